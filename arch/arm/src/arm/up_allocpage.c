@@ -34,7 +34,6 @@
  *
  ****************************************************************************/
 
-/****************************************************************************
  * Included Files
  ****************************************************************************/
 
@@ -70,12 +69,12 @@ typedef uint16_t pgndx_t;
 typedef uint32_t pgndx_t;
 #endif
 
-#if PG_POOL_MAXL1NDX < 256
-typedef uint8_t  L1ndx_t;
-#elif PG_POOL_MAXL1NDX < 65536
-typedef uint16_t L1ndx_t;
+#if PG_POOL_MAXL2NDX < 256
+typedef uint8_t  L2ndx_t;
+#elif PG_POOL_MAXL2NDX < 65536
+typedef uint16_t L2ndx_t;
 #else
-typedef uint32_t L1ndx_t;
+typedef uint32_t L2ndx_t;
 #endif
 
 /****************************************************************************
@@ -83,24 +82,30 @@ typedef uint32_t L1ndx_t;
  ****************************************************************************/
 
 /* Free pages in memory are managed by indices ranging from up to
- * CONFIG_PAGING_NPAGED.  Initially all pages are free so the page can be
- * simply allocated in order: 0, 1, 2, ... .  After all CONFIG_PAGING_NPAGED
- * pages have be filled, then they are blindly freed and re-used in the
- * same order 0, 1, 2, ... because we don't know any better.  No smart "least
- * recently used" kind of logic is supported.
+ * CONFIG_PAGING_NPPAGED.  Initially all pages are free so the page can be
+ * simply allocated in order: 0, 1, 2, ... .  After all CONFIG_PAGING_NPPAGED
+ * pages have be filled, g_pgndx becomes the hand of a "clock" (second
+ * chance) page replacement:  A page that was used since the hand last
+ * passed it is made inaccessible and skipped; a page that was not is
+ * replaced.
+ *
+ * The MMU does not record page use, so an inaccessible page is one whose
+ * L2 entry is left in place but with the type bits cleared.  A use of the
+ * page then causes a page fault that up_checkmapping() resolves simply by
+ * restoring the type bits.
  */
 
 static pgndx_t g_pgndx;
 
-/* After CONFIG_PAGING_NPAGED have been allocated, the pages will be re-used.
- * In order to re-used the page, we will have un-map the page from its previous
- * mapping.  In order to that, we need to be able to map a physical address to
- * to an index into the PTE where it was mapped.  The following table supports
- * this backward lookup - it is indexed by the page number index, and holds
- * another index to the mapped virtual page.
+/* After CONFIG_PAGING_NPPAGED have been allocated, the pages will be
+ * re-used.  In order to re-used the page, we will have un-map the page from
+ * its previous mapping.  In order to that, we need to be able to map a
+ * physical address to to an index into the PTE where it was mapped.  The
+ * following table supports this backward lookup - it is indexed by the page
+ * number index, and holds another index to the mapped virtual page.
  */
 
-static L1ndx_t g_ptemap[CONFIG_PAGING_NPPAGED];
+static L2ndx_t g_ptemap[CONFIG_PAGING_NPPAGED];
 
 /* The contents of g_ptemap[] are not valid until g_pgndx has wrapped at
  * least one time.
@@ -112,6 +117,114 @@ static bool g_pgwrap;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: up_pgreplace
+ *
+ * Description:
+ *   Select the physical page to use for the next allocation, un-mapping it
+ *   from its previous virtual address if necessary.
+ *
+ ****************************************************************************/
+
+static unsigned int up_pgreplace(void)
+{
+  uintptr_t oldvaddr;
+  uint32_t *pte;
+  unsigned int pgndx;
+  bool inuse;
+
+  for (; ; )
+    {
+      /* Advance the clock hand */
+
+      pgndx = g_pgndx++;
+      inuse = g_pgwrap;
+
+      if (g_pgndx >= CONFIG_PAGING_NPPAGED)
+        {
+          g_pgndx  = 0;
+          g_pgwrap = true;
+        }
+
+      /* Pages are simply taken in order until all have been used once */
+
+      if (!inuse)
+        {
+          return pgndx;
+        }
+
+      /* Get a pointer to the L2 entry corresponding to the current mapping
+       * of the page.
+       */
+
+      oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
+      pte      = up_va2pte(oldvaddr);
+
+      if ((*pte & PTE_TYPE_MASK) != PTE_TYPE_FAULT)
+        {
+          /* The page was used since the hand last passed it.  Give it a
+           * second chance but make it inaccessible so that we can tell if
+           * it is used again.
+           */
+
+          *pte &= ~PTE_TYPE_MASK;
+          tlb_invalidate_single(oldvaddr);
+          continue;
+        }
+
+      /* The page is not in use.  Remove the mapping and re-use the page.
+       * The TLB was invalidated when the page was made inaccessible.
+       *
+       * I do not believe that it is necessary to flush the I-Cache in this
+       * case:  The I-Cache uses a virtual address index and, hence, since
+       * the NuttX address space is flat, the cached instruction value should
+       * be correct even if the page mapping is no longer in place.
+       */
+
+      *pte = 0;
+      return pgndx;
+    }
+}
+
+/****************************************************************************
+ * Name: up_mappage
+ *
+ * Description:
+ *   Allocate a physical page and map it to the provided virtual address.
+ *
+ ****************************************************************************/
+
+static void up_mappage(uintptr_t vaddr, FAR void **vpage)
+{
+  uintptr_t paddr;
+  uint32_t *pte;
+  unsigned int pgndx;
+
+  /* Allocate page memory to back up the mapping and convert the index to a
+   * (physical) page address.
+   */
+
+  pgndx = up_pgreplace();
+  paddr = PG_POOL_PGPADDR(pgndx);
+
+  /* Now setup up the new mapping.  Get a pointer to the L2 entry
+   * corresponding to the new mapping.  Then set it map to the newly
+   * allocated page address.  The inital mapping is read/write but
+   * non-cached (MMU_L2_ALLOCFLAGS)
+   */
+
+  pte  = up_va2pte(vaddr);
+  *pte = (paddr | MMU_L2_ALLOCFLAGS);
+
+  /* And save the new L2 index */
+
+  g_ptemap[pgndx] = PG_POOL_VA2L2NDX(vaddr);
+
+  /* Finally, return the virtual address of allocated page */
+
+  *vpage = (void *)(vaddr & ~PAGEMASK);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -168,9 +281,6 @@ static bool g_pgwrap;
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
 {
   uintptr_t vaddr;
-  uintptr_t paddr;
-  uint32_t *pte;
-  unsigned int pgndx;
 
   /* Since interrupts are disabled, we don't need to anything special. */
 
@@ -181,63 +291,59 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
   vaddr = tcb->xcp.far;
   DEBUGASSERT(vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
 
-  /* Allocate page memory to back up the mapping.  Start by getting the
-   * index of the next page that we are going to allocate.
-   */
+  up_mappage(vaddr, vpage);
+  return OK;
+}
 
-  pgndx = g_pgndx++;
-  if (g_pgndx >= CONFIG_PAGING)
-    {
-      g_pgndx  = 0;
-      g_pgwrap = true;
-    }
+/****************************************************************************
+ * Name: up_allocvpage()
+ *
+ * Description:
+ *  Like up_allocpage(), but set aside a page for the provided virtual
+ *  address instead of the address of a page fault.  See
+ *  include/nuttx/page.h.
+ *
+ ****************************************************************************/
 
-  /* Was this physical page previously mapped? If so, then we need to un-map
-   * it.
+#ifdef CONFIG_PAGING_READAHEAD
+int up_allocvpage(uintptr_t vaddr, FAR void **vpage)
+{
+  DEBUGASSERT(vpage && vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
+
+  /* Nothing to do if the page is already in memory (even if it is
+   * currently inaccessible).
    */
 
-  if (g_pgwrap)
+  if (*up_va2pte(vaddr) != 0)
     {
-      /* Yes.. Get a pointer to the L2 entry corresponding to the previous
-       * mapping -- then zero it!
-       */
-
-       uintptr_t oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
-       pte = up_va2pte(oldvaddr);
-      *pte = 0;
-
-      /* Invalidate the instruction TLB corresponding to the virtual address */
-
-      tlb_inst_invalidate_single(oldvaddr);
-
-      /* I do not believe that it is necessary to flush the I-Cache in this
-       * case:  The I-Cache uses a virtual address index and, hence, since the
-       * NuttX address space is flat, the cached instruction value should be
-       * correct even if the page mapping is no longer in place.
-       */
+      return -EEXIST;
     }
 
-  /* Then convert the index to a (physical) page address. */
-
-  paddr = PG_POOL_PGPADDR(pgndx);
-
-  /* Now setup up the new mapping.  Get a pointer to the L2 entry
-   * corresponding to the new mapping.  Then set it map to the newly
-   * allocated page address.  The inital mapping is read/write but
-   * non-cached (MMU_L2_ALLOCFLAGS)
-   */
-
-  pte = up_va2pte(vaddr);
-  *pte = (paddr | MMU_L2_ALLOCFLAGS);
-
-  /* And save the new L1 index */
+  up_mappage(vaddr, vpage);
+  return OK;
+}
+#endif
 
-  g_ptemap[pgndx] = PG_POOL_VA2L2NDX(vaddr);
+/****************************************************************************
+ * Name: up_fillcomplete()
+ *
+ * Description:
+ *  Give newly filled pages their final mapping:  Read-only and cacheable.
+ *  See include/nuttx/page.h.
+ *
+ ****************************************************************************/
 
-  /* Finally, return the virtual address of allocated page */
+void up_fillcomplete(FAR void *vpage, unsigned int npages)
+{
+  uintptr_t vaddr = (uintptr_t)vpage;
+  uint32_t *pte;
 
-  *vpage = (void *)(vaddr & ~PAGEMASK);
-  return OK;
+  for (; npages > 0; npages--, vaddr += PAGESIZE)
+    {
+      pte  = up_va2pte(vaddr);
+      *pte = (*pte & ~PAGEMASK) | MMU_L2_TEXTFLAGS;
+      tlb_invalidate_single(vaddr);
+    }
 }
 
 #endif /* CONFIG_PAGING */
@@ -47,6 +47,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/page.h>
 
+#include "pg_macros.h"
 #include "up_internal.h"
 
 #ifdef CONFIG_PAGING
@@ -76,6 +77,9 @@
  *  may occur on several threads and be queued multiple times. This function
  *  will prevent the same page from be filled multiple times.
  *
+ *  A page that was made inaccessible by the page replacement logic in
+ *  up_allocpage() is still in memory.  It is made accessible again here.
+ *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that we believe
  *         needs to have a page fill.  Architecture-specific logic can
@@ -115,6 +119,15 @@ bool up_checkmapping(FAR struct tcb_s *tcb)
 
   pte = up_va2pte(vaddr);
 
+  /* Restore the mapping of a page that was made inaccessible in order to
+   * detect its use.
+   */
+
+  if (*pte != 0 && (*pte & PTE_TYPE_MASK) == PTE_TYPE_FAULT)
+    {
+      *pte |= (MMU_L2_TEXTFLAGS & PTE_TYPE_MASK);
+    }
+
   /* Return true if this virtual address is mapped. */
 
   return (*pte != 0);
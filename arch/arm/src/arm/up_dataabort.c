@@ -130,7 +130,7 @@ void up_dataabort(uint32_t *regs, uint32_t far, uint32_t fsr)
    * prefetch and data aborts.
    */
 
-  tcb->xcp.far = regs[REG_R15];
+  tcb->xcp.far = far;
 
   /* Call pg_miss() to schedule the page fill.  A consequences of this
    * call are:
@@ -376,7 +376,7 @@ int up_addrenv_destroy(FAR group_addrenv_t *addrenv)
    * data).
    */
 
-  arm_addrenv_destroy_region(addrenv->heap, ARCH_SHM_NSECTS,
+  arm_addrenv_destroy_region(addrenv->shm, ARCH_SHM_NSECTS,
                              CONFIG_ARCH_SHM_VBASE, true);
 #endif
 #endif
@@ -595,10 +595,18 @@ int up_addrenv_select(FAR const group_addrenv_t *addrenv,
           oldenv->shm[i] = mmu_l1_getentry(vaddr);
         }
 
-      /* Set (or clear) the new page table entry */
+      /* Set (or clear) the new page table entry.  Large shared memory
+       * regions may be mapped with section entries instead of L2 page
+       * tables.
+       */
 
       paddr = (uintptr_t)addrenv->shm[i];
-      if (paddr)
+      if ((paddr & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          mmu_l1_setentry(paddr & PMD_SECT_PADDR_MASK, vaddr,
+                          MMU_L1_USHMFLAGS);
+        }
+      else if (paddr)
         {
           mmu_l1_setentry(paddr, vaddr, MMU_L1_PGTABFLAGS);
         }
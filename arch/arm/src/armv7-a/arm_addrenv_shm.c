@@ -33,13 +33,13 @@
  *
  ****************************************************************************/
 
-/****************************************************************************
  * Included Files
  ****************************************************************************/
 
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 
@@ -55,6 +55,43 @@
 
 #if defined(CONFIG_BUILD_KERNEL) && defined(CONFIG_MM_SHM)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_shm_sectmappable
+ *
+ * Description:
+ *   Return true if the next section of the region can be mapped with a
+ *   single L1 section entry:  The virtual and physical addresses must both
+ *   be section aligned and the physical pages must be contiguous for the
+ *   whole section.
+ *
+ ****************************************************************************/
+
+static bool arm_shm_sectmappable(FAR const uintptr_t *pages,
+                                 unsigned int npages, uintptr_t vaddr)
+{
+  unsigned int i;
+
+  if ((vaddr & SECTION_MASK) != 0 || npages < ENTRIES_PER_L2TABLE ||
+      (pages[0] & SECTION_MASK) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < ENTRIES_PER_L2TABLE; i++)
+    {
+      if (pages[i] != pages[0] + ((uintptr_t)i << MM_PGSHIFT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +102,12 @@
  * Description:
  *   Attach, i.e, map, on shared memory region to a user virtual address
  *
+ *   Sections of the region that are backed by contiguous, section aligned
+ *   physical memory are mapped with L1 section entries.  The rest is mapped
+ *   page by page in L2 page tables.  The L1 entries are also installed in
+ *   the current page table so that the whole region is accessible as soon
+ *   as this function returns.
+ *
  * Input Parameters:
  *   pages - A pointer to the first element in a array of physical address,
  *     each corresponding to one page of memory.
@@ -86,11 +129,13 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
   FAR uint32_t *l2table;
   irqstate_t flags;
   uintptr_t paddr;
+  uintptr_t sectvaddr;
 #ifndef CONFIG_ARCH_PGPOOL_MAPPING
   uint32_t l1save;
 #endif
   unsigned int nmapped;
   unsigned int shmndx;
+  bool newtable;
 
   shminfo("pages=%p npages=%d vaddr=%08lx\n",
           pages, npages, (unsigned long)vaddr);
@@ -109,11 +154,34 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
     {
       /* Get the shm[] index associated with the virtual address */
 
-      shmndx = (vaddr - CONFIG_ARCH_SHM_VBASE) >> SECTION_SHIFT;
+      shmndx    = (vaddr - CONFIG_ARCH_SHM_VBASE) >> SECTION_SHIFT;
+      sectvaddr = vaddr & ~SECTION_MASK;
 
       /* Has a level 1 page table entry been created for this virtual address */
 
       l1entry = group->tg_addrenv.shm[shmndx];
+      if (l1entry == NULL &&
+          arm_shm_sectmappable(pages, npages - nmapped, vaddr))
+        {
+          /* Map the whole section with one L1 entry.  The shm[] entry holds
+           * the section descriptor so that it can be distinguished from an
+           * L2 page table address.
+           */
+
+          flags = enter_critical_section();
+          group->tg_addrenv.shm[shmndx] =
+            (FAR uintptr_t *)(pages[0] | MMU_L1_USHMFLAGS);
+          mmu_l1_setentry(pages[0], vaddr, MMU_L1_USHMFLAGS);
+          leave_critical_section(flags);
+
+          pages   += ENTRIES_PER_L2TABLE;
+          nmapped += ENTRIES_PER_L2TABLE;
+          vaddr   += SECTION_SIZE;
+          continue;
+        }
+
+      DEBUGASSERT(((uintptr_t)l1entry & PMD_TYPE_MASK) != PMD_TYPE_SECT);
+
       if (l1entry == NULL)
         {
           /* No.. Allocate one physical page for the L2 page table */
@@ -125,6 +193,7 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
             }
 
           DEBUGASSERT(MM_ISALIGNED(paddr));
+          newtable = true;
 
           /* We need to be more careful after we begin modifying
            * global resources.
@@ -159,8 +228,9 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
            * table entry.
            */
 
-          paddr = (uintptr_t)l1entry & ~SECTION_MASK;
-          flags = enter_critical_section();
+          paddr    = (uintptr_t)l1entry & ~SECTION_MASK;
+          newtable = false;
+          flags    = enter_critical_section();
 
 #ifdef CONFIG_ARCH_PGPOOL_MAPPING
           /* Get the virtual address corresponding to the physical page\
@@ -179,21 +249,19 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
 #endif
         }
 
-      /* Map the virtual address to this physical address */
+      /* Map each virtual page that falls within this L2 page table */
 
-      DEBUGASSERT(get_l2_entry(l2table, vaddr) == 0);
+      do
+        {
+          DEBUGASSERT(get_l2_entry(l2table, vaddr) == 0);
 
-      paddr = *pages++;
-      set_l2_entry(l2table, paddr, vaddr, MMU_MEMFLAGS);
-      nmapped++;
-      vaddr += MM_PGSIZE;
+          set_l2_entry(l2table, *pages++, vaddr, MMU_L2_UDATAFLAGS);
+          nmapped++;
+          vaddr += MM_PGSIZE;
+        }
+      while (nmapped < npages && (vaddr & SECTION_MASK) != 0);
 
-      /* Make sure that the initialized L2 table is flushed to physical
-       * memory.
-       *
-       * REVISIT: We could be smarter in doing this.  Currently, we may
-       * flush the entire L2 page table numerous times.
-       */
+      /* Make sure that the L2 table is flushed to physical memory */
 
       arch_flush_dcache((uintptr_t)l2table,
                         (uintptr_t)l2table +
@@ -204,6 +272,16 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr)
 
       mmu_l1_restore(ARCH_SCRATCH_VBASE, l1save);
 #endif
+
+      /* Hook a new L2 page table into the current L1 page table now rather
+       * than on the next address environment switch.
+       */
+
+      if (newtable)
+        {
+          mmu_l1_setentry(paddr, sectvaddr, MMU_L1_PGTABFLAGS);
+        }
+
       leave_critical_section(flags);
     }
 
@@ -235,6 +313,7 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
   FAR uint32_t *l2table;
   irqstate_t flags;
   uintptr_t paddr;
+  uintptr_t start;
 #ifndef CONFIG_ARCH_PGPOOL_MAPPING
   uint32_t l1save;
 #endif
@@ -266,6 +345,23 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
       l1entry = group->tg_addrenv.shm[shmndx];
       DEBUGASSERT(l1entry != NULL);
 
+      /* A section mapping is removed by simply clearing the L1 entry */
+
+      if (((uintptr_t)l1entry & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          DEBUGASSERT((vaddr & SECTION_MASK) == 0 &&
+                      npages - nunmapped >= ENTRIES_PER_L2TABLE);
+
+          flags = enter_critical_section();
+          group->tg_addrenv.shm[shmndx] = NULL;
+          mmu_l1_clrentry(vaddr);
+          leave_critical_section(flags);
+
+          nunmapped += ENTRIES_PER_L2TABLE;
+          vaddr     += SECTION_SIZE;
+          continue;
+        }
+
       /* Get the physical address of the L2 page table from the L1 page
        * table entry.
        */
@@ -289,7 +385,8 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
         (ARCH_SCRATCH_VBASE | (paddr & SECTION_MASK));
 #endif
 
-      /* Unmap this virtual page address.
+      /* Unmap each virtual page address that falls within this L2 page
+       * table.
        *
        * REVISIT: Note that the page allocated for the level 2 page table
        * is not freed nor is the level 1 page table entry ever cleared.
@@ -300,22 +397,25 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
        * mapping very quickly.
        */
 
-      DEBUGASSERT(get_l2_entry(l2table, vaddr) != 0);
+      start = vaddr;
+      do
+        {
+          DEBUGASSERT(get_l2_entry(l2table, vaddr) != 0);
 
-      clr_l2_entry(l2table, vaddr);
-      nunmapped++;
-      vaddr += MM_PGSIZE;
+          clr_l2_entry(l2table, vaddr);
+          nunmapped++;
+          vaddr += MM_PGSIZE;
+        }
+      while (nunmapped < npages && (vaddr & SECTION_MASK) != 0);
 
       /* Make sure that the modified L2 table is flushed to physical
-       * memory.
-       *
-       * REVISIT: We could be smarter in doing this.  Currently, we may
-       * flush the entire L2 page table numerous times.
+       * memory and that no stale translations remain in the TLB.
        */
 
       arch_flush_dcache((uintptr_t)l2table,
                         (uintptr_t)l2table +
                         ENTRIES_PER_L2TABLE * sizeof(uint32_t));
+      mmu_invalidate_region(start, vaddr - start);
 
 #ifndef CONFIG_ARCH_PGPOOL_MAPPING
       /* Restore the scratch section L1 page table entry */
@@ -212,7 +212,15 @@ void arm_addrenv_destroy_region(FAR uintptr_t **list, unsigned int listlen,
       /* Has this page table been allocated? */
 
       paddr = (uintptr_t)list[i];
-      if (paddr != 0)
+      if ((paddr & PMD_TYPE_MASK) == PMD_TYPE_SECT)
+        {
+          /* This is a section mapping of shared memory.  There is no
+           * page table to free and the page data is kept.
+           */
+
+          DEBUGASSERT(keep);
+        }
+      else if (paddr != 0)
         {
           flags = enter_critical_section();
 
@@ -72,10 +72,14 @@ void up_copyarmstate(uint32_t *dest, uint32_t *src)
   if (src != dest)
     {
       /* Save the floating point registers: This will initialize the floating
-       * registers at indices ARM_CONTEXT_REGS through (XCPTCONTEXT_REGS-1)
+       * registers at indices ARM_CONTEXT_REGS through (XCPTCONTEXT_REGS-1).
+       * With the lazy FPU logic, the registers are saved only when another
+       * thread claims the FPU.
        */
 
+#ifndef CONFIG_ARMV7A_LAZYFPU
       up_savefpu(dest);
+#endif
 
       /* Then copy all of the ARM registers (omitting the floating point
        * registers).  Indices: 0 through (ARM_CONTEXT_REGS-1).
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_critmon.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_ARMV7A_CRITMON
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_ARMV7A_CRITMON_FREQUENCY) || \
+    CONFIG_ARMV7A_CRITMON_FREQUENCY <= 0
+#  error CONFIG_ARMV7A_CRITMON_FREQUENCY must be provided
+#endif
+
+/* PMCR bits */
+
+#define PMCR_E              (1 << 0)   /* Bit 0: Enable all counters */
+#define PMCR_C              (1 << 2)   /* Bit 2: Cycle counter reset */
+#define PMCR_D              (1 << 3)   /* Bit 3: Count every 64th cycle */
+
+/* PMCNTENSET bits */
+
+#define PMCNTENSET_C        (1 << 31)  /* Bit 31: Cycle counter enable */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Performance Monitor register access (CP15 c9) */
+
+static inline uint32_t cp15_rdpmcr(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c12, 0\n" : "=r" (regval));
+  return regval;
+}
+
+static inline void cp15_wrpmcr(uint32_t regval)
+{
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 0\n" : : "r" (regval));
+}
+
+static inline uint32_t cp15_rdpmcntenset(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c12, 1\n" : "=r" (regval));
+  return regval;
+}
+
+static inline void cp15_wrpmcntenset(uint32_t regval)
+{
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 1\n" : : "r" (regval));
+}
+
+static inline uint32_t cp15_rdpmccntr(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c13, 0\n" : "=r" (regval));
+  return regval;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_critmon_gettime
+ *
+ * Description:
+ *   Return the current value of the PMU cycle counter of this CPU.  The
+ *   counter is enabled on the first call on each CPU.  Zero means that the
+ *   time is not yet available and so is never returned for a running
+ *   counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_critmon_gettime(void)
+{
+  uint32_t count;
+
+  if ((cp15_rdpmcntenset() & PMCNTENSET_C) == 0)
+    {
+      /* Enable and reset the counters, counting every cycle */
+
+      cp15_wrpmcr((cp15_rdpmcr() & ~PMCR_D) | PMCR_E | PMCR_C);
+      cp15_wrpmcntenset(PMCNTENSET_C);
+    }
+
+  count = cp15_rdpmccntr();
+  return count != 0 ? count : 1;
+}
+
+/****************************************************************************
+ * Name: up_critmon_convert
+ *
+ * Description:
+ *   Convert an elapsed cycle count into a time.
+ *
+ ****************************************************************************/
+
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts)
+{
+  uint32_t cycles;
+
+  ts->tv_sec  = elapsed / CONFIG_ARMV7A_CRITMON_FREQUENCY;
+  cycles      = elapsed % CONFIG_ARMV7A_CRITMON_FREQUENCY;
+  ts->tv_nsec = (uint64_t)cycles * NSEC_PER_SEC /
+                CONFIG_ARMV7A_CRITMON_FREQUENCY;
+}
+
+#endif /* CONFIG_ARMV7A_CRITMON */
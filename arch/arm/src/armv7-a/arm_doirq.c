@@ -52,6 +52,7 @@
 
 #include "group/group.h"
 #include "gic.h"
+#include "fpu.h"
 
 /****************************************************************************
  * Private Data
@@ -105,7 +106,13 @@ static inline uint32_t *_arm_doirq(int irq, uint32_t *regs)
 
   if (regs != CURRENT_REGS)
     {
-#ifdef CONFIG_ARCH_FPU
+#if defined(CONFIG_ARMV7A_LAZYFPU)
+      /* Leave the floating point registers in place.  The FPU is enabled
+       * only if the new thread already owns them.
+       */
+
+      arm_lazyfpu_switch();
+#elif defined(CONFIG_ARCH_FPU)
       /* Restore floating point registers */
 
       up_restorefpu((uint32_t *)CURRENT_REGS);
@@ -0,0 +1,244 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_lazyfpu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+#include "fpu.h"
+
+#ifdef CONFIG_ARMV7A_LAZYFPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FPEXC_EN  (1 << 30)  /* Bit 30: VFP/NEON enable */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The thread whose floating point state is currently held in the FPU
+ * registers, or NULL if the registers hold no thread's state.
+ */
+
+static FAR struct tcb_s *g_fpu_owner;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t arm_getfpexc(void)
+{
+  uint32_t fpexc;
+
+  __asm__ __volatile__
+  (
+    "\tfmrx %0, fpexc\n"
+    : "=r" (fpexc)
+    :
+    : "memory"
+  );
+
+  return fpexc;
+}
+
+static inline void arm_setfpexc(uint32_t fpexc)
+{
+  __asm__ __volatile__
+  (
+    "\tfmxr fpexc, %0\n"
+    :
+    : "r" (fpexc)
+    : "memory"
+  );
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_claim
+ *
+ * Description:
+ *   Enable the FPU and make 'tcb' the owner of the FPU registers, saving
+ *   the state of the previous owner into its TCB.  If 'load' is true, the
+ *   registers are then loaded from the TCB of the new owner.
+ *
+ ****************************************************************************/
+
+static void arm_lazyfpu_claim(FAR struct tcb_s *tcb, bool load)
+{
+  arm_setfpexc(arm_getfpexc() | FPEXC_EN);
+
+  if (g_fpu_owner != tcb)
+    {
+      if (g_fpu_owner != NULL)
+        {
+          up_savefpu(g_fpu_owner->xcp.regs);
+        }
+
+      if (load)
+        {
+          up_restorefpu(tcb->xcp.regs);
+        }
+
+      g_fpu_owner = tcb;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_lazyfpu_switch
+ *
+ * Description:
+ *   Called on each context switch after the thread that is about to run
+ *   has become the head of the ready-to-run list.  Enables the FPU only if
+ *   that thread owns the live FPU registers.
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_switch(void)
+{
+  uint32_t fpexc = arm_getfpexc();
+
+  if (g_fpu_owner == this_task())
+    {
+      fpexc |= FPEXC_EN;
+    }
+  else
+    {
+      fpexc &= ~FPEXC_EN;
+    }
+
+  arm_setfpexc(fpexc);
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_trap
+ *
+ * Description:
+ *   Called from the undefined instruction handler.  If the FPU is
+ *   disabled, hand the FPU to the current thread and return true so that
+ *   the faulting instruction is retried.  If the FPU is already enabled,
+ *   the instruction is truly undefined and false is returned.
+ *
+ ****************************************************************************/
+
+bool arm_lazyfpu_trap(void)
+{
+  if ((arm_getfpexc() & FPEXC_EN) != 0)
+    {
+      return false;
+    }
+
+  arm_lazyfpu_claim(this_task(), true);
+  return true;
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_save
+ *
+ * Description:
+ *   Copy the floating point state of the running thread 'tcb' into the
+ *   register save area 'regs'.
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_save(FAR struct tcb_s *tcb, FAR uint32_t *regs)
+{
+  if (tcb == g_fpu_owner)
+    {
+      arm_setfpexc(arm_getfpexc() | FPEXC_EN);
+      up_savefpu(regs);
+    }
+  else if (regs != tcb->xcp.regs)
+    {
+      memcpy(&regs[REG_S0], &tcb->xcp.regs[REG_S0],
+             sizeof(uint32_t) * FPU_CONTEXT_REGS);
+    }
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_restore
+ *
+ * Description:
+ *   Load the floating point state of the running thread 'tcb' from the
+ *   register save area 'regs'.
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_restore(FAR struct tcb_s *tcb, FAR const uint32_t *regs)
+{
+  arm_lazyfpu_claim(tcb, false);
+  up_restorefpu(regs);
+}
+
+/****************************************************************************
+ * Name: arm_lazyfpu_release
+ *
+ * Description:
+ *   Called when a thread is deleted so that its TCB is no longer
+ *   referenced as the owner of the FPU registers.
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_release(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags = enter_critical_section();
+
+  if (g_fpu_owner == tcb)
+    {
+      g_fpu_owner = NULL;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_ARMV7A_LAZYFPU */
@@ -0,0 +1,268 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_pmu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#ifdef CONFIG_ARMV7A_PMU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* PMCR bits */
+
+#define PMCR_E              (1 << 0)   /* Bit 0: Enable all counters */
+#define PMCR_D              (1 << 3)   /* Bit 3: Count every 64th cycle */
+#define PMCR_N_SHIFT        (11)       /* Bits 11-15: Number of counters */
+#define PMCR_N_MASK         (0x1f << PMCR_N_SHIFT)
+
+/* PMCNTENSET bits */
+
+#define PMCNTENSET_C        (1 << 31)  /* Bit 31: Cycle counter enable */
+
+/* Counter 0 is the cycle counter, followed by up to four event counters */
+
+#define PMU_NEVENTS         4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pmu_eventname_s
+{
+  uint8_t event;
+  FAR const char *name;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_pmu_events[PMU_NEVENTS] =
+{
+  CONFIG_ARMV7A_PMU_EVENT0,
+  CONFIG_ARMV7A_PMU_EVENT1,
+  CONFIG_ARMV7A_PMU_EVENT2,
+  CONFIG_ARMV7A_PMU_EVENT3
+};
+
+static const struct pmu_eventname_s g_pmu_eventnames[] =
+{
+  { 0x00, "SwIncrement" },
+  { 0x01, "L1IRefill" },
+  { 0x02, "ITLBRefill" },
+  { 0x03, "L1DRefill" },
+  { 0x04, "L1DAccess" },
+  { 0x05, "DTLBRefill" },
+  { 0x06, "Loads" },
+  { 0x07, "Stores" },
+  { 0x08, "Instructions" },
+  { 0x09, "Exceptions" },
+  { 0x10, "BrMispredict" },
+  { 0x12, "Branches" },
+  { 0x13, "MemAccess" }
+};
+
+#define PMU_NEVENTNAMES \
+  (sizeof(g_pmu_eventnames) / sizeof(struct pmu_eventname_s))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Performance Monitor register access (CP15 c9) */
+
+static inline uint32_t cp15_rdpmcr(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c12, 0\n" : "=r" (regval));
+  return regval;
+}
+
+static inline void cp15_wrpmcr(uint32_t regval)
+{
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 0\n" : : "r" (regval));
+}
+
+static inline uint32_t cp15_rdpmcntenset(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c12, 1\n" : "=r" (regval));
+  return regval;
+}
+
+static inline void cp15_wrpmcntenset(uint32_t regval)
+{
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 1\n" : : "r" (regval));
+}
+
+static inline void cp15_wrpmselr(uint32_t regval)
+{
+  __asm__ __volatile__
+  (
+    "\tmcr p15, 0, %0, c9, c12, 5\n"
+    "\tisb\n"
+    :
+    : "r" (regval)
+  );
+}
+
+static inline uint32_t cp15_rdpmccntr(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c13, 0\n" : "=r" (regval));
+  return regval;
+}
+
+static inline void cp15_wrpmxevtyper(uint32_t regval)
+{
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c13, 1\n" : : "r" (regval));
+}
+
+static inline uint32_t cp15_rdpmxevcntr(void)
+{
+  uint32_t regval;
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c13, 2\n" : "=r" (regval));
+  return regval;
+}
+
+/****************************************************************************
+ * Name: pmu_nevents
+ *
+ * Description:
+ *   Return the number of event counters that are used on this CPU.
+ *
+ ****************************************************************************/
+
+static inline int pmu_nevents(void)
+{
+  int nevents = (cp15_rdpmcr() & PMCR_N_MASK) >> PMCR_N_SHIFT;
+  return nevents < PMU_NEVENTS ? nevents : PMU_NEVENTS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the cycle counter and the event counters of this CPU.  The
+ *   counters are configured and enabled on the first call on each CPU.
+ *   The cycle counter is not reset so that it is not disturbed if it is
+ *   shared with up_critmon_gettime().
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts, int ncounters)
+{
+  uint32_t enable;
+  int nevents;
+  int i;
+
+  nevents = pmu_nevents();
+  enable  = PMCNTENSET_C | ((1 << nevents) - 1);
+
+  if ((cp15_rdpmcntenset() & enable) != enable)
+    {
+      for (i = 0; i < nevents; i++)
+        {
+          cp15_wrpmselr(i);
+          cp15_wrpmxevtyper(g_pmu_events[i]);
+        }
+
+      cp15_wrpmcntenset(enable);
+      cp15_wrpmcr((cp15_rdpmcr() & ~PMCR_D) | PMCR_E);
+    }
+
+  counts[0] = cp15_rdpmccntr();
+
+  for (i = 1; i < ncounters; i++)
+    {
+      if (i <= nevents)
+        {
+          cp15_wrpmselr(i - 1);
+          counts[i] = cp15_rdpmxevcntr();
+        }
+      else
+        {
+          counts[i] = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: up_pmu_event
+ *
+ * Description:
+ *   Return the name of the event counted by a performance counter.
+ *
+ ****************************************************************************/
+
+FAR const char *up_pmu_event(int index)
+{
+  int i;
+
+  if (index == 0)
+    {
+      return "Cycles";
+    }
+
+  if (index > pmu_nevents())
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < PMU_NEVENTNAMES; i++)
+    {
+      if (g_pmu_eventnames[i].event == g_pmu_events[index - 1])
+        {
+          return g_pmu_eventnames[i].name;
+        }
+    }
+
+  return "Event";
+}
+
+#endif /* CONFIG_ARMV7A_PMU */
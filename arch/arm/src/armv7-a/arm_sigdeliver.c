@@ -51,6 +51,7 @@
 #include "sched/sched.h"
 #include "up_internal.h"
 #include "up_arch.h"
+#include "fpu.h"
 
 #ifndef CONFIG_DISABLE_SIGNALS
 
@@ -102,6 +103,12 @@ void up_sigdeliver(void)
   regs[REG_PC]         = rtcb->xcp.saved_pc;
   regs[REG_CPSR]       = rtcb->xcp.saved_cpsr;
 
+#ifdef CONFIG_ARMV7A_LAZYFPU
+  /* The live floating point state may still be in the FPU registers */
+
+  arm_lazyfpu_save(rtcb, regs);
+#endif
+
   /* Get a local copy of the sigdeliver function pointer. we do this so that
    * we can nullify the sigdeliver function pointer in the TCB and accept
    * more signal deliveries while processing the current pending signals.
@@ -178,6 +185,9 @@ void up_sigdeliver(void)
   /* Then restore the correct state for this thread of execution. */
 
   board_autoled_off(LED_SIGNAL);
+#ifdef CONFIG_ARMV7A_LAZYFPU
+  arm_lazyfpu_restore(rtcb, regs);
+#endif
   up_fullcontextrestore(regs);
 }
 
@@ -46,6 +46,7 @@
 #include <arch/irq.h>
 
 #include "up_internal.h"
+#include "fpu.h"
 
 /****************************************************************************
  * Public Functions
@@ -57,6 +58,20 @@
 
 uint32_t *arm_undefinedinsn(uint32_t *regs)
 {
+#ifdef CONFIG_ARMV7A_LAZYFPU
+  /* If the FPU is disabled, this is probably the first VFP/NEON instruction
+   * executed by a thread that does not own the FPU registers.  Hand the
+   * FPU to this thread and retry the instruction.  The return address is
+   * past the faulting instruction (all VFP/NEON instructions are 32-bit).
+   */
+
+  if (arm_lazyfpu_trap())
+    {
+      regs[REG_PC] -= 4;
+      return regs;
+    }
+
+#endif
   _alert("Undefined instruction at 0x%x\n", regs[REG_PC]);
   CURRENT_REGS = regs;
   PANIC();
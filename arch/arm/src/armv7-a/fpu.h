@@ -43,6 +43,11 @@
 
 #include <nuttx/config.h>
 
+#ifndef __ASSEMBLY__
+#  include <stdint.h>
+#  include <stdbool.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -84,6 +89,47 @@ extern "C"
 void arm_fpuconfig(void);
 #endif
 
+#ifdef CONFIG_ARMV7A_LAZYFPU
+/****************************************************************************
+ * Name: arm_lazyfpu_switch
+ *
+ * Description:
+ *   Called on each context switch after the thread that is about to run
+ *   has become the head of the ready-to-run list.  Enables the FPU only if
+ *   that thread owns the live FPU registers.
+ *
+ ****************************************************************************/
+
+void arm_lazyfpu_switch(void);
+
+/****************************************************************************
+ * Name: arm_lazyfpu_trap
+ *
+ * Description:
+ *   Called from the undefined instruction handler.  If the FPU is
+ *   disabled, hand the FPU to the current thread and return true so that
+ *   the faulting instruction is retried.
+ *
+ ****************************************************************************/
+
+bool arm_lazyfpu_trap(void);
+
+/****************************************************************************
+ * Name: arm_lazyfpu_save and arm_lazyfpu_restore
+ *
+ * Description:
+ *   Copy the floating point state of the running thread 'tcb' into the
+ *   register save area 'regs', or load it from 'regs'.  Used when a
+ *   thread saves and restores its own context outside of a context
+ *   switch (signal delivery).
+ *
+ ****************************************************************************/
+
+struct tcb_s;
+void arm_lazyfpu_save(FAR struct tcb_s *tcb, FAR uint32_t *regs);
+void arm_lazyfpu_restore(FAR struct tcb_s *tcb, FAR const uint32_t *regs);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -560,7 +560,7 @@
  * registers, not the priority set by the sending Cortex-A9 processor.
  *
  * NOTE: If CONFIG_SMP is enabled then SGI1 and SGI2 are used for inter-CPU
- * task management.
+ * task management.  SGI3 is also used if CONFIG_SMP_CALL is enabled.
  */
 
 #define GIC_IRQ_SGI0              0  /* Software Generated Interrupt (SGI) 0 */
@@ -786,6 +786,25 @@ int arm_start_handler(int irq, FAR void *context, FAR void *arg);
 int arm_pause_handler(int irq, FAR void *context, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: arm_call_handler
+ *
+ * Description:
+ *   This is the handler for SGI3.  It runs the cross-CPU calls that have
+ *   been queued for this CPU.
+ *
+ * Input Parameters:
+ *   Standard interrupt handling
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int arm_call_handler(int irq, FAR void *context, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: arm_gic_dump
  *
@@ -596,6 +596,9 @@
 #define MMU_L2_UALLOCFLAGS    (PTE_TYPE_SMALL | PTE_WRITE_BACK | PTE_AP_RW01)
 #define MMU_L2_KALLOCFLAGS    (PTE_TYPE_SMALL | PTE_WRITE_BACK | PTE_AP_RW1)
 
+#define MMU_L1_USHMFLAGS      (PMD_TYPE_SECT | PMD_SECT_AP_RW01 | \
+                               PMD_CACHEABLE | PMD_SECT_DOM(0) | PMD_SECT_XN)
+
 #define MMU_L1_PGTABFLAGS     (PMD_TYPE_PTE | PMD_PTE_PXN | PTE_WRITE_THROUGH | \
                                PMD_PTE_DOM(0))
 #define MMU_L2_PGTABFLAGS     (PTE_TYPE_SMALL | PTE_WRITE_THROUGH | PTE_AP_RW1)
@@ -0,0 +1,382 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arch_dma_map.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+
+#include "up_arch.h"
+#include "cache.h"
+#include "dmamap.h"
+
+#ifdef CONFIG_ARMV7M_DMAMAP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Describes one region of non-cacheable memory */
+
+struct dmamap_region_s
+{
+  uintptr_t base;                      /* Start address of the region */
+  uintptr_t end;                       /* End address of the region + 1 */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dmamap_region_s g_nocache[CONFIG_ARMV7M_DMAMAP_NREGIONS];
+static uint8_t g_nnocache;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmamap_cacheable
+ *
+ * Description:
+ *   Return false if the segment lies completely within a non-cacheable
+ *   region.
+ *
+ ****************************************************************************/
+
+static bool dmamap_cacheable(uintptr_t start, uintptr_t end)
+{
+  int i;
+
+  for (i = 0; i < g_nnocache; i++)
+    {
+      if (start >= g_nocache[i].base && end <= g_nocache[i].end)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: dmamap_next
+ *
+ * Description:
+ *   Return the next range of cacheable memory in the scatter list.
+ *   Segments that follow one another in the list and that are adjacent or
+ *   overlap (when extended to cache line boundaries) are combined into one
+ *   range.
+ *
+ * Input Parameters:
+ *   seg      - The scatter list
+ *   nseg     - The number of segments in the scatter list
+ *   index    - The index of the next segment to examine.  Updated.
+ *   linesize - The size of one cache line in bytes
+ *   start    - The location to return the start of the range
+ *   end      - The location to return the end of the range + 1
+ *
+ * Returned Value:
+ *   True if a range was returned; false if the scatter list is exhausted.
+ *
+ ****************************************************************************/
+
+static bool dmamap_next(FAR const struct dmamap_seg_s *seg, int nseg,
+                        FAR int *index, uintptr_t linesize,
+                        FAR uintptr_t *start, FAR uintptr_t *end)
+{
+  uintptr_t mask = linesize - 1;
+  uintptr_t segstart;
+  uintptr_t segend;
+  bool found = false;
+
+  for (; *index < nseg; (*index)++)
+    {
+      segstart = seg[*index].addr;
+      segend   = segstart + seg[*index].len;
+
+      if (segstart == segend || !dmamap_cacheable(segstart, segend))
+        {
+          continue;
+        }
+
+      if (!found)
+        {
+          *start = segstart;
+          *end   = segend;
+          found  = true;
+        }
+      else if ((segstart & ~mask) <= ((*end + mask) & ~mask) &&
+               ((segend + mask) & ~mask) >= (*start & ~mask))
+        {
+          if (segstart < *start)
+            {
+              *start = segstart;
+            }
+
+          if (segend > *end)
+            {
+              *end = segend;
+            }
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: dmamap_lines
+ *
+ * Description:
+ *   Apply one by-address cache maintenance operation to each cache line in
+ *   the range.  The start address must be line aligned.
+ *
+ ****************************************************************************/
+
+static void dmamap_lines(uintptr_t reg, uintptr_t start, uintptr_t end,
+                         uintptr_t linesize)
+{
+  for (; start < end; start += linesize)
+    {
+      putreg32(start, reg);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_dma_sync
+ *
+ * Description:
+ *   Perform the D-Cache maintenance needed to pass ownership of the memory
+ *   described by a scatter list to the DMA (todevice == true) or back to
+ *   the CPU (todevice == false).
+ *
+ * Input Parameters:
+ *   seg      - The scatter list
+ *   nseg     - The number of segments in the scatter list
+ *   dir      - The direction of the transfer.  See DMAMAP_* definitions.
+ *   todevice - True: pass ownership to the DMA; false: back to the CPU.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_dma_sync(FAR const struct dmamap_seg_s *seg, int nseg, uint8_t dir,
+                   bool todevice)
+{
+  uint32_t ccsidr;
+  uintptr_t linesize;
+  uintptr_t mask;
+  uintptr_t start;
+  uintptr_t end;
+  uintptr_t first;
+  uintptr_t last;
+  size_t cachesize;
+  size_t total;
+  int index;
+
+  /* Memory that the DMA only reads needs nothing when it is returned to
+   * the CPU.  With a write-through D-Cache, there are never any dirty
+   * cache lines so that memory needs nothing when it is passed to the DMA
+   * either.
+   */
+
+  if ((dir & DMAMAP_FROMDEVICE) == 0)
+    {
+#ifdef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+      return;
+#else
+      if (!todevice)
+        {
+          return;
+        }
+#endif
+    }
+
+  /* Get the characteristics of the D-Cache */
+
+  ccsidr    = getreg32(NVIC_CCSIDR);
+  linesize  = (uintptr_t)1 << (CCSIDR_LSSHIFT(ccsidr) + 4);
+  mask      = linesize - 1;
+  cachesize = (CCSIDR_SETS(ccsidr) + 1) * (CCSIDR_WAYS(ccsidr) + 1) *
+              linesize;
+
+  /* Find the total size of the memory that needs maintenance.  If that is
+   * larger than the D-Cache, it is fastest to operate on the whole D-Cache.
+   */
+
+  total = 0;
+  index = 0;
+
+  while (dmamap_next(seg, nseg, &index, linesize, &start, &end))
+    {
+      total += ((end + mask) & ~mask) - (start & ~mask);
+    }
+
+  if (total == 0)
+    {
+      return;
+    }
+
+  if (total >= cachesize)
+    {
+      /* Invalidating the whole D-Cache would discard the dirty data of
+       * other memory, so clean and invalidate it instead.
+       */
+
+      if (todevice && (dir & DMAMAP_FROMDEVICE) == 0)
+        {
+          arch_clean_dcache_all();
+        }
+      else
+        {
+          arch_flush_dcache_all();
+        }
+
+      return;
+    }
+
+  /* Operate on each range one cache line at a time using the by-address
+   * operations.  Only one barrier is needed for all of the ranges.
+   */
+
+  ARM_DSB();
+
+  index = 0;
+  while (dmamap_next(seg, nseg, &index, linesize, &start, &end))
+    {
+      first = start & ~mask;
+      last  = (end + mask) & ~mask;
+
+      if (!todevice)
+        {
+          /* Discard any lines that were speculatively loaded while the DMA
+           * was in progress.
+           */
+
+          dmamap_lines(NVIC_DCIMVAC, first, last, linesize);
+        }
+#ifndef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+      else if ((dir & DMAMAP_TODEVICE) != 0)
+        {
+          /* Write back dirty lines so that the DMA reads the current data.
+           * If the DMA also writes the memory, the lines must go too.
+           */
+
+          dmamap_lines((dir & DMAMAP_FROMDEVICE) != 0 ?
+                       NVIC_DCCIMVAC : NVIC_DCCMVAC,
+                       first, last, linesize);
+        }
+#endif
+      else
+        {
+          /* The DMA will write the memory.  Partial lines at either end
+           * also hold other data and must be written back before they are
+           * discarded.  Lines that the DMA overwrites completely are just
+           * discarded.
+           */
+
+          if (start != first)
+            {
+              putreg32(first, NVIC_DCCIMVAC);
+              first += linesize;
+            }
+
+          if (end != last && last > first)
+            {
+              last -= linesize;
+              putreg32(last, NVIC_DCCIMVAC);
+            }
+
+          dmamap_lines(NVIC_DCIMVAC, first, last, linesize);
+        }
+    }
+
+  ARM_DSB();
+  ARM_ISB();
+}
+
+/****************************************************************************
+ * Name: arch_dma_nocache
+ *
+ * Description:
+ *   Register a region of memory that is not cached (or is coherent with
+ *   the DMA).  No cache maintenance is done for DMA memory in such a
+ *   region.
+ *
+ * Input Parameters:
+ *   base - The start address of the region
+ *   size - The size of the region in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOMEM is returned if the
+ *   CONFIG_ARMV7M_DMAMAP_NREGIONS regions are already in use.
+ *
+ ****************************************************************************/
+
+int arch_dma_nocache(uintptr_t base, size_t size)
+{
+  irqstate_t flags;
+  int ret = -ENOMEM;
+
+  flags = enter_critical_section();
+  if (g_nnocache < CONFIG_ARMV7M_DMAMAP_NREGIONS)
+    {
+      g_nocache[g_nnocache].base = base;
+      g_nocache[g_nnocache].end  = base + size;
+      g_nnocache++;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_ARMV7M_DMAMAP */
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arch_dma_pool.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/gran.h>
+
+#include "up_arch.h"
+#include "cache.h"
+#include "mpu.h"
+#include "dmamap.h"
+
+#ifdef CONFIG_ARMV7M_DMAPOOL
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static GRAN_HANDLE g_dmapool;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_dma_poolinit
+ *
+ * Description:
+ *   Provide the memory for the non-cacheable DMA memory pool.  This is
+ *   normally called by board-specific logic during initialization.
+ *
+ * Input Parameters:
+ *   heap - The start of the pool memory
+ *   size - The size of the pool memory in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int arch_dma_poolinit(FAR void *heap, size_t size)
+{
+  uintptr_t base = (uintptr_t)heap;
+  uint8_t l2line;
+  int ret;
+
+  DEBUGASSERT(heap != NULL && g_dmapool == NULL);
+
+#ifdef CONFIG_ARM_MPU
+  /* One MPU region maps the pool as non-cacheable */
+
+  if ((size & (size - 1)) != 0 || size < 32 || (base & (size - 1)) != 0)
+    {
+      merr("ERROR: Bad pool alignment: %p size=%lu\n",
+           heap, (unsigned long)size);
+      return -EINVAL;
+    }
+
+  /* Make sure that there is no stale data in the cache before the
+   * memory becomes non-cacheable.
+   */
+
+  arch_flush_dcache(base, base + size);
+
+  mpu_priv_noncache(base, size);
+  mpu_control(true, false, true);
+#endif
+
+  /* Allocations are made in units of one cache line and aligned to cache
+   * lines.
+   */
+
+  l2line    = CCSIDR_LSSHIFT(getreg32(NVIC_CCSIDR)) + 4;
+  g_dmapool = gran_initialize(heap, size, l2line, l2line);
+  if (g_dmapool == NULL)
+    {
+      merr("ERROR: gran_initialize failed\n");
+      return -ENOMEM;
+    }
+
+  /* Memory from the pool needs no cache maintenance */
+
+  ret = arch_dma_nocache(base, size);
+  if (ret < 0)
+    {
+      mwarn("WARNING: No free non-cacheable region\n");
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: arch_dma_alloc
+ *
+ * Description:
+ *   Allocate memory from the non-cacheable DMA memory pool.
+ *
+ ****************************************************************************/
+
+FAR void *arch_dma_alloc(size_t size)
+{
+  DEBUGASSERT(g_dmapool != NULL);
+  return gran_alloc(g_dmapool, size);
+}
+
+/****************************************************************************
+ * Name: arch_dma_free
+ *
+ * Description:
+ *   Return memory to the non-cacheable DMA memory pool.
+ *
+ ****************************************************************************/
+
+void arch_dma_free(FAR void *memory, size_t size)
+{
+  DEBUGASSERT(g_dmapool != NULL);
+  gran_free(g_dmapool, memory, size);
+}
+
+#endif /* CONFIG_ARMV7M_DMAPOOL */
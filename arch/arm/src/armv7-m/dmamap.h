@@ -0,0 +1,235 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/dmamap.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_ARM_SRC_ARMV7_M_DMAMAP_H
+#define __ARCH_ARM_SRC_ARMV7_M_DMAMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_ARMV7M_DMAMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* DMA transfer directions */
+
+#define DMAMAP_TODEVICE      (1 << 0)  /* The DMA reads the memory */
+#define DMAMAP_FROMDEVICE    (1 << 1)  /* The DMA writes the memory */
+#define DMAMAP_BIDIRECTIONAL (DMAMAP_TODEVICE | DMAMAP_FROMDEVICE)
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Describes one segment of a scatter list */
+
+struct dmamap_seg_s
+{
+  uintptr_t addr;                      /* Start address of the segment */
+  size_t len;                          /* Length of the segment in bytes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: arch_dma_sync
+ *
+ * Description:
+ *   Perform the D-Cache maintenance needed to pass ownership of the memory
+ *   described by a scatter list to the DMA (todevice == true) or back to
+ *   the CPU (todevice == false).
+ *
+ *   Segments that lie in a region registered with arch_dma_nocache() need
+ *   no maintenance and are skipped.  Adjacent and overlapping segments are
+ *   combined, and if the total exceeds the size of the D-Cache then the
+ *   whole D-Cache is maintained instead of one line at a time.
+ *
+ *   Memory that the DMA writes should begin and end on a cache line
+ *   boundary.  Otherwise, data that the CPU writes to the same cache lines
+ *   while the DMA is in progress will be lost.
+ *
+ * Input Parameters:
+ *   seg      - The scatter list
+ *   nseg     - The number of segments in the scatter list
+ *   dir      - The direction of the transfer.  See DMAMAP_* definitions.
+ *   todevice - True: pass ownership to the DMA; false: back to the CPU.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_dma_sync(FAR const struct dmamap_seg_s *seg, int nseg, uint8_t dir,
+                   bool todevice);
+
+/****************************************************************************
+ * Name: arch_dma_map and arch_dma_unmap
+ *
+ * Description:
+ *   arch_dma_map() must be called before the DMA is started and
+ *   arch_dma_unmap() after the DMA completes.  The CPU must not access the
+ *   memory in between.
+ *
+ ****************************************************************************/
+
+static inline void arch_dma_map(FAR const struct dmamap_seg_s *seg,
+                                int nseg, uint8_t dir)
+{
+  arch_dma_sync(seg, nseg, dir, true);
+}
+
+static inline void arch_dma_unmap(FAR const struct dmamap_seg_s *seg,
+                                  int nseg, uint8_t dir)
+{
+  arch_dma_sync(seg, nseg, dir, false);
+}
+
+/****************************************************************************
+ * Name: arch_dma_mapbuf and arch_dma_unmapbuf
+ *
+ * Description:
+ *   The same as arch_dma_map() and arch_dma_unmap() for a single buffer.
+ *
+ ****************************************************************************/
+
+static inline void arch_dma_mapbuf(FAR const void *buffer, size_t len,
+                                   uint8_t dir)
+{
+  struct dmamap_seg_s seg;
+
+  seg.addr = (uintptr_t)buffer;
+  seg.len  = len;
+  arch_dma_sync(&seg, 1, dir, true);
+}
+
+static inline void arch_dma_unmapbuf(FAR const void *buffer, size_t len,
+                                     uint8_t dir)
+{
+  struct dmamap_seg_s seg;
+
+  seg.addr = (uintptr_t)buffer;
+  seg.len  = len;
+  arch_dma_sync(&seg, 1, dir, false);
+}
+
+/****************************************************************************
+ * Name: arch_dma_nocache
+ *
+ * Description:
+ *   Register a region of memory that is not cached (or is coherent with
+ *   the DMA), such as the DTCM or a region that the MPU maps as non-
+ *   cacheable.  No cache maintenance is done for DMA memory in such a
+ *   region.
+ *
+ * Input Parameters:
+ *   base - The start address of the region
+ *   size - The size of the region in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOMEM is returned if the
+ *   CONFIG_ARMV7M_DMAMAP_NREGIONS regions are already in use.
+ *
+ ****************************************************************************/
+
+int arch_dma_nocache(uintptr_t base, size_t size);
+
+#ifdef CONFIG_ARMV7M_DMAPOOL
+/****************************************************************************
+ * Name: arch_dma_poolinit
+ *
+ * Description:
+ *   Provide the memory for the non-cacheable DMA memory pool.  This is
+ *   normally called by board-specific logic during initialization.
+ *
+ *   If the MPU is available, the memory is mapped as non-cacheable with
+ *   one MPU region.  In that case, the size must be a power of two and
+ *   the memory must be aligned to its size.  Otherwise, the memory must
+ *   already be non-cacheable (the DTCM, for example).
+ *
+ * Input Parameters:
+ *   heap - The start of the pool memory
+ *   size - The size of the pool memory in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int arch_dma_poolinit(FAR void *heap, size_t size);
+
+/****************************************************************************
+ * Name: arch_dma_alloc and arch_dma_free
+ *
+ * Description:
+ *   Allocate and free memory from the non-cacheable DMA memory pool.  The
+ *   memory begins on a cache line boundary and no cache maintenance is
+ *   needed for DMA to or from it.
+ *
+ ****************************************************************************/
+
+FAR void *arch_dma_alloc(size_t size);
+void arch_dma_free(FAR void *memory, size_t size);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* CONFIG_ARMV7M_DMAMAP */
+#endif /* __ARCH_ARM_SRC_ARMV7_M_DMAMAP_H */
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_critmon.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+
+#include "nvic.h"
+#include "dwt.h"
+#include "up_arch.h"
+
+#ifdef CONFIG_ARMV7M_CRITMON
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_ARMV7M_CRITMON_FREQUENCY) || \
+    CONFIG_ARMV7M_CRITMON_FREQUENCY <= 0
+#  error CONFIG_ARMV7M_CRITMON_FREQUENCY must be provided
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_critmon_gettime
+ *
+ * Description:
+ *   Return the current value of the DWT cycle counter.  The counter is
+ *   enabled on the first call.  Zero means that the time is not yet
+ *   available and so is never returned for a running counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_critmon_gettime(void)
+{
+  uint32_t count;
+
+  if ((getreg32(DWT_CTRL) & DWT_CTRL_CYCCNTENA_MASK) == 0)
+    {
+      /* Enable the trace and debug blocks, then the cycle counter */
+
+      modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+      putreg32(0, DWT_CYCCNT);
+      modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_MASK);
+    }
+
+  count = getreg32(DWT_CYCCNT);
+  return count != 0 ? count : 1;
+}
+
+/****************************************************************************
+ * Name: up_critmon_convert
+ *
+ * Description:
+ *   Convert an elapsed cycle count into a time.
+ *
+ ****************************************************************************/
+
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts)
+{
+  uint32_t cycles;
+
+  ts->tv_sec  = elapsed / CONFIG_ARMV7M_CRITMON_FREQUENCY;
+  cycles      = elapsed % CONFIG_ARMV7M_CRITMON_FREQUENCY;
+  ts->tv_nsec = (uint64_t)cycles * NSEC_PER_SEC /
+                CONFIG_ARMV7M_CRITMON_FREQUENCY;
+}
+
+#endif /* CONFIG_ARMV7M_CRITMON */
@@ -47,6 +47,7 @@
 #include <nuttx/board.h>
 #include <arch/board/board.h>
 
+#include "sched/sched.h"
 #include "up_arch.h"
 #include "up_internal.h"
 
@@ -85,6 +86,17 @@ uint32_t *up_doirq(int irq, uint32_t *regs)
 
   irq_dispatch(irq, regs);
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* If a context switch occurred, move the stack guard to the stack of the
+   * new thread.
+   */
+
+  if (regs != (uint32_t *)CURRENT_REGS)
+    {
+      arm_stackguard(this_task());
+    }
+
+#endif
   /* If a context switch occurred while processing the interrupt then
    * CURRENT_REGS may have change value.  If we return any value different
    * from the input regs, then the lower level will know that a context
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_pmu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#include "nvic.h"
+#include "dwt.h"
+#include "up_arch.h"
+
+#ifdef CONFIG_ARMV7M_PMU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the performance counters.  Only the DWT cycle counter is
+ *   provided.  It is enabled on the first call.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts, int ncounters)
+{
+  int i;
+
+  if ((getreg32(DWT_CTRL) & DWT_CTRL_CYCCNTENA_MASK) == 0)
+    {
+      /* Enable the trace and debug blocks, then the cycle counter */
+
+      modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+      modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_MASK);
+    }
+
+  counts[0] = getreg32(DWT_CYCCNT);
+
+  for (i = 1; i < ncounters; i++)
+    {
+      counts[i] = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: up_pmu_event
+ *
+ * Description:
+ *   Return the name of the event counted by a performance counter.
+ *
+ ****************************************************************************/
+
+FAR const char *up_pmu_event(int index)
+{
+  return index == 0 ? "Cycles" : NULL;
+}
+
+#endif /* CONFIG_ARMV7M_PMU */
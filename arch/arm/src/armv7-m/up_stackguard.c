@@ -0,0 +1,136 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_stackguard.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+#include "sched/sched.h"
+#include "mpu.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned int g_guard_region; /* MPU region used for the guard */
+static uint8_t g_guard_l2size;      /* Log2 size of the guard */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm_stackguard_initialize
+ *
+ * Description:
+ *   Reserve an MPU region for the stack guard and enable the MPU.  This
+ *   must be called after any other MPU regions have been configured so
+ *   that the guard region has the highest region number and, hence,
+ *   takes precedence over any overlapping region.
+ *
+ ****************************************************************************/
+
+void arm_stackguard_initialize(void)
+{
+  g_guard_region = mpu_allocregion();
+  g_guard_l2size = mpu_log2regionceil(CONFIG_ARMV7M_STACKGUARD_SIZE);
+
+  arm_stackguard(this_task());
+
+  /* Enable the MPU with the default memory map as the background region
+   * for privileged accesses.
+   */
+
+  mpu_control(true, false, true);
+}
+
+/****************************************************************************
+ * Name: arm_stackguard
+ *
+ * Description:
+ *   Move the stack guard region to the lowest addresses of the stack of
+ *   'tcb', the thread that is about to run.  Any access to the guard,
+ *   most likely the result of a stack overflow, then generates a memory
+ *   management fault.
+ *
+ ****************************************************************************/
+
+void arm_stackguard(FAR struct tcb_s *tcb)
+{
+  uintptr_t guardsize = (uintptr_t)1 << g_guard_l2size;
+  uintptr_t base;
+
+  putreg32(g_guard_region, MPU_RNR);
+
+  /* Leave the guard disabled if there is no stack or if the guard would
+   * consume too much of the stack.
+   */
+
+  if (tcb->stack_alloc_ptr == NULL ||
+      tcb->adj_stack_size < 4 * guardsize)
+    {
+      putreg32(0, MPU_RASR);
+      return;
+    }
+
+  /* The MPU region must be aligned to its size */
+
+  base = (uintptr_t)tcb->stack_alloc_ptr;
+#ifdef CONFIG_TLS
+  base += TLS_INFO_SIZE;
+#endif
+  base = (base + guardsize - 1) & ~(guardsize - 1);
+
+  putreg32((base & MPU_RBAR_ADDR_MASK) | g_guard_region | MPU_RBAR_VALID,
+           MPU_RBAR);
+  putreg32(MPU_RASR_ENABLE                              | /* Enable region  */
+           MPU_RASR_SIZE_LOG2((uint32_t)g_guard_l2size) | /* Region size    */
+           MPU_RASR_AP_NONO                             | /* P:None U:None  */
+           MPU_RASR_XN,                                   /* No execution   */
+           MPU_RASR);
+}
+
+#endif /* CONFIG_ARMV7M_STACKGUARD */
@@ -54,6 +54,14 @@
 
 #ifdef CONFIG_STACK_COLORATION
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of words skipped per step of the coarse high water mark search */
+
+#define STACK_CHECK_STRIDE 8
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -97,7 +105,7 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
       /* Skip over the TLS data structure at the bottom of the stack */
 
       DEBUGASSERT((alloc & TLS_STACK_MASK) == 0);
-      start = alloc + sizeof(struct tls_info_s);
+      start = alloc + TLS_INFO_SIZE;
     }
   else
     {
@@ -119,9 +127,25 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
    * that does not have the magic value is the high water mark.
    */
 
-  for (ptr = (FAR uint32_t *)start, mark = (size >> 2);
-       *ptr == STACK_COLOR && mark > 0;
-       ptr++, mark--);
+  ptr  = (FAR uint32_t *)start;
+  mark = size >> 2;
+
+  /* The unused part of the stack is normally one contiguous painted area,
+   * so first skip forward STACK_CHECK_STRIDE words at a time, testing only
+   * the last word of each block.  This keeps the check cheap enough to be
+   * used routinely on large, mostly unused stacks.
+   */
+
+  while (mark > STACK_CHECK_STRIDE &&
+         ptr[STACK_CHECK_STRIDE - 1] == STACK_COLOR)
+    {
+      ptr  += STACK_CHECK_STRIDE;
+      mark -= STACK_CHECK_STRIDE;
+    }
+
+  /* Then locate the first clobbered word within the final block */
+
+  for (; mark > 0 && *ptr == STACK_COLOR; ptr++, mark--);
 
   /* If the stack is completely used, then this might mean that the stack
    * overflowed from above (meaning that the stack is too small), or may
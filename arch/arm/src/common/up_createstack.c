@@ -47,6 +47,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/place.h>
 #include <nuttx/arch.h>
 #include <nuttx/tls.h>
 #include <nuttx/board.h>
@@ -125,7 +126,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 #ifdef CONFIG_TLS
    /* Add the size of the TLS information structure */
 
-   stack_size += sizeof(struct tls_info_s);
+   stack_size += TLS_INFO_SIZE;
 
    /* The allocated stack size must not exceed the maximum possible for the
     * TLS feature.
@@ -159,7 +160,19 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
        * If TLS is enabled, then we must allocate aligned stacks.
        */
 
-#ifdef CONFIG_TLS
+#if defined(CONFIG_MM_PLACE_STACKS) && defined(CONFIG_TLS)
+      /* Prefer fast memory for all stacks */
+
+      tcb->stack_alloc_ptr =
+        (uint32_t *)place_memalign(PLACE_FAST, TLS_STACK_ALIGN, stack_size);
+
+#elif defined(CONFIG_MM_PLACE_STACKS)
+      /* Prefer fast memory for all stacks */
+
+      tcb->stack_alloc_ptr =
+        (uint32_t *)place_malloc(PLACE_FAST, stack_size);
+
+#elif defined(CONFIG_TLS)
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
@@ -246,6 +259,9 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
       /* Initialize the TLS data structure */
 
       memset(tcb->stack_alloc_ptr, 0, sizeof(struct tls_info_s));
+#ifdef CONFIG_TLS_ELF
+      tls_elf_initialize((FAR struct tls_info_s *)tcb->stack_alloc_ptr);
+#endif
 
 #ifdef CONFIG_STACK_COLORATION
       /* If stack debug is enabled, then fill the stack with a
@@ -253,8 +269,8 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
        * water marks.
        */
 
-      stack_base = (uintptr_t)tcb->stack_alloc_ptr + sizeof(struct tls_info_s);
-      stack_size = tcb->adj_stack_size - sizeof(struct tls_info_s);
+      stack_base = (uintptr_t)tcb->stack_alloc_ptr + TLS_INFO_SIZE;
+      stack_size = tcb->adj_stack_size - TLS_INFO_SIZE;
       up_stack_color((FAR void *)stack_base, stack_size);
 
 #endif /* CONFIG_STACK_COLORATION */
@@ -130,6 +130,12 @@ void up_initialize(void)
 
   up_irqinitialize();
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Protect the bottom of the running thread's stack with an MPU region */
+
+  arm_stackguard_initialize();
+#endif
+
 #ifdef CONFIG_PM
   /* Initialize the power management subsystem.  This MCU-specific function
    * must be called *very* early in the initialization sequence *before* any
@@ -443,6 +443,11 @@ void up_restorefpu(const uint32_t *regs);
 #  define up_restorefpu(regs)
 #endif
 
+#ifdef CONFIG_ARMV7A_LAZYFPU
+struct tcb_s;
+void arm_lazyfpu_release(FAR struct tcb_s *tcb);
+#endif
+
 /* System timer *************************************************************/
 
 void arm_timer_initialize(void);
@@ -532,6 +537,12 @@ void up_usbuninitialize(void);
 void up_stack_color(FAR void *stackbase, size_t nbytes);
 #endif
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+struct tcb_s;
+void arm_stackguard_initialize(void);
+void arm_stackguard(FAR struct tcb_s *tcb);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
@@ -61,3 +62,20 @@ bool up_interrupt_context(void)
 {
   return CURRENT_REGS != NULL;
 }
+
+/****************************************************************************
+ * Name: up_interrupt_pc
+ *
+ * Description: Return the program counter of the code that was interrupted
+ * by the interrupt that is currently being processed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PROFILE
+uintptr_t up_interrupt_pc(void)
+{
+  FAR volatile uint32_t *regs = CURRENT_REGS;
+
+  return regs != NULL ? (uintptr_t)regs[REG_PC] : 0;
+}
+#endif
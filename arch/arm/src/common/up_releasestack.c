@@ -44,6 +44,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/place.h>
 
 #include "up_internal.h"
 
@@ -95,6 +96,12 @@
 
 void up_release_stack(FAR struct tcb_s *dtcb, uint8_t ttype)
 {
+#ifdef CONFIG_ARMV7A_LAZYFPU
+  /* The FPU registers may still hold the state of this thread */
+
+  arm_lazyfpu_release(dtcb);
+
+#endif
   /* Is there a stack allocated? */
 
   if (dtcb->stack_alloc_ptr)
@@ -118,6 +125,12 @@ void up_release_stack(FAR struct tcb_s *dtcb, uint8_t ttype)
             {
               sched_ufree(dtcb->stack_alloc_ptr);
             }
+#ifdef CONFIG_MM_PLACE_STACKS
+          else if (place_heapmember(dtcb->stack_alloc_ptr))
+            {
+              sched_ufree(dtcb->stack_alloc_ptr);
+            }
+#endif
         }
 
       /* Mark the stack freed */
@@ -156,6 +156,9 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
   /* Initialize the TLS data structure */
 
   memset(tcb->stack_alloc_ptr, 0, sizeof(struct tls_info_s));
+#ifdef CONFIG_TLS_ELF
+  tls_elf_initialize((FAR struct tls_info_s *)tcb->stack_alloc_ptr);
+#endif
 #endif
 
 #ifdef CONFIG_STACK_COLORATION
@@ -165,8 +168,8 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
 
 #ifdef CONFIG_TLS
   up_stack_color(
-      (FAR void *)((uintptr_t)tcb->stack_alloc_ptr + sizeof(struct tls_info_s)),
-      tcb->adj_stack_size - sizeof(struct tls_info_s));
+      (FAR void *)((uintptr_t)tcb->stack_alloc_ptr + TLS_INFO_SIZE),
+      tcb->adj_stack_size - TLS_INFO_SIZE);
 #else
   up_stack_color(tcb->stack_alloc_ptr, tcb->adj_stack_size);
 #endif
@@ -554,7 +554,7 @@ static int stm32_bbsram_poll(FAR struct file *filep, FAR struct pollfd *fds,
       fds->revents |= (fds->events & (POLLIN | POLLOUT));
       if (fds->revents != 0)
         {
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -259,10 +259,34 @@
 #  define STM32_LTDC_L2_FBSIZE (0)
 #endif
 
+/* Number of framebuffers of each layer.  If double buffering is enabled,
+ * the layer providing the video plane (layer 2 if enabled, otherwise layer
+ * 1) owns two framebuffers that are contiguous in memory and the one being
+ * displayed is selected with FBIOPAN_DISPLAY.
+ */
+
+#ifdef CONFIG_STM32_LTDC_FB_DOUBLEBUF
+#  define STM32_LTDC_NBUFFERS       2
+#else
+#  define STM32_LTDC_NBUFFERS       1
+#endif
+
+#ifdef CONFIG_STM32_LTDC_L2
+#  define STM32_LTDC_L1_NBUFFERS    1
+#  define STM32_LTDC_L2_NBUFFERS    STM32_LTDC_NBUFFERS
+#  define STM32_LTDC_PLANE          LTDC_LAYER_L2
+#else
+#  define STM32_LTDC_L1_NBUFFERS    STM32_LTDC_NBUFFERS
+#  define STM32_LTDC_L2_NBUFFERS    0
+#  define STM32_LTDC_PLANE          LTDC_LAYER_L1
+#endif
+
 /* Total memory used for framebuffers */
 
-#define STM32_LTDC_TOTAL_FBSIZE     (STM32_LTDC_L1_FBSIZE + \
-                                     STM32_LTDC_L2_FBSIZE)
+#define STM32_LTDC_TOTAL_FBSIZE     (STM32_LTDC_L1_FBSIZE * \
+                                     STM32_LTDC_L1_NBUFFERS + \
+                                     STM32_LTDC_L2_FBSIZE * \
+                                     STM32_LTDC_L2_NBUFFERS)
 
 /* Debug option */
 
@@ -295,12 +319,14 @@
 
 #define STM32_LTDC_BUFFER_L1        STM32_LTDC_BUFFER_START
 #define STM32_LTDC_ENDBUF_L1        (STM32_LTDC_BUFFER_L1 + \
-                                     STM32_LTDC_L1_FBSIZE)
+                                     STM32_LTDC_L1_FBSIZE * \
+                                     STM32_LTDC_L1_NBUFFERS)
 
 #ifdef CONFIG_STM32_LTDC_L2
 #  define STM32_LTDC_BUFFER_L2      STM32_LTDC_ENDBUF_L1
 #  define STM32_LTDC_ENDBUF_L2      (STM32_LTDC_BUFFER_L2 + \
-                                     STM32_LTDC_L2_FBSIZE)
+                                     STM32_LTDC_L2_FBSIZE * \
+                                     STM32_LTDC_L2_NBUFFERS)
 #else
 #  define STM32_LTDC_ENDBUF_L2      STM32_LTDC_ENDBUF_L1
 #endif
@@ -754,6 +780,13 @@ static int stm32_putcmap(FAR struct fb_vtable_s *vtable,
 static int stm32_waitforvsync(FAR struct fb_vtable_s *vtable);
 #endif
 
+/* The following is provided only if the video plane is double buffered */
+
+#ifdef CONFIG_STM32_LTDC_FB_DOUBLEBUF
+static int stm32_pandisplay(FAR struct fb_vtable_s *vtable,
+                            FAR const struct fb_planeinfo_s *pinfo);
+#endif
+
 /* The following is provided only if the video hardware supports overlays */
 
 #ifdef CONFIG_FB_OVERLAY
@@ -850,6 +883,11 @@ static struct stm32_ltdcdev_s g_vtable =
       .waitforvsync    = stm32_waitforvsync
 #endif
 
+#ifdef CONFIG_STM32_LTDC_FB_DOUBLEBUF
+      ,
+      .pandisplay      = stm32_pandisplay
+#endif
+
 #ifdef CONFIG_STM32_FB_CMAP
       ,
       .getcmap         = stm32_getcmap,
@@ -875,10 +913,15 @@ static struct stm32_ltdcdev_s g_vtable =
   .pinfo =
     {
       .fbmem           = (uint8_t *)STM32_LTDC_BUFFER_L2,
-      .fblen           = STM32_LTDC_L2_FBSIZE,
+      .fblen           = STM32_LTDC_L2_FBSIZE * STM32_LTDC_NBUFFERS,
       .stride          = STM32_LTDC_L2_STRIDE,
       .display         = 0,
       .bpp             = STM32_LTDC_L2_BPP
+#  ifdef CONFIG_FB_PANDISPLAY
+      ,
+      .yres_virtual    = STM32_LTDC_HEIGHT * STM32_LTDC_NBUFFERS,
+      .yoffset         = 0
+#  endif
     },
   .vinfo =
     {
@@ -894,10 +937,15 @@ static struct stm32_ltdcdev_s g_vtable =
   .pinfo =
     {
       .fbmem           = (uint8_t *)STM32_LTDC_BUFFER_L1,
-      .fblen           = STM32_LTDC_L1_FBSIZE,
+      .fblen           = STM32_LTDC_L1_FBSIZE * STM32_LTDC_NBUFFERS,
       .stride          = STM32_LTDC_L1_STRIDE,
       .display         = 0,
       .bpp             = STM32_LTDC_L1_BPP
+#  ifdef CONFIG_FB_PANDISPLAY
+      ,
+      .yres_virtual    = STM32_LTDC_HEIGHT * STM32_LTDC_NBUFFERS,
+      .yoffset         = 0
+#  endif
     },
   .vinfo =
     {
@@ -2548,6 +2596,56 @@ static int stm32_waitforvsync(FAR struct fb_vtable_s *vtable)
 }
 #endif /* CONFIG_FB_SYNC */
 
+/***************************************************************************
+ * Name: stm32_pandisplay
+ * Description:
+ *   Entrypoint ioctl FBIOPAN_DISPLAY
+ *   Select which one of the framebuffers of the video plane is displayed.
+ *   The new framebuffer address is latched during the next vertical
+ *   blanking period and this function waits until that has happened.  The
+ *   previously displayed framebuffer may then be drawn into safely.
+ ***************************************************************************/
+
+#ifdef CONFIG_STM32_LTDC_FB_DOUBLEBUF
+static int stm32_pandisplay(FAR struct fb_vtable_s *vtable,
+                            FAR const struct fb_planeinfo_s *pinfo)
+{
+  FAR struct stm32_ltdcdev_s *priv = (FAR struct stm32_ltdcdev_s *)vtable;
+  uint32_t cfbar;
+  int ret;
+
+  DEBUGASSERT(vtable != NULL && priv == &g_vtable && pinfo != NULL);
+  lcdinfo("vtable=%p yoffset=%d\n", vtable, pinfo->yoffset);
+
+  if (pinfo->yoffset + STM32_LTDC_HEIGHT > priv->pinfo.yres_virtual)
+    {
+      lcderr("ERROR: yoffset %d out of range\n", pinfo->yoffset);
+      return -EINVAL;
+    }
+
+  nxsem_wait(&g_lock);
+
+  /* Set the start address of the layer framebuffer.  The shadow register
+   * is reloaded during the next vertical blanking period.
+   */
+
+  cfbar = stm32_fbmem_layer_t[STM32_LTDC_PLANE] +
+          pinfo->yoffset * priv->pinfo.stride;
+
+  reginfo("set LTDC_L%dCFBAR=%08x\n", STM32_LTDC_PLANE + 1, cfbar);
+  putreg32(cfbar, stm32_cfbar_layer_t[STM32_LTDC_PLANE]);
+
+  ret = stm32_ltdc_reload(LTDC_SRCR_VBR, true);
+  if (ret == OK)
+    {
+      priv->pinfo.yoffset = pinfo->yoffset;
+    }
+
+  nxsem_post(&g_lock);
+  return ret;
+}
+#endif /* CONFIG_STM32_LTDC_FB_DOUBLEBUF */
+
 /***************************************************************************
  * Name: stm32_getoverlayinfo
  * Description:
@@ -324,6 +324,57 @@
 #  defined HAVE_BREAK
 #endif
 
+/* DMA streaming support.  The duty cycles of each frame are written to the
+ * CCR registers with a DMA burst (DCR/DMAR) on each timer update event.
+ * If a timer update request can be served by more than one DMA stream,
+ * board.h must select one by defining DMAMAP_TIMn_UP.
+ */
+
+#if defined(CONFIG_STM32_PWM_DMA) && defined(CONFIG_PWM_STREAM)
+#  define HAVE_PWM_DMA
+
+#  if defined(HAVE_IP_DMA_V2)
+#    define PWM_DMA_CONTROL_WORD (DMA_SCR_DIR_M2P | DMA_SCR_MINC | \
+                                  DMA_SCR_PSIZE_32BITS | \
+                                  DMA_SCR_MSIZE_32BITS | DMA_SCR_PRIHI)
+#  else
+#    define PWM_DMA_CONTROL_WORD (DMA_CCR_DIR | DMA_CCR_MINC | \
+                                  DMA_CCR_PSIZE_32BITS | \
+                                  DMA_CCR_MSIZE_32BITS | DMA_CCR_PRIHI)
+#  endif
+
+#  if defined(DMAMAP_TIM1_UP)
+#    define PWM_TIM1_DMAMAP DMAMAP_TIM1_UP
+#  elif defined(DMACHAN_TIM1_UP)
+#    define PWM_TIM1_DMAMAP DMACHAN_TIM1_UP
+#  endif
+#  if defined(DMAMAP_TIM2_UP)
+#    define PWM_TIM2_DMAMAP DMAMAP_TIM2_UP
+#  elif defined(DMACHAN_TIM2_UP)
+#    define PWM_TIM2_DMAMAP DMACHAN_TIM2_UP
+#  endif
+#  if defined(DMAMAP_TIM3_UP)
+#    define PWM_TIM3_DMAMAP DMAMAP_TIM3_UP
+#  elif defined(DMACHAN_TIM3_UP)
+#    define PWM_TIM3_DMAMAP DMACHAN_TIM3_UP
+#  endif
+#  if defined(DMAMAP_TIM4_UP)
+#    define PWM_TIM4_DMAMAP DMAMAP_TIM4_UP
+#  elif defined(DMACHAN_TIM4_UP)
+#    define PWM_TIM4_DMAMAP DMACHAN_TIM4_UP
+#  endif
+#  if defined(DMAMAP_TIM5_UP)
+#    define PWM_TIM5_DMAMAP DMAMAP_TIM5_UP
+#  elif defined(DMACHAN_TIM5_UP)
+#    define PWM_TIM5_DMAMAP DMACHAN_TIM5_UP
+#  endif
+#  if defined(DMAMAP_TIM8_UP)
+#    define PWM_TIM8_DMAMAP DMAMAP_TIM8_UP
+#  elif defined(DMACHAN_TIM8_UP)
+#    define PWM_TIM8_DMAMAP DMACHAN_TIM8_UP
+#  endif
+#endif
+
 /* Debug ********************************************************************/
 
 #ifdef CONFIG_DEBUG_PWM_INFO
@@ -416,6 +467,10 @@ struct stm32_pwmtimer_s
 #ifdef CONFIG_PWM_PULSECOUNT
   FAR void *handle;                     /* Handle used for upper-half callback */
 #endif
+#ifdef HAVE_PWM_DMA
+  DMA_HANDLE dma;                       /* Timer update DMA (NULL: none) */
+  FAR void *shandle;                    /* Handle used for pwm_streamdone() */
+#endif
 };
 
 /****************************************************************************
@@ -506,6 +561,14 @@ static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
 #endif
 
 static int pwm_stop(FAR struct pwm_lowerhalf_s *dev);
+#ifdef HAVE_PWM_DMA
+static void pwm_dma_setup(FAR struct stm32_pwmtimer_s *priv);
+static void pwm_dma_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg);
+static int pwm_stream(FAR struct pwm_lowerhalf_s *dev,
+                      FAR const struct pwm_stream_s *stream,
+                      FAR ub16_t *duty, size_t nframes, FAR void *handle);
+#endif
 static int pwm_ioctl(FAR struct pwm_lowerhalf_s *dev,
                      int cmd, unsigned long arg);
 
@@ -524,6 +587,13 @@ static const struct pwm_ops_s g_pwmops =
   .start       = pwm_start,
   .stop        = pwm_stop,
   .ioctl       = pwm_ioctl,
+#ifdef CONFIG_PWM_STREAM
+#  ifdef HAVE_PWM_DMA
+  .stream      = pwm_stream,
+#  else
+  .stream      = NULL,
+#  endif
+#endif
 };
 
 #ifdef CONFIG_STM32_PWM_LL_OPS
@@ -4081,6 +4151,12 @@ static int pwm_setup(FAR struct pwm_lowerhalf_s *dev)
       goto errout;
     }
 
+#ifdef HAVE_PWM_DMA
+  /* Reserve the timer update DMA for streaming */
+
+  pwm_dma_setup(priv);
+#endif
+
 errout:
   return ret;
 }
@@ -4114,6 +4190,16 @@ static int pwm_shutdown(FAR struct pwm_lowerhalf_s *dev)
 
   pwm_stop(dev);
 
+#ifdef HAVE_PWM_DMA
+  /* Release the timer update DMA */
+
+  if (priv->dma != NULL)
+    {
+      stm32_dmafree(priv->dma);
+      priv->dma = NULL;
+    }
+#endif
+
   /* Disable APB1/2 clocking for timer. */
 
   ret = pwm_set_apb_clock(priv, false);
@@ -4215,13 +4301,25 @@ static int pwm_start(FAR struct pwm_lowerhalf_s *dev,
 #ifdef CONFIG_PWM_MULTICHAN
       int i;
 
-      /* REVISIT: */
+      /* The CCR registers are preloaded.  Disable update events while they
+       * are written so that all channels change at the same period
+       * boundary.
+       */
+
+      pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, 0, GTIM_CR1_UDIS);
 
       for (i = 0; ret == OK && i < CONFIG_PWM_NCHANNELS; i++)
         {
-          ret = pwm_duty_update(dev, info->channels[i].channel,
-                                info->channels[i].duty);
+          /* A value of zero means to skip this channel */
+
+          if (info->channels[i].channel != 0)
+            {
+              ret = pwm_duty_update(dev, info->channels[i].channel,
+                                    info->channels[i].duty);
+            }
         }
+
+      pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, GTIM_CR1_UDIS, 0);
 #else
       ret = pwm_duty_update(dev, priv->channels[0].channel,info->duty);
 #endif  /* CONFIG_PWM_MULTICHAN */
@@ -4430,6 +4528,15 @@ static int pwm_stop(FAR struct pwm_lowerhalf_s *dev)
   priv->frequency = 0;
 #endif
 
+#ifdef HAVE_PWM_DMA
+  /* Stop any stream in progress */
+
+  if (priv->dma != NULL)
+    {
+      stm32_dmastop(priv->dma);
+    }
+#endif
+
   /* Disable further interrupts and stop the timer */
 
   pwm_putreg(priv, STM32_GTIM_DIER_OFFSET, 0);
@@ -4454,6 +4561,161 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: pwm_dma_setup
+ *
+ * Description:
+ *   Reserve the DMA channel that serves the update request of the timer,
+ *   if there is one.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_PWM_DMA
+static void pwm_dma_setup(FAR struct stm32_pwmtimer_s *priv)
+{
+  switch (priv->timid)
+    {
+#if defined(CONFIG_STM32_TIM1_PWM) && defined(PWM_TIM1_DMAMAP)
+      case 1:
+        priv->dma = stm32_dmachannel(PWM_TIM1_DMAMAP);
+        break;
+#endif
+
+#if defined(CONFIG_STM32_TIM2_PWM) && defined(PWM_TIM2_DMAMAP)
+      case 2:
+        priv->dma = stm32_dmachannel(PWM_TIM2_DMAMAP);
+        break;
+#endif
+
+#if defined(CONFIG_STM32_TIM3_PWM) && defined(PWM_TIM3_DMAMAP)
+      case 3:
+        priv->dma = stm32_dmachannel(PWM_TIM3_DMAMAP);
+        break;
+#endif
+
+#if defined(CONFIG_STM32_TIM4_PWM) && defined(PWM_TIM4_DMAMAP)
+      case 4:
+        priv->dma = stm32_dmachannel(PWM_TIM4_DMAMAP);
+        break;
+#endif
+
+#if defined(CONFIG_STM32_TIM5_PWM) && defined(PWM_TIM5_DMAMAP)
+      case 5:
+        priv->dma = stm32_dmachannel(PWM_TIM5_DMAMAP);
+        break;
+#endif
+
+#if defined(CONFIG_STM32_TIM8_PWM) && defined(PWM_TIM8_DMAMAP)
+      case 8:
+        priv->dma = stm32_dmachannel(PWM_TIM8_DMAMAP);
+        break;
+#endif
+
+      default:
+        priv->dma = NULL;
+        break;
+    }
+
+  pwminfo("TIM%u dma: %p\n", priv->timid, priv->dma);
+}
+
+/****************************************************************************
+ * Name: pwm_dma_callback
+ *
+ * Description:
+ *   Called from the DMA interrupt handler when a stream buffer has been
+ *   played.
+ *
+ ****************************************************************************/
+
+static void pwm_dma_callback(DMA_HANDLE handle, uint8_t status,
+                             FAR void *arg)
+{
+  FAR struct stm32_pwmtimer_s *priv = (FAR struct stm32_pwmtimer_s *)arg;
+
+  if ((status & DMA_STATUS_TEIF) != 0)
+    {
+      pwmerr("ERROR: TIM%u DMA error: %02x\n", priv->timid, status);
+    }
+
+  /* Stop the update DMA requests.  The last frame remains in the CCR
+   * registers until the upper half passes the next buffer.
+   */
+
+  pwm_modifyreg(priv, STM32_GTIM_DIER_OFFSET, GTIM_DIER_UDE, 0);
+  pwm_streamdone(priv->shandle);
+}
+
+/****************************************************************************
+ * Name: pwm_stream
+ *
+ * Description:
+ *   Play a buffer of duty cycle frames, one frame per timer period.  Each
+ *   update event triggers a DMA burst into the consecutive CCR registers
+ *   of the frame.
+ *
+ * Input Parameters:
+ *   dev     - A reference to the lower half PWM driver state structure
+ *   stream  - The frame layout
+ *   duty    - The frames.  These are converted to CCR values in place.
+ *   nframes - The number of frames
+ *   handle  - The handle to pass to pwm_streamdone()
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int pwm_stream(FAR struct pwm_lowerhalf_s *dev,
+                      FAR const struct pwm_stream_s *stream,
+                      FAR ub16_t *duty, size_t nframes, FAR void *handle)
+{
+  FAR struct stm32_pwmtimer_s *priv = (FAR struct stm32_pwmtimer_s *)dev;
+  FAR uint32_t *ccr = (FAR uint32_t *)duty;
+  uint32_t reload;
+  size_t ntransfers;
+  size_t i;
+
+  if (priv->dma == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  /* The burst must cover consecutive registers CCR1-CCR4 */
+
+  ntransfers = nframes * stream->nchannels;
+  if (stream->channel < 1 || stream->channel + stream->nchannels > 5 ||
+      ntransfers > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Convert the duty cycles to compare values as in pwm_duty_update() */
+
+  reload = pwm_arr_get(dev);
+  for (i = 0; i < ntransfers; i++)
+    {
+      ccr[i] = b16toi(duty[i] * reload + b16HALF);
+    }
+
+  /* Burst from CCRn, one transfer per channel for each update event */
+
+  pwm_putreg(priv, STM32_GTIM_DCR_OFFSET,
+             (((STM32_GTIM_CCR1_OFFSET >> 2) + stream->channel - 1) <<
+              GTIM_DCR_DBA_SHIFT) |
+             ((stream->nchannels - 1) << GTIM_DCR_DBL_SHIFT));
+
+  priv->shandle = handle;
+
+  stm32_dmasetup(priv->dma, priv->base + STM32_GTIM_DMAR_OFFSET,
+                 (uint32_t)ccr, ntransfers, PWM_DMA_CONTROL_WORD);
+  stm32_dmastart(priv->dma, pwm_dma_callback, priv, false);
+
+  pwm_modifyreg(priv, STM32_GTIM_DIER_OFFSET, 0, GTIM_DIER_UDE);
+  return OK;
+}
+#endif /* HAVE_PWM_DMA */
+
 /****************************************************************************
  * Name: pwm_ioctl
  *
@@ -55,7 +55,11 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PLACE
+struct place_heap_s g_dtcm_place;
+#else
 struct mm_heap_s g_dtcm_heap;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -45,6 +45,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -80,11 +81,19 @@
 #ifdef HAVE_DTCM_HEAP
 
 /* dtcm_initialize must be called early in initialization in order to
- * initialize the DTCM heap.
+ * initialize the DTCM heap.  With CONFIG_MM_PLACE, the DTCM heap is also
+ * made available as the named heap "dtcm" for PLACE_FAST allocations.
  */
 
-#define dtcm_initialize() \
+#ifdef CONFIG_MM_PLACE
+#  define g_dtcm_heap (g_dtcm_place.ph_heap)
+#  define dtcm_initialize() \
+  place_initialize(&g_dtcm_place, "dtcm", PLACE_FAST, (FAR void *)DTCM_START, \
+                   DTCM_END-DTCM_START)
+#else
+#  define dtcm_initialize() \
   mm_initialize(&g_dtcm_heap, (FAR void *)DTCM_START, DTCM_END-DTCM_START)
+#endif
 
 /* The dtcm_addregion interface could be used if, for example, you want to
  * add some other memory region to the DTCM heap.  I don't really know why
@@ -122,7 +131,11 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_MM_PLACE
+EXTERN struct place_heap_s g_dtcm_place;
+#else
 EXTERN struct mm_heap_s g_dtcm_heap;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
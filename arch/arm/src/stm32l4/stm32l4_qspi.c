@@ -324,6 +324,10 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static FAR void *qspi_alloc(FAR struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer);
+static int      qspi_memmap(FAR struct qspi_dev_s *dev,
+                  FAR const struct qspi_meminfo_s *meminfo,
+                  FAR void **base);
+static void     qspi_memunmap(FAR struct qspi_dev_s *dev);
 
 /* Initialization */
 
@@ -345,6 +349,8 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+  .memmap            = qspi_memmap,
+  .memunmap          = qspi_memunmap,
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2322,6 +2328,50 @@ static void qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer)
     }
 }
 
+/****************************************************************************
+ * Name: qspi_memmap
+ *
+ * Description:
+ *   Enter memory-mapped mode.  The memory then appears at the QUADSPI bank.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read performed on each memory access
+ *   base    - Location to return the memory-mapped base address
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS
+ *
+ ****************************************************************************/
+
+static int qspi_memmap(FAR struct qspi_dev_s *dev,
+                       FAR const struct qspi_meminfo_s *meminfo,
+                       FAR void **base)
+{
+  stm32l4_qspi_enter_memorymapped(dev, meminfo, 0);
+  *base = (FAR void *)STM32L4_QSPI_BANK;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: qspi_memunmap
+ *
+ * Description:
+ *   Leave memory-mapped mode
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static void qspi_memunmap(FAR struct qspi_dev_s *dev)
+{
+  stm32l4_qspi_exit_memorymapped(dev);
+}
+
 /****************************************************************************
  * Name: qspi_hw_initialize
  *
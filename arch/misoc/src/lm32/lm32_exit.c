@@ -86,10 +86,12 @@ static void _up_dumponexit(FAR struct tcb_s *tcb, FAR void *arg)
   sinfo("    priority=%d state=%d\n", tcb->sched_priority, tcb->task_state);
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
-  filelist = tcb->group->tg_filelist;
+  filelist = &tcb->group->tg_filelist;
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      struct inode *inode = filelist->fl_files[i].f_inode;
+      FAR struct file *filep = files_fget(filelist, i);
+      FAR struct inode *inode = filep != NULL ? filep->f_inode : NULL;
+
       if (inode)
         {
           sinfo("      fd=%d refcount=%d\n",
@@ -102,8 +104,8 @@ static void _up_dumponexit(FAR struct tcb_s *tcb, FAR void *arg)
   streamlist = tcb->group->tg_streamlist;
   for (i = 0; i < CONFIG_NFILE_STREAMS; i++)
     {
-      struct file_struct *filep = &streamlist->sl_streams[i];
-      if (filep->fs_fd >= 0)
+      struct file_struct *filep = STREAMLIST_STREAM(streamlist, i);
+      if (filep != NULL && filep->fs_fd >= 0)
         {
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
           if (filep->fs_bufstart != NULL)
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * arch/risc-v/src/rv32im/up_pmu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#ifdef CONFIG_RV32IM_PMU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the performance counters:  The low 32 bits of the cycle and
+ *   instret counters.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts, int ncounters)
+{
+  uint32_t cycles;
+  uint32_t instret;
+  int i;
+
+  __asm__ __volatile__ ("rdcycle %0" : "=r" (cycles));
+  __asm__ __volatile__ ("rdinstret %0" : "=r" (instret));
+
+  counts[0] = cycles;
+  if (ncounters > 1)
+    {
+      counts[1] = instret;
+    }
+
+  for (i = 2; i < ncounters; i++)
+    {
+      counts[i] = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: up_pmu_event
+ *
+ * Description:
+ *   Return the name of the event counted by a performance counter.
+ *
+ ****************************************************************************/
+
+FAR const char *up_pmu_event(int index)
+{
+  switch (index)
+    {
+      case 0:
+        return "Cycles";
+
+      case 1:
+        return "Instructions";
+
+      default:
+        return NULL;
+    }
+}
+
+#endif /* CONFIG_RV32IM_PMU */
@@ -52,6 +52,24 @@
 #define SP_UNLOCKED false  /* The Un-locked state */
 #define SP_LOCKED   true   /* The Locked state */
 
+#ifdef CONFIG_SMP
+/* The simulated CPUs are host pthreads that really do execute in parallel
+ * on a multi-core host.  up_testset() is a host atomic operation, but the
+ * compiler must still be kept from moving accesses across lock boundaries
+ * and the release of a spinlock must be visible to the other host cores.
+ */
+
+#  define SP_DMB() __sync_synchronize()
+
+/* Relax the host core while spinning on a lock */
+
+#  if defined(__i386__) || defined(__x86_64__)
+#    define SP_DSB() __asm__ __volatile__ ("pause" : : : "memory")
+#  else
+#    define SP_DSB() __asm__ __volatile__ ("" : : : "memory")
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
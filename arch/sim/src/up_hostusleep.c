@@ -37,7 +37,31 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NSEC_PER_SEC  1000000000
+#define NSEC_PER_USEC 1000
+
+/* If the simulation falls further behind the host clock than this many
+ * ticks (because the host was suspended or a debugger stopped the
+ * simulation), then give up trying to catch up.
+ */
+
+#define MAX_TICK_LAG  100
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct timespec g_nexttick;
+static bool g_tickvalid;
 
 /****************************************************************************
  * Public Functions
@@ -51,3 +75,54 @@ int up_hostusleep(unsigned int usec)
 {
   return usleep(usec);
 }
+
+/****************************************************************************
+ * Name: up_hosttickwait
+ *
+ * Description:
+ *   Wait until the next tick deadline on the host monotonic clock.  Unlike
+ *   a relative delay, the deadline advances by exactly one period each time
+ *   so that the time spent processing the tick does not accumulate as
+ *   drift.  If the simulation has fallen behind the host clock, this
+ *   returns immediately so that the missed ticks are processed back-to-
+ *   back.
+ *
+ ****************************************************************************/
+
+int up_hosttickwait(unsigned int usec)
+{
+  struct timespec now;
+  long long lag;
+  int ret;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &now) < 0)
+    {
+      return usleep(usec);
+    }
+
+  lag = (long long)(now.tv_sec - g_nexttick.tv_sec) * NSEC_PER_SEC +
+        (now.tv_nsec - g_nexttick.tv_nsec);
+
+  if (!g_tickvalid ||
+      lag > (long long)MAX_TICK_LAG * usec * NSEC_PER_USEC)
+    {
+      g_nexttick  = now;
+      g_tickvalid = true;
+    }
+
+  g_nexttick.tv_nsec += (long)usec * NSEC_PER_USEC;
+  while (g_nexttick.tv_nsec >= NSEC_PER_SEC)
+    {
+      g_nexttick.tv_nsec -= NSEC_PER_SEC;
+      g_nexttick.tv_sec++;
+    }
+
+  do
+    {
+      ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &g_nexttick,
+                            NULL);
+    }
+  while (ret == EINTR);
+
+  return ret == 0 ? 0 : -1;
+}
@@ -74,6 +74,7 @@ static int g_x11refresh = 0;
 
 #if defined(CONFIG_SIM_WALLTIME) || defined(CONFIG_SIM_X11FB)
 extern int up_hostusleep(unsigned int usec);
+extern int up_hosttickwait(unsigned int usec);
 #ifdef CONFIG_SIM_X11FB
 extern void up_x11update(void);
 #endif
@@ -111,11 +112,17 @@ void up_idle(void)
 
   if (up_testset(&lock) != SP_UNLOCKED)
     {
-      /* We didn't get it... Give other pthreads/CPUs a shot and try again
-       * later.
+      /* We didn't get it... Another CPU is processing the timer.  With
+       * SIM_WALLTIME, sleep for a tick rather than spinning on the host
+       * core; the pause signal will wake this CPU if it is given work.
+       * Otherwise, give other pthreads/CPUs a shot and try again later.
        */
 
+#ifdef CONFIG_SIM_WALLTIME
+      (void)up_hostusleep(1000000 / CLK_TCK);
+#else
       pthread_yield();
+#endif
       return;
     }
 #endif
@@ -171,7 +178,11 @@ void up_idle(void)
    * correct rate.
    */
 
+#ifdef CONFIG_SIM_WALLTIME
+  (void)up_hosttickwait(1000000 / CLK_TCK);
+#else
   (void)up_hostusleep(1000000 / CLK_TCK);
+#endif
 
   /* Handle X11-related events */
 
@@ -53,6 +53,18 @@
 #define SP_UNLOCKED   0   /* The Un-locked state */
 #define SP_LOCKED     1   /* The Locked state */
 
+/* The paused CPU normally responds within a few microseconds.  Spin on the
+ * host core for this many polls before giving the host core away.
+ */
+
+#define SIM_PAUSE_SPINS 1000
+
+#if defined(__i386__) || defined(__x86_64__)
+#  define sim_cpu_relax() __asm__ __volatile__ ("pause" : : : "memory")
+#else
+#  define sim_cpu_relax() __asm__ __volatile__ ("" : : : "memory")
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -456,20 +468,34 @@ errout_with_mutex:
 
 int up_cpu_pause(int cpu)
 {
+  int spins = 0;
+
   /* Take the spinlock that will prevent the CPU thread from running */
 
   g_cpu_wait[cpu]   = SP_LOCKED;
   g_cpu_paused[cpu] = SP_LOCKED;
+  __sync_synchronize();
 
   /* Signal the CPU thread */
 
   pthread_kill(g_sim_cputhread[cpu], SIGUSR1);
 
-  /* Spin, waiting for the thread to pause */
+  /* Spin, waiting for the thread to pause.  The CPU thread is running on
+   * another host core, so do not yield the host core unless the wait is
+   * taking a long time (as when there are more CPUs than host cores).
+   */
 
-  while (g_cpu_paused[cpu] != 0)
+  while (__atomic_load_n(&g_cpu_paused[cpu], __ATOMIC_ACQUIRE) != 0)
     {
-      pthread_yield();
+      if (spins < SIM_PAUSE_SPINS)
+        {
+          sim_cpu_relax();
+          spins++;
+        }
+      else
+        {
+          pthread_yield();
+        }
     }
 
   return 0;
@@ -498,6 +524,6 @@ int up_cpu_resume(int cpu)
 {
   /* Release the spinlock that will alloc the CPU thread to continue */
 
-  g_cpu_wait[cpu] = SP_UNLOCKED;
+  __atomic_store_n(&g_cpu_wait[cpu], SP_UNLOCKED, __ATOMIC_RELEASE);
   return 0;
 }
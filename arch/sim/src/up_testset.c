@@ -38,7 +38,6 @@
  ****************************************************************************/
 
 #include <stdint.h>
-#include <pthread.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -55,14 +54,6 @@
 
 typedef uint8_t spinlock_t;
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-#ifdef CONFIG_SMP
-static pthread_mutex_t g_tsmutex = PTHREAD_MUTEX_INITIALIZER;
-#endif
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -90,22 +81,19 @@ static pthread_mutex_t g_tsmutex = PTHREAD_MUTEX_INITIALIZER;
 spinlock_t up_testset(volatile spinlock_t *lock)
 {
 #ifdef CONFIG_SMP
-  /* In the multi-CPU SMP case, we use a mutex to assure that the following
-   * test and set is atomic.
+  /* In the multi-CPU SMP case, the CPU threads run concurrently on the host
+   * cores.  Use the host's atomic exchange so that unrelated spinlocks do
+   * not serialize the CPUs on a single, global host mutex.
    */
 
-  (void)pthread_mutex_lock(&g_tsmutex);
-#endif
-
+  return __atomic_exchange_n(lock, SP_LOCKED, __ATOMIC_ACQ_REL);
+#else
   /* In the non-SMP case, the simulation is implemented with a single thread
    * the test-and-set operation is inherently atomic.
    */
 
   spinlock_t ret = *lock;
   *lock = SP_LOCKED;
-
-#ifdef CONFIG_SMP
-  (void)pthread_mutex_unlock(&g_tsmutex);
-#endif
   return ret;
+#endif
 }
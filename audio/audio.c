@@ -53,6 +53,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
@@ -82,6 +84,27 @@
  * Private Type Definitions
  ****************************************************************************/
 
+/* This structure describes the state of the shared ring buffer */
+
+#ifdef CONFIG_AUDIO_RING
+struct audio_ring_state_s
+{
+  FAR uint8_t      *base;     /* Ring buffer memory (user heap) */
+  FAR struct ap_buffer_s *apb; /* One Audio Pipeline Buffer per period */
+  apb_samp_t        period_bytes; /* Size of one period in bytes */
+  uint8_t           nperiods; /* Number of periods (0: ring mode off) */
+  uint8_t           flags;    /* See AUDIO_RING_* definitions */
+  volatile uint8_t  inflight; /* Periods held by the lower half */
+  volatile bool     waiting;  /* True: a thread waits on waitsem */
+  volatile bool     streaming; /* True: running out of periods is an xrun */
+  volatile uint32_t hwptr;    /* Periods completed by the lower half */
+  uint32_t          applptr;  /* Periods committed by the application */
+  volatile uint32_t xruns;    /* Number of under/overruns */
+  struct timespec   tstamp;   /* Time of the last period completion */
+  sem_t             waitsem;  /* Posted when a period completes */
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct audio_upperhalf_s
@@ -91,6 +114,9 @@ struct audio_upperhalf_s
   sem_t             exclsem;  /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;   /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  struct audio_ring_state_s ring; /* Shared ring buffer state */
+#endif
 };
 
 /****************************************************************************
@@ -111,6 +137,20 @@ static int      audio_start(FAR struct audio_upperhalf_s *upper);
 static void     audio_callback(FAR void *priv, uint16_t reason,
                     FAR struct ap_buffer_s *apb, uint16_t status);
 #endif /* CONFIG_AUDIO_MULTI_SESSION */
+#ifdef CONFIG_AUDIO_RING
+static void     audio_ringfree(FAR struct audio_upperhalf_s *upper);
+static int      audio_ringsetup(FAR struct audio_upperhalf_s *upper,
+                    FAR struct audio_ring_s *setup);
+static int      audio_ringstart(FAR struct audio_upperhalf_s *upper);
+static int      audio_ringcommit(FAR struct audio_upperhalf_s *upper,
+                    unsigned int count);
+static int      audio_ringstatus(FAR struct file *filep,
+                    FAR struct audio_upperhalf_s *upper,
+                    FAR struct audio_ringstatus_s *status);
+static void     audio_ringwakeup(FAR struct audio_upperhalf_s *upper);
+static bool     audio_ringdequeue(FAR struct audio_upperhalf_s *upper,
+                    FAR struct ap_buffer_s *apb);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -233,6 +273,17 @@ static int audio_close(FAR struct file *filep)
       audinfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_AUDIO_RING
+      /* Release the ring buffer unless the lower half still holds some of
+       * its periods.
+       */
+
+      if (upper->ring.inflight == 0)
+        {
+          audio_ringfree(upper);
+        }
+#endif
     }
 
   ret = OK;
@@ -318,6 +369,16 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_RING
+      /* In ring mode, hand all capture periods to the lower half */
+
+      ret = audio_ringstart(upper);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -341,6 +402,381 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
   return ret;
 }
 
+/************************************************************************************
+ * Name: audio_ringfree
+ *
+ * Description:
+ *   Release the shared ring buffer.  The lower half must not hold any of its
+ *   periods.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_AUDIO_RING
+static void audio_ringfree(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  int i;
+
+  DEBUGASSERT(ring->inflight == 0);
+
+  if (ring->nperiods > 0)
+    {
+      for (i = 0; i < ring->nperiods; i++)
+        {
+          nxsem_destroy(&ring->apb[i].sem);
+        }
+
+      kmm_free(ring->apb);
+      kumm_free(ring->base);
+
+      ring->apb      = NULL;
+      ring->base     = NULL;
+      ring->nperiods = 0;
+    }
+}
+
+/************************************************************************************
+ * Name: audio_ringsetup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command.  Allocate one contiguous
+ *   buffer for all periods and one Audio Pipeline Buffer describing each
+ *   period.  The lower half then transfers samples directly to or from the
+ *   memory that the application reads or writes.
+ *
+ ************************************************************************************/
+
+static int audio_ringsetup(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_ring_s *setup)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  FAR struct ap_buffer_s *apb;
+  int i;
+
+  DEBUGASSERT(setup != NULL);
+
+  if (upper->started || ring->inflight > 0)
+    {
+      return -EBUSY;
+    }
+
+  /* Release any previous ring buffer */
+
+  audio_ringfree(upper);
+  setup->base = NULL;
+
+  if (setup->nperiods == 0)
+    {
+      return OK;
+    }
+
+  /* Keep every period word aligned for the benefit of DMA */
+
+  if (setup->period_bytes == 0 || (setup->period_bytes & 3) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ring->base = (FAR uint8_t *)
+    kumm_malloc((size_t)setup->period_bytes * setup->nperiods);
+  if (ring->base == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->apb = (FAR struct ap_buffer_s *)
+    kmm_zalloc(sizeof(struct ap_buffer_s) * setup->nperiods);
+  if (ring->apb == NULL)
+    {
+      kumm_free(ring->base);
+      ring->base = NULL;
+      return -ENOMEM;
+    }
+
+  memset(ring->base, 0, (size_t)setup->period_bytes * setup->nperiods);
+
+  for (i = 0; i < setup->nperiods; i++)
+    {
+      /* The upper half keeps a reference to each buffer so that the
+       * apb_free() calls of the lower half never release it.
+       */
+
+      apb             = &ring->apb[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = setup->period_bytes;
+      apb->samp       = ring->base + i * setup->period_bytes;
+      nxsem_init(&apb->sem, 0, 1);
+    }
+
+  ring->period_bytes = setup->period_bytes;
+  ring->nperiods     = setup->nperiods;
+  ring->flags        = setup->flags;
+  ring->hwptr        = 0;
+  ring->applptr      = 0;
+  ring->xruns        = 0;
+
+  setup->base = ring->base;
+  return OK;
+}
+
+/************************************************************************************
+ * Name: audio_ringenqueue
+ *
+ * Description:
+ *   Pass the period for the stream position applptr to the lower half.
+ *
+ ************************************************************************************/
+
+static int audio_ringenqueue(FAR struct audio_upperhalf_s *upper,
+                             uint32_t applptr)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct ap_buffer_s *apb = &ring->apb[applptr % ring->nperiods];
+  irqstate_t flags;
+  int ret;
+
+  apb->nbytes  = (ring->flags & AUDIO_RING_CAPTURE) != 0 ?
+                 0 : ring->period_bytes;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  /* The period may complete before enqueuebuffer() returns */
+
+  flags = enter_critical_section();
+  ring->inflight++;
+  leave_critical_section(flags);
+
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      ring->inflight--;
+      leave_critical_section(flags);
+    }
+
+  return ret;
+}
+
+/************************************************************************************
+ * Name: audio_ringstart
+ *
+ * Description:
+ *   Prepare the ring buffer when the stream is started.  Capture restarts
+ *   at period zero with every period handed to the lower half.
+ *
+ ************************************************************************************/
+
+static int audio_ringstart(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  int ret;
+  int i;
+
+  ring->streaming = ring->nperiods > 0;
+  if (ring->nperiods == 0 || (ring->flags & AUDIO_RING_CAPTURE) == 0)
+    {
+      return OK;
+    }
+
+  if (ring->inflight > 0)
+    {
+      return -EBUSY;
+    }
+
+  ring->hwptr   = 0;
+  ring->applptr = 0;
+
+  for (i = 0; i < ring->nperiods; i++)
+    {
+      ret = audio_ringenqueue(upper, i);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/************************************************************************************
+ * Name: audio_ringavail
+ *
+ * Description:
+ *   Return the number of periods available to the application.
+ *
+ ************************************************************************************/
+
+static int audio_ringavail(FAR struct audio_ring_state_s *ring)
+{
+  if ((ring->flags & AUDIO_RING_CAPTURE) != 0)
+    {
+      return (int)(ring->hwptr - ring->applptr);
+    }
+  else
+    {
+      return ring->nperiods - ring->inflight;
+    }
+}
+
+/************************************************************************************
+ * Name: audio_ringcommit
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGCOMMIT ioctl command.  Returns the number of
+ *   periods committed.
+ *
+ ************************************************************************************/
+
+static int audio_ringcommit(FAR struct audio_upperhalf_s *upper,
+                            unsigned int count)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  unsigned int i;
+  int ret;
+
+  if (ring->nperiods == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if (audio_ringavail(ring) <= 0)
+        {
+          break;
+        }
+
+      ret = audio_ringenqueue(upper, ring->applptr);
+      if (ret < 0)
+        {
+          return i > 0 ? (int)i : ret;
+        }
+
+      ring->applptr++;
+    }
+
+  return i > 0 || count == 0 ? (int)i : -EAGAIN;
+}
+
+/************************************************************************************
+ * Name: audio_ringstatus
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSTATUS ioctl command.  Called with exclsem held;
+ *   the semaphore is released while waiting for a period to complete.
+ *
+ ************************************************************************************/
+
+static int audio_ringstatus(FAR struct file *filep,
+                            FAR struct audio_upperhalf_s *upper,
+                            FAR struct audio_ringstatus_s *status)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(status != NULL);
+
+  if (ring->nperiods == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (audio_ringavail(ring) <= 0 && upper->started &&
+         (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      ring->waiting = true;
+      nxsem_post(&upper->exclsem);
+
+      ret = nxsem_wait(&ring->waitsem);
+      ring->waiting = false;
+
+      (void)nxsem_wait_uninterruptible(&upper->exclsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  status->hwptr   = ring->hwptr;
+  status->applptr = ring->applptr;
+  status->xruns   = ring->xruns;
+  status->avail   = audio_ringavail(ring);
+  status->tstamp  = ring->tstamp;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/************************************************************************************
+ * Name: audio_ringwakeup
+ *
+ * Description:
+ *   Wake up a thread waiting in AUDIOIOC_RINGSTATUS.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ************************************************************************************/
+
+static void audio_ringwakeup(FAR struct audio_upperhalf_s *upper)
+{
+  if (upper->ring.waiting)
+    {
+      upper->ring.waiting = false;
+      nxsem_post(&upper->ring.waitsem);
+    }
+}
+
+/************************************************************************************
+ * Name: audio_ringdequeue
+ *
+ * Description:
+ *   Account for a completed period of the ring buffer.  Returns false if apb
+ *   is not part of the ring buffer.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ************************************************************************************/
+
+static bool audio_ringdequeue(FAR struct audio_upperhalf_s *upper,
+                              FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_ring_state_s *ring = &upper->ring;
+  irqstate_t flags;
+
+  if (ring->nperiods == 0 || apb < ring->apb ||
+      apb >= ring->apb + ring->nperiods)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+
+  ring->hwptr++;
+  ring->inflight--;
+  (void)clock_systimespec(&ring->tstamp);
+
+  /* The lower half running out of periods while streaming is an underrun
+   * (output) or an overrun (input).
+   */
+
+  if (ring->inflight == 0 && ring->streaming)
+    {
+      ring->xruns++;
+    }
+
+  audio_ringwakeup(upper);
+  leave_critical_section(flags);
+  return true;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /************************************************************************************
  * Name: audio_ioctl
  *
@@ -457,6 +893,11 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           if (upper->started)
             {
+#ifdef CONFIG_AUDIO_RING
+              /* Periods returned while stopping are not overruns */
+
+              upper->ring.streaming = false;
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
               session = (FAR void *) arg;
               ret = lower->ops->stop(lower, session);
@@ -464,6 +905,9 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = lower->ops->stop(lower);
 #endif
               upper->started = false;
+#ifdef CONFIG_AUDIO_RING
+              audio_ringwakeup(upper);
+#endif
             }
         }
         break;
@@ -649,6 +1093,43 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSETUP - Set up or release the shared ring buffer
+       *
+       *   ioctl argument - pointer to an audio_ring_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          audinfo("AUDIOIOC_RINGSETUP\n");
+          ret = audio_ringsetup(upper, (FAR struct audio_ring_s *)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGCOMMIT - Commit periods of the ring buffer
+       *
+       *   ioctl argument - number of periods
+       */
+
+      case AUDIOIOC_RINGCOMMIT:
+        {
+          ret = audio_ringcommit(upper, (unsigned int)arg);
+        }
+        break;
+
+      /* AUDIOIOC_RINGSTATUS - Get the ring buffer state
+       *
+       *   ioctl argument - pointer to an audio_ringstatus_s structure
+       */
+
+      case AUDIOIOC_RINGSTATUS:
+        {
+          ret = audio_ringstatus(filep, upper,
+                                 (FAR struct audio_ringstatus_s *)arg);
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -709,6 +1190,15 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RING
+  /* Periods of the ring buffer are accounted for without any messages */
+
+  if (audio_ringdequeue(upper, apb))
+    {
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
@@ -750,6 +1240,11 @@ static inline void audio_complete(FAR struct audio_upperhalf_s *upper,
   /* Send a dequeue message to the user if a message queue is registered */
 
   upper->started = false;
+#ifdef CONFIG_AUDIO_RING
+  upper->ring.streaming = false;
+  audio_ringwakeup(upper);
+#endif
+
   if (upper->usermq != NULL)
     {
       msg.msgId = AUDIO_MSG_COMPLETE;
@@ -897,6 +1392,15 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev)
   nxsem_init(&upper->exclsem, 0, 1);
   upper->dev = dev;
 
+#ifdef CONFIG_AUDIO_RING
+  /* The ring wait semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  nxsem_init(&upper->ring.waitsem, 0, 0);
+  nxsem_setprotocol(&upper->ring.waitsem, SEM_PRIO_NONE);
+#endif
+
 #ifdef CONFIG_AUDIO_CUSTOM_DEV_PATH
 
 #ifdef CONFIG_AUDIO_DEV_ROOT
@@ -0,0 +1,1149 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <fixedmath.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#  error Work queue support is required (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+#if CONFIG_AUDIO_MIXER_BPSAMP != 16 && CONFIG_AUDIO_MIXER_BPSAMP != 24 && \
+    CONFIG_AUDIO_MIXER_BPSAMP != 32
+#  error Unsupported CONFIG_AUDIO_MIXER_BPSAMP
+#endif
+
+/* The low priority work queue is preferred.  If it is not enabled, LPWORK
+ * will be the same as HPWORK.
+ */
+
+#define MIXWORK             LPWORK
+
+/* Output stream format */
+
+#define MIXER_NCHANNELS     CONFIG_AUDIO_MIXER_NCHANNELS
+#define MIXER_BYTESPERSAMP  (CONFIG_AUDIO_MIXER_BPSAMP / 8)
+#define MIXER_FRAMESIZE     (MIXER_NCHANNELS * MIXER_BYTESPERSAMP)
+#define MIXER_NFRAMES       CONFIG_AUDIO_MIXER_PERIOD_FRAMES
+#define MIXER_BUFSIZE       (MIXER_NFRAMES * MIXER_FRAMESIZE)
+
+/* The largest number of channels accepted from a client */
+
+#define MIXER_MAXCHANNELS   8
+
+/* Samples are mixed as signed 24-bit values held in 32-bit integers.  That
+ * leaves 7 bits of headroom for summing the clients before clipping.
+ */
+
+#define MIXER_SAMPMAX       0x007fffff
+#define MIXER_SAMPMIN       (-0x00800000)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes one client stream of the mixer */
+
+struct audio_mixer_client_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the
+   * first element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_mixer_client_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer; /* The mixer that we belong to */
+  struct dq_queue_s queue;         /* Buffers waiting to be mixed */
+
+  /* Client stream format, see configure() */
+
+  uint32_t samprate;               /* 8000, 44100, ... */
+  uint8_t  nchannels;              /* Mono=1, Stereo=2, ... */
+  uint8_t  bpsamp;                 /* Bits per sample: 8, 16, 24 or 32 */
+  uint8_t  framesize;              /* nchannels * bpsamp / 8 */
+  bool     running;                /* True: start() has been called */
+  bool     paused;                 /* True: the stream is paused */
+
+  /* Sample rate conversion.  The stream is linearly interpolated between
+   * the two most recent input frames.  phase is the position of the next
+   * output frame past prev[] in units of input frames; step is the number
+   * of input frames per output frame.
+   */
+
+  ub16_t   step;
+  ub16_t   phase;
+  ub16_t   gain;                   /* Volume, 1.0 is unity gain */
+  int32_t  prev[MIXER_NCHANNELS];  /* Older input frame */
+  int32_t  next[MIXER_NCHANNELS];  /* Newer input frame */
+};
+
+/* This structure describes the state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The output device */
+  FAR struct audio_mixer_client_s *client; /* Clients */
+  uint8_t  nclients;                   /* Number of elements in client[] */
+  volatile bool running;               /* True: output is streaming */
+  sem_t    exclsem;                    /* Supports mutual exclusion */
+  struct work_s work;                  /* Mixing work */
+  struct dq_queue_s freeq;             /* Output buffers to be mixed */
+  FAR struct ap_buffer_s *apb[CONFIG_AUDIO_MIXER_NBUFFERS];
+  int32_t  mix[MIXER_NFRAMES * MIXER_NCHANNELS]; /* Accumulator */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Sample processing */
+
+static inline int32_t audio_mixer_getsample(FAR const uint8_t *src,
+                                            uint8_t bpsamp);
+static inline void audio_mixer_putsample(FAR uint8_t *dest, int32_t value);
+static bool audio_mixer_getframe(FAR struct audio_mixer_client_s *client,
+                                 FAR int32_t *frame);
+static void audio_mixer_mixclient(FAR struct audio_mixer_client_s *client,
+                                  FAR int32_t *mix);
+static void audio_mixer_render(FAR struct audio_mixer_s *mixer,
+                               FAR struct ap_buffer_s *apb);
+static void audio_mixer_worker(FAR void *arg);
+
+/* Output stream */
+
+static int  audio_mixer_startlower(FAR struct audio_mixer_s *mixer);
+static void audio_mixer_stoplower(FAR struct audio_mixer_s *mixer);
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+
+/* Client streams */
+
+static void audio_mixer_flush(FAR struct audio_mixer_client_s *client);
+static int  audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                                FAR struct audio_caps_s *caps);
+static int  audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                  FAR const struct audio_caps_s *caps);
+static int  audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int  audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+static int  audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int  audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int  audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int  audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                      FAR struct ap_buffer_s *apb);
+static int  audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int  audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                              unsigned long arg);
+static int  audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int  audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps */
+  audio_mixer_configure,     /* configure */
+  audio_mixer_shutdown,      /* shutdown */
+  audio_mixer_start,         /* start */
+  audio_mixer_stop,          /* stop */
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause */
+  audio_mixer_resume,        /* resume */
+#endif
+  NULL,                      /* allocbuffer */
+  NULL,                      /* freebuffer */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  audio_mixer_cancelbuffer,  /* cancel_buffer */
+  audio_mixer_ioctl,         /* ioctl */
+  NULL,                      /* read */
+  NULL,                      /* write */
+  audio_mixer_reserve,       /* reserve */
+  audio_mixer_release        /* release */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_getsample
+ *
+ * Description:
+ *   Convert one little-endian input sample to a signed 24-bit value.  8-bit
+ *   samples are unsigned, as in WAV files.
+ *
+ ****************************************************************************/
+
+static inline int32_t audio_mixer_getsample(FAR const uint8_t *src,
+                                            uint8_t bpsamp)
+{
+  switch (bpsamp)
+    {
+      case 8:
+        return ((int32_t)src[0] - 128) << 16;
+
+      case 16:
+        return (int32_t)(int16_t)((uint16_t)src[0] |
+                                  ((uint16_t)src[1] << 8)) << 8;
+
+      case 24:
+        return ((int32_t)((uint32_t)src[0] << 8 |
+                          (uint32_t)src[1] << 16 |
+                          (uint32_t)src[2] << 24)) >> 8;
+
+      default:
+        return ((int32_t)((uint32_t)src[0] |
+                          (uint32_t)src[1] << 8 |
+                          (uint32_t)src[2] << 16 |
+                          (uint32_t)src[3] << 24)) >> 8;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_putsample
+ *
+ * Description:
+ *   Clip a mixed, signed 24-bit value and store it in the output format.
+ *
+ ****************************************************************************/
+
+static inline void audio_mixer_putsample(FAR uint8_t *dest, int32_t value)
+{
+  uint32_t sample;
+
+  if (value > MIXER_SAMPMAX)
+    {
+      value = MIXER_SAMPMAX;
+    }
+  else if (value < MIXER_SAMPMIN)
+    {
+      value = MIXER_SAMPMIN;
+    }
+
+  sample = (uint32_t)value;
+
+#if CONFIG_AUDIO_MIXER_BPSAMP == 16
+  dest[0] = (uint8_t)(sample >> 8);
+  dest[1] = (uint8_t)(sample >> 16);
+#elif CONFIG_AUDIO_MIXER_BPSAMP == 24
+  dest[0] = (uint8_t)sample;
+  dest[1] = (uint8_t)(sample >> 8);
+  dest[2] = (uint8_t)(sample >> 16);
+#else
+  dest[0] = 0;
+  dest[1] = (uint8_t)sample;
+  dest[2] = (uint8_t)(sample >> 8);
+  dest[3] = (uint8_t)(sample >> 16);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getframe
+ *
+ * Description:
+ *   Read the next frame of a client stream and convert it to the output
+ *   channel layout.  Buffers that have been consumed are returned to the
+ *   client.  Returns false if the client has no more data queued.
+ *
+ * Assumptions:
+ *   The caller holds the mixer exclsem.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_getframe(FAR struct audio_mixer_client_s *client,
+                                 FAR int32_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *src;
+  int32_t in[MIXER_MAXCHANNELS];
+  int32_t sum;
+  bool final;
+  int ch;
+
+  /* Return any buffers that do not hold another complete frame */
+
+  for (; ; )
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&client->queue);
+      if (apb == NULL)
+        {
+          return false;
+        }
+
+      if (apb->curbyte + client->framesize <= apb->nbytes)
+        {
+          break;
+        }
+
+      dq_rem(&apb->dq_entry, &client->queue);
+      final = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+      client->export.upper(client->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+
+      if (final)
+        {
+          /* This was the last buffer of the stream */
+
+          client->running = false;
+          client->export.upper(client->export.priv, AUDIO_CALLBACK_COMPLETE,
+                               NULL, OK);
+          return false;
+        }
+    }
+
+  /* Convert the samples of one input frame */
+
+  src = &apb->samp[apb->curbyte];
+  for (ch = 0; ch < client->nchannels; ch++)
+    {
+      in[ch] = audio_mixer_getsample(src, client->bpsamp);
+      src   += client->bpsamp >> 3;
+    }
+
+  apb->curbyte += client->framesize;
+
+  /* Map the input channels onto the output channels.  Mono is copied to
+   * every output channel and is produced by averaging all input channels.
+   */
+
+  if (client->nchannels == MIXER_NCHANNELS)
+    {
+      for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+        {
+          frame[ch] = in[ch];
+        }
+    }
+  else if (MIXER_NCHANNELS == 1)
+    {
+      for (sum = 0, ch = 0; ch < client->nchannels; ch++)
+        {
+          sum += in[ch];
+        }
+
+      frame[0] = sum / client->nchannels;
+    }
+  else
+    {
+      for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+        {
+          frame[ch] = in[ch % client->nchannels];
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_mixclient
+ *
+ * Description:
+ *   Resample one output period of a client stream and add it to the mix.
+ *   If the client runs out of data, the rest of the period is left silent
+ *   for that client.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_mixclient(FAR struct audio_mixer_client_s *client,
+                                  FAR int32_t *mix)
+{
+  int32_t sample;
+  int frame;
+  int ch;
+
+  for (frame = 0; frame < MIXER_NFRAMES; frame++)
+    {
+      /* Advance the input until the output position lies between the
+       * prev[] and next[] frames.
+       */
+
+      while (client->phase >= b16ONE)
+        {
+          memcpy(client->prev, client->next, sizeof(client->prev));
+          if (!audio_mixer_getframe(client, client->next))
+            {
+              memcpy(client->next, client->prev, sizeof(client->next));
+              return;
+            }
+
+          client->phase -= b16ONE;
+        }
+
+      for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+        {
+          sample = client->prev[ch] +
+                   b16mulb16(client->next[ch] - client->prev[ch],
+                             (b16_t)client->phase);
+
+          if (client->gain != b16ONE)
+            {
+              sample = b16mulb16(sample, (b16_t)client->gain);
+            }
+
+          *mix++ += sample;
+        }
+
+      client->phase += client->step;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_render
+ *
+ * Description:
+ *   Mix one period of all running clients into an output buffer.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_render(FAR struct audio_mixer_s *mixer,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_client_s *client;
+  FAR uint8_t *dest;
+  int i;
+
+  memset(mixer->mix, 0, sizeof(mixer->mix));
+
+  for (i = 0; i < mixer->nclients; i++)
+    {
+      client = &mixer->client[i];
+      if (client->running && !client->paused)
+        {
+          audio_mixer_mixclient(client, mixer->mix);
+        }
+    }
+
+  dest = apb->samp;
+  for (i = 0; i < MIXER_NFRAMES * MIXER_NCHANNELS; i++)
+    {
+      audio_mixer_putsample(dest, mixer->mix[i]);
+      dest += MIXER_BYTESPERSAMP;
+    }
+
+  apb->nbytes  = MIXER_BUFSIZE;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Fill every output buffer returned by the lower half and pass it back.
+ *   If no client is running any longer, the output stream is stopped.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  bool active;
+  int ret;
+  int i;
+
+  (void)nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  while (mixer->running)
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_render(mixer, apb);
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addlast(&apb->dq_entry, &mixer->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+  /* Stop the output once the final buffers of all clients have been
+   * mixed.
+   */
+
+  for (active = false, i = 0; i < mixer->nclients; i++)
+    {
+      active |= mixer->client[i].running;
+    }
+
+  if (!active)
+    {
+      audio_mixer_stoplower(mixer);
+    }
+
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startlower
+ *
+ * Description:
+ *   Configure and start the output device and prime it with all output
+ *   buffers.
+ *
+ * Assumptions:
+ *   The caller holds the mixer exclsem.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startlower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  struct audio_caps_s caps;
+  irqstate_t flags;
+  int ret;
+
+  if (mixer->running)
+    {
+      return OK;
+    }
+
+  ret = lower->ops->reserve(lower);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to reserve the output: %d\n", ret);
+      return ret;
+    }
+
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPRATE;
+  caps.ac_controls.b[2]  = CONFIG_AUDIO_MIXER_BPSAMP;
+
+  ret = lower->ops->configure(lower, &caps);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure the output: %d\n", ret);
+      goto errout_with_reserve;
+    }
+
+  /* Mix and queue all free buffers before starting the output */
+
+  mixer->running = true;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_render(mixer, apb);
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+          goto errout_with_stop;
+        }
+    }
+
+  ret = lower->ops->start(lower);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to start the output: %d\n", ret);
+      goto errout_with_stop;
+    }
+
+  return OK;
+
+errout_with_stop:
+  mixer->running = false;
+  (void)lower->ops->stop(lower);
+
+errout_with_reserve:
+  (void)lower->ops->release(lower);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stoplower
+ *
+ * Description:
+ *   Stop the output device.  The lower half returns all output buffers
+ *   through the callback.
+ *
+ * Assumptions:
+ *   The caller holds the mixer exclsem.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stoplower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  if (mixer->running)
+    {
+      mixer->running = false;
+      (void)lower->ops->stop(lower);
+      (void)lower->ops->release(lower);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback for buffer dequeueing.  Returned output
+ *   buffers are refilled on the work queue.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE && apb != NULL)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &mixer->freeq);
+      leave_critical_section(flags);
+
+      if (mixer->running && work_available(&mixer->work))
+        {
+          (void)work_queue(MIXWORK, &mixer->work, audio_mixer_worker,
+                           mixer, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Return all buffers queued by a client.
+ *
+ * Assumptions:
+ *   The caller holds the mixer exclsem.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_client_s *client)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&client->queue))
+         != NULL)
+    {
+      client->export.upper(client->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description:
+ *   Report the capabilities of the output device.  PCM is the only format
+ *   accepted by the mixer.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = client->mixer->lower;
+  int ret;
+
+  DEBUGASSERT(lower->ops->getcaps != NULL);
+
+  ret = lower->ops->getcaps(lower, type, caps);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+    {
+      caps->ac_format.hw = (1 << (AUDIO_FMT_PCM - 1));
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Set the format of a client stream, or its volume.  The output device is
+ *   configured by the mixer itself.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+  FAR struct audio_mixer_s *mixer = client->mixer;
+  uint32_t samprate;
+  uint8_t bpsamp;
+  int ret = OK;
+
+  DEBUGASSERT(caps != NULL);
+
+  (void)nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            /* Volume is 0..1000 */
+
+            if (caps->ac_controls.hw[0] > 1000)
+              {
+                ret = -EDOM;
+                break;
+              }
+
+            client->gain = ((ub16_t)caps->ac_controls.hw[0] << 16) / 1000;
+          }
+        break;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0];
+        bpsamp   = caps->ac_controls.b[2];
+
+        if (caps->ac_channels < 1 ||
+            caps->ac_channels > MIXER_MAXCHANNELS ||
+            (bpsamp != 8 && bpsamp != 16 && bpsamp != 24 && bpsamp != 32) ||
+            samprate == 0)
+          {
+            auderr("ERROR: Unsupported format: %u ch, %u bits, %lu Hz\n",
+                   caps->ac_channels, bpsamp, (unsigned long)samprate);
+            ret = -ERANGE;
+            break;
+          }
+
+        client->samprate  = samprate;
+        client->nchannels = caps->ac_channels;
+        client->bpsamp    = bpsamp;
+        client->framesize = caps->ac_channels * (bpsamp >> 3);
+        client->step      = (ub16_t)(((uint64_t)samprate << 16) /
+                                     CONFIG_AUDIO_MIXER_SAMPRATE);
+        break;
+
+      default:
+        break;
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ *
+ * Description:
+ *   The client was closed.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+
+  if (client->running)
+    {
+      return audio_mixer_stop(dev);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a client stream.  The output device is started with the
+ *   first client.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+  FAR struct audio_mixer_s *mixer = client->mixer;
+  int ret;
+
+  if (client->framesize == 0)
+    {
+      /* Not configured */
+
+      return -EINVAL;
+    }
+
+  (void)nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  /* Start from silence so that the first frame is faded in */
+
+  memset(client->prev, 0, sizeof(client->prev));
+  memset(client->next, 0, sizeof(client->next));
+  client->phase   = b16ONE;
+  client->paused  = false;
+  client->running = true;
+
+  ret = audio_mixer_startlower(mixer);
+  if (ret < 0)
+    {
+      client->running = false;
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ *
+ * Description:
+ *   Stop mixing a client stream and return all of its buffers.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+  FAR struct audio_mixer_s *mixer = client->mixer;
+  bool active;
+  int i;
+
+  (void)nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  audio_mixer_flush(client);
+
+  if (client->running)
+    {
+      client->running = false;
+      client->export.upper(client->export.priv, AUDIO_CALLBACK_COMPLETE,
+                           NULL, OK);
+    }
+
+  for (active = false, i = 0; i < mixer->nclients; i++)
+    {
+      active |= mixer->client[i].running;
+    }
+
+  if (!active)
+    {
+      audio_mixer_stoplower(mixer);
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_pause and audio_mixer_resume
+ *
+ * Description:
+ *   A paused client contributes silence; the output keeps running.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+
+  client->paused = true;
+  return OK;
+}
+
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+
+  client->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue a client buffer for mixing.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_client_s *client =
+    (FAR struct audio_mixer_client_s *)dev;
+  FAR struct audio_mixer_s *mixer = client->mixer;
+
+  DEBUGASSERT(apb != NULL);
+
+  (void)nxsem_wait_uninterruptible(&mixer->exclsem);
+  dq_addlast(&apb->dq_entry, &client->queue);
+  nxsem_post(&mixer->exclsem);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_cancelbuffer
+ *
+ * Description:
+ *   Cancel a previously enqueued buffer.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                    FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ *
+ * Description:
+ *   The output device is shared, so device-specific ioctl commands are not
+ *   passed to it by the clients.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve and audio_mixer_release
+ *
+ * Description:
+ *   Clients do not need a reservation; the mixer reserves the output device
+ *   while it is streaming.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a software mixer in front of an audio output device.  See
+ *   include/nuttx/audio/audio_mixer.h.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev, int nclients,
+                           FAR struct audio_lowerhalf_s **clients)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct audio_mixer_client_s *client;
+  struct audio_buf_desc_s bufdesc;
+  int ret;
+  int i;
+
+  DEBUGASSERT(dev != NULL && clients != NULL);
+
+  if (nclients < 1 || nclients > 255)
+    {
+      return -EINVAL;
+    }
+
+  mixer = (FAR struct audio_mixer_s *)
+    kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->client = (FAR struct audio_mixer_client_s *)
+    kmm_zalloc(nclients * sizeof(struct audio_mixer_client_s));
+  if (mixer->client == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_mixer;
+    }
+
+  /* Allocate the output buffers.  They are kept for the life of the mixer
+   * because the lower half may return them at any time after a stop.
+   */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      bufdesc.numbytes   = MIXER_BUFSIZE;
+      bufdesc.u.ppBuffer = &mixer->apb[i];
+
+      if (dev->ops->allocbuffer != NULL)
+        {
+          ret = dev->ops->allocbuffer(dev, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to allocate output buffer: %d\n", ret);
+          goto errout_with_buffers;
+        }
+
+      dq_addlast(&mixer->apb[i]->dq_entry, &mixer->freeq);
+    }
+
+  nxsem_init(&mixer->exclsem, 0, 1);
+  mixer->lower    = dev;
+  mixer->nclients = nclients;
+
+  /* Our callback receives the output buffers back from the device */
+
+  dev->upper = audio_mixer_callback;
+  dev->priv  = mixer;
+
+  for (i = 0; i < nclients; i++)
+    {
+      client             = &mixer->client[i];
+      client->export.ops = &g_audio_mixer_ops;
+      client->mixer      = mixer;
+      client->gain       = b16ONE;
+      clients[i]         = &client->export;
+    }
+
+  return OK;
+
+errout_with_buffers:
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS && mixer->apb[i] != NULL; i++)
+    {
+      if (dev->ops->freebuffer != NULL)
+        {
+          bufdesc.u.pBuffer = mixer->apb[i];
+          (void)dev->ops->freebuffer(dev, &bufdesc);
+        }
+      else
+        {
+          apb_free(mixer->apb[i]);
+        }
+    }
+
+  kmm_free(mixer->client);
+
+errout_with_mixer:
+  kmm_free(mixer);
+  return ret;
+}
+
+#endif /* CONFIG_AUDIO_MIXER */
@@ -46,6 +46,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -67,6 +68,23 @@
 #  define CONFIG_ELF_BUFFERSIZE 128
 #endif
 
+#ifndef CONFIG_ELF_RELOCATION_BUFFERCOUNT
+#  define CONFIG_ELF_RELOCATION_BUFFERCOUNT 64
+#endif
+
+#if CONFIG_ELF_RELOCATION_BUFFERCOUNT < 1
+#  undef CONFIG_ELF_RELOCATION_BUFFERCOUNT
+#  define CONFIG_ELF_RELOCATION_BUFFERCOUNT 1
+#endif
+
+#ifndef CONFIG_ELF_SYMBOL_CACHECOUNT
+#  define CONFIG_ELF_SYMBOL_CACHECOUNT 32
+#endif
+
+#ifndef MIN
+#  define MIN(x,y) ((x) > (y) ? (y) : (x))
+#endif
+
 #ifdef CONFIG_ELF_DUMPBUFFER
 # define elf_dumpbuffer(m,b,n) binfodumpbuffer(m,b,n)
 #else
@@ -77,6 +95,29 @@
  * Private Types
  ****************************************************************************/
 
+/* One entry in the cache of resolved symbols.  Most relocations refer to a
+ * small number of symbols (the section symbols and a few imports), so
+ * this avoids re-reading and re-resolving the same symbol over and over.
+ */
+
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+struct elf_symcache_s
+{
+  int               idx;         /* Symbol table index (-1 if unused) */
+  Elf32_Sym         sym;         /* Symbol with the resolved st_value */
+};
+#endif
+
+/* Working buffers used while binding */
+
+struct elf_bindbuf_s
+{
+  FAR Elf32_Rel    *rels;        /* Block of relocation entries */
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  FAR struct elf_symcache_s *cache; /* Cache of resolved symbols */
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -86,34 +127,93 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: elf_readrel
+ * Name: elf_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read a block of up to CONFIG_ELF_RELOCATION_BUFFERCOUNT ELF32_Rel
+ *   structures into memory with a single read.
  *
  ****************************************************************************/
 
-static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
+static inline int elf_readrels(FAR struct elf_loadinfo_s *loadinfo,
+                               FAR const Elf32_Shdr *relsec,
+                               int index, FAR Elf32_Rel *rels, int nrels)
 {
   off_t offset;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the block lies within the relocation section */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || nrels < 1 ||
+      index + nrels > (relsec->sh_size / sizeof(Elf32_Rel)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return elf_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return elf_read(loadinfo, (FAR uint8_t *)rels,
+                  nrels * sizeof(Elf32_Rel), offset);
+}
+
+/****************************************************************************
+ * Name: elf_getsym
+ *
+ * Description:
+ *   Read the symbol at 'symidx' and get its value, using the cache of
+ *   resolved symbols if possible.  Only successfully resolved symbols are
+ *   cached.
+ *
+ * Returned Value:
+ *   Same as elf_symvalue().
+ *
+ ****************************************************************************/
+
+static int elf_getsym(FAR struct elf_loadinfo_s *loadinfo,
+                      FAR struct elf_bindbuf_s *bindbuf, int symidx,
+                      FAR Elf32_Sym *sym,
+                      FAR const struct symtab_s *exports, int nexports)
+{
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  FAR struct elf_symcache_s *entry =
+    &bindbuf->cache[symidx % CONFIG_ELF_SYMBOL_CACHECOUNT];
+#endif
+  int ret;
+
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  if (entry->idx == symidx)
+    {
+      memcpy(sym, &entry->sym, sizeof(Elf32_Sym));
+      return OK;
+    }
+#endif
+
+  /* Read the symbol table entry into memory */
+
+  ret = elf_readsym(loadinfo, symidx, sym);
+  if (ret < 0)
+    {
+      berr("Failed to read symbol[%d]: %d\n", symidx, ret);
+      return ret;
+    }
+
+  /* Get the value of the symbol (in sym.st_value) */
+
+  ret = elf_symvalue(loadinfo, sym, exports, nexports);
+
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  if (ret == OK)
+    {
+      entry->idx = symidx;
+      memcpy(&entry->sym, sym, sizeof(Elf32_Sym));
+    }
+#endif
+
+  return ret;
 }
 
 /****************************************************************************
@@ -129,15 +229,18 @@ static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
+                        FAR struct elf_bindbuf_s *bindbuf,
                         FAR const struct symtab_s *exports, int nexports)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  FAR Elf32_Rel  *rel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  int             nrels;
+  int             nbuffered;
   int             symidx;
   int             ret;
   int             i;
@@ -145,41 +248,46 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
+   *
+   * The relocation entries are read in blocks of
+   * CONFIG_ELF_RELOCATION_BUFFERCOUNT entries rather than one at a time.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels     = relsec->sh_size / sizeof(Elf32_Rel);
+  nbuffered = 0;
+  rel       = bindbuf->rels;
+
+  for (i = 0; i < nrels; i++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next block of relocation entries into memory */
 
-      ret = elf_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if (nbuffered == 0)
         {
-          berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          nbuffered = MIN(nrels - i, CONFIG_ELF_RELOCATION_BUFFERCOUNT);
+          rel       = bindbuf->rels;
+
+          ret = elf_readrels(loadinfo, relsec, i, rel, nbuffered);
+          if (ret < 0)
+            {
+              berr("Section %d reloc %d: Failed to read relocation entries: "
+                   "%d\n", relidx, i, ret);
+              return ret;
+            }
         }
 
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
-
-      /* Read the symbol table entry into memory */
-
-      ret = elf_readsym(loadinfo, symidx, &sym);
-      if (ret < 0)
-        {
-          berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-               relidx, i, symidx, ret);
-          return ret;
-        }
+      symidx = ELF32_R_SYM(rel->r_info);
 
-      /* Get the value of the symbol (in sym.st_value) */
+      /* Read the symbol table entry and get the value of the symbol (in
+       * sym.st_value)
+       */
 
-      ret = elf_symvalue(loadinfo, &sym, exports, nexports);
+      ret = elf_getsym(loadinfo, bindbuf, symidx, &sym, exports, nexports);
       if (ret < 0)
         {
           /* The special error -ESRCH is returned only in one condition:  The
@@ -208,29 +316,33 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           berr("Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           berr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
           return ret;
         }
+
+      rel++;
+      nbuffered--;
     }
 
   return OK;
 }
 
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
+                           FAR struct elf_bindbuf_s *bindbuf,
                            FAR const struct symtab_s *exports, int nexports)
 {
   berr("Not implemented\n");
@@ -257,6 +369,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  struct elf_bindbuf_s bindbuf;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -282,6 +395,34 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return -ENOMEM;
     }
 
+  /* Allocate the buffers used to read relocation entries in blocks and to
+   * cache resolved symbols.
+   */
+
+  bindbuf.rels = (FAR Elf32_Rel *)
+    kmm_malloc(CONFIG_ELF_RELOCATION_BUFFERCOUNT * sizeof(Elf32_Rel));
+  if (bindbuf.rels == NULL)
+    {
+      berr("Failed to allocate the relocation buffer\n");
+      return -ENOMEM;
+    }
+
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  bindbuf.cache = (FAR struct elf_symcache_s *)
+    kmm_malloc(CONFIG_ELF_SYMBOL_CACHECOUNT * sizeof(struct elf_symcache_s));
+  if (bindbuf.cache == NULL)
+    {
+      berr("Failed to allocate the symbol cache\n");
+      kmm_free(bindbuf.rels);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_ELF_SYMBOL_CACHECOUNT; i++)
+    {
+      bindbuf.cache[i].idx = -1;
+    }
+#endif
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -292,7 +433,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       berr("ERROR: elf_addrenv_select() failed: %d\n", ret);
-      return ret;
+      goto errout_with_bindbuf;
     }
 #endif
 
@@ -321,11 +462,12 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, &bindbuf, exports, nexports);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = elf_relocateadd(loadinfo, i, exports, nexports);
+          ret = elf_relocateadd(loadinfo, i, &bindbuf, exports,
+                                nexports);
         }
 
       if (ret < 0)
@@ -370,5 +512,12 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
 #endif
 
+#ifdef CONFIG_ARCH_ADDRENV
+errout_with_bindbuf:
+#endif
+#if CONFIG_ELF_SYMBOL_CACHECOUNT > 0
+  kmm_free(bindbuf.cache);
+#endif
+  kmm_free(bindbuf.rels);
   return ret;
 }
@@ -189,7 +189,7 @@ int elf_loadctors(FAR struct elf_loadinfo_s *loadinfo)
 
           for (i = 0; i < loadinfo->nctors; i++)
             {
-              FAR uintptr_t *ptr = (uintptr_t *)((FAR void *)(&loadinfo->ctors)[i]);
+              FAR uintptr_t *ptr = (FAR uintptr_t *)&loadinfo->ctors[i];
 
               binfo("ctor %d: %08lx + %08lx = %08lx\n",
                     i, *ptr, (unsigned long)loadinfo->textalloc,
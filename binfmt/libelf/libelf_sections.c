@@ -230,6 +230,46 @@ int elf_loadshdrs(FAR struct elf_loadinfo_s *loadinfo)
   return ret;
 }
 
+/****************************************************************************
+ * Name: elf_loadshstrtab
+ *
+ * Description:
+ *   Read the whole section name string table into memory so that sections
+ *   can be found by name without reading each name from the file.
+ *
+ ****************************************************************************/
+
+static int elf_loadshstrtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR const Elf32_Shdr *shstr;
+  FAR char *strtab;
+  int ret;
+
+  if (loadinfo->ehdr.e_shstrndx == SHN_UNDEF)
+    {
+      return -EINVAL;
+    }
+
+  shstr  = &loadinfo->shdr[loadinfo->ehdr.e_shstrndx];
+  strtab = (FAR char *)kmm_malloc(shstr->sh_size + 1);
+  if (strtab == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = elf_read(loadinfo, (FAR uint8_t *)strtab, shstr->sh_size,
+                 shstr->sh_offset);
+  if (ret < 0)
+    {
+      kmm_free(strtab);
+      return ret;
+    }
+
+  strtab[shstr->sh_size] = '\0';
+  loadinfo->shstrtab = strtab;
+  return OK;
+}
+
 /****************************************************************************
  * Name: elf_findsection
  *
@@ -253,6 +293,32 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
   int ret;
   int i;
 
+  /* Buffer the section names the first time that a section is looked up.
+   * If that fails, then fall back to reading each name from the file.
+   */
+
+  if (loadinfo->shstrtab == NULL)
+    {
+      (void)elf_loadshstrtab(loadinfo);
+    }
+
+  if (loadinfo->shstrtab != NULL)
+    {
+      size_t strsize = loadinfo->shdr[loadinfo->ehdr.e_shstrndx].sh_size;
+
+      for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+        {
+          shdr = &loadinfo->shdr[i];
+          if (shdr->sh_name < strsize &&
+              strcmp(&loadinfo->shstrtab[shdr->sh_name], sectname) == 0)
+            {
+              return i;
+            }
+        }
+
+      return -ENOENT;
+    }
+
   /* Search through the shdr[] array in loadinfo for a section named 'sectname' */
 
   for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
@@ -115,6 +115,12 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->shdr      = NULL;
     }
 
+  if (loadinfo->shstrtab)
+    {
+      kmm_free((FAR void *)loadinfo->shstrtab);
+      loadinfo->shstrtab  = NULL;
+    }
+
   if (loadinfo->iobuffer)
     {
       kmm_free((FAR void *)loadinfo->iobuffer);
@@ -189,7 +189,7 @@ static int pcode_run(FAR char *exepath, size_t varsize, size_t strsize)
 
   /* Load the POFF file into memory */
 
-  st = pload(exepath, varsize, varsize);
+  st = pload(exepath, varsize, strsize);
   if (!st)
     {
       berr("ERROR: Could not load %s\n", exepath);
@@ -198,7 +198,13 @@ static int pcode_run(FAR char *exepath, size_t varsize, size_t strsize)
 
   binfo("Loaded %s\n", exepath);
 
-  /* Execute the P-Code program until a stopping condition occurs */
+  /* Execute the P-Code program until a stopping condition occurs.
+   *
+   * NOTE: Instruction decode and dispatch happen inside pexec() in the
+   * apps/interpreters/pcode library.  Changes to the dispatch scheme
+   * (threaded code, superinstructions, stack caching) belong there; this
+   * loop only calls it once per instruction.
+   */
 
   for (; ; )
     {
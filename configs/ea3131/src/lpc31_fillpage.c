@@ -403,20 +403,28 @@ static inline void lpc31_initsrc(void)
 
 /* Version 1:  Supports blocking fill operations */
 
-int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
+/****************************************************************************
+ * Name: lpc31_fillpages
+ *
+ * Description:
+ *   Read npages of data into the page memory at vpage from the paging
+ *   source.  File offset 0 corresponds to PG_LOCKED_VBASE.
+ *
+ ****************************************************************************/
+
+static int lpc31_fillpages(FAR void *vpage, unsigned int npages)
 {
 #if defined(CONFIG_PAGING_BINPATH)
   ssize_t nbytes;
+  size_t  nread;
   off_t   offset;
   off_t   pos;
 #elif defined(CONFIG_PAGING_M25PX) || defined(CONFIG_PAGING_AT45DB)
   ssize_t nbytes;
+  size_t  nread;
   off_t   offset;
 #endif
 
-  pginfo("TCB: %p vpage: %p far: %08x\n", tcb, vpage, tcb->xcp.far);
-  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
-
   /* If BINPATH is defined, then it is the full path to a file on a mounted file
    * system.  In this case initialization will be deferred until the first
    * time that up_fillpage() is called.  Are we initialized?
@@ -432,7 +440,8 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
    * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE);
+  nread  = (size_t)npages << PAGESHIFT;
 
   /* Seek to that position */
 
@@ -441,8 +450,8 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
 
   /* And read the page data from that offset */
 
-  nbytes = nx_read(g_pgsrc.fd, vpage, PAGESIZE);
-  DEBUGASSERT(nbytes == PAGESIZE);
+  nbytes = nx_read(g_pgsrc.fd, vpage, nread);
+  DEBUGASSERT(nbytes == (ssize_t)nread);
   return OK;
 
 #elif defined(CONFIG_PAGING_M25PX) || defined(CONFIG_PAGING_AT45DB) /* !CONFIG_PAGING_BINPATH */
@@ -455,12 +464,14 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
    * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE + CONFIG_EA3131_PAGING_BINOFFSET;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE) +
+           CONFIG_EA3131_PAGING_BINOFFSET;
+  nread  = (size_t)npages << PAGESHIFT;
 
-  /* Read the page at the correct offset into the SPI FLASH device */
+  /* Read the pages at the correct offset into the SPI FLASH device */
 
-  nbytes = MTD_READ(g_pgsrc.mtd, offset, PAGESIZE, (FAR uint8_t *)vpage);
-  DEBUGASSERT(nbytes == PAGESIZE);
+  nbytes = MTD_READ(g_pgsrc.mtd, offset, nread, (FAR uint8_t *)vpage);
+  DEBUGASSERT(nbytes == (ssize_t)nread);
   return OK;
 
 #else /* !CONFIG_PAGING_BINPATH && !CONFIG_PAGING_M25PX && !CONFIG_PAGING_AT45DB */
@@ -471,6 +482,30 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
 #endif /* !CONFIG_PAGING_BINPATH && !CONFIG_PAGING_M25PX && !CONFIG_PAGING_AT45DB */
 }
 
+int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
+{
+  pginfo("TCB: %p vpage: %p far: %08x\n", tcb, vpage, tcb->xcp.far);
+  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
+
+  return lpc31_fillpages(vpage, 1);
+}
+
+#ifdef CONFIG_PAGING_READAHEAD
+int up_fillpages(FAR void *vpage, unsigned int npages)
+{
+  pginfo("vpage: %p npages: %u\n", vpage, npages);
+  DEBUGASSERT((uintptr_t)vpage >= PG_PAGED_VBASE &&
+              (uintptr_t)vpage + ((uintptr_t)npages << PAGESHIFT) <=
+              PG_PAGED_VEND);
+
+  /* The pages are contiguous in both the virtual address space and in the
+   * paging source so they can be read in a single transfer.
+   */
+
+  return lpc31_fillpages(vpage, npages);
+}
+#endif
+
 #else /* CONFIG_PAGING_BLOCKINGFILL */
 
 /* Version 2:  Supports non-blocking, asynchronous fill operations */
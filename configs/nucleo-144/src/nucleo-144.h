@@ -238,9 +238,7 @@ int stm32_spidev_bus_test(void);
  *
  ************************************************************************************/
 
-void stm32_dma_alloc_init(void);
-
-#if defined (CONFIG_FAT_DMAMEMORY)
+#if defined(CONFIG_FAT_DMAMEMORY) || defined(CONFIG_ARMV7M_DMAPOOL)
 int stm32_dma_alloc_init(void);
 #endif
 
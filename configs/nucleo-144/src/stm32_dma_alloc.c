@@ -42,9 +42,10 @@
 #include <errno.h>
 #include <nuttx/mm/gran.h>
 
+#include "dmamap.h"
 #include "nucleo-144.h"
 
-#if defined(CONFIG_FAT_DMAMEMORY)
+#if defined(CONFIG_FAT_DMAMEMORY) || defined(CONFIG_ARMV7M_DMAPOOL)
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -60,7 +61,9 @@
  * Private Data
  ************************************************************************************/
 
+#ifndef CONFIG_ARMV7M_DMAPOOL
 static GRAN_HANDLE dma_allocator;
+#endif
 
 /* The DMA heap size constrains the total number of things that can be
  * ready to do DMA at a time.
@@ -72,7 +75,16 @@ static GRAN_HANDLE dma_allocator;
  * to guarantee alignment for the largest STM32 DMA burst (16 beats x 32bits).
  */
 
+#ifdef CONFIG_ARMV7M_DMAPOOL
+/* The heap is the non-cacheable DMA memory pool.  If the MPU is used to
+ * make it non-cacheable, it must be aligned to its size.
+ */
+
+static uint8_t g_dma_heap[BOARD_DMA_ALLOC_POOL_SIZE]
+  __attribute__((aligned(BOARD_DMA_ALLOC_POOL_SIZE)));
+#else
 static uint8_t g_dma_heap[BOARD_DMA_ALLOC_POOL_SIZE] __attribute__((aligned(64)));
+#endif
 
 /************************************************************************************
  * Public Functions
@@ -89,6 +101,9 @@ static uint8_t g_dma_heap[BOARD_DMA_ALLOC_POOL_SIZE] __attribute__((aligned(64))
 
 int stm32_dma_alloc_init(void)
 {
+#ifdef CONFIG_ARMV7M_DMAPOOL
+  return arch_dma_poolinit(g_dma_heap, sizeof(g_dma_heap));
+#else
   dma_allocator = gran_initialize(g_dma_heap,
                                   sizeof(g_dma_heap),
                                   7,  /* 128B granule - must be > alignment (XXX bug?) */
@@ -100,18 +115,29 @@ int stm32_dma_alloc_init(void)
     }
 
   return OK;
+#endif
 }
 
 /* DMA-aware allocator stubs for the FAT filesystem. */
 
+#ifdef CONFIG_FAT_DMAMEMORY
 void *fat_dma_alloc(size_t size)
 {
+#ifdef CONFIG_ARMV7M_DMAPOOL
+  return arch_dma_alloc(size);
+#else
   return gran_alloc(dma_allocator, size);
+#endif
 }
 
 void fat_dma_free(FAR void *memory, size_t size)
 {
+#ifdef CONFIG_ARMV7M_DMAPOOL
+  arch_dma_free(memory, size);
+#else
   gran_free(dma_allocator, memory, size);
+#endif
 }
+#endif
 
-#endif /* CONFIG_FAT_DMAMEMORY */
+#endif /* CONFIG_FAT_DMAMEMORY || CONFIG_ARMV7M_DMAPOOL */
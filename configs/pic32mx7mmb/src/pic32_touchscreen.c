@@ -510,7 +510,7 @@ static void tc_notify(FAR struct tc_dev_s *priv)
         {
           fds->revents |= POLLIN;
           iinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 #endif
@@ -41,6 +41,7 @@
 
 #include <stdlib.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/userspace.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/mm/mm.h>
@@ -105,6 +106,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 
   .us_heap          = &g_mmheap,
 
+  /* Copy of the clock maintained by the kernel (see include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_USERTIME
+  .us_clock         = &g_clock_usertime,
+#endif
+
   /* Task/thread startup routines */
 
   .task_startup     = task_startup,
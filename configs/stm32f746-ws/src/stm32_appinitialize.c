@@ -93,7 +93,7 @@ int board_app_initialize(void)
 
   stm32_i2ctool();
 
-#if defined(CONFIG_FAT_DMAMEMORY)
+#if defined(CONFIG_FAT_DMAMEMORY) || defined(CONFIG_ARMV7M_DMAPOOL)
   if (stm32_dma_alloc_init() < 0)
     {
       syslog(LOG_ERR, "DMA alloc FAILED");
@@ -131,7 +131,7 @@ int stm32_sdio_initialize(void);
  *
  ************************************************************************************/
 
-#if defined (CONFIG_FAT_DMAMEMORY)
+#if defined(CONFIG_FAT_DMAMEMORY) || defined(CONFIG_ARMV7M_DMAPOOL)
 int stm32_dma_alloc_init(void);
 #endif
 
@@ -44,6 +44,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/clock.h>
 #include <nuttx/userspace.h>
 
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
@@ -106,6 +107,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 
   .us_heap          = &g_mmheap,
 
+  /* Copy of the clock maintained by the kernel (see include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_USERTIME
+  .us_clock         = &g_clock_usertime,
+#endif
+
   /* Task/thread startup routines */
 
   .task_startup     = task_startup,
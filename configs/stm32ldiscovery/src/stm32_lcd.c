@@ -1445,7 +1445,7 @@ static int slcd_poll(FAR struct file *filep, FAR struct pollfd *fds,
       fds->revents |= (fds->events & (POLLIN|POLLOUT));
       if (fds->revents != 0)
         {
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
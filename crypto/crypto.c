@@ -42,33 +42,350 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <semaphore.h>
 #include <poll.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is used by crypto_cypher() to wait for an asynchronous request */
+
+struct crypto_waiter_s
+{
+  sem_t cw_sem;                 /* Posted when the request completes */
+  int cw_result;                /* Result of the request */
+};
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
+static void crypto_lock(void);
+static void crypto_done(FAR struct crypto_req_s *req, int result);
+
+#ifdef CONFIG_CRYPTO_AES
+static bool crypto_arch_supported(FAR struct crypto_engine_s *engine,
+                                  int mode, uint32_t keysize);
+static int  crypto_arch_cypher(FAR struct crypto_engine_s *engine,
+                               FAR struct crypto_req_s *req);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* The list of registered engines, sorted by decreasing priority */
+
+static FAR struct crypto_engine_s *g_crypto_engines;
+static sem_t g_crypto_sem = SEM_INITIALIZER(1);
+
+#ifdef CONFIG_CRYPTO_AES
+/* The architecture-specific aes_cypher() is registered as an engine, too */
+
+static const struct crypto_engine_ops_s g_crypto_arch_ops =
+{
+  crypto_arch_supported,  /* supported */
+  crypto_arch_cypher      /* cypher */
+};
+
+static struct crypto_engine_s g_crypto_arch_engine =
+{
+  NULL,                   /* ce_flink */
+  "aes-arch",             /* ce_name */
+  &g_crypto_arch_ops,     /* ce_ops */
+  CRYPTO_ENGINE_HARDWARE, /* ce_flags */
+  CRYPTO_PRIO_HARDWARE    /* ce_priority */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: crypto_lock
+ ****************************************************************************/
+
+static void crypto_lock(void)
+{
+  nxsem_wait_uninterruptible(&g_crypto_sem);
+}
+
+/****************************************************************************
+ * Name: crypto_done
+ *
+ * Description:
+ *   Completion callback of an asynchronous request started by
+ *   crypto_cypher().  This may run in interrupt context.
+ *
+ ****************************************************************************/
+
+static void crypto_done(FAR struct crypto_req_s *req, int result)
+{
+  FAR struct crypto_waiter_s *waiter = (FAR struct crypto_waiter_s *)
+                                       req->cr_arg;
+
+  waiter->cw_result = result;
+  nxsem_post(&waiter->cw_sem);
+}
+
+#ifdef CONFIG_CRYPTO_AES
+/****************************************************************************
+ * Name: crypto_arch_supported
+ *
+ * Description:
+ *   The architecture-specific aes_cypher() implementations differ in the
+ *   modes and key sizes that they support.  If the software AES engine is
+ *   available, only claim the subset that all of them support (AES-128 in
+ *   ECB and CBC modes) and leave the rest to software.  Otherwise, claim
+ *   everything and let aes_cypher() reject what it cannot do.
+ *
+ ****************************************************************************/
+
+static bool crypto_arch_supported(FAR struct crypto_engine_s *engine,
+                                  int mode, uint32_t keysize)
+{
+#ifdef CONFIG_CRYPTO_SW_AES
+  mode &= AES_MODE_MASK;
+  return keysize == 16 && (mode == AES_MODE_ECB || mode == AES_MODE_CBC);
+#else
+  return true;
+#endif
+}
+
+/****************************************************************************
+ * Name: crypto_arch_cypher
+ ****************************************************************************/
+
+static int crypto_arch_cypher(FAR struct crypto_engine_s *engine,
+                              FAR struct crypto_req_s *req)
+{
+  return aes_cypher(req->cr_out, req->cr_in, req->cr_size, req->cr_iv,
+                    req->cr_key, req->cr_keysize, req->cr_mode,
+                    req->cr_encrypt);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-int up_cryptoinitialize(void)
+/****************************************************************************
+ * Name: crypto_register
+ *
+ * Description:
+ *   Register a crypto engine.  The engine structure must persist until it is
+ *   unregistered.
+ *
+ ****************************************************************************/
+
+int crypto_register(FAR struct crypto_engine_s *engine)
 {
-#ifdef CONFIG_CRYPTO_ALGTEST
+  FAR struct crypto_engine_s **next;
+
+  DEBUGASSERT(engine != NULL && engine->ce_ops != NULL &&
+              engine->ce_ops->supported != NULL &&
+              engine->ce_ops->cypher != NULL);
+
+  crypto_lock();
+
+  for (next = &g_crypto_engines; *next != NULL; next = &(*next)->ce_flink)
+    {
+      if (*next == engine)
+        {
+          nxsem_post(&g_crypto_sem);
+          return -EEXIST;
+        }
+    }
+
+  /* Keep the list sorted by decreasing priority so that the first
+   * supporting engine found is the best one.
+   */
+
+  for (next = &g_crypto_engines;
+       *next != NULL && (*next)->ce_priority >= engine->ce_priority;
+       next = &(*next)->ce_flink)
+    {
+    }
+
+  engine->ce_flink = *next;
+  *next            = engine;
+
+  nxsem_post(&g_crypto_sem);
+  cryptinfo("Registered %s\n", engine->ce_name);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: crypto_unregister
+ *
+ * Description:
+ *   Remove a crypto engine from the registry.
+ *
+ ****************************************************************************/
+
+int crypto_unregister(FAR struct crypto_engine_s *engine)
+{
+  FAR struct crypto_engine_s **next;
+  int ret = -ENOENT;
+
+  crypto_lock();
+
+  for (next = &g_crypto_engines; *next != NULL; next = &(*next)->ce_flink)
+    {
+      if (*next == engine)
+        {
+          *next = engine->ce_flink;
+          engine->ce_flink = NULL;
+          ret = OK;
+          break;
+        }
+    }
+
+  nxsem_post(&g_crypto_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: crypto_findengine
+ *
+ * Description:
+ *   Return the registered engine with the highest priority that supports the
+ *   mode and key size, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct crypto_engine_s *crypto_findengine(int mode, uint32_t keysize)
+{
+  FAR struct crypto_engine_s *engine;
+
+  crypto_lock();
+
+  for (engine = g_crypto_engines; engine != NULL; engine = engine->ce_flink)
+    {
+      if (engine->ce_ops->supported(engine, mode, keysize))
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&g_crypto_sem);
+  return engine;
+}
+
+/****************************************************************************
+ * Name: crypto_cypher
+ *
+ * Description:
+ *   Perform a request on an engine (or on the best engine for the request if
+ *   'engine' is NULL) and wait for it to complete.
+ *
+ ****************************************************************************/
+
+int crypto_cypher(FAR struct crypto_engine_s *engine,
+                  FAR struct crypto_req_s *req)
+{
+  struct crypto_waiter_s waiter;
   int ret;
 
+  if (engine == NULL)
+    {
+      engine = crypto_findengine(req->cr_mode, req->cr_keysize);
+      if (engine == NULL)
+        {
+          return -ENOSYS;
+        }
+    }
+
+  if ((engine->ce_flags & CRYPTO_ENGINE_ASYNC) == 0)
+    {
+      req->cr_done = NULL;
+      req->cr_arg  = NULL;
+      return engine->ce_ops->cypher(engine, req);
+    }
+
+  /* The engine may complete the request from its interrupt handler.  Sleep
+   * until it does so.  The semaphore is used for signaling and, hence,
+   * must not have priority inheritance enabled.
+   */
+
+  nxsem_init(&waiter.cw_sem, 0, 0);
+  nxsem_setprotocol(&waiter.cw_sem, SEM_PRIO_NONE);
+  waiter.cw_result = OK;
+
+  req->cr_done = crypto_done;
+  req->cr_arg  = &waiter;
+
+  ret = engine->ce_ops->cypher(engine, req);
+  if (ret == -EINPROGRESS)
+    {
+      nxsem_wait_uninterruptible(&waiter.cw_sem);
+      ret = waiter.cw_result;
+    }
+
+  nxsem_destroy(&waiter.cw_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: crypto_foreach
+ *
+ * Description:
+ *   Call the handler for each registered engine, stopping if it returns
+ *   non-zero.
+ *
+ ****************************************************************************/
+
+int crypto_foreach(crypto_handler_t handler, FAR void *arg)
+{
+  FAR struct crypto_engine_s *engine;
+  int ret = OK;
+
+  DEBUGASSERT(handler != NULL);
+
+  crypto_lock();
+
+  for (engine = g_crypto_engines; engine != NULL; engine = engine->ce_flink)
+    {
+      ret = handler(engine, arg);
+      if (ret != 0)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&g_crypto_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_cryptoinitialize
+ *
+ * Description:
+ *   Register the built-in crypto engines and run the self tests.
+ *
+ ****************************************************************************/
+
+int up_cryptoinitialize(void)
+{
+  int ret = OK;
+
+#ifdef CONFIG_CRYPTO_AES
+  (void)crypto_register(&g_crypto_arch_engine);
+#endif
+
+#ifdef CONFIG_CRYPTO_SW_AES
+  (void)aes_register_engine();
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
   ret = crypto_test();
   if (ret)
@@ -82,7 +399,4 @@ int up_cryptoinitialize(void)
 #endif
 
   return ret;
-#else
-  return OK;
-#endif
 }
@@ -0,0 +1,424 @@
+/****************************************************************************
+ * crypto/crypto_procfs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/crypto/crypto.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_CRYPTO_BENCHMARK) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_CRYPTO)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define CRYPTO_LINELEN   80
+
+/* The results buffer is grown in steps of this size */
+
+#define CRYPTO_BUFINCR   1024
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The benchmark is run once
+ * when the file is opened; read() then returns the formatted results.
+ */
+
+struct cryptoprocfs_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  FAR char *results;                 /* Formatted benchmark results */
+  size_t alloc;                      /* Allocated size of results */
+  size_t len;                        /* Bytes used in results */
+  int ret;                           /* Result of the benchmark */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     cryptoprocfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     cryptoprocfs_close(FAR struct file *filep);
+static ssize_t cryptoprocfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     cryptoprocfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     cryptoprocfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See include/nutts/fs/procfs.h
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations crypto_procfsoperations =
+{
+  cryptoprocfs_open,    /* open */
+  cryptoprocfs_close,   /* close */
+  cryptoprocfs_read,    /* read */
+  NULL,                 /* write */
+  cryptoprocfs_dup,     /* dup */
+
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  cryptoprocfs_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cryptoprocfs_append
+ *
+ * Description:
+ *   Append one line to the results buffer, growing it as needed.
+ *
+ ****************************************************************************/
+
+static int cryptoprocfs_append(FAR struct cryptoprocfs_file_s *priv,
+                               FAR const char *line, size_t linesize)
+{
+  FAR char *newbuf;
+
+  if (priv->len + linesize > priv->alloc)
+    {
+      newbuf = (FAR char *)kmm_realloc(priv->results,
+                                       priv->alloc + CRYPTO_BUFINCR);
+      if (newbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      priv->results = newbuf;
+      priv->alloc  += CRYPTO_BUFINCR;
+    }
+
+  memcpy(&priv->results[priv->len], line, linesize);
+  priv->len += linesize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_callback
+ ****************************************************************************/
+
+static int cryptoprocfs_callback(FAR const struct crypto_bench_s *result,
+                                 FAR void *arg)
+{
+  FAR struct cryptoprocfs_file_s *priv;
+  FAR const char *selftest;
+  char line[CRYPTO_LINELEN];
+  size_t linesize;
+
+  DEBUGASSERT(result != NULL && arg != NULL);
+  priv = (FAR struct cryptoprocfs_file_s *)arg;
+
+  if (result->cb_selftest == OK)
+    {
+      selftest = "pass";
+    }
+  else if (result->cb_selftest == -ENOENT)
+    {
+      selftest = "none";
+    }
+  else
+    {
+      selftest = "FAIL";
+    }
+
+  linesize = snprintf(line, CRYPTO_LINELEN, "%-12s %-2s %-3s %3u %-3s %-4s ",
+                      result->cb_engine->ce_name,
+                      (result->cb_engine->ce_flags &
+                       CRYPTO_ENGINE_HARDWARE) != 0 ? "hw" : "sw",
+                      result->cb_modename,
+                      (unsigned int)(result->cb_keysize * 8),
+                      result->cb_encrypt == CYPHER_ENCRYPT ? "enc" : "dec",
+                      selftest);
+
+  if (result->cb_result < 0)
+    {
+      linesize += snprintf(&line[linesize], CRYPTO_LINELEN - linesize,
+                           "error %d\n", result->cb_result);
+    }
+  else if (result->cb_cpb100 == 0)
+    {
+      linesize += snprintf(&line[linesize], CRYPTO_LINELEN - linesize,
+                           "%5lu.%02lu %9lu %8s\n",
+                           (unsigned long)(result->cb_kbps / 1024),
+                           (unsigned long)((result->cb_kbps % 1024) *
+                                           100 / 1024),
+                           (unsigned long)result->cb_kbps, "-");
+    }
+  else
+    {
+      linesize += snprintf(&line[linesize], CRYPTO_LINELEN - linesize,
+                           "%5lu.%02lu %9lu %5lu.%02lu\n",
+                           (unsigned long)(result->cb_kbps / 1024),
+                           (unsigned long)((result->cb_kbps % 1024) *
+                                           100 / 1024),
+                           (unsigned long)result->cb_kbps,
+                           (unsigned long)(result->cb_cpb100 / 100),
+                           (unsigned long)(result->cb_cpb100 % 100));
+    }
+
+  if (linesize >= CRYPTO_LINELEN)
+    {
+      linesize = CRYPTO_LINELEN - 1;
+    }
+
+  return cryptoprocfs_append(priv, line, linesize);
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_open
+ ****************************************************************************/
+
+static int cryptoprocfs_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode)
+{
+  FAR struct cryptoprocfs_file_s *priv;
+  static const char header[] =
+    "ENGINE       HW MOD KEY DIR TEST     MB/s     KiB/s CYCLES/B\n";
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if (((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0))
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate the open file structure */
+
+  priv = (FAR struct cryptoprocfs_file_s *)
+    kmm_zalloc(sizeof(struct cryptoprocfs_file_s));
+  if (!priv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Run the benchmark now so that the results do not change between
+   * successive reads.
+   */
+
+  priv->ret = cryptoprocfs_append(priv, header, sizeof(header) - 1);
+  if (priv->ret >= 0)
+    {
+      priv->ret = crypto_benchmark(cryptoprocfs_callback, priv);
+    }
+
+  if (priv->ret < 0)
+    {
+      ferr("ERROR: crypto_benchmark failed: %d\n", priv->ret);
+    }
+
+  /* Save the open file structure as the open-specific state in
+   * filep->f_priv.
+   */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_close
+ ****************************************************************************/
+
+static int cryptoprocfs_close(FAR struct file *filep)
+{
+  FAR struct cryptoprocfs_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct cryptoprocfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the results and the file attributes structure */
+
+  if (priv->results != NULL)
+    {
+      kmm_free(priv->results);
+    }
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_read
+ ****************************************************************************/
+
+static ssize_t cryptoprocfs_read(FAR struct file *filep, FAR char *buffer,
+                                 size_t buflen)
+{
+  FAR struct cryptoprocfs_file_s *priv;
+  off_t offset;
+  size_t copysize;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct cryptoprocfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  if (priv->ret < 0)
+    {
+      return priv->ret;
+    }
+
+  offset   = filep->f_pos;
+  copysize = procfs_memcpy(priv->results, priv->len, buffer, buflen,
+                           &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int cryptoprocfs_dup(FAR const struct file *oldp,
+                            FAR struct file *newp)
+{
+  FAR struct cryptoprocfs_file_s *oldpriv;
+  FAR struct cryptoprocfs_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct cryptoprocfs_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the results */
+
+  newpriv = (FAR struct cryptoprocfs_file_s *)
+    kmm_zalloc(sizeof(struct cryptoprocfs_file_s));
+  if (!newpriv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes and the results from the old file */
+
+  memcpy(newpriv, oldpriv, sizeof(struct cryptoprocfs_file_s));
+
+  if (oldpriv->results != NULL)
+    {
+      newpriv->results = (FAR char *)kmm_malloc(oldpriv->alloc);
+      if (newpriv->results == NULL)
+        {
+          kmm_free(newpriv);
+          return -ENOMEM;
+        }
+
+      memcpy(newpriv->results, oldpriv->results, oldpriv->len);
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptoprocfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int cryptoprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_CRYPTO_BENCHMARK && !CONFIG_FS_PROCFS_EXCLUDE_CRYPTO */
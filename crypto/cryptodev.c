@@ -42,9 +42,13 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <semaphore.h>
 #include <poll.h>
+#include <assert.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
 
@@ -55,11 +59,34 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
-#endif
+#define CRYPTODEV_MAXKEYLEN 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is one session created with CIOCGSESSION.  The crypto engine is
+ * selected once, when the session is created.
+ */
+
+struct cryptodev_session_s
+{
+  FAR struct cryptodev_session_s *cs_flink;  /* Next session of the file */
+  uint32_t cs_id;                            /* Session number */
+  int cs_mode;                               /* AES_MODE_* */
+  uint32_t cs_keylen;                        /* Key length in bytes */
+  FAR struct crypto_engine_s *cs_engine;     /* Engine to use */
+  uint8_t cs_key[CRYPTODEV_MAXKEYLEN];       /* Copy of the key */
+};
+
+/* This is the state of one open /dev/crypto */
+
+struct cryptodev_file_s
+{
+  sem_t cf_exclsem;                          /* Protects the session list */
+  uint32_t cf_nextid;                        /* Next session number */
+  FAR struct cryptodev_session_s *cf_sessions;
+};
 
 /****************************************************************************
  * Private Function Prototypes
@@ -67,6 +94,8 @@
 
 /* Character driver methods */
 
+static int cryptodev_open(FAR struct file *filep);
+static int cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
@@ -80,8 +109,8 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
-  0,                  /* open   */
-  0,                  /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   0,                  /* seek   */
@@ -98,6 +127,46 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *cf;
+
+  cf = (FAR struct cryptodev_file_s *)
+    kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (cf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&cf->cf_exclsem, 0, 1);
+  cf->cf_nextid = 1;
+
+  filep->f_priv = cf;
+  return OK;
+}
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *cf = filep->f_priv;
+  FAR struct cryptodev_session_s *cs;
+
+  DEBUGASSERT(cf != NULL);
+
+  /* Free all sessions that were not freed with CIOCFSESSION */
+
+  while ((cs = cf->cf_sessions) != NULL)
+    {
+      cf->cf_sessions = cs->cs_flink;
+      memset(cs->cs_key, 0, sizeof(cs->cs_key));
+      kmm_free(cs);
+    }
+
+  nxsem_destroy(&cf->cf_exclsem);
+  kmm_free(cf);
+  filep->f_priv = NULL;
+  return OK;
+}
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -110,59 +179,179 @@ static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
   return -EACCES;
 }
 
-static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+static int cryptodev_newsession(FAR struct cryptodev_file_s *cf,
+                                FAR struct session_op *ses)
 {
-  switch (cmd)
-  {
-  case CIOCGSESSION:
+  FAR struct cryptodev_session_s *cs;
+  FAR struct crypto_engine_s *engine;
+  int mode;
+
+  switch (ses->cipher)
     {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
+    case CRYPTO_AES_ECB:
+      mode = AES_MODE_ECB;
+      break;
+
+    case CRYPTO_AES_CBC:
+      mode = AES_MODE_CBC;
+      break;
+
+    case CRYPTO_AES_CTR:
+      mode = AES_MODE_CTR;
+      break;
+
+    default:
+      return -EINVAL;
     }
 
-  case CIOCFSESSION:
+  if (ses->keylen == 0 || ses->keylen > CRYPTODEV_MAXKEYLEN ||
+      ses->key == NULL)
     {
-      return OK;
+      return -EINVAL;
     }
 
-#ifdef CONFIG_CRYPTO_AES
-  case CIOCCRYPT:
+  /* Pick the best engine now, so that each CIOCCRYPT goes straight to it */
+
+  engine = crypto_findengine(mode, ses->keylen);
+  if (engine == NULL)
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      return -ENOSYS;
+    }
+
+  cs = (FAR struct cryptodev_session_s *)
+    kmm_zalloc(sizeof(struct cryptodev_session_s));
+  if (cs == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cs->cs_mode   = mode;
+  cs->cs_keylen = ses->keylen;
+  cs->cs_engine = engine;
+  memcpy(cs->cs_key, ses->key, ses->keylen);
+
+  nxsem_wait_uninterruptible(&cf->cf_exclsem);
+  cs->cs_id       = cf->cf_nextid++;
+  cs->cs_flink    = cf->cf_sessions;
+  cf->cf_sessions = cs;
+  nxsem_post(&cf->cf_exclsem);
+
+  cryptinfo("Session %lu uses %s\n", (unsigned long)cs->cs_id,
+            engine->ce_name);
 
-      switch (op->op)
+  ses->ses = cs->cs_id;
+  return OK;
+}
+
+static int cryptodev_freesession(FAR struct cryptodev_file_s *cf,
+                                 uint32_t id)
+{
+  FAR struct cryptodev_session_s **next;
+  FAR struct cryptodev_session_s *cs = NULL;
+
+  nxsem_wait_uninterruptible(&cf->cf_exclsem);
+
+  for (next = &cf->cf_sessions; *next != NULL; next = &(*next)->cs_flink)
+    {
+      if ((*next)->cs_id == id)
         {
-        case COP_ENCRYPT:
-          encrypt = 1;
+          cs    = *next;
+          *next = cs->cs_flink;
           break;
+        }
+    }
 
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
+  nxsem_post(&cf->cf_exclsem);
 
-        default:
-          return -EINVAL;
-        }
+  if (cs == NULL)
+    {
+      return -EINVAL;
+    }
 
-      switch (ses->cipher)
-        {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+  memset(cs->cs_key, 0, sizeof(cs->cs_key));
+  kmm_free(cs);
+  return OK;
+}
+
+static int cryptodev_crypt(FAR struct cryptodev_file_s *cf,
+                           FAR struct crypt_op *op)
+{
+  FAR struct cryptodev_session_s *cs;
+  FAR struct crypto_engine_s *engine;
+  struct crypto_req_s req;
+  uint8_t key[CRYPTODEV_MAXKEYLEN];
+  int ret;
+
+  memset(&req, 0, sizeof(req));
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+  switch (op->op)
+    {
+    case COP_ENCRYPT:
+      req.cr_encrypt = CYPHER_ENCRYPT;
+      break;
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+    case COP_DECRYPT:
+      req.cr_encrypt = CYPHER_DECRYPT;
+      break;
 
-        default:
-           return -EINVAL;
+    default:
+      return -EINVAL;
+    }
+
+  /* Find the session.  Copy what is needed so that the session may be
+   * freed by another thread while the request is in progress.
+   */
+
+  nxsem_wait_uninterruptible(&cf->cf_exclsem);
+
+  for (cs = cf->cf_sessions; cs != NULL; cs = cs->cs_flink)
+    {
+      if (cs->cs_id == op->ses)
+        {
+          break;
         }
     }
-#endif
+
+  if (cs == NULL)
+    {
+      nxsem_post(&cf->cf_exclsem);
+      return -EINVAL;
+    }
+
+  memcpy(key, cs->cs_key, cs->cs_keylen);
+  req.cr_keysize = cs->cs_keylen;
+  req.cr_mode    = cs->cs_mode;
+  req.cr_key     = key;
+  engine         = cs->cs_engine;
+
+  nxsem_post(&cf->cf_exclsem);
+
+  req.cr_out  = op->dst;
+  req.cr_in   = op->src;
+  req.cr_size = op->len;
+  req.cr_iv   = op->iv;
+
+  ret = crypto_cypher(engine, &req);
+  memset(key, 0, sizeof(key));
+  return ret;
+}
+
+static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct cryptodev_file_s *cf = filep->f_priv;
+
+  DEBUGASSERT(cf != NULL);
+
+  switch (cmd)
+  {
+  case CIOCGSESSION:
+    return cryptodev_newsession(cf, (FAR struct session_op *)arg);
+
+  case CIOCFSESSION:
+    return cryptodev_freesession(cf, *(FAR uint32_t *)arg);
+
+  case CIOCCRYPT:
+    return cryptodev_crypt(cf, (FAR struct crypt_op *)arg);
 
   default:
     return -ENOTTY;
@@ -49,6 +49,8 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +67,33 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA
+#  ifdef CONFIG_SMP
+#    define RNG_NCPUS          CONFIG_SMP_NCPUS
+#  else
+#    define RNG_NCPUS          1
+#  endif
+
+#  define RNG_RESEED_BYTES \
+     ((uint32_t)CONFIG_CRYPTO_RANDOM_POOL_CHACHA_RESEED_KB * 1024)
+#  define RNG_RESEED_TICKS \
+     SEC2TICK(CONFIG_CRYPTO_RANDOM_POOL_CHACHA_RESEED_SEC)
+
+#  define CHACHA_KEYWORDS      8
+#  define CHACHA_BLOCKWORDS    16
+#  define CHACHA_BLOCKBYTES    (4 * CHACHA_BLOCKWORDS)
+
+#  define CHACHA_QR(a,b,c,d) \
+  do \
+    { \
+      a += b; d ^= a; d = ROTL_32(d, 16); \
+      c += d; b ^= c; b = ROTL_32(b, 12); \
+      a += b; d ^= a; d = ROTL_32(d, 8); \
+      c += d; b ^= c; b = ROTL_32(b, 7); \
+    } \
+  while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -89,10 +118,26 @@ struct rng_s
   volatile uint8_t rd_rotate;
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
+  volatile uint32_t rd_generation; /* Incremented on every pool reseed */
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA
+/* Per-CPU ChaCha20 output generator.  Only accessed by the owning CPU with
+ * local interrupts disabled.
+ */
+
+struct rng_chacha_s
+{
+  uint32_t cc_key[CHACHA_KEYWORDS]; /* Current key, replaced on every use */
+  uint32_t cc_generation;           /* Pool generation of the last reseed */
+  uint32_t cc_outbytes;             /* Bytes produced since the last reseed */
+  clock_t cc_seedtime;              /* Time of the last reseed */
+  bool cc_seeded;                   /* Key has been seeded from the pool */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +153,17 @@ enum
 
 static struct rng_s g_rng;
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA
+static struct rng_chacha_s g_rng_chacha[RNG_NCPUS];
+
+/* "expand 32-byte k" */
+
+static const uint32_t g_chacha_sigma[4] =
+{
+  0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+};
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -313,6 +369,7 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+  g_rng.rd_generation++;
 }
 
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
@@ -365,6 +422,131 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA
+/****************************************************************************
+ * Name: chacha_block
+ *
+ * Description:
+ *   Produce one 64-byte ChaCha20 keystream block (RFC 7539) with an
+ *   all-zero nonce.
+ *
+ ****************************************************************************/
+
+static void chacha_block(FAR const uint32_t *key, uint32_t counter,
+                         FAR uint32_t *out)
+{
+  uint32_t x[CHACHA_BLOCKWORDS];
+  int i;
+
+  x[0]  = g_chacha_sigma[0];
+  x[1]  = g_chacha_sigma[1];
+  x[2]  = g_chacha_sigma[2];
+  x[3]  = g_chacha_sigma[3];
+
+  for (i = 0; i < CHACHA_KEYWORDS; i++)
+    {
+      x[4 + i] = key[i];
+    }
+
+  x[12] = counter;
+  x[13] = 0;
+  x[14] = 0;
+  x[15] = 0;
+
+  memcpy(out, x, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA_QR(x[0], x[4], x[8],  x[12]);
+      CHACHA_QR(x[1], x[5], x[9],  x[13]);
+      CHACHA_QR(x[2], x[6], x[10], x[14]);
+      CHACHA_QR(x[3], x[7], x[11], x[15]);
+      CHACHA_QR(x[0], x[5], x[10], x[15]);
+      CHACHA_QR(x[1], x[6], x[11], x[12]);
+      CHACHA_QR(x[2], x[7], x[8],  x[13]);
+      CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+  for (i = 0; i < CHACHA_BLOCKWORDS; i++)
+    {
+      out[i] += x[i];
+    }
+
+  explicit_bzero(x, sizeof(x));
+}
+
+/****************************************************************************
+ * Name: rng_chacha_needseed
+ *
+ * Description:
+ *   Check if a per-CPU generator must be reseeded before its next use.
+ *   Called with local interrupts disabled.
+ *
+ ****************************************************************************/
+
+static bool rng_chacha_needseed(FAR struct rng_chacha_s *cc)
+{
+  if (!cc->cc_seeded || cc->cc_generation != g_rng.rd_generation ||
+      cc->cc_outbytes >= RNG_RESEED_BYTES)
+    {
+      return true;
+    }
+
+#if CONFIG_CRYPTO_RANDOM_POOL_CHACHA_RESEED_SEC > 0
+  if (clock_systimer() - cc->cc_seedtime >= RNG_RESEED_TICKS)
+    {
+      return true;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: rng_chacha_reseed
+ *
+ * Description:
+ *   Draw a new seed from the BLAKE2Xs generator and mix it into the key of
+ *   the CPU that we are running on.  This is the only place where a
+ *   getrandom() caller takes the entropy pool semaphore.
+ *
+ ****************************************************************************/
+
+static void rng_chacha_reseed(void)
+{
+  FAR struct rng_chacha_s *cc;
+  uint32_t seed[CHACHA_KEYWORDS];
+  uint32_t generation;
+  irqstate_t flags;
+  int i;
+
+  (void)nxsem_wait_uninterruptible(&g_rng.rd_sem);
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.rd_generation;
+  nxsem_post(&g_rng.rd_sem);
+
+  /* We may have migrated to another CPU while waiting; seed whichever one
+   * we are on now.
+   */
+
+  flags = up_irq_save();
+  cc    = &g_rng_chacha[up_cpu_index()];
+
+  for (i = 0; i < CHACHA_KEYWORDS; i++)
+    {
+      cc->cc_key[i] ^= seed[i];
+    }
+
+  cc->cc_generation = generation;
+  cc->cc_outbytes   = 0;
+  cc->cc_seedtime   = clock_systimer();
+  cc->cc_seeded     = true;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_CHACHA */
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
@@ -560,6 +742,60 @@ void up_randompool_initialize(void)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA
+void getrandom(FAR void *bytes, size_t nbytes)
+{
+  FAR struct rng_chacha_s *cc;
+  FAR uint8_t *dest = bytes;
+  uint32_t block[CHACHA_BLOCKWORDS];
+  uint32_t key[CHACHA_KEYWORDS];
+  uint32_t counter;
+  irqstate_t flags;
+
+  /* Pick up this CPU's generator, reseeding it first if it is due */
+
+  for (; ; )
+    {
+      flags = up_irq_save();
+      cc    = &g_rng_chacha[up_cpu_index()];
+
+      if (!rng_chacha_needseed(cc))
+        {
+          break;
+        }
+
+      up_irq_restore(flags);
+      rng_chacha_reseed();
+    }
+
+  /* Fast key erasure: one block from the CPU key yields the next CPU key
+   * and a private key for this request, so that the old key cannot be
+   * used to recover this or any earlier output.
+   */
+
+  chacha_block(cc->cc_key, 0, block);
+  memcpy(cc->cc_key, &block[0], sizeof(cc->cc_key));
+  memcpy(key, &block[CHACHA_KEYWORDS], sizeof(key));
+  cc->cc_outbytes += MIN(nbytes, RNG_RESEED_BYTES);
+  up_irq_restore(flags);
+
+  /* Generate the output with the request key, no lock held */
+
+  for (counter = 0; nbytes > 0; counter++)
+    {
+      size_t block_size = MIN(nbytes, CHACHA_BLOCKBYTES);
+
+      chacha_block(key, counter, block);
+      memcpy(dest, block, block_size);
+
+      dest   += block_size;
+      nbytes -= block_size;
+    }
+
+  explicit_bzero(block, sizeof(block));
+  explicit_bzero(key, sizeof(key));
+}
+#else
 void getrandom(FAR void *bytes, size_t nbytes)
 {
   int ret;
@@ -581,3 +817,4 @@ void getrandom(FAR void *bytes, size_t nbytes)
   rng_buf_internal(bytes, nbytes);
   nxsem_post(&g_rng.rd_sem);
 }
+#endif
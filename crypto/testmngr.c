@@ -43,9 +43,11 @@
 #include <stdbool.h>
 #include <string.h>
 #include <poll.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
@@ -62,76 +64,401 @@
 #  define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
-#if defined(CONFIG_CRYPTO_AES)
+#define AES_TEST_IVSIZE 16
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+#  define BENCH_BUFSIZE CONFIG_CRYPTO_BENCHMARK_BUFSIZE
+#  define BENCH_TICKS   MSEC2TICK(CONFIG_CRYPTO_BENCHMARK_MSEC)
+#  if BENCH_BUFSIZE <= 0 || (BENCH_BUFSIZE % 16) != 0
+#    error CONFIG_CRYPTO_BENCHMARK_BUFSIZE must be a multiple of 16
+#  endif
+#endif
+
+#if defined(CONFIG_CRYPTO_AES) || defined(CONFIG_CRYPTO_SW_AES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The known-answer vectors of one AES mode */
+
+struct aes_testset_s
+{
+  int mode;                          /* AES_MODE_* */
+  FAR const char *name;              /* Name of the mode */
+  FAR struct cipher_testvec *enc;    /* Encryption vectors */
+  int nenc;                          /* Number of encryption vectors */
+  FAR struct cipher_testvec *dec;    /* Decryption vectors */
+  int ndec;                          /* Number of decryption vectors */
+};
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+/* State passed through crypto_foreach() by crypto_benchmark() */
+
+struct aes_benchctx_s
+{
+  crypto_bench_handler_t handler;    /* Receives each result */
+  FAR void *arg;                     /* Argument for the handler */
+  FAR uint8_t *buffer;               /* Input followed by output buffer */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct aes_testset_s g_aes_testsets[] =
+{
+  {
+    AES_MODE_ECB, "ECB",
+    aes_enc_tv_template, ARRAY_SIZE(aes_enc_tv_template),
+    aes_dec_tv_template, ARRAY_SIZE(aes_dec_tv_template)
+  },
+  {
+    AES_MODE_CBC, "CBC",
+    aes_cbc_enc_tv_template, ARRAY_SIZE(aes_cbc_enc_tv_template),
+    aes_cbc_dec_tv_template, ARRAY_SIZE(aes_cbc_dec_tv_template)
+  },
+  {
+    AES_MODE_CTR, "CTR",
+    aes_ctr_enc_tv_template, ARRAY_SIZE(aes_ctr_enc_tv_template),
+    aes_ctr_dec_tv_template, ARRAY_SIZE(aes_ctr_dec_tv_template)
+  }
+};
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+static const uint8_t g_aes_keysizes[] =
+{
+  16, 24, 32
+};
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static int do_test_aes(FAR struct cipher_testvec *test, int mode, int encrypt)
+static int do_test_aes(FAR struct crypto_engine_s *engine,
+                       FAR struct cipher_testvec *test, int mode,
+                       int encrypt)
 {
-  FAR void *out = kmm_zalloc(test->rlen);
+  struct crypto_req_s req;
+  uint8_t iv[AES_TEST_IVSIZE];
+  FAR void *out;
+  int res;
 
-  int res = aes_cypher(out, test->input, test->ilen, test->iv, test->key,
-                       test->klen, mode, encrypt);
-  if (res == OK)
+  out = kmm_zalloc(test->rlen);
+  if (out == NULL)
     {
-      res = memcmp(out, test->result, test->rlen);
+      return -ENOMEM;
+    }
+
+  /* The engine may update the IV.  Work on a copy so that the vector can
+   * be used again with the next engine.
+   */
+
+  memset(iv, 0, sizeof(iv));
+  if (test->iv != NULL)
+    {
+      memcpy(iv, test->iv, sizeof(iv));
+    }
+
+  memset(&req, 0, sizeof(req));
+  req.cr_out     = out;
+  req.cr_in      = test->input;
+  req.cr_size    = test->ilen;
+  req.cr_iv      = iv;
+  req.cr_key     = test->key;
+  req.cr_keysize = test->klen;
+  req.cr_mode    = mode;
+  req.cr_encrypt = encrypt;
+
+  res = crypto_cypher(engine, &req);
+  if (res == OK && memcmp(out, test->result, test->rlen) != 0)
+    {
+      res = -EIO;
     }
 
   kmm_free(out);
   return res;
 }
 
-#define AES_CYPHER_TEST_ENCRYPT(mode, mode_str, count, template) \
-  for (i = 0; i < count; i++) { \
-    if (do_test_aes(template + i, mode, CYPHER_ENCRYPT)) { \
-      crypterr("ERROR: Failed " mode_str " encrypt test #%i\n", i); \
-      return -1; \
-    } \
-  }
+/****************************************************************************
+ * Name: test_aes_vectors
+ *
+ * Description:
+ *   Run the vectors of one mode and direction that the engine supports.
+ *   Only the vectors with the given key size are used, or all of them if
+ *   keysize is zero.
+ *
+ * Returned Value:
+ *   Zero (OK) if all vectors passed, -ENOENT if none of them applied, or
+ *   the negated errno value of the first failure.
+ *
+ ****************************************************************************/
 
-#define AES_CYPHER_TEST_DECRYPT(mode, mode_str, count, template) \
-  for (i = 0; i < count; i++) { \
-    if (do_test_aes(template + i, mode, CYPHER_DECRYPT)) { \
-      crypterr("ERROR: Failed " mode_str " decrypt test #%i\n", i); \
-      return -1; \
-    } \
-  }
+static int test_aes_vectors(FAR struct crypto_engine_s *engine,
+                            FAR const struct aes_testset_s *set,
+                            int encrypt, uint32_t keysize)
+{
+  FAR struct cipher_testvec *vec;
+  int nvec;
+  int ret = -ENOENT;
+  int res;
+  int i;
+
+  vec  = encrypt == CYPHER_ENCRYPT ? set->enc : set->dec;
+  nvec = encrypt == CYPHER_ENCRYPT ? set->nenc : set->ndec;
+
+  for (i = 0; i < nvec; i++)
+    {
+      if ((keysize != 0 && vec[i].klen != keysize) ||
+          !engine->ce_ops->supported(engine, set->mode, vec[i].klen))
+        {
+          continue;
+        }
+
+      res = do_test_aes(engine, &vec[i], set->mode, encrypt);
+      if (res < 0)
+        {
+          crypterr("ERROR: %s failed %s %s test #%i: %d\n",
+                   engine->ce_name, set->name,
+                   encrypt == CYPHER_ENCRYPT ? "encrypt" : "decrypt",
+                   i, res);
+          return res;
+        }
+
+      ret = OK;
+    }
+
+  return ret;
+}
 
-#define AES_CYPHER_TEST(mode, mode_str, enc_count, dec_count, enc_template, dec_template) \
-  AES_CYPHER_TEST_ENCRYPT(mode, mode_str, enc_count, enc_template)\
-  AES_CYPHER_TEST_DECRYPT(mode, mode_str, dec_count, dec_template)
+/****************************************************************************
+ * Name: test_aes_engine
+ *
+ * Description:
+ *   crypto_foreach() callback that runs all AES vectors against one engine.
+ *
+ ****************************************************************************/
 
-static int test_aes(void)
+static int test_aes_engine(FAR struct crypto_engine_s *engine,
+                           FAR void *arg)
 {
+  int ret;
   int i;
 
-  AES_CYPHER_TEST(AES_MODE_ECB, "ECB", ARRAY_SIZE(aes_enc_tv_template),
-                  ARRAY_SIZE(aes_dec_tv_template), aes_enc_tv_template,
-                  aes_dec_tv_template)
-  AES_CYPHER_TEST(AES_MODE_CBC, "CBC", ARRAY_SIZE(aes_cbc_enc_tv_template),
-                  ARRAY_SIZE(aes_cbc_dec_tv_template),
-                  aes_cbc_enc_tv_template, aes_cbc_dec_tv_template)
-  AES_CYPHER_TEST(AES_MODE_CTR, "CTR", ARRAY_SIZE(aes_ctr_enc_tv_template),
-                  ARRAY_SIZE(aes_ctr_dec_tv_template),
-                  aes_ctr_enc_tv_template, aes_ctr_dec_tv_template)
+  for (i = 0; i < ARRAY_SIZE(g_aes_testsets); i++)
+    {
+      ret = test_aes_vectors(engine, &g_aes_testsets[i], CYPHER_ENCRYPT, 0);
+      if (ret < 0 && ret != -ENOENT)
+        {
+          return ret;
+        }
+
+      ret = test_aes_vectors(engine, &g_aes_testsets[i], CYPHER_DECRYPT, 0);
+      if (ret < 0 && ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
 
   return OK;
 }
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+/****************************************************************************
+ * Name: bench_aes
+ *
+ * Description:
+ *   Measure the throughput of one engine, mode, key size and direction in
+ *   KiB/s.
+ *
+ ****************************************************************************/
+
+static int bench_aes(FAR struct crypto_engine_s *engine, int mode,
+                     uint32_t keysize, int encrypt, FAR uint8_t *buffer,
+                     FAR uint32_t *kbps)
+{
+  struct crypto_req_s req;
+  uint8_t key[32];
+  uint8_t iv[AES_TEST_IVSIZE];
+  uint64_t nbytes = 0;
+  clock_t elapsed;
+  clock_t start;
+  int ret;
+  int i;
+
+  for (i = 0; i < sizeof(key); i++)
+    {
+      key[i] = (uint8_t)i;
+    }
+
+  memset(iv, 0xa5, sizeof(iv));
+
+  memset(&req, 0, sizeof(req));
+  req.cr_out     = buffer + BENCH_BUFSIZE;
+  req.cr_in      = buffer;
+  req.cr_size    = BENCH_BUFSIZE;
+  req.cr_iv      = iv;
+  req.cr_key     = key;
+  req.cr_keysize = keysize;
+  req.cr_mode    = mode;
+  req.cr_encrypt = encrypt;
+
+  /* Start on a clock tick boundary so that the measurement is not off by
+   * up to one tick.
+   */
+
+  start = clock_systimer();
+  while (clock_systimer() == start)
+    {
+    }
+
+  start = clock_systimer();
+
+  do
+    {
+      ret = crypto_cypher(engine, &req);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nbytes += BENCH_BUFSIZE;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < BENCH_TICKS);
+
+  *kbps = (uint32_t)((nbytes * USEC_PER_SEC) /
+                     ((uint64_t)TICK2USEC(elapsed) * 1024));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_aes_engine
+ *
+ * Description:
+ *   crypto_foreach() callback that benchmarks one engine.
+ *
+ ****************************************************************************/
+
+static int bench_aes_engine(FAR struct crypto_engine_s *engine,
+                            FAR void *arg)
+{
+  FAR struct aes_benchctx_s *ctx = (FAR struct aes_benchctx_s *)arg;
+  FAR const struct aes_testset_s *set;
+  struct crypto_bench_s result;
+  int encrypt;
+  int ret;
+  int i;
+  int j;
+  int k;
+
+  for (i = 0; i < ARRAY_SIZE(g_aes_testsets); i++)
+    {
+      set = &g_aes_testsets[i];
+
+      for (j = 0; j < ARRAY_SIZE(g_aes_keysizes); j++)
+        {
+          if (!engine->ce_ops->supported(engine, set->mode,
+                                         g_aes_keysizes[j]))
+            {
+              continue;
+            }
+
+          for (k = 0; k < 2; k++)
+            {
+              encrypt = k == 0 ? CYPHER_ENCRYPT : CYPHER_DECRYPT;
+
+              memset(&result, 0, sizeof(result));
+              result.cb_engine   = engine;
+              result.cb_mode     = set->mode;
+              result.cb_modename = set->name;
+              result.cb_keysize  = g_aes_keysizes[j];
+              result.cb_encrypt  = encrypt;
+              result.cb_selftest = test_aes_vectors(engine, set, encrypt,
+                                                    g_aes_keysizes[j]);
+              result.cb_result   = bench_aes(engine, set->mode,
+                                             g_aes_keysizes[j], encrypt,
+                                             ctx->buffer, &result.cb_kbps);
+
+#if CONFIG_CRYPTO_BENCHMARK_CPUFREQ > 0
+              if (result.cb_kbps > 0)
+                {
+                  result.cb_cpb100 = (uint32_t)
+                    (((uint64_t)CONFIG_CRYPTO_BENCHMARK_CPUFREQ * 100000) /
+                     ((uint64_t)result.cb_kbps * 1024));
+                }
 #endif
 
+              ret = ctx->handler(&result, ctx->arg);
+              if (ret != 0)
+                {
+                  return ret;
+                }
+            }
+        }
+    }
+
+  return OK;
+}
+#endif /* CONFIG_CRYPTO_BENCHMARK */
+#endif /* CONFIG_CRYPTO_AES || CONFIG_CRYPTO_SW_AES */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_test
+ *
+ * Description:
+ *   Run the known-answer tests against every registered engine.
+ *
+ ****************************************************************************/
+
 int crypto_test(void)
 {
-#if defined(CONFIG_CRYPTO_AES)
-  if (test_aes())
+#if defined(CONFIG_CRYPTO_AES) || defined(CONFIG_CRYPTO_SW_AES)
+  return crypto_foreach(test_aes_engine, NULL);
+#else
+  return OK;
+#endif
+}
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+/****************************************************************************
+ * Name: crypto_benchmark
+ *
+ * Description:
+ *   See include/nuttx/crypto/crypto.h
+ *
+ ****************************************************************************/
+
+int crypto_benchmark(crypto_bench_handler_t handler, FAR void *arg)
+{
+#if defined(CONFIG_CRYPTO_AES) || defined(CONFIG_CRYPTO_SW_AES)
+  struct aes_benchctx_s ctx;
+  int ret;
+
+  DEBUGASSERT(handler != NULL);
+
+  ctx.handler = handler;
+  ctx.arg     = arg;
+  ctx.buffer  = (FAR uint8_t *)kmm_zalloc(2 * BENCH_BUFSIZE);
+  if (ctx.buffer == NULL)
     {
-      return -1;
+      return -ENOMEM;
     }
-#endif
 
+  ret = crypto_foreach(bench_aes_engine, &ctx);
+  kmm_free(ctx.buffer);
+  return ret;
+#else
   return OK;
+#endif
 }
+#endif
 
 #else /* CONFIG_CRYPTO_ALGTEST */
 
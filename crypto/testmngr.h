@@ -60,7 +60,7 @@ struct cipher_testvec
   unsigned short rlen;
 };
 
-#if defined(CONFIG_CRYPTO_AES)
+#if defined(CONFIG_CRYPTO_AES) || defined(CONFIG_CRYPTO_SW_AES)
 
 /* AES test vectors */
 
@@ -520,5 +520,5 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 #endif
 };
 
-#endif /* CONFIG_CRYPTO_AES */
+#endif /* CONFIG_CRYPTO_AES || CONFIG_CRYPTO_SW_AES */
 #endif /* __CRYPTO_TESTMNGR_H */
@@ -58,8 +58,11 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 
 #include <nuttx/irq.h>
@@ -75,6 +78,14 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_BLOCKMODE
+static ssize_t adc_readblocks(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+static int     adc_blockmode(FAR struct adc_dev_s *dev, bool enable);
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+                                 FAR const uint16_t *data,
+                                 unsigned int nsamples, uint8_t nchannels);
+#endif
 static void    adc_notify(FAR struct adc_dev_s *dev);
 #ifndef CONFIG_DISABLE_POLL
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
@@ -103,6 +114,9 @@ static const struct file_operations g_adc_fops =
 static const struct adc_callback_s g_adc_callback =
 {
   adc_receive   /* au_receive */
+#ifdef CONFIG_ADC_BLOCKMODE
+  , adc_receive_block /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -216,6 +230,16 @@ static int adc_close(FAR struct file *filep)
           dev->ad_ops->ao_shutdown(dev);       /* Disable the ADC */
           leave_critical_section(flags);
 
+#ifdef CONFIG_ADC_BLOCKMODE
+          /* Block mode ends with the last close */
+
+          if (dev->ad_blocks != NULL)
+            {
+              kmm_free(dev->ad_blocks);
+              dev->ad_blocks = NULL;
+            }
+#endif
+
           nxsem_post(&dev->ad_closesem);
         }
     }
@@ -238,6 +262,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCKMODE
+  /* In block mode, only whole blocks are returned */
+
+  if (dev->ad_blocks != NULL)
+    {
+      return adc_readblocks(filep, buffer, buflen);
+    }
+#endif
+
   /* Determine size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -412,10 +445,203 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct adc_dev_s *dev = inode->i_private;
   int ret;
 
-  ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+  switch (cmd)
+    {
+#ifdef CONFIG_ADC_BLOCKMODE
+      case ANIOC_BLOCKMODE:
+        ret = adc_blockmode(dev, (bool)arg);
+        break;
+
+      case ANIOC_DECIMATION:
+        {
+          irqstate_t flags;
+
+          if (arg < 1 || arg > UINT16_MAX)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Restart any partially accumulated samples */
+
+          flags = enter_critical_section();
+          dev->ad_decimation = (uint16_t)arg;
+          dev->ad_deccount   = 0;
+          dev->ad_channel    = 0;
+          memset(dev->ad_acc, 0, sizeof(dev->ad_acc));
+          leave_critical_section(flags);
+          ret = OK;
+        }
+        break;
+#endif
+
+      default:
+        ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+        break;
+    }
+
   return ret;
 }
 
+#ifdef CONFIG_ADC_BLOCKMODE
+/****************************************************************************
+ * Name: adc_readblocks
+ *
+ * Description:
+ *   Return as many completed blocks as will fit in the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_readblocks(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct inode       *inode = filep->f_inode;
+  FAR struct adc_dev_s   *dev   = inode->i_private;
+  FAR struct adc_block_s *dest  = (FAR struct adc_block_s *)buffer;
+  irqstate_t              flags;
+  size_t                  nblocks;
+  size_t                  nread;
+  int                     ret;
+
+  nblocks = buflen / sizeof(struct adc_block_s);
+  if (nblocks == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Interrupts must be disabled while accessing the block ring */
+
+  flags = enter_critical_section();
+  while (dev->ad_bcount == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto return_with_irqdisabled;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          goto return_with_irqdisabled;
+        }
+
+      /* Block mode might have been disabled while we waited */
+
+      if (dev->ad_blocks == NULL)
+        {
+          ret = -EPERM;
+          goto return_with_irqdisabled;
+        }
+    }
+
+  for (nread = 0; nread < nblocks && dev->ad_bcount > 0; nread++)
+    {
+      memcpy(&dest[nread], &dev->ad_blocks[dev->ad_bhead],
+             sizeof(struct adc_block_s));
+
+      if (++dev->ad_bhead > CONFIG_ADC_BLOCK_NBLOCKS)
+        {
+          dev->ad_bhead = 0;
+        }
+
+      dev->ad_bcount--;
+    }
+
+  ret = nread * sizeof(struct adc_block_s);
+
+return_with_irqdisabled:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_blockmode
+ *
+ * Description:
+ *   Enable or disable block mode.  The ring holds one more block than can
+ *   be completed so that the lower half always has a block to fill.
+ *
+ ****************************************************************************/
+
+static int adc_blockmode(FAR struct adc_dev_s *dev, bool enable)
+{
+  FAR struct adc_block_s *blocks;
+  irqstate_t flags;
+  int ret;
+
+  if (enable)
+    {
+      if (dev->ad_blocks != NULL)
+        {
+          return OK;
+        }
+
+      blocks = (FAR struct adc_block_s *)
+        kmm_malloc((CONFIG_ADC_BLOCK_NBLOCKS + 1) *
+                   sizeof(struct adc_block_s));
+      if (blocks == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      flags = enter_critical_section();
+      dev->ad_bhead      = 0;
+      dev->ad_bcount     = 0;
+      dev->ad_bfill      = 0;
+      dev->ad_deccount   = 0;
+      dev->ad_nchannels  = 0;
+      dev->ad_channel    = 0;
+      memset(dev->ad_acc, 0, sizeof(dev->ad_acc));
+      dev->ad_blocks     = blocks;
+      leave_critical_section(flags);
+
+      /* Ask the lower half to start delivering blocks */
+
+      ret = dev->ad_ops->ao_ioctl(dev, ANIOC_BLOCKMODE, 1);
+      if (ret < 0)
+        {
+          aerr("ERROR: Block mode not supported: %d\n", ret);
+
+          flags = enter_critical_section();
+          dev->ad_blocks = NULL;
+          leave_critical_section(flags);
+
+          kmm_free(blocks);
+        }
+    }
+  else
+    {
+      if (dev->ad_blocks == NULL)
+        {
+          return OK;
+        }
+
+      (void)dev->ad_ops->ao_ioctl(dev, ANIOC_BLOCKMODE, 0);
+
+      flags = enter_critical_section();
+      blocks         = dev->ad_blocks;
+      dev->ad_blocks = NULL;
+
+      /* Wake up any readers so that they can return to message mode */
+
+      if (dev->ad_nrxwaiters > 0)
+        {
+          nxsem_post(&dev->ad_recv.af_sem);
+        }
+
+      leave_critical_section(flags);
+
+      kmm_free(blocks);
+      ret = OK;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_receive
  ****************************************************************************/
@@ -457,6 +683,151 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_blockput
+ *
+ * Description:
+ *   Add one (decimated) sample to the block being filled.  Returns true if
+ *   that completes the block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCKMODE
+static bool adc_blockput(FAR struct adc_dev_s *dev, uint16_t sample)
+{
+  FAR struct adc_block_s *block;
+  struct timespec ts;
+  unsigned int capacity;
+  unsigned int index;
+
+  /* The block being filled follows the completed blocks */
+
+  index = dev->ad_bhead + dev->ad_bcount;
+  if (index > CONFIG_ADC_BLOCK_NBLOCKS)
+    {
+      index -= CONFIG_ADC_BLOCK_NBLOCKS + 1;
+    }
+
+  block = &dev->ad_blocks[index];
+  block->ab_data[dev->ad_bfill++] = sample;
+
+  /* Blocks always hold complete sets of channel samples */
+
+  capacity = (CONFIG_ADC_BLOCK_NSAMPLES / dev->ad_nchannels) *
+             dev->ad_nchannels;
+
+  if (dev->ad_bfill < capacity)
+    {
+      return false;
+    }
+
+  (void)clock_systimespec(&ts);
+
+  block->ab_timestamp = (uint64_t)ts.tv_sec * USEC_PER_SEC +
+                        ts.tv_nsec / NSEC_PER_USEC;
+  block->ab_seqno     = dev->ad_bseqno++;
+  block->ab_nsamples  = dev->ad_bfill;
+  block->ab_nchannels = dev->ad_nchannels;
+  block->ab_reserved  = 0;
+  dev->ad_bfill       = 0;
+
+  /* If the reader has fallen behind, this block is lost and will be
+   * over-written.  The reader sees the gap in the sequence numbers.
+   */
+
+  if (dev->ad_bcount >= CONFIG_ADC_BLOCK_NBLOCKS)
+    {
+      return false;
+    }
+
+  dev->ad_bcount++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: adc_receive_block
+ ****************************************************************************/
+
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+                             FAR const uint16_t *data,
+                             unsigned int nsamples, uint8_t nchannels)
+{
+  bool completed = false;
+  uint32_t decimation;
+  unsigned int i;
+  int ch;
+
+  if (dev->ad_blocks == NULL)
+    {
+      return -EPERM;
+    }
+
+  if (nchannels == 0 || nchannels > ADC_BLOCK_MAXCHANNELS ||
+      nchannels > CONFIG_ADC_BLOCK_NSAMPLES)
+    {
+      return -EINVAL;
+    }
+
+  /* A change in the number of channels restarts the current block */
+
+  if (nchannels != dev->ad_nchannels)
+    {
+      dev->ad_nchannels = nchannels;
+      dev->ad_bfill     = 0;
+      dev->ad_deccount  = 0;
+      dev->ad_channel   = 0;
+      memset(dev->ad_acc, 0, sizeof(dev->ad_acc));
+    }
+
+  decimation = dev->ad_decimation;
+  if (decimation <= 1)
+    {
+      for (i = 0; i < nsamples; i++)
+        {
+          completed |= adc_blockput(dev, data[i]);
+        }
+    }
+  else
+    {
+      /* Average each channel over 'decimation' consecutive sample sets.
+       * The partial sums carry over from one buffer to the next.
+       */
+
+      for (i = 0; i < nsamples; i++)
+        {
+          dev->ad_acc[dev->ad_channel] += data[i];
+          if (++dev->ad_channel < nchannels)
+            {
+              continue;
+            }
+
+          dev->ad_channel = 0;
+          if (++dev->ad_deccount < decimation)
+            {
+              continue;
+            }
+
+          dev->ad_deccount = 0;
+          for (ch = 0; ch < nchannels; ch++)
+            {
+              completed |= adc_blockput(dev, (uint16_t)
+                                        (dev->ad_acc[ch] / decimation));
+              dev->ad_acc[ch] = 0;
+            }
+        }
+    }
+
+  /* Wake up readers once per buffer rather than once per block */
+
+  if (completed)
+    {
+      adc_notify(dev);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_pollnotify
  ****************************************************************************/
@@ -472,7 +843,7 @@ static void adc_pollnotify(FAR struct adc_dev_s *dev, uint32_t type)
       if (fds)
         {
           fds->revents |= type;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
@@ -564,6 +935,12 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           adc_pollnotify(dev, POLLIN);
         }
+#ifdef CONFIG_ADC_BLOCKMODE
+      else if (dev->ad_blocks != NULL && dev->ad_bcount > 0)
+        {
+          adc_pollnotify(dev, POLLIN);
+        }
+#endif
     }
   else if (fds->priv)
     {
@@ -610,6 +987,10 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
   /* Initialize the ADC device structure */
 
   dev->ad_ocount = 0;
+#ifdef CONFIG_ADC_BLOCKMODE
+  dev->ad_blocks     = NULL;
+  dev->ad_decimation = 1;
+#endif
 
   /* Initialize semaphores */
 
@@ -46,7 +46,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+
 #include <nuttx/fs/fs.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/drivers/drivers.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -55,22 +58,71 @@
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_BCH_NSECTORS
+#  define CONFIG_BCH_NSECTORS 1
+#endif
+
+#if CONFIG_BCH_NSECTORS < 1
+#  error CONFIG_BCH_NSECTORS must be at least one
+#endif
+
+/* Timed write-back of dirty sectors is performed on the work queue */
+
+#if defined(CONFIG_BCH_WRITEBACK_DELAY) && CONFIG_BCH_WRITEBACK_DELAY > 0
+#  define BCH_HAVE_WBTIMER 1
+#  ifdef CONFIG_SCHED_LPWORK
+#    define BCHWORK LPWORK
+#  else
+#    define BCHWORK HPWORK
+#  endif
+#endif
+
+/* Sector number of an unused cache entry */
+
+#define BCH_NOSECTOR      ((size_t)-1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one sector in the sector cache */
+
+struct bchlib_sector_s
+{
+  size_t sector;           /* The sector held in the buffer */
+  uint32_t lastuse;        /* Value of usecount at the last access */
+  bool dirty;              /* true: Data has been written to the buffer */
+  FAR uint8_t *buffer;     /* One sector buffer */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  uint32_t usecount;       /* Incremented on each access for LRU */
+  FAR uint8_t *pool;       /* Memory for all of the sector buffers */
+  FAR uint8_t *buffer;     /* Buffer of the most recently accessed sector */
+  FAR struct bchlib_sector_s *cur; /* The most recently accessed sector */
+
+  /* The sector cache.  The buffers are allocated in order from one
+   * contiguous pool so that dirty sectors held in adjacent entries can
+   * be written to the media with a single write.
+   */
+
+  struct bchlib_sector_s cache[CONFIG_BCH_NSECTORS];
+
+#ifdef BCH_HAVE_WBTIMER
+  struct work_s work;      /* For the delayed write-back of dirty sectors */
+#endif
+
+#ifdef CONFIG_BCH_CACHESTATS
+  struct bch_cachestats_s stats; /* Cache statistics */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -96,8 +148,14 @@ EXTERN const struct file_operations bch_fops;
  ****************************************************************************/
 
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
+EXTERN void bchlib_initcache(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_markdirty(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -120,7 +120,7 @@ static int bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
       fds->revents |= (fds->events & (POLLIN | POLLOUT));
       if (fds->revents != 0)
         {
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -409,6 +409,53 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* This is a request to flush dirty cached sectors to the media.  The
+       * request is then passed on to the contained block driver so that it
+       * may flush any buffering of its own.
+       */
+
+      case BIOC_FLUSH:
+        {
+          FAR struct inode *bchinode = bch->inode;
+
+          bchlib_semtake(bch);
+          ret = bchlib_flushsector(bch);
+          bchlib_semgive(bch);
+
+          if (ret >= 0 && bchinode->u.i_bops->ioctl != NULL)
+            {
+              ret = bchinode->u.i_bops->ioctl(bchinode, cmd, arg);
+              if (ret == -ENOTTY)
+                {
+                  ret = OK;
+                }
+            }
+        }
+        break;
+
+#ifdef CONFIG_BCH_CACHESTATS
+      /* This is a request to return the sector cache statistics */
+
+      case BIOC_CACHESTATS:
+        {
+          FAR struct bch_cachestats_s *stats =
+            (FAR struct bch_cachestats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              bchlib_semtake(bch);
+              memcpy(stats, &bch->stats, sizeof(struct bch_cachestats_s));
+              bchlib_semgive(bch);
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
@@ -40,17 +40,32 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 #  include <crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHESTATS
+#  define bch_stats(b,f,n) do { (b)->stats.f += (n); } while (0)
+#else
+#  define bch_stats(b,f,n)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -74,10 +89,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch,
+                      FAR struct bchlib_sector_s *entry, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)entry->buffer;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -85,7 +101,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        entry->sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -104,68 +120,307 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bch_inrun
+ *
+ * Description:
+ *   Return true if cache entry 'ndx' is dirty and holds the sector that
+ *   immediately follows the sector held in the entry before it.  Such
+ *   entries may be written to the media together with the previous entry.
+ *
  ****************************************************************************/
 
+static inline bool bch_inrun(FAR struct bchlib_s *bch, int ndx)
+{
+  return ndx > 0 && bch->cache[ndx].dirty && bch->cache[ndx - 1].dirty &&
+         bch->cache[ndx].sector == bch->cache[ndx - 1].sector + 1;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_writerun
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Write the dirty cache entry 'ndx' to the media.  Any dirty entries
+ *   adjacent to it in the cache that also hold adjacent sectors are written
+ *   by the same media write.
  *
  * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Caller must assume mutual exclusion and cache entry 'ndx' is dirty.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bch_writerun(FAR struct bchlib_s *bch, int ndx)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+  int first;
+  int last;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  int i;
+#endif
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
+  DEBUGASSERT(bch->cache[ndx].dirty);
+
+  /* Find the extent of the run of dirty, adjacent sectors.  The buffers
+   * of adjacent cache entries are adjacent in memory.
    */
 
-  if (bch->dirty)
+  for (first = ndx; bch_inrun(bch, first); first--);
+  for (last = ndx; last + 1 < CONFIG_BCH_NSECTORS &&
+                   bch_inrun(bch, last + 1); last++);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  for (i = first; i <= last; i++)
+    {
+      bch_cypher(bch, &bch->cache[i], CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, bch->cache[first].buffer,
+                               bch->cache[first].sector,
+                               last - first + 1);
+  if (ret < 0)
     {
-      inode = bch->inode;
+      ferr("Write failed: %d\n", (int)ret);
+    }
+
+  bch_stats(bch, bc_writes, 1);
+  bch_stats(bch, bc_wsectors, last - first + 1);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
+   */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+  for (i = first; i <= last; i++)
+    {
+      bch_cypher(bch, &bch->cache[i], CYPHER_DECRYPT);
+    }
 #endif
 
-      /* Write the sector to the media */
+  /* The sectors are now in sync with the media */
+
+  for (; first <= last; first++)
+    {
+      bch->cache[first].dirty = false;
+    }
+
+  return ret < 0 ? (int)ret : OK;
+}
+
+/****************************************************************************
+ * Name: bch_flush
+ *
+ * Description:
+ *   Write all dirty cache entries holding sectors in the range
+ *   [sector, sector + nsectors) to the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+static int bch_flush(FAR struct bchlib_s *bch, size_t sector,
+                     size_t nsectors)
+{
+  int ret = OK;
+  int tmp;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      FAR struct bchlib_sector_s *entry = &bch->cache[i];
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
+      if (entry->dirty && entry->sector >= sector &&
+          entry->sector - sector < nsectors)
         {
-          ferr("Write failed: %d\n");
+          tmp = bch_writerun(bch, i);
+          if (tmp < 0)
+            {
+              ret = tmp;
+            }
         }
+    }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bch_victim
+ *
+ * Description:
+ *   Select the cache entry to be replaced when 'sector' is not in the
+ *   cache.  If the previous sector is cached and the entry following it is
+ *   not dirty, that entry is selected so that sequentially written sectors
+ *   stay adjacent in the cache and can be written together.  Otherwise, an
+ *   unused entry or else the least recently used entry is selected.
+ *
+ ****************************************************************************/
+
+static int bch_victim(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct bchlib_sector_s *entry;
+  int victim = -1;
+  int i;
+
+#if CONFIG_BCH_NSECTORS > 1
+  for (i = 0; i + 1 < CONFIG_BCH_NSECTORS; i++)
+    {
+      entry = &bch->cache[i];
+      if (entry->sector != BCH_NOSECTOR && entry->sector + 1 == sector)
+        {
+          if (!bch->cache[i + 1].dirty)
+            {
+              return i + 1;
+            }
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+          break;
+        }
+    }
 #endif
 
-      /* The sector is now in sync with the media */
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      entry = &bch->cache[i];
+      if (entry->sector == BCH_NOSECTOR)
+        {
+          return i;
+        }
+
+      /* Compare the use counts allowing for wraparound */
 
-      bch->dirty = false;
+      if (victim < 0 ||
+          (int32_t)(entry->lastuse - bch->cache[victim].lastuse) < 0)
+        {
+          victim = i;
+        }
     }
 
-  return (int)ret;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bch_wbworker
+ *
+ * Description:
+ *   Write all dirty sectors to the media after the write-back delay.
+ *
+ ****************************************************************************/
+
+#ifdef BCH_HAVE_WBTIMER
+static void bch_wbworker(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = (FAR struct bchlib_s *)arg;
+
+  bchlib_semtake(bch);
+  (void)bchlib_flushsector(bch);
+  bchlib_semgive(bch);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_initcache
+ *
+ * Description:
+ *   Initialize the sector cache.  bch->pool must refer to memory for
+ *   CONFIG_BCH_NSECTORS sectors.
+ *
+ ****************************************************************************/
+
+void bchlib_initcache(FAR struct bchlib_s *bch)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      bch->cache[i].sector  = BCH_NOSECTOR;
+      bch->cache[i].lastuse = 0;
+      bch->cache[i].dirty   = false;
+      bch->cache[i].buffer  = &bch->pool[i * bch->sectsize];
+    }
+
+  bch->cur    = &bch->cache[0];
+  bch->buffer = bch->cur->buffer;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush the contents of all dirty sectors in the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+  return bch_flush(bch, 0, BCH_NOSECTOR);
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush any dirty cached sectors in the range [sector, sector + nsectors).
+ *   This must be done before reading those sectors directly from the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors)
+{
+  return bch_flush(bch, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Discard any cached sectors in the range [sector, sector + nsectors).
+ *   This must be done when those sectors are written directly to the
+ *   media; dirty data in the cache is superseded by the new data.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      FAR struct bchlib_sector_s *entry = &bch->cache[i];
+
+      if (entry->sector != BCH_NOSECTOR && entry->sector >= sector &&
+          entry->sector - sector < nsectors)
+        {
+          entry->sector = BCH_NOSECTOR;
+          entry->dirty  = false;
+        }
+    }
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make the sector available in the cache, reading it from the media if
+ *   necessary.  On return, bch->buffer refers to the cached sector data.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -174,26 +429,94 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
+  FAR struct bchlib_sector_s *entry;
   FAR struct inode *inode;
   ssize_t ret = OK;
+  int i;
 
-  if (bch->sector != sector)
-    {
-      inode = bch->inode;
+  /* Check the most recently used sector first, then the rest of the
+   * cache.
+   */
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+  entry = bch->cur;
+  if (entry->sector != sector)
+    {
+      for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+        {
+          if (bch->cache[i].sector == sector)
+            {
+              break;
+            }
+        }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+      if (i < CONFIG_BCH_NSECTORS)
         {
-          ferr("Read failed: %d\n");
+          entry = &bch->cache[i];
         }
-      bch->sector = sector;
+      else
+        {
+          /* Not cached.  Replace some entry, writing it to the media first
+           * if it is dirty.
+           */
+
+          bch_stats(bch, bc_misses, 1);
+
+          entry = &bch->cache[bch_victim(bch, sector)];
+          if (entry->dirty)
+            {
+              (void)bch_writerun(bch, entry - bch->cache);
+            }
+
+          inode         = bch->inode;
+          entry->sector = BCH_NOSECTOR;
+
+          ret = inode->u.i_bops->read(inode, entry->buffer, sector, 1);
+          if (ret < 0)
+            {
+              ferr("Read failed: %d\n", (int)ret);
+            }
+
+          entry->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+          bch_cypher(bch, entry, CYPHER_DECRYPT);
 #endif
+          goto out;
+        }
     }
-  return (int)ret;
+
+  bch_stats(bch, bc_hits, 1);
+
+out:
+  entry->lastuse = ++bch->usecount;
+  bch->cur       = entry;
+  bch->buffer    = entry->buffer;
+  return ret < 0 ? (int)ret : OK;
 }
 
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Mark the most recently read sector (see bchlib_readsector()) as dirty.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_markdirty(FAR struct bchlib_s *bch)
+{
+  bch->cur->dirty = true;
+
+#ifdef BCH_HAVE_WBTIMER
+  /* Schedule the write-back of the dirty sector(s) if it is not already
+   * scheduled.
+   */
+
+  if (work_available(&bch->work))
+    {
+      (void)work_queue(BCHWORK, &bch->work, bch_wbworker, bch,
+                       MSEC2TICK(CONFIG_BCH_WRITEBACK_DELAY));
+    }
+#endif
+}
@@ -154,6 +154,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
+      /* The media must be up to date before reading directly from it */
+
+      (void)bchlib_flushrange(bch, sector, nsectors);
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
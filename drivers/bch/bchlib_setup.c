@@ -121,19 +121,21 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   nxsem_init(&bch->sem, 0, 1);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate the sector I/O buffers */
 
-  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
-  if (!bch->buffer)
+  bch->pool = (FAR uint8_t *)
+    kmm_malloc(CONFIG_BCH_NSECTORS * bch->sectsize);
+  if (!bch->pool)
     {
       ferr("ERROR: Failed to allocate sector buffer\n");
       ret = -ENOMEM;
       goto errout_with_bch;
     }
 
+  bchlib_initcache(bch);
+
   *handle = bch;
   return OK;
 
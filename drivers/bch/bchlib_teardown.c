@@ -75,6 +75,16 @@ int bchlib_teardown(FAR void *handle)
       return -EBUSY;
     }
 
+#ifdef BCH_HAVE_WBTIMER
+  /* Cancel any pending, timed write-back.  Then wait for a write-back that
+   * may already be in progress.
+   */
+
+  (void)work_cancel(BCHWORK, &bch->work);
+  bchlib_semtake(bch);
+  bchlib_semgive(bch);
+#endif
+
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch);
@@ -85,9 +95,9 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
+  if (bch->pool)
     {
-      kmm_free(bch->buffer);
+      kmm_free(bch->pool);
     }
 
   nxsem_destroy(&bch->sem);
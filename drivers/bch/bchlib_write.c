@@ -113,7 +113,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
       /* Adjust pointers and counts */
 
@@ -141,6 +141,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Any cached copies of these sectors are superseded */
+
+      bchlib_invalidate(bch, sector, nsectors);
+
       /* Write the contiguous sectors */
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
@@ -177,13 +181,14 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
       /* Adjust counts */
 
       byteswritten += len;
     }
 
+#ifndef CONFIG_BCH_WRITEBACK
   /* Finally, flush any cached writes to the device as well */
 
   ret = bchlib_flushsector(bch);
@@ -192,6 +197,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       ferr("ERROR: Flush failed: %d\n", ret);
       return ret;
     }
+#endif
 
   return byteswritten;
 }
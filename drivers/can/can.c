@@ -56,6 +56,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
@@ -139,6 +140,7 @@ static int            can_open(FAR struct file *filep);
 static int            can_close(FAR struct file *filep);
 static ssize_t        can_read(FAR struct file *filep, FAR char *buffer,
                                size_t buflen);
+static int            can_rxcount(FAR struct can_dev_s *dev);
 static int            can_xmit(FAR struct can_dev_s *dev);
 static ssize_t        can_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t buflen);
@@ -220,7 +222,7 @@ static void can_pollnotify(FAR struct can_dev_s *dev, pollevent_t eventset)
           if (fds->revents != 0)
             {
               caninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -638,6 +640,33 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
             }
         }
 
+      /* If batching is enabled, wait a little while for more messages so
+       * that more of them are returned by this read.
+       */
+
+      if (dev->cd_rxbatch > 1 && (filep->f_oflags & O_NONBLOCK) == 0)
+        {
+          clock_t start = clock_systimer();
+
+          while (can_rxcount(dev) < dev->cd_rxbatch)
+            {
+              DEBUGASSERT(dev->cd_nrxwaiters < 255);
+              dev->cd_nrxwaiters++;
+              ret = nxsem_tickwait(&dev->cd_recv.rx_sem, start,
+                                   dev->cd_rxlatency);
+              dev->cd_nrxwaiters--;
+
+              /* Return whatever has been received on a time out or a
+               * signal.
+               */
+
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+        }
+
       /* The cd_recv FIFO is not empty.  Copy all buffered data that will fit
        * in the user buffer.
        */
@@ -683,6 +712,29 @@ return_with_irqdisabled:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_rxcount
+ *
+ * Description:
+ *   Return the number of messages in the cd_recv FIFO
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static int can_rxcount(FAR struct can_dev_s *dev)
+{
+  int count = dev->cd_recv.rx_tail - dev->cd_recv.rx_head;
+
+  if (count < 0)
+    {
+      count += CONFIG_CAN_FIFOSIZE;
+    }
+
+  return count;
+}
+
 /****************************************************************************
  * Name: can_xmit
  *
@@ -976,6 +1028,30 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = can_rtrread(dev, (FAR struct canioc_rtr_s *)((uintptr_t)arg));
         break;
 
+      /* CANIOC_SET_RXBATCH: Set the number of messages to batch for each
+       * reader wake-up.  Argument is a reference to struct
+       * canioc_rxbatch_s.
+       */
+
+      case CANIOC_SET_RXBATCH:
+        {
+          FAR const struct canioc_rxbatch_s *batch =
+            (FAR const struct canioc_rxbatch_s *)((uintptr_t)arg);
+
+          if (batch == NULL || batch->rb_nframes >= CONFIG_CAN_FIFOSIZE)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              irqstate_t flags = enter_critical_section();
+              dev->cd_rxbatch   = batch->rb_nframes;
+              dev->cd_rxlatency = MSEC2TICK(batch->rb_latency);
+              leave_critical_section(flags);
+            }
+        }
+        break;
+
       /* Not a "built-in" ioctl command.. perhaps it is unique to this
        * lower-half, device driver.
        */
@@ -1160,6 +1236,8 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
   dev->cd_ocount     = 0;
   dev->cd_ntxwaiters = 0;
   dev->cd_nrxwaiters = 0;
+  dev->cd_rxbatch    = 0;
+  dev->cd_rxlatency  = 0;
   dev->cd_npendrtr   = 0;
 #ifdef CONFIG_CAN_ERRORS
   dev->cd_error      = 0;
@@ -1298,6 +1376,20 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
       memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr, sizeof(struct can_hdr_s));
 
+#ifdef CONFIG_CAN_TIMESTAMP
+      /* Time stamp the message now unless the hardware already did */
+
+      if (!dev->cd_hwtimestamp)
+        {
+          struct timespec ts;
+
+          (void)clock_systimespec(&ts);
+          fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_sec  = ts.tv_sec;
+          fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_usec =
+            ts.tv_nsec / NSEC_PER_USEC;
+        }
+#endif
+
       nbytes = can_dlc2bytes(hdr->ch_dlc);
       for (i = 0, dest = fifo->rx_buffer[fifo->rx_tail].cm_data; i < nbytes; i++)
         {
@@ -1311,9 +1403,14 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
       /* The increment the counting semaphore. The maximum value should be
        * CONFIG_CAN_FIFOSIZE -- one possible count for each allocated
        * message buffer.
+       *
+       * If batching is enabled, a reader is waiting for the first message
+       * or for a full batch; there is no need to wake it in between.
        */
 
-      if (dev->cd_nrxwaiters > 0)
+      if (dev->cd_nrxwaiters > 0 &&
+          (dev->cd_rxbatch <= 1 || can_rxcount(dev) == 1 ||
+           can_rxcount(dev) >= dev->cd_rxbatch))
         {
           can_givesem(&fifo->rx_sem);
         }
@@ -323,7 +323,7 @@ static void ads7843e_notify(FAR struct ads7843e_dev_s *priv)
         {
           fds->revents |= POLLIN;
           iinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 #endif
@@ -359,7 +359,7 @@ static void ajoy_sample(FAR struct ajoy_upperhalf_s *priv)
                   if (fds->revents != 0)
                     {
                       iinfo("Report events: %02x\n", fds->revents);
-                      nxsem_post(fds->sem);
+                      poll_notify(fds);
                     }
                 }
             }
@@ -48,6 +48,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 #include <nuttx/i2c/i2c_master.h>
 
@@ -1022,7 +1023,7 @@ static void mbr3108_poll_notify(FAR struct mbr3108_dev_s *priv)
           mbr3108_dbg("Report events: %02x\n", fds->revents);
 
           fds->revents |= POLLIN;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
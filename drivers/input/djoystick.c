@@ -359,7 +359,7 @@ static void djoy_sample(FAR struct djoy_upperhalf_s *priv)
                   if (fds->revents != 0)
                     {
                       iinfo("Report events: %02x\n", fds->revents);
-                      nxsem_post(fds->sem);
+                      poll_notify(fds);
                     }
                 }
             }
@@ -65,9 +65,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
-#include <fcntl.h>
 #include <semaphore.h>
-#include <poll.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -75,7 +73,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/arch.h>
-#include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/wdog.h>
@@ -97,6 +95,18 @@
 #define DEV_FORMAT     "/dev/input%d"
 #define DEV_NAMELEN    16
 
+#ifndef CONFIG_FT5X06_NBUFFERS
+#  define CONFIG_FT5X06_NBUFFERS 8
+#endif
+
+/* The number of touch points reported in one sample */
+
+#ifdef CONFIG_FT5X06_SINGLEPOINT
+#  define FT5X06_MAXPOINT 1
+#else
+#  define FT5X06_MAXPOINT FT5x06_MAX_TOUCHES
+#endif
+
 /* In polled mode, the polling rate will decrease when there is no touch
  * activity.  These definitions represent the maximum and the minimum
  * polling rates.
@@ -114,12 +124,12 @@
 
 struct ft5x06_dev_s
 {
-  uint8_t crefs;                            /* Number of times the device
-                                             * has been opened */
-  uint8_t nwaiters;                         /* Number of threads waiting for
-                                             * FT5x06 data */
-  volatile bool valid;                      /* True:  New, valid touch data in
-                                             * touchbuf[] */
+  /* The touchscreen upper half sees this as the lower half.  This must be
+   * the first field so that the structures may be cast.
+   */
+
+  struct touch_lowerhalf_s lower;
+
 #ifdef CONFIG_FT5X06_SINGLEPOINT
   uint8_t lastid;                           /* Last reported touch id */
   uint8_t lastevent;                        /* Last reported event */
@@ -128,8 +138,6 @@ struct ft5x06_dev_s
 #endif
   sem_t devsem;                             /* Manages exclusive access to this
                                              * structure */
-  sem_t waitsem;                            /* Used to wait for the
-                                             * availability of data */
   uint32_t frequency;                       /* Current I2C frequency */
 #ifdef CONFIG_FT5X06_POLLMODE
   uint32_t delay;                           /* Current poll delay */
@@ -144,69 +152,41 @@ struct ft5x06_dev_s
 #endif
   uint8_t touchbuf[FT5x06_TOUCH_DATA_LEN];  /* Raw touch data */
 
-#ifndef CONFIG_DISABLE_POLL
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
-   */
+  /* Decoded touch data passed to the upper half */
 
-  struct pollfd *fds[CONFIG_FT5X06_NPOLLWAITERS];
-#endif
+  union
+  {
+    struct touch_sample_s sample;
+    uint8_t buffer[SIZEOF_TOUCH_SAMPLE_S(FT5X06_MAXPOINT)];
+  } report;
 };
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static void ft5x06_notify(FAR struct ft5x06_dev_s *priv);
 static void ft5x06_data_worker(FAR void *arg);
 #ifdef CONFIG_FT5X06_POLLMODE
 static void ft5x06_poll_timeout(int argc, wdparm_t arg1, ...);
 #else
 static int  ft5x06_data_interrupt(int irq, FAR void *context, FAR void *arg);
 #endif
-static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
-                             size_t len);
-static ssize_t ft5x06_waitsample(FAR struct ft5x06_dev_s *priv,
-                                 FAR char *buffer, size_t len);
+static int  ft5x06_sample(FAR struct ft5x06_dev_s *priv,
+                          FAR struct touch_sample_s *sample);
 static int  ft5x06_bringup(FAR struct ft5x06_dev_s *priv);
 static void ft5x06_shutdown(FAR struct ft5x06_dev_s *priv);
 
-/* Character driver methods */
-
-static int  ft5x06_open(FAR struct file *filep);
-static int  ft5x06_close(FAR struct file *filep);
-static ssize_t ft5x06_read(FAR struct file *filep, FAR char *buffer,
-                           size_t len);
-static int  ft5x06_ioctl(FAR struct file *filep, int cmd,
-                         unsigned long arg);
-#ifndef CONFIG_DISABLE_POLL
-static int  ft5x06_poll(FAR struct file *filep, struct pollfd *fds,
-                        bool setup);
-#endif
+/* Touchscreen lower half methods */
+
+static int  ft5x06_open(FAR struct touch_lowerhalf_s *lower);
+static int  ft5x06_close(FAR struct touch_lowerhalf_s *lower);
+static int  ft5x06_control(FAR struct touch_lowerhalf_s *lower, int cmd,
+                           unsigned long arg);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* This the vtable that supports the character driver interface */
-
-static const struct file_operations ft5x06_fops =
-{
-  ft5x06_open,    /* open */
-  ft5x06_close,   /* close */
-  ft5x06_read,    /* read */
-  NULL,           /* write */
-  NULL,           /* seek */
-  ft5x06_ioctl    /* ioctl */
-#ifndef CONFIG_DISABLE_POLL
-  , ft5x06_poll   /* poll */
-#endif
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL          /* unlink */
-#endif
-};
-
 /* Maps FT5x06 touch events into bit encoded representation used by NuttX */
 
 static const uint8_t g_event_map[4] =
@@ -221,49 +201,6 @@ static const uint8_t g_event_map[4] =
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: ft5x06_notify
- ****************************************************************************/
-
-static void ft5x06_notify(FAR struct ft5x06_dev_s *priv)
-{
-#ifndef CONFIG_DISABLE_POLL
-  int i;
-#endif
-
-  /* If there are threads waiting for read data, then signal one of them
-   * that the read data is available.
-   */
-
-  if (priv->nwaiters > 0)
-    {
-      /* After posting this semaphore, we need to exit because the FT5x06
-       * is no longer available.
-       */
-
-      nxsem_post(&priv->waitsem);
-    }
-
-#ifndef CONFIG_DISABLE_POLL
-  /* If there are threads waiting on poll() for FT5x06 data to become available,
-   * then wake them up now.  NOTE: we wake up all waiting threads because we
-   * do not know that they are going to do.  If they all try to read the data,
-   * then some make end up blocking after all.
-   */
-
-  for (i = 0; i < CONFIG_FT5X06_NPOLLWAITERS; i++)
-    {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
-        {
-          fds->revents |= POLLIN;
-          iinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
-        }
-    }
-#endif
-}
-
 /****************************************************************************
  * Name: ft5x06_data_worker
  ****************************************************************************/
@@ -282,8 +219,8 @@ static void ft5x06_data_worker(FAR void *arg)
   DEBUGASSERT(priv != NULL && priv->config != NULL);
   config = priv->config;
 
-  /* We need to have exclusive access to the touchbuf so that we do not
-   * corrupt any read operation that is in place.
+  /* We need to have exclusive access to the touchbuf and the I2C
+   * frequency.
    */
 
   do
@@ -328,19 +265,15 @@ static void ft5x06_data_worker(FAR void *arg)
 
       sample = (FAR struct ft5x06_touch_data_s *)priv->touchbuf;
 
-      /* Notify waiters (only if we ready some valid data).
-       *
-       * REVISIT: For improved performance consider moving the duplicate
-       * report and thresholding logic from ft5x06_sample() to here.  That
-       * would save a context switch.
+      /* Decode the touch data and pass it to the upper half (only if we
+       * read some valid data).  The upper half time stamps and queues the
+       * sample and wakes up any waiters.
        */
 
-      if (sample->tdstatus <= FT5x06_MAX_TOUCHES)
+      if (sample->tdstatus <= FT5x06_MAX_TOUCHES &&
+          ft5x06_sample(priv, &priv->report.sample) > 0)
         {
-          /* Notify any waiters that new FT5x06 data is available */
-
-          priv->valid = true;
-          ft5x06_notify(priv);
+          touch_event(priv->lower.priv, &priv->report.sample);
         }
 
 #ifdef CONFIG_FT5X06_POLLMODE
@@ -444,26 +377,25 @@ static int ft5x06_data_interrupt(int irq, FAR void *context, FAR void *arg)
 
 /****************************************************************************
  * Name: ft5x06_sample
+ *
+ * Description:
+ *   Decode the raw touch data in touchbuf.  Returns the number of touch
+ *   points in the sample; zero if there is nothing new to report.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FT5X06_SINGLEPOINT
-static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
-                             size_t len)
+static int ft5x06_sample(FAR struct ft5x06_dev_s *priv,
+                         FAR struct touch_sample_s *sample)
 {
   FAR struct ft5x06_touch_data_s *raw;
   FAR struct ft5x06_touch_point_s *touch;
-  FAR struct touch_sample_s *sample;
   FAR struct touch_point_s *point;
   int16_t x;
   int16_t y;
   uint8_t event;
   uint8_t id;
 
-  if (!priv->valid)
-    {
-      return 0;  /* Nothing to read */
-    }
-
   /* Raw data pointers (source) */
 
   raw = (FAR struct ft5x06_touch_data_s *)priv->touchbuf;
@@ -471,7 +403,7 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
 
   /* Get the reported X and Y positions */
 
-  #ifdef CONFIG_FT5X06_SWAPXY
+#ifdef CONFIG_FT5X06_SWAPXY
   y = TOUCH_POINT_GET_X(touch[0]);
   x = TOUCH_POINT_GET_Y(touch[0]);
 #else
@@ -523,11 +455,11 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
                   deltay = -deltay;
                 }
 
-              if (deltax < CONFIG_FT5X06_THRESHX)
+              if (deltay < CONFIG_FT5X06_THRESHY)
                 {
                   /* Ignore... no significant change in Y either */
 
-                  goto drop;
+                  return 0;
                 }
             }
         }
@@ -538,11 +470,8 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
   priv->lastx       = x;
   priv->lasty       = y;
 
-  /* User data buffer points (sink) */
-
   /* Return the number of touches read */
 
-  sample            = (FAR struct touch_sample_s *)buffer;
   sample->npoints   = 1;
 
   /* Decode and return the single touch point */
@@ -556,36 +485,23 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
   point[0].w        = 0;
   point[0].pressure = 0;
 
-  priv->valid       = false;
-  return SIZEOF_TOUCH_SAMPLE_S(1);
+  return 1;
 
 reset_and_drop:
   priv->lastx = 0;
   priv->lasty = 0;
-drop:
-  priv->valid = false;
   return 0;  /* No new touches read. */
 }
 #else
-static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
-                             size_t len)
+static int ft5x06_sample(FAR struct ft5x06_dev_s *priv,
+                         FAR struct touch_sample_s *sample)
 {
   FAR struct ft5x06_touch_data_s *raw;
   FAR struct ft5x06_touch_point_s *touch;
-  FAR struct touch_sample_s *sample;
   FAR struct touch_point_s *point;
-  unsigned int maxtouches;
   unsigned int ntouches;
   int i;
 
-  maxtouches = (len - sizeof(int)) / sizeof(struct touch_point_s);
-  DEBUGASSERT(maxtouches > 0);  /* Already verified */
-
-  if (!priv->valid)
-    {
-      return 0;  /* Nothing to read */
-    }
-
   /* Raw data pointers (source) */
 
   raw      = (FAR struct ft5x06_touch_data_s *)priv->touchbuf;
@@ -596,24 +512,14 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
   ntouches = raw->tdstatus;
   DEBUGASSERT(ntouches <= FT5x06_MAX_TOUCHES);
 
-  if (ntouches > maxtouches)
-    {
-      ntouches = maxtouches;
-    }
-
   if (ntouches < 1)
     {
-      priv->valid = false;
       return 0;  /* No touches read. */
     }
 
-  /* User data buffer points (sink) */
-
-  sample = (FAR struct touch_sample_s *)buffer;
-  point  = sample->point;
-
   /* Return the number of touches read */
 
+  point           = sample->point;
   sample->npoints = ntouches;
 
   /* Decode and return the touch points */
@@ -636,88 +542,10 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
       point[i].pressure = 0;
     }
 
-  priv->valid = false;
-  return SIZEOF_TOUCH_SAMPLE_S(ntouches);
+  return ntouches;
 }
 #endif /* CONFIG_FT5X06_SINGLEPOINT */
 
-/****************************************************************************
- * Name: ft5x06_waitsample
- ****************************************************************************/
-
-static ssize_t ft5x06_waitsample(FAR struct ft5x06_dev_s *priv,
-                                 FAR char *buffer, size_t len)
-{
-  int ret;
-
-  /* Disable pre-emption to prevent other threads from getting control while
-   * we muck with the semaphores.
-   */
-
-  sched_lock();
-
-  /* Now release the semaphore that manages mutually exclusive access to
-   * the device structure.  This may cause other tasks to become ready to
-   * run, but they cannot run yet because pre-emption is disabled.
-   */
-
-  nxsem_post(&priv->devsem);
-
-  /* Try to get the a sample... if we cannot, then wait on the semaphore
-   * that is posted when new sample data is available.
-   */
-
-  while (!priv->valid)
-    {
-      /* Increment the count of waiters */
-
-      priv->nwaiters++;
-
-      /* Wait for a change in the FT5x06 state */
-
-      ret = nxsem_wait(&priv->waitsem);
-      priv->nwaiters--;
-
-      if (ret < 0)
-        {
-          /* If we are awakened by a signal, then we need to return
-           * the failure now.
-           */
-
-          ierr("ERROR: nxsem_wait failed: %d\n", ret);
-          DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-          goto errout;
-        }
-    }
-
-  /* Re-acquire the semaphore that manages mutually exclusive access to
-   * the device structure.  We may have to wait here.  But we have our sample.
-   * Interrupts and pre-emption will be re-enabled while we wait.
-   */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret >= 0)
-    {
-      /* Now sample the data.
-       *
-       * REVISIT:  Is it safe to assume that priv->valid will always be
-       * true?  I think that sched_lock() whould protect the setting.
-       */
-
-      ret = ft5x06_sample(priv, buffer, len);
-    }
-
-errout:
-  /* Restore pre-emption.  We might get suspended here but that is okay
-   * because we already have our sample.  Note:  this means that if there
-   * were two threads reading from the FT5x06 for some reason, the data
-   * might be read out of order.
-   */
-
-  sched_unlock();
-  return ret;
-}
-
 /****************************************************************************
  * Name: ft5x06_bringup
  ****************************************************************************/
@@ -785,209 +613,51 @@ static void ft5x06_shutdown(FAR struct ft5x06_dev_s *priv)
 
 /****************************************************************************
  * Name: ft5x06_open
+ *
+ * Description:
+ *   Called by the upper half on the first open of the device.
+ *
  ****************************************************************************/
 
-static int ft5x06_open(FAR struct file *filep)
+static int ft5x06_open(FAR struct touch_lowerhalf_s *lower)
 {
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s *priv;
-  uint8_t tmp;
+  FAR struct ft5x06_dev_s *priv = (FAR struct ft5x06_dev_s *)lower;
   int ret;
 
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
+  ret = ft5x06_bringup(priv);
   if (ret < 0)
     {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Increment the reference count */
-
-  tmp = priv->crefs + 1;
-  if (tmp == 0)
-    {
-      /* More than 255 opens; uint8_t overflows to zero */
-
-      ret = -EMFILE;
-      goto errout_with_sem;
-    }
-
-  /* When the reference increments to 1, this is the first open event
-   * on the driver.. and the time when we must initialize the driver.
-   */
-
-  if (tmp == 1)
-    {
-      ret = ft5x06_bringup(priv);
-      if (ret < 0)
-        {
-          ierr("ERROR: ft5x06_bringup failed: %d\n", ret);
-          goto errout_with_sem;
-        }
+      ierr("ERROR: ft5x06_bringup failed: %d\n", ret);
     }
 
-  /* Save the new open count on success */
-
-  priv->crefs = tmp;
-
-errout_with_sem:
-  nxsem_post(&priv->devsem);
   return ret;
 }
 
 /****************************************************************************
  * Name: ft5x06_close
+ *
+ * Description:
+ *   Called by the upper half when the last open reference is closed.
+ *
  ****************************************************************************/
 
-static int ft5x06_close(FAR struct file *filep)
+static int ft5x06_close(FAR struct touch_lowerhalf_s *lower)
 {
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int ret;
-
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Decrement the reference count unless it would decrement a negative
-   * value.
-   */
-
-  if (priv->crefs >= 1)
-    {
-      priv->crefs--;
-    }
-
-  /* When the count decrements to zero, there are no further open references
-   * to the driver and it can be uninitialized.
-   */
-
-   if (priv->crefs == 0)
-     {
-       ft5x06_shutdown(priv);
-     }
-
-  nxsem_post(&priv->devsem);
+  ft5x06_shutdown((FAR struct ft5x06_dev_s *)lower);
   return OK;
 }
 
 /****************************************************************************
- * Name: ft5x06_read
+ * Name: ft5x06_control
  ****************************************************************************/
 
-static ssize_t ft5x06_read(FAR struct file *filep, FAR char *buffer,
-                           size_t len)
+static int ft5x06_control(FAR struct touch_lowerhalf_s *lower, int cmd,
+                          unsigned long arg)
 {
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s  *priv;
+  FAR struct ft5x06_dev_s *priv = (FAR struct ft5x06_dev_s *)lower;
   int ret;
 
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Verify that the caller has provided a buffer large enough to receive
-   * the touch data.
-   */
-
-  if (len < SIZEOF_TOUCH_SAMPLE_S(1))
-    {
-      /* We could provide logic to break up a touch report into segments and
-       * handle smaller reads... but why?
-       */
-
-      return -ENOSYS;
-    }
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Try to read sample data. */
-
-  ret = ft5x06_sample(priv, buffer, len);
-  while (ret == 0)
-    {
-      /* Sample data is not available now.  We would have to wait to receive
-       * sample data.  If the user has specified the O_NONBLOCK option, then
-       * just return an error.
-       */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          ret = -EAGAIN;
-          goto errout;
-       }
-
-      /* Wait for sample data */
-
-      ret = ft5x06_waitsample(priv, buffer, len);
-      if (ret < 0)
-        {
-          /* We might have been awakened by a signal */
-
-          goto errout;
-        }
-    }
-
-  ret = SIZEOF_TOUCH_SAMPLE_S(1);
-
-errout:
-  nxsem_post(&priv->devsem);
-  return ret;
-}
-
-/****************************************************************************
- * Name: ft5x06_ioctl
- ****************************************************************************/
-
-static int ft5x06_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
-{
-  FAR struct inode         *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int                       ret;
-
   iinfo("cmd: %d arg: %ld\n", cmd, arg);
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
 
   /* Get exclusive access to the driver data structure */
 
@@ -1030,105 +700,6 @@ static int ft5x06_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
-/****************************************************************************
- * Name: ft5x06_poll
- ****************************************************************************/
-
-#ifndef CONFIG_DISABLE_POLL
-static int ft5x06_poll(FAR struct file *filep, FAR struct pollfd *fds,
-                        bool setup)
-{
-  FAR struct inode         *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int                       ret;
-  int                       i;
-
-  iinfo("setup: %d\n", (int)setup);
-  DEBUGASSERT(filep && fds);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Are we setting up the poll?  Or tearing it down? */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  if (setup)
-    {
-      /* Ignore waits that do not include POLLIN */
-
-      if ((fds->events & POLLIN) == 0)
-        {
-          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
-          ret = -EDEADLK;
-          goto errout;
-        }
-
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_FT5X06_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!priv->fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              priv->fds[i] = fds;
-              fds->priv    = &priv->fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_FT5X06_NPOLLWAITERS)
-        {
-          ierr("ERROR: No available slot found: %d\n", i);
-          fds->priv    = NULL;
-          ret          = -EBUSY;
-          goto errout;
-        }
-
-      /* Should we immediately notify on any of the requested events? */
-
-      if (priv->valid)
-        {
-          ft5x06_notify(priv);
-        }
-    }
-  else if (fds->priv)
-    {
-      /* This is a request to tear down the poll. */
-
-      struct pollfd **slot = (struct pollfd **)fds->priv;
-      DEBUGASSERT(slot != NULL);
-
-      /* Remove all memory of the poll setup */
-
-      *slot                = NULL;
-      fds->priv            = NULL;
-    }
-
-errout:
-  nxsem_post(&priv->devsem);
-  return ret;
-}
-#endif
-
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1183,18 +754,16 @@ int ft5x06_register(FAR struct i2c_master_s *i2c,
 
   /* Initialize the FT5x06 device driver instance */
 
+  priv->lower.maxpoint = FT5X06_MAXPOINT;
+  priv->lower.open     = ft5x06_open;
+  priv->lower.close    = ft5x06_close;
+  priv->lower.control  = ft5x06_control;
+
   priv->i2c       = i2c;               /* Save the I2C device handle */
   priv->config    = config;            /* Save the board configuration */
   priv->frequency = config->frequency; /* Set the current I2C frequency */
 
   nxsem_init(&priv->devsem,  0, 1);    /* Initialize device structure semaphore */
-  nxsem_init(&priv->waitsem, 0, 0);    /* Initialize pen event wait semaphore */
-
-  /* The event wait semaphore is used for signaling and, hence, should not
-   * have priority inheritance enabled.
-   */
-
-  nxsem_setprotocol(&priv->waitsem, SEM_PRIO_NONE);
 
 #ifdef CONFIG_FT5X06_POLLMODE
   /* Allocate a timer for polling the FT5x06 */
@@ -1212,29 +781,34 @@ int ft5x06_register(FAR struct i2c_master_s *i2c,
 
   config->clear(config);
   config->enable(config, false);
+#endif
 
-  /* Attach the interrupt handler */
+  /* Register the device as an input device.  This must be done before the
+   * interrupt is attached because the upper half is the recipient of the
+   * touch samples.
+   */
 
-  ret = config->attach(config, ft5x06_data_interrupt,
-                       priv);
+  (void)snprintf(devname, DEV_NAMELEN, DEV_FORMAT, minor);
+  iinfo("Registering %s\n", devname);
+
+  ret = touch_register(&priv->lower, devname, CONFIG_FT5X06_NBUFFERS);
   if (ret < 0)
     {
-      ierr("ERROR: Failed to attach interrupt\n");
+      ierr("ERROR: touch_register() failed: %d\n", ret);
       goto errout_with_timer;
     }
-#endif
 
-  /* Register the device as an input device */
-
-  (void)snprintf(devname, DEV_NAMELEN, DEV_FORMAT, minor);
-  iinfo("Registering %s\n", devname);
+#ifndef CONFIG_FT5X06_POLLMODE
+  /* Attach the interrupt handler */
 
-  ret = register_driver(devname, &ft5x06_fops, 0666, priv);
+  ret = config->attach(config, ft5x06_data_interrupt,
+                       priv);
   if (ret < 0)
     {
-      ierr("ERROR: register_driver() failed: %d\n", ret);
-      goto errout_with_timer;
+      ierr("ERROR: Failed to attach interrupt\n");
+      goto errout_with_driver;
     }
+#endif
 
   /* Schedule work to perform the initial sampling and to set the data
    * availability conditions.
@@ -1244,13 +818,21 @@ int ft5x06_register(FAR struct i2c_master_s *i2c,
   if (ret < 0)
     {
       ierr("ERROR: Failed to queue work: %d\n", ret);
-      goto errout_with_timer;
+      goto errout_with_irq;
     }
 
   /* And return success */
 
   return OK;
 
+errout_with_irq:
+#ifndef CONFIG_FT5X06_POLLMODE
+  (void)config->attach(config, NULL, NULL);
+
+errout_with_driver:
+#endif
+  touch_unregister(&priv->lower, devname);
+
 errout_with_timer:
 #ifdef CONFIG_FT5X06_POLLMODE
   (void)wd_delete(priv->polltimer);
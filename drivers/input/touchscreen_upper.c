@@ -0,0 +1,949 @@
+/****************************************************************************
+ * drivers/input/touchscreen_upper.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/input/touchscreen.h>
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_INPUT_TOUCH_NPOLLWAITERS
+#  define CONFIG_INPUT_TOUCH_NPOLLWAITERS 2
+#endif
+
+/* The event bits of struct touch_point_s flags */
+
+#define TOUCH_EVENTS  (TOUCH_DOWN | TOUCH_MOVE | TOUCH_UP)
+
+/* Return the sample with index i in the sample queue */
+
+#define TOUCH_SAMPLE(p,i) \
+  ((FAR struct touch_sample_s *)&(p)->tu_ring[(i) * (p)->tu_samplesize])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure tracks one touch contact */
+
+struct touch_slot_s
+{
+  bool     ts_active;         /* True: The contact is down */
+  uint8_t  ts_id;             /* Touch ID of the contact */
+  int16_t  ts_x;              /* Last reported X position */
+  int16_t  ts_y;              /* Last reported Y position */
+  uint16_t ts_pressure;       /* Last reported pressure */
+};
+
+/* This structure provides the state of one touchscreen driver */
+
+struct touch_upperhalf_s
+{
+  /* Saved binding to the lower half touchscreen driver */
+
+  FAR struct touch_lowerhalf_s *tu_lower;
+
+  uint8_t  tu_crefs;          /* Number of open references */
+  uint8_t  tu_nwaiters;       /* Number of threads waiting for samples */
+  uint8_t  tu_nbuffers;       /* Size of the sample queue */
+  uint8_t  tu_head;           /* Index of the next sample to write */
+  uint8_t  tu_tail;           /* Index of the oldest queued sample */
+  uint8_t  tu_nqueued;        /* Number of queued samples */
+  uint32_t tu_overruns;       /* Number of samples discarded */
+  size_t   tu_samplesize;     /* Size of one queued sample */
+  sem_t    tu_exclsem;        /* Supports exclusive access to the device */
+  sem_t    tu_waitsem;        /* Used to wait for samples */
+
+  FAR struct touch_slot_s *tu_slots;    /* Contacts (maxpoint entries) */
+  FAR struct touch_sample_s *tu_filter; /* Scratch space for touch_event() */
+  FAR uint8_t *tu_ring;                 /* Queued samples */
+
+#ifndef CONFIG_DISABLE_POLL
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+  FAR struct pollfd *tu_fds[CONFIG_INPUT_TOUCH_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Semaphore helpers */
+
+static inline int touch_takesem(FAR sem_t *sem);
+#define touch_givesem(s) nxsem_post(s)
+
+/* Sample handling */
+
+static void    touch_notify(FAR struct touch_upperhalf_s *priv);
+static int     touch_filter(FAR struct touch_upperhalf_s *priv,
+                            FAR const struct touch_sample_s *sample,
+                            FAR struct touch_sample_s *out);
+#ifdef CONFIG_INPUT_TOUCH_COALESCE
+static bool    touch_canmerge(FAR const struct touch_sample_s *prev,
+                              FAR const struct touch_sample_s *next);
+#endif
+
+/* Character driver methods */
+
+static int     touch_open(FAR struct file *filep);
+static int     touch_close(FAR struct file *filep);
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t len);
+static int     touch_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_touch_fops =
+{
+  touch_open,  /* open */
+  touch_close, /* close */
+  touch_read,  /* read */
+  NULL,        /* write */
+  NULL,        /* seek */
+  touch_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , touch_poll /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL       /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_takesem
+ ****************************************************************************/
+
+static inline int touch_takesem(FAR sem_t *sem)
+{
+  int ret;
+
+  /* Take a count from the semaphore, possibly waiting */
+
+  ret = nxsem_wait(sem);
+
+  /* The only case that an error should occur here is if the wait is
+   * awakened by a signal
+   */
+
+  DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_notify
+ *
+ * Description:
+ *   Wake up any threads waiting in read() or poll().  Called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void touch_notify(FAR struct touch_upperhalf_s *priv)
+{
+#ifndef CONFIG_DISABLE_POLL
+  int i;
+#endif
+
+  /* If there are threads waiting for read data, then signal one of them
+   * that the read data is available.
+   */
+
+  if (priv->tu_nwaiters > 0)
+    {
+      nxsem_post(&priv->tu_waitsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  /* Wake up all threads waiting in poll() */
+
+  for (i = 0; i < CONFIG_INPUT_TOUCH_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = priv->tu_fds[i];
+      if (fds)
+        {
+          fds->revents |= POLLIN;
+          iinfo("Report events: %02x\n", fds->revents);
+          poll_notify(fds);
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: touch_filter
+ *
+ * Description:
+ *   Match the points of a new sample to the tracked contacts and copy the
+ *   points that carry new information to out.  A contact must be reported
+ *   down before it moves or is released:  A first report of motion becomes
+ *   TOUCH_DOWN, repeated reports of TOUCH_DOWN become TOUCH_MOVE and
+ *   releases of unknown contacts are dropped.  So are reports of motion
+ *   that did not change the position or the pressure.
+ *
+ * Returned Value:
+ *   The number of points in out.
+ *
+ ****************************************************************************/
+
+static int touch_filter(FAR struct touch_upperhalf_s *priv,
+                        FAR const struct touch_sample_s *sample,
+                        FAR struct touch_sample_s *out)
+{
+  FAR const struct touch_point_s *point;
+  FAR struct touch_slot_s *slot;
+  FAR struct touch_slot_s *avail;
+  struct timespec ts;
+  uint64_t timestamp;
+  uint8_t maxpoint = priv->tu_lower->maxpoint;
+  uint8_t flags;
+  int npoints;
+  int i;
+  int j;
+
+  (void)clock_systimespec(&ts);
+  timestamp = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  for (i = 0, npoints = 0; i < sample->npoints && npoints < maxpoint; i++)
+    {
+      point = &sample->point[i];
+      flags = point->flags;
+
+      /* Find the contact with this ID (or a free slot for a new one) */
+
+      slot  = NULL;
+      avail = NULL;
+
+      for (j = 0; j < maxpoint; j++)
+        {
+          if (!priv->tu_slots[j].ts_active)
+            {
+              if (avail == NULL)
+                {
+                  avail = &priv->tu_slots[j];
+                }
+            }
+          else if (priv->tu_slots[j].ts_id == point->id)
+            {
+              slot = &priv->tu_slots[j];
+              break;
+            }
+        }
+
+      if (slot == NULL)
+        {
+          /* Not a known contact.  Only a touch can start a new one. */
+
+          if ((flags & (TOUCH_DOWN | TOUCH_MOVE)) == 0 || avail == NULL)
+            {
+              continue;
+            }
+
+          slot            = avail;
+          slot->ts_active = true;
+          slot->ts_id     = point->id;
+          flags           = (flags & ~TOUCH_EVENTS) | TOUCH_DOWN;
+        }
+      else if ((flags & TOUCH_UP) != 0)
+        {
+          slot->ts_active = false;
+          flags           = (flags & ~TOUCH_EVENTS) | TOUCH_UP;
+        }
+      else if ((flags & (TOUCH_DOWN | TOUCH_MOVE)) != 0)
+        {
+          /* A known contact that is still down.  Drop the report if
+           * nothing changed.
+           */
+
+          if (point->x == slot->ts_x && point->y == slot->ts_y &&
+              point->pressure == slot->ts_pressure)
+            {
+              continue;
+            }
+
+          flags = (flags & ~TOUCH_EVENTS) | TOUCH_MOVE;
+        }
+      else
+        {
+          /* No event */
+
+          continue;
+        }
+
+      slot->ts_x        = point->x;
+      slot->ts_y        = point->y;
+      slot->ts_pressure = point->pressure;
+
+      memcpy(&out->point[npoints], point, sizeof(struct touch_point_s));
+      out->point[npoints].flags = flags;
+
+      if ((point->flags & TOUCH_TIME_VALID) == 0)
+        {
+          out->point[npoints].timestamp = timestamp;
+          out->point[npoints].flags    |= TOUCH_TIME_VALID;
+        }
+
+      npoints++;
+    }
+
+  out->npoints = npoints;
+  return npoints;
+}
+
+/****************************************************************************
+ * Name: touch_canmerge
+ *
+ * Description:
+ *   Return true if next may replace prev in the sample queue:  Both must
+ *   report only the motion of the same contacts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INPUT_TOUCH_COALESCE
+static bool touch_canmerge(FAR const struct touch_sample_s *prev,
+                           FAR const struct touch_sample_s *next)
+{
+  int i;
+
+  if (prev->npoints != next->npoints)
+    {
+      return false;
+    }
+
+  for (i = 0; i < next->npoints; i++)
+    {
+      if ((prev->point[i].flags & TOUCH_EVENTS) != TOUCH_MOVE ||
+          (next->point[i].flags & TOUCH_EVENTS) != TOUCH_MOVE ||
+          prev->point[i].id != next->point[i].id)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: touch_open
+ ****************************************************************************/
+
+static int touch_open(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  irqstate_t flags;
+  uint8_t tmp;
+  int ret;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+  lower = priv->tu_lower;
+
+  /* Get exclusive access to the driver data structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Increment the reference count */
+
+  tmp = priv->tu_crefs + 1;
+  if (tmp == 0)
+    {
+      /* More than 255 opens; uint8_t overflows to zero */
+
+      ret = -EMFILE;
+      goto errout_with_sem;
+    }
+
+  /* When the reference increments to 1, this is the first open event:
+   * Discard any stale samples and start the lower half.
+   */
+
+  if (tmp == 1)
+    {
+      flags = enter_critical_section();
+      priv->tu_head    = 0;
+      priv->tu_tail    = 0;
+      priv->tu_nqueued = 0;
+      memset(priv->tu_slots, 0,
+             lower->maxpoint * sizeof(struct touch_slot_s));
+      leave_critical_section(flags);
+
+      if (lower->open != NULL)
+        {
+          ret = lower->open(lower);
+          if (ret < 0)
+            {
+              ierr("ERROR: Lower half open failed: %d\n", ret);
+              goto errout_with_sem;
+            }
+        }
+    }
+
+  /* Save the new open count on success */
+
+  priv->tu_crefs = tmp;
+
+errout_with_sem:
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_close
+ ****************************************************************************/
+
+static int touch_close(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  int ret;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+  lower = priv->tu_lower;
+
+  /* Get exclusive access to the driver data structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Decrement the reference count.  Stop the lower half when the last
+   * reference is closed.
+   */
+
+  if (priv->tu_crefs > 0 && --priv->tu_crefs == 0 && lower->close != NULL)
+    {
+      (void)lower->close(lower);
+    }
+
+  touch_givesem(&priv->tu_exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: touch_read
+ *
+ * Description:
+ *   Return the oldest queued touch sample.  Points that do not fit in the
+ *   caller's buffer are discarded.
+ *
+ ****************************************************************************/
+
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t len)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_sample_s *sample;
+  FAR struct touch_sample_s *out;
+  irqstate_t flags;
+  size_t maxpoints;
+  ssize_t ret;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Verify that the caller has provided a buffer large enough to receive
+   * at least one touch point.
+   */
+
+  if (len < SIZEOF_TOUCH_SAMPLE_S(1))
+    {
+      return -ENOSYS;
+    }
+
+  maxpoints = 1 + (len - SIZEOF_TOUCH_SAMPLE_S(1)) /
+                  sizeof(struct touch_point_s);
+
+  /* The sample queue is shared with touch_event() which may run in an
+   * interrupt handler.
+   */
+
+  flags = enter_critical_section();
+  while (priv->tu_nqueued == 0)
+    {
+      /* No samples are available.  If the user has specified the
+       * O_NONBLOCK option, then just return an error.
+       */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Wait for a sample */
+
+      priv->tu_nwaiters++;
+      ret = nxsem_wait(&priv->tu_waitsem);
+      priv->tu_nwaiters--;
+
+      if (ret < 0)
+        {
+          DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
+          goto errout;
+        }
+    }
+
+  /* Return the oldest sample */
+
+  sample = TOUCH_SAMPLE(priv, priv->tu_tail);
+  out    = (FAR struct touch_sample_s *)buffer;
+
+  out->npoints = sample->npoints;
+  if (out->npoints > maxpoints)
+    {
+      out->npoints = maxpoints;
+    }
+
+  memcpy(out->point, sample->point,
+         out->npoints * sizeof(struct touch_point_s));
+  ret = SIZEOF_TOUCH_SAMPLE_S(out->npoints);
+
+  if (++priv->tu_tail >= priv->tu_nbuffers)
+    {
+      priv->tu_tail = 0;
+    }
+
+  priv->tu_nqueued--;
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_ioctl
+ ****************************************************************************/
+
+static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  int ret;
+
+  iinfo("cmd: %d arg: %ld\n", cmd, arg);
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+  lower = priv->tu_lower;
+
+  /* All commands are handled by the lower half */
+
+  if (lower->control == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = lower->control(lower, cmd, arg);
+
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL && fds != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Ignore waits that do not include POLLIN */
+
+      if ((fds->events & POLLIN) == 0)
+        {
+          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
+          ret = -EDEADLK;
+          goto errout;
+        }
+
+      /* This is a request to set up the poll.  Find an available slot for
+       * the poll structure reference.
+       */
+
+      flags = enter_critical_section();
+      for (i = 0; i < CONFIG_INPUT_TOUCH_NPOLLWAITERS; i++)
+        {
+          if (priv->tu_fds[i] == NULL)
+            {
+              /* Bind the poll structure and this slot */
+
+              priv->tu_fds[i] = fds;
+              fds->priv       = &priv->tu_fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_INPUT_TOUCH_NPOLLWAITERS)
+        {
+          ierr("ERROR: No available slot found: %d\n", i);
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (priv->tu_nqueued > 0)
+        {
+          /* Samples are already available */
+
+          touch_notify(priv);
+        }
+
+      leave_critical_section(flags);
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      flags     = enter_critical_section();
+      *slot     = NULL;
+      fds->priv = NULL;
+      leave_critical_section(flags);
+    }
+
+errout:
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Report a new touch sample to the upper half driver.  Points are matched
+ *   to their contacts by ID, unchanged motion reports are dropped and, if
+ *   the newest queued sample has not been read yet and holds only motion of
+ *   the same contacts, it is replaced instead of queuing another sample.
+ *   If the queue is full, the oldest sample is discarded.  The sample is
+ *   time stamped here unless the lower half set TOUCH_TIME_VALID.
+ *
+ *   This function may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   handle - The priv field of the lower half structure
+ *   sample - The new touch sample.  The contents are copied.
+ *
+ ****************************************************************************/
+
+void touch_event(FAR void *handle, FAR const struct touch_sample_s *sample)
+{
+  FAR struct touch_upperhalf_s *priv =
+    (FAR struct touch_upperhalf_s *)handle;
+  FAR struct touch_sample_s *dest;
+  irqstate_t flags;
+#ifdef CONFIG_INPUT_TOUCH_COALESCE
+  uint8_t newest;
+#endif
+
+  DEBUGASSERT(priv != NULL && sample != NULL);
+
+  flags = enter_critical_section();
+
+  /* Nobody is listening if the device is not open */
+
+  if (priv->tu_crefs == 0 ||
+      touch_filter(priv, sample, priv->tu_filter) == 0)
+    {
+      goto out;
+    }
+
+  dest = NULL;
+
+#ifdef CONFIG_INPUT_TOUCH_COALESCE
+  /* Replace the newest queued sample if it only holds older positions of
+   * the same moving contacts.
+   */
+
+  if (priv->tu_nqueued > 0)
+    {
+      newest = (priv->tu_head > 0 ? priv->tu_head : priv->tu_nbuffers) - 1;
+      if (touch_canmerge(TOUCH_SAMPLE(priv, newest), priv->tu_filter))
+        {
+          dest = TOUCH_SAMPLE(priv, newest);
+        }
+    }
+#endif
+
+  if (dest == NULL)
+    {
+      /* Queue a new sample.  Discard the oldest one if the queue is full. */
+
+      if (priv->tu_nqueued >= priv->tu_nbuffers)
+        {
+          if (++priv->tu_tail >= priv->tu_nbuffers)
+            {
+              priv->tu_tail = 0;
+            }
+
+          priv->tu_nqueued--;
+          priv->tu_overruns++;
+          iwarn("WARNING: Touch sample discarded (%lu)\n",
+                (unsigned long)priv->tu_overruns);
+        }
+
+      dest = TOUCH_SAMPLE(priv, priv->tu_head);
+      if (++priv->tu_head >= priv->tu_nbuffers)
+        {
+          priv->tu_head = 0;
+        }
+
+      priv->tu_nqueued++;
+    }
+
+  memcpy(dest, priv->tu_filter,
+         SIZEOF_TOUCH_SAMPLE_S(priv->tu_filter->npoints));
+
+  touch_notify(priv);
+
+out:
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Bind a touchscreen lower half driver to a new instance of the upper
+ *   half driver and register the character driver at the specified path
+ *   (usually /dev/inputN).
+ *
+ * Input Parameters:
+ *   lower    - The lower half driver instance
+ *   path     - The device path
+ *   nbuffers - The number of touch samples that can be queued
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t nbuffers)
+{
+  FAR struct touch_upperhalf_s *priv;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && path != NULL && lower->maxpoint > 0 &&
+              nbuffers > 0);
+
+  /* Allocate a new upper half driver instance */
+
+  priv = (FAR struct touch_upperhalf_s *)
+    kmm_zalloc(sizeof(struct touch_upperhalf_s));
+  if (priv == NULL)
+    {
+      ierr("ERROR: Failed to allocate device structure\n");
+      return -ENOMEM;
+    }
+
+  priv->tu_lower      = lower;
+  priv->tu_nbuffers   = nbuffers;
+  priv->tu_samplesize = SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint);
+
+  /* One more sample is allocated as scratch space for touch_event() */
+
+  priv->tu_ring  = (FAR uint8_t *)
+    kmm_malloc((nbuffers + 1) * priv->tu_samplesize);
+  priv->tu_slots = (FAR struct touch_slot_s *)
+    kmm_zalloc(lower->maxpoint * sizeof(struct touch_slot_s));
+
+  if (priv->tu_ring == NULL || priv->tu_slots == NULL)
+    {
+      ierr("ERROR: Failed to allocate sample queue\n");
+      ret = -ENOMEM;
+      goto errout_with_priv;
+    }
+
+  priv->tu_filter = TOUCH_SAMPLE(priv, nbuffers);
+
+  nxsem_init(&priv->tu_exclsem, 0, 1);
+  nxsem_init(&priv->tu_waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&priv->tu_waitsem, SEM_PRIO_NONE);
+
+  lower->priv = priv;
+
+  iinfo("Registering %s\n", path);
+
+  ret = register_driver(path, &g_touch_fops, 0666, priv);
+  if (ret < 0)
+    {
+      ierr("ERROR: register_driver() failed: %d\n", ret);
+      lower->priv = NULL;
+      nxsem_destroy(&priv->tu_exclsem);
+      nxsem_destroy(&priv->tu_waitsem);
+      goto errout_with_priv;
+    }
+
+  return OK;
+
+errout_with_priv:
+  if (priv->tu_slots != NULL)
+    {
+      kmm_free(priv->tu_slots);
+    }
+
+  if (priv->tu_ring != NULL)
+    {
+      kmm_free(priv->tu_ring);
+    }
+
+  kmm_free(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_unregister
+ *
+ * Description:
+ *   Unregister the character driver and free the upper half driver
+ *   instance.
+ *
+ ****************************************************************************/
+
+void touch_unregister(FAR struct touch_lowerhalf_s *lower,
+                      FAR const char *path)
+{
+  FAR struct touch_upperhalf_s *priv;
+
+  DEBUGASSERT(lower != NULL && lower->priv != NULL && path != NULL);
+  priv = (FAR struct touch_upperhalf_s *)lower->priv;
+
+  (void)unregister_driver(path);
+
+  lower->priv = NULL;
+  nxsem_destroy(&priv->tu_exclsem);
+  nxsem_destroy(&priv->tu_waitsem);
+  kmm_free(priv->tu_slots);
+  kmm_free(priv->tu_ring);
+  kmm_free(priv);
+}
+
+#endif /* CONFIG_INPUT_TOUCHSCREEN */
@@ -0,0 +1,494 @@
+/****************************************************************************
+ * drivers/ioexpander/gpio_port.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/ioexpander/ioexpander.h>
+#include <nuttx/ioexpander/gpio.h>
+
+#ifdef CONFIG_GPIO_PORT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* GPIO port driver state */
+
+struct gpport_dev_s
+{
+  FAR struct ioexpander_dev_s *ioe; /* Contain I/O expander interface */
+  ioe_pinset_t pinmask;             /* The pins of the port */
+  sem_t exclsem;                    /* Serializes (un)registration */
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+  FAR void *handle;                 /* Interrupt attach handle */
+
+  /* Tasks to be signalled when pins change */
+
+  struct gpio_signal_s signals[CONFIG_DEV_GPIO_NSIGNALS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+static int     gpport_handler(FAR struct ioexpander_dev_s *ioe,
+                              ioe_pinset_t pinset, FAR void *arg);
+static int     gpport_register(FAR struct gpport_dev_s *priv,
+                               FAR const struct sigevent *event);
+static int     gpport_unregister(FAR struct gpport_dev_s *priv);
+#endif
+static int     gpport_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_gpport_drvrops =
+{
+  NULL,         /* open */
+  NULL,         /* close */
+  NULL,         /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  gpport_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , NULL        /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL        /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gpport_handler
+ *
+ * Description:
+ *   I/O expander interrupt callback function.  The I/O expander reports
+ *   all of the pins that changed since the last callback at once;  each
+ *   registered task receives one signal carrying that set of pins.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+static int gpport_handler(FAR struct ioexpander_dev_s *ioe,
+                          ioe_pinset_t pinset, FAR void *arg)
+{
+  FAR struct gpport_dev_s *priv = (FAR struct gpport_dev_s *)arg;
+  struct sigevent event;
+  irqstate_t flags;
+  pid_t pid;
+  int i;
+
+  DEBUGASSERT(priv != NULL);
+
+  gpioinfo("pinset: %lx\n", (unsigned long)pinset);
+
+  for (i = 0; i < CONFIG_DEV_GPIO_NSIGNALS; i++)
+    {
+      flags = enter_critical_section();
+      pid   = priv->signals[i].gp_pid;
+      memcpy(&event, &priv->signals[i].gp_event, sizeof(struct sigevent));
+      leave_critical_section(flags);
+
+      if (pid == 0)
+        {
+          break;
+        }
+
+      event.sigev_value.sival_int = (int)(pinset & priv->pinmask);
+      nxsig_notification(pid, &event, SI_QUEUE);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: gpport_register
+ *
+ * Description:
+ *   Add the calling task to the tasks to be signalled when pins change
+ *   and attach to the I/O expander interrupt when the first task is added.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+static int gpport_register(FAR struct gpport_dev_s *priv,
+                           FAR const struct sigevent *event)
+{
+  irqstate_t flags;
+  pid_t pid;
+  int ret;
+  int i;
+
+  if (event == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pid   = getpid();
+  flags = enter_critical_section();
+
+  for (i = 0; i < CONFIG_DEV_GPIO_NSIGNALS; i++)
+    {
+      FAR struct gpio_signal_s *signal = &priv->signals[i];
+
+      if (signal->gp_pid == 0 || signal->gp_pid == pid)
+        {
+          memcpy(&signal->gp_event, event, sizeof(struct sigevent));
+          signal->gp_pid = pid;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (i >= CONFIG_DEV_GPIO_NSIGNALS)
+    {
+      ret = -EBUSY;
+    }
+  else if (priv->handle == NULL)
+    {
+      priv->handle = IOEP_ATTACH(priv->ioe, priv->pinmask, gpport_handler,
+                                 priv);
+      if (priv->handle == NULL)
+        {
+          gpioerr("ERROR: IOEP_ATTACH() failed\n");
+          priv->signals[i].gp_pid = 0;
+          ret = -EIO;
+        }
+    }
+
+  nxsem_post(&priv->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: gpport_unregister
+ *
+ * Description:
+ *   Remove the calling task from the tasks to be signalled and detach from
+ *   the I/O expander interrupt when no task is left.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+static int gpport_unregister(FAR struct gpport_dev_s *priv)
+{
+  irqstate_t flags;
+  pid_t pid;
+  int ret;
+  int i;
+  int j;
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pid   = getpid();
+  flags = enter_critical_section();
+
+  for (i = 0; i < CONFIG_DEV_GPIO_NSIGNALS; i++)
+    {
+      if (priv->signals[i].gp_pid == pid)
+        {
+          break;
+        }
+    }
+
+  if (i < CONFIG_DEV_GPIO_NSIGNALS)
+    {
+      /* Keep the table packed:  Move the last entry into the hole */
+
+      for (j = i + 1; j < CONFIG_DEV_GPIO_NSIGNALS; j++)
+        {
+          if (priv->signals[j].gp_pid == 0)
+            {
+              break;
+            }
+        }
+
+      if (i != --j)
+        {
+          memcpy(&priv->signals[i], &priv->signals[j],
+                 sizeof(struct gpio_signal_s));
+        }
+
+      priv->signals[j].gp_pid = 0;
+    }
+
+  leave_critical_section(flags);
+
+  if (i >= CONFIG_DEV_GPIO_NSIGNALS)
+    {
+      ret = -EINVAL;
+    }
+  else if (priv->signals[0].gp_pid == 0 && priv->handle != NULL)
+    {
+      ret = IOEP_DETACH(priv->ioe, priv->handle);
+      priv->handle = NULL;
+    }
+
+  nxsem_post(&priv->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: gpport_ioctl
+ *
+ * Description:
+ *   Standard character driver ioctl method.
+ *
+ ****************************************************************************/
+
+static int gpport_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode;
+  FAR struct gpport_dev_s *priv;
+  int ret;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private != NULL);
+  priv  = (FAR struct gpport_dev_s *)inode->i_private;
+
+  switch (cmd)
+    {
+      /* Command:     GPIOC_PORTREAD
+       * Description: Read the level of all pins of the port at once.
+       * Argument:    A pointer to a uint32_t to receive the pin levels.
+       */
+
+      case GPIOC_PORTREAD:
+        {
+          FAR uint32_t *ptr = (FAR uint32_t *)((uintptr_t)arg);
+          ioe_pinset_t pinset;
+
+          DEBUGASSERT(ptr != NULL);
+
+          ret = IOEXP_READPORT(priv->ioe, &pinset);
+          if (ret >= 0)
+            {
+              *ptr = (uint32_t)(pinset & priv->pinmask);
+            }
+        }
+        break;
+
+      /* Command:     GPIOC_PORTWRITE
+       * Description: Set the level of several output pins at once.
+       * Argument:    A pointer to an instance of struct gpio_port_s.
+       */
+
+      case GPIOC_PORTWRITE:
+        {
+          FAR const struct gpio_port_s *port =
+            (FAR const struct gpio_port_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(port != NULL);
+
+          if ((port->gp_mask & ~(uint32_t)priv->pinmask) != 0)
+            {
+              ret = -EACCES;
+            }
+          else
+            {
+              ret = IOEXP_WRITEPORT(priv->ioe, (ioe_pinset_t)port->gp_mask,
+                                    (ioe_pinset_t)port->gp_value);
+            }
+        }
+        break;
+
+      /* Command:     GPIOC_PORTDIRECTION
+       * Description: Set the direction of several pins at once.
+       * Argument:    A pointer to an instance of struct gpio_port_s.
+       */
+
+      case GPIOC_PORTDIRECTION:
+        {
+          FAR const struct gpio_port_s *port =
+            (FAR const struct gpio_port_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(port != NULL);
+
+          if ((port->gp_mask & ~(uint32_t)priv->pinmask) != 0)
+            {
+              ret = -EACCES;
+            }
+          else
+            {
+              ret = IOEXP_SETPORTDIRECTION(priv->ioe,
+                                           (ioe_pinset_t)port->gp_mask,
+                                           (ioe_pinset_t)port->gp_value);
+            }
+        }
+        break;
+
+#ifdef CONFIG_IOEXPANDER_INT_ENABLE
+      /* Command:     GPIOC_REGISTER
+       * Description: Register to receive a signal whenever pins of the
+       *              port change.
+       * Argument:    A pointer to the struct sigevent that describes the
+       *              signal.
+       */
+
+      case GPIOC_REGISTER:
+        ret = gpport_register(priv,
+                              (FAR const struct sigevent *)((uintptr_t)arg));
+        break;
+
+      /* Command:     GPIOC_UNREGISTER
+       * Description: Stop receiving signals for pin changes.
+       * Argument:    None.
+       */
+
+      case GPIOC_UNREGISTER:
+        ret = gpport_unregister(priv);
+        break;
+#endif
+
+      /* Unrecognized command */
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gpio_port_register
+ *
+ * Description:
+ *   Register a GPIO port device driver at /dev/gpportN that gives access
+ *   to a group of I/O expander pins with one ioctl() call per operation.
+ *   The pins must already have been configured by the caller (including
+ *   the interrupt type of pins whose changes are to be signalled).
+ *
+ * Input Parameters:
+ *   ioe     - An instance of the I/O expander interface.  It must support
+ *             the port methods (see IOEXP_READPORT).
+ *   pinmask - The set of I/O expander pins in the port (pins 0-31)
+ *   minor   - The minor device number to use when registering the device
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int gpio_port_register(FAR struct ioexpander_dev_s *ioe, uint32_t pinmask,
+                       int minor)
+{
+  FAR struct gpport_dev_s *priv;
+  char devname[16];
+  int ret;
+
+  DEBUGASSERT(ioe != NULL && pinmask != 0 && (unsigned int)minor < 100);
+
+  if (ioe->ops->ioe_readport == NULL || ioe->ops->ioe_writeport == NULL ||
+      ioe->ops->ioe_portdirection == NULL)
+    {
+      gpioerr("ERROR: The I/O expander does not support port access\n");
+      return -ENOSYS;
+    }
+
+  /* Allocate an new instance of the GPIO port driver */
+
+  priv = (FAR struct gpport_dev_s *)kmm_zalloc(sizeof(struct gpport_dev_s));
+  if (priv == NULL)
+    {
+      gpioerr("ERROR: Failed to allocate driver state\n");
+      return -ENOMEM;
+    }
+
+  priv->ioe     = ioe;
+  priv->pinmask = (ioe_pinset_t)pinmask & IOEXPANDER_PINMASK;
+  nxsem_init(&priv->exclsem, 0, 1);
+
+  /* Register the GPIO port driver */
+
+  snprintf(devname, 16, "/dev/gpport%u", (unsigned int)minor);
+  gpioinfo("Registering %s\n", devname);
+
+  ret = register_driver(devname, &g_gpport_drvrops, 0666, priv);
+  if (ret < 0)
+    {
+      gpioerr("ERROR: register_driver() failed: %d\n", ret);
+      nxsem_destroy(&priv->exclsem);
+      kmm_free(priv);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_GPIO_PORT */
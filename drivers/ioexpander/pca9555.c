@@ -98,6 +98,14 @@ static FAR void *pca9555_attach(FAR struct ioexpander_dev_s *dev,
 static int pca9555_detach(FAR struct ioexpander_dev_s *dev,
              FAR void *handle);
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+static int pca9555_readport(FAR struct ioexpander_dev_s *dev,
+             FAR ioe_pinset_t *pinset);
+static int pca9555_writeport(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t value);
+static int pca9555_portdirection(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t outputs);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -134,6 +142,11 @@ static const struct ioexpander_ops_s g_pca9555_ops =
   , pca9555_attach
   , pca9555_detach
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+  , pca9555_readport
+  , pca9555_writeport
+  , pca9555_portdirection
+#endif
 };
 
 /****************************************************************************
@@ -289,6 +302,66 @@ static int pca9555_setbit(FAR struct pca9555_dev_s *pca, uint8_t addr,
   return ret;
 }
 
+/****************************************************************************
+ * Name: pca9555_modify
+ *
+ * Description:
+ *  Change the bits in mask of a register pair to the corresponding bits of
+ *  value.  Bit n of mask and value corresponds to pin n.  In shadow mode
+ *  this costs a single I2C write.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_PORT
+static int pca9555_modify(FAR struct pca9555_dev_s *pca, uint8_t addr,
+                          uint16_t mask, uint16_t value)
+{
+  uint8_t buf[3];
+  int ret;
+
+  buf[0] = addr;
+
+#ifdef CONFIG_PCA9555_SHADOW_MODE
+  /* Get the shadowed register values */
+
+  buf[1] = pca->sreg[addr];
+  buf[2] = pca->sreg[addr + 1];
+
+#else
+  /* Get the register values from the IO-Expander */
+
+  ret = pca9555_writeread(pca, &buf[0], 1, &buf[1], 2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+  buf[1] = (buf[1] & ~(uint8_t)mask) | ((uint8_t)value & (uint8_t)mask);
+  buf[2] = (buf[2] & ~(uint8_t)(mask >> 8)) |
+           ((uint8_t)(value >> 8) & (uint8_t)(mask >> 8));
+
+#ifdef CONFIG_PCA9555_SHADOW_MODE
+  /* Save the new register values in the shadow registers */
+
+  pca->sreg[addr]     = buf[1];
+  pca->sreg[addr + 1] = buf[2];
+#endif
+
+  ret = pca9555_write(pca, buf, 3);
+#ifdef CONFIG_PCA9555_RETRY
+  if (ret != OK)
+    {
+      /* Try again (only once) */
+
+      ret = pca9555_write(pca, buf, 3);
+    }
+#endif
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pca9555_getbit
  *
@@ -709,6 +782,113 @@ static int pca9555_multireadbuf(FAR struct ioexpander_dev_s *dev,
 
 #endif
 
+#ifdef CONFIG_IOEXPANDER_PORT
+
+/****************************************************************************
+ * Name: pca9555_readport
+ *
+ * Description:
+ *   Read the level of all 16 pins with a single I2C transfer.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   pinset - The location to return the pin levels
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pca9555_readport(FAR struct ioexpander_dev_s *dev,
+                            FAR ioe_pinset_t *pinset)
+{
+  FAR struct pca9555_dev_s *pca = (FAR struct pca9555_dev_s *)dev;
+  uint8_t addr = PCA9555_REG_INPUT;
+  uint8_t buf[2];
+  int ret;
+
+  DEBUGASSERT(pinset != NULL);
+
+  /* Get exclusive access to the PCA555 */
+
+  pca9555_lock(pca);
+  ret = pca9555_writeread(pca, &addr, 1, buf, 2);
+  pca9555_unlock(pca);
+
+  if (ret >= 0)
+    {
+      *pinset = (ioe_pinset_t)(((uint16_t)buf[1] << 8) | buf[0]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pca9555_writeport
+ *
+ * Description:
+ *   Set the level of the output pins in mask.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   mask  - The set of pins to change
+ *   value - The new levels of the pins in mask
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pca9555_writeport(FAR struct ioexpander_dev_s *dev,
+                             ioe_pinset_t mask, ioe_pinset_t value)
+{
+  FAR struct pca9555_dev_s *pca = (FAR struct pca9555_dev_s *)dev;
+  int ret;
+
+  /* Get exclusive access to the PCA555 */
+
+  pca9555_lock(pca);
+  ret = pca9555_modify(pca, PCA9555_REG_OUTPUT, (uint16_t)mask,
+                       (uint16_t)value);
+  pca9555_unlock(pca);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pca9555_portdirection
+ *
+ * Description:
+ *   Set the direction of the pins in mask.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   mask    - The set of pins to change
+ *   outputs - The pins in mask that become outputs
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pca9555_portdirection(FAR struct ioexpander_dev_s *dev,
+                                 ioe_pinset_t mask, ioe_pinset_t outputs)
+{
+  FAR struct pca9555_dev_s *pca = (FAR struct pca9555_dev_s *)dev;
+  int ret;
+
+  /* Get exclusive access to the PCA555.  A one in the configuration
+   * register selects an input.
+   */
+
+  pca9555_lock(pca);
+  ret = pca9555_modify(pca, PCA9555_REG_CONFIG, (uint16_t)mask,
+                       (uint16_t)~outputs);
+  pca9555_unlock(pca);
+  return ret;
+}
+
+#endif /* CONFIG_IOEXPANDER_PORT */
+
 #ifdef CONFIG_PCA9555_INT_ENABLE
 
 /****************************************************************************
@@ -788,7 +968,7 @@ static int pca9555_detach(FAR struct ioexpander_dev_s *dev, FAR void *handle)
 
   DEBUGASSERT(pca != NULL && cb != NULL);
   DEBUGASSERT((uintptr_t)cb >= (uintptr_t)&pca->cb[0] &&
-              (uintptr_t)cb <= (uintptr_t)&pca->cb[CONFIG_TCA64XX_INT_NCALLBACKS-1]);
+              (uintptr_t)cb <= (uintptr_t)&pca->cb[CONFIG_PCA9555_INT_NCALLBACKS-1]);
   UNUSED(pca);
 
   cb->pinset = 0;
@@ -811,12 +991,16 @@ static void pca9555_irqworker(void *arg)
   FAR struct pca9555_dev_s *pca = (FAR struct pca9555_dev_s *)arg;
   uint8_t addr = PCA9555_REG_INPUT;
   uint8_t buf[2];
+  uint16_t input;
   ioe_pinset_t pinset;
   int ret;
   int i;
 
-  /* Read inputs */
+  /* Read inputs.  Interrupts stay disabled until this work has run so all
+   * of the changes that happened in the meantime are reported together.
+   */
 
+  pca9555_lock(pca);
   ret = pca9555_writeread(pca, &addr, 1, buf, 2);
   if (ret == OK)
     {
@@ -826,9 +1010,19 @@ static void pca9555_irqworker(void *arg)
       pca->sreg[addr]   = buf[0];
       pca->sreg[addr+1] = buf[1];
 #endif
-      /* Create a 16-bit pinset */
+      /* Create a 16-bit pinset of the pins that changed since the last
+       * interrupt.  Pins 0-7 are in port 0.
+       */
+
+      input      = ((uint16_t)buf[1] << 8) | buf[0];
+      pinset     = (ioe_pinset_t)(input ^ pca->input);
+      pca->input = input;
+    }
 
-      pinset = ((unsigned int)buf[0] << 8) | buf[1];
+  pca9555_unlock(pca);
+
+  if (ret == OK)
+    {
 
       /* Perform pin interrupt callbacks */
 
@@ -915,6 +1109,12 @@ FAR struct ioexpander_dev_s *pca9555_initialize(FAR struct i2c_master_s *i2cdev,
                                                 FAR struct pca9555_config_s *config)
 {
   FAR struct pca9555_dev_s *pcadev;
+#if defined(CONFIG_PCA9555_SHADOW_MODE) || defined(CONFIG_PCA9555_INT_ENABLE)
+  uint8_t addr;
+#endif
+#ifdef CONFIG_PCA9555_INT_ENABLE
+  uint8_t buf[2];
+#endif
 
   DEBUGASSERT(i2cdev != NULL && config != NULL);
 
@@ -946,6 +1146,34 @@ FAR struct ioexpander_dev_s *pca9555_initialize(FAR struct i2c_master_s *i2cdev,
   pcadev->dev.ops = &g_pca9555_ops;
   pcadev->config  = config;
 
+#ifdef CONFIG_PCA9555_SHADOW_MODE
+  /* Load the shadow registers.  The power-on values are used if the
+   * device cannot be read.
+   */
+
+  pcadev->sreg[PCA9555_REG_OUTPUT]     = 0xff;
+  pcadev->sreg[PCA9555_REG_OUTPUT + 1] = 0xff;
+  pcadev->sreg[PCA9555_REG_POLINV]     = 0x00;
+  pcadev->sreg[PCA9555_REG_POLINV + 1] = 0x00;
+  pcadev->sreg[PCA9555_REG_CONFIG]     = 0xff;
+  pcadev->sreg[PCA9555_REG_CONFIG + 1] = 0xff;
+
+  for (addr = PCA9555_REG_OUTPUT; addr <= PCA9555_REG_CONFIG; addr += 2)
+    {
+      (void)pca9555_writeread(pcadev, &addr, 1, &pcadev->sreg[addr], 2);
+    }
+#endif
+
+#ifdef CONFIG_PCA9555_INT_ENABLE
+  /* Remember the current input levels so that only changes are reported */
+
+  addr = PCA9555_REG_INPUT;
+  if (pca9555_writeread(pcadev, &addr, 1, buf, 2) == OK)
+    {
+      pcadev->input = ((uint16_t)buf[1] << 8) | buf[0];
+    }
+#endif
+
 #ifdef CONFIG_PCA9555_INT_ENABLE
   pcadev->config->attach(pcadev->config, pca9555_interrupt, pcadev);
   pcadev->config->enable(pcadev->config, TRUE);
@@ -156,6 +156,7 @@ struct pca9555_dev_s
 
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
   struct work_s work;                   /* Supports the interrupt handling "bottom half" */
+  uint16_t input;                       /* Input levels seen by the last interrupt */
 
   /* Saved callback information for each I/O expander client */
 
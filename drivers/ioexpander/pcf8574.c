@@ -92,6 +92,14 @@ static int pcf8574_multiwritepin(FAR struct ioexpander_dev_s *dev,
 static int pcf8574_multireadpin(FAR struct ioexpander_dev_s *dev,
              FAR uint8_t *pins, FAR bool *values, int count);
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+static int pcf8574_readport(FAR struct ioexpander_dev_s *dev,
+             FAR ioe_pinset_t *pinset);
+static int pcf8574_writeport(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t value);
+static int pcf8574_portdirection(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t outputs);
+#endif
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
 static FAR void *pcf8574_attach(FAR struct ioexpander_dev_s *dev,
              ioe_pinset_t pinset, ioe_callback_t callback, FAR void *arg);
@@ -138,6 +146,11 @@ static const struct ioexpander_ops_s g_pcf8574_ops =
   , pcf8574_attach
   , pcf8574_detach
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+  , pcf8574_readport
+  , pcf8574_writeport
+  , pcf8574_portdirection
+#endif
 };
 
 /****************************************************************************
@@ -707,6 +720,139 @@ errout_with_lock:
 }
 #endif
 
+#ifdef CONFIG_IOEXPANDER_PORT
+/****************************************************************************
+ * Name: pcf8574_readport
+ *
+ * Description:
+ *   Read the level of all pins.  The last value written is returned for
+ *   output pins.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   pinset - The location to return the pin levels
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pcf8574_readport(FAR struct ioexpander_dev_s *dev,
+                            FAR ioe_pinset_t *pinset)
+{
+  FAR struct pcf8574_dev_s *priv = (FAR struct pcf8574_dev_s *)dev;
+  uint8_t regval;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL && pinset != NULL);
+
+  /* Get exclusive access to the I/O Expander */
+
+  pcf8574_lock(priv);
+
+  ret = pcf8574_read(priv, &regval);
+  if (ret < 0)
+    {
+      gpioerr("ERROR: Failed to read port register: %d\n", ret);
+      goto errout_with_lock;
+    }
+
+#ifdef CONFIG_PCF8574_INT_ENABLE
+  /* Update the input status with the 8 bits read from the expander */
+
+  pcf8574_int_update(priv, regval);
+#endif
+
+  *pinset = (ioe_pinset_t)((regval & priv->inpins) |
+                           (priv->outstate & ~priv->inpins));
+  ret = OK;
+
+errout_with_lock:
+  pcf8574_unlock(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pcf8574_writeport
+ *
+ * Description:
+ *   Set the level of the output pins in mask.  Input pins in mask are
+ *   ignored.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   mask  - The set of pins to change
+ *   value - The new levels of the pins in mask
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pcf8574_writeport(FAR struct ioexpander_dev_s *dev,
+                             ioe_pinset_t mask, ioe_pinset_t value)
+{
+  FAR struct pcf8574_dev_s *priv = (FAR struct pcf8574_dev_s *)dev;
+  uint8_t outmask;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL);
+
+  /* Get exclusive access to the I/O Expander */
+
+  pcf8574_lock(priv);
+
+  outmask        = (uint8_t)mask & ~priv->inpins;
+  priv->outstate  = (priv->outstate & ~outmask) | ((uint8_t)value & outmask);
+
+  ret = pcf8574_write(priv, priv->inpins | priv->outstate);
+
+  pcf8574_unlock(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pcf8574_portdirection
+ *
+ * Description:
+ *   Set the direction of the pins in mask.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   mask    - The set of pins to change
+ *   outputs - The pins in mask that become outputs
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int pcf8574_portdirection(FAR struct ioexpander_dev_s *dev,
+                                 ioe_pinset_t mask, ioe_pinset_t outputs)
+{
+  FAR struct pcf8574_dev_s *priv = (FAR struct pcf8574_dev_s *)dev;
+  uint8_t inputs;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL);
+
+  /* Get exclusive access to the I/O Expander */
+
+  pcf8574_lock(priv);
+
+  /* Input pins are written high (quasi-bidirectional) */
+
+  inputs          = (uint8_t)mask & ~(uint8_t)outputs;
+  priv->inpins    = (priv->inpins & ~(uint8_t)mask) | inputs;
+  priv->outstate &= ~inputs;
+
+  ret = pcf8574_write(priv, priv->inpins | priv->outstate);
+
+  pcf8574_unlock(priv);
+  return ret;
+}
+#endif /* CONFIG_IOEXPANDER_PORT */
+
 /****************************************************************************
  * Name: pcf8574_attach
  *
@@ -87,6 +87,8 @@ static int tca64_getreg(FAR struct tca64_dev_s *priv, uint8_t regaddr,
              FAR uint8_t *regval, unsigned int count);
 static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
              FAR uint8_t *regval, unsigned int count);
+static int tca64_modify(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+             ioe_pinset_t mask, ioe_pinset_t value);
 
 /* I/O Expander Methods */
 
@@ -104,6 +106,14 @@ static int tca64_multiwritepin(FAR struct ioexpander_dev_s *dev,
 static int tca64_multireadpin(FAR struct ioexpander_dev_s *dev,
              FAR uint8_t *pins, FAR bool *values, int count);
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+static int tca64_readport(FAR struct ioexpander_dev_s *dev,
+             FAR ioe_pinset_t *pinset);
+static int tca64_writeport(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t value);
+static int tca64_portdirection(FAR struct ioexpander_dev_s *dev,
+             ioe_pinset_t mask, ioe_pinset_t outputs);
+#endif
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
 static FAR void *tca64_attach(FAR struct ioexpander_dev_s *dev,
              ioe_pinset_t pinset, ioe_callback_t callback, FAR void *arg);
@@ -151,6 +161,11 @@ static const struct ioexpander_ops_s g_tca64_ops =
   , tca64_attach
   , tca64_detach
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+  , tca64_readport
+  , tca64_writeport
+  , tca64_portdirection
+#endif
 };
 
 /* TCA64 part data */
@@ -257,7 +272,7 @@ static uint8_t tca64_ngpios(FAR struct tca64_dev_s *priv)
 static uint8_t tca64_input_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
 {
   FAR const struct tca64_part_s *part = tca64_getpart(priv);
-  uint8_t reg = part->tp_output;
+  uint8_t reg = part->tp_input;
 
   DEBUGASSERT(pin <= part->tp_ngpios);
   return reg + (pin >> 3);
@@ -291,7 +306,7 @@ static uint8_t tca64_output_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
 static uint8_t tca64_polarity_reg(FAR struct tca64_dev_s *priv, uint8_t pin)
 {
   FAR const struct tca64_part_s *part = tca64_getpart(priv);
-  uint8_t reg = part->tp_output;
+  uint8_t reg = part->tp_polarity;
 
   DEBUGASSERT(pin <= part->tp_ngpios);
   return reg + (pin >> 3);
@@ -330,6 +345,13 @@ static int tca64_getreg(FAR struct tca64_dev_s *priv, uint8_t regaddr,
 
   DEBUGASSERT(priv != NULL && priv->i2c != NULL && priv->config != NULL);
 
+  /* The TCA6424 only steps through its registers if asked to */
+
+  if (count > 1 && tca64_getpart(priv)->tp_id == TCA6424_PART)
+    {
+      regaddr |= TCA6424_AUTOINC;
+    }
+
   /* Set up for the transfer */
 
   msg[0].frequency = TCA64XX_I2C_MAXFREQUENCY,
@@ -373,15 +395,20 @@ static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
                         FAR uint8_t *regval, unsigned int count)
 {
   struct i2c_msg_s msg[1];
-  uint8_t cmd[2];
+  uint8_t cmd[1 + (TCA64XX_NR_GPIO_MAX >> 3)];
   int ret;
   int i;
 
-  DEBUGASSERT(priv != NULL && priv->i2c != NULL && priv->config != NULL);
+  DEBUGASSERT(priv != NULL && priv->i2c != NULL && priv->config != NULL &&
+              count < sizeof(cmd));
 
   /* Set up for the transfer */
 
   cmd[0] = regaddr;
+  if (count > 1 && tca64_getpart(priv)->tp_id == TCA6424_PART)
+    {
+      cmd[0] |= TCA6424_AUTOINC;
+    }
 
   for (i = 0; i < count; i++)
     {
@@ -409,6 +436,66 @@ static int tca64_putreg(struct tca64_dev_s *priv, uint8_t regaddr,
     }
 }
 
+/****************************************************************************
+ * Name: tca64_modify
+ *
+ * Description:
+ *  Change the bits in mask of the output or configuration registers to
+ *  the corresponding bits of value.  All of the registers of the part are
+ *  written in one transfer.  In shadow mode the registers are not read.
+ *
+ ****************************************************************************/
+
+static int tca64_modify(FAR struct tca64_dev_s *priv, uint8_t regaddr,
+                        ioe_pinset_t mask, ioe_pinset_t value)
+{
+  ioe_pinset_t pinset;
+  uint8_t nregs;
+  int ret;
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  FAR ioe_pinset_t *shadow;
+#endif
+
+  nregs  = (tca64_ngpios(priv) + 7) >> 3;
+  pinset = 0;
+
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  /* Get the shadowed register values */
+
+  DEBUGASSERT(regaddr == tca64_output_reg(priv, 0) ||
+              regaddr == tca64_config_reg(priv, 0));
+
+  shadow = (regaddr == tca64_output_reg(priv, 0)) ?
+           &priv->output : &priv->dirset;
+  pinset = *shadow;
+#else
+  /* Get the register values from the I/O Expander */
+
+  ret = tca64_getreg(priv, regaddr, (FAR uint8_t *)&pinset, nregs);
+  if (ret < 0)
+    {
+      gpioerr("ERROR: Failed to read %u registers at %u: %d\n",
+              nregs, regaddr, ret);
+      return ret;
+    }
+#endif
+
+  pinset = (pinset & ~mask) | (value & mask);
+
+  ret = tca64_putreg(priv, regaddr, (FAR uint8_t *)&pinset, nregs);
+  if (ret < 0)
+    {
+      gpioerr("ERROR: Failed to write %u registers at %u: %d\n",
+              nregs, regaddr, ret);
+      return ret;
+    }
+
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  *shadow = pinset;
+#endif
+  return OK;
+}
+
 /****************************************************************************
  * Name: tca64_direction
  *
@@ -429,8 +516,7 @@ static int tca64_direction(FAR struct ioexpander_dev_s *dev, uint8_t pin,
                           int direction)
 {
   FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
-  uint8_t regaddr;
-  uint8_t regval;
+  ioe_pinset_t bit = ((ioe_pinset_t)1 << pin);
   int ret;
 
   DEBUGASSERT(priv != NULL && priv->config != NULL &&
@@ -446,52 +532,18 @@ static int tca64_direction(FAR struct ioexpander_dev_s *dev, uint8_t pin,
 
   tca64_lock(priv);
 
-  /* Read the Configuration Register associated with this pin.  The
-   * Configuration Register configures the direction of the I/O pins.
+  /* Set the pin direction in the Configuration Register.  If a bit in the
+   * configuration register is set to 1, the corresponding port pin is
+   * enabled as an input with a high-impedance output driver.  If it is
+   * cleared to 0, the corresponding port pin is enabled as an output.
+   *
+   * REVISIT: The value of output has not been selected!  This might
+   * put a glitch on the output.
    */
 
-  regaddr = tca64_config_reg(priv, pin);
-  ret = tca64_getreg(priv, regaddr, &regval, 1);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to read config register at %u: %d\n",
-              regaddr, ret);
-      goto errout_with_lock;
-    }
-
-  /* Set the pin direction in the I/O Expander */
-
-  if (direction == IOEXPANDER_DIRECTION_IN)
-    {
-      /* Configure pin as input. If a bit in the configuration register is
-       * set to 1, the corresponding port pin is enabled as an input with a
-       * high-impedance output driver.
-       */
-
-      regval |= (1 << (pin & 7));
-    }
-  else /* if (direction == IOEXPANDER_DIRECTION_OUT) */
-    {
-      /* Configure pin as output.  If a bit in this register is cleared to
-       * 0, the corresponding port pin is enabled as an output.
-       *
-       * REVISIT: The value of output has not been selected!  This might
-       * put a glitch on the output.
-       */
+  ret = tca64_modify(priv, tca64_config_reg(priv, 0), bit,
+                     (direction == IOEXPANDER_DIRECTION_IN) ? bit : 0);
 
-      regval &= ~(1 << (pin & 7));
-    }
-
-  /* Write back the modified register content */
-
-  ret = tca64_putreg(priv, regaddr, &regval, 1);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to write config register at %u: %d\n",
-              regaddr, ret);
-    }
-
-errout_with_lock:
   tca64_unlock(priv);
   return ret;
 }
@@ -656,8 +708,7 @@ static int tca64_writepin(FAR struct ioexpander_dev_s *dev, uint8_t pin,
                          bool value)
 {
   FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
-  uint8_t regaddr;
-  uint8_t regval;
+  ioe_pinset_t bit = ((ioe_pinset_t)1 << pin);
   int ret;
 
   DEBUGASSERT(priv != NULL && priv->config != NULL &&
@@ -670,41 +721,14 @@ static int tca64_writepin(FAR struct ioexpander_dev_s *dev, uint8_t pin,
 
   tca64_lock(priv);
 
-  /* Read the output register. */
-
-  regaddr = tca64_output_reg(priv, pin);
-  ret = tca64_getreg(priv, regaddr, &regval, 1);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to read output register at %u: %d\n",
-              regaddr, ret);
-      goto errout_with_lock;
-    }
-
   /* Set output pins default value (before configuring it as output) The
    * Output Port Register shows the outgoing logic levels of the pins
    * defined as outputs by the Configuration Register.
    */
 
-  if (value != 0)
-    {
-      regval |= (1 << (pin & 7));
-    }
-  else
-    {
-      regval &= ~(1 << (pin & 7));
-    }
-
-  /* Write the modified output register value */
-
-  ret = tca64_putreg(priv, regaddr, &regval, 1);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to write output register at %u: %d\n",
-              regaddr, ret);
-    }
+  ret = tca64_modify(priv, tca64_output_reg(priv, 0), bit,
+                     value ? bit : 0);
 
-errout_with_lock:
   tca64_unlock(priv);
   return ret;
 }
@@ -800,62 +824,35 @@ static int tca64_multiwritepin(FAR struct ioexpander_dev_s *dev,
                                  int count)
 {
   FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
-  ioe_pinset_t pinset;
-  uint8_t regaddr;
-  uint8_t ngpios;
-  uint8_t nregs;
+  ioe_pinset_t mask;
+  ioe_pinset_t value;
   uint8_t pin;
   int ret;
   int i;
 
-  /* Get exclusive access to the I/O Expander */
-
-  tca64_lock(priv);
+  /* Collect the user defined changes */
 
-  /* Read the output registers for pin 0 through the number of supported
-   * pins.
-   */
-
-  ngpios  = tca64_ngpios(priv);
-  nregs   = (ngpios + 7) >> 3;
-  pinset  = 0;
-  regaddr = tca64_output_reg(priv, 0);
-
-  ret = tca64_getreg(priv, regaddr, (FAR uint8_t *)&pinset, nregs);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to read %u ouput registers at %u: %d\n",
-              nregs, regaddr, ret);
-      goto errout_with_lock;
-    }
-
-  /* Apply the user defined changes */
+  mask  = 0;
+  value = 0;
 
   for (i = 0; i < count; i++)
     {
       pin = pins[i];
       DEBUGASSERT(pin < CONFIG_IOEXPANDER_NPINS);
 
+      mask |= ((ioe_pinset_t)1 << pin);
       if (values[i])
         {
-          pinset |= (1 << pin);
-        }
-      else
-        {
-          pinset &= ~(1 << pin);
+          value |= ((ioe_pinset_t)1 << pin);
         }
     }
 
-  /* Now write back the new pins states */
-
-  ret = tca64_putreg(priv, regaddr, (FAR uint8_t *)&pinset, nregs);
-  if (ret < 0)
-    {
-      gpioerr("ERROR: Failed to write %u output registers at %u: %d\n",
-              nregs, regaddr, ret);
-    }
+  /* Get exclusive access to the I/O Expander and write the new pin
+   * states to all output registers at once.
+   */
 
-errout_with_lock:
+  tca64_lock(priv);
+  ret = tca64_modify(priv, tca64_output_reg(priv, 0), mask, value);
   tca64_unlock(priv);
   return ret;
 }
@@ -943,6 +940,125 @@ errout_with_lock:
 }
 #endif
 
+#ifdef CONFIG_IOEXPANDER_PORT
+/****************************************************************************
+ * Name: tca64_readport
+ *
+ * Description:
+ *   Read the level of all pins with a single I2C transfer.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   pinset - The location to return the pin levels
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int tca64_readport(FAR struct ioexpander_dev_s *dev,
+                          FAR ioe_pinset_t *pinset)
+{
+  FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
+  ioe_pinset_t input;
+  uint8_t regaddr;
+  uint8_t nregs;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL && pinset != NULL);
+
+  /* Get exclusive access to the I/O Expander */
+
+  tca64_lock(priv);
+
+  nregs   = (tca64_ngpios(priv) + 7) >> 3;
+  input   = 0;
+  regaddr = tca64_input_reg(priv, 0);
+
+  ret = tca64_getreg(priv, regaddr, (FAR uint8_t *)&input, nregs);
+  if (ret < 0)
+    {
+      gpioerr("ERROR: Failed to read input %u registers at %u: %d\n",
+              nregs, regaddr, ret);
+      goto errout_with_lock;
+    }
+
+#ifdef CONFIG_TCA64XX_INT_ENABLE
+  /* Update the input status with the bits read from the expander */
+
+  tca64_int_update(priv, input, PINSET_ALL);
+#endif
+
+  *pinset = input;
+
+errout_with_lock:
+  tca64_unlock(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tca64_writeport
+ *
+ * Description:
+ *   Set the level of the output pins in mask.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   mask  - The set of pins to change
+ *   value - The new levels of the pins in mask
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int tca64_writeport(FAR struct ioexpander_dev_s *dev,
+                           ioe_pinset_t mask, ioe_pinset_t value)
+{
+  FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL);
+
+  tca64_lock(priv);
+  ret = tca64_modify(priv, tca64_output_reg(priv, 0), mask, value);
+  tca64_unlock(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tca64_portdirection
+ *
+ * Description:
+ *   Set the direction of the pins in mask.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   mask    - The set of pins to change
+ *   outputs - The pins in mask that become outputs
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code
+ *
+ ****************************************************************************/
+
+static int tca64_portdirection(FAR struct ioexpander_dev_s *dev,
+                               ioe_pinset_t mask, ioe_pinset_t outputs)
+{
+  FAR struct tca64_dev_s *priv = (FAR struct tca64_dev_s *)dev;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL);
+
+  /* A one in the configuration register selects an input */
+
+  tca64_lock(priv);
+  ret = tca64_modify(priv, tca64_config_reg(priv, 0), mask, ~outputs);
+  tca64_unlock(priv);
+  return ret;
+}
+#endif /* CONFIG_IOEXPANDER_PORT */
+
 /****************************************************************************
  * Name: tca64_attach
  *
@@ -1364,6 +1480,9 @@ FAR struct ioexpander_dev_s *tca64_initialize(FAR struct i2c_master_s *i2c,
                                               FAR struct tca64_config_s *config)
 {
   FAR struct tca64_dev_s *priv;
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  uint8_t nregs;
+#endif
   int ret;
 
 #ifdef CONFIG_TCA64XX_MULTIPLE
@@ -1387,6 +1506,28 @@ FAR struct ioexpander_dev_s *tca64_initialize(FAR struct i2c_master_s *i2c,
   priv->i2c     = i2c;
   priv->config  = config;
 
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  /* Load the shadow registers.  The power-on values (all outputs high, all
+   * pins inputs) are used if the device cannot be read.
+   */
+
+  nregs        = (tca64_ngpios(priv) + 7) >> 3;
+  priv->output = 0;
+  priv->dirset = 0;
+
+  if (tca64_getreg(priv, tca64_output_reg(priv, 0),
+                   (FAR uint8_t *)&priv->output, nregs) < 0)
+    {
+      priv->output = PINSET_ALL;
+    }
+
+  if (tca64_getreg(priv, tca64_config_reg(priv, 0),
+                   (FAR uint8_t *)&priv->dirset, nregs) < 0)
+    {
+      priv->dirset = PINSET_ALL;
+    }
+#endif
+
 #ifdef CONFIG_TCA64XX_INT_ENABLE
   /* Initial interrupt state:  Edge triggered on both edges */
 
@@ -146,6 +146,7 @@
 #define TCA6424_CONFIG2_REG             0x0E
 
 #define TCA6424_NR_GPIOS                24
+#define TCA6424_AUTOINC                 0x80   /* Command bit: Auto-increment */
 
 #define TCA64XX_NR_GPIO_MAX             TCA6424_NR_GPIOS
 
@@ -223,6 +224,11 @@ struct tca64_dev_s
   uint8_t part;                      /* TCA64xx part ID (see enum tca64xx_part_e) */
   sem_t exclsem;                     /* Mutual exclusion */
 
+#ifdef CONFIG_TCA64XX_SHADOW_MODE
+  ioe_pinset_t output;               /* Shadow of the output registers */
+  ioe_pinset_t dirset;               /* Shadow of the config registers */
+#endif
+
 #ifdef CONFIG_IOEXPANDER_INT_ENABLE
 #ifdef CONFIG_TCA64XX_INT_POLL
   WDOG_ID wdog;                      /* Timer used to poll for missed interrupts */
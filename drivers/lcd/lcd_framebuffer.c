@@ -47,6 +47,9 @@
 
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/lcd/lcd.h>
@@ -62,6 +65,21 @@
 
 #define VIDEO_PLANE 0
 
+/* Damage tracking */
+
+#if defined(CONFIG_LCD_FRAMEBUFFER_NDAMAGE) && \
+    CONFIG_LCD_FRAMEBUFFER_NDAMAGE > 0
+#  define LCDFB_DAMAGE 1
+#  define LCDFB_NDAMAGE CONFIG_LCD_FRAMEBUFFER_NDAMAGE
+#  define LCDFB_DELAY   MSEC2TICK(CONFIG_LCD_FRAMEBUFFER_FRAMEMS)
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFB_WORK  LPWORK
+#  else
+#    define LCDFB_WORK  HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -80,6 +98,16 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef LCDFB_DAMAGE
+  /* Updates not yet written to the LCD */
+
+  uint8_t ndamage;                  /* Number of damage rectangles */
+  sem_t exclsem;                    /* Protects the damage set */
+  sem_t flushsem;                   /* Serializes writes to the LCD */
+  struct work_s work;               /* Deferred write to the LCD */
+  struct nxgl_rect_s damage[LCDFB_NDAMAGE];
+#endif
 };
 
 /****************************************************************************
@@ -91,6 +119,13 @@ struct lcdfb_dev_s
 static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
              FAR const struct nxgl_rect_s *rect);
 
+#ifdef LCDFB_DAMAGE
+static void lcdfb_damage(FAR struct lcdfb_dev_s *priv,
+             FAR const struct nxgl_rect_s *rect);
+static int lcdfb_flush(FAR struct lcdfb_dev_s *priv);
+static void lcdfb_worker(FAR void *arg);
+#endif
+
 /* Get information about the video controller configuration and the
  * configuration of each color plane.
  */
@@ -122,6 +157,14 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
              FAR struct fb_setcursor_s *settings);
 #endif
 
+/* The following is provided only if the video hardware signals vertical
+ * sync.  The LCD has no such signal; this is used to flush damage.
+ */
+
+#ifdef CONFIG_FB_SYNC
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -248,6 +291,208 @@ static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
   return OK;
 }
 
+#ifdef LCDFB_DAMAGE
+/****************************************************************************
+ * Name: lcdfb_area
+ *
+ * Description:
+ *   Return the number of pixels in a (non-null) rectangle.
+ *
+ ****************************************************************************/
+
+static uint32_t lcdfb_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: lcdfb_bound
+ *
+ * Description:
+ *   Return the bounding rectangle of two rectangles.
+ *
+ ****************************************************************************/
+
+static void lcdfb_bound(FAR struct nxgl_rect_s *dest,
+                        FAR const struct nxgl_rect_s *src1,
+                        FAR const struct nxgl_rect_s *src2)
+{
+  dest->pt1.x = src1->pt1.x < src2->pt1.x ? src1->pt1.x : src2->pt1.x;
+  dest->pt1.y = src1->pt1.y < src2->pt1.y ? src1->pt1.y : src2->pt1.y;
+  dest->pt2.x = src1->pt2.x > src2->pt2.x ? src1->pt2.x : src2->pt2.x;
+  dest->pt2.y = src1->pt2.y > src2->pt2.y ? src1->pt2.y : src2->pt2.y;
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage
+ *
+ * Description:
+ *   Add a (clipped, non-null) rectangle to the damage set.  The caller
+ *   holds exclsem.
+ *
+ *   The new rectangle is merged with each rectangle in the set whose
+ *   bounding rectangle with it is no larger than the two areas together,
+ *   i.e., with those that it overlaps or adjoins.  A merged rectangle may
+ *   then touch rectangles that were already checked, so the search is
+ *   restarted after each merge.  If the set is still full, the rectangle
+ *   is merged with the one whose bounding rectangle grows the least.
+ *
+ ****************************************************************************/
+
+static void lcdfb_damage(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s newrect;
+  struct nxgl_rect_s bound;
+  uint32_t bestcost;
+  uint32_t cost;
+  int best;
+  int i;
+
+  newrect = *rect;
+
+  for (i = 0; i < priv->ndamage; )
+    {
+      lcdfb_bound(&bound, &priv->damage[i], &newrect);
+      if (lcdfb_area(&bound) <=
+          lcdfb_area(&priv->damage[i]) + lcdfb_area(&newrect))
+        {
+          newrect         = bound;
+          priv->damage[i] = priv->damage[--priv->ndamage];
+          i               = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (priv->ndamage < LCDFB_NDAMAGE)
+    {
+      priv->damage[priv->ndamage++] = newrect;
+      return;
+    }
+
+  best     = 0;
+  bestcost = UINT32_MAX;
+
+  for (i = 0; i < priv->ndamage; i++)
+    {
+      lcdfb_bound(&bound, &priv->damage[i], &newrect);
+      cost = lcdfb_area(&bound) - lcdfb_area(&priv->damage[i]);
+      if (cost < bestcost)
+        {
+          best     = i;
+          bestcost = cost;
+        }
+    }
+
+  lcdfb_bound(&priv->damage[best], &priv->damage[best], &newrect);
+}
+
+/****************************************************************************
+ * Name: lcdfb_flush
+ *
+ * Description:
+ *   Write all accumulated damage to the LCD.
+ *
+ ****************************************************************************/
+
+static int lcdfb_flush(FAR struct lcdfb_dev_s *priv)
+{
+  struct nxgl_rect_s damage[LCDFB_NDAMAGE];
+  int ndamage;
+  int result = OK;
+  int ret;
+  int i;
+
+  /* Only one flush may write to the LCD at a time */
+
+  (void)nxsem_wait_uninterruptible(&priv->flushsem);
+
+  /* Take the damage set so that new updates can accumulate while the LCD
+   * is being written.
+   */
+
+  (void)nxsem_wait_uninterruptible(&priv->exclsem);
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct nxgl_rect_s));
+  priv->ndamage = 0;
+  (void)work_cancel(LCDFB_WORK, &priv->work);
+  nxsem_post(&priv->exclsem);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      ret = lcdfb_update(priv, &damage[i]);
+      if (ret < 0)
+        {
+          lcderr("ERROR: FB update failed: %d\n", ret);
+          if (result == OK)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  nxsem_post(&priv->flushsem);
+  return result;
+}
+
+/****************************************************************************
+ * Name: lcdfb_worker
+ *
+ * Description:
+ *   Work queue callback that writes the accumulated damage to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_worker(FAR void *arg)
+{
+  (void)lcdfb_flush((FAR struct lcdfb_dev_s *)arg);
+}
+
+/****************************************************************************
+ * Name: lcdfb_notify
+ *
+ * Description:
+ *   Record an update of the framebuffer and schedule the write to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_notify(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s clipped;
+
+  /* Clip to fit in the framebuffer */
+
+  clipped.pt1.x = rect->pt1.x < 0 ? 0 : rect->pt1.x;
+  clipped.pt1.y = rect->pt1.y < 0 ? 0 : rect->pt1.y;
+  clipped.pt2.x = rect->pt2.x >= priv->xres ? priv->xres - 1 : rect->pt2.x;
+  clipped.pt2.y = rect->pt2.y >= priv->yres ? priv->yres - 1 : rect->pt2.y;
+
+  if (clipped.pt1.x > clipped.pt2.x || clipped.pt1.y > clipped.pt2.y)
+    {
+      return;
+    }
+
+  (void)nxsem_wait_uninterruptible(&priv->exclsem);
+
+  lcdfb_damage(priv, &clipped);
+
+  /* The first update of a frame starts the frame timer */
+
+  if (work_available(&priv->work))
+    {
+      (void)work_queue(LCDFB_WORK, &priv->work, lcdfb_worker, priv,
+                       LCDFB_DELAY);
+    }
+
+  nxsem_post(&priv->exclsem);
+}
+#endif /* LCDFB_DAMAGE */
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -448,6 +693,27 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
 }
 #endif
 
+/****************************************************************************
+ * Name: lcdfb_waitforvsync
+ *
+ * Description:
+ *   The LCD provides no vertical sync.  Instead, write any accumulated
+ *   damage to the LCD now so that an application that draws a frame and
+ *   then waits for "vsync" sees the frame on the display.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable)
+{
+#ifdef LCDFB_DAMAGE
+  return lcdfb_flush((FAR struct lcdfb_dev_s *)vtable);
+#else
+  return OK;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -502,6 +768,14 @@ int up_fbinitialize(int display)
   priv->vtable.getcursor    = lcdfb_getcursor,
   priv->vtable.setcursor    = lcdfb_setcursor,
 #endif
+#ifdef CONFIG_FB_SYNC
+  priv->vtable.waitforvsync = lcdfb_waitforvsync,
+#endif
+
+#ifdef LCDFB_DAMAGE
+  nxsem_init(&priv->exclsem, 0, 1);
+  nxsem_init(&priv->flushsem, 0, 1);
+#endif
 
 #ifdef  CONFIG_LCD_EXTERNINIT
   /* Use external graphics driver initialization */
@@ -597,6 +871,10 @@ errout_with_lcd:
   board_lcd_uninitialize();
 
 errout_with_state:
+#endif
+#ifdef LCDFB_DAMAGE
+  nxsem_destroy(&priv->exclsem);
+  nxsem_destroy(&priv->flushsem);
 #endif
   kmm_free(priv);
   return ret;
@@ -686,6 +964,14 @@ void up_fbuninitialize(int display)
           board_lcd_uninitialize();
 #endif
 
+#ifdef LCDFB_DAMAGE
+          /* Discard any pending update */
+
+          (void)work_cancel(LCDFB_WORK, &priv->work);
+          nxsem_destroy(&priv->exclsem);
+          nxsem_destroy(&priv->flushsem);
+#endif
+
           /* Free the frame buffer allocation */
 
           kmm_free(priv->fbmem);
@@ -729,7 +1015,6 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
 {
   FAR struct fb_planeinfo_s *fpinfo = (FAR struct fb_planeinfo_s *)pinfo;
   FAR struct lcdfb_dev_s *priv;
-  int ret;
 
   DEBUGASSERT(fpinfo != NULL && rect != NULL);
 
@@ -742,11 +1027,17 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
   priv = lcdfb_find(fpinfo->display);
   if (priv != NULL)
     {
-      ret = lcdfb_update(priv, rect);
+#ifdef LCDFB_DAMAGE
+      /* Accumulate the update; it will be written to the LCD later */
+
+      lcdfb_notify(priv, rect);
+#else
+      int ret = lcdfb_update(priv, rect);
       if (ret < 0)
         {
           lcderr("FB update failed: %d\n", ret);
         }
+#endif
     }
 }
 #endif
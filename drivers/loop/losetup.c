@@ -68,6 +68,14 @@
 #define loop_semgive(d) nxsem_post(&(d)->sem)  /* To match loop_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
+/* Additional open flags for the backing file */
+
+#ifdef CONFIG_DEV_LOOP_DIRECTIO
+#  define LOOP_OFLAGS   O_DIRECT
+#else
+#  define LOOP_OFLAGS   0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -233,8 +241,10 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbytesread;
+  size_t remaining;
   off_t offset;
-  off_t ret;
+  off_t pos;
+  int ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
@@ -245,33 +255,63 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
-  /* Calculate the offset to read the sectors and seek to the position */
+  /* The seek and the read must not be separated by another transfer */
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
+  ret = loop_semtake(dev);
   if (ret < 0)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
-      return -EIO;
+      return ret;
     }
 
-  /* Then read the requested number of sectors from that position */
+  /* Calculate the offset to read the sectors and seek to the position */
 
-  do
+  offset = (off_t)start_sector * dev->sectsize + dev->offset;
+  pos = file_seek(&dev->devfile, offset, SEEK_SET);
+  if (pos < 0)
     {
-      nbytesread = file_read(&dev->devfile, buffer,
-                             nsectors * dev->sectsize);
-      if (nbytesread < 0 && nbytesread != -EINTR)
+      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)pos);
+      ret = -EIO;
+      goto errout_with_sem;
+    }
+
+  /* Then read all of the requested sectors from that position with as few
+   * reads as possible.  The backing file system may return less data than
+   * requested, for example at the end of a run of contiguous clusters.
+   */
+
+  remaining = (size_t)nsectors * dev->sectsize;
+  while (remaining > 0)
+    {
+      nbytesread = file_read(&dev->devfile, buffer, remaining);
+      if (nbytesread < 0)
+        {
+          if (nbytesread == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Read failed: %d\n", (int)nbytesread);
+          ret = (int)nbytesread;
+          goto errout_with_sem;
+        }
+      else if (nbytesread == 0)
         {
-          ferr("ERROR: Read failed: %d\n", nbytesread);
-          return (int)nbytesread;
+          break;
         }
+
+      buffer    += nbytesread;
+      remaining -= nbytesread;
     }
-  while (nbytesread < 0);
+
+  loop_semgive(dev);
 
   /* Return the number of sectors read */
 
-  return nbytesread / dev->sectsize;
+  return nsectors - (remaining + dev->sectsize - 1) / dev->sectsize;
+
+errout_with_sem:
+  loop_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -288,38 +328,74 @@ static ssize_t loop_write(FAR struct inode *inode,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbyteswritten;
+  size_t remaining;
   off_t offset;
-  off_t ret;
+  off_t pos;
+  int ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
-  /* Calculate the offset to write the sectors and seek to the position */
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      ferr("ERROR: Write past end of file\n");
+      return -EIO;
+    }
+
+  /* The seek and the write must not be separated by another transfer */
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
+  ret = loop_semtake(dev);
   if (ret < 0)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
+      return ret;
+    }
+
+  /* Calculate the offset to write the sectors and seek to the position */
+
+  offset = (off_t)start_sector * dev->sectsize + dev->offset;
+  pos = file_seek(&dev->devfile, offset, SEEK_SET);
+  if (pos < 0)
+    {
+      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)pos);
+      ret = -EIO;
+      goto errout_with_sem;
     }
 
-  /* Then write the requested number of sectors to that position */
+  /* Then write all of the requested sectors to that position */
 
-  do
+  remaining = (size_t)nsectors * dev->sectsize;
+  while (remaining > 0)
     {
-      nbyteswritten = file_write(&dev->devfile, buffer,
-                                 nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && nbyteswritten != -EINTR)
+      nbyteswritten = file_write(&dev->devfile, buffer, remaining);
+      if (nbyteswritten < 0)
+        {
+          if (nbyteswritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: file_write failed: %d\n", (int)nbyteswritten);
+          ret = (int)nbyteswritten;
+          goto errout_with_sem;
+        }
+      else if (nbyteswritten == 0)
         {
-          ferr("ERROR: nx_write failed: %d\n", nbyteswritten);
-          return nbyteswritten;
+          break;
         }
+
+      buffer    += nbyteswritten;
+      remaining -= nbyteswritten;
     }
-  while (nbyteswritten < 0);
+
+  loop_semgive(dev);
 
   /* Return the number of sectors written */
 
-  return nbyteswritten / dev->sectsize;
+  return nsectors - (remaining + dev->sectsize - 1) / dev->sectsize;
+
+errout_with_sem:
+  loop_semgive(dev);
+  return ret;
 }
 #endif
 
@@ -426,7 +502,7 @@ int losetup(FAR const char *devname, FAR const char *filename,
   ret = -ENOSYS;
   if (!readonly)
     {
-      ret = file_open(&dev->devfile, filename, O_RDWR);
+      ret = file_open(&dev->devfile, filename, O_RDWR | LOOP_OFLAGS);
     }
 
   if (ret >= 0)
@@ -438,7 +514,7 @@ int losetup(FAR const char *devname, FAR const char *filename,
     {
       /* If that fails, then try to open the device read-only */
 
-      ret = file_open(&dev->devfile, filename, O_RDONLY);
+      ret = file_open(&dev->devfile, filename, O_RDONLY | LOOP_OFLAGS);
       if (ret < 0)
         {
           ferr("ERROR: Failed to open %s: %d\n", filename, ret);
@@ -101,6 +101,36 @@
 
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
+/* Write-behind support.  Each of the two write-behind buffers holds
+ * CONFIG_MMCSD_WRITEBEHIND blocks of 512 bytes.
+ */
+
+#ifndef CONFIG_MMCSD_WRITEBEHIND
+#  define CONFIG_MMCSD_WRITEBEHIND 0
+#endif
+
+/* Write and read-ahead buffer sizes (in blocks) */
+
+#ifndef CONFIG_MMCSD_NWRBLOCKS
+#  define CONFIG_MMCSD_NWRBLOCKS 16
+#endif
+
+#ifndef CONFIG_MMCSD_WRDIRTY
+#  define CONFIG_MMCSD_WRDIRTY 0
+#endif
+
+#ifndef CONFIG_MMCSD_NRDBLOCKS
+#  define CONFIG_MMCSD_NRDBLOCKS 8
+#endif
+
+#if !defined(CONFIG_SDIO_DMA) || !defined(CONFIG_FS_WRITABLE) || \
+     defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
+#  undef  CONFIG_MMCSD_WRITEBEHIND
+#  define CONFIG_MMCSD_WRITEBEHIND 0
+#endif
+
+#define MMCSD_WBSIZE            (CONFIG_MMCSD_WRITEBEHIND * 512)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -125,6 +155,10 @@ struct mmcsd_state_s
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  uint8_t wbpending:1;             /* true: Write-behind transfer in progress */
+  uint8_t wbindex:1;               /* The write-behind buffer to fill next */
+#endif
 
   uint8_t mode:2;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
@@ -150,6 +184,13 @@ struct mmcsd_state_s
 #if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
   struct rwbuffer_s rwbuffer;
 #endif
+
+  /* Write-behind (double-buffered DMA) support */
+
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  size_t   wbnblocks;              /* Blocks in the pending write-behind transfer */
+  FAR uint8_t *wbbuffer[2];        /* The two write-behind buffers */
+#endif
 };
 
 /****************************************************************************
@@ -198,6 +239,9 @@ static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
 #endif
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+static int     mmcsd_wbfinish(FAR struct mmcsd_state_s *priv);
+#endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
@@ -206,7 +250,7 @@ static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
                  FAR uint8_t *buffer, off_t startblock, size_t nblocks);
 #endif
-#ifdef CONFIG_DRVR_READAHEAD
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
 static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 #endif
@@ -217,7 +261,7 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
                  FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
 #endif
-#ifdef CONFIG_DRVR_WRITEBUFFER
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
 static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 #endif
@@ -1145,11 +1189,21 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
       return -ENODEV;
     }
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  /* Complete any write-behind transfer that is still in progress */
+
+  ret = mmcsd_wbfinish(priv);
+  if (ret != OK)
+    {
+      return ret;
+    }
+#endif
+
   /* If the last data transfer was not a write, then we do not have to check
    * the card status.
    */
 
-  else if (!priv->wrbusy)
+  if (!priv->wrbusy)
     {
       return OK;
     }
@@ -1253,6 +1307,57 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_wbfinish
+ *
+ * Description:
+ *   Wait for the DMA of a pending write-behind transfer to complete and
+ *   then send STOP_TRANSMISSION.  Errors from that transfer are reported
+ *   here, i.e., to the next operation on the card.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+static int mmcsd_wbfinish(FAR struct mmcsd_state_s *priv)
+{
+  int evret;
+  int ret;
+
+  if (!priv->wbpending)
+    {
+      return OK;
+    }
+
+  priv->wbpending = false;
+
+  /* Wait for the transfer to complete */
+
+  evret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
+                          priv->wbnblocks * MMCSD_BLOCK_WDATADELAY);
+  if (evret != OK)
+    {
+      ferr("ERROR: CMD25 write-behind transfer failed: %d\n", evret);
+    }
+
+  /* Send STOP_TRANSMISSION, even on failure, to put the card back into
+   * the Transfer State.
+   */
+
+  ret = mmcsd_stoptransmission(priv);
+  if (evret != OK)
+    {
+      return evret;
+    }
+
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1574,11 +1679,11 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
  *
  * Description:
  *   Reload the specified number of sectors from the physical device into the
- *   read-ahead buffer.
+ *   read-ahead buffer (or directly into the caller's buffer).
  *
  ****************************************************************************/
 
-#ifdef CONFIG_DRVR_READAHEAD
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
 static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
                             off_t startblock, size_t nblocks)
 {
@@ -1591,6 +1696,17 @@ static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
 
   DEBUGASSERT(priv != NULL && buffer != NULL && nblocks > 0);
 
+  /* This is called by the rwbuffer logic, possibly on the worker thread,
+   * so get exclusive access to the driver here.
+   */
+
+  mmcsd_takesem(priv);
+  if (IS_EMPTY(priv))
+    {
+      mmcsd_givesem(priv);
+      return -ENODEV;
+    }
+
 #ifdef CONFIG_MMCSD_MULTIBLOCK_DISABLE
   /* Read each block using only the single block transfer method */
 
@@ -1627,6 +1743,8 @@ static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
 
 #endif
 
+  mmcsd_givesem(priv);
+
   /* On success, return the number of blocks read */
 
   return ret;
@@ -1816,6 +1934,9 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   size_t nbytes;
   int ret;
   int evret = OK;
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  bool writebehind = false;
+#endif
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
   DEBUGASSERT(priv != NULL && buffer != NULL && nblocks > 1);
@@ -1830,6 +1951,24 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return -EPERM;
     }
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  /* If the transfer fits in a write-behind buffer, copy the data there so
+   * that we can return without waiting for the DMA to complete.  The copy
+   * goes to the buffer that is not used by any transfer still in flight,
+   * so it overlaps with that transfer.
+   */
+
+  if (priv->wbbuffer[0] != NULL &&
+      (priv->caps & SDIO_CAPS_DMASUPPORTED) != 0 &&
+      (nblocks << priv->blockshift) <= MMCSD_WBSIZE)
+    {
+      memcpy(priv->wbbuffer[priv->wbindex], buffer,
+             nblocks << priv->blockshift);
+      buffer      = priv->wbbuffer[priv->wbindex];
+      writebehind = true;
+    }
+#endif
+
 #if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
   /* If we think we are going to perform a DMA transfer, make sure that we
    * will be able to before we commit the card to the operation.
@@ -1980,6 +2119,21 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
         }
     }
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  if (writebehind)
+    {
+      /* Don't wait for the transfer to complete.  That, and the
+       * STOP_TRANSMISSION, are done by mmcsd_wbfinish() at the beginning
+       * of the next transfer.
+       */
+
+      priv->wbpending = true;
+      priv->wbnblocks = nblocks;
+      priv->wbindex  ^= 1;
+      return nblocks;
+    }
+#endif
+
   /* Wait for the transfer to complete */
 
   evret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
@@ -2023,7 +2177,8 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
  *
  ****************************************************************************/
 
-#if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_DRVR_WRITEBUFFER)
+#if defined(CONFIG_FS_WRITABLE) && \
+    (defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD))
 static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
                            off_t startblock, size_t nblocks)
 {
@@ -2036,6 +2191,17 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
 
   DEBUGASSERT(priv != NULL && buffer != NULL && nblocks > 0);
 
+  /* This is called by the rwbuffer logic, possibly on the worker thread,
+   * so get exclusive access to the driver here.
+   */
+
+  mmcsd_takesem(priv);
+  if (IS_EMPTY(priv))
+    {
+      mmcsd_givesem(priv);
+      return -ENODEV;
+    }
+
 #ifdef CONFIG_MMCSD_MULTIBLOCK_DISABLE
   /* Write each block using only the single block transfer method */
 
@@ -2070,6 +2236,8 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
 
 #endif
 
+  mmcsd_givesem(priv);
+
   /* On success, return the number of blocks written */
 
   return ret;
@@ -2153,14 +2321,17 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
 
   if (nsectors > 0)
     {
-      mmcsd_takesem(priv);
-
-#if defined(CONFIG_DRVR_READAHEAD)
-      /* Get the data from the read-ahead buffer */
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+      /* Get the data from the write or read-ahead buffer.  The rwbuffer
+       * logic has its own locking and the mmcsd_reload() callout takes the
+       * driver semaphore.
+       */
 
       ret = rwb_read(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+      mmcsd_takesem(priv);
 
-#elif defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
+#if defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
       /* Read each block using only the single block transfer method */
 
       endsector = startsector + nsectors - 1;
@@ -2194,6 +2365,7 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
 
 #endif
       mmcsd_givesem(priv);
+#endif /* CONFIG_DRVR_WRITEBUFFER || CONFIG_DRVR_READAHEAD */
     }
 
   /* On success, return the number of blocks read */
@@ -2227,14 +2399,16 @@ static ssize_t mmcsd_write(FAR struct inode *inode, FAR const unsigned char *buf
   finfo("sector: %lu nsectors: %u sectorsize: %u\n",
         (unsigned long)startsector, nsectors, priv->blocksize);
 
-  mmcsd_takesem(priv);
-
-#if defined(CONFIG_DRVR_WRITEBUFFER)
-  /* Write the data to the write buffer */
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+  /* Write the data to the write buffer (and invalidate any read-ahead
+   * copy).  The mmcsd_flush() callout takes the driver semaphore.
+   */
 
   ret = rwb_write(&priv->rwbuffer, startsector, nsectors, buffer);
+#else
+  mmcsd_takesem(priv);
 
-#elif defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
+#if defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
   /* Write each block using only the single block transfer method */
 
   endsector = startsector + nsectors - 1;
@@ -2268,6 +2442,7 @@ static ssize_t mmcsd_write(FAR struct inode *inode, FAR const unsigned char *buf
 
 #endif
   mmcsd_givesem(priv);
+#endif /* CONFIG_DRVR_WRITEBUFFER || CONFIG_DRVR_READAHEAD */
 
   /* On success, return the number of blocks written */
 
@@ -2350,6 +2525,22 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   DEBUGASSERT(inode && inode->i_private);
   priv  = (FAR struct mmcsd_state_s *)inode->i_private;
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  /* Flush the write buffer first.  This must be done without holding the
+   * driver semaphore since the mmcsd_flush() callout takes it.
+   */
+
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = rwb_flush(&priv->rwbuffer);
+      if (ret < 0)
+        {
+          ferr("ERROR: rwb_flush failed: %d\n", ret);
+          return ret;
+        }
+    }
+#endif
+
   /* Process the IOCTL by command */
 
   mmcsd_takesem(priv);
@@ -2387,6 +2578,24 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       }
       break;
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+    case BIOC_FLUSH: /* Complete any write-behind transfer */
+      {
+        finfo("BIOC_FLUSH\n");
+
+        ret = mmcsd_wbfinish(priv);
+        if (ret != OK)
+          {
+            ferr("ERROR: mmcsd_wbfinish failed: %d\n", ret);
+          }
+      }
+      break;
+#elif defined(CONFIG_DRVR_WRITEBUFFER)
+    case BIOC_FLUSH: /* The write buffer was flushed above */
+      ret = OK;
+      break;
+#endif
+
     default:
       ret = -ENOTTY;
       break;
@@ -3131,6 +3340,10 @@ static int mmcsd_probe(FAR struct mmcsd_state_s *priv)
               finfo("Capacity: %lu Kbytes\n", (unsigned long)(priv->capacity / 1024));
               priv->mediachanged = true;
 
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+              priv->rwbuffer.nblocks = priv->nblocks;
+#endif
+
 #ifdef CONFIG_MMCSD_HAVE_CARDDETECT
               /* Set up to receive asynchronous, media removal events */
 
@@ -3175,12 +3388,25 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
 {
   finfo("type: %d present: %d\n", priv->type, SDIO_PRESENT(priv->dev));
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  /* Abandon any write-behind transfer that is still in progress */
+
+  if (priv->wbpending)
+    {
+      SDIO_CANCEL(priv->dev);
+      priv->wbpending = false;
+    }
+#endif
+
   /* Forget the card geometry, pretend the slot is empty (it might not
    * be), and that the card has never been initialized.
    */
 
   priv->capacity     = 0; /* Capacity=0 sometimes means no media */
   priv->blocksize    = 0;
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+  priv->rwbuffer.nblocks = 0;
+#endif
   priv->mediachanged = false;
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->probed       = false;
@@ -3302,6 +3528,12 @@ static void mmcsd_hwuninitialize(FAR struct mmcsd_state_s *priv)
     {
       mmcsd_removed(priv);
       SDIO_RESET(priv->dev);
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+      if (priv->wbbuffer[0] != NULL)
+        {
+          kmm_free(priv->wbbuffer[0]);
+        }
+#endif
       kmm_free(priv);
     }
 }
@@ -3355,6 +3587,18 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
 
       priv->dev = dev;
 
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+      /* Allocate the write-behind buffers.  If that fails, all writes are
+       * just performed synchronously.
+       */
+
+      priv->wbbuffer[0] = (FAR uint8_t *)kmm_malloc(2 * MMCSD_WBSIZE);
+      if (priv->wbbuffer[0] != NULL)
+        {
+          priv->wbbuffer[1] = priv->wbbuffer[0] + MMCSD_WBSIZE;
+        }
+#endif
+
       /* Initialize the hardware associated with the slot */
 
       ret = mmcsd_hwinitialize(priv);
@@ -3388,9 +3632,26 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
         }
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
-      /* Initialize buffering */
+      /* Initialize buffering.  The block size is always 512 bytes (see
+       * mmcsd_decodeCSD()); the number of blocks is updated whenever a
+       * card is probed or removed.
+       */
+
+      priv->rwbuffer.blocksize    = 512;
+      priv->rwbuffer.nblocks      = priv->nblocks;
+      priv->rwbuffer.dev          = priv;
+      priv->rwbuffer.rhreload     = mmcsd_reload;
+#ifdef CONFIG_FS_WRITABLE
+      priv->rwbuffer.wrflush      = mmcsd_flush;
+#ifdef CONFIG_DRVR_WRITEBUFFER
+      priv->rwbuffer.wrmaxblocks  = CONFIG_MMCSD_NWRBLOCKS;
+      priv->rwbuffer.wrdirtylimit = CONFIG_MMCSD_WRDIRTY;
+#endif
+#endif
+#ifdef CONFIG_DRVR_READAHEAD
+      priv->rwbuffer.rhmaxblocks  = CONFIG_MMCSD_NRDBLOCKS;
+#endif
 
-#warning "Missing setup of rwbuffer"
       ret = rwb_initialize(&priv->rwbuffer);
       if (ret < 0)
         {
@@ -3423,6 +3684,12 @@ errout_with_hwinit:
   return ret;
 
 errout_with_alloc:
+#if CONFIG_MMCSD_WRITEBEHIND > 0
+  if (priv->wbbuffer[0] != NULL)
+    {
+      kmm_free(priv->wbbuffer[0]);
+    }
+#endif
   kmm_free(priv);
   return ret;
 }
@@ -262,7 +262,7 @@ static int ubxmdm_poll(FAR struct file* filep,
       fds->revents |= (fds->events & (POLLIN | POLLOUT));
       if (fds->revents != 0)
         {
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
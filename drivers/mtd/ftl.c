@@ -52,6 +52,9 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -67,6 +70,42 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+/* Erase block cache.  With CONFIG_FTL_EBCACHE == 0, there is a single erase
+ * block buffer and each modified erase block is written back to FLASH
+ * immediately.  Otherwise, there are CONFIG_FTL_EBCACHE buffers and
+ * modified erase blocks are written back only when they are replaced, when
+ * the device is flushed or closed, or after CONFIG_FTL_EBCACHE_DELAY
+ * milliseconds without write activity.
+ */
+
+#ifndef CONFIG_FS_WRITABLE
+#  undef CONFIG_FTL_EBCACHE
+#  undef CONFIG_FTL_STATISTICS
+#endif
+
+#ifndef CONFIG_FTL_EBCACHE
+#  define CONFIG_FTL_EBCACHE 0
+#endif
+
+#if CONFIG_FTL_EBCACHE > 0
+#  define FTL_NEBLOCKS  CONFIG_FTL_EBCACHE
+#  define FTL_WRITEBACK 1
+#else
+#  define FTL_NEBLOCKS  1
+#  undef CONFIG_FTL_EBCACHE_DELAY
+#endif
+
+#if !defined(CONFIG_FTL_EBCACHE_DELAY) || !defined(CONFIG_SCHED_WORKQUEUE)
+#  undef CONFIG_FTL_EBCACHE_DELAY
+#  define CONFIG_FTL_EBCACHE_DELAY 0
+#endif
+
+#ifdef CONFIG_FTL_STATISTICS
+#  define ftl_count(d,f,n) do { (d)->stats.f += (n); } while (0)
+#else
+#  define ftl_count(d,f,n)
+#endif
+
 /* The maximum length of the device name paths is the maximum length of a
  * name plus 5 for the the length of "/dev/" and a NUL terminator.
  */
@@ -77,6 +116,19 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_WRITABLE
+/* One, in-memory erase block */
+
+struct ftl_eblock_s
+{
+  FAR uint8_t          *buffer;  /* Erase block data (allocated when used) */
+  off_t                 ebno;    /* Erase block held in the buffer */
+  uint32_t              lru;     /* Time of last use (for replacement) */
+  bool                  valid;   /* The buffer holds erase block 'ebno' */
+  bool                  dirty;   /* The buffer differs from FLASH */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -88,7 +140,15 @@ struct ftl_struct_s
   uint16_t              refs;    /* Number of references */
   bool                  unlinked;/* The driver has been unlinked */
 #ifdef CONFIG_FS_WRITABLE
-  FAR uint8_t          *eblock;  /* One, in-memory erase block */
+  sem_t                 exclsem; /* Protects the erase block cache */
+  uint32_t              lru;     /* Erase block use counter */
+  struct ftl_eblock_s   eblock[FTL_NEBLOCKS]; /* Erase block cache */
+#if CONFIG_FTL_EBCACHE_DELAY > 0
+  struct work_s         work;    /* Delayed write back of the cache */
+#endif
+#ifdef CONFIG_FTL_STATISTICS
+  struct ftl_stats_s    stats;   /* Write amplification statistics */
+#endif
 #endif
 };
 
@@ -139,6 +199,299 @@ static const struct block_operations g_bops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ftl_semtake
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static void ftl_semtake(FAR struct ftl_struct_s *dev)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&dev->exclsem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#  define ftl_semgive(d) nxsem_post(&(d)->exclsem)
+#else
+#  define ftl_semtake(d)
+#  define ftl_semgive(d)
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebfind
+ *
+ * Description: Return the cached copy of an erase block (or NULL)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static FAR struct ftl_eblock_s *ftl_ebfind(FAR struct ftl_struct_s *dev,
+                                           off_t ebno)
+{
+  FAR struct ftl_eblock_s *eb;
+  int i;
+
+  for (i = 0; i < FTL_NEBLOCKS; i++)
+    {
+      eb = &dev->eblock[i];
+      if (eb->valid && eb->ebno == ebno)
+        {
+          eb->lru = ++dev->lru;
+          return eb;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebprogram
+ *
+ * Description: Erase one erase block and write a full erase block of data
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_ebprogram(FAR struct ftl_struct_s *dev, off_t ebno,
+                         FAR const uint8_t *buffer)
+{
+  off_t  rwblock = ebno * dev->blkper;
+  size_t nxfrd;
+  int    ret;
+
+  /* Erase the erase block */
+
+  ret = MTD_ERASE(dev->mtd, ebno, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", ebno, ret);
+      return ret;
+    }
+
+  ftl_count(dev, fs_erases, 1);
+
+  /* Write a full erase back to flash */
+
+  finfo("Write %d bytes into erase block=%d\n", dev->geo.erasesize, ebno);
+
+  nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, buffer);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  ftl_count(dev, fs_progblocks, dev->blkper);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebwriteback
+ *
+ * Description: Write a cached erase block back to FLASH if it is dirty
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_ebwriteback(FAR struct ftl_struct_s *dev,
+                           FAR struct ftl_eblock_s *eb)
+{
+  int ret;
+
+  if (!eb->valid || !eb->dirty)
+    {
+      return OK;
+    }
+
+  /* If this fails, the block stays dirty:  The cache may now hold the only
+   * copy of its data.
+   */
+
+  ret = ftl_ebprogram(dev, eb->ebno, eb->buffer);
+  if (ret >= 0)
+    {
+      eb->dirty = false;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebflushall
+ *
+ * Description: Write all dirty erase blocks back to FLASH
+ *
+ ****************************************************************************/
+
+#ifdef FTL_WRITEBACK
+static int ftl_ebflushall(FAR struct ftl_struct_s *dev)
+{
+  int result = OK;
+  int ret;
+  int i;
+
+  for (i = 0; i < FTL_NEBLOCKS; i++)
+    {
+      ret = ftl_ebwriteback(dev, &dev->eblock[i]);
+      if (ret < 0 && result == OK)
+        {
+          result = ret;
+        }
+    }
+
+  return result;
+}
+#else
+#  define ftl_ebflushall(d) (OK)
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebworker
+ *
+ * Description: Write back the erase block cache on the worker thread
+ *
+ ****************************************************************************/
+
+#if CONFIG_FTL_EBCACHE_DELAY > 0
+static void ftl_ebworker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+
+  ftl_semtake(dev);
+  (void)ftl_ebflushall(dev);
+  ftl_semgive(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_ebget
+ *
+ * Description:
+ *   Return the cached copy of an erase block, reading it from FLASH into
+ *   the least recently used buffer if it is not already cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_ebget(FAR struct ftl_struct_s *dev, off_t ebno,
+                     FAR struct ftl_eblock_s **ebp)
+{
+  FAR struct ftl_eblock_s *eb;
+  size_t nxfrd;
+  int    ret;
+  int    i;
+
+  eb = ftl_ebfind(dev, ebno);
+  if (eb != NULL)
+    {
+      *ebp = eb;
+      return OK;
+    }
+
+  /* Pick an unused buffer or else the least recently used one */
+
+  eb = &dev->eblock[0];
+  for (i = 1; i < FTL_NEBLOCKS && eb->valid; i++)
+    {
+      if (!dev->eblock[i].valid || dev->eblock[i].lru < eb->lru)
+        {
+          eb = &dev->eblock[i];
+        }
+    }
+
+  ret = ftl_ebwriteback(dev, eb);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (eb->buffer == NULL)
+    {
+      eb->buffer = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
+      if (eb->buffer == NULL)
+        {
+          ferr("ERROR: Failed to allocate an erase block buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  /* Read the full erase block into the buffer */
+
+  eb->valid = false;
+  nxfrd     = MTD_BREAD(dev->mtd, ebno * dev->blkper, dev->blkper,
+                        eb->buffer);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", ebno, nxfrd);
+      return -EIO;
+    }
+
+  ftl_count(dev, fs_fills, 1);
+
+  eb->ebno  = ebno;
+  eb->lru   = ++dev->lru;
+  eb->valid = true;
+  eb->dirty = false;
+
+  *ebp = eb;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_free
+ *
+ * Description: Release all resources held by the FTL device
+ *
+ ****************************************************************************/
+
+static void ftl_free(FAR struct ftl_struct_s *dev)
+{
+#ifdef CONFIG_FS_WRITABLE
+  int i;
+#endif
+
+#ifdef FTL_HAVE_RWBUFFER
+  rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FS_WRITABLE
+#if CONFIG_FTL_EBCACHE_DELAY > 0
+  (void)work_cancel(LPWORK, &dev->work);
+#endif
+
+  ftl_semtake(dev);
+  (void)ftl_ebflushall(dev);
+  ftl_semgive(dev);
+
+  for (i = 0; i < FTL_NEBLOCKS; i++)
+    {
+      if (dev->eblock[i].buffer)
+        {
+          kmm_free(dev->eblock[i].buffer);
+        }
+    }
+
+  nxsem_destroy(&dev->exclsem);
+#endif
+
+  kmm_free(dev);
+}
+
 /****************************************************************************
  * Name: ftl_open
  *
@@ -175,27 +528,51 @@ static int ftl_close(FAR struct inode *inode)
   rwb_flush(&dev->rwb);
 #endif
 
+#ifdef FTL_WRITEBACK
+  ftl_semtake(dev);
+  (void)ftl_ebflushall(dev);
+  ftl_semgive(dev);
+#endif
+
   if (--dev->refs == 0 && dev->unlinked)
     {
-#ifdef FTL_HAVE_RWBUFFER
-      rwb_uninitialize(&dev->rwb);
-#endif
-#ifdef CONFIG_FS_WRITABLE
-      if (dev->eblock)
-        {
-          kmm_free(dev->eblock);
-        }
-#endif
-      kmm_free(dev);
+      ftl_free(dev);
     }
 
   return OK;
 }
 
+/****************************************************************************
+ * Name: ftl_mtdread
+ *
+ * Description:  Read the specified numer of sectors from FLASH
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_mtdread(FAR struct ftl_struct_s *dev,
+                           FAR uint8_t *buffer, off_t startblock,
+                           size_t nblocks)
+{
+  ssize_t nread;
+
+  nread = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
+  if (nread != nblocks)
+    {
+      ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
+            nblocks, startblock, nread);
+    }
+
+  return nread;
+}
+
 /****************************************************************************
  * Name: ftl_reload
  *
- * Description:  Read the specified numer of sectors
+ * Description:
+ *   Read the specified numer of sectors.  Blocks of erase blocks held in
+ *   the erase block cache are copied from the cache since it may hold data
+ *   that has not yet been written to FLASH.  Runs of other blocks are read
+ *   from FLASH with a single transfer.
  *
  ****************************************************************************/
 
@@ -203,18 +580,84 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                           off_t startblock, size_t nblocks)
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+#ifdef CONFIG_FS_WRITABLE
+  FAR struct ftl_eblock_s *eb;
+  FAR uint8_t *runbuf;
+  off_t   runstart;
+  size_t  runlen;
+  size_t  remaining;
+  size_t  count;
+  off_t   ebno;
+  off_t   offset;
   ssize_t nread;
 
-  /* Read the full erase block into the buffer */
+  ftl_semtake(dev);
 
-  nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
-  if (nread != nblocks)
+  runbuf    = buffer;
+  runstart  = startblock;
+  runlen    = 0;
+  remaining = nblocks;
+
+  while (remaining > 0)
     {
-      ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
-            nblocks, startblock, nread);
+      ebno   = startblock / dev->blkper;
+      offset = startblock - ebno * dev->blkper;
+      count  = dev->blkper - offset;
+
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      eb = ftl_ebfind(dev, ebno);
+      if (eb == NULL)
+        {
+          /* Add this block to the run read from FLASH */
+
+          runlen += count;
+        }
+      else
+        {
+          /* Read the preceding run (if any) then copy from the cache */
+
+          if (runlen > 0)
+            {
+              nread = ftl_mtdread(dev, runbuf, runstart, runlen);
+              if (nread != runlen)
+                {
+                  goto errout_with_sem;
+                }
+            }
+
+          memcpy(buffer, eb->buffer + offset * dev->geo.blocksize,
+                 count * dev->geo.blocksize);
+
+          runbuf   = buffer + count * dev->geo.blocksize;
+          runstart = startblock + count;
+          runlen   = 0;
+        }
+
+      startblock += count;
+      remaining  -= count;
+      buffer     += count * dev->geo.blocksize;
+    }
+
+  nread = nblocks;
+  if (runlen > 0)
+    {
+      nread = ftl_mtdread(dev, runbuf, runstart, runlen);
+      if (nread == runlen)
+        {
+          nread = nblocks;
+        }
     }
 
+errout_with_sem:
+  ftl_semgive(dev);
   return nread;
+#else
+  return ftl_mtdread(dev, buffer, startblock, nblocks);
+#endif
 }
 
 /****************************************************************************
@@ -244,203 +687,105 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 /****************************************************************************
  * Name: ftl_flush
  *
- * Description: Write the specified number of sectors
+ * Description:
+ *   Write the specified number of sectors.  Full erase blocks are written
+ *   directly to FLASH.  Partial erase blocks are merged into the cached
+ *   copy of the erase block.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int ftl_alloc_eblock(FAR struct ftl_struct_s *dev)
-{
-  if (dev->eblock == NULL)
-    {
-       /* Allocate one, in-memory erase block buffer */
-
-       dev->eblock = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
-    }
-
-   return dev->eblock != NULL ? OK : -ENOMEM;
-}
-
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
-  off_t  alignedblock;
-  off_t  mask;
-  off_t  rwblock;
-  off_t  eraseblock;
+  FAR struct ftl_eblock_s *eb;
+  off_t  ebno;
   off_t  offset;
   size_t remaining;
-  size_t nxfrd;
+  size_t count;
   int    nbytes;
-  int    ret;
-
-  /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
-   * per erase block is a power of 2, and (2) the erase begins with that same
-   * alignment.
-   */
+  int    ret = OK;
 
-  mask         = dev->blkper - 1;
-  alignedblock = (startblock + mask) & ~mask;
-
-  /* Handle partial erase blocks before the first unaligned block */
+  ftl_semtake(dev);
 
   remaining = nblocks;
-  if (alignedblock > startblock)
+  while (remaining > 0)
     {
-      /* Check if the write is shorter than to the end of the erase block */
-
-      bool short_write = (remaining < (alignedblock - startblock));
-
-      ret = ftl_alloc_eblock(dev);
-      if (ret < 0)
-        {
-          ferr("ERROR: Failed to allocate an erase block buffer\n");
-          return ret;
-        }
+      ebno   = startblock / dev->blkper;
+      offset = startblock - ebno * dev->blkper;
+      count  = dev->blkper - offset;
 
-      /* Read the full erase block into the buffer */
-
-      rwblock = startblock & ~mask;
-      nxfrd   = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
+      if (count > remaining)
         {
-          ferr("ERROR: Read erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
+          count = remaining;
         }
 
-      /* Then erase the erase block */
+      nbytes = count * dev->geo.blocksize;
 
-      eraseblock = rwblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
-      if (ret < 0)
+      if (count == dev->blkper)
         {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-          return ret;
-        }
-
-      /* Copy the user data at the end of the buffered erase block */
+          /* A full erase block.  Any cached copy is superseded. */
 
-      offset = (startblock & mask) * dev->geo.blocksize;
+          eb = ftl_ebfind(dev, ebno);
+          if (eb != NULL)
+            {
+              eb->valid = false;
+              eb->dirty = false;
+            }
 
-      if (short_write)
-        {
-          nbytes = remaining * dev->geo.blocksize;
+          ret = ftl_ebprogram(dev, ebno, buffer);
         }
       else
         {
-          nbytes = dev->geo.erasesize - offset;
-        }
+          /* A partial erase block.  Merge the data into the cached copy */
 
-      finfo("Copy %d bytes into erase block=%d at offset=%d\n",
-             nbytes, eraseblock, offset);
+          ret = ftl_ebget(dev, ebno, &eb);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      memcpy(dev->eblock + offset, buffer, nbytes);
+          finfo("Copy %d bytes into erase block=%d at offset=%d\n",
+                nbytes, ebno, offset * dev->geo.blocksize);
 
-      /* And write the erase block back to flash */
+          memcpy(eb->buffer + offset * dev->geo.blocksize, buffer, nbytes);
 
-      nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
-        }
+          if (eb->dirty)
+            {
+              ftl_count(dev, fs_merged, count);
+            }
 
-      /* Then update for amount written */
+          eb->dirty = true;
 
-      if (short_write)
-        {
-          remaining = 0;
-        }
-      else
-        {
-          remaining -= dev->blkper - (startblock & mask);
-        }
-
-      buffer += nbytes;
-    }
-
-  /* How handle full erase pages in the middle */
+#ifndef FTL_WRITEBACK
+          /* And write the erase block back to flash */
 
-  while (remaining >= dev->blkper)
-    {
-      /* Erase the erase block */
-
-      eraseblock = alignedblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
-      if (ret < 0)
-        {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-          return ret;
-        }
-
-      /* Write a full erase back to flash */
-
-      finfo("Write %d bytes into erase block=%d at offset=0\n",
-             dev->geo.erasesize, alignedblock);
-
-      nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, buffer);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
-
-      /* Then update for amount written */
-
-      alignedblock += dev->blkper;
-      remaining    -= dev->blkper;
-      buffer       += dev->geo.erasesize;
-    }
-
-  /* Finally, handle any partial blocks after the last full erase block */
-
-  if (remaining > 0)
-    {
-      ret = ftl_alloc_eblock(dev);
-      if (ret < 0)
-        {
-          ferr("ERROR: Failed to allocate an erase block buffer\n");
-          return ret;
-        }
-
-      /* Read the full erase block into the buffer */
-
-      nxfrd = MTD_BREAD(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Read erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
+          ret = ftl_ebwriteback(dev, eb);
+#endif
         }
 
-      /* Then erase the erase block */
-
-      eraseblock = alignedblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
       if (ret < 0)
         {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-          return ret;
+          break;
         }
 
-      /* Copy the user data at the beginning the buffered erase block */
+      ftl_count(dev, fs_hostblocks, count);
 
-      nbytes = remaining * dev->geo.blocksize;
-      finfo("Copy %d bytes into erase block=%d at offset=0\n",
-             nbytes, alignedblock);
-      memcpy(dev->eblock, buffer, nbytes);
+      startblock += count;
+      remaining  -= count;
+      buffer     += nbytes;
+    }
 
-      /* And write the erase back to flash */
+#if CONFIG_FTL_EBCACHE_DELAY > 0
+  /* Write the cache back if there is no more write activity for a while */
 
-      nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
-    }
+  (void)work_queue(LPWORK, &dev->work, ftl_ebworker, (FAR void *)dev,
+                   MSEC2TICK(CONFIG_FTL_EBCACHE_DELAY));
+#endif
 
-  return nblocks;
+  ftl_semgive(dev);
+  return ret < 0 ? ret : nblocks;
 }
 #endif
 
@@ -548,10 +893,49 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       cmd = MTDIOC_XIPBASE;
     }
-#ifdef CONFIG_FTL_WRITEBUFFER
   else if (cmd == BIOC_FLUSH)
     {
-      return rwb_flush(&dev->rwb);
+#ifdef CONFIG_FTL_WRITEBUFFER
+      ret = rwb_flush(&dev->rwb);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+
+#ifdef FTL_WRITEBACK
+      ftl_semtake(dev);
+      ret = ftl_ebflushall(dev);
+      ftl_semgive(dev);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+
+      /* Then let the MTD driver flush any buffering of its own.  Most MTD
+       * drivers do not buffer and will not recognize the command.
+       */
+
+      ret = MTD_IOCTL(dev->mtd, BIOC_FLUSH, 0);
+      return ret == -ENOTTY ? OK : ret;
+    }
+#ifdef CONFIG_FTL_STATISTICS
+  else if (cmd == BIOC_FTLSTATS)
+    {
+      FAR struct ftl_stats_s *stats =
+        (FAR struct ftl_stats_s *)((uintptr_t)arg);
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      ftl_semtake(dev);
+      memcpy(stats, &dev->stats, sizeof(struct ftl_stats_s));
+      ftl_semgive(dev);
+      return OK;
     }
 #endif
 
@@ -587,16 +971,7 @@ static int ftl_unlink(FAR struct inode *inode)
   dev->unlinked = true;
   if (dev->refs == 0)
     {
-#ifdef FTL_HAVE_RWBUFFER
-      rwb_uninitialize(&dev->rwb);
-#endif
-#ifdef CONFIG_FS_WRITABLE
-      if (dev->eblock)
-        {
-          kmm_free(dev->eblock);
-        }
-#endif
-      kmm_free(dev);
+      ftl_free(dev);
     }
 
   return OK;
@@ -658,6 +1033,10 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FS_WRITABLE
+      nxsem_init(&dev->exclsem, 0, 1);
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
@@ -679,6 +1058,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FS_WRITABLE
+          nxsem_destroy(&dev->exclsem);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -690,10 +1072,7 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
-#ifdef FTL_HAVE_RWBUFFER
-          rwb_uninitialize(&dev->rwb);
-#endif
-          kmm_free(dev);
+          ftl_free(dev);
         }
     }
 
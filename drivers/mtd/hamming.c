@@ -52,6 +52,27 @@
 
 #include <nuttx/mtd/hamming.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Helpers used to build the bit count table at compile time */
+
+#define B2(n) n,     n + 1,     n + 1,     n + 2
+#define B4(n) B2(n), B2(n + 1), B2(n + 1), B2(n + 2)
+#define B6(n) B4(n), B4(n + 1), B4(n + 1), B4(n + 2)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of bits set to '1' in each possible byte value */
+
+static const uint8_t g_bitsinbyte[256] =
+{
+  B6(0), B6(1), B6(1), B6(2)
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -70,21 +91,7 @@
  *
  ****************************************************************************/
 
-static unsigned int hamming_bitsinbyte(uint8_t byte)
-{
-  unsigned int count = 0;
-
-  while (byte != 0)
-    {
-      if ((byte & 1) != 0)
-        {
-          count++;
-        }
-      byte >>= 1;
-    }
-
-  return count;
-}
+#define hamming_bitsinbyte(b) ((unsigned int)g_bitsinbyte[(uint8_t)(b)])
 
 /****************************************************************************
  * Name: hamming_bitsincode256
@@ -137,13 +144,15 @@ static void hamming_compute256(FAR const uint8_t *data, FAR uint8_t *code)
 
   for (i = 0; i < 256; i++)
     {
-      colsum ^= data[i];
+      uint8_t byte = data[i];
+
+      colsum ^= byte;
 
       /* If the xor sum of the byte is 0, then this byte has no incidence on
        * the computed code; so check if the sum is 1.
        */
 
-      if ((hamming_bitsinbyte(data[i]) & 1) == 1)
+      if ((g_bitsinbyte[byte] & 1) != 0)
         {
           /* Parity groups are formed by forcing a particular index bit to 0
            * (even) or 1 (odd).
@@ -419,7 +428,7 @@ int hamming_verify256x(FAR uint8_t *data, size_t size, FAR const uint8_t *code)
 {
   ssize_t remaining = (ssize_t)size;
   int result = HAMMING_SUCCESS;
-  int ret;
+  int ret = HAMMING_SUCCESS;
 
   DEBUGASSERT((size & 0xff) == 0);
 
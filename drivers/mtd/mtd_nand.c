@@ -107,6 +107,14 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR const void *data);
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int      nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR uint8_t *data);
+static int      nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, unsigned int npages,
+                  FAR const uint8_t *data);
+#endif
 
 /* MTD driver methods */
 
@@ -539,6 +547,122 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of several consecutive pages of one block into
+ *   the provided buffer.  The lower half multi-page read is used when it is
+ *   available and the ECC is not performed in software; otherwise the pages
+ *   are read one at a time.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read (within the block)
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize;
+  int ret;
+
+  if (npages > 1 && raw->readpages != NULL &&
+      raw->ecctype != NANDECC_SWECC)
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_READPAGES(raw, block, page, npages, data);
+    }
+
+  pagesize = nandmodel_getpagesize(&raw->model);
+  for (; npages > 0; npages--, page++, data += pagesize)
+    {
+      ret = nand_readpage(nand, block, page, data);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of several consecutive pages of one block from
+ *   the provided buffer.  The lower half multi-page write is used when it
+ *   is available and the ECC is not performed in software; otherwise the
+ *   pages are written one at a time.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write (within the block)
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+static int nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize;
+  int ret;
+
+  if (npages > 1 && raw->writepages != NULL &&
+      raw->ecctype != NANDECC_SWECC)
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_WRITEPAGES(raw, block, page, npages, data);
+    }
+
+  pagesize = nandmodel_getpagesize(&raw->model);
+  for (; npages > 0; npages--, page++, data += pagesize)
+    {
+      ret = nand_writepage(nand, block, page, data);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -552,6 +676,10 @@ static int nand_erase(struct mtd_dev_s *dev, off_t startblock,
 {
   FAR struct nand_dev_s *nand = (FAR struct nand_dev_s *)dev;
   size_t blocksleft = nblocks;
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  FAR struct nand_raw_s *raw = nand->raw;
+  unsigned int nplanes = raw->nplanes;
+#endif
   int ret;
 
   finfo("startblock: %08lx nblocks: %d\n", (long)startblock, (int)nblocks);
@@ -561,6 +689,22 @@ static int nand_erase(struct mtd_dev_s *dev, off_t startblock,
   nand_lock(nand);
   while (blocksleft-- > 0)
     {
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+      /* Erase one block in every plane at once if the range covers a
+       * whole, aligned group of blocks.  If that fails, the blocks are
+       * erased (and bad blocks marked) one at a time below.
+       */
+
+      if (nplanes > 1 && raw->eraseblocks != NULL &&
+          (startblock % nplanes) == 0 && blocksleft + 1 >= nplanes &&
+          NAND_ERASEBLOCKS(raw, startblock) >= 0)
+        {
+          startblock += nplanes;
+          blocksleft -= nplanes - 1;
+          continue;
+        }
+#endif
+
       /* Erase each sector */
 
       ret = nand_eraseblock(nand, startblock, false);
@@ -595,6 +739,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -628,7 +773,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then read every page from NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -641,9 +786,22 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+      /* Read the rest of the pages in this block from NAND */
+
+      count = pagesperblock - page;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      ret = nand_readpages(nand, block, page, count, buffer);
+#else
       /* Read the next page from NAND */
 
+      count = 1;
       ret = nand_readpage(nand, block, page, buffer);
+#endif
       if (ret < 0)
         {
           ferr("ERROR: nand_readpage failed block=%ld page=%d: %d\n",
@@ -656,15 +814,16 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += count;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += count * pagesize;
     }
 
   nand_unlock(nand);
@@ -691,6 +850,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -724,7 +884,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then write every page into NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -737,9 +897,22 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+      /* Write the rest of the pages in this block into NAND */
+
+      count = pagesperblock - page;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      ret = nand_writepages(nand, block, page, count, buffer);
+#else
       /* Write the next page into NAND */
 
+      count = 1;
       ret = nand_writepage(nand, block, page, buffer);
+#endif
       if (ret < 0)
         {
           ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
@@ -752,15 +925,16 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
+      page += count;
+      if (page >= pagesperblock)
         {
           page = 0;
           block++;
         }
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += count * pagesize;
     }
 
   nand_unlock(nand);
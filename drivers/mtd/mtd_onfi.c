@@ -328,6 +328,11 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->buswidth = (*(FAR uint8_t *)(parmtab + 6)) & 0x01;
 
+  /* Features and optional commands supported (bytes 6-9) */
+
+  onfi->features = *(FAR uint16_t *)(FAR void *)(parmtab + 6);
+  onfi->optcmds  = *(FAR uint16_t *)(FAR void *)(parmtab + 8);
+
   /* Get number of data bytes per page (bytes 80-83 in the param table) */
 
   onfi->pagesize =  *(FAR uint32_t *)(FAR void *)(parmtab + 80);
@@ -348,6 +353,10 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->luns = *(FAR uint8_t *)(parmtab + 100);
 
+  /* Number of multi-plane (interleaved) address bits */
+
+  onfi->planebits = *(FAR uint8_t *)(parmtab + 110) & 0x0f;
+
   /* Number of bits of ECC correction */
 
   onfi->eccsize = *(FAR uint8_t *)(parmtab + 112);
@@ -366,6 +375,9 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
   finfo("  pagesperblock: %d\n",     onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",     onfi->blocksperlun);
   finfo("  pagesize:      %d\n",     onfi->pagesize);
+  finfo("  planebits:     %d\n",     onfi->planebits);
+  finfo("  features:      0x%04x\n", onfi->features);
+  finfo("  optcmds:       0x%04x\n", onfi->optcmds);
   return OK;
 }
 
@@ -287,7 +287,7 @@ static int mtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
           /* Erase the entire device */
 
           ret = priv->dev->ioctl(priv->dev, MTDIOC_BULKERASE, 0);
-          if (ret >= 0)
+          if (ret < 0)
             {
               ferr("ERROR: Device ioctl failed: %d\n", ret);
               break;
@@ -303,6 +303,14 @@ static int mtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+      case BIOC_FLUSH:
+        {
+          /* Write all buffered blocks to the device */
+
+          ret = rwb_flush(&priv->rwb);
+        }
+        break;
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
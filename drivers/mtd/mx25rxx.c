@@ -156,6 +156,7 @@ struct mx25rxx_dev_s
   uint8_t                sectorshift; /* 16 or 18 */
   uint8_t                pageshift;   /* 8 */
   uint16_t               nsectors;    /* 128 or 64 */
+  FAR void              *xipbase;     /* XIP base address (or NULL) */
 };
 
 /******************************************************************************
@@ -176,8 +177,9 @@ static int mx25rxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
 
 /* Internal driver methods */
 
-static void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read);
-static void mx25rxx_unlock(FAR struct qspi_dev_s *qspi);
+static void mx25rxx_lock(FAR struct mx25rxx_dev_s *dev, bool read);
+static void mx25rxx_unlock(FAR struct mx25rxx_dev_s *dev);
+static void mx25rxx_memmap(FAR struct mx25rxx_dev_s *dev);
 static int mx25rxx_command_read(FAR struct qspi_dev_s *qspi, uint8_t cmd,
                                 FAR void *buffer, size_t buflen);
 static int mx25rxx_command_write(FAR struct qspi_dev_s *qspi, uint8_t cmd,
@@ -205,8 +207,19 @@ static int mx25rxx_erase_chip(struct mx25rxx_dev_s *priv);
  * Private Functions
  ******************************************************************************/
 
-void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read)
+void mx25rxx_lock(FAR struct mx25rxx_dev_s *dev, bool read)
 {
+  FAR struct qspi_dev_s *qspi = dev->qspi;
+
+  /* Indirect transfers are not possible in memory-mapped (XIP) mode.  Leave
+   * it now; it is re-entered when the bus is unlocked.
+   */
+
+  if (dev->xipbase != NULL)
+    {
+      QSPI_MEMUNMAP(qspi);
+    }
+
   /* On SPI busses where there are multiple devices, it will be necessary to
    * lock SPI to have exclusive access to the busses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -230,9 +243,40 @@ void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read)
      read ? CONFIG_MX25RXX_QSPI_READ_FREQUENCY : CONFIG_MX25RXX_QSPI_FREQUENCY);
 }
 
-void mx25rxx_unlock(FAR struct qspi_dev_s *qspi)
+void mx25rxx_unlock(FAR struct mx25rxx_dev_s *dev)
 {
-  (void)QSPI_LOCK(qspi, false);
+  (void)QSPI_LOCK(dev->qspi, false);
+
+  if (dev->xipbase != NULL)
+    {
+      mx25rxx_memmap(dev);
+    }
+}
+
+/* Put the QuadSPI controller in memory-mapped (XIP) mode, reading with the
+ * same command used for indirect reads.  dev->xipbase is NULL on return if
+ * the controller does not support memory-mapped mode.
+ */
+
+void mx25rxx_memmap(FAR struct mx25rxx_dev_s *dev)
+{
+  struct qspi_meminfo_s meminfo;
+  int ret;
+
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = 6;
+  meminfo.buflen  = 0;
+  meminfo.cmd     = MX25R_4READ;
+  meminfo.addr    = 0;
+  meminfo.key     = 0;
+  meminfo.buffer  = NULL;
+
+  ret = QSPI_MEMMAP(dev->qspi, &meminfo, &dev->xipbase);
+  if (ret < 0)
+    {
+      dev->xipbase = NULL;
+    }
 }
 
 int mx25rxx_command_read(FAR struct qspi_dev_s *qspi, uint8_t cmd,
@@ -506,7 +550,7 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  mx25rxx_lock(priv->qspi, false);
+  mx25rxx_lock(priv, false);
 
   while (blocksleft > 0)
     {
@@ -531,7 +575,7 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
         }
     }
 
-  mx25rxx_unlock(priv->qspi);
+  mx25rxx_unlock(priv);
 
   return (int)nblocks;
 }
@@ -564,7 +608,7 @@ ssize_t mx25rxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  mx25rxx_lock(priv->qspi, false);
+  mx25rxx_lock(priv, false);
 
   ret = mx25rxx_write_page(priv, buf, startblock << priv->pageshift,
                           nblocks << priv->pageshift);
@@ -573,7 +617,7 @@ ssize_t mx25rxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
       ferr("ERROR: mx25rxx_write_page failed: %d\n", ret);
     }
 
-  mx25rxx_unlock(priv->qspi);
+  mx25rxx_unlock(priv);
 
   return ret < 0 ? ret : nblocks;
 }
@@ -588,9 +632,9 @@ ssize_t mx25rxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  mx25rxx_lock(priv->qspi, true);
+  mx25rxx_lock(priv, true);
   ret = mx25rxx_read_byte(priv, buffer, offset, nbytes);
-  mx25rxx_unlock(priv->qspi);
+  mx25rxx_unlock(priv);
 
   if (ret < 0)
     {
@@ -642,9 +686,40 @@ int mx25rxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire device */
 
-          mx25rxx_lock(priv->qspi, false);
+          mx25rxx_lock(priv, false);
           ret = mx25rxx_erase_chip(priv);
-          mx25rxx_unlock(priv->qspi);
+          mx25rxx_unlock(priv);
+        }
+        break;
+
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          if (ppv)
+            {
+              /* Configure the bus for reads, then switch the controller to
+               * memory-mapped mode.  It stays there except while the bus is
+               * locked for indirect transfers.
+               */
+
+              if (priv->xipbase == NULL)
+                {
+                  mx25rxx_lock(priv, true);
+                  (void)QSPI_LOCK(priv->qspi, false);
+                  mx25rxx_memmap(priv);
+                }
+
+              if (priv->xipbase != NULL)
+                {
+                  *ppv = priv->xipbase;
+                  ret  = OK;
+                }
+              else
+                {
+                  ret  = -ENOTTY;
+                }
+            }
         }
         break;
 
@@ -661,7 +736,7 @@ int mx25rxx_readid(struct mx25rxx_dev_s *dev)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  mx25rxx_lock(dev->qspi, false);
+  mx25rxx_lock(dev, false);
 
   /* Read the JEDEC ID */
 
@@ -669,7 +744,7 @@ int mx25rxx_readid(struct mx25rxx_dev_s *dev)
 
   /* Unlock the bus */
 
-  mx25rxx_unlock(dev->qspi);
+  mx25rxx_unlock(dev);
 
   finfo("Manufacturer: %02x Device Type %02x, Capacity: %02x\n",
         dev->cmdbuf[0], dev->cmdbuf[1], dev->cmdbuf[2]);
@@ -770,7 +845,7 @@ FAR struct mtd_dev_s *mx25rxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
       goto exit_free_cmdbuf;
     }
 
-  mx25rxx_lock(dev->qspi, false);
+  mx25rxx_lock(dev, false);
 
   /* Set MTD device in low power mode, with minimum dummy cycles */
 
@@ -787,7 +862,7 @@ FAR struct mtd_dev_s *mx25rxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
 
   finfo("device ready 0x%02x 0x%04x\n", status, config);
 
-  mx25rxx_unlock(dev->qspi);
+  mx25rxx_unlock(dev);
 
   /* Return the implementation-specific state structure as the MTD device */
 
@@ -276,6 +276,7 @@ struct n25qxxx_dev_s
   uint8_t                pageshift;   /* Log2 of page size */
   FAR uint8_t           *cmdbuf;      /* Allocated command buffer */
   FAR uint8_t           *readbuf;     /* Allocated status read buffer */
+  FAR void              *xipbase;     /* Memory-mapped base address (or NULL) */
 
 #ifdef CONFIG_N25QXXX_SECTOR512
   uint8_t                flags;       /* Buffered sector flags */
@@ -290,8 +291,9 @@ struct n25qxxx_dev_s
 
 /* Locking */
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi);
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi);
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv);
 
 /* Low-level message helpers */
 
@@ -350,8 +352,19 @@ static int  n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
  * Name: n25qxxx_lock
  ************************************************************************************/
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv)
 {
+  FAR struct qspi_dev_s *qspi = priv->qspi;
+
+  /* Indirect transfers are not possible in memory-mapped (XIP) mode.  Leave it
+   * now; it is re-entered when the bus is unlocked.
+   */
+
+  if (priv->xipbase != NULL)
+    {
+      QSPI_MEMUNMAP(qspi);
+    }
+
   /* On QuadSPI buses where there are multiple devices, it will be necessary to
    * lock QuadSPI to have exclusive access to the buses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -378,9 +391,45 @@ static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
  * Name: n25qxxx_unlock
  ************************************************************************************/
 
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv)
 {
-  (void)QSPI_LOCK(qspi, false);
+  (void)QSPI_LOCK(priv->qspi, false);
+
+  if (priv->xipbase != NULL)
+    {
+      n25qxxx_memmap(priv);
+    }
+}
+
+/************************************************************************************
+ * Name: n25qxxx_memmap
+ *
+ * Description:
+ *   Put the QuadSPI controller in memory-mapped (XIP) mode, reading with the same
+ *   command used for indirect reads.  priv->xipbase is NULL on return if the
+ *   controller does not support memory-mapped mode.
+ *
+ ************************************************************************************/
+
+static void n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  int ret;
+
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
+  meminfo.buflen  = 0;
+  meminfo.cmd     = N25QXXX_FAST_READ_QUADIO;
+  meminfo.addr    = 0;
+  meminfo.key     = 0;
+  meminfo.buffer  = NULL;
+
+  ret = QSPI_MEMMAP(priv->qspi, &meminfo, &priv->xipbase);
+  if (ret < 0)
+    {
+      priv->xipbase = NULL;
+    }
 }
 
 /************************************************************************************
@@ -557,7 +606,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   /* Read the JEDEC ID */
 
@@ -565,7 +614,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 
   /* Unlock the bus */
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   finfo("Manufacturer: %02x Device Type %02x, Capacity: %02x\n",
         priv->cmdbuf[0], priv->cmdbuf[1], priv->cmdbuf[2]);
@@ -1165,7 +1214,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1189,7 +1238,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return (int)nblocks;
 }
@@ -1243,7 +1292,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
 #if defined(CONFIG_N25QXXX_SECTOR512)
   ret = n25qxxx_write_cache(priv, buffer, startblock, nblocks);
@@ -1261,7 +1310,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return ret < 0 ? ret : nblocks;
 }
@@ -1280,9 +1329,9 @@ static ssize_t n25qxxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbyt
 
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
   ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   if (ret < 0)
     {
@@ -1344,9 +1393,40 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire device */
 
-          n25qxxx_lock(priv->qspi);
+          n25qxxx_lock(priv);
           ret = n25qxxx_erase_chip(priv);
-          n25qxxx_unlock(priv->qspi);
+          n25qxxx_unlock(priv);
+        }
+        break;
+
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          if (ppv)
+            {
+              /* Configure the bus for this device, then switch the controller
+               * to memory-mapped mode.  It stays there except while the bus is
+               * locked for indirect transfers.
+               */
+
+              if (priv->xipbase == NULL)
+                {
+                  n25qxxx_lock(priv);
+                  (void)QSPI_LOCK(priv->qspi, false);
+                  n25qxxx_memmap(priv);
+                }
+
+              if (priv->xipbase != NULL)
+                {
+                  *ppv = priv->xipbase;
+                  ret  = OK;
+                }
+              else
+                {
+                  ret  = -ENOTTY;
+                }
+            }
         }
         break;
 
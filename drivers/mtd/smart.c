@@ -58,7 +58,10 @@
 #include <crc32.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -143,6 +146,24 @@
 #define smart_free(d, p)        kmm_free(p)
 #endif
 
+/* Sector map checkpoint.  The journal entry for erase block N is N + 1 so
+ * that no entry is ever the erased state.
+ */
+
+#define SMART_CP_MAGIC              "SMCP"
+#define SMART_CP_OVERFLOW           0xfffe
+#define SMART_CP_ERASED             ((CONFIG_SMARTFS_ERASEDSTATE << 8) | \
+                                     CONFIG_SMARTFS_ERASEDSTATE)
+#define SMART_CP_MINENTRIES         16
+
+#ifndef CONFIG_MTD_SMART_JOURNAL_ENTRIES
+#  define CONFIG_MTD_SMART_JOURNAL_ENTRIES 512
+#endif
+
+#ifndef CONFIG_MTD_SMART_GC_DELAY
+#  define CONFIG_MTD_SMART_GC_DELAY 100
+#endif
+
 #define SMART_WEAR_FULL_RELOCATE_THRESHOLD  8
 #define SMART_WEAR_REORG_THRESHOLD          14
 #define SMART_WEAR_MIN_LEVEL                5
@@ -275,8 +296,45 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  sem_t                 exclsem;          /* Serializes the driver and the GC worker */
+  struct work_s         gcwork;           /* Background garbage collection */
+  bool                  gcworker;         /* True while the GC worker runs */
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR uint8_t          *cpjournaled;      /* Erase blocks recorded in the journal */
+  FAR uint8_t          *cpbuffer;         /* MTD block buffer for journal writes */
+  uint32_t              cpseq;            /* Sequence number of the newest copy */
+  uint32_t              cpjstart;         /* Offset of the journal in a copy */
+  uint32_t              cpnentries;       /* Journal entries in a copy */
+  uint32_t              cpnext;           /* Next free journal entry */
+  uint16_t              cpblocks;         /* Erase blocks per checkpoint copy */
+  uint8_t               cpcopy;           /* Index of the active copy */
+  bool                  cpvalid;          /* Active copy + journal match the FLASH */
+#endif
 };
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Header of a sector map checkpoint copy.  The header is followed by the
+ * sector map and the release and free counts exactly as they are laid out
+ * in RAM, and then by the journal starting at the next sector boundary.
+ */
+
+struct smart_cphdr_s
+{
+  uint8_t               magic[4];         /* SMART_CP_MAGIC */
+  uint32_t              seq;              /* Incremented for each copy written */
+  uint32_t              crc;              /* CRC-32 of header and map */
+  uint16_t              sectorsize;       /* Geometry the map applies to */
+  uint16_t              totalsectors;
+  uint16_t              neraseblocks;
+  uint8_t               formatstatus;     /* Format information */
+  uint8_t               formatversion;
+  uint8_t               namesize;
+  uint8_t               reserved[3];
+};
+#endif
+
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED   0x02
 
@@ -378,6 +436,9 @@ static int smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t canr
 
 #ifdef CONFIG_FS_WRITABLE
 static int smart_writesector(FAR struct smart_struct_s *dev, unsigned long arg);
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gcworker(FAR void *arg);
+#endif
 static inline int smart_allocsector(FAR struct smart_struct_s *dev,
                  unsigned long requested);
 #endif
@@ -391,6 +452,29 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_lock(FAR struct smart_struct_s *dev);
+#  define smart_unlock(dev) nxsem_post(&(dev)->exclsem)
+#else
+#  define smart_lock(dev)
+#  define smart_unlock(dev)
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_journal(FAR struct smart_struct_s *dev, uint16_t block);
+static void smart_cpinvalidate(FAR struct smart_struct_s *dev);
+static int  smart_cpwrite(FAR struct smart_struct_s *dev);
+#else
+#  define smart_journal(dev, block)
+#  define smart_cpinvalidate(dev)
+#endif
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+static void smart_cpsync(FAR struct smart_struct_s *dev);
+#else
+#  define smart_cpsync(dev)
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -462,6 +546,29 @@ static int smart_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: smart_lock
+ *
+ * Description: Get exclusive access to the device.  Needed only when the
+ *              garbage collection worker may run concurrently with the
+ *              file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_lock(FAR struct smart_struct_s *dev)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&dev->exclsem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_malloc
  *
@@ -829,6 +936,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -838,7 +946,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -875,7 +987,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
+
+  /* Raw writes to the device are not recorded in the checkpoint journal */
+
+  smart_cpinvalidate(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -914,9 +1030,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -943,9 +1057,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -957,6 +1069,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -1321,6 +1434,8 @@ static ssize_t smart_bytewrite(FAR struct smart_struct_s *dev, size_t offset,
 {
   ssize_t       ret;
 
+  smart_journal(dev, offset / dev->geo.erasesize);
+
 #ifdef CONFIG_MTD_BYTE_WRITE
   /* Check if the underlying MTD device supports write */
 
@@ -1375,6 +1490,404 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cpaddress
+ *
+ * Description: Returns the FLASH address of a sector map checkpoint copy.
+ *              The copies live in the erase blocks reserved past the end
+ *              of the SMART volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static uint32_t smart_cpaddress(FAR struct smart_struct_s *dev, uint8_t copy)
+{
+  return ((uint32_t)dev->geo.neraseblocks + copy * dev->cpblocks) *
+         dev->geo.erasesize;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cppaylen
+ *
+ * Description: Returns the size of the map and counts saved in a
+ *              checkpoint.  These are contiguous in the sMap allocation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static size_t smart_cppaylen(FAR struct smart_struct_s *dev)
+{
+  return (size_t)dev->totalsectors * sizeof(uint16_t) +
+         ((size_t)dev->neraseblocks << 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cplayout
+ *
+ * Description: Calculates the position and size of the journal in a
+ *              checkpoint copy for the current sector size.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cplayout(FAR struct smart_struct_s *dev)
+{
+  uint32_t size;
+  uint32_t jstart;
+
+  if (dev->cpblocks == 0 || dev->sectorsize == 0)
+    {
+      return -ENOSYS;
+    }
+
+  size   = dev->cpblocks * dev->geo.erasesize;
+  jstart = sizeof(struct smart_cphdr_s) + smart_cppaylen(dev);
+  jstart = (jstart + dev->sectorsize - 1) / dev->sectorsize * dev->sectorsize;
+
+  if (jstart + (SMART_CP_MINENTRIES << 1) > size)
+    {
+      /* The map of a volume with this sector size does not fit */
+
+      return -ENOSPC;
+    }
+
+  dev->cpjstart   = jstart;
+  dev->cpnentries = (size - jstart) >> 1;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cpprogram
+ *
+ * Description: Programs a few bytes of a checkpoint copy.  This is like
+ *              smart_bytewrite() but does not use the sector buffer, which
+ *              may hold data in flight when the journal is updated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cpprogram(FAR struct smart_struct_s *dev, uint32_t offset,
+                           int nbytes, FAR const uint8_t *buffer)
+{
+  uint32_t block;
+  ssize_t  ret;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (dev->mtd->write != NULL)
+    {
+      ret = dev->mtd->write(dev->mtd, offset, nbytes, buffer);
+      return ret == nbytes ? OK : -EIO;
+    }
+#endif
+
+  block = offset / dev->geo.blocksize;
+  DEBUGASSERT(offset + nbytes <= (block + 1) * dev->geo.blocksize);
+
+  ret = MTD_BREAD(dev->mtd, block, 1, dev->cpbuffer);
+  if (ret != 1)
+    {
+      return -EIO;
+    }
+
+  memcpy(&dev->cpbuffer[offset - block * dev->geo.blocksize], buffer, nbytes);
+
+  ret = MTD_BWRITE(dev->mtd, block, 1, dev->cpbuffer);
+  return ret == 1 ? OK : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cpinvalidate
+ *
+ * Description: Marks the active checkpoint copy as stale so that the next
+ *              initialization performs a full scan.  Used when the journal
+ *              overflows or when the FLASH is modified in a way that it
+ *              does not record.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_cpinvalidate(FAR struct smart_struct_s *dev)
+{
+  uint16_t entry = SMART_CP_OVERFLOW;
+  int ret;
+
+  if (dev->cpvalid)
+    {
+      /* A journal slot is always kept free for the overflow marker */
+
+      dev->cpvalid = false;
+      ret = smart_cpprogram(dev, smart_cpaddress(dev, dev->cpcopy) +
+                            dev->cpjstart + (dev->cpnext << 1), 2,
+                            (FAR const uint8_t *)&entry);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to invalidate the checkpoint: %d\n", ret);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_journal
+ *
+ * Description: Records in the checkpoint journal that an erase block is
+ *              about to be modified.  Must be called before the FLASH is
+ *              programmed or erased so that an interrupted operation is
+ *              still found when the journal is replayed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_journal(FAR struct smart_struct_s *dev, uint16_t block)
+{
+  uint16_t entry;
+  uint8_t  mask;
+  int      ret;
+
+  if (!dev->cpvalid || block >= dev->neraseblocks)
+    {
+      return;
+    }
+
+  /* Each erase block needs to be recorded only once */
+
+  mask = 1 << (block & 0x07);
+  if ((dev->cpjournaled[block >> 3] & mask) != 0)
+    {
+      return;
+    }
+
+  if (dev->cpnext >= dev->cpnentries - 1)
+    {
+      /* The journal is full.  A full scan is needed until the checkpoint
+       * is written again.
+       */
+
+      smart_cpinvalidate(dev);
+      return;
+    }
+
+  entry = block + 1;
+  ret = smart_cpprogram(dev, smart_cpaddress(dev, dev->cpcopy) +
+                        dev->cpjstart + (dev->cpnext << 1), 2,
+                        (FAR const uint8_t *)&entry);
+  if (ret < 0)
+    {
+      ferr("ERROR: Journal write failed: %d\n", ret);
+      smart_cpinvalidate(dev);
+      return;
+    }
+
+  dev->cpjournaled[block >> 3] |= mask;
+  dev->cpnext++;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cpwrite
+ *
+ * Description: Writes the sector map, the free and release counts and the
+ *              format information to the inactive checkpoint copy and makes
+ *              it the active copy with an empty journal.  Must be called
+ *              only when the RAM state matches the FLASH, i.e. not in the
+ *              middle of a sector write or relocation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cpwrite(FAR struct smart_struct_s *dev)
+{
+  struct smart_cphdr_s hdr;
+  FAR const uint8_t *payload;
+  uint32_t address;
+  uint32_t total;
+  uint32_t pos;
+  size_t   paylen;
+  size_t   src;
+  size_t   offset;
+  size_t   nbytes;
+  uint8_t  copy;
+  int      ret;
+
+  /* Only a formatted volume is checkpointed.  Otherwise the format status
+   * would be taken from the checkpoint instead of being found by a scan.
+   */
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return -ENODEV;
+    }
+
+  ret = smart_cplayout(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("Writing checkpoint %lu\n", (unsigned long)dev->cpseq + 1);
+
+  /* Erase the inactive copy.  The active one stays intact until the new
+   * copy is complete.
+   */
+
+  copy    = dev->cpcopy ^ 1;
+  address = smart_cpaddress(dev, copy);
+
+  ret = MTD_ERASE(dev->mtd, address / dev->geo.erasesize, dev->cpblocks);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, SMART_CP_MAGIC, sizeof(hdr.magic));
+  hdr.seq           = dev->cpseq + 1;
+  hdr.sectorsize    = dev->sectorsize;
+  hdr.totalsectors  = dev->totalsectors;
+  hdr.neraseblocks  = dev->neraseblocks;
+  hdr.formatstatus  = dev->formatstatus;
+  hdr.formatversion = dev->formatversion;
+  hdr.namesize      = dev->namesize;
+
+  payload = (FAR const uint8_t *)dev->sMap;
+  paylen  = smart_cppaylen(dev);
+  hdr.crc = crc32part(payload, paylen,
+                      crc32((FAR const uint8_t *)&hdr, sizeof(hdr)));
+
+  /* Write the header and the map one sector at a time */
+
+  total = sizeof(hdr) + paylen;
+  for (pos = 0; pos < total; pos += dev->sectorsize)
+    {
+      memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize);
+
+      offset = 0;
+      if (pos == 0)
+        {
+          memcpy(dev->rwbuffer, &hdr, sizeof(hdr));
+          offset = sizeof(hdr);
+        }
+
+      src    = pos + offset - sizeof(hdr);
+      nbytes = dev->sectorsize - offset;
+      if (src + nbytes > paylen)
+        {
+          nbytes = paylen - src;
+        }
+
+      memcpy(&dev->rwbuffer[offset], &payload[src], nbytes);
+
+      ret = MTD_BWRITE(dev->mtd, (address + pos) / dev->geo.blocksize,
+                       dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
+      if (ret != dev->mtdBlksPerSector)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+    }
+
+  /* The new copy is complete.  Start with an empty journal. */
+
+  dev->cpcopy  = copy;
+  dev->cpseq   = hdr.seq;
+  dev->cpnext  = 0;
+  dev->cpvalid = true;
+  memset(dev->cpjournaled, 0, (dev->neraseblocks + 7) >> 3);
+  return OK;
+
+errout:
+  ferr("ERROR: Checkpoint write failed: %d\n", ret);
+
+  /* Make sure that the old copy is not used with an incomplete journal */
+
+  smart_cpinvalidate(dev);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cpsync
+ *
+ * Description: Writes a new checkpoint if the active one is stale or if
+ *              its journal is getting full.  Called when an operation that
+ *              modified the FLASH has completed.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+static void smart_cpsync(FAR struct smart_struct_s *dev)
+{
+  if (dev->cpblocks > 0 &&
+      (!dev->cpvalid || dev->cpnext >= (dev->cpnentries * 3) / 4))
+    {
+      (void)smart_cpwrite(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cpreserve
+ *
+ * Description: Reserves erase blocks at the end of the device for two
+ *              copies of the sector map checkpoint.  The size is based on
+ *              the configured sector size; a volume formatted with smaller
+ *              sectors may not fit and is then always scanned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cpreserve(FAR struct smart_struct_s *dev)
+{
+  uint32_t nsectors;
+  uint32_t size;
+  uint32_t nblocks;
+
+  if (dev->geo.erasesize == 0)
+    {
+      return OK;
+    }
+
+  nsectors = dev->geo.erasesize / CONFIG_MTD_SMART_SECTOR_SIZE *
+             dev->geo.neraseblocks;
+  if (nsectors > 65536)
+    {
+      nsectors = 65536;
+    }
+
+  size = sizeof(struct smart_cphdr_s) + (nsectors << 1) +
+         ((uint32_t)dev->geo.neraseblocks << 1) +
+         CONFIG_MTD_SMART_SECTOR_SIZE +
+         (CONFIG_MTD_SMART_JOURNAL_ENTRIES << 1);
+  nblocks = (size + dev->geo.erasesize - 1) / dev->geo.erasesize;
+
+  if ((nblocks << 1) > (dev->geo.neraseblocks >> 2))
+    {
+      fwarn("WARNING: Device too small for a sector map checkpoint\n");
+      return OK;
+    }
+
+  dev->geo.neraseblocks -= nblocks << 1;
+  dev->cpblocks = nblocks;
+  dev->cpcopy   = 1;
+
+  dev->cpjournaled = (FAR uint8_t *)smart_zalloc(dev,
+    (dev->geo.neraseblocks + 7) >> 3, "Journal map");
+  dev->cpbuffer = (FAR uint8_t *)smart_malloc(dev, dev->geo.blocksize,
+    "Journal buffer");
+  if (dev->cpjournaled == NULL || dev->cpbuffer == NULL)
+    {
+      ferr("ERROR: Error allocating checkpoint buffers\n");
+      return -ENOMEM;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1824,20 +2337,17 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 #endif
 
 /****************************************************************************
- * Name: smart_scan
+ * Name: smart_scansector
  *
- * Description: Performs a scan of the MTD device searching for format
- *              information and fills in logical sector mapping, freesector
- *              count, etc.
+ * Description:  Reads the header of one physical sector during a scan of
+ *               the device and updates the free and release counts and the
+ *               logical to physical sector map accordingly.
  *
  ****************************************************************************/
 
-static int smart_scan(FAR struct smart_struct_s *dev)
+static int smart_scansector(FAR struct smart_struct_s *dev, int sector)
 {
-  int       sector;
   int       ret;
-  uint16_t  totalsectors;
-  uint16_t  sectorsize, prerelease;
   uint16_t  logicalsector;
   uint16_t  loser;
   uint32_t  readaddress;
@@ -1854,452 +2364,730 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   char      devname[22];
   FAR struct smart_multiroot_device_s *rootdirdev;
 #endif
-  static const short sizetbl[8] =
-  {
-    CONFIG_MTD_SMART_SECTOR_SIZE,
-    512, 1024, 4096, 2048, 8192, 16384, 32768
-  };
 
-  finfo("Entry\n");
+  finfo("Scan sector %d\n", sector);
 
-  /* Find the sector size on the volume by reading headers from
-   * sectors of decreasing size.  On a formatted volume, the sector
-   * size is saved in the header status byte of seach sector, so
-   * by starting with the largest supported sector size and
-   * decreasing from there, we will be sure to find data that is
-   * a header and not sector data.
+  /* Calculate the read address for this sector */
+
+  readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+
+  /* Read the header for this sector */
+
+  ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                 (FAR uint8_t *) &header);
+  if (ret != sizeof(struct smart_sect_header_s))
+    {
+      return -EIO;
+    }
+
+  /* Get the logical sector number for this physical sector */
+
+  logicalsector = *((FAR uint16_t *) header.logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+  if (logicalsector == 0)
+    {
+      logicalsector = -1;
+    }
+#endif
+
+  /* Test if this sector has been committed */
+
+  if ((header.status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+    {
+      return OK;
+    }
+
+  /* This block is commited, therefore not free.  Update the
+   * erase block's freecount.
    */
 
-  sectorsize = 0xffff;
-  offset = 16384;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  smart_add_count(dev, dev->freecount, sector / dev->sectorsPerBlk, -1);
+#else
+  dev->freecount[sector / dev->sectorsPerBlk]--;
+#endif
+  dev->freesectors--;
 
-  while (sectorsize == 0xffff)
+  /* Test if this sector has been release and if it has,
+   * update the erase block's releasecount.
+   */
+
+  if ((header.status & SMART_STATUS_RELEASED) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
     {
-      readaddress = 0;
+      /* Keep track of the total number of released sectors and
+       * released sectors per erase block.
+       */
 
-      while (readaddress < dev->erasesize * dev->geo.neraseblocks)
-        {
-          /* Read the next sector from the device */
+      dev->releasesectors++;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
+#else
+      dev->releasecount[sector / dev->sectorsPerBlk]++;
+#endif
+      return OK;
+    }
 
-          ret = MTD_READ(dev->mtd, 0, sizeof(struct smart_sect_header_s),
-                         (FAR uint8_t *) &header);
-          if (ret != sizeof(struct smart_sect_header_s))
-            {
-              goto err_out;
-            }
+  if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+    {
+      return OK;
+    }
 
-          if (header.status != CONFIG_SMARTFS_ERASEDSTATE)
-            {
-              sectorsize = sizetbl[(header.status & SMART_STATUS_SIZEBITS) >> 2];
-              break;
-            }
+  /* Validate the logical sector number is in bounds */
 
-          readaddress += offset;
-        }
+  if (logicalsector >= dev->totalsectors)
+    {
+      /* Error in logical sector read from the MTD device */
 
-      if (sectorsize == 0xffff)
+      ferr("ERROR: Invalid logical sector %d at physical %d.\n",
+           logicalsector, sector);
+      return OK;
+    }
+
+  /* If this is logical sector zero, then read in the signature
+   * information to validate the format signature.
+   */
+
+  if (logicalsector == 0)
+    {
+      /* Read the sector data */
+
+      ret = MTD_READ(dev->mtd, readaddress, 32,
+                     (FAR uint8_t *)dev->rwbuffer);
+      if (ret != 32)
         {
-          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
+          ferr("ERROR: Error reading physical sector %d.\n", sector);
+          return -EIO;
         }
 
-      offset >>= 1;
-      if (offset < 256 && sectorsize == 0xffff)
+      /* Validate the format signature */
+
+      if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
+          dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
+          dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
+          dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
         {
-          /* No valid sectors found on device.  Default the
-           * sector size to the CONFIG value
+          /* Invalid signature on a sector claiming to be sector 0!
+           * What should we do?  Release it?
            */
 
-          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
+          return OK;
         }
-    }
 
-  /* Now set the sectorsize and other sectorsize derived variables */
+      /* Mark the volume as formatted and set the sector size */
 
-  ret = smart_setsectorsize(dev, sectorsize);
-  if (ret != OK)
-    {
-      goto err_out;
-    }
+      dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+      dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
+      dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
 
-  /* Initialize the device variables */
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+      dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
 
-  totalsectors        = dev->totalsectors;
-  dev->formatstatus   = SMART_FMT_STAT_NOFMT;
-  dev->freesectors    = dev->availSectPerBlk * dev->geo.neraseblocks;
-  dev->releasesectors = 0;
+      /* If rootdirentries is greater than 1, then we need to register
+       * additional block devices.
+       */
 
-  /* Initialize the freecount and releasecount arrays */
+      for (x = 1; x < dev->rootdirentries; x++)
+        {
+          if (dev->partname[0] != '\0')
+            {
+              snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
+                      dev->minor, dev->partname, x+1);
+            }
+          else
+            {
+              snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
+                       x + 1);
+            }
 
-  for (sector = 0; sector < dev->neraseblocks; sector++)
+          /* Inode private data is a reference to a struct containing
+           * the SMART device structure and the root directory number.
+           */
+
+          rootdirdev = (struct smart_multiroot_device_s *)
+            smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
+          if (rootdirdev == NULL)
+            {
+              ferr("ERROR: Memory alloc failed\n");
+              return -ENOMEM;
+            }
+
+          /* Populate the rootdirdev */
+
+          rootdirdev->dev = dev;
+          rootdirdev->rootdirnum = x;
+          ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+
+          /* Inode private data is a reference to the SMART device structure */
+
+          ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+        }
+#endif
+    }
+
+  /* Test for duplicate logical sectors on the device */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  if (dev->sMap[logicalsector] != 0xffff)
+#else
+  if (dev->sBitMap[logicalsector >> 3] & (1 << (logicalsector & 0x07)))
+#endif
     {
-      if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+      /* Uh-oh, we found more than 1 physical sector claiming to be
+       * the same logical sector.  Use the sequence number information
+       * to resolve who wins.
+       */
+
+#if SMART_STATUS_VERSION == 1
+      if (header.status & SMART_STATUS_CRC)
         {
-          prerelease = 2;
+          seq2 = header.seq;
         }
       else
         {
-          prerelease = 0;
+          seq2 = *((FAR uint16_t *) &header.seq);
         }
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-      smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
-      smart_set_count(dev, dev->releasecount, sector, prerelease);
 #else
-      dev->freecount[sector] = dev->availSectPerBlk - prerelease;
-      dev->releasecount[sector] = prerelease;
+      seq2 = header.seq;
 #endif
-    }
 
-  /* Initialize the sector map */
+      /* We must re-read the 1st physical sector to get it's seq number */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-  for (sector = 0; sector < totalsectors; sector++)
-    {
-      dev->sMap[sector] = -1;
-    }
+      readaddress = dev->sMap[logicalsector]  * dev->mtdBlksPerSector * dev->geo.blocksize;
 #else
-  /* Clear all logical sector used bits */
+      /* For minimize RAM, we have to rescan to find the 1st sector claiming to
+       * be this logical sector.
+       */
 
-  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+      for (dupsector = 0; dupsector < sector; dupsector++)
+        {
+          /* Calculate the read address for this sector */
+
+          readaddress = dupsector * dev->mtdBlksPerSector * dev->geo.blocksize;
+
+          /* Read the header for this sector */
+
+          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                         (FAR uint8_t *) &header);
+          if (ret != sizeof(struct smart_sect_header_s))
+            {
+              return -EIO;
+            }
+
+          /* Get the logical sector number for this physical sector */
+
+          duplogsector = *((FAR uint16_t *) header.logicalsector);
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+          if (duplogsector == 0)
+            {
+              duplogsector = -1;
+            }
 #endif
 
-  /* Now scan the MTD device */
+          /* Test if this sector has been committed */
 
-  for (sector = 0; sector < totalsectors; sector++)
-    {
-      finfo("Scan sector %d\n", sector);
+          if ((header.status & SMART_STATUS_COMMITTED) ==
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+            {
+              continue;
+            }
 
-      /* Calculate the read address for this sector */
+          /* Test if this sector has been release and skip it if it has */
 
-      readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+          if ((header.status & SMART_STATUS_RELEASED) !=
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+            {
+              continue;
+            }
 
-      /* Read the header for this sector */
+          if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+            {
+              continue;
+            }
+
+          /* Now compare if this logical sector matches the current sector */
+
+          if (duplogsector == logicalsector)
+            {
+              break;
+            }
+        }
+#endif
 
       ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                     (FAR uint8_t *) &header);
+              (FAR uint8_t *) &header);
       if (ret != sizeof(struct smart_sect_header_s))
         {
-          goto err_out;
+          return -EIO;
         }
 
-      /* Get the logical sector number for this physical sector */
-
-      logicalsector = *((FAR uint16_t *) header.logicalsector);
-#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-      if (logicalsector == 0)
+#if SMART_STATUS_VERSION == 1
+      if (header.status & SMART_STATUS_CRC)
         {
-          logicalsector = -1;
+          seq1 = header.seq;
         }
-#endif
-
-      /* Test if this sector has been committed */
-
-      if ((header.status & SMART_STATUS_COMMITTED) ==
-              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+      else
         {
-          continue;
+          seq1 = *((FAR uint16_t *) &header.seq);
         }
-
-      /* This block is commited, therefore not free.  Update the
-       * erase block's freecount.
-       */
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-      smart_add_count(dev, dev->freecount, sector / dev->sectorsPerBlk, -1);
 #else
-      dev->freecount[sector / dev->sectorsPerBlk]--;
+      seq1 = header.seq;
 #endif
-      dev->freesectors--;
 
-      /* Test if this sector has been release and if it has,
-       * update the erase block's releasecount.
-       */
+      /* Now determine who wins */
 
-      if ((header.status & SMART_STATUS_RELEASED) !=
-              (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+      if ((seq1 > 0xfff0 && seq2 < 10) || seq2 > seq1)
         {
-          /* Keep track of the total number of released sectors and
-           * released sectors per erase block.
-           */
+          /* Seq 2 is the winner ... bigger or it wrapped */
 
-          dev->releasesectors++;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+          loser = dev->sMap[logicalsector];
+          dev->sMap[logicalsector] = sector;
 #else
-          dev->releasecount[sector / dev->sectorsPerBlk]++;
+          loser = dupsector;
 #endif
-          continue;
         }
-
-      if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+      else
         {
-          continue;
+          /* We keep the original mapping and seq2 is the loser */
+
+          loser = sector;
         }
 
-      /* Validate the logical sector number is in bounds */
+      /* Now release the loser sector */
 
-      if (logicalsector >= totalsectors)
+      readaddress = loser  * dev->mtdBlksPerSector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+              (FAR uint8_t *) &header);
+      if (ret != sizeof(struct smart_sect_header_s))
         {
-          /* Error in logical sector read from the MTD device */
+          return -EIO;
+        }
 
-          ferr("ERROR: Invalid logical sector %d at physical %d.\n",
-               logicalsector, sector);
-          continue;
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xff
+      header.status &= ~SMART_STATUS_RELEASED;
+#else
+      header.status |= SMART_STATUS_RELEASED;
+#endif
+      offset = readaddress + offsetof(struct smart_sect_header_s, status);
+      ret = smart_bytewrite(dev, offset, 1, &header.status);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error %d releasing duplicate sector\n", -ret);
+          return ret;
         }
+    }
 
-      /* If this is logical sector zero, then read in the signature
-       * information to validate the format signature.
-       */
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  /* Update the logical to physical sector map */
+
+  dev->sMap[logicalsector] = sector;
+#else
+  /* Mark the logical sector as used in the bitmap */
+
+  dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
 
-      if (logicalsector == 0)
+  if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
+    {
+      smart_add_sector_to_cache(dev, logicalsector, sector, __LINE__);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_cprescan
+ *
+ * Description: Re-scans one erase block that was modified after the
+ *              checkpoint was written, replacing what the checkpoint said
+ *              about its sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cprescan(FAR struct smart_struct_s *dev, uint16_t block)
+{
+  uint16_t prerelease;
+  uint32_t start;
+  uint32_t end;
+  uint32_t x;
+  int      ret;
+
+  start = (uint32_t)block * dev->sectorsPerBlk;
+  end   = start + dev->sectorsPerBlk;
+  if (end > dev->totalsectors)
+    {
+      end = dev->totalsectors;
+    }
+
+  /* Forget the logical sectors the checkpoint placed in this block */
+
+  for (x = 0; x < dev->totalsectors; x++)
+    {
+      if (dev->sMap[x] >= start && dev->sMap[x] < end)
         {
-          /* Read the sector data */
+          dev->sMap[x] = 0xffff;
+        }
+    }
 
-          ret = MTD_READ(dev->mtd, readaddress, 32,
-                         (FAR uint8_t *)dev->rwbuffer);
-          if (ret != 32)
-            {
-              ferr("ERROR: Error reading physical sector %d.\n", sector);
-              goto err_out;
-            }
+  prerelease = 0;
+  if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+    {
+      prerelease = 2;
+    }
 
-          /* Validate the format signature */
+  dev->freecount[block]    = dev->availSectPerBlk - prerelease;
+  dev->releasecount[block] = prerelease;
 
-          if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
-              dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
-              dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
-              dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
-            {
-              /* Invalid signature on a sector claiming to be sector 0!
-               * What should we do?  Release it?
-               */
+  for (x = start; x < end; x++)
+    {
+      ret = smart_scansector(dev, x);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
 
-              continue;
-            }
+  return OK;
+}
+#endif
 
-          /* Mark the volume as formatted and set the sector size */
+/****************************************************************************
+ * Name: smart_cpload
+ *
+ * Description: Loads the sector map, the free and release counts and the
+ *              format information from the newest complete checkpoint copy
+ *              and then re-scans the erase blocks listed in its journal.
+ *              Returns a negated errno if a full scan is needed instead.
+ *
+ ****************************************************************************/
 
-          dev->formatstatus = SMART_FMT_STAT_FORMATTED;
-          dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
-          dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_cpload(FAR struct smart_struct_s *dev)
+{
+  struct smart_cphdr_s hdr[2];
+  FAR uint8_t *payload;
+  FAR uint16_t *entries;
+  uint32_t address;
+  uint32_t perblock;
+  uint32_t crc;
+  uint32_t n;
+  size_t   paylen;
+  bool     valid[2];
+  uint16_t block;
+  uint8_t  copy;
+  int      i;
+  int      ret;
+
+  dev->cpvalid = false;
+
+  ret = smart_cplayout(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-          dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
+  for (copy = 0; copy < 2; copy++)
+    {
+      ret = MTD_READ(dev->mtd, smart_cpaddress(dev, copy), sizeof(hdr[0]),
+                     (FAR uint8_t *)&hdr[copy]);
+      valid[copy] = ret == sizeof(hdr[0]) &&
+                    memcmp(hdr[copy].magic, SMART_CP_MAGIC,
+                           sizeof(hdr[0].magic)) == 0;
+      if (valid[copy] && hdr[copy].seq > dev->cpseq)
+        {
+          dev->cpseq = hdr[copy].seq;
+        }
+    }
 
-          /* If rootdirentries is greater than 1, then we need to register
-           * additional block devices.
-           */
+  /* Use the newest copy that is complete.  An older copy is only used if
+   * the newer one was interrupted while being written:  Nothing was
+   * modified after that started.
+   */
 
-          for (x = 1; x < dev->rootdirentries; x++)
-            {
-              if (dev->partname[0] != '\0')
-                {
-                  snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
-                          dev->minor, dev->partname, x+1);
-                }
-              else
-                {
-                  snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
-                           x + 1);
-                }
+  copy = (valid[1] && (!valid[0] || hdr[1].seq > hdr[0].seq)) ? 1 : 0;
+  dev->cpcopy = copy;
 
-              /* Inode private data is a reference to a struct containing
-               * the SMART device structure and the root directory number.
-               */
+  payload = (FAR uint8_t *)dev->sMap;
+  paylen  = smart_cppaylen(dev);
 
-              rootdirdev = (struct smart_multiroot_device_s *)
-                smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
-              if (rootdirdev == NULL)
-                {
-                  ferr("ERROR: Memory alloc failed\n");
-                  ret = -ENOMEM;
-                  goto err_out;
-                }
+  for (i = 0; i < 2; i++, copy ^= 1)
+    {
+      if (!valid[copy])
+        {
+          continue;
+        }
+
+      ret = MTD_READ(dev->mtd, smart_cpaddress(dev, copy) + sizeof(hdr[0]),
+                     paylen, payload);
+      if (ret != paylen)
+        {
+          continue;
+        }
+
+      crc = hdr[copy].crc;
+      hdr[copy].crc = 0;
+      if (crc32part(payload, paylen,
+                    crc32((FAR const uint8_t *)&hdr[copy],
+                          sizeof(hdr[0]))) == crc)
+        {
+          break;
+        }
+    }
 
-              /* Populate the rootdirdev */
+  if (i >= 2 || hdr[copy].sectorsize != dev->sectorsize ||
+      hdr[copy].totalsectors != dev->totalsectors ||
+      hdr[copy].neraseblocks != dev->neraseblocks)
+    {
+      finfo("No usable checkpoint\n");
+      return -ENOENT;
+    }
 
-              rootdirdev->dev = dev;
-              rootdirdev->rootdirnum = x;
-              ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+  /* Read the journal */
 
-              /* Inode private data is a reference to the SMART device structure */
+  memset(dev->cpjournaled, 0, (dev->neraseblocks + 7) >> 3);
+  address  = smart_cpaddress(dev, copy) + dev->cpjstart;
+  perblock = dev->geo.blocksize >> 1;
+  entries  = (FAR uint16_t *)dev->cpbuffer;
 
-              ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+  for (n = 0; n < dev->cpnentries; n++)
+    {
+      if ((n % perblock) == 0)
+        {
+          ret = MTD_READ(dev->mtd, address + (n << 1), dev->geo.blocksize,
+                         dev->cpbuffer);
+          if (ret != dev->geo.blocksize)
+            {
+              return -EIO;
             }
-#endif
         }
 
-      /* Test for duplicate logical sectors on the device */
+      if (entries[n % perblock] == SMART_CP_ERASED)
+        {
+          break;
+        }
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-      if (dev->sMap[logicalsector] != 0xffff)
-#else
-      if (dev->sBitMap[logicalsector >> 3] & (1 << (logicalsector & 0x07)))
-#endif
+      if (entries[n % perblock] == SMART_CP_OVERFLOW)
         {
-          /* Uh-oh, we found more than 1 physical sector claiming to be
-           * the same logical sector.  Use the sequence number information
-           * to resolve who wins.
-           */
+          finfo("Checkpoint journal overflowed\n");
+          return -ENOENT;
+        }
+
+      block = entries[n % perblock] - 1;
+      if (block < dev->neraseblocks)
+        {
+          dev->cpjournaled[block >> 3] |= 1 << (block & 0x07);
+        }
+    }
+
+  if (n >= dev->cpnentries)
+    {
+      return -ENOENT;
+    }
 
-#if SMART_STATUS_VERSION == 1
-          if (header.status & SMART_STATUS_CRC)
-            {
-              seq2 = header.seq;
-            }
-          else
-            {
-              seq2 = *((FAR uint16_t *) &header.seq);
-            }
-#else
-          seq2 = header.seq;
-#endif
+  dev->cpcopy        = copy;
+  dev->cpnext        = n;
+  dev->cpvalid       = true;
+  dev->formatstatus  = hdr[copy].formatstatus;
+  dev->formatversion = hdr[copy].formatversion;
+  dev->namesize      = hdr[copy].namesize;
 
-          /* We must re-read the 1st physical sector to get it's seq number */
+  finfo("Checkpoint %lu, %lu journal entries\n",
+        (unsigned long)hdr[copy].seq, (unsigned long)n);
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-          readaddress = dev->sMap[logicalsector]  * dev->mtdBlksPerSector * dev->geo.blocksize;
-#else
-          /* For minimize RAM, we have to rescan to find the 1st sector claiming to
-           * be this logical sector.
-           */
+  /* Re-scan the erase blocks modified since the checkpoint was written.
+   * Anything modified while doing so is journaled again.
+   */
 
-          for (dupsector = 0; dupsector < sector; dupsector++)
+  for (block = 0; block < dev->neraseblocks; block++)
+    {
+      if ((dev->cpjournaled[block >> 3] & (1 << (block & 0x07))) != 0)
+        {
+          ret = smart_cprescan(dev, block);
+          if (ret < 0)
             {
-              /* Calculate the read address for this sector */
-
-              readaddress = dupsector * dev->mtdBlksPerSector * dev->geo.blocksize;
+              smart_cpinvalidate(dev);
+              return ret;
+            }
+        }
+    }
 
-              /* Read the header for this sector */
+  /* Recalculate the totals from the per erase block counts */
 
-              ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                             (FAR uint8_t *) &header);
-              if (ret != sizeof(struct smart_sect_header_s))
-                {
-                  goto err_out;
-                }
+  dev->freesectors    = 0;
+  dev->releasesectors = 0;
 
-              /* Get the logical sector number for this physical sector */
+  for (block = 0; block < dev->neraseblocks; block++)
+    {
+      dev->freesectors    += dev->freecount[block];
+      dev->releasesectors += dev->releasecount[block];
+    }
 
-              duplogsector = *((FAR uint16_t *) header.logicalsector);
+  if (dev->totalsectors == 65534)
+    {
+      dev->releasesectors -= 2;
+    }
 
-#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-              if (duplogsector == 0)
-                {
-                  duplogsector = -1;
-                }
+  return OK;
+}
 #endif
 
-              /* Test if this sector has been committed */
+/****************************************************************************
+ * Name: smart_scan
+ *
+ * Description: Performs a scan of the MTD device searching for format
+ *              information and fills in logical sector mapping, freesector
+ *              count, etc.
+ *
+ ****************************************************************************/
 
-              if ((header.status & SMART_STATUS_COMMITTED) ==
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
-                {
-                  continue;
-                }
+static int smart_scan(FAR struct smart_struct_s *dev)
+{
+  int       sector;
+  int       ret;
+  uint16_t  totalsectors;
+  uint16_t  sectorsize, prerelease;
+  uint32_t  readaddress;
+  uint32_t  offset;
+  struct    smart_sect_header_s header;
+  static const short sizetbl[8] =
+  {
+    CONFIG_MTD_SMART_SECTOR_SIZE,
+    512, 1024, 4096, 2048, 8192, 16384, 32768
+  };
 
-              /* Test if this sector has been release and skip it if it has */
+  finfo("Entry\n");
 
-              if ((header.status & SMART_STATUS_RELEASED) !=
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
-                {
-                  continue;
-                }
+  /* Find the sector size on the volume by reading headers from
+   * sectors of decreasing size.  On a formatted volume, the sector
+   * size is saved in the header status byte of seach sector, so
+   * by starting with the largest supported sector size and
+   * decreasing from there, we will be sure to find data that is
+   * a header and not sector data.
+   */
 
-              if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
-                {
-                  continue;
-                }
+  sectorsize = 0xffff;
+  offset = 16384;
 
-              /* Now compare if this logical sector matches the current sector */
+  while (sectorsize == 0xffff)
+    {
+      readaddress = 0;
 
-              if (duplogsector == logicalsector)
-                {
-                  break;
-                }
-            }
-#endif
+      while (readaddress < dev->erasesize * dev->geo.neraseblocks)
+        {
+          /* Read the next sector from the device */
 
-          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                  (FAR uint8_t *) &header);
+          ret = MTD_READ(dev->mtd, 0, sizeof(struct smart_sect_header_s),
+                         (FAR uint8_t *) &header);
           if (ret != sizeof(struct smart_sect_header_s))
             {
               goto err_out;
             }
 
-#if SMART_STATUS_VERSION == 1
-          if (header.status & SMART_STATUS_CRC)
-            {
-              seq1 = header.seq;
-            }
-          else
+          if (header.status != CONFIG_SMARTFS_ERASEDSTATE)
             {
-              seq1 = *((FAR uint16_t *) &header.seq);
+              sectorsize = sizetbl[(header.status & SMART_STATUS_SIZEBITS) >> 2];
+              break;
             }
-#else
-          seq1 = header.seq;
-#endif
 
-          /* Now determine who wins */
+          readaddress += offset;
+        }
+
+      if (sectorsize == 0xffff)
+        {
+          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
+        }
 
-          if ((seq1 > 0xfff0 && seq2 < 10) || seq2 > seq1)
-            {
-              /* Seq 2 is the winner ... bigger or it wrapped */
+      offset >>= 1;
+      if (offset < 256 && sectorsize == 0xffff)
+        {
+          /* No valid sectors found on device.  Default the
+           * sector size to the CONFIG value
+           */
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-              loser = dev->sMap[logicalsector];
-              dev->sMap[logicalsector] = sector;
-#else
-              loser = dupsector;
+          sectorsize = CONFIG_MTD_SMART_SECTOR_SIZE;
+        }
+    }
+
+  /* Now set the sectorsize and other sectorsize derived variables */
+
+  ret = smart_setsectorsize(dev, sectorsize);
+  if (ret != OK)
+    {
+      goto err_out;
+    }
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* With a usable checkpoint only the erase blocks modified since it was
+   * written need to be scanned.
+   */
+
+  if (smart_cpload(dev) == OK)
+    {
+      goto scan_done;
+    }
 #endif
-            }
-          else
-            {
-              /* We keep the original mapping and seq2 is the loser */
 
-              loser = sector;
-            }
+  /* Initialize the device variables */
 
-          /* Now release the loser sector */
+  totalsectors        = dev->totalsectors;
+  dev->formatstatus   = SMART_FMT_STAT_NOFMT;
+  dev->freesectors    = dev->availSectPerBlk * dev->geo.neraseblocks;
+  dev->releasesectors = 0;
 
-          readaddress = loser  * dev->mtdBlksPerSector * dev->geo.blocksize;
-          ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
-                  (FAR uint8_t *) &header);
-          if (ret != sizeof(struct smart_sect_header_s))
-            {
-              goto err_out;
-            }
+  /* Initialize the freecount and releasecount arrays */
 
-#if CONFIG_SMARTFS_ERASEDSTATE == 0xff
-          header.status &= ~SMART_STATUS_RELEASED;
+  for (sector = 0; sector < dev->neraseblocks; sector++)
+    {
+      if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+        {
+          prerelease = 2;
+        }
+      else
+        {
+          prerelease = 0;
+        }
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
+      smart_set_count(dev, dev->releasecount, sector, prerelease);
 #else
-          header.status |= SMART_STATUS_RELEASED;
+      dev->freecount[sector] = dev->availSectPerBlk - prerelease;
+      dev->releasecount[sector] = prerelease;
 #endif
-          offset = readaddress + offsetof(struct smart_sect_header_s, status);
-          ret = smart_bytewrite(dev, offset, 1, &header.status);
-          if (ret < 0)
-            {
-              ferr("ERROR: Error %d releasing duplicate sector\n", -ret);
-              goto err_out;
-            }
-        }
+    }
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-      /* Update the logical to physical sector map */
+  /* Initialize the sector map */
 
-      dev->sMap[logicalsector] = sector;
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  for (sector = 0; sector < totalsectors; sector++)
+    {
+      dev->sMap[sector] = -1;
+    }
 #else
-      /* Mark the logical sector as used in the bitmap */
+  /* Clear all logical sector used bits */
+
+  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#endif
 
-      dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
+  /* Now scan the MTD device */
 
-      if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
+  for (sector = 0; sector < totalsectors; sector++)
+    {
+      ret = smart_scansector(dev, sector);
+      if (ret < 0)
         {
-          smart_add_sector_to_cache(dev, logicalsector, sector, __LINE__);
+          goto err_out;
         }
-#endif
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
 #if defined (CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -2397,6 +3185,15 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       goto err_out;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Checkpoint the map if it had to be rebuilt by a full scan */
+
+  if (!dev->cpvalid)
+    {
+      (void)smart_cpwrite(dev);
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   finfo("   Allocations:\n");
   for (sector = 0; sector < SMART_MAX_ALLOCS; sector++)
@@ -2519,6 +3316,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
       dev->unusedsectors += freecount;
       dev->blockerases++;
 #endif
+      smart_journal(dev, block);
       MTD_ERASE(dev->mtd, block, 1);
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
@@ -2934,8 +3732,11 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
       return -EINVAL;
     }
 
-  /* Erase the MTD device */
+  /* Erase the MTD device.  This also erases any sector map checkpoint, a
+   * new one is written when the format completes.
+   */
 
+  smart_cpinvalidate(dev);
   ret = MTD_IOCTL(dev->mtd, MTDIOC_BULKERASE, 0);
   if (ret < 0)
     {
@@ -3115,6 +3916,7 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
   int         ret;
 
   header = (FAR struct smart_sect_header_s *) dev->rwbuffer;
+  smart_journal(dev, newsector / dev->sectorsPerBlk);
 
   /* Increment the sequence number and clear the "commit" flag */
 
@@ -3398,6 +4200,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 
   /* Now erase the erase block */
 
+  smart_journal(dev, block);
   MTD_ERASE(dev->mtd, block, 1);
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors += freecount;
@@ -3766,7 +4569,22 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
       if (dev->releasesectors > dev->freesectors && dev->freesectors <
           (dev->totalsectors >> 5))
         {
-          collect = TRUE;
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+          /* This is not urgent.  Leave it to the worker. */
+
+          if (!dev->gcworker)
+            {
+              if (work_available(&dev->gcwork))
+                {
+                  (void)work_queue(LPWORK, &dev->gcwork, smart_gcworker, dev,
+                                   MSEC2TICK(CONFIG_MTD_SMART_GC_DELAY));
+                }
+            }
+          else
+#endif
+            {
+              collect = TRUE;
+            }
         }
 
       /* Test if we have more reached our reserved free sector limit */
@@ -3976,6 +4794,45 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_gcworker
+ *
+ * Description:  Performs deferred garbage collection on the low priority
+ *               work queue.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_MTD_SMART_BACKGROUND_GC)
+static void smart_gcworker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  int ret;
+
+  smart_lock(dev);
+
+  dev->gcworker = true;
+  ret = smart_garbagecollect(dev);
+  dev->gcworker = false;
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Garbage collection failed: %d\n", ret);
+    }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  smart_cpsync(dev);
+  smart_unlock(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_read_wearstatus
  *
@@ -4186,6 +5043,7 @@ static int smart_write_alloc_sector(FAR struct smart_struct_s *dev,
 
 #ifndef CONFIG_MTD_SMART_ENABLE_CRC
   finfo("Write MTD block %d\n", physical * dev->mtdBlksPerSector);
+  smart_journal(dev, physical / dev->sectorsPerBlk);
   ret = MTD_BWRITE(dev->mtd, physical * dev->mtdBlksPerSector, 1,
       (FAR uint8_t *) dev->rwbuffer);
   if (ret != 1)
@@ -4536,6 +5394,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
     {
       /* Write the entire sector to the new physical location, uncommitted. */
 
+      smart_journal(dev, physsector / dev->sectorsPerBlk);
       ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdBlksPerSector,
               dev->mtdBlksPerSector, (FAR uint8_t *) dev->rwbuffer);
       if (ret != dev->mtdBlksPerSector)
@@ -4620,6 +5479,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
       /* Write the entire sector to FLASH when CRC enabled */
 
+      smart_journal(dev, physsector / dev->sectorsPerBlk);
       ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdBlksPerSector,
               dev->mtdBlksPerSector, (FAR uint8_t *) dev->rwbuffer);
       if (ret != dev->mtdBlksPerSector)
@@ -5194,6 +6054,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_lock(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5210,7 +6072,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5243,6 +6106,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Perform a low-level format on the flash */
 
       ret = smart_llformat(dev, arg);
+      smart_cpsync(dev);
       goto ok_out;
 
     case BIOC_ALLOCSECT:
@@ -5257,6 +6121,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Allocate a logical sector for the upper layer file system */
 
       ret = smart_allocsector(dev, arg);
+      smart_cpsync(dev);
       goto ok_out;
 
     case BIOC_FREESECT:
@@ -5264,6 +6129,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Free the specified logical sector */
 
       ret = smart_freesector(dev, arg);
+      smart_cpsync(dev);
       goto ok_out;
 
     case BIOC_WRITESECT:
@@ -5281,6 +6147,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+      smart_cpsync(dev);
       goto ok_out;
 #endif /* CONFIG_FS_WRITABLE */
 
@@ -5352,6 +6219,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -5414,6 +6282,20 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+      nxsem_init(&dev->exclsem, 0, 1);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve erase blocks at the end of the device for the checkpoint */
+
+      ret = smart_cpreserve(dev);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -5541,6 +6423,13 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_free(dev, dev->cpjournaled);
+  smart_free(dev, dev->cpbuffer);
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  nxsem_destroy(&dev->exclsem);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
@@ -5662,6 +6551,12 @@ static int smart_loteardown(FAR const char *devname)
 
   close_blockdriver(inode);
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  /* Make sure that no garbage collection is pending */
+
+  (void)work_cancel(LPWORK, &dev->gcwork);
+#endif
+
   /* Now teardown the filemtd */
 
   filemtd_teardown(dev->mtd);
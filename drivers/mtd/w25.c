@@ -51,6 +51,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -96,6 +97,8 @@
 #define W25_PURDID                 0xab    /* Release PD, Device ID                 */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device            */
 #define W25_JEDEC_ID               0x9f    /* JEDEC ID read                         */
+#define W25_EPS                    0x75    /* Erase/program suspend (W25Q)          */
+#define W25_EPR                    0x7a    /* Erase/program resume (W25Q)           */
 
 /* W25 Registers ********************************************************************/
 /* Read ID (RDID) register values */
@@ -178,6 +181,12 @@
 
 #define W25_DUMMY                  0xa5
 
+/* Erase suspend latency (tSUS).  This is also the minimum time allowed between
+ * an erase resume and the next erase suspend.
+ */
+
+#define W25_TSUS_USEC              20
+
 /* Chip Geometries ******************************************************************/
 /* All members of the family support uniform 4K-byte sectors and 256 byte pages */
 
@@ -226,6 +235,10 @@ struct w25_dev_s
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool                  cansuspend;  /* Device supports erase suspend/resume */
+  off_t                 eaddress;    /* Address of the last sector erased */
+#endif
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -246,7 +259,13 @@ static inline int w25_readid(FAR struct w25_dev_s *priv);
 #ifndef CONFIG_W25_READONLY
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv);
 static uint8_t w25_waitwritecomplete(FAR struct w25_dev_s *priv);
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes);
+static void w25_eraseresume(FAR struct w25_dev_s *priv);
+#endif
 static inline void w25_wren(FAR struct w25_dev_s *priv);
 static inline void w25_wrdi(FAR struct w25_dev_s *priv);
 static bool w25_is_erased(struct w25_dev_s *priv, off_t address, off_t size);
@@ -373,6 +392,12 @@ static inline int w25_readid(struct w25_dev_s *priv)
        memory == W25Q_JEDEC_MEMORY_TYPE_B ||
        memory == W25Q_JEDEC_MEMORY_TYPE_C))
     {
+#ifdef CONFIG_W25_ERASE_SUSPEND
+      /* Only the W25Q parts support erase suspend/resume */
+
+      priv->cansuspend = (memory != W25X_JEDEC_MEMORY_TYPE);
+#endif
+
       /* Okay.. is it a FLASH capacity that we understand? If so, save
        * the FLASH capacity.
        */
@@ -480,6 +505,32 @@ static void w25_unprotect(FAR struct w25_dev_s *priv)
 }
 #endif
 
+/************************************************************************************
+ * Name: w25_rdsr
+ ************************************************************************************/
+
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv)
+{
+  uint8_t status;
+
+  /* Select this FLASH part */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+
+  /* Send "Read Status Register (RDSR)" command */
+
+  (void)SPI_SEND(priv->spi, W25_RDSR);
+
+  /* Send a dummy byte to generate the clock needed to shift out the status */
+
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+
+  /* Deselect the FLASH */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  return status;
+}
+
 /************************************************************************************
  * Name: w25_waitwritecomplete
  ************************************************************************************/
@@ -496,21 +547,7 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
 
   do
     {
-      /* Select this FLASH part */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
-
-      /* Send "Read Status Register (RDSR)" command */
-
-      (void)SPI_SEND(priv->spi, W25_RDSR);
-
-      /* Send a dummy byte to generate the clock needed to shift out the status */
-
-      status = SPI_SEND(priv->spi, W25_DUMMY);
-
-      /* Deselect the FLASH */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+      status = w25_rdsr(priv);
 
       /* Given that writing could take up to few tens of milliseconds, and erasing
        * could take more.  The following short delay in the "busy" case will allow
@@ -531,6 +568,73 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
   return status;
 }
 
+/************************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   If a sector erase is in progress, suspend it so that the FLASH can be read
+ *   without waiting for the erase to complete (which may take hundreds of
+ *   milliseconds).  The sector being erased itself cannot be read.  Returns true
+ *   if the erase was suspended; w25_eraseresume() must then be called after the
+ *   read.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes)
+{
+  if (!priv->cansuspend || priv->prev_instr != W25_SE ||
+      (address < priv->eaddress + W25_SECTOR_SIZE &&
+       address + (off_t)nbytes > priv->eaddress))
+    {
+      return false;
+    }
+
+  /* Is the erase still in progress? */
+
+  if ((w25_rdsr(priv) & W25_SR_BUSY) == 0)
+    {
+      return false;
+    }
+
+  /* Send the "Erase/Program Suspend" instruction */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->spi, W25_EPS);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  priv->prev_instr = W25_EPS;
+
+  /* BUSY clears after at most tSUS.  This is too short to sleep. */
+
+  while ((w25_rdsr(priv) & W25_SR_BUSY) != 0)
+    {
+    }
+
+  return true;
+}
+
+/************************************************************************************
+ * Name: w25_eraseresume
+ ************************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv)
+{
+  /* Send the "Erase/Program Resume" instruction */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->spi, W25_EPR);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* The sector erase is in progress again.  Let it run for at least tSUS so
+   * that back-to-back reads cannot starve it.
+   */
+
+  priv->prev_instr = W25_SE;
+  up_udelay(W25_TSUS_USEC);
+}
+#endif
+
 /************************************************************************************
  * Name:  w25_wren
  ************************************************************************************/
@@ -653,6 +757,9 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   (void)SPI_SEND(priv->spi, W25_SE);
   priv->prev_instr = W25_SE;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  priv->eaddress   = address;
+#endif
 
   /* Send the sector address high byte first. Only the most significant bits (those
    * corresponding to the sector) have any meaning.
@@ -707,17 +814,28 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
   uint8_t status;
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  bool suspended;
+#endif
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  /* Suspend any sector erase in progress rather than waiting for it */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+  suspended = w25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
 
-  w25_wrdi(priv);
+      /* Make sure that writing is disabled */
+
+      w25_wrdi(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -752,6 +870,13 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef CONFIG_W25_ERASE_SUSPEND
+  if (suspended)
+    {
+      w25_eraseresume(priv);
+    }
+#endif
 }
 
 /************************************************************************************
@@ -521,6 +521,16 @@ int localhost_initialize(void)
   priv->lo_dev.d_buf     = g_iobuffer;   /* Attach the IO buffer */
   priv->lo_dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
 
+#ifdef CONFIG_LOOPBACK_NOCHKSUM
+  /* Nothing can corrupt a looped back packet so there is no need to
+   * generate or to verify the IPv4 header, TCP, and UDP checksums.
+   */
+
+  priv->lo_dev.d_txchksum = NETDEV_CHKSUM_IPv4 | NETDEV_CHKSUM_TCP |
+                            NETDEV_CHKSUM_UDP;
+  priv->lo_dev.d_rxchksum = priv->lo_dev.d_txchksum;
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->lo_polldog       = wd_create();  /* Create periodic poll timer */
@@ -99,6 +99,28 @@
 
 #define skeleton_TXTIMEOUT (60*CLK_TCK)
 
+/* The number of TX DMA descriptors that may be chained for one frame when
+ * scatter-gather transmit is used.
+ */
+
+#ifdef CONFIG_NETDEV_SGTX
+#  define skeleton_NTXSEGS 4
+#endif
+
+/* The largest TCP frame accepted with TCP segmentation offload.  This
+ * hardware cannot split such frames itself; netdev_gso() does it.
+ */
+
+#ifdef CONFIG_NETDEV_TSO
+#  define skeleton_TSOMAX  8192
+#endif
+
+/* The size of the buffer for aggregated TCP segments */
+
+#ifdef CONFIG_NETDEV_GRO
+#  define skeleton_GROSIZE 8192
+#endif
+
 /* This is a helper pointer for accessing the contents of the Ethernet header */
 
 #define BUF ((struct eth_hdr_s *)priv->sk_dev.d_buf)
@@ -119,6 +141,17 @@ struct skel_driver_s
   struct work_s sk_irqwork;    /* For deferring interrupt work to the work queue */
   struct work_s sk_pollwork;   /* For deferring poll work to the work queue */
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* The regions of the frame being transmitted */
+
+  struct netdev_txseg_s sk_txsegs[skeleton_NTXSEGS];
+  int sk_ntxsegs;
+#endif
+
+#ifdef CONFIG_NETDEV_RXPOLL
+  struct netdev_rxpoll_s sk_rxpoll; /* Budgeted RX polling */
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s sk_dev;  /* Interface understood by the network */
@@ -146,6 +179,15 @@ struct skel_driver_s
 
 static uint8_t g_pktbuf[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
 
+#ifdef CONFIG_NETDEV_GRO
+/* The buffer for aggregated TCP segments and a buffer for the replies to
+ * them.
+ */
+
+static uint8_t g_grobuf[skeleton_GROSIZE];
+static uint8_t g_grotxbuf[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
+#endif
+
 /* Driver state structure */
 
 static struct skel_driver_s g_skel[CONFIG_skeleton_NINTERFACES];
@@ -157,12 +199,23 @@ static struct skel_driver_s g_skel[CONFIG_skeleton_NINTERFACES];
 /* Common TX logic */
 
 static int  skel_transmit(FAR struct skel_driver_s *priv);
+#ifdef CONFIG_NETDEV_TSO
+static int  skel_gsoxmit(FAR struct net_driver_s *dev);
+#endif
 static int  skel_txpoll(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
 static void skel_reply(struct skel_driver_s *priv)
+static void skel_rxframe(FAR struct skel_driver_s *priv);
 static void skel_receive(FAR struct skel_driver_s *priv);
+#ifdef CONFIG_NETDEV_RXPOLL
+static int  skel_rxpoll(FAR struct net_driver_s *dev, int budget);
+static void skel_rxenable(FAR struct net_driver_s *dev);
+#endif
+#ifdef CONFIG_NETDEV_GRO
+static void skel_groreply(FAR struct net_driver_s *dev);
+#endif
 static void skel_txdone(FAR struct skel_driver_s *priv);
 
 static void skel_interrupt_work(FAR void *arg);
@@ -229,12 +282,41 @@ static int skel_transmit(FAR struct skel_driver_s *priv)
    * must have assured that there is no transmission in progress.
    */
 
+#ifdef CONFIG_NETDEV_TSO
+  /* A large TCP frame must be split into several frames in software.  Each
+   * of them is sent through skel_gsoxmit().  The hardware must have room
+   * for all of them.
+   */
+
+  if (NETDEV_IS_TSO(&priv->sk_dev))
+    {
+      (void)netdev_gso(&priv->sk_dev, skel_gsoxmit);
+      return OK;
+    }
+#endif
+
   /* Increment statistics */
 
   NETDEV_TXPACKETS(priv->sk_dev);
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* Get the regions of the frame.  Part of the frame may be in I/O buffers
+   * rather than in d_buf.  The regions remain valid until they are
+   * released in skel_txdone().
+   */
+
+  priv->sk_ntxsegs = netdev_txsegs(&priv->sk_dev, priv->sk_txsegs);
+
+  /* Send the packet: Set up one TX DMA descriptor for each region,
+   * address=priv->sk_txsegs[i].ts_data, length=priv->sk_txsegs[i].ts_len,
+   * and mark the last descriptor as the end of the frame.
+   */
+
+#else
   /* Send the packet: address=priv->sk_dev.d_buf, length=priv->sk_dev.d_len */
 
+#endif
+
   /* Enable Tx interrupts */
 
   /* Setup the TX timeout watchdog (perhaps restarting the timer) */
@@ -244,6 +326,30 @@ static int skel_transmit(FAR struct skel_driver_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: skel_gsoxmit
+ *
+ * Description:
+ *   Send one segment of a large TCP frame (see netdev_gso()).
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+static int skel_gsoxmit(FAR struct net_driver_s *dev)
+{
+  return skel_transmit((FAR struct skel_driver_s *)dev->d_private);
+}
+#endif
+
 /****************************************************************************
  * Name: skel_txpoll
  *
@@ -381,10 +487,10 @@ static void skel_reply(struct skel_driver_s *priv)
 }
 
 /****************************************************************************
- * Name: skel_receive
+ * Name: skel_rxframe
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Receive one frame from the hardware and pass it to the network
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -397,93 +503,222 @@ static void skel_reply(struct skel_driver_s *priv)
  *
  ****************************************************************************/
 
-static void skel_receive(FAR struct skel_driver_s *priv)
+static void skel_rxframe(FAR struct skel_driver_s *priv)
 {
-  do
-    {
-      /* Check for errors and update statistics */
+  /* Check for errors and update statistics */
 
-      /* Check if the packet is a valid size for the network buffer
-       * configuration.
-       */
+  /* Check if the packet is a valid size for the network buffer
+   * configuration.
+   */
 
-      /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
-       * amount of data in priv->sk_dev.d_len
-       */
+  /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
+   * amount of data in priv->sk_dev.d_len
+   */
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the packet tap */
+  /* When packet sockets are enabled, feed the frame into the packet tap */
 
-       pkt_input(&priv->sk_dev);
+  pkt_input(&priv->sk_dev);
 #endif
 
 #ifdef CONFIG_NET_IPv4
-      /* Check for an IPv4 packet */
+  /* Check for an IPv4 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP))
-        {
-          ninfo("IPv4 frame\n");
-          NETDEV_RXIPV4(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(&priv->sk_dev);
 
-          /* Handle ARP on input, then dispatch IPv4 packet to the network
-           * layer.
-           */
+      /* Handle ARP on input, then dispatch IPv4 packet to the network
+       * layer.
+       */
+
+      arp_ipin(&priv->sk_dev);
 
-          arp_ipin(&priv->sk_dev);
+#ifdef CONFIG_NETDEV_GRO
+      /* Consecutive TCP segments may be aggregated before they are
+       * passed to the network.
+       */
+
+      if (netdev_gro_input(&priv->sk_rxpoll) == 0)
+#endif
+        {
           ipv4_input(&priv->sk_dev);
 
           /* Check for a reply to the IPv4 packet */
 
           skel_reply(priv);
         }
-      else
+    }
+  else
 #endif
 #ifdef CONFIG_NET_IPv6
-      /* Check for an IPv6 packet */
+  /* Check for an IPv6 packet */
 
-      if (BUF->type == HTONS(ETHTYPE_IP6))
-        {
-          ninfo("Iv6 frame\n");
-          NETDEV_RXIPV6(&priv->sk_dev);
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("Iv6 frame\n");
+      NETDEV_RXIPV6(&priv->sk_dev);
 
-          /* Dispatch IPv6 packet to the network layer */
+      /* Dispatch IPv6 packet to the network layer */
 
-          ipv6_input(&priv->sk_dev);
+      ipv6_input(&priv->sk_dev);
 
-          /* Check for a reply to the IPv6 packet */
+      /* Check for a reply to the IPv6 packet */
 
-          skel_reply(priv);
-        }
-      else
+      skel_reply(priv);
+    }
+  else
 #endif
 #ifdef CONFIG_NET_ARP
-      /* Check for an ARP packet */
+  /* Check for an ARP packet */
 
-      if (BUF->type == htons(ETHTYPE_ARP))
-        {
-          /* Dispatch ARP packet to the network layer */
+  if (BUF->type == htons(ETHTYPE_ARP))
+    {
+      /* Dispatch ARP packet to the network layer */
 
-          arp_arpin(&priv->sk_dev);
-          NETDEV_RXARP(&priv->sk_dev);
+      arp_arpin(&priv->sk_dev);
+      NETDEV_RXARP(&priv->sk_dev);
 
-          /* If the above function invocation resulted in data that should be
-           * sent out on the network, the field  d_len will set to a value > 0.
-           */
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, the field  d_len will set to a value > 0.
+       */
 
-          if (priv->sk_dev.d_len > 0)
-            {
-              skel_transmit(priv);
-            }
-        }
-      else
-#endif
+      if (priv->sk_dev.d_len > 0)
         {
-          NETDEV_RXDROPPED(&priv->sk_dev);
+          skel_transmit(priv);
         }
     }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(&priv->sk_dev);
+    }
+}
+
+/****************************************************************************
+ * Name: skel_receive
+ *
+ * Description:
+ *   An interrupt was received indicating the availability of a new RX packet
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void skel_receive(FAR struct skel_driver_s *priv)
+{
+  do
+    {
+      skel_rxframe(priv);
+    }
   while (); /* While there are more packets to be processed */
 }
 
+#ifdef CONFIG_NETDEV_RXPOLL
+/****************************************************************************
+ * Name: skel_rxpoll
+ *
+ * Description:
+ *   Receive up to 'budget' frames (see netdev_rxpoll_schedule())
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   budget - The maximum number of frames to receive
+ *
+ * Returned Value:
+ *   The number of frames received
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int skel_rxpoll(FAR struct net_driver_s *dev, int budget)
+{
+  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)dev->d_private;
+  int npackets;
+
+  for (npackets = 0; npackets < budget; npackets++)
+    {
+      /* Check if there is another packet in the RX ring.  If not, break
+       * out of the loop.
+       */
+
+      skel_rxframe(priv);
+    }
+
+  return npackets;
+}
+
+/****************************************************************************
+ * Name: skel_rxenable
+ *
+ * Description:
+ *   The RX ring is empty.  Unmask the RX interrupt that was masked by
+ *   skel_interrupt().
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void skel_rxenable(FAR struct net_driver_s *dev)
+{
+  /* Unmask the RX interrupt at the hardware */
+}
+#endif
+
+/****************************************************************************
+ * Name: skel_groreply
+ *
+ * Description:
+ *   Send the reply to an aggregated TCP segment.  The reply is in the
+ *   aggregation buffer which this hardware cannot transmit from:  It will
+ *   be reused before the transmission is complete.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static void skel_groreply(FAR struct net_driver_s *dev)
+{
+  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)dev->d_private;
+  uint16_t len = dev->d_len;
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* Only the headers are in d_buf if the data was left in I/O buffers */
+
+  if (dev->d_iob != NULL)
+    {
+      len -= dev->d_sndlen;
+    }
+#endif
+
+  memcpy(g_grotxbuf, dev->d_buf, len);
+  dev->d_buf = g_grotxbuf;
+  skel_reply(priv);
+}
+#endif
+
 /****************************************************************************
  * Name: skel_txdone
  *
@@ -509,6 +744,13 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 
   NETDEV_TXDONE(priv->sk_dev);
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* The hardware is finished with the regions of the frame */
+
+  netdev_txsegs_release(priv->sk_txsegs, priv->sk_ntxsegs);
+  priv->sk_ntxsegs = 0;
+#endif
+
   /* Check if there are pending transmissions */
 
   /* If no further transmissions are pending, then cancel the TX timeout and
@@ -559,9 +801,11 @@ static void skel_interrupt_work(FAR void *arg)
 
   /* Handle interrupts according to status bit settings */
 
+#ifndef CONFIG_NETDEV_RXPOLL
   /* Check if we received an incoming packet, if so, call skel_receive() */
 
   skel_receive(priv);
+#endif
 
   /* Check if a packet transmission just completed.  If so, call skel_txdone.
    * This may disable further Tx interrupts if there are no pending
@@ -608,6 +852,19 @@ static int skel_interrupt(int irq, FAR void *context, FAR void *arg)
 
   up_disable_irq(CONFIG_skeleton_IRQ);
 
+#ifdef CONFIG_NETDEV_RXPOLL
+  /* TODO: Determine if a packet was received */
+
+    {
+      /* Mask the RX interrupt at the hardware and receive the packets on
+       * the worker thread.  The RX interrupt is unmasked in
+       * skel_rxenable() when there are no more packets.
+       */
+
+      netdev_rxpoll_schedule(&priv->sk_rxpoll);
+    }
+#endif
+
   /* TODO: Determine if a TX transfer just completed */
 
     {
@@ -657,6 +914,13 @@ static void skel_txtimeout_work(FAR void *arg)
 
   /* Then reset the hardware */
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* The frame will not be sent.  Release its regions. */
+
+  netdev_txsegs_release(priv->sk_txsegs, priv->sk_ntxsegs);
+  priv->sk_ntxsegs = 0;
+#endif
+
   /* Then poll the network for new XMIT data */
 
   (void)devif_poll(&priv->sk_dev, skel_txpoll);
@@ -864,6 +1128,12 @@ static int skel_ifdown(FAR struct net_driver_s *dev)
   wd_cancel(priv->sk_txpoll);
   wd_cancel(priv->sk_txtimeout);
 
+#ifdef CONFIG_NETDEV_RXPOLL
+  /* Cancel any pending RX polling */
+
+  netdev_rxpoll_cancel(&priv->sk_rxpoll);
+#endif
+
   /* Put the EMAC in its reset, non-operational state.  This should be
    * a known configuration that will guarantee the skel_ifup() always
    * successfully brings the interface back up.
@@ -1179,9 +1449,36 @@ int skel_initialize(int intf)
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
   priv->sk_dev.d_ioctl   = skel_ioctl;    /* Handle network IOCTL commands */
+#endif
+#ifdef CONFIG_NETDEV_SGTX
+  priv->sk_dev.d_sgmax   = skeleton_NTXSEGS; /* TX DMA descriptors per frame */
+#endif
+#ifdef CONFIG_NETDEV_TSO
+  priv->sk_dev.d_tsomax  = skeleton_TSOMAX; /* Largest TCP frame */
+#endif
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Checksums verified and inserted by the hardware */
+
+  priv->sk_dev.d_rxchksum = NETDEV_CHKSUM_IPv4 | NETDEV_CHKSUM_TCP |
+                            NETDEV_CHKSUM_UDP;
+  priv->sk_dev.d_txchksum = NETDEV_CHKSUM_IPv4 | NETDEV_CHKSUM_TCP |
+                            NETDEV_CHKSUM_UDP;
 #endif
   priv->sk_dev.d_private = (FAR void *)g_skel; /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_RXPOLL
+  /* Initialize budgeted RX polling */
+
+  netdev_rxpoll_initialize(&priv->sk_rxpoll, &priv->sk_dev, ETHWORK);
+  priv->sk_rxpoll.rp_poll    = skel_rxpoll;
+  priv->sk_rxpoll.rp_enable  = skel_rxenable;
+#ifdef CONFIG_NETDEV_GRO
+  priv->sk_rxpoll.rp_reply   = skel_groreply;
+  priv->sk_rxpoll.rp_grobuf  = g_grobuf;
+  priv->sk_rxpoll.rp_grosize = skeleton_GROSIZE;
+#endif
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmissions */
 
   priv->sk_txpoll        = wd_create();   /* Create periodic poll timer */
@@ -178,7 +178,8 @@ static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+static inline bool telnet_special(uint8_t ch);
+static void    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
                  int *nwritten);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
@@ -525,19 +526,33 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
   return nread;
 }
 
+/****************************************************************************
+ * Name: telnet_special
+ *
+ * Description:
+ *   Return true if the output character cannot simply be copied to the TX
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static inline bool telnet_special(uint8_t ch)
+{
+  return ch == ISO_nl || ch == ISO_cr || ch == TELNET_IAC;
+}
+
 /****************************************************************************
  * Name: telnet_putchar
  *
  * Description:
- *   Put another character from the user buffer to the TX buffer.
+ *   Put a special character from the user buffer to the TX buffer.  At
+ *   most three bytes are added.
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+static void telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
                            int *nread)
 {
   register int index;
-  bool ret = false;
 
   /* Ignore carriage returns (we will put these in automatically as necesary) */
 
@@ -556,16 +571,17 @@ static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 
           priv->td_txbuffer[index++] = ISO_cr;
           priv->td_txbuffer[index++] = '\0';
+        }
 
-          /* End of line */
+      /* A data byte of 255 must be doubled so it is not taken as IAC */
 
-          ret = true;
+      else if (ch == TELNET_IAC)
+        {
+          priv->td_txbuffer[index++] = TELNET_IAC;
         }
 
       *nread = index;
     }
-
-  return ret;
 }
 
 /****************************************************************************
@@ -838,33 +854,57 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
-  ssize_t nsent;
+  size_t remaining = len;
+  size_t nrun;
+  size_t space;
   ssize_t ret;
-  int ncopied;
-  char ch;
-  bool eol;
+  int ncopied = 0;
 
   ninfo("len: %d\n", len);
 
-  /* Process each character from the user buffer */
+  /* Fill the TX buffer as full as possible before sending it.  Sending
+   * each line separately would produce one small TCP segment per line.
+   */
 
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  while (remaining > 0)
     {
-      /* Get the next character from the user buffer */
+      /* Copy the run of ordinary characters up to the next character that
+       * needs special handling.
+       */
 
-      ch = *src++;
+      space = CONFIG_TELNET_TXBUFFER_SIZE - ncopied;
+      nrun  = 0;
+
+      while (nrun < remaining && nrun < space &&
+             !telnet_special((uint8_t)src[nrun]))
+        {
+          nrun++;
+        }
 
-      /* Add the character to the TX buffer */
+      memcpy(&priv->td_txbuffer[ncopied], src, nrun);
+      ncopied   += nrun;
+      src       += nrun;
+      remaining -= nrun;
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+      if (remaining == 0)
+        {
+          break;
+        }
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n\0")?
+      /* Add the special character if there is room for the largest
+       * expansion ("\n\r\0").  Otherwise, the buffer is full.
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE-3)
+      if (telnet_special((uint8_t)*src) &&
+          ncopied <= CONFIG_TELNET_TXBUFFER_SIZE - 3)
+        {
+          telnet_putchar(priv, (uint8_t)*src, &ncopied);
+          src++;
+          remaining--;
+        }
+      else
         {
-          /* Yes... send the data now */
+          /* Send the full buffer now */
 
           ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
           if (ret < 0)
@@ -1113,7 +1153,7 @@ static int telnet_poll(FAR struct file *filep, FAR struct pollfd *fds,
       /* Yes.. then signal the poll logic */
 
       fds->revents |= (POLLRDNORM & fds->events);
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
   /* Then let psock_poll() do the heavy lifting */
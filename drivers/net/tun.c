@@ -64,6 +64,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
@@ -140,6 +141,9 @@ struct tun_device_s
 #endif
 
   bool              read_wait;
+#ifdef CONFIG_NET_TUN_MULTIPKT
+  bool              multipkt; /* true: Packets are framed by tun_pkthdr_s */
+#endif
 
   uint8_t           read_buf[CONFIG_NET_TUN_PKTSIZE];
   size_t            read_d_len;
@@ -329,7 +333,7 @@ static void tun_pollnotify(FAR struct tun_device_s *priv, pollevent_t eventset)
   if (eventset != 0)
     {
       fds->revents |= eventset;
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 }
 #else
@@ -1256,6 +1260,51 @@ static int tun_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tun_write_multi
+ *
+ * Description:
+ *   Give each packet in a multi-packet write buffer to the network.
+ *
+ * Assumptions:
+ *   The device and the network are locked and no reply is pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TUN_MULTIPKT
+static ssize_t tun_write_multi(FAR struct tun_device_s *priv,
+                               FAR const char *buffer, size_t buflen)
+{
+  struct tun_pkthdr_s hdr;
+  size_t pos = 0;
+
+  /* Stop if a packet produced a reply; it must be read before another
+   * packet can be received.
+   */
+
+  while (pos + sizeof(hdr) <= buflen && priv->write_d_len == 0)
+    {
+      memcpy(&hdr, &buffer[pos], sizeof(hdr));
+      if (hdr.len > CONFIG_NET_TUN_PKTSIZE ||
+          hdr.len > buflen - pos - sizeof(hdr))
+        {
+          break;
+        }
+
+      memcpy(priv->write_buf, &buffer[pos + sizeof(hdr)], hdr.len);
+
+      priv->dev.d_buf = priv->write_buf;
+      priv->dev.d_len = hdr.len;
+
+      tun_net_receive(priv);
+
+      pos += sizeof(hdr) + hdr.len;
+    }
+
+  return pos > 0 ? (ssize_t)pos : -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Name: tun_write
  ****************************************************************************/
@@ -1281,6 +1330,13 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 
   net_lock();
 
+#ifdef CONFIG_NET_TUN_MULTIPKT
+  if (priv->multipkt)
+    {
+      ret = tun_write_multi(priv, buffer, buflen);
+    }
+  else
+#endif
   if (buflen > CONFIG_NET_TUN_PKTSIZE)
     {
       ret = -EINVAL;
@@ -1303,6 +1359,85 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tun_read_multi
+ *
+ * Description:
+ *   Copy as many pending packets as fit into a multi-packet read buffer.
+ *   Replies to written packets are returned first.  After each packet
+ *   read, the network is polled for the next one.
+ *
+ * Returned Value:
+ *   The number of bytes returned; zero if there is no packet to read.
+ *
+ * Assumptions:
+ *   The device is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TUN_MULTIPKT
+static ssize_t tun_read_multi(FAR struct tun_device_s *priv,
+                              FAR char *buffer, size_t buflen)
+{
+  struct tun_pkthdr_s hdr;
+  size_t pos = 0;
+
+  net_lock();
+
+  for (; ; )
+    {
+      if (priv->write_d_len > 0)
+        {
+          if (pos + sizeof(hdr) + priv->write_d_len > buflen)
+            {
+              break;
+            }
+
+          hdr.len = priv->write_d_len;
+          memcpy(&buffer[pos], &hdr, sizeof(hdr));
+          memcpy(&buffer[pos + sizeof(hdr)], priv->write_buf, hdr.len);
+          pos += sizeof(hdr) + hdr.len;
+
+          priv->write_d_len = 0;
+          NETDEV_TXDONE(&priv->dev);
+          tun_pollnotify(priv, POLLOUT);
+        }
+      else if (priv->read_d_len > 0)
+        {
+          if (pos + sizeof(hdr) + priv->read_d_len > buflen)
+            {
+              break;
+            }
+
+          hdr.len = priv->read_d_len;
+          memcpy(&buffer[pos], &hdr, sizeof(hdr));
+          memcpy(&buffer[pos + sizeof(hdr)], priv->read_buf, hdr.len);
+          pos += sizeof(hdr) + hdr.len;
+
+          /* This may queue the next outgoing packet in read_buf */
+
+          priv->read_d_len = 0;
+          tun_txdone(priv);
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+
+  /* The caller's buffer cannot hold even the first packet */
+
+  if (pos == 0 && (priv->write_d_len > 0 || priv->read_d_len > 0))
+    {
+      return -EINVAL;
+    }
+
+  return (ssize_t)pos;
+}
+#endif
+
 /****************************************************************************
  * Name: tun_read
  ****************************************************************************/
@@ -1322,6 +1457,30 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 
   tun_lock(priv);
 
+#ifdef CONFIG_NET_TUN_MULTIPKT
+  if (priv->multipkt)
+    {
+      ret = tun_read_multi(priv, buffer, buflen);
+      if (ret == 0)
+        {
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              goto out;
+            }
+
+          priv->read_wait = true;
+          tun_unlock(priv);
+          (void)nxsem_wait(&priv->read_wait_sem);
+          tun_lock(priv);
+
+          ret = tun_read_multi(priv, buffer, buflen);
+        }
+
+      goto out;
+    }
+#endif
+
   /* Check if there are data to read in write buffer */
 
   write_d_len = priv->write_d_len;
@@ -1502,6 +1661,17 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return OK;
     }
 
+#ifdef CONFIG_NET_TUN_MULTIPKT
+  if (cmd == TUNSETMULTI && priv != NULL)
+    {
+      tun_lock(priv);
+      priv->multipkt = (arg != 0);
+      tun_unlock(priv);
+
+      return OK;
+    }
+#endif
+
   return -EBADFD;
 }
 
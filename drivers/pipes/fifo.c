@@ -57,18 +57,20 @@
 
 static const struct file_operations fifo_fops =
 {
-  pipecommon_open,  /* open */
-  pipecommon_close, /* close */
-  pipecommon_read,  /* read */
-  pipecommon_write, /* write */
-  0,                /* seek */
-  pipecommon_ioctl, /* ioctl */
+  pipecommon_open,   /* open */
+  pipecommon_close,  /* close */
+  pipecommon_read,   /* read */
+  pipecommon_write,  /* write */
+  0,                 /* seek */
+  pipecommon_ioctl,  /* ioctl */
 #ifndef CONFIG_DISABLE_POLL
-  pipecommon_poll,  /* poll */
+  pipecommon_poll,   /* poll */
 #endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  pipecommon_unlink /* unlink */
+  pipecommon_unlink, /* unlink */
 #endif
+  0,                 /* readv */
+  pipecommon_writev  /* writev */
 };
 
 /****************************************************************************
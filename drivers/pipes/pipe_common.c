@@ -43,6 +43,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -80,6 +81,10 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -146,7 +151,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -155,6 +160,266 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_nbytes and pipecommon_nfree
+ *
+ * Description:
+ *   Return the number of bytes in the buffer and the number of bytes that
+ *   can still be written.  One byte of the buffer is always left free so
+ *   that a full buffer can be distinguished from an empty one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+
+  return dev->d_bufsize - dev->d_rdndx + dev->d_wrndx;
+}
+
+static inline size_t pipecommon_nfree(FAR struct pipe_dev_s *dev)
+{
+  return dev->d_bufsize - 1 - pipecommon_nbytes(dev);
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdspan and pipecommon_wrspan
+ *
+ * Description:
+ *   Return the number of bytes that can be read at the read index, or
+ *   written at the write index, without wrapping around the end of the
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_rdspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+
+  return dev->d_bufsize - dev->d_rdndx;
+}
+
+static size_t pipecommon_wrspan(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      return dev->d_rdndx - dev->d_wrndx - 1;
+    }
+
+  /* The last byte before the read index must stay free */
+
+  return dev->d_bufsize - dev->d_wrndx - (dev->d_rdndx == 0 ? 1 : 0);
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdadvance and pipecommon_wradvance
+ ****************************************************************************/
+
+static void pipecommon_rdadvance(FAR struct pipe_dev_s *dev, size_t nbytes)
+{
+  size_t ndx = dev->d_rdndx + nbytes;
+
+  dev->d_rdndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+static void pipecommon_wradvance(FAR struct pipe_dev_s *dev, size_t nbytes)
+{
+  size_t ndx = dev->d_wrndx + nbytes;
+
+  dev->d_wrndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdwait
+ *
+ * Description:
+ *   Wait until the pipe holds at least one byte.  The caller holds
+ *   d_bfsem.
+ *
+ * Returned Value:
+ *   One is returned with d_bfsem still held when there is data.  Zero (end
+ *   of file:  the pipe is empty and there are no writers) or a negated
+ *   errno value is returned with d_bfsem released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_rdwait(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrwait
+ *
+ * Description:
+ *   Wait until there is space for at least one byte in the pipe.  The
+ *   caller holds d_bfsem.
+ *
+ * Returned Value:
+ *   One is returned with d_bfsem still held when there is space.  A negated
+ *   errno value is returned with d_bfsem released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_wrwait(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EPIPE;
+        }
+
+      if (pipecommon_wrspan(dev) > 0)
+        {
+          return 1;
+        }
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* Wait for data to be removed from the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_wrsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the capacity of the pipe to 'size' bytes.  Data already in the
+ *   pipe is preserved.  The caller holds d_bfsem.
+ *
+ * Returned Value:
+ *   The new capacity on success; -EINVAL if the size is out of range,
+ *   -EBUSY if the data in the pipe would not fit, or -ENOMEM.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, unsigned long size)
+{
+  FAR uint8_t *buffer;
+  size_t nbytes;
+  size_t nfirst;
+
+  /* One byte of the buffer is always left free */
+
+  if (size < 1 || size >= CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  nbytes = pipecommon_nbytes(dev);
+  if (nbytes > size)
+    {
+      return -EBUSY;
+    }
+
+  /* The buffer is allocated when the pipe is opened.  If it has not been
+   * allocated yet, just remember the size.
+   */
+
+  if (dev->d_buffer != NULL && size + 1 != dev->d_bufsize)
+    {
+      buffer = (FAR uint8_t *)kmm_malloc(size + 1);
+      if (buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* Move the data to the beginning of the new buffer */
+
+      nfirst = pipecommon_rdspan(dev);
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nfirst);
+      memcpy(&buffer[nfirst], dev->d_buffer, nbytes - nfirst);
+
+      kmm_free(dev->d_buffer);
+      dev->d_buffer = buffer;
+      dev->d_rdndx  = 0;
+      dev->d_wrndx  = nbytes;
+    }
+
+  dev->d_bufsize = size + 1;
+
+  /* There may be more space for writers now */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+  pipecommon_pollnotify(dev, POLLOUT);
+  return size;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -433,6 +698,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
+  size_t                 nbytes;
   int                    sval;
   int                    ret;
 
@@ -453,49 +719,28 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  ret = pipecommon_rdwait(dev, (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret <= 0)
     {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          return ret;
-        }
+      return ret;
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).  The data is copied in at most two pieces:  From the read index
+   * up to the write index or the end of the buffer, then from the
+   * beginning of the buffer.
+   */
 
   nread = 0;
   while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
+      nbytes = MIN(pipecommon_rdspan(dev), len - nread);
 
-      nread++;
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+      pipecommon_rdadvance(dev, nbytes);
+
+      buffer += nbytes;
+      nread  += nbytes;
     }
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
@@ -520,17 +765,54 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                          size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = len;
+
+  return pipecommon_writev(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ *
+ * Description:
+ *   Gather-write a list of buffers into the pipe.  The buffers are copied
+ *   under a single hold of the device semaphore and waiting readers are
+ *   awakened only once the complete request has been copied (or when the
+ *   pipe becomes full), so a writev() is never interleaved with other
+ *   writers unless it must block.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                          int iovcnt)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
+  FAR const char        *buffer;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
+  size_t                 remaining;
+  size_t                 nbytes;
+  size_t                 len;
+  int                    index;
   int                    sval;
   int                    ret;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+
+  /* Get the total size of the transfer and skip any leading empty
+   * buffers.
+   */
+
+  for (index = 0, len = 0; index < iovcnt; index++)
+    {
+      pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)iov[index].iov_base,
+                      iov[index].iov_len);
+      len += iov[index].iov_len;
+    }
 
   /* Handle zero-length writes */
 
@@ -575,29 +857,41 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
+  index     = 0;
+  buffer    = (FAR const char *)iov[0].iov_base;
+  remaining = iov[0].iov_len;
+  last      = 0;
+
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Advance to the next non-empty buffer */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      while (remaining == 0)
         {
-          nxtwrndx = 0;
+          index++;
+          buffer    = (FAR const char *)iov[index].iov_base;
+          remaining = iov[index].iov_len;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* How many bytes can be copied at the write index without wrapping
+       * or overflowing the circular buffer?
+       */
 
-      if (nxtwrndx != dev->d_rdndx)
+      nbytes = pipecommon_wrspan(dev);
+      if (nbytes > 0)
         {
-          /* No... copy the byte */
+          /* Copy as much of this buffer as fits */
+
+          nbytes = MIN(nbytes, remaining);
+          memcpy(&dev->d_buffer[dev->d_wrndx], buffer, nbytes);
+          pipecommon_wradvance(dev, nbytes);
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          buffer    += nbytes;
+          remaining -= nbytes;
 
           /* Is the write complete? */
 
-          nwritten++;
+          nwritten  += nbytes;
           if ((size_t)nwritten >= len)
             {
               /* Yes.. Notify all of the waiting readers that more data is available */
@@ -619,7 +913,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+          /* The buffer is full.  Was anything written in this pass? */
 
           if (last < nwritten)
             {
@@ -661,6 +955,318 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_splicefrom
+ *
+ * Description:
+ *   Move up to 'len' bytes out of the pipe without an intermediate copy:
+ *   'copy' is handed the data in place in the pipe's buffer (in at most
+ *   two pieces) and returns the number of bytes that it consumed.  This
+ *   waits for data like read() unless 'nonblock' is true.
+ *
+ *   'copy' is called with the pipe held, so it must never access the same
+ *   pipe.
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at end of file; or a negated errno
+ *   value if nothing could be moved.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splicefrom(FAR struct file *filep, size_t len,
+                              bool nonblock, pipe_splice_t copy,
+                              FAR void *arg)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  ssize_t                total = 0;
+  ssize_t                ret;
+
+  DEBUGASSERT(dev && copy);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_rdwait(dev, nonblock);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  while ((size_t)total < len && dev->d_wrndx != dev->d_rdndx)
+    {
+      size_t nbytes = MIN(pipecommon_rdspan(dev), len - total);
+
+      ret = copy(arg, &dev->d_buffer[dev->d_rdndx], nbytes, total > 0);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipecommon_rdadvance(dev, ret);
+      total += ret;
+
+      if ((size_t)ret < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      /* Notify all waiting writers that bytes have been removed */
+
+      pipecommon_wakeup(&dev->d_wrsem);
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceto
+ *
+ * Description:
+ *   Move up to 'len' bytes into the pipe without an intermediate copy:
+ *   'copy' is handed the free space in place in the pipe's buffer (in at
+ *   most two pieces) and returns the number of bytes that it filled in.
+ *   This waits for space like write() unless 'nonblock' is true.
+ *
+ *   'copy' is called with the pipe held, so it must never access the same
+ *   pipe.
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero if 'copy' returned end of file; or a
+ *   negated errno value if nothing could be moved.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_spliceto(FAR struct file *filep, size_t len,
+                            bool nonblock, pipe_splice_t copy,
+                            FAR void *arg)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  ssize_t                total = 0;
+  ssize_t                ret;
+
+  DEBUGASSERT(dev && copy);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_wrwait(dev, nonblock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while ((size_t)total < len)
+    {
+      size_t nbytes = MIN(pipecommon_wrspan(dev), len - total);
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      ret = copy(arg, &dev->d_buffer[dev->d_wrndx], nbytes, total > 0);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", &dev->d_buffer[dev->d_wrndx], ret);
+      pipecommon_wradvance(dev, ret);
+      total += ret;
+
+      if ((size_t)ret < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      /* Notify all waiting readers that more data is available */
+
+      pipecommon_wakeup(&dev->d_rdsem);
+      pipecommon_pollnotify(dev, POLLIN);
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_tee
+ *
+ * Description:
+ *   Copy up to 'len' bytes directly from the buffer of one pipe to the
+ *   buffer of another.  The data is removed from the source pipe only if
+ *   'consume' is true (splice() rather than tee()).  This waits for data in
+ *   the source and for space in the destination unless 'nonblock' is
+ *   true.
+ *
+ * Returned Value:
+ *   The number of bytes copied; zero at end of file on the source; or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_tee(FAR struct file *infile, FAR struct file *outfile,
+                       size_t len, bool nonblock, bool consume)
+{
+  FAR struct pipe_dev_s *in  = infile->f_inode->i_private;
+  FAR struct pipe_dev_s *out = outfile->f_inode->i_private;
+  FAR struct pipe_dev_s *first;
+  FAR struct pipe_dev_s *second;
+  FAR sem_t             *waitsem;
+  ssize_t                ret;
+
+  DEBUGASSERT(in && out);
+
+  if (in == out)
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Always take the two pipes in the same order so that concurrent
+   * transfers in opposite directions cannot deadlock.
+   */
+
+  first  = in < out ? in : out;
+  second = in < out ? out : in;
+
+  for (; ; )
+    {
+      ret = nxsem_wait(&first->d_bfsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = nxsem_wait(&second->d_bfsem);
+      if (ret < 0)
+        {
+          nxsem_post(&first->d_bfsem);
+          return ret;
+        }
+
+      if (out->d_nreaders <= 0)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      if (in->d_wrndx == in->d_rdndx)
+        {
+          /* The source is empty */
+
+          if (in->d_nwriters <= 0)
+            {
+              ret = 0;
+              break;
+            }
+
+          waitsem = &in->d_rdsem;
+        }
+      else if (pipecommon_wrspan(out) == 0)
+        {
+          /* The destination is full */
+
+          waitsem = &out->d_wrsem;
+        }
+      else
+        {
+          size_t nbytes;
+          size_t rdndx;
+          size_t ncopied;
+
+          nbytes = MIN(len, pipecommon_nbytes(in));
+          nbytes = MIN(nbytes, pipecommon_nfree(out));
+
+          /* Each piece ends where either buffer wraps around */
+
+          rdndx = in->d_rdndx;
+          for (ncopied = 0; ncopied < nbytes; )
+            {
+              size_t n = MIN(nbytes - ncopied, in->d_bufsize - rdndx);
+
+              n = MIN(n, pipecommon_wrspan(out));
+              memcpy(&out->d_buffer[out->d_wrndx], &in->d_buffer[rdndx], n);
+              pipecommon_wradvance(out, n);
+
+              rdndx += n;
+              if (rdndx >= in->d_bufsize)
+                {
+                  rdndx = 0;
+                }
+
+              ncopied += n;
+            }
+
+          if (consume)
+            {
+              in->d_rdndx = rdndx;
+              pipecommon_wakeup(&in->d_wrsem);
+              pipecommon_pollnotify(in, POLLOUT);
+            }
+
+          pipecommon_wakeup(&out->d_rdsem);
+          pipecommon_pollnotify(out, POLLIN);
+
+          ret = nbytes;
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      /* Release both pipes and wait for the condition to change */
+
+      sched_lock();
+      nxsem_post(&second->d_bfsem);
+      nxsem_post(&first->d_bfsem);
+      ret = nxsem_wait(waitsem);
+      sched_unlock();
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  nxsem_post(&second->d_bfsem);
+  nxsem_post(&first->d_bfsem);
+  return ret;
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -712,14 +1318,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = pipecommon_nbytes(dev);
 
       /* Notify the POLLOUT event if the pipe is not full, but only if
        * there is readers.
@@ -831,20 +1430,9 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           /* Determine the number of bytes written to the buffer.  This is,
            * of course, also the number of bytes that may be read from the
            * buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
            */
 
-          if (dev->d_wrndx < dev->d_rdndx)
-            {
-              count = (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
-            }
-          else
-            {
-              count = dev->d_wrndx - dev->d_rdndx;
-            }
-
+          count = pipecommon_nbytes(dev);
           *(FAR int *)((uintptr_t)arg) = count;
           ret = 0;
         }
@@ -856,26 +1444,28 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         {
           int count;
 
-          /* Determine the number of bytes free in the buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
-           */
-
-          if (dev->d_wrndx < dev->d_rdndx)
-            {
-              count = (dev->d_rdndx - dev->d_wrndx) - 1;
-            }
-          else
-            {
-              count = ((dev->d_bufsize - dev->d_wrndx) + dev->d_rdndx) - 1;
-            }
+          /* Determine the number of bytes free in the buffer */
 
+          count = pipecommon_nfree(dev);
           *(FAR int *)((uintptr_t)arg) = count;
           ret = 0;
         }
         break;
 
+      /* Capacity of the buffer */
+
+      case PIPEIOC_GETSIZE:
+        {
+          ret = dev->d_bufsize - 1;
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, arg);
+        }
+        break;
+
       default:
         break;
     }
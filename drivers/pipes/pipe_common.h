@@ -122,6 +122,16 @@ typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 #endif
 
+/* Used by splice() and tee() to move data directly into or out of the
+ * buffer of a pipe.  The callback is given a contiguous region inside the
+ * pipe's buffer and returns the number of bytes that it moved (or a
+ * negated errno value).  'more' is true if data has already been moved by
+ * the same call; the callback should then avoid waiting.
+ */
+
+typedef CODE ssize_t (*pipe_splice_t)(FAR void *arg, FAR uint8_t *buffer,
+                                      size_t len, bool more);
+
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe pipe/fifo
  * device is registered.
@@ -166,6 +176,7 @@ extern "C"
 
 struct file;  /* Forward reference */
 struct inode; /* Forward reference */
+struct iovec; /* Forward reference */
 
 FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize);
 void    pipecommon_freedev(FAR struct pipe_dev_s *dev);
@@ -173,7 +184,17 @@ int     pipecommon_open(FAR struct file *filep);
 int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+ssize_t pipecommon_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                          int iovcnt);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+ssize_t pipecommon_splicefrom(FAR struct file *filep, size_t len,
+                              bool nonblock, pipe_splice_t copy,
+                              FAR void *arg);
+ssize_t pipecommon_spliceto(FAR struct file *filep, size_t len,
+                            bool nonblock, pipe_splice_t copy,
+                            FAR void *arg);
+ssize_t pipecommon_tee(FAR struct file *infile, FAR struct file *outfile,
+                       size_t len, bool nonblock, bool consume);
 #ifndef CONFIG_DISABLE_POLL
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
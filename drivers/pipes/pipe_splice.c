@@ -0,0 +1,416 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One end of a splice():  A file (possibly a pipe) or a socket */
+
+struct splice_end_s
+{
+  FAR struct file *filep;      /* The file, or NULL if this is a socket */
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  FAR struct socket *psock;    /* The socket, or NULL if this is a file */
+#endif
+  FAR off_t *offset;           /* Explicit file offset (may be NULL) */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_getend
+ *
+ * Description:
+ *   Look up the file or socket for a descriptor.  'oflags' is the access
+ *   that is required on a file (O_RDOK or O_WROK).
+ *
+ ****************************************************************************/
+
+static int splice_getend(int fd, FAR off_t *offset, int oflags,
+                         FAR struct splice_end_s *end)
+{
+  int ret;
+
+  end->filep  = NULL;
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  end->psock  = NULL;
+#endif
+  end->offset = offset;
+
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      end->psock = sockfd_socket(fd);
+      if (end->psock == NULL || end->psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      /* Sockets have no offset */
+
+      return offset != NULL ? -ESPIPE : OK;
+    }
+#endif
+
+  ret = fs_getfilep(fd, &end->filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return (end->filep->f_oflags & oflags) != 0 ? OK : -EBADF;
+}
+
+/****************************************************************************
+ * Name: splice_ispipe
+ ****************************************************************************/
+
+static bool splice_ispipe(FAR struct splice_end_s *end)
+{
+  FAR struct inode *inode;
+
+  if (end->filep == NULL)
+    {
+      return false;
+    }
+
+  inode = end->filep->f_inode;
+  return INODE_IS_DRIVER(inode) && inode->u.i_ops != NULL &&
+         inode->u.i_ops->read == pipecommon_read;
+}
+
+/****************************************************************************
+ * Name: splice_mayblock
+ *
+ * Description:
+ *   Return true if a transfer on this file may wait.  Files on a mounted
+ *   file system never wait for data or space; character drivers may.
+ *
+ ****************************************************************************/
+
+static bool splice_mayblock(FAR struct splice_end_s *end)
+{
+  return !INODE_IS_MOUNTPT(end->filep->f_inode);
+}
+
+/****************************************************************************
+ * Name: splice_read
+ *
+ * Description:
+ *   pipe_splice_t callback that reads from the source directly into the
+ *   buffer of the destination pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_read(FAR void *arg, FAR uint8_t *buffer, size_t len,
+                           bool more)
+{
+  FAR struct splice_end_s *end = (FAR struct splice_end_s *)arg;
+  ssize_t ret;
+
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (end->psock != NULL)
+    {
+      ret = psock_recvfrom(end->psock, buffer, len,
+                           more ? MSG_DONTWAIT : 0, NULL, NULL);
+      return more && ret == -EAGAIN ? 0 : ret;
+    }
+#endif
+
+  if (more && splice_mayblock(end))
+    {
+      return 0;
+    }
+
+  if (end->offset != NULL)
+    {
+      ret = file_pread(end->filep, buffer, len, *end->offset);
+      if (ret > 0)
+        {
+          *end->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_read(end->filep, buffer, len);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: splice_write
+ *
+ * Description:
+ *   pipe_splice_t callback that writes to the destination directly from the
+ *   buffer of the source pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_write(FAR void *arg, FAR uint8_t *buffer, size_t len,
+                            bool more)
+{
+  FAR struct splice_end_s *end = (FAR struct splice_end_s *)arg;
+  ssize_t ret;
+
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (end->psock != NULL)
+    {
+      ret = psock_send(end->psock, buffer, len, more ? MSG_DONTWAIT : 0);
+      return more && ret == -EAGAIN ? 0 : ret;
+    }
+#endif
+
+  if (more && splice_mayblock(end))
+    {
+      return 0;
+    }
+
+  if (end->offset != NULL)
+    {
+      ret = file_pwrite(end->filep, buffer, len, *end->offset);
+      if (ret > 0)
+        {
+          *end->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_write(end->filep, buffer, len);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: splice_nonblock
+ ****************************************************************************/
+
+static bool splice_nonblock(FAR struct splice_end_s *pipe,
+                            unsigned int flags)
+{
+  return (flags & SPLICE_F_NONBLOCK) != 0 ||
+         (pipe->filep->f_oflags & O_NONBLOCK) != 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move data between two descriptors, at least one of which is a pipe,
+ *   without copying it through a user buffer.  The other descriptor may be
+ *   a pipe, a file or a socket.  Data is read from the source directly into
+ *   the buffer of the destination pipe, or written to the destination
+ *   directly from the buffer of the source pipe.
+ *
+ *   NOTE: This interface is not specified by POSIX; it follows Linux.
+ *
+ * Input Parameters:
+ *   fd_in   - The source descriptor
+ *   off_in  - The offset to read from if fd_in is a file (NULL: use and
+ *             update the file position).  Must be NULL for pipes and
+ *             sockets.
+ *   fd_out  - The destination descriptor
+ *   off_out - The offset to write to if fd_out is a file
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK:  Do not wait on the pipe(s).  The other
+ *             SPLICE_F_* flags are accepted and ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved on success; zero at end of input.  On
+ *   failure, -1 is returned and errno is set:
+ *
+ *   EBADF  - A descriptor is not valid or not open for the required access
+ *   EINVAL - Neither descriptor is a pipe, or both refer to the same pipe
+ *   ESPIPE - An offset was given for a pipe or a socket
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe would block
+ *   EPIPE  - The destination pipe has no readers
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  struct splice_end_s in;
+  struct splice_end_s out;
+  bool inpipe;
+  bool outpipe;
+  ssize_t ret;
+
+  ret = splice_getend(fd_in, off_in, O_RDOK, &in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = splice_getend(fd_out, off_out, O_WROK, &out);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  inpipe  = splice_ispipe(&in);
+  outpipe = splice_ispipe(&out);
+
+  if ((inpipe && off_in != NULL) || (outpipe && off_out != NULL))
+    {
+      ret = -ESPIPE;
+      goto errout;
+    }
+
+  if (inpipe && outpipe)
+    {
+      ret = pipecommon_tee(in.filep, out.filep, len,
+                           splice_nonblock(&in, flags) ||
+                           splice_nonblock(&out, flags), true);
+    }
+  else if (inpipe)
+    {
+      ret = pipecommon_splicefrom(in.filep, len,
+                                  splice_nonblock(&in, flags),
+                                  splice_write, &out);
+    }
+  else if (outpipe)
+    {
+      ret = pipecommon_spliceto(out.filep, len,
+                                splice_nonblock(&out, flags),
+                                splice_read, &in);
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   Duplicate up to 'len' bytes from one pipe to another without consuming
+ *   them from the source pipe.
+ *
+ *   NOTE: This interface is not specified by POSIX; it follows Linux.
+ *
+ * Input Parameters:
+ *   fd_in  - The source pipe
+ *   fd_out - The destination pipe
+ *   len    - The maximum number of bytes to duplicate
+ *   flags  - SPLICE_F_NONBLOCK:  Do not wait on the pipes
+ *
+ * Returned Value:
+ *   The number of bytes duplicated on success; zero at end of input.  On
+ *   failure, -1 is returned and errno is set (see splice()).
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  struct splice_end_s in;
+  struct splice_end_s out;
+  ssize_t ret;
+
+  ret = splice_getend(fd_in, NULL, O_RDOK, &in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = splice_getend(fd_out, NULL, O_WROK, &out);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!splice_ispipe(&in) || !splice_ispipe(&out))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = pipecommon_tee(in.filep, out.filep, len,
+                       splice_nonblock(&in, flags) ||
+                       splice_nonblock(&out, flags), false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_PIPES */
@@ -80,6 +80,18 @@ struct pwm_upperhalf_s
 #endif
   struct pwm_info_s info;     /* Pulsed output characteristics */
   FAR struct pwm_lowerhalf_s *dev;  /* lower-half state */
+#ifdef CONFIG_PWM_STREAM
+  volatile bool     streaming; /* True: The lower half is playing a buffer */
+  volatile bool     swaiting;  /* True: A writer waits for a free buffer */
+  uint8_t           shead;     /* Index of the next buffer to fill */
+  uint8_t           stail;     /* Index of the buffer being played */
+  volatile uint8_t  squeued;   /* Number of buffers queued or playing */
+  sem_t             streamsem; /* Used to wait for a free buffer */
+  struct pwm_stream_s stream;  /* Frame layout.  nchannels == 0: None */
+  FAR ub16_t       *sbuffer;   /* All stream buffers */
+  size_t            snframes[CONFIG_PWM_STREAM_NBUFFERS];
+                               /* Number of frames in each buffer */
+#endif
 };
 
 /****************************************************************************
@@ -97,6 +109,12 @@ static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
 static int     pwm_start(FAR struct pwm_upperhalf_s *upper,
                          unsigned int oflags);
+#ifdef CONFIG_PWM_STREAM
+static void    pwm_streamflush(FAR struct pwm_upperhalf_s *upper);
+static int     pwm_streamsubmit(FAR struct pwm_upperhalf_s *upper);
+static int     pwm_streamsetup(FAR struct pwm_upperhalf_s *upper,
+                               FAR const struct pwm_stream_s *stream);
+#endif
 static int     pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 
 /****************************************************************************
@@ -265,6 +283,19 @@ static int pwm_close(FAR struct file *filep)
       pwminfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_PWM_STREAM
+      /* Discard any stream */
+
+      pwm_streamflush(upper);
+      if (upper->sbuffer != NULL)
+        {
+          kmm_free(upper->sbuffer);
+          upper->sbuffer = NULL;
+        }
+
+      upper->stream.nchannels = 0;
+#endif
     }
 
   ret = OK;
@@ -294,15 +325,257 @@ static ssize_t pwm_read(FAR struct file *filep, FAR char *buffer,
  * Name: pwm_write
  *
  * Description:
- *   A dummy write method.  This is provided only to satisfy the VFS layer.
+ *   Queue duty cycle frames for streaming (see PWMIOC_STREAMSETUP).
+ *   Without CONFIG_PWM_STREAM, this is a dummy write method that is
+ *   provided only to satisfy the VFS layer.
  *
  ****************************************************************************/
 
+#ifdef CONFIG_PWM_STREAM
+static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct pwm_upperhalf_s *upper = inode->i_private;
+  FAR ub16_t                 *dest;
+  irqstate_t                  flags;
+  size_t                      framesize;
+  size_t                      nframes;
+  size_t                      nwritten;
+  size_t                      n;
+  int                         ret;
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Streaming must have been set up and the output must be running */
+
+  if (upper->stream.nchannels == 0 || !upper->started)
+    {
+      ret = -EPERM;
+      goto errout_with_sem;
+    }
+
+  /* Only complete frames are accepted */
+
+  framesize = upper->stream.nchannels * sizeof(ub16_t);
+  nframes   = buflen / framesize;
+  nwritten  = 0;
+
+  if (nframes == 0)
+    {
+      ret = -EINVAL;
+      goto errout_with_sem;
+    }
+
+  while (nwritten < nframes)
+    {
+      /* Wait for a free buffer.  Buffers are released by pwm_streamdone()
+       * which is normally called from the DMA interrupt handler.
+       */
+
+      flags = enter_critical_section();
+      while (upper->squeued >= CONFIG_PWM_STREAM_NBUFFERS)
+        {
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          upper->swaiting = true;
+          ret = nxsem_wait(&upper->streamsem);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Fill the buffer.  Only this thread modifies the buffer at shead
+       * while it is free.
+       */
+
+      n = nframes - nwritten;
+      if (n > CONFIG_PWM_STREAM_NFRAMES)
+        {
+          n = CONFIG_PWM_STREAM_NFRAMES;
+        }
+
+      dest = &upper->sbuffer[upper->shead * CONFIG_PWM_STREAM_NFRAMES *
+                             upper->stream.nchannels];
+      memcpy(dest, &buffer[nwritten * framesize], n * framesize);
+      upper->snframes[upper->shead] = n;
+
+      /* Queue the buffer and start playing it if the stream is idle */
+
+      flags = enter_critical_section();
+      if (++upper->shead >= CONFIG_PWM_STREAM_NBUFFERS)
+        {
+          upper->shead = 0;
+        }
+
+      upper->squeued++;
+      ret = pwm_streamsubmit(upper);
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nwritten += n;
+    }
+
+  /* Report the frames queued so far, if any, instead of an error */
+
+  if (nwritten > 0)
+    {
+      ret = nwritten * framesize;
+    }
+
+errout_with_sem:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#else
 static ssize_t pwm_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
   return 0;
 }
+#endif
+
+/****************************************************************************
+ * Name: pwm_streamflush
+ *
+ * Description:
+ *   Discard all queued stream buffers and wake up any waiting writer.
+ *   The lower half must not be playing a buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_STREAM
+static void pwm_streamflush(FAR struct pwm_upperhalf_s *upper)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  upper->streaming = false;
+  upper->shead     = 0;
+  upper->stail     = 0;
+  upper->squeued   = 0;
+
+  if (upper->swaiting)
+    {
+      upper->swaiting = false;
+      nxsem_post(&upper->streamsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: pwm_streamsubmit
+ *
+ * Description:
+ *   Pass the oldest queued buffer to the lower half if it is not already
+ *   playing one.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int pwm_streamsubmit(FAR struct pwm_upperhalf_s *upper)
+{
+  FAR struct pwm_lowerhalf_s *lower = upper->dev;
+  FAR ub16_t *duty;
+  int ret;
+
+  if (upper->streaming || upper->squeued == 0)
+    {
+      return OK;
+    }
+
+  duty = &upper->sbuffer[upper->stail * CONFIG_PWM_STREAM_NFRAMES *
+                         upper->stream.nchannels];
+
+  ret = lower->ops->stream(lower, &upper->stream, duty,
+                           upper->snframes[upper->stail], upper);
+  if (ret < 0)
+    {
+      pwmerr("ERROR: stream failed: %d\n", ret);
+      pwm_streamflush(upper);
+      return ret;
+    }
+
+  upper->streaming = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pwm_streamsetup
+ *
+ * Description:
+ *   Handle the PWMIOC_STREAMSETUP ioctl command
+ *
+ ****************************************************************************/
+
+static int pwm_streamsetup(FAR struct pwm_upperhalf_s *upper,
+                           FAR const struct pwm_stream_s *stream)
+{
+  FAR struct pwm_lowerhalf_s *lower = upper->dev;
+  FAR ub16_t *sbuffer;
+
+  if (lower->ops->stream == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (stream->nchannels == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The frame layout cannot be changed while buffers are queued */
+
+  if (upper->squeued > 0)
+    {
+      return -EBUSY;
+    }
+
+  if (stream->nchannels != upper->stream.nchannels)
+    {
+      sbuffer = (FAR ub16_t *)
+        kmm_malloc(CONFIG_PWM_STREAM_NBUFFERS * CONFIG_PWM_STREAM_NFRAMES *
+                   stream->nchannels * sizeof(ub16_t));
+      if (sbuffer == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      if (upper->sbuffer != NULL)
+        {
+          kmm_free(upper->sbuffer);
+        }
+
+      upper->sbuffer = sbuffer;
+    }
+
+  upper->stream = *stream;
+  return OK;
+}
+#endif
 
 /****************************************************************************
  * Name: pwm_start
@@ -532,11 +805,37 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
                 {
                   upper->waiting = false;
                 }
+#endif
+#ifdef CONFIG_PWM_STREAM
+              /* The stop method also stopped any stream */
+
+              pwm_streamflush(upper);
 #endif
             }
         }
         break;
 
+#ifdef CONFIG_PWM_STREAM
+      /* PWMIOC_STREAMSETUP - Select the channels that are streamed by
+       *   write().
+       *
+       *   ioctl argument:  A read-only reference to struct pwm_stream_s.
+       */
+
+      case PWMIOC_STREAMSETUP:
+        {
+          FAR const struct pwm_stream_s *stream =
+            (FAR const struct pwm_stream_s *)((uintptr_t)arg);
+          DEBUGASSERT(stream != NULL);
+
+          pwminfo("PWMIOC_STREAMSETUP: channel: %u nchannels: %u\n",
+                  stream->channel, stream->nchannels);
+
+          ret = pwm_streamsetup(upper, stream);
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -606,6 +905,10 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev)
 
   nxsem_setprotocol(&upper->waitsem, SEM_PRIO_NONE);
 #endif
+#ifdef CONFIG_PWM_STREAM
+  nxsem_init(&upper->streamsem, 0, 0);
+  nxsem_setprotocol(&upper->streamsem, SEM_PRIO_NONE);
+#endif
 
   upper->dev = dev;
 
@@ -680,4 +983,60 @@ void pwm_expired(FAR void *handle)
 }
 #endif
 
+/****************************************************************************
+ * Name: pwm_streamdone
+ *
+ * Description:
+ *   Called by the lower half driver when the buffer passed to its stream()
+ *   method has been played.  Release the buffer and start the next one.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     stream() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_STREAM
+void pwm_streamdone(FAR void *handle)
+{
+  FAR struct pwm_upperhalf_s *upper = (FAR struct pwm_upperhalf_s *)handle;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Ignore late completions of a stream that was already stopped */
+
+  if (upper->streaming)
+    {
+      upper->streaming = false;
+      if (++upper->stail >= CONFIG_PWM_STREAM_NBUFFERS)
+        {
+          upper->stail = 0;
+        }
+
+      upper->squeued--;
+
+      /* Wake up a writer waiting for the buffer */
+
+      if (upper->swaiting)
+        {
+          upper->swaiting = false;
+          nxsem_post(&upper->streamsem);
+        }
+
+      /* Start the next buffer right away */
+
+      (void)pwm_streamsubmit(upper);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 #endif /* CONFIG_PWM */
@@ -148,87 +148,149 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
 {
   /* We assume that the caller holds the wrsem */
 
-  rwb->wrnblocks       = 0;
-  rwb->wrblockstart    = (off_t)-1;
-  rwb->wrexpectedblock = (off_t)-1;
+  rwb->wrnblocks = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrsearch
+ *
+ * Description:
+ *   Return the index of the first buffered block whose block number is
+ *   not less than 'block' (or wrnblocks if there is no such block).  The
+ *   buffered blocks are kept sorted by block number.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static unsigned int rwb_wrsearch(FAR struct rwbuffer_s *rwb, off_t block)
+{
+  unsigned int low  = 0;
+  unsigned int high = rwb->wrnblocks;
+  unsigned int mid;
+
+  /* Most writes are sequential, so check for an append first */
+
+  if (high == 0 || rwb->wrblock[high - 1] < block)
+    {
+      return high;
+    }
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (rwb->wrblock[mid] < block)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
 }
 #endif
 
 /****************************************************************************
  * Name: rwb_wrflush
  *
+ * Description:
+ *   Write all buffered blocks to the media.  Each run of consecutive block
+ *   numbers is written with a single call to the flush method; since the
+ *   blocks are sorted, each run is also contiguous in the write buffer.
+ *   The buffer is emptied even if a write fails:  Retrying would most
+ *   likely just fail again (for example, if the media was removed).
+ *
  * Assumptions:
  *   The caller holds the wrsem semaphore.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflush(struct rwbuffer_s *rwb)
 {
-  int ret;
+  unsigned int start;
+  unsigned int end;
+  ssize_t nwritten;
+  int ret = OK;
 
-  if (rwb->wrnblocks > 0)
+  for (start = 0; start < rwb->wrnblocks; start = end)
     {
-      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-      (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+      /* Find the end of this run of consecutive blocks */
+
+      end = start + 1;
+      while (end < rwb->wrnblocks &&
+             rwb->wrblock[end] == rwb->wrblock[end - 1] + 1)
+        {
+          end++;
+        }
+
+      finfo("Flushing: blockstart=0x%08lx nblocks=%u\n",
+            (long)rwb->wrblock[start], end - start);
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
+      /* On success, the flush method will return the number of blocks
+       * written.  Anything other than the number requested is an error.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      nwritten = rwb->wrflush(rwb->dev,
+                              &rwb->wrbuffer[start * rwb->blocksize],
+                              rwb->wrblock[start], end - start);
+      if (nwritten != (ssize_t)(end - start))
         {
-          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          ferr("ERROR: Error flushing write buffer: %d\n", (int)nwritten);
+          ret = nwritten < 0 ? (int)nwritten : -EIO;
         }
-
-      rwb_resetwrbuffer(rwb);
     }
 
+  rwb_resetwrbuffer(rwb);
+  return ret;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrtimeout
+ * Name: rwb_wrworker
+ *
+ * Description:
+ *   Flush the write buffer on the low priority worker thread.  This is
+ *   scheduled when there has been no write activity for CONFIG_DRVR_WRDELAY
+ *   milliseconds or, immediately, when the number of buffered blocks
+ *   reaches the dirty limit.
+ *
  ****************************************************************************/
 
-#if defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_DRVR_WRDELAY != 0
-static void rwb_wrtimeout(FAR void *arg)
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_SCHED_WORKQUEUE)
+static void rwb_wrworker(FAR void *arg)
 {
-  /* The following assumes that the size of a pointer is 4-bytes or less */
-
   FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
   DEBUGASSERT(rwb != NULL);
 
-  finfo("Timeout!\n");
-
-  /* If a timeout elapses with with write buffer activity, this watchdog
-   * handler function will be evoked on the thread of execution of the
-   * worker thread.
-   */
+  finfo("Background flush\n");
 
   rwb_semtake(&rwb->wrsem);
-  rwb_wrflush(rwb);
+  (void)rwb_wrflush(rwb);
   rwb_semgive(&rwb->wrsem);
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrstarttimeout
+ * Name: rwb_wrstartflush
+ *
+ * Description:
+ *   Schedule a background flush of the write buffer after 'ticks' clock
+ *   ticks.  Any previously scheduled flush is replaced.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_SCHED_WORKQUEUE)
+static void rwb_wrstartflush(FAR struct rwbuffer_s *rwb, int ticks)
 {
-#if CONFIG_DRVR_WRDELAY != 0
-  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
-   */
-
-  int ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
-  (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
-#endif
+  (void)work_queue(LPWORK, &rwb->work, rwb_wrworker, (FAR void *)rwb,
+                   ticks);
 }
 #endif
 
@@ -239,7 +301,7 @@ static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
-#if CONFIG_DRVR_WRDELAY != 0
+#ifdef CONFIG_SCHED_WORKQUEUE
   (void)work_cancel(LPWORK, &rwb->work);
 #endif
 }
@@ -247,6 +309,17 @@ static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Description:
+ *   Add blocks to the write buffer.  A block that is already buffered is
+ *   just overwritten; other blocks are inserted in sorted order so that
+ *   writes to nearby blocks are merged into larger transfers when the
+ *   buffer is flushed.  The buffer is only flushed synchronously if it is
+ *   full.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -254,54 +327,76 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+  unsigned int index;
+  unsigned int nmove;
+  uint32_t i;
   int ret;
 
-  /* Write writebuffer Logic */
-
   rwb_wrcanceltimeout(rwb);
 
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
-   */
-
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
+  for (i = 0; i < nblocks; i++, startblock++, wrbuffer += rwb->blocksize)
     {
-      finfo("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
+      index = rwb_wrsearch(rwb, startblock);
+      if (index >= rwb->wrnblocks || rwb->wrblock[index] != startblock)
+        {
+          /* This block is not buffered yet.  Make room for it if
+           * necessary.
+           */
 
-      /* Flush the write buffer */
+          if (rwb->wrnblocks >= rwb->wrmaxblocks)
+            {
+              ret = rwb_wrflush(rwb);
+              if (ret < 0)
+                {
+                  return ret;
+                }
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret < 0)
-        {
-          ferr("ERROR: Error writing multiple from cache: %d\n", -ret);
-          return ret;
+              index = 0;
+            }
+
+          /* Then insert it in order */
+
+          nmove = rwb->wrnblocks - index;
+          if (nmove > 0)
+            {
+              memmove(&rwb->wrblock[index + 1], &rwb->wrblock[index],
+                      nmove * sizeof(off_t));
+              memmove(&rwb->wrbuffer[(index + 1) * rwb->blocksize],
+                      &rwb->wrbuffer[index * rwb->blocksize],
+                      nmove * rwb->blocksize);
+            }
+
+          rwb->wrblock[index] = startblock;
+          rwb->wrnblocks++;
         }
 
-      rwb_resetwrbuffer(rwb);
+      memcpy(&rwb->wrbuffer[index * rwb->blocksize], wrbuffer,
+             rwb->blocksize);
     }
 
-  /* writebuffer is empty? Then initialize it */
+  /* Start writing in the background once the dirty limit is reached.
+   * Otherwise, flush whenever the write activity stops.
+   */
 
-  if (rwb->wrnblocks == 0)
+  if (rwb->wrnblocks >= rwb->wrdirtylimit)
     {
-      finfo("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
+#ifdef CONFIG_SCHED_WORKQUEUE
+      rwb_wrstartflush(rwb, 0);
+#else
+      ret = rwb_wrflush(rwb);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
     }
+#if CONFIG_DRVR_WRDELAY != 0
+  else
+    {
+      rwb_wrstartflush(rwb, MSEC2TICK(CONFIG_DRVR_WRDELAY));
+    }
+#endif
 
-  /* Add data to cache */
-
-  finfo("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
-
-  rwb->wrnblocks      += nblocks;
-  rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
-  rwb_wrstarttimeout(rwb);
   return nblocks;
 }
 #endif
@@ -422,129 +517,42 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret = OK;
+  unsigned int first;
+  unsigned int last;
+  unsigned int nmove;
 
   /* Is there a write buffer?  Is data saved in the write buffer? */
 
   if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
     {
-      off_t wrbend;
-      off_t invend;
-
       finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
 
       rwb_semtake(&rwb->wrsem);
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
-
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      invend = startblock + blockcount;
-
-      if (rwb->wrblockstart > invend || wrbend < startblock)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire write buffer. */
-
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = 0;
-          ret = OK;
-        }
+      /* Find the buffered blocks within the region and remove them */
 
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the write buffer
-       */
+      first = rwb_wrsearch(rwb, startblock);
+      last  = rwb_wrsearch(rwb, startblock + blockcount);
 
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
+      if (last > first)
         {
-          uint8_t *src;
-          off_t    block;
-          off_t    offset;
-          size_t   nblocks;
-
-          /* Write the blocks at the end of the media to hardware */
-
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
-
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: wrflush failed: %d\n", ret);
-            }
-
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
-          else
+          nmove = rwb->wrnblocks - last;
+          if (nmove > 0)
             {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
+              memmove(&rwb->wrblock[first], &rwb->wrblock[last],
+                      nmove * sizeof(off_t));
+              memmove(&rwb->wrbuffer[first * rwb->blocksize],
+                      &rwb->wrbuffer[last * rwb->blocksize],
+                      nmove * rwb->blocksize);
             }
-        }
-
-      /* 3. We invalidate a portion at the end of the write buffer */
-
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = wrbend - startblock;
-          ret = OK;
-        }
-
-      /* 4. We invalidate a portion at the beginning of the write buffer */
-
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          uint8_t *src;
-          size_t   ninval;
-          size_t   nkeep;
-
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
-
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
-
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
-
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
-
-          nkeep  = rwb->wrnblocks - ninval;
-
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
-           */
-
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
 
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
-
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+          rwb->wrnblocks -= last - first;
         }
 
       rwb_semgive(&rwb->wrsem);
     }
 
-  return ret;
+  return OK;
 }
 #endif
 
@@ -560,7 +568,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret;
+  int ret = OK;
 
   if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
     {
@@ -612,7 +620,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 
       else if (rhbend > startblock && rhbend <= invend)
         {
-          rwb->rhnblocks = rhbend - startblock;
+          rwb->rhnblocks = startblock - rwb->rhblockstart;
           ret = OK;
         }
 
@@ -677,14 +685,14 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
   DEBUGASSERT(rwb != NULL);
   DEBUGASSERT(rwb->blocksize > 0);
-  DEBUGASSERT(rwb->nblocks > 0);
   DEBUGASSERT(rwb->dev != NULL);
 
   /* Setup so that rwb_uninitialize can handle a failure */
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-  DEBUGASSERT(rwb->wrflush != NULL);
+  DEBUGASSERT(rwb->wrmaxblocks == 0 || rwb->wrflush != NULL);
   rwb->wrbuffer = NULL;
+  rwb->wrblock  = NULL;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
@@ -700,9 +708,15 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       nxsem_init(&rwb->wrsem, 0, 1);
 
-      /* Initialize write buffer parameters */
+      /* Initialize write buffer parameters.  By default, a background
+       * flush is started when the buffer becomes full.
+       */
 
       rwb_resetwrbuffer(rwb);
+      if (rwb->wrdirtylimit == 0 || rwb->wrdirtylimit > rwb->wrmaxblocks)
+        {
+          rwb->wrdirtylimit = rwb->wrmaxblocks;
+        }
 
       /* Allocate the write buffer */
 
@@ -716,6 +730,14 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
               ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
               return -ENOMEM;
             }
+
+          rwb->wrblock = (FAR off_t *)
+            kmm_malloc(rwb->wrmaxblocks * sizeof(off_t));
+          if (!rwb->wrblock)
+            {
+              ferr("Write buffer block list allocation failed\n");
+              return -ENOMEM;
+            }
         }
 
       finfo("Write buffer size: %d bytes\n", allocsize);
@@ -771,6 +793,11 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
         {
           kmm_free(rwb->wrbuffer);
         }
+
+      if (rwb->wrblock)
+        {
+          kmm_free(rwb->wrblock);
+        }
     }
 #endif
 
@@ -874,71 +901,84 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                  size_t nblocks, FAR uint8_t *rdbuffer)
 {
-  int ret = OK;
+#ifdef CONFIG_DRVR_WRITEBUFFER
   size_t readblocks = 0;
+  size_t count;
+  unsigned int index;
+  ssize_t ret;
+#endif
 
   finfo("startblock=%ld nblocks=%ld rdbuffer=%p\n",
         (long)startblock, (long)nblocks, rdbuffer);
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-  /* If the new read data overlaps any part of the write buffer, we
-   * directly copy write buffer to read buffer. This boost performance.
+  /* Blocks that are in the write buffer are newer than the media and are
+   * copied from the write buffer.  The blocks between them are read from
+   * the read-ahead buffer or from the media.
    */
 
   if (rwb->wrmaxblocks > 0)
     {
-      /* If the write buffer overlaps the block(s) requested */
-
       rwb_semtake(&rwb->wrsem);
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
+      while (nblocks > 0)
         {
-          size_t rdblocks = 0;
-          size_t wrnpass  = 0;
+          /* Count the blocks at 'startblock' that are in the write
+           * buffer.
+           */
+
+          index = rwb_wrsearch(rwb, startblock);
+          count = 0;
 
-          if (rwb->wrblockstart > startblock)
+          while (count < nblocks && index + count < rwb->wrnblocks &&
+                 rwb->wrblock[index + count] == startblock + count)
             {
-              rdblocks = rwb->wrblockstart - startblock;
-              ret = rwb_read_(rwb, startblock, rdblocks, rdbuffer);
+              count++;
+            }
+
+          if (count > 0)
+            {
+              memcpy(rdbuffer, &rwb->wrbuffer[index * rwb->blocksize],
+                     count * rwb->blocksize);
+            }
+          else
+            {
+              /* Read up to the next buffered block */
+
+              count = nblocks;
+              if (index < rwb->wrnblocks &&
+                  rwb->wrblock[index] - startblock < (off_t)count)
+                {
+                  count = rwb->wrblock[index] - startblock;
+                }
+
+              ret = rwb_read_(rwb, startblock, count, rdbuffer);
               if (ret < 0)
                 {
                   rwb_semgive(&rwb->wrsem);
-                  return (ssize_t)ret;
+                  return ret;
                 }
 
-              startblock += ret;
-              nblocks    -= ret;
-              rdbuffer   += ret * rwb->blocksize;
-              readblocks += ret;
-            }
-
-          if (rwb->wrblockstart < startblock)
-            {
-              wrnpass = startblock - rwb->wrblockstart;
+              count = ret;
+              if (count == 0)
+                {
+                  break;
+                }
             }
 
-          rdblocks = nblocks > (rwb->wrnblocks - wrnpass) ?
-                    (rwb->wrnblocks - wrnpass) : nblocks;
-          memcpy(rdbuffer, &rwb->wrbuffer[wrnpass * rwb->blocksize],
-                rdblocks * rwb->blocksize);
-
-          startblock += rdblocks;
-          nblocks    -= rdblocks;
-          rdbuffer   += rdblocks * rwb->blocksize;
-          readblocks += rdblocks;
+          startblock += count;
+          nblocks    -= count;
+          rdbuffer   += count * rwb->blocksize;
+          readblocks += count;
         }
 
       rwb_semgive(&rwb->wrsem);
+      return readblocks;
     }
 #endif
 
-  ret = rwb_read_(rwb, startblock, nblocks, rdbuffer);
-  if (ret < 0)
-    return ret;
-
-  return readblocks + ret;
+  return rwb_read_(rwb, startblock, nblocks, rdbuffer);
 }
 
-
 /****************************************************************************
  * Name: rwb_write
  ****************************************************************************/
@@ -957,25 +997,24 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
        * streaming applications.
        */
 
-      rwb_semtake(&rwb->rhsem);
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
-        {
 #ifdef CONFIG_DRVR_INVALIDATE
-          /* Just invalidate the read buffer startblock + nblocks data */
+      /* Just invalidate the read buffer startblock + nblocks data */
 
-          ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
-              rwb_semgive(&rwb->rhsem);
-              return (ssize_t)ret;
-            }
+      ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
+      if (ret < 0)
+        {
+          ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
+          return (ssize_t)ret;
+        }
 #else
+      rwb_semtake(&rwb->rhsem);
+      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
+        {
           rwb_resetrhbuffer(rwb);
-#endif
         }
 
       rwb_semgive(&rwb->rhsem);
+#endif
     }
 #endif
 
@@ -991,12 +1030,17 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
           /* First flush the cache */
 
           rwb_semtake(&rwb->wrsem);
-          rwb_wrflush(rwb);
-          rwb_semgive(&rwb->wrsem);
+          rwb_wrcanceltimeout(rwb);
+          ret = rwb_wrflush(rwb);
 
           /* Then transfer the data directly to the media */
 
-          ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+          if (ret >= 0)
+            {
+              ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+            }
+
+          rwb_semgive(&rwb->wrsem);
         }
       else
         {
@@ -1127,19 +1171,26 @@ int rwb_invalidate(FAR struct rwbuffer_s *rwb,
  * Name: rwb_flush
  *
  * Description:
- *   Flush the write buffer
+ *   Flush the write buffer.  All blocks written before the call are on the
+ *   media when this function returns, so block drivers should call it in
+ *   response to BIOC_FLUSH.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
 int rwb_flush(FAR struct rwbuffer_s *rwb)
 {
-  rwb_semtake(&rwb->wrsem);
-  rwb_wrcanceltimeout(rwb);
-  rwb_wrflush(rwb);
-  rwb_semgive(&rwb->wrsem);
+  int ret = OK;
 
-  return OK;
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->wrsem);
+      rwb_wrcanceltimeout(rwb);
+      ret = rwb_wrflush(rwb);
+      rwb_semgive(&rwb->wrsem);
+    }
+
+  return ret;
 }
 #endif
 
@@ -46,6 +46,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/random.h>
@@ -345,7 +346,7 @@ static void hcsr04_notify(FAR struct hcsr04_dev_s *priv)
         {
           fds->revents |= POLLIN;
           hcsr04_dbg("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
@@ -44,6 +44,7 @@
 #include <poll.h>
 #include <errno.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
@@ -1094,7 +1095,7 @@ static void hts221_notify(FAR struct hts221_dev_s *priv)
         {
           fds->revents |= POLLIN;
           hts221_dbg("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
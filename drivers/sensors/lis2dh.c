@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
@@ -773,7 +774,7 @@ static void lis2dh_notify(FAR struct lis2dh_dev_s *priv)
         {
           fds->revents |= POLLIN;
           lis2dh_dbg("lis2dh: Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
@@ -0,0 +1,678 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SENSORS_NPOLLWAITERS
+#  define CONFIG_SENSORS_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of the upper half driver */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* The lower half driver */
+  FAR struct sensor_event_s *events;    /* Ring buffer of events */
+  unsigned int nevents;                 /* Size of the ring buffer */
+  unsigned int head;                    /* Index of the next event written */
+  unsigned int tail;                    /* Index of the next event read */
+  unsigned int count;                   /* Number of events buffered */
+  uint32_t overruns;                    /* Number of events discarded */
+  uint8_t  crefs;                       /* Number of open references */
+  bool     active;                      /* Sampling has been started */
+  volatile bool waiting;                /* A reader is waiting for data */
+  sem_t    exclsem;                     /* Supports mutual exclusion */
+  sem_t    waitsem;                     /* Waits for events */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,  /* open */
+  sensor_close, /* close */
+  sensor_read,  /* read */
+  0,            /* write */
+  0,            /* seek */
+  sensor_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , sensor_poll /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_pollnotify
+ *
+ * Description:
+ *   Notify all poll() waiters that events are available.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void sensor_pollnotify(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          poll_notify(fds);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      upper->crefs++;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ *
+ * Description:
+ *   Sampling is stopped when the last reference is closed.
+ *
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+
+  (void)nxsem_wait_uninterruptible(&upper->exclsem);
+
+  if (--upper->crefs == 0)
+    {
+      if (upper->active)
+        {
+          (void)lower->ops->activate(lower, false);
+          upper->active = false;
+        }
+
+      flags = enter_critical_section();
+      upper->head  = 0;
+      upper->tail  = 0;
+      upper->count = 0;
+      leave_critical_section(flags);
+    }
+
+  nxsem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many buffered events as fit in the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_event_s *dest = (FAR struct sensor_event_s *)buffer;
+  irqstate_t flags;
+  unsigned int navail;
+  unsigned int nread;
+  unsigned int n;
+  int ret;
+
+  navail = buflen / sizeof(struct sensor_event_s);
+  if (navail == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for at least one event */
+
+  flags = enter_critical_section();
+  while (upper->count == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          nxsem_post(&upper->exclsem);
+          return -EAGAIN;
+        }
+
+      upper->waiting = true;
+      nxsem_post(&upper->exclsem);
+
+      ret = nxsem_wait(&upper->waitsem);
+      upper->waiting = false;
+
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      ret = nxsem_wait(&upper->exclsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* Copy the events.  The ring may wrap, so copy in at most two pieces.
+   * Events pushed while copying land at the head, past the events being
+   * copied, unless the ring overflows.
+   */
+
+  nread = 0;
+  while (nread < navail && upper->count > 0)
+    {
+      n = upper->nevents - upper->tail;
+      if (n > upper->count)
+        {
+          n = upper->count;
+        }
+
+      if (n > navail - nread)
+        {
+          n = navail - nread;
+        }
+
+      memcpy(&dest[nread], &upper->events[upper->tail],
+             n * sizeof(struct sensor_event_s));
+
+      upper->tail   = (upper->tail + n) % upper->nevents;
+      upper->count -= n;
+      nread        += n;
+    }
+
+  leave_critical_section(flags);
+  nxsem_post(&upper->exclsem);
+
+  return nread * sizeof(struct sensor_event_s);
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case SNIOC_ACTIVATE:
+        {
+          bool enable = (bool)arg;
+
+          if (enable != upper->active)
+            {
+              ret = lower->ops->activate(lower, enable);
+              if (ret >= 0)
+                {
+                  upper->active = enable;
+                }
+            }
+        }
+        break;
+
+      case SNIOC_SET_PERIOD:
+        {
+          FAR uint32_t *period = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (period == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else if (lower->ops->set_period == NULL)
+            {
+              ret = -ENOTSUP;
+            }
+          else
+            {
+              if (*period < lower->info.minperiod)
+                {
+                  *period = lower->info.minperiod;
+                }
+
+              ret = lower->ops->set_period(lower, period);
+            }
+        }
+        break;
+
+      case SNIOC_SET_BATCH:
+        {
+          FAR uint32_t *latency = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (latency == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else if (lower->ops->batch == NULL)
+            {
+              /* Without a FIFO, every sample is reported immediately */
+
+              *latency = 0;
+            }
+          else
+            {
+              ret = lower->ops->batch(lower, latency);
+            }
+        }
+        break;
+
+      case SNIOC_FLUSH:
+        if (lower->ops->flush != NULL)
+          {
+            ret = lower->ops->flush(lower);
+          }
+        break;
+
+      case SNIOC_GET_INFO:
+        {
+          FAR struct sensor_info_s *info =
+            (FAR struct sensor_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              *info          = lower->info;
+              info->overruns = upper->overruns;
+            }
+        }
+        break;
+
+      default:
+        if (lower->ops->ioctl != NULL)
+          {
+            ret = lower->ops->ioctl(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          /* Report immediately if events are already buffered */
+
+          flags = enter_critical_section();
+          if (upper->count > 0)
+            {
+              sensor_pollnotify(upper);
+            }
+
+          leave_critical_section(flags);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_push_events
+ *
+ * Description:
+ *   Called by the lower half to report one or more samples.
+ *
+ ****************************************************************************/
+
+void sensor_push_events(FAR struct sensor_lowerhalf_s *lower,
+                        FAR const struct sensor_event_s *events,
+                        unsigned int nevents)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  irqstate_t flags;
+  unsigned int n;
+
+  DEBUGASSERT(lower != NULL && lower->upper != NULL && events != NULL);
+  upper = (FAR struct sensor_upperhalf_s *)lower->upper;
+
+  /* Only the newest events are kept if there are more than fit */
+
+  if (nevents > upper->nevents)
+    {
+      upper->overruns += nevents - upper->nevents;
+      events          += nevents - upper->nevents;
+      nevents          = upper->nevents;
+    }
+
+  if (nevents == 0)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Discard the oldest events if the ring would overflow */
+
+  if (upper->count + nevents > upper->nevents)
+    {
+      n                = upper->count + nevents - upper->nevents;
+      upper->tail      = (upper->tail + n) % upper->nevents;
+      upper->count    -= n;
+      upper->overruns += n;
+    }
+
+  /* Copy the events, in at most two pieces */
+
+  while (nevents > 0)
+    {
+      n = upper->nevents - upper->head;
+      if (n > nevents)
+        {
+          n = nevents;
+        }
+
+      memcpy(&upper->events[upper->head], events,
+             n * sizeof(struct sensor_event_s));
+
+      upper->head   = (upper->head + n) % upper->nevents;
+      upper->count += n;
+      events       += n;
+      nevents      -= n;
+    }
+
+  /* Wake up any waiting reader and poll() waiters */
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      nxsem_post(&upper->waitsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  sensor_pollnotify(upper);
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half as a character driver.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower,
+                    FAR const char *path, unsigned int nevents)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL &&
+              lower->ops->activate != NULL && path != NULL);
+
+  if (nevents == 0)
+    {
+      return -EINVAL;
+    }
+
+  upper = (FAR struct sensor_upperhalf_s *)
+    kmm_zalloc(sizeof(struct sensor_upperhalf_s));
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->events = (FAR struct sensor_event_s *)
+    kmm_malloc(nevents * sizeof(struct sensor_event_s));
+  if (upper->events == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_upper;
+    }
+
+  upper->lower   = lower;
+  upper->nevents = nevents;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->waitsem, SEM_PRIO_NONE);
+
+  lower->upper = upper;
+
+  ret = register_driver(path, &g_sensor_fops, 0444, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: register_driver failed: %d\n", ret);
+      goto errout_with_sem;
+    }
+
+  return OK;
+
+errout_with_sem:
+  lower->upper = NULL;
+  nxsem_destroy(&upper->exclsem);
+  nxsem_destroy(&upper->waitsem);
+  kmm_free(upper->events);
+
+errout_with_upper:
+  kmm_free(upper);
+  return ret;
+}
+
+#endif /* CONFIG_SENSORS_UPPER */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -103,6 +104,12 @@ static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
+static size_t  uart_rawlen(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen);
+static size_t  uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                             size_t buflen);
+static ssize_t uart_putxmitbuffer(FAR uart_dev_t *dev, FAR const char *buffer,
+                                  size_t buflen, bool oktoblock);
 
 /* Character driver methods */
 
@@ -110,6 +117,8 @@ static int     uart_open(FAR struct file *filep);
 static int     uart_close(FAR struct file *filep);
 static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
+static ssize_t uart_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                           int iovcnt);
 static int     uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 #ifndef CONFIG_DISABLE_POLL
 static int     uart_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
@@ -121,18 +130,20 @@ static int     uart_poll(FAR struct file *filep, FAR struct pollfd *fds, bool se
 
 static const struct file_operations g_serialops =
 {
-  uart_open,  /* open */
-  uart_close, /* close */
-  uart_read,  /* read */
-  uart_write, /* write */
-  0,          /* seek */
-  uart_ioctl  /* ioctl */
+  uart_open,    /* open */
+  uart_close,   /* close */
+  uart_read,    /* read */
+  uart_write,   /* write */
+  0,            /* seek */
+  uart_ioctl    /* ioctl */
 #ifndef CONFIG_DISABLE_POLL
-  , uart_poll /* poll */
+  , uart_poll   /* poll */
 #endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL      /* unlink */
+  , NULL        /* unlink */
 #endif
+  , NULL        /* readv */
+  , uart_writev /* writev */
 };
 
 /************************************************************************************
@@ -203,7 +214,7 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -1056,88 +1067,159 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 }
 
 /************************************************************************************
- * Name: uart_write
+ * Name: uart_rawlen
+ *
+ * Description:
+ *   Return the number of bytes at the beginning of the user buffer that need no
+ *   output post-processing and can be copied into the TX buffer as they are.
+ *
  ************************************************************************************/
 
-static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
+static size_t uart_rawlen(FAR uart_dev_t *dev, FAR const char *buffer,
                           size_t buflen)
 {
-  FAR struct inode *inode    = filep->f_inode;
-  FAR uart_dev_t   *dev      = inode->i_private;
-  ssize_t           nwritten = buflen;
-  bool              oktoblock;
-  int               ret;
-  char              ch;
-
-  /* We may receive serial writes through this path from interrupt handlers and
-   * from debug output in the IDLE task!  In these cases, we will need to do things
-   * a little differently.
-   */
+  bool crnl = false;
+  bool nlcr = false;
+  size_t i;
 
-  if (up_interrupt_context() || sched_idletask())
+#ifdef CONFIG_SERIAL_TERMIOS
+  if ((dev->tc_oflag & OPOST) != 0)
     {
-      irqstate_t flags;
+      crnl = (dev->tc_oflag & OCRNL) != 0;
+      nlcr = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+    }
+#else
+  nlcr = dev->isconsole;
+#endif
 
-#ifdef CONFIG_SERIAL_REMOVABLE
-      /* If the removable device is no longer connected, refuse to write to
-       * the device.
-       */
+  if (!crnl && !nlcr)
+    {
+      return buflen;
+    }
 
-      if (dev->disconnected)
+  for (i = 0; i < buflen; i++)
+    {
+      if ((crnl && buffer[i] == '\r') || (nlcr && buffer[i] == '\n'))
         {
-          return -ENOTCONN;
+          break;
         }
-#endif
+    }
 
-      flags = enter_critical_section();
-      ret = uart_irqwrite(dev, buffer, buflen);
-      leave_critical_section(flags);
+  return i;
+}
 
-      return ret;
-    }
+/************************************************************************************
+ * Name: uart_copyxmit
+ *
+ * Description:
+ *   Copy as many bytes as will fit from the user buffer into the TX buffer with
+ *   memcpy(), never blocking.  Returns the number of bytes copied.  The caller
+ *   holds xmit.sem.  Only the interrupt (or DMA completion) logic moves the tail
+ *   and it only ever frees space, so a stale tail is always safe.
+ *
+ ************************************************************************************/
 
-  /* Only one user can access dev->xmit.head at a time */
+static size_t uart_copyxmit(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct uart_buffer_s *xmit = &dev->xmit;
+  size_t ncopied = 0;
+  int head = xmit->head;
+  int tail = xmit->tail;
+  int nfree;
 
-  ret = (ssize_t)uart_takesem(&dev->xmit.sem, true);
-  if (ret < 0)
+  while (buflen > 0)
     {
-      /* A signal received while waiting for access to the xmit.head will
-       * abort the transfer.  After the transfer has started, we are committed
-       * and signals will be ignored.
+      /* Get the contiguous free space at the head, always leaving one slot
+       * empty to distinguish a full buffer from an empty one.
        */
 
-      return ret;
-    }
+      if (head >= tail)
+        {
+          nfree = xmit->size - head;
+          if (tail == 0)
+            {
+              nfree--;
+            }
+        }
+      else
+        {
+          nfree = tail - head - 1;
+        }
 
-#ifdef CONFIG_SERIAL_REMOVABLE
-  /* If the removable device is no longer connected, refuse to write to the
-   * device.  This check occurs after taking the xmit.sem because the
-   * disconnection event might have occurred while we were waiting for
-   * access to the transmit buffers.
-   */
+      if (nfree <= 0)
+        {
+          break;
+        }
 
-  if (dev->disconnected)
-    {
-      uart_givesem(&dev->xmit.sem);
-      return -ENOTCONN;
+      if ((size_t)nfree > buflen)
+        {
+          nfree = buflen;
+        }
+
+      memcpy(&xmit->buffer[head], buffer, nfree);
+
+      head += nfree;
+      if (head >= xmit->size)
+        {
+          head = 0;
+        }
+
+      xmit->head  = head;
+      buffer     += nfree;
+      buflen     -= nfree;
+      ncopied    += nfree;
     }
-#endif
 
-  /* Can the following loop block, waiting for space in the TX
-   * buffer?
-   */
+  return ncopied;
+}
 
-  oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
+/************************************************************************************
+ * Name: uart_putxmitbuffer
+ *
+ * Description:
+ *   Copy one user buffer into the TX buffer, performing any output
+ *   post-processing.  Called with xmit.sem held and the TX interrupt disabled.
+ *   Returns the number of bytes transferred if any were transferred; otherwise
+ *   the negated errno value.
+ *
+ ************************************************************************************/
+
+static ssize_t uart_putxmitbuffer(FAR uart_dev_t *dev, FAR const char *buffer,
+                                  size_t buflen, bool oktoblock)
+{
+  ssize_t nwritten = buflen;
+  size_t  nraw;
+  int     ret;
+  char    ch;
 
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
    */
 
-  uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  while (buflen > 0)
     {
-      ch  = *buffer++;
+      /* Copy any run of bytes that needs no post-processing in bulk */
+
+      nraw = uart_rawlen(dev, buffer, buflen);
+      if (nraw > 0)
+        {
+          nraw    = uart_copyxmit(dev, buffer, nraw);
+          buffer += nraw;
+          buflen -= nraw;
+
+          if (buflen == 0)
+            {
+              break;
+            }
+        }
+
+      /* Then handle the next byte individually.  It either needs
+       * post-processing or it did not fit and we may have to wait for space.
+       */
+
+      ch  = *buffer;
       ret = OK;
 
 #ifdef CONFIG_SERIAL_TERMIOS
@@ -1220,6 +1302,144 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
           break;
         }
+
+      buffer++;
+      buflen--;
+    }
+
+  return nwritten;
+}
+
+/************************************************************************************
+ * Name: uart_write
+ ************************************************************************************/
+
+static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
+                          size_t buflen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buffer;
+  iov.iov_len  = buflen;
+
+  return uart_writev(filep, &iov, 1);
+}
+
+/************************************************************************************
+ * Name: uart_writev
+ *
+ * Description:
+ *   Gather-write a list of buffers.  The TX buffer is claimed once for the
+ *   whole list and the TX interrupt is enabled only after all of the buffers
+ *   have been queued.
+ *
+ ************************************************************************************/
+
+static ssize_t uart_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                           int iovcnt)
+{
+  FAR struct inode *inode    = filep->f_inode;
+  FAR uart_dev_t   *dev      = inode->i_private;
+  ssize_t           nwritten = 0;
+  bool              oktoblock;
+  ssize_t           ret;
+  int               i;
+
+  /* We may receive serial writes through this path from interrupt handlers and
+   * from debug output in the IDLE task!  In these cases, we will need to do things
+   * a little differently.
+   */
+
+  if (up_interrupt_context() || sched_idletask())
+    {
+      irqstate_t flags;
+
+#ifdef CONFIG_SERIAL_REMOVABLE
+      /* If the removable device is no longer connected, refuse to write to
+       * the device.
+       */
+
+      if (dev->disconnected)
+        {
+          return -ENOTCONN;
+        }
+#endif
+
+      flags = enter_critical_section();
+      for (i = 0; i < iovcnt; i++)
+        {
+          ret = uart_irqwrite(dev, (FAR const char *)iov[i].iov_base,
+                              iov[i].iov_len);
+          if (ret < 0)
+            {
+              nwritten = ret;
+              break;
+            }
+
+          nwritten += ret;
+        }
+
+      leave_critical_section(flags);
+      return nwritten;
+    }
+
+  /* Only one user can access dev->xmit.head at a time */
+
+  ret = (ssize_t)uart_takesem(&dev->xmit.sem, true);
+  if (ret < 0)
+    {
+      /* A signal received while waiting for access to the xmit.head will
+       * abort the transfer.  After the transfer has started, we are committed
+       * and signals will be ignored.
+       */
+
+      return ret;
+    }
+
+#ifdef CONFIG_SERIAL_REMOVABLE
+  /* If the removable device is no longer connected, refuse to write to the
+   * device.  This check occurs after taking the xmit.sem because the
+   * disconnection event might have occurred while we were waiting for
+   * access to the transmit buffers.
+   */
+
+  if (dev->disconnected)
+    {
+      uart_givesem(&dev->xmit.sem);
+      return -ENOTCONN;
+    }
+#endif
+
+  /* Can the following loop block, waiting for space in the TX
+   * buffer?
+   */
+
+  oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
+
+  /* Queue each buffer in turn, stopping at the first short transfer */
+
+  uart_disabletxint(dev);
+  for (i = 0; i < iovcnt; i++)
+    {
+      ret = uart_putxmitbuffer(dev, (FAR const char *)iov[i].iov_base,
+                               iov[i].iov_len, oktoblock);
+      if (ret < 0)
+        {
+          /* Report the error only if nothing has been transferred */
+
+          if (nwritten == 0)
+            {
+              nwritten = ret;
+            }
+
+          break;
+        }
+
+      nwritten += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
     }
 
   if (dev->xmit.head != dev->xmit.tail)
@@ -44,6 +44,7 @@
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/serial/serial.h>
 
 #ifdef CONFIG_SERIAL_DMA
@@ -140,18 +141,25 @@ static int uart_recvchars_signo(FAR uart_dev_t *dev)
  * Name: uart_xmitchars_dma
  *
  * Description:
- *   Set up to transfer bytes from the TX circular buffer using DMA
+ *   Set up to transfer bytes from the TX circular buffer using DMA.  All of the
+ *   buffered data is sent in one transfer, as two chained segments if it wraps
+ *   around the end of the buffer.  Nothing is done if a transfer is already in
+ *   progress; the new data will be sent when that one completes.  So the lower
+ *   half dmatxavail() method may simply call this function.
  *
  ************************************************************************************/
 
 void uart_xmitchars_dma(FAR uart_dev_t *dev)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  irqstate_t flags;
 
-  if (dev->xmit.head == dev->xmit.tail)
+  flags = enter_critical_section();
+  if (dev->xmit.head == dev->xmit.tail || xfer->length > 0)
     {
-      /* No data to transfer. */
+      /* No data to transfer or a transfer is already in progress. */
 
+      leave_critical_section(flags);
       return;
     }
 
@@ -171,6 +179,7 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev)
     }
 
   uart_dmasend(dev);
+  leave_critical_section(flags);
 }
 
 /************************************************************************************
@@ -179,7 +188,9 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev)
  * Description:
  *   Perform operations necessary at the complete of DMA including adjusting the
  *   TX circular buffer indices and waking up of any threads that may have been
- *   waiting for space to become available in the TX circular buffer.
+ *   waiting for space to become available in the TX circular buffer.  If more
+ *   data was queued while the transfer was in progress, the next transfer is
+ *   started immediately so that the transmitter is never left idle.
  *
  ************************************************************************************/
 
@@ -203,13 +214,19 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
     {
       uart_datasent(dev);
     }
+
+  /* Chain the next transfer, if there is more data to send */
+
+  uart_xmitchars_dma(dev);
 }
 
 /************************************************************************************
  * Name: uart_recvchars_dma
  *
  * Description:
- *   Set up to receive bytes into the RX circular buffer using DMA
+ *   Set up to receive bytes into the RX circular buffer using DMA.  Nothing is
+ *   done if a transfer is already in progress, so the lower half dmarxfree()
+ *   method may simply call this function.
  *
  ************************************************************************************/
 
@@ -224,6 +241,13 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
   bool is_full;
   int nexthead;
 
+  /* Nothing to do if a transfer is already in progress */
+
+  if (xfer->length > 0 || xfer->nlength > 0)
+    {
+      return;
+    }
+
   /* If RX buffer is empty move tail and head to zero position */
 
   if (rxbuf->head == rxbuf->tail)
@@ -340,6 +364,11 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
  *   RX circular buffer indices and waking up of any threads that may have been
  *   waiting for new data to become available in the RX circular buffer.
  *
+ *   The lower half may call this when the transfer completes or, in idle-line
+ *   mode, as soon as the line goes idle with xfer->nbytes set to the number of
+ *   bytes received so far.  Reception is then restarted into the remaining free
+ *   space of the RX buffer.
+ *
  ************************************************************************************/
 
 void uart_recvchars_done(FAR uart_dev_t *dev)
@@ -382,6 +411,12 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
       uart_reset_sem(dev);
     }
 #endif
+
+  /* Restart reception.  If the RX buffer is full, reception resumes when the
+   * reader frees space and the lower half dmarxfree() method is called.
+   */
+
+  uart_recvchars_dma(dev);
 }
 
 #endif /* CONFIG_SERIAL_DMA */
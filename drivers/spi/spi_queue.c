@@ -0,0 +1,223 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The low priority work queue is preferred.  If it is not enabled, LPWORK
+ * will be the same as HPWORK.
+ */
+
+#define SPIWORK LPWORK
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_worker
+ *
+ * Description:
+ *   Perform queued sequences until the queue is empty.
+ *
+ ****************************************************************************/
+
+static void spi_queue_worker(FAR void *arg)
+{
+  FAR struct spi_queue_s *queue = (FAR struct spi_queue_s *)arg;
+  FAR struct spi_request_s *req;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req = (FAR struct spi_request_s *)sq_remfirst(&queue->pending);
+      if (req == NULL)
+        {
+          queue->busy = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      req->result = spi_transfer(queue->spi, req->seq);
+      if (req->result < 0)
+        {
+          spierr("ERROR: spi_transfer failed: %d\n", req->result);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Initialize a transaction queue for an SPI bus.
+ *
+ ****************************************************************************/
+
+void spi_queue_initialize(FAR struct spi_queue_s *queue,
+                          FAR struct spi_dev_s *spi)
+{
+  DEBUGASSERT(queue != NULL && spi != NULL);
+
+  memset(queue, 0, sizeof(struct spi_queue_s));
+  sq_init(&queue->pending);
+  queue->spi = spi;
+}
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR struct spi_request_s *prev;
+  FAR struct spi_request_s *next;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(queue != NULL && req != NULL && req->seq != NULL);
+
+  req->result = -EINPROGRESS;
+
+  /* Insert the request after all requests of the same or higher priority */
+
+  flags = enter_critical_section();
+
+  for (prev = NULL,
+       next = (FAR struct spi_request_s *)sq_peek(&queue->pending);
+       next != NULL && next->priority >= req->priority;
+       prev = next, next = next->flink)
+    {
+    }
+
+  if (prev == NULL)
+    {
+      sq_addfirst((FAR sq_entry_t *)req, &queue->pending);
+    }
+  else
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)req,
+                  &queue->pending);
+    }
+
+  /* Start the worker if it is not already running */
+
+  if (!queue->busy)
+    {
+      queue->busy = true;
+      ret = work_queue(SPIWORK, &queue->work, spi_queue_worker, queue, 0);
+      if (ret < 0)
+        {
+          queue->busy = false;
+          sq_rem((FAR sq_entry_t *)req, &queue->pending);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  flags = enter_critical_section();
+  for (entry = sq_peek(&queue->pending); entry != NULL; entry = entry->flink)
+    {
+      if (entry == (FAR sq_entry_t *)req)
+        {
+          sq_rem(entry, &queue->pending);
+          req->result = -ECANCELED;
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_QUEUE */
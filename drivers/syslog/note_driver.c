@@ -88,57 +88,15 @@ static const struct file_operations note_fops =
 static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
                          size_t buflen)
 {
-  ssize_t notelen;
-  ssize_t retlen ;
-
   DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
 
-  /* Then loop, adding as many notes as possible to the user buffer. */
-
-  retlen = 0;
-  sched_lock();
-  do
-    {
-     /* Get the next note (removing it from the buffer) */
-
-     notelen = sched_note_get((FAR uint8_t *)buffer, buflen);
-     if (notelen < 0)
-       {
-         /* We were unable to read the next note, probably because it will
-          * not fit into the user buffer.
-          */
-
-         if (retlen == 0)
-           {
-             /* If nothing was read then report the error.  Otherwise,
-              * just silently drop the note.
-              */
-
-             retlen = notelen;
-           }
-
-         break;
-       }
-
-      /* Update pointers from the note that was transferred */
-
-      retlen += notelen;
-      buffer += notelen;
-      buflen -= notelen;
-
-      /* Will the next note fit?  There is a race here and even if the next
-       * note will fit, it may fail still when sched_note_get() is called.
-       *
-       * It won't fit (or an error occurred).  Return what we have without
-       * trying to get the next note (which would cause it to be deleted).
-       */
-
-      notelen = sched_note_size();
-    }
-  while (notelen > 0 && notelen <= buflen);
+  /* Transfer as many complete notes as will fit into the user buffer.  The
+   * notes are returned in their binary form so that the data read from
+   * /dev/note can be streamed as-is to a host (via a trace transport such
+   * as RTT or USB) and decoded there.
+   */
 
-  sched_unlock();
-  return retlen;
+  return sched_note_read((FAR uint8_t *)buffer, buflen);
 }
 
 /****************************************************************************
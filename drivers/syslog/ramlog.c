@@ -61,8 +61,42 @@
 
 #include <nuttx/irq.h>
 
+#ifdef CONFIG_RAMLOG_LZF
+#  include <lzf.h>
+#endif
+
 #ifdef CONFIG_RAMLOG
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_RAMLOG_CONSOLE) && !defined(CONFIG_RAMLOG_SYSLOG)
+#  undef CONFIG_RAMLOG_LZF
+#  undef CONFIG_RAMLOG_PERSIST
+#endif
+
+#ifdef CONFIG_RAMLOG_LZF
+#  ifndef CONFIG_RAMLOG_LZF_BLOCKSIZE
+#    define CONFIG_RAMLOG_LZF_BLOCKSIZE 256
+#  endif
+
+/* The ring must always have room for one complete, uncompressed block */
+
+#  if CONFIG_RAMLOG_BUFSIZE < (CONFIG_RAMLOG_LZF_BLOCKSIZE + \
+                               LZF_TYPE0_HDR_SIZE + 2)
+#    error CONFIG_RAMLOG_BUFSIZE is too small for CONFIG_RAMLOG_LZF_BLOCKSIZE
+#  endif
+#endif
+
+#ifdef CONFIG_RAMLOG_PERSIST
+#  ifndef CONFIG_RAMLOG_PERSIST_SECTION
+#    define CONFIG_RAMLOG_PERSIST_SECTION ".noinit"
+#  endif
+
+#  define RAMLOG_PERSIST_MAGIC 0x524d4c47  /* "RMLG" */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +125,36 @@ struct ramlog_dev_s
 #endif
 };
 
+/* This is the RAM used by the console RAM log and/or the syslogging
+ * function.  If CONFIG_RAMLOG_PERSIST is selected, it lives in a section
+ * that is not initialized at start-up and also holds a copy of the ring
+ * indices so that the log contents can be recovered after a warm reset.
+ */
+
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+struct ramlog_sysbuf_s
+{
+#ifdef CONFIG_RAMLOG_PERSIST
+  uint32_t          rs_magic;        /* RAMLOG_PERSIST_MAGIC if valid */
+  uint32_t          rs_check;        /* Check value over the saved indices */
+  uint16_t          rs_head;         /* Saved copy of rl_head */
+  uint16_t          rs_tail;         /* Saved copy of rl_tail */
+#endif
+#ifdef CONFIG_RAMLOG_LZF
+  uint16_t          rs_wrlen;        /* Bytes collected in rs_wrbuf */
+
+  /* The block being collected.  The data begins at LZF_TYPE0_HDR_SIZE;
+   * lzf_compress() writes the header in front of the data if the block
+   * will not compress.
+   */
+
+  uint8_t           rs_wrbuf[LZF_TYPE0_HDR_SIZE +
+                             CONFIG_RAMLOG_LZF_BLOCKSIZE];
+#endif
+  char              rs_buffer[CONFIG_RAMLOG_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -107,7 +171,23 @@ static int ramlog_flush(void);
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#ifdef CONFIG_RAMLOG_PERSIST
+static uint32_t ramlog_syscheck(FAR struct ramlog_sysbuf_s *sysbuf);
+static void ramlog_syssave(FAR struct ramlog_dev_s *priv);
+static void ramlog_sysrestore(FAR struct ramlog_dev_s *priv);
+#endif
+#ifdef CONFIG_RAMLOG_LZF
+static size_t ramlog_ringused(FAR struct ramlog_dev_s *priv);
+static void ramlog_ringput(FAR struct ramlog_dev_s *priv,
+                           FAR const uint8_t *data, size_t len);
+static void ramlog_ringget(FAR struct ramlog_dev_s *priv,
+                           FAR uint8_t *data, size_t len);
+static size_t ramlog_reclen(FAR struct ramlog_dev_s *priv);
+static void ramlog_compress(FAR struct ramlog_dev_s *priv);
+#endif
+static bool ramlog_isempty(FAR struct ramlog_dev_s *priv);
+static int ramlog_getc(FAR struct ramlog_dev_s *priv);
+static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
 
 /* Character driver methods */
 
@@ -158,7 +238,33 @@ static const struct file_operations g_ramlogfops =
  */
 
 #if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
-static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE];
+#ifdef CONFIG_RAMLOG_PERSIST
+static struct ramlog_sysbuf_s g_sysbuffer
+  __attribute__((section(CONFIG_RAMLOG_PERSIST_SECTION)));
+
+/* True once the persistent state has been validated after this boot */
+
+static bool g_sysrestored;
+#else
+static struct ramlog_sysbuf_s g_sysbuffer;
+#endif
+
+#ifdef CONFIG_RAMLOG_LZF
+/* Compression work buffers.  These are only used with interrupts
+ * disabled (g_lzfhtab, g_lzfout) or by the reader holding rl_exclsem
+ * (g_lzfin, g_lzfrd).
+ */
+
+static lzf_state_t g_lzfhtab;
+static uint8_t g_lzfout[LZF_TYPE1_HDR_SIZE + CONFIG_RAMLOG_LZF_BLOCKSIZE];
+static uint8_t g_lzfin[LZF_TYPE0_HDR_SIZE + CONFIG_RAMLOG_LZF_BLOCKSIZE];
+
+/* The most recently decompressed block and the read position in it */
+
+static uint8_t g_lzfrd[CONFIG_RAMLOG_LZF_BLOCKSIZE];
+static uint16_t g_lzfrdlen;
+static uint16_t g_lzfrdpos;
+#endif
 
 /* This is the device structure for the console or syslogging function.  It
  * must be statically initialized because the RAMLOG ramlog_putc function
@@ -177,7 +283,7 @@ static struct ramlog_dev_s g_sysdev =
   SEM_INITIALIZER(0),            /* rl_waitsem */
 #endif
   CONFIG_RAMLOG_BUFSIZE,         /* rl_bufsize */
-  g_sysbuffer                    /* rl_buffer */
+  g_sysbuffer.rs_buffer          /* rl_buffer */
 };
 #endif
 
@@ -219,7 +325,7 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
           fds->revents |= (fds->events & eventset);
           if (fds->revents != 0)
             {
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
       leave_critical_section(flags);
@@ -229,6 +335,440 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 #  define ramlog_pollnotify(priv,event)
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syscheck
+ *
+ * Description:
+ *   Return the check value for the saved ring state.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_PERSIST
+static uint32_t ramlog_syscheck(FAR struct ramlog_sysbuf_s *sysbuf)
+{
+  uint32_t check;
+
+  check = ~((uint32_t)sysbuf->rs_head << 16 | sysbuf->rs_tail);
+#ifdef CONFIG_RAMLOG_LZF
+  check ^= (uint32_t)sysbuf->rs_wrlen * 0x9e3779b1;
+#endif
+  return check;
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_syssave
+ *
+ * Description:
+ *   Save the ring indices in the persistent RAM log state.  Must be called
+ *   from within a critical section after the indices are modified.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_PERSIST
+static void ramlog_syssave(FAR struct ramlog_dev_s *priv)
+{
+  FAR struct ramlog_sysbuf_s *sysbuf = &g_sysbuffer;
+
+  sysbuf->rs_head  = priv->rl_head;
+  sysbuf->rs_tail  = priv->rl_tail;
+  sysbuf->rs_check = ramlog_syscheck(sysbuf);
+}
+#else
+#  define ramlog_syssave(priv)
+#endif
+
+/****************************************************************************
+ * Name: ramlog_sysrestore
+ *
+ * Description:
+ *   The first time that the RAM log is used after a reset, recover its
+ *   contents from the persistent state if that state is valid; otherwise
+ *   (as after a cold start) begin with an empty log.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_PERSIST
+static void ramlog_sysrestore(FAR struct ramlog_dev_s *priv)
+{
+  FAR struct ramlog_sysbuf_s *sysbuf = &g_sysbuffer;
+  irqstate_t flags;
+
+  if (g_sysrestored)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  if (!g_sysrestored)
+    {
+      if (sysbuf->rs_magic == RAMLOG_PERSIST_MAGIC &&
+          sysbuf->rs_check == ramlog_syscheck(sysbuf) &&
+          sysbuf->rs_head < CONFIG_RAMLOG_BUFSIZE &&
+          sysbuf->rs_tail < CONFIG_RAMLOG_BUFSIZE
+#ifdef CONFIG_RAMLOG_LZF
+          && sysbuf->rs_wrlen < CONFIG_RAMLOG_LZF_BLOCKSIZE
+#endif
+         )
+        {
+          /* The log survived the reset.  Pick up where we left off. */
+
+          priv->rl_head = sysbuf->rs_head;
+          priv->rl_tail = sysbuf->rs_tail;
+        }
+      else
+        {
+          /* The contents are not valid.  Start with an empty log. */
+
+#ifdef CONFIG_RAMLOG_LZF
+          sysbuf->rs_wrlen = 0;
+#endif
+          sysbuf->rs_magic = RAMLOG_PERSIST_MAGIC;
+          priv->rl_head    = 0;
+          priv->rl_tail    = 0;
+          ramlog_syssave(priv);
+        }
+
+      g_sysrestored = true;
+    }
+
+  leave_critical_section(flags);
+}
+#else
+#  define ramlog_sysrestore(priv)
+#endif
+
+/****************************************************************************
+ * Name: ramlog_ringused
+ *
+ * Description:
+ *   Return the number of bytes of compressed records in the ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_LZF
+static size_t ramlog_ringused(FAR struct ramlog_dev_s *priv)
+{
+  if (priv->rl_head >= priv->rl_tail)
+    {
+      return priv->rl_head - priv->rl_tail;
+    }
+
+  return priv->rl_bufsize - priv->rl_tail + priv->rl_head;
+}
+
+/****************************************************************************
+ * Name: ramlog_ringput
+ *
+ * Description:
+ *   Copy data into the ring at the head index.  The caller has ensured
+ *   that there is space.
+ *
+ ****************************************************************************/
+
+static void ramlog_ringput(FAR struct ramlog_dev_s *priv,
+                           FAR const uint8_t *data, size_t len)
+{
+  size_t head = priv->rl_head;
+  size_t n;
+
+  n = priv->rl_bufsize - head;
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(&priv->rl_buffer[head], data, n);
+  memcpy(priv->rl_buffer, data + n, len - n);
+
+  head += len;
+  if (head >= priv->rl_bufsize)
+    {
+      head -= priv->rl_bufsize;
+    }
+
+  priv->rl_head = head;
+}
+
+/****************************************************************************
+ * Name: ramlog_ringget
+ *
+ * Description:
+ *   Remove data from the ring at the tail index.  If data is NULL, the
+ *   bytes are discarded.
+ *
+ ****************************************************************************/
+
+static void ramlog_ringget(FAR struct ramlog_dev_s *priv,
+                           FAR uint8_t *data, size_t len)
+{
+  size_t tail = priv->rl_tail;
+  size_t n;
+
+  if (data != NULL)
+    {
+      n = priv->rl_bufsize - tail;
+      if (n > len)
+        {
+          n = len;
+        }
+
+      memcpy(data, &priv->rl_buffer[tail], n);
+      memcpy(data + n, priv->rl_buffer, len - n);
+    }
+
+  tail += len;
+  if (tail >= priv->rl_bufsize)
+    {
+      tail -= priv->rl_bufsize;
+    }
+
+  priv->rl_tail = tail;
+}
+
+/****************************************************************************
+ * Name: ramlog_reclen
+ *
+ * Description:
+ *   Return the size of the record at the tail of the ring, including its
+ *   LZF header.  Zero is returned if the ring does not hold a valid
+ *   record.
+ *
+ ****************************************************************************/
+
+static size_t ramlog_reclen(FAR struct ramlog_dev_s *priv)
+{
+  uint8_t hdr[LZF_TYPE1_HDR_SIZE];
+  size_t tail = priv->rl_tail;
+  size_t used;
+  size_t len;
+  int i;
+
+  used = ramlog_ringused(priv);
+  if (used < LZF_TYPE0_HDR_SIZE)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < LZF_TYPE1_HDR_SIZE; i++)
+    {
+      hdr[i] = priv->rl_buffer[tail];
+      if (++tail >= priv->rl_bufsize)
+        {
+          tail = 0;
+        }
+    }
+
+  if (hdr[0] != 'Z' || hdr[1] != 'V')
+    {
+      return 0;
+    }
+
+  if (hdr[2] == LZF_TYPE0_HDR)
+    {
+      len = (size_t)hdr[3] << 8 | hdr[4];
+      len += LZF_TYPE0_HDR_SIZE;
+    }
+  else if (hdr[2] == LZF_TYPE1_HDR)
+    {
+      len = (size_t)hdr[3] << 8 | hdr[4];
+      if (len >= CONFIG_RAMLOG_LZF_BLOCKSIZE ||
+          ((size_t)hdr[5] << 8 | hdr[6]) > CONFIG_RAMLOG_LZF_BLOCKSIZE)
+        {
+          return 0;
+        }
+
+      len += LZF_TYPE1_HDR_SIZE;
+    }
+  else
+    {
+      return 0;
+    }
+
+  if (len > used || len > LZF_TYPE0_HDR_SIZE + CONFIG_RAMLOG_LZF_BLOCKSIZE)
+    {
+      return 0;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ramlog_compress
+ *
+ * Description:
+ *   Compress the collected block and add it to the ring as a new record,
+ *   discarding the oldest records as necessary to make room.  Must be
+ *   called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void ramlog_compress(FAR struct ramlog_dev_s *priv)
+{
+  FAR struct ramlog_sysbuf_s *sysbuf = &g_sysbuffer;
+  FAR struct lzf_header_s *header;
+  size_t reclen;
+  size_t oldlen;
+
+  /* Try to compress into fewer bytes than the block itself.  If that is
+   * not possible, the header is written in front of the uncompressed data
+   * in rs_wrbuf instead.
+   */
+
+  reclen = lzf_compress(&sysbuf->rs_wrbuf[LZF_TYPE0_HDR_SIZE],
+                        sysbuf->rs_wrlen, &g_lzfout[LZF_TYPE1_HDR_SIZE],
+                        sysbuf->rs_wrlen - 1, g_lzfhtab, &header);
+
+  /* Discard the oldest records until the new one fits */
+
+  while (priv->rl_bufsize - 1 - ramlog_ringused(priv) < reclen)
+    {
+      oldlen = ramlog_reclen(priv);
+      if (oldlen == 0)
+        {
+          /* The ring is corrupted.  Discard everything. */
+
+          priv->rl_tail = priv->rl_head;
+          break;
+        }
+
+      ramlog_ringget(priv, NULL, oldlen);
+    }
+
+  ramlog_ringput(priv, (FAR const uint8_t *)header, reclen);
+  sysbuf->rs_wrlen = 0;
+}
+#endif /* CONFIG_RAMLOG_LZF */
+
+/****************************************************************************
+ * Name: ramlog_isempty
+ *
+ * Description:
+ *   Return true if there is nothing that can be read from the RAM log.
+ *
+ ****************************************************************************/
+
+static bool ramlog_isempty(FAR struct ramlog_dev_s *priv)
+{
+#ifdef CONFIG_RAMLOG_LZF
+  return g_lzfrdpos >= g_lzfrdlen && priv->rl_head == priv->rl_tail &&
+         g_sysbuffer.rs_wrlen == 0;
+#else
+  return priv->rl_head == priv->rl_tail;
+#endif
+}
+
+/****************************************************************************
+ * Name: ramlog_getc
+ *
+ * Description:
+ *   Remove and return the next byte from the RAM log, or return -ENODATA
+ *   if there is none.  The caller holds rl_exclsem.
+ *
+ *   When the log is compressed, bytes are returned from the last
+ *   decompressed block.  When that is exhausted, the next record is
+ *   removed from the ring and decompressed.  When the ring is empty, the
+ *   block that is still being collected is taken instead.
+ *
+ ****************************************************************************/
+
+static int ramlog_getc(FAR struct ramlog_dev_s *priv)
+{
+#ifdef CONFIG_RAMLOG_LZF
+  FAR struct ramlog_sysbuf_s *sysbuf = &g_sysbuffer;
+  irqstate_t flags;
+  size_t reclen;
+
+  while (g_lzfrdpos >= g_lzfrdlen)
+    {
+      g_lzfrdpos = 0;
+      g_lzfrdlen = 0;
+
+      flags = enter_critical_section();
+      if (priv->rl_head != priv->rl_tail)
+        {
+          /* Remove the oldest record from the ring */
+
+          reclen = ramlog_reclen(priv);
+          if (reclen == 0)
+            {
+              priv->rl_tail = priv->rl_head;
+            }
+          else
+            {
+              ramlog_ringget(priv, g_lzfin, reclen);
+            }
+
+          ramlog_syssave(priv);
+          leave_critical_section(flags);
+
+          /* Then decompress it outside of the critical section */
+
+          if (reclen == 0)
+            {
+              continue;
+            }
+          else if (g_lzfin[2] == LZF_TYPE0_HDR)
+            {
+              g_lzfrdlen = reclen - LZF_TYPE0_HDR_SIZE;
+              memcpy(g_lzfrd, &g_lzfin[LZF_TYPE0_HDR_SIZE], g_lzfrdlen);
+            }
+          else
+            {
+              g_lzfrdlen = lzf_decompress(&g_lzfin[LZF_TYPE1_HDR_SIZE],
+                                          reclen - LZF_TYPE1_HDR_SIZE,
+                                          g_lzfrd, sizeof(g_lzfrd));
+            }
+        }
+      else if (sysbuf->rs_wrlen > 0)
+        {
+          /* Take the block that is still being collected */
+
+          g_lzfrdlen = sysbuf->rs_wrlen;
+          memcpy(g_lzfrd, &sysbuf->rs_wrbuf[LZF_TYPE0_HDR_SIZE], g_lzfrdlen);
+          sysbuf->rs_wrlen = 0;
+          ramlog_syssave(priv);
+          leave_critical_section(flags);
+        }
+      else
+        {
+          leave_critical_section(flags);
+          return -ENODATA;
+        }
+    }
+
+  return g_lzfrd[g_lzfrdpos++];
+#else
+#ifdef CONFIG_RAMLOG_PERSIST
+  irqstate_t flags;
+#endif
+  int ch;
+
+  if (priv->rl_head == priv->rl_tail)
+    {
+      return -ENODATA;
+    }
+
+  /* Get the next byte from the tail index, then increment the tail index */
+
+  ch = (uint8_t)priv->rl_buffer[priv->rl_tail];
+
+#ifdef CONFIG_RAMLOG_PERSIST
+  flags = enter_critical_section();
+#endif
+  if (++priv->rl_tail >= priv->rl_bufsize)
+    {
+      priv->rl_tail = 0;
+    }
+
+#ifdef CONFIG_RAMLOG_PERSIST
+  ramlog_syssave(priv);
+  leave_critical_section(flags);
+#endif
+  return ch;
+#endif
+}
+
 /****************************************************************************
  * Name: ramlog_addchar
  ****************************************************************************/
@@ -236,12 +776,30 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 {
   irqstate_t flags;
+#ifndef CONFIG_RAMLOG_LZF
   size_t nexthead;
+#endif
+
+  ramlog_sysrestore(priv);
 
   /* Disable interrupts (in case we are NOT called from interrupt handler) */
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_RAMLOG_LZF
+  /* Add the byte to the block being collected.  Compress the block into
+   * the ring when it is full.  This never fails:  The oldest records are
+   * discarded instead.
+   */
+
+  g_sysbuffer.rs_wrbuf[LZF_TYPE0_HDR_SIZE + g_sysbuffer.rs_wrlen] = ch;
+  if (++g_sysbuffer.rs_wrlen >= CONFIG_RAMLOG_LZF_BLOCKSIZE)
+    {
+      ramlog_compress(priv);
+    }
+
+  ramlog_syssave(priv);
+#else
   /* Calculate the write index AFTER the next byte is written */
 
   nexthead = priv->rl_head + 1;
@@ -264,6 +822,9 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 
   priv->rl_buffer[priv->rl_head] = ch;
   priv->rl_head = nexthead;
+  ramlog_syssave(priv);
+#endif
+
   leave_critical_section(flags);
   return OK;
 }
@@ -277,13 +838,13 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
   ssize_t nread;
-  char ch;
   int ret;
 
   /* Some sanity checking */
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct ramlog_dev_s *)inode->i_private;
+  ramlog_sysrestore(priv);
 
   /* If the circular buffer is empty, then wait for something to be written
    * to it.  This function may NOT be called from an interrupt handler.
@@ -305,7 +866,7 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
     {
       /* Get the next byte from the buffer */
 
-      if (priv->rl_head == priv->rl_tail)
+      if (ramlog_isempty(priv))
         {
           /* The circular buffer is empty. */
 
@@ -397,22 +958,18 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
       else
         {
           /* The circular buffer is not empty, get the next byte from the
-           * tail index.
+           * tail index.  This can only fail if a corrupted record was
+           * discarded.
            */
 
-          ch = priv->rl_buffer[priv->rl_tail];
-
-          /* Increment the tail index and re-enable interrupts */
-
-          if (++priv->rl_tail >= priv->rl_bufsize)
+          ret = ramlog_getc(priv);
+          if (ret >= 0)
             {
-              priv->rl_tail = 0;
-            }
-
-          /* Add the character to the user buffer */
+              /* Add the character to the user buffer */
 
-          buffer[nread] = ch;
-          nread++;
+              buffer[nread] = (char)ret;
+              nread++;
+            }
         }
     }
 
@@ -556,7 +1113,9 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
   pollevent_t eventset;
+#ifndef CONFIG_RAMLOG_LZF
   size_t ndx;
+#endif
   int ret;
   int i;
 
@@ -564,6 +1123,7 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct ramlog_dev_s *)inode->i_private;
+  ramlog_sysrestore(priv);
 
   /* Get exclusive access to the poll structures */
 
@@ -608,6 +1168,11 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
       eventset = 0;
 
+#ifdef CONFIG_RAMLOG_LZF
+      /* Writes never block:  Old records are discarded instead */
+
+      eventset |= POLLOUT;
+#else
       ndx = priv->rl_head + 1;
       if (ndx >= priv->rl_bufsize)
         {
@@ -618,10 +1183,11 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        {
          eventset |= POLLOUT;
        }
+#endif
 
       /* Check if the receive buffer is empty */
 
-      if (priv->rl_head != priv->rl_tail)
+      if (!ramlog_isempty(priv))
        {
          eventset |= POLLIN;
        }
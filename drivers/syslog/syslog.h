@@ -43,6 +43,8 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdarg.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -254,6 +256,61 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Save a message in the deferred SYSLOG ring of the current CPU so that
+ *   it can be formatted later by the SYSLOG formatting thread.  If the
+ *   ring is full, the message is dropped and counted.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message (ignored unless
+ *         CONFIG_SYSLOG_TIMESTAMP is selected)
+ *   fmt - The message format string.  This must remain valid until the
+ *         message is formatted.
+ *   ap  - The message arguments.  These are not consumed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the message was saved (or dropped).  A
+ *   negated errno value is returned if the message cannot be deferred and
+ *   must be formatted immediately by the caller.
+ *
+ * Assumptions:
+ *   May be called from any context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_add_deferred(FAR const struct timespec *ts,
+                        FAR const char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format all messages that are waiting in the deferred SYSLOG rings and
+ *   send them to the SYSLOG device.
+ *
+ * Input Parameters:
+ *   force - Use the SYSLOG emergency stream (and the force() method of the
+ *           channel) instead of the normal SYSLOG stream.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Normally called only from the SYSLOG formatting thread.  With force
+ *   set, this may also be called by crash-handling logic with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_flush_deferred(bool force);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
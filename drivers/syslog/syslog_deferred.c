@@ -0,0 +1,790 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_DEFERRED_NRECORDS & \
+     (CONFIG_SYSLOG_DEFERRED_NRECORDS - 1)) != 0
+#  error CONFIG_SYSLOG_DEFERRED_NRECORDS must be a power of two
+#endif
+
+#define SYSLOG_RECORD_MASK  (CONFIG_SYSLOG_DEFERRED_NRECORDS - 1)
+
+/* There is one ring per CPU.  Only the owning CPU ever adds records to a
+ * ring, and it does so with its local interrupts disabled, so no lock is
+ * needed between producers.  Only the formatting thread removes records.
+ */
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NRINGS     CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_NRINGS     1
+#endif
+
+/* Memory barriers are only needed when the formatting thread may run on a
+ * different CPU than the producer.
+ */
+
+#ifndef CONFIG_SPINLOCK
+#  define SP_DMB()
+#endif
+
+/* The longest conversion specification that will be deferred, including
+ * the leading '%' and the terminating NUL.
+ */
+
+#define SYSLOG_SPEC_MAX     16
+
+/* The most '*' width and precision arguments in one conversion */
+
+#define SYSLOG_STAR_MAX     2
+
+/* Format one value using a conversion specification with 0, 1, or 2
+ * preceding '*' arguments.
+ */
+
+#define SYSLOG_PUTVALUE(s,spec,nstar,star,val) \
+  ((nstar) == 0 ? lib_sprintf(s, spec, val) : \
+   (nstar) == 1 ? lib_sprintf(s, spec, star[0], val) : \
+                  lib_sprintf(s, spec, star[0], star[1], val))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The kind of argument consumed by one conversion specification.  These
+ * mirror the va_arg() types used by lib_vsprintf().
+ */
+
+enum syslog_argtype_e
+{
+  SYSLOG_ARG_INVALID = 0, /* Cannot be deferred */
+  SYSLOG_ARG_NONE,        /* "%%", consumes no argument */
+  SYSLOG_ARG_INT,         /* int */
+  SYSLOG_ARG_LONG,        /* long */
+  SYSLOG_ARG_LLONG,       /* long long */
+  SYSLOG_ARG_PTR,         /* FAR void * */
+  SYSLOG_ARG_STRING,      /* FAR char *, copied into the record */
+  SYSLOG_ARG_DOUBLE       /* double */
+};
+
+/* One parsed conversion specification */
+
+struct syslog_spec_s
+{
+  uint8_t type;           /* See enum syslog_argtype_e */
+  uint8_t nstar;          /* Number of '*' arguments */
+  uint8_t len;            /* Length of the specification in bytes */
+};
+
+/* One saved argument */
+
+union syslog_arg_u
+{
+  int                i;
+#ifdef CONFIG_LONG_IS_NOT_INT
+  long               l;
+#endif
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+  long long          ll;
+#endif
+#ifdef CONFIG_PTR_IS_NOT_INT
+  FAR void          *p;
+#endif
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+  double             d;
+#endif
+  int16_t            s;   /* Offset of a string in sr_strbuf; -1 if NULL */
+};
+
+/* One deferred message */
+
+struct syslog_record_s
+{
+  FAR const char    *sr_fmt;     /* Format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec    sr_ts;      /* Time that the message was logged */
+#endif
+  uint8_t            sr_nargs;   /* Number of arguments saved */
+  uint8_t            sr_strlen;  /* Bytes of sr_strbuf in use */
+  union syslog_arg_u sr_args[CONFIG_SYSLOG_DEFERRED_NARGS];
+  char               sr_strbuf[CONFIG_SYSLOG_DEFERRED_STRBUF];
+};
+
+/* The ring of deferred messages of one CPU */
+
+struct syslog_ring_s
+{
+  volatile unsigned int  rg_head;     /* Next record to add (producer) */
+  volatile unsigned int  rg_tail;     /* Next record to format (consumer) */
+  volatile unsigned int  rg_lost;     /* Records dropped (producer) */
+  unsigned int           rg_reported; /* Drops reported (consumer) */
+  struct syslog_record_s rg_record[CONFIG_SYSLOG_DEFERRED_NRECORDS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[SYSLOG_NRINGS];
+
+/* The process ID of the formatting thread (zero if not yet started) */
+
+static pid_t g_syslog_drainpid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parsespec
+ *
+ * Description:
+ *   Parse the conversion specification beginning with the '%' at 'fmt'
+ *   exactly as lib_vsprintf() would, and determine the type of argument
+ *   that it consumes.
+ *
+ * Returned Value:
+ *   A pointer to the first character after the specification.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_parsespec(FAR const char *fmt,
+                                        FAR struct syslog_spec_s *spec)
+{
+  FAR const char *start = fmt;
+  bool islong = false;
+  bool islonglong = false;
+  int ch;
+
+  spec->type  = SYSLOG_ARG_INVALID;
+  spec->nstar = 0;
+
+  /* Skip over the flags, field width, and precision */
+
+  for (fmt++; *fmt != '\0'; fmt++)
+    {
+      if (strchr("diuxXpobeEfgGlLsc%", *fmt) != NULL)
+        {
+          break;
+        }
+      else if (*fmt == '*')
+        {
+          spec->nstar++;
+        }
+    }
+
+  ch = *fmt;
+  if (ch == '%')
+    {
+      spec->type = SYSLOG_ARG_NONE;
+    }
+  else if (ch == 's')
+    {
+      spec->type = SYSLOG_ARG_STRING;
+    }
+  else if (ch == 'c')
+    {
+      spec->type = SYSLOG_ARG_INT;
+    }
+  else if (ch != '\0')
+    {
+      /* Check for the long and long long prefixes */
+
+      if (ch == 'L')
+        {
+          islonglong = true;
+          ch = *++fmt;
+        }
+      else if (ch == 'l')
+        {
+          islong = true;
+          ch = *++fmt;
+          if (ch == 'l')
+            {
+              islonglong = true;
+              ch = *++fmt;
+            }
+        }
+
+      if (ch != '\0' && strchr("diuxXpob", ch) != NULL)
+        {
+          spec->type = SYSLOG_ARG_INT;
+#ifdef CONFIG_PTR_IS_NOT_INT
+          if (ch == 'p')
+            {
+              spec->type = SYSLOG_ARG_PTR;
+            }
+          else
+#endif
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          if (islonglong && ch != 'p')
+            {
+              spec->type = SYSLOG_ARG_LLONG;
+            }
+          else
+#endif
+#ifdef CONFIG_LONG_IS_NOT_INT
+          if (islong && ch != 'p')
+            {
+              spec->type = SYSLOG_ARG_LONG;
+            }
+#endif
+          UNUSED(islong);
+          UNUSED(islonglong);
+        }
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+      else if (ch != '\0' && strchr("eEfgG", ch) != NULL)
+        {
+          spec->type = SYSLOG_ARG_DOUBLE;
+        }
+#endif
+    }
+
+  /* Anything else (including a specification truncated by the end of the
+   * format string) is left to lib_vsprintf().
+   */
+
+  if (ch == '\0' || fmt - start + 1 >= SYSLOG_SPEC_MAX ||
+      spec->nstar > SYSLOG_STAR_MAX)
+    {
+      spec->type = SYSLOG_ARG_INVALID;
+      return fmt;
+    }
+
+  spec->len = fmt - start + 1;
+  return fmt + 1;
+}
+
+/****************************************************************************
+ * Name: syslog_capture
+ *
+ * Description:
+ *   Save the arguments of a message into a record.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOTSUP if the message cannot be deferred.
+ *
+ ****************************************************************************/
+
+static int syslog_capture(FAR struct syslog_record_s *rec,
+                          FAR const char *fmt, va_list ap)
+{
+  FAR union syslog_arg_u *arg;
+  struct syslog_spec_s spec;
+  FAR const char *str;
+  size_t len;
+  int nargs = 0;
+  int i;
+
+  rec->sr_fmt    = fmt;
+  rec->sr_strlen = 0;
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          fmt++;
+          continue;
+        }
+
+      fmt = syslog_parsespec(fmt, &spec);
+      if (spec.type == SYSLOG_ARG_INVALID)
+        {
+          return -ENOTSUP;
+        }
+      else if (spec.type == SYSLOG_ARG_NONE)
+        {
+          continue;
+        }
+
+      if (nargs + spec.nstar + 1 > CONFIG_SYSLOG_DEFERRED_NARGS)
+        {
+          return -ENOTSUP;
+        }
+
+      for (i = 0; i < spec.nstar; i++)
+        {
+          rec->sr_args[nargs++].i = va_arg(ap, int);
+        }
+
+      arg = &rec->sr_args[nargs++];
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            arg->i = va_arg(ap, int);
+            break;
+
+#ifdef CONFIG_LONG_IS_NOT_INT
+          case SYSLOG_ARG_LONG:
+            arg->l = va_arg(ap, long);
+            break;
+#endif
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          case SYSLOG_ARG_LLONG:
+            arg->ll = va_arg(ap, long long);
+            break;
+#endif
+
+#ifdef CONFIG_PTR_IS_NOT_INT
+          case SYSLOG_ARG_PTR:
+            arg->p = va_arg(ap, FAR void *);
+            break;
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            arg->d = va_arg(ap, double);
+            break;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            str = va_arg(ap, FAR const char *);
+            if (str == NULL)
+              {
+                arg->s = -1;
+                break;
+              }
+
+            /* Copy as much of the string as fits, always leaving room for
+             * the NUL terminator.
+             */
+
+            len = CONFIG_SYSLOG_DEFERRED_STRBUF - rec->sr_strlen;
+            if (len < 1)
+              {
+                return -ENOTSUP;
+              }
+
+            len = strnlen(str, len - 1);
+            arg->s = rec->sr_strlen;
+            memcpy(&rec->sr_strbuf[rec->sr_strlen], str, len);
+            rec->sr_strbuf[rec->sr_strlen + len] = '\0';
+            rec->sr_strlen += len + 1;
+            break;
+
+          default:
+            return -ENOTSUP;
+        }
+    }
+
+  rec->sr_nargs = nargs;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Format one saved message and send it to the SYSLOG device.
+ *
+ ****************************************************************************/
+
+static void syslog_format(FAR const struct syslog_record_s *rec, bool force)
+{
+  struct lib_syslogstream_s stream;
+  FAR const union syslog_arg_u *arg = rec->sr_args;
+  FAR const char *fmt = rec->sr_fmt;
+  FAR const char *next;
+  struct syslog_spec_s spec;
+  char specbuf[SYSLOG_SPEC_MAX];
+  int star[SYSLOG_STAR_MAX];
+  int i;
+
+  if (force)
+    {
+      emergstream(&stream.public);
+    }
+  else
+    {
+      syslogstream_create(&stream);
+    }
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  (void)lib_sprintf(&stream.public, "[%5d.%06d] ",
+                    rec->sr_ts.tv_sec, rec->sr_ts.tv_nsec / 1000);
+#endif
+
+#ifdef CONFIG_SYSLOG_PREFIX
+  (void)lib_sprintf(&stream.public, "%s", CONFIG_SYSLOG_PREFIX_STRING);
+#endif
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          stream.public.put(&stream.public, *fmt++);
+          continue;
+        }
+
+      /* The message was parsed successfully when it was saved */
+
+      next = syslog_parsespec(fmt, &spec);
+      if (spec.type == SYSLOG_ARG_NONE)
+        {
+          stream.public.put(&stream.public, '%');
+          fmt = next;
+          continue;
+        }
+
+      memcpy(specbuf, fmt, spec.len);
+      specbuf[spec.len] = '\0';
+      fmt = next;
+
+      for (i = 0; i < spec.nstar; i++)
+        {
+          star[i] = (arg++)->i;
+        }
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->i);
+            break;
+
+#ifdef CONFIG_LONG_IS_NOT_INT
+          case SYSLOG_ARG_LONG:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->l);
+            break;
+#endif
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          case SYSLOG_ARG_LLONG:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->ll);
+            break;
+#endif
+
+#ifdef CONFIG_PTR_IS_NOT_INT
+          case SYSLOG_ARG_PTR:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->p);
+            break;
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->d);
+            break;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            (void)SYSLOG_PUTVALUE(&stream.public, specbuf, spec.nstar, star,
+                                  arg->s < 0 ? NULL :
+                                  &rec->sr_strbuf[arg->s]);
+            break;
+
+          default:
+            break;
+        }
+
+      arg++;
+    }
+
+#ifdef CONFIG_SYSLOG_BUFFER
+  if (!force)
+    {
+      syslogstream_destroy(&stream);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: syslog_report_lost
+ *
+ * Description:
+ *   Report the number of messages dropped from a ring since the last
+ *   report.
+ *
+ ****************************************************************************/
+
+static void syslog_report_lost(unsigned int nlost, bool force)
+{
+  struct lib_syslogstream_s stream;
+
+  if (force)
+    {
+      emergstream(&stream.public);
+    }
+  else
+    {
+      syslogstream_create(&stream);
+    }
+
+  (void)lib_sprintf(&stream.public, "[%u messages lost]\n", nlost);
+
+#ifdef CONFIG_SYSLOG_BUFFER
+  if (!force)
+    {
+      syslogstream_destroy(&stream);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: syslog_drain_thread
+ *
+ * Description:
+ *   The SYSLOG formatting thread.
+ *
+ ****************************************************************************/
+
+static int syslog_drain_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      syslog_flush_deferred(false);
+      (void)nxsig_usleep(CONFIG_SYSLOG_DEFERRED_INTERVAL * 1000);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Save a message in the deferred SYSLOG ring of the current CPU so that
+ *   it can be formatted later by the SYSLOG formatting thread.  If the
+ *   ring is full, the message is dropped and counted.
+ *
+ * Input Parameters:
+ *   ts  - The time stamp of the message (ignored unless
+ *         CONFIG_SYSLOG_TIMESTAMP is selected)
+ *   fmt - The message format string.  This must remain valid until the
+ *         message is formatted.
+ *   ap  - The message arguments.  These are not consumed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the message was saved (or dropped).  A
+ *   negated errno value is returned if the message cannot be deferred and
+ *   must be formatted immediately by the caller.
+ *
+ * Assumptions:
+ *   May be called from any context.
+ *
+ ****************************************************************************/
+
+int syslog_add_deferred(FAR const struct timespec *ts,
+                        FAR const char *fmt, FAR va_list *ap)
+{
+  struct syslog_record_s rec;
+  FAR struct syslog_ring_s *ring;
+  unsigned int head;
+  irqstate_t flags;
+  va_list ap2;
+  int ret;
+
+  /* Nothing can be deferred until the formatting thread is running */
+
+  if (g_syslog_drainpid <= 0 || fmt == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  /* Save the arguments outside of the critical section.  Work on a copy of
+   * the argument list so that the caller can still format the message if
+   * it cannot be deferred.
+   */
+
+  va_copy(ap2, *ap);
+  ret = syslog_capture(&rec, fmt, ap2);
+  va_end(ap2);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  rec.sr_ts = *ts;
+#else
+  UNUSED(ts);
+#endif
+
+  /* With local interrupts disabled, nothing else can add a record to the
+   * ring of this CPU.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_ring[up_cpu_index()];
+  head  = ring->rg_head;
+
+  if (head - ring->rg_tail >= CONFIG_SYSLOG_DEFERRED_NRECORDS)
+    {
+      ring->rg_lost++;
+    }
+  else
+    {
+      memcpy(&ring->rg_record[head & SYSLOG_RECORD_MASK], &rec,
+             sizeof(struct syslog_record_s));
+
+      /* The record must be complete before the formatting thread can see
+       * it.
+       */
+
+      SP_DMB();
+      ring->rg_head = head + 1;
+    }
+
+  up_irq_restore(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format all messages that are waiting in the deferred SYSLOG rings and
+ *   send them to the SYSLOG device.
+ *
+ * Input Parameters:
+ *   force - Use the SYSLOG emergency stream (and the force() method of the
+ *           channel) instead of the normal SYSLOG stream.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Normally called only from the SYSLOG formatting thread.  With force
+ *   set, this may also be called by crash-handling logic with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+void syslog_flush_deferred(bool force)
+{
+  FAR struct syslog_ring_s *ring;
+  unsigned int tail;
+  unsigned int lost;
+  int cpu;
+
+  for (cpu = 0; cpu < SYSLOG_NRINGS; cpu++)
+    {
+      ring = &g_syslog_ring[cpu];
+
+      for (tail = ring->rg_tail; tail != ring->rg_head; tail++)
+        {
+          /* Do not read the record before seeing the new head */
+
+          SP_DMB();
+          syslog_format(&ring->rg_record[tail & SYSLOG_RECORD_MASK], force);
+
+          /* Do not release the record until it has been formatted */
+
+          SP_DMB();
+          ring->rg_tail = tail + 1;
+        }
+
+      lost = ring->rg_lost;
+      if (lost != ring->rg_reported)
+        {
+          syslog_report_lost(lost - ring->rg_reported, force);
+          ring->rg_reported = lost;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_start
+ *
+ * Description:
+ *   Start the kernel thread that formats deferred SYSLOG messages.  Until
+ *   this thread is running, all SYSLOG output is formatted immediately.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The process ID (pid) of the new thread is returned on success; a
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_start(void)
+{
+  pid_t pid;
+
+  pid = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       (main_t)syslog_drain_thread,
+                       (FAR char * const *)NULL);
+  if (pid > 0)
+    {
+      g_syslog_drainpid = pid;
+    }
+
+  return pid;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
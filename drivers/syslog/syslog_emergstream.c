@@ -109,6 +109,7 @@ static void emergstream_putc(FAR struct lib_outstream_s *this, int ch)
 void emergstream(FAR struct lib_outstream_s *stream)
 {
   stream->put   = emergstream_putc;
+  stream->puts  = NULL;
   stream->flush = lib_noflush;
   stream->nput  = 0;
 }
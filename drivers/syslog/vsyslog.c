@@ -49,6 +49,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,6 +66,9 @@
  *   some compilers and passing of structures in the NuttX sycalls does
  *   not work.
  *
+ *   If CONFIG_SYSLOG_DEFERRED is selected, the message may only be saved
+ *   for later formatting, in which case zero is returned.
+ *
  ****************************************************************************/
 
 int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
@@ -110,6 +115,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Let the SYSLOG formatting thread format the message later, if
+   * possible.  Emergency output is never deferred.
+   */
+
+  if (priority != LOG_EMERG)
+    {
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      if (syslog_add_deferred(&ts, fmt, ap) >= 0)
+#else
+      if (syslog_add_deferred(NULL, fmt, ap) >= 0)
+#endif
+        {
+          return 0;
+        }
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
@@ -0,0 +1,419 @@
+/****************************************************************************
+ * drivers/timers/hrtimer.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/timers/oneshot.h>
+#include <nuttx/timers/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The shortest interval programmed into the oneshot timer.  Timers that
+ * are already due when started are expired after this interval.
+ */
+
+#define HRTIMER_MINDELAY  1000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void hrtimer_handler(FAR struct oneshot_lowerhalf_s *lower,
+                            FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The oneshot timer that drives the high resolution timers */
+
+static FAR struct oneshot_lowerhalf_s *g_hrtimer_lower;
+
+/* The longest interval supported by the oneshot timer (ns) */
+
+static uint64_t g_hrtimer_maxdelay;
+
+/* The time at which the oneshot timer will next fire (ns) or UINT64_MAX if
+ * it is not running.
+ */
+
+static uint64_t g_hrtimer_fire = UINT64_MAX;
+
+/* The active timers, ordered by expiration time */
+
+static dq_queue_t g_hrtimer_active;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_ts2ns(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static inline void hrtimer_ns2ts(FAR struct timespec *ts, uint64_t ns)
+{
+  ts->tv_sec  = ns / NSEC_PER_SEC;
+  ts->tv_nsec = ns - (uint64_t)ts->tv_sec * NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Name: hrtimer_insert
+ *
+ * Description:
+ *   Add a timer to the active list in order of expiration.  The list is
+ *   searched from the end since new timers usually expire last.
+ *
+ ****************************************************************************/
+
+static void hrtimer_insert(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *prev;
+
+  for (prev = (FAR struct hrtimer_s *)g_hrtimer_active.tail;
+       prev != NULL && prev->expire > timer->expire;
+       prev = (FAR struct hrtimer_s *)dq_prev(&prev->node));
+
+  if (prev == NULL)
+    {
+      dq_addfirst(&timer->node, &g_hrtimer_active);
+    }
+  else
+    {
+      dq_addafter(&prev->node, &timer->node, &g_hrtimer_active);
+    }
+
+  timer->active = true;
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the oneshot timer for the next expiration.  Each timer may
+ *   expire any time within its window of [expire, expire + slack].  The
+ *   oneshot timer is set to the end of the earliest window so that every
+ *   timer whose window begins before then expires from the same interrupt.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(uint64_t now)
+{
+  FAR struct hrtimer_s *timer;
+  struct timespec ts;
+  uint64_t fire = UINT64_MAX;
+  uint64_t delay;
+
+  for (timer = (FAR struct hrtimer_s *)dq_peek(&g_hrtimer_active);
+       timer != NULL && timer->expire <= fire;
+       timer = (FAR struct hrtimer_s *)dq_next(&timer->node))
+    {
+      if (timer->expire + timer->slack < fire)
+        {
+          fire = timer->expire + timer->slack;
+        }
+    }
+
+  (void)ONESHOT_CANCEL(g_hrtimer_lower, &ts);
+  g_hrtimer_fire = fire;
+
+  if (fire != UINT64_MAX)
+    {
+      delay = fire > now ? fire - now : 0;
+      if (delay < HRTIMER_MINDELAY)
+        {
+          delay = HRTIMER_MINDELAY;
+        }
+      else if (delay > g_hrtimer_maxdelay)
+        {
+          /* The handler will find nothing due and reprogram the timer */
+
+          delay = g_hrtimer_maxdelay;
+        }
+
+      hrtimer_ns2ts(&ts, delay);
+      (void)ONESHOT_START(g_hrtimer_lower, hrtimer_handler, NULL, &ts);
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_handler
+ *
+ * Description:
+ *   Called from the oneshot timer interrupt.  Expire every timer that is due
+ *   and program the next interrupt.
+ *
+ ****************************************************************************/
+
+static void hrtimer_handler(FAR struct oneshot_lowerhalf_s *lower,
+                            FAR void *arg)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  uint64_t period;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  now   = hrtimer_now();
+
+  while ((timer = (FAR struct hrtimer_s *)dq_peek(&g_hrtimer_active)) !=
+          NULL && timer->expire <= now)
+    {
+      dq_rem(&timer->node, &g_hrtimer_active);
+      timer->active = false;
+
+      /* The callback may restart or (if it returns zero) free the timer */
+
+      period = timer->func(timer);
+      if (period != 0 && !timer->active)
+        {
+          timer->expire += period;
+          hrtimer_insert(timer);
+        }
+    }
+
+  hrtimer_reprogram(now);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Provide the oneshot timer that drives the high resolution timers.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL);
+
+  if (lower->ops->current == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = ONESHOT_MAX_DELAY(lower, &ts);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_hrtimer_maxdelay = hrtimer_ts2ns(&ts);
+  g_hrtimer_lower    = lower;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t func,
+                  FAR void *arg)
+{
+  DEBUGASSERT(timer != NULL && func != NULL);
+
+  timer->func   = func;
+  timer->arg    = arg;
+  timer->expire = 0;
+  timer->slack  = 0;
+  timer->active = false;
+}
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current time of the high resolution timers in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void)
+{
+  struct timespec ts;
+
+  if (g_hrtimer_lower == NULL || ONESHOT_CURRENT(g_hrtimer_lower, &ts) < 0)
+    {
+      return 0;
+    }
+
+  return hrtimer_ts2ns(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t ns, uint32_t slack,
+                  int mode)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  DEBUGASSERT(timer != NULL && timer->func != NULL);
+
+  if (g_hrtimer_lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (mode != HRTIMER_MODE_REL && mode != HRTIMER_MODE_ABS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (timer->active)
+    {
+      dq_rem(&timer->node, &g_hrtimer_active);
+      timer->active = false;
+    }
+
+  now           = hrtimer_now();
+  timer->expire = mode == HRTIMER_MODE_ABS ? ns : now + ns;
+  timer->slack  = slack;
+  hrtimer_insert(timer);
+
+  /* Only a window that ends before the programmed time requires the
+   * oneshot timer to be changed.  Removing a timer at most causes one
+   * early interrupt.
+   */
+
+  if (timer->expire + slack < g_hrtimer_fire)
+    {
+      hrtimer_reprogram(now);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  struct timespec ts;
+  irqstate_t flags;
+
+  DEBUGASSERT(timer != NULL);
+
+  flags = enter_critical_section();
+  if (timer->active)
+    {
+      dq_rem(&timer->node, &g_hrtimer_active);
+      timer->active = false;
+
+      /* Stop the oneshot timer if no timers remain */
+
+      if (dq_empty(&g_hrtimer_active))
+        {
+          (void)ONESHOT_CANCEL(g_hrtimer_lower, &ts);
+          g_hrtimer_fire = UINT64_MAX;
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the nanoseconds remaining until the timer expires.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  uint64_t remaining = 0;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  if (timer->active)
+    {
+      now = hrtimer_now();
+      if (timer->expire > now)
+        {
+          remaining = timer->expire - now;
+        }
+    }
+
+  leave_critical_section(flags);
+  return remaining;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,467 @@
+/****************************************************************************
+ * drivers/timers/profile.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/timers/timer.h>
+#include <nuttx/timers/profile.h>
+
+#ifdef CONFIG_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One slot of the ring buffer is always unused so that a full buffer can
+ * be distinguished from an empty one.
+ */
+
+#define PROFILE_NSLOTS (CONFIG_PROFILE_NSAMPLES + 1)
+
+/****************************************************************************
+ * Private Type Definitions
+ ****************************************************************************/
+
+/* This structure describes the state of the profiler device */
+
+struct profile_dev_s
+{
+  FAR struct timer_lowerhalf_s *lower; /* The dedicated timer */
+  sem_t             exclsem;   /* Supports mutually exclusive access */
+  uint32_t          interval;  /* Sampling interval in microseconds */
+  uint32_t          noverruns; /* Number of samples lost */
+  bool              started;   /* True:  Sampling is in progress */
+
+  /* The sample ring buffer.  head is only modified by the timer interrupt
+   * handler and tail is only modified by read().
+   */
+
+  volatile uint16_t head;
+  volatile uint16_t tail;
+  struct profile_sample_s samples[PROFILE_NSLOTS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static bool    profile_sample(FAR uint32_t *next_interval_us,
+                              FAR void *arg);
+static int     profile_start(FAR struct profile_dev_s *dev);
+static int     profile_stop(FAR struct profile_dev_s *dev);
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static int     profile_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_profileops =
+{
+  NULL,          /* open */
+  NULL,          /* close */
+  profile_read,  /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  profile_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , NULL         /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_sample
+ *
+ * Description:
+ *   The timer callback.  This runs in the timer interrupt handler and
+ *   records the state of the interrupted code.
+ *
+ ****************************************************************************/
+
+static bool profile_sample(FAR uint32_t *next_interval_us, FAR void *arg)
+{
+  FAR struct profile_dev_s *dev = (FAR struct profile_dev_s *)arg;
+  FAR struct profile_sample_s *sample;
+  uint16_t next;
+
+  next = dev->head + 1;
+  if (next >= PROFILE_NSLOTS)
+    {
+      next = 0;
+    }
+
+  if (next == dev->tail)
+    {
+      /* The buffer is full.  Keep the oldest samples. */
+
+      dev->noverruns++;
+      return true;
+    }
+
+  sample           = &dev->samples[dev->head];
+  sample->pc       = (uint32_t)up_interrupt_pc();
+  sample->pid      = (uint16_t)getpid();
+  sample->cpu      = (uint8_t)up_cpu_index();
+  sample->reserved = 0;
+
+  dev->head        = next;
+  return true;
+}
+
+/****************************************************************************
+ * Name: profile_start
+ *
+ * Description:
+ *   Discard any old samples and start the sampling timer.
+ *
+ ****************************************************************************/
+
+static int profile_start(FAR struct profile_dev_s *dev)
+{
+  FAR struct timer_lowerhalf_s *lower = dev->lower;
+  int ret;
+
+  if (dev->started)
+    {
+      (void)profile_stop(dev);
+    }
+
+  dev->head      = 0;
+  dev->tail      = 0;
+  dev->noverruns = 0;
+
+  ret = lower->ops->settimeout(lower, dev->interval);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: settimeout(%lu) failed: %d\n",
+             (unsigned long)dev->interval, ret);
+      return ret;
+    }
+
+  lower->ops->setcallback(lower, profile_sample, dev);
+
+  ret = lower->ops->start(lower);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: start failed: %d\n", ret);
+      lower->ops->setcallback(lower, NULL, NULL);
+      return ret;
+    }
+
+  dev->started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stop
+ *
+ * Description:
+ *   Stop the sampling timer.  Collected samples are retained.
+ *
+ ****************************************************************************/
+
+static int profile_stop(FAR struct profile_dev_s *dev)
+{
+  FAR struct timer_lowerhalf_s *lower = dev->lower;
+  int ret;
+
+  if (!dev->started)
+    {
+      return OK;
+    }
+
+  ret = lower->ops->stop(lower);
+  lower->ops->setcallback(lower, NULL, NULL);
+  dev->started = false;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ *
+ * Description:
+ *   Return as many whole samples as will fit in the user buffer.  Zero is
+ *   returned if there are no samples waiting to be read; read() does not
+ *   wait for new samples.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct profile_dev_s *dev;
+  size_t maxsamples;
+  size_t nread = 0;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t ncopy;
+  int ret;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  dev = (FAR struct profile_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&dev->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  maxsamples = buflen / sizeof(struct profile_sample_s);
+  tail       = dev->tail;
+
+  while (nread < maxsamples)
+    {
+      /* Copy the contiguous samples up to the head or to the end of the
+       * ring.  The interrupt handler may add more samples meanwhile but
+       * it never modifies those between tail and the head sampled here.
+       */
+
+      head = dev->head;
+      if (head == tail)
+        {
+          break;
+        }
+
+      ncopy = (head > tail ? head : PROFILE_NSLOTS) - tail;
+      if (ncopy > maxsamples - nread)
+        {
+          ncopy = maxsamples - nread;
+        }
+
+      memcpy(buffer, &dev->samples[tail],
+             ncopy * sizeof(struct profile_sample_s));
+
+      buffer += ncopy * sizeof(struct profile_sample_s);
+      nread  += ncopy;
+      tail   += ncopy;
+
+      if (tail >= PROFILE_NSLOTS)
+        {
+          tail = 0;
+        }
+
+      dev->tail = tail;
+    }
+
+  nxsem_post(&dev->exclsem);
+  return nread * sizeof(struct profile_sample_s);
+}
+
+/****************************************************************************
+ * Name: profile_ioctl
+ *
+ * Description:
+ *   Handle the PROFIOC_* commands defined in include/nuttx/timers/profile.h
+ *
+ ****************************************************************************/
+
+static int profile_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct profile_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  dev = (FAR struct profile_dev_s *)inode->i_private;
+
+  ret = nxsem_wait(&dev->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+    /* cmd:         PROFIOC_START
+     * Description: Discard old samples and start sampling
+     * Argument:    Ignored
+     */
+
+    case PROFIOC_START:
+      ret = profile_start(dev);
+      break;
+
+    /* cmd:         PROFIOC_STOP
+     * Description: Stop sampling
+     * Argument:    Ignored
+     */
+
+    case PROFIOC_STOP:
+      ret = profile_stop(dev);
+      break;
+
+    /* cmd:         PROFIOC_SETINTERVAL
+     * Description: Set the sampling interval
+     * Argument:    A 32-bit interval in microseconds
+     */
+
+    case PROFIOC_SETINTERVAL:
+      if (arg == 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          dev->interval = (uint32_t)arg;
+          ret = OK;
+        }
+      break;
+
+    /* cmd:         PROFIOC_GETSTATUS
+     * Description: Get the state of the profiler
+     * Argument:    A writeable pointer to struct profile_status_s
+     */
+
+    case PROFIOC_GETSTATUS:
+      {
+        FAR struct profile_status_s *status =
+          (FAR struct profile_status_s *)((uintptr_t)arg);
+        int nsamples;
+
+        if (status == NULL)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        nsamples = (int)dev->head - (int)dev->tail;
+        if (nsamples < 0)
+          {
+            nsamples += PROFILE_NSLOTS;
+          }
+
+        status->nsamples  = nsamples;
+        status->noverruns = dev->noverruns;
+        status->interval  = dev->interval;
+        status->started   = dev->started;
+        ret = OK;
+      }
+      break;
+
+    default:
+      tmrerr("ERROR: Unrecognized cmd: %d\n", cmd);
+      ret = -ENOTTY;
+      break;
+    }
+
+  nxsem_post(&dev->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_register
+ *
+ * Description:
+ *   Register the statistical profiler device.  Each time that the timer
+ *   expires, the program counter of the interrupted code and the ID of the
+ *   running task are added to a buffer of CONFIG_PROFILE_NSAMPLES samples.
+ *   The samples are then read from the device (see tools/profinfo.c).
+ *
+ * Input Parameters:
+ *   path  - The path to the device.  Normally "/dev/profile".
+ *   lower - An instance of the timer lower half driver.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int profile_register(FAR const char *path,
+                     FAR struct timer_lowerhalf_s *lower)
+{
+  FAR struct profile_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(path != NULL && lower != NULL && lower->ops != NULL);
+
+  dev = (FAR struct profile_dev_s *)
+    kmm_zalloc(sizeof(struct profile_dev_s));
+  if (dev == NULL)
+    {
+      tmrerr("ERROR: Failed to allocate the profiler\n");
+      return -ENOMEM;
+    }
+
+  dev->lower    = lower;
+  dev->interval = CONFIG_PROFILE_INTERVAL;
+  nxsem_init(&dev->exclsem, 0, 1);
+
+  ret = register_driver(path, &g_profileops, 0444, dev);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: register_driver failed: %d\n", ret);
+      nxsem_destroy(&dev->exclsem);
+      kmm_free(dev);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PROFILE */
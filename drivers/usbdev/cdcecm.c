@@ -111,6 +111,14 @@
 #  define CONFIG_CDCECM_NINTERFACES 1
 #endif
 
+/* CONFIG_CDCECM_NWRREQS determines the number of frames that may be queued
+ * for transmission.
+ */
+
+#ifndef CONFIG_CDCECM_NWRREQS
+#  define CONFIG_CDCECM_NWRREQS 4
+#endif
+
 /* TX poll delay = 1 seconds. CLK_TCK is the number of clock ticks per second */
 
 #define CDCECM_WDDELAY   (1*CLK_TCK)
@@ -127,6 +135,14 @@
  * Private Types
  ****************************************************************************/
 
+/* Container to support a list of write requests */
+
+struct cdcecm_req_s
+{
+  FAR struct cdcecm_req_s *flink;   /* Implements a singly linked list */
+  FAR struct usbdev_req_s *req;     /* The contained request */
+};
+
 /* The cdcecm_driver_s encapsulates all state information for a single hardware
  * interface
  */
@@ -148,8 +164,9 @@ struct cdcecm_driver_s
   struct usbdev_req_s         *rdreq;       /* Single read request */
   bool                         rxpending;   /* Packet available in rdreq */
 
-  struct usbdev_req_s         *wrreq;       /* Single write request */
-  sem_t                        wrreq_idle;  /* Is the wrreq available? */
+  struct cdcecm_req_s          wrreqs[CONFIG_CDCECM_NWRREQS];
+  struct sq_queue_s            wrreqlist;   /* Free write requests */
+  sem_t                        wrreq_idle;  /* Counts free write requests */
   bool                         txdone;      /* Did a write request complete? */
 
   /* Network device */
@@ -323,24 +340,45 @@ static const struct usb_devdesc_s g_devdesc =
 
 static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 {
-  /* Wait until the USB device request for Ethernet frame transmissions becomes
-   * available.
+  FAR struct cdcecm_req_s *privreq;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  int ret;
+
+  /* Wait until one of the USB device requests for Ethernet frame
+   * transmissions becomes available.
    */
 
   while (nxsem_wait(&self->wrreq_idle) != OK)
     {
     }
 
+  flags   = enter_critical_section();
+  privreq = (FAR struct cdcecm_req_s *)sq_remfirst(&self->wrreqlist);
+  leave_critical_section(flags);
+
+  DEBUGASSERT(privreq != NULL);
+  req = privreq->req;
+
   /* Increment statistics */
 
   NETDEV_TXPACKETS(self->dev);
 
   /* Send the packet: address=priv->dev.d_buf, length=priv->dev.d_len */
 
-  memcpy(self->wrreq->buf, self->dev.d_buf, self->dev.d_len);
-  self->wrreq->len = self->dev.d_len;
+  memcpy(req->buf, self->dev.d_buf, self->dev.d_len);
+  req->len = self->dev.d_len;
+
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)privreq, &self->wrreqlist);
+      leave_critical_section(flags);
+      nxsem_post(&self->wrreq_idle);
+    }
 
-  return EP_SUBMIT(self->epbulkin, self->wrreq);
+  return ret;
 }
 
 /****************************************************************************
@@ -1156,13 +1194,19 @@ static void cdcecm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)ep->priv;
+  irqstate_t flags;
   int rc;
 
   uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again. */
+  /* The USB device write request is available for upcoming transmissions
+   * again.
+   */
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->wrreqlist);
+  leave_critical_section(flags);
 
   rc = nxsem_post(&self->wrreq_idle);
 
@@ -1799,7 +1843,9 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+  FAR struct usbdev_req_s *req;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -1848,22 +1894,32 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 
   self->rdreq->callback = cdcecm_rdcomplete;
 
-  /* Pre-allocate a single write request.  Buffer size is one full packet. */
+  /* Pre-allocate the write requests and put them in a free list.  Buffer
+   * size is one full packet.
+   */
 
-  self->wrreq = cdcecm_allocreq(self->epbulkin,
-                                CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
-  if (self->wrreq == NULL)
+  sq_init(&self->wrreqlist);
+
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      req = cdcecm_allocreq(self->epbulkin,
+                            CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+      if (req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcecm_wrcomplete;
+      req->callback         = cdcecm_wrcomplete;
+      req->priv             = &self->wrreqs[i];
+      self->wrreqs[i].req   = req;
+      sq_addlast((FAR sq_entry_t *)&self->wrreqs[i], &self->wrreqlist);
+    }
 
-  /* The single write request just allocated is available now. */
+  /* All write requests just allocated are available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCECM_NWRREQS);
 
   if (ret != OK)
     {
@@ -1897,6 +1953,7 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -1954,10 +2011,13 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCECM_NWRREQS; i++)
     {
-      cdcecm_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          cdcecm_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk IN endpoint */
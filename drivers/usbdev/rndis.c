@@ -69,7 +69,13 @@
 
 #define CONFIG_RNDIS_EP0MAXPACKET 64
 
-#define CONFIG_RNDIS_NWRREQS    (2)
+#ifndef CONFIG_RNDIS_NWRREQS
+#  define CONFIG_RNDIS_NWRREQS  (4)
+#endif
+
+#if CONFIG_RNDIS_NWRREQS < 2
+#  error CONFIG_RNDIS_NWRREQS must be at least 2
+#endif
 
 #define RNDIS_PACKET_HDR_SIZE   (sizeof(struct rndis_packet_msg))
 #define CONFIG_RNDIS_BULKIN_REQLEN \
@@ -2119,6 +2119,9 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+#ifdef CONFIG_USBMSC_DIRECTXFR
+  uint32_t nsect;
+#endif
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2133,14 +2136,29 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
-      /* Is the I/O buffer empty? */
+#ifdef CONFIG_USBMSC_DIRECTXFR
+      /* If the request buffer holds at least one whole sector, then read as
+       * many sectors as will fit directly into the next request.  The
+       * requests already submitted are sent to the host while the block
+       * driver performs this read.
+       */
 
-      if (priv->nsectbytes <= 0)
+      if (priv->nsectbytes <= 0 && priv->nreqbytes == 0 &&
+          lun->sectorsize <= CONFIG_USBMSC_BULKINREQLEN)
         {
-          /* Yes.. read the next sector */
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              return -ENOMEM;
+            }
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          req   = privreq->req;
+          nsect = MIN(priv->u.xfrlen,
+                      CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize);
+
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nsect);
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
               lun->sd     = SCSI_KCQME_UNRRE1;
@@ -2148,46 +2166,73 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->nreqbytes = nread * lun->sectorsize;
+          priv->u.xfrlen -= nread;
+          priv->sector   += nread;
         }
+      else
+#endif
+        {
+          /* Is the I/O buffer empty? */
 
-      /* Check if there is a request in the wrreqlist that we will be able to
-       * use for data transfer.
-       */
+          if (priv->nsectbytes <= 0)
+            {
+              /* Yes.. read the next sector */
 
-      privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+              nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+              if (nread < 0)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                           -nread);
+                  lun->sd     = SCSI_KCQME_UNRRE1;
+                  lun->sdinfo = priv->sector;
+                  break;
+                }
 
-      /* If there no request structures available, then just return an error.
-       * This will cause us to remain in the CMDREAD state.  When a request is
-       * returned, the worker thread will be awakened in the USBMSC_STATE_CMDREAD
-       * and we will be called again.
-       */
+              priv->nsectbytes = lun->sectorsize;
+              priv->u.xfrlen--;
+              priv->sector++;
+            }
 
-      if (!privreq)
-        {
-          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
-          priv->nreqbytes = 0;
-          return -ENOMEM;
-        }
+          /* Check if there is a request in the wrreqlist that we will be
+           * able to use for data transfer.
+           */
 
-      req = privreq->req;
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
 
-      /* Transfer all of the data that will (1) fit into the request buffer, OR (2)
-       * all of the data available in the sector buffer.
-       */
+          /* If there no request structures available, then just return an
+           * error.  This will cause us to remain in the CMDREAD state.  When
+           * a request is returned, the worker thread will be awakened in the
+           * USBMSC_STATE_CMDREAD and we will be called again.
+           */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
-      dest   = &req->buf[priv->nreqbytes];
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              priv->nreqbytes = 0;
+              return -ENOMEM;
+            }
+
+          req = privreq->req;
 
-      nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
+          /* Transfer all of the data that will (1) fit into the request
+           * buffer, OR (2) all of the data available in the sector buffer.
+           */
 
-      /* Copy the data from the sector buffer to the USB request and update counts */
+          src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+          dest   = &req->buf[priv->nreqbytes];
 
-      memcpy(dest, src, nbytes);
-      priv->nreqbytes  += nbytes;
-      priv->nsectbytes -= nbytes;
+          nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes,
+                       priv->nsectbytes);
+
+          /* Copy the data from the sector buffer to the USB request and
+           * update counts
+           */
+
+          memcpy(dest, src, nbytes);
+          priv->nreqbytes  += nbytes;
+          priv->nsectbytes -= nbytes;
+        }
 
       /* If (1) the request buffer is full OR (2) this is the final request full of data,
        * then submit the request
@@ -2265,6 +2310,9 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
   ssize_t nwritten;
+#ifdef CONFIG_USBMSC_DIRECTXFR
+  uint32_t nsect;
+#endif
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
@@ -2311,6 +2359,37 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       while (priv->nreqbytes > 0 && priv->u.xfrlen > 0)
         {
+#ifdef CONFIG_USBMSC_DIRECTXFR
+          /* If no partial sector is buffered and the request holds one or
+           * more whole sectors, then write them directly from the request
+           * buffer.
+           */
+
+          if (priv->nsectbytes == 0 && priv->nreqbytes >= lun->sectorsize)
+            {
+              nsect    = MIN(priv->u.xfrlen,
+                             priv->nreqbytes / lun->sectorsize);
+              src      = &req->buf[xfrd - priv->nreqbytes];
+
+              nwritten = USBMSC_DRVR_WRITE(lun, src, priv->sector, nsect);
+              if (nwritten <= 0)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
+                           -nwritten);
+                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+                  lun->sdinfo = priv->sector;
+                  goto errout;
+                }
+
+              nbytes           = nwritten * lun->sectorsize;
+              priv->nreqbytes -= nbytes;
+              priv->residue   -= nbytes;
+              priv->u.xfrlen  -= nwritten;
+              priv->sector    += nwritten;
+              continue;
+            }
+#endif
+
           /* Copy the data received in the read request into the sector I/O buffer */
 
           src  = &req->buf[xfrd - priv->nreqbytes];
@@ -635,7 +635,7 @@ static void usbhost_pollnotify(FAR struct usbhost_state_s *priv)
           if (fds->revents != 0)
             {
               uinfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -978,6 +978,7 @@ static inline void usbhost_encodescancode(FAR struct usbhost_state_s *priv,
           /* And it does correspond to a special function key */
 
           usbstream.stream.put  = usbhost_putstream;
+          usbstream.stream.puts = NULL;
           usbstream.stream.nput = 0;
           usbstream.priv        = priv;
 
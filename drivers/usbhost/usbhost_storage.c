@@ -90,6 +90,10 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+#ifndef CONFIG_USBHOST_MSC_READAHEAD
+#  define CONFIG_USBHOST_MSC_READAHEAD 0
+#endif
+
 /* Driver support ***********************************************************/
 /* This format is used to construct the /dev/sd[n] device driver path.  It
  * defined here so that it will be used consistently in all places.
@@ -137,6 +141,11 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  FAR uint8_t            *rabuffer;     /* The allocated read-ahead buffer */
+  size_t                  rastart;      /* First sector in rabuffer */
+  unsigned int            ransectors;   /* Valid sectors in rabuffer */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -224,6 +233,17 @@ static inline int usbhost_talloc(FAR struct usbhost_state_s *priv);
 static inline int usbhost_tfree(FAR struct usbhost_state_s *priv);
 static FAR struct usbmsc_cbw_s *usbhost_cbwalloc(FAR struct usbhost_state_s *priv);
 
+/* Data transfer */
+
+static ssize_t usbhost_readsectors(FAR struct usbhost_state_s *priv,
+                                   FAR uint8_t *buffer, size_t startsector,
+                                   unsigned int nsectors);
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+static ssize_t usbhost_readahead(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors);
+#endif
+
 /* struct usbhost_registry_s methods */
 
 static struct usbhost_class_s *
@@ -953,6 +973,14 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_tfree(priv);
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  if (priv->rabuffer != NULL)
+    {
+      (void)DRVR_IOFREE(hport->drvr, priv->rabuffer);
+      priv->rabuffer = NULL;
+    }
+#endif
+
   /* Destroy the semaphores */
 
   nxsem_destroy(&priv->exclsem);
@@ -1649,6 +1677,173 @@ static FAR struct usbmsc_cbw_s *usbhost_cbwalloc(FAR struct usbhost_state_s *pri
   return cbw;
 }
 
+/****************************************************************************
+ * Name: usbhost_readsectors
+ *
+ * Description:
+ *   Read sectors from the device with one READ10 command.
+ *
+ * Input Parameters:
+ *   priv - A reference to the class instance.
+ *   buffer - The location to return the data.
+ *   startsector - The first sector to read.
+ *   nsectors - The number of sectors to read.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success; a negated errno value on
+ *   failure.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_readsectors(FAR struct usbhost_state_s *priv,
+                                   FAR uint8_t *buffer, size_t startsector,
+                                   unsigned int nsectors)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  ssize_t nbytes;
+
+  /* Initialize a CBW (re-using the allocated transfer buffer) */
+
+  cbw = usbhost_cbwalloc(priv);
+  if (cbw == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Loop in the event that EAGAIN is returned (mean that the
+   * transaction was NAKed and we should try again.
+   */
+
+  do
+    {
+      /* Construct and send the CBW */
+
+      usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes >= 0)
+        {
+          /* Receive the user data */
+
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                 buffer, priv->blocksize * nsectors);
+          if (nbytes >= 0)
+            {
+              ssize_t ncsw;
+
+              /* Receive the CSW */
+
+              ncsw = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                   priv->tbuffer, USBMSC_CSW_SIZEOF);
+              if (ncsw < 0)
+                {
+                  nbytes = ncsw;
+                }
+              else
+                {
+                  FAR struct usbmsc_csw_s *csw;
+
+                  /* Check the CSW status */
+
+                  csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+                  if (csw->status != 0)
+                    {
+                      uerr("ERROR: CSW status error: %d\n", csw->status);
+                      nbytes = -ENODEV;
+                    }
+                }
+            }
+        }
+    }
+  while (nbytes == -EAGAIN);
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: usbhost_readahead
+ *
+ * Description:
+ *   Satisfy a small read from the read-ahead buffer.  On a miss, the buffer
+ *   is refilled starting at startsector with up to
+ *   CONFIG_USBHOST_MSC_READAHEAD sectors.  Bulk-only transport permits only
+ *   one command at a time, so reading ahead is what avoids paying the
+ *   CBW/data/CSW round trip for each sector of a sequential read.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+static ssize_t usbhost_readahead(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  unsigned int count;
+  ssize_t nbytes;
+  int ret;
+
+  /* Allocate the read-ahead buffer the first time that it is needed.  If
+   * that fails, just read the sectors directly.
+   */
+
+  if (priv->rabuffer == NULL)
+    {
+      ret = DRVR_IOALLOC(hport->drvr, &priv->rabuffer,
+                         CONFIG_USBHOST_MSC_READAHEAD * priv->blocksize);
+      if (ret < 0)
+        {
+          priv->rabuffer = NULL;
+          return usbhost_readsectors(priv, buffer, startsector, nsectors);
+        }
+
+      priv->ransectors = 0;
+    }
+
+  /* Are all of the requested sectors in the read-ahead buffer? */
+
+  if (priv->ransectors == 0 || startsector < priv->rastart ||
+      startsector + nsectors > priv->rastart + priv->ransectors)
+    {
+      /* No.. refill it, without reading past the end of the device */
+
+      count = CONFIG_USBHOST_MSC_READAHEAD;
+      if (startsector + count > priv->nblocks)
+        {
+          count = priv->nblocks > startsector ?
+                  priv->nblocks - startsector : 0;
+        }
+
+      if (count < nsectors)
+        {
+          return usbhost_readsectors(priv, buffer, startsector, nsectors);
+        }
+
+      priv->ransectors = 0;
+      nbytes = usbhost_readsectors(priv, priv->rabuffer, startsector, count);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      priv->rastart    = startsector;
+      priv->ransectors = count;
+    }
+
+  nbytes = (ssize_t)nsectors * priv->blocksize;
+  memcpy(buffer,
+         &priv->rabuffer[(startsector - priv->rastart) * priv->blocksize],
+         nbytes);
+  return nbytes;
+}
+#endif
+
 /****************************************************************************
  * struct usbhost_registry_s methods
  ****************************************************************************/
@@ -1983,14 +2178,11 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes = 0;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
-
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
         startsector, nsectors, priv->blocksize);
@@ -2008,63 +2200,17 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
     }
   else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
 
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      if (nsectors < CONFIG_USBHOST_MSC_READAHEAD)
         {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
-
-          do
-            {
-              /* Assume some device failure */
-
-              nbytes = -ENODEV;
-
-              /* Construct and send the CBW */
-
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-              if (nbytes >= 0)
-                {
-                  /* Receive the user data */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
-                    {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer, USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n", csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
-                    }
-                }
-            }
-          while (nbytes == -EAGAIN);
+          nbytes = usbhost_readahead(priv, buffer, startsector, nsectors);
+        }
+      else
+#endif
+        {
+          nbytes = usbhost_readsectors(priv, buffer, startsector, nsectors);
         }
 
       usbhost_givesem(&priv->exclsem);
@@ -2117,6 +2263,16 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 
       usbhost_takesem(&priv->exclsem);
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      /* Discard the read-ahead buffer if it overlaps the written sectors */
+
+      if (startsector < priv->rastart + priv->ransectors &&
+          startsector + nsectors > priv->rastart)
+        {
+          priv->ransectors = 0;
+        }
+#endif
+
      /* Assume allocation failure */
 
       nbytes = -ENOMEM;
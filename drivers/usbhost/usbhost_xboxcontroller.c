@@ -571,7 +571,7 @@ static void usbhost_notify(FAR struct usbhost_state_s *priv)
         {
           fds->revents |= POLLIN;
           iinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 #endif
@@ -775,7 +775,7 @@ static void fusb301_notify(FAR struct fusb301_dev_s *priv)
         {
           fds->revents |= POLLIN;
           fusb301_info("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 }
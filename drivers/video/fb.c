@@ -429,6 +429,25 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_FB_PANDISPLAY
+      case FBIOPAN_DISPLAY:  /* Pan display at the next vertical sync */
+        {
+          FAR const struct fb_planeinfo_s *pinfo =
+            (FAR const struct fb_planeinfo_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(pinfo != 0 && fb->vtable != NULL);
+          if (fb->vtable->pandisplay == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else
+            {
+              ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
       case FBIO_SELECT_OVERLAY:  /* Select video overlay */
         {
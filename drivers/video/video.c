@@ -0,0 +1,988 @@
+/****************************************************************************
+ * drivers/video/video.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/video/video.h>
+
+#ifdef CONFIG_VIDEO_STREAM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_VIDEO_NPOLLWAITERS
+#  define CONFIG_VIDEO_NPOLLWAITERS 2
+#endif
+
+/* Each driver allocated buffer begins on this alignment so that DMA does
+ * not share cache lines with other buffers.
+ */
+
+#define VIDEO_ALIGN(n) \
+  (((n) + CONFIG_VIDEO_BUFALIGN - 1) & ~(CONFIG_VIDEO_BUFALIGN - 1))
+
+/* No buffer is being filled */
+
+#define VIDEO_NONE     0xff
+
+/****************************************************************************
+ * Private Type Definitions
+ ****************************************************************************/
+
+/* A FIFO of buffer indices.  A buffer is in at most one queue at a time so
+ * a queue can never hold more than CONFIG_VIDEO_NBUFFERS entries.
+ */
+
+struct video_queue_s
+{
+  uint8_t head;                /* Index of the oldest entry */
+  uint8_t count;               /* Number of entries */
+  uint8_t index[CONFIG_VIDEO_NBUFFERS];
+};
+
+/* One streaming buffer */
+
+struct video_buf_s
+{
+  FAR uint8_t *mem;            /* The buffer memory */
+  uint32_t length;             /* The size of the buffer */
+  uint32_t bytesused;          /* Bytes captured */
+  uint32_t sequence;           /* Frame sequence number */
+  struct timespec timestamp;   /* Time that capture completed */
+  uint8_t  flags;              /* See VIDEO_BUF_FLAG_* definitions */
+};
+
+/* This structure describes the state of the upper half driver */
+
+struct video_upperhalf_s
+{
+  FAR struct video_lowerhalf_s *lower; /* The image sensor/capture hardware */
+  sem_t    exclsem;            /* Supports mutually exclusive access */
+  sem_t    waitsem;            /* Used to wait for a filled buffer */
+  struct video_format_s fmt;   /* The current capture format */
+  FAR uint8_t *pool;           /* VIDEO_MEMORY_MMAP buffer memory */
+  uint32_t buflen;             /* Size of each buffer in the pool */
+  uint32_t sequence;           /* Next frame sequence number */
+  uint8_t  nbufs;              /* Number of buffers (0:  not allocated) */
+  uint8_t  memory;             /* VIDEO_MEMORY_MMAP or USERPTR */
+  uint8_t  active;             /* Buffer being filled (or VIDEO_NONE) */
+  bool     open;               /* The device is open */
+  bool     streaming;          /* Capture has been started */
+  bool     waiting;            /* A task is waiting on waitsem */
+
+  /* The buffers and the queues of buffers to be filled and of filled
+   * buffers.  These are modified by the capture handler.
+   */
+
+  struct video_buf_s   bufs[CONFIG_VIDEO_NBUFFERS];
+  struct video_queue_s inq;
+  struct video_queue_s doneq;
+
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_VIDEO_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    video_captured(FAR void *arg, int result, uint32_t nbytes);
+
+static int     video_open(FAR struct file *filep);
+static int     video_close(FAR struct file *filep);
+static int     video_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     video_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_videoops =
+{
+  video_open,    /* open */
+  video_close,   /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  video_ioctl    /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , video_poll   /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: video_semtake
+ ****************************************************************************/
+
+static void video_semtake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define video_semgive(s) nxsem_post(s)
+
+/****************************************************************************
+ * Name: video_enqueue and video_dequeue
+ *
+ * Description:
+ *   Add a buffer index to the end of a queue and remove the buffer index
+ *   at the head of a queue.  The caller must disable interrupts.
+ *
+ ****************************************************************************/
+
+static void video_enqueue(FAR struct video_queue_s *queue, uint8_t index)
+{
+  unsigned int ndx;
+
+  DEBUGASSERT(queue->count < CONFIG_VIDEO_NBUFFERS);
+
+  ndx = queue->head + queue->count;
+  if (ndx >= CONFIG_VIDEO_NBUFFERS)
+    {
+      ndx -= CONFIG_VIDEO_NBUFFERS;
+    }
+
+  queue->index[ndx] = index;
+  queue->count++;
+}
+
+static uint8_t video_dequeue(FAR struct video_queue_s *queue)
+{
+  uint8_t index;
+
+  DEBUGASSERT(queue->count > 0);
+
+  index = queue->index[queue->head];
+  if (++queue->head >= CONFIG_VIDEO_NBUFFERS)
+    {
+      queue->head = 0;
+    }
+
+  queue->count--;
+  return index;
+}
+
+/****************************************************************************
+ * Name: video_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void video_pollnotify(FAR struct video_upperhalf_s *upper,
+                             pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  /* This function may be called from an interrupt handler */
+
+  for (i = 0; i < CONFIG_VIDEO_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              poll_notify(fds);
+            }
+        }
+    }
+}
+#else
+#  define video_pollnotify(upper,event)
+#endif
+
+/****************************************************************************
+ * Name: video_complete
+ *
+ * Description:
+ *   Move a buffer to the queue of filled buffers and wake up any waiter.
+ *   The caller must disable interrupts.
+ *
+ ****************************************************************************/
+
+static void video_complete(FAR struct video_upperhalf_s *upper,
+                           uint8_t index, int result, uint32_t nbytes)
+{
+  FAR struct video_buf_s *buf = &upper->bufs[index];
+
+  (void)clock_systimespec(&buf->timestamp);
+
+  buf->flags    = VIDEO_BUF_FLAG_DONE;
+  buf->sequence = upper->sequence++;
+
+  if (result < 0)
+    {
+      buf->flags    |= VIDEO_BUF_FLAG_ERROR;
+      buf->bytesused = 0;
+    }
+  else
+    {
+      buf->bytesused = nbytes < buf->length ? nbytes : buf->length;
+    }
+
+  video_enqueue(&upper->doneq, index);
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      video_semgive(&upper->waitsem);
+    }
+
+  video_pollnotify(upper, POLLIN);
+}
+
+/****************************************************************************
+ * Name: video_arm
+ *
+ * Description:
+ *   If streaming and the lower half is idle, give it the next queued
+ *   buffer to fill.  The caller must disable interrupts.
+ *
+ ****************************************************************************/
+
+static void video_arm(FAR struct video_upperhalf_s *upper)
+{
+  FAR struct video_lowerhalf_s *lower = upper->lower;
+  FAR struct video_buf_s *buf;
+  uint8_t index;
+  int ret;
+
+  while (upper->streaming && upper->active == VIDEO_NONE &&
+         upper->inq.count > 0)
+    {
+      index = video_dequeue(&upper->inq);
+      buf   = &upper->bufs[index];
+
+      upper->active = index;
+      ret = lower->ops->capture(lower, buf->mem, buf->length);
+      if (ret < 0)
+        {
+          gerr("ERROR: capture failed: %d\n", ret);
+          upper->active = VIDEO_NONE;
+          video_complete(upper, index, ret, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: video_captured
+ *
+ * Description:
+ *   The lower half callback.  This may run in an interrupt handler.  The
+ *   buffer that was being filled is completed and the next queued buffer
+ *   is started immediately so that no frames are missed as long as the
+ *   application keeps buffers queued.
+ *
+ ****************************************************************************/
+
+static void video_captured(FAR void *arg, int result, uint32_t nbytes)
+{
+  FAR struct video_upperhalf_s *upper = (FAR struct video_upperhalf_s *)arg;
+  irqstate_t flags;
+  uint8_t index;
+
+  DEBUGASSERT(upper != NULL);
+
+  flags = enter_critical_section();
+
+  index = upper->active;
+  if (index != VIDEO_NONE)
+    {
+      upper->active = VIDEO_NONE;
+      video_complete(upper, index, result, nbytes);
+      video_arm(upper);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: video_streamoff
+ *
+ * Description:
+ *   Stop the lower half and return all buffers to the application.
+ *
+ ****************************************************************************/
+
+static int video_streamoff(FAR struct video_upperhalf_s *upper)
+{
+  FAR struct video_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  if (upper->streaming)
+    {
+      ret = lower->ops->stop(lower);
+    }
+
+  flags = enter_critical_section();
+
+  upper->streaming   = false;
+  upper->active      = VIDEO_NONE;
+  upper->inq.count   = 0;
+  upper->doneq.count = 0;
+
+  for (i = 0; i < upper->nbufs; i++)
+    {
+      upper->bufs[i].flags = 0;
+    }
+
+  if (upper->waiting)
+    {
+      upper->waiting = false;
+      video_semgive(&upper->waitsem);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: video_freebufs
+ ****************************************************************************/
+
+static void video_freebufs(FAR struct video_upperhalf_s *upper)
+{
+  if (upper->pool != NULL)
+    {
+      kumm_free(upper->pool);
+      upper->pool = NULL;
+    }
+
+  memset(upper->bufs, 0, sizeof(upper->bufs));
+  upper->nbufs  = 0;
+  upper->buflen = 0;
+}
+
+/****************************************************************************
+ * Name: video_reqbufs
+ ****************************************************************************/
+
+static int video_reqbufs(FAR struct video_upperhalf_s *upper,
+                         FAR struct video_reqbufs_s *req)
+{
+  uint32_t count;
+  int i;
+
+  if (upper->streaming)
+    {
+      return -EBUSY;
+    }
+
+  if (req->memory != VIDEO_MEMORY_MMAP &&
+      req->memory != VIDEO_MEMORY_USERPTR)
+    {
+      return -EINVAL;
+    }
+
+  video_freebufs(upper);
+
+  count = req->count;
+  if (count == 0)
+    {
+      return OK;
+    }
+
+  if (upper->fmt.imagesize == 0)
+    {
+      /* The format has not been set */
+
+      return -EINVAL;
+    }
+
+  if (count > CONFIG_VIDEO_NBUFFERS)
+    {
+      count = CONFIG_VIDEO_NBUFFERS;
+    }
+
+  if (req->memory == VIDEO_MEMORY_MMAP)
+    {
+      /* Allocate all buffers as one region so that the whole pool is
+       * mapped with a single mmap().  It comes from the user heap so that
+       * it is accessible to the application.
+       */
+
+      upper->buflen = VIDEO_ALIGN(upper->fmt.imagesize);
+      upper->pool   = (FAR uint8_t *)
+        kumm_memalign(CONFIG_VIDEO_BUFALIGN, count * upper->buflen);
+
+      if (upper->pool == NULL)
+        {
+          gerr("ERROR: Failed to allocate %lu buffers\n",
+               (unsigned long)count);
+          upper->buflen = 0;
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          upper->bufs[i].mem    = upper->pool + i * upper->buflen;
+          upper->bufs[i].length = upper->buflen;
+        }
+    }
+
+  upper->memory = req->memory;
+  upper->nbufs  = count;
+  req->count    = count;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: video_getbuf
+ *
+ * Description:
+ *   Return the description of a buffer to the application.
+ *
+ ****************************************************************************/
+
+static void video_getbuf(FAR struct video_upperhalf_s *upper,
+                         uint8_t index, FAR struct video_buffer_s *vbuf)
+{
+  FAR struct video_buf_s *buf = &upper->bufs[index];
+
+  vbuf->index     = index;
+  vbuf->memory    = upper->memory;
+  vbuf->flags     = buf->flags;
+  vbuf->length    = buf->length;
+  vbuf->bytesused = buf->bytesused;
+  vbuf->sequence  = buf->sequence;
+  vbuf->timestamp = buf->timestamp;
+
+  if (upper->memory == VIDEO_MEMORY_MMAP)
+    {
+      vbuf->offset  = (off_t)index * upper->buflen;
+      vbuf->userptr = NULL;
+    }
+  else
+    {
+      vbuf->offset  = 0;
+      vbuf->userptr = buf->mem;
+    }
+}
+
+/****************************************************************************
+ * Name: video_qbuf
+ ****************************************************************************/
+
+static int video_qbuf(FAR struct video_upperhalf_s *upper,
+                      FAR struct video_buffer_s *vbuf)
+{
+  FAR struct video_buf_s *buf;
+  irqstate_t flags;
+
+  if (vbuf->index >= upper->nbufs || vbuf->memory != upper->memory)
+    {
+      return -EINVAL;
+    }
+
+  buf = &upper->bufs[vbuf->index];
+  if ((buf->flags & (VIDEO_BUF_FLAG_QUEUED | VIDEO_BUF_FLAG_DONE)) != 0)
+    {
+      return -EBUSY;
+    }
+
+  if (upper->memory == VIDEO_MEMORY_USERPTR)
+    {
+      /* The application buffer must hold a whole frame */
+
+      if (vbuf->userptr == NULL || vbuf->length < upper->fmt.imagesize)
+        {
+          return -EINVAL;
+        }
+
+      buf->mem    = (FAR uint8_t *)vbuf->userptr;
+      buf->length = vbuf->length;
+    }
+
+  flags = enter_critical_section();
+
+  buf->flags     = VIDEO_BUF_FLAG_QUEUED;
+  buf->bytesused = 0;
+  video_enqueue(&upper->inq, vbuf->index);
+  video_arm(upper);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: video_dqbuf
+ ****************************************************************************/
+
+static int video_dqbuf(FAR struct video_upperhalf_s *upper,
+                       FAR struct video_buffer_s *vbuf, bool nonblock)
+{
+  irqstate_t flags;
+  uint8_t index;
+  int ret;
+
+  flags = enter_critical_section();
+
+  while (upper->doneq.count == 0)
+    {
+      if (!upper->streaming)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Wait for a frame.  Other operations (such as VIDIOC_QBUF from
+       * another thread) may proceed while we wait.
+       */
+
+      upper->waiting = true;
+      video_semgive(&upper->exclsem);
+      ret = nxsem_wait(&upper->waitsem);
+      video_semtake(&upper->exclsem);
+
+      if (ret < 0)
+        {
+          upper->waiting = false;
+          goto errout;
+        }
+    }
+
+  index = video_dequeue(&upper->doneq);
+  upper->bufs[index].flags &= ~VIDEO_BUF_FLAG_DONE;
+  leave_critical_section(flags);
+
+  video_getbuf(upper, index, vbuf);
+  return OK;
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: video_open
+ ****************************************************************************/
+
+static int video_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct video_upperhalf_s *upper;
+  int ret = OK;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  upper = (FAR struct video_upperhalf_s *)inode->i_private;
+
+  /* The streaming buffers belong to a single user */
+
+  video_semtake(&upper->exclsem);
+  if (upper->open)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      upper->open = true;
+    }
+
+  video_semgive(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: video_close
+ ****************************************************************************/
+
+static int video_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct video_upperhalf_s *upper;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  upper = (FAR struct video_upperhalf_s *)inode->i_private;
+
+  video_semtake(&upper->exclsem);
+  (void)video_streamoff(upper);
+  video_freebufs(upper);
+  upper->open = false;
+  video_semgive(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: video_ioctl
+ ****************************************************************************/
+
+static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct video_upperhalf_s *upper;
+  FAR struct video_lowerhalf_s *lower;
+  FAR struct video_buffer_s *vbuf;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  upper = (FAR struct video_upperhalf_s *)inode->i_private;
+  lower = upper->lower;
+
+  video_semtake(&upper->exclsem);
+
+  switch (cmd)
+    {
+      case VIDIOC_G_FMT:
+        {
+          FAR struct video_format_s *fmt =
+            (FAR struct video_format_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(fmt != NULL);
+          *fmt = upper->fmt;
+          ret  = OK;
+        }
+        break;
+
+      case VIDIOC_S_FMT:
+        {
+          FAR struct video_format_s *fmt =
+            (FAR struct video_format_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(fmt != NULL);
+          if (upper->nbufs > 0)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          ret = lower->ops->setformat(lower, fmt);
+          if (ret >= 0)
+            {
+              upper->fmt = *fmt;
+            }
+        }
+        break;
+
+      case VIDIOC_REQBUFS:
+        {
+          FAR struct video_reqbufs_s *req =
+            (FAR struct video_reqbufs_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(req != NULL);
+          ret = video_reqbufs(upper, req);
+        }
+        break;
+
+      case VIDIOC_QUERYBUF:
+        {
+          vbuf = (FAR struct video_buffer_s *)((uintptr_t)arg);
+          DEBUGASSERT(vbuf != NULL);
+
+          if (vbuf->index >= upper->nbufs)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          video_getbuf(upper, vbuf->index, vbuf);
+          ret = OK;
+        }
+        break;
+
+      case VIDIOC_QBUF:
+        {
+          vbuf = (FAR struct video_buffer_s *)((uintptr_t)arg);
+          DEBUGASSERT(vbuf != NULL);
+          ret = video_qbuf(upper, vbuf);
+        }
+        break;
+
+      case VIDIOC_DQBUF:
+        {
+          vbuf = (FAR struct video_buffer_s *)((uintptr_t)arg);
+          DEBUGASSERT(vbuf != NULL);
+          ret = video_dqbuf(upper, vbuf,
+                            (filep->f_oflags & O_NONBLOCK) != 0);
+        }
+        break;
+
+      case VIDIOC_STREAMON:
+        {
+          if (upper->nbufs == 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          if (upper->streaming)
+            {
+              ret = OK;
+              break;
+            }
+
+          ret = lower->ops->start(lower, video_captured, upper);
+          if (ret >= 0)
+            {
+              flags = enter_critical_section();
+              upper->streaming = true;
+              video_arm(upper);
+              leave_critical_section(flags);
+            }
+        }
+        break;
+
+      case VIDIOC_STREAMOFF:
+        ret = video_streamoff(upper);
+        break;
+
+      /* Return the address of the buffer pool.  mmap() adds the offset
+       * of the buffer (see VIDIOC_QUERYBUF).
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          if (upper->pool == NULL)
+            {
+              ret = -ENODEV;
+              break;
+            }
+
+          *ppv = upper->pool;
+          ret  = OK;
+        }
+        break;
+
+      default:
+        {
+          if (lower->ops->ioctl != NULL)
+            {
+              ret = lower->ops->ioctl(lower, cmd, arg);
+            }
+          else
+            {
+              ret = -ENOTTY;
+            }
+        }
+        break;
+    }
+
+  video_semgive(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: video_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int video_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct video_upperhalf_s *upper;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  upper = (FAR struct video_upperhalf_s *)inode->i_private;
+
+  video_semtake(&upper->exclsem);
+
+  /* The poll structures are also referenced from the capture handler */
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      /* This is a request to set up the poll.  Find an available slot for
+       * the poll structure reference.
+       */
+
+      for (i = 0; i < CONFIG_VIDEO_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_VIDEO_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (upper->doneq.count > 0)
+        {
+          /* A filled buffer is already waiting */
+
+          video_pollnotify(upper, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  video_semgive(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: video_register
+ *
+ * Description:
+ *   Register a video capture device.  Frames are captured directly into
+ *   buffers that are either allocated by the driver and mapped into the
+ *   application with mmap(), or provided by the application.  No frame
+ *   data is copied by the CPU.
+ *
+ * Input Parameters:
+ *   path  - The path to the device.  Normally "/dev/videoN".
+ *   lower - An instance of the lower half video capture driver.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int video_register(FAR const char *path,
+                   FAR struct video_lowerhalf_s *lower)
+{
+  FAR struct video_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(path != NULL && lower != NULL && lower->ops != NULL);
+  DEBUGASSERT(lower->ops->setformat != NULL && lower->ops->start != NULL &&
+              lower->ops->capture != NULL && lower->ops->stop != NULL);
+
+  upper = (FAR struct video_upperhalf_s *)
+    kmm_zalloc(sizeof(struct video_upperhalf_s));
+
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->lower  = lower;
+  upper->active = VIDEO_NONE;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->waitsem, SEM_PRIO_NONE);
+
+  ret = register_driver(path, &g_videoops, 0666, upper);
+  if (ret < 0)
+    {
+      gerr("ERROR: register_driver failed: %d\n", ret);
+      nxsem_destroy(&upper->waitsem);
+      nxsem_destroy(&upper->exclsem);
+      kmm_free(upper);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_VIDEO_STREAM */
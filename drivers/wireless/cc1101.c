@@ -690,7 +690,7 @@ static int cc1101_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
       if (dev->fifo_len > 0)
         {
           dev->pfd->revents |= POLLIN; /* Data available for input */
-          nxsem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
         }
 
       nxsem_post(&dev->sem_rx_buffer);
@@ -1585,7 +1585,7 @@ void cc1101_isr_process(FAR void *arg)
             {
               dev->pfd->revents |= POLLIN; /* Data available for input */
               wlinfo("Wake up polled fd\n");
-              nxsem_post(dev->pfd->sem);
+              poll_notify(dev->pfd);
             }
 #endif
         }
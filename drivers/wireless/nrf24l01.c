@@ -60,6 +60,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 
 #ifdef CONFIG_WL_NRF24L01_RXSUPPORT
@@ -732,7 +733,7 @@ static void nrf24l01_worker(FAR void *arg)
           dev->pfd->revents |= POLLIN;  /* Data available for input */
 
           wlinfo("Wake up polled fd\n");
-          nxsem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
         }
 #endif
 
@@ -1401,7 +1402,7 @@ static int nrf24l01_poll(FAR struct file *filep, FAR struct pollfd *fds,
       if (dev->fifo_len > 0)
         {
           dev->pfd->revents |= POLLIN;  /* Data available for input */
-          nxsem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
         }
 
       nxsem_post(&dev->sem_fifo);
@@ -204,6 +204,24 @@ FAR struct aio_container_s *aioc_alloc(void);
 
 void aioc_free(FAR struct aio_container_s *aioc);
 
+/****************************************************************************
+ * Name: aioc_create
+ *
+ * Description:
+ *   Create and initialize a container for the provided AIO control block,
+ *   but do not add it to the pending transfer list.
+ *
+ * Input Parameters:
+ *   aiocbp - The AIO control block pointer
+ *
+ * Returned Value:
+ *   A reference to the new AIO control block container or NULL on failure
+ *   with the errno value set appropriately.  See aio_contain().
+ *
+ ****************************************************************************/
+
+FAR struct aio_container_s *aioc_create(FAR struct aiocb *aiocbp);
+
 /****************************************************************************
  * Name: aio_contain
  *
@@ -0,0 +1,412 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/aioring.h>
+#include <nuttx/net/net.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Add a completed request to the completion queue and wake up any
+ *   thread waiting in aio_ring_reap().  There is always room in the
+ *   completion queue because aio_ring_submit() never has more requests
+ *   outstanding than the queue can hold.
+ *
+ ****************************************************************************/
+
+static void aio_ring_complete(FAR struct aio_ring_s *ring,
+                              FAR struct aiocb *aiocbp)
+{
+  aio_lock();
+  DEBUGASSERT((uint16_t)(ring->ar_cqtail - ring->ar_cqhead) <= ring->ar_mask);
+  ring->ar_cq[ring->ar_cqtail & ring->ar_mask] = aiocbp;
+  ring->ar_cqtail++;
+  aio_unlock();
+
+  nxsem_post(&ring->ar_cqsem);
+}
+
+/****************************************************************************
+ * Name: aio_ring_perform
+ *
+ * Description:
+ *   Perform the I/O for one request on the worker thread.
+ *
+ * Input Parameters:
+ *   aiocbp - The AIO control block
+ *   ptr    - The file or socket structure recovered from the container
+ *
+ * Returned Value:
+ *   The result of the transfer, as for aio_return().
+ *
+ ****************************************************************************/
+
+static ssize_t aio_ring_perform(FAR struct aiocb *aiocbp, FAR void *ptr)
+{
+#ifdef AIO_HAVE_FILEP
+  int oflags;
+#endif
+
+  if (aiocbp->aio_lio_opcode == LIO_NOP)
+    {
+      return 0;
+    }
+  else if (aiocbp->aio_lio_opcode != LIO_READ &&
+           aiocbp->aio_lio_opcode != LIO_WRITE)
+    {
+      return -EINVAL;
+    }
+
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  if (aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+#ifdef AIO_HAVE_FILEP
+    {
+      FAR struct file *filep = (FAR struct file *)ptr;
+
+      if (aiocbp->aio_lio_opcode == LIO_READ)
+        {
+          return file_pread(filep, (FAR void *)aiocbp->aio_buf,
+                            aiocbp->aio_nbytes, aiocbp->aio_offset);
+        }
+
+      /* Writes honor O_APPEND, as in aio_write() */
+
+      oflags = file_fcntl(filep, F_GETFL);
+      if (oflags < 0)
+        {
+          return oflags;
+        }
+
+      if ((oflags & O_APPEND) != 0)
+        {
+          return file_write(filep, (FAR const void *)aiocbp->aio_buf,
+                            aiocbp->aio_nbytes);
+        }
+
+      return file_pwrite(filep, (FAR const void *)aiocbp->aio_buf,
+                         aiocbp->aio_nbytes, aiocbp->aio_offset);
+    }
+#endif
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  else
+#endif
+#ifdef AIO_HAVE_PSOCK
+    {
+      FAR struct socket *psock = (FAR struct socket *)ptr;
+
+      if (aiocbp->aio_lio_opcode == LIO_READ)
+        {
+          return psock_recv(psock, (FAR void *)aiocbp->aio_buf,
+                            aiocbp->aio_nbytes, 0);
+        }
+
+      return psock_send(psock, (FAR const void *)aiocbp->aio_buf,
+                        aiocbp->aio_nbytes, 0);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: aio_ring_worker
+ *
+ * Description:
+ *   Runs on the low priority worker thread and performs all submitted
+ *   requests of the ring, one after the other.
+ *
+ * Input Parameters:
+ *   arg - The AIO ring cast to void *.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void aio_ring_worker(FAR void *arg)
+{
+  FAR struct aio_ring_s *ring = (FAR struct aio_ring_s *)arg;
+  FAR struct aio_container_s *aioc;
+  FAR struct aiocb *aiocbp;
+  FAR void *ptr;
+  ssize_t result;
+
+  DEBUGASSERT(ring != NULL);
+
+  for (; ; )
+    {
+      /* Take the next request, freeing its container before starting any
+       * I/O so that other threads waiting for a container are not
+       * delayed.
+       */
+
+      aio_lock();
+      aioc = (FAR struct aio_container_s *)dq_remfirst(&ring->ar_pending);
+      if (aioc == NULL)
+        {
+          aio_unlock();
+          break;
+        }
+
+      aiocbp = aioc->aioc_aiocbp;
+      ptr    = aioc->u.ptr;
+      aioc_free(aioc);
+      aio_unlock();
+
+      result = aio_ring_perform(aiocbp, ptr);
+      if (result < 0)
+        {
+          ferr("ERROR: AIO ring request failed: %d\n", (int)result);
+        }
+
+      aiocbp->aio_result = result;
+      aio_ring_complete(ring, aiocbp);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_setup
+ *
+ * Description:
+ *   Initialize an AIO ring.
+ *
+ ****************************************************************************/
+
+int aio_ring_setup(FAR struct aio_ring_s *ring, FAR struct aiocb **sq,
+                   FAR struct aiocb **cq, unsigned int nentries)
+{
+  if (ring == NULL || sq == NULL || cq == NULL || nentries == 0 ||
+      nentries > 32768 || (nentries & (nentries - 1)) != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  memset(ring, 0, sizeof(struct aio_ring_s));
+  ring->ar_sq   = sq;
+  ring->ar_cq   = cq;
+  ring->ar_mask = nentries - 1;
+
+  /* The CQ semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&ring->ar_cqsem, 0, 0);
+  (void)nxsem_setprotocol(&ring->ar_cqsem, SEM_PRIO_NONE);
+  dq_init(&ring->ar_pending);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_teardown
+ *
+ * Description:
+ *   Release the resources of an AIO ring.
+ *
+ ****************************************************************************/
+
+int aio_ring_teardown(FAR struct aio_ring_s *ring)
+{
+  DEBUGASSERT(ring != NULL);
+
+  if (ring->ar_sqhead != ring->ar_cqhead)
+    {
+      set_errno(EBUSY);
+      return ERROR;
+    }
+
+  (void)nxsem_destroy(&ring->ar_cqsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_enqueue
+ *
+ * Description:
+ *   Add one request to the submission queue.
+ *
+ ****************************************************************************/
+
+int aio_ring_enqueue(FAR struct aio_ring_s *ring, FAR struct aiocb *aiocbp)
+{
+  DEBUGASSERT(ring != NULL && aiocbp != NULL);
+
+  if ((uint16_t)(ring->ar_sqtail - ring->ar_sqhead) > ring->ar_mask)
+    {
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+
+  ring->ar_sq[ring->ar_sqtail & ring->ar_mask] = aiocbp;
+  ring->ar_sqtail++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Submit all requests enqueued since the last call.
+ *
+ ****************************************************************************/
+
+int aio_ring_submit(FAR struct aio_ring_s *ring)
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aiocb *aiocbp;
+  int nsubmitted = 0;
+  int ret;
+
+  DEBUGASSERT(ring != NULL);
+
+  while (ring->ar_sqhead != ring->ar_sqtail &&
+         (uint16_t)(ring->ar_sqhead - ring->ar_cqhead) <= ring->ar_mask)
+    {
+      aiocbp = ring->ar_sq[ring->ar_sqhead & ring->ar_mask];
+      ring->ar_sqhead++;
+      nsubmitted++;
+
+      /* The result -EINPROGRESS means that the transfer has not yet
+       * completed
+       */
+
+      aiocbp->aio_result = -EINPROGRESS;
+      aiocbp->aio_priv   = NULL;
+
+      /* Create a container for the AIO control block.  The file or socket
+       * must be looked up here, in the context of the submitting task.
+       */
+
+      aioc = aioc_create(aiocbp);
+      if (aioc == NULL)
+        {
+          /* The errno has already been set (probably EBADF).  Complete the
+           * request now with that error.
+           */
+
+          aiocbp->aio_result = -get_errno();
+          aio_ring_complete(ring, aiocbp);
+          continue;
+        }
+
+      aio_lock();
+      dq_addlast(&aioc->aioc_link, &ring->ar_pending);
+      aio_unlock();
+    }
+
+  /* Start the worker unless it is already queued.  If it is running now,
+   * it will either find the new requests or we queue it again here.
+   */
+
+  if (nsubmitted > 0 && work_available(&ring->ar_work))
+    {
+      ret = work_queue(LPWORK, &ring->ar_work, aio_ring_worker, ring, 0);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+    }
+
+  return nsubmitted;
+}
+
+/****************************************************************************
+ * Name: aio_ring_reap
+ *
+ * Description:
+ *   Remove the next completed request from the completion queue.
+ *
+ ****************************************************************************/
+
+FAR struct aiocb *aio_ring_reap(FAR struct aio_ring_s *ring, bool wait)
+{
+  FAR struct aiocb *aiocbp;
+  int ret;
+
+  DEBUGASSERT(ring != NULL);
+
+  if (wait)
+    {
+      ret = nxsem_wait(&ring->ar_cqsem);
+    }
+  else
+    {
+      ret = nxsem_trywait(&ring->ar_cqsem);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return NULL;
+    }
+
+  aio_lock();
+  aiocbp = ring->ar_cq[ring->ar_cqhead & ring->ar_mask];
+  ring->ar_cqhead++;
+  aio_unlock();
+
+  return aiocbp;
+}
+
+#endif /* CONFIG_FS_AIO_RING */
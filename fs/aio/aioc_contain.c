@@ -55,10 +55,11 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: aio_contain
+ * Name: aioc_create
  *
  * Description:
- *   Create and initialize a container for the provided AIO control block
+ *   Create and initialize a container for the provided AIO control block,
+ *   but do not add it to the pending transfer list.
  *
  * Input Parameters:
  *   aiocbp - The AIO control block pointer
@@ -71,7 +72,7 @@
  *
  ****************************************************************************/
 
-FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
+FAR struct aio_container_s *aioc_create(FAR struct aiocb *aiocbp)
 {
   FAR struct aio_container_s *aioc;
   union
@@ -144,11 +145,6 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   aioc->aioc_prio = param.sched_priority;
 #endif
 
-  /* Add the container to the pending transfer list. */
-
-  aio_lock();
-  dq_addlast(&aioc->aioc_link, &g_aio_pending);
-  aio_unlock();
   return aioc;
 
 errout:
@@ -156,6 +152,40 @@ errout:
   return NULL;
 }
 
+/****************************************************************************
+ * Name: aio_contain
+ *
+ * Description:
+ *   Create and initialize a container for the provided AIO control block
+ *
+ * Input Parameters:
+ *   aiocbp - The AIO control block pointer
+ *
+ * Returned Value:
+ *   A reference to the new AIO control block container.   This function
+ *   will not fail but will wait if necessary for the resources to perform
+ *   this operation.  NULL will be returned on certain errors with the
+ *   errno value already set appropriately.
+ *
+ ****************************************************************************/
+
+FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
+{
+  FAR struct aio_container_s *aioc;
+
+  aioc = aioc_create(aiocbp);
+  if (aioc != NULL)
+    {
+      /* Add the container to the pending transfer list. */
+
+      aio_lock();
+      dq_addlast(&aioc->aioc_link, &g_aio_pending);
+      aio_unlock();
+    }
+
+  return aioc;
+}
+
 /****************************************************************************
  * Name: aioc_decant
  *
@@ -0,0 +1,708 @@
+/****************************************************************************
+ * fs/blkcache/fs_blkcache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkcache.h>
+
+#ifdef CONFIG_FS_BLKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_BLKCACHE_NBLOCKS
+#  define CONFIG_FS_BLKCACHE_NBLOCKS 16
+#endif
+
+#ifndef CONFIG_FS_BLKCACHE_BLOCKSIZE
+#  define CONFIG_FS_BLKCACHE_BLOCKSIZE 512
+#endif
+
+#ifndef CONFIG_FS_BLKCACHE_READAHEAD
+#  define CONFIG_FS_BLKCACHE_READAHEAD 4
+#endif
+
+#if CONFIG_FS_BLKCACHE_READAHEAD < 1
+#  error CONFIG_FS_BLKCACHE_READAHEAD must be at least one
+#endif
+
+#if CONFIG_FS_BLKCACHE_READAHEAD > CONFIG_FS_BLKCACHE_NBLOCKS
+#  error CONFIG_FS_BLKCACHE_READAHEAD may not exceed CONFIG_FS_BLKCACHE_NBLOCKS
+#endif
+
+/* Cache entry flags */
+
+#define BLKCACHE_VALID   (1 << 0)  /* Entry holds a sector */
+#define BLKCACHE_DIRTY   (1 << 1)  /* Sector differs from the media */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct blkcache_entry_s
+{
+  FAR struct inode *bc_inode;      /* The block driver */
+  blkcnt_t bc_sector;              /* The cached sector */
+  uint32_t bc_lru;                 /* Time stamp of the last access */
+  uint8_t bc_flags;                /* See BLKCACHE_* definitions */
+  FAR uint8_t *bc_buffer;          /* Sector data */
+};
+
+/* The state of the block cache */
+
+struct blkcache_s
+{
+  sem_t exclsem;                   /* Exclusive access to the cache */
+  bool initialized;                /* True: Semaphore initialized */
+  bool allocated;                  /* True: Allocation was attempted */
+  uint32_t lru;                    /* Access time stamp counter */
+  FAR uint8_t *pool;               /* Memory for all sector buffers */
+  FAR uint8_t *rabuffer;           /* Read-ahead staging buffer */
+  struct blkcache_entry_s entry[CONFIG_FS_BLKCACHE_NBLOCKS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct blkcache_s g_blkcache;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_semtake
+ *
+ * Description:
+ *   Get exclusive access to the block cache and allocate the sector
+ *   buffers on first use.  Returns false if no buffers are available, in
+ *   which case the cache is bypassed (the semaphore is still held).
+ *
+ ****************************************************************************/
+
+static bool blkcache_semtake(void)
+{
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  flags = enter_critical_section();
+  if (!g_blkcache.initialized)
+    {
+      nxsem_init(&g_blkcache.exclsem, 0, 1);
+      g_blkcache.initialized = true;
+    }
+
+  leave_critical_section(flags);
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&g_blkcache.exclsem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  if (!g_blkcache.allocated)
+    {
+      g_blkcache.allocated = true;
+      g_blkcache.pool = (FAR uint8_t *)
+        kmm_malloc((CONFIG_FS_BLKCACHE_NBLOCKS +
+                    CONFIG_FS_BLKCACHE_READAHEAD) *
+                   CONFIG_FS_BLKCACHE_BLOCKSIZE);
+
+      if (g_blkcache.pool == NULL)
+        {
+          ferr("ERROR: Failed to allocate the block cache\n");
+        }
+      else
+        {
+          for (i = 0; i < CONFIG_FS_BLKCACHE_NBLOCKS; i++)
+            {
+              g_blkcache.entry[i].bc_buffer =
+                &g_blkcache.pool[i * CONFIG_FS_BLKCACHE_BLOCKSIZE];
+            }
+
+          g_blkcache.rabuffer =
+            &g_blkcache.pool[CONFIG_FS_BLKCACHE_NBLOCKS *
+                             CONFIG_FS_BLKCACHE_BLOCKSIZE];
+        }
+    }
+
+  return g_blkcache.pool != NULL;
+}
+
+/****************************************************************************
+ * Name: blkcache_semgive
+ ****************************************************************************/
+
+static inline void blkcache_semgive(void)
+{
+  nxsem_post(&g_blkcache.exclsem);
+}
+
+/****************************************************************************
+ * Name: blkcache_hwread and blkcache_hwwrite
+ *
+ * Description:
+ *   Transfer sectors directly to or from the block driver.  Returns OK if
+ *   all sectors were transferred; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+static int blkcache_hwread(FAR struct inode *inode, FAR uint8_t *buffer,
+                           blkcnt_t start, unsigned int nsectors)
+{
+  ssize_t nread;
+
+  if (inode->u.i_bops == NULL || inode->u.i_bops->read == NULL)
+    {
+      return -ENODEV;
+    }
+
+  nread = inode->u.i_bops->read(inode, buffer, start, nsectors);
+  if (nread < 0)
+    {
+      return (int)nread;
+    }
+
+  return (nread == nsectors) ? OK : -EIO;
+}
+
+static int blkcache_hwwrite(FAR struct inode *inode,
+                            FAR const uint8_t *buffer, blkcnt_t start,
+                            unsigned int nsectors)
+{
+  ssize_t nwritten;
+
+  if (inode->u.i_bops == NULL || inode->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  nwritten = inode->u.i_bops->write(inode, buffer, start, nsectors);
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+  return (nwritten == nsectors) ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: blkcache_find
+ *
+ * Description:
+ *   Return the cache entry holding the sector or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *blkcache_find(FAR struct inode *inode,
+                                                  blkcnt_t sector)
+{
+  FAR struct blkcache_entry_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLKCACHE_NBLOCKS; i++)
+    {
+      entry = &g_blkcache.entry[i];
+      if ((entry->bc_flags & BLKCACHE_VALID) != 0 &&
+          entry->bc_inode == inode && entry->bc_sector == sector)
+        {
+          entry->bc_lru = ++g_blkcache.lru;
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: blkcache_alloc
+ *
+ * Description:
+ *   Get an entry for a new sector:  An unused entry if there is one,
+ *   otherwise the least recently used entry, which is written back first if
+ *   it is dirty.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *blkcache_alloc(FAR struct inode *inode,
+                                                   blkcnt_t sector,
+                                                   FAR int *result)
+{
+  FAR struct blkcache_entry_s *victim = NULL;
+  FAR struct blkcache_entry_s *entry;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLKCACHE_NBLOCKS; i++)
+    {
+      entry = &g_blkcache.entry[i];
+      if ((entry->bc_flags & BLKCACHE_VALID) == 0)
+        {
+          victim = entry;
+          break;
+        }
+
+      if (victim == NULL ||
+          (int32_t)(entry->bc_lru - victim->bc_lru) < 0)
+        {
+          victim = entry;
+        }
+    }
+
+  if ((victim->bc_flags & BLKCACHE_DIRTY) != 0)
+    {
+      ret = blkcache_hwwrite(victim->bc_inode, victim->bc_buffer,
+                             victim->bc_sector, 1);
+      if (ret < 0)
+        {
+          ferr("ERROR: Write back of sector %lu failed: %d\n",
+               (unsigned long)victim->bc_sector, ret);
+          *result = ret;
+          return NULL;
+        }
+    }
+
+  victim->bc_inode  = inode;
+  victim->bc_sector = sector;
+  victim->bc_flags  = BLKCACHE_VALID;
+  victim->bc_lru    = ++g_blkcache.lru;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: blkcache_fill
+ *
+ * Description:
+ *   Handle a read miss of 'nmiss' (< CONFIG_FS_BLKCACHE_READAHEAD) sectors
+ *   by reading a full read-ahead block into the staging buffer and adding
+ *   each sector to the cache.  Read-ahead sectors that are already cached
+ *   are left alone since the cached copy may be dirty.
+ *
+ ****************************************************************************/
+
+static int blkcache_fill(FAR struct inode *inode, FAR uint8_t *buffer,
+                         blkcnt_t start, unsigned int nmiss,
+                         uint16_t sectsize)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR uint8_t *src;
+  unsigned int nfill;
+  unsigned int i;
+  int ret;
+
+  /* Read ahead.  The read may fail near the end of the media, so fall back
+   * to reading only the missed sectors in that case.
+   */
+
+  nfill = CONFIG_FS_BLKCACHE_READAHEAD;
+  ret   = blkcache_hwread(inode, g_blkcache.rabuffer, start, nfill);
+  if (ret < 0 && nfill > nmiss)
+    {
+      nfill = nmiss;
+      ret   = blkcache_hwread(inode, g_blkcache.rabuffer, start, nfill);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(buffer, g_blkcache.rabuffer, nmiss * sectsize);
+
+  for (i = 0, src = g_blkcache.rabuffer; i < nfill; i++, src += sectsize)
+    {
+      if (i >= nmiss && blkcache_find(inode, start + i) != NULL)
+        {
+          continue;
+        }
+
+      entry = blkcache_alloc(inode, start + i, &ret);
+      if (entry == NULL)
+        {
+          /* The caller's data was still read successfully */
+
+          break;
+        }
+
+      memcpy(entry->bc_buffer, src, sectsize);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_xread
+ *
+ * Description:
+ *   Common logic of blkcache_read() and blkcache_directread().  If 'direct'
+ *   is true, misses are always read directly into the caller's buffer and
+ *   nothing is added to the cache.
+ *
+ ****************************************************************************/
+
+static ssize_t blkcache_xread(FAR struct inode *inode, FAR uint8_t *buffer,
+                              blkcnt_t start, unsigned int nsectors,
+                              uint16_t sectsize, bool direct)
+{
+  FAR struct blkcache_entry_s *entry;
+  unsigned int remaining;
+  unsigned int nmiss;
+  int ret = OK;
+
+  DEBUGASSERT(inode != NULL && buffer != NULL);
+
+  if (!blkcache_semtake() || sectsize > CONFIG_FS_BLKCACHE_BLOCKSIZE)
+    {
+      /* The cache is not usable; read directly from the driver */
+
+      ret = blkcache_hwread(inode, buffer, start, nsectors);
+      goto out_with_semaphore;
+    }
+
+  remaining = nsectors;
+  while (remaining > 0)
+    {
+      /* Copy out the cached sectors */
+
+      entry = blkcache_find(inode, start);
+      if (entry != NULL)
+        {
+          memcpy(buffer, entry->bc_buffer, sectsize);
+          buffer += sectsize;
+          start++;
+          remaining--;
+          continue;
+        }
+
+      /* Find the length of the run of sectors not in the cache */
+
+      nmiss = 1;
+      while (nmiss < remaining &&
+             blkcache_find(inode, start + nmiss) == NULL)
+        {
+          nmiss++;
+        }
+
+      /* Long runs are read directly into the caller's buffer so that a
+       * large sequential transfer does not flush the whole cache.
+       */
+
+      if (direct || nmiss >= CONFIG_FS_BLKCACHE_READAHEAD)
+        {
+          ret = blkcache_hwread(inode, buffer, start, nmiss);
+        }
+      else
+        {
+          ret = blkcache_fill(inode, buffer, start, nmiss, sectsize);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer    += nmiss * sectsize;
+      start     += nmiss;
+      remaining -= nmiss;
+    }
+
+out_with_semaphore:
+  blkcache_semgive();
+  return ret < 0 ? ret : (ssize_t)nsectors;
+}
+
+/****************************************************************************
+ * Name: blkcache_xwrite
+ *
+ * Description:
+ *   Common logic of blkcache_write() and blkcache_directwrite().  If
+ *   'direct' is true, the sectors are always written through.
+ *
+ ****************************************************************************/
+
+static ssize_t blkcache_xwrite(FAR struct inode *inode,
+                               FAR const uint8_t *buffer, blkcnt_t start,
+                               unsigned int nsectors, uint16_t sectsize,
+                               bool direct)
+{
+  FAR struct blkcache_entry_s *entry;
+  unsigned int i;
+  int ret = OK;
+
+  DEBUGASSERT(inode != NULL && buffer != NULL);
+
+  if (!blkcache_semtake() || sectsize > CONFIG_FS_BLKCACHE_BLOCKSIZE)
+    {
+      ret = blkcache_hwwrite(inode, buffer, start, nsectors);
+      goto out_with_semaphore;
+    }
+
+  if (direct || nsectors >= CONFIG_FS_BLKCACHE_READAHEAD)
+    {
+      /* Write through.  The cached copies are then clean. */
+
+      ret = blkcache_hwwrite(inode, buffer, start, nsectors);
+      if (ret < 0)
+        {
+          goto out_with_semaphore;
+        }
+
+      for (i = 0; i < nsectors; i++, buffer += sectsize)
+        {
+          entry = blkcache_find(inode, start + i);
+          if (entry != NULL)
+            {
+              memcpy(entry->bc_buffer, buffer, sectsize);
+              entry->bc_flags &= ~BLKCACHE_DIRTY;
+            }
+        }
+    }
+  else
+    {
+      /* Write back.  Just update the cache and mark the sectors dirty. */
+
+      for (i = 0; i < nsectors; i++, buffer += sectsize)
+        {
+          entry = blkcache_find(inode, start + i);
+          if (entry == NULL)
+            {
+              entry = blkcache_alloc(inode, start + i, &ret);
+              if (entry == NULL)
+                {
+                  goto out_with_semaphore;
+                }
+            }
+
+          memcpy(entry->bc_buffer, buffer, sectsize);
+          entry->bc_flags |= BLKCACHE_DIRTY;
+        }
+    }
+
+out_with_semaphore:
+  blkcache_semgive();
+  return ret < 0 ? ret : (ssize_t)nsectors;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read 'nsectors' sectors beginning at 'start' from the block driver,
+ *   using cached sectors where available.  Misses shorter than
+ *   CONFIG_FS_BLKCACHE_READAHEAD sectors are filled with a read of
+ *   CONFIG_FS_BLKCACHE_READAHEAD sectors; longer misses bypass the cache.
+ *
+ * Input Parameters:
+ *   inode    - The block driver inode
+ *   buffer   - Location to return the data
+ *   start    - The first sector to read
+ *   nsectors - The number of sectors to read
+ *   sectsize - The size of one sector in bytes
+ *
+ * Returned Value:
+ *   The number of sectors read on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct inode *inode, FAR uint8_t *buffer,
+                      blkcnt_t start, unsigned int nsectors,
+                      uint16_t sectsize)
+{
+  return blkcache_xread(inode, buffer, start, nsectors, sectsize, false);
+}
+
+/****************************************************************************
+ * Name: blkcache_directread
+ *
+ * Description:
+ *   Like blkcache_read(), but sectors that are not cached are read
+ *   directly into the caller's buffer and are not added to the cache.
+ *   Cached sectors are still used since they may be newer than the media.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_directread(FAR struct inode *inode, FAR uint8_t *buffer,
+                            blkcnt_t start, unsigned int nsectors,
+                            uint16_t sectsize)
+{
+  return blkcache_xread(inode, buffer, start, nsectors, sectsize, true);
+}
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write 'nsectors' sectors beginning at 'start'.  Short writes are held
+ *   in the cache; writes of CONFIG_FS_BLKCACHE_READAHEAD sectors or more go
+ *   directly to the block driver (and update any cached copies).
+ *
+ * Returned Value:
+ *   The number of sectors written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct inode *inode, FAR const uint8_t *buffer,
+                       blkcnt_t start, unsigned int nsectors,
+                       uint16_t sectsize)
+{
+  return blkcache_xwrite(inode, buffer, start, nsectors, sectsize, false);
+}
+
+/****************************************************************************
+ * Name: blkcache_directwrite
+ *
+ * Description:
+ *   Like blkcache_write(), but the sectors are always written directly to
+ *   the block driver.  Cached copies of the sectors are updated.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_directwrite(FAR struct inode *inode,
+                             FAR const uint8_t *buffer, blkcnt_t start,
+                             unsigned int nsectors, uint16_t sectsize)
+{
+  return blkcache_xwrite(inode, buffer, start, nsectors, sectsize, true);
+}
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write all dirty cached sectors of the block driver to the media.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct inode *inode)
+{
+  FAR struct blkcache_entry_s *entry;
+  int result = OK;
+  int ret;
+  int i;
+
+  (void)blkcache_semtake();
+
+  if (g_blkcache.pool != NULL)
+    {
+      for (i = 0; i < CONFIG_FS_BLKCACHE_NBLOCKS; i++)
+        {
+          entry = &g_blkcache.entry[i];
+          if ((entry->bc_flags & (BLKCACHE_VALID | BLKCACHE_DIRTY)) ==
+              (BLKCACHE_VALID | BLKCACHE_DIRTY) && entry->bc_inode == inode)
+            {
+              ret = blkcache_hwwrite(inode, entry->bc_buffer,
+                                     entry->bc_sector, 1);
+              if (ret < 0)
+                {
+                  /* Keep the sector dirty but try the others */
+
+                  result = ret;
+                  continue;
+                }
+
+              entry->bc_flags &= ~BLKCACHE_DIRTY;
+            }
+        }
+    }
+
+  blkcache_semgive();
+  return result;
+}
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Discard all cached sectors of the block driver, dirty or not.  Call
+ *   blkcache_flush() first if the dirty sectors should be kept.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct inode *inode)
+{
+  int i;
+
+  (void)blkcache_semtake();
+
+  for (i = 0; i < CONFIG_FS_BLKCACHE_NBLOCKS; i++)
+    {
+      if (g_blkcache.entry[i].bc_inode == inode)
+        {
+          g_blkcache.entry[i].bc_flags = 0;
+          g_blkcache.entry[i].bc_inode = NULL;
+        }
+    }
+
+  blkcache_semgive();
+}
+
+#endif /* CONFIG_FS_BLKCACHE */
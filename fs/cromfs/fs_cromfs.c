@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <semaphore.h>
 #include <fcntl.h>
 #include <lzf.h>
 #include <assert.h>
@@ -53,6 +54,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -62,20 +64,78 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_CROMFS_NCACHED
+#  define CONFIG_FS_CROMFS_NCACHED 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+/* This is one entry in the block index of an open file */
+
+struct cromfs_blkndx_s
+{
+  uint32_t bn_fpos;                         /* File offset of block data */
+  uint32_t bn_hdr;                          /* Volume offset of the header */
+};
+#endif
+
 /* This structure represents an open, regular file */
 
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+#if CONFIG_FS_CROMFS_NCACHED == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+  FAR struct cromfs_blkndx_s *ff_index;     /* Index of all file blocks */
+  uint32_t ff_nblocks;                      /* Entries in ff_index */
+  uint16_t ff_ubsize;                       /* Uncompressed size shared by all
+                                             * blocks (zero if they differ) */
+#else
+  uint32_t ff_curhdr;                       /* Volume offset of the header of
+                                             * the last block found */
+  uint32_t ff_curpos;                       /* File offset of that block */
+#endif
 };
 
+/* This describes one block of file data found by cromfs_findblock() */
+
+struct cromfs_blkinfo_s
+{
+  FAR const struct lzf_header_s *bi_hdr;    /* The block header */
+  uint32_t bi_fpos;                         /* File offset of block data */
+  uint16_t bi_ulen;                         /* Length of uncompressed data */
+  uint16_t bi_clen;                         /* Length of compressed data */
+};
+
+#if CONFIG_FS_CROMFS_NCACHED > 0
+/* This is the cache of decompressed blocks shared by all open files */
+
+struct cromfs_cache_s
+{
+  sem_t cc_sem;                             /* Protects the cache */
+  uint16_t cc_nbound;                       /* Number of mounts using it */
+  uint32_t cc_stamp;                        /* Last LRU time stamp */
+  FAR uint8_t *cc_buffer;                   /* Decompressed block data */
+  uint32_t cc_offset[CONFIG_FS_CROMFS_NCACHED];  /* Volume offset of the
+                                                  * compressed data (zero
+                                                  * means none) */
+  uint32_t cc_used[CONFIG_FS_CROMFS_NCACHED];    /* LRU time stamp */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -115,6 +175,25 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static uint32_t cromfs_blksize(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen);
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+static int      cromfs_mkindex(FAR const struct cromfs_volume_s *fs,
+                               FAR struct cromfs_file_s *ff);
+#endif
+static void     cromfs_findblock(FAR const struct cromfs_volume_s *fs,
+                                 FAR struct cromfs_file_s *ff, uint32_t fpos,
+                                 FAR struct cromfs_blkinfo_s *blk);
+static bool     cromfs_iscached(FAR struct cromfs_file_s *ff,
+                                uint32_t voloffs);
+static FAR const uint8_t *
+                cromfs_getblock(FAR const struct cromfs_volume_s *fs,
+                                FAR struct cromfs_file_s *ff,
+                                FAR const struct cromfs_blkinfo_s *blk);
+static void     cromfs_freefile(FAR struct cromfs_file_s *ff);
+static FAR struct cromfs_file_s *
+                cromfs_allocfile(FAR const struct cromfs_volume_s *fs,
+                                 FAR const struct cromfs_node_s *node);
 
 /* Common file system methods */
 
@@ -194,6 +273,17 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_NCACHED > 0
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  SEM_INITIALIZER(1)
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -478,6 +568,419 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_blksize
+ *
+ * Description:
+ *   Get the lengths of the uncompressed and of the compressed data in one
+ *   block and return the total size of the block, including its header.
+ *   For an uncompressed block, both lengths are the same.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_blksize(FAR const struct lzf_header_s *hdr,
+                               FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_mkindex
+ *
+ * Description:
+ *   Walk the block headers of an opened file once and build the index of
+ *   all of its blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+static int cromfs_mkindex(FAR const struct cromfs_volume_s *fs,
+                          FAR struct cromfs_file_s *ff)
+{
+  FAR const struct lzf_header_s *hdr;
+  FAR const uint8_t *first;
+  uint32_t fsize;
+  uint32_t fpos;
+  uint32_t nblocks;
+  uint32_t i;
+  uint16_t ulen;
+  uint16_t clen;
+
+  fsize = ff->ff_node->cn_size;
+  first = (FAR const uint8_t *)cromfs_offset2addr(fs,
+                                                  ff->ff_node->u.cn_blocks);
+
+  /* Count the blocks */
+
+  hdr     = (FAR const struct lzf_header_s *)first;
+  nblocks = 0;
+
+  for (fpos = 0; fpos < fsize; fpos += ulen)
+    {
+      hdr = (FAR const struct lzf_header_s *)
+            ((FAR const uint8_t *)hdr + cromfs_blksize(hdr, &ulen, &clen));
+      nblocks++;
+    }
+
+  ff->ff_nblocks = nblocks;
+  ff->ff_ubsize  = 0;
+
+  if (nblocks == 0)
+    {
+      return OK;
+    }
+
+  ff->ff_index = (FAR struct cromfs_blkndx_s *)
+    kmm_malloc(nblocks * sizeof(struct cromfs_blkndx_s));
+  if (ff->ff_index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Then fill in the index.  Note if all blocks but the last have the same
+   * size so that the block can be found by a simple division.
+   */
+
+  hdr  = (FAR const struct lzf_header_s *)first;
+  fpos = 0;
+
+  for (i = 0; i < nblocks; i++)
+    {
+      uint32_t blksize = cromfs_blksize(hdr, &ulen, &clen);
+
+      ff->ff_index[i].bn_fpos = fpos;
+      ff->ff_index[i].bn_hdr  = cromfs_addr2offset(fs, hdr);
+
+      if (i == 0)
+        {
+          ff->ff_ubsize = ulen;
+        }
+      else if (ulen != ff->ff_ubsize && (i + 1 < nblocks ||
+                                         ulen > ff->ff_ubsize))
+        {
+          ff->ff_ubsize = 0;
+        }
+
+      fpos += ulen;
+      hdr   = (FAR const struct lzf_header_s *)
+              ((FAR const uint8_t *)hdr + blksize);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_findblock
+ *
+ * Description:
+ *   Find the block of an opened file that holds the data at file offset
+ *   'fpos'.  'fpos' must lie within the file.
+ *
+ ****************************************************************************/
+
+static void cromfs_findblock(FAR const struct cromfs_volume_s *fs,
+                             FAR struct cromfs_file_s *ff, uint32_t fpos,
+                             FAR struct cromfs_blkinfo_s *blk)
+{
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+  uint32_t ndx;
+
+  DEBUGASSERT(fpos < ff->ff_node->cn_size && ff->ff_nblocks > 0);
+
+  if (ff->ff_ubsize != 0)
+    {
+      /* All blocks have the same size (except perhaps the last) */
+
+      ndx = fpos / ff->ff_ubsize;
+    }
+  else
+    {
+      uint32_t low  = 0;
+      uint32_t high = ff->ff_nblocks - 1;
+
+      /* Binary search for the last block starting at or before fpos */
+
+      while (low < high)
+        {
+          uint32_t mid = (low + high + 1) >> 1;
+
+          if (ff->ff_index[mid].bn_fpos <= fpos)
+            {
+              low = mid;
+            }
+          else
+            {
+              high = mid - 1;
+            }
+        }
+
+      ndx = low;
+    }
+
+  DEBUGASSERT(ndx < ff->ff_nblocks);
+
+  blk->bi_hdr  = (FAR const struct lzf_header_s *)
+                 cromfs_offset2addr(fs, ff->ff_index[ndx].bn_hdr);
+  blk->bi_fpos = ff->ff_index[ndx].bn_fpos;
+  (void)cromfs_blksize(blk->bi_hdr, &blk->bi_ulen, &blk->bi_clen);
+
+#else
+  FAR const struct lzf_header_s *hdr;
+  uint32_t blkpos;
+  uint32_t blksize;
+  uint16_t ulen;
+  uint16_t clen;
+
+  DEBUGASSERT(fpos < ff->ff_node->cn_size);
+
+  /* Blocks are normally read in order, so resume the search at the block
+   * found last time.  Otherwise, start over with the first block.
+   */
+
+  if (ff->ff_curhdr != 0 && fpos >= ff->ff_curpos)
+    {
+      hdr    = (FAR const struct lzf_header_s *)
+               cromfs_offset2addr(fs, ff->ff_curhdr);
+      blkpos = ff->ff_curpos;
+    }
+  else
+    {
+      hdr    = (FAR const struct lzf_header_s *)
+               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+      blkpos = 0;
+    }
+
+  for (; ; )
+    {
+      blksize = cromfs_blksize(hdr, &ulen, &clen);
+      if (fpos < blkpos + ulen)
+        {
+          break;
+        }
+
+      blkpos += ulen;
+      hdr     = (FAR const struct lzf_header_s *)
+                ((FAR const uint8_t *)hdr + blksize);
+    }
+
+  ff->ff_curhdr = cromfs_addr2offset(fs, hdr);
+  ff->ff_curpos = blkpos;
+
+  blk->bi_hdr   = hdr;
+  blk->bi_fpos  = blkpos;
+  blk->bi_ulen  = ulen;
+  blk->bi_clen  = clen;
+#endif
+}
+
+/****************************************************************************
+ * Name: cromfs_iscached
+ *
+ * Description:
+ *   Return true if the decompressed data of the compressed block at volume
+ *   offset 'voloffs' is already cached.
+ *
+ ****************************************************************************/
+
+static bool cromfs_iscached(FAR struct cromfs_file_s *ff, uint32_t voloffs)
+{
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_NCACHED; i++)
+    {
+      if (g_cromfs_cache.cc_offset[i] == voloffs)
+        {
+          return true;
+        }
+    }
+
+  return false;
+#else
+  return ff->ff_offset == voloffs;
+#endif
+}
+
+/****************************************************************************
+ * Name: cromfs_getblock
+ *
+ * Description:
+ *   Return the decompressed data of the compressed block 'blk',
+ *   decompressing it into the cache if it is not already cached.  NULL is
+ *   returned if the compressed data is corrupted.  The caller must hold the
+ *   shared cache semaphore, if there is a shared cache.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *
+cromfs_getblock(FAR const struct cromfs_volume_s *fs,
+                FAR struct cromfs_file_s *ff,
+                FAR const struct cromfs_blkinfo_s *blk)
+{
+  FAR const uint8_t *src;
+  FAR uint8_t *buffer;
+  unsigned int decomplen;
+  uint32_t voloffs;
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  uint32_t oldest;
+  int victim;
+  int i;
+#endif
+
+  src     = (FAR const uint8_t *)blk->bi_hdr + LZF_TYPE1_HDR_SIZE;
+  voloffs = cromfs_addr2offset(fs, src);
+
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  /* Look for the block in the cache, remembering the least recently used
+   * entry as we go.
+   */
+
+  victim = 0;
+  oldest = UINT32_MAX;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_NCACHED; i++)
+    {
+      if (g_cromfs_cache.cc_offset[i] == voloffs)
+        {
+          g_cromfs_cache.cc_used[i] = ++g_cromfs_cache.cc_stamp;
+          return &g_cromfs_cache.cc_buffer[i * fs->cv_bsize];
+        }
+
+      if (g_cromfs_cache.cc_used[i] < oldest)
+        {
+          oldest = g_cromfs_cache.cc_used[i];
+          victim = i;
+        }
+    }
+
+  /* Not cached.  Replace the least recently used entry. */
+
+  buffer = &g_cromfs_cache.cc_buffer[victim * fs->cv_bsize];
+  g_cromfs_cache.cc_offset[victim] = 0;
+
+  decomplen = lzf_decompress(src, blk->bi_clen, buffer, fs->cv_bsize);
+  if (decomplen != blk->bi_ulen)
+    {
+      return NULL;
+    }
+
+  g_cromfs_cache.cc_offset[victim] = voloffs;
+  g_cromfs_cache.cc_used[victim]   = ++g_cromfs_cache.cc_stamp;
+#else
+  buffer = ff->ff_buffer;
+
+  if (ff->ff_offset != voloffs)
+    {
+      ff->ff_offset = 0;
+
+      decomplen = lzf_decompress(src, blk->bi_clen, buffer, fs->cv_bsize);
+      if (decomplen != blk->bi_ulen)
+        {
+          return NULL;
+        }
+
+      ff->ff_offset = voloffs;
+      ff->ff_ulen   = decomplen;
+    }
+#endif
+
+  return buffer;
+}
+
+/****************************************************************************
+ * Name: cromfs_freefile
+ *
+ * Description:
+ *   Free an open file instance.
+ *
+ ****************************************************************************/
+
+static void cromfs_freefile(FAR struct cromfs_file_s *ff)
+{
+#if CONFIG_FS_CROMFS_NCACHED == 0
+  if (ff->ff_buffer != NULL)
+    {
+      kmm_free(ff->ff_buffer);
+    }
+#endif
+
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+  if (ff->ff_index != NULL)
+    {
+      kmm_free(ff->ff_index);
+    }
+#endif
+
+  kmm_free(ff);
+}
+
+/****************************************************************************
+ * Name: cromfs_allocfile
+ *
+ * Description:
+ *   Allocate and initialize an open file instance for 'node'.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_file_s *
+cromfs_allocfile(FAR const struct cromfs_volume_s *fs,
+                 FAR const struct cromfs_node_s *node)
+{
+  FAR struct cromfs_file_s *ff;
+
+  ff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
+  if (ff == NULL)
+    {
+      return NULL;
+    }
+
+  ff->ff_node = node;
+
+#if CONFIG_FS_CROMFS_NCACHED == 0
+  /* Create a file buffer to support partial sector accesses */
+
+  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+  if (ff->ff_buffer == NULL)
+    {
+      cromfs_freefile(ff);
+      return NULL;
+    }
+#endif
+
+#ifdef CONFIG_FS_CROMFS_BLKINDEX
+  /* Build the block index */
+
+  if (cromfs_mkindex(fs, ff) < 0)
+    {
+      cromfs_freefile(ff);
+      return NULL;
+    }
+#endif
+
+  return ff;
+}
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -540,25 +1043,12 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
-  ff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
+  ff = cromfs_allocfile(fs, node);
   if (ff == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      kmm_free(ff);
-      return -ENOMEM;
-    }
-
-  /* Save the node in the open file instance */
-
-  ff->ff_node = node;
-
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -579,12 +1069,11 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
-  kmm_free(ff);
+  cromfs_freefile(ff);
 
   return OK;
 }
@@ -599,17 +1088,14 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  struct cromfs_blkinfo_s blk;
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
   size_t remaining;
-  uint32_t blkoffs;
-  uint16_t ulen;
-  uint16_t clen;
   unsigned int copysize;
   unsigned int copyoffs;
+  ssize_t ret;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -625,7 +1111,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -646,164 +1132,82 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  /* Get exclusive access to the shared cache of decompressed blocks */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cache.cc_sem);
+#endif
 
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
-  ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
-
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
+  ret       = buflen;
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks should
-       * be contiguous so that the logic should not loop.
-       *
-       */
-
-      do
-        {
-          uint32_t blksize;
+      /* Find the compressed block containing the current offset, fpos */
 
-          /* Go to the next block */
+      cromfs_findblock(fs, ff, fpos, &blk);
 
-          currhdr  = nexthdr;
-          blkoffs += ulen;
+      copyoffs = fpos - blk.bi_fpos;
+      DEBUGASSERT(blk.bi_ulen > copyoffs);
+      copysize = blk.bi_ulen - copyoffs;
 
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+      if (copysize > remaining)  /* Clip to the size really needed */
+        {
+          copysize = remaining;
         }
-      while (fpos >= (blkoffs + ulen));
 
-      /* Check if we need to decompress the next block into the user buffer. */
-
-      if (currhdr->lzf_type == LZF_TYPE0_HDR)
+      if (blk.bi_hdr->lzf_type == LZF_TYPE0_HDR)
         {
-          /* Just copy the uncompressed data copy data from image to the
-           * user buffer.
+          /* Just copy the uncompressed data from image to the user
+           * buffer.
            */
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
-
-          if (copysize > remaining)  /* Clip to the size really needed */
-            {
-              copysize = remaining;
-            }
-
-          src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
-          memcpy(dest, &src[copyoffs], copysize);
-
-          finfo("blkoffs=%lu ulen=%u copysize=%u\n",
-                (unsigned long)blkoffs, ulen, copysize);
+          src = (FAR const uint8_t *)blk.bi_hdr + LZF_TYPE0_HDR_SIZE;
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
+          src = (FAR const uint8_t *)blk.bi_hdr + LZF_TYPE1_HDR_SIZE;
+
+          /* If the whole block is wanted and it is not already cached, then
+           * we can decompress directly into the user buffer.
            */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          if (copyoffs == 0 && copysize == blk.bi_ulen &&
+              !cromfs_iscached(ff, cromfs_addr2offset(fs, src)))
             {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
-
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (lzf_decompress(src, blk.bi_clen, dest, blk.bi_ulen) !=
+                  blk.bi_ulen)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  ret = -EIO;
+                  break;
                 }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
+              src = NULL;
             }
           else
             {
-              uint32_t voloffs;
+              /* No, we will need to decompress into the cache */
 
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
+              src = cromfs_getblock(fs, ff, &blk);
+              if (src == NULL)
                 {
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  ret = -EIO;
+                  break;
                 }
+            }
+        }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+      finfo("blkoffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+            (unsigned long)blk.bi_fpos, blk.bi_ulen, blk.bi_clen,
+            copyoffs, copysize);
 
-              /* Then copy to user buffer */
+      /* Then copy to user buffer */
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
-            }
+      if (src != NULL)
+        {
+          memcpy(dest, &src[copyoffs], copysize);
         }
 
       /* Adjust pointers counts and offset */
@@ -813,10 +1217,20 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  nxsem_post(&g_cromfs_cache.cc_sem);
+#endif
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Corrupted block at offset %lu\n", (unsigned long)fpos);
+      return ret;
+    }
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
-  return buflen;
+  return ret;
 }
 
 /****************************************************************************
@@ -858,31 +1272,18 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
    */
 
-  newff = (FAR struct cromfs_file_s *)kmm_zalloc(sizeof(struct cromfs_file_s));
+  newff = cromfs_allocfile(fs, oldff->ff_node);
   if (newff == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      kmm_free(newff);
-      return -ENOMEM;
-    }
-
-  /* Save the node in the open file instance */
-
-  newff->ff_node = oldff->ff_node;
-
   /* Copy the index from the old to the new file structure */
 
   newp->f_priv = newff;
@@ -915,7 +1316,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1111,6 +1512,32 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  /* Allocate the shared cache of decompressed blocks when the first mount
+   * is bound.
+   */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cache.cc_sem);
+  if (g_cromfs_cache.cc_nbound == 0)
+    {
+      g_cromfs_cache.cc_buffer = (FAR uint8_t *)
+        kmm_malloc(CONFIG_FS_CROMFS_NCACHED * g_cromfs_image.cv_bsize);
+      if (g_cromfs_cache.cc_buffer == NULL)
+        {
+          nxsem_post(&g_cromfs_cache.cc_sem);
+          return -ENOMEM;
+        }
+
+      memset(g_cromfs_cache.cc_offset, 0,
+             sizeof(g_cromfs_cache.cc_offset));
+      memset(g_cromfs_cache.cc_used, 0, sizeof(g_cromfs_cache.cc_used));
+      g_cromfs_cache.cc_stamp = 0;
+    }
+
+  g_cromfs_cache.cc_nbound++;
+  nxsem_post(&g_cromfs_cache.cc_sem);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1130,6 +1557,22 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CONFIG_FS_CROMFS_NCACHED > 0
+  /* Free the shared cache when the last mount is unbound */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cache.cc_sem);
+  DEBUGASSERT(g_cromfs_cache.cc_nbound > 0);
+
+  if (--g_cromfs_cache.cc_nbound == 0)
+    {
+      kmm_free(g_cromfs_cache.cc_buffer);
+      g_cromfs_cache.cc_buffer = NULL;
+    }
+
+  nxsem_post(&g_cromfs_cache.cc_sem);
+#endif
+
   return OK;
 }
 
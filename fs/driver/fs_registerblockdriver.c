@@ -43,6 +43,8 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/init.h>
+#include <nuttx/boottime.h>
 
 #include "inode/inode.h"
 
@@ -107,6 +109,16 @@ int register_blockdriver(FAR const char *path,
     }
 
   inode_semgive();
+
+#ifdef CONFIG_SCHED_BOOTTIME
+  /* Record the registration of drivers during the OS start-up */
+
+  if (ret >= 0 && OSINIT_OS_INITIALIZING())
+    {
+      boottime_mark(path);
+    }
+#endif
+
   return ret;
 }
 
@@ -62,7 +62,9 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/blkcache.h>
 #include <nuttx/fs/dirent.h>
 
 #include "inode/inode.h"
@@ -119,6 +121,14 @@ static int     fat_stat_root(FAR struct fat_mountpt_s *fs,
 static int     fat_stat(struct inode *mountpt, const char *relpath,
                  FAR struct stat *buf);
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int     fat_runsectors(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff, unsigned int nsectors,
+                 bool extend);
+static void    fat_runadvance(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff, unsigned int nsectors);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -473,6 +483,88 @@ static int fat_close(FAR struct file *filep)
   return ret;
 }
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+/****************************************************************************
+ * Name: fat_runsectors
+ *
+ * Description:
+ *   Return the number of sectors, up to 'nsectors', that can be transferred
+ *   starting at ff_currentsector with a single multi-sector request.  That
+ *   is the rest of the current cluster plus any following clusters of the
+ *   file that are physically contiguous with it.  If 'extend' is true, the
+ *   cluster chain is extended as needed (for writes past the end of the
+ *   file).
+ *
+ * Returned Value:
+ *   <0: error, >0: the number of sectors in the run
+ *
+ ****************************************************************************/
+
+static int fat_runsectors(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff, unsigned int nsectors,
+                          bool extend)
+{
+  unsigned int maxclusters;
+  unsigned int runsectors;
+  int32_t ncontig;
+
+  runsectors = ff->ff_sectorsincluster;
+  if (nsectors > runsectors)
+    {
+      /* The request extends past the end of this cluster.  Check how many
+       * of the clusters that follow are contiguous with it.
+       */
+
+      maxclusters = (nsectors - runsectors + fs->fs_fatsecperclus - 1) /
+                    fs->fs_fatsecperclus;
+
+      ncontig = fat_clusterrun(fs, ff->ff_currentcluster, maxclusters,
+                               extend);
+      if (ncontig < 0)
+        {
+          return ncontig;
+        }
+
+      runsectors += ncontig * fs->fs_fatsecperclus;
+    }
+
+  return nsectors < runsectors ? nsectors : runsectors;
+}
+
+/****************************************************************************
+ * Name: fat_runadvance
+ *
+ * Description:
+ *   Advance the file's current sector and cluster past a run of 'nsectors'
+ *   sectors returned by fat_runsectors().
+ *
+ ****************************************************************************/
+
+static void fat_runadvance(FAR struct fat_mountpt_s *fs,
+                           FAR struct fat_file_s *ff, unsigned int nsectors)
+{
+  unsigned int extra;
+  unsigned int nclusters;
+
+  if (nsectors > ff->ff_sectorsincluster)
+    {
+      /* The run continued into 'nclusters' following clusters */
+
+      extra                   = nsectors - ff->ff_sectorsincluster;
+      nclusters               = (extra + fs->fs_fatsecperclus - 1) /
+                                fs->fs_fatsecperclus;
+      ff->ff_currentcluster  += nclusters;
+      ff->ff_sectorsincluster = nclusters * fs->fs_fatsecperclus - extra;
+    }
+  else
+    {
+      ff->ff_sectorsincluster -= nsectors;
+    }
+
+  ff->ff_currentsector += nsectors;
+}
+#endif /* CONFIG_FAT_FORCE_INDIRECT */
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -612,24 +704,40 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the remaining sectors in this cluster
+           * plus those of any physically contiguous clusters that follow.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_runsectors(fs, ff, nsectors, false);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_semaphore;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
            */
 
           (void)fat_ffcacheinvalidate(fs, ff);
 
-          /* Read all of the sectors directly into user memory */
+          /* Read all of the sectors directly into user memory.  Data read
+           * from files opened with O_DIRECT is not added to the block
+           * cache.
+           */
+
+          if ((ff->ff_oflags & O_DIRECT) != 0)
+            {
+              ret = fat_hwdirectread(fs, userbuffer, ff->ff_currentsector,
+                                     nsectors);
+            }
+          else
+            {
+              ret = fat_hwread(fs, userbuffer, ff->ff_currentsector,
+                               nsectors);
+            }
 
-          ret = fat_hwread(fs, userbuffer, ff->ff_currentsector, nsectors);
           if (ret < 0)
             {
 #ifdef CONFIG_FAT_DIRECT_RETRY
@@ -652,9 +760,8 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_runadvance(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -871,15 +978,20 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the remaining sectors in this cluster
+           * plus those of any physically contiguous clusters that follow,
+           * allocating new clusters if we are writing past the end of the
+           * chain.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_runsectors(fs, ff, nsectors, true);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_semaphore;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
            * and invalidate the current cache content.
@@ -887,9 +999,22 @@ fat_write_restart:
 
           (void)fat_ffcacheinvalidate(fs, ff);
 
-          /* Write all of the sectors directly from user memory */
+          /* Write all of the sectors directly from user memory.  Writes
+           * to files opened with O_DIRECT are never deferred in the block
+           * cache.
+           */
+
+          if ((ff->ff_oflags & O_DIRECT) != 0)
+            {
+              ret = fat_hwdirectwrite(fs, userbuffer, ff->ff_currentsector,
+                                      nsectors);
+            }
+          else
+            {
+              ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector,
+                                nsectors);
+            }
 
-          ret = fat_hwwrite(fs, userbuffer, ff->ff_currentsector, nsectors);
           if (ret < 0)
             {
 #ifdef CONFIG_FAT_DIRECT_RETRY
@@ -912,10 +1037,9 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_runadvance(fs, ff, nsectors);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1306,6 +1430,20 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  /* Return the location of the directory entry as the file identity */
+
+  if (cmd == FIOC_FILEID)
+    {
+      FAR uintptr_t *fileid = (FAR uintptr_t *)((uintptr_t)arg);
+
+      DEBUGASSERT(fileid != NULL);
+      *fileid = (uintptr_t)ff->ff_dirsector * DIRSEC_NDIRS(fs) +
+                ff->ff_dirindex;
+
+      fat_semgive(fs);
+      return OK;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   fat_semgive(fs);
@@ -1410,6 +1548,24 @@ static int fat_sync(FAR struct file *filep)
 
       fs->fs_dirty = true;
       ret          = fat_updatefsinfo(fs);
+
+#ifdef CONFIG_FAT_BLKCACHE
+      /* Then write everything held in the shared block cache */
+
+      if (ret >= 0)
+        {
+          ret = blkcache_flush(fs->fs_blkdriver);
+        }
+#endif
+
+      /* Finally, make sure that the block driver does not hold any of the
+       * data in a write buffer of its own.
+       */
+
+      if (ret >= 0)
+        {
+          ret = fat_hwflush(fs);
+        }
     }
 
 errout_with_semaphore:
@@ -2170,6 +2326,12 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#if CONFIG_FAT_FATCACHE > 0
+  /* Write back any FAT sectors still held in the FAT table cache */
+
+  (void)fat_fatflush(fs);
+#endif
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2177,6 +2339,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       FAR struct inode *inode = fs->fs_blkdriver;
       if (inode)
         {
+#ifdef CONFIG_FAT_BLKCACHE
+          /* Write back and forget the cached sectors of the volume */
+
+          (void)blkcache_flush(inode);
+          blkcache_invalidate(inode);
+#endif
+
           if (inode->u.i_bops && inode->u.i_bops->close)
             {
               (void)inode->u.i_bops->close(inode);
@@ -2202,6 +2371,18 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_FATCACHE > 0
+  fat_fatcachefree(fs);
+#endif
+
+#ifdef CONFIG_FAT_FREEBITMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
+  fat_dircachefree(fs);
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
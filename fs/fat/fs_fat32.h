@@ -863,6 +863,56 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/****************************************************************************
+ * FAT table access
+ *
+ * Description:
+ *   If CONFIG_FAT_FATCACHE is non-zero, then FAT table sectors are held in
+ *   a separate, multi-sector cache.  Otherwise, they share fs_buffer with
+ *   directory accesses.  fat_fatread() makes a FAT sector current,
+ *   FAT_FATBUFFER() then returns the buffer that holds it and
+ *   FAT_FATDIRTY() marks that buffer as modified.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FATCACHE
+#  define CONFIG_FAT_FATCACHE 0
+#endif
+
+#if CONFIG_FAT_FATCACHE > 0
+#  define FAT_FATBUFFER(fs)  ((fs)->fs_fatcur->fc_buffer)
+#  define FAT_FATDIRTY(fs)   ((fs)->fs_fatcur->fc_dirty = true)
+#else
+#  define fat_fatread(fs,s)  fat_fscacheread(fs,s)
+#  define fat_fatflush(fs)   (OK)
+#  define FAT_FATBUFFER(fs)  ((fs)->fs_buffer)
+#  define FAT_FATDIRTY(fs)   ((fs)->fs_dirty = true)
+#endif
+
+/****************************************************************************
+ * Directory look-up cache
+ *
+ * Description:
+ *   If CONFIG_FAT_DIRCACHE is non-zero, then the results of
+ *   fat_finddirentry() (including look-ups that fail with -ENOENT) are held
+ *   in a hashed cache of that many entries, allocated when first needed.
+ *   Allocating or freeing any directory entry invalidates the whole cache.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_DIRCACHE
+#  define CONFIG_FAT_DIRCACHE 0
+#endif
+
+#ifndef CONFIG_FAT_DIRCACHE_PATHLEN
+#  define CONFIG_FAT_DIRCACHE_PATHLEN 48
+#endif
+
+#if CONFIG_FAT_DIRCACHE == 0
+#  define fat_dircacheinvalidate(fs)
+#  define fat_dircachefree(fs)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -872,6 +922,18 @@
  * mounted with a fat32 filesystem.
  */
 
+#if CONFIG_FAT_FATCACHE > 0
+/* This structure describes one sector in the FAT table cache */
+
+struct fat_fatcache_s
+{
+  off_t    fc_sector;              /* FAT sector in fc_buffer (-1: none) */
+  uint32_t fc_lastuse;             /* Used to select the LRU entry */
+  bool     fc_dirty;               /* true: fc_buffer is dirty */
+  uint8_t *fc_buffer;              /* One sector of FAT data */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -901,6 +963,21 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#if CONFIG_FAT_FATCACHE > 0
+  uint32_t fs_fatuse;              /* FAT cache access counter */
+  uint8_t *fs_fatpool;             /* Memory backing the FAT cache buffers */
+  struct fat_fatcache_s *fs_fatcur; /* The most recently used FAT sector */
+  struct fat_fatcache_s fs_fatcache[CONFIG_FAT_FATCACHE];
+#endif
+#ifdef CONFIG_FAT_FREEBITMAP
+  uint32_t *fs_freemap;            /* Free cluster bitmap (1: in use), NULL
+                                    * until first needed */
+#endif
+#if CONFIG_FAT_DIRCACHE > 0
+  uint32_t fs_dirgen;              /* Directory cache generation */
+  struct fat_dircache_s *fs_dircache; /* Directory look-up cache, NULL
+                                    * until first needed */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -912,7 +989,7 @@ struct fat_file_s
 {
   struct fat_file_s *ff_next;      /* Retained in a singly linked list */
   uint8_t  ff_bflags;              /* The file buffer/mount flags */
-  uint8_t  ff_oflags;              /* Flags provided when file was opened */
+  uint16_t ff_oflags;              /* Flags provided when file was opened */
   uint8_t  ff_sectorsincluster;    /* Sectors remaining in cluster */
   uint16_t ff_dirindex;            /* Index into ff_dirsector to directory entry */
   uint32_t ff_currentcluster;      /* Current cluster being accessed */
@@ -990,6 +1067,19 @@ struct fat_dirinfo_s
   struct fs_fatdir_s dir;          /* Used with opendir, readdir, etc. */
 };
 
+#if CONFIG_FAT_DIRCACHE > 0
+/* One cached result of fat_finddirentry() */
+
+struct fat_dircache_s
+{
+  uint32_t dc_gen;                 /* fs_dirgen when cached (0: unused) */
+  uint32_t dc_hash;                /* Hash of the relative path */
+  int      dc_ret;                 /* OK or -ENOENT */
+  struct fat_dirinfo_s dc_dirinfo; /* The directory entry description */
+  char     dc_path[CONFIG_FAT_DIRCACHE_PATHLEN];
+};
+#endif
+
 /* Generic helper macros ****************************************************/
 
 #ifndef MIN
@@ -1044,6 +1134,16 @@ EXTERN int    fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_hwflush(struct fat_mountpt_s *fs);
+#ifdef CONFIG_FAT_BLKCACHE
+EXTERN int    fat_hwdirectread(struct fat_mountpt_s *fs, uint8_t *buffer,
+                               off_t sector, unsigned int nsectors);
+EXTERN int    fat_hwdirectwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                                off_t sector, unsigned int nsectors);
+#else
+#  define fat_hwdirectread(fs,b,s,n)  fat_hwread(fs,b,s,n)
+#  define fat_hwdirectwrite(fs,b,s,n) fat_hwwrite(fs,b,s,n)
+#endif
 
 /* Cluster / cluster chain access helpers */
 
@@ -1053,6 +1153,8 @@ EXTERN int    fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                              off_t startsector);
 EXTERN int    fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster);
 EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
+EXTERN int32_t fat_clusterrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                              uint32_t maxclusters, bool extend);
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
@@ -1061,6 +1163,10 @@ EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
 EXTERN int    fat_nextdirentry(struct fat_mountpt_s *fs, struct fs_fatdir_s *dir);
 EXTERN int    fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
                                const char *path);
+#if CONFIG_FAT_DIRCACHE > 0
+EXTERN void   fat_dircacheinvalidate(struct fat_mountpt_s *fs);
+EXTERN void   fat_dircachefree(struct fat_mountpt_s *fs);
+#endif
 EXTERN int    fat_dirnamewrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo);
 EXTERN int    fat_dirwrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
                            uint8_t attributes, uint32_t fattime);
@@ -1086,6 +1192,15 @@ EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 
+#if CONFIG_FAT_FATCACHE > 0
+/* FAT table cache */
+
+EXTERN int    fat_fatcacheinit(struct fat_mountpt_s *fs);
+EXTERN void   fat_fatcachefree(struct fat_mountpt_s *fs);
+EXTERN int    fat_fatflush(struct fat_mountpt_s *fs);
+EXTERN int    fat_fatread(struct fat_mountpt_s *fs, off_t sector);
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(struct fat_mountpt_s *fs);
@@ -80,6 +80,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -150,6 +151,12 @@ static int fat_putlfname(struct fat_mountpt_s *fs,
 static int fat_putsfdirentry(struct fat_mountpt_s *fs,
                              struct fat_dirinfo_s *dirinfo,
                              uint8_t attributes, uint32_t fattime);
+static int fat_searchdirentry(struct fat_mountpt_s *fs,
+                              struct fat_dirinfo_s *dirinfo,
+                              const char *path);
+#if CONFIG_FAT_DIRCACHE > 0
+static uint32_t fat_dircachehash(const char *path, size_t *len);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -2274,23 +2281,20 @@ static int fat_putsfdirentry(struct fat_mountpt_s *fs,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: fat_finddirentry
+ * Name: fat_searchdirentry
  *
  * Description: Given a path to something that may or may not be in the file
- *   system, return the description of the directory entry of the requested
- *   item.
+ *   system, walk the directory tree on the media and return the
+ *   description of the directory entry of the requested item.
  *
  * NOTE: As a side effect, this function returns with the sector containing
  *   the short file name directory entry in the cache.
  *
  ****************************************************************************/
 
-int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
-                     const char *path)
+static int fat_searchdirentry(struct fat_mountpt_s *fs,
+                              struct fat_dirinfo_s *dirinfo,
+                              const char *path)
 {
   off_t    cluster;
   uint8_t *direntry;
@@ -2448,6 +2452,151 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
     }
 }
 
+#if CONFIG_FAT_DIRCACHE > 0
+/****************************************************************************
+ * Name: fat_dircachehash
+ *
+ * Description:
+ *   Return the FNV-1a hash of the path and its length.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_dircachehash(const char *path, size_t *len)
+{
+  const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = path; *ptr != '\0'; ptr++)
+    {
+      hash ^= (uint8_t)*ptr;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#if CONFIG_FAT_DIRCACHE > 0
+/****************************************************************************
+ * Name: fat_dircacheinvalidate
+ *
+ * Description: Discard all cached directory look-ups.  Called whenever
+ *   directory entries are allocated or freed.
+ *
+ ****************************************************************************/
+
+void fat_dircacheinvalidate(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_dircache != NULL && ++fs->fs_dirgen == 0)
+    {
+      memset(fs->fs_dircache, 0,
+             CONFIG_FAT_DIRCACHE * sizeof(struct fat_dircache_s));
+      fs->fs_dirgen = 1;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dircachefree
+ *
+ * Description: Free the directory look-up cache when the volume is
+ *   unmounted.
+ *
+ ****************************************************************************/
+
+void fat_dircachefree(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_dircache != NULL)
+    {
+      kmm_free(fs->fs_dircache);
+      fs->fs_dircache = NULL;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_finddirentry
+ *
+ * Description: Given a path to something that may or may not be in the file
+ *   system, return the description of the directory entry of the requested
+ *   item.
+ *
+ * NOTE: As a side effect, this function returns with the sector containing
+ *   the short file name directory entry in the cache.
+ *
+ ****************************************************************************/
+
+int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
+                     const char *path)
+{
+#if CONFIG_FAT_DIRCACHE > 0
+  struct fat_dircache_s *entry;
+  uint32_t hash;
+  size_t len;
+  int ret;
+
+  /* The root directory needs no look-up and long paths are not cached */
+
+  hash = fat_dircachehash(path, &len);
+  if (*path == '\0' || len >= CONFIG_FAT_DIRCACHE_PATHLEN)
+    {
+      return fat_searchdirentry(fs, dirinfo, path);
+    }
+
+  /* Allocate the cache the first time that it is needed.  If that fails,
+   * just do without it.
+   */
+
+  if (fs->fs_dircache == NULL)
+    {
+      fs->fs_dircache = (struct fat_dircache_s *)
+        kmm_zalloc(CONFIG_FAT_DIRCACHE * sizeof(struct fat_dircache_s));
+      if (fs->fs_dircache == NULL)
+        {
+          return fat_searchdirentry(fs, dirinfo, path);
+        }
+
+      fs->fs_dirgen = 1;
+    }
+
+  entry = &fs->fs_dircache[hash % CONFIG_FAT_DIRCACHE];
+  if (entry->dc_gen == fs->fs_dirgen && entry->dc_hash == hash &&
+      strcmp(entry->dc_path, path) == 0)
+    {
+      /* Cache hit.  Restore the directory entry description and, as
+       * fat_searchdirentry() would, bring the sector holding the short file
+       * name entry into the sector cache.
+       */
+
+      memcpy(dirinfo, &entry->dc_dirinfo, sizeof(struct fat_dirinfo_s));
+      if (entry->dc_ret < 0)
+        {
+          return entry->dc_ret;
+        }
+
+      return fat_fscacheread(fs, dirinfo->fd_seq.ds_sector);
+    }
+
+  ret = fat_searchdirentry(fs, dirinfo, path);
+  if (ret == OK || ret == -ENOENT)
+    {
+      entry->dc_gen = fs->fs_dirgen;
+      entry->dc_hash = hash;
+      entry->dc_ret = ret;
+      memcpy(&entry->dc_dirinfo, dirinfo, sizeof(struct fat_dirinfo_s));
+      memcpy(entry->dc_path, path, len + 1);
+    }
+
+  return ret;
+#else
+  return fat_searchdirentry(fs, dirinfo, path);
+#endif
+}
+
 /****************************************************************************
  * Name: fat_allocatedirentry
  *
@@ -2465,6 +2614,12 @@ int fat_allocatedirentry(struct fat_mountpt_s *fs,
   int      ret;
   int      i;
 
+  /* Cached directory look-ups (especially those that failed) are no
+   * longer valid once new directory entries are allocated.
+   */
+
+  fat_dircacheinvalidate(fs);
+
   /* Re-initialize directory object */
 
   cluster = dirinfo->dir.fd_startcluster;
@@ -2604,6 +2759,10 @@ int fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq)
   off_t    startsector;
   int      ret;
 
+  /* Cached directory look-ups may refer to the entry being freed */
+
+  fat_dircacheinvalidate(fs);
+
   /* Set it to the cluster containing the "last" LFN entry (that appears
    * first on the media).
    */
@@ -2668,6 +2827,10 @@ int fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq)
   uint8_t *direntry;
   int      ret;
 
+  /* Cached directory look-ups may refer to the entry being freed */
+
+  fat_dircacheinvalidate(fs);
+
   /* Free the single short file name entry.
    *
    * Make sure that the sector containing the directory entry is in the
@@ -60,10 +60,24 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/blkcache.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+/* Free cluster bitmap access.  A set bit means that the cluster is in use */
+
+#  define FAT_MAPWORDS(n)     (((n) + 31) >> 5)
+#  define FAT_MAPSET(m,c)     ((m)[(c) >> 5] |= (uint32_t)1 << ((c) & 31))
+#  define FAT_MAPCLR(m,c)     ((m)[(c) >> 5] &= ~((uint32_t)1 << ((c) & 31)))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -275,6 +289,345 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fatsearch
+ *
+ * Description:
+ *   Search the FAT for a free cluster, starting with the cluster after
+ *   'startcluster' and wrapping around to the beginning of the FAT.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_fatsearch(FAR struct fat_mountpt_s *fs,
+                             uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return (int32_t)newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return (int32_t)startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_scanfat
+ *
+ * Description:
+ *   Examine every entry in the FAT, counting the free clusters and,
+ *   optionally, marking the in-use clusters in a free cluster bitmap.
+ *
+ * Input Parameters:
+ *   fs     - The mountpoint
+ *   map    - The bitmap to fill in (may be NULL).  It must be zeroed.
+ *   pnfree - The location to return the number of free clusters
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int fat_scanfat(FAR struct fat_mountpt_s *fs, FAR uint32_t *map,
+                       FAR uint32_t *pnfree)
+{
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t    next;
+
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
+      /* Examine every cluster in the fat */
+
+      for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+        {
+          next = fat_getcluster(fs, cluster);
+          if (next < 0)
+            {
+              return (int)next;
+            }
+
+          /* If the cluster is unassigned, then increment the count of free
+           * clusters.
+           */
+
+          if (next == 0)
+            {
+              nfreeclusters++;
+            }
+#ifdef CONFIG_FAT_FREEBITMAP
+          else if (map != NULL)
+            {
+              FAT_MAPSET(map, cluster);
+            }
+#endif
+        }
+    }
+  else
+    {
+      off_t        fatsector = fs->fs_fatbase;
+      unsigned int offset    = fs->fs_hwsectorsize;
+      int          ret;
+
+      /* Examine each cluster in the fat */
+
+      for (cluster = 0; cluster < fs->fs_nclusters; cluster++)
+        {
+          /* If we are starting a new sector, then read the new sector */
+
+          if (offset >= fs->fs_hwsectorsize)
+            {
+              ret = fat_fatread(fs, fatsector);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              /* Reset the offset to the next FAT entry.  Increment the
+               * sector number to read next time around.
+               */
+
+              offset = 0;
+              fatsector++;
+            }
+
+          /* FAT16 and FAT32 differ only on the size of each cluster start
+           * sector number in the FAT.
+           */
+
+          if (fs->fs_type == FSTYPE_FAT16)
+            {
+              next    = FAT_GETFAT16(FAT_FATBUFFER(fs), offset);
+              offset += 2;
+            }
+          else
+            {
+              next    = FAT_GETFAT32(FAT_FATBUFFER(fs), offset) & 0x0fffffff;
+              offset += 4;
+            }
+
+          /* The first two FAT entries are reserved and never free */
+
+          if (next == 0 && cluster >= 2)
+            {
+              nfreeclusters++;
+            }
+#ifdef CONFIG_FAT_FREEBITMAP
+          else if (map != NULL)
+            {
+              FAT_MAPSET(map, cluster);
+            }
+#endif
+        }
+    }
+
+  *pnfree = nfreeclusters;
+  return OK;
+}
+
+#ifdef CONFIG_FAT_FREEBITMAP
+/****************************************************************************
+ * Name: fat_buildfreemap
+ *
+ * Description:
+ *   Allocate and fill in the free cluster bitmap from the FAT.  As a side
+ *   effect, the free cluster count is re-synchronized with the FAT.
+ *
+ ****************************************************************************/
+
+static int fat_buildfreemap(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *map;
+  uint32_t nfreeclusters;
+  int ret;
+
+  map = (FAR uint32_t *)
+    kmm_zalloc(FAT_MAPWORDS(fs->fs_nclusters) * sizeof(uint32_t));
+  if (map == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = fat_scanfat(fs, map, &nfreeclusters);
+  if (ret < 0)
+    {
+      kmm_free(map);
+      return ret;
+    }
+
+  /* Clusters 0 and 1 are always considered in-use */
+
+  FAT_MAPSET(map, 0);
+  FAT_MAPSET(map, 1);
+  fs->fs_freemap = map;
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemaprange
+ *
+ * Description:
+ *   Return the first free cluster in the range [first, last) of the free
+ *   cluster bitmap, or zero if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemaprange(FAR const uint32_t *map, uint32_t first,
+                                 uint32_t last)
+{
+  uint32_t cluster = first;
+  uint32_t bits;
+
+  while (cluster < last)
+    {
+      /* Free clusters in this word at or above 'cluster' */
+
+      bits = ~map[cluster >> 5] & ((uint32_t)0xffffffff << (cluster & 31));
+      if (bits != 0)
+        {
+          cluster &= ~31;
+          while ((bits & 1) == 0)
+            {
+              bits >>= 1;
+              cluster++;
+            }
+
+          return cluster < last ? cluster : 0;
+        }
+
+      /* Skip to the first cluster of the next word */
+
+      cluster = (cluster | 31) + 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Same as fat_fatsearch(), but uses the free cluster bitmap.
+ *
+ ****************************************************************************/
+
+static int32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                 uint32_t startcluster)
+{
+  uint32_t newcluster;
+
+  newcluster = fat_freemaprange(fs->fs_freemap, startcluster + 1,
+                                fs->fs_nclusters);
+  if (newcluster == 0)
+    {
+      /* Wrap back to the beginning, but don't continue past the start
+       * cluster.
+       */
+
+      newcluster = fat_freemaprange(fs->fs_freemap, 2, startcluster + 1);
+    }
+
+  return (int32_t)newcluster;
+}
+#endif /* CONFIG_FAT_FREEBITMAP */
+
+#if CONFIG_FAT_FATCACHE > 0
+/****************************************************************************
+ * Name: fat_fatwrite
+ *
+ * Description:
+ *   Write one FAT cache entry back to every copy of the FAT
+ *
+ ****************************************************************************/
+
+static int fat_fatwrite(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_fatcache_s *entry)
+{
+  off_t sector = entry->fc_sector;
+  int ret;
+  int i;
+
+  for (i = 0; i < fs->fs_fatnumfats; i++)
+    {
+      ret = fat_hwwrite(fs, entry->fc_buffer, sector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      sector += fs->fs_nfatsects;
+    }
+
+  entry->fc_dirty = false;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -546,6 +899,12 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
+#ifdef CONFIG_FAT_BLKCACHE
+  /* Discard anything cached from media previously in the device */
+
+  blkcache_invalidate(inode);
+#endif
+
   /* Allocate a buffer to hold one hardware sector */
 
   fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
@@ -555,6 +914,16 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_FATCACHE > 0
+  /* Allocate the FAT table cache */
+
+  ret = fat_fatcacheinit(fs);
+  if (ret < 0)
+    {
+      goto errout_with_buffer;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -682,6 +1051,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#if CONFIG_FAT_FATCACHE > 0
+  fat_fatcachefree(fs);
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -729,6 +1101,15 @@ int fat_checkmount(struct fat_mountpt_s *fs)
       /* If we get here, the mount is NOT healthy */
 
       fs->fs_mounted = false;
+
+#ifdef CONFIG_FAT_BLKCACHE
+      /* Anything still cached belongs to the old media */
+
+      if (fs->fs_blkdriver)
+        {
+          blkcache_invalidate(fs->fs_blkdriver);
+        }
+#endif
     }
 
   return -ENODEV;
@@ -751,8 +1132,14 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
+#ifdef CONFIG_FAT_BLKCACHE
+          ssize_t nSectorsRead = blkcache_read(inode, buffer, sector,
+                                               nsectors,
+                                               fs->fs_hwsectorsize);
+#else
           ssize_t nSectorsRead = inode->u.i_bops->read(inode, buffer,
                                                        sector, nsectors);
+#endif
           if (nSectorsRead == nsectors)
             {
               ret = OK;
@@ -784,8 +1171,14 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
+#ifdef CONFIG_FAT_BLKCACHE
+          ssize_t nSectorsWritten =
+              blkcache_write(inode, buffer, sector, nsectors,
+                             fs->fs_hwsectorsize);
+#else
           ssize_t nSectorsWritten =
               inode->u.i_bops->write(inode, buffer, sector, nsectors);
+#endif
 
           if (nSectorsWritten == nsectors)
             {
@@ -801,6 +1194,102 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwflush
+ *
+ * Description:
+ *   Ask the block driver to write any data that it has buffered (the
+ *   BIOC_FLUSH ioctl).  Drivers that do no buffering do not need to support
+ *   the command.
+ *
+ ****************************************************************************/
+
+int fat_hwflush(struct fat_mountpt_s *fs)
+{
+  struct inode *inode;
+  int ret = OK;
+
+  if (fs && fs->fs_blkdriver)
+    {
+      inode = fs->fs_blkdriver;
+      if (inode->u.i_bops && inode->u.i_bops->ioctl)
+        {
+          ret = inode->u.i_bops->ioctl(inode, BIOC_FLUSH, 0);
+          if (ret == -ENOTTY)
+            {
+              ret = OK;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_hwdirectread and fat_hwdirectwrite
+ *
+ * Description:
+ *   Like fat_hwread() and fat_hwwrite(), but for the direct transfers of
+ *   files opened with O_DIRECT:  The data does not displace other sectors
+ *   in the shared block cache and writes are not deferred.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_BLKCACHE
+int fat_hwdirectread(struct fat_mountpt_s *fs, uint8_t *buffer,
+                     off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->read)
+        {
+          ssize_t nSectorsRead = blkcache_directread(inode, buffer, sector,
+                                                     nsectors,
+                                                     fs->fs_hwsectorsize);
+          if (nSectorsRead == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nSectorsRead < 0)
+            {
+              ret = nSectorsRead;
+            }
+        }
+    }
+
+  return ret;
+}
+
+int fat_hwdirectwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                      off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->write)
+        {
+          ssize_t nSectorsWritten =
+              blkcache_directwrite(inode, buffer, sector, nsectors,
+                                   fs->fs_hwsectorsize);
+
+          if (nSectorsWritten == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nSectorsWritten < 0)
+            {
+              ret = nSectorsWritten;
+            }
+        }
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -858,7 +1347,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
 
               /* Read the sector at this offset */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
@@ -868,7 +1357,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               /* Get the first, LS byte of the cluster from the FAT */
 
               fatindex = fatoffset & SEC_NDXMASK(fs);
-              cluster  = fs->fs_buffer[fatindex];
+              cluster  = FAT_FATBUFFER(fs)[fatindex];
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -880,7 +1369,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                   fatsector++;
                   fatindex = 0;
 
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  if (fat_fatread(fs, fatsector) < 0)
                     {
                       /* Read error */
 
@@ -893,7 +1382,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                * on the fact that the byte stream is little-endian.
                */
 
-              cluster |= (unsigned int)fs->fs_buffer[fatindex] << 8;
+              cluster |= (unsigned int)FAT_FATBUFFER(fs)[fatindex] << 8;
 
               /* Now, pick out the correct 12 bit cluster start sector value */
 
@@ -919,14 +1408,14 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT16(fs->fs_buffer, fatindex);
+              return FAT_GETFAT16(FAT_FATBUFFER(fs), fatindex);
             }
 
           case FSTYPE_FAT32 :
@@ -935,14 +1424,14 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT32(fs->fs_buffer, fatindex) & 0x0fffffff;
+              return FAT_GETFAT32(FAT_FATBUFFER(fs), fatindex) & 0x0fffffff;
             }
 
           default:
@@ -992,7 +1481,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Make sure that the sector at this offset is in the cache */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
@@ -1008,7 +1497,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the LS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0x0f) | nextcluster << 4;
+                  value = (FAT_FATBUFFER(fs)[fatindex] & 0x0f) |
+                          nextcluster << 4;
                 }
               else
                 {
@@ -1017,7 +1507,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                   value = (uint8_t)nextcluster;
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              FAT_FATBUFFER(fs)[fatindex] = value;
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -1035,8 +1525,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                    * just modified is written out.
                    */
 
-                  fs->fs_dirty = true;
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  FAT_FATDIRTY(fs);
+                  if (fat_fatread(fs, fatsector) < 0)
                     {
                       /* Read error */
 
@@ -1058,10 +1548,11 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the MS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0xf0) | ((nextcluster >> 8) & 0x0f);
+                  value = (FAT_FATBUFFER(fs)[fatindex] & 0xf0) |
+                          ((nextcluster >> 8) & 0x0f);
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              FAT_FATBUFFER(fs)[fatindex] = value;
             }
           break;
 
@@ -1071,14 +1562,14 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              FAT_PUTFAT16(fs->fs_buffer, fatindex, nextcluster & 0xffff);
+              FAT_PUTFAT16(FAT_FATBUFFER(fs), fatindex, nextcluster & 0xffff);
             }
           break;
 
@@ -1089,7 +1580,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
               uint32_t     val;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatread(fs, fatsector) < 0)
                 {
                   /* Read error */
 
@@ -1098,18 +1589,36 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Keep the top 4 bits */
 
-              val = FAT_GETFAT32(fs->fs_buffer, fatindex) & 0xf0000000;
-              FAT_PUTFAT32(fs->fs_buffer, fatindex, val | (nextcluster & 0x0fffffff));
+              val = FAT_GETFAT32(FAT_FATBUFFER(fs), fatindex) & 0xf0000000;
+              FAT_PUTFAT32(FAT_FATBUFFER(fs), fatindex,
+                           val | (nextcluster & 0x0fffffff));
+            }
+          break;
+
+          default:
+            return -EINVAL;
+        }
+
+      /* Mark the modified sector as "dirty" */
+
+      FAT_FATDIRTY(fs);
+
+#ifdef CONFIG_FAT_FREEBITMAP
+      /* Keep the free cluster bitmap in sync with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster == 0)
+            {
+              FAT_MAPCLR(fs->fs_freemap, clusterno);
+            }
+          else
+            {
+              FAT_MAPSET(fs->fs_freemap, clusterno);
             }
-          break;
-
-          default:
-            return -EINVAL;
         }
+#endif
 
-      /* Mark the modified sector as "dirty" and return success */
-
-      fs->fs_dirty = true;
       return OK;
     }
 
@@ -1184,6 +1693,7 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   off_t    startsector;
   uint32_t newcluster;
   uint32_t startcluster;
+  int32_t  found;
   int      ret;
 
   /* The special value 0 is used when the new chain should start */
@@ -1233,66 +1743,39 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find the next free cluster following the start cluster */
 
-  newcluster = startcluster;
-  for (; ; )
+#ifdef CONFIG_FAT_FREEBITMAP
+  if (fs->fs_freemap == NULL)
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
+      /* Build the free cluster bitmap now.  If that fails, we just fall
+       * back to searching the FAT.
        */
 
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
+      (void)fat_buildfreemap(fs);
+    }
 
-          return startsector;
-        }
+  if (fs->fs_freemap != NULL)
+    {
+      found = fat_freemapsearch(fs, startcluster);
+    }
+  else
+#endif
+    {
+      found = fat_fatsearch(fs, startcluster);
+    }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+  if (found <= 0)
+    {
+      /* No free cluster (0) or an error occurred (<0) */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return found;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = (uint32_t)found;
+
+  /* We get here only if we found an available cluster number in
+   * 'newcluster'  Now mark that cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -1330,6 +1813,63 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_clusterrun
+ *
+ * Description:
+ *   Count the clusters that follow 'cluster' in its chain and that are also
+ *   physically contiguous with it on the media, so that a run of sectors
+ *   spanning them can be transferred with a single multi-sector request.
+ *
+ * Input Parameters:
+ *   fs          - The mountpoint
+ *   cluster     - The cluster where the run starts
+ *   maxclusters - The maximum number of following clusters to examine
+ *   extend      - If true, the chain is extended (as by fat_extendchain())
+ *                 when its end is reached.
+ *
+ * Returned Value:
+ *   <0: error, otherwise the number of contiguous clusters that follow
+ *   'cluster' (0..maxclusters).
+ *
+ ****************************************************************************/
+
+int32_t fat_clusterrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                       uint32_t maxclusters, bool extend)
+{
+  uint32_t nclusters = 0;
+  off_t    next;
+
+  while (nclusters < maxclusters)
+    {
+      if (extend)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      if (next < 0)
+        {
+          return (int32_t)next;
+        }
+
+      /* Stop at the end of the chain or at the first discontinuity */
+
+      if (next != (off_t)cluster + 1)
+        {
+          break;
+        }
+
+      cluster = (uint32_t)next;
+      nclusters++;
+    }
+
+  return (int32_t)nclusters;
+}
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1863,6 +2403,159 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
   return OK;
 }
 
+#if CONFIG_FAT_FATCACHE > 0
+/****************************************************************************
+ * Name: fat_fatcacheinit
+ *
+ * Description:
+ *   Allocate the FAT table cache buffers.  Called when the volume is
+ *   mounted, after the hardware sector size is known.
+ *
+ ****************************************************************************/
+
+int fat_fatcacheinit(struct fat_mountpt_s *fs)
+{
+  int i;
+
+  fs->fs_fatpool = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_FATCACHE * fs->fs_hwsectorsize);
+  if (fs->fs_fatpool == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_FAT_FATCACHE; i++)
+    {
+      fs->fs_fatcache[i].fc_sector  = (off_t)-1;
+      fs->fs_fatcache[i].fc_lastuse = 0;
+      fs->fs_fatcache[i].fc_dirty   = false;
+      fs->fs_fatcache[i].fc_buffer  = fs->fs_fatpool +
+                                      i * fs->fs_hwsectorsize;
+    }
+
+  fs->fs_fatcur = &fs->fs_fatcache[0];
+  fs->fs_fatuse = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fatcachefree
+ *
+ * Description:
+ *   Free the FAT table cache buffers.  Any dirty sectors are discarded.
+ *
+ ****************************************************************************/
+
+void fat_fatcachefree(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_fatpool != NULL)
+    {
+      fat_io_free(fs->fs_fatpool,
+                  CONFIG_FAT_FATCACHE * fs->fs_hwsectorsize);
+      fs->fs_fatpool = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_fatflush
+ *
+ * Description:
+ *   Write all dirty FAT table cache sectors back to the media
+ *
+ ****************************************************************************/
+
+int fat_fatflush(struct fat_mountpt_s *fs)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FATCACHE; i++)
+    {
+      if (fs->fs_fatcache[i].fc_dirty)
+        {
+          ret = fat_fatwrite(fs, &fs->fs_fatcache[i]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fatread
+ *
+ * Description:
+ *   Make the specified FAT sector the current FAT cache entry, replacing
+ *   the least recently used entry if the sector is not already cached.
+ *
+ ****************************************************************************/
+
+int fat_fatread(struct fat_mountpt_s *fs, off_t sector)
+{
+  FAR struct fat_fatcache_s *entry;
+  FAR struct fat_fatcache_s *victim;
+  int ret;
+  int i;
+
+  /* Most FAT accesses hit the same sector as the previous one */
+
+  entry = fs->fs_fatcur;
+  if (entry->fc_sector != sector)
+    {
+      /* Look for the sector in the cache, remembering the LRU entry */
+
+      victim = NULL;
+      for (i = 0; i < CONFIG_FAT_FATCACHE; i++)
+        {
+          entry = &fs->fs_fatcache[i];
+          if (entry->fc_sector == sector)
+            {
+              break;
+            }
+
+          if (victim == NULL || entry->fc_lastuse < victim->fc_lastuse)
+            {
+              victim = entry;
+            }
+        }
+
+      if (i >= CONFIG_FAT_FATCACHE)
+        {
+          /* Not cached.  Write back the victim if it is dirty, then read
+           * the requested sector into it.
+           */
+
+          entry = victim;
+          if (entry->fc_dirty)
+            {
+              ret = fat_fatwrite(fs, entry);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          ret = fat_hwread(fs, entry->fc_buffer, sector, 1);
+          if (ret < 0)
+            {
+              entry->fc_sector = (off_t)-1;
+              return ret;
+            }
+
+          entry->fc_sector = sector;
+        }
+
+      fs->fs_fatcur = entry;
+    }
+
+  entry->fc_lastuse = ++fs->fs_fatuse;
+  return OK;
+}
+#endif /* CONFIG_FAT_FATCACHE > 0 */
+
 /****************************************************************************
  * Name: fat_ffcacheflush
  *
@@ -1992,9 +2685,14 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 {
   int ret;
 
-  /* Flush the fs_buffer if it is dirty */
+  /* Flush the FAT table cache and the fs_buffer if they are dirty */
+
+  ret = fat_fatflush(fs);
+  if (ret == OK)
+    {
+      ret = fat_fscacheflush(fs);
+    }
 
-  ret = fat_fscacheflush(fs);
   if (ret == OK)
     {
       /* The FSINFO sector only has to be update for the case of a FAT32 file
@@ -2040,6 +2738,7 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 {
   uint32_t nfreeclusters;
+  int ret;
 
   /* If number of the first free cluster is valid, then just return that value. */
 
@@ -2049,90 +2748,32 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       return OK;
     }
 
-  /* Otherwise, we will have to count the number of free clusters */
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* Building the free cluster bitmap also counts the free clusters */
 
-  nfreeclusters = 0;
-  if (fs->fs_type == FSTYPE_FAT12)
+  if (fs->fs_freemap == NULL && fat_buildfreemap(fs) == OK)
     {
-      off_t sector;
-
-      /* Examine every cluster in the fat */
-
-      for (sector = 2; sector < fs->fs_nclusters; sector++)
-        {
-
-          /* If the cluster is unassigned, then increment the count of free clusters */
-
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
-            {
-              nfreeclusters++;
-            }
-        }
+      *pfreeclusters = fs->fs_fsifreecount;
+      return OK;
     }
-  else
-    {
-      unsigned int cluster;
-      off_t        fatsector;
-      unsigned int offset;
-      int          ret;
-
-      fatsector    = fs->fs_fatbase;
-      offset       = fs->fs_hwsectorsize;
-
-      /* Examine each cluster in the fat */
-
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
-        {
-          /* If we are starting a new sector, then read the new sector in fs_buffer */
-
-          if (offset >= fs->fs_hwsectorsize)
-            {
-              ret = fat_fscacheread(fs, fatsector++);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-
-              /* Reset the offset to the next FAT entry.
-               * Increment the sector number to read next time around.
-               */
-
-              offset = 0;
-              fatsector++;
-            }
-
-          /* FAT16 and FAT32 differ only on the size of each cluster start
-           * sector number in the FAT.
-           */
+#endif
 
-          if (fs->fs_type == FSTYPE_FAT16)
-            {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-              offset += 2;
-            }
-          else
-            {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
+  /* Otherwise, we will have to count the number of free clusters */
 
-              offset += 4;
-            }
-        }
+  ret = fat_scanfat(fs, NULL, &nfreeclusters);
+  if (ret < 0)
+    {
+      return ret;
     }
 
-    fs->fs_fsifreecount = nfreeclusters;
-    if (fs->fs_type == FSTYPE_FAT32)
-      {
-        fs->fs_fsidirty = true;
-      }
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
 
-    *pfreeclusters = nfreeclusters;
-    return OK;
+  *pfreeclusters = nfreeclusters;
+  return OK;
 }
 
 /****************************************************************************
@@ -52,6 +52,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
@@ -67,10 +68,31 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+#if CONFIG_FS_HOSTFS_READAHEAD == 0
+#  define hostfs_raflush(fs)
+#endif
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE == 0
+#  define hostfs_attrflush(fs)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+static int     hostfs_hostseek(FAR struct hostfs_ofile_s *hf, off_t pos);
+static ssize_t hostfs_rdbuffered(FAR struct hostfs_ofile_s *hf, off_t pos,
+                        FAR char *buffer, size_t buflen);
+static void    hostfs_raflush(FAR struct hostfs_mountpt_s *fs);
+#endif
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+static FAR struct hostfs_attr_s *hostfs_attrslot(
+                        FAR struct hostfs_mountpt_s *fs,
+                        FAR const char *relpath);
+static void    hostfs_attrflush(FAR struct hostfs_mountpt_s *fs);
+#endif
+
 static int     hostfs_open(FAR struct file *filep, FAR const char *relpath,
                         int oflags, mode_t mode);
 static int     hostfs_close(FAR struct file *filep);
@@ -261,6 +283,198 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+/****************************************************************************
+ * Name: hostfs_hostseek
+ *
+ * Description: Move the host file position to 'pos' unless it is already
+ *   there.
+ *
+ ****************************************************************************/
+
+static int hostfs_hostseek(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->hostpos != pos)
+    {
+      ret = host_lseek(hf->fd, pos, SEEK_SET);
+      if (ret < 0)
+        {
+          hf->hostpos = -1;
+          return (int)ret;
+        }
+
+      hf->hostpos = pos;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_rdbuffered
+ *
+ * Description: Read from the file at 'pos' through the read-ahead buffer.
+ *   The buffer is refilled one aligned block at a time.  Large reads go
+ *   directly to the host.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_rdbuffered(FAR struct hostfs_ofile_s *hf, off_t pos,
+                                 FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret;
+  off_t   blkpos;
+  size_t  n;
+
+  while (buflen > 0)
+    {
+      /* Copy any data that is already in the buffer */
+
+      if (pos >= hf->raoffset && pos < hf->raoffset + hf->ralen)
+        {
+          n = hf->raoffset + hf->ralen - pos;
+          if (n > buflen)
+            {
+              n = buflen;
+            }
+
+          memcpy(buffer, &hf->rabuf[pos - hf->raoffset], n);
+          pos    += n;
+          buffer += n;
+          buflen -= n;
+          nread  += n;
+          continue;
+        }
+
+      if (hf->rabuf == NULL && buflen < CONFIG_FS_HOSTFS_READAHEAD)
+        {
+          hf->rabuf = (FAR uint8_t *)kmm_malloc(CONFIG_FS_HOSTFS_READAHEAD);
+        }
+
+      /* Large reads (or small reads without a buffer) go directly to the
+       * host.
+       */
+
+      if (buflen >= CONFIG_FS_HOSTFS_READAHEAD || hf->rabuf == NULL)
+        {
+          ret = hostfs_hostseek(hf, pos);
+          if (ret >= 0)
+            {
+              ret = host_read(hf->fd, buffer, buflen);
+            }
+
+          if (ret < 0)
+            {
+              hf->hostpos = -1;
+              return nread > 0 ? nread : ret;
+            }
+
+          hf->hostpos = pos + ret;
+          return nread + ret;
+        }
+
+      /* Refill the buffer with the aligned block that contains 'pos' */
+
+      blkpos    = pos - pos % CONFIG_FS_HOSTFS_READAHEAD;
+      hf->ralen = 0;
+
+      ret = hostfs_hostseek(hf, blkpos);
+      if (ret >= 0)
+        {
+          ret = host_read(hf->fd, hf->rabuf, CONFIG_FS_HOSTFS_READAHEAD);
+        }
+
+      if (ret < 0)
+        {
+          hf->hostpos = -1;
+          return nread > 0 ? nread : ret;
+        }
+
+      hf->hostpos  = blkpos + ret;
+      hf->raoffset = blkpos;
+      hf->ralen    = ret;
+
+      /* Check for the end of the file */
+
+      if (pos >= blkpos + ret)
+        {
+          break;
+        }
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: hostfs_raflush
+ *
+ * Description: Discard the read-ahead data of all open files.
+ *
+ ****************************************************************************/
+
+static void hostfs_raflush(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *hf;
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      hf->ralen = 0;
+    }
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/****************************************************************************
+ * Name: hostfs_attrslot
+ *
+ * Description: Return the attribute cache entry for 'relpath' or NULL if
+ *   the path is too long to be cached.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_attr_s *hostfs_attrslot(
+                                         FAR struct hostfs_mountpt_s *fs,
+                                         FAR const char *relpath)
+{
+  FAR const char *ptr;
+  uint32_t hash = 5381;
+
+  if (strlen(relpath) >= HOSTFS_ATTR_PATHLEN)
+    {
+      return NULL;
+    }
+
+  for (ptr = relpath; *ptr != '\0'; ptr++)
+    {
+      hash = ((hash << 5) + hash) + (uint8_t)*ptr;
+    }
+
+  return &fs->fs_attrcache[hash % CONFIG_FS_HOSTFS_ATTRCACHE];
+}
+
+/****************************************************************************
+ * Name: hostfs_attrflush
+ *
+ * Description: Discard all entries of the attribute cache.
+ *
+ ****************************************************************************/
+
+static void hostfs_attrflush(FAR struct hostfs_mountpt_s *fs)
+{
+  /* Entries of older generations are invalid.  Generation zero marks
+   * unused entries, so the entries must really be cleared on a wrap.
+   */
+
+  if (++fs->fs_attrgen == 0)
+    {
+      memset(fs->fs_attrcache, 0, sizeof(fs->fs_attrcache));
+      fs->fs_attrgen = 1;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -316,6 +530,20 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  hf->hostpos  = 0;
+  hf->raoffset = 0;
+  hf->ralen    = 0;
+  hf->rabuf    = NULL;
+#endif
+
+  /* Creating or truncating the file changes its attributes */
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_attrflush(fs);
+    }
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -326,6 +554,9 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       if (ret >= 0)
         {
           filep->f_pos = ret;
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+          hf->hostpos  = ret;
+#endif
         }
       else
         {
@@ -439,6 +670,13 @@ static int hostfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  if (hf->rabuf != NULL)
+    {
+      kmm_free(hf->rabuf);
+    }
+
+#endif
   kmm_free(hf);
 
 okout:
@@ -476,7 +714,11 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  ret = hostfs_rdbuffered(hf, filep->f_pos, buffer, buflen);
+#else
   ret = host_read(hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -536,6 +778,19 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  /* The host file position may differ from the file position */
+
+  if ((hf->oflags & O_APPEND) == 0)
+    {
+      ret = hostfs_hostseek(hf, filep->f_pos);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
@@ -544,6 +799,22 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       filep->f_pos += ret;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  if (ret < 0 || (hf->oflags & O_APPEND) != 0)
+    {
+      hf->hostpos = -1;
+    }
+  else
+    {
+      hf->hostpos = filep->f_pos;
+    }
+#endif
+
+  /* Buffered data and attributes may now be stale */
+
+  hostfs_raflush(fs);
+  hostfs_attrflush(fs);
+
 errout_with_semaphore:
   hostfs_semgive(fs);
   return ret;
@@ -576,9 +847,35 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  /* The file position is kept here.  Only a seek relative to the end of
+   * the file needs the host.
+   */
+
+  switch (whence)
+    {
+      case SEEK_SET:
+        ret = offset >= 0 ? offset : -EINVAL;
+        break;
+
+      case SEEK_CUR:
+        ret = filep->f_pos + offset >= 0 ? filep->f_pos + offset : -EINVAL;
+        break;
+
+      case SEEK_END:
+        ret = host_lseek(hf->fd, offset, whence);
+        hf->hostpos = ret >= 0 ? ret : -1;
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+#else
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, offset, whence);
+#endif
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -768,6 +1065,11 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   ret = host_ftruncate(hf->fd, length);
 
+  /* Buffered data and attributes may now be stale */
+
+  hostfs_raflush(fs);
+  hostfs_attrflush(fs);
+
   hostfs_semgive(fs);
   return ret;
 }
@@ -994,6 +1296,9 @@ static int hostfs_bind(FAR struct inode *blkdriver, FAR const void *data,
    */
 
   fs->fs_head = NULL;
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  fs->fs_attrgen = 1;
+#endif
 
   /* Now perform the mount.  */
 
@@ -1141,6 +1446,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1177,6 +1483,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1214,6 +1521,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1254,6 +1562,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1270,6 +1579,9 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  FAR struct hostfs_attr_s *entry;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1283,6 +1595,21 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  /* Check if the attributes are in the cache (and still fresh) */
+
+  entry = hostfs_attrslot(fs, relpath);
+  if (entry != NULL && entry->gen == fs->fs_attrgen &&
+      strcmp(entry->path, relpath) == 0 &&
+      clock_systimer() - entry->time <
+      MSEC2TICK(CONFIG_FS_HOSTFS_ATTRCACHE_TIMEOUT))
+    {
+      memcpy(buf, &entry->buf, sizeof(struct stat));
+      ret = entry->result;
+      goto okout;
+    }
+#endif
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -1291,6 +1618,21 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_stat(path, buf);
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  /* Save the result in the cache */
+
+  if (entry != NULL)
+    {
+      strcpy(entry->path, relpath);
+      memcpy(&entry->buf, buf, sizeof(struct stat));
+      entry->result = ret;
+      entry->time   = clock_systimer();
+      entry->gen    = fs->fs_attrgen;
+    }
+
+okout:
+#endif
+
   hostfs_semgive(fs);
   return ret;
 }
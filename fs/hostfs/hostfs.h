@@ -43,9 +43,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -63,6 +65,22 @@
 
 #define HOSTFS_MAX_PATH     256
 
+#ifndef CONFIG_FS_HOSTFS_READAHEAD
+#  define CONFIG_FS_HOSTFS_READAHEAD 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE
+#  define CONFIG_FS_HOSTFS_ATTRCACHE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE_TIMEOUT
+#  define CONFIG_FS_HOSTFS_ATTRCACHE_TIMEOUT 1000
+#endif
+
+/* Longer relative paths are not held in the attribute cache */
+
+#define HOSTFS_ATTR_PATHLEN 48
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,8 +95,27 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  off_t                     hostpos;    /* Host file position (-1: unknown) */
+  off_t                     raoffset;   /* File offset of the buffered data */
+  size_t                    ralen;      /* Number of bytes buffered */
+  FAR uint8_t              *rabuf;      /* Read-ahead buffer (or NULL) */
+#endif
 };
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/* One entry of the attribute cache */
+
+struct hostfs_attr_s
+{
+  uint32_t                  gen;        /* Cache generation (0: unused) */
+  clock_t                   time;       /* Time that the entry was made */
+  int                       result;     /* Value returned by host_stat() */
+  struct stat               buf;        /* The attributes */
+  char                      path[HOSTFS_ATTR_PATHLEN];
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a hostfs filesystem.
@@ -89,6 +126,10 @@ struct hostfs_mountpt_s
   sem_t                      *fs_sem;       /* Used to assure thread-safe access */
   FAR struct hostfs_ofile_s  *fs_head;      /* A singly-linked list of open files */
   char                        fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  uint32_t                    fs_attrgen;   /* Attribute cache generation */
+  struct hostfs_attr_s        fs_attrcache[CONFIG_FS_HOSTFS_ATTRCACHE];
+#endif
 };
 
 /****************************************************************************
@@ -134,8 +134,8 @@ int file_detach(int fd, FAR struct file *filep)
   /* If the file was properly opened, there should be an inode assigned */
 
   _files_semtake(list);
-  parent = &list->fl_files[fd];
-  if (parent->f_inode == NULL)
+  parent = files_fget(list, fd);
+  if (parent == NULL || parent->f_inode == NULL)
     {
       /* File is not open */
 
@@ -161,6 +161,7 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_pos    = 0;
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
+  FILES_CLRINUSE(list, fd);
 
   _files_semgive(list);
   return OK;
@@ -42,6 +42,7 @@
 
 #include <sys/types.h>
 #include <string.h>
+#include <strings.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <sched.h>
@@ -85,6 +86,108 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Allocate the block of the file list that holds the file descriptor fd,
+ *   if it has not already been allocated.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore (or the list is not yet shared).
+ *
+ ****************************************************************************/
+
+static int _files_extend(FAR struct filelist *list, int fd)
+{
+  int block = fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+
+  if (list->fl_files[block] == NULL)
+    {
+      list->fl_files[block] = (FAR struct file *)
+        kmm_zalloc(CONFIG_NFILE_DESCRIPTORS_PER_BLOCK *
+                   sizeof(struct file));
+      if (list->fl_files[block] == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: _files_findfree
+ *
+ * Description:
+ *   Find the lowest file descriptor that is not in use and is not less
+ *   than minfd.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _files_findfree(FAR struct filelist *list, int minfd)
+{
+  uint32_t unused;
+  int word;
+  int fd;
+
+  if (minfd < 0 || minfd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EMFILE;
+    }
+
+  /* Ignore the descriptors below minfd in the first word */
+
+  word   = minfd >> 5;
+  unused = ~list->fl_inuse[word] & ~(((uint32_t)1 << (minfd & 31)) - 1);
+
+  for (; ; )
+    {
+      if (unused != 0)
+        {
+          fd = (word << 5) + ffs((int)unused) - 1;
+          return fd < CONFIG_NFILE_DESCRIPTORS ? fd : -EMFILE;
+        }
+
+      if (++word >= FILELIST_NWORDS)
+        {
+          return -EMFILE;
+        }
+
+      unused = ~list->fl_inuse[word];
+    }
+}
+
+/****************************************************************************
+ * Name: _files_fd
+ *
+ * Description:
+ *   Return the file descriptor of a struct file instance in the file list
+ *   or -1 if it is not part of the list.
+ *
+ ****************************************************************************/
+
+static int _files_fd(FAR struct filelist *list, FAR struct file *filep)
+{
+  FAR struct file *base;
+  int block;
+
+  for (block = 0; block < FILELIST_NBLOCKS; block++)
+    {
+      base = list->fl_files[block];
+      if (base != NULL && filep >= base &&
+          filep < base + CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+        {
+          return block * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK + (filep - base);
+        }
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -170,6 +273,7 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  int block;
   int i;
 
   DEBUGASSERT(list);
@@ -179,16 +283,137 @@ void files_releaselist(FAR struct filelist *list)
    * there should not be any references in this context.
    */
 
-  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (block = 0; block < FILELIST_NBLOCKS; block++)
     {
-      (void)_files_close(&list->fl_files[i]);
+      if (list->fl_files[block] != NULL)
+        {
+          for (i = 0; i < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; i++)
+            {
+              (void)_files_close(&list->fl_files[block][i]);
+            }
+
+          kmm_free(list->fl_files[block]);
+          list->fl_files[block] = NULL;
+        }
     }
 
+  memset(list->fl_inuse, 0, sizeof(list->fl_inuse));
+
   /* Destroy the semaphore */
 
   (void)nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_duplist
+ *
+ * Description:
+ *   Duplicate the first nfds file descriptors of one file list into
+ *   another, new file list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
+                  int nfds)
+{
+  FAR struct file *pfilep;
+  int ret;
+  int fd;
+
+  DEBUGASSERT(plist != NULL && clist != NULL);
+
+  /* The new list is not yet shared, so only the file_dup2() of each file
+   * needs the protection of a semaphore.
+   */
+
+  for (fd = 0; fd < nfds && fd < CONFIG_NFILE_DESCRIPTORS; fd++)
+    {
+      pfilep = files_fget(plist, fd);
+      if (pfilep == NULL || pfilep->f_inode == NULL)
+        {
+          continue;
+        }
+
+      ret = _files_extend(clist, fd);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = file_dup2(pfilep, files_fget(clist, fd));
+      if (ret >= 0)
+        {
+          FILES_SETINUSE(clist, fd);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file instance of a file descriptor in a file list.
+ *   The file may or may not be open.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd)
+{
+  FAR struct file *block;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  block = list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  if (block == NULL)
+    {
+      return NULL;
+    }
+
+  return &block[fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+}
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the block of the current task's file list that holds
+ *   the file descriptor fd has been allocated.
+ *
+ ****************************************************************************/
+
+int files_extend(int fd)
+{
+  FAR struct filelist *list;
+  int ret;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  /* Kernel threads have no allocated file descriptors */
+
+  list = sched_getfiles();
+  if (list == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  _files_semtake(list);
+  ret = _files_extend(list, fd);
+  _files_semgive(list);
+  return ret;
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -211,6 +436,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   FAR struct filelist *list;
   FAR struct inode *inode;
   int ret;
+  int fd;
 
   if (!filep1 || !filep1->f_inode || !filep2)
     {
@@ -285,6 +511,14 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
   if (list != NULL)
     {
+      /* If filep2 belongs to the file list, its descriptor is now in use */
+
+      fd = _files_fd(list, filep2);
+      if (fd >= 0)
+        {
+          FILES_SETINUSE(list, fd);
+        }
+
       _files_semgive(list);
     }
 
@@ -301,12 +535,94 @@ errout_with_inode:
 errout_with_sem:
   if (list != NULL)
     {
+      /* Whatever filep2 held before has been closed */
+
+      fd = _files_fd(list, filep2);
+      if (fd >= 0)
+        {
+          FILES_CLRINUSE(list, fd);
+        }
+
       _files_semgive(list);
     }
 
   return ret;
 }
 
+/****************************************************************************
+ * Name: file_close_detached
+ *
+ * Description:
+ *   Close a struct file instance that is not part of any file list, such
+ *   as one set up by file_dup2() for internal OS use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int file_close_detached(FAR struct file *filep)
+{
+  DEBUGASSERT(filep != NULL);
+  return _files_close(filep);
+}
+
+/****************************************************************************
+ * Name: file_install
+ *
+ * Description:
+ *   Move a struct file instance that is not part of any file list, such as
+ *   one set up by file_dup2() for internal OS use, into a new file
+ *   descriptor of the current task.  The open file is taken over as it is;
+ *   it is not re-opened.  On success, the detached instance is reset and
+ *   must not be closed.
+ *
+ * Returned Value:
+ *   The new file descriptor is returned on success; a negated errno value
+ *   is returned on any failure.
+ *
+ ****************************************************************************/
+
+int file_install(FAR struct file *filep, int minfd)
+{
+  FAR struct filelist *list;
+  int ret;
+  int fd;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+
+  /* Kernel threads have no allocated file descriptors */
+
+  list = sched_getfiles();
+  if (list == NULL)
+    {
+      return -EMFILE;
+    }
+
+  _files_semtake(list);
+  fd = _files_findfree(list, minfd);
+  if (fd < 0)
+    {
+      _files_semgive(list);
+      return fd;
+    }
+
+  ret = _files_extend(list, fd);
+  if (ret < 0)
+    {
+      _files_semgive(list);
+      return ret;
+    }
+
+  memcpy(files_fget(list, fd), filep, sizeof(struct file));
+  memset(filep, 0, sizeof(struct file));
+  FILES_SETINUSE(list, fd);
+
+  _files_semgive(list);
+  return fd;
+}
+
 /****************************************************************************
  * Name: files_allocate
  *
@@ -319,29 +635,37 @@ errout_with_sem:
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
-  int i;
+  FAR struct file *filep;
+  int fd;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  /* Find the lowest unused descriptor and make sure that the block holding
+   * it exists.
+   */
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  fd = _files_findfree(list, minfd);
+  if (fd < 0 || _files_extend(list, fd) < 0)
     {
-      if (!list->fl_files[i].f_inode)
-        {
-           list->fl_files[i].f_oflags = oflags;
-           list->fl_files[i].f_pos    = pos;
-           list->fl_files[i].f_inode  = inode;
-           list->fl_files[i].f_priv   = NULL;
-           _files_semgive(list);
-           return i;
-        }
+      _files_semgive(list);
+      return ERROR;
     }
 
+  filep = files_fget(list, fd);
+  DEBUGASSERT(filep->f_inode == NULL);
+
+  filep->f_oflags = oflags;
+  filep->f_pos    = pos;
+  filep->f_inode  = inode;
+  filep->f_priv   = NULL;
+  FILES_SETINUSE(list, fd);
+
   _files_semgive(list);
-  return ERROR;
+  return fd;
 }
 
 /****************************************************************************
@@ -358,6 +682,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -369,7 +694,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  filep = files_fget(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -377,7 +703,8 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
+  FILES_CLRINUSE(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -394,16 +721,19 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  filep = files_fget(list, fd);
+  if (filep != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
+      FILES_CLRINUSE(list, fd);
       _files_semgive(list);
     }
 }
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_FS_INODECACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_INODECACHE_PATHLEN
+#  define CONFIG_FS_INODECACHE_PATHLEN 48
+#endif
+
+/* No relative path */
+
+#define NO_RELPATH 0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached search result.  The pointers into the search path returned by
+ * inode_search() are held as offsets from the beginning of the path.
+ */
+
+struct inode_cache_s
+{
+  uint32_t ic_gen;                 /* Generation when cached (0: unused) */
+  uint32_t ic_hash;                /* Hash of the path */
+  int16_t ic_ret;                  /* OK or -ENOENT */
+  uint16_t ic_pathoff;             /* Offset to the remaining path */
+  uint16_t ic_reloff;              /* Offset to relpath or NO_RELPATH */
+  FAR struct inode *ic_node;       /* The node found */
+  FAR struct inode *ic_peer;       /* Node to the "left" of the node */
+  FAR struct inode *ic_parent;     /* Node "above" the node */
+  char ic_path[CONFIG_FS_INODECACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cache is a direct-mapped hash table.  Invalidating the cache just
+ * advances the generation number so that no existing entry matches.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODECACHE];
+static uint32_t g_inode_cachegen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachehash
+ *
+ * Description:
+ *   Return the FNV-1a hash of the path and its length.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cachehash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = path; *ptr != '\0'; ptr++)
+    {
+      hash ^= (uint8_t)*ptr;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachelookup
+ *
+ * Description:
+ *   Return true and the cached search result if 'desc->path' was cached.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_cachelookup(FAR struct inode_search_s *desc, FAR int *ret)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  uint32_t hash;
+  size_t len;
+
+  hash = inode_cachehash(path, &len);
+  if (len >= CONFIG_FS_INODECACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash % CONFIG_FS_INODECACHE];
+  if (entry->ic_gen != g_inode_cachegen || entry->ic_hash != hash ||
+      strcmp(entry->ic_path, path) != 0)
+    {
+      return false;
+    }
+
+  desc->path    = path + entry->ic_pathoff;
+  desc->node    = entry->ic_node;
+  desc->peer    = entry->ic_peer;
+  desc->parent  = entry->ic_parent;
+  desc->relpath = entry->ic_reloff == NO_RELPATH ?
+                  NULL : path + entry->ic_reloff;
+
+  *ret = entry->ic_ret;
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_cacheadd
+ *
+ * Description:
+ *   Cache the result of a search of 'path'.  Only successful searches and
+ *   searches that failed with -ENOENT are cached.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheadd(FAR const char *path,
+                    FAR const struct inode_search_s *desc, int ret)
+{
+  FAR struct inode_cache_s *entry;
+  uint32_t hash;
+  size_t len;
+
+  if (ret != OK && ret != -ENOENT)
+    {
+      return;
+    }
+
+  hash = inode_cachehash(path, &len);
+  if (len >= CONFIG_FS_INODECACHE_PATHLEN)
+    {
+      return;
+    }
+
+  entry             = &g_inode_cache[hash % CONFIG_FS_INODECACHE];
+  entry->ic_gen     = g_inode_cachegen;
+  entry->ic_hash    = hash;
+  entry->ic_ret     = (int16_t)ret;
+  entry->ic_pathoff = (uint16_t)(desc->path - path);
+  entry->ic_reloff  = desc->relpath == NULL ?
+                      NO_RELPATH : (uint16_t)(desc->relpath - path);
+  entry->ic_node    = desc->node;
+  entry->ic_peer    = desc->peer;
+  entry->ic_parent  = desc->parent;
+  memcpy(entry->ic_path, path, len + 1);
+}
+
+/****************************************************************************
+ * Name: inode_cacheinvalidate
+ *
+ * Description:
+ *   Discard all cached search results.  Called whenever the inode tree is
+ *   modified.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheinvalidate(void)
+{
+  /* Generation zero marks unused entries.  In the unlikely event that the
+   * generation wraps, clear the table so that no stale entry can match.
+   */
+
+  if (++g_inode_cachegen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cachegen = 1;
+    }
+}
+
+#endif /* CONFIG_FS_INODECACHE > 0 */
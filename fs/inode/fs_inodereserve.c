@@ -131,6 +131,10 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = g_root_inode;
       g_root_inode = node;
     }
+
+  /* Cached look-up results may no longer be valid */
+
+  inode_cacheinvalidate();
 }
 
 /****************************************************************************
@@ -471,7 +471,25 @@ int inode_search(FAR struct inode_search_s *desc)
   desc->linktgt = NULL;
 #endif
 
-  ret = _inode_search(desc);
+  /* Check for a cached result of a previous search of the same path */
+
+  if (!inode_cachelookup(desc, &ret))
+    {
+      FAR const char *path = desc->path;
+
+      ret = _inode_search(desc);
+
+      /* Results that depend on a soft link within the path are not cached
+       * to keep the cache simple.
+       */
+
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+      if (desc->linktgt == NULL)
+#endif
+        {
+          inode_cacheadd(path, desc, ret);
+        }
+    }
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
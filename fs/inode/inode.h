@@ -55,6 +55,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_FS_INODECACHE
+#  define CONFIG_FS_INODECACHE 0
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
 
 #  define SETUP_SEARCH(d,p,n) \
@@ -95,6 +99,13 @@
 
 #endif
 
+/* Mark a file descriptor in a file list as used or unused */
+
+#define FILES_SETINUSE(l,fd) \
+  ((l)->fl_inuse[(fd) >> 5] |= (uint32_t)1 << ((fd) & 31))
+#define FILES_CLRINUSE(l,fd) \
+  ((l)->fl_inuse[(fd) >> 5] &= ~((uint32_t)1 << ((fd) & 31)))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -226,6 +237,33 @@ void inode_semgive(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cachelookup, inode_cacheadd, and inode_cacheinvalidate
+ *
+ * Description:
+ *   A hashed cache of the results of inode_search(), both successful
+ *   look-ups and look-ups that failed with -ENOENT.  inode_cachelookup()
+ *   returns true and fills in 'desc' (and 'ret') if the path is cached.
+ *   inode_cacheadd() adds the result of a completed search of 'path'.  Any
+ *   change to the inode tree must call inode_cacheinvalidate() which
+ *   discards all cached results.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODECACHE > 0
+bool inode_cachelookup(FAR struct inode_search_s *desc, FAR int *ret);
+void inode_cacheadd(FAR const char *path,
+                    FAR const struct inode_search_s *desc, int ret);
+void inode_cacheinvalidate(void);
+#else
+#  define inode_cachelookup(d,r)  (false)
+#  define inode_cacheadd(p,d,r)
+#  define inode_cacheinvalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -424,6 +462,22 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the block of the current task's file list that holds
+ *   the file descriptor fd has been allocated.  This is needed before a
+ *   file can be dup2()'ed to a descriptor that has never been used.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int files_extend(int fd);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -59,7 +59,9 @@
 #include <fcntl.h>
 #include <queue.h>
 #include <semaphore.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/kmalloc.h>
@@ -71,10 +73,46 @@
 #include "lfs.h"
 #include "lfs_util.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_LITTLEFS_CACHE_SIZE
+#  define CONFIG_FS_LITTLEFS_CACHE_SIZE 0
+#endif
+
+#ifndef CONFIG_FS_LITTLEFS_LOOKAHEAD
+#  define CONFIG_FS_LITTLEFS_LOOKAHEAD 512
+#endif
+
+#ifndef CONFIG_FS_LITTLEFS_MDCACHE
+#  define CONFIG_FS_LITTLEFS_MDCACHE 0
+#endif
+
+#ifndef CONFIG_FS_LITTLEFS_READAHEAD
+#  define CONFIG_FS_LITTLEFS_READAHEAD 0
+#endif
+
+/* Marks an unused cache entry */
+
+#define LITTLEFS_NOBLOCK 0xffffffff
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* One entry of the metadata cache.  Each holds cfg.read_size bytes. */
+
+struct littlefs_line_s
+{
+  lfs_block_t block;
+  lfs_off_t off;
+  uint32_t age;
+  FAR uint8_t *buffer;
+};
+
 struct littefs_s
 {
   struct lfs_s lfs;
@@ -82,6 +120,26 @@ struct littefs_s
   FAR struct mtd_dev_s *mtd;
   struct mtd_geometry_s geo;
   sem_t fs_sem;
+
+  /* Metadata cache */
+
+  FAR struct littlefs_line_s *lines;
+  FAR uint8_t *linebuf;
+  uint16_t nlines;
+  uint32_t age;
+
+  /* Sequential read-ahead window */
+
+  FAR uint8_t *rabuffer;
+  lfs_size_t rasize;
+  lfs_block_t rablock;
+  lfs_off_t raoff;
+  lfs_size_t ralen;
+
+  /* End of the last read, used to detect sequential access */
+
+  lfs_block_t lastblock;
+  lfs_off_t lastend;
 };
 
 /****************************************************************************
@@ -308,34 +366,207 @@ static int lfs_result_to_vfs(int result)
   return status;
 }
 
+/* Read directly from the MTD device */
+
+static int littlefs_mtdread(FAR struct littefs_s *fs, lfs_block_t block,
+                            lfs_off_t off, FAR void *buffer,
+                            lfs_size_t size)
+{
+  FAR struct mtd_dev_s *mtd = fs->mtd;
+
+  if (mtd->read(mtd, block * fs->cfg.block_size + off, size, buffer) !=
+      size)
+    {
+      return LFS_ERR_IO;
+    }
+
+  return LFS_ERR_OK;
+}
+
+/* Forget any cached data in the given region of a block.  The caches never
+ * hold data that has not been written, so this is all that is needed to
+ * keep them coherent.  Data just programmed is then read back from the
+ * media when littlefs verifies it.
+ */
+
+static void littlefs_invalidate(FAR struct littefs_s *fs, lfs_block_t block,
+                                lfs_off_t off, lfs_size_t size)
+{
+  FAR struct littlefs_line_s *line;
+  int i;
+
+  for (i = 0; i < fs->nlines; i++)
+    {
+      line = &fs->lines[i];
+      if (line->block == block && line->off < off + size &&
+          off < line->off + fs->cfg.read_size)
+        {
+          line->block = LITTLEFS_NOBLOCK;
+        }
+    }
+
+  if (fs->rablock == block && fs->raoff < off + size &&
+      off < fs->raoff + fs->ralen)
+    {
+      fs->rablock = LITTLEFS_NOBLOCK;
+    }
+
+  if (fs->lastblock == block)
+    {
+      fs->lastblock = LITTLEFS_NOBLOCK;
+    }
+}
+
+/* Find a cache entry holding the data at block/off.  If there is none,
+ * return the least recently used entry (with block set to
+ * LITTLEFS_NOBLOCK) to be refilled.
+ */
+
+static FAR struct littlefs_line_s *
+littlefs_findline(FAR struct littefs_s *fs, lfs_block_t block, lfs_off_t off)
+{
+  FAR struct littlefs_line_s *victim = &fs->lines[0];
+  FAR struct littlefs_line_s *line;
+  int i;
+
+  for (i = 0; i < fs->nlines; i++)
+    {
+      line = &fs->lines[i];
+      if (line->block == block && line->off == off)
+        {
+          return line;
+        }
+
+      if (line->block == LITTLEFS_NOBLOCK ||
+          (victim->block != LITTLEFS_NOBLOCK &&
+           (int32_t)(line->age - victim->age) < 0))
+        {
+          victim = line;
+        }
+    }
+
+  victim->block = LITTLEFS_NOBLOCK;
+  return victim;
+}
+
 static int _lfs_flash_read(FAR const struct lfs_config_s *cfg,
                            lfs_block_t block, lfs_off_t off,
                            FAR void *buffer, lfs_size_t size)
 {
-  FAR struct mtd_dev_s *mtd;
+  FAR struct littefs_s *fs;
+  FAR struct littlefs_line_s *line;
+  FAR uint8_t *dest = buffer;
+  lfs_size_t rdsize;
+  lfs_size_t len;
+  bool sequential;
+  int ret;
 
   DEBUGASSERT(cfg != NULL);
   DEBUGASSERT(cfg->context != NULL);
 
-  mtd = (FAR struct mtd_dev_s *)cfg->context;
-  if (mtd->read(mtd, block * cfg->block_size + off, size, buffer) != size)
+  fs         = (FAR struct littefs_s *)cfg->context;
+  rdsize     = cfg->read_size;
+  sequential = (block == fs->lastblock && off == fs->lastend);
+
+  fs->lastblock = block;
+  fs->lastend   = off + size;
+
+  /* littlefs reads whole, aligned cache lines, except when it bypasses its
+   * own cache for a large read into a user buffer.  Those, and reads
+   * without any caching configured, go straight to the media.
+   */
+
+  if ((fs->nlines == 0 && fs->rabuffer == NULL) || size != rdsize ||
+      (off % rdsize) != 0)
     {
-      return LFS_ERR_IO;
+      return littlefs_mtdread(fs, block, off, buffer, size);
     }
 
-  return LFS_ERR_OK;
+  /* Is it in the read-ahead window? */
+
+  if (block == fs->rablock && off >= fs->raoff &&
+      off + size <= fs->raoff + fs->ralen)
+    {
+      memcpy(dest, &fs->rabuffer[off - fs->raoff], size);
+      return LFS_ERR_OK;
+    }
+
+  /* Is it in the metadata cache? */
+
+  line = NULL;
+  if (fs->nlines > 0)
+    {
+      line = littlefs_findline(fs, block, off);
+      if (line->block != LITTLEFS_NOBLOCK)
+        {
+          line->age = ++fs->age;
+          memcpy(dest, line->buffer, size);
+          return LFS_ERR_OK;
+        }
+    }
+
+  /* Sequential reads (file data) fill the read-ahead window and leave the
+   * metadata cache alone.
+   */
+
+  if (sequential && fs->rabuffer != NULL)
+    {
+      len = cfg->block_size - off;
+      if (len > fs->rasize)
+        {
+          len = fs->rasize;
+        }
+
+      fs->rablock = LITTLEFS_NOBLOCK;
+      ret = littlefs_mtdread(fs, block, off, fs->rabuffer, len);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fs->rablock = block;
+      fs->raoff   = off;
+      fs->ralen   = len;
+
+      memcpy(dest, fs->rabuffer, size);
+      return LFS_ERR_OK;
+    }
+
+  /* Otherwise, read into the least recently used cache entry */
+
+  if (line != NULL)
+    {
+      ret = littlefs_mtdread(fs, block, off, line->buffer, size);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      line->block = block;
+      line->off   = off;
+      line->age   = ++fs->age;
+
+      memcpy(dest, line->buffer, size);
+      return LFS_ERR_OK;
+    }
+
+  return littlefs_mtdread(fs, block, off, buffer, size);
 }
 
 static int _lfs_flash_prog(FAR const struct lfs_config_s *cfg,
                            lfs_block_t block, lfs_off_t off,
                            FAR const void *buffer, lfs_size_t size)
 {
+  FAR struct littefs_s *fs;
   FAR struct mtd_dev_s *mtd;
 
   DEBUGASSERT(cfg != NULL);
   DEBUGASSERT(cfg->context != NULL);
 
-  mtd = (FAR struct mtd_dev_s *)cfg->context;
+  fs  = (FAR struct littefs_s *)cfg->context;
+  mtd = fs->mtd;
+
+  littlefs_invalidate(fs, block, off, size);
   if (mtd->write(mtd, block * cfg->block_size + off, size, buffer) != size)
     {
       return LFS_ERR_IO;
@@ -347,12 +578,16 @@ static int _lfs_flash_prog(FAR const struct lfs_config_s *cfg,
 static int _lfs_flash_erase(FAR const struct lfs_config_s *cfg,
                             lfs_block_t block)
 {
+  FAR struct littefs_s *fs;
   FAR struct mtd_dev_s *mtd;
 
   DEBUGASSERT(cfg != NULL);
   DEBUGASSERT(cfg->context != NULL);
 
-  mtd = (struct mtd_dev_s *)cfg->context;
+  fs  = (FAR struct littefs_s *)cfg->context;
+  mtd = fs->mtd;
+
+  littlefs_invalidate(fs, block, 0, cfg->block_size);
   if (mtd->erase(mtd, block, 1) != 1)
     {
       return LFS_ERR_IO;
@@ -366,6 +601,151 @@ static int _lfs_flash_sync(FAR const struct lfs_config_s *cfg)
     return LFS_ERR_OK;
 }
 
+/* Parse the mount options and set up the littlefs configuration and the
+ * caches.  The options we support are:
+ *
+ *   "cache=<bytes>"      Size of the read and program caches
+ *   "lookahead=<blocks>" Maximum allocation lookahead
+ *   "mdcache=<entries>"  Number of metadata cache entries
+ *   "readahead=<bytes>"  Size of the sequential read-ahead
+ */
+
+static int littlefs_configure(FAR struct littefs_s *fs,
+                              FAR const char *options)
+{
+  FAR const char *ptr = options;
+  unsigned long cachesize = CONFIG_FS_LITTLEFS_CACHE_SIZE;
+  unsigned long lookahead = CONFIG_FS_LITTLEFS_LOOKAHEAD;
+  unsigned long nlines    = CONFIG_FS_LITTLEFS_MDCACHE;
+  unsigned long rasize    = CONFIG_FS_LITTLEFS_READAHEAD;
+  int i;
+
+  while (ptr != NULL && *ptr != '\0')
+    {
+      if (strncmp(ptr, "cache=", 6) == 0)
+        {
+          cachesize = strtoul(&ptr[6], NULL, 0);
+        }
+      else if (strncmp(ptr, "lookahead=", 10) == 0)
+        {
+          lookahead = strtoul(&ptr[10], NULL, 0);
+        }
+      else if (strncmp(ptr, "mdcache=", 8) == 0)
+        {
+          nlines = strtoul(&ptr[8], NULL, 0);
+        }
+      else if (strncmp(ptr, "readahead=", 10) == 0)
+        {
+          rasize = strtoul(&ptr[10], NULL, 0);
+        }
+      else
+        {
+          finfo("Ignoring option: %s\n", ptr);
+        }
+
+      ptr = strchr(ptr, ',');
+      if (ptr != NULL)
+        {
+          ptr++;
+        }
+    }
+
+  /* The cache size must be a multiple of the MTD block size and must divide
+   * the erase block size.
+   */
+
+  if (cachesize == 0)
+    {
+      cachesize = fs->geo.blocksize;
+    }
+
+  cachesize -= cachesize % fs->geo.blocksize;
+  if (cachesize == 0 || (fs->geo.erasesize % cachesize) != 0 ||
+      nlines > UINT16_MAX)
+    {
+      ferr("ERROR: Bad cache configuration: %lu %lu\n", cachesize, nlines);
+      return -EINVAL;
+    }
+
+  fs->cfg.context = fs;
+  fs->cfg.read_size = cachesize;
+  fs->cfg.prog_size = cachesize;
+  fs->cfg.block_size = fs->geo.erasesize;
+  fs->cfg.block_count = fs->geo.neraseblocks;
+
+  /* There is no point looking further ahead than the whole device */
+
+  fs->cfg.lookahead = 32 * ((fs->cfg.block_count + 31) / 32);
+  lookahead = 32 * ((lookahead + 31) / 32);
+  if (lookahead > 0 && fs->cfg.lookahead > lookahead)
+    {
+      fs->cfg.lookahead = lookahead;
+    }
+
+  /* Allocate the metadata cache and the read-ahead window */
+
+  fs->lastblock = LITTLEFS_NOBLOCK;
+  fs->rablock   = LITTLEFS_NOBLOCK;
+
+  if (nlines > 0)
+    {
+      fs->lines = (FAR struct littlefs_line_s *)
+        kmm_zalloc(nlines * sizeof(struct littlefs_line_s));
+      fs->linebuf = (FAR uint8_t *)kmm_malloc(nlines * cachesize);
+      if (fs->lines == NULL || fs->linebuf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < nlines; i++)
+        {
+          fs->lines[i].block  = LITTLEFS_NOBLOCK;
+          fs->lines[i].buffer = &fs->linebuf[i * cachesize];
+        }
+
+      fs->nlines = nlines;
+    }
+
+  rasize -= rasize % cachesize;
+  if (rasize > fs->cfg.block_size)
+    {
+      rasize = fs->cfg.block_size;
+    }
+
+  if (rasize > cachesize)
+    {
+      fs->rabuffer = (FAR uint8_t *)kmm_malloc(rasize);
+      if (fs->rabuffer == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      fs->rasize = rasize;
+    }
+
+  return OK;
+}
+
+/* Free the caches allocated by littlefs_configure() */
+
+static void littlefs_freecaches(FAR struct littefs_s *fs)
+{
+  if (fs->lines != NULL)
+    {
+      kmm_free(fs->lines);
+    }
+
+  if (fs->linebuf != NULL)
+    {
+      kmm_free(fs->linebuf);
+    }
+
+  if (fs->rabuffer != NULL)
+    {
+      kmm_free(fs->rabuffer);
+    }
+}
+
 static int littlefs_bind(FAR struct inode *mtdinode,
                          FAR const void *data, FAR void **handle)
 {
@@ -400,16 +780,10 @@ static int littlefs_bind(FAR struct inode *mtdinode,
       goto errout_with_volume;
     }
 
-  fs->cfg.context = mtd;
-  fs->cfg.read_size = fs->geo.blocksize;
-  fs->cfg.prog_size = fs->geo.blocksize;
-  fs->cfg.block_size = fs->geo.erasesize;
-  fs->cfg.block_count = fs->geo.neraseblocks;
-
-  fs->cfg.lookahead = 32 * ((fs->cfg.block_count + 31) / 32);
-  if (fs->cfg.lookahead > 512)
+  ret = littlefs_configure(fs, (FAR const char *)data);
+  if (ret < 0)
     {
-      fs->cfg.lookahead = 512;
+      goto errout_with_volume;
     }
 
   fs->cfg.read = _lfs_flash_read;
@@ -444,6 +818,7 @@ static int littlefs_bind(FAR struct inode *mtdinode,
   return OK;
 
 errout_with_volume:
+  littlefs_freecaches(fs);
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return ret;
@@ -462,6 +837,7 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **mtdinode,
 
   littlefs_semtake(fs);
   ret = lfs_unmount(&fs->lfs);
+  littlefs_freecaches(fs);
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return lfs_result_to_vfs(ret);
@@ -161,7 +161,7 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
   if (ret < 0)
     {
 #ifdef CONFIG_FS_RAMMAP
-      return rammap(fd, length, offset);
+      return rammap(fd, length, offset, (prot & PROT_WRITE) != 0);
 #else
       ferr("ERROR: ioctl(FIOC_MMAP) failed: %d\n", get_errno());
       return MAP_FAILED;
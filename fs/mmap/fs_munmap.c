@@ -93,7 +93,10 @@
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      memory holding the shared copy of the file.  The memory is freed
+ *      only when the last mapping of a shared region is unmapped.  If the
+ *      region was mapped with PROT_WRITE, the unmapped data is first
+ *      written back to the file.
  *
  * Input Parameters:
  *   start   The start address of the mapping to delete.  For this
@@ -123,7 +126,7 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
@@ -149,6 +152,15 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
+  /* Is the region still in use by other mappings of the same file? */
+
+  if (curr->crefs > 1)
+    {
+      curr->crefs--;
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
    * There is no support for free a block of memory but leaving a block of
@@ -170,6 +182,15 @@ int munmap(FAR void *start, size_t length)
 
   length = curr->length - offset;
 
+  /* Write any modified data back to the file before it is discarded */
+
+  ret = rammap_writeback(curr, offset, length);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_semaphore;
+    }
+
   /* Are we unmapping the entire region (offset == 0)? */
 
   if (length >= curr->length)
@@ -185,7 +206,12 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
-      /* Then free the region */
+      /* Then release the write back file and free the region */
+
+      if (curr->writeback)
+        {
+          (void)file_close_detached(&curr->file);
+        }
 
       kumm_free(curr);
     }
@@ -196,9 +222,10 @@ int munmap(FAR void *start, size_t length)
 
   else
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      curr->length = length;
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
+      UNUSED(newaddr);
+      curr->length = offset;
     }
 
   nxsem_post(&g_rammaps.exclsem);
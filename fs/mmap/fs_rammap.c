@@ -43,11 +43,13 @@
 #include <sys/mman.h>
 
 #include <string.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 
 #include "inode/inode.h"
@@ -55,6 +57,68 @@
 
 #ifdef CONFIG_FS_RAMMAP
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Search the list of mapped regions for an existing copy of the same
+ *   region of the same file.  The caller must hold g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct fs_rammap_s *rammap_find(FAR struct inode *inode,
+                                           uintptr_t fileid, size_t length,
+                                           off_t offset)
+{
+  FAR struct fs_rammap_s *curr;
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      if (curr->shared && curr->inode == inode && curr->fileid == fileid &&
+          curr->offset == offset && curr->length >= length)
+        {
+          return curr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rammap_attach
+ *
+ * Description:
+ *   Keep a private, detached copy of the file open so that the region can
+ *   be written back after the caller has closed its file descriptor.
+ *
+ ****************************************************************************/
+
+static int rammap_attach(FAR struct fs_rammap_s *map,
+                         FAR struct file *filep)
+{
+  int ret;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      ferr("ERROR: File not open for writing\n");
+      return -EACCES;
+    }
+
+  ret = file_dup2(filep, &map->file);
+  if (ret < 0)
+    {
+      ferr("ERROR: file_dup2 failed: %d\n", ret);
+      return ret;
+    }
+
+  map->writeback = true;
+  return OK;
+}
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -90,6 +154,73 @@ void rammap_initialize(void)
     }
 }
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write the part of a mapped region beginning at 'offset' bytes from the
+ *   start of the region and extending for 'length' bytes back to the
+ *   mapped file.  This does nothing if the region was not mapped with
+ *   PROT_WRITE.  The caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The mapped region
+ *   offset  Offset into the region of the first byte to write back
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer;
+  ssize_t nwritten;
+  off_t fpos;
+
+  if (!map->writeback || offset >= map->length)
+    {
+      return OK;
+    }
+
+  if (length > map->length - offset)
+    {
+      length = map->length - offset;
+    }
+
+  wrbuffer = (FAR const uint8_t *)map->addr + offset;
+  fpos     = map->offset + offset;
+
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, wrbuffer, length, fpos);
+      if (nwritten < 0)
+        {
+          if (nwritten != -EINTR)
+            {
+              ferr("ERROR: Write failed: offset=%d errno=%d\n",
+                   (int)fpos, (int)nwritten);
+              return (int)nwritten;
+            }
+
+          continue;
+        }
+
+      if (nwritten == 0)
+        {
+          return -ENOSPC;
+        }
+
+      wrbuffer += nwritten;
+      fpos     += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: rammmap
  *
@@ -101,11 +232,15 @@ void rammap_initialize(void)
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   writable True: the mapping was created with PROT_WRITE and changes to
+ *           the region must be written back to the file.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *      'writable' is true but 'fd' was not opened for writing.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -115,29 +250,67 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, bool writable)
 {
   FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
+  uintptr_t fileid = 0;
   ssize_t nread;
-  off_t fpos;
+  bool shared;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* Different file descriptors opened with the same file path should get
+   * the same memory region when mapped.  The inode alone is not enough to
+   * know that two file descriptors refer to the same file:  All files on a
+   * mounted volume share the inode of the mountpoint.  The file system must
+   * also tell us which file this is.  If it cannot, then a new memory region
+   * is created each time that rammap() is called.
    */
 
+  shared = (file_ioctl(filep, FIOC_FILEID,
+                       (unsigned long)((uintptr_t)&fileid)) >= 0);
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  if (shared)
+    {
+      map = rammap_find(filep->f_inode, fileid, length, offset);
+      if (map != NULL)
+        {
+          /* Upgrade a read-only region if this mapping is writable */
+
+          if (writable && !map->writeback)
+            {
+              ret = rammap_attach(map, filep);
+              if (ret < 0)
+                {
+                  errcode = -ret;
+                  goto errout_with_semaphore;
+                }
+            }
+
+          map->crefs++;
+          nxsem_post(&g_rammaps.exclsem);
+          return map->addr;
+        }
+    }
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -145,7 +318,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
     {
       ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
-      goto errout;
+      goto errout_with_semaphore;
     }
 
   /* Initialize the region */
@@ -155,27 +328,29 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->addr   = alloc + sizeof(struct fs_rammap_s);
   map->length = length;
   map->offset = offset;
+  map->inode  = filep->f_inode;
+  map->fileid = fileid;
+  map->shared = shared;
+  map->crefs  = 1;
 
-  /* Seek to the specified file offset */
-
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
+  if (writable)
     {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
+      ret = rammap_attach(map, filep);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
     }
 
-  /* Read the file data into the memory region */
+  /* Read the file data into the memory region.  file_pread() leaves the
+   * file position of the caller's file descriptor unchanged.
+   */
 
   rdbuffer = map->addr;
   while (length > 0)
     {
-      nread = nx_read(fd, rdbuffer, length);
+      nread = file_pread(filep, rdbuffer, length, offset);
       if (nread < 0)
         {
           /* Handle the special case where the read was interrupted by a
@@ -190,8 +365,10 @@ FAR void *rammap(int fd, size_t length, off_t offset)
                    (int)offset, (int)nread);
 
               errcode = (int)-nread;
-              goto errout_with_region;
+              goto errout_with_file;
             }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -204,6 +381,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
       /* Increment number of bytes read */
 
       rdbuffer += nread;
+      offset   += nread;
       length   -= nread;
     }
 
@@ -213,23 +391,24 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
   /* Add the buffer to the list of regions */
 
-  rammap_initialize();
-  ret = nxsem_wait(&g_rammaps.exclsem);
-  if (ret < 0)
-    {
-      errcode = -ret;
-      goto errout_with_region;
-    }
-
   map->flink  = g_rammaps.head;
   g_rammaps.head = map;
 
   nxsem_post(&g_rammaps.exclsem);
   return map->addr;
 
+errout_with_file:
+  if (map->writeback)
+    {
+      (void)file_close_detached(&map->file);
+    }
+
 errout_with_region:
   kumm_free(alloc);
 
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
 errout:
   set_errno(errcode);
   return MAP_FAILED;
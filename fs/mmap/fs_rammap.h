@@ -45,8 +45,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/fs/fs.h>
+
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
@@ -65,9 +68,15 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Modifications to the in-memory image reach the file only if the
+ *   mapping was created with PROT_WRITE and then only when msync() is
+ *   called or when the region is finally unmapped.
  * - There are not access privileges.
+ *
+ * Mappings of the same region of the same file share one copy.  Files are
+ * identified by their inode and, if the file system supports it, by the
+ * identifier returned by the FIOC_FILEID ioctl.  A file system that does
+ * not support FIOC_FILEID gets a new copy for each mapping.
  */
 
 struct fs_rammap_s
@@ -76,6 +85,12 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+  FAR struct inode   *inode;       /* Inode of the mapped file */
+  uintptr_t           fileid;      /* File identity within the inode */
+  uint16_t            crefs;       /* Number of mappings sharing the region */
+  bool                shared;      /* True: fileid is valid, may be shared */
+  bool                writeback;   /* True: file is valid, write back changes */
+  struct file         file;        /* Detached file used for write back */
 };
 
 /* This structure defines all "mapped" files */
@@ -115,6 +130,28 @@ extern struct fs_allmaps_s g_rammaps;
 
 void rammap_initialize(void);
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write the part of a mapped region beginning at 'offset' bytes from the
+ *   start of the region and extending for 'length' bytes back to the
+ *   mapped file.  This does nothing if the region was not mapped with
+ *   PROT_WRITE.  The caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The mapped region
+ *   offset  Offset into the region of the first byte to write back
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length);
+
 /****************************************************************************
  * Name: rammmap
  *
@@ -126,11 +163,15 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   writable True: the mapping was created with PROT_WRITE and changes to
+ *           the region must be written back to the file.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *      'writable' is true but 'fd' was not opened for writing.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -140,7 +181,7 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, bool writable);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
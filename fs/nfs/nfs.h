@@ -122,6 +122,7 @@ EXTERN int  nfs_fsinfo(FAR struct nfsmount *nmp);
 EXTERN int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int  nfs_replystatus(FAR const void *response);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -104,6 +104,7 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
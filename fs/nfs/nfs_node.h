@@ -54,10 +54,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_MAXREQUESTS
+#  define CONFIG_NFS_MAXREQUESTS 1
+#endif
+
+#ifndef CONFIG_NFS_READAHEAD
+#  define CONFIG_NFS_READAHEAD 0
+#endif
+
 /* Flags for struct nfsnode n_flag */
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
 #define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_UNSTABLE       (1 << 2) /* Has uncommitted UNSTABLE writes */
+#define NFSNODE_STALEVERF      (1 << 3) /* Write verifier changed */
 
 /****************************************************************************
  * Public Types
@@ -79,6 +89,15 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file */
+#ifdef CONFIG_NFS_WRITEBEHIND
+  uint8_t            n_verf[NFSX_V3WRITEVERF]; /* UNSTABLE write verifier */
+#endif
+#if CONFIG_NFS_READAHEAD > 0
+  FAR uint8_t       *n_rabuf;       /* Read-ahead buffer (or NULL) */
+  off_t              n_raoffset;    /* File offset of the read-ahead data */
+  size_t             n_ralen;       /* Number of bytes of read-ahead data */
+  off_t              n_rapos;       /* File position after the last read */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -204,7 +204,6 @@ int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *response, size_t resplen)
 {
   struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
 
 tryagain:
@@ -216,6 +215,33 @@ tryagain:
       return error;
     }
 
+  error = nfs_replystatus(response);
+  if (error == EAGAIN)
+    {
+      goto tryagain;
+    }
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: nfs_replystatus
+ *
+ * Description:
+ *   Check the NFS status of a reply message received by nfs_request() or
+ *   by rpcclnt_recvreply().
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.  EAGAIN means that
+ *   the call should be sent again.
+ *
+ ****************************************************************************/
+
+int nfs_replystatus(FAR const void *response)
+{
+  struct nfs_reply_header replyh;
+  int error;
+
   memcpy(&replyh, response, sizeof(struct nfs_reply_header));
 
   if (replyh.nfs_status != 0)
@@ -237,11 +263,9 @@ tryagain:
   if (replyh.rpc_verfi.authtype != 0)
     {
       error = fxdr_unsigned(int, replyh.rpc_verfi.authtype);
-
       if (error == EAGAIN)
         {
-          error = 0;
-          goto tryagain;
+          return error;
         }
 
       ferr("ERROR: NFS error %d from server\n", error);
@@ -103,6 +103,14 @@
 #  error "Length of cookie verify in fs_dirent_s is incorrect"
 #endif
 
+/* With write-behind, data is written UNSTABLE and committed later */
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+#  define NFS_WRITE_STABLE    NFSV3WRITE_UNSTABLE
+#else
+#  define NFS_WRITE_STABLE    NFSV3WRITE_FILESYNC
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -119,6 +127,14 @@ struct nfs_statinfo_s
   time_t   ns_ctime;   /* Time of last status change */
 };
 
+/* Describes one READ or WRITE call of a transfer */
+
+struct nfs_rwreq_s
+{
+  off_t    offset;     /* File offset of the data */
+  size_t   size;       /* Number of bytes requested */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -143,6 +159,27 @@ static int     nfs_filetruncate(FAR struct nfsmount *nmp,
 static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
+static int     nfs_readcall(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR const struct nfs_rwreq_s *req,
+                   FAR uint32_t *xid);
+static int     nfs_readrpcs(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset, FAR char *buffer,
+                   size_t buflen, FAR size_t *nread, FAR bool *eof);
+#if CONFIG_NFS_READAHEAD > 0
+static int     nfs_readahead(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset, FAR char *buffer,
+                   size_t buflen, FAR size_t *nread, FAR bool *eof);
+#endif
+static int     nfs_writecall(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR const struct nfs_rwreq_s *req,
+                   FAR const char *data, FAR uint32_t *xid);
+static int     nfs_writerpcs(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const char *buffer, size_t buflen,
+                   FAR size_t *nwritten);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
 
 static int     nfs_open(FAR struct file *filep, const char *relpath,
                    int oflags, mode_t mode);
@@ -150,6 +187,9 @@ static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
 static int     nfs_truncate(FAR struct file *filep, off_t length);
@@ -194,7 +234,11 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  nfs_sync,                     /* sync */
+#else
   NULL,                         /* sync */
+#endif
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
   nfs_truncate,                 /* truncate */
@@ -741,6 +785,12 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Commit any UNSTABLE writes before the file structure is freed. */
+
+      int error = nfs_commit(nmp, np);
+#endif
+
       /* Assume file structure will not be found.  This should never happen. */
 
       ret = -EINVAL;
@@ -770,11 +820,25 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#if CONFIG_NFS_READAHEAD > 0
+              if (np->n_rabuf != NULL)
+                {
+                  kmm_free(np->n_rabuf);
+                }
+
+#endif
               kmm_free(np);
               ret = OK;
               break;
             }
         }
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+      if (ret == OK && error != OK)
+        {
+          ret = -error;
+        }
+#endif
     }
 
   filep->f_priv = NULL;
@@ -783,130 +847,196 @@ static int nfs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: nfs_read
+ * Name: nfs_readcall
+ *
+ * Description:
+ *   Format and send one READ call message.  The reply is not awaited.
  *
  * Returned Value:
- *   The (non-negative) number of bytes read on success; a negated errno
- *   value on failure.
+ *   0 on success; a positive errno value on failure.
  *
  ****************************************************************************/
 
-static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
+static int nfs_readcall(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        FAR const struct nfs_rwreq_s *req,
+                        FAR uint32_t *xid)
 {
-  FAR struct nfsmount       *nmp;
-  FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
-  int                        error = 0;
+  FAR uint32_t *ptr;
+  size_t        reqlen;
 
-  finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
+  /* Initialize the request */
 
-  /* Sanity checks */
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
 
-  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+  /* Copy the variable length, file handle */
 
-  /* Recover our private data from the struct file instance */
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
 
-  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
-  np  = (FAR struct nfsnode *)filep->f_priv;
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
 
-  DEBUGASSERT(nmp != NULL);
+  /* Copy the file offset */
 
-  /* Make sure that the mount is still healthy */
+  txdr_hyper((uint64_t)req->offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
 
-  nfs_semtake(nmp);
-  error = nfs_checkmount(nmp);
-  if (error != OK)
-    {
-      ferr("ERROR: nfs_checkmount failed: %d\n", error);
-      goto errout_with_semaphore;
-    }
+  /* Set the readsize */
 
-  /* Get the number of bytes left in the file and truncate read count so that
-   * it does not exceed the number of bytes left in the file.
+  *ptr    = txdr_unsigned(req->size);
+  reqlen += sizeof(uint32_t);
+
+  /* Send the read request */
+
+  finfo("Reading %d bytes at offset %d\n", req->size, req->offset);
+  nfs_statistics(NFSPROC_READ);
+  return rpcclnt_sendcall(nmp->nm_rpcclnt, NFSPROC_READ, NFS_PROG, NFS_VER3,
+                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen, xid);
+}
+
+/****************************************************************************
+ * Name: nfs_readrpcs
+ *
+ * Description:
+ *   Read 'buflen' bytes at 'offset' into 'buffer' using as many READ calls
+ *   as needed.  Up to CONFIG_NFS_MAXREQUESTS calls are kept outstanding.
+ *   The transfer ends early at the end of the file or if the server
+ *   returns fewer bytes than were requested.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  The number of bytes
+ *   read is returned in 'nread'.  'eof' is set if the end of the file was
+ *   reached.
+ *
+ ****************************************************************************/
+
+static int nfs_readrpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        off_t offset, FAR char *buffer, size_t buflen,
+                        FAR size_t *nread, FAR bool *eof)
+{
+  struct nfs_rwreq_s  reqs[CONFIG_NFS_MAXREQUESTS];
+  uint32_t            xids[CONFIG_NFS_MAXREQUESTS];
+  FAR struct rpcclnt *rpc = nmp->nm_rpcclnt;
+  FAR uint32_t       *ptr;
+  size_t              maxsize;
+  size_t              readsize;
+  uint32_t            tmp;
+  off_t               next;
+  off_t               end;
+  off_t               eofpos;
+  bool                eofseen = false;
+  int                 retries = 0;
+  int                 nreqs = 0;
+  int                 index = -1;
+  int                 error;
+  int                 i;
+
+  /* Make sure that the read size does not exceed the RPC maximum or the
+   * IO buffer size
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  maxsize = nmp->nm_rsize;
+  if (SIZEOF_rpc_reply_read(maxsize) > nmp->nm_buflen)
     {
-      buflen = tmp;
-      finfo("Read size truncated to %d\n", buflen);
+      maxsize = nmp->nm_buflen - SIZEOF_rpc_reply_read(0);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
+  next   = offset;
+  end    = offset + buflen;
+  eofpos = end;
 
-  for (bytesread = 0; bytesread < buflen; )
+  for (; ; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
+      /* Keep the maximum number of READ calls outstanding */
 
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      while (nreqs < CONFIG_NFS_MAXREQUESTS && next < end)
         {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
+          readsize = end - next;
+          if (readsize > maxsize)
+            {
+              readsize = maxsize;
+            }
 
-      /* Initialize the request */
+          reqs[nreqs].offset = next;
+          reqs[nreqs].size   = readsize;
+          xids[nreqs]        = 0;
 
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
+          error = nfs_readcall(nmp, np, &reqs[nreqs], &xids[nreqs]);
+          if (error != OK)
+            {
+              ferr("ERROR: nfs_readcall failed: %d\n", error);
+              return error;
+            }
 
-      /* Copy the variable length, file handle */
+          next += readsize;
+          nreqs++;
+        }
 
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+      if (nreqs == 0)
+        {
+          break;
+        }
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
+      /* Wait for the reply to any one of the outstanding calls */
 
-      /* Copy the file offset */
+      error = rpcclnt_recvreply(rpc, xids, nreqs, nmp->nm_iobuffer,
+                                nmp->nm_buflen, &index);
+      if (error == OK)
+        {
+          error = nfs_replystatus(nmp->nm_iobuffer);
+        }
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
+      /* On a timeout, send all of the outstanding calls again */
 
-      /* Set the readsize */
+      if (rpc->rc_timeout || error == EAGAIN)
+        {
+          if (++retries > rpc->rc_retry)
+            {
+              ferr("ERROR: READ failed: %d\n", error);
+              return error;
+            }
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          for (i = 0; i < nreqs; i++)
+            {
+              if (rpc->rc_timeout || i == index)
+                {
+                  error = nfs_readcall(nmp, np, &reqs[i], &xids[i]);
+                  if (error != OK)
+                    {
+                      ferr("ERROR: nfs_readcall failed: %d\n", error);
+                      return error;
+                    }
+                }
+            }
 
-      /* Perform the read */
+          continue;
+        }
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
+          ferr("ERROR: READ failed: %d\n", error);
+          return error;
         }
 
+      retries = 0;
+
       /* The read was successful.  Get a pointer to the beginning of the NFS
        * response data.
        */
 
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+      ptr = (FAR uint32_t *)
+        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
 
-      /* Check if attributes are included in the responses */
+      /* Check if attributes are included in the responses.  If so, use
+       * them to keep the cached file status up to date.
+       */
 
-      tmp = *ptr++;
-      if (*ptr != 0)
+      if (*ptr++ != 0)
         {
-          /* Yes... just skip over the attributes for now */
-
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
           ptr += uint32_increment(sizeof(struct nfs_fattr));
         }
 
@@ -927,58 +1057,163 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       readsize = fxdr_unsigned(uint32_t, *ptr);
       ptr++;
 
+      if (readsize > reqs[index].size)
+        {
+          ferr("ERROR: Bad READ length: %d\n", readsize);
+          return EIO;
+        }
+
       /* Copy the read data into the user buffer */
 
-      memcpy(buffer, ptr, readsize);
+      memcpy(&buffer[reqs[index].offset - offset], ptr, readsize);
 
-      /* Update the read state data */
+      /* A short read or the end of file truncates the transfer */
+
+      if (tmp != 0 || readsize < reqs[index].size)
+        {
+          end = reqs[index].offset + readsize;
+          if (tmp != 0)
+            {
+              eofseen = true;
+              eofpos  = end;
+            }
+        }
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+      /* This call is complete.  Calls beyond the (new) end of the transfer
+       * are abandoned.  Any late replies to them will be discarded.
+       */
 
-      /* Check if we hit the end of file */
+      nreqs--;
+      reqs[index] = reqs[nreqs];
+      xids[index] = xids[nreqs];
 
-      if (tmp != 0)
+      for (i = 0; i < nreqs; )
         {
-          break;
+          if (reqs[i].offset >= end)
+            {
+              nreqs--;
+              reqs[i] = reqs[nreqs];
+              xids[i] = xids[nreqs];
+            }
+          else
+            {
+              i++;
+            }
+        }
+
+      if (next > end)
+        {
+          next = end;
         }
     }
 
-  finfo("Read %d bytes\n", bytesread);
-  nfs_semgive(nmp);
-  return bytesread;
+  *nread = end - offset;
+  *eof   = eofseen && eofpos == end;
+  return OK;
+}
 
-errout_with_semaphore:
-  nfs_semgive(nmp);
-  return -error;
+#if CONFIG_NFS_READAHEAD > 0
+/****************************************************************************
+ * Name: nfs_readahead
+ *
+ * Description:
+ *   Satisfy a small, sequential read from the read-ahead buffer of the
+ *   file, refilling the buffer from the server if it does not hold the
+ *   data at 'offset'.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  The number of bytes
+ *   read is returned in 'nread'.  'eof' is set if the end of the file was
+ *   reached.
+ *
+ ****************************************************************************/
+
+static int nfs_readahead(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         off_t offset, FAR char *buffer, size_t buflen,
+                         FAR size_t *nread, FAR bool *eof)
+{
+  size_t ralen;
+  size_t avail;
+  int    error;
+
+  *eof = false;
+
+  /* Refill the buffer if it does not contain the data at 'offset' */
+
+  if (offset < np->n_raoffset || offset >= np->n_raoffset + np->n_ralen)
+    {
+      if (np->n_rabuf == NULL)
+        {
+          np->n_rabuf = (FAR uint8_t *)kmm_malloc(CONFIG_NFS_READAHEAD);
+          if (np->n_rabuf == NULL)
+            {
+              /* Just read directly into the user buffer */
+
+              return nfs_readrpcs(nmp, np, offset, buffer, buflen, nread,
+                                  eof);
+            }
+        }
+
+      ralen = CONFIG_NFS_READAHEAD;
+      if (np->n_size - offset < ralen)
+        {
+          ralen = np->n_size - offset;
+        }
+
+      np->n_ralen = 0;
+      error = nfs_readrpcs(nmp, np, offset, (FAR char *)np->n_rabuf, ralen,
+                           &ralen, eof);
+      if (error != OK)
+        {
+          return error;
+        }
+
+      np->n_raoffset = offset;
+      np->n_ralen    = ralen;
+    }
+
+  /* Then copy the data from the read-ahead buffer */
+
+  avail = np->n_raoffset + np->n_ralen - offset;
+  if (buflen > avail)
+    {
+      buflen = avail;
+    }
+
+  if (buflen < avail)
+    {
+      *eof = false;
+    }
+
+  memcpy(buffer, &np->n_rabuf[offset - np->n_raoffset], buflen);
+  *nread = buflen;
+  return OK;
 }
+#endif
 
 /****************************************************************************
- * Name: nfs_write
+ * Name: nfs_read
  *
  * Returned Value:
- *   The (non-negative) number of bytes written on success; a negated errno
+ *   The (non-negative) number of bytes read on success; a negated errno
  *   value on failure.
  *
  ****************************************************************************/
 
-static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
-                         size_t buflen)
+static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
-  struct nfsmount       *nmp;
-  struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
-  ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
-  int                    error;
+  FAR struct nfsmount       *nmp;
+  FAR struct nfsnode        *np;
+  ssize_t                    tmp;
+  ssize_t                    bytesread;
+  size_t                     nread;
+#if CONFIG_NFS_READAHEAD > 0
+  bool                       readahead;
+#endif
+  bool                       eof;
+  int                        error = 0;
 
-  finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
+  finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
 
   /* Sanity checks */
 
@@ -1001,98 +1236,281 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Check if the file size would exceed the range of off_t */
+  /* Get the number of bytes left in the file and truncate read count so that
+   * it does not exceed the number of bytes left in the file.
+   */
 
-  if (np->n_size + buflen < np->n_size)
+  tmp = np->n_size - filep->f_pos;
+  if (buflen > tmp)
     {
-      error = EFBIG;
-      goto errout_with_semaphore;
+      buflen = tmp;
+      finfo("Read size truncated to %d\n", buflen);
     }
 
-  /* Now loop until we send the entire user buffer */
+#if CONFIG_NFS_READAHEAD > 0
+  /* Small reads go through the read-ahead buffer if the file is being read
+   * sequentially (or the data is already buffered).
+   */
 
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
-    {
-      /* Make sure that the attempted write size does not exceed the RPC maximum */
+  readahead = buflen < CONFIG_NFS_READAHEAD &&
+              (filep->f_pos == np->n_rapos ||
+               (filep->f_pos >= np->n_raoffset &&
+                filep->f_pos < np->n_raoffset + np->n_ralen));
+#endif
 
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
+  /* Now loop until we fill the user buffer (or hit the end of the file) */
+
+  for (bytesread = 0; bytesread < buflen; )
+    {
+#if CONFIG_NFS_READAHEAD > 0
+      if (readahead)
         {
-          writesize = nmp->nm_wsize;
+          error = nfs_readahead(nmp, np, filep->f_pos, buffer,
+                                buflen - bytesread, &nread, &eof);
         }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      else
+#endif
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          error = nfs_readrpcs(nmp, np, filep->f_pos, buffer,
+                               buflen - bytesread, &nread, &eof);
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
-      if (error)
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
 
-      /* Get a pointer to the WRITE reply data */
+      /* Update the read state data */
 
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+      filep->f_pos += nread;
+      bytesread    += nread;
+      buffer       += nread;
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+      /* Check if we hit the end of file */
 
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (eof || nread == 0)
         {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
+          break;
         }
+    }
 
-      /* Check if normal file attributes follow */
+#if CONFIG_NFS_READAHEAD > 0
+  np->n_rapos = filep->f_pos;
+#endif
+
+  finfo("Read %d bytes\n", bytesread);
+  nfs_semgive(nmp);
+  return bytesread;
+
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
+
+/****************************************************************************
+ * Name: nfs_writecall
+ *
+ * Description:
+ *   Format and send one WRITE call message.  The reply is not awaited.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_writecall(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         FAR const struct nfs_rwreq_s *req,
+                         FAR const char *data, FAR uint32_t *xid)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)
+    &((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)req->offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(req->size);
+  *ptr++  = txdr_unsigned(NFS_WRITE_STABLE);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(req->size);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, data, req->size);
+  reqlen += uint32_alignup(req->size);
+
+  /* Send the write request */
+
+  nfs_statistics(NFSPROC_WRITE);
+  return rpcclnt_sendcall(nmp->nm_rpcclnt, NFSPROC_WRITE, NFS_PROG,
+                          NFS_VER3, (FAR void *)nmp->nm_iobuffer, reqlen,
+                          xid);
+}
+
+/****************************************************************************
+ * Name: nfs_writerpcs
+ *
+ * Description:
+ *   Write 'buflen' bytes from 'buffer' at 'offset' using as many WRITE
+ *   calls as needed.  Up to CONFIG_NFS_MAXREQUESTS calls are kept
+ *   outstanding.  The transfer ends early if the server accepts fewer
+ *   bytes than were sent.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  The number of bytes
+ *   written is returned in 'nwritten'.
+ *
+ ****************************************************************************/
+
+static int nfs_writerpcs(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         off_t offset, FAR const char *buffer,
+                         size_t buflen, FAR size_t *nwritten)
+{
+  struct nfs_rwreq_s  reqs[CONFIG_NFS_MAXREQUESTS];
+  uint32_t            xids[CONFIG_NFS_MAXREQUESTS];
+  FAR struct rpcclnt *rpc = nmp->nm_rpcclnt;
+  FAR uint32_t       *ptr;
+  size_t              maxsize;
+  size_t              writesize;
+  uint32_t            tmp;
+  off_t               next;
+  off_t               end;
+  int                 retries = 0;
+  int                 nreqs = 0;
+  int                 index = -1;
+  int                 error;
+  int                 i;
+
+  /* Make sure that the write size does not exceed the RPC maximum or the
+   * IO buffer size
+   */
+
+  maxsize = nmp->nm_wsize;
+  if (SIZEOF_rpc_call_write(maxsize) > nmp->nm_buflen)
+    {
+      maxsize = nmp->nm_buflen - SIZEOF_rpc_call_write(0);
+    }
+
+  next = offset;
+  end  = offset + buflen;
+
+  for (; ; )
+    {
+      /* Keep the maximum number of WRITE calls outstanding */
+
+      while (nreqs < CONFIG_NFS_MAXREQUESTS && next < end)
+        {
+          writesize = end - next;
+          if (writesize > maxsize)
+            {
+              writesize = maxsize;
+            }
+
+          reqs[nreqs].offset = next;
+          reqs[nreqs].size   = writesize;
+          xids[nreqs]        = 0;
+
+          error = nfs_writecall(nmp, np, &reqs[nreqs],
+                                &buffer[next - offset], &xids[nreqs]);
+          if (error != OK)
+            {
+              ferr("ERROR: nfs_writecall failed: %d\n", error);
+              return error;
+            }
+
+          next += writesize;
+          nreqs++;
+        }
+
+      if (nreqs == 0)
+        {
+          break;
+        }
+
+      /* Wait for the reply to any one of the outstanding calls */
+
+      error = rpcclnt_recvreply(rpc, xids, nreqs,
+                                (FAR void *)&nmp->nm_msgbuffer.write,
+                                sizeof(struct rpc_reply_write), &index);
+      if (error == OK)
+        {
+          error = nfs_replystatus(&nmp->nm_msgbuffer.write);
+        }
+
+      /* On a timeout, send all of the outstanding calls again */
+
+      if (rpc->rc_timeout || error == EAGAIN)
+        {
+          if (++retries > rpc->rc_retry)
+            {
+              ferr("ERROR: WRITE failed: %d\n", error);
+              return error;
+            }
+
+          for (i = 0; i < nreqs; i++)
+            {
+              if (rpc->rc_timeout || i == index)
+                {
+                  error = nfs_writecall(nmp, np, &reqs[i],
+                                        &buffer[reqs[i].offset - offset],
+                                        &xids[i]);
+                  if (error != OK)
+                    {
+                      ferr("ERROR: nfs_writecall failed: %d\n", error);
+                      return error;
+                    }
+                }
+            }
+
+          continue;
+        }
+
+      if (error != OK)
+        {
+          ferr("ERROR: WRITE failed: %d\n", error);
+          return error;
+        }
+
+      retries = 0;
+
+      /* Get a pointer to the WRITE reply data */
+
+      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+      /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+      tmp = *ptr++;
+      if (tmp != 0)
+        {
+          /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+          ptr += uint32_increment(sizeof(struct wcc_attr));
+        }
+
+      /* Check if normal file attributes follow */
 
       tmp = *ptr++;
       if (tmp != 0)
@@ -1105,45 +1523,304 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 
       /* Get the count of bytes actually written */
 
+      writesize = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (writesize < 1 || writesize > reqs[index].size)
+        {
+          return EIO;
+        }
+
+      /* Get the committment level obtained by the RPC */
+
       tmp = fxdr_unsigned(uint32_t, *ptr);
       ptr++;
 
-      if (tmp < 1 || tmp > writesize)
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Remember the write verifier of UNSTABLE writes.  A different
+       * verifier means that the server has restarted and that earlier
+       * UNSTABLE writes may have been lost.
+       */
+
+      if (tmp == NFSV3WRITE_UNSTABLE)
         {
-           error = EIO;
-           goto errout_with_semaphore;
+          if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+            {
+              memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+              np->n_flags |= NFSNODE_UNSTABLE;
+            }
+          else if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+            {
+              np->n_flags |= NFSNODE_STALEVERF;
+            }
         }
+#else
+      UNUSED(tmp);
+#endif
 
-      writesize = tmp;
+      /* A short write truncates the transfer */
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+      if (writesize < reqs[index].size)
+        {
+          end = reqs[index].offset + writesize;
+        }
+
+      /* This call is complete.  Calls beyond the (new) end of the transfer
+       * are abandoned.  Any late replies to them will be discarded.
+       */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
+      nreqs--;
+      reqs[index] = reqs[nreqs];
+      xids[index] = xids[nreqs];
+
+      for (i = 0; i < nreqs; )
         {
-          committed = commit;
+          if (reqs[i].offset >= end)
+            {
+              nreqs--;
+              reqs[i] = reqs[nreqs];
+              xids[i] = xids[nreqs];
+            }
+          else
+            {
+              i++;
+            }
         }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
+
+      if (next > end)
         {
-          committed = commit;
+          next = end;
         }
+    }
 
-      /* Update the read state data */
+  /* The attributes of replies that arrived out of order may be stale */
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  if (np->n_size < (uint64_t)end)
+    {
+      np->n_size = end;
+    }
+
+  *nwritten = end - offset;
+  return OK;
+}
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Commit any UNSTABLE writes to the file to stable storage on the server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  EIO means that the
+ *   server restarted and that written data may have been lost.
+ *
+ ****************************************************************************/
+
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  int           error;
+
+  if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+    {
+      return OK;
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Commit the whole file:  Offset zero and count zero */
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the COMMIT RPC */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* Parse file_wcc */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  if (*ptr++ != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  if (*ptr++ != 0)
+    {
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* The verifier must match the one returned by the UNSTABLE writes */
+
+  if ((np->n_flags & NFSNODE_STALEVERF) != 0 ||
+      memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      ferr("ERROR: Write verifier changed; data may have been lost\n");
+      error = EIO;
+    }
+
+  np->n_flags &= ~(NFSNODE_UNSTABLE | NFSNODE_STALEVERF);
+  return error;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_write
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
+                         size_t buflen)
+{
+  struct nfsmount       *nmp;
+  struct nfsnode        *np;
+  ssize_t                byteswritten;
+  size_t                 nwritten;
+  int                    error;
+
+  finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_checkmount failed: %d\n", error);
+      goto errout_with_semaphore;
+    }
+
+  /* Check if the file size would exceed the range of off_t */
+
+  if (np->n_size + buflen < np->n_size)
+    {
+      error = EFBIG;
+      goto errout_with_semaphore;
+    }
+
+#if CONFIG_NFS_READAHEAD > 0
+  /* Any read-ahead data may now be stale */
+
+  np->n_ralen = 0;
+#endif
+
+  /* Now loop until we send the entire user buffer */
+
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+      error = nfs_writerpcs(nmp, np, filep->f_pos, buffer,
+                            buflen - byteswritten, &nwritten);
+      if (error != OK)
+        {
+          goto errout_with_semaphore;
+        }
+
+      /* Update the write state data */
+
+      filep->f_pos += nwritten;
+      byteswritten += nwritten;
+      buffer       += nwritten;
     }
 
   nfs_semgive(nmp);
-  return writesize;
+  return byteswritten;
 
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Commit any UNSTABLE writes to the file to stable storage.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int error;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_checkmount failed: %d\n", error);
+    }
+  else
+    {
+      error = nfs_commit(nmp, np);
+    }
+
+  nfs_semgive(nmp);
+  return -error;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_dup
  *
@@ -1313,6 +1990,12 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
       goto errout_with_semaphore;
     }
 
+#if CONFIG_NFS_READAHEAD > 0
+  /* Any read-ahead data may now be stale */
+
+  np->n_ralen = 0;
+#endif
+
   /* Then perform the SETATTR RPC to set the new file size */
 
   error = nfs_filetruncate(nmp, np, length);
@@ -137,8 +137,10 @@ static int rpcclnt_send(FAR struct rpcclnt *rpc, int procid, int prog,
                         FAR void *call, int reqlen);
 static int rpcclnt_receive(FAR struct rpcclnt *rpc, struct sockaddr *aname,
                            int proc, int program, void *reply, size_t resplen);
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
-                         void *reply, size_t resplen);
+static int rpcclnt_reply(FAR struct rpcclnt *rpc,
+                         FAR const uint32_t *xids, int nxids,
+                         FAR void *reply, size_t resplen, FAR int *index);
+static int rpcclnt_checkreply(FAR void *reply);
 static uint32_t rpcclnt_newxid(void);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
@@ -214,48 +216,128 @@ static int rpcclnt_receive(FAR struct rpcclnt *rpc, FAR struct sockaddr *aname,
  * Name: rpcclnt_reply
  *
  * Description:
- *   Received the RPC reply on the socket.
+ *   Received the RPC reply on the socket.  Replies are matched against the
+ *   transaction IDs of the outstanding calls in 'xids'.  Replies to other
+ *   calls (for example, late replies to calls that were re-transmitted or
+ *   abandoned) are discarded.  The index of the matching call is returned
+ *   in 'index'.
  *
  ****************************************************************************/
 
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
-                         FAR void *reply, size_t resplen)
+static int rpcclnt_reply(FAR struct rpcclnt *rpc,
+                         FAR const uint32_t *xids, int nxids,
+                         FAR void *reply, size_t resplen, FAR int *index)
 {
+  FAR struct rpc_reply_header *replyheader;
   int error;
+  int i;
 
-  /* Get the next RPC reply from the socket */
-
-  error = rpcclnt_receive(rpc, rpc->rc_name, procid, prog, reply, resplen);
-  if (error != 0)
+  for (; ; )
     {
-      ferr("ERROR: rpcclnt_receive returned: %d\n", error);
-
-      /* If we failed because of a timeout, then try sending the CALL
-       * message again.
-       */
+      /* Get the next RPC reply from the socket */
 
-      if (error == EAGAIN || error == ETIMEDOUT)
+      error = rpcclnt_receive(rpc, rpc->rc_name, 0, 0, reply, resplen);
+      if (error != 0)
         {
-          rpc->rc_timeout = true;
-       }
-    }
+          ferr("ERROR: rpcclnt_receive returned: %d\n", error);
 
-  /* Get the xid and check that it is an RPC replysvr */
+          /* If we failed because of a timeout, then try sending the CALL
+           * message again.
+           */
 
-  else
-    {
-      FAR struct rpc_reply_header *replyheader =
-        (FAR struct rpc_reply_header *)reply;
+          if (error == EAGAIN || error == ETIMEDOUT)
+            {
+              rpc->rc_timeout = true;
+            }
+
+          return error;
+        }
+
+      /* Check that it is an RPC reply */
 
+      replyheader = (FAR struct rpc_reply_header *)reply;
       if (replyheader->rp_direction != rpc_reply)
         {
           ferr("ERROR: Different RPC REPLY returned\n");
           rpc_statistics(rpcinvalid);
-          error = EPROTO;
+          continue;
+        }
+
+      /* Check if it is the reply to one of our calls */
+
+      for (i = 0; i < nxids; i++)
+        {
+          if (replyheader->rp_xid == txdr_unsigned(xids[i]))
+            {
+              *index = i;
+              return OK;
+            }
         }
+
+      finfo("Discarding reply with xid %08x\n",
+            fxdr_unsigned(uint32_t, replyheader->rp_xid));
     }
+}
 
-  return error;
+/****************************************************************************
+ * Name: rpcclnt_checkreply
+ *
+ * Description:
+ *   Verify the RPC level of the returned values in the reply message.
+ *   (There may still be be NFS layer errors that will be detected by
+ *   calling logic).
+ *
+ ****************************************************************************/
+
+static int rpcclnt_checkreply(FAR void *reply)
+{
+  FAR struct rpc_reply_header *replymsg;
+  uint32_t tmp;
+
+  /* Break down the RPC header and check if it is OK */
+
+  replymsg = (FAR struct rpc_reply_header *)reply;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp == RPC_MSGDENIED)
+    {
+      tmp = fxdr_unsigned(uint32_t, replymsg->status);
+      switch (tmp)
+        {
+        case RPC_MISMATCH:
+          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
+          return EOPNOTSUPP;
+
+        case RPC_AUTHERR:
+          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
+          return EACCES;
+
+        default:
+          return EOPNOTSUPP;
+        }
+    }
+  else if (tmp != RPC_MSGACCEPTED)
+    {
+      return EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else if (tmp == RPC_PROGMISMATCH)
+    {
+      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
+      return EOPNOTSUPP;
+    }
+  else if (tmp > 5)
+    {
+      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
+      return EOPNOTSUPP;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -677,75 +759,141 @@ bad:
 }
 
 /****************************************************************************
- * Name: rpcclnt_request
+ * Name: rpcclnt_sendcall
  *
  * Description:
- *   Perform the RPC request.  Logic formats the RPC CALL message and calls
- *   rpcclnt_send to send the RPC CALL message.  It then calls rpcclnt_reply()
- *   to get the response.  It may attempt to re-send the CALL message on
- *   certain errors.
+ *   Format the RPC CALL message and send it without waiting for the reply.
+ *   If '*xid' is zero, then a new transaction ID is assigned and returned
+ *   in '*xid'.  Otherwise, the call is re-transmitted with the same
+ *   transaction ID.  rpcclnt_recvreply() may then be used to collect the
+ *   replies to one or more outstanding calls.
  *
- *   On successful receipt, it verifies the RPC level of the returned values.
- *   (There may still be be NFS layer errors that will be deted by calling
- *   logic).
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
  *
  ****************************************************************************/
 
-int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
-                    int version, FAR void *request, size_t reqlen,
-                    FAR void *response, size_t resplen)
+int rpcclnt_sendcall(FAR struct rpcclnt *rpc, int procnum, int prog,
+                     int version, FAR void *request, size_t reqlen,
+                     FAR uint32_t *xid)
 {
-  struct rpc_reply_header *replymsg;
-  uint32_t tmp;
-  uint32_t xid;
-  int retries;
-  int error = 0;
+  int error;
 
-  /* Get a new (non-zero) xid */
+  /* Get a new (non-zero) xid if this is not a re-transmission */
 
-  xid = rpcclnt_newxid();
+  if (*xid == 0)
+    {
+      *xid = rpcclnt_newxid();
+    }
+  else
+    {
+      rpc_statistics(rpcretries);
+    }
 
   /* Initialize the RPC header fields */
 
   rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
-                    xid, prog, version, procnum);
+                    *xid, prog, version, procnum);
 
-  /* Get the full size of the message (the size of variable data plus the size of
+  /* Send the full message (the size of variable data plus the size of
    * the messages header).
    */
 
-  reqlen += sizeof(struct rpc_call_header);
+  rpc_statistics(rpcrequests);
+  error = rpcclnt_send(rpc, procnum, prog, request,
+                       reqlen + sizeof(struct rpc_call_header));
+  if (error != OK)
+    {
+      finfo("ERROR rpcclnt_send failed: %d\n", error);
+    }
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: rpcclnt_recvreply
+ *
+ * Description:
+ *   Wait for the reply to any one of 'nxids' outstanding calls sent with
+ *   rpcclnt_sendcall().  The index of the call in 'xids' is returned in
+ *   'index'.  On a timeout, rc_timeout is set in the RPC client structure
+ *   and the caller may re-transmit the outstanding calls.
+ *
+ *   On successful receipt, it verifies the RPC level of the returned values.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.  'index' is valid
+ *   on success and on RPC level errors (i.e., whenever a reply was
+ *   received).
+ *
+ ****************************************************************************/
+
+int rpcclnt_recvreply(FAR struct rpcclnt *rpc, FAR const uint32_t *xids,
+                      int nxids, FAR void *response, size_t resplen,
+                      FAR int *index)
+{
+  int error;
+
+  rpc->rc_timeout = false;
+  error = rpcclnt_reply(rpc, xids, nxids, response, resplen, index);
+  if (error != OK)
+    {
+      finfo("ERROR rpcclnt_reply failed: %d\n", error);
+      if (rpc->rc_timeout)
+        {
+          rpc_statistics(rpctimeouts);
+        }
+
+      return error;
+    }
+
+  return rpcclnt_checkreply(response);
+}
+
+/****************************************************************************
+ * Name: rpcclnt_request
+ *
+ * Description:
+ *   Perform the RPC request.  Logic formats the RPC CALL message and calls
+ *   rpcclnt_sendcall to send the RPC CALL message.  It then calls
+ *   rpcclnt_recvreply() to get the response.  It may attempt to re-send the
+ *   CALL message on certain errors.
+ *
+ *   On successful receipt, it verifies the RPC level of the returned values.
+ *   (There may still be be NFS layer errors that will be deted by calling
+ *   logic).
+ *
+ ****************************************************************************/
+
+int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
+                    int version, FAR void *request, size_t reqlen,
+                    FAR void *response, size_t resplen)
+{
+  uint32_t xid = 0;
+  int retries;
+  int index;
+  int error = 0;
 
   /* Send the RPC call messsages and receive the RPC response.  A limited
    * number of re-tries will be attempted, but only for the case of response
-   * timeouts.
+   * timeouts.  Re-transmissions use the same xid.
    */
 
   retries = 0;
   do
     {
-      /* Do the client side RPC. */
-
-      rpc_statistics(rpcrequests);
-      rpc->rc_timeout = false;
-
       /* Send the RPC CALL message */
 
-      error = rpcclnt_send(rpc, procnum, prog, request, reqlen);
-      if (error != OK)
-        {
-          finfo("ERROR rpcclnt_send failed: %d\n", error);
-        }
+      rpc->rc_timeout = false;
+      error = rpcclnt_sendcall(rpc, procnum, prog, version, request, reqlen,
+                               &xid);
 
       /* Wait for the reply from our send */
 
-      else
+      if (error == OK)
         {
-          error = rpcclnt_reply(rpc, procnum, prog, response, resplen);
-          if (error != OK)
-            {
-              finfo("ERROR rpcclnt_reply failed: %d\n", error);
-            }
+          error = rpcclnt_recvreply(rpc, &xid, 1, response, resplen,
+                                    &index);
         }
 
       retries++;
@@ -755,51 +903,7 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
   if (error != OK)
     {
       ferr("ERROR: RPC failed: %d\n", error);
-      return error;
     }
 
-  /* Break down the RPC header and check if it is OK */
-
-  replymsg = (FAR struct rpc_reply_header *)response;
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp == RPC_MSGDENIED)
-    {
-      tmp = fxdr_unsigned(uint32_t, replymsg->status);
-      switch (tmp)
-        {
-        case RPC_MISMATCH:
-          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
-          return EOPNOTSUPP;
-
-        case RPC_AUTHERR:
-          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
-          return EACCES;
-
-        default:
-          return EOPNOTSUPP;
-        }
-    }
-  else if (tmp != RPC_MSGACCEPTED)
-    {
-      return EOPNOTSUPP;
-    }
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
-    {
-      finfo("RPC_SUCCESS\n");
-    }
-  else if (tmp == RPC_PROGMISMATCH)
-    {
-      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
-      return EOPNOTSUPP;
-    }
-  else if (tmp > 5)
-    {
-      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
-      return EOPNOTSUPP;
-    }
-
-  return OK;
+  return error;
 }
@@ -284,6 +284,16 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+#ifdef CONFIG_NXFFS_INDEX
+/* One entry of the in-memory inode index */
+
+struct nxffs_idxentry_s
+{
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+  uint32_t                  hash;      /* Hash of the inode name */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -302,6 +312,13 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_idxentry_s *index;  /* Valid inodes, sorted by hoffset */
+  int                       nindex;    /* Number of entries in the index */
+  int                       nalloc;    /* Number of entries allocated */
+  bool                      idxvalid;  /* The index may be used */
+  bool                      idxstale;  /* The index must be rebuilt */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -640,6 +657,96 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
 int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
                     FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_idxreset, nxffs_idxadd, nxffs_idxremove, and nxffs_idxupdate
+ *
+ * Description:
+ *   Maintain the optional, in-memory index of valid inodes.
+ *
+ *   nxffs_idxreset()  - Empty the index before building it from scratch.
+ *   nxffs_idxadd()    - Add a valid inode.
+ *   nxffs_idxremove() - Remove a deleted inode.
+ *   nxffs_idxstale()  - Inodes have moved; rebuild the index before it is
+ *                       next used for a look-up.
+ *   nxffs_idxupdate() - Rebuild the index by scanning the volume if it is
+ *                       stale.
+ *
+ *   If memory for the index cannot be allocated, the index is disabled
+ *   and the FLASH is searched until it is rebuilt.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_idxreset(FAR struct nxffs_volume_s *volume);
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume,
+                  FAR const struct nxffs_entry_s *entry);
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+#  define nxffs_idxstale(v) ((v)->idxstale = true)
+void nxffs_idxupdate(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_idxreset(v)
+#  define nxffs_idxadd(v,e)
+#  define nxffs_idxremove(v,h)
+#  define nxffs_idxstale(v)
+#  define nxffs_idxupdate(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Use the index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the FLASH
+ *   must be searched instead.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_nextinode
+ *
+ * Description:
+ *   Like nxffs_nextentry(), but use the index (if it is usable) to skip
+ *   directly to the next valid inode header instead of searching the FLASH
+ *   for it.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   offset - The FLASH memory offset to begin searching.
+ *   entry  - A pointer to memory provided by the caller in which to return
+ *     the inode description.
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_nextinode(FAR struct nxffs_volume_s *volume, off_t offset,
+                    FAR struct nxffs_entry_s *entry);
+#else
+#  define nxffs_nextinode(v,o,e) nxffs_nextentry(v,o,e)
+#endif
+
 /****************************************************************************
  * Name: nxffs_inodeend
  *
@@ -136,8 +136,9 @@ int nxffs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
 
   /* Read the next inode header from the offset */
 
+  nxffs_idxupdate(volume);
   offset = dir->u.nxffs.nx_offset;
-  ret = nxffs_nextentry(volume, offset, &entry);
+  ret = nxffs_nextinode(volume, offset, &entry);
 
   /* If the read was successful, then handle the reported inode.  Note
    * that when the last inode has been reported, the value -ENOENT will
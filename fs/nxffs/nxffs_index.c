@@ -0,0 +1,419 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <crc32.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The index is allocated in increments of this many entries */
+
+#define NXFFS_INDEX_INCR 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxhash
+ *
+ * Description:
+ *   Return the hash of an inode name that is kept in the index.
+ *
+ ****************************************************************************/
+
+static inline uint32_t nxffs_idxhash(FAR const char *name)
+{
+  return crc32((FAR const uint8_t *)name, strlen(name));
+}
+
+/****************************************************************************
+ * Name: nxffs_idxsearch
+ *
+ * Description:
+ *   Return the position of the first index entry whose inode header lies
+ *   at or after the given FLASH offset.
+ *
+ ****************************************************************************/
+
+static int nxffs_idxsearch(FAR struct nxffs_volume_s *volume, off_t offset)
+{
+  int low  = 0;
+  int high = volume->nindex;
+
+  while (low < high)
+    {
+      int mid = (low + high) >> 1;
+      if (volume->index[mid].hoffset < offset)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxdisable
+ *
+ * Description:
+ *   The index is out of memory or does not agree with the FLASH.  Fall back
+ *   to searching the FLASH until the index is rebuilt.
+ *
+ ****************************************************************************/
+
+static void nxffs_idxdisable(FAR struct nxffs_volume_s *volume)
+{
+  fwarn("WARNING: Disabling the inode index\n");
+  volume->idxvalid = false;
+  volume->idxstale = true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxreset
+ *
+ * Description:
+ *   Empty the inode index in preparation for building it from scratch.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxreset(FAR struct nxffs_volume_s *volume)
+{
+  volume->nindex   = 0;
+  volume->idxvalid = true;
+  volume->idxstale = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxadd
+ *
+ * Description:
+ *   Add a valid inode to the index.  The index is kept sorted by the FLASH
+ *   offset of the inode header.  If memory for the index cannot be
+ *   allocated, then the index is disabled.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume,
+                  FAR const struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_idxentry_s *index;
+  int pos;
+
+  if (!volume->idxvalid)
+    {
+      return;
+    }
+
+  /* Make room for one more entry */
+
+  if (volume->nindex >= volume->nalloc)
+    {
+      index = (FAR struct nxffs_idxentry_s *)
+        kmm_realloc(volume->index, (volume->nalloc + NXFFS_INDEX_INCR) *
+                    sizeof(struct nxffs_idxentry_s));
+      if (index == NULL)
+        {
+          ferr("ERROR: Failed to grow the inode index\n");
+          nxffs_idxdisable(volume);
+          return;
+        }
+
+      volume->index   = index;
+      volume->nalloc += NXFFS_INDEX_INCR;
+    }
+
+  /* New inodes are normally written at the end of FLASH so this is almost
+   * always an append.
+   */
+
+  pos = nxffs_idxsearch(volume, entry->hoffset);
+  if (pos < volume->nindex && volume->index[pos].hoffset == entry->hoffset)
+    {
+      volume->index[pos].hash = nxffs_idxhash(entry->name);
+      return;
+    }
+
+  memmove(&volume->index[pos + 1], &volume->index[pos],
+          (volume->nindex - pos) * sizeof(struct nxffs_idxentry_s));
+
+  volume->index[pos].hoffset = entry->hoffset;
+  volume->index[pos].hash    = nxffs_idxhash(entry->name);
+  volume->nindex++;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxremove
+ *
+ * Description:
+ *   Remove a deleted inode from the index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   hoffset - FLASH offset to the inode header
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int pos;
+
+  if (!volume->idxvalid)
+    {
+      return;
+    }
+
+  pos = nxffs_idxsearch(volume, hoffset);
+  if (pos < volume->nindex && volume->index[pos].hoffset == hoffset)
+    {
+      volume->nindex--;
+      memmove(&volume->index[pos], &volume->index[pos + 1],
+              (volume->nindex - pos) * sizeof(struct nxffs_idxentry_s));
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxupdate
+ *
+ * Description:
+ *   If inodes have been moved (by packing) or the index was disabled, then
+ *   rebuild the index by scanning the volume.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_idxupdate(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  if (!volume->idxstale)
+    {
+      return;
+    }
+
+  finfo("Rebuilding the inode index\n");
+  nxffs_idxreset(volume);
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
+    {
+      nxffs_idxadd(volume, &entry);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+
+  /* -ENOENT just means that the end of the inodes was reached */
+
+  if (ret != -ENOENT)
+    {
+      ferr("ERROR: nxffs_nextentry failed: %d\n", -ret);
+      volume->idxvalid = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Use the index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the FLASH
+ *   must be searched instead.
+ *
+ ****************************************************************************/
+
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash;
+  off_t hoffset;
+  int ret;
+  int i;
+
+  if (!volume->idxvalid)
+    {
+      return -ENOSYS;
+    }
+
+  hash = nxffs_idxhash(name);
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hash != hash)
+        {
+          continue;
+        }
+
+      /* The inode header must be exactly where the index says it is */
+
+      hoffset = volume->index[i].hoffset;
+      ret = nxffs_nextentry(volume, hoffset, entry);
+      if (ret < 0)
+        {
+          nxffs_idxdisable(volume);
+          return -ENOSYS;
+        }
+
+      if (entry->hoffset != hoffset)
+        {
+          nxffs_freeentry(entry);
+          nxffs_idxdisable(volume);
+          return -ENOSYS;
+        }
+
+      if (strcmp(name, entry->name) == 0)
+        {
+          return OK;
+        }
+
+      /* A hash collision */
+
+      nxffs_freeentry(entry);
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nxffs_nextinode
+ *
+ * Description:
+ *   Like nxffs_nextentry(), but use the index (if it is usable) to skip
+ *   directly to the next valid inode header instead of searching the FLASH
+ *   for it.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   offset - The FLASH memory offset to begin searching.
+ *   entry  - A pointer to memory provided by the caller in which to return
+ *     the inode description.
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_nextinode(FAR struct nxffs_volume_s *volume, off_t offset,
+                    FAR struct nxffs_entry_s *entry)
+{
+  off_t hoffset;
+  int pos;
+  int ret;
+
+  if (volume->idxvalid)
+    {
+      pos = nxffs_idxsearch(volume, offset);
+      if (pos >= volume->nindex)
+        {
+          return -ENOENT;
+        }
+
+      hoffset = volume->index[pos].hoffset;
+      ret = nxffs_nextentry(volume, hoffset, entry);
+      if (ret == OK)
+        {
+          if (entry->hoffset == hoffset)
+            {
+              return OK;
+            }
+
+          nxffs_freeentry(entry);
+        }
+
+      /* The index does not agree with the FLASH.  Search instead. */
+
+      nxffs_idxdisable(volume);
+    }
+
+  return nxffs_nextentry(volume, offset, entry);
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -313,6 +313,13 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ferr("ERROR: Failed to calculate file system limits: %d\n", -ret);
 
 errout_with_buffer:
+#ifdef CONFIG_NXFFS_INDEX
+  if (volume->index != NULL)
+    {
+      kmm_free(volume->index);
+    }
+
+#endif
   kmm_free(volume->pack);
 errout_with_cache:
   kmm_free(volume->cache);
@@ -367,8 +374,11 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
-  /* Then find the first valid inode in or beyond the first valid block */
+  /* Then find the first valid inode in or beyond the first valid block.
+   * The inode index is rebuilt as the inodes are found.
+   */
 
+  nxffs_idxreset(volume);
   offset = block * volume->geo.blocksize;
   ret = nxffs_nextentry(volume, offset, &entry);
   if (ret < 0)
@@ -402,6 +412,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
 
       /* Discard this entry and set the next offset. */
 
+      nxffs_idxadd(volume, &entry);
       offset = nxffs_inodeend(volume, &entry);
       nxffs_freeentry(&entry);
     }
@@ -414,6 +425,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
         {
           /* Discard the entry and guess the next offset. */
 
+          nxffs_idxadd(volume, &entry);
           offset = nxffs_inodeend(volume, &entry);
           nxffs_freeentry(&entry);
         }
@@ -378,6 +378,17 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Use the in-memory index if we can */
+
+  nxffs_idxupdate(volume);
+  ret = nxffs_idxfind(volume, name, entry);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -902,6 +902,10 @@ static inline int nxffs_wrclose(FAR struct nxffs_volume_s *volume,
   /* Write the inode header to FLASH */
 
   ret = nxffs_wrinode(volume, &wrfile->ofile.entry);
+  if (ret >= 0)
+    {
+      nxffs_idxadd(volume, &wrfile->ofile.entry);
+    }
 
   /* The volume is now available for other writers */
 
@@ -228,7 +228,7 @@ static inline off_t nxffs_mediacheck(FAR struct nxffs_volume_s *volume,
 
   /* Get the offset to the first valid inode entry after this free offset */
 
-  ret = nxffs_nextentry(volume, froffset, &pack->src.entry);
+  ret = nxffs_nextinode(volume, froffset, &pack->src.entry);
   if (ret < 0)
     {
       /* No valid entries on the media -- Return offset zero */
@@ -368,7 +368,7 @@ static inline int nxffs_startpos(FAR struct nxffs_volume_s *volume,
 
       /* Get the offset to the next valid inode entry */
 
-      ret = nxffs_nextentry(volume, offset, &pack->src.entry);
+      ret = nxffs_nextinode(volume, offset, &pack->src.entry);
       if (ret < 0)
         {
           /* No more valid inode entries.  Just return an end-of-flash error
@@ -956,7 +956,7 @@ static inline int nxffs_packblock(FAR struct nxffs_volume_s *volume,
           offset = pack->src.blkoffset + pack->src.blklen;
           memset(&pack->src, 0, sizeof(struct nxffs_packstream_s));
 
-          ret = nxffs_nextentry(volume, offset, &pack->src.entry);
+          ret = nxffs_nextinode(volume, offset, &pack->src.entry);
           if (ret < 0)
             {
               /* No more valid inode entries.  Just return an end-of-flash error
@@ -1274,6 +1274,14 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   int i;
   int ret = OK;
 
+  /* The inode index (if any) is used to find the source inodes.  Make sure
+   * that it is current; the inodes will all move, so it will have to be
+   * rebuilt afterward.
+   */
+
+  nxffs_idxupdate(volume);
+  nxffs_idxstale(volume);
+
   /* Get the offset to the first valid inode entry */
 
   wrfile = NULL;
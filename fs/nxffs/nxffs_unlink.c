@@ -130,6 +130,10 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+  else
+    {
+      nxffs_idxremove(volume, entry.hoffset);
+    }
 
 errout_with_entry:
   nxffs_freeentry(&entry);
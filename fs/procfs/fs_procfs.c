@@ -77,11 +77,14 @@
  ****************************************************************************/
 
 extern const struct procfs_operations proc_operations;
+extern const struct procfs_operations boottime_operations;
 extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations critmon_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations slabinfo_operations;
+extern const struct procfs_operations tasks_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
 
@@ -91,6 +94,9 @@ extern const struct procfs_operations version_operations;
  * configuration.
  */
 
+extern const struct procfs_operations bench_procfsoperations;
+extern const struct procfs_operations crypto_procfsoperations;
+extern const struct procfs_operations lockstat_operations;
 extern const struct procfs_operations net_procfsoperations;
 extern const struct procfs_operations net_procfs_routeoperations;
 extern const struct procfs_operations part_procfsoperations;
@@ -122,6 +128,18 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",        &proc_operations,            PROCFS_DIR_TYPE    },
 #endif
 
+#if defined(CONFIG_SCHED_BENCH) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BENCH)
+  { "bench",         &bench_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_BOOTTIME) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME)
+  { "boottime",      &boottime_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_CRYPTO_BENCHMARK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CRYPTO)
+  { "crypto",        &crypto_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -130,10 +148,22 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "critmon",       &critmon_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM)
+  { "crithist",      &critmon_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  { "irqhist",       &irq_operations,             PROCFS_FILE_TYPE   },
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
   { "irqs",          &irq_operations,             PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+  { "lockstat",      &lockstat_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
   { "meminfo",       &meminfo_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -171,11 +201,19 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "partitions",    &part_procfsoperations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_SLAB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SLABINFO)
+  { "slabinfo",      &slabinfo_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",          &proc_operations,            PROCFS_DIR_TYPE    },
   { "self/**",       &proc_operations,            PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKS
+  { "tasks",         &tasks_operations,           PROCFS_FILE_TYPE   },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",        &uptime_operations,          PROCFS_FILE_TYPE   },
 #endif
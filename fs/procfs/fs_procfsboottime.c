@@ -0,0 +1,327 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsboottime.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/boottime.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SCHED_BOOTTIME) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOTTIME_LINELEN (CONFIG_SCHED_BOOTTIME_NAMELEN + 40)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct boottime_file_s
+{
+  struct procfs_file_s  base;        /* Base open file structure */
+  char line[BOOTTIME_LINELEN];       /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     boottime_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     boottime_close(FAR struct file *filep);
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     boottime_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     boottime_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations boottime_operations =
+{
+  boottime_open,     /* open */
+  boottime_close,    /* close */
+  boottime_read,     /* read */
+  NULL,              /* write */
+
+  boottime_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  boottime_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_open
+ ****************************************************************************/
+
+static int boottime_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct boottime_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "boottime" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "boottime") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct boottime_file_s *)
+    kmm_zalloc(sizeof(struct boottime_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_close
+ ****************************************************************************/
+
+static int boottime_close(FAR struct file *filep)
+{
+  FAR struct boottime_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct boottime_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_read
+ *
+ * Description:
+ *   Show one line per boot time mark:  The name of the stage, the time of
+ *   its completion relative to the first mark, and the time since the
+ *   previous mark (i.e., the duration of the stage), both in microseconds.
+ *   The marks are recorded once, so the content is stable between reads.
+ *
+ ****************************************************************************/
+
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct boottime_file_s *attr;
+  FAR const char *name;
+  struct timespec ts;
+  unsigned long prev;
+  unsigned long usec;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct boottime_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  linesize  = snprintf(attr->line, BOOTTIME_LINELEN, "%-*s %12s %12s\n",
+                       CONFIG_SCHED_BOOTTIME_NAMELEN - 1, "STAGE",
+                       "TIME(us)", "DELTA(us)");
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+  totalsize = copysize;
+  prev      = 0;
+
+  for (i = 0; totalsize < buflen && boottime_get(i, &name, &ts) == OK; i++)
+    {
+      usec      = (unsigned long)ts.tv_sec * USEC_PER_SEC +
+                  ts.tv_nsec / NSEC_PER_USEC;
+      linesize  = snprintf(attr->line, BOOTTIME_LINELEN, "%-*s %12lu %12lu\n",
+                           CONFIG_SCHED_BOOTTIME_NAMELEN - 1, name, usec,
+                           usec - prev);
+      copysize  = procfs_memcpy(attr->line, linesize, &buffer[totalsize],
+                                buflen - totalsize, &offset);
+      totalsize += copysize;
+      prev      = usec;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: boottime_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int boottime_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct boottime_file_s *oldattr;
+  FAR struct boottime_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct boottime_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct boottime_file_s *)
+    kmm_malloc(sizeof(struct boottime_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct boottime_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int boottime_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "boottime" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "boottime") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "boottime" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SCHED_BOOTTIME && !CONFIG_FS_PROCFS_EXCLUDE_BOOTTIME */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
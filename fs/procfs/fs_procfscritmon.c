@@ -55,6 +55,8 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -82,6 +84,9 @@ struct critmon_file_s
 {
   struct procfs_file_s  base;   /* Base open file structure */
   unsigned int linesize;        /* Number of valid characters in line[] */
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  bool hist;                    /* True: "crithist", false: "critmon" */
+#endif
   char line[CRITMON_LINELEN];   /* Pre-allocated buffer for formatted lines */
 };
 
@@ -100,6 +105,15 @@ void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Helpers */
+
+static bool    critmon_isfile(FAR const char *relpath);
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t crithist_read_cpu(FAR struct critmon_file_s *attr,
+                 FAR char *buffer, size_t buflen, FAR off_t *offset,
+                 int cpu);
+#endif
+
 /* File system methods */
 
 static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
@@ -141,6 +155,26 @@ const struct procfs_operations critmon_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: critmon_isfile
+ *
+ * Description:
+ *   Return true if relpath is one of the files provided here.
+ *
+ ****************************************************************************/
+
+static bool critmon_isfile(FAR const char *relpath)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  if (strcmp(relpath, "crithist") == 0)
+    {
+      return true;
+    }
+#endif
+
+  return strcmp(relpath, "critmon") == 0;
+}
+
 /****************************************************************************
  * Name: critmon_open
  ****************************************************************************/
@@ -164,9 +198,11 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       return -EACCES;
     }
 
-  /* "critmon" is the only acceptable value for the relpath */
+  /* "critmon" and "crithist" are the only acceptable values for the
+   * relpath
+   */
 
-  if (strcmp(relpath, "critmon") != 0)
+  if (!critmon_isfile(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
@@ -181,6 +217,10 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  attr->hist = (strcmp(relpath, "crithist") == 0);
+#endif
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)attr;
@@ -221,6 +261,15 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   size_t copysize;
   size_t totalsize;
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  /* Is this the histogram file? */
+
+  if (attr->hist)
+    {
+      return crithist_read_cpu(attr, buffer, buflen, offset, cpu);
+    }
+#endif
+
   remaining = buflen;
   totalsize = 0;
 
@@ -283,6 +332,106 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: crithist_read_hist
+ *
+ * Description:
+ *   Generate one line for each non-empty bucket of a histogram:
+ *
+ *     <cpu>,<kind>,<limit>,<count>,<max>,<site>
+ *
+ *   <kind> is "premp" for pre-emption disabled or "crit" for a critical
+ *   section.  <limit> is the upper limit of the bucket in nanoseconds (or
+ *   "inf" for the last bucket).  <max> is the longest duration in the
+ *   bucket in seconds and <site> is the address from which sched_lock() or
+ *   enter_critical_section() was called for that longest duration.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t crithist_read_hist(FAR struct critmon_file_s *attr,
+                                  FAR char *buffer, size_t buflen,
+                                  FAR off_t *offset, int cpu,
+                                  FAR const char *kind,
+                                  FAR struct critmon_hist_s *hist)
+{
+  struct critmon_hist_s bucket;
+  struct timespec maxtime;
+  irqstate_t flags;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  char limit[12];
+  int i;
+
+  totalsize = 0;
+
+  for (i = 0; i < SCHED_HIST_NBUCKETS && totalsize < buflen; i++)
+    {
+      /* Take a snapshot and reset the bucket */
+
+      flags = enter_critical_section();
+      memcpy(&bucket, &hist[i], sizeof(struct critmon_hist_s));
+      memset(&hist[i], 0, sizeof(struct critmon_hist_s));
+      leave_critical_section(flags);
+
+      if (bucket.count == 0)
+        {
+          continue;
+        }
+
+      if (i < SCHED_HIST_NBUCKETS - 1)
+        {
+          (void)snprintf(limit, sizeof(limit), "%lu",
+                         1ul << (SCHED_HIST_SHIFT + i));
+        }
+      else
+        {
+          strcpy(limit, "inf");
+        }
+
+      up_critmon_convert(bucket.max, &maxtime);
+
+      linesize = snprintf(attr->line, CRITMON_LINELEN,
+                          "%d,%s,%s,%lu,%lu.%09lu,%08lx\n",
+                          cpu, kind, limit, (unsigned long)bucket.count,
+                          (unsigned long)maxtime.tv_sec,
+                          (unsigned long)maxtime.tv_nsec,
+                          (unsigned long)((uintptr_t)bucket.site));
+      copysize = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                               buflen - totalsize, offset);
+
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: crithist_read_cpu
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t crithist_read_cpu(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset, int cpu)
+{
+  size_t totalsize;
+
+  totalsize = crithist_read_hist(attr, buffer, buflen, offset, cpu,
+                                 "premp", g_premp_hist[cpu]);
+  if (totalsize < buflen)
+    {
+      totalsize += crithist_read_hist(attr, buffer + totalsize,
+                                      buflen - totalsize, offset, cpu,
+                                      "crit", g_crit_hist[cpu]);
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -386,15 +535,17 @@ static int critmon_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int critmon_stat(const char *relpath, struct stat *buf)
 {
-  /* "critmon" is the only acceptable value for the relpath */
+  /* "critmon" and "crithist" are the only acceptable values for the
+   * relpath
+   */
 
-  if (strcmp(relpath, "critmon") != 0)
+  if (!critmon_isfile(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
     }
 
-  /* "critmon" is the name for a read-only file */
+  /* Both are the names of read-only files */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
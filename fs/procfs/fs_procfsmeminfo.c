@@ -56,6 +56,7 @@
 #include <nuttx/pgalloc.h>
 #include <nuttx/progmem.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -83,6 +84,19 @@ struct meminfo_file_s
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
 };
 
+/* This structure is used with the place_foreach() callback */
+
+#ifdef CONFIG_MM_PLACE
+struct meminfo_place_s
+{
+  FAR struct meminfo_file_s *procfile;
+  FAR char *buffer;
+  size_t buflen;
+  off_t offset;
+  size_t totalsize;
+};
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 struct progmem_info_s
 {
@@ -140,6 +154,41 @@ const struct procfs_operations meminfo_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: meminfo_place
+ *
+ * Description:
+ *   The place_foreach() callback that shows the usage of one named heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PLACE
+static void meminfo_place(FAR const struct placeinfo_s *info, FAR void *arg)
+{
+  FAR struct meminfo_place_s *rd = (FAR struct meminfo_place_s *)arg;
+  char label[8];
+  size_t linesize;
+  size_t copysize;
+
+  if (rd->totalsize >= rd->buflen)
+    {
+      return;
+    }
+
+  snprintf(label, sizeof(label), "%.5s:", info->name);
+  linesize       = snprintf(rd->procfile->line, MEMINFO_LINELEN,
+                            "%-7s%11lu%11lu%11lu%11lu\n", label,
+                            (unsigned long)info->arena,
+                            (unsigned long)info->used,
+                            (unsigned long)info->free,
+                            (unsigned long)info->largest);
+  copysize       = procfs_memcpy(rd->procfile->line, linesize, rd->buffer,
+                                 rd->buflen - rd->totalsize, &rd->offset);
+  rd->buffer    += copysize;
+  rd->totalsize += copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_progmem
  *
@@ -355,6 +404,30 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+#ifdef CONFIG_MM_PLACE
+  if (totalsize < buflen)
+    {
+      struct meminfo_place_s rd;
+
+      buffer      += copysize;
+      buflen      -= copysize;
+
+      /* Show the usage of each named heap */
+
+      rd.procfile  = procfile;
+      rd.buffer    = buffer;
+      rd.buflen    = buflen;
+      rd.offset    = offset;
+      rd.totalsize = 0;
+
+      place_foreach(meminfo_place, &rd);
+
+      offset       = rd.offset;
+      copysize     = rd.totalsize;
+      totalsize   += copysize;
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (totalsize < buflen)
     {
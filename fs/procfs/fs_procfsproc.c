@@ -61,12 +61,14 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/environ.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
 
-#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR)
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_RUNTIME)
 #  include <nuttx/clock.h>
 #endif
 
@@ -92,7 +94,17 @@
  * to handle the longest line generated by this logic.
  */
 
-#define STATUS_LINELEN 32
+#ifdef CONFIG_MM_OWNER
+#  define STATUS_LINELEN 48
+#else
+#  define STATUS_LINELEN 32
+#endif
+
+/* The number of distinct call sites reported in /proc/<pid>/heap.  The
+ * allocations from any further call sites are summarized as "Other".
+ */
+
+#define HEAP_NCALLERS  16
 
 /****************************************************************************
  * Private Type Definitions
@@ -112,8 +124,17 @@ enum proc_node_e
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
+#endif
+#ifdef CONFIG_SCHED_RUNTIME
+  PROC_STAT,                          /* Run time statistics */
+#endif
+#ifdef CONFIG_SCHED_PMU
+  PROC_PMU,                           /* Performance counters */
 #endif
   PROC_STACK,                         /* Task stack info */
+#ifdef CONFIG_MM_OWNER
+  PROC_HEAP,                          /* Task heap usage */
+#endif
   PROC_GROUP,                         /* Group directory */
   PROC_GROUP_STATUS,                  /* Task group status */
   PROC_GROUP_FD                       /* Group file descriptors */
@@ -165,6 +186,27 @@ struct proc_envinfo_s
   size_t totalsize;
 };
 
+/* This structure is used with the mm_foreach() callback */
+
+#ifdef CONFIG_MM_OWNER
+struct proc_heapcaller_s
+{
+  FAR void *caller;                   /* Return address of the allocation */
+  size_t nchunks;                     /* Number of chunks from this caller */
+  size_t nbytes;                      /* Size of those chunks */
+};
+
+struct proc_heapinfo_s
+{
+  pid_t pid;                          /* The task whose chunks are counted */
+  size_t nchunks;                     /* Chunks in the current heap */
+  size_t nbytes;                      /* Bytes in the current heap */
+  uint8_t ncallers;                   /* Entries used in caller[] */
+  struct proc_heapcaller_s caller[HEAP_NCALLERS];
+  struct proc_heapcaller_s other;     /* All remaining callers */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -212,9 +254,26 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_RUNTIME
+static ssize_t proc_runstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
+#ifdef CONFIG_SCHED_PMU
+static ssize_t proc_pmu(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
+#ifdef CONFIG_MM_OWNER
+static void    proc_heap_callback(FAR struct mm_allocnode_s *node,
+                 FAR void *arg);
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -307,11 +366,32 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_RUNTIME
+static const struct proc_node_s g_stat =
+{
+  "stat",          "stat",    (uint8_t)PROC_STAT,        DTYPE_FILE        /* Run time statistics */
+};
+#endif
+
+#ifdef CONFIG_SCHED_PMU
+static const struct proc_node_s g_pmu =
+{
+  "pmu",           "pmu",     (uint8_t)PROC_PMU,         DTYPE_FILE        /* Performance counters */
+};
+#endif
+
 static const struct proc_node_s g_stack =
 {
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
 };
 
+#ifdef CONFIG_MM_OWNER
+static const struct proc_node_s g_heap =
+{
+  "heap",         "heap",    (uint8_t)PROC_HEAP,         DTYPE_FILE        /* Task heap usage */
+};
+#endif
+
 static const struct proc_node_s g_group =
 {
   "group",        "group",   (uint8_t)PROC_GROUP,        DTYPE_DIRECTORY   /* Group directory */
@@ -346,8 +426,17 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
+#endif
+#ifdef CONFIG_SCHED_RUNTIME
+  &g_stat,         /* Run time statistics */
+#endif
+#ifdef CONFIG_SCHED_PMU
+  &g_pmu,          /* Performance counters */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_OWNER
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
   &g_groupstatus,  /* Task group status */
   &g_groupfd       /* Group file descriptors */
@@ -369,8 +458,17 @@ static const struct proc_node_s * const g_level0info[] =
 #endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
+#endif
+#ifdef CONFIG_SCHED_RUNTIME
+  &g_stat,         /* Run time statistics */
+#endif
+#ifdef CONFIG_SCHED_PMU
+  &g_pmu,          /* Performance counters */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_OWNER
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
 };
 #define PROC_NLEVEL0NODES (sizeof(g_level0info)/sizeof(FAR const struct proc_node_s * const))
@@ -861,6 +959,144 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_runstat
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUNTIME
+static ssize_t proc_runstat(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  uint64_t runtime;
+  uint64_t irqtime;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  sched_runtime_get(tcb, &runtime, &irqtime);
+
+  /* Show the execution time of the thread, less interrupt handling */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%09lu\n",
+                      "RunTime:",
+                      (unsigned long)(runtime / NSEC_PER_SEC),
+                      (unsigned long)(runtime % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the time spent in interrupt handlers while the thread ran */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%09lu\n",
+                      "IrqTime:",
+                      (unsigned long)(irqtime / NSEC_PER_SEC),
+                      (unsigned long)(irqtime % NSEC_PER_SEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of voluntary context switches */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                      "Voluntary:", (unsigned long)tcb->nvcsw);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of times that the thread was preempted */
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                      "Preempted:", (unsigned long)tcb->nivcsw);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_pmu
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+static ssize_t proc_pmu(FAR struct proc_file_s *procfile,
+                        FAR struct tcb_s *tcb, FAR char *buffer,
+                        size_t buflen, off_t offset)
+{
+  uint64_t counts[CONFIG_SCHED_PMU_NCOUNTERS];
+  FAR const char *name;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  sched_pmu_get(tcb, counts);
+
+  /* Show each counter that the hardware provides */
+
+  for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS; i++)
+    {
+      name = up_pmu_event(i);
+      if (name == NULL)
+        {
+          continue;
+        }
+
+      linesize = snprintf(procfile->line, STATUS_LINELEN, "%s:%*s%llu\n",
+                          name, (int)(strlen(name) < 15 ?
+                                      15 - strlen(name) : 1), "",
+                          (unsigned long long)counts[i]);
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -922,6 +1158,150 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_heap_callback
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_OWNER
+static void proc_heap_callback(FAR struct mm_allocnode_s *node,
+                               FAR void *arg)
+{
+  FAR struct proc_heapinfo_s *info = (FAR struct proc_heapinfo_s *)arg;
+  FAR struct proc_heapcaller_s *entry;
+  int i;
+
+  if (node->pid != info->pid)
+    {
+      return;
+    }
+
+  info->nchunks++;
+  info->nbytes += node->size;
+
+  /* Find or create the entry for this call site */
+
+  entry = &info->other;
+  for (i = 0; i < info->ncallers; i++)
+    {
+      if (info->caller[i].caller == node->caller)
+        {
+          entry = &info->caller[i];
+          break;
+        }
+    }
+
+  if (i >= info->ncallers && info->ncallers < HEAP_NCALLERS)
+    {
+      entry         = &info->caller[info->ncallers++];
+      entry->caller = node->caller;
+    }
+
+  entry->nchunks++;
+  entry->nbytes += node->size;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_heap
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_OWNER
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                         FAR struct tcb_s *tcb, FAR char *buffer,
+                         size_t buflen, off_t offset)
+{
+  struct proc_heapinfo_s info;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  memset(&info, 0, sizeof(struct proc_heapinfo_s));
+  info.pid = tcb->pid;
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  /* Show the kernel heap usage of the task */
+
+  kmm_foreach(proc_heap_callback, &info);
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu (%lu)\n",
+                        "Kmem:", (unsigned long)info.nbytes,
+                        (unsigned long)info.nchunks);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+#endif
+
+#ifndef CONFIG_BUILD_KERNEL
+  /* Show the user heap usage of the task */
+
+  info.nchunks = 0;
+  info.nbytes  = 0;
+
+  umm_foreach(proc_heap_callback, &info);
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu (%lu)\n",
+                        "Umem:", (unsigned long)info.nbytes,
+                        (unsigned long)info.nchunks);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+#endif
+
+  /* Then show the bytes (chunks) allocated from each call site.  This is
+   * the list to look at when the heap usage of a task keeps growing.
+   */
+
+  for (i = 0; i < info.ncallers; i++)
+    {
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+
+      linesize   = snprintf(procfile->line, STATUS_LINELEN,
+                            "  0x%p %lu (%lu)\n", info.caller[i].caller,
+                            (unsigned long)info.caller[i].nbytes,
+                            (unsigned long)info.caller[i].nchunks);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  if (info.other.nchunks > 0 && totalsize < buflen)
+    {
+      linesize   = snprintf(procfile->line, STATUS_LINELEN,
+                            "  %-10s %lu (%lu)\n", "Other",
+                            (unsigned long)info.other.nbytes,
+                            (unsigned long)info.other.nchunks);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -1096,11 +1476,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files; i < CONFIG_NFILE_DESCRIPTORS; i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_fget(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN, "%3d %8ld %04x\n",
                                 i, (long)file->f_pos, file->f_oflags);
@@ -1439,11 +1820,27 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
     case PROC_CRITMON: /* Critical section monitor */
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
+#endif
+#ifdef CONFIG_SCHED_RUNTIME
+    case PROC_STAT: /* Run time statistics */
+      ret = proc_runstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+#ifdef CONFIG_SCHED_PMU
+    case PROC_PMU: /* Performance counters */
+      ret = proc_pmu(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
 #endif
     case PROC_STACK: /* Task stack info */
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
+#ifdef CONFIG_MM_OWNER
+    case PROC_HEAP: /* Task heap usage */
+      ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
     case PROC_GROUP_STATUS: /* Task group status */
       ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
@@ -0,0 +1,360 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsslabinfo.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/slab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_MM_SLAB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SLABINFO)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SLABINFO_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct slabinfo_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[SLABINFO_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation as the caches are
+ * traversed.
+ */
+
+struct slabinfo_read_s
+{
+  FAR struct slabinfo_file_s *procfile;
+  FAR char *buffer;               /* User receive buffer */
+  size_t buflen;                  /* Size of the user receive buffer */
+  size_t totalsize;               /* Number of bytes transferred */
+  off_t offset;                   /* Number of bytes remaining to skip */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    slabinfo_line(FAR struct slabinfo_read_s *rd,
+                 size_t linesize);
+static void    slabinfo_cache(FAR const struct slabinfo_s *info,
+                 FAR void *arg);
+
+/* File system methods */
+
+static int     slabinfo_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     slabinfo_close(FAR struct file *filep);
+static ssize_t slabinfo_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     slabinfo_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     slabinfo_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations slabinfo_operations =
+{
+  slabinfo_open,   /* open */
+  slabinfo_close,  /* close */
+  slabinfo_read,   /* read */
+  NULL,            /* write */
+  slabinfo_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  slabinfo_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slabinfo_line
+ *
+ * Description:
+ *   Transfer one formatted line to the user buffer.
+ *
+ ****************************************************************************/
+
+static void slabinfo_line(FAR struct slabinfo_read_s *rd, size_t linesize)
+{
+  if (rd->totalsize < rd->buflen)
+    {
+      rd->totalsize += procfs_memcpy(rd->procfile->line, linesize,
+                                     rd->buffer + rd->totalsize,
+                                     rd->buflen - rd->totalsize,
+                                     &rd->offset);
+    }
+}
+
+/****************************************************************************
+ * Name: slabinfo_cache
+ *
+ * Description:
+ *   slab_foreach() callback.  Format the statistics of one cache.
+ *
+ ****************************************************************************/
+
+static void slabinfo_cache(FAR const struct slabinfo_s *info, FAR void *arg)
+{
+  FAR struct slabinfo_read_s *rd = (FAR struct slabinfo_read_s *)arg;
+  size_t linesize;
+
+  linesize = snprintf(rd->procfile->line, SLABINFO_LINELEN,
+                      "%-10s %7lu %6u %7lu %7lu %7lu %10lu %6lu\n",
+                      info->name, (unsigned long)info->objsize,
+                      (unsigned int)info->nslabs,
+                      (unsigned long)info->nused,
+                      (unsigned long)info->nfree,
+                      (unsigned long)info->hiwater,
+                      (unsigned long)info->nalloc,
+                      (unsigned long)info->nfail);
+
+  slabinfo_line(rd, linesize);
+}
+
+/****************************************************************************
+ * Name: slabinfo_open
+ ****************************************************************************/
+
+static int slabinfo_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct slabinfo_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "slabinfo" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "slabinfo") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct slabinfo_file_s *)
+    kmm_zalloc(sizeof(struct slabinfo_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_close
+ ****************************************************************************/
+
+static int slabinfo_close(FAR struct file *filep)
+{
+  FAR struct slabinfo_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct slabinfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_read
+ ****************************************************************************/
+
+static ssize_t slabinfo_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct slabinfo_read_s rd;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  rd.procfile  = (FAR struct slabinfo_file_s *)filep->f_priv;
+  rd.buffer    = buffer;
+  rd.buflen    = buflen;
+  rd.totalsize = 0;
+  rd.offset    = filep->f_pos;
+  DEBUGASSERT(rd.procfile);
+
+  /* The first line is the headers */
+
+  linesize = snprintf(rd.procfile->line, SLABINFO_LINELEN,
+                      "%-10s %7s %6s %7s %7s %7s %10s %6s\n",
+                      "name", "objsize", "slabs", "used", "free",
+                      "hiwater", "allocs", "fails");
+  slabinfo_line(&rd, linesize);
+
+  /* Followed by one line for each cache */
+
+  slab_foreach(slabinfo_cache, &rd);
+
+  /* Update the file offset */
+
+  filep->f_pos += rd.totalsize;
+  return rd.totalsize;
+}
+
+/****************************************************************************
+ * Name: slabinfo_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int slabinfo_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct slabinfo_file_s *oldattr;
+  FAR struct slabinfo_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct slabinfo_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct slabinfo_file_s *)
+    kmm_malloc(sizeof(struct slabinfo_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct slabinfo_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: slabinfo_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int slabinfo_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "slabinfo" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "slabinfo") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "slabinfo" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_MM_SLAB && !CONFIG_FS_PROCFS_EXCLUDE_SLABINFO */
@@ -0,0 +1,465 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstasks.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  There can never be more
+ * than CONFIG_MAX_TASKS tasks and threads, so the snapshot always fits.
+ */
+
+struct tasks_file_s
+{
+  struct procfs_file_s base;          /* Base open file structure */
+  size_t size;                        /* Size of the current snapshot */
+#ifdef CONFIG_MM_OWNER
+  int last;                           /* Record of the last heap chunk */
+#endif
+  struct procfs_taskhdr_s hdr;        /* The snapshot header ... */
+  struct procfs_taskstat_s rec[CONFIG_MAX_TASKS]; /* ... and records */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    tasks_collect(FAR struct tcb_s *tcb, FAR void *arg);
+#ifdef CONFIG_MM_OWNER
+static void    tasks_heap(FAR struct mm_allocnode_s *node, FAR void *arg);
+#endif
+static void    tasks_snapshot(FAR struct tasks_file_s *procfile);
+
+/* File system methods */
+
+static int     tasks_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     tasks_close(FAR struct file *filep);
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     tasks_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     tasks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations tasks_operations =
+{
+  tasks_open,      /* open */
+  tasks_close,     /* close */
+  tasks_read,      /* read */
+  NULL,            /* write */
+  tasks_dup,       /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  tasks_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tasks_collect
+ *
+ * Description:
+ *   sched_foreach() callback.  Copy the state of one task into the next
+ *   record.  This runs in a critical section so only the fields that can
+ *   be copied cheaply are collected here.
+ *
+ ****************************************************************************/
+
+static void tasks_collect(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct tasks_file_s *procfile = (FAR struct tasks_file_s *)arg;
+  FAR struct procfs_taskstat_s *rec;
+
+  if (procfile->hdr.nrecords >= CONFIG_MAX_TASKS)
+    {
+      return;
+    }
+
+  rec = &procfile->rec[procfile->hdr.nrecords++];
+  memset(rec, 0, sizeof(struct procfs_taskstat_s));
+
+  rec->pid       = tcb->pid;
+  rec->flags     = tcb->flags;
+  rec->state     = tcb->task_state;
+  rec->priority  = tcb->sched_priority;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  rec->basepriority = tcb->base_priority;
+#else
+  rec->basepriority = tcb->sched_priority;
+#endif
+#ifdef CONFIG_SMP
+  rec->cpu       = tcb->cpu;
+#endif
+#ifdef CONFIG_SCHED_RUNTIME
+  rec->nvcsw     = tcb->nvcsw;
+  rec->nivcsw    = tcb->nivcsw;
+#endif
+  rec->stacksize = tcb->adj_stack_size;
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  strncpy(rec->name, tcb->name, PROCFS_TASKSTAT_NAMELEN - 1);
+#endif
+}
+
+/****************************************************************************
+ * Name: tasks_heap
+ *
+ * Description:
+ *   umm_foreach() callback.  Charge one allocated chunk to the task that
+ *   owns it.  Chunks of one task tend to be allocated together so the
+ *   last match is tried first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_OWNER
+static void tasks_heap(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct tasks_file_s *procfile = (FAR struct tasks_file_s *)arg;
+  FAR struct procfs_taskstat_s *rec;
+  int i;
+
+  rec = &procfile->rec[procfile->last];
+  if (rec->pid != node->pid)
+    {
+      for (i = 0; i < procfile->hdr.nrecords; i++)
+        {
+          if (procfile->rec[i].pid == node->pid)
+            {
+              break;
+            }
+        }
+
+      if (i >= procfile->hdr.nrecords)
+        {
+          return;
+        }
+
+      procfile->last = i;
+      rec = &procfile->rec[i];
+    }
+
+  rec->heapused += node->size;
+  rec->heapchunks++;
+}
+#endif
+
+/****************************************************************************
+ * Name: tasks_snapshot
+ *
+ * Description:
+ *   Replace the snapshot held by the open file with the current state of
+ *   all tasks.
+ *
+ ****************************************************************************/
+
+static void tasks_snapshot(FAR struct tasks_file_s *procfile)
+{
+#if defined(CONFIG_STACK_COLORATION) || defined(CONFIG_SCHED_CPULOAD)
+  FAR struct tcb_s *tcb;
+  int i;
+#endif
+
+  procfile->hdr.version  = PROCFS_TASKSTAT_VERSION;
+  procfile->hdr.hdrsize  = sizeof(struct procfs_taskhdr_s);
+  procfile->hdr.recsize  = sizeof(struct procfs_taskstat_s);
+  procfile->hdr.nrecords = 0;
+  procfile->hdr.systime  = (uint32_t)clock_systimer();
+
+  /* Keep the tasks from exiting until the statistics that need the TCB
+   * have been collected.
+   */
+
+  sched_lock();
+  sched_foreach(tasks_collect, procfile);
+
+#if defined(CONFIG_STACK_COLORATION) || defined(CONFIG_SCHED_CPULOAD)
+  for (i = 0; i < procfile->hdr.nrecords; i++)
+    {
+      FAR struct procfs_taskstat_s *rec = &procfile->rec[i];
+
+      tcb = sched_gettcb((pid_t)rec->pid);
+      if (tcb == NULL)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_STACK_COLORATION
+      rec->stackused = up_check_tcbstack(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+      {
+        struct cpuload_s cpuload;
+
+        if (clock_cpuload(rec->pid, &cpuload) >= 0)
+          {
+            rec->cpuactive = cpuload.active;
+            rec->cputotal  = cpuload.total;
+          }
+      }
+#endif
+    }
+#endif
+
+  sched_unlock();
+
+#ifdef CONFIG_MM_OWNER
+  /* Charge the user heap to its owners in a single walk of the heap */
+
+  procfile->last = 0;
+  if (procfile->hdr.nrecords > 0)
+    {
+      umm_foreach(tasks_heap, procfile);
+    }
+#endif
+
+  procfile->size = sizeof(struct procfs_taskhdr_s) +
+                   procfile->hdr.nrecords * sizeof(struct procfs_taskstat_s);
+}
+
+/****************************************************************************
+ * Name: tasks_open
+ ****************************************************************************/
+
+static int tasks_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct tasks_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "tasks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "tasks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes and the snapshot */
+
+  procfile = (FAR struct tasks_file_s *)
+    kmm_zalloc(sizeof(struct tasks_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_close
+ ****************************************************************************/
+
+static int tasks_close(FAR struct file *filep)
+{
+  FAR struct tasks_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct tasks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_read
+ ****************************************************************************/
+
+static ssize_t tasks_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct tasks_file_s *procfile;
+  off_t offset;
+  size_t nbytes;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct tasks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Take a new snapshot when reading from the beginning of the file.
+   * Otherwise continue with the snapshot that is being read.
+   */
+
+  offset = filep->f_pos;
+  if (offset == 0 || procfile->size == 0)
+    {
+      tasks_snapshot(procfile);
+    }
+
+  nbytes = procfs_memcpy((FAR const char *)&procfile->hdr, procfile->size,
+                         buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  filep->f_pos += nbytes;
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: tasks_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int tasks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct tasks_file_s *oldattr;
+  FAR struct tasks_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct tasks_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct tasks_file_s *)
+    kmm_malloc(sizeof(struct tasks_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct tasks_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tasks_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int tasks_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "tasks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "tasks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "tasks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_FS_PROCFS_EXCLUDE_TASKS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
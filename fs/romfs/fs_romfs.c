@@ -1017,6 +1017,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Index the directories.  Without the index, look-ups just search the
+   * directories.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fwarn("WARNING: romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (FAR void *)rm;
@@ -1107,6 +1119,13 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+      if (rm->rm_index != NULL)
+        {
+          kmm_free(rm->rm_index);
+        }
+
+#endif
       nxsem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
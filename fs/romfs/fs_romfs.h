@@ -129,6 +129,17 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+/* This structure is one slot of the directory index hash table */
+
+struct romfs_idxentry_s
+{
+  uint32_t ie_dir;                  /* Offset to the directory first entry */
+  uint32_t ie_hash;                 /* Hash of ie_dir and the entry name */
+  uint32_t ie_offset;               /* File header offset (0: unused) */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -149,6 +160,10 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_INDEX
+  uint32_t rm_idxmask;              /* Directory index size minus one */
+  FAR struct romfs_idxentry_s *rm_index; /* Directory index (or NULL) */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -216,6 +231,9 @@ int  romfs_checkmount(FAR struct romfs_mountpt_s *rm);
 int  romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
        FAR struct romfs_dirinfo_s *dirinfo,
        FAR const char *path);
+#ifdef CONFIG_FS_ROMFS_INDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+#endif
 int  romfs_parsedirentry(FAR struct romfs_mountpt_s *rm,
        uint32_t offset, FAR uint32_t *poffset, FAR uint32_t *pnext,
        FAR uint32_t *pinfo, FAR uint32_t *psize);
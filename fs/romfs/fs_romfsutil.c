@@ -57,6 +57,14 @@
 
 #include "fs_romfs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The list of entries is allocated in increments of this many entries */
+
+#define ROMFS_INDEX_INCR 32
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -255,6 +263,153 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+/****************************************************************************
+ * Name: romfs_idxhash
+ *
+ * Description:
+ *   Hash the name of a directory entry together with the offset to the
+ *   first entry of the directory that contains it.
+ *
+ ****************************************************************************/
+
+static uint32_t romfs_idxhash(uint32_t dir, FAR const char *name,
+                              int namelen)
+{
+  uint32_t hash = 2166136261u ^ dir;
+  int i;
+
+  for (i = 0; i < namelen; i++)
+    {
+      hash ^= (uint8_t)name[i];
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_idxadddir
+ *
+ * Description:
+ *   Add all of the entries of the directory whose first entry is at
+ *   'first' to the list of entries being indexed.
+ *
+ ****************************************************************************/
+
+static int romfs_idxadddir(FAR struct romfs_mountpt_s *rm, uint32_t first,
+                           FAR struct romfs_idxentry_s **list,
+                           FAR uint32_t *nentries, FAR uint32_t *nalloc)
+{
+  FAR struct romfs_idxentry_s *newlist;
+  char name[NAME_MAX+1];
+  uint32_t offset;
+  uint32_t next;
+  int16_t  ndx;
+  int      ret;
+
+  offset = first;
+  do
+    {
+      /* Each header takes at least 32 bytes so an image cannot hold more
+       * than rm_volsize / 32 entries.  More means that the image is bad.
+       */
+
+      if (offset >= rm->rm_volsize ||
+          *nentries >= rm->rm_volsize / 32)
+        {
+          return -EINVAL;
+        }
+
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          return ndx;
+        }
+
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+      ret = romfs_parsefilename(rm, offset, name);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Make room for one more entry */
+
+      if (*nentries >= *nalloc)
+        {
+          newlist = (FAR struct romfs_idxentry_s *)
+            kmm_realloc(*list, (*nalloc + ROMFS_INDEX_INCR) *
+                        sizeof(struct romfs_idxentry_s));
+          if (newlist == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          *list   = newlist;
+          *nalloc += ROMFS_INDEX_INCR;
+        }
+
+      newlist            = &(*list)[*nentries];
+      newlist->ie_dir    = first;
+      newlist->ie_hash   = romfs_idxhash(first, name, strlen(name));
+      newlist->ie_offset = offset;
+      (*nentries)++;
+
+      offset = next;
+    }
+  while (next != 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_idxsearch
+ *
+ * Description:
+ *   Use the directory index to find entryname in the directory beginning
+ *   at dirinfo->fr_firstoffset.
+ *
+ ****************************************************************************/
+
+static int romfs_idxsearch(FAR struct romfs_mountpt_s *rm,
+                           FAR const char *entryname, int entrylen,
+                           FAR struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_idxentry_s *entry;
+  uint32_t first;
+  uint32_t hash;
+  uint32_t i;
+  int      ret;
+
+  first = dirinfo->rd_dir.fr_firstoffset;
+  hash  = romfs_idxhash(first, entryname, entrylen);
+
+  for (i = hash & rm->rm_idxmask;
+       rm->rm_index[i].ie_offset != 0;
+       i = (i + 1) & rm->rm_idxmask)
+    {
+      entry = &rm->rm_index[i];
+      if (entry->ie_hash == hash && entry->ie_dir == first)
+        {
+          /* Verify the name in the header itself */
+
+          ret = romfs_checkentry(rm, entry->ie_offset, entryname, entrylen,
+                                 dirinfo);
+          if (ret != -ENOENT)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* There is nothing in this directory with that name */
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -273,6 +428,15 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Use the directory index if there is one */
+
+  if (rm->rm_index != NULL)
+    {
+      return romfs_idxsearch(rm, entryname, entrylen, dirinfo);
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -768,6 +932,102 @@ int romfs_finddirentry(struct romfs_mountpt_s *rm,
   return ERROR; /* Won't get here */
 }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   Build a hashed index of every directory entry in the file system so
+ *   that path look-ups do not have to walk the directories.  The index
+ *   maps the offset of a directory and the name of an entry in it to the
+ *   offset of the entry's file header.
+ *
+ ****************************************************************************/
+
+int romfs_buildindex(FAR struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_idxentry_s *list = NULL;
+  FAR struct romfs_idxentry_s *table;
+  uint32_t nentries = 0;
+  uint32_t nalloc = 0;
+  uint32_t tabsize;
+  uint32_t next;
+  uint32_t info;
+  uint32_t i;
+  uint32_t j;
+  int16_t  ndx;
+  int      ret;
+
+  /* Collect all entries, starting with the root directory.  Each real
+   * (i.e., not hard linked) directory found is added in turn.
+   */
+
+  ret = romfs_idxadddir(rm, rm->rm_rootoffset, &list, &nentries, &nalloc);
+  for (i = 0; ret >= 0 && i < nentries; i++)
+    {
+      ndx = romfs_devcacheread(rm, list[i].ie_offset);
+      if (ndx < 0)
+        {
+          ret = ndx;
+          break;
+        }
+
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+      info = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
+      if (IS_DIRECTORY(next) && info != 0)
+        {
+          ret = romfs_idxadddir(rm, info, &list, &nentries, &nalloc);
+        }
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_list;
+    }
+
+  /* Then create a hash table that is at most half full */
+
+  tabsize = 16;
+  while (tabsize < 2 * nentries)
+    {
+      tabsize <<= 1;
+    }
+
+  table = (FAR struct romfs_idxentry_s *)
+    kmm_zalloc(tabsize * sizeof(struct romfs_idxentry_s));
+  if (table == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_list;
+    }
+
+  for (i = 0; i < nentries; i++)
+    {
+      j = list[i].ie_hash & (tabsize - 1);
+      while (table[j].ie_offset != 0)
+        {
+          j = (j + 1) & (tabsize - 1);
+        }
+
+      table[j] = list[i];
+    }
+
+  finfo("Indexed %lu entries\n", (unsigned long)nentries);
+
+  rm->rm_index   = table;
+  rm->rm_idxmask = tabsize - 1;
+  ret            = OK;
+
+errout_with_list:
+  if (list != NULL)
+    {
+      kmm_free(list);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_parsedirentry
  *
@@ -59,6 +59,9 @@ extern "C"
 
 #include <nuttx/semaphore.h>
 #include <nuttx/mtd/mtd.h>
+#ifdef CONFIG_SPIFFS_GC_WORKER
+#  include <nuttx/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -117,6 +120,16 @@ struct spiffs_sem_s
   uint16_t count;                   /* Number of counts held */
 };
 
+#if CONFIG_SPIFFS_HDRCACHE > 0
+/* One entry in the object ID to object index header page cache */
+
+struct spiffs_hdrcache_s
+{
+  int16_t objid;                    /* Object ID with the index flag */
+  int16_t pgndx;                    /* Page of the object index header */
+};
+#endif
+
 /* spiffs SPI configuration struct */
 
 /* This structure represents the current state of an SPIFFS volume */
@@ -133,6 +146,15 @@ struct spiffs_s
   FAR uint8_t *work;                /* Secondary work buffer, size of a logical page */
   FAR uint8_t *mtd_work;            /* MTD I/O buffer for read-modify-write */
   FAR void *cache;                  /* Cache memory */
+#ifdef CONFIG_SPIFFS_LUCACHE
+  FAR uint8_t *lucache;             /* RAM copy of all object lookup pages */
+#endif
+#if CONFIG_SPIFFS_HDRCACHE > 0
+  struct spiffs_hdrcache_s hdrcache[CONFIG_SPIFFS_HDRCACHE];
+#endif
+#ifdef CONFIG_SPIFFS_GC_WORKER
+  struct work_s gcwork;             /* Background garbage collection */
+#endif
 #ifdef CONFIG_HAVE_LONG_LONG
   off64_t media_size;               /* Physical size of the SPI flash */
 #else
@@ -276,6 +276,23 @@ static int spiffs_objlu_find_id_and_span_callback(FAR struct spiffs_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: spiffs_hdrcache_entry
+ *
+ * Description:
+ *   Return the object header cache entry that the object ID maps to.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_HDRCACHE > 0
+static inline FAR struct spiffs_hdrcache_s *
+spiffs_hdrcache_entry(FAR struct spiffs_s *fs, int16_t objid)
+{
+  uint16_t ndx = (uint16_t)(objid & ~SPIFFS_OBJID_NDXFLAG);
+  return &fs->hdrcache[ndx % CONFIG_SPIFFS_HDRCACHE];
+}
+#endif
+
 /****************************************************************************
  * Name: spiffs_find_objhdr_pgndx_callback
  *
@@ -965,10 +982,42 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
                                   int16_t spndx, int16_t exclusion_pgndx,
                                   FAR int16_t *pgndx)
 {
+#if CONFIG_SPIFFS_HDRCACHE > 0
+  FAR struct spiffs_hdrcache_s *hdr = NULL;
+#endif
   int16_t blkndx;
   int entry;
   int ret;
 
+#if CONFIG_SPIFFS_HDRCACHE > 0
+  /* Object index headers may be in the cache.  The cached page index is
+   * only a hint:  The page header must still agree.
+   */
+
+  if (spndx == 0 && (objid & SPIFFS_OBJID_NDXFLAG) != 0)
+    {
+      hdr = spiffs_hdrcache_entry(fs, objid);
+      if (hdr->objid == objid && hdr->pgndx != exclusion_pgndx)
+        {
+          ret = spiffs_objlu_find_id_and_span_callback(fs, objid,
+                  SPIFFS_BLOCK_FOR_PAGE(fs, hdr->pgndx),
+                  SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, hdr->pgndx),
+                  exclusion_pgndx ? &exclusion_pgndx : 0, &spndx);
+          if (ret == OK)
+            {
+              if (pgndx != NULL)
+                {
+                  *pgndx = hdr->pgndx;
+                }
+
+              return OK;
+            }
+
+          hdr->objid = SPIFFS_OBJID_DELETED;
+        }
+    }
+#endif
+
   ret = spiffs_foreach_objlu(fs, fs->lu_blkndx, fs->lu_entry,
                              SPIFFS_VIS_CHECK_ID, objid,
                              spiffs_objlu_find_id_and_span_callback,
@@ -990,6 +1039,14 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
       *pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
     }
 
+#if CONFIG_SPIFFS_HDRCACHE > 0
+  if (hdr != NULL && ret >= 0)
+    {
+      hdr->objid = objid;
+      hdr->pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
+    }
+#endif
+
   fs->lu_blkndx = blkndx;
   fs->lu_entry  = entry;
 
@@ -1526,6 +1583,25 @@ void spiffs_fobj_event(FAR struct spiffs_s *fs,
   finfo("Event=%s objid=%04x spndx=%04x npgndx=%04x nsz=%d\n",
         evname[MIN(ev, 5)], objid_raw, spndx, new_pgndx, new_size);
 
+#if CONFIG_SPIFFS_HDRCACHE > 0
+  /* Keep the object header cache in sync with the header page */
+
+  if (spndx == 0)
+    {
+      FAR struct spiffs_hdrcache_s *hdr = spiffs_hdrcache_entry(fs, objid);
+
+      if (ev != SPIFFS_EV_NDXDEL)
+        {
+          hdr->objid = objid | SPIFFS_OBJID_NDXFLAG;
+          hdr->pgndx = new_pgndx;
+        }
+      else if (hdr->objid == (objid | SPIFFS_OBJID_NDXFLAG))
+        {
+          hdr->objid = SPIFFS_OBJID_DELETED;
+        }
+    }
+#endif
+
   /* Update index caches in all file descriptors */
 
   for (fobj  = (FAR struct spiffs_file_s *)dq_peek(&fs->objq);
@@ -48,8 +48,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <unistd.h>
 #include <debug.h>
 
+#ifdef CONFIG_SPIFFS_GC_WORKER
+#  include <nuttx/wqueue.h>
+#endif
+
 #include "spiffs.h"
 #include "spiffs_core.h"
 #include "spiffs_cache.h"
@@ -943,6 +948,136 @@ static int spiffs_gc_clean(FAR struct spiffs_s *fs, int16_t blkndx)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spiffs_gc_block
+ *
+ * Description:
+ *   Move all live pages out of the candidate block, then erase it.
+ *
+ * Input Parameters:
+ *   fs     - A reference to the volume structure
+ *   blkndx - The block to be collected
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+static int spiffs_gc_block(FAR struct spiffs_s *fs, int16_t blkndx)
+{
+  int ret;
+
+  ret = spiffs_gc_clean(fs, blkndx);
+
+  spiffs_gcinfo("Cleaning block %d, result=%d\n", blkndx, ret);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_epage_stats(fs, blkndx);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_erase_block(fs, blkndx);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spiffs_gc_wanted
+ *
+ * Description:
+ *   Return true if background garbage collection should run.  There is
+ *   nothing to gain by moving pages around unless some have been deleted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_WORKER
+static inline bool spiffs_gc_wanted(FAR struct spiffs_s *fs)
+{
+  return fs->free_blocks <= CONFIG_SPIFFS_GC_WORKER_BLOCKS &&
+         fs->deleted_pages > 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_gc_worker
+ *
+ * Description:
+ *   Collect one block on the low priority work queue and re-schedule if
+ *   more collection is wanted.
+ *
+ *   The worker never waits for the volume.  If a file system operation is
+ *   in progress, the worker just returns; the next write will schedule it
+ *   again.  That keeps it from delaying the foreground and also means
+ *   that the worker cannot be blocked on the volume while it is being
+ *   unmounted.
+ *
+ * Input Parameters:
+ *   arg - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_WORKER
+static void spiffs_gc_worker(FAR void *arg)
+{
+  FAR struct spiffs_s *fs = (FAR struct spiffs_s *)arg;
+  FAR int16_t *cands;
+  int count;
+  int ret;
+
+  if (nxsem_trywait(&fs->exclsem.sem) < 0)
+    {
+      return;
+    }
+
+  fs->exclsem.holder = getpid();
+  fs->exclsem.count  = 1;
+
+  if (spiffs_gc_wanted(fs))
+    {
+      /* Fully deleted blocks can be erased without moving anything */
+
+      ret = spiffs_gc_quick(fs, 0);
+      if (ret == -ENODATA)
+        {
+          ret = spiffs_gc_find_candidate(fs, &cands, &count, false);
+          if (ret >= 0)
+            {
+              ret = count > 0 ? spiffs_gc_block(fs, cands[0]) : -ENODATA;
+            }
+        }
+
+      spiffs_gcinfo("Background GC free_blocks=%u ret=%d\n",
+                    (unsigned int)fs->free_blocks, ret);
+
+      if (ret >= 0 && spiffs_gc_wanted(fs))
+        {
+          (void)work_queue(LPWORK, &fs->gcwork, spiffs_gc_worker, fs,
+                           MSEC2TICK(CONFIG_SPIFFS_GC_WORKER_DELAY));
+        }
+    }
+
+  fs->exclsem.holder = SPIFFS_NO_HOLDER;
+  fs->exclsem.count  = 0;
+  nxsem_post(&fs->exclsem.sem);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1119,6 +1254,16 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
                 (long)len, (unsigned long)fs->free_blocks,
                 (long)free_pages);
 
+#ifdef CONFIG_SPIFFS_GC_WORKER
+  /* Start collecting in the background before the write path has to */
+
+  if (spiffs_gc_wanted(fs) && work_available(&fs->gcwork))
+    {
+      (void)work_queue(LPWORK, &fs->gcwork, spiffs_gc_worker, fs,
+                       MSEC2TICK(CONFIG_SPIFFS_GC_WORKER_DELAY));
+    }
+#endif
+
   if (fs->free_blocks > 3 &&
       (int32_t)len < free_pages * (int32_t)SPIFFS_DATA_PAGE_SIZE(fs))
     {
@@ -1184,27 +1329,9 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 #endif
       cand = cands[0];
 
-      ret = spiffs_gc_clean(fs, cand);
-
-      spiffs_gcinfo("Cleaning block %d, result=%d\n", cand, ret);
-
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
-          return ret;
-        }
-
-      ret = spiffs_gc_epage_stats(fs, cand);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
-          return ret;
-        }
-
-      ret = spiffs_gc_erase_block(fs, cand);
+      ret = spiffs_gc_block(fs, cand);
       if (ret < 0)
         {
-          ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
           return ret;
         }
 
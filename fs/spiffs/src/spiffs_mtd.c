@@ -46,9 +46,11 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 
 #include "spiffs.h"
+#include "spiffs_core.h"
 #include "spiffs_mtd.h"
 
 /****************************************************************************
@@ -68,29 +70,127 @@ static inline void spiffs_mtd_dump(FAR const char *msg,
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: spiffs_lucache_read
+ *
+ * Description:
+ *   Copy data from the object lookup cache if the whole range lies within
+ *   the object lookup pages of one block.
+ *
+ * Returned Value:
+ *   True if the data was copied from the cache.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_SPIFFS_LUCACHE
+static bool spiffs_lucache_read(FAR struct spiffs_s *fs, off_t offset,
+                                size_t len, FAR uint8_t *dest)
+{
+  size_t lusize;
+  off_t blkoffset;
+  int16_t blkndx;
+
+  if (fs->lucache == NULL)
+    {
+      return false;
+    }
+
+  lusize    = SPIFFS_OBJ_LOOKUP_PAGES(fs) * SPIFFS_GEO_PAGE_SIZE(fs);
+  blkndx    = offset / SPIFFS_GEO_BLOCK_SIZE(fs);
+  blkoffset = offset - SPIFFS_BLOCK_TO_PADDR(fs, blkndx);
+
+  if (blkndx >= SPIFFS_GEO_BLOCK_COUNT(fs) || blkoffset + len > lusize)
+    {
+      return false;
+    }
+
+  memcpy(dest, &fs->lucache[blkndx * lusize + blkoffset], len);
+  return true;
+}
+#endif
+
 /****************************************************************************
- * Name: spiffs_mtd_write
+ * Name: spiffs_lucache_update
  *
  * Description:
- *   Write data to FLASH memory
+ *   Apply a FLASH write (src != NULL) or erase (src == NULL) to the parts
+ *   of the object lookup cache that it overlaps.
  *
- * Input Parameters:
- *   fs     - A reference to the volume structure
- *   offset - The byte offset to write to
- *   len    - The number of bytes to write
- *   src    - A reference to the bytes to be written
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+static void spiffs_lucache_update(FAR struct spiffs_s *fs, off_t offset,
+                                  size_t len, FAR const uint8_t *src)
+{
+  FAR uint8_t *dest;
+  size_t lusize;
+  off_t blkoffset;
+  off_t end;
+  size_t nbytes;
+  size_t ncached;
+  size_t i;
+  int16_t blkndx;
+
+  if (fs->lucache == NULL)
+    {
+      return;
+    }
+
+  lusize = SPIFFS_OBJ_LOOKUP_PAGES(fs) * SPIFFS_GEO_PAGE_SIZE(fs);
+  end    = offset + len;
+
+  while (offset < end)
+    {
+      blkndx    = offset / SPIFFS_GEO_BLOCK_SIZE(fs);
+      blkoffset = offset - SPIFFS_BLOCK_TO_PADDR(fs, blkndx);
+      nbytes    = MIN(end - offset, SPIFFS_GEO_BLOCK_SIZE(fs) - blkoffset);
+
+      if (blkndx >= SPIFFS_GEO_BLOCK_COUNT(fs))
+        {
+          break;
+        }
+
+      if (blkoffset < lusize)
+        {
+          ncached = MIN(nbytes, lusize - blkoffset);
+          dest    = &fs->lucache[blkndx * lusize + blkoffset];
+
+          if (src == NULL)
+            {
+              memset(dest, 0xff, ncached);
+            }
+          else
+            {
+              /* Writing NOR FLASH can only clear bits.  SPIFFS depends on
+               * this for its blind writes.
+               */
+
+              for (i = 0; i < ncached; i++)
+                {
+                  dest[i] &= src[i];
+                }
+            }
+        }
+
+      offset += nbytes;
+      if (src != NULL)
+        {
+          src += nbytes;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_mtd_program
  *
- * Returned Value:
- *   On success, the number of bytes written is returned.  On failure, a
- *   negated errno value is returned.
+ * Description:
+ *   Write data to FLASH memory, using read-modify-write if the MTD driver
+ *   does not support byte writes.
  *
  ****************************************************************************/
 
-ssize_t spiffs_mtd_write(FAR struct spiffs_s *fs, off_t offset, size_t len,
-                         FAR const uint8_t *src)
+static ssize_t spiffs_mtd_program(FAR struct spiffs_s *fs, off_t offset,
+                                  size_t len, FAR const uint8_t *src)
 {
   size_t remaining;
   ssize_t ret;
@@ -259,6 +359,51 @@ ssize_t spiffs_mtd_write(FAR struct spiffs_s *fs, off_t offset, size_t len,
   return (ssize_t)len;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_mtd_write
+ *
+ * Description:
+ *   Write data to FLASH memory
+ *
+ * Input Parameters:
+ *   fs     - A reference to the volume structure
+ *   offset - The byte offset to write to
+ *   len    - The number of bytes to write
+ *   src    - A reference to the bytes to be written
+ *
+ * Returned Value:
+ *   On success, the number of bytes written is returned.  On failure, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t spiffs_mtd_write(FAR struct spiffs_s *fs, off_t offset, size_t len,
+                         FAR const uint8_t *src)
+{
+  ssize_t ret;
+
+  ret = spiffs_mtd_program(fs, offset, len, src);
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+  if (ret < 0)
+    {
+      /* The state of the FLASH is not known */
+
+      spiffs_lucache_release(fs);
+    }
+  else
+    {
+      spiffs_lucache_update(fs, offset, len, src);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: spiffs_mtd_read
  *
@@ -296,6 +441,16 @@ ssize_t spiffs_mtd_read(FAR struct spiffs_s *fs, off_t offset, size_t len,
 
   DEBUGASSERT(fs != NULL && fs->mtd != NULL && dest != NULL && len > 0);
 
+#ifdef CONFIG_SPIFFS_LUCACHE
+  /* Object lookup pages are served from the RAM copy */
+
+  if (spiffs_lucache_read(fs, offset, len, dest))
+    {
+      spiffs_mtd_dump("Read (cached)", dest, len);
+      return (ssize_t)len;
+    }
+#endif
+
   remaining = len;
 
   /* Try to do the byte read */
@@ -472,8 +627,88 @@ ssize_t spiffs_mtd_erase(FAR struct spiffs_s *fs, off_t offset, size_t len)
   if (nerased < 0)
     {
       ferr("ERROR: MTD_ERASE() failed: %d\n");
+#ifdef CONFIG_SPIFFS_LUCACHE
+      spiffs_lucache_release(fs);
+#endif
       return nerased;
     }
 
+#ifdef CONFIG_SPIFFS_LUCACHE
+  spiffs_lucache_update(fs, offset, erasesize * nerased, NULL);
+#endif
   return erasesize * nerased;
 }
+
+/****************************************************************************
+ * Name: spiffs_lucache_initialize
+ *
+ * Description:
+ *   Allocate the object lookup cache and fill it from FLASH.  Failures are
+ *   not fatal:  The volume simply operates without the cache.
+ *
+ * Input Parameters:
+ *   fs - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+void spiffs_lucache_initialize(FAR struct spiffs_s *fs)
+{
+  FAR uint8_t *lucache;
+  size_t lusize;
+  ssize_t ret;
+  int16_t blkndx;
+
+  DEBUGASSERT(fs->lucache == NULL);
+
+  lusize  = SPIFFS_OBJ_LOOKUP_PAGES(fs) * SPIFFS_GEO_PAGE_SIZE(fs);
+  lucache = (FAR uint8_t *)kmm_malloc(lusize * SPIFFS_GEO_BLOCK_COUNT(fs));
+  if (lucache == NULL)
+    {
+      fwarn("WARNING: No memory for the object lookup cache\n");
+      return;
+    }
+
+  for (blkndx = 0; blkndx < SPIFFS_GEO_BLOCK_COUNT(fs); blkndx++)
+    {
+      ret = spiffs_mtd_read(fs, SPIFFS_BLOCK_TO_PADDR(fs, blkndx), lusize,
+                            &lucache[blkndx * lusize]);
+      if (ret < 0)
+        {
+          ferr("ERROR: spiffs_mtd_read() failed: %d\n", (int)ret);
+          kmm_free(lucache);
+          return;
+        }
+    }
+
+  fs->lucache = lucache;
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_lucache_release
+ *
+ * Description:
+ *   Free the object lookup cache.  All further reads go to FLASH.
+ *
+ * Input Parameters:
+ *   fs - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+void spiffs_lucache_release(FAR struct spiffs_s *fs)
+{
+  if (fs->lucache != NULL)
+    {
+      kmm_free(fs->lucache);
+      fs->lucache = NULL;
+    }
+}
+#endif
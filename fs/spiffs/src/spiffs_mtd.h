@@ -157,6 +157,43 @@ ssize_t spiffs_mtd_read(FAR struct spiffs_s *fs, off_t offset, size_t len,
 
 ssize_t spiffs_mtd_erase(FAR struct spiffs_s *fs, off_t offset, size_t len);
 
+/****************************************************************************
+ * Name: spiffs_lucache_initialize
+ *
+ * Description:
+ *   Allocate the object lookup cache and fill it from FLASH.  Failures are
+ *   not fatal:  The volume simply operates without the cache.
+ *
+ * Input Parameters:
+ *   fs - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+void spiffs_lucache_initialize(FAR struct spiffs_s *fs);
+#endif
+
+/****************************************************************************
+ * Name: spiffs_lucache_release
+ *
+ * Description:
+ *   Free the object lookup cache.  All further reads go to FLASH.
+ *
+ * Input Parameters:
+ *   fs - A reference to the volume structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+void spiffs_lucache_release(FAR struct spiffs_s *fs);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -1443,6 +1443,12 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
 
   (void)nxsem_init(&fs->exclsem.sem, 0, 1);
 
+#ifdef CONFIG_SPIFFS_LUCACHE
+  /* Load the object lookup pages into RAM before the scan uses them */
+
+  spiffs_lucache_initialize(fs);
+#endif
+
   /* Check the file system */
 
   ret = spiffs_objlu_scan(fs);
@@ -1483,6 +1489,9 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   return OK;
 
 errout_with_work:
+#ifdef CONFIG_SPIFFS_LUCACHE
+  spiffs_lucache_release(fs);
+#endif
   kmm_free(fs->work);
 
 errout_with_cache:
@@ -1530,6 +1539,16 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
       spiffs_fobj_free(fs, fobj, false);
     }
 
+#ifdef CONFIG_SPIFFS_GC_WORKER
+  /* Make sure that no background garbage collection is pending */
+
+  (void)work_cancel(LPWORK, &fs->gcwork);
+#endif
+
+#ifdef CONFIG_SPIFFS_LUCACHE
+  spiffs_lucache_release(fs);
+#endif
+
  /* Free allocated working buffers */
 
   if (fs->work != NULL)
@@ -42,6 +42,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <dirent.h>
@@ -50,6 +51,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
@@ -67,10 +69,18 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#if CONFIG_FS_TMPFS_PAGESIZE <= 0
+#  error CONFIG_FS_TMPFS_PAGESIZE must be positive
 #endif
 
+#define TMPFS_PAGESIZE          CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_NPAGES(size) \
+  (((size) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+
+/* The page list grows by at least this many entries */
+
+#define TMPFS_PAGELIST_INCR     4
+
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -93,8 +103,17 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static int  tmpfs_reserve(FAR struct tmpfs_s *fs, size_t nbytes);
+static void tmpfs_unreserve(FAR struct tmpfs_s *fs, size_t nbytes);
+static int  tmpfs_grow_pagelist(FAR struct tmpfs_file_s *tfo,
+              unsigned int npages);
+static int  tmpfs_alloc_page(FAR struct tmpfs_file_s *tfo,
+              unsigned int pgndx, FAR uint8_t **page);
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+              unsigned int first);
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -103,7 +122,7 @@ static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
 static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
               FAR struct tmpfs_object_s *to, FAR const char *name);
-static FAR struct tmpfs_file_s *tmpfs_alloc_file(void);
+static FAR struct tmpfs_file_s *tmpfs_alloc_file(FAR struct tmpfs_s *fs);
 static int  tmpfs_create_file(FAR struct tmpfs_s *fs,
               FAR const char *relpath, FAR struct tmpfs_file_s **tfo);
 static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void);
@@ -372,72 +391,222 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_reserve
+ *
+ * Description:
+ *   Account for nbytes more of file pages, failing if that would exceed the
+ *   size limit of the file system.  Files are locked individually, so a
+ *   critical section protects the file system totals.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static int tmpfs_reserve(FAR struct tmpfs_s *fs, size_t nbytes)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (fs->tfs_quota > 0 && fs->tfs_inuse + nbytes > fs->tfs_quota)
+    {
+      ret = -ENOSPC;
+    }
+  else
+    {
+      fs->tfs_inuse += nbytes;
+    }
 
-  /* Check if the current allocation is sufficient */
+  leave_critical_section(flags);
+  return ret;
+}
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+/****************************************************************************
+ * Name: tmpfs_unreserve
+ ****************************************************************************/
 
-  /* Are we growing or shrinking the object? */
+static void tmpfs_unreserve(FAR struct tmpfs_s *fs, size_t nbytes)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT(fs->tfs_inuse >= nbytes);
+  fs->tfs_inuse -= nbytes;
+  leave_critical_section(flags);
+}
 
-  if (objsize <= oldtfo->tfo_alloc)
+/****************************************************************************
+ * Name: tmpfs_grow_pagelist
+ *
+ * Description:
+ *   Make sure that the page list of the file has at least npages entries.
+ *   The list is grown geometrically so that appending to a file takes
+ *   amortized constant time.  Only the page pointers are copied.
+ *
+ ****************************************************************************/
+
+static int tmpfs_grow_pagelist(FAR struct tmpfs_file_s *tfo,
+                               unsigned int npages)
+{
+  FAR uint8_t **pages;
+  unsigned int newcount;
+
+  if (npages <= tfo->tfo_npages)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      return OK;
+    }
 
-      if (newsize > 0)
-        {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+  newcount = 2 * tfo->tfo_npages;
+  if (newcount < TMPFS_PAGELIST_INCR)
+    {
+      newcount = TMPFS_PAGELIST_INCR;
+    }
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+  if (newcount < npages)
+    {
+      newcount = npages;
+    }
 
-              oldtfo->tfo_size = newsize;
-              return OK;
-            }
+  pages = (FAR uint8_t **)kmm_realloc(tfo->tfo_pages,
+                                      newcount * sizeof(FAR uint8_t *));
+  if (pages == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(&pages[tfo->tfo_npages], 0,
+         (newcount - tfo->tfo_npages) * sizeof(FAR uint8_t *));
+
+  tfo->tfo_alloc += (newcount - tfo->tfo_npages) * sizeof(FAR uint8_t *);
+  tfo->tfo_pages  = pages;
+  tfo->tfo_npages = newcount;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_alloc_page
+ *
+ * Description:
+ *   Return the data page at index pgndx, allocating a zeroed page if there
+ *   is a hole there.  The page list must already be large enough.
+ *
+ ****************************************************************************/
+
+static int tmpfs_alloc_page(FAR struct tmpfs_file_s *tfo,
+                            unsigned int pgndx, FAR uint8_t **page)
+{
+  FAR uint8_t *newpage;
+  int ret;
+
+  DEBUGASSERT(pgndx < tfo->tfo_npages);
+
+  if (tfo->tfo_pages[pgndx] == NULL)
+    {
+      ret = tmpfs_reserve(tfo->tfo_fs, TMPFS_PAGESIZE);
+      if (ret < 0)
+        {
+          return ret;
         }
+
+      newpage = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+      if (newpage == NULL)
+        {
+          tmpfs_unreserve(tfo->tfo_fs, TMPFS_PAGESIZE);
+          return -ENOMEM;
+        }
+
+      tfo->tfo_pages[pgndx] = newpage;
+      tfo->tfo_alloc       += TMPFS_PAGESIZE;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  *page = tfo->tfo_pages[pgndx];
+  return OK;
+}
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Free all data pages at and after the page index first.
+ *
+ ****************************************************************************/
 
-  /* Realloc the file object */
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             unsigned int first)
+{
+  unsigned int pgndx;
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+  for (pgndx = first; pgndx < tfo->tfo_npages; pgndx++)
     {
-      return -ENOMEM;
+      if (tfo->tfo_pages[pgndx] != NULL)
+        {
+          kmm_free(tfo->tfo_pages[pgndx]);
+          tfo->tfo_pages[pgndx] = NULL;
+          tfo->tfo_alloc       -= TMPFS_PAGESIZE;
+          tmpfs_unreserve(tfo->tfo_fs, TMPFS_PAGESIZE);
+        }
     }
+}
 
-  /* Adjust the reference in the parent directory entry */
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Change the size of the file.  Growing the file just leaves a hole at
+ *   the end.  Shrinking frees the pages beyond the new end of the file and
+ *   clears the tail of the last page so that the hole reads as zeroes if
+ *   the file is extended again.
+ *
+ ****************************************************************************/
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+  unsigned int npages;
+  size_t offset;
 
-  /* Return the new address of the reallocated file object */
+  if (newsize < tfo->tfo_size)
+    {
+      npages = TMPFS_NPAGES(newsize);
+      tmpfs_free_pages(tfo, npages);
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
-  return OK;
+      offset = newsize % TMPFS_PAGESIZE;
+      if (offset > 0 && npages <= tfo->tfo_npages &&
+          tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(&tfo->tfo_pages[npages - 1][offset], 0,
+                 TMPFS_PAGESIZE - offset);
+        }
+
+      /* Release the page list too once the file is empty */
+
+      if (newsize == 0 && tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+          tfo->tfo_alloc -= tfo->tfo_npages * sizeof(FAR uint8_t *);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
+        }
+    }
+
+  tfo->tfo_size = newsize;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Free a file object and all of its data.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, 0);
+  if (tfo->tfo_pages != NULL)
+    {
+      kmm_free(tfo->tfo_pages);
+    }
+
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
 }
 
 /****************************************************************************
@@ -475,8 +644,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -619,15 +787,15 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
  * Name: tmpfs_alloc_file
  ****************************************************************************/
 
-static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
+static FAR struct tmpfs_file_s *tmpfs_alloc_file(FAR struct tmpfs_s *fs)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No data pages are allocated
+   * until the file is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -637,11 +805,14 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
+  tfo->tfo_alloc  = sizeof(struct tmpfs_file_s);
+  tfo->tfo_type   = TMPFS_REGULAR;
+  tfo->tfo_refs   = 1;
+  tfo->tfo_flags  = 0;
+  tfo->tfo_size   = 0;
+  tfo->tfo_fs     = fs;
+  tfo->tfo_pages  = NULL;
+  tfo->tfo_npages = 0;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -728,7 +899,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
    * reference count.
    */
 
-  newtfo = tmpfs_alloc_file();
+  newtfo = tmpfs_alloc_file(fs);
   if (newtfo == NULL)
     {
       ret = -ENOMEM;
@@ -1279,8 +1450,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      nxsem_destroy(&to->to_exclsem.ts_sem);
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1428,11 +1607,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
-              if (ret < 0)
-                {
-                  goto errout_with_filelock;
-                }
+              tmpfs_resize_file(tfo, 0);
             }
         }
     }
@@ -1543,7 +1718,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1561,9 +1736,14 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  off_t pos;
+  size_t offset;
+  size_t nbytes;
+  unsigned int pgndx;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1583,15 +1763,45 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread  = 0;
+      endpos = startpos;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer.  Holes read as
+   * zeroes.
+   */
+
+  for (pos = startpos; pos < endpos; pos += nbytes)
+    {
+      pgndx  = pos / TMPFS_PAGESIZE;
+      page   = pgndx < tfo->tfo_npages ? tfo->tfo_pages[pgndx] : NULL;
+      offset = pos % TMPFS_PAGESIZE;
+      nbytes = TMPFS_PAGESIZE - offset;
+
+      if (nbytes > endpos - pos)
+        {
+          nbytes = endpos - pos;
+        }
+
+      if (page != NULL)
+        {
+          memcpy(buffer, &page[offset], nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+
+      buffer += nbytes;
+    }
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1608,9 +1818,13 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  off_t pos;
+  size_t offset;
+  size_t nbytes;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1625,28 +1839,56 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   tmpfs_lock_file(tfo);
 
-  /* Handle attempts to write beyond the end of the file */
+  /* Make sure that the page list covers the end of the write */
 
   startpos = filep->f_pos;
-  nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  ret = tmpfs_grow_pagelist(tfo, TMPFS_NPAGES(endpos));
+  if (ret < 0)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      goto errout_with_lock;
+    }
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+  /* Copy data from the user buffer to the file pages, allocating pages as
+   * needed.
+   */
+
+  for (pos = startpos; pos < endpos; pos += nbytes)
+    {
+      ret = tmpfs_alloc_page(tfo, pos / TMPFS_PAGESIZE, &page);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          /* Out of memory or over the size limit.  Report a partial
+           * write if anything was written.
+           */
+
+          if (pos == startpos)
+            {
+              goto errout_with_lock;
+            }
+
+          break;
         }
 
-      filep->f_priv = tfo;
+      offset = pos % TMPFS_PAGESIZE;
+      nbytes = TMPFS_PAGESIZE - offset;
+
+      if (nbytes > endpos - pos)
+        {
+          nbytes = endpos - pos;
+        }
+
+      memcpy(&page[offset], buffer, nbytes);
+      buffer += nbytes;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  nwritten = pos - startpos;
+  if (pos > tfo->tfo_size)
+    {
+      tfo->tfo_size = pos;
+    }
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1727,6 +1969,8 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  FAR uint8_t *page;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1742,11 +1986,33 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
       /* Return the address on the media corresponding to the start of
-       * the file.
+       * the file.  The file is contiguous in memory only if it fits in
+       * its first page.  Otherwise mmap() has to fall back to copying the
+       * file (see CONFIG_FS_RAMMAP).
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      tmpfs_lock_file(tfo);
+
+      if (tfo->tfo_size > TMPFS_PAGESIZE)
+        {
+          ret = -ENOSYS;
+        }
+      else
+        {
+          ret = tmpfs_grow_pagelist(tfo, 1);
+          if (ret >= 0)
+            {
+              ret = tmpfs_alloc_page(tfo, 0, &page);
+            }
+
+          if (ret >= 0)
+            {
+              *ppv = (FAR void *)page;
+            }
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1848,31 +2114,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      filep->f_priv = tfo;
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Growing the file leaves a
+       * hole that reads as zeroes.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      tmpfs_resize_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2048,6 +2298,8 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 {
   FAR struct tmpfs_directory_s *tdo;
   FAR struct tmpfs_s *fs;
+  FAR const char *ptr;
+  FAR char *end;
 
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
@@ -2060,6 +2312,36 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       return -ENOMEM;
     }
 
+  /* The only mount option is the size limit:  "size=<bytes>[k|m]" */
+
+  fs->tfs_quota = CONFIG_FS_TMPFS_QUOTA;
+
+  for (ptr = (FAR const char *)data; ptr != NULL && *ptr != '\0'; )
+    {
+      if (strncmp(ptr, "size=", 5) == 0)
+        {
+          fs->tfs_quota = strtoul(&ptr[5], &end, 0);
+          if (*end == 'k' || *end == 'K')
+            {
+              fs->tfs_quota <<= 10;
+            }
+          else if (*end == 'm' || *end == 'M')
+            {
+              fs->tfs_quota <<= 20;
+            }
+        }
+      else
+        {
+          finfo("Ignoring option: %s\n", ptr);
+        }
+
+      ptr = strchr(ptr, ',');
+      if (ptr != NULL)
+        {
+          ptr++;
+        }
+    }
+
   /* Create a root file system.  This is like a single directory entry in
    * the file system structure.
    */
@@ -2172,7 +2454,15 @@ static int tmpfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
       return -ECANCELED;
     }
 
-  /* Return something for the file system description */
+  /* Return something for the file system description.  With a size limit,
+   * report the file pages against the limit.
+   */
+
+  if (fs->tfs_quota > 0)
+    {
+      tmpbuf.tsf_alloc = fs->tfs_quota;
+      tmpbuf.tsf_inuse = fs->tfs_inuse;
+    }
 
   blkalloc        = (tmpbuf.tsf_alloc + CONFIG_FS_TMPFS_BLOCKSIZE - 1) /
                      CONFIG_FS_TMPFS_BLOCKSIZE;
@@ -2275,8 +2565,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
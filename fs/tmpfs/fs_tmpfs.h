@@ -137,8 +137,13 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in a list of separately allocated pages of
+ * CONFIG_FS_TMPFS_PAGESIZE bytes.
  */
 
+struct tmpfs_s;          /* Forward reference */
+
 struct tmpfs_file_s
 {
   /* First fields must match common TMPFS object layout */
@@ -154,11 +159,11 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  FAR struct tmpfs_s *tfo_fs; /* The file system that holds the file */
+  FAR uint8_t **tfo_pages; /* Data pages.  NULL entries are holes */
+  unsigned int tfo_npages; /* Number of entries in tfo_pages[] */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
@@ -167,6 +172,9 @@ struct tmpfs_s
 
   FAR struct tmpfs_dirent_s tfs_root;
   struct tmpfs_sem_s tfs_exclsem;
+
+  size_t tfs_quota;      /* Limit on tfs_inuse (zero if none) */
+  size_t tfs_inuse;      /* Bytes of file pages allocated */
 };
 
 /* This is the type used the tmpfs_statfs_callout to accumulate memory usage */
@@ -91,6 +91,13 @@ int dup2(int fd1, int fd2)
   /* Get the file structures corresponding to the file descriptors. */
 
   ret = fs_getfilep(fd1, &filep1);
+  if (ret >= 0)
+    {
+      /* fd2 may never have been used */
+
+      ret = files_extend(fd2);
+    }
+
   if (ret >= 0)
     {
       ret = fs_getfilep(fd2, &filep2);
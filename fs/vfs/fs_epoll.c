@@ -42,15 +42,456 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <queue.h>
 #include <errno.h>
 #include <string.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 
 #ifndef CONFIG_DISABLE_POLL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* struct epoll_node_s flag bits */
+
+#define EPOLL_NODE_INUSE   (1 << 0)  /* Node holds a registered descriptor */
+#define EPOLL_NODE_ARMED   (1 << 1)  /* Poll is setup on the descriptor */
+#define EPOLL_NODE_READY   (1 << 2)  /* Node is in the ready list */
+#define EPOLL_NODE_REARM   (1 << 3)  /* Node is in the re-arm list */
+
+/* The ready/re-arm list that holds a node */
+
+#define EPOLL_NODE_QUEUED  (EPOLL_NODE_READY | EPOLL_NODE_REARM)
+
+/* These event bits are always monitored */
+
+#define EPOLL_ALWAYS       (POLLERR | POLLHUP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One registered file or socket descriptor.  The poll is set up on the
+ * descriptor when it is added (and remains set up until it is removed) so
+ * that epoll_wait() does not have to set up and tear down every descriptor
+ * on each call.  Drivers notify events through poll_notify() which calls
+ * epoll_pollnotify() to move the node into the ready list.
+ */
+
+struct epoll_head_s;
+struct epoll_node_s
+{
+  dq_entry_t link;                  /* Ready/re-arm list link (must be first) */
+  FAR struct epoll_head_s *eph;     /* The containing epoll instance */
+  struct pollfd pfd;                /* The persistent poll setup */
+  epoll_data_t data;                /* User data returned with events */
+  uint32_t events;                  /* Requested events and EPOLL flags */
+  uint8_t flags;                    /* See EPOLL_NODE_* definitions */
+};
+
+/* One epoll instance */
+
+struct epoll_head_s
+{
+  int size;                         /* Number of allocated nodes */
+  int occupied;                     /* Number of registered descriptors */
+  int nnotify;                      /* Number of callback semaphore posts */
+  sem_t sem;                        /* Posted on each event notification */
+  sem_t exclsem;                    /* Serializes access to the nodes */
+  dq_queue_t ready;                 /* Nodes with pending events */
+  dq_queue_t rearm;                 /* Level-triggered nodes to be re-polled */
+  FAR struct epoll_node_s *nodes;   /* Allocated array of 'size' nodes */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR struct epoll_head_s *eph)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&eph->exclsem);
+
+      /* The only case that an error should occur here is if the wait were
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define epoll_semgive(eph) nxsem_post(&(eph)->exclsem)
+
+/****************************************************************************
+ * Name: epoll_pollnotify
+ *
+ * Description:
+ *   The poll notification callback.  This is called by poll_notify() when
+ *   the driver posts events for a registered descriptor.  It adds the node
+ *   to the ready list and wakes up any waiter.  This may be called from an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+static void epoll_pollnotify(FAR struct pollfd *fds)
+{
+  FAR struct epoll_node_s *node = (FAR struct epoll_node_s *)fds->arg;
+  FAR struct epoll_head_s *eph;
+  irqstate_t flags;
+
+  DEBUGASSERT(node != NULL && node->eph != NULL);
+  eph = node->eph;
+
+  flags = enter_critical_section();
+
+  /* Some drivers notify through private, "shadow" pollfd structures. */
+
+  if (fds != &node->pfd)
+    {
+      node->pfd.revents |= fds->revents;
+    }
+
+  if ((node->flags & EPOLL_NODE_QUEUED) == 0 && node->pfd.revents != 0)
+    {
+      dq_addlast(&node->link, &eph->ready);
+      node->flags |= EPOLL_NODE_READY;
+    }
+
+  /* Count the post so that epoll_wait() can distinguish it from a direct
+   * post of the semaphore by a driver that does not use poll_notify().
+   */
+
+  eph->nnotify++;
+  nxsem_post(&eph->sem);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Setup or teardown the poll on one file or socket descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+{
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS &&
+      (unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS +
+                          CONFIG_NSOCKET_DESCRIPTORS))
+    {
+      return net_poll(fd, fds, setup);
+    }
+#endif
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  return fdesc_poll(fd, fds, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_dequeue
+ *
+ * Description:
+ *   Remove the node from the ready or re-arm list, if it is in either.
+ *
+ ****************************************************************************/
+
+static void epoll_dequeue(FAR struct epoll_head_s *eph,
+                          FAR struct epoll_node_s *node)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if ((node->flags & EPOLL_NODE_READY) != 0)
+    {
+      dq_rem(&node->link, &eph->ready);
+    }
+  else if ((node->flags & EPOLL_NODE_REARM) != 0)
+    {
+      dq_rem(&node->link, &eph->rearm);
+    }
+
+  node->flags &= ~EPOLL_NODE_QUEUED;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Setup the persistent poll on the node's descriptor.  If the descriptor
+ *   is already ready, the driver will notify immediately and the node will
+ *   be placed in the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_arm(FAR struct epoll_head_s *eph,
+                      FAR struct epoll_node_s *node)
+{
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT((node->flags & EPOLL_NODE_ARMED) == 0);
+
+  node->pfd.revents = 0;
+  node->pfd.priv    = NULL;
+
+  ret = epoll_fdsetup(node->pfd.fd, &node->pfd, true);
+  if (ret >= 0)
+    {
+      node->flags |= EPOLL_NODE_ARMED;
+      return;
+    }
+
+  /* The setup failed.  Report the error on the descriptor, just as would
+   * poll().
+   */
+
+  ferr("ERROR: poll setup failed for fd=%d: %d\n", node->pfd.fd, ret);
+
+  flags = enter_critical_section();
+  node->pfd.revents |= (ret == -EBADF) ? POLLNVAL : POLLERR;
+  if ((node->flags & EPOLL_NODE_QUEUED) == 0)
+    {
+      dq_addlast(&node->link, &eph->ready);
+      node->flags |= EPOLL_NODE_READY;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Teardown the persistent poll on the node's descriptor.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_node_s *node)
+{
+  if ((node->flags & EPOLL_NODE_ARMED) != 0)
+    {
+      (void)epoll_fdsetup(node->pfd.fd, &node->pfd, false);
+      node->flags &= ~EPOLL_NODE_ARMED;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      FAR struct epoll_node_s *node = &eph->nodes[i];
+
+      if ((node->flags & EPOLL_NODE_INUSE) != 0 && node->pfd.fd == fd)
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_setevents
+ ****************************************************************************/
+
+static void epoll_setevents(FAR struct epoll_node_s *node,
+                            FAR const struct epoll_event *ev)
+{
+  node->events     = ev->events;
+  node->data       = ev->data;
+  node->pfd.events = ((pollevent_t)ev->events & ~POLLMASK) | EPOLL_ALWAYS;
+}
+
+/****************************************************************************
+ * Name: epoll_drain
+ *
+ * Description:
+ *   Consume all pending posts of the wait semaphore.  If there are more
+ *   posts than there were notification callbacks, then some driver posted
+ *   the semaphore directly; in that case, every registered descriptor is
+ *   checked for events and ready nodes are moved to the ready list.
+ *
+ * Input Parameters:
+ *   eph    - The epoll instance
+ *   ntaken - The number of posts already taken by the caller.
+ *
+ ****************************************************************************/
+
+static void epoll_drain(FAR struct epoll_head_s *eph, int ntaken)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  while (nxsem_trywait(&eph->sem) == OK)
+    {
+      ntaken++;
+    }
+
+  if (ntaken > eph->nnotify)
+    {
+      for (i = 0; i < eph->size; i++)
+        {
+          FAR struct epoll_node_s *node = &eph->nodes[i];
+
+          if ((node->flags & (EPOLL_NODE_ARMED | EPOLL_NODE_QUEUED)) ==
+              EPOLL_NODE_ARMED && node->pfd.revents != 0)
+            {
+              dq_addlast(&node->link, &eph->ready);
+              node->flags |= EPOLL_NODE_READY;
+            }
+        }
+    }
+
+  eph->nnotify = 0;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_harvest
+ *
+ * Description:
+ *   Remove up to maxevents nodes from the ready list and return their
+ *   events.
+ *
+ ****************************************************************************/
+
+static int epoll_harvest(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
+
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      node  = (FAR struct epoll_node_s *)dq_remfirst(&eph->ready);
+      if (node == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      node->flags &= ~EPOLL_NODE_READY;
+      revents = node->pfd.revents & (node->pfd.events | POLLNVAL);
+
+      /* In edge-triggered mode, the poll remains set up and events are
+       * reported again when the driver next notifies.
+       */
+
+      if ((node->events & (EPOLLET | EPOLLONESHOT)) == EPOLLET)
+        {
+          node->pfd.revents = 0;
+        }
+
+      leave_critical_section(flags);
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = node->data;
+      nevents++;
+
+      if ((node->events & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until re-armed by EPOLL_CTL_MOD */
+
+          epoll_disarm(node);
+        }
+      else if ((node->events & EPOLLET) == 0)
+        {
+          /* Level-triggered: The descriptor is re-polled at the beginning
+           * of the next epoll_wait() and reported again if the condition
+           * still persists.
+           */
+
+          epoll_disarm(node);
+
+          flags = enter_critical_section();
+          dq_addlast(&node->link, &eph->rearm);
+          node->flags |= EPOLL_NODE_REARM;
+          leave_critical_section(flags);
+        }
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Re-poll all level-triggered nodes that were reported by the last
+ *   epoll_wait().
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      node  = (FAR struct epoll_node_s *)dq_remfirst(&eph->rearm);
+      if (node != NULL)
+        {
+          node->flags &= ~EPOLL_NODE_REARM;
+        }
+
+      leave_critical_section(flags);
+
+      if (node == NULL)
+        {
+          break;
+        }
+
+      epoll_arm(eph, node);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,24 +500,56 @@
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance that can monitor up to 'size' descriptors.
  *
  * Input Parameters:
+ *   size - The maximum number of descriptors that may be registered.
  *
  * Returned Value:
+ *   A handle to the epoll instance on success; -1 (ERROR) on failure with
+ *   the errno value set appropriately.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  eph->nodes = (FAR struct epoll_node_s *)
+    kmm_zalloc(sizeof(struct epoll_node_s) * size);
+
+  if (eph->nodes == NULL)
+    {
+      kmm_free(eph);
+      set_errno(ENOMEM);
+      return ERROR;
+    }
 
   eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_setprotocol(&eph->sem, SEM_PRIO_NONE);
+  nxsem_init(&eph->exclsem, 0, 1);
 
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
   return (int)((intptr_t)eph);
@@ -86,22 +559,35 @@ int epoll_create(int size)
  * Name: epoll_close
  *
  * Description:
+ *   Release an epoll instance.  Any remaining descriptors are removed.
  *
  * Input Parameters:
+ *   epfd - The epoll instance returned by epoll_create()
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
 void epoll_close(int epfd)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  int i;
+
+  DEBUGASSERT(eph != NULL);
 
-  kmm_free(eph->evs);
+  for (i = 0; i < eph->size; i++)
+    {
+      epoll_disarm(&eph->nodes[i]);
+    }
+
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(eph->nodes);
   kmm_free(eph);
 }
 
@@ -109,20 +595,45 @@ void epoll_close(int epfd)
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify, or remove a descriptor from the epoll instance.  The poll
+ *   on an added descriptor remains set up until it is removed so an added
+ *   descriptor must be removed (EPOLL_CTL_DEL) before it is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll instance returned by epoll_create()
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD, or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The requested events (EPOLLET and EPOLLONESHOT may be included)
+ *          and the user data to return with the events.  Not used by
+ *          EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with the errno value set
+ *   appropriately.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  FAR struct epoll_node_s *node;
+  int errcode = OK;
+  int i;
+
+  DEBUGASSERT(eph != NULL);
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      set_errno(EFAULT);
+      return ERROR;
+    }
+
+  epoll_semtake(eph);
+  node = epoll_find(eph, fd);
 
   switch (op)
     {
@@ -130,63 +641,107 @@ int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
         finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
               epfd, eph->occupied, fd, ev->events);
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        if (node != NULL)
+          {
+            errcode = EEXIST;
+            break;
+          }
+
+        for (i = 0; i < eph->size; i++)
+          {
+            if ((eph->nodes[i].flags & EPOLL_NODE_INUSE) == 0)
+              {
+                node = &eph->nodes[i];
+                break;
+              }
+          }
+
+        if (node == NULL)
+          {
+            errcode = ENOMEM;
+            break;
+          }
+
+        memset(node, 0, sizeof(struct epoll_node_s));
+        node->eph      = eph;
+        node->flags    = EPOLL_NODE_INUSE;
+        node->pfd.fd   = fd;
+        node->pfd.sem  = &eph->sem;
+        node->pfd.cb   = epoll_pollnotify;
+        node->pfd.arg  = node;
+        epoll_setevents(node, ev);
+
+        eph->occupied++;
+        epoll_arm(eph, node);
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%08x CTL DEL(%d): fd=%d\n", epfd, eph->occupied, fd);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (node == NULL)
+          {
+            errcode = ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_disarm(node);
+        epoll_dequeue(eph, node);
+
+        node->flags = 0;
+        eph->occupied--;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
+              epfd, eph->occupied, fd, ev->events);
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        if (node == NULL)
+          {
+            errcode = ENOENT;
+            break;
+          }
+
+        epoll_disarm(node);
+        epoll_dequeue(eph, node);
+        epoll_setevents(node, ev);
+        epoll_arm(eph, node);
+        break;
+
+      default:
+        errcode = EINVAL;
+        break;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+  epoll_semgive(eph);
 
-          return -ENOENT;
-        }
+  if (errcode != OK)
+    {
+      set_errno(errcode);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the registered descriptors.  Only the descriptors
+ *   that have posted events are visited so the cost does not depend on the
+ *   number of registered descriptors.
  *
  * Input Parameters:
+ *   epfd      - The epoll instance returned by epoll_create()
+ *   evs       - The location to return the posted events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - Upper limit on the time to wait in milliseconds.  A
+ *               negative value means an infinite timeout.
  *
  * Returned Value:
+ *   The number of events returned in evs; zero if the timeout expired with
+ *   no event.  -1 (ERROR) is returned on failure with the errno value set
+ *   appropriately.
  *
  ****************************************************************************/
 
@@ -194,45 +749,111 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  clock_t start = clock_systimer();
+  int nevents = 0;
+  int ret = OK;
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  DEBUGASSERT(eph != NULL);
 
-  if (rc <= 0)
+  if (evs == NULL || maxevents <= 0)
     {
-      if (rc < 0)
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* epoll_wait() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  for (; ; )
+    {
+      /* Re-poll the level-triggered descriptors reported last time, gather
+       * any pending notifications, and return the ready events.
+       */
+
+      epoll_semtake(eph);
+      epoll_rearm(eph);
+      epoll_drain(eph, 0);
+      nevents = epoll_harvest(eph, evs, maxevents);
+      epoll_semgive(eph);
+
+      if (nevents > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Nothing is ready.  Wait for a notification, a signal, or for the
+       * timeout to expire.
+       */
+
+      if (timeout > 0)
+        {
+          clock_t elapsed = clock_systimer() - start;
+          clock_t ticks;
+
+          /* Round timeout up to next full tick. */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+          ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+                   (USEC_PER_TICK - 1)) / USEC_PER_TICK;
+#else
+          ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+                  MSEC_PER_TICK;
+#endif
+
+          if (elapsed >= ticks)
+            {
+              break;
+            }
+
+          ret = nxsem_tickwait(&eph->sem, start, ticks);
+        }
+      else
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          ret = nxsem_wait(&eph->sem);
+        }
 
-          for (i = 0; i < eph->occupied; i++)
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              ret = OK;
             }
+
+          break;
         }
 
-      return rc;
+      /* Put back the post that we just took so that epoll_drain() will
+       * account for it.
+       */
+
+      nxsem_post(&eph->sem);
     }
 
-  /* Iterate over non NULL event fds */
+  /* Check for events that arrived at the very end of the wait. */
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
+  if (nevents == 0 && ret == OK && timeout != 0)
     {
-      if (eph->evs[counter].revents != 0)
-        {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
-        }
+      epoll_semtake(eph);
+      epoll_drain(eph, 0);
+      nevents = epoll_harvest(eph, evs, maxevents);
+      epoll_semgive(eph);
+    }
+
+  leave_cancellation_point();
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return i;
+  return nevents;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
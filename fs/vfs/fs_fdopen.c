@@ -216,7 +216,32 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
 
   for (i = 0 ; i < CONFIG_NFILE_STREAMS; i++)
     {
-      stream = &slist->sl_streams[i];
+#if STREAMLIST_NEXTRA > 0
+      /* Allocate the rest of the streams when the first of them is needed.
+       * This happens at the appropriate privilege level for the group.
+       */
+
+      if (i == STREAMLIST_NSTDIO && slist->sl_extra == NULL)
+        {
+          int j;
+
+          slist->sl_extra = (FAR struct file_struct *)
+            group_zalloc(tcb->group,
+                         STREAMLIST_NEXTRA * sizeof(struct file_struct));
+          if (slist->sl_extra == NULL)
+            {
+              errcode = ENOMEM;
+              goto errout_with_sem;
+            }
+
+          for (j = 0; j < STREAMLIST_NEXTRA; j++)
+            {
+              slist->sl_extra[j].fs_fd = -1;
+            }
+        }
+
+#endif
+      stream = STREAMLIST_STREAM(slist, i);
       if (stream->fs_fd < 0)
         {
           /* Zero the structure */
@@ -229,6 +254,11 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
           (void)nxsem_init(&stream->fs_sem, 0, 1);
 
 #if CONFIG_STDIO_BUFFER_SIZE > 0
+#ifdef CONFIG_STDIO_LAZYBUFFER
+          /* The IO buffer will be allocated on the first read or write */
+
+          stream->fs_flags  |= __FS_FLAG_LAZY;
+#else
           /* Allocate the IO buffer at the appropriate privilege level for
            * the group.
            */
@@ -247,6 +277,7 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
           stream->fs_bufend  = &stream->fs_bufstart[CONFIG_STDIO_BUFFER_SIZE];
           stream->fs_bufpos  = stream->fs_bufstart;
           stream->fs_bufread = stream->fs_bufstart;
+#endif /* CONFIG_STDIO_LAZYBUFFER */
 
 #ifdef CONFIG_STDIO_LINEBUFFER
           /* Setup buffer flags */
@@ -273,7 +304,9 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
 
   errcode = ENFILE;
 
-#if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && CONFIG_STDIO_BUFFER_SIZE > 0
+#if (!defined(CONFIG_STDIO_DISABLE_BUFFERING) && \
+     CONFIG_STDIO_BUFFER_SIZE > 0 && !defined(CONFIG_STDIO_LAZYBUFFER)) || \
+    STREAMLIST_NEXTRA > 0
 errout_with_sem:
 #endif
   nxsem_post(&slist->sl_sem);
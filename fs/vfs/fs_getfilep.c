@@ -100,8 +100,10 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  /* And return the file pointer from the list */
+  /* And return the file pointer from the list.  If the block holding the
+   * descriptor has not been allocated, then it cannot be open.
+   */
 
-  *filep = &list->fl_files[fd];
-  return OK;
+  *filep = files_fget(list, fd);
+  return *filep != NULL ? OK : -EBADF;
 }
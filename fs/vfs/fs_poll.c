@@ -147,6 +147,8 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
       fds[i].sem     = sem;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
+      fds[i].cb      = NULL;
+      fds[i].arg     = NULL;
 
       /* Check for invalid descriptors. "If the value of fd is less than 0,
        * events shall be ignored, and revents shall be set to 0 in that entry
@@ -305,6 +307,38 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds, int *count,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the poll waiter that events have been posted in fds->revents.
+ *   If the waiter provided a notification callback, then that callback is
+ *   called; otherwise, the poll semaphore is posted.
+ *
+ *   This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with the updated revents.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  DEBUGASSERT(fds != NULL);
+
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+  else if (fds->sem != NULL)
+    {
+      nxsem_post(fds->sem);
+    }
+}
+
 /****************************************************************************
  * Name: file_poll
  *
@@ -360,7 +394,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -414,9 +448,12 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 #endif
 
 /****************************************************************************
- * Name: poll
+ * Name: nx_poll
  *
  * Description:
+ *   nx_poll() is the internal implementation of poll().  It is not a
+ *   cancellation point and it does not modify the errno variable.
+ *
  *   poll() waits for one of a set of file descriptors to become ready to
  *   perform I/O.  If none of the events requested (and no error) has
  *   occurred for any of  the  file  descriptors,  then  poll() blocks until
@@ -432,7 +469,7 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
  * Returned Value:
  *   On success, the number of structures that have non-zero revents fields.
  *   A value of 0 indicates that the call timed out and no file descriptors
- *   were ready.  On error, -1 is returned, and errno is set appropriately:
+ *   were ready.  On error, a negated errno value is returned:
  *
  *   EBADF  - An invalid file descriptor was given in one of the sets.
  *   EFAULT - The fds address is invalid
@@ -444,7 +481,7 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
  *
  ****************************************************************************/
 
-int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+int nx_poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 {
   sem_t sem;
   int count = 0;
@@ -453,10 +490,6 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   DEBUGASSERT(nfds == 0 || fds != NULL);
 
-  /* poll() is a cancellation point */
-
-  (void)enter_cancellation_point();
-
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
    */
@@ -536,17 +569,40 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
     }
 
   nxsem_destroy(&sem);
-  leave_cancellation_point();
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: poll
+ *
+ * Description:
+ *   poll() waits for one of a set of file descriptors to become ready to
+ *   perform I/O.  See nx_poll() for the details.
+ *
+ * Returned Value:
+ *   On success, the number of structures that have non-zero revents fields.
+ *   A value of 0 indicates that the call timed out and no file descriptors
+ *   were ready.  On error, -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  int ret;
+
+  /* poll() is a cancellation point */
 
-  /* Check for errors */
+  (void)enter_cancellation_point();
 
+  ret = nx_poll(fds, nfds, timeout);
   if (ret < 0)
     {
       set_errno(-ret);
-      return ERROR;
+      ret = ERROR;
     }
 
-  return count;
+  leave_cancellation_point();
+  return ret;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
@@ -42,6 +42,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sched.h>
@@ -222,3 +223,228 @@ ssize_t read(int fd, FAR void *buf, size_t nbytes)
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that is accepts a
+ *   struct file instance instead of a file descriptor.  If the driver
+ *   provides a readv method, the whole vector is passed to the driver in
+ *   one call.  Otherwise, the vector is filled one buffer at a time,
+ *   stopping at the first short read.
+ *
+ *  - It does not modify the errno variable,
+ *  - It is not a cancellation point, and
+ *  - It does not handle socket descriptors.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read (zero at the end-of-file) or, if no data was
+ *   read, a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal;
+  ssize_t nread;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  if (iov == NULL || iovcnt < 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (inode == NULL || !inode->u.i_ops || !inode->u.i_ops->read)
+    {
+      return -EBADF;
+    }
+
+  /* Mountpoint operations do not have a readv method; the operations
+   * structures are only common up through the ioctl method.
+   */
+
+  if (!INODE_IS_MOUNTPT(inode) && inode->u.i_ops->readv != NULL)
+    {
+      return inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length reads */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = inode->u.i_ops->read(filep, (FAR char *)iov[i].iov_base,
+                                   iov[i].iov_len);
+      if (nread < 0)
+        {
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      /* Stop at the end-of-file or when there is no more data available */
+
+      ntotal += nread;
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   nx_readv() is the internal OS version of readv().  It is functionally
+ *   equivalent to readv() except that:
+ *
+ *   - It does not modify the errno variable, and
+ *   - It is not a cancellation point.
+ *
+ * Returned Value:
+ *   The number of bytes read (zero at the end-of-file) or, if no data was
+ *   read, a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  /* Did we get a valid file descriptor? */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+#endif
+    {
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      ssize_t ntotal;
+      ssize_t nread;
+      int i;
+
+      if (iov == NULL || iovcnt < 0)
+        {
+          return -EINVAL;
+        }
+
+      /* Receive into each buffer in turn, stopping when less than a full
+       * buffer is received.
+       */
+
+      for (i = 0, ntotal = 0; i < iovcnt; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          nread = nx_recv(fd, iov[i].iov_base, iov[i].iov_len, 0);
+          if (nread < 0)
+            {
+              return ntotal > 0 ? ntotal : nread;
+            }
+
+          ntotal += nread;
+          if ((size_t)nread < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return ntotal;
+#else
+      return -EBADF;
+#endif
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else
+    {
+      FAR struct file *filep;
+      ssize_t ret;
+
+      ret = (ssize_t)fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return file_readv(filep, iov, iovcnt);
+    }
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The readv() function is equivalent to read(), except as described below.
+ *   The readv() function places the input data into the 'iovcnt' buffers
+ *   specified by the members of the 'iov' array: iov[0], iov[1], ...,
+ *   iov['iovcnt'-1].  The 'iovcnt' argument is valid if greater than 0 and
+ *   less than or equal to IOV_MAX.
+ *
+ *   Each iovec entry specifies the base address and length of an area in
+ *   memory where data should be placed.  The readv() function will always
+ *   fill an area completely before proceeding to the next.
+ *
+ * Input Parameters:
+ *   fd     - The open file descriptor for the file to be read
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   Upon successful completion, readv() will return a non-negative integer
+ *   indicating the number of bytes actually read.  Otherwise, the functions
+ *   will return -1 and set errno to indicate the error.  See read() for the
+ *   list of returned errno values.  In addition, the readv() function will
+ *   fail if:
+ *
+ *    EINVAL.
+ *      The 'iovcnt' argument was less than zero.
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let nx_readv() do the real work */
+
+  ret = nx_readv(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
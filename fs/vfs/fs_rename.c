@@ -280,6 +280,7 @@ next_subdir:
   /* Remove all of the children from the unlinked inode */
 
   oldinode->i_child = NULL;
+  inode_cacheinvalidate();
   ret = OK;
 
 errout_with_sem:
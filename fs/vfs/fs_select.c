@@ -42,6 +42,7 @@
 #include <sys/select.h>
 #include <sys/time.h>
 
+#include <stdbool.h>
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
@@ -60,9 +61,9 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
+#ifndef CONFIG_FS_SELECT_NSTACKFDS
+#  define CONFIG_FS_SELECT_NSTACKFDS 0
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -82,7 +83,8 @@
  *   operation under NuttX.  select() is provided for compatibility and
  *   is simply a layer of added logic on top of poll().  As such, select()
  *   is more wasteful of resources and poll() is the recommended API to be
- *   used.
+ *   used.  Up to CONFIG_FS_SELECT_NSTACKFDS descriptors are handled
+ *   without a heap allocation.
  *
  * Input Parameters:
  *   nfds - the maximum fd number (+1) of any descriptor in any of the
@@ -103,8 +105,14 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
-  struct pollfd *pollset = NULL;
-  int errcode = OK;
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  struct pollfd stackset[CONFIG_FS_SELECT_NSTACKFDS];
+#endif
+  FAR struct pollfd *pollset = NULL;
+  pollevent_t events;
+  pollevent_t revents;
+  bool selected;
+  int count;
   int fd;
   int npfds;
   int msec;
@@ -115,9 +123,7 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
 
   (void)enter_cancellation_point();
 
-  /* How many pollfd structures do we need to allocate? */
-
-  /* Initialize the descriptor list for poll() */
+  /* How many pollfd structures do we need? */
 
   for (fd = 0, npfds = 0; fd < nfds; fd++)
     {
@@ -133,25 +139,34 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  /* Allocate the descriptor list for poll() */
+  /* Use the descriptor list on the stack if it is large enough.  Otherwise,
+   * allocate one.
+   */
 
-  if (npfds > 0)
+  if (npfds > CONFIG_FS_SELECT_NSTACKFDS)
     {
       pollset = (FAR struct pollfd *)
-        kmm_zalloc(npfds * sizeof(struct pollfd));
+        kmm_malloc(npfds * sizeof(struct pollfd));
 
       if (pollset == NULL)
         {
-          errcode = ENOMEM;
+          ret = -ENOMEM;
           goto errout;
         }
     }
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  else
+    {
+      pollset = stackset;
+    }
+#endif
 
   /* Initialize the descriptor list for poll() */
 
   for (fd = 0, ndx = 0; fd < nfds; fd++)
     {
-      int incr = 0;
+      events   = 0;
+      selected = false;
 
       /* The readfs set holds the set of FDs that the caller can be assured
        * of reading from without blocking.  Note that POLLHUP is included as
@@ -162,9 +177,8 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
 
       if (readfds && FD_ISSET(fd, readfds))
         {
-          pollset[ndx].fd      = fd;
-          pollset[ndx].events |= POLLIN;
-          incr                 = 1;
+          events  |= POLLIN;
+          selected = true;
         }
 
       /* The writefds set holds the set of FDs that the caller can be assured
@@ -173,20 +187,25 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
 
       if (writefds && FD_ISSET(fd, writefds))
         {
-          pollset[ndx].fd      = fd;
-          pollset[ndx].events |= POLLOUT;
-          incr                 = 1;
+          events  |= POLLOUT;
+          selected = true;
         }
 
-      /* The exceptfds set holds the set of FDs that are watched for exceptions */
+      /* The exceptfds set holds the set of FDs that are watched for
+       * exceptions.  POLLERR is always reported.
+       */
 
       if (exceptfds && FD_ISSET(fd, exceptfds))
         {
-          pollset[ndx].fd      = fd;
-          incr                  = 1;
+          selected = true;
         }
 
-      ndx += incr;
+      if (selected)
+        {
+          pollset[ndx].fd     = fd;
+          pollset[ndx].events = events;
+          ndx++;
+        }
     }
 
   DEBUGASSERT(ndx == npfds);
@@ -208,78 +227,77 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
 
   /* Then let poll do all of the real work. */
 
-  ret = poll(pollset, npfds, msec);
-  if (ret < 0)
-    {
-      /* poll() failed! Save the errno value */
-
-      errcode = get_errno();
-    }
-
-  /* Now set up the return values */
-
-  if (readfds)
-    {
-      memset(readfds, 0, sizeof(fd_set));
-    }
-
-  if (writefds)
-    {
-      memset(writefds, 0, sizeof(fd_set));
-    }
+  ret = nx_poll(pollset, npfds, msec);
 
-  if (exceptfds)
-    {
-      memset(exceptfds, 0, sizeof(fd_set));
-    }
+  /* Convert the poll descriptor list back into selects 3 bitsets.  Only
+   * the descriptors in the list can be set, so just clear those that are
+   * not ready, leaving only the ready ones.
+   */
 
-  /* Convert the poll descriptor list back into selects 3 bitsets */
-
-  if (ret > 0)
+  if (ret >= 0)
     {
-      ret = 0;
+      count = 0;
       for (ndx = 0; ndx < npfds; ndx++)
         {
+          fd      = pollset[ndx].fd;
+          revents = pollset[ndx].revents;
+
           /* Check for read conditions.  Note that POLLHUP is included as a
            * read condition.  POLLHUP will be reported when no more data will
            * be available (such as when a connection is lost).  In either
            * case, the read() can then be performed without blocking.
            */
 
-          if (readfds)
+          if (readfds && FD_ISSET(fd, readfds))
             {
-              if (pollset[ndx].revents & (POLLIN | POLLHUP))
+              if ((revents & (POLLIN | POLLHUP)) != 0)
                 {
-                  FD_SET(pollset[ndx].fd, readfds);
-                  ret++;
+                  count++;
+                }
+              else
+                {
+                  FD_CLR(fd, readfds);
                 }
             }
 
           /* Check for write conditions */
 
-          if (writefds)
+          if (writefds && FD_ISSET(fd, writefds))
             {
-              if (pollset[ndx].revents & POLLOUT)
+              if ((revents & POLLOUT) != 0)
+                {
+                  count++;
+                }
+              else
                 {
-                  FD_SET(pollset[ndx].fd, writefds);
-                  ret++;
+                  FD_CLR(fd, writefds);
                 }
             }
 
           /* Check for exceptions */
 
-          if (exceptfds)
+          if (exceptfds && FD_ISSET(fd, exceptfds))
             {
-              if (pollset[ndx].revents & POLLERR)
+              if ((revents & POLLERR) != 0)
+                {
+                  count++;
+                }
+              else
                 {
-                  FD_SET(pollset[ndx].fd, exceptfds);
-                  ret++;
+                  FD_CLR(fd, exceptfds);
                 }
             }
         }
+
+      ret = count;
     }
 
-  kmm_free(pollset);
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (pollset != stackset)
+#endif
+    {
+      kmm_free(pollset);
+    }
 
   /* Did poll() fail above? */
 
@@ -290,7 +308,7 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
     }
 
 errout:
-  set_errno(errcode);
+  set_errno(-ret);
   leave_cancellation_point();
   return ERROR;
 }
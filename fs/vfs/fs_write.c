@@ -41,7 +41,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <string.h>
 #include <fcntl.h>
 #include <sched.h>
 #include <errno.h>
@@ -52,6 +54,7 @@
 #endif
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
 #include "inode/inode.h"
@@ -253,3 +256,256 @@ ssize_t write(int fd, FAR const void *buf, size_t nbytes)
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that is accepts a
+ *   struct file instance instead of a file descriptor.  If the driver
+ *   provides a writev method, the whole vector is passed to the driver in
+ *   one call.  Otherwise, the vector is written one buffer at a time,
+ *   stopping at the first short write.
+ *
+ *  - It does not modify the errno variable,
+ *  - It is not a cancellation point, and
+ *  - It does not handle socket descriptors.
+ *
+ * Input Parameters:
+ *   filep  - Instance of struct file to use with the write
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *  On success, the number of bytes written are returned.  On any failure,
+ *  a negated errno value is returned.  If the failure occurs after some
+ *  data was written, the number of bytes written is returned instead.
+ *
+ ****************************************************************************/
+
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal;
+  ssize_t nwritten;
+  int i;
+
+  if (iov == NULL || iovcnt < 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  inode = filep->f_inode;
+  if (!inode || !inode->u.i_ops || !inode->u.i_ops->write)
+    {
+      return -EBADF;
+    }
+
+  /* Mountpoint operations do not have a writev method; the operations
+   * structures are only common up through the ioctl method.
+   */
+
+  if (!INODE_IS_MOUNTPT(inode) && inode->u.i_ops->writev != NULL)
+    {
+      return inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length writes */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = inode->u.i_ops->write(filep, iov[i].iov_base,
+                                       iov[i].iov_len);
+      if (nwritten < 0)
+        {
+          return ntotal > 0 ? ntotal : nwritten;
+        }
+
+      ntotal += nwritten;
+      if ((size_t)nwritten < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *  nx_writev() is the internal OS version of writev().  It is functionally
+ *  equivalent to writev() except that:
+ *
+ *  - It does not modify the errno variable, and
+ *  - It is not a cancellation point.
+ *
+ *  A writev() to a socket gathers the data and sends it with a single
+ *  send() so that, for example, a header and its payload go out as one
+ *  TCP segment.  If memory for the gather buffer is not available, each
+ *  buffer is sent separately.
+ *
+ * Returned Value:
+ *  On success, the number of bytes written are returned.  On any failure,
+ *  a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+#endif
+  ssize_t ret;
+
+  /* Did we get a valid file descriptor? */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+#endif
+    {
+#if defined(CONFIG_NET_TCP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      FAR uint8_t *buffer;
+      FAR uint8_t *dest;
+      size_t ntotal;
+      int i;
+
+      if (iov == NULL || iovcnt < 0)
+        {
+          return -EINVAL;
+        }
+
+      for (i = 0, ntotal = 0; i < iovcnt; i++)
+        {
+          ntotal += iov[i].iov_len;
+        }
+
+      if (ntotal == 0)
+        {
+          return 0;
+        }
+
+      buffer = (FAR uint8_t *)kmm_malloc(ntotal);
+      if (buffer != NULL)
+        {
+          for (i = 0, dest = buffer; i < iovcnt; i++)
+            {
+              memcpy(dest, iov[i].iov_base, iov[i].iov_len);
+              dest += iov[i].iov_len;
+            }
+
+          ret = nx_send(fd, buffer, ntotal, 0);
+          kmm_free(buffer);
+        }
+      else
+        {
+          ssize_t nsent;
+
+          for (i = 0, ret = 0; i < iovcnt; i++)
+            {
+              if (iov[i].iov_len == 0)
+                {
+                  continue;
+                }
+
+              nsent = nx_send(fd, iov[i].iov_base, iov[i].iov_len, 0);
+              if (nsent < 0)
+                {
+                  ret = ret > 0 ? ret : nsent;
+                  break;
+                }
+
+              ret += nsent;
+              if ((size_t)nsent < iov[i].iov_len)
+                {
+                  break;
+                }
+            }
+        }
+#else
+      ret = -EBADF;
+#endif
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else
+    {
+      ret = (ssize_t)fs_getfilep(fd, &filep);
+      if (ret >= 0)
+        {
+          ret = file_writev(filep, iov, iovcnt);
+        }
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The writev() function is equivalent to write(), except as described
+ *   below. The writev() function will gather output data from the 'iovcnt'
+ *   buffers specified by the members of the 'iov' array: iov[0], iov[1], ...,
+ *   iov[iovcnt-1]. The 'iovcnt' argument is valid if greater than 0 and less
+ *   than or equal to IOV_MAX, as defined in limits.h.
+ *
+ *   Each iovec entry specifies the base address and length of an area in
+ *   memory from which data should be written. The writev() function always
+ *   writes a complete area before proceeding to the next.
+ *
+ *   If 'filedes' refers to a regular file and all of the iov_len members in
+ *   the array pointed to by iov are 0, writev() will return 0 and have no
+ *   other effect. For other file types, the behavior is unspecified.
+ *
+ * Input Parameters:
+ *   fd     - The open file descriptor for the file to be written
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   Upon successful completion, writev() shall return the number of bytes
+ *   actually written. Otherwise, it shall return a value of -1 and errno
+ *   shall be set to indicate an error. See write for the list of returned
+ *   errno values. In addition, the writev() function will fail if:
+ *
+ *    EINVAL.
+ *      The 'iovcnt' argument was less than zero.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let nx_writev() do all of the work */
+
+  ret = nx_writev(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
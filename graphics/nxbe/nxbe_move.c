@@ -78,7 +78,7 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 {
   struct nxbe_move_s *info = (struct nxbe_move_s *)cops;
   struct nxgl_point_s offset;
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_UPDATE) && !defined(CONFIG_NX_UPDATE_MOVE)
   struct nxgl_rect_s update;
 #endif
 
@@ -93,7 +93,12 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
 
       plane->moverectangle(&plane->pinfo, rect, &offset);
 
-#ifdef CONFIG_NX_UPDATE
+#if defined(CONFIG_NX_UPDATE_MOVE)
+      /* Notify external logic that the region has been moved */
+
+      nx_notify_move(&plane->pinfo, rect, &offset);
+
+#elif defined(CONFIG_NX_UPDATE)
       /* Notify external logic that the display has been updated */
 
       update.pt1.x = offset.x;
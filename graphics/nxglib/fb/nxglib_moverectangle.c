@@ -93,7 +93,7 @@ static inline void nxgl_lowresmemcpy(FAR uint8_t *dline, FAR const uint8_t *slin
 
    if (lnlen > 0)
      {
-       NXGL_MEMCPY(dptr, sptr, lnlen);
+       NXGL_MEMMOVE(dptr, sptr, lnlen);
      }
 }
 #endif
@@ -178,7 +178,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
    */
 
   if (offset->y < rect->pt1.y ||
-     (offset->y < rect->pt1.y && offset->x <= rect->pt1.x))
+     (offset->y == rect->pt1.y && offset->x <= rect->pt1.x))
     {
       /* Yes.. Copy the rectangle from top down (i.e., adding the stride
        * to move to the next, lower row) */
@@ -190,7 +190,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
           /* Point to the next source/dest row below the current one */
 
@@ -229,7 +229,7 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
 #if NXGLIB_BITSPERPIXEL < 8
           nxgl_lowresmemcpy(dline, sline, width, leadmask, tailmask);
 #else
-          NXGL_MEMCPY(dline, sline, width);
+          NXGL_MEMMOVE(dline, sline, width);
 #endif
         }
     }
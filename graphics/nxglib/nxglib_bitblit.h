@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -121,52 +122,24 @@
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+   memset((dest), (value), NXGL_SCALEX(width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memcpy((dest), (src), NXGL_SCALEX(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+   nxgl_memset24((FAR uint8_t *)(dest), (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memcpy((dest), (src), 3 * (size_t)(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+   memmove((dest), (src), 3 * (size_t)(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -185,28 +158,24 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
-
-#  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+#else /* NXGLIB_BITSPERPIXEL == 8, 16, or 32 */
+
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_MEMSET(dest,value,width) \
+     memset((dest), (value), (width))
+#  elif NXGLIB_BITSPERPIXEL == 16
+#    define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset16((FAR uint16_t *)(dest), (value), (width))
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset32((FAR uint32_t *)(dest), (value), (width))
+#  endif
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memcpy((dest), (src), sizeof(NXGL_PIXEL_T) * (size_t)(width))
+
+#  define NXGL_MEMMOVE(dest,src,width) \
+   memmove((dest), (src), sizeof(NXGL_PIXEL_T) * (size_t)(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -229,6 +198,138 @@
  * Public Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_memset16, nxgl_memset24, nxgl_memset32
+ *
+ * Description:
+ *   Fill a run of pixels with one color.  Rather than storing one pixel at
+ *   a time, a few leading pixels are stored until the destination is word
+ *   aligned, then whole 32-bit words (holding 2 16-bit pixels or 4 24-bit
+ *   pixels in 3 words) are stored, four words per iteration where
+ *   possible.  This is several times faster than a pixel loop for all but
+ *   the shortest runs.  16-bit and 32-bit pixels must be naturally
+ *   aligned.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_memset16(FAR uint16_t *dest, uint16_t color,
+                                 size_t npixels)
+{
+  FAR uint32_t *wdest;
+  uint32_t wide;
+
+  if (((uintptr_t)dest & 2) != 0 && npixels > 0)
+    {
+      *dest++ = color;
+      npixels--;
+    }
+
+  wide  = ((uint32_t)color << 16) | color;
+  wdest = (FAR uint32_t *)dest;
+
+  for (; npixels >= 8; npixels -= 8)
+    {
+      wdest[0] = wide;
+      wdest[1] = wide;
+      wdest[2] = wide;
+      wdest[3] = wide;
+      wdest   += 4;
+    }
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wdest++ = wide;
+    }
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wdest = color;
+    }
+}
+#endif
+
+#if NXGLIB_BITSPERPIXEL == 24
+static inline void nxgl_memset24(FAR uint8_t *dest, uint32_t color,
+                                 size_t npixels)
+{
+  FAR uint32_t *wdest;
+  uint32_t pattern[3];
+  uint8_t bytes[12];
+  int i;
+
+  /* Store single pixels until the destination is word aligned (at most
+   * three, since each pixel advances the alignment by three bytes).
+   */
+
+  while (((uintptr_t)dest & 3) != 0 && npixels > 0)
+    {
+      *dest++ = color;
+      *dest++ = color >> 8;
+      *dest++ = color >> 16;
+      npixels--;
+    }
+
+  if (npixels >= 4)
+    {
+      /* Four pixels are exactly three words.  Build them in memory order,
+       * which keeps this independent of the CPU byte order.
+       */
+
+      for (i = 0; i < 12; i += 3)
+        {
+          bytes[i]     = color;
+          bytes[i + 1] = color >> 8;
+          bytes[i + 2] = color >> 16;
+        }
+
+      memcpy(pattern, bytes, sizeof(pattern));
+      wdest = (FAR uint32_t *)dest;
+
+      for (; npixels >= 4; npixels -= 4)
+        {
+          wdest[0] = pattern[0];
+          wdest[1] = pattern[1];
+          wdest[2] = pattern[2];
+          wdest   += 3;
+        }
+
+      dest = (FAR uint8_t *)wdest;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = color;
+      *dest++ = color >> 8;
+      *dest++ = color >> 16;
+    }
+}
+#endif
+
+#if NXGLIB_BITSPERPIXEL == 24 || NXGLIB_BITSPERPIXEL == 32
+static inline void nxgl_memset32(FAR uint32_t *dest, uint32_t color,
+                                 size_t npixels)
+{
+  for (; npixels >= 4; npixels -= 4)
+    {
+      dest[0] = color;
+      dest[1] = color;
+      dest[2] = color;
+      dest[3] = color;
+      dest   += 4;
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = color;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
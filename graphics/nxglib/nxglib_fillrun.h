@@ -44,6 +44,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "nxglib_bitblit.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -161,10 +163,7 @@ static inline void nxgl_fillrun_16bpp(FAR uint16_t *run, nxgl_mxpixel_t color,
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 
-  while (npixels-- > 0)
-    {
-      *run++ = (uint16_t)color;
-    }
+  nxgl_memset16(run, (uint16_t)color, npixels);
 }
 
 #elif NXGLIB_BITSPERPIXEL == 24
@@ -172,10 +171,7 @@ static inline void nxgl_fillrun_24bpp(FAR uint32_t *run, nxgl_mxpixel_t color, s
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 #warning "Assuming 24-bit color is not packed"
-  while (npixels-- > 0)
-    {
-      *run++ = (uint32_t)color;
-    }
+  nxgl_memset32(run, (uint32_t)color, npixels);
 }
 
 #elif NXGLIB_BITSPERPIXEL == 32
@@ -183,10 +179,7 @@ static inline void nxgl_fillrun_32bpp(FAR uint32_t *run, nxgl_mxpixel_t color, s
 {
   /* Fill the run with the color (it is okay to run a fractional byte overy the end */
 
-  while (npixels-- > 0)
-    {
-      *run++ = (uint32_t)color;
-    }
+  nxgl_memset32(run, (uint32_t)color, npixels);
 }
 #else
 #  error "Unsupported value of NXGLIB_BITSPERPIXEL"
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #include <nuttx/semaphore.h>
@@ -140,6 +141,7 @@ struct nxterm_state_s
   uint16_t nchars;                          /* Number of chars in the bm[] array */
 
   struct nxgl_point_s fpos;                 /* Next display position */
+  bool deferscroll;                         /* Scroll once when write ends */
 
   /* VT100 escape sequence processing */
 
@@ -230,5 +232,6 @@ void nxterm_hidecursor(FAR struct nxterm_state_s *priv);
 /* Scrolling support */
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight);
+void nxterm_flushscroll(FAR struct nxterm_state_s *priv);
 
 #endif /* __GRAPHICS_NXTERM_NXTERM_H */
@@ -166,6 +166,10 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
 
   nxterm_hidecursor(priv);
 
+  /* Defer scrolling until all of the characters have been written */
+
+  priv->deferscroll = true;
+
   /* Loop writing each character to the display */
 
   for (remaining = (ssize_t)buflen; remaining > 0; remaining--)
@@ -241,8 +245,11 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
       while (state == VT100_ABORT);
     }
 
-  /* Show the cursor at its new position */
+  /* Perform any deferred scrolling and show the cursor at its new
+   * position.
+   */
 
+  priv->deferscroll = false;
   nxterm_showcursor(priv);
   nxterm_sempost(priv);
   return (ssize_t)buflen;
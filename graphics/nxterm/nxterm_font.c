@@ -278,7 +278,6 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
   FAR const struct nxfonts_glyph_s *glyph;
   struct nxgl_rect_s bounds;
   struct nxgl_rect_s intersection;
-  struct nxgl_size_s fsize;
   int ret;
 
   /* Handle the special case of spaces which have no glyph bitmap */
@@ -288,10 +287,13 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
       return;
     }
 
-  /* Get the size of the font glyph (which may not have been created yet) */
+  /* Find (or create) the glyph that goes with this font.  The rendered
+   * glyph also carries the size of the font bitmap, so there is no need to
+   * look up the font bitmap separately.
+   */
 
-  ret = nxterm_fontsize(priv, bm->code, &fsize);
-  if (ret < 0)
+  glyph = nxf_cache_getglyph(priv->fcache, bm->code);
+  if (!glyph)
     {
       /* This would mean that there is no bitmap for the character code and
        * that the font would be rendered as a space.  But this case should
@@ -306,8 +308,8 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
 
   bounds.pt1.x = bm->pos.x;
   bounds.pt1.y = bm->pos.y;
-  bounds.pt2.x = bm->pos.x + fsize.w - 1;
-  bounds.pt2.y = bm->pos.y + fsize.h - 1;
+  bounds.pt2.x = bm->pos.x + glyph->width - 1;
+  bounds.pt2.y = bm->pos.y + glyph->height - 1;
 
   /* Should this also be clipped to a region in the window? */
 
@@ -330,21 +332,12 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
     {
       FAR const void *src;
 
-      /* Find (or create) the glyph that goes with this font */
-
-      glyph = nxf_cache_getglyph(priv->fcache, bm->code);
-      if (!glyph)
-        {
-          /* Shouldn't happen */
-
-          return;
-        }
-
       /* Blit the font bitmap into the window */
 
       src = (FAR const void *)glyph->bitmap;
       ret = priv->ops->bitmap(priv, &intersection, &src,
                               &bm->pos, (unsigned int)glyph->stride);
       DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
     }
 }
@@ -110,20 +110,25 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
       return;
     }
 
-  /* Check if we need to scroll up */
+  /* Check if we need to scroll up.  While a write is in progress, the
+   * scroll is deferred so that the display is moved only once for all of
+   * the lines that were written.  Characters below the window are then
+   * drawn by the scroll logic.  But scroll now if there is no space left to
+   * retain another character.
+   */
 
-  lineheight = (priv->fheight + CONFIG_NXTERM_LINESEPARATION);
-  while (priv->fpos.y >= priv->wndo.wsize.h - lineheight)
+  if (!priv->deferscroll || priv->nchars >= priv->maxchars)
     {
-      nxterm_scroll(priv, lineheight);
+      nxterm_flushscroll(priv);
     }
 
   /* Find the glyph associated with the character and render it onto the
-   * display.
+   * display (if it is not below the window).
    */
 
+  lineheight = (priv->fheight + CONFIG_NXTERM_LINESEPARATION);
   bm = nxterm_addchar(priv, ch);
-  if (bm)
+  if (bm && bm->pos.y < priv->wndo.wsize.h - lineheight)
     {
       nxterm_fillchar(priv, NULL, bm);
     }
@@ -139,8 +144,6 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
 
 void nxterm_showcursor(FAR struct nxterm_state_s *priv)
 {
-  int lineheight;
-
   /* Will another character fit on this line? */
 
   if (priv->fpos.x + priv->fwidth > priv->wndo.wsize.w)
@@ -156,11 +159,7 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
 
   /* Check if we need to scroll up */
 
-  lineheight = (priv->fheight + CONFIG_NXTERM_LINESEPARATION);
-  while (priv->fpos.y >= priv->wndo.wsize.h - lineheight)
-    {
-      nxterm_scroll(priv, lineheight);
-    }
+  nxterm_flushscroll(priv);
 
   /* Render the cursor glyph onto the display. */
 
@@ -129,47 +129,72 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
                                      int bottom, int scrollheight)
 {
+  FAR struct nxterm_bitmap_s *bm;
   struct nxgl_rect_s rect;
   struct nxgl_point_s offset;
   int ret;
-
-  /* Add the line separation value to the scroll height */
-
-  scrollheight += CONFIG_NXTERM_LINESEPARATION;
+  int i;
 
   /* Move the display in the range of 0-height up one scrollheight.  The
-   * line at the bottom will be reset to the background color automatically.
+   * characters were moved up by exactly scrollheight in nxterm_scroll() so
+   * the display must be moved by the same amount.
    *
    * The source rectangle to be moved.
    */
 
   rect.pt1.x = 0;
-  rect.pt1.y = scrollheight;
   rect.pt2.x = priv->wndo.wsize.w - 1;
   rect.pt2.y = priv->wndo.wsize.h - 1;
 
-  /* The offset that determines how far to move the source rectangle */
+  /* Nothing that is on display survives a scroll by the full height of the
+   * window.  In that case, the window is just cleared below.
+   */
 
-  offset.x   = 0;
-  offset.y   = -scrollheight;
+  if (scrollheight < priv->wndo.wsize.h)
+    {
+      rect.pt1.y = scrollheight;
 
-  /* Move the source rectangle upward by the scrollheight */
+      /* The offset that determines how far to move the source rectangle */
 
-  ret = priv->ops->move(priv, &rect, &offset);
-  if (ret < 0)
+      offset.x   = 0;
+      offset.y   = -scrollheight;
+
+      /* Move the source rectangle upward by the scrollheight */
+
+      ret = priv->ops->move(priv, &rect, &offset);
+      if (ret < 0)
+        {
+          gerr("ERROR: Move failed: %d\n", errno);
+        }
+
+      rect.pt1.y = priv->wndo.wsize.h - scrollheight;
+    }
+  else
     {
-      gerr("ERROR: Move failed: %d\n", errno);
+      rect.pt1.y = 0;
     }
 
-  /* Finally, clear the vacated bottom part of the display */
-
-  rect.pt1.y = priv->wndo.wsize.h - scrollheight;
+  /* Clear the vacated bottom part of the display */
 
   ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
   if (ret < 0)
     {
       gerr("ERROR: Fill failed: %d\n", errno);
     }
+
+  /* Finally, draw any characters that were added below the window while
+   * the scroll was deferred and that have now moved into the vacated
+   * region.
+   */
+
+  for (i = 0; i < priv->nchars; i++)
+    {
+      bm = &priv->bm[i];
+      if (bm->pos.y + priv->fheight > rect.pt1.y)
+        {
+          nxterm_fillchar(priv, &rect, bm);
+        }
+    }
 }
 #endif
 
@@ -186,45 +211,37 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character.  Characters that are
+   * kept are packed down over the deleted ones in a single pass ('j' is the
+   * index where the next kept character goes).
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
       FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
 
-      /* Has any part of this character scrolled off the screen? */
+      /* Has any part of this character scrolled off the screen?  If so, it
+       * is deleted simply by not keeping it.
+       */
 
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars-1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j+1],
-                     sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
+          /* No.. just decrement its vertical position (moving it "up" the
+           * display) and keep it.
            */
 
-          priv->nchars--;
-        }
-
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
-
-      else
-        {
           bm->pos.y -= scrollheight;
+          if (j != i)
+            {
+              memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
+            }
 
-          /* We are keeping this one so increment to the next character */
-
-          i++;
+          j++;
         }
     }
 
+  priv->nchars = j;
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
@@ -233,3 +250,29 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 
   nxterm_movedisplay(priv, priv->fpos.y, scrollheight);
 }
+
+/****************************************************************************
+ * Name: nxterm_flushscroll
+ *
+ * Description:
+ *   Scroll the display up just far enough that there is room for a line of
+ *   text at the current display position.  All of the lines are scrolled
+ *   with one operation.
+ *
+ ****************************************************************************/
+
+void nxterm_flushscroll(FAR struct nxterm_state_s *priv)
+{
+  int lineheight;
+  int bottom;
+  int nlines;
+
+  lineheight = priv->fheight + CONFIG_NXTERM_LINESEPARATION;
+  bottom     = priv->wndo.wsize.h - lineheight;
+
+  if (priv->fpos.y >= bottom)
+    {
+      nlines = (priv->fpos.y - bottom) / lineheight + 1;
+      nxterm_scroll(priv, nlines * lineheight);
+    }
+}
@@ -888,3 +888,43 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
     }
 }
 #endif
+
+/****************************************************************************
+ * Name: nx_notify_move
+ *
+ * Description:
+ *   When CONFIG_NX_UPDATE_MOVE=y, then the graphics system will call this
+ *   function instead of nx_notify_rectangle() when a rectangular region
+ *   has been moved on the display.  'rect' is the source region and 'pos'
+ *   is the new position of its upper left corner.  The move is sent to the
+ *   client as a CopyRect if possible.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_MOVE
+void nx_notify_move(FAR NX_PLANEINFOTYPE *pinfo,
+                    FAR const struct nxgl_rect_s *rect,
+                    FAR const struct nxgl_point_s *pos)
+{
+  FAR struct vnc_session_s *session;
+  int ret;
+
+  DEBUGASSERT(pinfo != NULL && rect != NULL && pos != NULL);
+
+  DEBUGASSERT(pinfo->display >= 0 && pinfo->display < RFB_MAX_DISPLAYS);
+  session = g_vnc_sessions[pinfo->display];
+
+  /* Verify that the session is still valid */
+
+  if (session != NULL && session->state == VNCSERVER_RUNNING)
+    {
+      /* Queue the CopyRect (or the equivalent rectangular update) */
+
+      ret = vnc_copy_rectangle(session, rect, pos);
+      if (ret < 0)
+        {
+          gerr("ERROR: vnc_copy_rectangle failed: %d\n", ret);
+        }
+    }
+}
+#endif
@@ -466,6 +466,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle = false;
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  session->copyrect = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -482,6 +488,18 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_ZRLE
+      else if (encoding == RFB_ENCODING_ZRLE)
+        {
+          session->zrle = true;
+        }
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      else if (encoding == RFB_ENCODING_COPYRECT)
+        {
+          session->copyrect = true;
+        }
+#endif
     }
 
   session->change = true;
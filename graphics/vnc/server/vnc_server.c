@@ -139,6 +139,14 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->state   = VNCSERVER_INITIALIZED;
   session->nwhupd  = 0;
   session->change  = true;
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle    = false;
+  session->zrlehdr = false;
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  session->copyrect = false;
+  session->current  = NULL;
+#endif
 
   /* Careful not to disturb the keyboard/mouse callouts set by
    * vnc_fbinitialize().  Client related data left in garbage state.
@@ -231,6 +231,10 @@ struct vnc_fbupdate_s
 {
   FAR struct vnc_fbupdate_s *flink;
   bool whupd;                  /* True: whole screen update */
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  bool copy;                   /* True: CopyRect from 'src' to 'rect' */
+  struct nxgl_point_s src;     /* Source position of a CopyRect */
+#endif
   struct nxgl_rect_s rect;     /* The enqueued update rectangle */
 };
 
@@ -249,8 +253,16 @@ struct vnc_session_s
   uint8_t display;             /* Display number (for debug) */
   volatile uint8_t colorfmt;   /* Remote color format (See include/nuttx/fb.h) */
   volatile uint8_t bpp;        /* Remote bits per pixel */
+  volatile uint8_t depth;      /* Remote color depth */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_ZRLE
+  volatile bool zrle;          /* True: Remote supports ZRLE encoding */
+  bool zrlehdr;                /* True: zlib stream header has been sent */
+#endif
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  volatile bool copyrect;      /* True: Remote supports CopyRect encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -270,6 +282,15 @@ struct vnc_session_s
   sq_queue_t updqueue;
   sem_t freesem;
   sem_t queuesem;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  FAR struct vnc_fbupdate_s *current; /* Update being sent by the updater */
+#endif
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  /* ZRLE tile palette */
+
+  uint32_t palette[127];
+#endif
 
   /* I/O buffers for misc network send/receive */
 
@@ -459,6 +480,33 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct nxgl_rect_s *rect,
                          bool change);
 
+/****************************************************************************
+ * Name: vnc_copy_rectangle
+ *
+ * Description:
+ *  Queue a CopyRect update:  A rectangular region of the display has been
+ *  moved within the local framebuffer.  If the client is known to hold the
+ *  same content at the source position, then it is told to copy the
+ *  region itself.  Otherwise, this falls back to a normal update of the
+ *  destination region.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The source rectangle of the move.
+ *   pos     - The new position of upper left corner of the rectangle.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copy_rectangle(FAR struct vnc_session_s *session,
+                       FAR const struct nxgl_rect_s *rect,
+                       FAR const struct nxgl_point_s *pos);
+#endif
+
 /****************************************************************************
  * Name: vnc_receiver
  *
@@ -498,6 +546,57 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.  The update region
+ *  is split into tiles that fit into the update buffer and each tile is
+ *  palettized and/or run-length encoded, whichever is smallest.  The
+ *  encoded tiles are sent as stored (uncompressed) blocks of the zlib
+ *  stream; the palette and run-length encoding gives the compression.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if ZRLE coding was not performed (but not error was)
+ *   encountered.  Otherwise, the number of bytes sent is returned on
+ *   success or a negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned in
+ *   cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_copyrect
+ *
+ * Description:
+ *  Send a framebuffer update using the CopyRect encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The destination rectangle in the local framebuffer.
+ *   src     - The upper left corner of the source rectangle.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copyrect(FAR struct vnc_session_s *session,
+                 FAR const struct nxgl_rect_s *rect,
+                 FAR const struct nxgl_point_s *src);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -336,6 +336,14 @@ vnc_remove_queue(FAR struct vnc_session_s *session)
       updinfo("Whole screen update: nwhupd=%d\n", session->nwhupd);
     }
 
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  /* Remember the update that is being sent.  The client does not yet hold
+   * the content of that region.
+   */
+
+  session->current = rect;
+#endif
+
   sched_unlock();
   return rect;
 }
@@ -381,6 +389,85 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_rectarea
+ *
+ * Description:
+ *   Return the area of a rectangle in pixels.
+ *
+ ****************************************************************************/
+
+static inline uint32_t vnc_rectarea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: vnc_coalesce
+ *
+ * Description:
+ *   Try to merge a new update rectangle into an update that is already
+ *   queued.  The framebuffer content is read when the update is sent so
+ *   any queued update that covers a region will send the latest content
+ *   of that region; sending it twice only wastes bandwidth.  Two
+ *   rectangles are merged if their bounding box is no larger than the sum
+ *   of their areas, i.e., if they overlap or nearly abut.
+ *
+ *   Updates may not be merged across a queued CopyRect:  The client
+ *   would then receive the new content before the copy was performed.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The new, clipped update rectangle
+ *
+ * Returned Value:
+ *   True if the rectangle was merged into a queued update.
+ *
+ * Assumptions:
+ *   The scheduler is locked.
+ *
+ ****************************************************************************/
+
+static bool vnc_coalesce(FAR struct vnc_session_s *session,
+                         FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  FAR struct vnc_fbupdate_s *first;
+  struct nxgl_rect_s bounds;
+  uint32_t area;
+
+  /* Find the first update following the last queued CopyRect */
+
+  first = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  for (curr = first; curr != NULL; curr = curr->flink)
+    {
+      if (curr->copy)
+        {
+          first = curr->flink;
+        }
+    }
+#endif
+
+  area = vnc_rectarea(rect);
+  for (curr = first; curr != NULL; curr = curr->flink)
+    {
+      nxgl_rectunion(&bounds, &curr->rect, rect);
+      if (vnc_rectarea(&bounds) <= vnc_rectarea(&curr->rect) + area)
+        {
+          updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                  rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+
+          nxgl_rectcopy(&curr->rect, &bounds);
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -424,18 +511,44 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      if (srcrect->copy)
+        {
+          /* The client copies the region from its own framebuffer */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+          ret = vnc_copyrect(session, &srcrect->rect, &srcrect->src);
+        }
+      else
+#endif
         {
-          /* Perform the framebuffer update using the default RAW encoding */
+          /* Attempt to use RRE encoding */
+
+          ret = vnc_rre(session, &srcrect->rect);
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+          if (ret == 0)
+            {
+              /* Not a single color.  Attempt to use ZRLE encoding */
+
+              ret = vnc_zrle(session, &srcrect->rect);
+            }
+#endif
+
+          if (ret == 0)
+            {
+              /* Perform the framebuffer update using the default RAW
+               * encoding
+               */
 
-          ret = vnc_raw(session, &srcrect->rect);
+              ret = vnc_raw(session, &srcrect->rect);
+            }
         }
 
       /* Release the update structure */
 
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      session->current = NULL;
+#endif
       vnc_free_update(session, srcrect);
 
       /* Break out and terminate the server if the encoding failed */
@@ -637,6 +750,14 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Just extend a queued update if this region overlaps it */
+
+              if (vnc_coalesce(session, &intersection))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
@@ -647,6 +768,9 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
           /* Copy the clipped rectangle into the update structure */
 
           update->whupd = whupd;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+          update->copy  = false;
+#endif
           nxgl_rectcopy(&update->rect, &intersection);
 
           /* Add the upate to the end of the update queue. */
@@ -667,3 +791,105 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_copy_rectangle
+ *
+ * Description:
+ *  Queue a CopyRect update:  A rectangular region of the display has been
+ *  moved within the local framebuffer.  If the client is known to hold the
+ *  same content at the source position, then it is told to copy the
+ *  region itself.  Otherwise, this falls back to a normal update of the
+ *  destination region.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The source rectangle of the move.
+ *   pos     - The new position of upper left corner of the rectangle.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copy_rectangle(FAR struct vnc_session_s *session,
+                       FAR const struct nxgl_rect_s *rect,
+                       FAR const struct nxgl_point_s *pos)
+{
+  FAR struct vnc_fbupdate_s *update;
+  FAR struct vnc_fbupdate_s *curr;
+  struct nxgl_rect_s src;
+  struct nxgl_rect_s dest;
+  struct nxgl_rect_s clipped;
+
+  nxgl_rectcopy(&src, rect);
+  nxgl_rectoffset(&dest, rect, pos->x - rect->pt1.x, pos->y - rect->pt1.y);
+
+  /* The client can only copy what it already has.  That is not the case if
+   * any part of the source region is still waiting to be sent (or is being
+   * sent right now):  When sent, that update would already contain the
+   * moved content.  Both rectangles must also be entirely on the screen.
+   */
+
+  sched_lock();
+  if (!session->copyrect || session->nwhupd > 0)
+    {
+      goto fallback;
+    }
+
+  nxgl_rectintersect(&clipped, rect, &g_wholescreen);
+  if (memcmp(&clipped, rect, sizeof(struct nxgl_rect_s)) != 0)
+    {
+      goto fallback;
+    }
+
+  nxgl_rectintersect(&clipped, &dest, &g_wholescreen);
+  if (memcmp(&clipped, &dest, sizeof(struct nxgl_rect_s)) != 0)
+    {
+      goto fallback;
+    }
+
+  if (session->current != NULL && !session->current->copy &&
+      nxgl_rectoverlap(&session->current->rect, &src))
+    {
+      goto fallback;
+    }
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL;
+       curr = curr->flink)
+    {
+      if (!curr->copy && nxgl_rectoverlap(&curr->rect, &src))
+        {
+          goto fallback;
+        }
+    }
+
+  /* Queue the CopyRect.  Allocate an update structure... waiting if
+   * necessary
+   */
+
+  update = vnc_alloc_update(session);
+  DEBUGASSERT(update != NULL);
+
+  update->whupd = false;
+  update->copy  = true;
+  update->src   = rect->pt1;
+  nxgl_rectcopy(&update->rect, &dest);
+
+  vnc_add_queue(session, update);
+  session->change = true;
+  sched_unlock();
+
+  updinfo("Queued copy (%d, %d) to {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, dest.pt1.x, dest.pt1.y,
+          dest.pt2.x, dest.pt2.y);
+  return OK;
+
+fallback:
+  sched_unlock();
+  return vnc_update_rectangle(session, &dest, true);
+}
+#endif
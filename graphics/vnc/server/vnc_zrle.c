@@ -0,0 +1,791 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_zrle.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_FEATURES
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  define CONFIG_DEBUG_FEATURES 1
+#  define CONFIG_DEBUG_ERROR    1
+#  define CONFIG_DEBUG_WARN     1
+#  define CONFIG_DEBUG_INFO     1
+#  define CONFIG_DEBUG_GRAPHICS 1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ZRLE_TILESIZE     64    /* Maximum width and height of a tile */
+#define ZRLE_MAXPALETTE   127   /* Maximum size of a tile palette */
+#define ZRLE_MAXPACKED    16    /* Maximum size of a packed palette */
+
+/* The zlib stream header (deflate, 32K window, no dictionary) that precedes
+ * the first ZRLE rectangle and the size of the header of each stored
+ * deflate block.
+ */
+
+#define ZLIB_CMF          0x78
+#define ZLIB_FLG          0x01
+#define ZLIB_HDRSIZE      2
+#define ZLIB_STOREDSIZE   5
+#define ZLIB_MAXSTORED    65535
+
+/* Size of the FramebufferUpdate header with one rectangle header */
+
+#define ZRLE_UPDHDRSIZE \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
+
+/* Bytes needed to encode a run length */
+
+#define ZRLE_RUNSIZE(n)   (((n) + 254) / 255)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State that is fixed for one ZRLE update */
+
+struct vnc_zrle_s
+{
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+
+  uint8_t bytesperpixel;       /* Remote bytes per pixel */
+  uint8_t cpixelsize;          /* Remote bytes per compressed pixel */
+  bool bigendian;              /* True: Remote expects big-endian data */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle_convert
+ *
+ * Description:
+ *   Convert a local framebuffer color to the remote pixel value.
+ *
+ ****************************************************************************/
+
+static inline uint32_t vnc_zrle_convert(FAR const struct vnc_zrle_s *enc,
+                                        lfb_color_t color)
+{
+  if (enc->bytesperpixel == 1)
+    {
+      return enc->convert.bpp8(color);
+    }
+  else if (enc->bytesperpixel == 2)
+    {
+      return enc->convert.bpp16(color);
+    }
+  else
+    {
+      return enc->convert.bpp32(color);
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putcpixel
+ *
+ * Description:
+ *   Store one CPIXEL in the remote format and byte order.  Return the next
+ *   location in the output buffer.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putcpixel(FAR const struct vnc_zrle_s *enc,
+                                       FAR uint8_t *dest, uint32_t pixel)
+{
+  switch (enc->cpixelsize)
+    {
+      case 1:
+        *dest++ = (uint8_t)pixel;
+        break;
+
+      case 2:
+        if (enc->bigendian)
+          {
+            rfb_putbe16(dest, (uint16_t)pixel);
+          }
+        else
+          {
+            rfb_putle16(dest, (uint16_t)pixel);
+          }
+
+        dest += 2;
+        break;
+
+      case 3:
+
+        /* The three least significant bytes of the 32-bit pixel */
+
+        if (enc->bigendian)
+          {
+            *dest++ = (uint8_t)(pixel >> 16);
+            *dest++ = (uint8_t)(pixel >> 8);
+            *dest++ = (uint8_t)pixel;
+          }
+        else
+          {
+            *dest++ = (uint8_t)pixel;
+            *dest++ = (uint8_t)(pixel >> 8);
+            *dest++ = (uint8_t)(pixel >> 16);
+          }
+        break;
+
+      default:
+        if (enc->bigendian)
+          {
+            rfb_putbe32(dest, pixel);
+          }
+        else
+          {
+            rfb_putle32(dest, pixel);
+          }
+
+        dest += 4;
+        break;
+    }
+
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putrun
+ *
+ * Description:
+ *   Store a run length:  (length - 1) as a sequence of 255's terminated by
+ *   a byte with a value less than 255.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putrun(FAR uint8_t *dest, unsigned int runlen)
+{
+  runlen--;
+  while (runlen >= 255)
+    {
+      *dest++ = 255;
+      runlen -= 255;
+    }
+
+  *dest++ = (uint8_t)runlen;
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_palindex
+ *
+ * Description:
+ *   Return the index of a pixel value in the tile palette or -1 if the
+ *   pixel value is not in the palette.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_palindex(FAR struct vnc_session_s *session,
+                             unsigned int npalette, uint32_t pixel)
+{
+  unsigned int i;
+
+  for (i = 0; i < npalette; i++)
+    {
+      if (session->palette[i] == pixel)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_tile
+ *
+ * Description:
+ *   Encode one tile of the local framebuffer.  The framebuffer is read
+ *   twice:  The first pass collects the palette and the run lengths and
+ *   determines the size of each possible sub-encoding; the second pass
+ *   emits the smallest.  The result is never larger than the raw
+ *   sub-encoding.
+ *
+ * Input Parameters:
+ *   session      - An instance of the session structure.
+ *   enc          - Remote pixel format information.
+ *   dest         - The location to save the encoded tile.
+ *   x,y          - The upper left X/Y (pixel/row) position of the tile
+ *   width,height - The width (pixels) and height (rows) of the tile
+ *
+ * Returned Value:
+ *   The size of the encoded tile in bytes.
+ *
+ ****************************************************************************/
+
+static size_t vnc_zrle_tile(FAR struct vnc_session_s *session,
+                            FAR const struct vnc_zrle_s *enc,
+                            FAR uint8_t *dest, nxgl_coord_t x,
+                            nxgl_coord_t y, nxgl_coord_t width,
+                            nxgl_coord_t height)
+{
+  FAR const lfb_color_t *srcleft;
+  FAR const lfb_color_t *src;
+  FAR uint8_t *start = dest;
+  unsigned int npalette;
+  unsigned int cpixelsize;
+  unsigned int runlen;
+  unsigned int bits;
+  size_t rawsize;
+  size_t rlesize;
+  size_t palrlesize;
+  size_t packedsize;
+  size_t best;
+  uint32_t prev;
+  uint32_t pixel;
+  uint8_t subencoding;
+  uint8_t packed;
+  bool overflow;
+  int ndx;
+  int nbits;
+  int col;
+  int row;
+
+  srcleft    = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  /* Pass 1:  Collect the palette and sizes of the run-length encodings.
+   * Every color starts a run, so only the first pixel of each run needs to
+   * be checked against the palette.
+   */
+
+  cpixelsize = enc->cpixelsize;
+  npalette   = 0;
+  overflow   = false;
+  rlesize    = 0;
+  palrlesize = 0;
+  prev       = 0;
+  runlen     = 0;
+
+  for (row = 0; row < height; row++)
+    {
+      src = srcleft;
+      for (col = 0; col < width; col++, src++)
+        {
+          pixel = vnc_zrle_convert(enc, *src);
+          if (runlen > 0 && pixel == prev)
+            {
+              runlen++;
+              continue;
+            }
+
+          if (runlen > 0)
+            {
+              rlesize    += cpixelsize + ZRLE_RUNSIZE(runlen);
+              palrlesize += runlen > 1 ? 1 + ZRLE_RUNSIZE(runlen) : 1;
+            }
+
+          prev   = pixel;
+          runlen = 1;
+
+          if (!overflow && vnc_zrle_palindex(session, npalette, pixel) < 0)
+            {
+              if (npalette < ZRLE_MAXPALETTE)
+                {
+                  session->palette[npalette++] = pixel;
+                }
+              else
+                {
+                  overflow = true;
+                }
+            }
+        }
+
+      srcleft = (FAR const lfb_color_t *)((uintptr_t)srcleft + RFB_STRIDE);
+    }
+
+  rlesize    += cpixelsize + ZRLE_RUNSIZE(runlen);
+  palrlesize += runlen > 1 ? 1 + ZRLE_RUNSIZE(runlen) : 1;
+
+  /* A single color tile is the easy case */
+
+  if (npalette == 1)
+    {
+      *dest++ = RFB_SUBENCODING_SOLID;
+      dest    = vnc_zrle_putcpixel(enc, dest, prev);
+      return (size_t)(dest - start);
+    }
+
+  /* Pick the smallest sub-encoding */
+
+  rawsize     = (size_t)width * height * cpixelsize;
+  best        = rawsize;
+  subencoding = RFB_SUBENCODING_RAW;
+  bits        = 0;
+
+  if (rlesize < best)
+    {
+      best        = rlesize;
+      subencoding = RFB_SUBENCODING_RLE;
+    }
+
+  if (!overflow)
+    {
+      palrlesize += npalette * cpixelsize;
+      if (palrlesize < best)
+        {
+          best        = palrlesize;
+          subencoding = RFB_SUBENCODING_PALRLE;
+        }
+
+      if (npalette <= ZRLE_MAXPACKED)
+        {
+          bits       = npalette <= 2 ? 1 : npalette <= 4 ? 2 : 4;
+          packedsize = npalette * cpixelsize +
+                       (size_t)height * ((width * bits + 7) >> 3);
+
+          if (packedsize < best)
+            {
+              best        = packedsize;
+              subencoding = npalette;
+            }
+        }
+    }
+
+  /* Pass 2:  Emit the selected sub-encoding.  For palette RLE, the
+   * sub-encoding value is 128 plus the size of the palette.
+   */
+
+  if (subencoding == RFB_SUBENCODING_PALRLE)
+    {
+      *dest++ = RFB_SUBENCODING_RLE + npalette;
+    }
+  else
+    {
+      *dest++ = subencoding;
+    }
+
+  if (subencoding == RFB_SUBENCODING_PALRLE ||
+      (subencoding > RFB_SUBENCODING_SOLID &&
+       subencoding <= ZRLE_MAXPACKED))
+    {
+      for (ndx = 0; ndx < npalette; ndx++)
+        {
+          dest = vnc_zrle_putcpixel(enc, dest, session->palette[ndx]);
+        }
+    }
+
+  srcleft = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  if (subencoding == RFB_SUBENCODING_RAW)
+    {
+      for (row = 0; row < height; row++)
+        {
+          src = srcleft;
+          for (col = 0; col < width; col++, src++)
+            {
+              dest = vnc_zrle_putcpixel(enc, dest,
+                                        vnc_zrle_convert(enc, *src));
+            }
+
+          srcleft = (FAR const lfb_color_t *)
+            ((uintptr_t)srcleft + RFB_STRIDE);
+        }
+    }
+  else if (subencoding <= ZRLE_MAXPACKED)
+    {
+      /* Packed palette:  Rows are padded to a whole byte */
+
+      ndx = 0;
+      for (row = 0; row < height; row++)
+        {
+          src    = srcleft;
+          packed = 0;
+          nbits  = 0;
+
+          for (col = 0; col < width; col++, src++)
+            {
+              pixel = vnc_zrle_convert(enc, *src);
+              if (session->palette[ndx] != pixel)
+                {
+                  ndx = vnc_zrle_palindex(session, npalette, pixel);
+                  DEBUGASSERT(ndx >= 0);
+                }
+
+              packed  = (packed << bits) | ndx;
+              nbits  += bits;
+
+              if (nbits >= 8)
+                {
+                  *dest++ = packed;
+                  packed  = 0;
+                  nbits   = 0;
+                }
+            }
+
+          if (nbits > 0)
+            {
+              *dest++ = packed << (8 - nbits);
+            }
+
+          srcleft = (FAR const lfb_color_t *)
+            ((uintptr_t)srcleft + RFB_STRIDE);
+        }
+    }
+  else
+    {
+      /* Plain or palette RLE.  Runs may continue onto the next row. */
+
+      runlen = 0;
+      for (row = 0; row < height; row++)
+        {
+          src = srcleft;
+          for (col = 0; col < width; col++, src++)
+            {
+              pixel = vnc_zrle_convert(enc, *src);
+              if (runlen > 0 && pixel == prev)
+                {
+                  runlen++;
+                  continue;
+                }
+
+              if (runlen > 0)
+                {
+                  if (subencoding == RFB_SUBENCODING_RLE)
+                    {
+                      dest = vnc_zrle_putcpixel(enc, dest, prev);
+                      dest = vnc_zrle_putrun(dest, runlen);
+                    }
+                  else
+                    {
+                      ndx = vnc_zrle_palindex(session, npalette, prev);
+                      DEBUGASSERT(ndx >= 0);
+
+                      if (runlen > 1)
+                        {
+                          *dest++ = 0x80 | ndx;
+                          dest    = vnc_zrle_putrun(dest, runlen);
+                        }
+                      else
+                        {
+                          *dest++ = ndx;
+                        }
+                    }
+                }
+
+              prev   = pixel;
+              runlen = 1;
+            }
+
+          srcleft = (FAR const lfb_color_t *)
+            ((uintptr_t)srcleft + RFB_STRIDE);
+        }
+
+      if (subencoding == RFB_SUBENCODING_RLE)
+        {
+          dest = vnc_zrle_putcpixel(enc, dest, prev);
+          dest = vnc_zrle_putrun(dest, runlen);
+        }
+      else
+        {
+          ndx = vnc_zrle_palindex(session, npalette, prev);
+          DEBUGASSERT(ndx >= 0);
+
+          if (runlen > 1)
+            {
+              *dest++ = 0x80 | ndx;
+              dest    = vnc_zrle_putrun(dest, runlen);
+            }
+          else
+            {
+              *dest++ = ndx;
+            }
+        }
+    }
+
+  DEBUGASSERT((size_t)(dest - start) == best + 1);
+  return (size_t)(dest - start);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.  The update region
+ *  is split into tiles that fit into the update buffer and each tile is
+ *  palettized and/or run-length encoded, whichever is smallest.  The
+ *  encoded tiles are sent as stored (uncompressed) blocks of the zlib
+ *  stream; the palette and run-length encoding gives the compression.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if ZRLE coding was not performed (but not error was)
+ *   encountered.  Otherwise, the number of bytes sent is returned on
+ *   success or a negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned in
+ *   cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct rfb_srle_s *zrle;
+  FAR const uint8_t *src;
+  FAR uint8_t *dest;
+  FAR uint8_t *block;
+  struct vnc_zrle_s enc;
+  nxgl_coord_t srcwidth;
+  nxgl_coord_t srcheight;
+  nxgl_coord_t tilewidth;
+  nxgl_coord_t tileheight;
+  nxgl_coord_t updwidth;
+  nxgl_coord_t updheight;
+  nxgl_coord_t width;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  unsigned int maxpixels;
+  size_t capacity;
+  size_t tilesize;
+  size_t size;
+  ssize_t nsent;
+  uint8_t colorfmt;
+  bool zhdr;
+  int total;
+
+  /* Check if the client supports the ZRLE encoding */
+
+  if (!session->zrle)
+    {
+      return 0;
+    }
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.  These can change at any time if a SetPixelFormat is
+   * received asynchronously.
+   */
+
+  colorfmt = session->colorfmt;
+  switch (colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        enc.convert.bpp8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        enc.convert.bpp8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        enc.convert.bpp16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        enc.convert.bpp16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        enc.convert.bpp32 = vnc_convert_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  enc.bytesperpixel = (session->bpp + 7) >> 3;
+  enc.cpixelsize    = enc.bytesperpixel;
+  enc.bigendian     = session->bigendian;
+
+  /* A 32-bit true color pixel with a depth <= 24 is sent as 3 bytes */
+
+  if (enc.bytesperpixel == 4 && session->depth <= 24)
+    {
+      enc.cpixelsize = 3;
+    }
+
+  /* Pick a tile size such that even a raw tile will fit into the update
+   * buffer after the length, the zlib header, and the stored block header.
+   */
+
+  capacity = CONFIG_VNCSERVER_UPDATE_BUFSIZE - sizeof(zrle->length) -
+             ZLIB_HDRSIZE - ZLIB_STOREDSIZE;
+  capacity = MIN(capacity, ZLIB_MAXSTORED);
+  DEBUGASSERT(capacity > 1 + enc.cpixelsize);
+
+  maxpixels = (capacity - 1) / enc.cpixelsize;
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x);
+  srcwidth   = rect->pt2.x - rect->pt1.x + 1;
+
+  DEBUGASSERT(rect->pt1.y <= rect->pt2.y);
+  srcheight  = rect->pt2.y - rect->pt1.y + 1;
+
+  tilewidth  = MIN(srcwidth, ZRLE_TILESIZE);
+  tilewidth  = MIN(tilewidth, maxpixels);
+  tileheight = MIN(maxpixels / tilewidth, ZRLE_TILESIZE);
+
+  /* Send each tile as its own rectangle, transferring tiles horizontally
+   * across each swath as vnc_raw() does.
+   *
+   * NOTE that the loop also terminates of the color format or supported
+   * encodings change asynchronously.
+   */
+
+  total = 0;
+  for (y = rect->pt1.y;
+       srcheight > 0 && colorfmt == session->colorfmt && session->zrle;
+       srcheight -= updheight, y += updheight)
+    {
+      updheight = MIN(tileheight, srcheight);
+
+      for (width = srcwidth, x = rect->pt1.x;
+           width > 0 && colorfmt == session->colorfmt && session->zrle;
+           width -= updwidth, x += updwidth)
+        {
+          updwidth = MIN(tilewidth, width);
+
+          /* Format the zlib data:  The stream header (only before the
+           * first rectangle), then one stored block holding the tile.
+           */
+
+          update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+          zrle   = (FAR struct rfb_srle_s *)update->rect[0].data;
+          dest   = zrle->data;
+
+          zhdr   = !session->zrlehdr;
+          if (zhdr)
+            {
+              *dest++ = ZLIB_CMF;
+              *dest++ = ZLIB_FLG;
+            }
+
+          block    = dest;
+          dest    += ZLIB_STOREDSIZE;
+          tilesize = vnc_zrle_tile(session, &enc, dest, x, y,
+                                   updwidth, updheight);
+
+          DEBUGASSERT(tilesize <= capacity);
+
+          block[0] = 0;   /* BFINAL=0, BTYPE=00 (stored) */
+          rfb_putle16(&block[1], (uint16_t)tilesize);
+          rfb_putle16(&block[3], (uint16_t)~tilesize);
+
+          size = (zhdr ? ZLIB_HDRSIZE : 0) + ZLIB_STOREDSIZE + tilesize;
+          rfb_putbe32(zrle->length, size);
+
+          /* Format the FramebufferUpdate message */
+
+          update->msgtype = RFB_FBUPDATE_MSG;
+          update->padding = 0;
+          rfb_putbe16(update->nrect, 1);
+
+          rfb_putbe16(update->rect[0].xpos, x);
+          rfb_putbe16(update->rect[0].ypos, y);
+          rfb_putbe16(update->rect[0].width, updwidth);
+          rfb_putbe16(update->rect[0].height, updheight);
+          rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_ZRLE);
+
+          size += ZRLE_UPDHDRSIZE + sizeof(zrle->length);
+          src   = session->outbuf;
+
+          /* At the very last most, make certain that the color format
+           * has not changed asynchronously.
+           */
+
+          if (colorfmt == session->colorfmt)
+            {
+              /* Okay send until all of the bytes are out.  This may
+               * loop for the case where TCP write buffering is enabled
+               * and there are a limited number of IOBs available.
+               */
+
+              total += size;
+              do
+                {
+                  nsent = psock_send(&session->connect, src, size, 0);
+                  if (nsent < 0)
+                    {
+                      gerr("ERROR: Send ZRLE FrameBufferUpdate failed: %d\n",
+                           (int)nsent);
+                      return (int)nsent;
+                    }
+
+                  DEBUGASSERT(nsent <= size);
+                  src  += nsent;
+                  size -= nsent;
+                }
+              while (size > 0);
+
+              /* The zlib stream has been started */
+
+              session->zrlehdr = true;
+
+              updinfo("Sent {(%d, %d),(%d, %d)}\n",
+                      x, y, x + updwidth - 1, y + updheight - 1);
+            }
+        }
+    }
+
+  return total;
+}
+
+#endif /* CONFIG_VNCSERVER_ZRLE */
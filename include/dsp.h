@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/compiler.h>
+#include <fixedmath.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -88,6 +89,11 @@
 #define ONE_BY_SQRT3_F     (0.57735f)
 #define TWO_BY_SQRT3_F     (1.15470f)
 
+#define SQRT3_BY_TWO_B16   ftob16(SQRT3_BY_TWO_F)
+#define SQRT3_BY_THREE_B16 ftob16(SQRT3_BY_THREE_F)
+#define ONE_BY_SQRT3_B16   ftob16(ONE_BY_SQRT3_F)
+#define TWO_BY_SQRT3_B16   ftob16(TWO_BY_SQRT3_F)
+
 /* Some lib constants **********************************************************/
 
 /* Motor electrical angle is in range 0.0 to 2*PI */
@@ -150,6 +156,11 @@
  * Public Types
  ****************************************************************************/
 
+/* Fixed-point fractional numbers */
+
+typedef int16_t q15_t;         /* Q1.15, range <-1.0, 1.0) */
+typedef int32_t q31_t;         /* Q1.31, range <-1.0, 1.0) */
+
 /* This structure represents phase angle.
  * Besides angle value it also stores sine and cosine values for given angle.
  */
@@ -372,6 +383,190 @@ struct foc_data_s
   float vab_mod_scale;       /* Voltage alpha-beta modulation scale */
 };
 
+/* Fixed-point (b16_t) versions of the FOC data types.  These are intended
+ * for CPUs without an FPU and mirror the float types above.
+ */
+
+struct phase_angle_b16_s
+{
+  b16_t   angle;               /* Phase angle in radians <0, 2PI> */
+  b16_t   sin;                 /* Phase angle sine */
+  b16_t   cos;                 /* Phase angle cosine */
+};
+
+typedef struct phase_angle_b16_s phase_angle_b16_t;
+
+struct b16_sat_s
+{
+  b16_t min;                    /* Lower limit */
+  b16_t max;                    /* Upper limit */
+};
+
+typedef struct b16_sat_s b16_sat_t;
+
+struct pid_controller_b16_s
+{
+  b16_t       out;              /* Controller output */
+  b16_sat_t   sat;              /* Output saturation */
+  b16_t       err;              /* Current error value */
+  b16_t       err_prev;         /* Previous error value */
+  b16_t       KP;               /* Proportional coefficient */
+  b16_t       KI;               /* Integral coefficient */
+  b16_t       KD;               /* Derivative coefficient */
+  b16_t       part[3];          /* 0 - proporitonal part
+                                 * 1 - integral part
+                                 * 2 - derivative part
+                                 */
+};
+
+typedef struct pid_controller_b16_s pid_controller_b16_t;
+
+struct abc_frame_b16_s
+{
+  b16_t a;                     /* A component */
+  b16_t b;                     /* B component */
+  b16_t c;                     /* C component */
+};
+
+typedef struct abc_frame_b16_s abc_frame_b16_t;
+
+struct ab_frame_b16_s
+{
+  b16_t a;                     /* Alpha component */
+  b16_t b;                     /* Beta component */
+};
+
+typedef struct ab_frame_b16_s ab_frame_b16_t;
+
+struct dq_frame_b16_s
+{
+  b16_t d;                     /* Driect component */
+  b16_t q;                     /* Quadrature component */
+};
+
+typedef struct dq_frame_b16_s dq_frame_b16_t;
+
+struct svm3_state_b16_s
+{
+  uint8_t     sector;          /* Current space vector sector */
+  b16_t       d_u;             /* Duty cycle for phase U */
+  b16_t       d_v;             /* Duty cycle for phase V */
+  b16_t       d_w;             /* Duty cycle for phase W */
+  b16_t       d_max;           /* Duty cycle max */
+  b16_t       d_min;           /* Duty cycle min */
+};
+
+struct foc_data_b16_s
+{
+  abc_frame_b16_t      v_abc;    /* Voltage in ABC frame */
+  ab_frame_b16_t       v_ab;     /* Voltage in alpha-beta frame */
+  dq_frame_b16_t       v_dq;     /* Voltage in dq frame */
+  ab_frame_b16_t       v_ab_mod; /* Modulation voltage normalized to
+                                  * magnitude (0.0, 1.0)
+                                  */
+
+  abc_frame_b16_t      i_abc;    /* Current in ABC frame */
+  ab_frame_b16_t       i_ab;     /* Current in apha-beta frame*/
+  dq_frame_b16_t       i_dq;     /* Current in dq frame */
+  dq_frame_b16_t       i_dq_err; /* DQ current error */
+
+  dq_frame_b16_t       i_dq_ref; /* Currrent dq reference frame */
+  pid_controller_b16_t id_pid;   /* Current d-axis component PI controller */
+  pid_controller_b16_t iq_pid;   /* Current q-axis component PI controller */
+
+  b16_t vdq_mag_max;             /* Maximum dq voltage magnitude */
+  b16_t vab_mod_scale;           /* Voltage alpha-beta modulation scale */
+};
+
+/* FIR filter data.
+ *
+ *   y(n) = SUM(coeffs[k] * x(n - k)), k = 0 .. ntaps - 1
+ *
+ * The state buffer must hold 2 * ntaps samples.
+ */
+
+struct fir_f32_s
+{
+  FAR const float *coeffs;     /* Filter coefficients */
+  FAR float       *state;      /* Delay line (2 * ntaps samples) */
+  uint16_t         ntaps;      /* Number of filter taps */
+  uint16_t         idx;        /* Delay line index of the newest sample */
+};
+
+struct fir_q15_s
+{
+  FAR const q15_t *coeffs;     /* Filter coefficients */
+  FAR q15_t       *state;      /* Delay line (2 * ntaps samples) */
+  uint16_t         ntaps;      /* Number of filter taps */
+  uint16_t         idx;        /* Delay line index of the newest sample */
+};
+
+struct fir_q31_s
+{
+  FAR const q31_t *coeffs;     /* Filter coefficients */
+  FAR q31_t       *state;      /* Delay line (2 * ntaps samples) */
+  uint16_t         ntaps;      /* Number of filter taps */
+  uint16_t         idx;        /* Delay line index of the newest sample */
+};
+
+/* Cascade of second order IIR sections (biquads).  Each section
+ * implements:
+ *
+ *           b0 + b1*z^-1 + b2*z^-2
+ *   H(z) = ------------------------
+ *            1 + a1*z^-1 + a2*z^-2
+ *
+ * The coefficients are stored as {b0, b1, b2, a1, a2} for each section.
+ * Fixed-point coefficients are scaled down by 2^shift so that values of
+ * magnitude up to 2^shift can be represented.
+ */
+
+struct biquad_f32_s
+{
+  FAR const float *coeffs;     /* 5 coefficients per section */
+  FAR float       *state;      /* 2 state variables per section */
+  uint8_t          nstages;    /* Number of sections */
+};
+
+struct biquad_q15_s
+{
+  FAR const q15_t *coeffs;     /* 5 coefficients per section */
+  FAR q15_t       *state;      /* 4 state variables per section */
+  uint8_t          nstages;    /* Number of sections */
+  uint8_t          shift;      /* Coefficient scaling (0 - 3) */
+};
+
+struct biquad_q31_s
+{
+  FAR const q31_t *coeffs;     /* 5 coefficients per section */
+  FAR q31_t       *state;      /* 4 state variables per section */
+  uint8_t          nstages;    /* Number of sections */
+  uint8_t          shift;      /* Coefficient scaling (0 - 3) */
+};
+
+/* FFT data.  The twiddle factor table holds n/2 complex values
+ * (interleaved real and imaginary parts, n values in total) and is
+ * filled in by the init function.
+ */
+
+struct fft_f32_s
+{
+  FAR float *twiddle;          /* Twiddle factors */
+  uint16_t   n;                /* Transform length (power of two) */
+};
+
+struct fft_q15_s
+{
+  FAR q15_t *twiddle;          /* Twiddle factors */
+  uint16_t   n;                /* Transform length (power of two) */
+};
+
+struct fft_q31_s
+{
+  FAR q31_t *twiddle;          /* Twiddle factors */
+  uint16_t   n;                /* Transform length (power of two) */
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -489,6 +684,114 @@ void motor_phy_params_init(FAR struct motor_phy_params_s *phy, uint8_t poles,
 void motor_phy_params_temp_set(FAR struct motor_phy_params_s *phy,
                                float res_alpha, float res_temp_ref);
 
+/* Fixed-point (b16_t) math functions */
+
+b16_t fast_sin_b16(b16_t angle);
+b16_t fast_cos_b16(b16_t angle);
+
+void b16_saturate(FAR b16_t *val, b16_t min, b16_t max);
+
+b16_t vector2d_mag_b16(b16_t x, b16_t y);
+void vector2d_saturate_b16(FAR b16_t *x, FAR b16_t *y, b16_t max);
+
+void dq_saturate_b16(FAR dq_frame_b16_t *dq, b16_t max);
+b16_t dq_mag_b16(FAR dq_frame_b16_t *dq);
+
+void angle_norm_2pi_b16(FAR b16_t *angle, b16_t bottom, b16_t top);
+void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val);
+
+/* Fixed-point PID controller functions */
+
+void pid_controller_init_b16(FAR pid_controller_b16_t *pid,
+                             b16_t KP, b16_t KI, b16_t KD);
+void pi_controller_init_b16(FAR pid_controller_b16_t *pid,
+                            b16_t KP, b16_t KI);
+void pid_saturation_set_b16(FAR pid_controller_b16_t *pid, b16_t min,
+                            b16_t max);
+void pi_saturation_set_b16(FAR pid_controller_b16_t *pid, b16_t min,
+                           b16_t max);
+void pid_integral_reset_b16(FAR pid_controller_b16_t *pid);
+void pi_integral_reset_b16(FAR pid_controller_b16_t *pid);
+b16_t pi_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
+b16_t pid_controller_b16(FAR pid_controller_b16_t *pid, b16_t err);
+
+/* Fixed-point transformation functions */
+
+void clarke_transform_b16(FAR abc_frame_b16_t *abc, FAR ab_frame_b16_t *ab);
+void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
+                              FAR abc_frame_b16_t *abc);
+void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
+                        FAR dq_frame_b16_t *dq);
+void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
+                            FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
+
+/* Fixed-point 3-phase system space vector modulation */
+
+void svm3_init_b16(FAR struct svm3_state_b16_s *s, b16_t min, b16_t max);
+void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *ab);
+void svm3_current_correct_b16(FAR struct svm3_state_b16_s *s,
+                              int32_t *c0, int32_t *c1, int32_t *c2);
+
+/* Fixed-point field oriented control */
+
+void foc_vbase_update_b16(FAR struct foc_data_b16_s *foc, b16_t vbase);
+void foc_idq_ref_set_b16(FAR struct foc_data_b16_s *data, b16_t d, b16_t q);
+
+void foc_init_b16(FAR struct foc_data_b16_s *data,
+                  b16_t id_kp, b16_t id_ki, b16_t iq_kp, b16_t iq_ki);
+void foc_process_b16(FAR struct foc_data_b16_s *foc,
+                     FAR abc_frame_b16_t *i_abc,
+                     FAR phase_angle_b16_t *angle);
+
+/* FIR filters */
+
+void fir_f32_init(FAR struct fir_f32_s *fir, FAR const float *coeffs,
+                  FAR float *state, uint16_t ntaps);
+void fir_f32(FAR struct fir_f32_s *fir, FAR const float *in,
+             FAR float *out, size_t n);
+void fir_q15_init(FAR struct fir_q15_s *fir, FAR const q15_t *coeffs,
+                  FAR q15_t *state, uint16_t ntaps);
+void fir_q15(FAR struct fir_q15_s *fir, FAR const q15_t *in,
+             FAR q15_t *out, size_t n);
+void fir_q31_init(FAR struct fir_q31_s *fir, FAR const q31_t *coeffs,
+                  FAR q31_t *state, uint16_t ntaps);
+void fir_q31(FAR struct fir_q31_s *fir, FAR const q31_t *in,
+             FAR q31_t *out, size_t n);
+
+/* IIR biquad cascades */
+
+void biquad_f32_init(FAR struct biquad_f32_s *iir, FAR const float *coeffs,
+                     FAR float *state, uint8_t nstages);
+void biquad_f32(FAR struct biquad_f32_s *iir, FAR const float *in,
+                FAR float *out, size_t n);
+void biquad_q15_init(FAR struct biquad_q15_s *iir, FAR const q15_t *coeffs,
+                     FAR q15_t *state, uint8_t nstages, uint8_t shift);
+void biquad_q15(FAR struct biquad_q15_s *iir, FAR const q15_t *in,
+                FAR q15_t *out, size_t n);
+void biquad_q31_init(FAR struct biquad_q31_s *iir, FAR const q31_t *coeffs,
+                     FAR q31_t *state, uint8_t nstages, uint8_t shift);
+void biquad_q31(FAR struct biquad_q31_s *iir, FAR const q31_t *in,
+                FAR q31_t *out, size_t n);
+
+/* FFT */
+
+int fft_f32_init(FAR struct fft_f32_s *fft, FAR float *twiddle,
+                 uint16_t n);
+void fft_f32_cfft(FAR const struct fft_f32_s *fft, FAR float *buf,
+                  bool inverse);
+void fft_f32_rfft(FAR const struct fft_f32_s *fft, FAR float *buf);
+void fft_f32_irfft(FAR const struct fft_f32_s *fft, FAR float *buf);
+int fft_q15_init(FAR struct fft_q15_s *fft, FAR q15_t *twiddle,
+                 uint16_t n);
+void fft_q15_cfft(FAR const struct fft_q15_s *fft, FAR q15_t *buf,
+                  bool inverse);
+void fft_q15_rfft(FAR const struct fft_q15_s *fft, FAR q15_t *buf);
+int fft_q31_init(FAR struct fft_q31_s *fft, FAR q31_t *twiddle,
+                 uint16_t n);
+void fft_q31_cfft(FAR const struct fft_q31_s *fft, FAR q31_t *buf,
+                  bool inverse);
+void fft_q31_rfft(FAR const struct fft_q31_s *fft, FAR q31_t *buf);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
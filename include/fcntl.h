@@ -109,6 +109,8 @@
 #define F_SETLKW    12 /* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13 /* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14 /* Set the signal to be sent */
+#define F_GETPIPE_SZ 15 /* Get the capacity of a pipe (linux) */
+#define F_SETPIPE_SZ 16 /* Set the capacity of a pipe (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -129,6 +131,13 @@
 #define DN_RENAME   4  /* A file was renamed */
 #define DN_ATTRIB   5  /* Attributes of a file were changed */
 
+/* Flags for splice() and tee() (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Move pages instead of copying (ignored) */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Do not wait on the pipe(s) */
+#define SPLICE_F_MORE     (1 << 2) /* More data will follow (ignored) */
+#define SPLICE_F_GIFT     (1 << 3) /* Gift the user pages (ignored) */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -173,6 +182,12 @@ extern "C"
 int open(const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
+/* Pipe data transfers (linux) */
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
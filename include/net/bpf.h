@@ -0,0 +1,155 @@
+/****************************************************************************
+ * include/net/bpf.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_BPF_H
+#define __INCLUDE_NET_BPF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Classic BPF packet filter programs as used with PACKET_ATTACH_FILTER
+ * (see include/netpacket/packet.h).  The instruction encoding is the one
+ * of BSD and Linux so that the output of, for example, tcpdump -dd can be
+ * used unmodified.
+ */
+
+/* Instruction classes */
+
+#define BPF_CLASS(code) ((code) & 0x07)
+#define BPF_LD          0x00
+#define BPF_LDX         0x01
+#define BPF_ST          0x02
+#define BPF_STX         0x03
+#define BPF_ALU         0x04
+#define BPF_JMP         0x05
+#define BPF_RET         0x06
+#define BPF_MISC        0x07
+
+/* ld/ldx fields */
+
+#define BPF_SIZE(code)  ((code) & 0x18)
+#define BPF_W           0x00
+#define BPF_H           0x08
+#define BPF_B           0x10
+#define BPF_MODE(code)  ((code) & 0xe0)
+#define BPF_IMM         0x00
+#define BPF_ABS         0x20
+#define BPF_IND         0x40
+#define BPF_MEM         0x60
+#define BPF_LEN         0x80
+#define BPF_MSH         0xa0
+
+/* alu/jmp fields */
+
+#define BPF_OP(code)    ((code) & 0xf0)
+#define BPF_ADD         0x00
+#define BPF_SUB         0x10
+#define BPF_MUL         0x20
+#define BPF_DIV         0x30
+#define BPF_OR          0x40
+#define BPF_AND         0x50
+#define BPF_LSH         0x60
+#define BPF_RSH         0x70
+#define BPF_NEG         0x80
+#define BPF_MOD         0x90
+#define BPF_XOR         0xa0
+
+#define BPF_JA          0x00
+#define BPF_JEQ         0x10
+#define BPF_JGT         0x20
+#define BPF_JGE         0x30
+#define BPF_JSET        0x40
+
+#define BPF_SRC(code)   ((code) & 0x08)
+#define BPF_K           0x00
+#define BPF_X           0x08
+
+/* ret fields */
+
+#define BPF_RVAL(code)  ((code) & 0x18)
+#define BPF_A           0x10
+
+/* misc fields */
+
+#define BPF_MISCOP(code) ((code) & 0xf8)
+#define BPF_TAX         0x00
+#define BPF_TXA         0x80
+
+/* The number of words of scratch memory and the maximum program length */
+
+#define BPF_MEMWORDS    16
+#define BPF_MAXINSNS    4096
+
+/* Helpers to build instructions */
+
+#define BPF_STMT(code, k) \
+  { (uint16_t)(code), 0, 0, (k) }
+#define BPF_JUMP(code, k, jt, jf) \
+  { (uint16_t)(code), (jt), (jf), (k) }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One filter instruction */
+
+struct sock_filter
+{
+  uint16_t code;        /* The opcode */
+  uint8_t  jt;          /* Jump offset if true */
+  uint8_t  jf;          /* Jump offset if false */
+  uint32_t k;           /* Generic field */
+};
+
+/* A filter program.  The program is run for every received frame; its
+ * return value is the number of bytes of the frame to accept, zero to drop
+ * the frame.
+ */
+
+struct sock_fprog
+{
+  uint16_t len;                  /* Number of instructions */
+  FAR struct sock_filter *filter;
+};
+
+#endif /* __INCLUDE_NET_BPF_H */
@@ -69,4 +69,14 @@
 #define TCP_KEEPCNT   (__SO_PROTOCOL + 3) /* Number of keepalives before death
                                            * Argument: max retry count */
 
+/* Selection of the TCP congestion control algorithm: */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 4) /* Congestion control algorithm
+                                            * Argument: name, e.g. "cubic" */
+
+/* Coalescing of small writes: */
+
+#define TCP_CORK      (__SO_PROTOCOL + 5) /* Hold back partial segments
+                                           * Argument: int, 0 or 1 */
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -75,6 +75,18 @@
                                       * Key Exchange protocol. */
 #define NETLINK_USERSOCK     11      /* Reserved for user mode socket protocols */
 
+/* Standard message types **************************************************/
+/* These are common to all protocols.  Protocol message types begin at
+ * NLMSG_MIN_TYPE.
+ */
+
+#define NLMSG_NOOP           1       /* Nothing, ignore */
+#define NLMSG_ERROR          2       /* Error (or ACK) with struct nlmsgerr */
+#define NLMSG_DONE           3       /* End of a multipart message */
+#define NLMSG_OVERRUN        4       /* Data lost */
+
+#define NLMSG_MIN_TYPE       16
+
 /* NETLINK_ROUTE protocol message types *************************************/
 /* Link layer:
  *
@@ -84,10 +96,10 @@
  *   of rtattr structures.
  */
 
-#define RTM_NEWLINK          0
-#define RTM_DELLINK          1
-#define RTM_GETLINK          2
-#define RTM_SETLINK          3
+#define RTM_NEWLINK          16
+#define RTM_DELLINK          17
+#define RTM_GETLINK          18
+#define RTM_SETLINK          19
 
 /* Address settings:
  *
@@ -97,9 +109,9 @@
  *   followed by rtattr routing attributes.
  */
 
-#define RTM_NEWADDR          4
-#define RTM_DELADDR          5
-#define RTM_GETADDR          6
+#define RTM_NEWADDR          20
+#define RTM_DELADDR          21
+#define RTM_GETADDR          22
 
 /* Routing tables:
  *
@@ -113,9 +125,9 @@
  *   except rtm_table and rtm_protocol, 0 is the wildcard.
  */
 
-#define RTM_NEWROUTE         7
-#define RTM_DELROUTE         8
-#define RTM_GETROUTE         9
+#define RTM_NEWROUTE         24
+#define RTM_DELROUTE         25
+#define RTM_GETROUTE         26
 
 /* Neighbor cache:
  *
@@ -124,9 +136,9 @@
  *   an ARP entry).  The message contains an ndmsg structure.
  */
 
-#define RTM_NEWNEIGH         10
-#define RTM_DELNEIGH         11
-#define RTM_GETNEIGH         12
+#define RTM_NEWNEIGH         28
+#define RTM_DELNEIGH         29
+#define RTM_GETNEIGH         30
 
 /* Routing rules:
  *
@@ -134,9 +146,9 @@
  *   Add, delete or retrieve a routing rule.  Carries a struct rtmsg
  */
 
-#define RTM_NEWRULE          13
-#define RTM_DELRULE          14
-#define RTM_GETRULE          15
+#define RTM_NEWRULE          32
+#define RTM_DELRULE          33
+#define RTM_GETRULE          34
 
 /* Queuing discipline settings:
  *
@@ -145,9 +157,9 @@
  *   struct tcmsg and may be followed by a series of attributes.
  */
 
-#define RTM_NEWQDISC         16
-#define RTM_DELQDISC         17
-#define RTM_GETQDISC         18
+#define RTM_NEWQDISC         36
+#define RTM_DELQDISC         37
+#define RTM_GETQDISC         38
 
 /* Traffic classes used with queues:
  *
@@ -156,9 +168,9 @@
  *   tcmsg as described above.
  */
 
-#define RTM_NEWTCLASS        19
-#define RTM_DELTCLASS        20
-#define RTM_GETTCLASS        21
+#define RTM_NEWTCLASS        40
+#define RTM_DELTCLASS        41
+#define RTM_GETTCLASS        42
 
 /* Traffic filters:
  *
@@ -167,22 +179,60 @@
  *   messages contain a struct tcmsg as described above.
  */
 
-#define RTM_NEWTFILTER       22
-#define RTM_DELTFILTER       23
-#define RTM_GETTFILTER       24
+#define RTM_NEWTFILTER       44
+#define RTM_DELTFILTER       45
+#define RTM_GETTFILTER       46
 
 /* Others: */
 
-#define RTM_NEWACTION        25
-#define RTM_DELACTION        26
-#define RTM_GETACTION        27
-#define RTM_NEWPREFIX        28
-#define RTM_GETPREFIX        29
-#define RTM_GETMULTICAST     30
-#define RTM_GETANYCAST       31
-#define RTM_NEWNEIGHTBL      32
-#define RTM_GETNEIGHTBL      33
-#define RTM_SETNEIGHTBL      34
+#define RTM_NEWACTION        48
+#define RTM_DELACTION        49
+#define RTM_GETACTION        50
+#define RTM_NEWPREFIX        52
+#define RTM_GETPREFIX        54
+#define RTM_GETMULTICAST     58
+#define RTM_GETANYCAST       62
+#define RTM_NEWNEIGHTBL      64
+#define RTM_GETNEIGHTBL      66
+#define RTM_SETNEIGHTBL      67
+
+/* NETLINK_ROUTE multicast groups ******************************************/
+/* A socket receives notifications of the groups that are set in nl_groups
+ * when the socket is bound.
+ */
+
+#define RTMGRP_LINK          0x0001  /* RTM_NEWLINK, RTM_DELLINK */
+#define RTMGRP_NOTIFY        0x0002
+#define RTMGRP_NEIGH         0x0004  /* RTM_NEWNEIGH, RTM_DELNEIGH */
+#define RTMGRP_TC            0x0008
+#define RTMGRP_IPV4_IFADDR   0x0010  /* RTM_NEWADDR, RTM_DELADDR (IPv4) */
+#define RTMGRP_IPV4_MROUTE   0x0020
+#define RTMGRP_IPV4_ROUTE    0x0040  /* RTM_NEWROUTE, RTM_DELROUTE (IPv4) */
+#define RTMGRP_IPV4_RULE     0x0080
+#define RTMGRP_IPV6_IFADDR   0x0100  /* RTM_NEWADDR, RTM_DELADDR (IPv6) */
+#define RTMGRP_IPV6_MROUTE   0x0200
+#define RTMGRP_IPV6_ROUTE    0x0400  /* RTM_NEWROUTE, RTM_DELROUTE (IPv6) */
+
+/* Definitions associated with struct nlmsghdr ******************************/
+/* Macros to handle a buffer holding a sequence of messages */
+
+#define NLMSG_ALIGNTO        4
+#define NLMSG_ALIGN(len)     (((len)+NLMSG_ALIGNTO-1) & ~(NLMSG_ALIGNTO-1))
+#define NLMSG_HDRLEN         ((int)NLMSG_ALIGN(sizeof(struct nlmsghdr)))
+#define NLMSG_LENGTH(len)    ((len) + NLMSG_HDRLEN)
+#define NLMSG_SPACE(len)     NLMSG_ALIGN(NLMSG_LENGTH(len))
+#define NLMSG_DATA(nlh) \
+  ((FAR void *)(((FAR char *)(nlh)) + NLMSG_LENGTH(0)))
+#define NLMSG_NEXT(nlh,len) \
+  ((len) -= NLMSG_ALIGN((nlh)->nlmsg_len), \
+   (FAR struct nlmsghdr *) \
+     (((FAR char *)(nlh)) + NLMSG_ALIGN((nlh)->nlmsg_len)))
+#define NLMSG_OK(nlh,len) \
+  ((len) >= (int)sizeof(struct nlmsghdr) && \
+   (nlh)->nlmsg_len >= sizeof(struct nlmsghdr) && \
+   (nlh)->nlmsg_len <= (len))
+#define NLMSG_PAYLOAD(nlh,len) \
+  ((nlh)->nlmsg_len - NLMSG_SPACE((len)))
 
 /* Definitions associated with struct sockaddr_nl ***************************/
 /* Flags values */
@@ -234,6 +284,61 @@
 #define RTA_DATA(rta)        ((FAR void *)(((FAR char *)(rta)) + RTA_LENGTH(0)))
 #define RTA_PAYLOAD(rta)     ((int)((rta)->rta_len) - RTA_LENGTH(0))
 
+/* Attribute types (rta_type) for RTM_NEWLINK, RTM_DELLINK */
+
+#define IFLA_UNSPEC          0
+#define IFLA_ADDRESS         1       /* Link layer address */
+#define IFLA_BROADCAST       2
+#define IFLA_IFNAME          3       /* Interface name (NUL terminated) */
+#define IFLA_MTU             4       /* Maximum packet size (uint32_t) */
+
+/* Attribute types (rta_type) for RTM_NEWADDR, RTM_DELADDR */
+
+#define IFA_UNSPEC           0
+#define IFA_ADDRESS          1       /* Interface address */
+#define IFA_LOCAL            2       /* Local address (IPv4) */
+#define IFA_LABEL            3
+#define IFA_BROADCAST        4
+
+/* Attribute types (rta_type) for RTM_NEWROUTE, RTM_DELROUTE */
+
+#define RTA_UNSPEC           0
+#define RTA_DST              1       /* Destination network */
+#define RTA_SRC              2
+#define RTA_IIF              3
+#define RTA_OIF              4
+#define RTA_GATEWAY          5       /* Route packets via this router */
+
+/* Attribute types (rta_type) for RTM_NEWNEIGH, RTM_DELNEIGH */
+
+#define NDA_UNSPEC           0
+#define NDA_DST              1       /* Network layer address */
+#define NDA_LLADDR           2       /* Link layer address */
+
+/* Definitions for struct rtmsg *********************************************/
+
+#define RT_TABLE_UNSPEC      0       /* rtm_table */
+#define RT_TABLE_MAIN        254
+
+#define RTPROT_UNSPEC        0       /* rtm_protocol */
+#define RTPROT_KERNEL        2
+#define RTPROT_BOOT          3
+#define RTPROT_STATIC        4
+
+#define RT_SCOPE_UNIVERSE    0       /* rtm_scope */
+#define RT_SCOPE_LINK        253
+#define RT_SCOPE_HOST        254
+
+#define RTN_UNSPEC           0       /* rtm_type */
+#define RTN_UNICAST          1
+
+/* Definitions for struct ndmsg *********************************************/
+
+#define NUD_INCOMPLETE       0x01    /* ndm_state */
+#define NUD_REACHABLE        0x02
+#define NUD_STALE            0x04
+#define NUD_PERMANENT        0x80
+
 /* Definitions for struct ifaddrmsg  ****************************************/
 /* ifa_flags definitions:  ifa_flags is a flag word of IFA_F_SECONDARY for
  * secondary address (old alias interface), IFA_F_PERMANENT for a permanent
@@ -316,6 +421,51 @@ struct ifaddrmsg
   int16_t ifa_index;     /* Unique interface index */
 };
 
+/* RTM_NEWROUTE, RTM_DELROUTE, RTM_GETROUTE
+ *
+ * These messages contain an rtmsg structure followed by RTA_* attributes.
+ */
+
+struct rtmsg
+{
+  uint8_t rtm_family;    /* Address family:  AF_INET or AF_INET6 */
+  uint8_t rtm_dst_len;   /* Prefix length of the destination */
+  uint8_t rtm_src_len;   /* Prefix length of the source */
+  uint8_t rtm_tos;       /* TOS filter */
+  uint8_t rtm_table;     /* Routing table ID.  See RT_TABLE_* definitions */
+  uint8_t rtm_protocol;  /* Routing protocol.  See RTPROT_* definitions */
+  uint8_t rtm_scope;     /* See RT_SCOPE_* definitions */
+  uint8_t rtm_type;      /* See RTN_* definitions */
+  uint32_t rtm_flags;
+};
+
+/* RTM_NEWNEIGH, RTM_DELNEIGH, RTM_GETNEIGH
+ *
+ * These messages contain an ndmsg structure followed by NDA_* attributes.
+ */
+
+struct ndmsg
+{
+  uint8_t ndm_family;    /* Address family:  AF_INET or AF_INET6 */
+  uint8_t ndm_pad1;
+  uint16_t ndm_pad2;
+  int32_t ndm_ifindex;   /* Interface index (zero if unknown) */
+  uint16_t ndm_state;    /* See NUD_* definitions */
+  uint8_t ndm_flags;
+  uint8_t ndm_type;
+};
+
+/* NLMSG_ERROR
+ *
+ * Reports the result of a request.  An error of zero is an ACK.
+ */
+
+struct nlmsgerr
+{
+  int error;             /* Negated errno value or zero */
+  struct nlmsghdr msg;   /* Header of the message that failed */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
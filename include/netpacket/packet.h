@@ -45,8 +45,46 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <sys/socket.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SOL_PACKET protocol-level socket options */
+
+#define PACKET_RX_RING        (__SO_PROTOCOL + 0)
+                              /* Set up (or, with tp_block_nr == 0, release)
+                               * the memory-mapped receive ring.
+                               * arg: struct tpacket_req
+                               */
+#define PACKET_ATTACH_FILTER  (__SO_PROTOCOL + 1)
+                              /* Attach a classic BPF filter program.
+                               * arg: struct sock_fprog (see net/bpf.h)
+                               */
+#define PACKET_DETACH_FILTER  (__SO_PROTOCOL + 2)
+                              /* Detach the filter program.  arg: ignored */
+
+/* Values of tp_status.  A frame belongs to the kernel while its status is
+ * TP_STATUS_KERNEL.  The kernel sets TP_STATUS_USER (and TP_STATUS_LOSING
+ * if frames were dropped because the ring was full) when the frame has been
+ * written; the user hands the frame back by writing TP_STATUS_KERNEL.
+ */
+
+#define TP_STATUS_KERNEL      0
+#define TP_STATUS_USER        (1 << 0)
+#define TP_STATUS_LOSING      (1 << 2)
+
+/* Frames are aligned to TPACKET_ALIGNMENT bytes and the data of each frame
+ * follows its header at offset tp_mac.
+ */
+
+#define TPACKET_ALIGNMENT     16
+#define TPACKET_ALIGN(x)      (((x) + TPACKET_ALIGNMENT - 1) & \
+                               ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN        TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +96,32 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* The layout of the receive ring set up with PACKET_RX_RING.  The ring
+ * consists of tp_block_nr blocks of tp_block_size bytes, each holding
+ * tp_block_size / tp_frame_size frames.  The ring is mapped with
+ * mmap(NULL, tp_block_size * tp_block_nr, PROT_READ | PROT_WRITE,
+ * MAP_SHARED, sockfd, 0).
+ */
+
+struct tpacket_req
+{
+  uint32_t tp_block_size;  /* Size of each block in bytes */
+  uint32_t tp_block_nr;    /* Number of blocks */
+  uint32_t tp_frame_size;  /* Size of each frame, multiple of alignment */
+  uint32_t tp_frame_nr;    /* Total number of frames */
+};
+
+/* The header at the beginning of each frame of the receive ring */
+
+struct tpacket_hdr
+{
+  volatile uint32_t tp_status; /* See TP_STATUS_* definitions */
+  uint32_t tp_len;             /* Length of the frame on the wire */
+  uint32_t tp_snaplen;         /* Length of the captured data */
+  uint16_t tp_mac;             /* Offset to the link layer header */
+  uint16_t tp_net;             /* Offset to the network layer header */
+  uint32_t tp_sec;             /* Time of reception (CLOCK_REALTIME) */
+  uint32_t tp_usec;
+};
+
 #endif  /* __INCLUDE_NETPACKET_PACKET_H */
@@ -78,6 +78,19 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#ifdef CONFIG_ADC_BLOCKMODE
+#  ifndef CONFIG_ADC_BLOCK_NBLOCKS
+#    define CONFIG_ADC_BLOCK_NBLOCKS 4
+#  endif
+#  ifndef CONFIG_ADC_BLOCK_NSAMPLES
+#    define CONFIG_ADC_BLOCK_NSAMPLES 256
+#  endif
+
+/* Maximum number of interleaved channels supported by decimation */
+
+#  define ADC_BLOCK_MAXCHANNELS 16
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -105,6 +118,29 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_BLOCKMODE
+  /* This method is called from the lower half when a buffer of samples is
+   * available in block mode, typically from the DMA half and full transfer
+   * interrupts.  The samples are copied (and decimated) before the method
+   * returns, so the lower half may re-use the buffer immediately.
+   *
+   * Input Parameters:
+   *   dev       - The ADC device structure that was previously registered by
+   *               adc_register()
+   *   data      - The converted samples.  If more than one channel is
+   *               converted, the samples of each channel are interleaved.
+   *   nsamples  - The total number of samples in the buffer
+   *   nchannels - The number of interleaved channels
+   *
+   * Returned Value:
+   *   Zero on success; a negated errno value on failure.
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+                               FAR const uint16_t *data,
+                               unsigned int nsamples, uint8_t nchannels);
+#endif
 };
 
 /* This describes on ADC message */
@@ -115,6 +151,21 @@ begin_packed_struct struct adc_msg_s
   int32_t      am_data;                  /* ADC convert result (4 bytes) */
 } end_packed_struct;
 
+#ifdef CONFIG_ADC_BLOCKMODE
+/* In block mode, read() returns whole blocks of this form */
+
+struct adc_block_s
+{
+  uint64_t     ab_timestamp;             /* Time of the last sample (usec) */
+  uint32_t     ab_seqno;                 /* Sequence number.  Gaps mean that
+                                          * blocks were lost */
+  uint16_t     ab_nsamples;              /* Number of valid samples */
+  uint8_t      ab_nchannels;             /* Number of interleaved channels */
+  uint8_t      ab_reserved;
+  uint16_t     ab_data[CONFIG_ADC_BLOCK_NSAMPLES];
+};
+#endif
+
 /* This describes a FIFO of ADC messages */
 
 struct adc_fifo_s
@@ -199,6 +250,21 @@ struct adc_dev_s
   struct pollfd *fds[CONFIG_ADC_NPOLLWAITERS];
 #endif
 
+#ifdef CONFIG_ADC_BLOCKMODE
+  /* Block mode state.  ad_blocks is allocated when block mode is enabled */
+
+  FAR struct adc_block_s     *ad_blocks;     /* Ring of completed blocks */
+  uint8_t                     ad_bhead;      /* Index of the oldest completed block */
+  uint8_t                     ad_bcount;     /* Number of completed blocks */
+  uint16_t                    ad_bfill;      /* Samples in the block being filled */
+  uint32_t                    ad_bseqno;     /* Sequence number of the next block */
+  uint16_t                    ad_decimation; /* Decimation factor (1 = none) */
+  uint16_t                    ad_deccount;   /* Sample sets accumulated so far */
+  uint8_t                     ad_nchannels;  /* Channels in the current block */
+  uint8_t                     ad_channel;    /* Next channel to accumulate */
+  uint32_t                    ad_acc[ADC_BLOCK_MAXCHANNELS];
+#endif
+
 #endif /* CONFIG_ADC */
 
   /* Fields provided by lower half ADC logic */
@@ -64,9 +64,15 @@
 #define ANIOC_WDOG_LOWER  _ANIOC(0x0003)  /* Set lower threshold for watchdog
                                            * IN: Threshold value
                                            * OUT: None */
+#define ANIOC_BLOCKMODE   _ANIOC(0x0004)  /* Enable/disable ADC block mode
+                                           * IN: bool enable
+                                           * OUT: None */
+#define ANIOC_DECIMATION  _ANIOC(0x0005)  /* Set the block mode decimation
+                                           * IN: Decimation factor (>= 1)
+                                           * OUT: None */
 
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          3               /* Number of common commands */
+#define AN_NCMDS          5               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half QE driver to the lower-half QE driver via the ioctl()
@@ -1406,6 +1406,24 @@ void up_coherent_dcache(uintptr_t addr, size_t len);
 
 bool up_interrupt_context(void);
 
+/****************************************************************************
+ * Name: up_interrupt_pc
+ *
+ * Description:
+ *   Return the program counter of the code that was interrupted by the
+ *   interrupt that is currently being processed.  This is used by the
+ *   sampling profiler (see drivers/timers/profile.c).
+ *
+ * Returned Value:
+ *   The interrupted program counter or zero if not called from an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PROFILE
+uintptr_t up_interrupt_pc(void);
+#endif
+
 /****************************************************************************
  * Name: up_enable_irq
  *
@@ -1804,6 +1822,74 @@ int16_t up_fetchsub16(FAR volatile int16_t *addr, int16_t value);
 int8_t up_fetchsub8(FAR volatile int8_t *addr, int8_t value);
 #endif
 
+/****************************************************************************
+ * Name: up_cmpxchg16
+ *
+ * Description:
+ *   Perform an atomic compare and exchange operation on the provided 16-bit
+ *   value:  If the value is equal to oldval, replace it with newval.
+ *
+ *   This function must be provided via the architecture-specific logic.
+ *
+ * Input Parameters:
+ *   addr   - The address of 16-bit value to be exchanged.
+ *   oldval - The expected 16-bit value
+ *   newval - The new 16-bit value
+ *
+ * Returned Value:
+ *   True if the value was exchanged; false if the value was not equal to
+ *   oldval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CMPXCHG
+bool up_cmpxchg16(FAR volatile int16_t *addr, int16_t oldval,
+                  int16_t newval);
+#endif
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the free-running hardware performance counters of the current
+ *   CPU.  The counters are started on the first call.  Only differences
+ *   between two readings on the same CPU are meaningful.
+ *
+ * Input Parameters:
+ *   counts    - The location to return the counter values
+ *   ncounters - The number of counters to return.  Counters that the
+ *               hardware does not provide are returned as zero.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+void up_pmu_read(FAR uint32_t *counts, int ncounters);
+#endif
+
+/****************************************************************************
+ * Name: up_pmu_event
+ *
+ * Description:
+ *   Return a short description of the event counted by a performance
+ *   counter.
+ *
+ * Input Parameters:
+ *   index - The index of the counter in the array returned by
+ *           up_pmu_read()
+ *
+ * Returned Value:
+ *   The name of the event or NULL if the hardware does not provide the
+ *   counter.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+FAR const char *up_pmu_event(int index);
+#endif
+
 /****************************************************************************
  * Name: up_cpu_index
  *
@@ -2007,6 +2093,27 @@ int up_cpu_paused(int cpu);
 int up_cpu_resume(int cpu);
 #endif
 
+/****************************************************************************
+ * Name: up_cpu_call
+ *
+ * Description:
+ *   Send a light-weight inter-processor interrupt to the CPU.  The
+ *   interrupt handler on that CPU must call sched_smp_call_handler().
+ *   Unlike up_cpu_pause(), this function does not wait for the other CPU
+ *   to respond.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU to be interrupted
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int up_cpu_call(int cpu);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -2079,6 +2186,37 @@ void up_udelay(useconds_t microseconds);
 void sched_process_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_process_cputick
+ *
+ * Description:
+ *   If CONFIG_SMP_PERCPU_TICK is defined, then the architecture specific
+ *   code must call this function from a timer interrupt on each CPU
+ *   (including the CPU that calls sched_process_timer()) at the interval
+ *   CONFIG_USEC_PER_TICK.  It performs the scheduling policy operations
+ *   (round-robin, sporadic) for the task running on the calling CPU only.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_PERCPU_TICK
+void sched_process_cputick(void);
+#endif
+
+/****************************************************************************
+ * Name: sched_smp_call_handler
+ *
+ * Description:
+ *   If CONFIG_SMP_CALL is defined, then the architecture specific code must
+ *   call this function from the interrupt handler of the inter-processor
+ *   interrupt generated by up_cpu_call().  It runs all of the functions
+ *   that have been queued for the calling CPU by sched_smp_call().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+void sched_smp_call_handler(void);
+#endif
+
 /****************************************************************************
  * Name:  sched_timer_expiration
  *
@@ -60,6 +60,7 @@
 #include <nuttx/spi/spi.h>
 #include <queue.h>
 #include <semaphore.h>
+#include <time.h>
 
 #ifdef CONFIG_AUDIO
 
@@ -104,6 +105,24 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSETUP - Set up (or, with nperiods == 0, release) the shared
+ *   ring buffer.  Only allowed while streaming is stopped.
+ *
+ *   ioctl argument:  Pointer to the audio_ring_s structure.  The base field
+ *                    receives the address of the ring buffer memory.
+ *
+ * AUDIOIOC_RINGCOMMIT - Pass periods of the ring buffer to the device.  For
+ *   output, these are periods that have been filled by the application; for
+ *   input, these are periods that the application has finished reading.
+ *
+ *   ioctl argument:  The number of periods to commit
+ *
+ * AUDIOIOC_RINGSTATUS - Get the state of the ring buffer.  Unless the
+ *   device was opened with O_NONBLOCK, this waits until at least one
+ *   period is available to the application.
+ *
+ *   ioctl argument:  Pointer to the audio_ringstatus_s structure
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -123,6 +142,9 @@
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(18)
+#define AUDIOIOC_RINGCOMMIT         _AUDIOIOC(19)
+#define AUDIOIOC_RINGSTATUS         _AUDIOIOC(20)
 
 /* Audio Device Types *******************************************************/
 /* The NuttX audio interface support different types of audio devices for
@@ -325,6 +347,10 @@
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
 
+/* Ring buffer flags */
+
+#define AUDIO_RING_CAPTURE          (1 << 0) /* Device fills the periods */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -429,6 +455,40 @@ struct audio_msg_s
   } u;
 };
 
+/* Structures used with the AUDIOIOC_RINGSETUP and AUDIOIOC_RINGSTATUS
+ * ioctls.  In ring mode, the upper half allocates one contiguous buffer
+ * divided into nperiods periods of period_bytes each.  The application
+ * reads or writes samples directly in that buffer; no Audio Pipeline
+ * Buffers or dequeue messages are exchanged.  Period n of the stream is
+ * located at base + (n % nperiods) * period_bytes.
+ *
+ * For output, the application may fill period applptr when
+ * applptr - hwptr < nperiods.  For input, period applptr holds captured
+ * samples when applptr < hwptr.  In both cases the period is then handed
+ * (back) to the device with AUDIOIOC_RINGCOMMIT.  Small periods (down to
+ * about 1 ms of samples) give low latency at the cost of more frequent
+ * wakeups.
+ */
+
+#ifdef CONFIG_AUDIO_RING
+struct audio_ring_s
+{
+  FAR uint8_t        *base;         /* Returned: start of the ring buffer */
+  apb_samp_t          period_bytes; /* Size of one period in bytes */
+  uint8_t             nperiods;     /* Number of periods in the ring */
+  uint8_t             flags;        /* See AUDIO_RING_* definitions */
+};
+
+struct audio_ringstatus_s
+{
+  uint32_t            hwptr;        /* Periods completed by the device */
+  uint32_t            applptr;      /* Periods committed by the app */
+  uint32_t            xruns;        /* Number of under/overruns */
+  uint8_t             avail;        /* Periods available to the app */
+  struct timespec     tstamp;       /* System time when hwptr advanced */
+};
+#endif
+
 /* Structure defining the built-in sounds */
 
 #ifdef CONFIG_AUDIO_BUILTIN_SOUNDS
@@ -0,0 +1,99 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a software mixer in front of an audio output device.  The mixer
+ *   takes over the upper half callback of the device and returns nclients
+ *   lower half instances.  Each of these accepts PCM in any supported
+ *   format and is registered like any other output device, normally
+ *   through pcm_decode_initialize() and audio_register():
+ *
+ *     FAR struct audio_lowerhalf_s *clients[2];
+ *
+ *     ret = audio_mixer_initialize(wm8904, 2, clients);
+ *     ret = audio_register("pcm0", pcm_decode_initialize(clients[0]));
+ *     ret = audio_register("pcm1", pcm_decode_initialize(clients[1]));
+ *
+ *   The output device must not be registered itself.  It is configured
+ *   for CONFIG_AUDIO_MIXER_SAMPRATE, _NCHANNELS and _BPSAMP and is running
+ *   whenever at least one client is started.
+ *
+ * Input Parameters:
+ *   dev      - The output device
+ *   nclients - The number of clients to create
+ *   clients  - The location to return the client lower halves
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev, int nclients,
+                           FAR struct audio_lowerhalf_s **clients);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
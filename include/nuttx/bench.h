@@ -0,0 +1,121 @@
+/****************************************************************************
+ * include/nuttx/bench.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BENCH_H
+#define __INCLUDE_NUTTX_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the result of one benchmark of sched_benchmark().  All times are
+ * in nanoseconds.  For the throughput benchmarks, the times are those of
+ * one operation averaged over a batch of CONFIG_SCHED_BENCH_ITERATIONS
+ * operations and min and max are the best and worst batches.  For the
+ * latency benchmarks, each of CONFIG_SCHED_BENCH_SAMPLES events is timed
+ * individually.
+ */
+
+struct bench_result_s
+{
+  FAR const char *br_name;   /* Name of the benchmark */
+  uint32_t br_count;         /* Number of operations or events timed */
+  uint32_t br_min;           /* Shortest time */
+  uint32_t br_mean;          /* Average time */
+  uint32_t br_max;           /* Longest time */
+  uint64_t br_total;         /* Sum of all times */
+  int      br_result;        /* OK or negated errno if the benchmark failed */
+};
+
+/* The function that receives each result of sched_benchmark() */
+
+typedef CODE int (*bench_handler_t)(FAR const struct bench_result_s *result,
+                                    FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sched_benchmark
+ *
+ * Description:
+ *   Run the kernel microbenchmarks:  Context switch, semaphore hand-off,
+ *   message queue, pipe, heap, work queue latency, watchdog timer jitter
+ *   and, if CONFIG_HRTIMER is selected, timer interrupt latency.  The
+ *   network, file system and block device benchmarks follow if they are
+ *   configured.  The benchmarks run one at a time in a kernel thread of
+ *   priority CONFIG_SCHED_BENCH_PRIORITY.
+ *
+ * Input Parameters:
+ *   handler - Called with the result of each benchmark.  A negative return
+ *             value stops the remaining benchmarks.
+ *   arg     - An argument passed to handler.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if all of the benchmarks were run; a negated
+ *   errno value is returned if the benchmarks could not be started or if
+ *   the handler returns an error.  The failure of an individual benchmark
+ *   is reported in its result.
+ *
+ ****************************************************************************/
+
+int sched_benchmark(bench_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCH */
+#endif /* __INCLUDE_NUTTX_BENCH_H */
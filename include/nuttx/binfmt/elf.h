@@ -112,6 +112,7 @@ struct elf_loadinfo_s
   off_t             filelen;     /* Length of the entire ELF file */
   Elf32_Ehdr        ehdr;        /* Buffered ELF file header */
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
+  FAR char          *shstrtab;   /* Buffered section name string table */
   uint8_t           *iobuffer;   /* File I/O buffer */
 
   /* Constructors and destructors */
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * include/nuttx/boottime.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BOOTTIME_H
+#define __INCLUDE_NUTTX_BOOTTIME_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SCHED_BOOTTIME
+
+/****************************************************************************
+ * Name: boottime_mark
+ *
+ * Description:
+ *   Record the time at which a stage of the system start-up completed.
+ *   The name is copied (and truncated to CONFIG_SCHED_BOOTTIME_NAMELEN - 1
+ *   characters).  This may be called at any time, even before the memory
+ *   manager, the timer or the SYSLOG are available, and from interrupt
+ *   handlers.  Marks beyond the first CONFIG_SCHED_BOOTTIME_NMARKS are
+ *   discarded.
+ *
+ *   The time is taken from the critical section monitor timer
+ *   (up_critmon_gettime()) if CONFIG_SCHED_CRITMONITOR is selected;  that
+ *   is typically a free-running cycle counter.  Otherwise the system timer
+ *   is used and all marks before the timer is started read as zero.
+ *
+ * Input Parameters:
+ *   name - The name of the stage that completed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void boottime_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: boottime_get
+ *
+ * Description:
+ *   Return one of the recorded marks.
+ *
+ * Input Parameters:
+ *   index - The index of the mark, in the order that they were recorded.
+ *   name  - The location to return a pointer to the name of the mark.
+ *   ts    - The location to return the time of the mark, relative to the
+ *           first mark.
+ *
+ * Returned Value:
+ *   Zero (OK) on success;  -ENOENT if there is no such mark.
+ *
+ ****************************************************************************/
+
+int boottime_get(int index, FAR const char **name, FAR struct timespec *ts);
+
+#else
+#  define boottime_mark(n)
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_BOOTTIME_H */
@@ -47,6 +47,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <sys/time.h>
+#endif
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -193,6 +196,19 @@
  *                   is returned with the errno variable set to indicate the
  *                   nature of the error.
  *   Dependencies:   None
+ *
+ * CANIOC_SET_RXBATCH:
+ *   Description:    Batch the wake-up of blocked readers.  A read() that
+ *                   finds the receive FIFO non-empty but holding fewer than
+ *                   rb_nframes messages waits up to rb_latency milliseconds
+ *                   for more messages before returning.  Readers are then
+ *                   woken once per batch rather than once per message.
+ *                   rb_nframes of 0 or 1 restores the default behavior.
+ *   Argument:       A reference to struct canioc_rxbatch_s
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.
+ *   Dependencies:   None
  */
 
 #define CANIOC_RTR                _CANIOC(1)
@@ -205,9 +221,10 @@
 #define CANIOC_GET_CONNMODES      _CANIOC(8)
 #define CANIOC_SET_CONNMODES      _CANIOC(9)
 #define CANIOC_BUSOFF_RECOVERY    _CANIOC(10)
+#define CANIOC_SET_RXBATCH        _CANIOC(11)
 
 #define CAN_FIRST                 0x0001         /* First common command */
-#define CAN_NCMDS                 10             /* Ten common commands */
+#define CAN_NCMDS                 11             /* Eleven common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half CAN driver to the lower-half CAN driver via the co_ioctl()
@@ -430,6 +447,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Reception time stamp */
+#endif
 } end_packed_struct;
 #else
 begin_packed_struct struct can_hdr_s
@@ -441,6 +461,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Reception time stamp */
+#endif
 } end_packed_struct;
 #endif
 
@@ -548,6 +571,11 @@ struct can_ops_s
  *   The elements of 'cd_ops', and 'cd_priv'
  *
  * The common logic will initialize all semaphores.
+ *
+ * If CONFIG_CAN_TIMESTAMP is enabled, the lower half may also set
+ * 'cd_hwtimestamp' if it provides a hardware time stamp in the ch_ts field
+ * of each message header passed to can_receive().  Otherwise, the upper
+ * half time stamps each message when can_receive() is called.
  */
 
 struct can_dev_s
@@ -556,6 +584,11 @@ struct can_dev_s
   uint8_t              cd_npendrtr;      /* Number of pending RTR messages */
   volatile uint8_t     cd_ntxwaiters;    /* Number of threads waiting to enqueue a message */
   volatile uint8_t     cd_nrxwaiters;    /* Number of threads waiting to receive a message */
+  uint8_t              cd_rxbatch;       /* Messages per reader wake-up (CANIOC_SET_RXBATCH) */
+  uint32_t             cd_rxlatency;     /* Maximum batching delay (ticks) */
+#ifdef CONFIG_CAN_TIMESTAMP
+  bool                 cd_hwtimestamp;   /* Lower half provides ch_ts */
+#endif
 #ifdef CONFIG_CAN_ERRORS
   uint8_t              cd_error;         /* Flags to indicate internal device errors */
 #endif
@@ -603,6 +636,14 @@ struct canioc_bittiming_s
   uint8_t               bt_sjw;          /* Synchronization Jump Width in time quanta */
 };
 
+/* CANIOC_SET_RXBATCH: */
+
+struct canioc_rxbatch_s
+{
+  uint8_t               rb_nframes;      /* Messages to wait for before waking a reader */
+  uint16_t              rb_latency;      /* Maximum wait for a full batch (msec) */
+};
+
 /* CANIOC_GET_CONNMODES/CANIOC_SET_CONNMODES: */
 /* A CAN device may support loopback and silent mode. Both modes may not be
  * settable independently.
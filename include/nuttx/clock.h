@@ -228,6 +228,23 @@ struct cpuload_s
 };
 #endif
 
+/* If CONFIG_CLOCK_USERTIME is selected, the kernel keeps a copy of the
+ * system timer and of the time-of-day base in an instance of this
+ * structure.  It lies in user memory (see struct userspace_s) so that
+ * clock_gettime() in user space can read it without a system call.  cu_seq
+ * is odd while the kernel is updating the other fields.
+ */
+
+#ifdef CONFIG_CLOCK_USERTIME
+struct clock_usertime_s
+{
+  volatile uint32_t cu_seq;          /* Update sequence count */
+  volatile clock_t  cu_ticks;        /* Copy of the system timer */
+  volatile time_t   cu_basesec;      /* Time-of-day base (seconds) */
+  volatile long     cu_basensec;     /* Time-of-day base (nanoseconds) */
+};
+#endif
+
 /* This non-standard type used to hold relative clock ticks that may take
  * negative values.  Because of its non-portable nature the type sclock_t
  * should be used only within the OS proper and not by portable applications.
@@ -258,6 +275,12 @@ extern "C"
  * access to kernel global data
  */
 
+#if defined(CONFIG_CLOCK_USERTIME) && !defined(__KERNEL__)
+/* The user-space copy of the clock, maintained by the kernel */
+
+EXTERN struct clock_usertime_s g_clock_usertime;
+#endif
+
 #ifdef __HAVE_KERNEL_GLOBALS
 EXTERN volatile clock_t g_system_timer;
 
@@ -79,6 +79,12 @@
 #  define CONFIG_HAVE_BUILTIN_CLZ 1
 #endif
 
+/* __builtin_return_address(0) provides the return address of the current
+ * function, i.e., the call site in its caller.
+ */
+
+#define CONFIG_HAVE_BUILTIN_RETURN_ADDRESS 1
+
 /* C++ support */
 
 #if defined(__cplusplus) && __cplusplus >= 201402L
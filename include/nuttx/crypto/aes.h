@@ -49,6 +49,10 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_MAXNR          14  /* Number of rounds for AES-256 */
 
 /****************************************************************************
  * Public Types
@@ -56,7 +60,9 @@
 
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t ek[4 * (AES_MAXNR + 1)];  /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAXNR + 1)];  /* Decryption round keys */
+  int nrounds;                       /* 10, 12 or 14 */
 };
 
 /****************************************************************************
@@ -118,14 +124,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key: 16 (AES-128), 24 (AES-192) or 32 (AES-256)
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not 16, 24 or 32
  *
  ****************************************************************************/
 
@@ -164,6 +168,21 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+/****************************************************************************
+ * Name: aes_register_engine
+ *
+ * Description:
+ *   Register the software AES implementation with the crypto engine
+ *   registry.  It has the lowest priority so that any hardware engine
+ *   supporting a request is used instead.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aes_register_engine(void);
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
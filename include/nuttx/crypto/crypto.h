@@ -41,36 +41,132 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
 #include <debug.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#if defined(CONFIG_CRYPTO_AES)
-#  define AES_MODE_MIN 1
+#define AES_MODE_MIN 1
 
-#  define AES_MODE_ECB 1
-#  define AES_MODE_CBC 2
-#  define AES_MODE_CTR 3
-#  define AES_MODE_CFB 4
+#define AES_MODE_ECB 1
+#define AES_MODE_CBC 2
+#define AES_MODE_CTR 3
+#define AES_MODE_CFB 4
 
-#  define AES_MODE_MAX 4
+#define AES_MODE_MAX 4
 
-#  define AES_MODE_MAC 0x80000000
+#define AES_MODE_MAC 0x80000000
 
-#  define AES_MODE_MASK 0xffff
-#endif
+#define AES_MODE_MASK 0xffff
 
 #define CYPHER_ENCRYPT 1
 #define CYPHER_DECRYPT 0
 
+/* Crypto engine flags (see struct crypto_engine_s) */
+
+#define CRYPTO_ENGINE_HARDWARE  (1 << 0) /* Hardware accelerated */
+#define CRYPTO_ENGINE_ASYNC     (1 << 1) /* May complete asynchronously */
+
+/* Crypto engine priorities.  The engine with the highest priority that
+ * supports a request is used.
+ */
+
+#define CRYPTO_PRIO_SOFTWARE    0
+#define CRYPTO_PRIO_HARDWARE    100
+
 /*******************************************************************************
- * Public Data
+ * Public Types
  ******************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* This describes one cypher request passed to a crypto engine */
+
+struct crypto_req_s;
+typedef CODE void (*crypto_done_t)(FAR struct crypto_req_s *req, int result);
+
+struct crypto_req_s
+{
+  FAR void *cr_out;              /* Output data */
+  FAR const void *cr_in;         /* Input data (may be the same as cr_out) */
+  uint32_t cr_size;              /* Size of the data in bytes */
+  FAR const void *cr_iv;         /* Initialization vector (NULL for ECB) */
+  FAR const void *cr_key;        /* Key */
+  uint32_t cr_keysize;           /* Size of the key in bytes */
+  int cr_mode;                   /* AES_MODE_* */
+  int cr_encrypt;                /* CYPHER_ENCRYPT or CYPHER_DECRYPT */
+  crypto_done_t cr_done;         /* Completion callback (asynchronous) */
+  FAR void *cr_arg;              /* Argument for the completion callback */
+};
+
+/* These are the operations of a crypto engine.
+ *
+ * supported - Return true if the engine can perform requests with this
+ *   mode and key size.
+ * cypher - Perform a request.  Return OK or a negated errno value if the
+ *   request completed synchronously.  An engine with the
+ *   CRYPTO_ENGINE_ASYNC flag may instead return -EINPROGRESS after
+ *   starting, for example, a DMA transfer.  It must then call
+ *   req->cr_done() (perhaps from the interrupt handler) when the request
+ *   completes.
+ */
+
+struct crypto_engine_s;
+struct crypto_engine_ops_s
+{
+  CODE bool (*supported)(FAR struct crypto_engine_s *engine, int mode,
+                         uint32_t keysize);
+  CODE int  (*cypher)(FAR struct crypto_engine_s *engine,
+                      FAR struct crypto_req_s *req);
+};
+
+/* This is one registered crypto engine.  An engine is normally a
+ * statically allocated structure in the driver for a hardware crypto
+ * block; the software AES implementation is one, too.
+ */
+
+struct crypto_engine_s
+{
+  FAR struct crypto_engine_s *ce_flink;   /* Supports a singly linked list */
+  FAR const char *ce_name;                /* Name of the engine */
+  FAR const struct crypto_engine_ops_s *ce_ops;
+  uint8_t ce_flags;                       /* See CRYPTO_ENGINE_* */
+  uint8_t ce_priority;                    /* See CRYPTO_PRIO_* */
+};
+
+/* This is the type of the callback used with crypto_foreach() */
+
+typedef CODE int (*crypto_handler_t)(FAR struct crypto_engine_s *engine,
+                                     FAR void *arg);
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+/* This is one result of crypto_benchmark() */
+
+struct crypto_bench_s
+{
+  FAR struct crypto_engine_s *cb_engine;  /* The engine measured */
+  FAR const char *cb_modename;            /* Name of the mode */
+  int cb_mode;                            /* AES_MODE_* */
+  uint32_t cb_keysize;                    /* Size of the key in bytes */
+  int cb_encrypt;                         /* CYPHER_ENCRYPT or _DECRYPT */
+  int cb_selftest;                        /* Known-answer test result */
+  int cb_result;                          /* Benchmark request result */
+  uint32_t cb_kbps;                       /* Throughput in KiB/s */
+  uint32_t cb_cpb100;                     /* 100 x cycles/byte (or 0) */
+};
+
+typedef CODE int (*crypto_bench_handler_t)
+  (FAR const struct crypto_bench_s *result, FAR void *arg);
+#endif
+
+/*******************************************************************************
+ * Public Data
+ ******************************************************************************/
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -86,6 +182,79 @@ extern "C"
 
 int up_cryptoinitialize(void);
 
+/*******************************************************************************
+ * Name: crypto_register
+ *
+ * Description:
+ *   Register a crypto engine.  The engine structure must persist until it is
+ *   unregistered.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ******************************************************************************/
+
+int crypto_register(FAR struct crypto_engine_s *engine);
+
+/*******************************************************************************
+ * Name: crypto_unregister
+ *
+ * Description:
+ *   Remove a crypto engine from the registry.  No requests may be pending on
+ *   the engine and no sessions may still refer to it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the engine was not registered.
+ *
+ ******************************************************************************/
+
+int crypto_unregister(FAR struct crypto_engine_s *engine);
+
+/*******************************************************************************
+ * Name: crypto_findengine
+ *
+ * Description:
+ *   Return the registered engine with the highest priority that supports the
+ *   mode and key size, or NULL if there is none.
+ *
+ ******************************************************************************/
+
+FAR struct crypto_engine_s *crypto_findengine(int mode, uint32_t keysize);
+
+/*******************************************************************************
+ * Name: crypto_cypher
+ *
+ * Description:
+ *   Perform a request on an engine (or on the best engine for the request if
+ *   'engine' is NULL) and wait for it to complete.  If the engine completes
+ *   the request asynchronously, the caller sleeps until then rather than
+ *   polling the hardware.  The cr_done and cr_arg fields of the request are
+ *   used internally.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ******************************************************************************/
+
+int crypto_cypher(FAR struct crypto_engine_s *engine,
+                  FAR struct crypto_req_s *req);
+
+/*******************************************************************************
+ * Name: crypto_foreach
+ *
+ * Description:
+ *   Call the handler for each registered engine in order of decreasing
+ *   priority, stopping if it returns non-zero.  The registry is locked
+ *   while this runs, so the handler must not register, unregister or look
+ *   up engines.  It may, however, use crypto_cypher() on an engine.
+ *
+ * Returned Value:
+ *   Zero (OK) or the first non-zero value returned by the handler.
+ *
+ ******************************************************************************/
+
+int crypto_foreach(crypto_handler_t handler, FAR void *arg);
+
 #if defined(CONFIG_CRYPTO_AES)
 int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
                FAR const void *iv, FAR const void *key, uint32_t keysize,
@@ -96,6 +265,26 @@ int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
 int crypto_test(void);
 #endif
 
+/*******************************************************************************
+ * Name: crypto_benchmark
+ *
+ * Description:
+ *   For each registered engine and each mode, key size and direction that it
+ *   supports, run the matching known-answer tests, measure the throughput
+ *   and pass the result to the handler.  Measuring stops early if the handler
+ *   returns non-zero.  This takes CONFIG_CRYPTO_BENCHMARK_MSEC per result
+ *   and holds the engine registry lock meanwhile.
+ *
+ * Returned Value:
+ *   Zero (OK), a negated errno value, or the first non-zero value returned by
+ *   the handler.
+ *
+ ******************************************************************************/
+
+#ifdef CONFIG_CRYPTO_BENCHMARK
+int crypto_benchmark(crypto_bench_handler_t handler, FAR void *arg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -43,8 +43,25 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* BCH sector cache statistics returned by the BIOC_CACHESTATS IOCTL command
+ * (if CONFIG_BCH_CACHESTATS is enabled).
+ */
+
+struct bch_cachestats_s
+{
+  uint32_t bc_hits;        /* Sector accesses satisfied by the cache */
+  uint32_t bc_misses;      /* Sector accesses requiring a media read */
+  uint32_t bc_writes;      /* Number of write operations to the media */
+  uint32_t bc_wsectors;    /* Number of sectors written to the media */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
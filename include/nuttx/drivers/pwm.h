@@ -57,6 +57,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <sys/types.h>
 #include <fixedmath.h>
 
 #include <nuttx/fs/ioctl.h>
@@ -74,6 +75,10 @@
  * CONFIG_PWM_MULTICHAN - Enables support for multiple output channels per
  *   timer.  If selected, then CONFIG_PWM_NCHANNELS must be provided to
  *   indicated the maximum number of supported PWM output channels.
+ * CONFIG_PWM_STREAM - Enables streaming of duty cycle sequences with
+ *   write().  This requires support from the lower half driver, normally
+ *   by DMA.  CONFIG_PWM_STREAM_NBUFFERS and CONFIG_PWM_STREAM_NFRAMES set
+ *   the number and the size of the stream buffers.
  * CONFIG_DEBUG_PWM_INFO - This will generate output that can be use to
  *   debug the PWM driver.
  */
@@ -113,12 +118,25 @@
  *   and return immediately.
  *
  *   ioctl argument:  None
+ *
+ * PWMIOC_STREAMSETUP - Select the output channels that are updated by
+ *   write() when CONFIG_PWM_STREAM is enabled.  After this command, each
+ *   write() provides a sequence of frames.  A frame holds one ub16_t duty
+ *   value for each of the selected channels and is applied to all of them
+ *   at once at one period boundary; frames follow each other one period
+ *   apart.  The output must have been started with PWMIOC_START.  Stream
+ *   buffers are queued and played back to back; write() blocks while all
+ *   buffers are in use unless the driver was opened with O_NONBLOCK.  The
+ *   last frame remains in effect when the stream runs dry.
+ *
+ *   ioctl argument:  A read-only reference to struct pwm_stream_s.
  */
 
 #define PWMIOC_SETCHARACTERISTICS _PWMIOC(1)
 #define PWMIOC_GETCHARACTERISTICS _PWMIOC(2)
 #define PWMIOC_START              _PWMIOC(3)
 #define PWMIOC_STOP               _PWMIOC(4)
+#define PWMIOC_STREAMSETUP        _PWMIOC(5)
 
 /****************************************************************************
  * Public Types
@@ -157,6 +175,16 @@ struct pwm_info_s
 #endif /* CONFIG_PWM_MULTICHAN */
 };
 
+/* This structure describes the frame layout of a PWM stream */
+
+#ifdef CONFIG_PWM_STREAM
+struct pwm_stream_s
+{
+  uint8_t            channel;   /* First output channel in each frame */
+  uint8_t            nchannels; /* Number of consecutive channels per frame */
+};
+#endif
+
 /* This structure is a set a callback functions used to call from the upper-
  * half, generic PWM driver into lower-half, platform-specific logic that
  * supports the low-level timer outputs.
@@ -201,6 +229,21 @@ struct pwm_ops_s
 
   CODE int (*ioctl)(FAR struct pwm_lowerhalf_s *dev,
                     int cmd, unsigned long arg);
+
+#ifdef CONFIG_PWM_STREAM
+  /* Play nframes frames from the duty buffer, one frame per period,
+   * starting at the next period boundary, then call pwm_streamdone() with
+   * the handle.  The lower half may convert the duty values in place.
+   * This method is called from pwm_streamdone() and so must be callable
+   * from an interrupt handler.  It returns -ENOSYS if the timer cannot
+   * stream or -EINVAL if the frame layout is not supported.  The stop
+   * method also stops any stream in progress.
+   */
+
+  CODE int (*stream)(FAR struct pwm_lowerhalf_s *dev,
+                     FAR const struct pwm_stream_s *stream,
+                     FAR ub16_t *duty, size_t nframes, FAR void *handle);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -315,6 +358,30 @@ int pwm_register(FAR const char *path, FAR struct pwm_lowerhalf_s *dev);
 void pwm_expired(FAR void *handle);
 #endif
 
+/****************************************************************************
+ * Name: pwm_streamdone
+ *
+ * Description:
+ *   Called by the lower half driver when the buffer passed to its stream()
+ *   method has been played.  The upper half driver then passes the next
+ *   queued buffer to the stream() method.
+ *
+ * Input Parameters:
+ *   handle - This is the handle that was provided to the lower-half
+ *     stream() method.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PWM_STREAM
+void pwm_streamdone(FAR void *handle);
+#endif
+
 /****************************************************************************
  * Platform-Independent "Lower-Half" PWM Driver Interfaces
  ****************************************************************************/
@@ -99,7 +99,9 @@ struct rwbuffer_s
    * rwb_initialize()
    */
 
-  /* Supported geometry */
+  /* Supported geometry.  A driver for removable media may update nblocks
+   * when the media changes (zero if there is no media).
+   */
 
   uint16_t      blocksize;       /* The size of one block */
   size_t        nblocks;         /* The total number blocks supported */
@@ -116,6 +118,17 @@ struct rwbuffer_s
   uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
 #endif
 
+  /* The write buffer holds any set of blocks, not just one sequential run.
+   * Rewrites of a buffered block are combined and the blocks are kept
+   * sorted so that neighbouring blocks are written to the media together.
+   * When wrdirtylimit blocks are buffered, the buffer is flushed on the low
+   * priority worker thread.  Zero selects wrmaxblocks.
+   */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  uint16_t      wrdirtylimit;    /* Blocks that start a background flush */
+#endif
+
   /* Callback functions.
    *
    * wrflush.  This callback is normally used to flush the contents of
@@ -137,11 +150,10 @@ struct rwbuffer_s
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   sem_t         wrsem;           /* Enforces exclusive access to the write buffer */
-  struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
+  struct work_s work;            /* Background flush of the write buffer */
   uint8_t      *wrbuffer;        /* Allocated write buffer */
+  off_t        *wrblock;         /* Sorted numbers of the buffered blocks */
   uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
-  off_t         wrexpectedblock; /* Next block expected */
 #endif
 
   /* This is the state of the read-ahead buffering */
@@ -0,0 +1,197 @@
+/****************************************************************************
+ * include/nuttx/fs/aioring.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_NUTTX_FS_AIORING_H
+#define __INCLUDE_NUTTX_FS_AIORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <aio.h>
+
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An AIO ring is a pair of circular queues of AIO control block pointers
+ * shared between the application and the OS:
+ *
+ * - The submission queue (SQ).  The application adds requests with
+ *   aio_ring_enqueue() at ar_sqtail; aio_ring_submit() then passes all new
+ *   requests to the OS at once and advances ar_sqhead.
+ * - The completion queue (CQ).  The OS adds each completed request at
+ *   ar_cqtail; the application removes them with aio_ring_reap().
+ *
+ * All of the requests of one submission are performed by a single run of
+ * the low priority worker thread, and completions are reported through
+ * the CQ rather than by signals, so aio_sigevent is ignored.  The
+ * operation of each request is selected by aio_lio_opcode (LIO_READ,
+ * LIO_WRITE, or LIO_NOP) as with lio_listio().  Ring requests cannot be
+ * cancelled with aio_cancel().
+ *
+ * The structure must not be moved or freed while requests are in flight.
+ */
+
+struct aio_ring_s
+{
+  /* Shared with the application (but only modified via the interfaces
+   * below).
+   */
+
+  FAR struct aiocb **ar_sq;        /* Submission queue (nentries entries) */
+  FAR struct aiocb **ar_cq;        /* Completion queue (nentries entries) */
+  uint16_t ar_mask;                /* nentries - 1 */
+  volatile uint16_t ar_sqhead;     /* Next SQ entry to be submitted */
+  volatile uint16_t ar_sqtail;     /* Next SQ entry to be filled in */
+  volatile uint16_t ar_cqhead;     /* Next CQ entry to be reaped */
+  volatile uint16_t ar_cqtail;     /* Next CQ entry to be filled in */
+
+  /* Private to the implementation */
+
+  sem_t ar_cqsem;                  /* Counts the CQ entries */
+  dq_queue_t ar_pending;           /* Submitted requests (AIO containers) */
+  struct work_s ar_work;           /* Runs the requests on the worker */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: aio_ring_setup
+ *
+ * Description:
+ *   Initialize an AIO ring.
+ *
+ * Input Parameters:
+ *   ring     - The ring to initialize
+ *   sq       - Storage for the submission queue
+ *   cq       - Storage for the completion queue
+ *   nentries - The number of entries in each queue.  Must be a power of
+ *              two no larger than 32768.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with the errno value set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_ring_setup(FAR struct aio_ring_s *ring, FAR struct aiocb **sq,
+                   FAR struct aiocb **cq, unsigned int nentries);
+
+/****************************************************************************
+ * Name: aio_ring_teardown
+ *
+ * Description:
+ *   Release the resources of an AIO ring.  Fails with EBUSY if there are
+ *   submitted requests that have not yet been reaped.
+ *
+ ****************************************************************************/
+
+int aio_ring_teardown(FAR struct aio_ring_s *ring);
+
+/****************************************************************************
+ * Name: aio_ring_enqueue
+ *
+ * Description:
+ *   Add one request to the submission queue.  Nothing is started until
+ *   aio_ring_submit() is called.  Fails with EAGAIN if the submission
+ *   queue is full.
+ *
+ ****************************************************************************/
+
+int aio_ring_enqueue(FAR struct aio_ring_s *ring, FAR struct aiocb *aiocbp);
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Submit all requests enqueued since the last call.  Requests are only
+ *   submitted as long as there is room to report their completion, i.e.
+ *   while fewer than nentries requests are submitted but not yet reaped.
+ *
+ * Returned Value:
+ *   The number of requests submitted; -1 (ERROR) on failure with the errno
+ *   value set appropriately.
+ *
+ ****************************************************************************/
+
+int aio_ring_submit(FAR struct aio_ring_s *ring);
+
+/****************************************************************************
+ * Name: aio_ring_reap
+ *
+ * Description:
+ *   Remove the next completed request from the completion queue.  The
+ *   result is then available through aio_error() and aio_return().
+ *
+ * Input Parameters:
+ *   ring - The ring
+ *   wait - True: wait for a completion if there is none
+ *
+ * Returned Value:
+ *   The completed AIO control block or NULL with the errno value set to
+ *   EAGAIN (no completion and wait is false) or EINTR.
+ *
+ ****************************************************************************/
+
+FAR struct aiocb *aio_ring_reap(FAR struct aio_ring_s *ring, bool wait);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_NUTTX_FS_AIORING_H */
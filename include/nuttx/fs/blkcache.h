@@ -0,0 +1,174 @@
+/****************************************************************************
+ * include/nuttx/fs/blkcache.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_NUTTX_FS_BLKCACHE_H
+#define __INCLUDE_NUTTX_FS_BLKCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_BLKCACHE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* The block cache is a single, global cache of device sectors that is
+ * shared by all file systems that opt in to use it.  Cached sectors are
+ * identified by the block driver inode and the sector number.  The total
+ * memory used is fixed by CONFIG_FS_BLKCACHE_NBLOCKS and
+ * CONFIG_FS_BLKCACHE_BLOCKSIZE; sectors are replaced on a least-recently-
+ * used basis.
+ *
+ * A file system uses the cache by calling blkcache_read() and
+ * blkcache_write() in place of the block driver read() and write()
+ * methods.  Writes are held in the cache until the sector is replaced or
+ * until blkcache_flush() is called, so the file system must call
+ * blkcache_flush() whenever it needs data to reach the media (sync,
+ * unmount) and blkcache_invalidate() before it releases the block driver
+ * or when the media has changed.
+ */
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct inode;
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read 'nsectors' sectors beginning at 'start' from the block driver,
+ *   using cached sectors where available.  Misses shorter than
+ *   CONFIG_FS_BLKCACHE_READAHEAD sectors are filled with a read of
+ *   CONFIG_FS_BLKCACHE_READAHEAD sectors; longer misses bypass the cache.
+ *
+ * Input Parameters:
+ *   inode    - The block driver inode
+ *   buffer   - Location to return the data
+ *   start    - The first sector to read
+ *   nsectors - The number of sectors to read
+ *   sectsize - The size of one sector in bytes
+ *
+ * Returned Value:
+ *   The number of sectors read on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct inode *inode, FAR uint8_t *buffer,
+                      blkcnt_t start, unsigned int nsectors,
+                      uint16_t sectsize);
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write 'nsectors' sectors beginning at 'start'.  Short writes are held
+ *   in the cache; writes of CONFIG_FS_BLKCACHE_READAHEAD sectors or more go
+ *   directly to the block driver (and update any cached copies).
+ *
+ * Returned Value:
+ *   The number of sectors written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct inode *inode, FAR const uint8_t *buffer,
+                       blkcnt_t start, unsigned int nsectors,
+                       uint16_t sectsize);
+
+/****************************************************************************
+ * Name: blkcache_directread and blkcache_directwrite
+ *
+ * Description:
+ *   Variants of blkcache_read() and blkcache_write() for transfers that
+ *   should not displace other cached sectors, such as those of files
+ *   opened with O_DIRECT.  Sectors that are not cached are transferred
+ *   directly to or from the block driver and writes are never deferred.
+ *   Cached copies of the sectors are still used (reads) or updated
+ *   (writes), so the cache remains coherent.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_directread(FAR struct inode *inode, FAR uint8_t *buffer,
+                            blkcnt_t start, unsigned int nsectors,
+                            uint16_t sectsize);
+ssize_t blkcache_directwrite(FAR struct inode *inode,
+                             FAR const uint8_t *buffer, blkcnt_t start,
+                             unsigned int nsectors, uint16_t sectsize);
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write all dirty cached sectors of the block driver to the media.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Discard all cached sectors of the block driver, dirty or not.  Call
+ *   blkcache_flush() first if the dirty sectors should be kept.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct inode *inode);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_BLKCACHE */
+#endif /* __INCLUDE_NUTTX_FS_BLKCACHE_H */
@@ -117,6 +117,7 @@
 #define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
 #define __FS_FLAG_LBF   (1 << 2) /* Line buffered */
 #define __FS_FLAG_UBF   (1 << 3) /* Buffer allocated by caller of setvbuf */
+#define __FS_FLAG_LAZY  (1 << 4) /* Buffer will be allocated on first use */
 
 /* Inode i_flags values:
  *
@@ -214,6 +215,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct iovec;
 struct fs_dirent_s;
 struct mtd_dev_s;
 
@@ -246,6 +248,15 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored I/O methods.  If these are NULL, readv() and
+   * writev() fall back to calling read() or write() once per buffer.
+   */
+
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -425,13 +436,29 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.  The files
+ * are allocated in blocks of CONFIG_NFILE_DESCRIPTORS_PER_BLOCK when they
+ * are first needed, so a task group that opens few files stays small even
+ * if CONFIG_NFILE_DESCRIPTORS is large.  A block is not moved or freed
+ * until the list is released.  One bit per descriptor records the
+ * descriptors that are in use.
+ */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#ifndef CONFIG_NFILE_DESCRIPTORS_PER_BLOCK
+#  define CONFIG_NFILE_DESCRIPTORS_PER_BLOCK 8
+#endif
+
+#define FILELIST_NBLOCKS \
+  ((CONFIG_NFILE_DESCRIPTORS + CONFIG_NFILE_DESCRIPTORS_PER_BLOCK - 1) / \
+   CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+#define FILELIST_NWORDS  ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
-  struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+  uint32_t fl_inuse[FILELIST_NWORDS];          /* Descriptors in use */
+  FAR struct file *fl_files[FILELIST_NBLOCKS]; /* Allocated blocks */
 };
 #endif
 
@@ -482,10 +509,39 @@ struct file_struct
 #endif
 };
 
+/* The first (up to) three streams of the list are reserved for stdin,
+ * stdout and stderr, which are set up for every task group.  These are
+ * held in the stream list itself.  The remaining streams are allocated
+ * together when fopen() or fdopen() first needs one of them.
+ */
+
+#if CONFIG_NFILE_STREAMS > 3
+#  define STREAMLIST_NSTDIO 3
+#else
+#  define STREAMLIST_NSTDIO CONFIG_NFILE_STREAMS
+#endif
+
+#define STREAMLIST_NEXTRA (CONFIG_NFILE_STREAMS - STREAMLIST_NSTDIO)
+
+/* Return the stream with index i in the list, or NULL if that stream has
+ * not yet been allocated.
+ */
+
+#if STREAMLIST_NEXTRA > 0
+#  define STREAMLIST_STREAM(l,i) \
+     ((i) < STREAMLIST_NSTDIO ? &(l)->sl_streams[i] : \
+      (l)->sl_extra != NULL ? &(l)->sl_extra[(i) - STREAMLIST_NSTDIO] : NULL)
+#else
+#  define STREAMLIST_STREAM(l,i) (&(l)->sl_streams[i])
+#endif
+
 struct streamlist
 {
   sem_t               sl_sem;   /* For thread safety */
-  struct file_struct sl_streams[CONFIG_NFILE_STREAMS];
+  struct file_struct sl_streams[STREAMLIST_NSTDIO];
+#if STREAMLIST_NEXTRA > 0
+  FAR struct file_struct *sl_extra; /* Allocated on demand */
+#endif
 };
 #endif /* CONFIG_NFILE_STREAMS */
 
@@ -721,6 +777,41 @@ void files_initlist(FAR struct filelist *list);
 void files_releaselist(FAR struct filelist *list);
 #endif
 
+/****************************************************************************
+ * Name: files_duplist
+ *
+ * Description:
+ *   Duplicate the first nfds file descriptors of one file list into
+ *   another, new file list.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist,
+                  int nfds);
+#endif
+
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file instance of a file descriptor in a file list.
+ *   The file may or may not be open.
+ *
+ * Returned Value:
+ *   The struct file instance or NULL if the descriptor is not valid or the
+ *   block holding it has not been allocated (and so it is not open).
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_fget(FAR struct filelist *list, int fd);
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -742,6 +833,43 @@ void files_releaselist(FAR struct filelist *list);
 int file_dup2(FAR struct file *filep1, FAR struct file *filep2);
 #endif
 
+/****************************************************************************
+ * Name: file_close_detached
+ *
+ * Description:
+ *   Close a struct file instance that is not part of any file list, such
+ *   as one set up by file_dup2() for internal OS use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int file_close_detached(FAR struct file *filep);
+#endif
+
+/****************************************************************************
+ * Name: file_install
+ *
+ * Description:
+ *   Move a struct file instance that is not part of any file list, such as
+ *   one set up by file_dup2() for internal OS use, into a new file
+ *   descriptor of the current task.  The open file is taken over as it is;
+ *   it is not re-opened.  On success, the detached instance is reset and
+ *   must not be closed.
+ *
+ * Returned Value:
+ *   The new file descriptor is returned on success; a negated errno value
+ *   is returned on any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int file_install(FAR struct file *filep, int minfd);
+#endif
+
 /****************************************************************************
  * Name: fs_dupfd OR dup
  *
@@ -1094,6 +1222,26 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
 
 ssize_t nx_read(int fd, FAR void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv and nx_readv
+ *
+ * Description:
+ *   The internal OS versions of readv() that accept a struct file instance
+ *   or a file (or socket) descriptor, respectively.  They do not modify the
+ *   errno variable and are not cancellation points.
+ *
+ * Returned Value:
+ *   The number of bytes read (zero at the end-of-file) or, if no data was
+ *   read, a negated errno value.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+#endif
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_write
  *
@@ -1135,6 +1283,26 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
 
 ssize_t nx_write(int fd, FAR const void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_writev and nx_writev
+ *
+ * Description:
+ *   The internal OS versions of writev() that accept a struct file
+ *   instance or a file (or socket) descriptor, respectively.  They do not
+ *   modify the errno variable and are not cancellation points.
+ *
+ * Returned Value:
+ *   The number of bytes written or, if no data was written, a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+#endif
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -1325,6 +1493,27 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 #endif
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Notify the poll waiter that events have been posted in fds->revents.
+ *   Drivers should use this function rather than posting fds->sem directly
+ *   so that notifications can be routed to the waiter's callback (see
+ *   epoll()).  This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   fds - The poll structure with the updated revents.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+void poll_notify(FAR struct pollfd *fds);
+#endif
+
 /****************************************************************************
  * Name: fdesc_poll
  *
@@ -1347,6 +1536,26 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf);
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 #endif
 
+/****************************************************************************
+ * Name: nx_poll
+ *
+ * Description:
+ *   nx_poll() is similar to the standard 'poll' interface except that is
+ *   not a cancellation point and it does not modify the errno variable.
+ *
+ *   nx_poll() is an internal NuttX interface and should not be called from
+ *   applications.
+ *
+ * Returned Value:
+ *   The number of structures that have non-zero revents fields is returned
+ *   on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int nx_poll(FAR struct pollfd *fds, unsigned int nfds, int timeout);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
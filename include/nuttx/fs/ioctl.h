@@ -93,6 +93,8 @@
 #define _MAC802154BASE  (0x2600) /* 802.15.4 MAC ioctl commands */
 #define _PWRBASE        (0x2700) /* Power-related ioctl commands */
 #define _FBIOCBASE      (0x2800) /* Frame buffer character driver ioctl commands */
+#define _PROFIOCBASE    (0x2900) /* Sampling profiler ioctl commands */
+#define _VIDIOCBASE     (0x2a00) /* Video capture ioctl commands */
 
 /* boardctl() commands share the same number space */
 
@@ -167,6 +169,12 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_FILEID     _FIOC(0x000b)     /* IN:  Location to return value
+                                           *      (uintptr_t *)
+                                           * OUT: A value that identifies the
+                                           *      open file uniquely within its
+                                           *      mounted volume.
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -261,6 +269,22 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_CACHESTATS _BIOC(0x000e)     /* Used only by BCH to return the
+                                           * sector cache statistics.
+                                           * IN:  Pointer to writable instance
+                                           *      of struct bch_cachestats_s
+                                           *      in which to return the
+                                           *      statistics.
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
+#define BIOC_FTLSTATS   _BIOC(0x000f)     /* Used only by the FTL to return
+                                           * write amplification statistics.
+                                           * IN:  Pointer to writable instance
+                                           *      of struct ftl_stats_s in
+                                           *      which to return the
+                                           *      statistics.
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -375,6 +399,15 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0002)  /* Get buffer capacity
+                                             * IN: None
+                                             * OUT: Capacity in bytes (as
+                                             *      the return value) */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0003)  /* Set buffer capacity
+                                             * IN: unsigned long integer
+                                             *     capacity in bytes
+                                             * OUT: New capacity (as the
+                                             *      return value) */
 
 /* RTC driver ioctl definitions *********************************************/
 /* (see nuttx/include/rtc.h */
@@ -470,6 +503,18 @@
 #define _FBIOCVALID(c)   (_IOC_TYPE(c)==_FBIOCBASE)
 #define _FBIOC(nr)       _IOC(_FBIOCBASE,nr)
 
+/* Sampling profiler driver *************************************************/
+/* (see nuttx/include/timers/profile.h */
+
+#define _PROFIOCVALID(c) (_IOC_TYPE(c)==_PROFIOCBASE)
+#define _PROFIOC(nr)     _IOC(_PROFIOCBASE,nr)
+
+/* Video capture driver *****************************************************/
+/* (see nuttx/include/video/video.h */
+
+#define _VIDIOCVALID(c)  (_IOC_TYPE(c)==_VIDIOCBASE)
+#define _VIDIOC(nr)      _IOC(_VIDIOCBASE,nr)
+
 /* boardctl() command definitions *******************************************/
 
 #define _BOARDIOCVALID(c) (_IOC_TYPE(c)==_BOARDBASE)
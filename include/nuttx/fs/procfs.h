@@ -41,6 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -133,6 +136,51 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+/* /proc/tasks is a binary file:  A struct procfs_taskhdr_s followed by
+ * 'nrecords' records of 'recsize' bytes each, one per task or thread.  New
+ * fields are only ever added to the end of a record, so readers should
+ * step through the records with 'recsize' rather than with the size of
+ * their own copy of struct procfs_taskstat_s.  Fields that the
+ * configuration does not support (CPU load, context switch counts, stack
+ * coloration, heap ownership) are zero.
+ *
+ * The snapshot is taken when the file is read at offset zero; reads at
+ * other offsets return the rest of the same snapshot.  So the statistics
+ * can be sampled again with lseek(fd, 0, SEEK_SET) and read().
+ */
+
+#define PROCFS_TASKSTAT_VERSION  1
+#define PROCFS_TASKSTAT_NAMELEN  16
+
+struct procfs_taskhdr_s
+{
+  uint16_t version;                      /* PROCFS_TASKSTAT_VERSION */
+  uint16_t hdrsize;                      /* Size of this header */
+  uint16_t recsize;                      /* Size of each record */
+  uint16_t nrecords;                     /* Number of records that follow */
+  uint32_t systime;                      /* Time of the snapshot (ticks) */
+};
+
+struct procfs_taskstat_s
+{
+  int32_t  pid;                          /* Task/thread ID */
+  uint16_t flags;                        /* TCB_FLAG_* bits */
+  uint8_t  state;                        /* enum tstate_e */
+  uint8_t  priority;                     /* Current priority */
+  uint8_t  basepriority;                 /* Base priority (without boosts) */
+  uint8_t  cpu;                          /* CPU of a running task (SMP) */
+  uint16_t reserved;
+  uint32_t cpuactive;                    /* CPU load:  Ticks while running */
+  uint32_t cputotal;                     /* CPU load:  Total ticks sampled */
+  uint32_t nvcsw;                        /* Voluntary context switches */
+  uint32_t nivcsw;                       /* Preemptions */
+  uint32_t stacksize;                    /* Stack size */
+  uint32_t stackused;                    /* Stack high water mark */
+  uint32_t heapused;                     /* User heap bytes allocated */
+  uint32_t heapchunks;                   /* User heap chunks allocated */
+  char     name[PROCFS_TASKSTAT_NAMELEN]; /* Name (NUL terminated) */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -46,6 +46,11 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#ifdef CONFIG_I2C_QUEUE
+#  include <stdbool.h>
+#  include <queue.h>
+#  include <nuttx/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -247,6 +252,40 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_QUEUE
+/* This describes one queued, asynchronous I2C transfer as handled by
+ * i2c_queue_submit().  The structure and the messages that it refers to
+ * must persist until the callback has been called.
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_reqcallback_t)(FAR struct i2c_request_s *req);
+
+struct i2c_request_s
+{
+  FAR struct i2c_request_s *flink; /* Supports a singly linked list */
+  FAR struct i2c_msg_s *msgv;      /* Array of I2C messages */
+  int msgc;                        /* Number of messages in the array */
+  i2c_reqcallback_t callback;      /* Called when the transfer completes */
+  FAR void *arg;                   /* For use by the callback */
+  uint8_t priority;                /* Higher priorities are served first */
+  bool pending;                    /* Waiting in the queue */
+  int result;                      /* Result of I2C_TRANSFER() */
+};
+
+/* The state of one I2C request queue.  There is one queue per I2C bus and
+ * it is normally allocated statically by board logic.
+ */
+
+struct i2c_queue_s
+{
+  FAR struct i2c_master_s *i2c;    /* The I2C bus */
+  sq_queue_t pending;              /* Requests waiting, by priority */
+  struct work_s work;              /* Performs the transfers */
+  bool busy;                       /* Work has been scheduled */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -356,6 +395,71 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Initialize a request queue for an I2C bus.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   i2c   - An instance of the lower half I2C driver
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_QUEUE
+void i2c_queue_initialize(FAR struct i2c_queue_s *queue,
+                          FAR struct i2c_master_s *i2c);
+
+/****************************************************************************
+ * Name: i2c_queue_submit
+ *
+ * Description:
+ *   Queue an I2C transfer and return immediately.  Transfers are performed
+ *   one at a time on the work queue with I2C_TRANSFER(), highest priority
+ *   first and in order of submission within a priority.  When the transfer
+ *   has completed, req->result is set and req->callback (if not NULL) is
+ *   called from the work queue.
+ *
+ *   A request that is submitted again while it is still waiting in the
+ *   queue is not queued a second time.  A sensor that is polled
+ *   periodically may therefore simply resubmit the same request on each
+ *   period; polls that the bus cannot keep up with are coalesced into one
+ *   transfer.
+ *
+ * Input Parameters:
+ *   queue - The I2C request queue
+ *   req   - Describes the transfer to perform
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_queue_submit(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  The
+ *   callback is not called.
+ *
+ * Input Parameters:
+ *   queue - The I2C request queue
+ *   req   - The request to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the request is not waiting in the
+ *   queue (it is being performed or has already completed).
+ *
+ ****************************************************************************/
+
+int i2c_queue_cancel(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * include/nuttx/initcall.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INITCALL_H
+#define __INCLUDE_NUTTX_INITCALL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initialization calls are identified by a small integer that the board
+ * logic assigns.  Dependencies are given as a set of these identifiers.
+ */
+
+#define INITCALL_ID_MAX       31
+#define INITCALL_DEPEND(id)   ((uint32_t)1 << (id))
+
+/* Values for the flags field of struct initcall_s */
+
+#define INITCALL_DEFERRED     (1 << 0)  /* Run only when first waited for */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the type of the function that performs the initialization.  It
+ * returns zero (OK) on success or a negated errno value on failure.
+ */
+
+typedef CODE int (*initcall_t)(FAR void *arg);
+
+/* This structure describes one initialization call.  It is provided by the
+ * caller of initcall_register() and must persist;  it is typically
+ * statically allocated.
+ *
+ *   name    - A name for debug output.
+ *   func    - The initialization function.
+ *   arg     - The argument passed to func().
+ *   depends - The set of INITCALL_DEPEND() identifiers of the calls that
+ *             must complete before this one may run.  Dependencies must not
+ *             be circular.
+ *   id      - The unique identifier of this call, 0..INITCALL_ID_MAX.
+ *   flags   - INITCALL_DEFERRED:  Do not run the call on the initialization
+ *             threads;  run it when initcall_wait() is first called for it
+ *             (on the thread of the caller of initcall_wait()).
+ *
+ * The remaining fields are used internally.
+ */
+
+struct initcall_s
+{
+  FAR struct initcall_s *flink;  /* Supports a singly linked list */
+  FAR const char *name;          /* Name for debug output */
+  initcall_t      func;          /* The initialization function */
+  FAR void       *arg;           /* Argument passed to func() */
+  uint32_t        depends;       /* Calls that must complete first */
+  uint8_t         id;            /* This call's identifier */
+  uint8_t         flags;         /* See INITCALL_* definitions */
+  volatile uint8_t state;        /* Internal state of the call */
+  int             result;        /* Value returned by func() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register a (presumably slow) initialization call, such as the probe of
+ *   an SD card or the auto-negotiation of an Ethernet PHY.  The call will
+ *   be run on one of the CONFIG_SCHED_INITCALL_NTHREADS initialization
+ *   threads as soon as all of its dependencies have completed, in parallel
+ *   with other initialization calls and with the rest of the system
+ *   start-up.  Deferred calls are run only when initcall_wait() is first
+ *   called for them.
+ *
+ *   Calls may be registered at any time, including from up_initialize()
+ *   and board_initialize().  Calls registered before the OS is fully
+ *   initialized start when the initialization threads are started by
+ *   os_bringup().
+ *
+ * Input Parameters:
+ *   call - Describes the initialization call.
+ *
+ * Returned Value:
+ *   Zero (OK) on success;  a negated errno value on failure:
+ *
+ *   EINVAL - The call depends on itself
+ *   EEXIST - A call with that identifier is already registered
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call);
+
+/****************************************************************************
+ * Name: initcall_wait
+ *
+ * Description:
+ *   Wait for an initialization call to complete.  This is called before
+ *   first use of the resource that the call initializes.  If the call has
+ *   not yet started (because it is deferred or because the initialization
+ *   threads are busy) then it is run on the caller's thread, after first
+ *   waiting for its dependencies.
+ *
+ *   This must not be called from an interrupt handler or from the IDLE
+ *   thread.
+ *
+ * Input Parameters:
+ *   id - The identifier of the call to wait for.
+ *
+ * Returned Value:
+ *   The value returned by the initialization function.  -ENOENT is
+ *   returned if there is no call with that identifier.
+ *
+ ****************************************************************************/
+
+int initcall_wait(int id);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_INITCALL */
+#endif /* __INCLUDE_NUTTX_INITCALL_H */
@@ -50,6 +50,9 @@
  ************************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 
 #ifdef CONFIG_INPUT
@@ -104,6 +107,7 @@
 #define TOUCH_POS_VALID      (1 << 4) /* Hardware provided a valid X/Y position */
 #define TOUCH_PRESSURE_VALID (1 << 5) /* Hardware provided a valid pressure */
 #define TOUCH_SIZE_VALID     (1 << 6) /* Hardware provided a valid H/W contact size */
+#define TOUCH_TIME_VALID     (1 << 7) /* The timestamp of the report is valid */
 
 /************************************************************************************
  * Public Types
@@ -122,6 +126,7 @@ struct touch_point_s
   int16_t  h;        /* Height of touch point (uncalibrated) */
   int16_t  w;        /* Width of touch point (uncalibrated) */
   uint16_t pressure; /* Touch pressure */
+  uint64_t timestamp; /* Time of the report in microseconds (see TOUCH_TIME_VALID) */
 };
 
 /* The typical touchscreen driver is a read-only, input character device driver.
@@ -145,6 +150,42 @@ struct touch_sample_s
 };
 #define SIZEOF_TOUCH_SAMPLE_S(n) (sizeof(struct touch_sample_s) + ((n)-1)*sizeof(struct touch_point_s))
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/* The touchscreen driver may be a two-part driver:
+ *
+ * 1) The common upper half driver (drivers/input/touchscreen_upper.c) that
+ *    provides the character driver interface, queues time stamped touch
+ *    samples, coalesces motion and tracks the multi-touch contacts, and
+ * 2) A lower half driver that talks to the touch controller and reports
+ *    each new sample with touch_event().
+ *
+ * This structure defines the interface between an instance of the lower
+ * half driver and the upper half driver.  It is provided by the lower half
+ * and must persist while the driver is registered.
+ */
+
+struct touch_lowerhalf_s
+{
+  uint8_t maxpoint;  /* Maximum number of simultaneous touch points */
+  FAR void *priv;    /* Upper half state (set by touch_register()) */
+
+  /* Start and stop sampling.  open() is called on the first open of the
+   * device and close() when the last reference is closed.  Either may be
+   * NULL.
+   */
+
+  CODE int (*open)(FAR struct touch_lowerhalf_s *lower);
+  CODE int (*close)(FAR struct touch_lowerhalf_s *lower);
+
+  /* Driver specific ioctl commands (such as TSIOC_SETFREQUENCY).  May be
+   * NULL.
+   */
+
+  CODE int (*control)(FAR struct touch_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+#endif
+
 /************************************************************************************
  * Public Function Prototypes
  ************************************************************************************/
@@ -157,6 +198,61 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/************************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Bind a touchscreen lower half driver to a new instance of the upper half
+ *   driver and register the character driver at the specified path (usually
+ *   /dev/inputN).
+ *
+ * Input Parameters:
+ *   lower    - The lower half driver instance
+ *   path     - The device path
+ *   nbuffers - The number of touch samples that can be queued
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, a negated errno value is
+ *   returned to indicate the nature of the failure.
+ *
+ ************************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t nbuffers);
+
+/************************************************************************************
+ * Name: touch_unregister
+ *
+ * Description:
+ *   Unregister the character driver and free the upper half driver instance.
+ *
+ ************************************************************************************/
+
+void touch_unregister(FAR struct touch_lowerhalf_s *lower, FAR const char *path);
+
+/************************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Report a new touch sample to the upper half driver.  Points are matched to
+ *   their contacts by ID, unchanged motion reports are dropped and, if the
+ *   newest queued sample has not been read yet and holds only motion of the
+ *   same contacts, it is replaced instead of queuing another sample.  If the
+ *   queue is full, the oldest sample is discarded.  The sample is time stamped
+ *   here unless the lower half set TOUCH_TIME_VALID.
+ *
+ *   This function may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   priv   - The priv field of the lower half structure
+ *   sample - The new touch sample.  The contents are copied.
+ *
+ ************************************************************************************/
+
+void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -81,6 +81,26 @@
  * Description: Set the GPIO pin type.
  * Argument:    The enum gpio_pintype_e type.
  *
+ * The following commands are supported only by GPIO port devices
+ * (/dev/gpportN).  Bit n of each pin set is I/O expander pin n.
+ * GPIOC_REGISTER and GPIOC_UNREGISTER are also supported:  The signal
+ * value (sigev_value.sival_int) is replaced by the set of pins that
+ * changed.
+ *
+ * Command:     GPIOC_PORTREAD
+ * Description: Read the level of all pins of the port at once.
+ * Argument:    A pointer to a uint32_t to receive the pin levels.
+ *
+ * Command:     GPIOC_PORTWRITE
+ * Description: Set the level of several output pins at once.
+ * Argument:    A pointer to an instance of struct gpio_port_s.  The pins
+ *              in gp_mask are set to the corresponding bits of gp_value.
+ *
+ * Command:     GPIOC_PORTDIRECTION
+ * Description: Set the direction of several pins at once.
+ * Argument:    A pointer to an instance of struct gpio_port_s.  The pins
+ *              in gp_mask whose bit is set in gp_value become outputs;
+ *              the others become inputs.
  */
 
 #define GPIOC_WRITE      _GPIOC(1)
@@ -89,6 +109,9 @@
 #define GPIOC_REGISTER   _GPIOC(4)
 #define GPIOC_UNREGISTER _GPIOC(5)
 #define GPIOC_SETPINTYPE _GPIOC(6)
+#define GPIOC_PORTREAD   _GPIOC(7)
+#define GPIOC_PORTWRITE  _GPIOC(8)
+#define GPIOC_PORTDIRECTION _GPIOC(9)
 
 /****************************************************************************
  * Public Types
@@ -139,6 +162,14 @@ struct gpio_operations_s
                             enum gpio_pintype_e pintype);
 };
 
+/* Argument of GPIOC_PORTWRITE and GPIOC_PORTDIRECTION */
+
+struct gpio_port_s
+{
+  uint32_t gp_mask;    /* The set of pins to change */
+  uint32_t gp_value;   /* The new pin levels or directions */
+};
+
  /* Signal information */
 
 struct gpio_signal_s
@@ -241,6 +272,32 @@ int gpio_lower_half(FAR struct ioexpander_dev_s *ioe, unsigned int pin,
                     enum gpio_pintype_e pintype, int minor);
 #endif
 
+/****************************************************************************
+ * Name: gpio_port_register
+ *
+ * Description:
+ *   Register a GPIO port device driver at /dev/gpportN that gives access
+ *   to a group of I/O expander pins with one ioctl() call per operation.
+ *   The pins must already have been configured by the caller (including
+ *   the interrupt type of pins whose changes are to be signalled).
+ *
+ * Input Parameters:
+ *   ioe     - An instance of the I/O expander interface.  It must support
+ *             the port methods (see IOEXP_READPORT).
+ *   pinmask - The set of I/O expander pins in the port (pins 0-31)
+ *   minor   - The minor device number to use when registering the device
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_GPIO_PORT
+struct ioexpander_dev_s;
+int gpio_port_register(FAR struct ioexpander_dev_s *ioe, uint32_t pinmask,
+                       int minor);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
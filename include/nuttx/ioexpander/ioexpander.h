@@ -56,6 +56,10 @@
 #  define CONFIG_IOEXPANDER_NPINS 16
 #endif
 
+#if defined(CONFIG_IOEXPANDER_PORT) && CONFIG_IOEXPANDER_NPINS > 64
+#  error Port access requires CONFIG_IOEXPANDER_NPINS <= 64
+#endif
+
 /* Pin definitions **********************************************************/
 
 #define IOEXPANDER_DIRECTION_IN    0
@@ -286,6 +290,76 @@
 #define IOEP_DETACH(dev,handle) ((dev)->ops->ioe_detach(dev,handle))
 #endif
 
+#ifdef CONFIG_IOEXPANDER_PORT
+/****************************************************************************
+ * Name: IOEXP_READPORT
+ *
+ * Description:
+ *   Read the level of all pins of the I/O expander in one bus transaction
+ *   (per register).  Optional.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   pinset - The location to return the pin levels.  Bit n corresponds to
+ *            pin n.  Pin inversion has already been applied.
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code; -ENOSYS if the driver does
+ *   not support port access.
+ *
+ ****************************************************************************/
+
+#define IOEXP_READPORT(dev,pinset) \
+  ((dev)->ops->ioe_readport ? (dev)->ops->ioe_readport(dev,pinset) : \
+   -ENOSYS)
+
+/****************************************************************************
+ * Name: IOEXP_WRITEPORT
+ *
+ * Description:
+ *   Set the level of several output pins at once.  Optional.  Pins not in
+ *   the mask are not changed.  Drivers that keep a copy of the output
+ *   register will do this without reading the device.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   mask  - The set of pins to change
+ *   value - The new levels of the pins in mask
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code; -ENOSYS if the driver does
+ *   not support port access.
+ *
+ ****************************************************************************/
+
+#define IOEXP_WRITEPORT(dev,mask,value) \
+  ((dev)->ops->ioe_writeport ? (dev)->ops->ioe_writeport(dev,mask,value) : \
+   -ENOSYS)
+
+/****************************************************************************
+ * Name: IOEXP_SETPORTDIRECTION
+ *
+ * Description:
+ *   Set the direction of several pins at once.  Optional.  Pins not in the
+ *   mask are not changed.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   mask    - The set of pins to change
+ *   outputs - Pins in mask that are set here become outputs; the other
+ *             pins in mask become inputs.
+ *
+ * Returned Value:
+ *   0 on success, else a negative error code; -ENOSYS if the driver does
+ *   not support port access.
+ *
+ ****************************************************************************/
+
+#define IOEXP_SETPORTDIRECTION(dev,mask,outputs) \
+  ((dev)->ops->ioe_portdirection ? \
+   (dev)->ops->ioe_portdirection(dev,mask,outputs) : -ENOSYS)
+#endif /* CONFIG_IOEXPANDER_PORT */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -349,6 +423,14 @@ struct ioexpander_ops_s
   CODE int (*ioe_detach)(FAR struct ioexpander_dev_s *dev,
                          FAR void *handle);
 #endif
+#ifdef CONFIG_IOEXPANDER_PORT
+  CODE int (*ioe_readport)(FAR struct ioexpander_dev_s *dev,
+                           FAR ioe_pinset_t *pinset);
+  CODE int (*ioe_writeport)(FAR struct ioexpander_dev_s *dev,
+                            ioe_pinset_t mask, ioe_pinset_t value);
+  CODE int (*ioe_portdirection)(FAR struct ioexpander_dev_s *dev,
+                                ioe_pinset_t mask, ioe_pinset_t outputs);
+#endif
 };
 
 struct ioexpander_dev_s
@@ -61,6 +61,12 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* The value that the top half of a threaded interrupt handler returns in
+ * order to run the bottom half on the IRQ thread.  See irq_attach_thread().
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -171,6 +177,26 @@ int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  'isr' (which
+ *   may be NULL) runs in interrupt context and returns IRQ_WAKE_THREAD to
+ *   mask the IRQ and run 'isrthread' on a dedicated kernel thread of the
+ *   given priority.  The IRQ is unmasked when 'isrthread' returns.  A
+ *   NULL 'isrthread' detaches the IRQ and stops the thread.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQTHREAD
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size);
+#endif
+
 /****************************************************************************
  * Name: enter_critical_section
  *
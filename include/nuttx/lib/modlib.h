@@ -178,6 +178,12 @@ struct module_s
   size_t datasize;                     /* Size of the kernel .bss/.data memory allocation */
 #endif
 
+#ifdef CONFIG_LIBC_DLLFCN_SHARED
+  uint16_t refs;                       /* Number of dlopen() references */
+  time_t mtime;                        /* Modification time of the file */
+  off_t fsize;                         /* Size of the file */
+#endif
+
 #if CONFIG_MODLIB_MAXDEPEND > 0
   uint8_t dependents;                  /* Number of modules that depend on this module */
 
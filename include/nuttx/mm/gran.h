@@ -124,10 +124,6 @@ extern "C"
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -196,9 +192,9 @@ void gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size);
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   Allocations of up to 32 granules are found with a fast, word-at-a-
+ *   time search of the GAT.  Larger allocations use a slower search for
+ *   a first fit run of free granules.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -84,10 +84,60 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Low watermark notification */
+
+#ifndef CONFIG_IOB_LOWATER
+#  define CONFIG_IOB_LOWATER 0
+#endif
+
+/* Additional I/O buffers may be allocated from the heap */
+
+#ifndef CONFIG_IOB_GROW_MAX
+#  define CONFIG_IOB_GROW_MAX 0
+#endif
+
+/* I/O buffer data alignment.  If non-zero, io_data[] is aligned to
+ * CONFIG_IOB_ALIGNMENT and sized to a whole multiple of it so that it
+ * may be used directly for DMA on cached cores.
+ */
+
+#ifndef CONFIG_IOB_ALIGNMENT
+#  define CONFIG_IOB_ALIGNMENT 0
+#endif
+
+#if (CONFIG_IOB_ALIGNMENT & (CONFIG_IOB_ALIGNMENT - 1)) != 0
+#  error CONFIG_IOB_ALIGNMENT must be a power of two
+#endif
+
+#if CONFIG_IOB_ALIGNMENT > 0
+#  define IOB_ALIGNUP(n) \
+     (((n) + CONFIG_IOB_ALIGNMENT - 1) & ~(CONFIG_IOB_ALIGNMENT - 1))
+#  define IOB_DATASIZE   IOB_ALIGNUP(CONFIG_IOB_BUFSIZE)
+#else
+#  define IOB_ALIGNUP(n) (n)
+#  define IOB_DATASIZE   CONFIG_IOB_BUFSIZE
+#endif
+
+/* Large I/O buffers */
+
+#ifndef CONFIG_IOB_NLARGE
+#  define CONFIG_IOB_NLARGE 0
+#endif
+
+#if CONFIG_IOB_NLARGE > 0 && CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
+#if CONFIG_IOB_NLARGE > 0
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -100,9 +150,30 @@
  * Public Types
  ****************************************************************************/
 
+/* Identifies the consumer of an I/O buffer.  This is used to account for
+ * I/O buffers and to enforce per-consumer quotas (see CONFIG_IOB_QUOTA).
+ * Buffers added to an existing chain are accounted to the consumer of the
+ * chain.
+ */
+
+enum iob_user_e
+{
+  IOBUSER_UNKNOWN = 0,         /* Any other consumer (no quota) */
+  IOBUSER_NET_TCP_READAHEAD,   /* TCP read-ahead buffering */
+  IOBUSER_NET_TCP_WRITEBUFFER, /* TCP write buffering */
+  IOBUSER_NET_UDP,             /* UDP read-ahead and write buffering */
+  IOBUSER_NET_6LOWPAN,         /* 6LoWPAN frames */
+  IOBUSER_WIRELESS_BLUETOOTH,  /* Bluetooth frames */
+  IOBUSER_NENTRIES             /* Number of consumers */
+};
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
+ *
+ * A large I/O buffer (CONFIG_IOB_NLARGE > 0) has the same layout but its
+ * io_data[] extends to io_bufsize bytes.  Use IOB_BUFSIZE() rather than
+ * CONFIG_IOB_BUFSIZE for the capacity of any buffer in a chain.
  */
 
 struct iob_s
@@ -113,7 +184,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && CONFIG_IOB_NLARGE == 0
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -121,8 +192,23 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
+#if CONFIG_IOB_NLARGE > 0
+  uint16_t io_bufsize;  /* Size of io_data[] */
+#endif
+#ifdef CONFIG_IOB_REFCOUNT
+  uint8_t  io_refs;     /* Number of references to the I/O buffer */
+  uint8_t  io_shares;   /* Additional holders of the chain (head only) */
+#endif
+#ifdef CONFIG_IOB_QUOTA
+  uint8_t  io_user;     /* Consumer of the I/O buffer (enum iob_user_e) */
+#endif
 
-  uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#if CONFIG_IOB_ALIGNMENT > 0
+  uint8_t  io_data[IOB_DATASIZE]
+           __attribute__ ((aligned(CONFIG_IOB_ALIGNMENT)));
+#else
+  uint8_t  io_data[IOB_DATASIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -187,6 +273,56 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_user
+ *
+ * Description:
+ *   Allocate an I/O buffer on behalf of the consumer 'user', waiting if
+ *   necessary for a buffer to become free or for the consumer to fall back
+ *   under its quota.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_user(bool throttled, enum iob_user_e user);
+
+/****************************************************************************
+ * Name: iob_tryalloc_user
+ *
+ * Description:
+ *   Try to allocate an I/O buffer on behalf of the consumer 'user' without
+ *   waiting.  NULL is returned if there is no free buffer or if the
+ *   consumer already holds its quota of buffers.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_user(bool throttled, enum iob_user_e user);
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for 'size' bytes of data on behalf of the
+ *   consumer 'user'.  If 'size' exceeds CONFIG_IOB_BUFSIZE and a large I/O
+ *   buffer is free, then a large I/O buffer is returned.  Otherwise this
+ *   is the same as iob_alloc_user().  The returned buffer may be smaller
+ *   than 'size'; see IOB_BUFSIZE().
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(bool throttled, enum iob_user_e user,
+                                 unsigned int size);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but never waits for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, enum iob_user_e user,
+                                    unsigned int size);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -197,6 +333,20 @@ FAR struct iob_s *iob_tryalloc(bool throttled);
 
 int iob_navail(bool throttled);
 
+/****************************************************************************
+ * Name: iob_user_inuse
+ *
+ * Description:
+ *   Return the number of IOBs currently held by the consumer 'user'.  The
+ *   peak number of IOBs ever held by that consumer is returned in 'peak' if
+ *   it is not NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+int iob_user_inuse(enum iob_user_e user, FAR int *peak);
+#endif
+
 /****************************************************************************
  * Name: iob_qentry_navail
  *
@@ -249,6 +399,36 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob);
 int iob_notifier_setup(int qid, worker_t worker, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: iob_lowater_setup
+ *
+ * Description:
+ *   Set up to perform a callback to the worker function when the number of
+ *   free IOBs falls to the low watermark, CONFIG_IOB_LOWATER.  The worker
+ *   function will execute on the selected priority worker thread.
+ *
+ * Input Parameters:
+ *   qid    - Selects work queue.  Must be HPWORK or LPWORK.
+ *   worker - The worker function to execute on the work queue when the
+ *            event occurs.
+ *   arg    - A user-defined argument that will be available to the worker
+ *            function when it runs.
+ *
+ * Returned Value:
+ *   > 0   - The notification is in place.  The returned value is a key
+ *           that may be used later in a call to iob_notifier_teardown().
+ *   == 0  - There are already no more than CONFIG_IOB_LOWATER free IOBs.
+ *           No notification will be provided.
+ *   < 0   - An unexpected error occurred and no notification will be
+ *           provided.  The returned value is a negated errno value that
+ *           indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_IOB_NOTIFIER) && CONFIG_IOB_LOWATER > 0
+int iob_lowater_setup(int qid, worker_t worker, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_teardown
  *
@@ -301,12 +481,60 @@ void iob_notifier_signal(void);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  If the chain is shared (see iob_share_chain()), then
+ *   only the caller's hold on the chain is released.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_share_chain
+ *
+ * Description:
+ *   Add another holder of an entire I/O buffer chain.  Each holder releases
+ *   the chain with iob_free_chain() and the chain is freed when the last
+ *   holder does so.  A shared chain is read-only:  No holder may modify,
+ *   trim, or extend it or free any I/O buffer in it individually.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EMLINK is returned if the chain
+ *   already has the maximum number of holders.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_REFCOUNT
+int iob_share_chain(FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: iob_addref
+ *
+ * Description:
+ *   Take an additional reference to a single I/O buffer.  The I/O buffer
+ *   will not be returned to the free list until the reference is dropped
+ *   with iob_unref(), even if the owner of the chain containing it frees
+ *   it in the meantime.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_REFCOUNT
+void iob_addref(FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: iob_unref
+ *
+ * Description:
+ *   Drop a reference taken with iob_addref().  If this is the last
+ *   reference to the I/O buffer, then the I/O buffer is freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_REFCOUNT
+void iob_unref(FAR struct iob_s *iob);
+#endif
+
 /****************************************************************************
  * Name: iob_add_queue
  *
@@ -348,6 +576,24 @@ int iob_tryadd_queue(FAR struct iob_s *iob, FAR struct iob_queue_s *iobq);
 FAR struct iob_s *iob_remove_queue(FAR struct iob_queue_s *iobq);
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+/****************************************************************************
+ * Name: iob_split_queue
+ *
+ * Description:
+ *   Remove up to 'maxiobs' I/O buffers from the beginning of the I/O buffer
+ *   chain at the head of the queue and return them as a separate chain.
+ *   The remainder of the chain, if any, stays at the head of the queue.
+ *
+ * Returned Value:
+ *   The I/O buffer chain removed from the head of the queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+FAR struct iob_s *iob_split_queue(FAR struct iob_queue_s *iobq,
+                                  unsigned int maxiobs);
+#endif /* CONFIG_IOB_NCHAINS > 0 */
+
 /****************************************************************************
  * Name: iob_peek_queue
  *
@@ -109,6 +109,27 @@
 #  undef CONFIG_MM_KERNEL_HEAP
 #endif
 
+/* Per-CPU chunk caches depend on disabling local interrupts and so are
+ * not available for user-space heaps in the PROTECTED and KERNEL builds.
+ *
+ *   MM_USE_CPUCACHE
+ *     Per-CPU chunk caches are used by the heap logic
+ *   MM_CPUCACHE_NCPUS
+ *     The number of per-CPU caches in each heap
+ */
+
+#undef MM_USE_CPUCACHE
+#if defined(CONFIG_MM_CPUCACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_USE_CPUCACHE 1
+#endif
+
+#ifdef CONFIG_SMP
+#  define MM_CPUCACHE_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define MM_CPUCACHE_NCPUS 1
+#endif
+
 /* Chunk Header Definitions *************************************************/
 /* These definitions define the characteristics of allocator
  *
@@ -125,13 +146,23 @@
  *   minor performance losses.
  */
 
+/* When chunk owners are recorded, the chunk header is enlarged by a pid
+ * and a caller address and the smallest chunk doubles in size.
+ */
+
+#ifdef CONFIG_MM_OWNER
+#  define MM_OWNER_SHIFT  1
+#else
+#  define MM_OWNER_SHIFT  0
+#endif
+
 #if defined(CONFIG_MM_SMALL) && UINTPTR_MAX <= UINT32_MAX
 /* Two byte offsets; Pointers may be 2 or 4 bytes;
  * sizeof(struct mm_freenode_s) is 8 or 12 bytes.
  * REVISIT: We could do better on machines with 16-bit addressing.
  */
 
-#  define MM_MIN_SHIFT    4  /* 16 bytes */
+#  define MM_MIN_SHIFT   (4 + MM_OWNER_SHIFT)  /* 16 (32) bytes */
 #  define MM_MAX_SHIFT   15  /* 32 Kb */
 
 #elif defined(CONFIG_HAVE_LONG_LONG)
@@ -140,9 +171,9 @@
  */
 
 #  if UINTPTR_MAX <= UINT32_MAX
-#    define MM_MIN_SHIFT  4  /* 16 bytes */
+#    define MM_MIN_SHIFT (4 + MM_OWNER_SHIFT)  /* 16 (32) bytes */
 #  elif UINTPTR_MAX <= UINT64_MAX
-#    define MM_MIN_SHIFT  5  /* 32 bytes */
+#    define MM_MIN_SHIFT (5 + MM_OWNER_SHIFT)  /* 32 (64) bytes */
 #  endif
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 
@@ -151,7 +182,7 @@
  * sizeof(struct mm_freenode_s) is 16 bytes.
  */
 
-#  define MM_MIN_SHIFT    4  /* 16 bytes */
+#  define MM_MIN_SHIFT   (4 + MM_OWNER_SHIFT)  /* 16 (32) bytes */
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
@@ -161,6 +192,24 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* TLSF free list definitions:
+ *
+ * MM_TLSF_SLSHIFT - Log2 of the number of second level size classes
+ *   within each first level (power of two) range.
+ * MM_TLSF_FLSHIFT - Chunks smaller than (1 << MM_TLSF_FLSHIFT) are all
+ *   held in first level 0 in linearly spaced classes of MM_MIN_CHUNK
+ *   bytes.
+ * MM_TLSF_FLCOUNT - The number of first level ranges.  The last range
+ *   also holds all chunks of MM_MAX_CHUNK bytes or more.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_TLSF_SLSHIFT  CONFIG_MM_TLSF_SLSHIFT
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLSHIFT  (MM_MIN_SHIFT + MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLCOUNT  (MM_MAX_SHIFT - MM_TLSF_FLSHIFT + 2)
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -200,11 +249,17 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_OWNER
+  pid_t pid;               /* Owning task, or -1 if not owned */
+  FAR void *caller;        /* Return address of the allocation call */
+#endif
 };
 
 /* What is the size of the allocnode? */
 
-#ifdef CONFIG_MM_SMALL
+#if defined(CONFIG_MM_OWNER)
+# define SIZEOF_MM_ALLOCNODE   sizeof(struct mm_allocnode_s)
+#elif defined(CONFIG_MM_SMALL)
 # define SIZEOF_MM_ALLOCNODE   4
 #else
 # define SIZEOF_MM_ALLOCNODE   8
@@ -219,6 +274,10 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_OWNER
+  pid_t pid;                       /* Unused in free chunks */
+  FAR void *caller;
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -231,6 +290,38 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+/* MM_CALLER() provides the return address that is recorded as the caller
+ * of an allocation.  It must be expanded in the outermost allocation
+ * function.
+ */
+
+#ifdef CONFIG_MM_OWNER
+#  ifdef CONFIG_HAVE_BUILTIN_RETURN_ADDRESS
+#    define MM_CALLER()  __builtin_return_address(0)
+#  else
+#    define MM_CALLER()  NULL
+#  endif
+#  define MM_SETOWNER(n,c) mm_setowner(n,c)
+#  define MM_CLROWNER(n)   do { (n)->pid = -1; } while (0)
+#else
+#  define MM_SETOWNER(n,c)
+#  define MM_CLROWNER(n)
+#endif
+
+/* This describes the cache of recently freed chunks of one CPU.  Cached
+ * chunks remain allocated in the heap and are linked through the 'flink'
+ * field of the (otherwise unused) free node.  There is one list for each
+ * MM_NNODES size class.
+ */
+
+#ifdef CONFIG_MM_CPUCACHE
+struct mm_cpucache_s
+{
+  FAR struct mm_freenode_s *mc_list[MM_NNODES];
+  uint8_t mc_count[MM_NNODES];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -256,12 +347,28 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are maintained in one doubly linked list for each TLSF size
+   * class.  The bitmaps indicate which lists are non-empty.
+   */
+
+  uint32_t mm_tlsf_flbitmap;
+  uint32_t mm_tlsf_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_tlsf_list[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Per-CPU caches of recently freed chunks */
+
+  struct mm_cpucache_s mm_cpucache[MM_CPUCACHE_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -367,6 +474,8 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -377,6 +486,8 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *chunk);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -503,20 +614,61 @@ int kmm_mallinfo(struct mallinfo *info);
 #endif /* CONFIG_CAN_PASS_STRUCTS */
 #endif /* CONFIG_MM_KERNEL_HEAP */
 
+/* Functions contained in mm_foreach.c **************************************/
+
+#ifdef CONFIG_MM_OWNER
+typedef CODE void (*mm_foreach_t)(FAR struct mm_allocnode_s *node,
+                                  FAR void *arg);
+
+void mm_foreach(FAR struct mm_heap_s *heap, mm_foreach_t handler,
+                FAR void *arg);
+
+/* Functions contained in umm_foreach.c *************************************/
+
+void umm_foreach(mm_foreach_t handler, FAR void *arg);
+
+/* Functions contained in kmm_foreach.c *************************************/
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+void kmm_foreach(mm_foreach_t handler, FAR void *arg);
+#endif
+
+/* Functions contained in mm_owner.c ****************************************/
+
+void mm_setowner(FAR struct mm_allocnode_s *node, FAR void *caller);
+#endif
+
 /* Functions contained in mm_shrinkchunk.c **********************************/
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c *******************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+#ifdef CONFIG_MM_TLSF
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size);
+#endif
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef MM_USE_CPUCACHE
+FAR struct mm_allocnode_s *mm_cpucache_alloc(FAR struct mm_heap_s *heap,
+                                             size_t alignsize);
+bool mm_cpucache_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *chunk);
+bool mm_cpucache_flush(FAR struct mm_heap_s *heap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
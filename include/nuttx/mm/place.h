@@ -0,0 +1,230 @@
+/****************************************************************************
+ * include/nuttx/mm/place.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_PLACE_H
+#define __INCLUDE_NUTTX_MM_PLACE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_PLACE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Placement hints.  These describe the properties of the memory in a named
+ * heap and, when passed to place_malloc() and friends, the properties that
+ * the caller wants.  A heap satisfies a request if it has all of the
+ * requested properties.
+ */
+
+#define PLACE_ANY         0         /* No preference */
+#define PLACE_FAST        (1 << 0)  /* Fast (e.g., tightly-coupled) memory */
+#define PLACE_DMA         (1 << 1)  /* Memory that is accessible by DMA */
+#define PLACE_LARGE       (1 << 2)  /* Bulk memory (e.g., external SDRAM) */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one named heap.  The structure is normally
+ * allocated statically by the board logic that adds the memory and must
+ * not be modified directly.
+ */
+
+struct place_heap_s
+{
+  FAR struct place_heap_s *ph_flink; /* Supports a list of all heaps */
+  FAR const char *ph_name;           /* Name of the heap (for procfs) */
+  uint8_t ph_flags;                  /* Properties of the memory */
+  struct mm_heap_s ph_heap;          /* The heap itself */
+};
+
+/* This structure holds a snapshot of the state of one heap as reported by
+ * place_foreach().
+ */
+
+struct placeinfo_s
+{
+  FAR const char *name;              /* Name of the heap */
+  uint8_t flags;                     /* Properties of the memory */
+  size_t arena;                      /* Total size of the heap */
+  size_t used;                       /* Allocated bytes */
+  size_t free;                       /* Free bytes */
+  size_t largest;                    /* Largest free chunk */
+};
+
+/* This is the type of the callback used with place_foreach() */
+
+typedef CODE void (*place_handler_t)(FAR const struct placeinfo_s *info,
+                                     FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: place_initialize
+ *
+ * Description:
+ *   Initialize a named heap with its first memory region and add it to
+ *   the list of heaps searched by place_malloc().  Heaps are searched in
+ *   the order in which they were added.  This is normally called by the
+ *   board logic from up_addregion().
+ *
+ * Input Parameters:
+ *   heap  - The heap to be initialized
+ *   name  - A name for the heap.  The string must persist.
+ *   flags - The properties of the memory (PLACE_FAST, etc.)
+ *   start - Start of the memory region
+ *   size  - Size of the memory region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void place_initialize(FAR struct place_heap_s *heap, FAR const char *name,
+                      uint8_t flags, FAR void *start, size_t size);
+
+/****************************************************************************
+ * Name: place_addregion
+ *
+ * Description:
+ *   Add one more memory region, with the same properties, to a named heap.
+ *   At most CONFIG_MM_REGIONS regions may be added in total.
+ *
+ ****************************************************************************/
+
+void place_addregion(FAR struct place_heap_s *heap, FAR void *start,
+                     size_t size);
+
+/****************************************************************************
+ * Name: place_find
+ *
+ * Description:
+ *   Return the named heap with the given name or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct place_heap_s *place_find(FAR const char *name);
+
+/****************************************************************************
+ * Name: place_malloc, place_zalloc, place_memalign
+ *
+ * Description:
+ *   Allocate memory from the first named heap that has all of the
+ *   properties in 'flags' and that can satisfy the request.  If there is
+ *   none, the memory is allocated from the kernel heap instead.  Use
+ *   place_free() to release the memory.
+ *
+ * Input Parameters:
+ *   flags     - The requested properties (PLACE_FAST, etc.)
+ *   alignment - (place_memalign() only) The required alignment
+ *   size      - The size of the allocation
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the request could not be satisfied.
+ *
+ ****************************************************************************/
+
+FAR void *place_malloc(uint8_t flags, size_t size);
+FAR void *place_zalloc(uint8_t flags, size_t size);
+FAR void *place_memalign(uint8_t flags, size_t alignment, size_t size);
+
+/****************************************************************************
+ * Name: place_free
+ *
+ * Description:
+ *   Free memory allocated by place_malloc() and friends.  Memory that does
+ *   not belong to any named heap is returned to the kernel heap.
+ *
+ ****************************************************************************/
+
+void place_free(FAR void *mem);
+
+/****************************************************************************
+ * Name: place_heapmember
+ *
+ * Description:
+ *   Return true if the memory lies in one of the named heaps.
+ *
+ ****************************************************************************/
+
+bool place_heapmember(FAR void *mem);
+
+/****************************************************************************
+ * Name: place_foreach
+ *
+ * Description:
+ *   Call the handler once for each named heap with a snapshot of the heap
+ *   state.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each heap
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void place_foreach(place_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_PLACE */
+#endif /* __INCLUDE_NUTTX_MM_PLACE_H */
@@ -0,0 +1,254 @@
+/****************************************************************************
+ * include/nuttx/mm/slab.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_SLAB_H
+#define __INCLUDE_NUTTX_MM_SLAB_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_MM_SLAB_NPERSLAB
+#  define CONFIG_MM_SLAB_NPERSLAB 8
+#endif
+
+#ifndef CONFIG_MM_SLAB_TCB_NPERSLAB
+#  define CONFIG_MM_SLAB_TCB_NPERSLAB 2
+#endif
+
+/* All objects are aligned like memory returned by malloc() */
+
+#define SLAB_ALIGN        (2 * sizeof(uintptr_t))
+#define SLAB_ALIGN_MASK   (SLAB_ALIGN - 1)
+#define SLAB_ALIGN_UP(a)  (((a) + SLAB_ALIGN_MASK) & ~SLAB_ALIGN_MASK)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One slab is a single, contiguous block of memory that holds a header
+ * followed by sc_nperslab objects.  The definition of the slab header is
+ * private to mm/slab.
+ */
+
+struct slab_s;
+
+/* This structure describes one cache of fixed-size objects.  The structure
+ * is normally allocated statically by the subsystem that owns the cache
+ * and must not be modified directly.
+ *
+ * Freed objects are retained on the cache's free list; the memory of a
+ * slab is never returned to the heap.  Allocation and deallocation are
+ * therefore O(1) and never fragment the heap once the cache has grown to
+ * its working set size.
+ */
+
+struct slab_cache_s
+{
+  FAR struct slab_cache_s *sc_flink; /* Supports a list of all caches */
+  FAR const char *sc_name;           /* Name of the cache (for procfs) */
+  FAR struct slab_s *sc_slabs;       /* List of slabs owned by the cache */
+  sq_queue_t sc_freelist;            /* List of free objects */
+  size_t   sc_objsize;               /* Aligned size of one object */
+  uint16_t sc_nperslab;              /* Number of objects in each slab */
+  uint16_t sc_nslabs;                /* Number of slabs allocated */
+  uint32_t sc_nused;                 /* Number of objects in use */
+  uint32_t sc_hiwater;               /* Largest value of sc_nused */
+  uint32_t sc_nalloc;                /* Number of successful allocations */
+  uint32_t sc_nfail;                 /* Number of failed allocations */
+};
+
+/* This structure holds a snapshot of the state of one cache as reported
+ * by slab_foreach().
+ */
+
+struct slabinfo_s
+{
+  FAR const char *name;              /* Name of the cache */
+  size_t   objsize;                  /* Aligned size of one object */
+  uint16_t nperslab;                 /* Number of objects in each slab */
+  uint16_t nslabs;                   /* Number of slabs allocated */
+  uint32_t nused;                    /* Number of objects in use */
+  uint32_t nfree;                    /* Number of objects on the free list */
+  uint32_t hiwater;                  /* Largest number of objects in use */
+  uint32_t nalloc;                   /* Number of successful allocations */
+  uint32_t nfail;                    /* Number of failed allocations */
+};
+
+/* This is the type of the callback used with slab_foreach() */
+
+typedef CODE void (*slab_handler_t)(FAR const struct slabinfo_s *info,
+                                    FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: slab_initialize
+ *
+ * Description:
+ *   Initialize a cache of fixed-size objects and add it to the list of
+ *   caches reported by slab_foreach().  No memory is allocated until the
+ *   first call to slab_alloc().
+ *
+ * Input Parameters:
+ *   cache    - The cache to be initialized
+ *   name     - A name for the cache.  The string must persist.
+ *   objsize  - The size of one object
+ *   nperslab - The number of objects allocated each time the cache grows
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_initialize(FAR struct slab_cache_s *cache, FAR const char *name,
+                     size_t objsize, uint16_t nperslab);
+
+/****************************************************************************
+ * Name: slab_alloc
+ *
+ * Description:
+ *   Allocate one object from the cache.  An object is taken from the free
+ *   list if one is available.  Otherwise, and if not called from an
+ *   interrupt handler, a new slab is allocated from the kernel heap.
+ *
+ * Input Parameters:
+ *   cache - The cache to allocate from
+ *
+ * Returned Value:
+ *   A pointer to the (uninitialized) object or NULL if no object could be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+FAR void *slab_alloc(FAR struct slab_cache_s *cache);
+
+/****************************************************************************
+ * Name: slab_zalloc
+ *
+ * Description:
+ *   Same as slab_alloc() except that the object is zeroed.
+ *
+ ****************************************************************************/
+
+FAR void *slab_zalloc(FAR struct slab_cache_s *cache);
+
+/****************************************************************************
+ * Name: slab_free
+ *
+ * Description:
+ *   Return an object to the cache that it was allocated from.  This
+ *   function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   cache - The cache that the object was allocated from
+ *   obj   - The object to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_free(FAR struct slab_cache_s *cache, FAR void *obj);
+
+/****************************************************************************
+ * Name: slab_member
+ *
+ * Description:
+ *   Return true if the memory at obj lies within one of the slabs of the
+ *   cache.  This is used when objects from a cache and from the heap may
+ *   be released by the same logic.
+ *
+ * Input Parameters:
+ *   cache - The cache to check
+ *   obj   - The object in question
+ *
+ * Returned Value:
+ *   True if obj was allocated from the cache.
+ *
+ ****************************************************************************/
+
+bool slab_member(FAR struct slab_cache_s *cache, FAR const void *obj);
+
+/****************************************************************************
+ * Name: slab_foreach
+ *
+ * Description:
+ *   Call the handler once for each initialized cache with a snapshot of
+ *   the cache state.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each cache
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_foreach(slab_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_SLAB */
+#endif /* __INCLUDE_NUTTX_MM_SLAB_H */
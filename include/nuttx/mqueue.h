@@ -47,6 +47,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <mqueue.h>
 #include <queue.h>
 #include <signal.h>
@@ -92,6 +93,17 @@
 #  define _MQ_GETERRVAL(r)            (-errno)
 #endif
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+/* With CONFIG_MQ_PRIO_BUCKETS, there is one FIFO message list for each
+ * message priority (0 through MQ_PRIO_MAX) and a bit set for each non-
+ * empty list.  A second level bit set records each non-zero word of the
+ * first.
+ */
+
+#  define MQ_PRIO_NLISTS  (_POSIX_MQ_PRIO_MAX + 1)
+#  define MQ_PRIO_NWORDS  ((MQ_PRIO_NLISTS + 31) >> 5)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -103,7 +115,16 @@ struct mq_des; /* forward reference */
 struct mqueue_inode_s
 {
   FAR struct inode *inode;    /* Containing inode */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  sq_queue_t msglist[MQ_PRIO_NLISTS]; /* FIFO message list per priority */
+  uint32_t prioset[MQ_PRIO_NWORDS];   /* Bit set of non-empty lists */
+  uint32_t prioword;                  /* Bit set of non-zero prioset[] */
+#else
   sq_queue_t msglist;         /* Prioritized message list */
+#endif
+#ifdef CONFIG_MQ_QUEUE_POOL
+  sq_queue_t msgfree;         /* Free messages from the per-queue pool */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
@@ -294,6 +315,90 @@ ssize_t nxmq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                         FAR int *prio, FAR const struct timespec *abstime);
 
+#ifdef CONFIG_MQ_LOAN
+/****************************************************************************
+ * Name: nxmq_loan
+ *
+ * Description:
+ *   Obtain a message buffer that can be filled in place and then queued
+ *   with nxmq_send_loan(), avoiding the copy performed by nxmq_send().
+ *   The buffer can hold the maxmsgsize attribute of the message queue.  It
+ *   must be passed to either nxmq_send_loan() or nxmq_return_loan().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor, opened for writing
+ *   buffer - The location to return the loaned buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:  EINVAL, EPERM, or ENOMEM.
+ *
+ ****************************************************************************/
+
+int nxmq_loan(mqd_t mqdes, FAR void **buffer);
+
+/****************************************************************************
+ * Name: nxmq_send_loan
+ *
+ * Description:
+ *   Queue a buffer obtained from nxmq_loan() as a message of msglen bytes.
+ *   This behaves like nxmq_send() except that the message data is not
+ *   copied.  On success, the buffer belongs to the message queue.  On
+ *   failure, the caller still holds the loan.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The buffer returned by nxmq_loan()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see nxmq_send()).
+ *
+ ****************************************************************************/
+
+int nxmq_send_loan(mqd_t mqdes, FAR void *buffer, size_t msglen, int prio);
+
+/****************************************************************************
+ * Name: nxmq_receive_loan
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages like nxmq_receive()
+ *   but, instead of copying the message, return the message buffer
+ *   itself.  The buffer must be released with nxmq_return_loan().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor, opened for reading
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success.  A negated errno value is
+ *   returned on failure (see nxmq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_loan(mqd_t mqdes, FAR void **buffer, FAR int *prio);
+
+/****************************************************************************
+ * Name: nxmq_return_loan
+ *
+ * Description:
+ *   Release a buffer obtained from nxmq_loan() or nxmq_receive_loan().
+ *
+ * Input Parameters:
+ *   mqdes  - The message queue descriptor used to obtain the buffer
+ *   buffer - The buffer to release
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_return_loan(mqd_t mqdes, FAR void *buffer);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
@@ -141,6 +141,21 @@ struct mtd_byte_write_s
   const uint8_t *buffer;  /* Pointer to the data to write */
 };
 
+/* FTL write statistics returned by the BIOC_FTLSTATS IOCTL command (if
+ * CONFIG_FTL_STATISTICS is enabled).  The write amplification of the FTL
+ * is fs_progblocks / fs_hostblocks.
+ */
+
+struct ftl_stats_s
+{
+  uint32_t fs_hostblocks; /* Blocks written to the FTL */
+  uint32_t fs_merged;     /* Of those, blocks merged into a dirty cached
+                           * erase block */
+  uint32_t fs_fills;      /* Erase blocks read into the erase block cache */
+  uint32_t fs_erases;     /* Erase blocks erased */
+  uint32_t fs_progblocks; /* Blocks programmed to FLASH */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
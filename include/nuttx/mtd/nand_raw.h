@@ -77,6 +77,14 @@
 #define COMMAND_STATUS                  0x70
 #define COMMAND_RESET                   0xff
 
+/* Nand flash commands (ONFI optional cache and multi-plane operations) */
+
+#define COMMAND_CACHE_READ              0x31
+#define COMMAND_CACHE_READ_END          0x3f
+#define COMMAND_CACHE_WRITE             0x15
+#define COMMAND_MULTIPLANE_READ_2       0x32
+#define COMMAND_MULTIPLANE_WRITE_2      0x11
+
 /* Nand flash commands (small blocks) */
 
 #define COMMAND_READ_A                  0x00
@@ -232,6 +240,77 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of several consecutive pages of one block of a
+ *   NAND FLASH into the provided buffer, for example using the cache read
+ *   commands.  Hardware ECC checking will be performed if so configured.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read.  The pages do not cross the end of
+ *            the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in succes; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+#endif
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of several consecutive pages of one block of a
+ *   NAND FLASH, for example using the cache program command.  Hardware ECC
+ *   will be generated if so configured.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write.  The pages do not cross the end of
+ *            the block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in succes; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+#endif
+
+/****************************************************************************
+ * Name: NAND_ERASEBLOCKS
+ *
+ * Description:
+ *   Erases one block in each plane of the device with a single multi-plane
+ *   erase operation.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the first physical block to erase.  This is a
+ *            multiple of the number of planes.
+ *
+ * Returned Value:
+ *   OK is returned in succes; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+#  define NAND_ERASEBLOCKS(r,b) ((r)->eraseblocks(r,b))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -250,6 +329,9 @@ struct nand_raw_s
   uintptr_t addraddr;        /* NAND address address base */
   uintptr_t dataaddr;        /* NAND data address */
   uint8_t ecctype;           /* See NANDECC_* definitions */
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  uint8_t nplanes;           /* Planes erased by eraseblocks (0/1: none) */
+#endif
 
   /* NAND operations */
 
@@ -268,6 +350,18 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_MULTIPAGE
+  /* Optional multi-page operations.  These may be NULL. */
+
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+  CODE int (*eraseblocks)(FAR struct nand_raw_s *raw, off_t block);
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers*/
 
@@ -116,12 +116,25 @@
 /* TUN/TAP driver ***********************************************************/
 
 #define TUNSETIFF        _SIOC(0x0028)  /* Set TUN/TAP interface */
+#define TUNSETMULTI      _SIOC(0x002d)  /* Enable multi-packet read/write.
+                                         * See include/nuttx/net/tun.h */
 
 /* Telnet driver ************************************************************/
 
 #define SIOCTELNET       _SIOC(0x0029)  /* Create a Telnet sessions.
                                          * See include/nuttx/net/telnet.h */
 
+/* Zero-copy receive ********************************************************/
+
+#define SIOCZCRECV       _SIOC(0x002a)  /* Borrow read-ahead I/O buffers.
+                                         * See include/nuttx/net/zcrecv.h */
+#define SIOCZCRELEASE    _SIOC(0x002b)  /* Return borrowed I/O buffers */
+
+/* IP packet filter *********************************************************/
+
+#define SIOCSIPFILTER    _SIOC(0x002c)  /* Load the filter rule table.
+                                         * See include/nuttx/net/ipfilter.h */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * include/nuttx/net/ipfilter.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_IPFILTER_H
+#define __INCLUDE_NUTTX_NET_IPFILTER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <netinet/in.h>
+
+#include <nuttx/net/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The points in the IP input path at which the rules are evaluated */
+
+#define IPFILTER_INPUT       0  /* Packets destined for this host */
+#define IPFILTER_FORWARD     1  /* Packets to be forwarded */
+#define IPFILTER_NHOOKS      2
+
+#define IPFILTER_HOOK(h)     (1 << (h))  /* Bit for ipf_hooks */
+
+/* Actions */
+
+#define IPFILTER_ACCEPT      0
+#define IPFILTER_DROP        1
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One filter rule.  A packet matches the rule if:
+ *
+ *   - It is evaluated at one of the hooks in ipf_hooks,
+ *   - It has the address family ipf_family,
+ *   - The first ipf_srclen bits of its source address and the first
+ *     ipf_dstlen bits of its destination address equal those of ipf_src
+ *     and ipf_dst,
+ *   - ipf_proto is zero or equals its IP protocol, and
+ *   - ipf_sport and ipf_dport (network order) are zero or equal its TCP or
+ *     UDP port numbers.  Non-zero port numbers require that ipf_proto is
+ *     IP_PROTO_TCP or IP_PROTO_UDP.
+ *
+ * The action of the first rule of the table that a packet matches is taken;
+ * the policy of the hook applies if no rule matches.
+ */
+
+union ipfilter_addr_u
+{
+  struct in_addr  ipv4;
+  struct in6_addr ipv6;
+};
+
+struct ipfilter_rule_s
+{
+  uint8_t  ipf_family;          /* AF_INET or AF_INET6 */
+  uint8_t  ipf_hooks;           /* Set of IPFILTER_HOOK() bits */
+  uint8_t  ipf_action;          /* IPFILTER_ACCEPT or IPFILTER_DROP */
+  uint8_t  ipf_proto;           /* IP protocol (0: any) */
+  uint8_t  ipf_srclen;          /* Source prefix length in bits */
+  uint8_t  ipf_dstlen;          /* Destination prefix length in bits */
+  uint16_t ipf_sport;           /* Source port (0: any) */
+  uint16_t ipf_dport;           /* Destination port (0: any) */
+  union ipfilter_addr_u ipf_src; /* Source address prefix */
+  union ipfilter_addr_u ipf_dst; /* Destination address prefix */
+};
+
+/* The argument of the SIOCSIPFILTER ioctl command.  The rules are copied
+ * and compiled, then the new table replaces the old one atomically.  A
+ * table with no rules and ACCEPT policies disables filtering.
+ */
+
+struct ipfilter_table_s
+{
+  uint8_t  ipt_policy[IPFILTER_NHOOKS]; /* Action if no rule matches */
+  uint16_t ipt_nrules;                  /* Number of rules */
+  FAR const struct ipfilter_rule_s *ipt_rules;
+};
+
+#endif /* __INCLUDE_NUTTX_NET_IPFILTER_H */
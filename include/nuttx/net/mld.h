@@ -383,6 +383,7 @@ struct mld_mcast_listen_done_s
 struct mld_netdev_s
 {
   sq_queue_t grplist;                /* MLD group list */
+  sq_queue_t grphash[CONFIG_NET_MLD_HASHSIZE]; /* Groups by address */
   WDOG_ID gendog;                    /* General query timer */
   WDOG_ID v1dog;                     /* MLDv1 compatibility timer */
   uint8_t flags;                     /* See MLD_ flags definitions */
@@ -50,6 +50,10 @@
 #include <stdarg.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -130,7 +134,7 @@ enum net_lltype_e
 
 /* This defines a bitmap big enough for one bit for each socket option */
 
-typedef uint16_t sockopt_t;
+typedef uint32_t sockopt_t;
 
 /* This defines the storage size of a timeout value.  This effects only
  * range of supported timeout values.  With an LSB in seciseconds, the
@@ -144,6 +148,17 @@ typedef uint16_t socktimeo_t;
 
 typedef uint8_t sockcaps_t;
 
+/* This is a re-entrant lock.  The global network lock taken by net_lock()
+ * is one instance; each network device also has one (see netdev_lock()).
+ */
+
+struct net_rlock_s
+{
+  sem_t        sem;            /* Mutual exclusion */
+  pid_t        holder;         /* ID of the holding thread (-1 if none) */
+  unsigned int count;          /* Number of times held by that thread */
+};
+
 /* This callbacks are socket operations that may be performed on a socket of
  * a given address family.
  */
@@ -190,6 +205,16 @@ struct sock_intf_s
   CODE int        (*si_ioctl)(FAR struct socket *psock, int cmd,
                     FAR void *arg, size_t arglen);
 #endif
+
+  /* Optional scatter/gather methods.  If these are NULL, sendmsg() and
+   * recvmsg() transfer the data through a contiguous bounce buffer using
+   * si_sendto() and si_recvfrom().
+   */
+
+  CODE ssize_t    (*si_sendmsg)(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
+  CODE ssize_t    (*si_recvmsg)(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
 };
 
 /* This is the internal representation of a socket reference by a file
@@ -293,8 +318,80 @@ void net_initialize(void);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * In addition, each network device has its own re-entrant lock, see
+ * netdev_lock() and netdev_unlock().  The device lock serializes the
+ * device control methods (d_ifup, d_ifdown, d_ioctl) and device state that
+ * is private to the driver without holding the network lock.  Drivers may
+ * take the network lock while holding the device lock, so the device lock
+ * must never be taken while the network lock is held.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rlock_init
+ *
+ * Description:
+ *   Initialize a re-entrant network lock.
+ *
+ * Input Parameters:
+ *   lock - The lock to be initialized
+ *
+ * Returned Value:
+ *   None
+ *
  ****************************************************************************/
 
+void net_rlock_init(FAR struct net_rlock_s *lock);
+
+/****************************************************************************
+ * Name: net_rlock
+ *
+ * Description:
+ *   Take a re-entrant network lock, waiting if it is held by another
+ *   thread.
+ *
+ * Input Parameters:
+ *   lock - The lock to be taken
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_rlock(FAR struct net_rlock_s *lock);
+
+/****************************************************************************
+ * Name: net_runlock
+ *
+ * Description:
+ *   Release a re-entrant network lock.
+ *
+ * Input Parameters:
+ *   lock - The lock to be released
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_runlock(FAR struct net_rlock_s *lock);
+
+/****************************************************************************
+ * Name: net_rlock_held
+ *
+ * Description:
+ *   Return true if the calling thread holds the re-entrant network lock.
+ *
+ * Input Parameters:
+ *   lock - The lock to be checked
+ *
+ * Returned Value:
+ *   True if the lock is held by the calling thread.
+ *
+ ****************************************************************************/
+
+bool net_rlock_held(FAR struct net_rlock_s *lock);
+
 /****************************************************************************
  * Name: net_lock
  *
@@ -388,6 +485,7 @@ int net_lockedwait(sem_t *sem);
  *
  * Input Parameters:
  *   throttled - An indication of the IOB allocation is "throttled"
+ *   user      - The consumer that the IOB is accounted to
  *
  * Returned Value:
  *   A pointer to the newly allocated IOB is returned on success.  NULL is
@@ -396,8 +494,7 @@ int net_lockedwait(sem_t *sem);
  ****************************************************************************/
 
 #ifdef CONFIG_MM_IOB
-struct iob_s;  /* Forward reference */
-FAR struct iob_s *net_ioballoc(bool throttled);
+FAR struct iob_s *net_ioballoc(bool throttled, enum iob_user_e user);
 #endif
 
 /****************************************************************************
@@ -967,6 +1064,64 @@ ssize_t nx_recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
 
 #define nx_recv(psock,buf,len,flags) nx_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends a message described by a struct msghdr.  The data
+ *   is gathered from the msg_iov list and sent as a single message (or, for
+ *   stream sockets, as a single contiguous transfer).  This is an internal
+ *   OS interface.  It is functionally equivalent to sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned (See comments with sendto() for a list
+ *   of the appropriate errno value).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives one message into the msg_iov list of a struct
+ *   msghdr, returning the source address in msg_name and any control
+ *   messages (such as SCM_TIMESTAMP) in msg_control.  This is an internal
+ *   OS interface.  It is functionally equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Describes the buffers to receive the message
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On any
+ *   failure, a negated errno value is returned (see comments with
+ *   recvfrom() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
 /****************************************************************************
  * Name: psock_getsockopt
  *
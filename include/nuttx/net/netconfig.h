@@ -240,6 +240,12 @@
 #  endif
 #endif
 
+/* The number of buckets in the UDP connection hash table, Default: 16 */
+
+#ifndef CONFIG_NET_UDP_HASHSIZE
+#  define CONFIG_NET_UDP_HASHSIZE 16
+#endif
+
 /* The UDP maximum packet size. This is should not be to set to more
  * than NETDEV_PKTSIZE(d) - NET_LL_HDRLEN(dev) - __UDP_HDRLEN - IPv*_HDRLEN.
  */
@@ -372,6 +378,14 @@
 #  define CONFIG_NET_MAX_LISTENPORTS 20
 #endif
 
+/* The number of buckets in each of the TCP connection and listener hash
+ * tables.
+ */
+
+#ifndef CONFIG_NET_TCP_HASHSIZE
+#  define CONFIG_NET_TCP_HASHSIZE 16
+#endif
+
 /* Define the maximum number of concurrently active UDP and TCP
  * ports.  This number must be greater than the number of open
  * sockets in order to support multi-threaded read/write operations.
@@ -62,6 +62,7 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
 
 #ifdef CONFIG_NET_IGMP
 #  include <nuttx/net/igmp.h>
@@ -71,6 +72,17 @@
 #  include <nuttx/net/mld.h>
 #endif
 
+#ifdef CONFIG_NETDEV_RXPOLL
+#  include <stdbool.h>
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  include <sys/types.h>
+#  include <stdbool.h>
+#  include <semaphore.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -95,6 +107,42 @@
 #  define RADIO_MAX_ADDRLEN CONFIG_PKTRADIO_ADDRLEN
 #endif
 
+/* Per-device locking.  The device lock serializes calls to the device
+ * control methods and protects device state that is private to the driver
+ * so that operations on different devices need not contend for the global
+ * network lock.  If both locks are required, netdev_lock() must be taken
+ * first.
+ */
+
+#define netdev_lock(dev)        net_rlock(&(dev)->d_lock)
+#define netdev_unlock(dev)      net_runlock(&(dev)->d_lock)
+
+/* True if the outgoing frame is a large TCP segment that must be split into
+ * segments of d_tsomss bytes of data (see netdev_gso()).
+ */
+
+#ifdef CONFIG_NETDEV_TSO
+#  define NETDEV_IS_TSO(dev) ((dev)->d_iob != NULL && (dev)->d_tsomss > 0)
+#else
+#  define NETDEV_IS_TSO(dev) (0)
+#endif
+
+/* Checksum offload capabilities (d_rxchksum and d_txchksum) */
+
+#define NETDEV_CHKSUM_IPv4      (1 << 0) /* IPv4 header checksum */
+#define NETDEV_CHKSUM_TCP       (1 << 1) /* TCP checksum (IPv4 and IPv6) */
+#define NETDEV_CHKSUM_UDP       (1 << 2) /* UDP checksum (IPv4 and IPv6) */
+
+/* True if the hardware verifies (RX) or inserts (TX) the checksum */
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+#  define NETDEV_RXCHKSUM(dev,c) (((dev)->d_rxchksum & (c)) != 0)
+#  define NETDEV_TXCHKSUM(dev,c) (((dev)->d_txchksum & (c)) != 0)
+#else
+#  define NETDEV_RXCHKSUM(dev,c) (0)
+#  define NETDEV_TXCHKSUM(dev,c) (0)
+#endif
+
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
@@ -223,6 +271,12 @@ struct netdev_varaddr_s
  */
 
 struct devif_callback_s; /* Forward reference */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+struct netdev_queue_s;   /* Forward reference */
+#endif
+#if defined(CONFIG_NETDEV_SGTX) || defined(CONFIG_NETDEV_RFS)
+struct iob_s;            /* Forward reference See iob.h */
+#endif
 
 struct net_driver_s
 {
@@ -340,14 +394,73 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* Scatter-gather transmit.  A driver that can transmit a frame from
+   * several separate memory regions sets d_sgmax to the maximum number of
+   * regions (including the headers in d_buf) that it can accept for one
+   * frame.  The network may then leave the d_sndlen bytes of outgoing
+   * application data in the I/O buffer chain d_iob, starting at offset
+   * d_iobofs, rather than copying them to d_appdata.  Or the data may be
+   * left in place in memory that remains valid until the transmission
+   * completes (such as XIP flash), referenced by d_sndref.  The driver uses
+   * netdev_txsegs() to obtain the regions of the frame.
+   */
+
+  uint8_t d_sgmax;
+  uint16_t d_iobofs;
+  FAR struct iob_s *d_iob;
+  FAR const uint8_t *d_sndref;
+#endif
+
+#ifdef CONFIG_NETDEV_TSO
+  /* TCP segmentation offload.  A driver that can accept TCP frames larger
+   * than the MSS sets d_tsomax to the maximum amount of TCP data that it
+   * can accept in one such frame; d_tsomax plus the size of the headers
+   * must still fit in d_len.  When the network provides a large
+   * frame, the data is always left in d_iob and d_tsomss holds the size
+   * of the segments that the frame must be split into (see NETDEV_IS_TSO()
+   * and netdev_gso()).  A driver that passes the regions of the frame to
+   * hardware must also assure that d_sgmax is at least
+   * d_tsomax / CONFIG_IOB_BUFSIZE + 2.
+   */
+
+  uint16_t d_tsomax;
+  uint16_t d_tsomss;
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* Checksum offload.  A driver whose hardware verifies the checksums of
+   * received packets (and discards those that are bad) sets the
+   * corresponding NETDEV_CHKSUM_* bits in d_rxchksum.  A driver whose
+   * hardware inserts the checksums of outgoing packets sets the bits in
+   * d_txchksum; the network then leaves those checksum fields zero.
+   */
+
+  uint8_t d_rxchksum;
+  uint8_t d_txchksum;
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The queues of a multi-queue device as passed to netdev_queue_start()
+   * (NULL and zero if the device has no queue threads).
+   */
+
+  FAR struct netdev_queue_s *d_queues;
+  uint8_t d_nqueues;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
   sq_queue_t d_igmp_grplist;    /* IGMP group list */
+  sq_queue_t d_igmp_grphash[CONFIG_NET_IGMP_HASHSIZE]; /* Groups by address */
 #endif
 #ifdef CONFIG_NET_MLD
   struct mld_netdev_s d_mld;    /* MLD state information */
 #endif
+#ifdef CONFIG_NET_MCASTGROUP
+  sq_queue_t d_mcastmacs;       /* Multicast MAC addresses in the filter */
+#endif
 
 #ifdef CONFIG_NETDEV_STATISTICS
   /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
@@ -388,6 +501,14 @@ struct net_driver_s
   int (*d_ifdown)(FAR struct net_driver_s *dev);
   int (*d_txavail)(FAR struct net_driver_s *dev);
 #ifdef CONFIG_NET_MCASTGROUP
+  /* The multicast MAC address filter.  Each address is added once, when
+   * the first multicast group that maps to it is joined, and removed when
+   * the last one is left.  After a removal, the remaining addresses are
+   * added again so that a hardware hash filter can restore any bits
+   * shared with the removed address.  d_addmac() must therefore accept
+   * an address that is already in the filter.
+   */
+
   int (*d_addmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
   int (*d_rmmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 #endif
@@ -396,6 +517,10 @@ struct net_driver_s
                  unsigned long arg);
 #endif
 
+  /* Serializes the driver callbacks, see netdev_lock() */
+
+  struct net_rlock_s d_lock;
+
   /* Drivers may attached device-specific, private information */
 
   void *d_private;
@@ -403,6 +528,117 @@ struct net_driver_s
 
 typedef int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_SGTX
+/* One memory region of an outgoing frame as returned by netdev_txsegs().
+ * If ts_iob is not NULL, the region lies in that I/O buffer and the driver
+ * holds a reference to it until netdev_txsegs_release() is called.
+ */
+
+struct netdev_txseg_s
+{
+  FAR const uint8_t *ts_data;   /* Start of the region */
+  uint16_t ts_len;              /* Length of the region in bytes */
+  FAR struct iob_s *ts_iob;     /* I/O buffer holding the region (or NULL) */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_RXPOLL
+/* RX polling state for one network device (see netdev_rxpoll_initialize()).
+ * This structure is allocated by the driver, typically as a part of its
+ * private state structure.
+ */
+
+struct netdev_rxpoll_s
+{
+  FAR struct net_driver_s *rp_dev;  /* The network device */
+
+  /* Receive up to 'budget' frames and return the number received.  Called
+   * on the worker thread with the network locked.
+   */
+
+  CODE int (*rp_poll)(FAR struct net_driver_s *dev, int budget);
+
+  /* Unmask RX interrupts.  Called on the worker thread when the last pass
+   * used less than the whole budget.
+   */
+
+  CODE void (*rp_enable)(FAR struct net_driver_s *dev);
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Send the reply in d_buf to an aggregated segment (if d_len > 0).  d_buf
+   * is then the aggregation buffer which will be reused as soon as this
+   * returns:  A driver that transmits directly from d_buf must first copy
+   * the frame.
+   */
+
+  CODE void (*rp_reply)(FAR struct net_driver_s *dev);
+
+  FAR uint8_t *rp_grobuf;           /* Aggregation buffer (from the driver) */
+  uint16_t rp_grosize;              /* Size of rp_grobuf in bytes */
+  uint16_t rp_grolen;               /* Length of the held frame (0: none) */
+  uint32_t rp_groseq;               /* Next sequence number of the held flow */
+#endif
+
+  struct work_s rp_work;            /* Work queue support */
+  int rp_qid;                       /* Work queue to use (HPWORK or LPWORK) */
+  volatile bool rp_scheduled;       /* True: Work is queued or running */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* One RX/TX queue of a multi-queue network device (see
+ * netdev_queue_start()).  Each queue is serviced by its own kernel thread
+ * which, in an SMP configuration, is bound to one CPU.  These structures
+ * are allocated by the driver, typically as an array in its private state
+ * structure.
+ */
+
+struct netdev_queue_s
+{
+  FAR struct net_driver_s *nq_dev;  /* The network device */
+  FAR void *nq_private;             /* Driver state for this queue */
+
+  /* Service up to 'budget' frames of this queue and return the number
+   * received.  This is called on the queue thread WITHOUT the network
+   * locked so that the descriptor handling of different queues can run in
+   * parallel:  The driver must hold net_lock() while it passes a frame to
+   * the network and while it uses d_buf.  May be NULL for a queue that
+   * only receives steered frames (see netdev_rfs_steer()).
+   */
+
+  CODE int (*nq_poll)(FAR struct netdev_queue_s *nq, int budget);
+
+  /* Unmask the interrupts of this queue (may be NULL).  Called on the
+   * queue thread when the last pass used less than the whole budget.
+   */
+
+  CODE void (*nq_enable)(FAR struct netdev_queue_s *nq);
+
+#ifdef CONFIG_NETDEV_RFS
+  /* Process one steered frame in d_buf just as the driver's own receive
+   * logic would, including the transmission of any reply.  Called on the
+   * queue thread with the network locked.  d_buf is then nq_buf which
+   * will be reused as soon as this returns.
+   */
+
+  CODE void (*nq_input)(FAR struct netdev_queue_s *nq);
+
+  FAR uint8_t *nq_buf;              /* Frame buffer for steered frames */
+  uint16_t nq_bufsize;              /* Size of nq_buf in bytes */
+  uint16_t nq_head;                 /* Backlog: Index of the next free entry */
+  uint16_t nq_tail;                 /* Backlog: Index of the oldest entry */
+  FAR struct iob_s *nq_backlog[CONFIG_NETDEV_RFS_BACKLOG];
+#endif
+
+  sem_t nq_sem;                     /* Wakes up the queue thread */
+  sem_t nq_exitsem;                 /* Posted when the queue thread exits */
+  pid_t nq_pid;                     /* The queue thread */
+  uint8_t nq_index;                 /* Index of this queue in d_queues */
+  volatile bool nq_scheduled;       /* True: The queue thread is running */
+  volatile bool nq_stop;            /* True: The queue thread must exit */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -605,6 +841,314 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_txsegs
+ *
+ * Description:
+ *   Describe the outgoing frame of length d_len as a list of memory regions
+ *   for a driver that supports scatter-gather transmit (d_sgmax > 0).  The
+ *   first region is always the start of d_buf.  If the application data of
+ *   the frame was left in an I/O buffer chain, then one further region is
+ *   returned for each I/O buffer holding part of it.  The driver must not
+ *   assume that the data is in d_buf and must later release the regions
+ *   with netdev_txsegs_release(), normally when the transmission completes.
+ *
+ * Input Parameters:
+ *   dev  - The network device with an outgoing frame in d_buf (d_len > 0)
+ *   segs - An array of at least d_sgmax entries to receive the regions
+ *
+ * Returned Value:
+ *   The number of regions returned in segs[].
+ *
+ * Assumptions:
+ *   Called with the network locked, immediately after the network has
+ *   provided the frame.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SGTX
+int netdev_txsegs(FAR struct net_driver_s *dev,
+                  FAR struct netdev_txseg_s *segs);
+
+/****************************************************************************
+ * Name: netdev_txsegs_release
+ *
+ * Description:
+ *   Release the I/O buffer references held by regions returned by
+ *   netdev_txsegs().  This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   segs  - The regions returned by netdev_txsegs()
+ *   nsegs - The number of regions
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_txsegs_release(FAR struct netdev_txseg_s *segs, int nsegs);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gso
+ *
+ * Description:
+ *   Software segmentation for a driver that accepts large TCP frames
+ *   (d_tsomax > 0) but whose hardware cannot split them.  If
+ *   NETDEV_IS_TSO(dev) is true, the large frame is split into segments of
+ *   at most d_tsomss bytes of data.  For each segment, a complete frame
+ *   with corrected IP and TCP headers is placed in d_buf (d_len) and
+ *   passed to the driver's xmit() function.
+ *
+ * Input Parameters:
+ *   dev  - The network device with an outgoing large frame
+ *   xmit - Transmit the single frame in d_buf.  If xmit() returns a
+ *          non-zero value, the remaining segments are discarded; they will
+ *          be recovered by TCP retransmission.
+ *
+ * Returned Value:
+ *   The number of segments passed to xmit().
+ *
+ * Assumptions:
+ *   Called with the network locked, immediately after the network has
+ *   provided the frame and after the link layer header has been added.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+int netdev_gso(FAR struct net_driver_s *dev,
+               CODE int (*xmit)(FAR struct net_driver_s *dev));
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxpoll_initialize
+ *
+ * Description:
+ *   Initialize the RX polling state of a network device.  rp_poll and
+ *   rp_enable (and, with CONFIG_NETDEV_GRO, rp_reply, rp_grobuf, and
+ *   rp_grosize) must be set by the driver, before or after this call.
+ *
+ * Input Parameters:
+ *   rp  - The RX polling state to initialize
+ *   dev - The network device
+ *   qid - The work queue to poll on (HPWORK or LPWORK)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXPOLL
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rp,
+                              FAR struct net_driver_s *dev, int qid);
+
+/****************************************************************************
+ * Name: netdev_rxpoll_schedule
+ *
+ * Description:
+ *   Schedule RX polling.  This is normally called from the RX interrupt
+ *   handler after RX interrupts have been masked.  They remain masked until
+ *   rp_enable() is called.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rp);
+
+/****************************************************************************
+ * Name: netdev_rxpoll_cancel
+ *
+ * Description:
+ *   Cancel any pending RX polling, for example when the interface is
+ *   brought down.  RX interrupts are left masked.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rp);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Offer a received IPv4 frame in d_buf for TCP receive aggregation.  This
+ *   is called from rp_poll() in place of ipv4_input() (after any link layer
+ *   processing such as arp_ipin()).  If the frame is an in-order data
+ *   segment that continues the held segment, its data is appended.
+ *   Otherwise the held segment is passed to the network first (see
+ *   rp_reply()).  The held segment is also passed to the network at the
+ *   end of each poll pass.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   One if the frame was absorbed (d_len is then zero); zero if the driver
+ *   must pass the frame to ipv4_input() itself.
+ *
+ * Assumptions:
+ *   Called with the network locked from rp_poll().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+int netdev_gro_input(FAR struct netdev_rxpoll_s *rp);
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass any held aggregated segment to the network.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct netdev_rxpoll_s *rp);
+#endif
+
+/****************************************************************************
+ * Name: netdev_queue_start
+ *
+ * Description:
+ *   Start one kernel thread for each queue of a multi-queue network device.
+ *   In an SMP configuration, the thread of queue n is bound to CPU
+ *   n % CONFIG_SMP_NCPUS.  nq_poll, nq_enable, nq_private (and, with
+ *   CONFIG_NETDEV_RFS, nq_input, nq_buf, and nq_bufsize) must be set by
+ *   the driver before this call.  This is normally called once when the
+ *   driver is initialized.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   queues  - An array of nqueues queue structures
+ *   nqueues - The number of queues
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  No thread is
+ *   left running on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+int netdev_queue_start(FAR struct net_driver_s *dev,
+                       FAR struct netdev_queue_s *queues, int nqueues);
+
+/****************************************************************************
+ * Name: netdev_queue_stop
+ *
+ * Description:
+ *   Stop the queue threads started by netdev_queue_start() and wait for
+ *   them to exit.  The network lock, if held, is released while waiting.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_queue_stop(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: netdev_queue_schedule
+ *
+ * Description:
+ *   Wake up the thread of a queue.  This is normally called from the
+ *   interrupt handler of the queue after its interrupts have been masked.
+ *   They remain masked until nq_enable() is called.
+ *
+ * Input Parameters:
+ *   nq - The queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_queue_schedule(FAR struct netdev_queue_s *nq);
+
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Calculate a hash over the IP addresses and, for TCP and UDP, the port
+ *   numbers of the IPv4 or IPv6 packet in d_buf.  Both directions of a
+ *   flow give the same hash.  Drivers without hardware receive-side
+ *   scaling may use this to select the queue of a received frame and any
+ *   driver may use it to select the TX queue of an outgoing frame so that
+ *   the frames of one flow are not reordered.
+ *
+ * Input Parameters:
+ *   dev - The network device holding the packet in d_buf
+ *
+ * Returned Value:
+ *   The hash value.  All frames that are not IP packets give zero.
+ *
+ ****************************************************************************/
+
+uint32_t netdev_flowhash(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: netdev_queue_select
+ *
+ * Description:
+ *   Select the queue for the frame in d_buf using netdev_flowhash().
+ *
+ * Input Parameters:
+ *   dev - The network device holding the packet in d_buf
+ *
+ * Returned Value:
+ *   The selected queue or NULL if the device has no queues.
+ *
+ ****************************************************************************/
+
+FAR struct netdev_queue_s *netdev_queue_select(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_rfs_steer
+ *
+ * Description:
+ *   Software receive flow steering for devices with a single hardware
+ *   queue.  The frame in d_buf is copied into an I/O buffer chain and
+ *   queued to the thread of the queue selected by netdev_queue_select().
+ *   That thread passes it to nq_input().  This is called from the driver's
+ *   receive logic in place of its protocol dispatch; it does not require
+ *   the network to be locked.
+ *
+ * Input Parameters:
+ *   dev - The network device holding the received frame in d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) if the frame was queued; d_len is then zero.  A negated
+ *   errno value if it could not be queued:  The frame is still in d_buf
+ *   and the driver may process it itself or drop it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RFS
+int netdev_rfs_steer(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -69,6 +69,9 @@
 #ifdef CONFIG_NET_MLD
 #  include <nuttx/net/mld.h>
 #endif
+#ifdef CONFIG_NET_6LOWPAN
+#  include <nuttx/net/sixlowpan.h>
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
 
@@ -117,6 +120,10 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_6LOWPAN
+  struct sixlowpan_stats_s sixlowpan; /* 6LoWPAN statistics */
+#endif
 };
 
 /****************************************************************************
@@ -132,4 +139,97 @@ extern struct net_stats_s g_netstats;
  ****************************************************************************/
 
 #endif /* CONFIG_NET_STATISTICS */
+
+/****************************************************************************
+ * Network Performance Counters
+ ****************************************************************************/
+
+/* These macros time one pass through a layer of the network stack and
+ * account it to one of the performance counters.  They expand to nothing
+ * if CONFIG_NET_PERF is not selected.
+ */
+
+#ifdef CONFIG_NET_PERF
+#  define NETPERF_DECLARE(t)     uint64_t t
+#  define NETPERF_START(t)       ((t) = netperf_gettime())
+#  define NETPERF_UPDATE(id, t)  netperf_update(id, t)
+#else
+#  define NETPERF_DECLARE(t)
+#  define NETPERF_START(t)
+#  define NETPERF_UPDATE(id, t)
+#endif
+
+#ifdef CONFIG_NET_PERF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The timed sections.  Inner layers are timed as part of the outer layer
+ * too:  The TCP and UDP input times are included in the IP input times and
+ * the driver transmit time is included in the device poll time.
+ */
+
+enum netperf_e
+{
+  NETPERF_IPv4_INPUT = 0,       /* ipv4_input() */
+  NETPERF_IPv6_INPUT,           /* ipv6_input() */
+  NETPERF_TCP_INPUT,            /* tcp_ipv4/6_input() */
+  NETPERF_UDP_INPUT,            /* udp_ipv4/6_input() */
+  NETPERF_DEVIF_POLL,           /* devif_poll() */
+  NETPERF_DRIVER_TX,            /* Driver poll callback with data to send */
+  NETPERF_IOB_WAIT,             /* Waiting for an IOB in net_ioballoc() */
+  NETPERF_LOCK_WAIT,            /* Waiting for the network lock */
+  NETPERF_LOCK_HOLD,            /* Holding the network lock */
+  NETPERF_NCOUNTERS
+};
+
+/* One performance counter.  Times are in nanoseconds. */
+
+struct netperf_s
+{
+  uint32_t np_count;            /* Number of timed passes */
+  uint32_t np_max;              /* Longest pass */
+  uint64_t np_total;            /* Sum of all passes */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct netperf_s g_netperf[NETPERF_NCOUNTERS];
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netperf_gettime
+ *
+ * Description:
+ *   Return the start time of a timed section in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t netperf_gettime(void);
+
+/****************************************************************************
+ * Name: netperf_update
+ *
+ * Description:
+ *   Account the time since start to a performance counter.
+ *
+ * Input Parameters:
+ *   id    - The performance counter
+ *   start - The value returned by netperf_gettime() at the start of the
+ *           timed section
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netperf_update(enum netperf_e id, uint64_t start);
+
+#endif /* CONFIG_NET_PERF */
 #endif /* __INCLUDE_NUTTX_NET_NETSTATS_H */
@@ -442,6 +442,23 @@ struct sixlowpan_reassbuf_s
   clock_t rb_time;
 };
 
+#ifdef CONFIG_NET_STATISTICS
+/* 6LoWPAN statistics */
+
+struct sixlowpan_stats_s
+{
+  net_stats_t reassalloc;   /* Number of reassemblies started */
+  net_stats_t reassdone;    /* Number of packets completely reassembled */
+  net_stats_t reasstimeout; /* Number of reassemblies that timed out */
+  net_stats_t reassevict;   /* Number of reassemblies cancelled because
+                             * all reassembly buffers were in use */
+  net_stats_t reassdrop;    /* Number of first fragments dropped because
+                             * no reassembly buffer was available */
+  net_stats_t fragerr;      /* Number of fragments dropped because they
+                             * were not part of a reassembly */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
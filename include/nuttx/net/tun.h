@@ -44,6 +44,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/net/ioctl.h>
 
 #ifdef CONFIG_NET_TUN
@@ -63,6 +66,20 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TUN_MULTIPKT
+/* After TUNSETMULTI (with a non-zero int argument), each packet in a
+ * read() or write() buffer is preceded by this header.  Packets follow
+ * one another with no padding, so the header may be unaligned.  A write()
+ * consumes whole packets only and returns the number of bytes consumed.
+ * It stops early if a packet produces a reply that must be read first.
+ */
+
+struct tun_pkthdr_s
+{
+  uint16_t len;         /* Length of the packet that follows (host order) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
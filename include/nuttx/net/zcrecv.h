@@ -0,0 +1,93 @@
+/****************************************************************************
+ * include/nuttx/net/zcrecv.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_ZCRECV_H
+#define __INCLUDE_NUTTX_NET_ZCRECV_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <nuttx/net/ioctl.h>
+
+#ifdef CONFIG_NET_ZEROCOPY_RECV
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Socket ioctl commands:
+ *
+ * Command:      SIOCZCRECV
+ * Description:  Borrow the I/O buffers holding the next read-ahead data of
+ *               a TCP or UDP socket.  Each buffer segment is described by
+ *               one entry of zc_iov[].  For a TCP socket, up to zc_iovcnt
+ *               segments of the stream are lent.  For a UDP socket, one
+ *               datagram is lent; if it does not fit into zc_iovcnt
+ *               segments, the remainder is discarded and MSG_TRUNC is set
+ *               in zc_flags.  The command does not wait:  -EAGAIN is
+ *               returned if no read-ahead data is available.  A zero
+ *               zc_len with a NULL zc_handle indicates end-of-file on a
+ *               TCP socket that was closed by the peer.
+ * Argument:     A pointer to a write-able instance of struct zcrecv_s.
+ * Dependencies: CONFIG_NET_ZEROCOPY_RECV
+ *
+ * Command:      SIOCZCRELEASE
+ * Description:  Return the I/O buffers borrowed with SIOCZCRECV.  The
+ *               memory described by zc_iov[] must not be accessed after
+ *               this call.
+ * Argument:     The zc_handle value returned by SIOCZCRECV.
+ * Dependencies: CONFIG_NET_ZEROCOPY_RECV
+ */
+
+struct zcrecv_s
+{
+  FAR struct iovec *zc_iov;     /* In:  Receives the buffer segments */
+  int zc_iovcnt;                /* In:  Size of zc_iov[]; Out: Entries used */
+  int zc_flags;                 /* Out: MSG_TRUNC if the datagram was cut */
+  size_t zc_len;                /* Out: Total number of bytes lent */
+  FAR struct sockaddr *zc_from; /* In:  UDP source address (may be NULL) */
+  socklen_t zc_fromlen;         /* In/Out: Size of the zc_from address */
+  FAR void *zc_handle;          /* Out: Pass to SIOCZCRELEASE when done */
+};
+
+#endif /* CONFIG_NET_ZEROCOPY_RECV */
+#endif /* __INCLUDE_NUTTX_NET_ZCRECV_H */
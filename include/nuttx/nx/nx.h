@@ -858,6 +858,27 @@ void nx_notify_rectangle(FAR NX_PLANEINFOTYPE *pinfo,
                          FAR const struct nxgl_rect_s *rect);
 #endif
 
+/****************************************************************************
+ * Name: nx_notify_move
+ *
+ * Description:
+ *   When CONFIG_NX_UPDATE_MOVE=y, then the graphics system will call this
+ *   function instead of nx_notify_rectangle() when a rectangular region
+ *   has been moved on the display.  'rect' is the source region and 'pos'
+ *   is the new position of its upper left corner.  This permits a remote
+ *   display to copy the region rather than to transfer the moved pixels.
+ *
+ *   When this feature is enabled, some external logic must provide this
+ *   interface.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_MOVE
+void nx_notify_move(FAR NX_PLANEINFOTYPE *pinfo,
+                    FAR const struct nxgl_rect_s *rect,
+                    FAR const struct nxgl_point_s *pos);
+#endif
+
 /****************************************************************************
  * Name: nx_kbdin
  *
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <stdint.h>
 #  include <stdbool.h>
 #  include <nuttx/sched.h>
 #endif
@@ -221,8 +222,21 @@
  *   the (asynchronous) page fill logic.  If the fill takes longer than this
  *   number if microseconds, then a fatal error will be declared.
  *   Default: No timeouts monitored.
+ * CONFIG_PAGING_READAHEAD - The maximum number of pages to fill ahead of a
+ *   sequential page fault (one on the page just after the previous fill).
+ *   Requires CONFIG_PAGING_BLOCKINGFILL.  Default: 0 (no read-ahead).
  */
 
+#if defined(CONFIG_PAGING_READAHEAD) && \
+    (CONFIG_PAGING_READAHEAD <= 0 || !defined(CONFIG_PAGING_BLOCKINGFILL))
+#  undef CONFIG_PAGING_READAHEAD
+#endif
+
+#if defined(CONFIG_PAGING_READAHEAD) && \
+    CONFIG_PAGING_READAHEAD >= CONFIG_PAGING_NPPAGED
+#  error "CONFIG_PAGING_READAHEAD must be less than CONFIG_PAGING_NPPAGED"
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -325,6 +339,11 @@ void pg_miss(void);
  *  may occur on several threads and be queued multiple times. This function
  *  will prevent the same page from be filled multiple times.
  *
+ *  The page replacement logic may also make a page inaccessible without
+ *  freeing it in order to learn whether it is still in use.  A fault on
+ *  such a page needs no fill:  This function should just make the page
+ *  accessible again and return true.
+ *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that we believe
  *         needs to have a page fill.  Architecture-specific logic can
@@ -363,7 +382,8 @@ bool up_checkmapping(FAR struct tcb_s *tcb);
  *
  *  NOTE 1: This function must always return a page allocation. If all
  *  available pages are in-use (the typical case), then this function will
- *  select a page in-use, un-map it, and make it available.
+ *  select a page in-use, un-map it, and make it available.  The choice of
+ *  page should favor pages that have not been used recently.
  *
  *  NOTE 2: If an in-use page is un-mapped, it may be necessary to flush the
  *  instruction cache in some architectures.
@@ -399,6 +419,32 @@ bool up_checkmapping(FAR struct tcb_s *tcb);
 
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
 
+/****************************************************************************
+ * Name: up_allocvpage()
+ *
+ * Description:
+ *  Like up_allocpage(), but set aside a page for the provided virtual
+ *  address instead of the address of a page fault.  This is used to read
+ *  ahead of sequential page faults.
+ *
+ * Input Parameters:
+ *   vaddr - A page-aligned virtual address within the paged text region.
+ *   vpage - The location to return the virtual address of the page.
+ *
+ * Returned Value:
+ *   This function will return zero (OK) if the allocation was successful.
+ *   -EEXIST is returned if the page is already in memory; no page is
+ *   allocated in that case.
+ *
+ * Assumptions:
+ *   Same as up_allocpage().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_READAHEAD
+int up_allocvpage(uintptr_t vaddr, FAR void **vpage);
+#endif
+
 /****************************************************************************
  * Name: up_fillpage()
  *
@@ -420,10 +466,9 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
  *
  *  NOTE 2: The initial mapping of vpage will be read-able, write-able,
  *  but non-cacheable.  No special actions will be required of
- *  up_fillpage() in order to write into this allocated page.  If the
- *  virtual address maps to a text region, however, this function should
- *  remap the region so that is is read/execute only.  It should be made
- *  cache-able in any case.
+ *  up_fillpage() in order to write into this allocated page.  The common
+ *  paging logic calls up_fillcomplete() when the fill is complete so that
+ *  the page can be remapped as read/execute only and cache-able.
  *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that needs to
@@ -459,6 +504,56 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage,
                 up_pgcallback_t pg_callback);
 #endif
 
+/****************************************************************************
+ * Name: up_fillpages()
+ *
+ * Description:
+ *  Fill several consecutive pages with one (blocking) transfer from the
+ *  non-volatile storage device.  Each page was allocated and mapped by
+ *  up_allocpage() or up_allocvpage().  This is used in place of
+ *  up_fillpage() when read-ahead is enabled.
+ *
+ * Input Parameters:
+ *   vpage  - The virtual address of the first page.
+ *   npages - The number of pages to fill.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  All errors,
+ *   however, are fatal.
+ *
+ * Assumptions:
+ *   Same as up_fillpage().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_READAHEAD
+int up_fillpages(FAR void *vpage, unsigned int npages);
+#endif
+
+/****************************************************************************
+ * Name: up_fillcomplete()
+ *
+ * Description:
+ *  Called by the common paging logic after a successful fill of one or
+ *  more consecutive pages.  The architecture-specific logic must change
+ *  the mapping of the pages from the initial read-able, write-able, non-
+ *  cacheable mapping to the final read/execute only, cache-able text
+ *  mapping.
+ *
+ * Input Parameters:
+ *   vpage  - The virtual address of the first page that was filled.
+ *   npages - The number of pages that were filled.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Same as up_allocpage().
+ *
+ ****************************************************************************/
+
+void up_fillcomplete(FAR void *vpage, unsigned int npages);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * include/nuttx/rwlock.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RWLOCK_H
+#define __INCLUDE_NUTTX_RWLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Reader counts are kept per CPU so that readers on different CPUs do not
+ * write to the same location.  A reader may migrate so an individual count
+ * may become negative; only the sum is meaningful.
+ */
+
+#ifdef CONFIG_SMP
+#  define RW_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define RW_NCPUS 1
+#endif
+
+/* Static initializers */
+
+#define SEQLOCK_INITIALIZER {0}
+#define RCU_INITIALIZER     {{{0}}, 0, SEM_INITIALIZER(1)}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A sleeping reader-writer lock with writer preference.  Uncontended
+ * readers only touch the reader count of their own CPU; once a writer is
+ * waiting, new readers block until all writers are done.  Read locks are
+ * not recursive.
+ */
+
+struct rwlock_s
+{
+  volatile int16_t readers[RW_NCPUS]; /* Per-CPU reader counts */
+  volatile int16_t nwriters;          /* Writers holding or waiting */
+  int16_t nrdwait;                    /* Readers blocked by writers */
+  sem_t wrexcl;                       /* Serializes writers */
+  sem_t rdwait;                       /* Readers wait here for writers */
+  sem_t wrwait;                       /* A writer waits here for readers */
+};
+
+/* A sequence lock.  Readers never block or write:  They retry if a write
+ * happened while they were reading.  Writers exclude each other (and
+ * interrupt handlers) with a critical section.
+ */
+
+struct seqlock_s
+{
+  volatile uint32_t sequence;         /* Odd while a write is in progress */
+};
+
+/* An RCU-like read-side section with deferred reclamation.  Readers
+ * (which may nest and may sleep) only increment the count of the current
+ * phase on their own CPU.  An updater unlinks an object and then waits for
+ * a grace period, after which no reader can still hold a reference to it,
+ * before freeing it.
+ */
+
+struct rcu_head_s;
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head_s *head);
+
+struct rcu_head_s
+{
+  FAR struct rcu_head_s *flink;       /* Supports a singly linked list */
+  rcu_callback_t func;                /* Called after a grace period */
+};
+
+struct rcu_s
+{
+  volatile int16_t readers[2][RW_NCPUS]; /* Per-phase, per-CPU counts */
+  volatile uint8_t phase;             /* Phase of new readers (0 or 1) */
+  sem_t exclsem;                      /* Serializes grace periods */
+#ifdef CONFIG_SCHED_LPWORK
+  sq_queue_t pending;                 /* Deferred callbacks */
+  struct work_s work;                 /* Runs the deferred callbacks */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxrwlock_init and nxrwlock_destroy
+ *
+ * Description:
+ *   Initialize or destroy a reader-writer lock.
+ *
+ ****************************************************************************/
+
+void nxrwlock_init(FAR struct rwlock_s *rwl);
+void nxrwlock_destroy(FAR struct rwlock_s *rwl);
+
+/****************************************************************************
+ * Name: nxrwlock_rdlock, nxrwlock_tryrdlock, and nxrwlock_rdunlock
+ *
+ * Description:
+ *   Take or release a shared (read) lock.  nxrwlock_tryrdlock() returns
+ *   false instead of blocking if a writer holds or is waiting for the
+ *   lock.  These must not be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void nxrwlock_rdlock(FAR struct rwlock_s *rwl);
+bool nxrwlock_tryrdlock(FAR struct rwlock_s *rwl);
+void nxrwlock_rdunlock(FAR struct rwlock_s *rwl);
+
+/****************************************************************************
+ * Name: nxrwlock_wrlock and nxrwlock_wrunlock
+ *
+ * Description:
+ *   Take or release the exclusive (write) lock.
+ *
+ ****************************************************************************/
+
+void nxrwlock_wrlock(FAR struct rwlock_s *rwl);
+void nxrwlock_wrunlock(FAR struct rwlock_s *rwl);
+
+/****************************************************************************
+ * Name: nxseq_init, nxseq_read_begin, and nxseq_read_retry
+ *
+ * Description:
+ *   A reader calls nxseq_read_begin(), copies the protected data, and
+ *   then calls nxseq_read_retry() with the returned sequence number.  If
+ *   that returns true, the copy may be inconsistent and must be repeated.
+ *
+ ****************************************************************************/
+
+void nxseq_init(FAR struct seqlock_s *sl);
+uint32_t nxseq_read_begin(FAR struct seqlock_s *sl);
+bool nxseq_read_retry(FAR struct seqlock_s *sl, uint32_t seq);
+
+/****************************************************************************
+ * Name: nxseq_write_lock and nxseq_write_unlock
+ *
+ * Description:
+ *   Bracket a modification of the data protected by the sequence lock.
+ *   These may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+irqstate_t nxseq_write_lock(FAR struct seqlock_s *sl);
+void nxseq_write_unlock(FAR struct seqlock_s *sl, irqstate_t flags);
+
+/****************************************************************************
+ * Name: nxrcu_init
+ *
+ * Description:
+ *   Initialize an RCU domain.
+ *
+ ****************************************************************************/
+
+void nxrcu_init(FAR struct rcu_s *rcu);
+
+/****************************************************************************
+ * Name: nxrcu_read_lock and nxrcu_read_unlock
+ *
+ * Description:
+ *   Begin and end an RCU read-side section.  The value returned by
+ *   nxrcu_read_lock() must be passed to the matching nxrcu_read_unlock().
+ *   Sections may nest and may be entered from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int nxrcu_read_lock(FAR struct rcu_s *rcu);
+void nxrcu_read_unlock(FAR struct rcu_s *rcu, int phase);
+
+/****************************************************************************
+ * Name: nxrcu_synchronize
+ *
+ * Description:
+ *   Wait until every read-side section that began before this call has
+ *   ended.  Objects unlinked before the call may then be freed.  This
+ *   must not be called from an interrupt handler or within a read-side
+ *   section of the same domain.
+ *
+ ****************************************************************************/
+
+void nxrcu_synchronize(FAR struct rcu_s *rcu);
+
+/****************************************************************************
+ * Name: nxrcu_defer
+ *
+ * Description:
+ *   Call func(head) after a grace period, normally from the low-priority
+ *   work queue.  Without CONFIG_SCHED_LPWORK, this waits for the grace
+ *   period and then calls func() directly.
+ *
+ ****************************************************************************/
+
+void nxrcu_defer(FAR struct rcu_s *rcu, FAR struct rcu_head_s *head,
+                 rcu_callback_t func);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RWLOCK_H */
@@ -123,6 +123,19 @@
 #  define CONFIG_SCHED_SPORADIC_MAXREPL 3
 #endif
 
+/* Number of pthread stacks held for re-use */
+
+#if !defined(CONFIG_PTHREAD_STACK_CACHE) || defined(CONFIG_BUILD_KERNEL)
+#  undef CONFIG_PTHREAD_STACK_CACHE
+#  define CONFIG_PTHREAD_STACK_CACHE 0
+#endif
+
+/* Pending signal structures pre-allocated for each task group */
+
+#ifndef CONFIG_SIG_PREALLOC_GROUP
+#  define CONFIG_SIG_PREALLOC_GROUP 0
+#endif
+
 /* Task Management Definitions **************************************************/
 /* Special task IDS.  Any negative PID is invalid. */
 
@@ -215,6 +228,20 @@
 #  define _SCHED_ERRVAL(r)           (-errno)
 #endif
 
+/* Duration histograms.  Bucket 0 holds durations of less than
+ * 2**SCHED_HIST_SHIFT nanoseconds; each following bucket doubles the upper
+ * limit.  The last bucket holds all longer durations.
+ */
+
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM) || \
+    defined(CONFIG_SCHED_IRQMONITOR_HISTOGRAM)
+#  define SCHED_HIST_SHIFT           8
+#  define SCHED_HIST_NBUCKETS        16
+#  define SCHED_HIST_BUCKET(ns) \
+     (fls((int)((ns) >> SCHED_HIST_SHIFT)) < SCHED_HIST_NBUCKETS ? \
+      fls((int)((ns) >> SCHED_HIST_SHIFT)) : SCHED_HIST_NBUCKETS - 1)
+#endif
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -336,6 +363,11 @@ struct sporadic_s
   uint32_t  repl_period;            /* Sporadic replenishment period            */
   uint32_t  budget;                 /* Sporadic execution budget period         */
   clock_t   eventtime;              /* Time thread suspended or [re-]started    */
+#ifdef CONFIG_SCHED_DEADLINE
+  uint32_t  deadline;               /* Relative deadline, zero if not EDF       */
+  uint32_t  bandwidth;              /* Reserved utilization (Q16)               */
+  clock_t   abs_deadline;           /* Deadline of the current period           */
+#endif
 
   /* This is the last interval timer activated */
 
@@ -449,6 +481,10 @@ struct join_s;                      /* Forward reference
 struct binary_s;                    /* Forward reference                        */
                                     /* Defined in include/nuttx/binfmt/binfmt.h */
 #endif
+#ifndef CONFIG_DISABLE_ENVIRON
+struct env_s;                       /* Forward reference                        */
+                                    /* Defined in sched/environ/environ.h       */
+#endif
 
 struct task_group_s
 {
@@ -543,6 +579,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  sq_queue_t tg_sigpendfree;        /* Free pending signals reserved for group  */
+  FAR void *tg_sigpendalloc;        /* Allocated block of group pending signals */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -551,8 +591,7 @@ struct task_group_s
 #ifndef CONFIG_DISABLE_ENVIRON
   /* Environment variables ******************************************************/
 
-  size_t     tg_envsize;            /* Size of environment string allocation    */
-  FAR char  *tg_envp;               /* Allocated environment strings            */
+  FAR struct env_s *tg_env;         /* Environment (shared copy-on-write)       */
 #endif
 
   /* PIC data space and address environments ************************************/
@@ -719,6 +758,28 @@ struct tcb_s
   uint32_t crit_start;                   /* Time critical section entered       */
   uint32_t crit_max;                     /* Max time in critical section        */
 #endif
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  FAR void *premp_site;                  /* Caller of sched_lock()              */
+  FAR void *crit_site;                   /* Caller of enter_critical_section()  */
+#endif
+
+  /* Run time statistics support ************************************************/
+
+#ifdef CONFIG_SCHED_RUNTIME
+  uint32_t run_start;                    /* Time when the thread last resumed   */
+  uint32_t irq_start;                    /* CPU interrupt time at that moment   */
+  uint64_t run_time;                     /* Execution time, less IRQs (ns)      */
+  uint64_t irq_time;                     /* Interrupt time while running (ns)   */
+  uint32_t nvcsw;                        /* Number of voluntary switches        */
+  uint32_t nivcsw;                       /* Number of preemptions               */
+#endif
+
+  /* Hardware performance counter support ***************************************/
+
+#ifdef CONFIG_SCHED_PMU
+  uint32_t pmu_start[CONFIG_SCHED_PMU_NCOUNTERS]; /* Counters at resumption  */
+  uint64_t pmu_count[CONFIG_SCHED_PMU_NCOUNTERS]; /* Accumulated counts      */
+#endif
 
   /* Library related fields *****************************************************/
 
@@ -783,6 +844,9 @@ struct pthread_tcb_s
 
   pthread_addr_t arg;                    /* Startup argument                    */
   FAR void *joininfo;                    /* Detach-able info to support join    */
+#if CONFIG_PTHREAD_STACK_CACHE > 0
+  size_t stacksize;                      /* Requested size of a cached stack    */
+#endif
 
   /* Robust mutex support *******************************************************/
 
@@ -807,6 +871,39 @@ struct pthread_tcb_s
 
 typedef void (*sched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* One bucket of a critical section or pre-emption duration histogram */
+
+struct critmon_hist_s
+{
+  uint32_t count;                        /* Number of durations in the bucket   */
+  uint32_t max;                          /* Longest duration (platform units)   */
+  FAR void *site;                        /* Call site of the longest duration   */
+};
+#endif
+
+#ifdef CONFIG_SMP_CALL
+/* This is the type of a function queued for another CPU by sched_smp_call().
+ * It runs on that CPU in interrupt context.
+ */
+
+typedef CODE void (*smp_callback_t)(FAR void *arg);
+
+/* A cross-CPU call request.  The storage belongs to the caller and must
+ * persist until the request has been dequeued on the other CPU (i.e.,
+ * until busy becomes false).  A request may be queued for only one CPU
+ * at a time.
+ */
+
+struct smp_call_s
+{
+  FAR struct smp_call_s *flink;          /* Supports a singly linked list       */
+  smp_callback_t func;                   /* Function to run on the other CPU    */
+  FAR void *arg;                         /* Argument passed to func             */
+  volatile bool busy;                    /* True while the request is queued    */
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /********************************************************************************
@@ -835,6 +932,34 @@ EXTERN uint32_t g_crit_max[1];
 #endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Histograms of the time with pre-emption disabled or within a critical
+ * section.
+ */
+
+#ifdef CONFIG_SMP_NCPUS
+EXTERN struct critmon_hist_s
+  g_premp_hist[CONFIG_SMP_NCPUS][SCHED_HIST_NBUCKETS];
+EXTERN struct critmon_hist_s
+  g_crit_hist[CONFIG_SMP_NCPUS][SCHED_HIST_NBUCKETS];
+#else
+EXTERN struct critmon_hist_s
+  g_premp_hist[1][SCHED_HIST_NBUCKETS];
+EXTERN struct critmon_hist_s
+  g_crit_hist[1][SCHED_HIST_NBUCKETS];
+#endif
+#endif /* CONFIG_SCHED_CRITMONITOR_HISTOGRAM */
+
+#ifdef CONFIG_SCHED_RUNTIME
+/* Cumulative interrupt handling time on each CPU (platform time units) */
+
+#ifdef CONFIG_SMP_NCPUS
+EXTERN uint32_t g_runtime_irq[CONFIG_SMP_NCPUS];
+#else
+EXTERN uint32_t g_runtime_irq[1];
+#endif
+#endif /* CONFIG_SCHED_RUNTIME */
+
 /********************************************************************************
  * Public Function Prototypes
  ********************************************************************************/
@@ -1200,6 +1325,78 @@ int nxsched_setaffinity(pid_t pid, size_t cpusetsize,
                         FAR const cpu_set_t *mask);
 #endif
 
+/****************************************************************************
+ * Name: sched_smp_call
+ *
+ * Description:
+ *   Queue a function to be run on another CPU and interrupt that CPU.  The
+ *   function runs in interrupt context on that CPU.  This function does
+ *   not wait for it to do so;  the caller may poll call->busy if it needs
+ *   to know when the request has been taken.  If cpu is the calling CPU,
+ *   then the function is run immediately.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU that will run the function
+ *   call - Caller-provided storage for the request
+ *   func - The function to run
+ *   arg  - The argument passed to func
+ *
+ * Returned Value:
+ *   Zero (OK) if successful.  Otherwise, a negated errno value is returned:
+ *
+ *     EBUSY  The request is still queued from a previous call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int sched_smp_call(int cpu, FAR struct smp_call_s *call,
+                   smp_callback_t func, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: sched_runtime_get
+ *
+ * Description:
+ *   Return the execution time of the thread (excluding interrupt handling)
+ *   and the time spent handling interrupts while the thread was running,
+ *   both in nanoseconds.  If the thread is running now, then the current
+ *   time slice is included.
+ *
+ * Input Parameters:
+ *   tcb     - The TCB of the thread
+ *   runtime - The location to return the execution time
+ *   irqtime - The location to return the interrupt time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUNTIME
+void sched_runtime_get(FAR struct tcb_s *tcb, FAR uint64_t *runtime,
+                       FAR uint64_t *irqtime);
+#endif
+
+/****************************************************************************
+ * Name: sched_pmu_get
+ *
+ * Description:
+ *   Return the hardware performance counts of a thread.  If the thread is
+ *   running on this CPU now, then the current time slice is included.
+ *
+ * Input Parameters:
+ *   tcb    - The TCB of the thread
+ *   counts - The location to return CONFIG_SCHED_PMU_NCOUNTERS counts
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+void sched_pmu_get(FAR struct tcb_s *tcb, FAR uint64_t *counts);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
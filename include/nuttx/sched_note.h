@@ -106,6 +106,10 @@ enum note_type_e
   NOTE_SPINLOCK_UNLOCK = 16,
   NOTE_SPINLOCK_ABORT  = 17
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PMU
+  ,
+  NOTE_PMU             = 18
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -234,6 +238,16 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PMU
+/* This is the specific form of the NOTE_PMU note */
+
+struct note_pmu_s
+{
+  struct note_common_s npm_cmn; /* Common note parameters */
+  uint8_t npm_count[CONFIG_SCHED_PMU_NCOUNTERS][4]; /* Counter increments */
+};
+#endif /* CONFIG_SCHED_INSTRUMENTATION_PMU */
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -305,6 +319,13 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock);
 #  define sched_note_spinabort(t,s)
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PMU
+void sched_note_pmu(FAR struct tcb_s *tcb, FAR const uint32_t *counts,
+                    int ncounters);
+#else
+#  define sched_note_pmu(t,c,n)
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
@@ -348,6 +369,31 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 ssize_t sched_note_size(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many complete notes as will fit from the circular buffer(s)
+ *   and return them in the user buffer.  In the SMP case, the notes from
+ *   each CPU are returned in order, but notes from different CPUs are not
+ *   merged.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the total length of the returned notes is provided.  Zero
+ *   is returned only if the circular buffer(s) are empty.  A negated errno
+ *   value is returned in the event of any failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_SCHED_NOTE_GET)
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: note_register
  *
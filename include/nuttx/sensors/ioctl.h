@@ -210,4 +210,12 @@
 #define SNIOC_SET_CLEAN_INTERVAL   _SNIOC(0x005d) /* Arg: uint32_t value (seconds) */
 #define SNIOC_START_FAN_CLEANING   _SNIOC(0x005e) /* Arg: None */
 
+/* IOCTL commands of the common sensor upper half (see sensor.h) */
+
+#define SNIOC_ACTIVATE             _SNIOC(0x005f) /* Arg: bool value */
+#define SNIOC_SET_PERIOD           _SNIOC(0x0060) /* Arg: uint32_t* (usec) */
+#define SNIOC_SET_BATCH            _SNIOC(0x0061) /* Arg: uint32_t* (usec) */
+#define SNIOC_FLUSH                _SNIOC(0x0062) /* Arg: None */
+#define SNIOC_GET_INFO             _SNIOC(0x0063) /* Arg: struct sensor_info_s* */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
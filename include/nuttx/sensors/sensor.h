@@ -0,0 +1,244 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/sensors/ioctl.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************
+ * CONFIG_SENSORS_UPPER - Enables the common sensor upper half
+ * CONFIG_SENSORS_NPOLLWAITERS - Maximum number of threads that can be
+ *   waiting on poll()
+ */
+
+/* IOCTL Commands ***********************************************************
+ * The common sensor upper half is a character driver.  read() returns an
+ * array of struct sensor_event_s (as many whole events as fit in the
+ * buffer) and blocks unless O_NONBLOCK is set.  poll() reports POLLIN when
+ * at least one event is buffered.  The following ioctls are supported:
+ *
+ * SNIOC_ACTIVATE - Start or stop sampling.
+ *   Argument: bool, true to start
+ * SNIOC_SET_PERIOD - Set the sample period.  The lower half rounds the
+ *   period to one that the hardware supports.
+ *   Argument: uint32_t pointer to the period in microseconds (in/out)
+ * SNIOC_SET_BATCH - Set the maximum latency with which samples are
+ *   reported.  Hardware with a FIFO sets its watermark so that the FIFO is
+ *   drained in bulk once per latency period.  Zero reports each sample.
+ *   Argument: uint32_t pointer to the latency in microseconds (in/out)
+ * SNIOC_FLUSH - Drain the hardware FIFO into the buffer now.
+ *   Argument: None
+ * SNIOC_GET_INFO - Describe the sensor.
+ *   Argument: struct sensor_info_s pointer
+ *
+ * Other commands are forwarded to the lower half.
+ */
+
+/* Sensor types */
+
+#define SENSOR_TYPE_CUSTOM         0
+#define SENSOR_TYPE_ACCELEROMETER  1
+#define SENSOR_TYPE_GYROSCOPE      2
+#define SENSOR_TYPE_MAGNETOMETER   3
+#define SENSOR_TYPE_PRESSURE       4
+#define SENSOR_TYPE_TEMPERATURE    5
+#define SENSOR_TYPE_HUMIDITY       6
+#define SENSOR_TYPE_LIGHT          7
+
+/* The maximum number of values in one sample */
+
+#define SENSOR_MAXDATA             4
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One timestamped sample */
+
+struct sensor_event_s
+{
+  uint64_t timestamp;              /* Microseconds, see sensor_timestamp() */
+  int32_t  data[SENSOR_MAXDATA];   /* Values in lower half defined units */
+};
+
+/* Returned by SNIOC_GET_INFO */
+
+struct sensor_info_s
+{
+  uint8_t  type;                   /* See SENSOR_TYPE_* definitions */
+  uint8_t  ndata;                  /* Number of valid values in data[] */
+  uint16_t fifodepth;              /* Hardware FIFO depth in samples */
+  uint32_t minperiod;              /* Shortest sample period (usec) */
+  uint32_t overruns;               /* Events lost because the buffer was
+                                    * full (set by the upper half) */
+};
+
+/* This is the vtable that is used by the upper half sensor driver to call
+ * back into the lower half driver.
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Start or stop sampling.  While active, the lower half reports samples
+   * with sensor_push_events().  Required.
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sample period.  The lower half may round the period and
+   * returns the period actually used.  Optional.
+   */
+
+  CODE int (*set_period)(FAR struct sensor_lowerhalf_s *lower,
+                         FAR uint32_t *period_us);
+
+  /* Set the batching latency.  A lower half with a hardware FIFO should
+   * set the FIFO watermark accordingly and, on the watermark interrupt,
+   * read the whole FIFO and report all of its samples with one call to
+   * sensor_push_events().  Optional.
+   */
+
+  CODE int (*batch)(FAR struct sensor_lowerhalf_s *lower,
+                    FAR uint32_t *latency_us);
+
+  /* Report all samples currently held in the hardware FIFO.  Optional. */
+
+  CODE int (*flush)(FAR struct sensor_lowerhalf_s *lower);
+
+  /* Lower-half logic may support device-specific ioctl commands */
+
+  CODE int (*ioctl)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                    unsigned long arg);
+};
+
+/* This is the interface between the lower half sensor driver and the upper
+ * half.  Normally the lower half driver will have its own, custom state
+ * structure whose first member is this structure.
+ */
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops; /* Lower half operations */
+  struct sensor_info_s info;          /* Set up by the lower half */
+  FAR void *upper;                    /* Private; set by sensor_register() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half as a character driver.
+ *
+ * Input Parameters:
+ *   lower   - The lower half sensor driver
+ *   path    - The device path, e.g. "/dev/imu0"
+ *   nevents - The number of events buffered by the upper half.  This
+ *             should hold at least two batches of samples.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR struct sensor_lowerhalf_s *lower,
+                    FAR const char *path, unsigned int nevents);
+
+/****************************************************************************
+ * Name: sensor_push_events
+ *
+ * Description:
+ *   Called by the lower half to report one or more samples.  If the buffer
+ *   is full, the oldest events are discarded and counted as overruns.  This
+ *   function may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   lower   - The lower half sensor driver
+ *   events  - The samples
+ *   nevents - The number of samples
+ *
+ ****************************************************************************/
+
+void sensor_push_events(FAR struct sensor_lowerhalf_s *lower,
+                        FAR const struct sensor_event_s *events,
+                        unsigned int nevents);
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds on the time base used for
+ *   sensor event time stamps.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPER */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
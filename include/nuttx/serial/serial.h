@@ -227,19 +227,32 @@ struct uart_ops_s
 #endif
 
 #ifdef CONFIG_SERIAL_DMA
-  /* Start transfer bytes from the TX circular buffer using DMA */
+  /* Start transfer bytes from the TX circular buffer using DMA.  The transfer
+   * is described by dev->dmatx and may consist of two segments that must be
+   * chained.  The lower half calls uart_xmitchars_done() when it completes;
+   * that starts the next transfer if more data is waiting.
+   */
 
   CODE void (*dmasend)(FAR struct uart_dev_s *dev);
 
-  /* Start transfer bytes from the TX circular buffer using DMA */
+  /* Start transfer bytes into the RX circular buffer using DMA.  The transfer
+   * is described by dev->dmarx.  If the hardware can detect an idle line, the
+   * lower half should end the transfer early when the line goes idle and call
+   * uart_recvchars_done() with the partial count so that received data is
+   * delivered promptly; reception is then restarted automatically.
+   */
 
   CODE void (*dmareceive)(FAR struct uart_dev_s *dev);
 
-  /* Notify DMA that there is free space in the RX buffer */
+  /* Notify DMA that there is free space in the RX buffer.  This is normally
+   * just a call to uart_recvchars_dma().
+   */
 
   CODE void (*dmarxfree)(FAR struct uart_dev_s *dev);
 
-  /* Notify DMA that there is data to be transferred in the TX buffer */
+  /* Notify DMA that there is data to be transferred in the TX buffer.  This is
+   * normally just a call to uart_xmitchars_dma().
+   */
 
   CODE void (*dmatxavail)(FAR struct uart_dev_s *dev);
 #endif
@@ -445,7 +458,8 @@ void uart_connected(FAR uart_dev_t *dev, bool connected);
  * Name: uart_xmitchars_dma
  *
  * Description:
- *   Set up to transfer bytes from the TX circular buffer using DMA
+ *   Set up to transfer bytes from the TX circular buffer using DMA.  Does
+ *   nothing if a transfer is already in progress.
  *
  ************************************************************************************/
 
@@ -459,7 +473,8 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev);
  * Description:
  *   Perform operations necessary at the complete of DMA including adjusting the
  *   TX circular buffer indices and waking up of any threads that may have been
- *   waiting for space to become available in the TX circular buffer.
+ *   waiting for space to become available in the TX circular buffer.  The next
+ *   transfer is started if more data is waiting.
  *
  ************************************************************************************/
 
@@ -471,7 +486,8 @@ void uart_xmitchars_done(FAR uart_dev_t *dev);
  * Name: uart_recvchars_dma
  *
  * Description:
- *   Set up to receive bytes into the RX circular buffer using DMA
+ *   Set up to receive bytes into the RX circular buffer using DMA.  Does nothing
+ *   if a transfer is already in progress.
  *
  ************************************************************************************/
 
@@ -485,7 +501,8 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
  * Description:
  *   Perform operations necessary at the complete of DMA including adjusting the
  *   RX circular buffer indices and waking up of any threads that may have been
- *   waiting for new data to become available in the RX circular buffer.
+ *   waiting for new data to become available in the RX circular buffer.  May be
+ *   called with a partial count on an idle line.  Reception is restarted.
  *
  ************************************************************************************/
 
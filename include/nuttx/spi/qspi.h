@@ -226,6 +226,58 @@
 
 #define QSPI_FREE(d,b) (d)->ops->free(d,b)
 
+/****************************************************************************
+ * Name: QSPI_MEMMAP
+ *
+ * Description:
+ *   Switch the controller to memory-mapped (XIP) mode, if supported.  While
+ *   in memory-mapped mode, the memory can be read (and code executed)
+ *   directly from the returned base address.  Each access is performed with
+ *   the read command described by meminfo.  The addr, buflen, and buffer
+ *   fields of meminfo are ignored.
+ *
+ *   Memory-mapped mode ends with QSPI_MEMUNMAP or with any indirect
+ *   transfer (QSPI_COMMAND or QSPI_MEMORY).  Both QSPI_MEMMAP and
+ *   QSPI_MEMUNMAP must be called with the bus unlocked.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the memory read to be performed on each access
+ *   base    - Location to return the memory-mapped base address
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS; -ENOSYS if memory-mapped mode is not supported
+ *   by the controller, or another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#define QSPI_MEMMAP(d,m,b) \
+  ((d)->ops->memmap ? (d)->ops->memmap(d,m,b) : -ENOSYS)
+
+/****************************************************************************
+ * Name: QSPI_MEMUNMAP
+ *
+ * Description:
+ *   Leave memory-mapped mode entered by QSPI_MEMMAP
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#define QSPI_MEMUNMAP(d) \
+  do \
+    { \
+      if ((d)->ops->memunmap != NULL) \
+        { \
+          (d)->ops->memunmap(d); \
+        } \
+    } \
+  while (0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -283,6 +335,13 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+
+  /* Optional: NULL if memory-mapped mode is not supported */
+
+  CODE int       (*memmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo,
+                    FAR void **base);
+  CODE void      (*memunmap)(FAR struct qspi_dev_s *dev);
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
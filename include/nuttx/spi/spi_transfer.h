@@ -48,6 +48,10 @@
 
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
+#ifdef CONFIG_SPI_QUEUE
+#  include <queue.h>
+#  include <nuttx/wqueue.h>
+#endif
 
 #ifdef CONFIG_SPI_EXCHANGE
 
@@ -125,6 +129,38 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_QUEUE
+/* This describes one queued, asynchronous SPI sequence as handled by
+ * spi_queue_submit().  The structure and the sequence that it refers to
+ * must persist until the callback has been called.
+ */
+
+struct spi_request_s;
+typedef CODE void (*spi_reqcallback_t)(FAR struct spi_request_s *req);
+
+struct spi_request_s
+{
+  FAR struct spi_request_s *flink;  /* Supports a singly linked list */
+  FAR struct spi_sequence_s *seq;   /* The sequence of transfers */
+  spi_reqcallback_t callback;       /* Called when the sequence completes */
+  FAR void *arg;                    /* For use by the callback */
+  uint8_t priority;                 /* Higher priorities are served first */
+  int result;                       /* Result of spi_transfer() */
+};
+
+/* The state of one SPI transaction queue.  There is one queue per SPI bus
+ * and it is normally allocated statically by board logic.
+ */
+
+struct spi_queue_s
+{
+  FAR struct spi_dev_s *spi;        /* The SPI bus */
+  sq_queue_t pending;               /* Requests waiting, by priority */
+  struct work_s work;               /* Performs the transfers */
+  bool busy;                        /* Work has been scheduled */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,6 +210,67 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Initialize a transaction queue for an SPI bus.
+ *
+ * Input Parameters:
+ *   queue - The queue to initialize
+ *   spi   - An instance of the lower half SPI driver
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_QUEUE
+void spi_queue_initialize(FAR struct spi_queue_s *queue,
+                          FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return immediately.  Sequences
+ *   are performed one at a time on the work queue with spi_transfer(),
+ *   highest priority first and in order of submission within a priority.
+ *   When the sequence has completed, req->result is set and req->callback
+ *   (if not NULL) is called from the work queue.  The lower half performs
+ *   each exchange with DMA if it is configured to do so, so no client
+ *   thread is blocked while the bus is busy.
+ *
+ * Input Parameters:
+ *   queue - The SPI transaction queue
+ *   req   - Describes the sequence to perform
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  The
+ *   callback is not called.
+ *
+ * Input Parameters:
+ *   queue - The SPI transaction queue
+ *   req   - The request to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the request is not waiting in the
+ *   queue (it is being performed or has already completed).
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
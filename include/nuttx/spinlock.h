@@ -84,6 +84,10 @@
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
+#if defined(CONFIG_SCHED_LOCKSTAT) && !defined(__SP_UNLOCK_FUNCTION)
+#  define __SP_UNLOCK_FUNCTION 1
+#endif
+
 /* If the target CPU supports a data cache then it may be necessary to
  * manage spinlocks in a special way, perhaps linking them all into a
  * special non-cacheable memory region.
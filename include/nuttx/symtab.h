@@ -118,6 +118,27 @@ FAR const struct symtab_s *
 symtab_findorderedbyname(FAR const struct symtab_s *symtab,
                          FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version makes no assumptions about the ordering of the table.  A
+ *   hash index of the table is built on the first search and is reused by
+ *   later searches of the same table.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms);
+#endif
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
@@ -82,6 +82,14 @@
  * following may also be provided:
  *
  * CONFIG_RAMLOG_BUFSIZE - Size of the console RAM log.  Default: 1024
+ * CONFIG_RAMLOG_LZF - Store the RAM log as LZF-compressed blocks.  When
+ *   there is no room for a new block, the oldest blocks are discarded.
+ * CONFIG_RAMLOG_LZF_BLOCKSIZE - Size of one uncompressed block.
+ *   Default: 256
+ * CONFIG_RAMLOG_PERSIST - Keep the RAM log in RAM that is not initialized
+ *   at start-up so that its contents survive a warm reset.
+ * CONFIG_RAMLOG_PERSIST_SECTION - The linker section holding the RAM log.
+ *   Default: ".noinit"
  */
 
 #ifndef CONFIG_DEV_CONSOLE
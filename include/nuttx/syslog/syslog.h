@@ -193,6 +193,26 @@ int syslog_initialize(enum syslog_init_e phase);
 #  define syslog_initialize(phase)
 #endif
 
+/****************************************************************************
+ * Name: syslog_deferred_start
+ *
+ * Description:
+ *   Start the kernel thread that formats deferred SYSLOG messages.  Until
+ *   this thread is running, all SYSLOG output is formatted immediately.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The process ID (pid) of the new thread is returned on success; a
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_start(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_file_channel
  *
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * include/nuttx/timers/hrtimer.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+#define __INCLUDE_NUTTX_TIMERS_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include <nuttx/timers/oneshot.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Modes for hrtimer_start() */
+
+#define HRTIMER_MODE_REL  0  /* Expiration is relative to now */
+#define HRTIMER_MODE_ABS  1  /* Expiration is an absolute hrtimer_now() */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The function called when a high resolution timer expires.  It is called
+ * from the interrupt handler of the oneshot timer.  A non-zero return value
+ * is an interval in nanoseconds after which the timer is started again,
+ * measured from the previous expiration time so that periodic timers do
+ * not drift.  Zero means that the timer is not restarted.
+ */
+
+struct hrtimer_s;
+typedef CODE uint64_t (*hrtimer_callback_t)(FAR struct hrtimer_s *timer);
+
+/* One high resolution timer.  This is allocated by the caller and must
+ * persist while the timer is active.
+ */
+
+struct hrtimer_s
+{
+  dq_entry_t node;                /* Supports a doubly linked list */
+  hrtimer_callback_t func;        /* Function to call on expiration */
+  FAR void *arg;                  /* Argument for the use of func */
+  uint64_t expire;                /* Earliest expiration time (ns) */
+  uint32_t slack;                 /* Allowed lateness (ns) */
+  bool active;                    /* True: The timer is running */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Provide the oneshot timer that drives the high resolution timers.  This
+ *   should be a timer other than the one used for the system timer.  The
+ *   lower half must support ONESHOT_CURRENT() which provides the time base
+ *   of the high resolution timers.
+ *
+ * Input Parameters:
+ *   lower - An instance of the oneshot lower half
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.
+ *
+ * Input Parameters:
+ *   timer - The timer to initialize
+ *   func  - The function to call when the timer expires
+ *   arg   - An argument available to func as timer->arg
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t func,
+                  FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current time of the high resolution timers in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_now(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.  The timer will not expire
+ *   before the requested time and should expire no later than 'slack'
+ *   nanoseconds after it.  Timers with overlapping windows expire together
+ *   from one timer interrupt.
+ *
+ * Input Parameters:
+ *   timer - The timer to start
+ *   ns    - The expiration time in nanoseconds
+ *   slack - The coalescing window in nanoseconds
+ *   mode  - HRTIMER_MODE_REL or HRTIMER_MODE_ABS
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t ns, uint32_t slack,
+                  int mode);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.  This does nothing if the timer is not
+ *   active.
+ *
+ * Input Parameters:
+ *   timer - The timer to stop
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the nanoseconds remaining until the timer expires, or zero if
+ *   the timer is not active.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_TIMERS_HRTIMER_H */
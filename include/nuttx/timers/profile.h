@@ -0,0 +1,149 @@
+/****************************************************************************
+ * include/nuttx/timers/profile.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_PROFILE_H
+#define __INCLUDE_NUTTX_TIMERS_PROFILE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/timers/timer.h>
+
+#ifdef CONFIG_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+/* The profiler device supports the following IOCTL commands:
+ *
+ * PROFIOC_START       - Discard any old samples and start sampling.
+ *                       Argument: Ignored
+ * PROFIOC_STOP        - Stop sampling.  Samples that have been collected
+ *                       may still be read.
+ *                       Argument: Ignored
+ * PROFIOC_SETINTERVAL - Set the sampling interval.  This takes effect the
+ *                       next time that sampling is started.
+ *                       Argument: A 32-bit interval in microseconds.
+ * PROFIOC_GETSTATUS   - Return the number of samples that are waiting to
+ *                       be read and the number that have been lost.
+ *                       Argument: A reference to struct profile_status_s
+ */
+
+#define PROFIOC_START       _PROFIOC(0x0001)
+#define PROFIOC_STOP        _PROFIOC(0x0002)
+#define PROFIOC_SETINTERVAL _PROFIOC(0x0003)
+#define PROFIOC_GETSTATUS   _PROFIOC(0x0004)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One sample as returned by read().  pc is the program counter of the
+ * code that was interrupted by the sampling timer.  The samples are packed
+ * in the native byte order of the target.
+ */
+
+struct profile_sample_s
+{
+  uint32_t pc;          /* Interrupted program counter */
+  uint16_t pid;         /* ID of the interrupted task */
+  uint8_t  cpu;         /* CPU that took the sample */
+  uint8_t  reserved;
+};
+
+/* Returned by PROFIOC_GETSTATUS */
+
+struct profile_status_s
+{
+  uint32_t nsamples;    /* Number of samples waiting to be read */
+  uint32_t noverruns;   /* Samples lost because the buffer was full */
+  uint32_t interval;    /* Sampling interval in microseconds */
+  bool     started;     /* True:  Sampling is in progress */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: profile_register
+ *
+ * Description:
+ *   Register the statistical profiler device.  Each time that the timer
+ *   expires, the program counter of the interrupted code and the ID of the
+ *   running task are added to a buffer of CONFIG_PROFILE_NSAMPLES samples.
+ *   The samples are then read from the device (see tools/profinfo.c).
+ *
+ *   The timer lower half is dedicated to the profiler.  It must not also
+ *   be registered with timer_register().  The timer interrupt should have
+ *   a higher priority than the interrupts that are to be profiled.
+ *
+ * Input Parameters:
+ *   path  - The path to the device.  Normally "/dev/profile".
+ *   lower - An instance of the timer lower half driver.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int profile_register(FAR const char *path,
+                     FAR struct timer_lowerhalf_s *lower);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_PROFILE */
+#endif /* __INCLUDE_NUTTX_TIMERS_PROFILE_H */
@@ -73,6 +73,16 @@
 #define TLS_MAXSTACK      (TLS_STACK_ALIGN)
 #define TLS_INFO(sp)      ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
 
+/* The size of the TLS region at the bottom of each stack.  With
+ * CONFIG_TLS_ELF, this includes the compiler's __thread variables.
+ */
+
+#ifdef CONFIG_TLS_ELF
+#  define TLS_INFO_SIZE   (sizeof(struct tls_info_s) + tls_elf_size())
+#else
+#  define TLS_INFO_SIZE   sizeof(struct tls_info_s)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -93,8 +103,17 @@
 struct tls_info_s
 {
   uintptr_t tl_elem[CONFIG_TLS_NELEM]; /* TLS elements */
+#ifdef CONFIG_TLS_ELF
+  uint64_t  tl_tcb;                    /* ELF thread control block */
+#endif
 };
 
+/* With CONFIG_TLS_ELF, the thread pointer returned by __aeabi_read_tp()
+ * points to tl_tcb and the __thread variables of the thread immediately
+ * follow struct tls_info_s (ARM EABI TLS variant 1).  tl_tcb must be the
+ * last member of the structure.
+ */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -136,5 +155,37 @@ uintptr_t tls_get_element(int elem);
 
 void tls_set_element(int elem, uintptr_t value);
 
+/****************************************************************************
+ * Name: tls_elf_size
+ *
+ * Description:
+ *   Return the size of the compiler thread-local variables (.tdata and
+ *   .tbss) that are placed after struct tls_info_s in each stack.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_ELF
+size_t tls_elf_size(void);
+#endif
+
+/****************************************************************************
+ * Name: tls_elf_initialize
+ *
+ * Description:
+ *   Initialize the compiler thread-local variables of a new thread:  Copy
+ *   the initial values of .tdata and clear .tbss.
+ *
+ * Input Parameters:
+ *   info - The TLS structure at the bottom of the new stack
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_ELF
+void tls_elf_initialize(FAR struct tls_info_s *info);
+#endif
+
 #endif /* CONFIG_TLS */
 #endif /* __INCLUDE_NUTTX_TLS_H */
@@ -87,7 +87,8 @@
  * Public Type Definitions
  ****************************************************************************/
 
-struct mm_heaps_s; /* Forward reference */
+struct mm_heaps_s;       /* Forward reference */
+struct clock_usertime_s; /* Forward reference */
 
  /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s.  An
@@ -111,6 +112,12 @@ struct userspace_s
 
   FAR struct mm_heap_s *us_heap;
 
+  /* Copy of the clock maintained by the kernel */
+
+#ifdef CONFIG_CLOCK_USERTIME
+  FAR struct clock_usertime_s *us_clock;
+#endif
+
   /* Task/thread startup routines */
 
   void (*task_startup)(main_t entrypt, int argc, FAR char *argv[])
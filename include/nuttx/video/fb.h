@@ -287,6 +287,12 @@
 #endif
 #endif /* CONFIG_FB_OVERLAY */
 
+#ifdef CONFIG_FB_PANDISPLAY
+#  define FBIOPAN_DISPLAY     _FBIOC(0x0012)  /* Pan display at next vsync
+                                               * Argument: read-only struct
+                                               *           fb_planeinfo_s */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -321,6 +327,10 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_PANDISPLAY
+  fb_coord_t yres_virtual; /* Number of lines in the frame buffer memory */
+  fb_coord_t yoffset;     /* First line of the frame buffer displayed */
+#endif
 };
 
 #ifdef CONFIG_FB_OVERLAY
@@ -516,6 +526,18 @@ struct fb_vtable_s
   int (*waitforvsync)(FAR struct fb_vtable_s *vtable);
 #endif
 
+#ifdef CONFIG_FB_PANDISPLAY
+  /* The following is provided only if the video hardware can display any
+   * part of a virtual frame buffer that is larger than the display.  The
+   * yoffset of pinfo selects the first line displayed.  The change takes
+   * effect at the next vertical sync and the call does not return before
+   * then.
+   */
+
+  int (*pandisplay)(FAR struct fb_vtable_s *vtable,
+                    FAR const struct fb_planeinfo_s *pinfo);
+#endif
+
 #ifdef CONFIG_FB_OVERLAY
   /* Get information about the video controller configuration and the
    * configuration of each overlay.
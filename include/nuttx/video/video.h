@@ -0,0 +1,253 @@
+/****************************************************************************
+ * include/nuttx/video/video.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_VIDEO_H
+#define __INCLUDE_NUTTX_VIDEO_VIDEO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/video/fb.h>
+
+#ifdef CONFIG_VIDEO_STREAM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+/* The video capture device supports the following IOCTL commands.  The
+ * sequence of operations is the same as for V4L2 streaming I/O:  Set the
+ * format, request buffers, mmap() them (VIDEO_MEMORY_MMAP only), queue
+ * them, start streaming and then repeatedly dequeue filled buffers and
+ * queue them again when they have been processed.
+ *
+ * VIDIOC_G_FMT     - Get the current capture format
+ *                    Argument: A reference to struct video_format_s
+ * VIDIOC_S_FMT     - Set the capture format.  The lower half adjusts the
+ *                    request to the nearest supported format and returns
+ *                    the line stride and the maximum frame size.  Not
+ *                    permitted while buffers are allocated.
+ *                    Argument: A reference to struct video_format_s
+ * VIDIOC_REQBUFS   - Allocate (or, with a count of zero, release) the
+ *                    streaming buffers.  The count may be reduced.
+ *                    Argument: A reference to struct video_reqbufs_s
+ * VIDIOC_QUERYBUF  - Return the size and mmap() offset of a buffer
+ *                    Argument: A reference to struct video_buffer_s
+ * VIDIOC_QBUF      - Give an empty buffer to the driver to be filled
+ *                    Argument: A reference to struct video_buffer_s
+ * VIDIOC_DQBUF     - Take the oldest filled buffer back from the driver.
+ *                    This waits for a frame unless O_NONBLOCK is set.
+ *                    poll() reports POLLIN when a buffer can be dequeued.
+ *                    Argument: A reference to struct video_buffer_s
+ * VIDIOC_STREAMON  - Start capturing
+ *                    Argument: Ignored
+ * VIDIOC_STREAMOFF - Stop capturing.  All buffers, filled or not, are
+ *                    returned to the application.
+ *                    Argument: Ignored
+ *
+ * Other commands are passed to the lower half driver.
+ */
+
+#define VIDIOC_G_FMT         _VIDIOC(0x0001)
+#define VIDIOC_S_FMT         _VIDIOC(0x0002)
+#define VIDIOC_REQBUFS       _VIDIOC(0x0003)
+#define VIDIOC_QUERYBUF      _VIDIOC(0x0004)
+#define VIDIOC_QBUF          _VIDIOC(0x0005)
+#define VIDIOC_DQBUF         _VIDIOC(0x0006)
+#define VIDIOC_STREAMON      _VIDIOC(0x0007)
+#define VIDIOC_STREAMOFF     _VIDIOC(0x0008)
+
+/* Buffer memory types ******************************************************/
+
+#define VIDEO_MEMORY_MMAP    1  /* The driver allocates the buffers.  They
+                                 * are accessed with mmap() */
+#define VIDEO_MEMORY_USERPTR 2  /* The application provides each buffer
+                                 * with VIDIOC_QBUF.  This may be shared
+                                 * memory or frame buffer memory so that
+                                 * frames are captured where they are
+                                 * used */
+
+/* Buffer flags *************************************************************/
+
+#define VIDEO_BUF_FLAG_QUEUED (1 << 0) /* Owned by the driver */
+#define VIDEO_BUF_FLAG_DONE   (1 << 1) /* Filled, waiting to be dequeued */
+#define VIDEO_BUF_FLAG_ERROR  (1 << 2) /* The frame was not captured */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Used with VIDIOC_G_FMT and VIDIOC_S_FMT */
+
+struct video_format_s
+{
+  uint16_t width;       /* Frame width in pixels */
+  uint16_t height;      /* Frame height in pixels */
+  uint8_t  pixfmt;      /* Pixel format:  FB_FMT_* (see nuttx/video/fb.h) */
+  uint32_t stride;      /* Returned:  Bytes per line */
+  uint32_t imagesize;   /* Returned:  Maximum bytes per frame */
+};
+
+/* Used with VIDIOC_REQBUFS */
+
+struct video_reqbufs_s
+{
+  uint32_t count;       /* Number of buffers requested / allocated */
+  uint8_t  memory;      /* VIDEO_MEMORY_MMAP or VIDEO_MEMORY_USERPTR */
+};
+
+/* Used with VIDIOC_QUERYBUF, VIDIOC_QBUF, and VIDIOC_DQBUF */
+
+struct video_buffer_s
+{
+  uint32_t index;       /* Buffer index:  0 .. count-1 */
+  uint8_t  memory;      /* VIDEO_MEMORY_MMAP or VIDEO_MEMORY_USERPTR */
+  uint8_t  flags;       /* See VIDEO_BUF_FLAG_* definitions */
+  uint32_t length;      /* Size of the buffer in bytes */
+  uint32_t bytesused;   /* DQBUF:  Number of bytes captured */
+  uint32_t sequence;    /* DQBUF:  Frame sequence number */
+  struct timespec timestamp; /* DQBUF:  Time that capture completed */
+  off_t    offset;      /* MMAP:  The offset to pass to mmap() */
+  FAR void *userptr;    /* USERPTR:  Buffer provided with QBUF */
+};
+
+/* This is the type of the callback that the lower half calls when it has
+ * finished with the buffer passed to the most recent call of capture().
+ * It may be called from an interrupt handler.  result is zero if a frame
+ * was captured into the buffer or a negated errno value if not.
+ */
+
+typedef CODE void (*video_handler_t)(FAR void *arg, int result,
+                                     uint32_t nbytes);
+
+/* The lower half video capture driver interface.  The upper half provides
+ * the buffers; the lower half hardware must be able to transfer (normally
+ * via DMA) a whole frame directly into each buffer.
+ */
+
+struct video_lowerhalf_s;
+struct video_ops_s
+{
+  /* Adjust the format to the closest supported format and select it.
+   * stride and imagesize must be returned.
+   */
+
+  CODE int (*setformat)(FAR struct video_lowerhalf_s *lower,
+                        FAR struct video_format_s *fmt);
+
+  /* Start the image sensor.  handler is to be called with arg each time
+   * that capture into a buffer completes.
+   */
+
+  CODE int (*start)(FAR struct video_lowerhalf_s *lower,
+                    video_handler_t handler, FAR void *arg);
+
+  /* Capture the next frame into the buffer.  This is called from the
+   * handler (and so possibly from an interrupt handler) as soon as the
+   * previous frame has been captured and there is a queued buffer.  Frames
+   * that start while no buffer is available are to be dropped.
+   */
+
+  CODE int (*capture)(FAR struct video_lowerhalf_s *lower,
+                      FAR uint8_t *buffer, uint32_t length);
+
+  /* Stop the image sensor and abort any capture in progress.  The handler
+   * must not be called after this returns.
+   */
+
+  CODE int (*stop)(FAR struct video_lowerhalf_s *lower);
+
+  /* Any other IOCTL commands (optional) */
+
+  CODE int (*ioctl)(FAR struct video_lowerhalf_s *lower, int cmd,
+                    unsigned long arg);
+};
+
+struct video_lowerhalf_s
+{
+  FAR const struct video_ops_s *ops;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: video_register
+ *
+ * Description:
+ *   Register a video capture device.  Frames are captured directly into
+ *   buffers that are either allocated by the driver and mapped into the
+ *   application with mmap(), or provided by the application.  No frame
+ *   data is copied by the CPU.
+ *
+ * Input Parameters:
+ *   path  - The path to the device.  Normally "/dev/videoN".
+ *   lower - An instance of the lower half video capture driver.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int video_register(FAR const char *path,
+                   FAR struct video_lowerhalf_s *lower);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_STREAM */
+#endif /* __INCLUDE_NUTTX_VIDEO_VIDEO_H */
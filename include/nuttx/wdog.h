@@ -144,6 +144,11 @@ struct wdog_s
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_WHEEL
+  FAR struct wdog_s *prev;       /* Doubly linked within a wheel slot */
+  uint32_t           expire;     /* Wheel time of expiration */
+  uint8_t            slot;       /* Wheel slot holding the watchdog */
+#endif
 };
 
 /* Watchdog 'handle' */
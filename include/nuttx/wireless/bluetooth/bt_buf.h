@@ -85,6 +85,7 @@ struct bt_buf_hci_data_s
 struct bt_buf_acl_data_s
 {
   uint16_t handle;
+  uint8_t credit;        /* Return a notification credit when sent */
 };
 
 /* This structure defines one buffer */
@@ -850,13 +850,25 @@ int bt_gatt_attr_read_cep(FAR struct bt_conn_s *conn,
  *   BT_GATT_CCC otherwise it cannot find a valid peer configuration.
  *
  * Input Parameters:
+ *   Each connection may have up to CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS
+ *   notifications waiting for transmission.  A peer with no credits left
+ *   is skipped rather than blocking the caller, so notifications may be
+ *   issued at the full rate of the link.
+ *
+ * Input Parameters:
  *   handle - Attribute handle.
  *   value  - Attribute value.
  *   len    - Attribute value length.
  *
+ * Returned Value:
+ *   Zero (OK) is returned if the notification was queued for every
+ *   configured peer.  -EAGAIN is returned if one or more peers were
+ *   skipped because they had no notification credits; -ENOBUFS if no
+ *   buffer could be allocated.
+ *
  ****************************************************************************/
 
-void bt_gatt_notify(uint16_t handle, FAR const void *data, size_t len);
+int bt_gatt_notify(uint16_t handle, FAR const void *data, size_t len);
 
 /****************************************************************************
  * Name: bt_gatt_connected
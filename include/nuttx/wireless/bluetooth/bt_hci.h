@@ -98,7 +98,9 @@
 
 /* LE features */
 
-#define BT_HCI_LE_ENCRYPTION     0x01
+#define BT_HCI_LE_ENCRYPTION     0x01  /* Byte 0 */
+#define BT_HCI_LE_DATA_LEN_EXT   0x20  /* Byte 0 */
+#define BT_HCI_LE_2M_PHY         0x01  /* Byte 1 */
 
 /* OpCode Group Fields */
 
@@ -156,6 +158,11 @@
 #define BT_HCI_OP_LE_START_ENCRYPTION         BT_OP(BT_OGF_LE, 0x0019)
 #define BT_HCI_OP_LE_LTK_REQ_REPLY            BT_OP(BT_OGF_LE, 0x001a)
 #define BT_HCI_OP_LE_LTK_REQ_NEG_REPLY        BT_OP(BT_OGF_LE, 0x001b)
+#define BT_HCI_OP_LE_SET_DATA_LEN             BT_OP(BT_OGF_LE, 0x0022)
+#define BT_HCI_OP_LE_READ_MAX_DATA_LEN        BT_OP(BT_OGF_LE, 0x002f)
+#define BT_HCI_OP_LE_SET_DEFAULT_PHY          BT_OP(BT_OGF_LE, 0x0031)
+#  define BT_HCI_LE_PHY_1M                    0x01
+#  define BT_HCI_LE_PHY_2M                    0x02
 
 /* Event definitions */
 
@@ -355,6 +362,29 @@ begin_packed_struct struct hci_cp_le_conn_update_s
   uint16_t max_ce_len;
 } end_packed_struct;
 
+begin_packed_struct struct bt_hci_cp_le_set_data_len_s
+{
+  uint16_t handle;
+  uint16_t tx_octets;
+  uint16_t tx_time;
+} end_packed_struct;
+
+begin_packed_struct struct bt_hci_rp_le_read_max_data_len_s
+{
+  uint8_t status;
+  uint16_t max_tx_octets;
+  uint16_t max_tx_time;
+  uint16_t max_rx_octets;
+  uint16_t max_rx_time;
+} end_packed_struct;
+
+begin_packed_struct struct bt_hci_cp_le_set_default_phy_s
+{
+  uint8_t all_phys;
+  uint8_t tx_phys;
+  uint8_t rx_phys;
+} end_packed_struct;
+
 begin_packed_struct struct bt_hci_cp_le_encrypt_s
 {
   uint8_t key[16];
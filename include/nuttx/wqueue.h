@@ -227,6 +227,10 @@
  *     used for any purpose.  if CONFIG_SCHED_LPWORK is not defined, then
  *     there is only one kernel work queue and LPWORK == HPWORK.
  *
+ *   NAMEDWORK: The ID of the first named work queue.  Named work queues
+ *     are created at run time by work_queue_create() if
+ *     CONFIG_SCHED_NAMEDWORK is selected.  Their IDs follow this one.
+ *
  * User Work Queue:
  *   USRWORK:  In the kernel phase a a kernel build, there should be no
  *     references to user-space work queues.  That would be an error.
@@ -251,6 +255,9 @@
 #    define LPWORK HPWORK     /* Redirect low-priority references */
 #  endif
 #  define USRWORK  LPWORK     /* Redirect user-mode references */
+#  ifdef CONFIG_SCHED_NAMEDWORK
+#    define NAMEDWORK 3       /* First named, kernel-mode work queue */
+#  endif
 
 #endif /* CONFIG_LIB_USRWORK && !__KERNEL__ */
 
@@ -288,7 +295,8 @@ enum work_evtype_e
   WORK_NET_DOWN,       /* Notify that the network is down */
   WORK_TCP_READAHEAD,  /* Notify that TCP read-ahead data is available */
   WORK_TCP_DISCONNECT, /* Notify loss of TCP connection */
-  WORK_UDP_READAHEAD   /* Notify that TCP read-ahead data is available */
+  WORK_UDP_READAHEAD,  /* Notify that TCP read-ahead data is available */
+  WORK_IOB_LOWATER     /* Notify that free IOBs fell to the low watermark */
 };
 
 /* This structure describes one notification and is provided as input to
@@ -443,6 +451,59 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 int work_signal(int qid);
 
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a named, kernel-mode work queue served by its own worker
+ *   thread(s).
+ *
+ * Input Parameters:
+ *   name       - The name of the work queue, also used for its threads
+ *   priority   - The priority of the worker threads
+ *   stack_size - The stack size of each worker thread
+ *   nthreads   - The number of worker threads, at most
+ *                CONFIG_SCHED_NAMEDWORK_MAXTHREADS
+ *   affinity   - The CPU affinity of the worker threads as a bit set with
+ *                bit n for CPU n.  Zero means any CPU.  Ignored if
+ *                CONFIG_SMP is not selected.
+ *
+ * Returned Value:
+ *   The ID of the new work queue (NAMEDWORK or greater) is returned on
+ *   success.  A negated errno value is returned on failure:
+ *
+ *   -EEXIST - A work queue with this name already exists
+ *   -ENOSPC - All CONFIG_SCHED_NAMEDWORK_NQUEUES work queues are in use
+ *   -EINVAL - An invalid argument was provided
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NAMEDWORK) && \
+   (!defined(CONFIG_LIB_USRWORK) || defined(__KERNEL__))
+int work_queue_create(FAR const char *name, int priority, int stack_size,
+                      int nthreads, uint32_t affinity);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_find
+ *
+ * Description:
+ *   Find a named work queue created by work_queue_create().
+ *
+ * Input Parameters:
+ *   name - The name of the work queue
+ *
+ * Returned Value:
+ *   The ID of the work queue is returned on success; -ENOENT is returned if
+ *   there is no work queue with that name.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NAMEDWORK) && \
+   (!defined(CONFIG_LIB_USRWORK) || defined(__KERNEL__))
+int work_queue_find(FAR const char *name);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
@@ -110,6 +110,16 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
+/* Poll notification callback.  When the pollfd 'cb' field is non-NULL, the
+ * driver notification (poll_notify()) calls this function instead of simply
+ * posting the 'sem' semaphore.  This permits event notification to be
+ * routed to the specific waiter (as is needed by epoll()).  For the normal
+ * poll() logic, 'cb' is always NULL.
+ */
+
+struct pollfd; /* Forward reference */
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
 /* This is the Nuttx variant of the standard pollfd structure. */
 
 struct pollfd
@@ -133,6 +143,8 @@ struct pollfd
   pollevent_t  events;  /* The input event flags */
   pollevent_t  revents; /* The output event flags */
   FAR void    *priv;    /* For use by drivers */
+  pollcb_t     cb;      /* Notification callback (or NULL) */
+  FAR void    *arg;     /* For use by the notification callback */
 };
 
 /****************************************************************************
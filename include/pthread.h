@@ -179,6 +179,7 @@
 #define _PTHREAD_MFLAGS_ROBUST        (1 << 0) /* Robust (NORMAL) mutex */
 #define _PTHREAD_MFLAGS_INCONSISTENT  (1 << 1) /* Mutex is in an inconsistent state */
 #define _PTHREAD_MFLAGS_NRECOVERABLE  (1 << 2) /* Inconsistent mutex has been unlocked */
+#define _PTHREAD_MFLAGS_ADAPTIVE      (1 << 3) /* Spin while the holder runs */
 
 /* Definitions to map some non-standard, BSD thread management interfaces to
  * the non-standard Linux-like prctl() interface.  Since these are simple
@@ -267,6 +268,9 @@ struct pthread_mutexattr_s
 #ifdef CONFIG_PTHREAD_MUTEX_BOTH
   uint8_t robust  : 1;  /* PTHREAD_MUTEX_STALLED or PTHREAD_MUTEX_ROBUST */
 #endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  uint8_t adaptive : 1; /* Spin before blocking (non-standard) */
+#endif
 };
 
 typedef struct pthread_mutexattr_s pthread_mutexattr_t;
@@ -510,6 +514,10 @@ int pthread_mutexattr_getrobust(FAR const pthread_mutexattr_t *attr,
                                 FAR int *robust);
 int pthread_mutexattr_setrobust(FAR pthread_mutexattr_t *attr,
                                 int robust);
+int pthread_mutexattr_getadaptive_np(FAR const pthread_mutexattr_t *attr,
+                                     FAR int *adaptive);
+int pthread_mutexattr_setadaptive_np(FAR pthread_mutexattr_t *attr,
+                                     int adaptive);
 
 /* The following routines create, delete, lock and unlock mutexes. */
 
@@ -59,6 +59,7 @@
 #define SCHED_RR                  2  /* Round robin scheduling policy */
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_OTHER               4  /* Not supported */
+#define SCHED_DEADLINE            5  /* Earliest deadline first policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -208,6 +209,10 @@ struct sched_param
   int sched_ss_max_repl;                /* Maximum pending replenishments for
                                          * sporadic server. */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct timespec sched_dl_deadline;    /* Relative deadline for
+                                         * SCHED_DEADLINE. */
+#endif
 };
 
 /********************************************************************************
@@ -1,5 +1,5 @@
 /****************************************************************************
- * fs/vfs/fs_epoll.c
+ * include/sys/epoll.h
  *
  *   Copyright (C) 2015 Anton D. Kachalov. All rights reserved.
  *   Author: Anton D. Kachalov <mouse@mayc.ru>
@@ -40,6 +40,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -50,6 +53,21 @@
 #define EPOLL_CTL_DEL 2 /* Remove a file descriptor from the interface.  */
 #define EPOLL_CTL_MOD 3 /* Change file descriptor epoll_event structure.  */
 
+/* Input-only flags that modify the delivery of events.  These lie outside
+ * of the range of pollevent_t.
+ *
+ *   EPOLLONESHOT
+ *     Disable the file descriptor after one event is reported.  It must
+ *     then be re-armed with EPOLL_CTL_MOD.
+ *   EPOLLET
+ *     Edge-triggered:  Report an event only once each time that it is
+ *     signalled by the driver, rather than for as long as the condition
+ *     persists.
+ */
+
+#define EPOLLONESHOT  (1u << 30)
+#define EPOLLET       (1u << 31)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -78,33 +96,40 @@ enum EPOLL_EVENTS
 
 typedef union poll_data
 {
+  FAR void    *ptr;      /* Caller-defined pointer */
   int          fd;       /* The descriptor being polled */
+  uint32_t     u32;      /* Caller-defined value */
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* Input: Requested events; Output: Posted events */
+  epoll_data_t data;     /* Returned unmodified with each posted event */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
 int epoll_create(int size);
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
-int epoll_wait(int epfd, struct epoll_event *evs, int maxevents, int timeout);
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev);
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
+               int timeout);
 
 void epoll_close(int epfd);
 
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_SYS_EPOLL_H */
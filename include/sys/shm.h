@@ -54,6 +54,13 @@
 #define SHM_RDONLY 0x01 /* Attach read-only (else read-write) */
 #define SHM_RND    0x02 /* Round attach address to SHMLBA */
 
+/* Non-standard shmget() flag.  The segment is allocated from physically
+ * contiguous memory.  Segments of one MMU section or more are also section
+ * aligned so that they may be mapped using large pages.
+ */
+
+#define SHM_HUGETLB (1 << 13)
+
 /* Segment low boundary address multiple */
 
 #ifdef CONFIG_SHM_SHMLBA
@@ -124,6 +124,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* Wait for first message only.  */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -197,6 +198,17 @@
 #define SO_TYPE         15 /* Reports the socket type (get only).
                             * return: int
                             */
+#define SO_TIMESTAMP    16 /* Deliver the time of reception of each datagram
+                            * with recvmsg() as an SCM_TIMESTAMP control
+                            * message (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_REUSEPORT    17 /* Allow several sockets to bind the same port and
+                            * share its incoming traffic (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 
 /* Protocol-level socket operations. */
 
@@ -208,10 +220,11 @@
 #define SOL_L2CAP       6 /* See options in include/netpacket/bluetooth.h */
 #define SOL_SCO         7 /* See options in include/netpacket/bluetooth.h */
 #define SOL_RFCOMM      8 /* See options in include/netpacket/bluetooth.h */
+#define SOL_PACKET      9 /* See options in include/netpacket/packet.h */
 
 /* Protocol-level socket options may begin with this value */
 
-#define __SO_PROTOCOL  16
+#define __SO_PROTOCOL  18
 
 /* Values for the 'how' argument of shutdown() */
 
@@ -231,6 +244,10 @@
 
 /* Definitions associated with sendmsg/recvmsg */
 
+#define SCM_RIGHTS      0x01         /* cmsg_type: Array of descriptors */
+#define SCM_CREDENTIALS 0x02         /* cmsg_type: struct ucred of sender */
+#define SCM_TIMESTAMP   SO_TIMESTAMP /* cmsg_type: struct timeval of reception */
+
 #define CMSG_NXTHDR(mhdr, cmsg) cmsg_nxthdr((mhdr), (cmsg))
 
 #define CMSG_ALIGN(len) \
@@ -310,6 +327,25 @@ struct cmsghdr
   int cmsg_type;                /* Protocol-specific type */
 };
 
+/* Credentials of the sending process.  Passed in an SCM_CREDENTIALS
+ * control message over a Unix domain socket.
+ */
+
+struct ucred
+{
+  pid_t pid;                    /* Process ID of the sending process */
+  uid_t uid;                    /* User ID of the sending process */
+  gid_t gid;                    /* Group ID of the sending process */
+};
+
+/* Used with sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -378,6 +414,13 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec; /* Forward reference */
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -239,13 +239,18 @@
 
 #define SYS_clock                      (__SYS_clock + 0)
 #define SYS_clock_getres               (__SYS_clock + 1)
-#define SYS_clock_gettime              (__SYS_clock + 2)
-#define SYS_clock_settime              (__SYS_clock + 3)
+#ifndef CONFIG_CLOCK_USERTIME
+#  define SYS_clock_gettime            (__SYS_clock + 2)
+#  define __SYS_clock_settime          (__SYS_clock + 3)
+#else
+#  define __SYS_clock_settime          (__SYS_clock + 2)
+#endif
+#define SYS_clock_settime              __SYS_clock_settime
 #ifdef CONFIG_CLOCK_TIMEKEEPING
-#  define SYS_adjtime                  (__SYS_clock + 4)
-#  define __SYS_timers                 (__SYS_clock + 5)
+#  define SYS_adjtime                  (__SYS_clock_settime + 1)
+#  define __SYS_timers                 (__SYS_clock_settime + 2)
 #else
-#  define __SYS_timers                 (__SYS_clock + 4)
+#  define __SYS_timers                 (__SYS_clock_settime + 1)
 #endif
 
 /* The following are defined only if POSIX timers are supported */
@@ -286,14 +291,16 @@
 #  define SYS_write                    (__SYS_descriptors + 3)
 #  define SYS_pread                    (__SYS_descriptors + 4)
 #  define SYS_pwrite                   (__SYS_descriptors + 5)
+#  define SYS_readv                    (__SYS_descriptors + 6)
+#  define SYS_writev                   (__SYS_descriptors + 7)
 #  ifdef CONFIG_FS_AIO
-#    define SYS_aio_read               (__SYS_descriptors + 6)
-#    define SYS_aio_write              (__SYS_descriptors + 7)
-#    define SYS_aio_fsync              (__SYS_descriptors + 8)
-#    define SYS_aio_cancel             (__SYS_descriptors + 9)
-#    define __SYS_poll                 (__SYS_descriptors + 10)
+#    define SYS_aio_read               (__SYS_descriptors + 8)
+#    define SYS_aio_write              (__SYS_descriptors + 9)
+#    define SYS_aio_fsync              (__SYS_descriptors + 10)
+#    define SYS_aio_cancel             (__SYS_descriptors + 11)
+#    define __SYS_poll                 (__SYS_descriptors + 12)
 #  else
-#    define __SYS_poll                 (__SYS_descriptors + 6)
+#    define __SYS_poll                 (__SYS_descriptors + 8)
 #  endif
 #  ifndef CONFIG_DISABLE_POLL
 #    define SYS_poll                   __SYS_poll
@@ -371,9 +378,17 @@
 
 #  if defined(CONFIG_PIPES) && CONFIG_DEV_FIFO_SIZE > 0
 #    define SYS_mkfifo2                (__SYS_mkfifo2 + 0)
-#    define __SYS_fs_fdopen            (__SYS_mkfifo2 + 1)
+#    define __SYS_splice               (__SYS_mkfifo2 + 1)
+#  else
+#    define __SYS_splice               (__SYS_mkfifo2 + 0)
+#  endif
+
+#  if defined(CONFIG_PIPES)
+#    define SYS_splice                 (__SYS_splice + 0)
+#    define SYS_tee                    (__SYS_splice + 1)
+#    define __SYS_fs_fdopen            (__SYS_splice + 2)
 #  else
-#    define __SYS_fs_fdopen            (__SYS_mkfifo2 + 0)
+#    define __SYS_fs_fdopen            (__SYS_splice + 0)
 #  endif
 
 #  if CONFIG_NFILE_STREAMS > 0
@@ -537,10 +552,14 @@
 #  define SYS_listen                   (__SYS_network + 6)
 #  define SYS_recv                     (__SYS_network + 7)
 #  define SYS_recvfrom                 (__SYS_network + 8)
-#  define SYS_send                     (__SYS_network + 9)
-#  define SYS_sendto                   (__SYS_network + 10)
-#  define SYS_setsockopt               (__SYS_network + 11)
-#  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_recvmmsg                 (__SYS_network + 9)
+#  define SYS_recvmsg                  (__SYS_network + 10)
+#  define SYS_send                     (__SYS_network + 11)
+#  define SYS_sendmmsg                 (__SYS_network + 12)
+#  define SYS_sendmsg                  (__SYS_network + 13)
+#  define SYS_sendto                   (__SYS_network + 14)
+#  define SYS_setsockopt               (__SYS_network + 15)
+#  define SYS_socket                   (__SYS_network + 16)
 #else
 #  define SYS_socket                    __SYS_network
 #endif
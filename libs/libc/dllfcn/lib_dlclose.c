@@ -218,11 +218,36 @@ errout_with_lock:
 int dlclose(FAR void *handle)
 {
 #if defined(CONFIG_BUILD_FLAT)
+#ifdef CONFIG_LIBC_DLLFCN_SHARED
+  FAR struct module_s *modp = (FAR struct module_s *)handle;
+  int ret;
+
+  /* The module is only removed when the last dlopen() reference to it is
+   * closed.  The registry is kept locked so that no new reference can be
+   * taken while the module is being removed.
+   */
+
+  modlib_registry_lock();
+  ret = modlib_registry_verify(modp);
+  if (ret >= 0 && modp->refs > 1)
+    {
+      modp->refs--;
+      ret = OK;
+    }
+  else
+    {
+      ret = rmmod(handle);
+    }
+
+  modlib_registry_unlock();
+  return ret;
+#else
   /* In the FLAT build, a shared library is essentially the same as a kernel
    * module.
    */
 
   return rmmod(handle);
+#endif
 
 #elif defined(CONFIG_BUILD_PROTECTED)
   /* The PROTECTED build is equivalent to the FLAT build EXCEPT that there
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
+
 #include <stdlib.h>
 #include <string.h>
 #include <libgen.h>
@@ -366,6 +368,11 @@ errout_with_lock:
 FAR void *dlopen(FAR const char *file, int mode)
 {
 #if defined(CONFIG_BUILD_FLAT)
+#ifdef CONFIG_LIBC_DLLFCN_SHARED
+  FAR struct module_s *modp;
+  FAR char *modname;
+  struct stat buf;
+#endif
   FAR void *handle;
   FAR char *name;
 
@@ -392,9 +399,54 @@ FAR void *dlopen(FAR const char *file, int mode)
       return NULL;
     }
 
+#ifdef CONFIG_LIBC_DLLFCN_SHARED
+  /* Get the identity of the file so that we can tell if it is the same
+   * file as an already loaded module.
+   */
+
+  if (stat(file, &buf) < 0)
+    {
+      free(name);
+      return NULL;
+    }
+
+  modname = basename(name);
+  modlib_registry_lock();
+
+  /* Has this file already been loaded by dlopen() (and not modified since
+   * then)?  If so, just share the loaded copy.
+   */
+
+  modp = modlib_registry_find(modname);
+  if (modp != NULL && modp->refs > 0 && modp->mtime == buf.st_mtime &&
+      modp->fsize == buf.st_size)
+    {
+      modp->refs++;
+      handle = (FAR void *)modp;
+    }
+  else
+    {
+      /* No, install the file using the basename of the file as the module
+       * name.
+       */
+
+      handle = insmod(file, modname);
+      if (handle != NULL)
+        {
+          modp        = (FAR struct module_s *)handle;
+          modp->refs  = 1;
+          modp->mtime = buf.st_mtime;
+          modp->fsize = buf.st_size;
+        }
+    }
+
+  modlib_registry_unlock();
+#else
   /* Then install the file using the basename of the file as the module name. */
 
   handle = insmod(file, basename(name));
+#endif
+
   free(name);
   return handle;
 
@@ -185,6 +185,12 @@ int lib_rdflush(FAR FILE *stream);
 
 int lib_wrflush(FAR FILE *stream);
 
+/* Defined in lib_bufalloc.c */
+
+#ifdef CONFIG_STDIO_LAZYBUFFER
+void lib_bufalloc(FAR FILE *stream);
+#endif
+
 /* Defined in lib_sem.c */
 
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
@@ -216,6 +222,12 @@ float  lib_expif(size_t n);
 double lib_expi(size_t n);
 #endif
 
+/* Defined in lib_libsincosf.c */
+
+#ifdef CONFIG_LIBM
+float lib_sincosf(float x, int quadrant);
+#endif
+
 /* Defined in lib_libsqrtapprox.c */
 
 #ifdef CONFIG_LIBM
@@ -195,6 +195,7 @@ unsigned int lzf_decompress (FAR const void *const in_data,
       else /* back reference */
         {
           unsigned int len = ctrl >> 5;
+          uintptr_t dist;
 
           FAR uint8_t *ref = op - ((ctrl & 0x1f) << 8) - 1;
 
@@ -240,22 +241,41 @@ unsigned int lzf_decompress (FAR const void *const in_data,
               default:
                 len += 2;
 
-                if (op >= ref + len)
+                dist = op - ref;
+
+                if (dist >= len)
                   {
                     /* Disjunct areas */
 
-                    memcpy (op, ref, len);
+                    memcpy(op, ref, len);
                     op += len;
                   }
-                else
+                else if (dist == 1)
                   {
-                    /* Overlapping, use octet by octet copying */
+                    /* A run of one repeated octet */
 
-                    do
+                    memset(op, *ref, len);
+                    op += len;
+                  }
+                else
+                  {
+                    /* Overlapping.  Copy the repeating pattern of 'dist'
+                     * octets in disjunct pieces.  After each piece the
+                     * already written pattern is twice as long, so the
+                     * copy finishes in a few memcpy() calls instead of an
+                     * octet by octet loop.
+                     */
+
+                    while (len > dist)
                       {
-                        *op++ = *ref++;
+                        memcpy(op, ref, dist);
+                        op   += dist;
+                        len  -= dist;
+                        dist += dist;
                       }
-                    while (--len);
+
+                    memcpy(op, ref, len);
+                    op += len;
                   }
 
                 break;
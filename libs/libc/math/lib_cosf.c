@@ -31,11 +31,13 @@
 
 #include <math.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float cosf(float x)
 {
-  return sinf(x + M_PI_2_F);
+  return lib_sincosf(x, 1);
 }
@@ -29,29 +29,41 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
+#include <stdint.h>
 #include <math.h>
 
-#include "libc.h"
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ln(2) split so that k * LN2_HI is exact */
+
+#define LN2_HI      0.693359375F
+#define LN2_LO      -2.12194440e-4F
+#define LOG2E       1.44269504088896341F
+
+/* Beyond these, the result overflows or underflows to zero */
+
+#define EXPF_MAX    88.7228391F
+#define EXPF_MIN    -103.972084F
 
 /****************************************************************************
- * Private Data
+ * Private Functions
  ****************************************************************************/
 
-static float _flt_inv_fact[] =
+/* Return 2**n for -126 <= n <= 127 */
+
+static inline float expf_pow2(int n)
 {
-  1.0 / 1.0,                    /* 1/0! */
-  1.0 / 1.0,                    /* 1/1! */
-  1.0 / 2.0,                    /* 1/2! */
-  1.0 / 6.0,                    /* 1/3! */
-  1.0 / 24.0,                   /* 1/4! */
-  1.0 / 120.0,                  /* 1/5! */
-  1.0 / 720.0,                  /* 1/6! */
-  1.0 / 5040.0,                 /* 1/7! */
-  1.0 / 40320.0,                /* 1/8! */
-  1.0 / 362880.0,               /* 1/9! */
-  1.0 / 3628800.0,              /* 1/10! */
-};
+  union
+  {
+    uint32_t i;
+    float f;
+  } u;
+
+  u.i = (uint32_t)(n + 127) << 23;
+  return u.f;
+}
 
 /****************************************************************************
  * Public Functions
@@ -59,54 +71,52 @@ static float _flt_inv_fact[] =
 
 float expf(float x)
 {
-  size_t int_part;
-  bool invert;
-  float value;
-  float x0;
-  size_t i;
+  float k;
+  float p;
+  int n;
 
-  if (x == 0)
+  if (isnan(x))
     {
-      return 1;
+      return x;
     }
-  else if (x < 0)
+
+  if (x > EXPF_MAX)
     {
-      invert = true;
-      x = -x;
+      return INFINITY_F;
     }
-  else
+
+  if (x < EXPF_MIN)
     {
-      invert = false;
+      return 0.0F;
     }
 
-  /* Extract integer component */
-
-  int_part = (size_t) x;
-
-  /* set x to fractional component */
+  /* Reduce x to r = x - n * ln(2) with |r| <= ln(2) / 2 */
 
-  x -= (float)int_part;
+  k = x * LOG2E;
+  n = (int)(k >= 0.0F ? k + 0.5F : k - 0.5F);
+  k = (float)n;
+  x = (x - k * LN2_HI) - k * LN2_LO;
 
-  /* Perform Taylor series approximation with eleven terms */
+  /* Minimax polynomial for exp(r) on that range */
 
-  value = 0.0F;
-  x0 = 1.0F;
-  for (i = 0; i < 10; i++)
-    {
-      value += x0 * _flt_inv_fact[i];
-      x0 *= x;
-    }
+  p = 1.9875691500e-4F;
+  p = p * x + 1.3981999507e-3F;
+  p = p * x + 8.3334519073e-3F;
+  p = p * x + 4.1665795894e-2F;
+  p = p * x + 1.6666665459e-1F;
+  p = p * x + 5.0000001201e-1F;
+  p = p * x * x + x + 1.0F;
 
-  /* Multiply by exp of the integer component */
+  /* Scale by 2**n, in two steps if 2**n is not a normal number */
 
-  value *= lib_expif(int_part);
-
-  if (invert)
+  if (n > 127)
     {
-      return (1.0F / value);
+      return p * 2.0F * expf_pow2(n - 1);
     }
-  else
+  else if (n < -126)
     {
-      return value;
+      return p * expf_pow2(n + 64) * 5.42101086e-20F;  /* 2**-64 */
     }
+
+  return p * expf_pow2(n);
 }
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * libs/libc/math/lib_libsincosf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <math.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split into four parts.  The first three have at most 12
+ * significant bits so that multiplying them by the quadrant number is exact
+ * for |x| < SINCOSF_FLOAT_MAX (2**12 * pi/2).
+ */
+
+#define PIO2_1             1.5703125F
+#define PIO2_2             4.837512969970703125e-4F
+#define PIO2_3             7.54953362047672271729e-8F
+#define PIO2_4             2.56334406825708960298e-12F
+
+#define SINCOSF_FLOAT_MAX  6433.0F
+
+/* Beyond that, the reduction is done in double precision with pi/2 split
+ * into two parts.  The first has 33 significant bits so this is exact for
+ * |x| < SINCOSF_DOUBLE_MAX (2**20 * pi/2).
+ */
+
+#define PIO2_1D            1.57079632673412561417e+00
+#define PIO2_1TD           6.07710050650619224932e-11
+
+#define SINCOSF_DOUBLE_MAX 1647099.0F
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Minimax polynomials for sin and cos on [-pi/4, pi/4].  The maximum error
+ * of each is below one ULP.
+ */
+
+static inline float sinf_kernel(float x)
+{
+  float z = x * x;
+
+  return x + x * z * ((-1.9515295891e-4F * z + 8.3321608736e-3F) * z -
+                      1.6666654611e-1F);
+}
+
+static inline float cosf_kernel(float x)
+{
+  float z = x * x;
+
+  return 1.0F - 0.5F * z +
+         z * z * ((2.443315711809948e-5F * z - 1.388731625493765e-3F) * z +
+                  4.166664568298827e-2F);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_sincosf
+ *
+ * Description:
+ *   Return sin(x + quadrant * pi/2).  sinf() uses quadrant 0 and cosf()
+ *   quadrant 1.  Only single precision arithmetic is used.
+ *
+ ****************************************************************************/
+
+float lib_sincosf(float x, int quadrant)
+{
+  float k;
+  int n;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      return x - x;
+    }
+
+  /* Huge arguments are not reduced accurately.  Bring them into range
+   * first.
+   */
+
+  if (fabsf(x) >= SINCOSF_DOUBLE_MAX)
+    {
+      x = fmodf(x, 2 * M_PI_F);
+    }
+
+  /* Reduce x to r = x - n * pi/2 with |r| <= pi/4 */
+
+  k = x * (float)M_2_PI;
+  n = (int)(k >= 0.0F ? k + 0.5F : k - 0.5F);
+
+  if (fabsf(x) < SINCOSF_FLOAT_MAX)
+    {
+      k = (float)n;
+      x = (((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3) - k * PIO2_4;
+    }
+  else
+    {
+      x = (float)(((double)x - (double)n * PIO2_1D) -
+                  (double)n * PIO2_1TD);
+    }
+
+  switch ((n + quadrant) & 3)
+    {
+      default:
+      case 0:
+        return sinf_kernel(x);
+
+      case 1:
+        return cosf_kernel(x);
+
+      case 2:
+        return -sinf_kernel(x);
+
+      case 3:
+        return -cosf_kernel(x);
+    }
+}
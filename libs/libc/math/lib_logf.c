@@ -29,22 +29,17 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <math.h>
-#include <float.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define FLT_MAX_EXP_X   88.0F
+/* ln(2) split so that e * LN2_HI is exact */
 
-/* To avoid looping forever in particular corner cases, every LOGF_MAX_ITER
- * the error criteria is relaxed by a factor LOGF_RELAX_MULTIPLIER.
- * todo: might need to adjust the double floating point version too.
- */
-
-#define LOGF_MAX_ITER         10
-#define LOGF_RELAX_MULTIPLIER 2
+#define LN2_HI      0.693359375F
+#define LN2_LO      -2.12194440e-4F
 
 /****************************************************************************
  * Public Functions
@@ -56,59 +51,72 @@
 
 float logf(float x)
 {
+  union
+  {
+    float f;
+    uint32_t i;
+  } u;
+
+  float z;
   float y;
-  float y_old;
-  float ney;
-  float epsilon;
-  int   relax_factor;
-  int   iter;
+  int e;
 
-  y       = 0.0F;
-  y_old   = 1.0F;
-  epsilon = FLT_EPSILON;
+  if (isnan(x) || x == INFINITY_F)
+    {
+      return x;
+    }
 
-  iter         = 0;
-  relax_factor = 1;
+  if (x < 0.0F)
+    {
+      return NAN_F;
+    }
 
-  while (y > y_old + epsilon || y < y_old - epsilon)
+  if (x == 0.0F)
     {
-      y_old = y;
-      ney   = expf(-y);
-      y    -= 1.0F - x * ney;
-
-      if (y > FLT_MAX_EXP_X)
-        {
-          y = FLT_MAX_EXP_X;
-        }
-
-      if (y < -FLT_MAX_EXP_X)
-        {
-          y = -FLT_MAX_EXP_X;
-        }
-
-      epsilon = (fabsf(y) > 1.0F) ? fabsf(y) * FLT_EPSILON : FLT_EPSILON;
-
-      if (++iter >= LOGF_MAX_ITER)
-        {
-          relax_factor *= LOGF_RELAX_MULTIPLIER;
-          iter = 0;
-        }
-
-      if (relax_factor > 1)
-        {
-          epsilon *= relax_factor;
-        }
+      return -INFINITY_F;
     }
 
-  if (y == FLT_MAX_EXP_X)
+  /* Split x into 2**e * m with sqrt(1/2) <= m < sqrt(2).  Sub-normal
+   * numbers are normalized first.
+   */
+
+  u.f = x;
+  e   = 0;
+
+  if ((u.i >> 23) == 0)
     {
-      return INFINITY;
+      u.f *= 8388608.0F;  /* 2**23 */
+      e   -= 23;
     }
 
-  if (y == -FLT_MAX_EXP_X)
+  e    += (int)(u.i >> 23) - 127;
+  u.i   = (u.i & 0x007fffff) | 0x3f800000;
+
+  if (u.f > (float)M_SQRT2)
     {
-      return INFINITY;
+      u.f *= 0.5F;
+      e++;
     }
 
-  return y;
+  /* Minimax polynomial for log(1 + x) with x = m - 1 */
+
+  x = u.f - 1.0F;
+  z = x * x;
+
+  y = 7.0376836292e-2F;
+  y = y * x - 1.1514610310e-1F;
+  y = y * x + 1.1676998740e-1F;
+  y = y * x - 1.2420140846e-1F;
+  y = y * x + 1.4249322787e-1F;
+  y = y * x - 1.6668057665e-1F;
+  y = y * x + 2.0000714765e-1F;
+  y = y * x - 2.4999993993e-1F;
+  y = y * x + 3.3333331174e-1F;
+  y = y * x * z;
+
+  /* log(x) = e * ln(2) + log(m) */
+
+  y += (float)e * LN2_LO;
+  y -= 0.5F * z;
+  return x + y + (float)e * LN2_HI;
 }
@@ -37,5 +37,44 @@
 
 float powf(float b, float e)
 {
-  return expf(e * logf(b));
+  float r;
+  int odd;
+
+  if (e == 0.0F || b == 1.0F)
+    {
+      return 1.0F;
+    }
+
+  if (isnan(b) || isnan(e))
+    {
+      return NAN_F;
+    }
+
+  if (b == 0.0F)
+    {
+      return e > 0.0F ? 0.0F : INFINITY_F;
+    }
+
+  if (b > 0.0F)
+    {
+      return expf(e * logf(b));
+    }
+
+  /* A negative base is only valid with an integral exponent.  All floats
+   * of magnitude 2**24 or more are even integers.
+   */
+
+  odd = 0;
+  if (fabsf(e) < 16777216.0F)
+    {
+      if ((float)(long)e != e)
+        {
+          return NAN_F;
+        }
+
+      odd = (int)((long)e & 1);
+    }
+
+  r = expf(e * logf(-b));
+  return odd ? -r : r;
 }
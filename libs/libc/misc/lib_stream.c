@@ -86,9 +86,15 @@ void lib_stream_initialize(FAR struct task_group_s *group)
 
   (void)nxsem_init(&list->sl_sem, 0, 1);
 
-  /* Initialize each FILE structure */
+  /* Initialize each FILE structure.  Any others will be initialized when
+   * they are allocated.
+   */
 
-  for (i = 0; i < CONFIG_NFILE_STREAMS; i++)
+#if STREAMLIST_NEXTRA > 0
+  list->sl_extra = NULL;
+#endif
+
+  for (i = 0; i < STREAMLIST_NSTDIO; i++)
    {
       FAR struct file_struct *stream = &list->sl_streams[i];
 
@@ -145,7 +151,12 @@ void lib_stream_release(FAR struct task_group_s *group)
 
   for (i = 0; i < CONFIG_NFILE_STREAMS; i++)
     {
-      FAR struct file_struct *stream = &list->sl_streams[i];
+      FAR struct file_struct *stream = STREAMLIST_STREAM(list, i);
+
+      if (stream == NULL)
+        {
+          break;
+        }
 
       /* Destroy the semaphore that protects the IO buffer */
 
@@ -177,6 +188,24 @@ void lib_stream_release(FAR struct task_group_s *group)
         }
     }
 #endif
+
+#if STREAMLIST_NEXTRA > 0
+  /* Release the streams that were allocated on demand.  As above, there is
+   * nothing to do for an unprivileged group in the kernel build.
+   */
+
+  if (list->sl_extra != NULL)
+    {
+#ifdef CONFIG_BUILD_KERNEL
+      if ((group->tg_flags & GROUP_FLAG_PRIVILEGED) != 0)
+#endif
+        {
+          group_free(group, list->sl_extra);
+        }
+
+      list->sl_extra = NULL;
+    }
+#endif
 }
 
 #endif /* CONFIG_NFILE_STREAMS > 0 */
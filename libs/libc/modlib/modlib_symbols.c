@@ -401,9 +401,12 @@ int modlib_symvalue(FAR struct module_s *modp,
         if (symbol == NULL)
           {
             modlib_getsymtab(&symbol, &nsymbols);
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
             symbol = symtab_findorderedbyname(symbol, exportinfo.name,
                                               nsymbols);
+#elif defined(CONFIG_SYMTAB_HASHED)
+            symbol = symtab_findhashedbyname(symbol, exportinfo.name,
+                                             nsymbols);
 #else
             symbol = symtab_findbyname(symbol, exportinfo.name,
                                        nsymbols);
@@ -209,7 +209,10 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero records that the
+ *              hostname could not be resolved.
+ *   ttl      - The time-to-live of the answer in seconds.  Not used for
+ *              negative answers.
  *
  * Returned Value:
  *   None
@@ -218,7 +221,8 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr);
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -239,7 +243,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL means that the cache
+ *   recently learned that the hostname cannot be resolved.
  *
  ****************************************************************************/
 
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <assert.h>
@@ -66,7 +67,8 @@
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * with no addresses records that the name could not be resolved.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -74,9 +76,9 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
   time_t            ctime;      /* Creation time */
-#endif
+  uint32_t          life;       /* Life in seconds.  Zero:  Entry unused */
+  uint32_t          hash;       /* Hash of the name */
   char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
   uint8_t           naddr;      /* How many addresses per name */
   union dns_addr_u  addr[CONFIG_NETDB_DNSCLIENT_MAXIP]; /* Resolved address */
@@ -86,9 +88,6 @@ struct dns_cache_s
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
 /* This is the DNS resolver cache */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
@@ -97,6 +96,112 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_hash_name
+ *
+ * Description:
+ *   Return a hash of the part of the hostname that is kept in the cache.
+ *   Names are compared only when their hashes match.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_hash_name(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0';
+       i++)
+    {
+      hash = (hash ^ (uint8_t)hostname[i]) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: dns_time
+ *
+ * Description:
+ *   Get the current time, using CLOCK_MONOTONIC if possible
+ *
+ ****************************************************************************/
+
+static inline time_t dns_time(void)
+{
+  struct timespec now;
+
+  if (clock_gettime(DNS_CLOCK, &now) < 0)
+    {
+      return 0;
+    }
+
+  return now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_expired
+ *
+ * Description:
+ *   Return true if the entry is unused or its life has ended.
+ *
+ ****************************************************************************/
+
+static inline bool dns_expired(FAR struct dns_cache_s *entry, time_t now)
+{
+  /* REVISIT: Does not this calculation assume that the sizeof(time_t)
+   * is equal to the sizeof(uint32_t)?
+   */
+
+  return entry->life == 0 ||
+         (uint32_t)now - (uint32_t)entry->ctime >= entry->life;
+}
+
+/****************************************************************************
+ * Name: dns_lookup_entry
+ *
+ * Description:
+ *   Find the unexpired entry for the hostname.  Expired entries are
+ *   released along the way.  The caller holds the DNS semaphore.
+ *
+ ****************************************************************************/
+
+static FAR struct dns_cache_s *dns_lookup_entry(FAR const char *hostname,
+                                                uint32_t hash, time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
+    {
+      entry = &g_dns_cache[ndx];
+      if (entry->life == 0)
+        {
+          continue;
+        }
+
+      if (dns_expired(entry, now))
+        {
+          entry->life = 0;
+          continue;
+        }
+
+      /* Notice that because the names are truncated to
+       * CONFIG_NETDB_DNSCLIENT_NAMESIZE, this has the possibility of
+       * aliasing two names and returning the wrong entry from the cache.
+       */
+
+      if (entry->hash == hash &&
+          strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -110,7 +215,10 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses.  Zero records that the
+ *              hostname could not be resolved.
+ *   ttl      - The time-to-live of the answer in seconds.  Not used for
+ *              negative answers.
  *
  * Returned Value:
  *   None
@@ -118,64 +226,82 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 void dns_save_answer(FAR const char *hostname,
-                     FAR const union dns_addr_u *addr, int naddr)
+                     FAR const union dns_addr_u *addr, int naddr,
+                     uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  FAR struct dns_cache_s *oldest;
+  uint32_t hash;
+  time_t now;
   int ndx;
 
   naddr = MIN(naddr, CONFIG_NETDB_DNSCLIENT_MAXIP);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
 
-  /* Get exclusive access to the DNS cache */
+  /* Honor the TTL of the answer, limited by the configured life */
 
-  dns_semtake();
-
-  /* Get the index to the new head of the list */
+  if (naddr == 0)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC;
+    }
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  else if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+    }
+#endif
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  if (ttl == 0)
     {
-      next = 0;
+      return;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  hash = dns_hash_name(hostname);
+
+  /* Get exclusive access to the DNS cache */
+
+  dns_semtake();
+
+  /* Replace the entry for this name, else an unused or expired entry, else
+   * the oldest entry.
    */
 
-  if (next == g_dns_tail)
+  now   = dns_time();
+  entry = dns_lookup_entry(hostname, hash, now);
+  if (entry == NULL)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      oldest = &g_dns_cache[0];
+      for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
         {
-          tmp = 0;
+          entry = &g_dns_cache[ndx];
+          if (entry->life == 0)
+            {
+              break;
+            }
+
+          if ((uint32_t)now - (uint32_t)entry->ctime >
+              (uint32_t)now - (uint32_t)oldest->ctime)
+            {
+              oldest = entry;
+            }
         }
 
-      g_dns_tail = tmp;
+      if (ndx >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+        {
+          entry = oldest;
+        }
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  (void)clock_gettime(DNS_CLOCK, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  entry->ctime = now;
+  entry->life  = ttl;
+  entry->hash  = hash;
 
   strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
   entry->naddr = naddr;
 
-  /* Save the updated head index */
-
-  g_dns_head = next;
   dns_semgive();
 }
 
@@ -197,7 +323,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL means that the cache
+ *   recently learned that the hostname cannot be resolved.
  *
  ****************************************************************************/
 
@@ -205,13 +332,7 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
   int ret;
-#endif
-  int next;
-  int ndx;
 
   /* If DNS not initialized, no need to proceed */
 
@@ -225,75 +346,28 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
 
   dns_semtake();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  ret = clock_gettime(DNS_CLOCK, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  entry = dns_lookup_entry(hostname, dns_hash_name(hostname), dns_time());
+  if (entry == NULL)
     {
-      entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
-
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-        {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
+      ret = -ENOENT;
+    }
+  else if (entry->naddr == 0)
+    {
+      ret = -EADDRNOTAVAIL;
+    }
+  else
+    {
+      /* We have a match.  Make sure that the address will fit in the
+       * caller-provided buffer and return the resolved host addresses.
        */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
-        {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
-
-          g_dns_tail = next;
-        }
-      else
-#endif
-        {
-          /* The entry has not expired, check for a name match.  Notice that
-           * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
-           */
-
-          if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
-
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_semgive();
-              return OK;
-            }
-        }
+      *naddr = MIN(*naddr, entry->naddr);
+      memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+      ret = OK;
     }
 
-  ret = -ENOENT;
-
   dns_semgive();
   return ret;
 }
 
 #endif /* CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 */
-
@@ -48,6 +48,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
@@ -83,15 +84,6 @@
  * Private Types
  ****************************************************************************/
 
-struct dns_query_s
-{
-  int sd;                         /* DNS server socket */
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
-};
-
 /* Query info to check response against. */
 
 struct dns_query_info_s
@@ -113,6 +105,19 @@ struct dns_query_info_s
                                                   * format + NUL */
 };
 
+/* The query is sent to all name servers at once.  This holds the queries
+ * still waiting for an answer.
+ */
+
+struct dns_query_s
+{
+  int sd;                         /* DNS server socket */
+  int result;                     /* Explanation of the failure */
+  int nqueries;                   /* Number of outstanding queries */
+  FAR const char *hostname;       /* Hostname to lookup */
+  struct dns_query_info_s qinfo[CONFIG_NETDB_DNSCLIENT_MAXSERVERS];
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -335,17 +340,31 @@ static int dns_send_query(int sd, FAR const char *name,
  * Name: dns_recv_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Called when new UDP data arrives.  The response is matched against all
+ *   of the outstanding queries.
+ *
+ * Input Parameters:
+ *   query - The outstanding queries
+ *   addr  - The location to return the IP addresses
+ *   naddr - On entry, the count of addresses backing up the 'addr'
+ *           pointer.  On return, the actual count of returned addresses.
+ *   index - The location to return the index of the query that was
+ *           answered, or -1 if the response did not match any query.
+ *   ttl   - The location to return the smallest TTL of the addresses.
  *
  * Returned Value:
  *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   returned in all other cases.  -EADDRNOTAVAIL means that the name server
+ *   reported that the name does not exist or that it has no address of the
+ *   queried type.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
-                             FAR struct dns_query_info_s *qinfo)
+static int dns_recv_response(FAR struct dns_query_s *query,
+                             FAR union dns_addr_u *addr, FAR int *naddr,
+                             FAR int *index, FAR uint32_t *ttl)
 {
+  FAR struct dns_query_info_s *qinfo;
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
   FAR uint8_t *endofbuffer;
@@ -357,14 +376,18 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
   uint16_t nanswers;
   union dns_addr_u recvaddr;
   socklen_t raddrlen;
+  uint32_t anttl;
   int naddr_read;
   int errcode;
   int ret;
+  int i;
+
+  *index = -1;
 
   /* Receive the response */
 
   raddrlen = sizeof(recvaddr.addr);
-  ret      = _NX_RECVFROM(sd, buffer, RECV_BUFFER_SIZE, 0,
+  ret      = _NX_RECVFROM(query->sd, buffer, RECV_BUFFER_SIZE, 0,
                           &recvaddr.addr, &raddrlen);
   if (ret < 0)
     {
@@ -373,63 +396,65 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
       return errcode;
     }
 
-#ifdef CONFIG_NET_IPv4
-  /* Check for an IPv4 address */
-
-  if (recvaddr.addr.sa_family == AF_INET)
+  if (ret < sizeof(*hdr))
     {
-      if (memcmp(&recvaddr.ipv4.sin_addr, &qinfo->u.srv_ipv4,
-                 sizeof(recvaddr.ipv4.sin_addr)) != 0)
-        {
-          /* Not response from DNS server. */
+      /* DNS header can't fit in received data */
 
-          nerr("ERROR: DNS packet from wrong address\n");
-          return -EBADMSG;
-        }
+      nerr("ERROR: DNS response is too short\n");
+      return -EBADMSG;
+    }
 
-      if (recvaddr.ipv4.sin_port != qinfo->srv_port)
-        {
-          /* Not response from DNS server. */
+  hdr         = (FAR struct dns_header_s *)buffer;
+  endofbuffer = (FAR uint8_t*)buffer + ret;
 
-          nerr("ERROR: DNS packet from wrong port\n");
-          return -EBADMSG;
-        }
-    }
-#endif
-#ifdef CONFIG_NET_IPv6
-  /* Check for an IPv6 address */
+  /* Find the query that this answers:  The response must come from the
+   * server that the query was sent to and must carry the same ID.
+   */
 
-  if (recvaddr.addr.sa_family == AF_INET6)
+  for (i = 0; i < query->nqueries; i++)
     {
-      if (memcmp(&recvaddr.ipv6.sin6_addr, &qinfo->u.srv_ipv6,
-                 sizeof(recvaddr.ipv6.sin6_addr)) != 0)
+      qinfo = &query->qinfo[i];
+      if (hdr->id != qinfo->id)
         {
-          /* Not response from DNS server. */
-
-          nerr("ERROR: DNS packet from wrong address\n");
-          return -EBADMSG;
+          continue;
         }
 
-      if (recvaddr.ipv6.sin6_port != qinfo->srv_port)
+#ifdef CONFIG_NET_IPv4
+      /* Check for an IPv4 address */
+
+      if (recvaddr.addr.sa_family == AF_INET &&
+          memcmp(&recvaddr.ipv4.sin_addr, &qinfo->u.srv_ipv4,
+                 sizeof(recvaddr.ipv4.sin_addr)) == 0 &&
+          recvaddr.ipv4.sin_port == qinfo->srv_port)
         {
-          /* Not response from DNS server. */
+          break;
+        }
+#endif
+#ifdef CONFIG_NET_IPv6
+      /* Check for an IPv6 address */
 
-          nerr("ERROR: DNS packet from wrong port\n");
-          return -EBADMSG;
+      if (recvaddr.addr.sa_family == AF_INET6 &&
+          memcmp(&recvaddr.ipv6.sin6_addr, &qinfo->u.srv_ipv6,
+                 sizeof(recvaddr.ipv6.sin6_addr)) == 0 &&
+          recvaddr.ipv6.sin6_port == qinfo->srv_port)
+        {
+          break;
         }
-    }
 #endif
+    }
 
-  if (ret < sizeof(*hdr))
+  if (i >= query->nqueries)
     {
-      /* DNS header can't fit in received data */
+      /* Not response from DNS server, or a late response to an earlier
+       * query.
+       */
 
-      nerr("ERROR: DNS response is too short\n");
-      return -EILSEQ;
+      nerr("ERROR: DNS packet from wrong address or with wrong ID %d\n",
+           htons(hdr->id));
+      return -EBADMSG;
     }
 
-  hdr         = (FAR struct dns_header_s *)buffer;
-  endofbuffer = (FAR uint8_t*)buffer + ret;
+  *index = i;
 
   ninfo("ID %d\n", htons(hdr->id));
   ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
@@ -440,19 +465,16 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
 
   /* Check for error */
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
     {
-      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
+      ninfo("DNS reported that the name does not exist\n");
+      return -EADDRNOTAVAIL;
     }
 
-  /* Check for matching ID. */
-
-  if (hdr->id != qinfo->id)
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
-      nerr("ERROR: DNS wrong response ID (expected %d, got %d)\n",
-           htons(qinfo->id), htons(hdr->id));
-      return -EBADMSG;
+      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      return -EPROTO;
     }
 
   /* We only care about the question(s) and the answers. The authrr
@@ -541,6 +563,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
 
   ret = OK;
   naddr_read = 0;
+  *ttl = UINT32_MAX;
 
   for (; nanswers > 0; nanswers--)
     {
@@ -553,7 +576,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
           break;
         }
 
-      ans = (FAR struct dns_answer_s *)nameptr;
+      ans   = (FAR struct dns_answer_s *)nameptr;
+      anttl = ((uint32_t)htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]);
 
       ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x \n",
             htons(ans->type), htons(ans->class),
@@ -587,6 +611,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin_port         = 0;
               inaddr->sin_addr.s_addr  = ans->u.ipv4.s_addr;
 
+              *ttl = MIN(*ttl, anttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -624,6 +649,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
               inaddr->sin6_port        = 0;
               memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+              *ttl = MIN(*ttl, anttl);
               naddr_read++;
               if (naddr_read >= *naddr)
                 {
@@ -660,8 +686,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  * Name: dns_query_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Send the query for the hostname to this DNS server.  The response is
+ *   not waited for here, so that all name servers are queried at once.
  *
  * Input Parameters:
  *   arg      - Query arguements
@@ -669,9 +695,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int *naddr,
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal if no more queries can be
+ *   outstanding.  Zero is returned in all other cases.  The result field
+ *   of the query structure is set to a negated errno value indicate the
+ *   reason for the last failure (only).
  *
  ****************************************************************************/
 
@@ -679,196 +706,82 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-  FAR struct dns_query_info_s qinfo;
-  int retries;
+  uint16_t rectype;
   int ret;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
-  */
+#ifdef CONFIG_NET_IPv4
+  /* Is this an IPv4 address? */
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  if (addr->sa_family == AF_INET)
     {
-#ifdef CONFIG_NET_IPv4
-      /* Is this an IPv4 address? */
+      /* Yes.. verify the address size */
 
-      if (addr->sa_family == AF_INET)
+      if (addrlen < sizeof(struct sockaddr_in))
         {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
-
-          /* Send the IPv4 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_A, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv4 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
-            {
-              /* IPv4 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
-
-              dns_save_answer(query->hostname, query->addr,
-                              *query->naddr);
-#endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
-
-          /* Handle errors */
-
-          nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
-
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv4 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
-
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-              query->result = ret;
-              return 0;
-            }
+          nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
         }
-      else
+
+      rectype = DNS_RECTYPE_A;
+    }
+  else
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
-      /* Is this an IPv6 address? */
-
-      if (addr->sa_family == AF_INET6)
-        {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in6))
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
+  /* Is this an IPv6 address? */
 
-          /* Send the IPv6 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                              (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_AAAA, &qinfo);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * nameserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv6 response */
+  if (addr->sa_family == AF_INET6)
+    {
+      /* Yes.. verify the address size */
 
-          ret = dns_recv_response(query->sd, query->addr, query->naddr,
-                                  &qinfo);
-          if (ret >= 0)
-            {
-              /* IPv6 response received successfully */
+      if (addrlen < sizeof(struct sockaddr_in6))
+        {
+          /* Return zero to skip this address and try the next
+           * nameserver address in resolv.conf.
+           */
 
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
+          nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
+        }
 
-              dns_save_answer(query->hostname, query->addr, *query->naddr);
+      rectype = DNS_RECTYPE_AAAA;
+    }
+  else
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
-
-          /* Handle errors */
+    {
+      /* Unsupported address family. Return zero to continue the
+       * tranversal with the next nameserver address in resolv.conf.
+       */
 
-          nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
+      return 0;
+    }
 
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv6 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+  /* Send the query */
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next nameserver
-               * address in resolv.conf.
-               */
-
-              query->result = ret;
-              return 0;
-            }
-        }
-      else
-#endif
-        {
-           /* Unsupported address family. Return zero to continue the
-            * tranversal with the next nameserver address in resolv.conf.
-            */
+  ret = dns_send_query(query->sd, query->hostname,
+                       (FAR union dns_addr_u *)addr, rectype,
+                       &query->qinfo[query->nqueries]);
+  if (ret < 0)
+    {
+      /* Return zero to skip this address and try the next nameserver
+       * address in resolv.conf.
+       */
 
-           return 0;
-        }
+      nerr("ERROR: dns_send_query failed: %d\n", ret);
+      query->result = ret;
+      return 0;
     }
 
-  /* We tried and could not communicate with this nameserver. Perhaps it
-   * is down?  Return zero to continue with the next address in the
-   * resolv.conf file.
-   */
+  /* Stop the traversal when no more queries can be outstanding */
 
-  query->result = -ETIMEDOUT;
-  return 0;
+  query->nqueries++;
+  return query->nqueries >= CONFIG_NETDB_DNSCLIENT_MAXSERVERS ? 1 : 0;
 }
 
 /****************************************************************************
@@ -892,7 +805,9 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *     the returned addresses.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful.  -EADDRNOTAVAIL is
+ *   returned if the name servers reported that the hostname has no
+ *   address.
  *
  ****************************************************************************/
 
@@ -900,6 +815,11 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
   FAR struct dns_query_s query;
+  uint32_t ttl;
+  bool answered;
+  int maxaddr;
+  int retries;
+  int index;
   int ret;
 
   /* Set up the query info structure */
@@ -907,27 +827,105 @@ int dns_query(int sd, FAR const char *hostname, FAR union dns_addr_u *addr,
   query.sd       = sd;
   query.result   = -EADDRNOTAVAIL;
   query.hostname = hostname;
-  query.addr     = addr;
-  query.naddr    = naddr;
+  answered       = false;
+  maxaddr        = *naddr;
 
-  /* Perform the query. dns_foreach_nameserver() will return:
-   *
-   *  1 - The query was successful.
-   *  0 - Look up failed
-   * <0 - Some other failure (?, shouldn't happen)
+  /* Loop while receive timeout errors occur and there are remaining
+   * retries.
    */
 
-  ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
     {
-      /* The lookup was successful */
+      /* Send the query to all of the name servers.
+       * dns_foreach_nameserver() will return:
+       *
+       *  1 - No more queries can be outstanding
+       *  0 - All name servers were queried
+       * <0 - Some other failure (?, shouldn't happen)
+       */
+
+      query.nqueries = 0;
+      ret = dns_foreach_nameserver(dns_query_callback, &query);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Wait for answers.  The first address returned wins. */
+
+      while (query.nqueries > 0)
+        {
+          *naddr = maxaddr;
+          ret    = dns_recv_response(&query, addr, naddr, &index, &ttl);
+          if (ret >= 0)
+            {
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+              /* Save the answer in the DNS cache */
+
+              dns_save_answer(hostname, addr, *naddr, ttl);
+#endif
+              return OK;
+            }
+
+          if (ret == -EAGAIN)
+            {
+              /* Receive timeout.  Send the queries again. */
+
+              break;
+            }
 
-      ret = OK;
+          if (index >= 0)
+            {
+              /* This name server will not provide the address.  Stop
+               * waiting for it.
+               */
+
+              nerr("ERROR: dns_recv_response failed: %d\n", ret);
+
+              query.result = ret;
+              query.nqueries--;
+              query.qinfo[index] = query.qinfo[query.nqueries];
+
+              if (query.nqueries == 0)
+                {
+                  /* Every name server has answered */
+
+                  answered = true;
+                  goto errout;
+                }
+            }
+          else if (ret != -EBADMSG)
+            {
+              /* Some failure other than an unrelated packet */
+
+              query.result = ret;
+              break;
+            }
+        }
+
+      if (query.nqueries == 0)
+        {
+          /* No query could be sent */
+
+          goto errout;
+        }
+
+      /* We tried and could not communicate with the name servers.
+       * Perhaps they are down?
+       */
+
+      query.result = -ETIMEDOUT;
     }
-  else if (ret == 0)
+
+errout:
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  if (answered && query.result == -EADDRNOTAVAIL)
     {
-      ret = query.result;
+      /* Remember that the name could not be resolved */
+
+      dns_save_answer(hostname, NULL, 0, 0);
     }
+#endif
 
-  return ret;
+  return query.result;
 }
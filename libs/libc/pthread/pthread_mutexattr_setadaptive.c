@@ -1,7 +1,7 @@
 /****************************************************************************
- * libc/net/lib_recvmsg.c
+ * libs/libc/pthread/pthread_mutexattr_setadaptive.c
  *
- *   Copyright (C) 2007, 2008, 2012, 2008 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -38,11 +38,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
-
-#ifdef CONFIG_NET
-
-#include <sys/types.h>
-#include <sys/socket.h>
+#include <pthread.h>
 #include <errno.h>
 
 /****************************************************************************
@@ -50,40 +46,37 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Function: recvmsg
+ * Name: pthread_mutexattr_setadaptive_np
  *
  * Description:
- *   The recvmsg() call is identical to recvfrom() with a NULL from parameter.
+ *   Select whether a thread locking the mutex should spin while the holder
+ *   of the mutex is running on another CPU.  This is a non-standard
+ *   interface and requires CONFIG_PTHREAD_MUTEX_ADAPTIVE.
  *
- * Parameters:
- *   sockfd   Socket descriptor of socket
- *   buf      Buffer to receive data
- *   len      Length of buffer
- *   flags    Receive flags
+ * Input Parameters:
+ *   attr     - The mutex attributes in which to set the setting.
+ *   adaptive - Nonzero to spin before blocking; zero to block immediately.
  *
  * Returned Value:
- *  (see recvfrom)
+ *   0, if the setting was successfully set in 'attr', or
+ *   EINVAL, if 'attr' is NULL or adaptive mutexes are not supported.
  *
  * Assumptions:
  *
  ****************************************************************************/
 
-ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+int pthread_mutexattr_setadaptive_np(FAR pthread_mutexattr_t *attr,
+                                     int adaptive)
 {
-  FAR void *buf             = msg->msg_iov->iov_base;
-  FAR struct sockaddr *from = msg->msg_name;
-  FAR socklen_t *fromlen    = (FAR socklen_t *)&msg->msg_namelen;
-  size_t len                = msg->msg_iov->iov_len;
-
-  if (msg->msg_iovlen == 1)
+  if (attr == NULL)
     {
-      return recvfrom(sockfd, buf, len, flags, from, fromlen);
+      return EINVAL;
     }
-  else
-    {
-      set_errno(ENOTSUP);
-      return ERROR;
-    }
-}
 
-#endif /* CONFIG_NET */
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  attr->adaptive = (adaptive != 0);
+  return OK;
+#else
+  return adaptive != 0 ? EINVAL : OK;
+#endif
+}
@@ -46,6 +46,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <math.h>
 #include <assert.h>
 
@@ -67,6 +69,17 @@
 #  define MAX(a,b) (a > b ? a : b)
 #endif
 
+/* lib_fastcvt() handles values m * 2**e (m 53 bits) with
+ * DTOA_FAST_MINEXP <= e <= DTOA_FAST_MAXEXP, so that the integer part fits
+ * in 64 bits and the fraction times ten does too.  It handles up to
+ * DTOA_FAST_MAXPREC digits after the decimal point.
+ */
+
+#define DTOA_FAST_MINEXP  (-60)
+#define DTOA_FAST_MAXEXP  11
+#define DTOA_FAST_MAXPREC 20
+#define DTOA_FAST_BUFSIZE (20 + DTOA_FAST_MAXPREC + 2)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -105,6 +118,161 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
     }
 }
 
+/****************************************************************************
+ * Name: lib_fastcvt
+ *
+ * Description:
+ *   Do what __dtoa(value, 3, prec, ...) does for positive values within the
+ *   range described above, using only integer arithmetic and without
+ *   allocating memory.  The result is exact and rounds to nearest even as
+ *   does __dtoa.
+ *
+ * Returned Value:
+ *   The digit string (without leading or trailing zeros) is returned with
+ *   its end in 'rve' and the position of the decimal point in 'expt'.  NULL
+ *   is returned if the value is not handled here.
+ *
+ ****************************************************************************/
+
+static FAR char *lib_fastcvt(double value, int prec,
+                             FAR char buf[DTOA_FAST_BUFSIZE],
+                             FAR int *expt, FAR char **rve)
+{
+  union
+  {
+    double d;
+    uint64_t i;
+  } u;
+
+  uint64_t mantissa;
+  uint64_t intpart;
+  uint64_t frac;
+  uint64_t mask;
+  FAR char *digits;
+  FAR char *end;
+  FAR char *ptr;
+  bool roundup;
+  int shift;
+  int e;
+  int i;
+
+  u.d = value;
+  e   = (int)((u.i >> 52) & 0x7ff);
+  if (e == 0 || prec > DTOA_FAST_MAXPREC)
+    {
+      return NULL;
+    }
+
+  mantissa = (u.i & 0x000fffffffffffffull) | 0x0010000000000000ull;
+  e       -= 1075;
+
+  if (e < DTOA_FAST_MINEXP || e > DTOA_FAST_MAXEXP)
+    {
+      return NULL;
+    }
+
+  /* Split into the integer part and a binary fraction frac / 2**shift */
+
+  if (e >= 0)
+    {
+      intpart = mantissa << e;
+      frac    = 0;
+      shift   = 0;
+      mask    = 0;
+    }
+  else
+    {
+      shift   = -e;
+      mask    = ((uint64_t)1 << shift) - 1;
+      intpart = mantissa >> shift;
+      frac    = mantissa & mask;
+    }
+
+  /* Convert the integer part, right-justified in the first 21 bytes.  Byte
+   * zero is left free for a carry out of the rounding.
+   */
+
+  ptr = &buf[21];
+  while (intpart != 0)
+    {
+      *--ptr = '0' + (int)(intpart % 10);
+      intpart /= 10;
+    }
+
+  digits = ptr;
+  *expt  = &buf[21] - ptr;
+
+  /* Then the fractional digits */
+
+  end = &buf[21];
+  for (i = 0; i < prec; i++)
+    {
+      frac  *= 10;
+      *end++ = '0' + (int)(frac >> shift);
+      frac  &= mask;
+    }
+
+  /* Round to nearest, ties to even, on the exact remainder */
+
+  if (shift == 0 || frac < ((uint64_t)1 << (shift - 1)))
+    {
+      roundup = false;
+    }
+  else if (frac > ((uint64_t)1 << (shift - 1)))
+    {
+      roundup = true;
+    }
+  else
+    {
+      roundup = end > digits && ((end[-1] - '0') & 1) != 0;
+    }
+
+  if (roundup)
+    {
+      for (ptr = end; ; )
+        {
+          if (ptr == digits)
+            {
+              *--digits = '1';
+              (*expt)++;
+              break;
+            }
+
+          if (*--ptr != '9')
+            {
+              (*ptr)++;
+              break;
+            }
+
+          *ptr = '0';
+        }
+    }
+
+  /* Remove leading zeros (from a zero integer part) and trailing zeros */
+
+  while (digits < end && *digits == '0')
+    {
+      digits++;
+      (*expt)--;
+    }
+
+  while (end > digits && end[-1] == '0')
+    {
+      end--;
+    }
+
+  /* Leave a result that rounds to zero to __dtoa */
+
+  if (digits == end)
+    {
+      return NULL;
+    }
+
+  *end = '\0';
+  *rve = end;
+  return digits;
+}
+
 /****************************************************************************
  * Name: lib_dtoa
  *
@@ -130,6 +298,7 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
                      uint8_t flags, double value)
 {
+  char buf[DTOA_FAST_BUFSIZE];
   FAR char *digits;     /* String returned by __dtoa */
   FAR char *rve;        /* Points to the end of the return value */
   int  expt;            /* Integer value of exponent */
@@ -176,9 +345,21 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
       SET_NEGATE(flags);
     }
 
-  /* Perform the conversion */
+  /* Perform the conversion.  Most values can be converted quickly without
+   * the multiple precision arithmetic (and memory allocation) in __dtoa.
+   */
+
+  digits   = NULL;
+  if (value != 0.0)
+    {
+      digits = lib_fastcvt(value, prec, buf, &expt, &rve);
+    }
+
+  if (digits == NULL)
+    {
+      digits = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
+    }
 
-  digits   = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
   numlen   = rve - digits;
 
   /* Avoid precision error from missing trailing zeroes */
@@ -76,7 +76,12 @@ int lib_flushall(FAR struct streamlist *list)
       stream_semtake(list);
       for (i = 0; i < CONFIG_NFILE_STREAMS; i++)
         {
-          FILE *stream = &list->sl_streams[i];
+          FILE *stream = STREAMLIST_STREAM(list, i);
+
+          if (stream == NULL)
+            {
+              break;
+            }
 
           /* If the stream is open (i.e., assigned a non-negative file
            * descriptor) and opened for writing, then flush all of the pending
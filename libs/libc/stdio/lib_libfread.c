@@ -99,6 +99,12 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
         }
 #endif
 
+#ifdef CONFIG_STDIO_LAZYBUFFER
+      /* Allocate the I/O buffer if this is the first use of the stream */
+
+      lib_bufalloc(stream);
+
+#endif
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
       /* Is there an I/O buffer? */
 
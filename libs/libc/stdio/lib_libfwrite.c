@@ -82,6 +82,12 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
       goto errout;
     }
 
+#ifdef CONFIG_STDIO_LAZYBUFFER
+  /* Allocate the I/O buffer if this is the first use of the stream */
+
+  lib_bufalloc(stream);
+
+#endif
   /* If there is no I/O buffer, then output data immediately */
 
   if (stream->fs_bufstart == NULL)
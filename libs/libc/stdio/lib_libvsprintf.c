@@ -197,10 +197,45 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t justify,
 
 static const char g_nullstring[] = "(null)";
 
+/* Pairs of decimal digits "00" through "99" used to convert two digits of
+ * an integer per division.
+ */
+
+static const char g_digitpairs[] =
+  "00010203040506070809101112131415161718192021222324"
+  "25262728293031323334353637383940414243444546474849"
+  "50515253545556575859606162636465666768697071727374"
+  "75767778798081828384858687888990919293949596979899";
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: putstring
+ *
+ * Description:
+ *   Output a block of characters using the stream's block output method,
+ *   if it has one, or one character at a time if it does not.
+ *
+ ****************************************************************************/
+
+static void putstring(FAR struct lib_outstream_s *obj, FAR const char *buf,
+                      int len)
+{
+  if (obj->puts != NULL)
+    {
+      (void)obj->puts(obj, buf, len);
+    }
+  else
+    {
+      while (len-- > 0)
+        {
+          obj->put(obj, *buf++);
+        }
+    }
+}
+
 /* Include floating point functions */
 
 #ifdef CONFIG_LIBC_FLOATINGPOINT
@@ -271,19 +306,31 @@ static int getpsize(uint8_t flags, FAR void *p)
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 {
   char buf[16];
-  int i = 0;
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
+
+  /* Convert two digits at a time, filling the buffer from the end */
 
-  do
+  while (n >= 100)
     {
-      buf[i++] = n % 10 + '0';
-      n /= 10;
+      pair  = (unsigned int)(n % 100) << 1;
+      n    /= 100;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
     }
-  while (n > 0);
 
-  while (i > 0)
+  if (n >= 10)
     {
-      obj->put(obj, buf[--i]);
+      pair   = (unsigned int)n << 1;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
     }
+  else
+    {
+      *--ptr = (char)n + '0';
+    }
+
+  putstring(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -520,19 +567,31 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
   char buf[32];
-  int i = 0;
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
 
-  do
+  /* Convert two digits at a time, filling the buffer from the end */
+
+  while (n >= 100)
     {
-      buf[i++] = n % 10 + '0';
-      n /= 10;
+      pair  = (unsigned int)(n % 100) << 1;
+      n    /= 100;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
     }
-  while (n > 0);
 
-  while (i > 0)
+  if (n >= 10)
+    {
+      pair   = (unsigned int)n << 1;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
+    }
+  else
     {
-      obj->put(obj, buf[--i]);
+      *--ptr = (char)n + '0';
     }
+
+  putstring(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -750,19 +809,31 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
   char buf[32];
-  int i = 0;
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
+
+  /* Convert two digits at a time, filling the buffer from the end */
 
-  do
+  while (n >= 100)
     {
-      buf[i++] = n % 10 + '0';
-      n /= 10;
+      pair  = (unsigned int)(n % 100) << 1;
+      n    /= 100;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
     }
-  while (n > 0);
 
-  while (i > 0)
+  if (n >= 10)
     {
-      obj->put(obj, buf[--i]);
+      pair   = (unsigned int)n << 1;
+      *--ptr = g_digitpairs[pair + 1];
+      *--ptr = g_digitpairs[pair];
     }
+  else
+    {
+      *--ptr = (char)n + '0';
+    }
+
+  putstring(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -1199,9 +1270,24 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
+#ifdef CONFIG_ARCH_ROMGETC
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
+#else
+           /* Output the run of regular characters up to the next format
+            * specifier (or through the next newline) as one block.
+            */
+
+           FAR const char *run = src;
+
+           while (*src != '\n' && src[1] != '\0' && src[1] != '%')
+             {
+               src++;
+             }
+
+           putstring(obj, run, src - run + 1);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1364,20 +1450,10 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           swidth = (IS_HASDOT(flags) && trunc >= 0)
                       ? strnlen(ptmp, trunc) : strlen(ptmp);
           prejustify(obj, FMT_CHAR, justify, 0, width, swidth, 0);
-          left = swidth;
 
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-              if (left-- <= 0)
-                {
-                  break;
-                }
-
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          putstring(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
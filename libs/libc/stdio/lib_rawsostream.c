@@ -88,6 +88,53 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (errcode == EINTR);
 }
 
+/****************************************************************************
+ * Name: rawoutstream_puts
+ ****************************************************************************/
+
+static int rawoutstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_rawoutstream_s *rthis = (FAR struct lib_rawoutstream_s *)this;
+  FAR const char *src = (FAR const char *)buf;
+  int remaining = len;
+  int nwritten;
+  int errcode;
+
+  DEBUGASSERT(this && rthis->fd >= 0);
+
+  /* Loop until all of the data has been transferred or until an
+   * irrecoverable error occurs.
+   */
+
+  while (remaining > 0)
+    {
+      nwritten = _NX_WRITE(rthis->fd, src, remaining);
+      if (nwritten > 0)
+        {
+          this->nput += nwritten;
+          src        += nwritten;
+          remaining  -= nwritten;
+          continue;
+        }
+
+      /* The only expected error is EINTR, meaning that the write operation
+       * was awakened by a signal.  Zero would not be a valid return value
+       * from _NX_WRITE().
+       */
+
+      errcode = _NX_GETERRNO(nwritten);
+      DEBUGASSERT(nwritten < 0);
+
+      if (errcode != EINTR)
+        {
+          break;
+        }
+    }
+
+  return len - remaining;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -112,6 +159,7 @@ static void rawoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_rawoutstream(FAR struct lib_rawoutstream_s *outstream, int fd)
 {
   outstream->public.put   = rawoutstream_putc;
+  outstream->public.puts  = rawoutstream_puts;
   outstream->public.flush = lib_noflush;
   outstream->public.nput  = 0;
   outstream->fd           = fd;
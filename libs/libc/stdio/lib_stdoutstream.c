@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -78,6 +79,51 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static int stdoutstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
+  int result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Loop until the data is successfully transferred or an irrecoverable
+   * error occurs.
+   */
+
+  do
+    {
+      result = lib_fwrite(buf, len, sthis->stream);
+      if (result >= 0)
+        {
+          this->nput += result;
+
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+          /* Honor line buffering as fputc() would if a newline was output */
+
+          if ((sthis->stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+              memchr(buf, '\n', result) != NULL)
+            {
+              (void)lib_fflush(sthis->stream, true);
+            }
+#endif
+
+          return result;
+        }
+
+      /* EINTR (meaning that lib_fwrite was interrupted by a signal) is the
+       * only recoverable error.
+       */
+    }
+  while (get_errno() == EINTR);
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -118,7 +164,8 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
 {
   /* Select the put operation */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
@@ -55,6 +55,10 @@
 
 #define min(a, b)  (a) < (b) ? a : b
 
+/* Arrays smaller than this are sorted by straight insertion */
+
+#define QSORT_INSERTION_THRESHOLD 7
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof (TYPE); \
@@ -93,6 +97,11 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
                              CODE int (*compar)(FAR const void *,
                              FAR const void *));
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *));
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int depth);
 
 /****************************************************************************
  * Private Functions
@@ -120,50 +129,83 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: heapsort
+ *
+ * Description:
+ *   Sort in O(n log n) time with no further recursion.  This is used when
+ *   the quicksort partitioning has gone too deep, as can happen with some
+ *   input patterns.
+ *
  ****************************************************************************/
 
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *))
+{
+  FAR char *parent;
+  FAR char *child;
+  size_t start;
+  size_t end;
+  size_t root;
+  size_t i;
+  int swaptype;
+
+  SWAPINIT(base, width);
+
+  /* Build a max-heap, then repeatedly move the largest element to the end
+   * of the array.
+   */
+
+  start = nel / 2;
+  end   = nel;
+
+  while (end > 1)
+    {
+      if (start > 0)
+        {
+          start--;
+        }
+      else
+        {
+          end--;
+          swap(base, base + end * width);
+        }
+
+      /* Sift the element at 'start' down into the heap of 'end' elements */
+
+      for (root = start; (i = 2 * root + 1) < end; root = i)
+        {
+          child = base + i * width;
+          if (i + 1 < end && compar(child, child + width) < 0)
+            {
+              i++;
+              child += width;
+            }
+
+          parent = base + root * width;
+          if (compar(parent, child) >= 0)
+            {
+              break;
+            }
+
+          swap(parent, child);
+        }
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: introsort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
- *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   Quicksort the array, recursing into the smaller partition and iterating
+ *   over the larger one so that the stack depth is O(log n).  When 'depth'
+ *   partitioning steps have been taken without finishing, the remainder is
+ *   heap sorted so that the worst case is O(n log n).
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -172,126 +214,205 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t d;
+  size_t r;
+  size_t s;
   int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
+  int cmp;
 
-loop:
   SWAPINIT(base, width);
-  swap_cnt = 0;
 
-  if (nel < 7)
+  for (; ; )
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nel < QSORT_INSERTION_THRESHOLD)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          for (pm = (FAR char *)base + width;
+               pm < (FAR char *)base + nel * width;
+               pm += width)
             {
-              swap(pl, pl - width);
+              for (pl = pm;
+                   pl > (FAR char *)base && compar(pl - width, pl) > 0;
+                   pl -= width)
+                {
+                  swap(pl, pl - width);
+                }
             }
-        }
 
-      return;
-  }
+          return;
+        }
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
-      pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      if (depth-- <= 0)
         {
-          d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          heapsort(base, nel, width, compar);
+          return;
         }
 
-      pm = med3(pl, pm, pn, compar);
-    }
-
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Select the pivot:  The median of three, or the pseudo-median of
+       * nine for larger arrays.
+       */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      pm = (FAR char *)base + (nel / 2) * width;
+      if (nel > QSORT_INSERTION_THRESHOLD)
         {
-          if (r == 0)
+          pl = base;
+          pn = (FAR char *)base + (nel - 1) * width;
+          if (nel > 40)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              d  = (nel / 8) * width;
+              pl = med3(pl, pl + d, pl + 2 * d, compar);
+              pm = med3(pm - d, pm, pm + d, compar);
+              pn = med3(pn - 2 * d, pn - d, pn, compar);
             }
 
-          pb += width;
+          pm = med3(pl, pm, pn, compar);
         }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+      /* Three-way partition.  Elements equal to the pivot are collected at
+       * both ends and then swapped into the middle.
+       */
+
+      swap(base, pm);
+      pa = pb = (FAR char *)base + width;
+
+      pc = pd = (FAR char *)base + (nel - 1) * width;
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (cmp = compar(pb, base)) <= 0)
+            {
+              if (cmp == 0)
+                {
+                  swap(pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
+            }
+
+          while (pb <= pc && (cmp = compar(pc, base)) >= 0)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              if (cmp == 0)
+                {
+                  swap(pc, pd);
+                  pd -= width;
+                }
+
+              pc -= width;
             }
 
+          if (pb > pc)
+            {
+              break;
+            }
+
+          swap(pb, pc);
+          pb += width;
           pc -= width;
         }
 
-      if (pb > pc)
-        {
-          break;
-        }
+      pn = (FAR char *)base + nel * width;
+      r  = min(pa - (FAR char *)base, pb - pa);
+      vecswap(base, pb - r, r);
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
+      r  = min(pd - pc, pn - pd - width);
+      vecswap(pb, pn - r, r);
 
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+      /* 'r' is the size of the lower partition, 's' of the upper */
+
+      r = pb - pa;
+      s = pd - pc;
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (r < s)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          if (r > width)
             {
-              swap(pl, pl - width);
+              introsort(base, r / width, width, compar, depth);
             }
+
+          if (s <= width)
+            {
+              return;
+            }
+
+          base = pn - s;
+          nel  = s / width;
         }
+      else
+        {
+          if (s > width)
+            {
+              introsort(pn - s, s / width, width, compar, depth);
+            }
+
+          if (r <= width)
+            {
+              return;
+            }
 
-      return;
+          nel = r / width;
+        }
     }
+}
 
-  pn = (FAR char *)base + nel * width;
-  r  = min(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
-  r  = min(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   This version is an introsort:  The partitioning depth is limited and
+ *   a heap sort is used beyond that, so the worst case is O(n log n).
+ *
+ ****************************************************************************/
 
-  if ((r = pb - pa) > width)
-    {
-      qsort(base, r / width, width, compar);
-    }
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth;
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+  /* Allow 2 * log2(nel) levels of partitioning before falling back to the
+   * heap sort.
+   */
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  for (depth = 0, n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  introsort(base, nel, width, compar, depth);
 }
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
@@ -65,6 +67,27 @@
 #  define __DBL_MAX_EXP__ (1024)
 #endif
 
+/* Up to this many significant digits are accumulated exactly in a 64-bit
+ * integer.
+ */
+
+#define STRTOD_MAXDIGITS 19
+
+/* Integers up to 2**53 and powers of ten up to 1e22 are exact doubles */
+
+#define STRTOD_MAXEXACT  ((uint64_t)1 << 53)
+#define STRTOD_MAXPOW10  22
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const double g_pow10[STRTOD_MAXPOW10 + 1] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -89,9 +112,12 @@ static inline int is_real(double x)
 
 double strtod(FAR const char *str, FAR char **endptr)
 {
+  uint64_t mantissa;
   double number;
+  bool truncated;
   int exponent;
   int negative;
+  int negexp;
   FAR char *p = (FAR char *) str;
   double p10;
   int n;
@@ -121,16 +147,34 @@ double strtod(FAR const char *str, FAR char **endptr)
       break;
     }
 
-  number       = 0.;
+  mantissa     = 0;
+  truncated    = false;
   exponent     = 0;
   num_digits   = 0;
   num_decimals = 0;
 
-  /* Process string of digits */
+  /* Process string of digits.  Leading zeros are not significant and
+   * digits beyond the first STRTOD_MAXDIGITS significant ones are only
+   * counted.
+   */
 
+  n = 0;
   while (isdigit(*p))
     {
-      number = number * 10. + (*p - '0');
+      if (n < STRTOD_MAXDIGITS)
+        {
+          mantissa = mantissa * 10 + (*p - '0');
+          if (mantissa != 0)
+            {
+              n++;
+            }
+        }
+      else
+        {
+          truncated |= (*p != '0');
+          exponent++;
+        }
+
       p++;
       num_digits++;
     }
@@ -143,10 +187,23 @@ double strtod(FAR const char *str, FAR char **endptr)
 
       while (isdigit(*p))
         {
-          number = number * 10. + (*p - '0');
+          if (n < STRTOD_MAXDIGITS)
+            {
+              mantissa = mantissa * 10 + (*p - '0');
+              if (mantissa != 0)
+                {
+                  n++;
+                }
+
+              num_decimals++;
+            }
+          else
+            {
+              truncated |= (*p != '0');
+            }
+
           p++;
           num_digits++;
-          num_decimals++;
         }
 
       exponent -= num_decimals;
@@ -159,24 +216,17 @@ double strtod(FAR const char *str, FAR char **endptr)
       goto errout;
     }
 
-  /* Correct for sign */
-
-  if (negative)
-    {
-      number = -number;
-    }
-
   /* Process an exponent string */
 
   if (*p == 'e' || *p == 'E')
     {
       /* Handle optional sign */
 
-      negative = 0;
+      negexp = 0;
       switch (*++p)
         {
         case '-':
-          negative = 1;   /* Fall through to increment pos */
+          negexp = 1;     /* Fall through to increment pos */
           /* FALLTHROUGH */
         case '+':
           p++;
@@ -194,7 +244,7 @@ double strtod(FAR const char *str, FAR char **endptr)
           p++;
         }
 
-      if (negative)
+      if (negexp)
         {
           exponent -= n;
         }
@@ -204,15 +254,51 @@ double strtod(FAR const char *str, FAR char **endptr)
         }
     }
 
+  number = (double)mantissa;
+  if (negative)
+    {
+      number = -number;
+    }
+
+  if (mantissa == 0)
+    {
+      goto errout;
+    }
+
   if (exponent < __DBL_MIN_EXP__ ||
       exponent > __DBL_MAX_EXP__)
     {
       set_errno(ERANGE);
-      number = infinite;
+      number = exponent < 0 ? 0.0 : infinite;
+      if (negative)
+        {
+          number = -number;
+        }
+
+      goto errout;
+    }
+
+  /* If both the mantissa and the power of ten are exact doubles, then a
+   * single multiply or divide gives the correctly rounded result.  This
+   * covers most numbers in practice.
+   */
+
+  if (!truncated && mantissa <= STRTOD_MAXEXACT &&
+      exponent >= -STRTOD_MAXPOW10 && exponent <= STRTOD_MAXPOW10)
+    {
+      if (exponent < 0)
+        {
+          number /= g_pow10[-exponent];
+        }
+      else
+        {
+          number *= g_pow10[exponent];
+        }
+
       goto errout;
     }
 
-  /* Scale the result */
+  /* Otherwise scale the result by repeated squaring */
 
   p10 = 10.;
   n = exponent;
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,12 +62,36 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_LIBC_ARCH_MEMCHR
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
   if (s)
     {
+#ifdef CONFIG_STRING_OPTSPEED
+      FAR const uintptr_t *w;
+      uintptr_t mask = STRING_REPEAT(c);
+
+      /* Check one byte at a time until the pointer is word aligned */
+
+      for (; n > 0 && !STRING_ALIGNED(p); n--, p++)
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+        }
+
+      /* Then skip whole words that do not contain 'c' */
+
+      for (w = (FAR const uintptr_t *)p;
+           n >= STRING_WORDSIZE && !STRING_HASZERO(*w ^ mask);
+           n -= STRING_WORDSIZE, w++);
+
+      p = (FAR const unsigned char *)w;
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -78,3 +105,4 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   return NULL;
 }
+#endif
@@ -39,8 +39,16 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE sizeof(uintptr_t)
+#define WORDMASK (WORDSIZE - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -54,6 +62,62 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+  /* This version is optimized for speed.  If the source and destination
+   * have the same alignment, copy whole words, four at a time, once the
+   * destination is aligned.  Otherwise, or for the tail, copy bytes.
+   */
+
+  if (n >= 2 * WORDSIZE &&
+      (((uintptr_t)pout ^ (uintptr_t)pin) & WORDMASK) == 0)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+
+      /* Align to a word boundary */
+
+      while (((uintptr_t)pout & WORDMASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+      win  = (FAR const uintptr_t *)pin;
+
+      /* Loop while there are at least four words left to be copied */
+
+      while (n >= 4 * WORDSIZE)
+        {
+          uintptr_t w0 = win[0];
+          uintptr_t w1 = win[1];
+          uintptr_t w2 = win[2];
+          uintptr_t w3 = win[3];
+
+          wout[0] = w0;
+          wout[1] = w1;
+          wout[2] = w2;
+          wout[3] = w3;
+
+          wout += 4;
+          win  += 4;
+          n    -= 4 * WORDSIZE;
+        }
+
+      /* Then any remaining whole words */
+
+      while (n >= WORDSIZE)
+        {
+          *wout++ = *win++;
+          n      -= WORDSIZE;
+        }
+
+      pout = (FAR unsigned char *)wout;
+      pin  = (FAR unsigned char *)win;
+    }
+#endif
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
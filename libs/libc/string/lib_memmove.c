@@ -39,8 +39,16 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORDSIZE sizeof(uintptr_t)
+#define WORDMASK (WORDSIZE - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,6 +64,31 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_MEMCPY_OPTSPEED
+      /* If the source and destination have the same alignment, copy whole
+       * words forward.  This is safe because the destination is below the
+       * source:  each word is read before it can be overwritten.
+       */
+
+      if (count >= 2 * WORDSIZE &&
+          (((uintptr_t)tmp ^ (uintptr_t)s) & WORDMASK) == 0)
+        {
+          while (((uintptr_t)tmp & WORDMASK) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          while (count >= WORDSIZE)
+            {
+              *(FAR uintptr_t *)tmp = *(FAR uintptr_t *)s;
+              tmp   += WORDSIZE;
+              s     += WORDSIZE;
+              count -= WORDSIZE;
+            }
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -66,6 +99,28 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_MEMCPY_OPTSPEED
+      /* Likewise, copy whole words backward from the end */
+
+      if (count >= 2 * WORDSIZE &&
+          (((uintptr_t)tmp ^ (uintptr_t)s) & WORDMASK) == 0)
+        {
+          while (((uintptr_t)tmp & WORDMASK) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          while (count >= WORDSIZE)
+            {
+              tmp   -= WORDSIZE;
+              s     -= WORDSIZE;
+              count -= WORDSIZE;
+              *(FAR uintptr_t *)tmp = *(FAR uintptr_t *)s;
+            }
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
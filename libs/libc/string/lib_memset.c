@@ -72,7 +72,7 @@ FAR void *memset(FAR void *s, int c, size_t n)
    */
 
   uintptr_t addr  = (uintptr_t)s;
-  uint16_t  val16 = ((uint16_t)c << 8) | (uint16_t)c;
+  uint16_t  val16 = ((uint16_t)(uint8_t)c << 8) | (uint16_t)(uint8_t)c;
   uint32_t  val32 = ((uint32_t)val16 << 16) | (uint32_t)val16;
 #ifdef CONFIG_MEMSET_64BIT
   uint64_t  val64 = ((uint64_t)val32 << 32) | (uint64_t)val32;
@@ -107,7 +107,19 @@ FAR void *memset(FAR void *s, int c, size_t n)
             }
 
 #ifndef CONFIG_MEMSET_64BIT
-          /* Loop while there are at least 32-bits left to be written */
+          /* Loop while there are at least four 32-bit words left to be
+           * written, then one 32-bit word at a time.
+           */
+
+          while (n >= 16)
+            {
+              ((FAR uint32_t *)addr)[0] = val32;
+              ((FAR uint32_t *)addr)[1] = val32;
+              ((FAR uint32_t *)addr)[2] = val32;
+              ((FAR uint32_t *)addr)[3] = val32;
+              addr += 16;
+              n    -= 16;
+            }
 
           while (n >= 4)
             {
@@ -131,7 +143,19 @@ FAR void *memset(FAR void *s, int c, size_t n)
                   n    -= 4;
                 }
 
-              /* Loop while there are at least 64-bits left to be written */
+              /* Loop while there are at least four 64-bit words left to be
+               * written, then one 64-bit word at a time.
+               */
+
+              while (n >= 32)
+                {
+                  ((FAR uint64_t *)addr)[0] = val64;
+                  ((FAR uint64_t *)addr)[1] = val64;
+                  ((FAR uint64_t *)addr)[2] = val64;
+                  ((FAR uint64_t *)addr)[3] = val64;
+                  addr += 32;
+                  n    -= 32;
+                }
 
               while (n >= 8)
                 {
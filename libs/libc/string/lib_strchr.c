@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,9 +67,37 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_STRING_OPTSPEED
+      FAR const uintptr_t *w;
+      uintptr_t mask = STRING_REPEAT(c);
+
+      /* Check one byte at a time until the pointer is word aligned */
+
+      for (; !STRING_ALIGNED(s); s++)
+        {
+          if (*s == (char)c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      /* Then skip whole words that contain neither 'c' nor the NUL */
+
+      for (w = (FAR const uintptr_t *)s;
+           !STRING_HASZERO(*w) && !STRING_HASZERO(*w ^ mask);
+           w++);
+
+      s = (FAR const char *)w;
+#endif
+
       for (; ; s++)
         {
-          if (*s == c)
+          if (*s == (char)c)
             {
               return (FAR char *)s;
             }
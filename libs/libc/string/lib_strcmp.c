@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,6 +52,41 @@
 int strcmp(FAR const char *cs, FAR const char *ct)
 {
   register signed char result;
+
+#ifdef CONFIG_STRING_OPTSPEED
+  /* If both strings have the same alignment, compare whole words once
+   * they are aligned.  Stop at the first word that differs or that
+   * contains the terminating NUL; the byte loop below then finds the
+   * result.
+   */
+
+  if ((((uintptr_t)cs ^ (uintptr_t)ct) & STRING_WORDMASK) == 0)
+    {
+      FAR const uintptr_t *wcs;
+      FAR const uintptr_t *wct;
+
+      for (; !STRING_ALIGNED(cs); cs++, ct++)
+        {
+          if ((result = *cs - *ct) != 0 || !*cs)
+            {
+              return result;
+            }
+        }
+
+      wcs = (FAR const uintptr_t *)cs;
+      wct = (FAR const uintptr_t *)ct;
+
+      while (*wcs == *wct && !STRING_HASZERO(*wcs))
+        {
+          wcs++;
+          wct++;
+        }
+
+      cs = (FAR const char *)wcs;
+      ct = (FAR const char *)wct;
+    }
+#endif
+
   for (; ; )
     {
       if ((result = *cs - *ct++) != 0 || !*cs++)
@@ -0,0 +1,73 @@
+/****************************************************************************
+ * libs/libc/string/lib_string.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_STRING_LIB_STRING_H
+#define __LIBC_STRING_LIB_STRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Helpers for the word-at-a-time string functions (CONFIG_STRING_OPTSPEED).
+ *
+ * STRING_HASZERO(w) is non-zero if any byte of the word w is zero.  The
+ * subtraction borrows into the high bit of each byte that was zero; the
+ * ~w term discards bytes whose high bit was already set.  Bytes above the
+ * first zero byte may give false positives, so the caller must then find
+ * the zero byte one byte at a time.
+ *
+ * An aligned word never crosses a page or memory protection boundary, so
+ * reading the whole word that contains the terminating NUL is always
+ * safe.
+ */
+
+#define STRING_WORDSIZE   sizeof(uintptr_t)
+#define STRING_WORDMASK   (STRING_WORDSIZE - 1)
+#define STRING_ONES       ((uintptr_t)-1 / 0xff)
+#define STRING_HIGHS      (STRING_ONES << 7)
+
+#define STRING_ALIGNED(p) (((uintptr_t)(p) & STRING_WORDMASK) == 0)
+#define STRING_HASZERO(w) (((w) - STRING_ONES) & ~(w) & STRING_HIGHS)
+#define STRING_REPEAT(c)  ((uintptr_t)(unsigned char)(c) * STRING_ONES)
+
+#endif /* __LIBC_STRING_LIB_STRING_H */
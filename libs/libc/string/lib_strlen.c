@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_string.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,7 +52,29 @@
 size_t strlen(const char *s)
 {
   const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+
+#ifdef CONFIG_STRING_OPTSPEED
+  FAR const uintptr_t *w;
+
+  /* Check one byte at a time until the pointer is word aligned */
+
+  for (sc = s; !STRING_ALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  /* Then skip whole words that contain no NUL byte */
+
+  for (w = (FAR const uintptr_t *)sc; !STRING_HASZERO(*w); ++w);
+  sc = (FAR const char *)w;
+#else
+  sc = s;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
@@ -0,0 +1,327 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_findhashedbyname.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASHED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SYMTAB_HASH_NTABLES
+#  define CONFIG_SYMTAB_HASH_NTABLES 2
+#endif
+
+/* Marks the end of a hash chain */
+
+#define SYMTAB_HASH_NONE 0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is the hash index of one symbol table.  Symbols are chained through
+ * next[] from the bucket[] that their name hashes to.  The index is built
+ * the first time that the symbol table is searched.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int             nsyms;             /* The number of symbols in symtab */
+  uint16_t        mask;              /* Number of buckets minus one */
+  FAR uint16_t   *bucket;            /* First symbol in each bucket */
+  FAR uint16_t   *next;              /* Next symbol with the same hash */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_symtab_hashsem = SEM_INITIALIZER(1);
+static struct symtab_hash_s g_symtab_hash[CONFIG_SYMTAB_HASH_NTABLES];
+static uint8_t g_symtab_hashnext;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashtake and symtab_hashgive
+ *
+ * Description:
+ *   Get and release exclusive access to the symbol table hash indices.
+ *
+ ****************************************************************************/
+
+static void symtab_hashtake(void)
+{
+  int errcode = 0;
+  int ret;
+
+  do
+    {
+      ret = _SEM_WAIT(&g_symtab_hashsem);
+      if (ret < 0)
+        {
+          errcode = _SEM_ERRNO(ret);
+          DEBUGASSERT(errcode == EINTR || errcode == ECANCELED);
+        }
+    }
+  while (ret < 0 && errcode == EINTR);
+}
+
+#define symtab_hashgive() (void)_SEM_POST(&g_symtab_hashsem)
+
+/****************************************************************************
+ * Name: symtab_namehash
+ *
+ * Description:
+ *   The ELF (SysV) hash of a symbol name.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_namehash(FAR const char *name)
+{
+  uint32_t hash = 0;
+  uint32_t high;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 4) + (uint8_t)*name++;
+      high = hash & 0xf0000000;
+      if (high != 0)
+        {
+          hash ^= high >> 24;
+        }
+
+      hash &= ~high;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_hashbuild
+ *
+ * Description:
+ *   (Re-)build the hash index for a symbol table.  Any previous index held
+ *   in 'hash' is discarded.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int symtab_hashbuild(FAR struct symtab_hash_s *hash,
+                            FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR uint16_t *bucket;
+  uint32_t nbuckets;
+  uint32_t ndx;
+  int i;
+
+  lib_free(hash->bucket);
+  memset(hash, 0, sizeof(struct symtab_hash_s));
+
+  if (nsyms <= 0 || nsyms >= SYMTAB_HASH_NONE)
+    {
+      return -E2BIG;
+    }
+
+  /* Use a power of two number of buckets, about two symbols per bucket */
+
+  nbuckets = 1;
+  while (2 * nbuckets < (uint32_t)nsyms)
+    {
+      nbuckets <<= 1;
+    }
+
+  bucket = (FAR uint16_t *)
+    lib_malloc((nbuckets + nsyms) * sizeof(uint16_t));
+  if (bucket == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->bucket = bucket;
+  hash->next   = &bucket[nbuckets];
+  hash->mask   = nbuckets - 1;
+
+  memset(bucket, 0xff, nbuckets * sizeof(uint16_t));
+
+  /* Add the symbols in reverse order so that each chain is in table order
+   * and the first of any duplicate names is found, just as with a linear
+   * search.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      ndx            = symtab_namehash(symtab[i].sym_name) & hash->mask;
+      hash->next[i]  = bucket[ndx];
+      bucket[ndx]    = i;
+    }
+
+  hash->symtab = symtab;
+  hash->nsyms  = nsyms;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hashsearch
+ *
+ * Description:
+ *   Search a hash index for the named symbol.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *
+symtab_hashsearch(FAR struct symtab_hash_s *hash, FAR const char *name)
+{
+  uint16_t i;
+
+  i = hash->bucket[symtab_namehash(name) & hash->mask];
+  while (i != SYMTAB_HASH_NONE)
+    {
+      if (strcmp(name, hash->symtab[i].sym_name) == 0)
+        {
+          return &hash->symtab[i];
+        }
+
+      i = hash->next[i];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version makes no assumptions about the ordering of the table.  A
+ *   hash index of the table is built the first time that the table is
+ *   searched and kept for later searches, so look-ups take constant time.
+ *   Up to CONFIG_SYMTAB_HASH_NTABLES indices are kept.
+ *
+ *   No assumptions are made about the symbol table not changing:  If the
+ *   symbol is not found in the index, the table is searched linearly and,
+ *   if the symbol is then found, the stale index is rebuilt.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms)
+{
+  FAR const struct symtab_s *symbol;
+  FAR struct symtab_hash_s *hash;
+  int i;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+  symtab_hashtake();
+
+  /* Is there already an index for this symbol table? */
+
+  for (i = 0; i < CONFIG_SYMTAB_HASH_NTABLES; i++)
+    {
+      hash = &g_symtab_hash[i];
+      if (hash->symtab == symtab && hash->nsyms == nsyms)
+        {
+          symbol = symtab_hashsearch(hash, name);
+          if (symbol != NULL)
+            {
+              symtab_hashgive();
+              return symbol;
+            }
+
+          break;
+        }
+    }
+
+  /* The symbol is not in the index or there is no index.  Fall back to the
+   * linear search.
+   */
+
+  symbol = symtab_findbyname(symtab, name, nsyms);
+
+  if (i >= CONFIG_SYMTAB_HASH_NTABLES)
+    {
+      /* There is no index.  Replace the oldest one. */
+
+      hash = &g_symtab_hash[g_symtab_hashnext];
+      if (++g_symtab_hashnext >= CONFIG_SYMTAB_HASH_NTABLES)
+        {
+          g_symtab_hashnext = 0;
+        }
+
+      (void)symtab_hashbuild(hash, symtab, nsyms);
+    }
+  else if (symbol != NULL)
+    {
+      /* The symbol table was modified after the index was built */
+
+      (void)symtab_hashbuild(hash, symtab, nsyms);
+    }
+
+  symtab_hashgive();
+  return symbol;
+}
+
+#endif /* CONFIG_SYMTAB_HASHED */
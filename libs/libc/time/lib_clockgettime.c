@@ -0,0 +1,140 @@
+/****************************************************************************
+ * libs/libc/time/lib_clockgettime.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+#if defined(CONFIG_CLOCK_USERTIME) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The copy of the clock maintained by the kernel.  The kernel finds this
+ * through the us_clock field of the user-space header.
+ */
+
+struct clock_usertime_s g_clock_usertime;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Clock Functions based on POSIX APIs.  This is the user-space version
+ *   that reads the copy of the clock kept by the kernel instead of making
+ *   a system call.  The computation is the same as clock_systimespec() in
+ *   the kernel.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR volatile struct clock_usertime_s *usertime = &g_clock_usertime;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t msecs;
+  uint64_t secs;
+#else
+  clock_t msecs;
+  clock_t secs;
+#endif
+  clock_t ticks;
+  time_t basesec;
+  long basensec;
+  uint32_t seq;
+
+  if (clock_id != CLOCK_REALTIME
+#ifdef CONFIG_CLOCK_MONOTONIC
+      && clock_id != CLOCK_MONOTONIC
+#endif
+     )
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Take a consistent snapshot.  The kernel may update the copy from the
+   * timer interrupt at any time.
+   */
+
+  do
+    {
+      seq      = usertime->cu_seq;
+      ticks    = usertime->cu_ticks;
+      basesec  = usertime->cu_basesec;
+      basensec = usertime->cu_basensec;
+    }
+  while ((seq & 1) != 0 || seq != usertime->cu_seq);
+
+  /* Get the time since power-on in seconds and nanoseconds */
+
+  msecs       = TICK2MSEC(ticks);
+  secs        = msecs / MSEC_PER_SEC;
+  tp->tv_sec  = (time_t)secs;
+  tp->tv_nsec = (long)((msecs - (secs * MSEC_PER_SEC)) * NSEC_PER_MSEC);
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+      return OK;
+    }
+#endif
+
+  /* Add the base time to get the time-of-day */
+
+  tp->tv_sec  += basesec;
+  tp->tv_nsec += basensec;
+  if (tp->tv_nsec >= NSEC_PER_SEC)
+    {
+      tp->tv_sec++;
+      tp->tv_nsec -= NSEC_PER_SEC;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_USERTIME && !__KERNEL__ */
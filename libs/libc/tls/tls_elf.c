@@ -0,0 +1,136 @@
+/****************************************************************************
+ * libs/libc/tls/tls_elf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/tls.h>
+
+#ifdef CONFIG_TLS_ELF
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* These symbols are provided by the board linker script */
+
+extern const uint8_t _stdata[];  /* Start of .tdata initial values */
+extern const uint8_t _etdata[];  /* End of .tdata initial values */
+extern const uint8_t _stbss[];   /* Start of .tbss */
+extern const uint8_t _etbss[];   /* End of .tbss */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tls_elf_size
+ *
+ * Description:
+ *   Return the size of the compiler thread-local variables (.tdata and
+ *   .tbss) that are placed after struct tls_info_s in each stack.
+ *
+ ****************************************************************************/
+
+size_t tls_elf_size(void)
+{
+  size_t size = (size_t)(_etdata - _stdata) + (size_t)(_etbss - _stbss);
+  return (size + 7) & ~7;
+}
+
+/****************************************************************************
+ * Name: tls_elf_initialize
+ *
+ * Description:
+ *   Initialize the compiler thread-local variables of a new thread:  Copy
+ *   the initial values of .tdata and clear .tbss.
+ *
+ * Input Parameters:
+ *   info - The TLS structure at the bottom of the new stack
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tls_elf_initialize(FAR struct tls_info_s *info)
+{
+  FAR uint8_t *tdata = (FAR uint8_t *)(info + 1);
+  size_t datsize = (size_t)(_etdata - _stdata);
+
+  memcpy(tdata, _stdata, datsize);
+  memset(tdata + datsize, 0, tls_elf_size() - datsize);
+}
+
+/****************************************************************************
+ * Name: __aeabi_read_tp
+ *
+ * Description:
+ *   Return the thread pointer.  This is called by code generated with
+ *   -mtp=soft to access __thread variables.  The ABI requires that only
+ *   r0 be modified.
+ *
+ ****************************************************************************/
+
+naked_function void *__aeabi_read_tp(void)
+{
+  __asm__ __volatile__
+  (
+    "\tmov  r0, sp\n"
+#ifdef __thumb__
+    "\tlsrs r0, r0, %0\n"
+    "\tlsls r0, r0, %0\n"
+    "\tadds r0, r0, %1\n"
+#else
+    "\tmov  r0, r0, lsr %0\n"
+    "\tmov  r0, r0, lsl %0\n"
+    "\tadd  r0, r0, %1\n"
+#endif
+    "\tbx   lr\n"
+    :
+    : "i" (CONFIG_TLS_LOG2_MAXSTACK),
+      "i" (offsetof(struct tls_info_s, tl_tcb))
+  );
+}
+
+#endif /* CONFIG_TLS_ELF */
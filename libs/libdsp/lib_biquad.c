@@ -0,0 +1,347 @@
+/****************************************************************************
+ * libs/libdsp/lib_biquad.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "libdsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: biquad_f32_init
+ *
+ * Description:
+ *   Initialize a cascade of float biquad sections.
+ *
+ * Input Parameters:
+ *   iir     - (out) pointer to the biquad cascade data
+ *   coeffs  - (in) pointer to 5 * nstages coefficients
+ *   state   - (in) pointer to a buffer of 2 * nstages values
+ *   nstages - (in) number of sections
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_f32_init(FAR struct biquad_f32_s *iir, FAR const float *coeffs,
+                     FAR float *state, uint8_t nstages)
+{
+  DEBUGASSERT(iir != NULL && coeffs != NULL && state != NULL);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+
+  memset(state, 0, 2 * nstages * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: biquad_f32
+ *
+ * Description:
+ *   Filter a block of float samples.  Each section is implemented in the
+ *   transposed direct form II and is applied to the whole block before
+ *   the next one, so that its coefficients stay in registers.
+ *
+ * Input Parameters:
+ *   iir - (in/out) pointer to the biquad cascade data
+ *   in  - (in) pointer to n input samples
+ *   out - (out) pointer to n output samples (may be the same as in)
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_f32(FAR struct biquad_f32_s *iir, FAR const float *in,
+                FAR float *out, size_t n)
+{
+  FAR const float *c = iir->coeffs;
+  FAR float *s = iir->state;
+  FAR const float *src = in;
+  uint8_t stage;
+  size_t i;
+
+  DEBUGASSERT(iir != NULL && in != NULL && out != NULL);
+
+  for (stage = 0; stage < iir->nstages; stage++, c += 5, s += 2)
+    {
+      float b0 = c[0];
+      float b1 = c[1];
+      float b2 = c[2];
+      float a1 = c[3];
+      float a2 = c[4];
+      float d1 = s[0];
+      float d2 = s[1];
+      float x;
+      float y;
+
+      for (i = 0; i < n; i++)
+        {
+          x      = src[i];
+          y      = b0 * x + d1;
+          d1     = b1 * x - a1 * y + d2;
+          d2     = b2 * x - a2 * y;
+          out[i] = y;
+        }
+
+      s[0] = d1;
+      s[1] = d2;
+      src  = out;
+    }
+
+  /* Pass the input through if there are no sections */
+
+  if (src != out)
+    {
+      memmove(out, in, n * sizeof(float));
+    }
+}
+
+/****************************************************************************
+ * Name: biquad_q15_init
+ *
+ * Description:
+ *   Initialize a cascade of Q15 biquad sections.
+ *
+ * Input Parameters:
+ *   iir     - (out) pointer to the biquad cascade data
+ *   coeffs  - (in) pointer to 5 * nstages coefficients, each scaled down
+ *             by 2^shift
+ *   state   - (in) pointer to a buffer of 4 * nstages values
+ *   nstages - (in) number of sections
+ *   shift   - (in) coefficient scaling
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void biquad_q15_init(FAR struct biquad_q15_s *iir, FAR const q15_t *coeffs,
+                     FAR q15_t *state, uint8_t nstages, uint8_t shift)
+{
+  DEBUGASSERT(iir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(shift < 15);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+  iir->shift   = shift;
+
+  memset(state, 0, 4 * nstages * sizeof(q15_t));
+}
+
+/****************************************************************************
+ * Name: biquad_q15
+ *
+ * Description:
+ *   Filter a block of Q15 samples.  Each section is implemented in direct
+ *   form I with a 64-bit accumulator and a saturated output.  The state of
+ *   each section is {x(n-1), x(n-2), y(n-1), y(n-2)}.
+ *
+ ****************************************************************************/
+
+void biquad_q15(FAR struct biquad_q15_s *iir, FAR const q15_t *in,
+                FAR q15_t *out, size_t n)
+{
+  FAR const q15_t *c = iir->coeffs;
+  FAR q15_t *s = iir->state;
+  FAR const q15_t *src = in;
+  int rshift = 15 - iir->shift;
+  uint8_t stage;
+  size_t i;
+
+  DEBUGASSERT(iir != NULL && in != NULL && out != NULL);
+
+  for (stage = 0; stage < iir->nstages; stage++, c += 5, s += 4)
+    {
+#ifdef LIBDSP_HAVE_ARM_DSP
+      /* Keep {x(n-1), x(n-2)} and {y(n-1), y(n-2)} packed in one register
+       * each so that they can be multiplied with {b1, b2} and {a1, a2}
+       * with one SMLALD instruction.
+       */
+
+      uint32_t b12 = dsp_read_q15x2(&c[1]);
+      uint32_t a12 = dsp_read_q15x2(&c[3]);
+      uint32_t xs  = dsp_read_q15x2(&s[0]);
+      uint32_t ys  = dsp_read_q15x2(&s[2]);
+      int32_t b0   = c[0];
+      int64_t acc;
+      q15_t x;
+      q15_t y;
+
+      for (i = 0; i < n; i++)
+        {
+          x   = src[i];
+          acc = dsp_smlald(b12, xs, (int64_t)b0 * x) -
+                dsp_smlald(a12, ys, 0);
+          y   = dsp_sat_q15(acc >> rshift);
+
+          xs     = (xs << 16) | (uint16_t)x;
+          ys     = (ys << 16) | (uint16_t)y;
+          out[i] = y;
+        }
+
+      memcpy(&s[0], &xs, sizeof(xs));
+      memcpy(&s[2], &ys, sizeof(ys));
+#else
+      int32_t b0 = c[0];
+      int32_t b1 = c[1];
+      int32_t b2 = c[2];
+      int32_t a1 = c[3];
+      int32_t a2 = c[4];
+      q15_t x1   = s[0];
+      q15_t x2   = s[1];
+      q15_t y1   = s[2];
+      q15_t y2   = s[3];
+      int64_t acc;
+      q15_t x;
+
+      for (i = 0; i < n; i++)
+        {
+          x   = src[i];
+          acc = (int64_t)b0 * x + (int64_t)b1 * x1 + (int64_t)b2 * x2 -
+                (int64_t)a1 * y1 - (int64_t)a2 * y2;
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = dsp_sat_q15(acc >> rshift);
+          out[i] = y1;
+        }
+
+      s[0] = x1;
+      s[1] = x2;
+      s[2] = y1;
+      s[3] = y2;
+#endif
+      src = out;
+    }
+
+  if (src != out)
+    {
+      memmove(out, in, n * sizeof(q15_t));
+    }
+}
+
+/****************************************************************************
+ * Name: biquad_q31_init
+ *
+ * Description:
+ *   Initialize a cascade of Q31 biquad sections.  See biquad_q15_init().
+ *
+ ****************************************************************************/
+
+void biquad_q31_init(FAR struct biquad_q31_s *iir, FAR const q31_t *coeffs,
+                     FAR q31_t *state, uint8_t nstages, uint8_t shift)
+{
+  DEBUGASSERT(iir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(shift < 31);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+  iir->shift   = shift;
+
+  memset(state, 0, 4 * nstages * sizeof(q31_t));
+}
+
+/****************************************************************************
+ * Name: biquad_q31
+ *
+ * Description:
+ *   Filter a block of Q31 samples.  Each section is implemented in direct
+ *   form I.  The Q62 products are accumulated in 64 bits, so the input
+ *   should be scaled down by 2 bits to rule out overflow.
+ *
+ ****************************************************************************/
+
+void biquad_q31(FAR struct biquad_q31_s *iir, FAR const q31_t *in,
+                FAR q31_t *out, size_t n)
+{
+  FAR const q31_t *c = iir->coeffs;
+  FAR q31_t *s = iir->state;
+  FAR const q31_t *src = in;
+  int rshift = 31 - iir->shift;
+  uint8_t stage;
+  size_t i;
+
+  DEBUGASSERT(iir != NULL && in != NULL && out != NULL);
+
+  for (stage = 0; stage < iir->nstages; stage++, c += 5, s += 4)
+    {
+      q31_t b0 = c[0];
+      q31_t b1 = c[1];
+      q31_t b2 = c[2];
+      q31_t a1 = c[3];
+      q31_t a2 = c[4];
+      q31_t x1 = s[0];
+      q31_t x2 = s[1];
+      q31_t y1 = s[2];
+      q31_t y2 = s[3];
+      int64_t acc;
+      q31_t x;
+
+      for (i = 0; i < n; i++)
+        {
+          x   = src[i];
+          acc = (int64_t)b0 * x + (int64_t)b1 * x1 + (int64_t)b2 * x2 -
+                (int64_t)a1 * y1 - (int64_t)a2 * y2;
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = dsp_sat_q31(acc >> rshift);
+          out[i] = y1;
+        }
+
+      s[0] = x1;
+      s[1] = x2;
+      s[2] = y1;
+      s[3] = y2;
+      src  = out;
+    }
+
+  if (src != out)
+    {
+      memmove(out, in, n * sizeof(q31_t));
+    }
+}
@@ -0,0 +1,815 @@
+/****************************************************************************
+ * libs/libdsp/lib_fft.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+
+#include "libdsp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fft_checklen
+ *
+ * Description:
+ *   Check that the transform length is a supported power of two.
+ *
+ ****************************************************************************/
+
+static bool fft_checklen(uint16_t n)
+{
+  return n >= 4 && (n & (n - 1)) == 0;
+}
+
+/****************************************************************************
+ * Name: fft_f32_to_q15 and fft_f32_to_q31
+ *
+ * Description:
+ *   Convert a value in the range <-1.0, 1.0> to fixed-point with rounding
+ *   and saturation.
+ *
+ ****************************************************************************/
+
+static q15_t fft_f32_to_q15(float val)
+{
+  val *= 32768.0f;
+  return dsp_sat_q15((int64_t)(val >= 0.0f ? val + 0.5f : val - 0.5f));
+}
+
+static q31_t fft_f32_to_q31(float val)
+{
+  val *= 2147483648.0f;
+  return dsp_sat_q31((int64_t)(val >= 0.0f ? val + 0.5f : val - 0.5f));
+}
+
+/****************************************************************************
+ * Name: cfft_f32
+ *
+ * Description:
+ *   In-place complex radix-2 decimation-in-time FFT of m points.  The
+ *   twiddle factor of the m-point transform with index k is found at
+ *   index k * tstride of the table.  The first two stages have trivial
+ *   twiddle factors (1 and -j) and are done together as one radix-4 pass
+ *   without multiplications.
+ *
+ ****************************************************************************/
+
+static void cfft_f32(FAR float *buf, uint16_t m, FAR const float *tw,
+                     uint16_t tstride, bool inverse)
+{
+  uint16_t half;
+  uint16_t step;
+  uint16_t len;
+  uint16_t bit;
+  uint16_t i;
+  uint16_t j;
+  float tr;
+  float ti;
+  float wr;
+  float wi;
+
+  /* Bit-reversed reordering */
+
+  for (i = 1, j = 0; i < m; i++)
+    {
+      for (bit = m >> 1; (j & bit) != 0; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j ^= bit;
+      if (i < j)
+        {
+          tr = buf[2 * i];
+          ti = buf[2 * i + 1];
+          buf[2 * i]     = buf[2 * j];
+          buf[2 * i + 1] = buf[2 * j + 1];
+          buf[2 * j]     = tr;
+          buf[2 * j + 1] = ti;
+        }
+    }
+
+  len = 2;
+  if (m >= 4)
+    {
+      /* Radix-4 pass for the first two stages */
+
+      for (i = 0; i < 2 * m; i += 8)
+        {
+          FAR float *x = &buf[i];
+          float s0r = x[0] + x[2];
+          float s0i = x[1] + x[3];
+          float d0r = x[0] - x[2];
+          float d0i = x[1] - x[3];
+          float s1r = x[4] + x[6];
+          float s1i = x[5] + x[7];
+          float d1r = x[4] - x[6];
+          float d1i = x[5] - x[7];
+
+          /* Rotate d1 by -j (forward) or +j (inverse) */
+
+          if (inverse)
+            {
+              tr  = -d1i;
+              d1i = d1r;
+            }
+          else
+            {
+              tr  = d1i;
+              d1i = -d1r;
+            }
+
+          x[0] = s0r + s1r;
+          x[1] = s0i + s1i;
+          x[4] = s0r - s1r;
+          x[5] = s0i - s1i;
+          x[2] = d0r + tr;
+          x[3] = d0i + d1i;
+          x[6] = d0r - tr;
+          x[7] = d0i - d1i;
+        }
+
+      len = 8;
+    }
+
+  /* Remaining radix-2 stages */
+
+  for (; len <= m; len <<= 1)
+    {
+      half = len >> 1;
+      step = (m / len) * tstride;
+
+      for (j = 0; j < half; j++)
+        {
+          wr = tw[2 * j * step];
+          wi = inverse ? -tw[2 * j * step + 1] : tw[2 * j * step + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              FAR float *a = &buf[2 * i];
+              FAR float *b = &buf[2 * (i + half)];
+
+              tr   = wr * b[0] - wi * b[1];
+              ti   = wr * b[1] + wi * b[0];
+              b[0] = a[0] - tr;
+              b[1] = a[1] - ti;
+              a[0] = a[0] + tr;
+              a[1] = a[1] + ti;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cfft_q15
+ *
+ * Description:
+ *   Q15 version of cfft_f32().  Every stage scales its output by 1/2 so
+ *   that the result is the transform divided by m.
+ *
+ ****************************************************************************/
+
+static void cfft_q15(FAR q15_t *buf, uint16_t m, FAR const q15_t *tw,
+                     uint16_t tstride, bool inverse)
+{
+  uint16_t half;
+  uint16_t step;
+  uint16_t len;
+  uint16_t bit;
+  uint16_t i;
+  uint16_t j;
+  int32_t tr;
+  int32_t ti;
+  int32_t wr;
+  int32_t wi;
+
+  for (i = 1, j = 0; i < m; i++)
+    {
+      for (bit = m >> 1; (j & bit) != 0; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j ^= bit;
+      if (i < j)
+        {
+          tr = buf[2 * i];
+          ti = buf[2 * i + 1];
+          buf[2 * i]     = buf[2 * j];
+          buf[2 * i + 1] = buf[2 * j + 1];
+          buf[2 * j]     = tr;
+          buf[2 * j + 1] = ti;
+        }
+    }
+
+  len = 2;
+  if (m >= 4)
+    {
+      for (i = 0; i < 2 * m; i += 8)
+        {
+          FAR q15_t *x = &buf[i];
+          int32_t s0r = x[0] + x[2];
+          int32_t s0i = x[1] + x[3];
+          int32_t d0r = x[0] - x[2];
+          int32_t d0i = x[1] - x[3];
+          int32_t s1r = x[4] + x[6];
+          int32_t s1i = x[5] + x[7];
+          int32_t d1r = x[4] - x[6];
+          int32_t d1i = x[5] - x[7];
+
+          if (inverse)
+            {
+              tr  = -d1i;
+              d1i = d1r;
+            }
+          else
+            {
+              tr  = d1i;
+              d1i = -d1r;
+            }
+
+          x[0] = (s0r + s1r) >> 2;
+          x[1] = (s0i + s1i) >> 2;
+          x[4] = (s0r - s1r) >> 2;
+          x[5] = (s0i - s1i) >> 2;
+          x[2] = (d0r + tr) >> 2;
+          x[3] = (d0i + d1i) >> 2;
+          x[6] = (d0r - tr) >> 2;
+          x[7] = (d0i - d1i) >> 2;
+        }
+
+      len = 8;
+    }
+
+  for (; len <= m; len <<= 1)
+    {
+      half = len >> 1;
+      step = (m / len) * tstride;
+
+      for (j = 0; j < half; j++)
+        {
+          wr = tw[2 * j * step];
+          wi = inverse ? -tw[2 * j * step + 1] : tw[2 * j * step + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              FAR q15_t *a = &buf[2 * i];
+              FAR q15_t *b = &buf[2 * (i + half)];
+
+              tr   = (wr * b[0] - wi * b[1]) >> 15;
+              ti   = (wr * b[1] + wi * b[0]) >> 15;
+              b[0] = (a[0] - tr) >> 1;
+              b[1] = (a[1] - ti) >> 1;
+              a[0] = (a[0] + tr) >> 1;
+              a[1] = (a[1] + ti) >> 1;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cfft_q31
+ *
+ * Description:
+ *   Q31 version of cfft_q15().
+ *
+ ****************************************************************************/
+
+static void cfft_q31(FAR q31_t *buf, uint16_t m, FAR const q31_t *tw,
+                     uint16_t tstride, bool inverse)
+{
+  uint16_t half;
+  uint16_t step;
+  uint16_t len;
+  uint16_t bit;
+  uint16_t i;
+  uint16_t j;
+  int64_t tr;
+  int64_t ti;
+  int64_t wr;
+  int64_t wi;
+
+  for (i = 1, j = 0; i < m; i++)
+    {
+      for (bit = m >> 1; (j & bit) != 0; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j ^= bit;
+      if (i < j)
+        {
+          tr = buf[2 * i];
+          ti = buf[2 * i + 1];
+          buf[2 * i]     = buf[2 * j];
+          buf[2 * i + 1] = buf[2 * j + 1];
+          buf[2 * j]     = tr;
+          buf[2 * j + 1] = ti;
+        }
+    }
+
+  len = 2;
+  if (m >= 4)
+    {
+      for (i = 0; i < 2 * m; i += 8)
+        {
+          FAR q31_t *x = &buf[i];
+          int64_t s0r = (int64_t)x[0] + x[2];
+          int64_t s0i = (int64_t)x[1] + x[3];
+          int64_t d0r = (int64_t)x[0] - x[2];
+          int64_t d0i = (int64_t)x[1] - x[3];
+          int64_t s1r = (int64_t)x[4] + x[6];
+          int64_t s1i = (int64_t)x[5] + x[7];
+          int64_t d1r = (int64_t)x[4] - x[6];
+          int64_t d1i = (int64_t)x[5] - x[7];
+
+          if (inverse)
+            {
+              tr  = -d1i;
+              d1i = d1r;
+            }
+          else
+            {
+              tr  = d1i;
+              d1i = -d1r;
+            }
+
+          x[0] = (q31_t)((s0r + s1r) >> 2);
+          x[1] = (q31_t)((s0i + s1i) >> 2);
+          x[4] = (q31_t)((s0r - s1r) >> 2);
+          x[5] = (q31_t)((s0i - s1i) >> 2);
+          x[2] = (q31_t)((d0r + tr) >> 2);
+          x[3] = (q31_t)((d0i + d1i) >> 2);
+          x[6] = (q31_t)((d0r - tr) >> 2);
+          x[7] = (q31_t)((d0i - d1i) >> 2);
+        }
+
+      len = 8;
+    }
+
+  for (; len <= m; len <<= 1)
+    {
+      half = len >> 1;
+      step = (m / len) * tstride;
+
+      for (j = 0; j < half; j++)
+        {
+          wr = tw[2 * j * step];
+          wi = inverse ? -(int64_t)tw[2 * j * step + 1] :
+                         tw[2 * j * step + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              FAR q31_t *a = &buf[2 * i];
+              FAR q31_t *b = &buf[2 * (i + half)];
+
+              tr   = (wr * b[0] - wi * b[1]) >> 31;
+              ti   = (wr * b[1] + wi * b[0]) >> 31;
+              b[0] = (q31_t)((a[0] - tr) >> 1);
+              b[1] = (q31_t)((a[1] - ti) >> 1);
+              a[0] = (q31_t)((a[0] + tr) >> 1);
+              a[1] = (q31_t)((a[1] + ti) >> 1);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fft_f32_init
+ *
+ * Description:
+ *   Initialize a float FFT of length n.
+ *
+ * Input Parameters:
+ *   fft     - (out) pointer to the FFT data
+ *   twiddle - (in) pointer to a buffer of n values for the twiddle factors
+ *   n       - (in) transform length, a power of two (at least 4)
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if n is not supported.
+ *
+ ****************************************************************************/
+
+int fft_f32_init(FAR struct fft_f32_s *fft, FAR float *twiddle, uint16_t n)
+{
+  float angle;
+  uint16_t k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (!fft_checklen(n))
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      angle = 2.0f * M_PI_F * k / n;
+      twiddle[2 * k]     = cosf(angle);
+      twiddle[2 * k + 1] = -sinf(angle);
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fft_f32_cfft
+ *
+ * Description:
+ *   In-place complex FFT of n points.  The buffer holds n complex values
+ *   with interleaved real and imaginary parts.  The inverse transform is
+ *   scaled by 1/n.
+ *
+ * Input Parameters:
+ *   fft     - (in) pointer to the FFT data
+ *   buf     - (in/out) pointer to 2 * n values
+ *   inverse - (in) true for the inverse transform
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fft_f32_cfft(FAR const struct fft_f32_s *fft, FAR float *buf,
+                  bool inverse)
+{
+  float scale;
+  uint16_t i;
+
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  cfft_f32(buf, fft->n, fft->twiddle, 1, inverse);
+
+  if (inverse)
+    {
+      scale = 1.0f / fft->n;
+      for (i = 0; i < 2 * fft->n; i++)
+        {
+          buf[i] *= scale;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fft_f32_rfft
+ *
+ * Description:
+ *   In-place FFT of n real values.  The n/2 + 1 non-redundant frequency
+ *   bins are returned packed into the n values of the buffer:  buf[0] and
+ *   buf[1] are the (real) bins 0 and n/2, followed by the real and
+ *   imaginary parts of bins 1 to n/2 - 1.
+ *
+ *   The transform is computed as a complex FFT of n/2 points followed by
+ *   a split step, which is about twice as fast as a complex FFT of n
+ *   points with zero imaginary parts.
+ *
+ * Input Parameters:
+ *   fft - (in) pointer to the FFT data
+ *   buf - (in/out) pointer to n values
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fft_f32_rfft(FAR const struct fft_f32_s *fft, FAR float *buf)
+{
+  FAR const float *tw = fft->twiddle;
+  uint16_t m = fft->n / 2;
+  uint16_t k;
+  float er;
+  float ei;
+  float odr;
+  float odi;
+  float tr;
+  float ti;
+
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  cfft_f32(buf, m, tw, 2, false);
+
+  tr     = buf[0];
+  buf[0] = tr + buf[1];
+  buf[1] = tr - buf[1];
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR float *a = &buf[2 * k];
+      FAR float *b = &buf[2 * (m - k)];
+
+      /* Even and odd parts.  a is Z(k) and b is Z(m-k). */
+
+      er = 0.5f * (a[0] + b[0]);
+      ei = 0.5f * (a[1] - b[1]);
+      odr = 0.5f * (a[0] - b[0]);
+      odi = 0.5f * (a[1] + b[1]);
+
+      /* W(k) * odd part */
+
+      tr = tw[2 * k] * odr - tw[2 * k + 1] * odi;
+      ti = tw[2 * k] * odi + tw[2 * k + 1] * odr;
+
+      b[0] = er - ti;
+      b[1] = -ei - tr;
+      a[0] = er + ti;
+      a[1] = ei - tr;
+    }
+}
+
+/****************************************************************************
+ * Name: fft_f32_irfft
+ *
+ * Description:
+ *   Inverse of fft_f32_rfft().  The buffer holds the packed frequency bins
+ *   on input and the n real values on output.
+ *
+ ****************************************************************************/
+
+void fft_f32_irfft(FAR const struct fft_f32_s *fft, FAR float *buf)
+{
+  FAR const float *tw = fft->twiddle;
+  uint16_t m = fft->n / 2;
+  uint16_t k;
+  float scale;
+  float er;
+  float ei;
+  float odr;
+  float odi;
+  float tr;
+  float ti;
+
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  tr     = buf[0];
+  buf[0] = 0.5f * (tr + buf[1]);
+  buf[1] = 0.5f * (tr - buf[1]);
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR float *a = &buf[2 * k];
+      FAR float *b = &buf[2 * (m - k)];
+
+      er = 0.5f * (a[0] + b[0]);
+      ei = 0.5f * (a[1] - b[1]);
+      tr = 0.5f * (b[0] - a[0]);
+      ti = 0.5f * (-b[1] - a[1]);
+
+      /* Odd part = -j * conj(W(k)) * t */
+
+      odr = tw[2 * k] * ti - tw[2 * k + 1] * tr;
+      odi = -tw[2 * k] * tr - tw[2 * k + 1] * ti;
+
+      b[0] = er - odr;
+      b[1] = odi - ei;
+      a[0] = er + odr;
+      a[1] = ei + odi;
+    }
+
+  cfft_f32(buf, m, tw, 2, true);
+
+  scale = 1.0f / m;
+  for (k = 0; k < fft->n; k++)
+    {
+      buf[k] *= scale;
+    }
+}
+
+/****************************************************************************
+ * Name: fft_q15_init
+ *
+ * Description:
+ *   Initialize a Q15 FFT of length n.  See fft_f32_init().
+ *
+ ****************************************************************************/
+
+int fft_q15_init(FAR struct fft_q15_s *fft, FAR q15_t *twiddle, uint16_t n)
+{
+  float angle;
+  uint16_t k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (!fft_checklen(n))
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      angle = 2.0f * M_PI_F * k / n;
+      twiddle[2 * k]     = fft_f32_to_q15(cosf(angle));
+      twiddle[2 * k + 1] = fft_f32_to_q15(-sinf(angle));
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fft_q15_cfft
+ *
+ * Description:
+ *   In-place complex Q15 FFT of n points.  Both the forward and the
+ *   inverse transform are scaled by 1/n.  See fft_f32_cfft().
+ *
+ ****************************************************************************/
+
+void fft_q15_cfft(FAR const struct fft_q15_s *fft, FAR q15_t *buf,
+                  bool inverse)
+{
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  cfft_q15(buf, fft->n, fft->twiddle, 1, inverse);
+}
+
+/****************************************************************************
+ * Name: fft_q15_rfft
+ *
+ * Description:
+ *   In-place FFT of n real Q15 values, scaled by 1/n.  The output is
+ *   packed as described for fft_f32_rfft().
+ *
+ ****************************************************************************/
+
+void fft_q15_rfft(FAR const struct fft_q15_s *fft, FAR q15_t *buf)
+{
+  FAR const q15_t *tw = fft->twiddle;
+  uint16_t m = fft->n / 2;
+  uint16_t k;
+  int32_t er;
+  int32_t ei;
+  int32_t odr;
+  int32_t odi;
+  int32_t tr;
+  int32_t ti;
+
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  /* The complex FFT is scaled by 1/m, the split step by another 1/2 */
+
+  cfft_q15(buf, m, tw, 2, false);
+
+  tr     = buf[0];
+  buf[0] = (tr + buf[1]) >> 1;
+  buf[1] = (tr - buf[1]) >> 1;
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR q15_t *a = &buf[2 * k];
+      FAR q15_t *b = &buf[2 * (m - k)];
+
+      er = (a[0] + b[0]) >> 2;
+      ei = (a[1] - b[1]) >> 2;
+      odr = (a[0] - b[0]) >> 2;
+      odi = (a[1] + b[1]) >> 2;
+
+      tr = (tw[2 * k] * odr - tw[2 * k + 1] * odi) >> 15;
+      ti = (tw[2 * k] * odi + tw[2 * k + 1] * odr) >> 15;
+
+      b[0] = dsp_sat_q15(er - ti);
+      b[1] = dsp_sat_q15(-ei - tr);
+      a[0] = dsp_sat_q15(er + ti);
+      a[1] = dsp_sat_q15(ei - tr);
+    }
+}
+
+/****************************************************************************
+ * Name: fft_q31_init
+ *
+ * Description:
+ *   Initialize a Q31 FFT of length n.  See fft_f32_init().
+ *
+ ****************************************************************************/
+
+int fft_q31_init(FAR struct fft_q31_s *fft, FAR q31_t *twiddle, uint16_t n)
+{
+  float angle;
+  uint16_t k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (!fft_checklen(n))
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      angle = 2.0f * M_PI_F * k / n;
+      twiddle[2 * k]     = fft_f32_to_q31(cosf(angle));
+      twiddle[2 * k + 1] = fft_f32_to_q31(-sinf(angle));
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fft_q31_cfft
+ *
+ * Description:
+ *   In-place complex Q31 FFT of n points.  Both the forward and the
+ *   inverse transform are scaled by 1/n.  See fft_f32_cfft().
+ *
+ ****************************************************************************/
+
+void fft_q31_cfft(FAR const struct fft_q31_s *fft, FAR q31_t *buf,
+                  bool inverse)
+{
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  cfft_q31(buf, fft->n, fft->twiddle, 1, inverse);
+}
+
+/****************************************************************************
+ * Name: fft_q31_rfft
+ *
+ * Description:
+ *   In-place FFT of n real Q31 values, scaled by 1/n.  See fft_q15_rfft().
+ *
+ ****************************************************************************/
+
+void fft_q31_rfft(FAR const struct fft_q31_s *fft, FAR q31_t *buf)
+{
+  FAR const q31_t *tw = fft->twiddle;
+  uint16_t m = fft->n / 2;
+  uint16_t k;
+  int64_t er;
+  int64_t ei;
+  int64_t odr;
+  int64_t odi;
+  int64_t tr;
+  int64_t ti;
+
+  DEBUGASSERT(fft != NULL && buf != NULL);
+
+  cfft_q31(buf, m, tw, 2, false);
+
+  tr     = buf[0];
+  buf[0] = (q31_t)((tr + buf[1]) >> 1);
+  buf[1] = (q31_t)((tr - buf[1]) >> 1);
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR q31_t *a = &buf[2 * k];
+      FAR q31_t *b = &buf[2 * (m - k)];
+
+      er = ((int64_t)a[0] + b[0]) >> 2;
+      ei = ((int64_t)a[1] - b[1]) >> 2;
+      odr = ((int64_t)a[0] - b[0]) >> 2;
+      odi = ((int64_t)a[1] + b[1]) >> 2;
+
+      tr = (tw[2 * k] * odr - tw[2 * k + 1] * odi) >> 31;
+      ti = (tw[2 * k] * odi + tw[2 * k + 1] * odr) >> 31;
+
+      b[0] = dsp_sat_q31(er - ti);
+      b[1] = dsp_sat_q31(-ei - tr);
+      a[0] = dsp_sat_q31(er + ti);
+      a[1] = dsp_sat_q31(ei - tr);
+    }
+}
@@ -0,0 +1,346 @@
+/****************************************************************************
+ * libs/libdsp/lib_fir.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "libdsp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_f32_dot
+ *
+ * Description:
+ *   Return the dot product of the coefficients and the delay line window.
+ *
+ ****************************************************************************/
+
+static float fir_f32_dot(FAR const float *h, FAR const float *w,
+                         uint16_t ntaps)
+{
+  uint16_t k = 0;
+  float acc;
+
+#ifdef LIBDSP_HAVE_NEON
+  float32x4_t vacc = vdupq_n_f32(0.0f);
+  float32x2_t vsum;
+
+  for (; k + 4 <= ntaps; k += 4)
+    {
+      vacc = vmlaq_f32(vacc, vld1q_f32(&h[k]), vld1q_f32(&w[k]));
+    }
+
+  vsum = vadd_f32(vget_low_f32(vacc), vget_high_f32(vacc));
+  acc  = vget_lane_f32(vpadd_f32(vsum, vsum), 0);
+#else
+  float acc0 = 0.0f;
+  float acc1 = 0.0f;
+  float acc2 = 0.0f;
+  float acc3 = 0.0f;
+
+  /* Four independent accumulators hide the FPU multiply-add latency */
+
+  for (; k + 4 <= ntaps; k += 4)
+    {
+      acc0 += h[k]     * w[k];
+      acc1 += h[k + 1] * w[k + 1];
+      acc2 += h[k + 2] * w[k + 2];
+      acc3 += h[k + 3] * w[k + 3];
+    }
+
+  acc = (acc0 + acc1) + (acc2 + acc3);
+#endif
+
+  for (; k < ntaps; k++)
+    {
+      acc += h[k] * w[k];
+    }
+
+  return acc;
+}
+
+/****************************************************************************
+ * Name: fir_q15_dot
+ *
+ * Description:
+ *   Return the dot product of the coefficients and the delay line window
+ *   as a Q15 value.  The products are accumulated with 64-bit precision.
+ *
+ ****************************************************************************/
+
+static q15_t fir_q15_dot(FAR const q15_t *h, FAR const q15_t *w,
+                         uint16_t ntaps)
+{
+  uint16_t k = 0;
+  int64_t acc = 0;
+
+#ifdef LIBDSP_HAVE_ARM_DSP
+  /* Two taps per SMLALD instruction */
+
+  for (; k + 4 <= ntaps; k += 4)
+    {
+      acc = dsp_smlald(dsp_read_q15x2(&h[k]), dsp_read_q15x2(&w[k]), acc);
+      acc = dsp_smlald(dsp_read_q15x2(&h[k + 2]),
+                       dsp_read_q15x2(&w[k + 2]), acc);
+    }
+#endif
+
+  for (; k < ntaps; k++)
+    {
+      acc += (int32_t)h[k] * w[k];
+    }
+
+  return dsp_sat_q15(acc >> 15);
+}
+
+/****************************************************************************
+ * Name: fir_q31_dot
+ *
+ * Description:
+ *   Return the dot product of the coefficients and the delay line window
+ *   as a Q31 value.  The Q62 products are accumulated in 64 bits, so the
+ *   input must be scaled down by log2(ntaps) bits to rule out overflow.
+ *
+ ****************************************************************************/
+
+static q31_t fir_q31_dot(FAR const q31_t *h, FAR const q31_t *w,
+                         uint16_t ntaps)
+{
+  uint16_t k = 0;
+  int64_t acc0 = 0;
+  int64_t acc1 = 0;
+
+  for (; k + 2 <= ntaps; k += 2)
+    {
+      acc0 += (int64_t)h[k]     * w[k];
+      acc1 += (int64_t)h[k + 1] * w[k + 1];
+    }
+
+  for (; k < ntaps; k++)
+    {
+      acc0 += (int64_t)h[k] * w[k];
+    }
+
+  return dsp_sat_q31((acc0 + acc1) >> 31);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_f32_init
+ *
+ * Description:
+ *   Initialize a float FIR filter.
+ *
+ *   The delay line is held twice in the state buffer so that the last
+ *   ntaps samples can always be found in one contiguous window, newest
+ *   first.  This avoids wrapping in the inner loop and shifting the delay
+ *   line for every sample.
+ *
+ * Input Parameters:
+ *   fir    - (out) pointer to the FIR filter data
+ *   coeffs - (in) pointer to ntaps filter coefficients
+ *   state  - (in) pointer to a buffer of 2 * ntaps samples
+ *   ntaps  - (in) number of filter taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_f32_init(FAR struct fir_f32_s *fir, FAR const float *coeffs,
+                  FAR float *state, uint16_t ntaps)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->idx    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: fir_f32
+ *
+ * Description:
+ *   Filter a block of float samples.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter data
+ *   in  - (in) pointer to n input samples
+ *   out - (out) pointer to n output samples (may be the same as in)
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_f32(FAR struct fir_f32_s *fir, FAR const float *in,
+             FAR float *out, size_t n)
+{
+  FAR float *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  uint16_t idx = fir->idx;
+  size_t i;
+
+  DEBUGASSERT(fir != NULL && in != NULL && out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      idx = (idx == 0 ? ntaps : idx) - 1;
+      state[idx]         = in[i];
+      state[idx + ntaps] = in[i];
+
+      out[i] = fir_f32_dot(fir->coeffs, &state[idx], ntaps);
+    }
+
+  fir->idx = idx;
+}
+
+/****************************************************************************
+ * Name: fir_q15_init
+ *
+ * Description:
+ *   Initialize a Q15 FIR filter.  See fir_f32_init().
+ *
+ ****************************************************************************/
+
+void fir_q15_init(FAR struct fir_q15_s *fir, FAR const q15_t *coeffs,
+                  FAR q15_t *state, uint16_t ntaps)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->idx    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(q15_t));
+}
+
+/****************************************************************************
+ * Name: fir_q15
+ *
+ * Description:
+ *   Filter a block of Q15 samples.  The output is saturated.  See
+ *   fir_f32().
+ *
+ ****************************************************************************/
+
+void fir_q15(FAR struct fir_q15_s *fir, FAR const q15_t *in,
+             FAR q15_t *out, size_t n)
+{
+  FAR q15_t *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  uint16_t idx = fir->idx;
+  size_t i;
+
+  DEBUGASSERT(fir != NULL && in != NULL && out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      idx = (idx == 0 ? ntaps : idx) - 1;
+      state[idx]         = in[i];
+      state[idx + ntaps] = in[i];
+
+      out[i] = fir_q15_dot(fir->coeffs, &state[idx], ntaps);
+    }
+
+  fir->idx = idx;
+}
+
+/****************************************************************************
+ * Name: fir_q31_init
+ *
+ * Description:
+ *   Initialize a Q31 FIR filter.  See fir_f32_init().
+ *
+ ****************************************************************************/
+
+void fir_q31_init(FAR struct fir_q31_s *fir, FAR const q31_t *coeffs,
+                  FAR q31_t *state, uint16_t ntaps)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->idx    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(q31_t));
+}
+
+/****************************************************************************
+ * Name: fir_q31
+ *
+ * Description:
+ *   Filter a block of Q31 samples.  The output is saturated.  See
+ *   fir_f32().
+ *
+ ****************************************************************************/
+
+void fir_q31(FAR struct fir_q31_s *fir, FAR const q31_t *in,
+             FAR q31_t *out, size_t n)
+{
+  FAR q31_t *state = fir->state;
+  uint16_t ntaps = fir->ntaps;
+  uint16_t idx = fir->idx;
+  size_t i;
+
+  DEBUGASSERT(fir != NULL && in != NULL && out != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      idx = (idx == 0 ? ntaps : idx) - 1;
+      state[idx]         = in[i];
+      state[idx + ntaps] = in[i];
+
+      out[i] = fir_q31_dot(fir->coeffs, &state[idx], ntaps);
+    }
+
+  fir->idx = idx;
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+ * libs/libdsp/lib_foc_b16.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+#include <stdbool.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_current_control_b16
+ *
+ * Description:
+ *   Current controller for the fixed-point FOC.  See
+ *   foc_current_control() in lib_foc.c.
+ *
+ ****************************************************************************/
+
+static void foc_current_control_b16(FAR struct foc_data_b16_s *foc)
+{
+  FAR pid_controller_b16_t *id_pid = &foc->id_pid;
+  FAR pid_controller_b16_t *iq_pid = &foc->iq_pid;
+  FAR dq_frame_b16_t       *v_dq   = &foc->v_dq;
+
+  /* Get dq current error */
+
+  foc->i_dq_err.d = foc->i_dq_ref.d - foc->i_dq.d;
+  foc->i_dq_err.q = foc->i_dq_ref.q - foc->i_dq.q;
+
+  /* PI controller for d-current (flux loop) */
+
+  v_dq->d = pi_controller_b16(id_pid, foc->i_dq_err.d);
+
+  /* PI controller for q-current (torque loop) */
+
+  v_dq->q = pi_controller_b16(iq_pid, foc->i_dq_err.q);
+
+  /* Saturate voltage DQ vector */
+
+  dq_saturate_b16(v_dq, foc->vdq_mag_max);
+}
+
+/****************************************************************************
+ * Name: foc_vdq_mag_max_set_b16
+ *
+ * Description:
+ *   Set maximum dq voltage vector magnitude and update the PI regulators
+ *   saturation.
+ *
+ ****************************************************************************/
+
+static void foc_vdq_mag_max_set_b16(FAR struct foc_data_b16_s *foc,
+                                    b16_t max)
+{
+  foc->vdq_mag_max = max;
+
+  /* Update regulators saturation */
+
+  if (max > 0)
+    {
+      pi_saturation_set_b16(&foc->id_pid, -max, max);
+      pi_saturation_set_b16(&foc->iq_pid, -max, max);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: foc_init_b16
+ *
+ * Description:
+ *   Initialize fixed-point FOC controller.  See foc_init().
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the FOC data
+ *   id_kp - (in) KP for d current
+ *   id_ki - (in) KI for d current
+ *   iq_kp - (in) KP for q current
+ *   iq_ki - (in) KI for q current
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_init_b16(FAR struct foc_data_b16_s *foc,
+                  b16_t id_kp, b16_t id_ki, b16_t iq_kp, b16_t iq_ki)
+{
+  DEBUGASSERT(foc != NULL);
+
+  /* Reset data */
+
+  memset(foc, 0, sizeof(struct foc_data_b16_s));
+
+  /* Initialize PI current d and q components */
+
+  pi_controller_init_b16(&foc->id_pid, id_kp, id_ki);
+  pi_controller_init_b16(&foc->iq_pid, iq_kp, iq_ki);
+}
+
+/****************************************************************************
+ * Name: foc_idq_ref_set_b16
+ *
+ * Description:
+ *   Set dq current reference for the fixed-point FOC.
+ *
+ ****************************************************************************/
+
+void foc_idq_ref_set_b16(FAR struct foc_data_b16_s *foc, b16_t d, b16_t q)
+{
+  foc->i_dq_ref.d = d;
+  foc->i_dq_ref.q = q;
+}
+
+/****************************************************************************
+ * Name: foc_vbase_update_b16
+ *
+ * Description:
+ *   Update base voltage for the fixed-point FOC.  See foc_vbase_update().
+ *   The division is only done here, so foc_process_b16() does not divide.
+ *
+ ****************************************************************************/
+
+void foc_vbase_update_b16(FAR struct foc_data_b16_s *foc, b16_t vbase)
+{
+  b16_t scale   = 0;
+  b16_t mag_max = 0;
+
+  /* Only if voltage is valid */
+
+  if (vbase > 0)
+    {
+      scale   = b16divb16(b16ONE, vbase);
+      mag_max = vbase;
+    }
+
+  foc->vab_mod_scale = scale;
+  foc_vdq_mag_max_set_b16(foc, mag_max);
+}
+
+/****************************************************************************
+ * Name: foc_process_b16
+ *
+ * Description:
+ *   Process fixed-point FOC: current dq in, voltage alpha-beta modulation
+ *   out.  See foc_process().
+ *
+ * Input Parameters:
+ *   foc   - (in/out) pointer to the FOC data
+ *   i_abc - (in) pointer to the ABC current frame
+ *   angle - (in) pointer to the phase angle data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_process_b16(FAR struct foc_data_b16_s *foc,
+                     FAR abc_frame_b16_t *i_abc,
+                     FAR phase_angle_b16_t *angle)
+{
+  DEBUGASSERT(foc != NULL);
+  DEBUGASSERT(i_abc != NULL);
+  DEBUGASSERT(angle != NULL);
+
+  /* Copy ABC current to foc data */
+
+  foc->i_abc.a = i_abc->a;
+  foc->i_abc.b = i_abc->b;
+  foc->i_abc.c = i_abc->c;
+
+  /* Convert abc current to alpha-beta current */
+
+  clarke_transform_b16(&foc->i_abc, &foc->i_ab);
+
+  /* Convert alpha-beta current to dq current */
+
+  park_transform_b16(angle, &foc->i_ab, &foc->i_dq);
+
+  /* Run FOC current control (current dq -> voltage dq) */
+
+  foc_current_control_b16(foc);
+
+  /* Inverse Park tranform (voltage dq -> voltage alpha-beta) */
+
+  inv_park_transform_b16(angle, &foc->v_dq, &foc->v_ab);
+
+  /* Normalize the alpha-beta voltage to get the alpha-beta modulation
+   * voltage
+   */
+
+  foc->v_ab_mod.a = b16mulb16(foc->v_ab.a, foc->vab_mod_scale);
+  foc->v_ab_mod.b = b16mulb16(foc->v_ab.b, foc->vab_mod_scale);
+}
@@ -0,0 +1,359 @@
+/****************************************************************************
+ * libs/libdsp/lib_misc_b16.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Conversion from b16 radians <0, 2PI> to a 16-bit phase where 65536
+ * corresponds to 2PI:  phase = angle * (65536 / 2PI) / 65536 with
+ * 65536 / 2PI = 10430.378.  The fractional part of the constant is added
+ * separately (as 97/256) so that the products still fit in 32 bits.
+ */
+
+#define B16RAD_TO_PHASE      10430
+#define B16RAD_TO_PHASE_FRAC 97
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Sine of 257 angles evenly spaced over <0, 2PI> in Q15 */
+
+static const int16_t g_sin_q15[257] =
+{
+       0,    804,   1608,   2411,   3212,   4011,   4808,   5602,
+    6393,   7180,   7962,   8740,   9512,  10279,  11039,  11793,
+   12540,  13279,  14010,  14733,  15447,  16151,  16846,  17531,
+   18205,  18868,  19520,  20160,  20788,  21403,  22006,  22595,
+   23170,  23732,  24279,  24812,  25330,  25833,  26320,  26791,
+   27246,  27684,  28106,  28511,  28899,  29269,  29622,  29957,
+   30274,  30572,  30853,  31114,  31357,  31581,  31786,  31972,
+   32138,  32286,  32413,  32522,  32610,  32679,  32729,  32758,
+   32767,  32758,  32729,  32679,  32610,  32522,  32413,  32286,
+   32138,  31972,  31786,  31581,  31357,  31114,  30853,  30572,
+   30274,  29957,  29622,  29269,  28899,  28511,  28106,  27684,
+   27246,  26791,  26320,  25833,  25330,  24812,  24279,  23732,
+   23170,  22595,  22006,  21403,  20788,  20160,  19520,  18868,
+   18205,  17531,  16846,  16151,  15447,  14733,  14010,  13279,
+   12540,  11793,  11039,  10279,   9512,   8740,   7962,   7180,
+    6393,   5602,   4808,   4011,   3212,   2411,   1608,    804,
+       0,   -804,  -1608,  -2411,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7180,  -7962,  -8740,  -9512, -10279, -11039, -11793,
+  -12540, -13279, -14010, -14733, -15447, -16151, -16846, -17531,
+  -18205, -18868, -19520, -20160, -20788, -21403, -22006, -22595,
+  -23170, -23732, -24279, -24812, -25330, -25833, -26320, -26791,
+  -27246, -27684, -28106, -28511, -28899, -29269, -29622, -29957,
+  -30274, -30572, -30853, -31114, -31357, -31581, -31786, -31972,
+  -32138, -32286, -32413, -32522, -32610, -32679, -32729, -32758,
+  -32768, -32758, -32729, -32679, -32610, -32522, -32413, -32286,
+  -32138, -31972, -31786, -31581, -31357, -31114, -30853, -30572,
+  -30274, -29957, -29622, -29269, -28899, -28511, -28106, -27684,
+  -27246, -26791, -26320, -25833, -25330, -24812, -24279, -23732,
+  -23170, -22595, -22006, -21403, -20788, -20160, -19520, -18868,
+  -18205, -17531, -16846, -16151, -15447, -14733, -14010, -13279,
+  -12540, -11793, -11039, -10279,  -9512,  -8740,  -7962,  -7180,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2411,  -1608,   -804,
+       0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: angle_to_phase
+ *
+ * Description:
+ *   Convert an angle in radians to a 16-bit phase.
+ *
+ ****************************************************************************/
+
+static uint16_t angle_to_phase(b16_t angle)
+{
+  /* Normalize angle to <0.0, 2PI> */
+
+  angle_norm_2pi_b16(&angle, 0, b16TWOPI);
+
+  return (uint16_t)(((uint32_t)angle * B16RAD_TO_PHASE +
+                     (((uint32_t)angle * B16RAD_TO_PHASE_FRAC) >> 8) +
+                     0x8000) >> 16);
+}
+
+/****************************************************************************
+ * Name: phase_sin
+ *
+ * Description:
+ *   Get the sine of a 16-bit phase from the sine table with linear
+ *   interpolation between the table entries.
+ *
+ ****************************************************************************/
+
+static b16_t phase_sin(uint16_t phase)
+{
+  uint16_t i    = phase >> 8;
+  int32_t  frac = phase & 0xff;
+  int32_t  sin;
+
+  sin = g_sin_q15[i] +
+        (((g_sin_q15[i + 1] - g_sin_q15[i]) * frac + 0x80) >> 8);
+
+  /* Q15 to b16 */
+
+  return (b16_t)(sin * 2);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: b16_saturate
+ *
+ * Description:
+ *   Saturate b16 number
+ *
+ * Input Parameters:
+ *   val - pointer to b16 number
+ *   min - lower limit
+ *   max - upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void b16_saturate(FAR b16_t *val, b16_t min, b16_t max)
+{
+  if (*val < min)
+    {
+      *val = min;
+    }
+  else if (*val > max)
+    {
+      *val = max;
+    }
+}
+
+/****************************************************************************
+ * Name: vector2d_mag_b16
+ *
+ * Description:
+ *   Get 2D vector magnitude.  The squared magnitude must fit in b16.
+ *
+ * Input Parameters:
+ *   x   - (in) vector x component
+ *   y   - (in) vector y component
+ *
+ * Returned Value:
+ *   Return 2D vector magnitude
+ *
+ ****************************************************************************/
+
+b16_t vector2d_mag_b16(b16_t x, b16_t y)
+{
+  return (b16_t)ub16sqrtub16((ub16_t)(b16sqr(x) + b16sqr(y)));
+}
+
+/****************************************************************************
+ * Name: vector2d_saturate_b16
+ *
+ * Description:
+ *   Saturate 2D vector magnitude.  The squared magnitudes are compared
+ *   first, so the square root is only needed if the vector is saturated.
+ *
+ * Input Parameters:
+ *   x   - (in/out) pointer to the vector x component
+ *   y   - (in/out) pointer to the vector y component
+ *   max - (in) maximum vector magnitude
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vector2d_saturate_b16(FAR b16_t *x, FAR b16_t *y, b16_t max)
+{
+  ub16_t sq;
+  b16_t mag;
+  b16_t tmp;
+
+  sq = (ub16_t)(b16sqr(*x) + b16sqr(*y));
+  if (sq > (ub16_t)b16sqr(max))
+    {
+      mag = (b16_t)ub16sqrtub16(sq);
+      if (mag > max)
+        {
+          /* Saturate vector */
+
+          tmp = b16divb16(max, mag);
+          *x  = b16mulb16(*x, tmp);
+          *y  = b16mulb16(*y, tmp);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dq_mag_b16
+ *
+ * Description:
+ *   Get DQ vector magnitude.
+ *
+ ****************************************************************************/
+
+b16_t dq_mag_b16(FAR dq_frame_b16_t *dq)
+{
+  return vector2d_mag_b16(dq->d, dq->q);
+}
+
+/****************************************************************************
+ * Name: dq_saturate_b16
+ *
+ * Description:
+ *   Saturate dq frame vector magnitude.
+ *
+ ****************************************************************************/
+
+void dq_saturate_b16(FAR dq_frame_b16_t *dq, b16_t max)
+{
+  vector2d_saturate_b16(&dq->d, &dq->q, max);
+}
+
+/****************************************************************************
+ * Name: fast_sin_b16
+ *
+ * Description:
+ *   Fast sin calculation from a 256 entry table with linear interpolation.
+ *   The error is about 1e-4 for angles in <0, 2PI>.  Angles outside that
+ *   range are normalized with b16TWOPI, which adds a small error per turn.
+ *
+ * Input Parameters:
+ *   angle - (in) angle in radians
+ *
+ * Returned Value:
+ *   Return estimated sine value
+ *
+ ****************************************************************************/
+
+b16_t fast_sin_b16(b16_t angle)
+{
+  return phase_sin(angle_to_phase(angle));
+}
+
+/****************************************************************************
+ * Name: fast_cos_b16
+ *
+ * Description:
+ *   Fast cos calculation.  See fast_sin_b16().
+ *
+ ****************************************************************************/
+
+b16_t fast_cos_b16(b16_t angle)
+{
+  /* cos(x) = sin(x + PI/2) */
+
+  return phase_sin((uint16_t)(angle_to_phase(angle) + 0x4000));
+}
+
+/****************************************************************************
+ * Name: angle_norm_2pi_b16
+ *
+ * Description:
+ *   Normalize radians angle with period 2*PI to a given boundary.
+ *
+ * Input Parameters:
+ *   angle  - (in/out) pointer to the angle data
+ *   bottom - (in) lower limit
+ *   top    - (in) upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void angle_norm_2pi_b16(FAR b16_t *angle, b16_t bottom, b16_t top)
+{
+  while (*angle > top)
+    {
+      *angle -= b16TWOPI;
+    }
+
+  while (*angle < bottom)
+    {
+      *angle += b16TWOPI;
+    }
+}
+
+/****************************************************************************
+ * Name: phase_angle_update_b16
+ *
+ * Description:
+ *   Update phase_angle_b16_s structure:
+ *     1. normalize angle value to <0.0, 2PI> range
+ *     2. update angle value
+ *     3. update sin/cos value for given angle
+ *
+ * Input Parameters:
+ *   angle - (in/out) pointer to the angle data
+ *   val   - (in) angle radian value
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val)
+{
+  uint16_t phase;
+
+  DEBUGASSERT(angle != NULL);
+
+  /* Normalize angle to <0.0, 2PI> */
+
+  angle_norm_2pi_b16(&val, 0, b16TWOPI);
+
+  /* Update structure.  sin and cos share the phase computation. */
+
+  phase        = angle_to_phase(val);
+  angle->angle = val;
+  angle->sin   = phase_sin(phase);
+  angle->cos   = phase_sin((uint16_t)(phase + 0x4000));
+}
@@ -0,0 +1,363 @@
+/****************************************************************************
+ * libs/libdsp/lib_svm_b16.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <assert.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: svm3_sector_get_b16
+ *
+ * Description:
+ *   Get current sector for space vector modulation.  See
+ *   svm3_sector_get() in lib_svm.c.
+ *
+ ****************************************************************************/
+
+static uint8_t svm3_sector_get_b16(FAR abc_frame_b16_t *ijk)
+{
+  uint8_t sector = 0;
+  b16_t i = ijk->a;
+  b16_t j = ijk->b;
+  b16_t k = ijk->c;
+
+  if (k <= 0)
+    {
+      if (i <= 0)
+        {
+          sector = 2;
+        }
+      else
+        {
+          if (j <= 0)
+            {
+              sector = 6;
+            }
+          else
+            {
+              sector = 1;
+            }
+        }
+    }
+  else
+    {
+      if (i <= 0)
+        {
+          if (j <= 0)
+            {
+              sector = 4;
+            }
+          else
+            {
+              sector = 3;
+            }
+        }
+      else
+        {
+          sector = 5;
+        }
+    }
+
+  /* Return SVM sector */
+
+  return sector;
+}
+
+/****************************************************************************
+ * Name: svm3_duty_calc_b16
+ *
+ * Description:
+ *   Calculate duty cycles for space vector modulation.
+ *
+ ****************************************************************************/
+
+static void svm3_duty_calc_b16(FAR struct svm3_state_b16_s *s,
+                               FAR abc_frame_b16_t *ijk)
+{
+  b16_t i = ijk->a;
+  b16_t j = ijk->b;
+  b16_t k = ijk->c;
+  b16_t T0 = 0;
+  b16_t T1 = 0;
+  b16_t T2 = 0;
+  b16_t half;
+
+  /* Determine T1, T2 and T0 based on the sector */
+
+  switch (s->sector)
+    {
+      case 1:
+        {
+          T1 = i;
+          T2 = j;
+          break;
+        }
+      case 2:
+        {
+          T1 = -k;
+          T2 = -i;
+          break;
+        }
+      case 3:
+        {
+          T1 = j;
+          T2 = k;
+          break;
+        }
+      case 4:
+        {
+          T1 = -i;
+          T2 = -j;
+          break;
+        }
+      case 5:
+        {
+          T1 = k;
+          T2 = i;
+          break;
+        }
+      case 6:
+        {
+          T1 = -j;
+          T2 = -k;
+          break;
+        }
+      default:
+        {
+          /* We should not get here */
+
+          DEBUGASSERT(0);
+          break;
+        }
+    }
+
+  /* Get null vector time */
+
+  T0   = b16ONE - T1 - T2;
+  half = T0 >> 1;
+
+  /* Calculate duty cycle for 3 phase */
+
+  switch (s->sector)
+    {
+      case 1:
+        {
+          s->d_u = T1 + T2 + half;
+          s->d_v = T2 + half;
+          s->d_w = half;
+          break;
+        }
+      case 2:
+        {
+          s->d_u = T1 + half;
+          s->d_v = T1 + T2 + half;
+          s->d_w = half;
+          break;
+        }
+      case 3:
+        {
+          s->d_u = half;
+          s->d_v = T1 + T2 + half;
+          s->d_w = T2 + half;
+          break;
+        }
+      case 4:
+        {
+          s->d_u = half;
+          s->d_v = T1 + half;
+          s->d_w = T1 + T2 + half;
+          break;
+        }
+      case 5:
+        {
+          s->d_u = T2 + half;
+          s->d_v = half;
+          s->d_w = T1 + T2 + half;
+          break;
+        }
+      case 6:
+        {
+          s->d_u = T1 + T2 + half;
+          s->d_v = half;
+          s->d_w = T1 + half;
+          break;
+        }
+      default:
+        {
+          /* We should not get here */
+
+          DEBUGASSERT(0);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: svm3_b16
+ *
+ * Description:
+ *   One step of the fixed-point space vector modulation.  See svm3().
+ *
+ * Input Parameters:
+ *   s    - (out) pointer to the SVM data
+ *   v_ab - (in) pointer to the modulation voltage vector in alpha-beta
+ *          frame, normalized to magnitude (0.0 - 1.0)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *v_ab)
+{
+  abc_frame_b16_t ijk;
+
+  DEBUGASSERT(s != NULL);
+  DEBUGASSERT(v_ab != NULL);
+
+  /* Perform modified inverse Clarke-transformation (alpha,beta) -> (i,j,k)
+   * to obtain auxiliary frame which will be used in further calculations.
+   */
+
+  ijk.a = -(v_ab->b >> 1) + b16mulb16(SQRT3_BY_TWO_B16, v_ab->a);
+  ijk.b = v_ab->b;
+  ijk.c = -ijk.b - ijk.a;
+
+  /* Get vector sector */
+
+  s->sector = svm3_sector_get_b16(&ijk);
+
+  /* Get duty cycle */
+
+  svm3_duty_calc_b16(s, &ijk);
+
+  /* Saturate output from SVM */
+
+  b16_saturate(&s->d_u, s->d_min, s->d_max);
+  b16_saturate(&s->d_v, s->d_min, s->d_max);
+  b16_saturate(&s->d_w, s->d_min, s->d_max);
+}
+
+/****************************************************************************
+ * Name: svm3_current_correct_b16
+ *
+ * Description:
+ *   Correct ADC samples (int32) according to SVM3 state.  See
+ *   svm3_current_correct().
+ *
+ ****************************************************************************/
+
+void svm3_current_correct_b16(FAR struct svm3_state_b16_s *s,
+                              int32_t *c0, int32_t *c1, int32_t *c2)
+{
+  switch (s->sector)
+    {
+      case 1:
+      case 6:
+        {
+          /* Sector 1-6: ignore phase 1 */
+
+          *c0 = -(*c1 + *c2);
+          break;
+        }
+
+      case 2:
+      case 3:
+        {
+          /* Sector 2-3: ignore phase 2 */
+
+          *c1 = -(*c0 + *c2);
+          break;
+        }
+
+      case 4:
+      case 5:
+        {
+          /* Sector 4-5: ignore phase 3 */
+
+          *c2 = -(*c0 + *c1);
+          break;
+        }
+
+      default:
+        {
+          /* We should not get here. */
+
+          *c0 = 0;
+          *c1 = 0;
+          *c2 = 0;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: svm3_init_b16
+ *
+ * Description:
+ *   Initialize fixed-point 3-phase SVM data.
+ *
+ * Input Parameters:
+ *   s   - (in/out) pointer to the SVM state data
+ *   min - (in) minimum duty cycle
+ *   max - (in) maximum duty cycle
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void svm3_init_b16(FAR struct svm3_state_b16_s *s, b16_t min, b16_t max)
+{
+  DEBUGASSERT(s != NULL);
+  DEBUGASSERT(max > min);
+
+  memset(s, 0, sizeof(struct svm3_state_b16_s));
+
+  s->d_max = max;
+  s->d_min = min;
+}
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * libs/libdsp/lib_transform_b16.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_b16
+ *
+ * Description:
+ *   Fixed-point Clarke transform (abc frame -> ab frame).  See
+ *   clarke_transform().
+ *
+ ****************************************************************************/
+
+void clarke_transform_b16(FAR abc_frame_b16_t *abc,
+                          FAR ab_frame_b16_t *ab)
+{
+  DEBUGASSERT(abc != NULL);
+  DEBUGASSERT(ab != NULL);
+
+  ab->a = abc->a;
+  ab->b = b16mulb16(ONE_BY_SQRT3_B16, abc->a) +
+          b16mulb16(TWO_BY_SQRT3_B16, abc->b);
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_b16
+ *
+ * Description:
+ *   Fixed-point inverse Clarke transform (ab frame -> abc frame).  See
+ *   inv_clarke_transform().
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
+                              FAR abc_frame_b16_t *abc)
+{
+  DEBUGASSERT(ab != NULL);
+  DEBUGASSERT(abc != NULL);
+
+  /* Assume non-power-invariant transform and balanced system */
+
+  abc->a = ab->a;
+  abc->b = -(ab->a >> 1) + b16mulb16(SQRT3_BY_TWO_B16, ab->b);
+  abc->c = -abc->a - abc->b;
+}
+
+/****************************************************************************
+ * Name: park_transform_b16
+ *
+ * Description:
+ *   Fixed-point Park transform (ab frame -> dq frame).  See
+ *   park_transform().
+ *
+ ****************************************************************************/
+
+void park_transform_b16(FAR phase_angle_b16_t *angle,
+                        FAR ab_frame_b16_t *ab,
+                        FAR dq_frame_b16_t *dq)
+{
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(ab != NULL);
+  DEBUGASSERT(dq != NULL);
+
+  dq->d = b16mulb16(angle->cos, ab->a) + b16mulb16(angle->sin, ab->b);
+  dq->q = b16mulb16(angle->cos, ab->b) - b16mulb16(angle->sin, ab->a);
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_b16
+ *
+ * Description:
+ *   Fixed-point inverse Park transform (dq frame -> ab frame).  See
+ *   inv_park_transform().
+ *
+ ****************************************************************************/
+
+void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
+                            FAR dq_frame_b16_t *dq,
+                            FAR ab_frame_b16_t *ab)
+{
+  DEBUGASSERT(angle != NULL);
+  DEBUGASSERT(dq != NULL);
+  DEBUGASSERT(ab != NULL);
+
+  ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
+  ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
+}
@@ -0,0 +1,149 @@
+/****************************************************************************
+ * libs/libdsp/libdsp.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBDSP_LIBDSP_H
+#define __LIBS_LIBDSP_LIBDSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+#ifdef __ARM_NEON
+#  include <arm_neon.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The fixed-point kernels use the ARMv7E-M DSP extension instructions
+ * (Cortex-M4/M7) and the float kernels use NEON if the compiler reports
+ * that they are available for the selected CPU.
+ */
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#  define LIBDSP_HAVE_ARM_DSP 1
+#endif
+
+#if defined(__ARM_NEON) && __ARM_NEON
+#  define LIBDSP_HAVE_NEON 1
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_sat_q15
+ *
+ * Description:
+ *   Saturate a value to the Q15 range.
+ *
+ ****************************************************************************/
+
+static inline q15_t dsp_sat_q15(int64_t val)
+{
+  if (val > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (val < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (q15_t)val;
+}
+
+/****************************************************************************
+ * Name: dsp_sat_q31
+ *
+ * Description:
+ *   Saturate a value to the Q31 range.
+ *
+ ****************************************************************************/
+
+static inline q31_t dsp_sat_q31(int64_t val)
+{
+  if (val > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (val < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (q31_t)val;
+}
+
+#ifdef LIBDSP_HAVE_ARM_DSP
+/****************************************************************************
+ * Name: dsp_read_q15x2
+ *
+ * Description:
+ *   Read two adjacent Q15 values as one 32-bit word.  The values do not
+ *   need to be word aligned.
+ *
+ ****************************************************************************/
+
+static inline uint32_t dsp_read_q15x2(FAR const q15_t *ptr)
+{
+  uint32_t val;
+
+  memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+/****************************************************************************
+ * Name: dsp_smlald
+ *
+ * Description:
+ *   Dual 16-bit multiply with 64-bit accumulate:
+ *
+ *     acc + x[15:0] * y[15:0] + x[31:16] * y[31:16]
+ *
+ ****************************************************************************/
+
+static inline int64_t dsp_smlald(uint32_t x, uint32_t y, int64_t acc)
+{
+  __asm__ ("smlald %Q0, %R0, %1, %2" : "+r" (acc) : "r" (x), "r" (y));
+  return acc;
+}
+#endif /* LIBDSP_HAVE_ARM_DSP */
+
+#endif /* __LIBS_LIBDSP_LIBDSP_H */
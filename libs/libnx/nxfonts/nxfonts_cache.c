@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <semaphore.h>
 #include <assert.h>
@@ -51,6 +52,36 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Glyph edge smoothing needs the NX color blending functions for the pixel
+ * depth of the cache.
+ */
+
+#ifdef CONFIG_NXFONTS_ANTIALIASING
+#  if !defined(CONFIG_NXFONTS_DISABLE_16BPP) && \
+      !defined(CONFIG_NX_DISABLE_16BPP)
+#    define NXF_SMOOTH16BPP 1
+#  endif
+#  if !defined(CONFIG_NXFONTS_DISABLE_32BPP) && \
+      !defined(CONFIG_NX_DISABLE_32BPP)
+#    define NXF_SMOOTH32BPP 1
+#  endif
+#endif
+
+#if defined(NXF_SMOOTH16BPP) && defined(NXF_SMOOTH32BPP)
+#  define NXF_SMOOTHING 1
+#  define NXF_CANSMOOTH(bpp) ((bpp) == 16 || (bpp) == 32)
+#elif defined(NXF_SMOOTH16BPP)
+#  define NXF_SMOOTHING 1
+#  define NXF_CANSMOOTH(bpp) ((bpp) == 16)
+#elif defined(NXF_SMOOTH32BPP)
+#  define NXF_SMOOTHING 1
+#  define NXF_CANSMOOTH(bpp) ((bpp) == 32)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -504,6 +535,119 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
     }
 }
 
+#ifdef NXF_SMOOTHING
+/****************************************************************************
+ * Name: nxf_getbit
+ *
+ * Description:
+ *   Return true if the 1BPP font bitmap has a set bit at the glyph position
+ *   (row, col).  Positions outside of the font bitmap are never set.
+ *
+ ****************************************************************************/
+
+static inline bool nxf_getbit(FAR const struct nx_fontbitmap_s *fbm,
+                              int row, int col)
+{
+  row -= fbm->metric.yoffset;
+  col -= fbm->metric.xoffset;
+
+  if (row < 0 || row >= fbm->metric.height ||
+      col < 0 || col >= fbm->metric.width)
+    {
+      return false;
+    }
+
+  return (fbm->bitmap[row * fbm->metric.stride + (col >> 3)] &
+          (0x80 >> (col & 7))) != 0;
+}
+
+/****************************************************************************
+ * Name: nxf_smoothglyph
+ *
+ * Description:
+ *   Soften the stair steps of a rendered glyph.  The font bitmaps are only
+ *   1BPP so there is no real coverage information; instead, each
+ *   background pixel that sits in the inside corner of a step (i.e., has
+ *   two adjacent, orthogonal neighbors that are set) is replaced with a
+ *   blend of the foreground and background colors.  The more neighbors
+ *   that are set, the more foreground is blended in.  Straight edges and
+ *   the set pixels themselves are not changed so the glyphs stay sharp.
+ *
+ *   Since the background color of the cache is known, the blended glyph
+ *   can be copied as an opaque bitmap and the cost is paid only once when
+ *   the glyph is added to the cache.
+ *
+ * Assumptions:
+ *   The caller holds the font cache semaphore and the glyph has already
+ *   been rendered at 16 or 32 BPP.
+ *
+ ****************************************************************************/
+
+static void nxf_smoothglyph(FAR struct nxfonts_fcache_s *priv,
+                            FAR const struct nx_fontbitmap_s *fbm,
+                            FAR struct nxfonts_glyph_s *glyph)
+{
+  /* Foreground fraction by number of set, orthogonal neighbors */
+
+  static const ub16_t g_frac[5] =
+  {
+    0, 0, 0x6000, 0x8000, 0xa000
+  };
+
+  FAR uint8_t *line;
+  bool up;
+  bool down;
+  bool left;
+  bool right;
+  ub16_t frac;
+  int row;
+  int col;
+
+  line = glyph->bitmap;
+  for (row = 0; row < glyph->height; row++, line += glyph->stride)
+    {
+      for (col = 0; col < glyph->width; col++)
+        {
+          if (nxf_getbit(fbm, row, col))
+            {
+              continue;
+            }
+
+          up    = nxf_getbit(fbm, row - 1, col);
+          down  = nxf_getbit(fbm, row + 1, col);
+          left  = nxf_getbit(fbm, row, col - 1);
+          right = nxf_getbit(fbm, row, col + 1);
+
+          /* Only inside corners are blended */
+
+          if (!((up || down) && (left || right)))
+            {
+              continue;
+            }
+
+          frac = g_frac[up + down + left + right];
+
+#ifdef NXF_SMOOTH16BPP
+          if (priv->bpp == 16)
+            {
+              ((FAR uint16_t *)line)[col] =
+                nxglib_rgb565_blend((uint16_t)priv->fgcolor,
+                                    (uint16_t)priv->bgcolor, frac);
+            }
+#endif
+#ifdef NXF_SMOOTH32BPP
+          if (priv->bpp == 32)
+            {
+              ((FAR uint32_t *)line)[col] =
+                nxglib_rgb24_blend((uint32_t)priv->fgcolor,
+                                   (uint32_t)priv->bgcolor, frac);
+            }
+#endif
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxf_renderglyph
  *
@@ -571,6 +715,15 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
           return NULL;
         }
 
+#ifdef NXF_SMOOTHING
+      /* Soften the edges if the pixel depth supports blended colors */
+
+      if (NXF_CANSMOOTH(priv->bpp) && priv->fgcolor != priv->bgcolor)
+        {
+          nxf_smoothglyph(priv, fbm, glyph);
+        }
+#endif
+
       /* Add the new glyph to the font cache */
 
       nxf_addglyph(priv, glyph);
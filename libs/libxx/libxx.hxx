@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <cstddef>
+
 //***************************************************************************
 // Definitions
 //***************************************************************************
@@ -84,5 +86,12 @@ extern "C" FAR void *__dso_handle;
 //***************************************************************************
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
+extern "C" void __cxa_finalize(void *dso_handle);
+
+#ifdef CONFIG_CXX_NEWPOOL
+FAR void *libxx_pool_alloc(size_t nbytes);
+void libxx_pool_free(FAR void *ptr);
+void libxx_pool_free_sized(FAR void *ptr, size_t nbytes);
+#endif
 
 #endif // __LIBXX_LIBXX_HXX
@@ -40,6 +40,9 @@
 #include <nuttx/config.h>
 
 #include <cassert>
+#include <cstdint>
+#include <sched.h>
+#include <unistd.h>
 
 #include "libxx.hxx"
 
@@ -47,6 +50,11 @@
 // Pre-processor Definitions
 //***************************************************************************
 
+// Destructors are registered in blocks of this many entries.  Only one
+// on_exit() registration and one allocation is needed for each block.
+
+#define CXA_ATEXIT_NENTRIES 16
+
 //***************************************************************************
 // Private Types
 //***************************************************************************
@@ -55,12 +63,27 @@ struct __cxa_atexit_s
 {
   __cxa_exitfunc_t func;
   FAR void *arg;
+  FAR void *dso_handle;
+};
+
+struct __cxa_atexit_block_s
+{
+  FAR struct __cxa_atexit_block_s *flink;
+  pid_t pid;                        // Task that registered the entries
+  unsigned int nused;               // Number of entries used
+  struct __cxa_atexit_s entry[CXA_ATEXIT_NENTRIES];
 };
 
 //***************************************************************************
 // Private Data
 //***************************************************************************
 
+#ifdef CONFIG_SCHED_ONEXIT
+// All blocks, most recently allocated first
+
+static FAR struct __cxa_atexit_block_s *g_cxa_blocks;
+#endif
+
 extern "C"
 {
   //*************************************************************************
@@ -77,20 +100,46 @@ extern "C"
   // Name: __cxa_callback
   //
   // Description:
-  //   This is really just an "adaptor" function that matches the form of
-  //   the __cxa_exitfunc_t to an onexitfunc_t using an allocated structure
-  //   to marshall the call parameters.
+  //   This is the on_exit() function of one block of destructors.  Call the
+  //   destructors of the block in the reverse order of their registration,
+  //   then free the block.  Since on_exit() functions are also called in
+  //   reverse order, the most recent block is handled first.
   //
   //*************************************************************************
 
 #ifdef CONFIG_SCHED_ONEXIT
   static void __cxa_callback(int exitcode, FAR void *arg)
   {
-    FAR struct __cxa_atexit_s *alloc = (FAR struct __cxa_atexit_s *)arg;
-    DEBUGASSERT(alloc && alloc->func);
+    FAR struct __cxa_atexit_block_s *block =
+      (FAR struct __cxa_atexit_block_s *)arg;
+    FAR struct __cxa_atexit_block_s **prev;
+    int i;
+
+    DEBUGASSERT(block != NULL);
 
-    alloc->func(alloc->arg);
-    lib_free(alloc);
+    // Remove the block from the list so that it will not be used again
+
+    sched_lock();
+    for (prev = &g_cxa_blocks; *prev != NULL; prev = &(*prev)->flink)
+      {
+        if (*prev == block)
+          {
+            *prev = block->flink;
+            break;
+          }
+      }
+
+    sched_unlock();
+
+    for (i = (int)block->nused - 1; i >= 0; i--)
+      {
+        if (block->entry[i].func != NULL)
+          {
+            block->entry[i].func(block->entry[i].arg);
+          }
+      }
+
+    lib_free(block);
   }
 #endif
 
@@ -119,27 +168,109 @@ extern "C"
   int __cxa_atexit(__cxa_exitfunc_t func, FAR void *arg, FAR void *dso_handle)
     {
 #ifdef CONFIG_SCHED_ONEXIT
-      // Allocate memory to hold the marshaled __cxa_exitfunc_t call
-      // information.
+      FAR struct __cxa_atexit_block_s *block;
+      FAR struct __cxa_atexit_s *entry;
+      pid_t pid = getpid();
 
-      FAR struct __cxa_atexit_s *alloc =
-        (FAR struct __cxa_atexit_s *)lib_malloc(sizeof(struct __cxa_atexit_s));
+      // Find the most recent block of this task
 
-      if (alloc)
+      sched_lock();
+      for (block = g_cxa_blocks; block != NULL; block = block->flink)
         {
-          // Register the function to be called when the task/thread exists.
+          if (block->pid == pid)
+            {
+              break;
+            }
+        }
+
+      if (block == NULL || block->nused >= CXA_ATEXIT_NENTRIES)
+        {
+          int ret;
+
+          // Allocate a new block and register the function to be called
+          // when the task/thread exits.
+
+          block = (FAR struct __cxa_atexit_block_s *)
+            lib_malloc(sizeof(struct __cxa_atexit_block_s));
 
-          alloc->func = func;
-          alloc->arg  = arg;
+          if (block == NULL)
+            {
+              sched_unlock();
+              return -1;
+            }
 
-          return on_exit(__cxa_callback, alloc);
+          block->pid   = pid;
+          block->nused = 0;
+
+          ret = on_exit(__cxa_callback, block);
+          if (ret != 0)
+            {
+              sched_unlock();
+              lib_free(block);
+              return ret;
+            }
+
+          block->flink = g_cxa_blocks;
+          g_cxa_blocks = block;
         }
-      else
+
+      entry             = &block->entry[block->nused++];
+      entry->func       = func;
+      entry->arg        = arg;
+      entry->dso_handle = dso_handle;
+      sched_unlock();
 #endif
+
+      return 0;
+    }
+
+  //*************************************************************************
+  // Name: __cxa_finalize
+  //
+  // Description:
+  //   Call the destructors that this task registered for 'dso_handle' (or
+  //   all of its destructors if 'dso_handle' is NULL) in the reverse order
+  //   of their registration.  This should be called before a module that
+  //   registered destructors is unloaded.  Each destructor is called only
+  //   once.
+  //
+  //*************************************************************************
+
+  void __cxa_finalize(FAR void *dso_handle)
+    {
+#ifdef CONFIG_SCHED_ONEXIT
+      FAR struct __cxa_atexit_block_s *block;
+      pid_t pid = getpid();
+      int i;
+
+      sched_lock();
+      for (block = g_cxa_blocks; block != NULL; block = block->flink)
         {
-          // What else can we do?
+          if (block->pid != pid)
+            {
+              continue;
+            }
 
-          return 0;
+          for (i = (int)block->nused - 1; i >= 0; i--)
+            {
+              FAR struct __cxa_atexit_s *entry = &block->entry[i];
+              __cxa_exitfunc_t func = entry->func;
+
+              if (func != NULL &&
+                  (dso_handle == NULL || entry->dso_handle == dso_handle))
+                {
+                  // Our own blocks can only be freed when we exit, so the
+                  // lock may be released while the destructor runs.
+
+                  entry->func = NULL;
+                  sched_unlock();
+                  func(entry->arg);
+                  sched_lock();
+                }
+            }
         }
+
+      sched_unlock();
+#endif
     }
 }
@@ -68,7 +68,11 @@ void operator delete(FAR void *ptr, unsigned long size)
 void operator delete(FAR void *ptr, unsigned int size)
 #endif
 {
+#ifdef CONFIG_CXX_NEWPOOL
+  libxx_pool_free_sized(ptr, size);
+#else
   lib_free(ptr);
+#endif
 }
 
 #endif /* CONFIG_HAVE_CXX14 */
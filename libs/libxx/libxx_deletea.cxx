@@ -51,5 +51,9 @@
 
 void operator delete[](void *ptr)
 {
+#ifdef CONFIG_CXX_NEWPOOL
+  libxx_pool_free(ptr);
+#else
   lib_free(ptr);
+#endif
 }
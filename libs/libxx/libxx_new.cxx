@@ -68,6 +68,11 @@ void *operator new(unsigned long nbytes)
 void *operator new(unsigned int nbytes)
 #endif
 {
+#ifdef CONFIG_CXX_NEWPOOL
+  // Small objects come from the pool
+
+  void *alloc = libxx_pool_alloc(nbytes);
+#else
   // We have to allocate something
 
   if (nbytes < 1)
@@ -78,6 +83,7 @@ void *operator new(unsigned int nbytes)
   // Perform the allocation
 
   void *alloc = lib_malloc(nbytes);
+#endif
 
 #ifdef CONFIG_DEBUG_ERROR
   if (alloc == 0)
@@ -0,0 +1,249 @@
+//***************************************************************************
+// libs/libxx/libxx_newpool.cxx
+//
+//   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX nor the names of its contributors may be
+//    used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <sched.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_CXX_NEWPOOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The pool is a static arena divided into pages.  Each page is assigned to
+// one size class the first time that it is needed and is then split into
+// blocks of that size.  Blocks are recycled on a per-class free list and
+// pages are never returned to the heap.  Blocks carry no header:  The size
+// class of a block is found from the page that contains it.
+
+#define POOL_PAGESIZE     256
+#define POOL_NPAGES       (CONFIG_CXX_NEWPOOL_SIZE / POOL_PAGESIZE)
+#define POOL_NCLASSES     (CONFIG_CXX_NEWPOOL_MAXSIZE / 8)
+#define POOL_CLASS(n)     (((n) - 1) >> 3)
+#define POOL_BLKSIZE(c)   (((c) + 1) << 3)
+
+#if (CONFIG_CXX_NEWPOOL_MAXSIZE & 7) != 0 || \
+    CONFIG_CXX_NEWPOOL_MAXSIZE > POOL_PAGESIZE
+#  error CONFIG_CXX_NEWPOOL_MAXSIZE must be a multiple of 8 <= 256
+#endif
+
+#if POOL_NPAGES < 1 || POOL_NPAGES > 65535
+#  error CONFIG_CXX_NEWPOOL_SIZE is out of range
+#endif
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+struct pool_block_s
+{
+  FAR struct pool_block_s *flink;
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static uint64_t g_pool_arena[POOL_NPAGES * POOL_PAGESIZE / 8];
+static uint8_t g_pool_pageclass[POOL_NPAGES];
+static unsigned int g_pool_nextpage;
+static FAR struct pool_block_s *g_pool_freelist[POOL_NCLASSES];
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: pool_page
+//
+// Description:
+//   Return the index of the arena page containing 'ptr' or -1 if 'ptr' does
+//   not lie in the arena.
+//
+//***************************************************************************
+
+static inline int pool_page(FAR void *ptr)
+{
+  uintptr_t offset = (uintptr_t)ptr - (uintptr_t)g_pool_arena;
+
+  if (offset >= sizeof(g_pool_arena))
+    {
+      return -1;
+    }
+
+  return (int)(offset / POOL_PAGESIZE);
+}
+
+//***************************************************************************
+// Name: pool_release
+//
+// Description:
+//   Return a block to the free list of its size class.
+//
+//***************************************************************************
+
+static inline void pool_release(FAR void *ptr, int cls)
+{
+  FAR struct pool_block_s *blk = (FAR struct pool_block_s *)ptr;
+
+  sched_lock();
+  blk->flink = g_pool_freelist[cls];
+  g_pool_freelist[cls] = blk;
+  sched_unlock();
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_pool_alloc
+//
+// Description:
+//   Allocate memory for operator new.  Small requests are served from the
+//   pool; larger requests, or small requests when the arena is exhausted,
+//   are served from the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_pool_alloc(size_t nbytes)
+{
+  FAR struct pool_block_s *blk;
+  int cls;
+
+  if (nbytes < 1)
+    {
+      nbytes = 1;
+    }
+
+  if (nbytes > CONFIG_CXX_NEWPOOL_MAXSIZE)
+    {
+      return lib_malloc(nbytes);
+    }
+
+  cls = POOL_CLASS(nbytes);
+
+  sched_lock();
+  blk = g_pool_freelist[cls];
+  if (blk == NULL && g_pool_nextpage < POOL_NPAGES)
+    {
+      // Assign a new page to this size class and split it into blocks
+
+      FAR uint8_t *page = (FAR uint8_t *)g_pool_arena +
+                          g_pool_nextpage * POOL_PAGESIZE;
+      size_t blksize = POOL_BLKSIZE(cls);
+      size_t offset;
+
+      g_pool_pageclass[g_pool_nextpage++] = (uint8_t)cls;
+
+      for (offset = 0; offset + blksize <= POOL_PAGESIZE; offset += blksize)
+        {
+          FAR struct pool_block_s *next =
+            (FAR struct pool_block_s *)(page + offset);
+
+          next->flink = blk;
+          blk = next;
+        }
+    }
+
+  if (blk != NULL)
+    {
+      g_pool_freelist[cls] = blk->flink;
+    }
+
+  sched_unlock();
+
+  if (blk == NULL)
+    {
+      return lib_malloc(nbytes);
+    }
+
+  return blk;
+}
+
+//***************************************************************************
+// Name: libxx_pool_free
+//
+// Description:
+//   Free memory allocated by libxx_pool_alloc() when the size is not known.
+//
+//***************************************************************************
+
+void libxx_pool_free(FAR void *ptr)
+{
+  int page = pool_page(ptr);
+
+  if (page < 0)
+    {
+      lib_free(ptr);
+    }
+  else
+    {
+      pool_release(ptr, g_pool_pageclass[page]);
+    }
+}
+
+//***************************************************************************
+// Name: libxx_pool_free_sized
+//
+// Description:
+//   Free memory allocated by libxx_pool_alloc() for a request of 'nbytes'.
+//   The size class follows from the size so the page table is not needed
+//   and large blocks go straight back to the heap.
+//
+//***************************************************************************
+
+void libxx_pool_free_sized(FAR void *ptr, size_t nbytes)
+{
+  if (nbytes > CONFIG_CXX_NEWPOOL_MAXSIZE || pool_page(ptr) < 0)
+    {
+      lib_free(ptr);
+    }
+  else
+    {
+      pool_release(ptr, POOL_CLASS(nbytes < 1 ? 1 : nbytes));
+    }
+}
+
+#endif // CONFIG_CXX_NEWPOOL
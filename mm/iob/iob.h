@@ -83,6 +83,43 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The consumer of an I/O buffer chain */
+
+#ifdef CONFIG_IOB_QUOTA
+#  define IOB_USER(iob)  ((enum iob_user_e)(iob)->io_user)
+#else
+#  define IOB_USER(iob)  IOBUSER_UNKNOWN
+#endif
+
+/* True if the I/O buffer is a large I/O buffer */
+
+#if CONFIG_IOB_NLARGE > 0
+#  define IOB_ISLARGE(iob) ((iob)->io_bufsize > CONFIG_IOB_BUFSIZE)
+#endif
+
+/* True if the small I/O buffer was allocated from the heap */
+
+#if CONFIG_IOB_GROW_MAX > 0
+#  define IOB_GROWN(iob) \
+     ((iob) < &g_iob_pool[0] || (iob) >= &g_iob_pool[CONFIG_IOB_NBUFFERS])
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+/* Per-consumer I/O buffer accounting */
+
+struct iob_quota_s
+{
+  int16_t iq_inuse;     /* Number of I/O buffers held by the consumer */
+  int16_t iq_peak;      /* Largest number ever held by the consumer */
+  int16_t iq_limit;     /* The quota.  Zero means no quota */
+  sem_t   iq_sem;       /* Counts the I/O buffers remaining in the quota */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +152,32 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#if CONFIG_IOB_NLARGE > 0
+/* A list of all free, unallocated large I/O buffers and their number */
+
+extern FAR struct iob_s *g_iob_lfreelist;
+extern int16_t g_iob_nlfree;
+#endif
+
+#if CONFIG_IOB_GROW_MAX > 0
+/* The pre-allocated I/O buffers and the number of additional I/O buffers
+ * currently allocated from the heap.
+ */
+
+#ifdef CONFIG_MM_PLACE_IOB
+extern FAR struct iob_s *g_iob_pool;
+#else
+extern struct iob_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+#endif
+extern int16_t g_iob_ngrown;
+#endif
+
+#ifdef CONFIG_IOB_QUOTA
+/* Accounting for each consumer of I/O buffers */
+
+extern struct iob_quota_s g_iob_quota[IOBUSER_NENTRIES];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -178,5 +241,24 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_lowater_signal
+ *
+ * Description:
+ *   The number of free IOBs has fallen to the low watermark.  Execute all
+ *   of the workers registered with iob_lowater_setup().
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_IOB_NOTIFIER) && CONFIG_IOB_LOWATER > 0
+void iob_lowater_signal(void);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -37,6 +37,7 @@
  * Included Files
  ****************************************************************************/
 
+
 #include <nuttx/config.h>
 
 #include <semaphore.h>
@@ -46,6 +47,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -54,6 +56,99 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_reset
+ *
+ * Description:
+ *   Put a newly allocated I/O buffer in a known state.
+ *
+ ****************************************************************************/
+
+static inline void iob_reset(FAR struct iob_s *iob)
+{
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_REFCOUNT
+  iob->io_refs   = 1;    /* Only the allocator holds a reference */
+  iob->io_shares = 0;    /* The chain is not shared */
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_account
+ *
+ * Description:
+ *   Account for an allocated I/O buffer against its consumer.  This must be
+ *   called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+static inline void iob_account(FAR struct iob_s *iob, enum iob_user_e user)
+{
+  FAR struct iob_quota_s *quota = &g_iob_quota[user];
+
+  iob->io_user = (uint8_t)user;
+  if (++quota->iq_inuse > quota->iq_peak)
+    {
+      quota->iq_peak = quota->iq_inuse;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_grow
+ *
+ * Description:
+ *   Allocate an additional I/O buffer from the heap.  This may only be
+ *   called from thread context.  The new buffer does not pass through the
+ *   free list; it joins the free list only when it is freed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_GROW_MAX > 0
+static FAR struct iob_s *iob_grow(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  /* Reserve a slot so that concurrent callers cannot exceed the limit */
+
+  flags = enter_critical_section();
+  if (g_iob_ngrown >= CONFIG_IOB_GROW_MAX)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  g_iob_ngrown++;
+  leave_critical_section(flags);
+
+#if CONFIG_IOB_ALIGNMENT > 0
+  iob = (FAR struct iob_s *)kmm_memalign(CONFIG_IOB_ALIGNMENT,
+                                         sizeof(struct iob_s));
+#else
+  iob = (FAR struct iob_s *)kmm_malloc(sizeof(struct iob_s));
+#endif
+  if (iob == NULL)
+    {
+      flags = enter_critical_section();
+      g_iob_ngrown--;
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  iobinfo("Grew I/O buffer pool: iob=%p ngrown=%d\n", iob, g_iob_ngrown);
+#if CONFIG_IOB_NLARGE > 0
+  iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+#endif
+  iob_reset(iob);
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -85,16 +180,223 @@ static FAR struct iob_s *iob_alloc_committed(void)
 
       /* Put the I/O buffer in a known state */
 
-      iob->io_flink  = NULL; /* Not in a chain */
-      iob->io_len    = 0;    /* Length of the data in the entry */
-      iob->io_offset = 0;    /* Offset to the beginning of data */
-      iob->io_pktlen = 0;    /* Total length of the packet */
+      iob_reset(iob);
     }
 
   leave_critical_section(flags);
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   free list without waiting for a buffer to become free.  If the free
+ *   list is exhausted, an un-throttled allocation from thread context may
+ *   allocate an additional buffer from the heap.  No consumer accounting
+ *   is performed.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          g_iob_sem.semcount--;
+          DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is a little more complicated because
+           * it can be negative!  Decrementing is still safe, however.
+           */
+
+          g_throttle_sem.semcount--;
+          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+
+#if defined(CONFIG_IOB_NOTIFIER) && CONFIG_IOB_LOWATER > 0
+          /* Let interested consumers know if the free I/O buffers just
+           * fell to the low watermark.
+           */
+
+          if (g_iob_sem.semcount == CONFIG_IOB_LOWATER)
+            {
+              iob_lowater_signal();
+            }
+#endif
+
+          leave_critical_section(flags);
+
+          /* Put the I/O buffer in a known state */
+
+          iob_reset(iob);
+          return iob;
+        }
+    }
+
+  leave_critical_section(flags);
+
+#if CONFIG_IOB_GROW_MAX > 0
+  /* The free list is exhausted.  Throttled allocations must not grow the
+   * pool and the heap cannot be used from interrupt level or from the
+   * IDLE thread.
+   */
+
+  if (!throttled && !up_interrupt_context() && !sched_idletask())
+    {
+      return iob_grow();
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate a large I/O buffer by taking the buffer at the head of
+ *   the large free list.  Large I/O buffers are never waited for.  No
+ *   consumer accounting is performed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NLARGE > 0
+static FAR struct iob_s *iob_tryalloc_large(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = g_iob_lfreelist;
+  if (iob != NULL)
+    {
+      g_iob_lfreelist = iob->io_flink;
+      g_iob_nlfree--;
+      DEBUGASSERT(g_iob_nlfree >= 0);
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      iob_reset(iob);
+    }
+
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_class
+ *
+ * Description:
+ *   Try to allocate a small or a large I/O buffer on behalf of the
+ *   consumer 'user' without waiting.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_class(bool throttled,
+                                            enum iob_user_e user, bool large)
+{
+  FAR struct iob_s *iob;
+#ifdef CONFIG_IOB_QUOTA
+  FAR struct iob_quota_s *quota;
+  irqstate_t flags;
+
+  DEBUGASSERT((unsigned int)user < IOBUSER_NENTRIES);
+  quota = &g_iob_quota[user];
+
+  flags = enter_critical_section();
+
+  /* Does the consumer already hold its quota of I/O buffers? */
+
+  if (quota->iq_limit > 0 && quota->iq_sem.semcount <= 0)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+#endif
+
+#if CONFIG_IOB_NLARGE > 0
+  if (large)
+    {
+      iob = iob_tryalloc_large();
+    }
+  else
+#endif
+    {
+      iob = iob_tryalloc_internal(throttled);
+    }
+
+#ifdef CONFIG_IOB_QUOTA
+  if (iob != NULL)
+    {
+      /* Take a count from the quota.  As in iob_tryalloc_internal(), a
+       * simple decrement is sufficient because we know that the count is
+       * positive.
+       */
+
+      if (quota->iq_limit > 0)
+        {
+          quota->iq_sem.semcount--;
+        }
+
+      iob_account(iob, user);
+    }
+
+  leave_critical_section(flags);
+#else
+  UNUSED(user);
+#endif
+
+  UNUSED(large);
+  return iob;
+}
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -104,11 +406,14 @@ static FAR struct iob_s *iob_alloc_committed(void)
  *
  ****************************************************************************/
 
-static FAR struct iob_s *iob_allocwait(bool throttled)
+static FAR struct iob_s *iob_allocwait(bool throttled, enum iob_user_e user)
 {
-  FAR struct iob_s *iob;
+  FAR struct iob_s *iob = NULL;
   irqstate_t flags;
   FAR sem_t *sem;
+#ifdef CONFIG_IOB_QUOTA
+  FAR struct iob_quota_s *quota = &g_iob_quota[user];
+#endif
   int ret = OK;
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -127,11 +432,33 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_IOB_QUOTA
+  /* If the consumer has a quota, then wait until it holds fewer buffers
+   * than its quota.  The count taken here is returned when the I/O buffer
+   * is freed.
+   */
+
+  if (quota->iq_limit > 0)
+    {
+      do
+        {
+          ret = nxsem_wait(&quota->iq_sem);
+        }
+      while (ret == -EINTR);
+
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return NULL;
+        }
+    }
+#endif
+
   /* Try to get an I/O buffer.  If successful, the semaphore count will be
    * decremented atomically.
    */
 
-  iob = iob_tryalloc(throttled);
+  iob = iob_tryalloc_internal(throttled);
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -183,11 +510,24 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
                */
 
               nxsem_post(sem);
-              iob = iob_tryalloc(throttled);
+              iob = iob_tryalloc_internal(throttled);
             }
         }
     }
 
+#ifdef CONFIG_IOB_QUOTA
+  if (iob != NULL)
+    {
+      iob_account(iob, user);
+    }
+  else if (quota->iq_limit > 0)
+    {
+      /* Return the quota count that we took above */
+
+      nxsem_post(&quota->iq_sem);
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -206,99 +546,126 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
 
 FAR struct iob_s *iob_alloc(bool throttled)
 {
+  return iob_alloc_user(throttled, IOBUSER_UNKNOWN);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   free list without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc(bool throttled)
+{
+  return iob_tryalloc_user(throttled, IOBUSER_UNKNOWN);
+}
+
+/****************************************************************************
+ * Name: iob_alloc_user
+ *
+ * Description:
+ *   Allocate an I/O buffer on behalf of the consumer 'user', waiting if
+ *   necessary for a buffer to become free or for the consumer to fall back
+ *   under its quota.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_user(bool throttled, enum iob_user_e user)
+{
+  DEBUGASSERT((unsigned int)user < IOBUSER_NENTRIES);
+
   /* Were we called from the interrupt level? */
 
   if (up_interrupt_context() || sched_idletask())
     {
       /* Yes, then try to allocate an I/O buffer without waiting */
 
-      return iob_tryalloc(throttled);
+      return iob_tryalloc_user(throttled, user);
     }
   else
     {
       /* Then allocate an I/O buffer, waiting as necessary */
 
-      return iob_allocwait(throttled);
+      return iob_allocwait(throttled, user);
     }
 }
 
 /****************************************************************************
- * Name: iob_tryalloc
+ * Name: iob_tryalloc_user
  *
  * Description:
- *   Try to allocate an I/O buffer by taking the buffer at the head of the
- *   free list without waiting for a buffer to become free.
+ *   Try to allocate an I/O buffer on behalf of the consumer 'user' without
+ *   waiting.  NULL is returned if there is no free buffer or if the
+ *   consumer already holds its quota of buffers.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_tryalloc(bool throttled)
+FAR struct iob_s *iob_tryalloc_user(bool throttled, enum iob_user_e user)
 {
-  FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
-  FAR sem_t *sem;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the semaphore count to check. */
-
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
-#endif
-
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
+  return iob_tryalloc_class(throttled, user, false);
+}
 
-  flags = enter_critical_section();
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for 'size' bytes of data on behalf of the
+ *   consumer 'user'.  If 'size' exceeds CONFIG_IOB_BUFSIZE and a large I/O
+ *   buffer is free, then a large I/O buffer is returned.  Otherwise this
+ *   is the same as iob_alloc_user().  The returned buffer may be smaller
+ *   than 'size'; see IOB_BUFSIZE().
+ *
+ ****************************************************************************/
 
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
+FAR struct iob_s *iob_alloc_size(bool throttled, enum iob_user_e user,
+                                 unsigned int size)
+{
+#if CONFIG_IOB_NLARGE > 0
+  FAR struct iob_s *iob;
 
-  if (sem->semcount > 0)
-#endif
+  if (size > CONFIG_IOB_BUFSIZE)
     {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
+      iob = iob_tryalloc_class(throttled, user, true);
       if (iob != NULL)
         {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
-
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+          return iob;
+        }
+    }
+#else
+  UNUSED(size);
+#endif
 
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
+  return iob_alloc_user(throttled, user);
+}
 
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
-#endif
-          leave_critical_section(flags);
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but never waits for a buffer to become free.
+ *
+ ****************************************************************************/
 
-          /* Put the I/O buffer in a known state */
+FAR struct iob_s *iob_tryalloc_size(bool throttled, enum iob_user_e user,
+                                    unsigned int size)
+{
+#if CONFIG_IOB_NLARGE > 0
+  FAR struct iob_s *iob;
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_class(throttled, user, true);
+      if (iob != NULL)
+        {
           return iob;
         }
     }
+#else
+  UNUSED(size);
+#endif
 
-  leave_critical_section(flags);
-  return NULL;
+  return iob_tryalloc_class(throttled, user, false);
 }
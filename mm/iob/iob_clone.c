@@ -77,6 +77,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
   unsigned int avail2;
   unsigned int offset1;
   unsigned int offset2;
+  unsigned int remaining;
 
   DEBUGASSERT(iob2->io_len == 0 && iob2->io_offset == 0 &&
               iob2->io_pktlen == 0 && iob2->io_flink == NULL);
@@ -84,6 +85,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
   /* Copy the total packet size from the I/O buffer at the head of the chain */
 
   iob2->io_pktlen = iob1->io_pktlen;
+  remaining       = iob1->io_pktlen;
 
   /* Handle special case where there are empty buffers at the head
    * the list.
@@ -113,7 +115,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        */
 
       dest   = &iob2->io_data[offset2];
-      avail2 = CONFIG_IOB_BUFSIZE - offset2;
+      avail2 = IOB_BUFSIZE(iob2) - offset2;
 
       /* Copy the smaller of the two and update the srce and destination
        * offsets.
@@ -122,8 +124,9 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
       ncopy = MIN(avail1, avail2);
       memcpy(dest, src, ncopy);
 
-      offset1 += ncopy;
-      offset2 += ncopy;
+      offset1   += ncopy;
+      offset2   += ncopy;
+      remaining -= MIN(ncopy, remaining);
 
       /* Have we taken all of the data from the source I/O buffer? */
 
@@ -150,15 +153,15 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        * transferred?
        */
 
-       if (offset2 >= CONFIG_IOB_BUFSIZE && iob1 != NULL)
+       if (offset2 >= IOB_BUFSIZE(iob2) && iob1 != NULL)
         {
           FAR struct iob_s *next;
 
-          /* Allocate new destination I/O buffer and hook it into the
-           * destination I/O buffer chain.
+          /* Allocate new destination I/O buffer, sized for the remaining
+           * data, and hook it into the destination I/O buffer chain.
            */
 
-          next = iob_alloc(throttled);
+          next = iob_alloc_size(throttled, IOB_USER(iob2), remaining);
           if (!next)
             {
               ioberr("ERROR: Failed to allocate an I/O buffer/n");
@@ -148,7 +148,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
               /* Yes.. We can extend this buffer to the up to the very end. */
 
-              maxlen = CONFIG_IOB_BUFSIZE - iob->io_offset;
+              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
@@ -204,11 +204,11 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
           if (!can_block || len < total)
             {
-              next = iob_tryalloc(throttled);
+              next = iob_tryalloc_size(throttled, IOB_USER(head), len);
             }
           else
             {
-              next = iob_alloc(throttled);
+              next = iob_alloc_size(throttled, IOB_USER(head), len);
             }
 
           if (next == NULL)
@@ -46,6 +46,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -89,6 +90,9 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
+#ifdef CONFIG_IOB_QUOTA
+  FAR struct iob_quota_s *quota;
+#endif
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
 #endif
@@ -135,6 +139,72 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_IOB_REFCOUNT
+  /* If some other user still holds a reference to the I/O buffer (see
+   * iob_addref()), then just drop the caller's reference.  The I/O buffer
+   * is removed from the caller's chain and the link is cleared so that
+   * the final iob_unref() does not follow it.
+   */
+
+  if (iob->io_refs > 1)
+    {
+      iob->io_refs--;
+      iob->io_flink = NULL;
+      leave_critical_section(flags);
+      return next;
+    }
+#endif
+
+#ifdef CONFIG_IOB_QUOTA
+  /* Return the I/O buffer to the quota of its consumer.  This may wake up
+   * a thread of that consumer that is waiting in iob_alloc_user().
+   */
+
+  quota = &g_iob_quota[iob->io_user];
+  quota->iq_inuse--;
+  DEBUGASSERT(quota->iq_inuse >= 0);
+
+  if (quota->iq_limit > 0)
+    {
+      nxsem_post(&quota->iq_sem);
+    }
+#endif
+
+#if CONFIG_IOB_NLARGE > 0
+  /* Large I/O buffers are returned to their own free list.  Nothing ever
+   * waits for a large I/O buffer.
+   */
+
+  if (IOB_ISLARGE(iob))
+    {
+      iob->io_flink   = g_iob_lfreelist;
+      g_iob_lfreelist = iob;
+      g_iob_nlfree++;
+      DEBUGASSERT(g_iob_nlfree <= CONFIG_IOB_NLARGE);
+
+      leave_critical_section(flags);
+      return next;
+    }
+#endif
+
+#if CONFIG_IOB_GROW_MAX > 0
+  /* If the I/O buffer came from the heap and at least half of the
+   * pre-allocated buffers are free (so no thread is waiting for one),
+   * then shrink the pool by returning the I/O buffer to the heap.
+   * sched_kfree() defers the free if we are at the interrupt level.
+   */
+
+  if (IOB_GROWN(iob) && g_iob_sem.semcount >= CONFIG_IOB_NBUFFERS / 2)
+    {
+      g_iob_ngrown--;
+      leave_critical_section(flags);
+
+      iobinfo("Shrank I/O buffer pool: iob=%p\n", iob);
+      sched_kfree(iob);
+      return next;
+    }
+#endif
+
   /* Which list?  If there is a task waiting for an IOB, then put
    * the IOB on either the free list or on the committed list where
    * it is reserved for that allocation (and not available to
@@ -159,7 +229,8 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
    */
 
   nxsem_post(&g_iob_sem);
-  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+  DEBUGASSERT(g_iob_sem.semcount <=
+              CONFIG_IOB_NBUFFERS + CONFIG_IOB_GROW_MAX);
 
 #if CONFIG_IOB_THROTTLE > 0
   nxsem_post(&g_throttle_sem);
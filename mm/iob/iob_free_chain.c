@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -53,13 +54,32 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  If the chain is shared (see iob_share_chain()), then
+ *   only the caller's hold on the chain is released.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next;
+#ifdef CONFIG_IOB_REFCOUNT
+  irqstate_t flags;
+
+  /* If other holders of the chain remain, then just drop our hold */
+
+  if (iob != NULL)
+    {
+      flags = enter_critical_section();
+      if (iob->io_shares > 0)
+        {
+          iob->io_shares--;
+          leave_critical_section(flags);
+          return;
+        }
+
+      leave_critical_section(flags);
+    }
+#endif
 
   /* Free each IOB in the chain -- one at a time to keep the count straight */
 
@@ -39,10 +39,13 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
+#include <assert.h>
 
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mm/place.h>
 
 #include "iob.h"
 
@@ -54,21 +57,98 @@
 #  define NULL ((FAR void *)0)
 #endif
 
+/* The size of one large I/O buffer in units of uintptr_t.  This is a
+ * struct iob_s with io_data[] extended to CONFIG_IOB_LARGE_BUFSIZE and
+ * keeps each large buffer aligned like struct iob_s.
+ */
+
+#if CONFIG_IOB_NLARGE > 0
+#  define IOB_LARGE_SIZE \
+     IOB_ALIGNUP(sizeof(struct iob_s) - IOB_DATASIZE + \
+                 CONFIG_IOB_LARGE_BUFSIZE)
+#  define IOB_LARGE_NWORDS \
+     ((IOB_LARGE_SIZE + sizeof(uintptr_t) - 1) / sizeof(uintptr_t))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* This is a pool of pre-allocated I/O buffers */
-
-static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
 
+#if CONFIG_IOB_NLARGE > 0
+/* This is a pool of pre-allocated large I/O buffers */
+
+#if CONFIG_IOB_ALIGNMENT > 0
+static uintptr_t g_iob_lpool[CONFIG_IOB_NLARGE][IOB_LARGE_NWORDS]
+  __attribute__ ((aligned(CONFIG_IOB_ALIGNMENT)));
+#else
+static uintptr_t g_iob_lpool[CONFIG_IOB_NLARGE][IOB_LARGE_NWORDS];
+#endif
+#endif
+
+#ifdef CONFIG_IOB_QUOTA
+/* The configured quota of each consumer */
+
+static const int16_t g_iob_limits[IOBUSER_NENTRIES] =
+{
+  0,                                  /* IOBUSER_UNKNOWN */
+#ifdef CONFIG_IOB_QUOTA_TCP_RX
+  CONFIG_IOB_QUOTA_TCP_RX,            /* IOBUSER_NET_TCP_READAHEAD */
+#else
+  0,
+#endif
+#ifdef CONFIG_IOB_QUOTA_TCP_TX
+  CONFIG_IOB_QUOTA_TCP_TX,            /* IOBUSER_NET_TCP_WRITEBUFFER */
+#else
+  0,
+#endif
+#ifdef CONFIG_IOB_QUOTA_UDP
+  CONFIG_IOB_QUOTA_UDP,               /* IOBUSER_NET_UDP */
+#else
+  0,
+#endif
+#ifdef CONFIG_IOB_QUOTA_6LOWPAN
+  CONFIG_IOB_QUOTA_6LOWPAN,           /* IOBUSER_NET_6LOWPAN */
+#else
+  0,
+#endif
+#ifdef CONFIG_IOB_QUOTA_BLUETOOTH
+  CONFIG_IOB_QUOTA_BLUETOOTH          /* IOBUSER_WIRELESS_BLUETOOTH */
+#else
+  0
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+/* This is a pool of pre-allocated I/O buffers.  It may instead be
+ * allocated from fast memory when the pool is initialized.
+ */
+
+#ifdef CONFIG_MM_PLACE_IOB
+FAR struct iob_s *g_iob_pool;
+#else
+struct iob_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+#endif
+
+#if CONFIG_IOB_GROW_MAX > 0
+/* The number of I/O buffers currently allocated from the heap */
+
+int16_t g_iob_ngrown;
+#endif
+
+#ifdef CONFIG_IOB_QUOTA
+/* Accounting for each consumer of I/O buffers */
+
+struct iob_quota_s g_iob_quota[IOBUSER_NENTRIES];
+#endif
+
 /* A list of all free, unallocated I/O buffers */
 
 FAR struct iob_s *g_iob_freelist;
@@ -77,6 +157,13 @@ FAR struct iob_s *g_iob_freelist;
 
 FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_NLARGE > 0
+/* A list of all free, unallocated large I/O buffers and their number */
+
+FAR struct iob_s *g_iob_lfreelist;
+int16_t g_iob_nlfree;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -118,6 +205,23 @@ void iob_initialize(void)
 
   if (!initialized)
     {
+#ifdef CONFIG_MM_PLACE_IOB
+      /* Allocate the I/O buffers from fast memory if possible */
+
+#if CONFIG_IOB_ALIGNMENT > 0
+      g_iob_pool = (FAR struct iob_s *)
+        place_memalign(PLACE_FAST, CONFIG_IOB_ALIGNMENT,
+                       CONFIG_IOB_NBUFFERS * sizeof(struct iob_s));
+#else
+      g_iob_pool = (FAR struct iob_s *)
+        place_malloc(PLACE_FAST, CONFIG_IOB_NBUFFERS * sizeof(struct iob_s));
+#endif
+      if (g_iob_pool == NULL)
+        {
+          PANIC();
+        }
+
+#endif
       /* Add each I/O buffer to the free list */
 
       for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
@@ -126,12 +230,30 @@ void iob_initialize(void)
 
           /* Add the pre-allocate I/O buffer to the head of the free list */
 
+#if CONFIG_IOB_NLARGE > 0
+          iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+#endif
           iob->io_flink  = g_iob_freelist;
           g_iob_freelist = iob;
         }
 
       g_iob_committed = NULL;
 
+#if CONFIG_IOB_NLARGE > 0
+      /* Add each large I/O buffer to the large free list */
+
+      for (i = 0; i < CONFIG_IOB_NLARGE; i++)
+        {
+          FAR struct iob_s *iob = (FAR struct iob_s *)g_iob_lpool[i];
+
+          iob->io_bufsize = CONFIG_IOB_LARGE_BUFSIZE;
+          iob->io_flink   = g_iob_lfreelist;
+          g_iob_lfreelist = iob;
+        }
+
+      g_iob_nlfree = CONFIG_IOB_NLARGE;
+#endif
+
       nxsem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
 #if CONFIG_IOB_THROTTLE > 0
       nxsem_init(&g_throttle_sem, 0, CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE);
@@ -155,6 +277,22 @@ void iob_initialize(void)
       nxsem_init(&g_qentry_sem, 0, CONFIG_IOB_NCHAINS);
 #endif
 
+#ifdef CONFIG_IOB_QUOTA
+      /* Initialize the accounting for each consumer.  The semaphore of a
+       * consumer with a quota counts the buffers remaining in the quota.
+       */
+
+      for (i = 0; i < IOBUSER_NENTRIES; i++)
+        {
+          FAR struct iob_quota_s *quota = &g_iob_quota[i];
+
+          quota->iq_inuse = 0;
+          quota->iq_peak  = 0;
+          quota->iq_limit = g_iob_limits[i];
+          nxsem_init(&quota->iq_sem, 0, quota->iq_limit);
+        }
+#endif
+
       initialized = true;
     }
 }
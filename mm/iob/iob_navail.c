@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <assert.h>
 
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -120,3 +121,30 @@ int iob_qentry_navail(void)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: iob_user_inuse
+ *
+ * Description:
+ *   Return the number of IOBs currently held by the consumer 'user'.  The
+ *   peak number of IOBs ever held by that consumer is returned in 'peak' if
+ *   it is not NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+int iob_user_inuse(enum iob_user_e user, FAR int *peak)
+{
+  FAR struct iob_quota_s *quota;
+
+  DEBUGASSERT((unsigned int)user < IOBUSER_NENTRIES);
+  quota = &g_iob_quota[user];
+
+  if (peak != NULL)
+    {
+      *peak = quota->iq_peak;
+    }
+
+  return quota->iq_inuse;
+}
+#endif
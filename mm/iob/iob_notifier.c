@@ -106,6 +106,60 @@ int iob_notifier_setup(int qid, worker_t worker, FAR void *arg)
   return work_notifier_setup(&info);
 }
 
+/****************************************************************************
+ * Name: iob_lowater_setup
+ *
+ * Description:
+ *   Set up to perform a callback to the worker function when the number of
+ *   free IOBs falls to the low watermark, CONFIG_IOB_LOWATER.  The worker
+ *   function will execute on the selected priority worker thread.
+ *
+ * Input Parameters:
+ *   qid    - Selects work queue.  Must be HPWORK or LPWORK.
+ *   worker - The worker function to execute on the work queue when the
+ *            event occurs.
+ *   arg    - A user-defined argument that will be available to the worker
+ *            function when it runs.
+ *
+ * Returned Value:
+ *   > 0   - The notification is in place.  The returned value is a key
+ *           that may be used later in a call to iob_notifier_teardown().
+ *   == 0  - There are already no more than CONFIG_IOB_LOWATER free IOBs.
+ *           No notification will be provided.
+ *   < 0   - An unexpected error occurred and no notification will be
+ *           provided.  The returned value is a negated errno value that
+ *           indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LOWATER > 0
+int iob_lowater_setup(int qid, worker_t worker, FAR void *arg)
+{
+  struct work_notifier_s info;
+
+  DEBUGASSERT(worker != NULL);
+
+  /* If the free IOBs are already at or below the low watermark, then
+   * return zero without setting up the notification.
+   */
+
+  if (iob_navail(false) <= CONFIG_IOB_LOWATER)
+    {
+      return 0;
+    }
+
+  /* Otherwise, this is just a simple wrapper around work_notifer_setup(). */
+
+  info.evtype    = WORK_IOB_LOWATER;
+  info.qid       = qid;
+  info.qualifier = NULL;
+  info.arg       = arg;
+  info.worker    = worker;
+
+  return work_notifier_setup(&info);
+}
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_teardown
  *
@@ -159,4 +213,26 @@ void iob_notifier_signal(void)
   return work_notifier_signal(WORK_IOB_AVAIL, NULL);
 }
 
+/****************************************************************************
+ * Name: iob_lowater_signal
+ *
+ * Description:
+ *   The number of free IOBs has fallen to the low watermark.  Execute all
+ *   of the workers registered with iob_lowater_setup().
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LOWATER > 0
+void iob_lowater_signal(void)
+{
+  work_notifier_signal(WORK_IOB_LOWATER, NULL);
+}
+#endif
+
 #endif /* CONFIG_IOB_NOTIFIER */
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * mm/iob/iob_ref.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_REFCOUNT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_addref
+ *
+ * Description:
+ *   Take an additional reference to a single I/O buffer.  The I/O buffer
+ *   will not be returned to the free list until the reference is dropped
+ *   with iob_unref(), even if the owner of the chain containing it frees
+ *   it in the meantime.  The holder of the reference must not use the
+ *   io_flink link of the I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_addref(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT(iob->io_refs > 0 && iob->io_refs < UINT8_MAX);
+  iob->io_refs++;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_unref
+ *
+ * Description:
+ *   Drop a reference taken with iob_addref().  If this is the last
+ *   reference to the I/O buffer, then the I/O buffer is freed.
+ *
+ ****************************************************************************/
+
+void iob_unref(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT(iob->io_refs > 0);
+
+  if (iob->io_refs > 1)
+    {
+      /* The owner of the chain still holds the I/O buffer */
+
+      iob->io_refs--;
+      leave_critical_section(flags);
+    }
+  else
+    {
+      /* The owner already freed the I/O buffer and unlinked it from its
+       * chain.  Free it now.
+       */
+
+      leave_critical_section(flags);
+
+      DEBUGASSERT(iob->io_flink == NULL);
+      (void)iob_free(iob);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_share_chain
+ *
+ * Description:
+ *   Add another holder of an entire I/O buffer chain.  Each holder releases
+ *   the chain with iob_free_chain() and the chain is freed when the last
+ *   holder does so.  A shared chain is read-only:  No holder may modify,
+ *   trim, or extend it or free any I/O buffer in it individually.
+ *
+ *   Unlike iob_addref(), the links of the chain remain valid for every
+ *   holder.  The count is kept only in the head of the chain.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EMLINK is returned if the chain
+ *   already has the maximum number of holders.
+ *
+ ****************************************************************************/
+
+int iob_share_chain(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+  int ret = -EMLINK;
+
+  DEBUGASSERT(iob != NULL);
+
+  flags = enter_critical_section();
+  if (iob->io_shares < UINT8_MAX)
+    {
+      iob->io_shares++;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_IOB_REFCOUNT */
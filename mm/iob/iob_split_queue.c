@@ -0,0 +1,130 @@
+/****************************************************************************
+ * mm/iob/iob_split_queue.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_NCHAINS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef NULL
+#  define NULL ((FAR void *)0)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_split_queue
+ *
+ * Description:
+ *   Remove up to 'maxiobs' I/O buffers from the beginning of the I/O buffer
+ *   chain at the head of the queue and return them as a separate chain.
+ *   If the chain at the head of the queue contains no more than 'maxiobs'
+ *   I/O buffers, then the entire chain is removed from the queue just as
+ *   with iob_remove_queue().  Otherwise, the remainder of the chain stays
+ *   at the head of the queue.
+ *
+ * Returned Value:
+ *   The I/O buffer chain removed from the head of the queue.  NULL is
+ *   returned if the queue is empty or if 'maxiobs' is zero.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_split_queue(FAR struct iob_queue_s *iobq,
+                                  unsigned int maxiobs)
+{
+  FAR struct iob_qentry_s *qentry;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *last;
+  unsigned int pktlen;
+
+  /* Peek at the I/O buffer chain container at the head of the queue */
+
+  qentry = iobq->qh_head;
+  if (qentry == NULL || qentry->qe_head == NULL || maxiobs == 0)
+    {
+      return NULL;
+    }
+
+  /* Find the last I/O buffer to be removed */
+
+  iob    = qentry->qe_head;
+  last   = iob;
+  pktlen = last->io_len;
+
+  while (--maxiobs > 0 && last->io_flink != NULL)
+    {
+      last    = last->io_flink;
+      pktlen += last->io_len;
+    }
+
+  /* If that is the end of the chain, just remove the whole queue entry */
+
+  if (last->io_flink == NULL)
+    {
+      return iob_remove_queue(iobq);
+    }
+
+  /* Otherwise, break the chain.  The remainder becomes the new I/O buffer
+   * chain at the head of the queue.
+   */
+
+  DEBUGASSERT(iob->io_pktlen > pktlen);
+
+  qentry->qe_head            = last->io_flink;
+  qentry->qe_head->io_pktlen = iob->io_pktlen - pktlen;
+
+  last->io_flink             = NULL;
+  iob->io_pktlen             = pktlen;
+
+  return iob;
+}
+
+#endif /* CONFIG_IOB_NCHAINS > 0 */
@@ -47,6 +47,94 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find the first run of ngranules free granules.  This is used for
+ *   allocations larger than 32 granules which cannot be handled by the
+ *   mask-based search in gran_alloc().
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   ngranules - The number of contiguous granules needed
+ *
+ * Returned Value:
+ *   The address of the first granule in the run; zero if there is no
+ *   such run.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to the GAT.
+ *
+ ****************************************************************************/
+
+static uintptr_t gran_search(FAR struct gran_s *priv, unsigned int ngranules)
+{
+  unsigned int granidx = 0;
+  unsigned int start   = 0;
+  unsigned int nfree   = 0;
+  unsigned int nbits;
+  uint32_t     curr;
+
+  while (granidx < priv->ngranules)
+    {
+      curr = priv->gat[granidx >> 5];
+
+      /* Skip or accept a whole GAT entry at a time when possible */
+
+      if ((granidx & 31) == 0 && curr == 0xffffffff)
+        {
+          nfree    = 0;
+          granidx += 32;
+          continue;
+        }
+      else if ((granidx & 31) == 0 && curr == 0)
+        {
+          nbits = 32;
+        }
+      else if ((curr & (1 << (granidx & 31))) != 0)
+        {
+          nfree = 0;
+          granidx++;
+          continue;
+        }
+      else
+        {
+          nbits = 1;
+        }
+
+      /* Extend (or begin) the current run of free granules */
+
+      if (nfree == 0)
+        {
+          start = granidx;
+        }
+
+      nfree   += nbits;
+      granidx += nbits;
+
+      if (nfree >= ngranules)
+        {
+          /* The unused bits at the end of the last GAT entry are zero, so
+           * make sure that the run really lies within the heap.
+           */
+
+          if (start + ngranules > priv->ngranules)
+            {
+              break;
+            }
+
+          return priv->heapstart + (start << priv->log2gran);
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,9 +145,9 @@
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   Allocations of up to 32 granules are found with a fast, word-at-a-
+ *   time search of the GAT.  Larger allocations use a slower search for
+ *   a first fit run of free granules.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -85,7 +173,7 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
   int          bitidx;
   int          shift;
 
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL);
 
   if (priv != NULL && size > 0)
     {
@@ -98,9 +186,22 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
+      /* Large allocations require a search for a run of free granules */
+
+      if (ngranules > 32)
+        {
+          alloc = gran_search(priv, ngranules);
+          if (alloc != 0)
+            {
+              gran_mark_allocated(priv, alloc, ngranules);
+            }
+
+          gran_leave_critical(priv);
+          return (FAR void *)alloc;
+        }
+
+      /* Otherwise, create mask for that number of granules */
 
-      DEBUGASSERT(ngranules <= 32);
       mask = 0xffffffff >> (32 - ngranules);
 
       /* Now search the granule allocation table for that number of contiguous */
@@ -75,9 +75,10 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
   unsigned int granmask;
   unsigned int ngranules;
   unsigned int avail;
+  unsigned int nbits;
   uint32_t     gatmask;
 
-  DEBUGASSERT(priv != NULL && memory && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL && memory);
 
   /* Get exclusive access to the GAT */
 
@@ -99,38 +100,23 @@ void gran_free(GRAN_HANDLE handle, FAR void *memory, size_t size)
   granmask =  (1 << priv->log2gran) - 1;
   ngranules = (size + granmask) >> priv->log2gran;
 
-  /* Clear bits in the GAT entry or entries */
-
-  avail = 32 - gatbit;
-  if (ngranules > avail)
-    {
-      /* Clear bits in the first GAT entry */
-
-      gatmask = (0xffffffff << gatbit);
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
-      priv->gat[gatidx] &= ~gatmask;
-      ngranules -= avail;
-
-      /* Clear bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == gatmask);
-
-      priv->gat[gatidx+1] &= ~gatmask;
-    }
-
-  /* Handle the case where where all of the granules came from one entry */
+  /* Clear bits in each GAT entry spanned by the allocation.  Any part of
+   * an allocation may be freed, so this need not be the whole allocation.
+   */
 
-  else
+  while (ngranules > 0)
     {
-      /* Clear bits in a single GAT entry */
+      avail = 32 - gatbit;
+      nbits = ngranules < avail ? ngranules : avail;
 
-      gatmask   = 0xffffffff >> (32 - ngranules);
+      gatmask   = 0xffffffff >> (32 - nbits);
       gatmask <<= gatbit;
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
       priv->gat[gatidx] &= ~gatmask;
+      ngranules -= nbits;
+      gatidx++;
+      gatbit = 0;
     }
 
   gran_leave_critical(priv);
@@ -169,7 +169,7 @@ void mm_pgreserve(uintptr_t start, size_t size)
 
 uintptr_t mm_pgalloc(unsigned int npages)
 {
-  return (uintptr_t)gran_alloc(g_pgalloc, (size_t)1 << MM_PGSHIFT);
+  return (uintptr_t)gran_alloc(g_pgalloc, (size_t)npages << MM_PGSHIFT);
 }
 
 /****************************************************************************
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -82,3 +84,25 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
       next->blink = node;
     }
 }
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the node list.  It is assumed that the caller
+ *   holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  /* There must be a predecessor, but there may not be a successor node. */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
@@ -70,6 +70,12 @@ FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
       if (n <= (SIZE_MAX / elem_size))
         {
           ret = mm_zalloc(heap, n * elem_size);
+          if (ret != NULL)
+            {
+              MM_SETOWNER((FAR struct mm_allocnode_s *)
+                          ((FAR char *)ret - SIZEOF_MM_ALLOCNODE),
+                          MM_CALLER());
+            }
         }
     }
 
@@ -0,0 +1,361 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef MM_USE_CPUCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_CPUCACHE_BATCH < 1 || \
+    CONFIG_MM_CPUCACHE_BATCH > CONFIG_MM_CPUCACHE_DEPTH
+#  error CONFIG_MM_CPUCACHE_BATCH must be in the range 1..CONFIG_MM_CPUCACHE_DEPTH
+#endif
+
+#if CONFIG_MM_CPUCACHE_DEPTH > 255
+#  error CONFIG_MM_CPUCACHE_DEPTH is too large
+#endif
+
+/* Only chunks that can hold the cache link are cached */
+
+#define MM_CPUCACHE_CACHEABLE(s) \
+  ((s) >= SIZEOF_MM_FREENODE && (s) <= CONFIG_MM_CPUCACHE_MAXSIZE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_get
+ *
+ * Description:
+ *   Return the cache for the current CPU.  Local interrupts must be
+ *   disabled so that the caller cannot migrate to a different CPU.
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_cpucache_s *
+mm_cpucache_get(FAR struct mm_heap_s *heap)
+{
+  return &heap->mm_cpucache[up_cpu_index()];
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_release
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap.
+ *
+ ****************************************************************************/
+
+static void mm_cpucache_release(FAR struct mm_heap_s *heap,
+                                FAR struct mm_freenode_s *list)
+{
+  FAR struct mm_freenode_s *next;
+
+  mm_takesemaphore(heap);
+  for (; list != NULL; list = next)
+    {
+      next = list->flink;
+      mm_freechunk(heap, (FAR struct mm_allocnode_s *)list);
+    }
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_alloc
+ *
+ * Description:
+ *   Allocate a chunk from the cache of the current CPU without taking the
+ *   MM semaphore.  If the size class is empty, it is refilled from the heap
+ *   with CONFIG_MM_CPUCACHE_BATCH chunks of the requested size.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The aligned size of the chunk, including the chunk header
+ *
+ * Returned Value:
+ *   The allocated chunk or NULL if the size is not cached or if the heap is
+ *   exhausted.
+ *
+ ****************************************************************************/
+
+FAR struct mm_allocnode_s *mm_cpucache_alloc(FAR struct mm_heap_s *heap,
+                                             size_t alignsize)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_freenode_s *prev;
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *extra;
+  FAR struct mm_allocnode_s *chunk;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  if (!MM_CPUCACHE_CACHEABLE(alignsize))
+    {
+      return NULL;
+    }
+
+  /* Search the size class for a chunk that is large enough.  All chunks in
+   * the size class are less than twice the requested size.
+   */
+
+  ndx   = mm_size2ndx(alignsize);
+  flags = up_irq_save();
+  cache = mm_cpucache_get(heap);
+
+  for (prev = NULL, node = cache->mc_list[ndx];
+       node != NULL && node->size < alignsize;
+       prev = node, node = node->flink);
+
+  if (node != NULL)
+    {
+      if (prev == NULL)
+        {
+          cache->mc_list[ndx] = node->flink;
+        }
+      else
+        {
+          prev->flink = node->flink;
+        }
+
+      cache->mc_count[ndx]--;
+      up_irq_restore(flags);
+      return (FAR struct mm_allocnode_s *)node;
+    }
+
+  up_irq_restore(flags);
+
+  /* Cache miss.  Allocate the chunk and the refill batch from the heap
+   * with a single acquisition of the MM semaphore.
+   */
+
+  extra = NULL;
+
+  mm_takesemaphore(heap);
+  chunk = mm_allocchunk(heap, alignsize);
+  if (chunk != NULL)
+    {
+      for (i = 1; i < CONFIG_MM_CPUCACHE_BATCH; i++)
+        {
+          node = (FAR struct mm_freenode_s *)mm_allocchunk(heap, alignsize);
+          if (node == NULL)
+            {
+              break;
+            }
+
+          node->flink = extra;
+          extra       = node;
+        }
+    }
+
+  mm_givesemaphore(heap);
+
+  /* Add the extra chunks to the cache of the (possibly different) current
+   * CPU.  Any that do not fit are returned to the heap.
+   */
+
+  if (extra != NULL)
+    {
+      flags = up_irq_save();
+      cache = mm_cpucache_get(heap);
+
+      while (extra != NULL && cache->mc_count[ndx] < CONFIG_MM_CPUCACHE_DEPTH)
+        {
+          node                = extra;
+          extra               = node->flink;
+          node->flink         = cache->mc_list[ndx];
+          cache->mc_list[ndx] = node;
+          cache->mc_count[ndx]++;
+        }
+
+      up_irq_restore(flags);
+
+      if (extra != NULL)
+        {
+          mm_cpucache_release(heap, extra);
+        }
+    }
+
+  return chunk;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_free
+ *
+ * Description:
+ *   Free a chunk to the cache of the current CPU without taking the MM
+ *   semaphore.  If the size class is full, CONFIG_MM_CPUCACHE_BATCH chunks
+ *   are first returned to the heap.
+ *
+ * Input Parameters:
+ *   heap  - The selected heap
+ *   chunk - The allocated chunk to be freed
+ *
+ * Returned Value:
+ *   True if the chunk was cached; false if the chunk must be freed to the
+ *   heap by the caller.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_free(FAR struct mm_heap_s *heap,
+                      FAR struct mm_allocnode_s *chunk)
+{
+  FAR struct mm_freenode_s *node = (FAR struct mm_freenode_s *)chunk;
+  FAR struct mm_freenode_s *drain = NULL;
+  FAR struct mm_freenode_s *tail;
+  FAR struct mm_cpucache_s *cache;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  if (!MM_CPUCACHE_CACHEABLE(node->size))
+    {
+      return false;
+    }
+
+  ndx   = mm_size2ndx(node->size);
+  flags = up_irq_save();
+  cache = mm_cpucache_get(heap);
+
+  if (cache->mc_count[ndx] >= CONFIG_MM_CPUCACHE_DEPTH)
+    {
+      /* The size class is full.  Detach the oldest batch of chunks from
+       * the end of the list.
+       */
+
+      for (i = CONFIG_MM_CPUCACHE_DEPTH - CONFIG_MM_CPUCACHE_BATCH,
+           tail = NULL, drain = cache->mc_list[ndx];
+           i > 0;
+           i--, tail = drain, drain = drain->flink);
+
+      if (tail == NULL)
+        {
+          cache->mc_list[ndx] = NULL;
+        }
+      else
+        {
+          tail->flink = NULL;
+        }
+
+      cache->mc_count[ndx] -= CONFIG_MM_CPUCACHE_BATCH;
+    }
+
+  node->flink         = cache->mc_list[ndx];
+  cache->mc_list[ndx] = node;
+  cache->mc_count[ndx]++;
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      mm_cpucache_release(heap, drain);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_flush
+ *
+ * Description:
+ *   Return all chunks in the cache of the current CPU to the heap.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *
+ * Returned Value:
+ *   True if any chunks were returned to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_freenode_s *drain = NULL;
+  FAR struct mm_freenode_s *node;
+  FAR struct mm_cpucache_s *cache;
+  irqstate_t flags;
+  int ndx;
+
+  flags = up_irq_save();
+  cache = mm_cpucache_get(heap);
+
+  for (ndx = 0; ndx < MM_NNODES; ndx++)
+    {
+      while ((node = cache->mc_list[ndx]) != NULL)
+        {
+          cache->mc_list[ndx] = node->flink;
+          node->flink         = drain;
+          drain               = node;
+        }
+
+      cache->mc_count[ndx] = 0;
+    }
+
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      mm_cpucache_release(heap, drain);
+      return true;
+    }
+
+  return false;
+}
+
+#endif /* MM_USE_CPUCACHE */
@@ -0,0 +1,110 @@
+/****************************************************************************
+ * mm/mm_heap/mm_foreach.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_OWNER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_foreach
+ *
+ * Description:
+ *   Call 'handler' for each allocated chunk in the heap that has an owner.
+ *   The guard chunks and chunks held in the per-CPU caches are skipped.
+ *   The heap semaphore is held while the handler runs so the handler must
+ *   not allocate or free memory from the same heap.
+ *
+ * Input Parameters:
+ *   heap    - The heap to visit
+ *   handler - The function to call for each allocated chunk
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_foreach(FAR struct mm_heap_s *heap, mm_foreach_t handler,
+                FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(handler != NULL);
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Visit each node in the region
+       * Retake the semaphore for each region to reduce latencies
+       */
+
+      mm_takesemaphore(heap);
+
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + node->size))
+        {
+          if ((node->preceding & MM_ALLOC_BIT) != 0 && node->pid >= 0)
+            {
+              handler(node, arg);
+            }
+        }
+
+      mm_givesemaphore(heap);
+    }
+#undef region
+}
+
+#endif /* CONFIG_MM_OWNER */
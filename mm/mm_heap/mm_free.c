@@ -49,39 +49,30 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_free
+ * Name: mm_freechunk
  *
  * Description:
- *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   Returns an allocated chunk to the list of free nodes,  merging with
  *   adjacent free chunks if possible.
  *
+ *   The caller must hold the MM semaphore.
+ *
+ * Input Parameters:
+ *   heap  - The selected heap
+ *   chunk - The allocated chunk to be freed
+ *
+ * Returned Value:
+ *   None
+ *
  ****************************************************************************/
 
-void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+void mm_freechunk(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *chunk)
 {
-  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *node = (FAR struct mm_freenode_s *)chunk;
   FAR struct mm_freenode_s *prev;
   FAR struct mm_freenode_s *next;
 
-  minfo("Freeing %p\n", mem);
-
-  /* Protect against attempts to free a NULL reference */
-
-  if (!mem)
-    {
-      return;
-    }
-
-  /* We need to hold the MM semaphore while we muck with the
-   * nodelist.
-   */
-
-  mm_takesemaphore(heap);
-
-  /* Map the memory chunk into a free node */
-
-  node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
-
   /* Sanity check against double-frees */
 
   DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
@@ -103,16 +94,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
       andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + next->size);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node from the free list */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -129,16 +113,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   DEBUGASSERT((node->preceding & ~MM_ALLOC_BIT) == prev->size);
   if ((prev->preceding & MM_ALLOC_BIT) == 0)
     {
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the previous node from the free list */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -150,5 +127,52 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+
+  minfo("Freeing %p\n", mem);
+
+  /* Protect against attempts to free a NULL reference */
+
+  if (!mem)
+    {
+      return;
+    }
+
+  /* Map the memory chunk into an allocated node */
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  /* Chunks in the per-CPU caches remain allocated but are not owned */
+
+  MM_CLROWNER(node);
+
+#ifdef MM_USE_CPUCACHE
+  /* Small chunks are kept in the cache of this CPU */
+
+  if (mm_cpucache_free(heap, node))
+    {
+      return;
+    }
+#endif
+
+  /* We need to hold the MM semaphore while we muck with the
+   * nodelist.
+   */
+
+  mm_takesemaphore(heap);
+  mm_freechunk(heap, node);
   mm_givesemaphore(heap);
 }
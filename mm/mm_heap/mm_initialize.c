@@ -113,6 +113,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapstart[IDX]            = (FAR struct mm_allocnode_s *)heapbase;
   heap->mm_heapstart[IDX]->size      = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapstart[IDX]->preceding = MM_ALLOC_BIT;
+  MM_CLROWNER(heap->mm_heapstart[IDX]);
 
   node                        = (FAR struct mm_freenode_s *)(heapbase + SIZEOF_MM_ALLOCNODE);
   node->size                  = heapsize - 2*SIZEOF_MM_ALLOCNODE;
@@ -121,6 +122,7 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]              = (FAR struct mm_allocnode_s *)(heapend - SIZEOF_MM_ALLOCNODE);
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
+  MM_CLROWNER(heap->mm_heapend[IDX]);
 
 #undef IDX
 
@@ -155,7 +157,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
                    size_t heapsize)
 {
+#ifndef CONFIG_MM_TLSF
   int i;
+#endif
 
   minfo("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -177,6 +181,13 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_nregions = 0;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Start with empty TLSF free lists */
+
+  heap->mm_tlsf_flbitmap = 0;
+  memset(heap->mm_tlsf_slbitmap, 0, sizeof(heap->mm_tlsf_slbitmap));
+  memset(heap->mm_tlsf_list, 0, sizeof(heap->mm_tlsf_list));
+#else
   /* Initialize the node array */
 
   memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
@@ -185,6 +196,13 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Start with empty per-CPU caches */
+
+  memset(heap->mm_cpucache, 0, sizeof(heap->mm_cpucache));
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
@@ -59,40 +59,33 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
  *  that chunk, save the remaining, smaller chunk (if any).
  *
- *  8-byte alignment of the allocated data is assured.
+ *  The caller must hold the MM semaphore.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   alignsize - The aligned size of the chunk, including the chunk header
+ *
+ * Returned Value:
+ *   The allocated chunk or NULL if there is no free chunk large enough.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
-  void *ret = NULL;
-  int ndx;
-
-  /* Ignore zero-length allocations */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
+#ifdef CONFIG_MM_TLSF
+  /* Find a large enough chunk in the TLSF free lists */
 
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
+  node = mm_tlsf_search(heap, alignsize);
+#else
+  int ndx;
 
   /* Get the location in the node list to start the search. Special case
    * really big allocations
@@ -117,6 +110,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   for (node = heap->mm_nodelist[ndx].flink;
        node && node->size < alignsize;
        node = node->flink);
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -129,16 +123,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -180,10 +167,76 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->preceding |= MM_ALLOC_BIT;
-      ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
-  mm_givesemaphore(heap);
+  return (FAR struct mm_allocnode_s *)node;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t alignsize;
+  void *ret = NULL;
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+
+#ifdef MM_USE_CPUCACHE
+  /* Small allocations are first attempted from the cache of this CPU.  This
+   * does not require the MM semaphore.
+   */
+
+  node = mm_cpucache_alloc(heap, alignsize);
+  if (node == NULL)
+#endif
+    {
+      /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+      mm_takesemaphore(heap);
+      node = mm_allocchunk(heap, alignsize);
+      mm_givesemaphore(heap);
+
+#ifdef MM_USE_CPUCACHE
+      /* If the allocation failed, return the chunks held in the cache of
+       * this CPU to the heap and try again.
+       */
+
+      if (node == NULL && mm_cpucache_flush(heap))
+        {
+          mm_takesemaphore(heap);
+          node = mm_allocchunk(heap, alignsize);
+          mm_givesemaphore(heap);
+        }
+#endif
+    }
+
+  if (node != NULL)
+    {
+      MM_SETOWNER(node, MM_CALLER());
+      ret = (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+    }
 
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
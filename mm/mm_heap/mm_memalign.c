@@ -205,6 +205,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+  MM_SETOWNER(node, MM_CALLER());
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
@@ -46,6 +46,22 @@
 
 #include <nuttx/mm/mm.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of extra bytes reserved when an allocation of 's' bytes is
+ * grown (computed so that it cannot overflow).
+ */
+
+#if CONFIG_MM_REALLOC_RESERVE > 0
+#  define REALLOC_RESERVE(s) \
+     MM_ALIGN_UP(((s) / 100) * CONFIG_MM_REALLOC_RESERVE + \
+                 ((s) % 100) * CONFIG_MM_REALLOC_RESERVE / 100)
+#else
+#  define REALLOC_RESERVE(s) 0
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -67,9 +83,17 @@
  *     (2) Taking the additional space from the preceding free chunk.
  *     (3) Or both
  *
- *  If the request is for more space but the current chunk cannot be
- *  extended, then malloc a new buffer, copy the data into the new buffer,
- *  and free the old buffer.
+ *  The following free chunk is preferred because the data does not have
+ *  to be moved.  If the request is for more space but the current chunk
+ *  cannot be extended, then malloc a new buffer, copy the data into the
+ *  new buffer, and free the old buffer.
+ *
+ *  If CONFIG_MM_REALLOC_RESERVE is non-zero, then a chunk that is grown
+ *  receives that percentage of extra space (when available) so that the
+ *  next few increases can be made in place.  A chunk is then only reduced
+ *  in size if more than its reservation would be left unused.
+ *
+ *  The data is always moved without holding the MM semaphore.
  *
  ****************************************************************************/
 
@@ -81,6 +105,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   FAR struct mm_freenode_s  *next;
   size_t newsize;
   size_t oldsize;
+  size_t reserve;
   size_t prevsize = 0;
   size_t nextsize = 0;
   FAR void *newmem;
@@ -105,6 +130,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
    */
 
   newsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  reserve = REALLOC_RESERVE(newsize);
 
   /* Map the memory chunk into an allocated node structure */
 
@@ -120,10 +146,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   if (newsize <= oldsize)
     {
       /* Handle the special case where we are not going to change the size
-       * of the allocation.
+       * of the allocation.  Space within the growth reservation is kept.
        */
 
-      if (newsize < oldsize)
+      if (newsize + reserve < oldsize)
         {
           mm_shrinkchunk(heap, oldnode, newsize);
         }
@@ -159,58 +185,38 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
-       */
-
-      if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1))
+      if (nextsize >= needed)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
+          /* Take what we need (and as much of the reservation as there
+           * is) from the next chunk.  The data stays where it is.
+           */
 
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
+          takenext = needed + reserve;
+          if (takenext > nextsize)
             {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
+              takenext = nextsize;
             }
+        }
+      else
+        {
+          /* Take the whole next chunk (if any) and get the rest that we
+           * need from the previous chunk.
+           */
 
-          needed = 0;
+          takenext = nextsize;
+          takeprev = needed - nextsize;
         }
 
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
-       */
+      /* Never leave a remainder that is too small to be a free chunk */
 
-      if (nextsize > 0 && needed)
+      if (nextsize - takenext < SIZEOF_MM_FREENODE)
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+          takenext = nextsize;
+        }
 
-              takeprev = 0;
-              takenext = needed;
-            }
+      if (takeprev > 0 && prevsize - takeprev < SIZEOF_MM_FREENODE)
+        {
+          takeprev = prevsize;
         }
 
       /* Extend into the previous free chunk */
@@ -220,16 +226,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -261,17 +260,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
               next->preceding     = newnode->size | (next->preceding & MM_ALLOC_BIT);
             }
 
-          /* Now we want to return newnode */
-
-          oldnode = newnode;
-          oldsize = newnode->size;
-
-          /* Now we have to move the user contents 'down' in memory.  memcpy should
-           * should be save for this.
+          /* Now we want to return newnode.  The user contents will be
+           * moved 'down' in memory after the MM semaphore is released.
            */
 
-          newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+          oldnode = newnode;
+          newmem  = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
         }
 
       /* Extend into the next free chunk */
@@ -287,20 +281,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
-          oldnode->size = oldsize + takenext;
+          oldnode->size = oldnode->size + takenext;
           newnode       = (FAR struct mm_freenode_s *)((FAR char *)oldnode + oldnode->size);
 
           /* Did we consume the entire preceding chunk? */
@@ -327,7 +314,19 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+      MM_SETOWNER(oldnode, MM_CALLER());
       mm_givesemaphore(heap);
+
+      /* The chunk now belongs to us alone, so the (overlapping) move of
+       * the user data into the previous chunk can be done without holding
+       * the MM semaphore.
+       */
+
+      if (newmem != oldmem)
+        {
+          memmove(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+        }
+
       return newmem;
     }
 
@@ -335,15 +334,30 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   else
     {
-      /* Allocate a new block.  On failure, realloc must return NULL but
-       * leave the original memory in place.
+      /* Allocate a new block (with the growth reservation if that does not
+       * overflow).  On failure, realloc must return NULL but leave the
+       * original memory in place.
        */
 
       mm_givesemaphore(heap);
-      newmem = (FAR void *)mm_malloc(heap, size);
+
+      newmem = NULL;
+      if (reserve > 0 && size + reserve > size)
+        {
+          newmem = (FAR void *)mm_malloc(heap, size + reserve);
+        }
+
+      if (newmem == NULL)
+        {
+          newmem = (FAR void *)mm_malloc(heap, size);
+        }
+
       if (newmem)
         {
-          memcpy(newmem, oldmem, oldsize);
+          MM_SETOWNER((FAR struct mm_allocnode_s *)
+                      ((FAR char *)newmem - SIZEOF_MM_ALLOCNODE),
+                      MM_CALLER());
+          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
           mm_free(heap, oldmem);
         }
 
@@ -0,0 +1,283 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Convert a chunk size into the first and second level indices of the
+ *   TLSF size class that holds chunks of that size.
+ *
+ ****************************************************************************/
+
+static void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int l2size;
+
+  if (size < (1 << MM_TLSF_FLSHIFT))
+    {
+      /* Small chunks:  Linearly spaced classes of MM_MIN_CHUNK bytes */
+
+      *fl = 0;
+      *sl = (int)(size >> MM_MIN_SHIFT);
+    }
+  else if (size < MM_MAX_CHUNK)
+    {
+      /* Divide the power of two range of the size into MM_TLSF_SLCOUNT
+       * classes.
+       */
+
+      l2size = fls((int)size) - 1;
+      *fl    = l2size - MM_TLSF_FLSHIFT + 1;
+      *sl    = (int)(size >> (l2size - MM_TLSF_SLSHIFT)) - MM_TLSF_SLCOUNT;
+    }
+  else
+    {
+      /* Really big chunks all go into the last first level range */
+
+      *fl = MM_TLSF_FLCOUNT - 1;
+      *sl = (int)(size >> (MM_MAX_SHIFT - MM_TLSF_SLSHIFT)) - MM_TLSF_SLCOUNT;
+      if (*sl >= MM_TLSF_SLCOUNT)
+        {
+          *sl = MM_TLSF_SLCOUNT - 1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_nonempty
+ *
+ * Description:
+ *   Find the first non-empty free list at or above the size class (fl, sl)
+ *   using the bitmaps.  On success, fl and sl are updated to the size class
+ *   that was found.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *
+mm_tlsf_nonempty(FAR struct mm_heap_s *heap, FAR int *fl, FAR int *sl)
+{
+  uint32_t flmap;
+  uint32_t slmap;
+
+  slmap = heap->mm_tlsf_slbitmap[*fl] & (UINT32_MAX << *sl);
+  if (slmap == 0)
+    {
+      /* Nothing in this first level range.  Try the larger ranges. */
+
+      flmap = heap->mm_tlsf_flbitmap & (UINT32_MAX << (*fl + 1));
+      if (flmap == 0)
+        {
+          return NULL;
+        }
+
+      *fl   = ffs((int)flmap) - 1;
+      slmap = heap->mm_tlsf_slbitmap[*fl];
+      DEBUGASSERT(slmap != 0);
+    }
+
+  *sl = ffs((int)slmap) - 1;
+  return heap->mm_tlsf_list[*fl][*sl];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list of its size class.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *next;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  next        = heap->mm_tlsf_list[fl][sl];
+  node->blink = NULL;
+  node->flink = next;
+
+  if (next)
+    {
+      next->blink = node;
+    }
+
+  heap->mm_tlsf_list[fl][sl]    = node;
+  heap->mm_tlsf_flbitmap       |= (uint32_t)1 << fl;
+  heap->mm_tlsf_slbitmap[fl]   |= (uint32_t)1 << sl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list of its size class.  The chunk
+ *   size must not have been changed since the chunk was added.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+      return;
+    }
+
+  /* This was the list head */
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+  DEBUGASSERT(heap->mm_tlsf_list[fl][sl] == node);
+
+  heap->mm_tlsf_list[fl][sl] = node->flink;
+  if (node->flink == NULL)
+    {
+      /* The list is now empty */
+
+      heap->mm_tlsf_slbitmap[fl] &= ~((uint32_t)1 << sl);
+      if (heap->mm_tlsf_slbitmap[fl] == 0)
+        {
+          heap->mm_tlsf_flbitmap &= ~((uint32_t)1 << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_search
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes (including the chunk
+ *   header).  The chunk is not removed from its free list.  It is assumed
+ *   that the caller holds the mm semaphore
+ *
+ * Returned Value:
+ *   The free chunk or NULL if there is no free chunk large enough.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  size_t target = size;
+  int fl;
+  int sl;
+
+  /* Round the size up to the next size class.  Then every chunk in any
+   * non-empty class at or above that class is large enough and the head of
+   * the first such list can be used without searching it.
+   */
+
+  if (size >= (1 << MM_TLSF_FLSHIFT) && size < MM_MAX_CHUNK)
+    {
+      target += ((size_t)1 << (fls((int)size) - 1 - MM_TLSF_SLSHIFT)) - 1;
+    }
+
+  mm_tlsf_mapping(target, &fl, &sl);
+  node = mm_tlsf_nonempty(heap, &fl, &sl);
+  if (node != NULL && node->size >= size)
+    {
+      return node;
+    }
+
+  /* That failed.  There may still be a large enough chunk in the class of
+   * the size itself or, for really big chunks, further down a list of the
+   * last first level range.  Fall back to searching the lists.
+   */
+
+  mm_tlsf_mapping(size, &fl, &sl);
+  while ((node = mm_tlsf_nonempty(heap, &fl, &sl)) != NULL)
+    {
+      for (; node != NULL; node = node->flink)
+        {
+          if (node->size >= size)
+            {
+              return node;
+            }
+        }
+
+      /* Move on to the next size class */
+
+      if (++sl >= MM_TLSF_SLCOUNT)
+        {
+          if (++fl >= MM_TLSF_FLCOUNT)
+            {
+              break;
+            }
+
+          sl = 0;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_MM_TLSF */
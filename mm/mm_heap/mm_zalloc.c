@@ -60,6 +60,8 @@ FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
   FAR void *alloc = mm_malloc(heap, size);
   if (alloc)
     {
+       MM_SETOWNER((FAR struct mm_allocnode_s *)
+                   ((FAR char *)alloc - SIZEOF_MM_ALLOCNODE), MM_CALLER());
        memset(alloc, 0, size);
     }
 
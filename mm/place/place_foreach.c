@@ -0,0 +1,95 @@
+/****************************************************************************
+ * mm/place/place_foreach.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
+
+#include "place.h"
+
+#ifdef CONFIG_MM_PLACE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: place_foreach
+ *
+ * Description:
+ *   Call the handler once for each named heap with a snapshot of the heap
+ *   state.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each heap
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void place_foreach(place_handler_t handler, FAR void *arg)
+{
+  FAR struct place_heap_s *heap;
+  struct placeinfo_s info;
+  struct mallinfo mem;
+
+  DEBUGASSERT(handler != NULL);
+
+  for (heap = g_place_heaps; heap != NULL; heap = heap->ph_flink)
+    {
+      (void)mm_mallinfo(&heap->ph_heap, &mem);
+
+      info.name    = heap->ph_name;
+      info.flags   = heap->ph_flags;
+      info.arena   = mem.arena;
+      info.used    = mem.uordblks;
+      info.free    = mem.fordblks;
+      info.largest = mem.mxordblk;
+
+      handler(&info, arg);
+    }
+}
+
+#endif /* CONFIG_MM_PLACE */
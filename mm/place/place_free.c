@@ -0,0 +1,125 @@
+/****************************************************************************
+ * mm/place/place_free.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
+
+#include "place.h"
+
+#ifdef CONFIG_MM_PLACE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: place_findmem
+ *
+ * Description:
+ *   Return the named heap that holds the memory or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct place_heap_s *place_findmem(FAR void *mem)
+{
+  FAR struct place_heap_s *heap;
+
+  for (heap = g_place_heaps; heap != NULL; heap = heap->ph_flink)
+    {
+      if (mm_heapmember(&heap->ph_heap, mem))
+        {
+          return heap;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: place_free
+ *
+ * Description:
+ *   Free memory allocated by place_malloc() and friends.  Memory that does
+ *   not belong to any named heap is returned to the kernel heap.
+ *
+ ****************************************************************************/
+
+void place_free(FAR void *mem)
+{
+  FAR struct place_heap_s *heap;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  heap = place_findmem(mem);
+  if (heap != NULL)
+    {
+      mm_free(&heap->ph_heap, mem);
+    }
+  else
+    {
+      kmm_free(mem);
+    }
+}
+
+/****************************************************************************
+ * Name: place_heapmember
+ *
+ * Description:
+ *   Return true if the memory lies in one of the named heaps.
+ *
+ ****************************************************************************/
+
+bool place_heapmember(FAR void *mem)
+{
+  return place_findmem(mem) != NULL;
+}
+
+#endif /* CONFIG_MM_PLACE */
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * mm/place/place_initialize.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
+
+#include "place.h"
+
+#ifdef CONFIG_MM_PLACE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of all named heaps in the order in which they were added */
+
+FAR struct place_heap_s *g_place_heaps;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: place_initialize
+ *
+ * Description:
+ *   Initialize a named heap with its first memory region and add it to
+ *   the list of heaps searched by place_malloc().  Heaps are searched in
+ *   the order in which they were added.  This is normally called by the
+ *   board logic from up_addregion().
+ *
+ * Input Parameters:
+ *   heap  - The heap to be initialized
+ *   name  - A name for the heap.  The string must persist.
+ *   flags - The properties of the memory (PLACE_FAST, etc.)
+ *   start - Start of the memory region
+ *   size  - Size of the memory region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void place_initialize(FAR struct place_heap_s *heap, FAR const char *name,
+                      uint8_t flags, FAR void *start, size_t size)
+{
+  FAR struct place_heap_s **tail;
+  irqstate_t irqflags;
+
+  DEBUGASSERT(heap != NULL && name != NULL && start != NULL);
+
+  heap->ph_flink = NULL;
+  heap->ph_name  = name;
+  heap->ph_flags = flags;
+  mm_initialize(&heap->ph_heap, start, size);
+
+  /* Add the heap to the end of the list of all heaps.  Heaps are never
+   * removed so the list may be searched without any locking.
+   */
+
+  irqflags = enter_critical_section();
+  for (tail = &g_place_heaps; *tail != NULL; tail = &(*tail)->ph_flink);
+  *tail = heap;
+  leave_critical_section(irqflags);
+}
+
+/****************************************************************************
+ * Name: place_addregion
+ *
+ * Description:
+ *   Add one more memory region, with the same properties, to a named heap.
+ *   At most CONFIG_MM_REGIONS regions may be added in total.
+ *
+ ****************************************************************************/
+
+void place_addregion(FAR struct place_heap_s *heap, FAR void *start,
+                     size_t size)
+{
+  DEBUGASSERT(heap != NULL && start != NULL);
+  mm_addregion(&heap->ph_heap, start, size);
+}
+
+/****************************************************************************
+ * Name: place_find
+ *
+ * Description:
+ *   Return the named heap with the given name or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct place_heap_s *place_find(FAR const char *name)
+{
+  FAR struct place_heap_s *heap;
+
+  for (heap = g_place_heaps; heap != NULL; heap = heap->ph_flink)
+    {
+      if (strcmp(heap->ph_name, name) == 0)
+        {
+          return heap;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_MM_PLACE */
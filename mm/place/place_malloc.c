@@ -0,0 +1,146 @@
+/****************************************************************************
+ * mm/place/place_malloc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/place.h>
+
+#include "place.h"
+
+#ifdef CONFIG_MM_PLACE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: place_memalign
+ *
+ * Description:
+ *   Allocate memory from the first named heap that has all of the
+ *   properties in 'flags' and that can satisfy the request.  If there is
+ *   none, the memory is allocated from the kernel heap instead.  Use
+ *   place_free() to release the memory.
+ *
+ * Input Parameters:
+ *   flags     - The requested properties (PLACE_FAST, etc.)
+ *   alignment - The required alignment
+ *   size      - The size of the allocation
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the request could not be satisfied.
+ *
+ ****************************************************************************/
+
+FAR void *place_memalign(uint8_t flags, size_t alignment, size_t size)
+{
+  FAR struct place_heap_s *heap;
+  FAR void *mem;
+
+  for (heap = g_place_heaps; heap != NULL; heap = heap->ph_flink)
+    {
+      if ((heap->ph_flags & flags) == flags)
+        {
+          mem = mm_memalign(&heap->ph_heap, alignment, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  /* Fall back to the kernel heap */
+
+  return kmm_memalign(alignment, size);
+}
+
+/****************************************************************************
+ * Name: place_malloc
+ *
+ * Description:
+ *   Same as place_memalign() with the natural alignment of malloc().
+ *
+ ****************************************************************************/
+
+FAR void *place_malloc(uint8_t flags, size_t size)
+{
+  FAR struct place_heap_s *heap;
+  FAR void *mem;
+
+  for (heap = g_place_heaps; heap != NULL; heap = heap->ph_flink)
+    {
+      if ((heap->ph_flags & flags) == flags)
+        {
+          mem = mm_malloc(&heap->ph_heap, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  /* Fall back to the kernel heap */
+
+  return kmm_malloc(size);
+}
+
+/****************************************************************************
+ * Name: place_zalloc
+ *
+ * Description:
+ *   Same as place_malloc() except that the memory is zeroed.
+ *
+ ****************************************************************************/
+
+FAR void *place_zalloc(uint8_t flags, size_t size)
+{
+  FAR void *mem = place_malloc(flags, size);
+  if (mem != NULL)
+    {
+      memset(mem, 0, size);
+    }
+
+  return mem;
+}
+
+#endif /* CONFIG_MM_PLACE */
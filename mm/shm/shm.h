@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include <semaphore.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/addrenv.h>
 
 #ifdef CONFIG_MM_SHM
@@ -60,6 +61,17 @@
 #define SRFLAG_INUSE     (1 << 0) /* Bit 0: Region is in use */
 #define SRFLAG_UNLINKED  (1 << 1) /* Bit 1: Region perists while references */
 
+/* Regions of at least one MMU section are attached at section aligned
+ * virtual addresses.  The architecture may then map each section with a
+ * single large page if the physical pages are also contiguous and aligned
+ * (see SHM_HUGETLB).
+ */
+
+#ifdef ARCH_SECT2PG
+#  define SHM_SECTPAGES    ARCH_SECT2PG(1)
+#  define SHM_SECTSIZE     ((size_t)SHM_SECTPAGES << MM_PGSHIFT)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,10 +82,10 @@
 
 struct shm_region_s
 {
-  struct shmid_ds sr_ds; /* Region info */
-  bool  sr_flags;        /* See SRFLAGS_* definitions */
-  key_t sr_key;          /* Lookup key */
-  sem_t sr_sem;          /* Manages exclusive access to this region */
+  struct shmid_ds sr_ds;  /* Region info */
+  uint8_t sr_flags;       /* See SRFLAGS_* definitions */
+  key_t   sr_key;         /* Lookup key */
+  sem_t   sr_sem;         /* Manages exclusive access to this region */
 
   /* List of physical pages allocated for this memory region */
 
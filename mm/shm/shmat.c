@@ -50,6 +50,61 @@
 
 #ifdef CONFIG_MM_SHM
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_vaddr_alloc
+ *
+ * Description:
+ *   Set aside a virtual address space to span a region of the provided
+ *   size.  Regions of at least one MMU section are placed on a section
+ *   boundary (if there is room) so that they may be mapped with large
+ *   pages.
+ *
+ ****************************************************************************/
+
+static uintptr_t shm_vaddr_alloc(FAR struct task_group_s *group,
+                                 size_t segsz)
+{
+  uintptr_t vaddr;
+#ifdef SHM_SECTPAGES
+  uintptr_t aligned;
+  size_t padsz;
+
+  segsz = MM_PGALIGNUP(segsz) << MM_PGSHIFT;
+  if (segsz >= SHM_SECTSIZE)
+    {
+      /* Over-allocate, then free the unaligned head and the tail */
+
+      padsz = SHM_SECTSIZE - MM_PGSIZE;
+      vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle, segsz + padsz);
+      if (vaddr != 0)
+        {
+          aligned = (vaddr + SHM_SECTSIZE - 1) & ~(SHM_SECTSIZE - 1);
+          if (aligned > vaddr)
+            {
+              gran_free(group->tg_shm.gs_handle, (FAR void *)vaddr,
+                        aligned - vaddr);
+            }
+
+          if (padsz > aligned - vaddr)
+            {
+              gran_free(group->tg_shm.gs_handle,
+                        (FAR void *)(aligned + segsz),
+                        padsz - (aligned - vaddr));
+            }
+
+          return aligned;
+        }
+    }
+#endif
+
+  vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle, segsz);
+  return vaddr;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -142,8 +197,7 @@ FAR void *shmat(int shmid, FAR const void *shmaddr, int shmflg)
 
   /* Set aside a virtual address space to span this physical region */
 
-  vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle,
-                                region->sr_ds.shm_segsz);
+  vaddr = shm_vaddr_alloc(group, region->sr_ds.shm_segsz);
   if (vaddr == 0)
     {
       shmerr("ERROR: gran_alloc() failed\n");
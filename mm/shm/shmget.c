@@ -218,6 +218,83 @@ static int shm_extend(int shmid, size_t size)
   return OK;
 }
 
+/****************************************************************************
+ * Name: shm_contiguous
+ *
+ * Description:
+ *   Allocate the physical pages of a new region as one contiguous block
+ *   (SHM_HUGETLB).  Regions of at least one MMU section are also aligned
+ *   to a section boundary.  That is done by over-allocating and then
+ *   returning the unaligned head and tail to the page allocator.
+ *
+ * Input Parameters:
+ *   shmid - The index of the region of interest in the shared memory region
+ *     table.
+ *   size - The size of the region.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOMEM is returned on failure.
+ *
+ ****************************************************************************/
+
+static int shm_contiguous(int shmid, size_t size)
+{
+  FAR struct shm_region_s *region =  &g_shminfo.si_region[shmid];
+  unsigned int npages;
+  unsigned int npad = 0;
+  unsigned int i;
+  uintptr_t paddr;
+
+  npages = MM_PGALIGNUP(size);
+  if (npages > CONFIG_ARCH_SHM_NPAGES)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef SHM_SECTPAGES
+  if (npages >= SHM_SECTPAGES)
+    {
+      npad = SHM_SECTPAGES - 1;
+    }
+#endif
+
+  paddr = mm_pgalloc(npages + npad);
+  if (paddr == 0)
+    {
+      shmerr("ERROR: mm_pgalloc(%u) failed\n", npages + npad);
+      return -ENOMEM;
+    }
+
+#ifdef SHM_SECTPAGES
+  if (npad > 0)
+    {
+      unsigned int nhead;
+
+      nhead = ((SHM_SECTSIZE - (paddr & (SHM_SECTSIZE - 1))) &
+               (SHM_SECTSIZE - 1)) >> MM_PGSHIFT;
+      if (nhead > 0)
+        {
+          mm_pgfree(paddr, nhead);
+          paddr += (uintptr_t)nhead << MM_PGSHIFT;
+        }
+
+      if (npad > nhead)
+        {
+          mm_pgfree(paddr + ((uintptr_t)npages << MM_PGSHIFT),
+                    npad - nhead);
+        }
+    }
+#endif
+
+  for (i = 0; i < npages; i++)
+    {
+      region->sr_pages[i] = paddr + ((uintptr_t)i << MM_PGSHIFT);
+    }
+
+  region->sr_ds.shm_segsz = size;
+  return OK;
+}
+
 /****************************************************************************
  * Name: shm_create
  *
@@ -230,7 +307,8 @@ static int shm_extend(int shmid, size_t size)
  *   size    - The shared memory region that is created will be at least
  *             this size in bytes.
  *   shmflgs - See IPC_* definitions in sys/ipc.h.  Only the values
- *             IPC_PRIVATE or IPC_CREAT are supported.
+ *             IPC_PRIVATE or IPC_CREAT are supported.  SHM_HUGETLB
+ *             selects physically contiguous memory.
  *
  * Returned Value:
  *   Zero is returned on success;  A negated errno value is returned on
@@ -257,11 +335,19 @@ static int shm_create(key_t key, size_t size, int shmflg)
 
   shmid = ret;
 
-  /* Then allocate the physical memory (by extending it from the initial
-   * size of zero).
+  /* Then allocate the physical memory, either in one block or by extending
+   * it from the initial size of zero.
    */
 
-  ret = shm_reserve(shmid, size);
+  if ((shmflg & SHM_HUGETLB) != 0)
+    {
+      ret = shm_contiguous(shmid, size);
+    }
+  else
+    {
+      ret = shm_extend(shmid, size);
+    }
+
   if (ret < 0)
     {
       /* Free any partial allocations and unreserve the region */
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * mm/slab/slab.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_SLAB_SLAB_H
+#define __MM_SLAB_SLAB_H 1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/mm/slab.h>
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The objects of a slab follow the (aligned) slab header */
+
+#define SLAB_HDRSIZE      SLAB_ALIGN_UP(sizeof(struct slab_s))
+#define SLAB_OBJECTS(s)   ((FAR uint8_t *)(s) + SLAB_HDRSIZE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the header at the beginning of each slab */
+
+struct slab_s
+{
+  FAR struct slab_s *sl_flink;       /* Next slab owned by the same cache */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of all initialized caches */
+
+extern FAR struct slab_cache_s *g_slab_caches;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_grow
+ *
+ * Description:
+ *   Allocate one new slab from the kernel heap and add all of its objects
+ *   to the free list of the cache.  This function is intended only for
+ *   internal use by the slab module and must not be called from an
+ *   interrupt handler.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the slab could not be allocated.
+ *
+ ****************************************************************************/
+
+int slab_grow(FAR struct slab_cache_s *cache);
+
+#endif /* CONFIG_MM_SLAB */
+#endif /* __MM_SLAB_SLAB_H */
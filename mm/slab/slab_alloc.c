@@ -0,0 +1,148 @@
+/****************************************************************************
+ * mm/slab/slab_alloc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_alloc
+ *
+ * Description:
+ *   Allocate one object from the cache.  An object is taken from the free
+ *   list if one is available.  Otherwise, and if not called from an
+ *   interrupt handler, a new slab is allocated from the kernel heap.
+ *
+ * Input Parameters:
+ *   cache - The cache to allocate from
+ *
+ * Returned Value:
+ *   A pointer to the (uninitialized) object or NULL if no object could be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+FAR void *slab_alloc(FAR struct slab_cache_s *cache)
+{
+  FAR sq_entry_t *obj;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(cache != NULL);
+
+  /* The free list may be accessed from interrupt handlers */
+
+  flags = enter_critical_section();
+  while ((obj = sq_remfirst(&cache->sc_freelist)) == NULL)
+    {
+      /* The free list is empty.  Interrupt handlers cannot allocate from
+       * the heap; they can only use objects that are already cached.
+       */
+
+      if (up_interrupt_context())
+        {
+          break;
+        }
+
+      /* Grow the cache.  The new objects could be taken by some other
+       * thread before we re-enter the critical section, hence the loop.
+       */
+
+      leave_critical_section(flags);
+      ret   = slab_grow(cache);
+      flags = enter_critical_section();
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* Update the statistics */
+
+  if (obj != NULL)
+    {
+      cache->sc_nalloc++;
+      if (++cache->sc_nused > cache->sc_hiwater)
+        {
+          cache->sc_hiwater = cache->sc_nused;
+        }
+    }
+  else
+    {
+      cache->sc_nfail++;
+    }
+
+  leave_critical_section(flags);
+  return (FAR void *)obj;
+}
+
+/****************************************************************************
+ * Name: slab_zalloc
+ *
+ * Description:
+ *   Same as slab_alloc() except that the object is zeroed.
+ *
+ ****************************************************************************/
+
+FAR void *slab_zalloc(FAR struct slab_cache_s *cache)
+{
+  FAR void *obj = slab_alloc(cache);
+  if (obj != NULL)
+    {
+      memset(obj, 0, cache->sc_objsize);
+    }
+
+  return obj;
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,110 @@
+/****************************************************************************
+ * mm/slab/slab_foreach.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_foreach
+ *
+ * Description:
+ *   Call the handler once for each initialized cache with a snapshot of
+ *   the cache state.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each cache
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_foreach(slab_handler_t handler, FAR void *arg)
+{
+  FAR struct slab_cache_s *cache;
+  struct slabinfo_s info;
+  irqstate_t flags;
+
+  DEBUGASSERT(handler != NULL);
+
+  /* Caches are never removed from the list so it is sufficient to take a
+   * consistent snapshot of each cache.  The handler is called outside of
+   * the critical section.
+   */
+
+  flags = enter_critical_section();
+  cache = g_slab_caches;
+
+  while (cache != NULL)
+    {
+      info.name     = cache->sc_name;
+      info.objsize  = cache->sc_objsize;
+      info.nperslab = cache->sc_nperslab;
+      info.nslabs   = cache->sc_nslabs;
+      info.nused    = cache->sc_nused;
+      info.nfree    = (uint32_t)cache->sc_nslabs * cache->sc_nperslab -
+                      cache->sc_nused;
+      info.hiwater  = cache->sc_hiwater;
+      info.nalloc   = cache->sc_nalloc;
+      info.nfail    = cache->sc_nfail;
+      leave_critical_section(flags);
+
+      handler(&info, arg);
+
+      flags = enter_critical_section();
+      cache = cache->sc_flink;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_MM_SLAB */
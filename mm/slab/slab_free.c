@@ -0,0 +1,91 @@
+/****************************************************************************
+ * mm/slab/slab_free.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_free
+ *
+ * Description:
+ *   Return an object to the cache that it was allocated from.  This
+ *   function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   cache - The cache that the object was allocated from
+ *   obj   - The object to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_free(FAR struct slab_cache_s *cache, FAR void *obj)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cache != NULL && obj != NULL);
+  DEBUGASSERT(slab_member(cache, obj));
+
+  /* Objects are freed to the head of the list so that the most recently
+   * used (and most likely cached) object is re-used first.
+   */
+
+  flags = enter_critical_section();
+  DEBUGASSERT(cache->sc_nused > 0);
+
+  sq_addfirst((FAR sq_entry_t *)obj, &cache->sc_freelist);
+  cache->sc_nused--;
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * mm/slab/slab_grow.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_grow
+ *
+ * Description:
+ *   Allocate one new slab from the kernel heap and add all of its objects
+ *   to the free list of the cache.  This function is intended only for
+ *   internal use by the slab module and must not be called from an
+ *   interrupt handler.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the slab could not be allocated.
+ *
+ ****************************************************************************/
+
+int slab_grow(FAR struct slab_cache_s *cache)
+{
+  FAR struct slab_s *slab;
+  FAR uint8_t *obj;
+  irqstate_t flags;
+  int i;
+
+  DEBUGASSERT(cache != NULL && !up_interrupt_context());
+
+  /* Allocate the slab.  Interrupts need not be disabled to do this. */
+
+  slab = (FAR struct slab_s *)
+    kmm_malloc(SLAB_HDRSIZE + cache->sc_nperslab * cache->sc_objsize);
+
+  if (slab == NULL)
+    {
+      mwarn("WARNING: Failed to grow cache %s\n", cache->sc_name);
+      return -ENOMEM;
+    }
+
+  /* Add the slab to the cache and all of its objects to the free list */
+
+  flags           = enter_critical_section();
+  slab->sl_flink  = cache->sc_slabs;
+  cache->sc_slabs = slab;
+  cache->sc_nslabs++;
+
+  for (i = 0, obj = SLAB_OBJECTS(slab);
+       i < cache->sc_nperslab;
+       i++, obj += cache->sc_objsize)
+    {
+      sq_addlast((FAR sq_entry_t *)obj, &cache->sc_freelist);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,112 @@
+/****************************************************************************
+ * mm/slab/slab_initialize.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of all initialized caches */
+
+FAR struct slab_cache_s *g_slab_caches;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_initialize
+ *
+ * Description:
+ *   Initialize a cache of fixed-size objects and add it to the list of
+ *   caches reported by slab_foreach().  No memory is allocated until the
+ *   first call to slab_alloc().
+ *
+ * Input Parameters:
+ *   cache    - The cache to be initialized
+ *   name     - A name for the cache.  The string must persist.
+ *   objsize  - The size of one object
+ *   nperslab - The number of objects allocated each time the cache grows
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void slab_initialize(FAR struct slab_cache_s *cache, FAR const char *name,
+                     size_t objsize, uint16_t nperslab)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cache != NULL && objsize > 0 && nperslab > 0);
+
+  /* The aligned object size is at least SLAB_ALIGN bytes and so is always
+   * large enough to hold the free list link of a free object.
+   */
+
+  cache->sc_name     = name;
+  cache->sc_slabs    = NULL;
+  sq_init(&cache->sc_freelist);
+  cache->sc_objsize  = SLAB_ALIGN_UP(objsize);
+  cache->sc_nperslab = nperslab;
+  cache->sc_nslabs   = 0;
+  cache->sc_nused    = 0;
+  cache->sc_hiwater  = 0;
+  cache->sc_nalloc   = 0;
+  cache->sc_nfail    = 0;
+
+  /* Add the cache to the list of all caches */
+
+  flags              = enter_critical_section();
+  cache->sc_flink    = g_slab_caches;
+  g_slab_caches      = cache;
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_MM_SLAB */
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * mm/slab/slab_member.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/slab.h>
+
+#include "slab.h"
+
+#ifdef CONFIG_MM_SLAB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: slab_member
+ *
+ * Description:
+ *   Return true if the memory at obj lies within one of the slabs of the
+ *   cache.  This is used when objects from a cache and from the heap may
+ *   be released by the same logic.
+ *
+ * Input Parameters:
+ *   cache - The cache to check
+ *   obj   - The object in question
+ *
+ * Returned Value:
+ *   True if obj was allocated from the cache.
+ *
+ ****************************************************************************/
+
+bool slab_member(FAR struct slab_cache_s *cache, FAR const void *obj)
+{
+  FAR struct slab_s *slab;
+  FAR const uint8_t *start;
+  FAR const uint8_t *end;
+  irqstate_t flags;
+  bool member = false;
+
+  DEBUGASSERT(cache != NULL);
+
+  flags = enter_critical_section();
+  for (slab = cache->sc_slabs; slab != NULL; slab = slab->sl_flink)
+    {
+      start = SLAB_OBJECTS(slab);
+      end   = start + cache->sc_nperslab * cache->sc_objsize;
+
+      if ((FAR const uint8_t *)obj >= start &&
+          (FAR const uint8_t *)obj < end)
+        {
+          member = true;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return member;
+}
+
+#endif /* CONFIG_MM_SLAB */
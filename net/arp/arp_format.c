@@ -86,6 +86,15 @@ void arp_format(FAR struct net_driver_s *dev, in_addr_t ipaddr)
   FAR struct arp_hdr_s *arp = ARPBUF;
   FAR struct eth_hdr_s *eth = ETHBUF;
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* This replaces any outgoing packet, including application data that
+   * was left in an I/O buffer chain.
+   */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Construct the ARP packet.  Creating both the Ethernet and ARP headers */
 
   memset(eth->dest, 0xff, ETHER_ADDR_LEN);
@@ -144,9 +144,11 @@ void arp_out(FAR struct net_driver_s *dev)
   in_addr_t destipaddr;
   int ret;
 
-#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND)
+#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND) || \
+    defined(CONFIG_NET_IPFORWARD_FLOWCACHE)
   /* Skip sending ARP requests when the frame to be transmitted was
-   * written into a packet socket.
+   * written into a packet socket or already has its Ethernet header (such
+   * as packets forwarded on the fast path).
    */
 
   if (IFF_IS_NOARP(dev->d_flags))
@@ -48,7 +48,9 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
@@ -63,6 +65,8 @@
 
 #include <arp/arp.h>
 #include <netdev/netdev.h>
+#include <utils/utils.h>
+#include <netlink/netlink.h>
 
 #ifdef CONFIG_NET_ARP
 
@@ -82,13 +86,31 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+/* One entry in the hashed ARP table */
+
+struct arp_node_s
+{
+  struct net_agecache_entry_s an_age;  /* Must be first */
+  struct arp_entry_s          an_entry;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ARPTAB_HASH
+/* The hashed table of known address mappings */
+
+static struct net_agecache_s g_arpcache =
+  NET_AGECACHE_INITIALIZER(struct arp_node_s, an_entry.at_ipaddr,
+                           CONFIG_NET_ARPTAB_SIZE, ARP_MAXAGE_TICK);
+#else
 /* The table of known address mappings */
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -141,6 +163,7 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 
+#ifndef CONFIG_NET_ARPTAB_HASH
 /****************************************************************************
  * Name: arp_return_old_entry
  *
@@ -169,6 +192,7 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
       return e2;
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -196,6 +220,43 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
+#ifdef CONFIG_NET_ARPTAB_HASH
+  FAR struct arp_node_s *node;
+#ifdef CONFIG_NETLINK_ROUTE
+  bool changed;
+
+  /* Only new or changed mappings are reported to netlink */
+
+  node    = (FAR struct arp_node_s *)net_agecache_find(&g_arpcache, &ipaddr);
+  changed = node == NULL ||
+            memcmp(node->an_entry.at_ethaddr.ether_addr_octet, ethaddr,
+                   ETHER_ADDR_LEN) != 0;
+#endif
+
+  /* Find the entry for this IP address, creating it (or replacing the
+   * oldest entry) if there is none.
+   */
+
+  node = (FAR struct arp_node_s *)net_agecache_insert(&g_arpcache, &ipaddr);
+  if (node == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(node->an_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  node->an_entry.at_time = node->an_age.ae_time;
+
+#ifdef CONFIG_NETLINK_ROUTE
+  if (changed)
+    {
+      netlink_neigh_notify(NULL, RTM_NEWNEIGH, AF_INET, &ipaddr, ethaddr,
+                           ETHER_ADDR_LEN);
+    }
+#endif
+
+  return OK;
+#else
   FAR struct arp_entry_s *tabptr = &g_arptable[0];
   int i;
 
@@ -230,10 +291,23 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
    * information.
    */
 
+#ifdef CONFIG_NETLINK_ROUTE
+  /* Only new or changed mappings are reported to netlink */
+
+  if (!net_ipv4addr_cmp(tabptr->at_ipaddr, ipaddr) ||
+      memcmp(tabptr->at_ethaddr.ether_addr_octet, ethaddr,
+             ETHER_ADDR_LEN) != 0)
+    {
+      netlink_neigh_notify(NULL, RTM_NEWNEIGH, AF_INET, &ipaddr, ethaddr,
+                           ETHER_ADDR_LEN);
+    }
+#endif
+
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = clock_systimer();
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -282,6 +356,16 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
+#ifdef CONFIG_NET_ARPTAB_HASH
+  FAR struct arp_node_s *node;
+
+  /* Check if the IPv4 address is in the ARP table.  Expired entries are
+   * never returned.
+   */
+
+  node = (FAR struct arp_node_s *)net_agecache_find(&g_arpcache, &ipaddr);
+  return node != NULL ? &node->an_entry : NULL;
+#else
   FAR struct arp_entry_s *tabptr;
   int i;
 
@@ -300,6 +384,7 @@ FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
   /* Not found */
 
   return NULL;
+#endif
 }
 
 /****************************************************************************
@@ -381,6 +466,19 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
+#ifdef CONFIG_NET_ARPTAB_HASH
+  FAR struct net_agecache_entry_s *entry;
+
+  /* Check if the IPv4 address is in the ARP table. */
+
+  entry = net_agecache_find(&g_arpcache, &ipaddr);
+  if (entry != NULL)
+    {
+      /* Yes.. remove and free it */
+
+      net_agecache_remove(&g_arpcache, entry);
+    }
+#else
   FAR struct arp_entry_s *tabptr;
 
   /* Check if the IPv4 address is in the ARP table. */
@@ -392,6 +490,7 @@ void arp_delete(in_addr_t ipaddr)
 
       tabptr->at_ipaddr = 0;
     }
+#endif
 }
 
 #endif /* CONFIG_NET_ARP */
@@ -474,6 +474,30 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, void *pvconn,
 
 void devif_send(FAR struct net_driver_s *dev, FAR const void *buf, int len);
 
+/****************************************************************************
+ * Name: devif_ref_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that, if the driver
+ *   supports scatter-gather transmit, the data is not copied but referenced
+ *   in place (see netdev_txsegs()).  The caller must assure that the data
+ *   remains valid and unmodified until the transmission completes.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SGTX
+void devif_ref_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                    int len);
+#else
+#  define devif_ref_send(dev,buf,len) devif_send(dev,buf,len)
+#endif
+
 /****************************************************************************
  * Name: devif_iob_send
  *
@@ -495,6 +519,23 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
                     unsigned int len, unsigned int offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_tso_send
+ *
+ * Description:
+ *   Like devif_iob_send(), but for a large TCP segment that the driver will
+ *   split into segments of 'mss' bytes of data.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+void devif_tso_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
+                    unsigned int len, unsigned int offset, uint16_t mss);
+#endif
+
 /****************************************************************************
  * Name: devif_pkt_send
  *
@@ -48,6 +48,45 @@
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_nsegs
+ *
+ * Description:
+ *   Return the number of I/O buffers that hold the 'len' bytes of the I/O
+ *   buffer chain beginning at 'offset'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SGTX
+static unsigned int devif_iob_nsegs(FAR struct iob_s *iob, unsigned int len,
+                                    unsigned int offset)
+{
+  unsigned int nsegs = 0;
+
+  for (; iob != NULL && len > 0; iob = iob->io_flink)
+    {
+      if (offset >= iob->io_len)
+        {
+          offset -= iob->io_len;
+        }
+      else
+        {
+          unsigned int seglen = iob->io_len - offset;
+
+          len   -= seglen > len ? len : seglen;
+          offset = 0;
+          nsegs++;
+        }
+    }
+
+  return nsegs;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,7 +99,9 @@
  *   the network interface driver.
  *
  *   This is identical to calling devif_send() except that the data is
- *   in an I/O buffer chain, rather than a flat buffer.
+ *   in an I/O buffer chain, rather than a flat buffer.  If the driver
+ *   supports scatter-gather transmit, the data is not copied but left in
+ *   the I/O buffer chain for the driver (see netdev_txsegs()).
  *
  * Assumptions:
  *   Called with the network locked.
@@ -72,6 +113,28 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 {
   DEBUGASSERT(dev && len > 0 && len < NETDEV_PKTSIZE(dev));
 
+#ifdef CONFIG_NETDEV_TSO
+  dev->d_tsomss = 0;
+#endif
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* If the driver can transmit the headers in d_buf followed by each I/O
+   * buffer separately, then just leave the data in the I/O buffer chain.
+   */
+
+  if (dev->d_sgmax > 1 && devif_iob_nsegs(iob, len, offset) < dev->d_sgmax)
+    {
+      dev->d_iob    = iob;
+      dev->d_iobofs = offset;
+      dev->d_sndlen = len;
+      dev->d_sndref = NULL;
+      return;
+    }
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Copy the data from the I/O buffer chain to the device buffer */
 
   iob_copyout(dev->d_appdata, iob, len, offset);
@@ -84,5 +147,32 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 #endif
 }
 
+/****************************************************************************
+ * Name: devif_tso_send
+ *
+ * Description:
+ *   Like devif_iob_send(), but for a large TCP segment of up to d_tsomax
+ *   bytes of data that the driver must split into segments of 'mss' bytes
+ *   (see netdev_gso()).  The data is always left in the I/O buffer chain.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+void devif_tso_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                    unsigned int len, unsigned int offset, uint16_t mss)
+{
+  DEBUGASSERT(dev && len > mss && mss > 0 && len <= dev->d_tsomax);
+
+  dev->d_iob    = iob;
+  dev->d_iobofs = offset;
+  dev->d_sndlen = len;
+  dev->d_sndref = NULL;
+  dev->d_tsomss = mss;
+}
+#endif
+
 #endif /* CONFIG_MM_IOB */
 
@@ -45,6 +45,9 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/pkt.h>
 #include <nuttx/net/netdev.h>
+#ifdef CONFIG_NETDEV_SGTX
+#  include <nuttx/mm/iob.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -83,6 +86,22 @@ static bool is_loopback(FAR struct net_driver_s *dev)
   return false;
 }
 
+/****************************************************************************
+ * Name: devif_loopback_segment
+ *
+ * Description:
+ *   Loop back one segment of a large TCP frame (see netdev_gso()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+static int devif_loopback_segment(FAR struct net_driver_s *dev)
+{
+  (void)devif_loopback(dev);
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_loopback
  *
@@ -100,17 +119,61 @@ static bool is_loopback(FAR struct net_driver_s *dev)
 
 int devif_loopback(FAR struct net_driver_s *dev)
 {
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  uint8_t rxchksum;
+#endif
+
   if (!is_loopback(dev))
     {
       return 0;
     }
 
+#ifdef CONFIG_NETDEV_TSO
+  /* A large TCP frame must be received one segment at a time */
+
+  if (NETDEV_IS_TSO(dev))
+    {
+      (void)netdev_gso(dev, devif_loopback_segment);
+      dev->d_len = 0;
+      return 1;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  /* The checksums that were left for the hardware to insert are missing
+   * from the packets that are looped back.  Don't verify them.
+   */
+
+  rxchksum         = dev->d_rxchksum;
+  dev->d_rxchksum |= dev->d_txchksum;
+#endif
+
   /* Loop while if there is data "sent" to ourself.
    * Sending, of course, just means relaying back through the network.
    */
 
   do
     {
+#ifdef CONFIG_NETDEV_SGTX
+      /* The packet will be received from d_buf.  Copy in any application
+       * data that was left in an I/O buffer chain.
+       */
+
+      if (dev->d_iob != NULL && dev->d_sndlen > 0)
+        {
+          iob_copyout(&dev->d_buf[dev->d_len - dev->d_sndlen], dev->d_iob,
+                      dev->d_sndlen, dev->d_iobofs);
+        }
+      else if (dev->d_sndref != NULL && dev->d_sndlen > 0)
+        {
+          memcpy(&dev->d_buf[dev->d_len - dev->d_sndlen], dev->d_sndref,
+                 dev->d_sndlen);
+        }
+
+      dev->d_iob    = NULL;
+      dev->d_sndref = NULL;
+#endif
+
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
@@ -157,6 +220,10 @@ int devif_loopback(FAR struct net_driver_s *dev)
     }
   while (dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_CHKSUM_OFFLOAD
+  dev->d_rxchksum = rxchksum;
+#endif
+
   return 1;
 }
 
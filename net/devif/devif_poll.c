@@ -47,6 +47,7 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
 #include "arp/arp.h"
@@ -84,10 +85,71 @@ enum devif_packet_type
 
 clock_t g_polltime;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PERF
+/* The driver callback of the current poll.  Polls are serialized by the
+ * network lock so only one is needed.
+ */
+
+static devif_poll_callback_t g_perf_callback;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: devif_perf_callback
+ *
+ * Description:
+ *   Call the driver's poll callback, timing it if there is a packet for it
+ *   to send.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PERF
+static int devif_perf_callback(FAR struct net_driver_s *dev)
+{
+  uint64_t start;
+  int ret;
+
+  if (dev->d_len == 0)
+    {
+      return g_perf_callback(dev);
+    }
+
+  start = netperf_gettime();
+  ret   = g_perf_callback(dev);
+  netperf_update(NETPERF_DRIVER_TX, start);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: devif_perf_wrap
+ *
+ * Description:
+ *   Substitute devif_perf_callback() for the driver's poll callback.  This
+ *   does nothing if it has already been substituted by devif_timer().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PERF
+static inline devif_poll_callback_t
+devif_perf_wrap(devif_poll_callback_t callback)
+{
+  if (callback != devif_perf_callback)
+    {
+      g_perf_callback = callback;
+    }
+
+  return devif_perf_callback;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_packet_conversion
  *
@@ -609,6 +671,19 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 {
   int bstop = false;
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+#ifdef CONFIG_NET_PERF
+  callback = devif_perf_wrap(callback);
+#endif
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* There is no outgoing application data in an I/O buffer chain yet */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
 
   /* Traverse all of the active packet connections and perform the poll
    * action.
@@ -718,6 +793,7 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
       /* Nothing more to do */
     }
 
+  NETPERF_UPDATE(NETPERF_DEVIF_POLL, start);
   return bstop;
 }
 
@@ -751,6 +827,17 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   clock_t elapsed;
   int bstop = false;
 
+#ifdef CONFIG_NET_PERF
+  callback = devif_perf_wrap(callback);
+#endif
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* There is no outgoing application data in an I/O buffer chain yet */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Get the elapsed time since the last poll in units of half seconds
    * (truncating).
    */
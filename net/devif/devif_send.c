@@ -71,4 +71,47 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* The application data is in d_buf */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: devif_ref_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that, if the driver
+ *   supports scatter-gather transmit, the data is not copied but referenced
+ *   in place (see netdev_txsegs()).  The caller must assure that the data
+ *   remains valid and unmodified until the transmission completes.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SGTX
+void devif_ref_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                    int len)
+{
+  DEBUGASSERT(dev != NULL && len > 0 && len < NETDEV_PKTSIZE(dev));
+
+  if (dev->d_sgmax > 1)
+    {
+      dev->d_iob    = NULL;
+      dev->d_sndref = (FAR const uint8_t *)buf;
+      dev->d_sndlen = len;
+    }
+  else
+    {
+      devif_send(dev, buf, len);
+    }
 }
+#endif
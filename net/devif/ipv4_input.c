@@ -83,6 +83,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <errno.h>
 #include <debug.h>
 #include <string.h>
 
@@ -102,6 +103,7 @@
 #include "igmp/igmp.h"
 
 #include "ipforward/ipforward.h"
+#include "ipfilter/ipfilter.h"
 #include "devif/devif.h"
 
 /****************************************************************************
@@ -312,24 +314,14 @@ nullreturn:
 #endif /* CONFIG_NET_IPv4_REASSEMBLY */
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: ipv4_input
+ * Name: ipv4_in
  *
  * Description:
- *
- * Returned Value:
- *   OK    - The packet was processed (or dropped) and can be discarded.
- *   ERROR - Hold the packet and try again later.  There is a listening
- *           socket but no receive in place to catch the packet yet.  The
- *           device's d_len will be set to zero in this case as there is
- *           no outgoing data.
+ *   Process an incoming IPv4 packet.  See ipv4_input().
  *
  ****************************************************************************/
 
-int ipv4_input(FAR struct net_driver_s *dev)
+static int ipv4_in(FAR struct net_driver_s *dev)
 {
   FAR struct ipv4_hdr_s *ipv4 = BUF;
   in_addr_t destipaddr;
@@ -342,6 +334,13 @@ int ipv4_input(FAR struct net_driver_s *dev)
   g_netstats.ipv4.recv++;
 #endif
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* There is no outgoing application data in an I/O buffer chain yet */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Start of IP input header processing code. */
   /* Check validity of the IP header. */
 
@@ -405,6 +404,17 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Packets of flows that are known to be forwarded take a short path that
+   * bypasses the remaining input processing.
+   */
+
+  if (ipv4_fastforward(dev, ipv4) >= 0)
+    {
+      return OK;
+    }
+
+#endif
   /* Get the destination IP address in a friendlier form */
 
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
@@ -419,6 +429,16 @@ int ipv4_input(FAR struct net_driver_s *dev)
   if (ipv4->proto == IP_PROTO_UDP &&
       net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST))
     {
+#ifdef CONFIG_NET_IPFILTER
+      if (ipfilter_ipv4(dev, IPFILTER_INPUT) == IPFILTER_DROP)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipv4.drop++;
+#endif
+          goto drop;
+        }
+
+#endif
 #ifdef CONFIG_NET_IPFORWARD_BROADCAST
       /* Forward broadcast packets */
 
@@ -449,6 +469,16 @@ int ipv4_input(FAR struct net_driver_s *dev)
       net_ipv4addr_maskcmp(destipaddr, dev->d_ipaddr, dev->d_netmask) &&
       net_ipv4addr_broadcast(destipaddr, dev->d_netmask))
     {
+#ifdef CONFIG_NET_IPFILTER
+      if (ipfilter_ipv4(dev, IPFILTER_INPUT) == IPFILTER_DROP)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipv4.drop++;
+#endif
+          goto drop;
+        }
+
+#endif
 #ifdef CONFIG_NET_IPFORWARD_BROADCAST
       /* Forward broadcast packets */
 
@@ -484,7 +514,15 @@ int ipv4_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_IPFORWARD
           /* Try to forward the packet */
 
-          int ret = ipv4_forward(dev, ipv4);
+          int ret = -EPERM;
+
+#ifdef CONFIG_NET_IPFILTER
+          if (ipfilter_ipv4(dev, IPFILTER_FORWARD) == IPFILTER_ACCEPT)
+#endif
+            {
+              ret = ipv4_forward(dev, ipv4);
+            }
+
           if (ret >= 0)
             {
               /* The packet was forwarded.  Return success; d_len will
@@ -514,7 +552,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCHKSUM(dev, NETDEV_CHKSUM_IPv4) && ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -532,6 +570,18 @@ int ipv4_input(FAR struct net_driver_s *dev)
 
   IFF_SET_IPv4(dev->d_flags);
 
+#ifdef CONFIG_NET_IPFILTER
+  /* Apply the packet filter before any protocol processing */
+
+  if (ipfilter_ipv4(dev, IPFILTER_INPUT) == IPFILTER_DROP)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.drop++;
+#endif
+      goto drop;
+    }
+
+#endif
   /* Now process the incoming packet according to the protocol. */
 
   switch (ipv4->proto)
@@ -586,4 +636,35 @@ drop:
   dev->d_len = 0;
   return OK;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_input
+ *
+ * Description:
+ *   Receive an IPv4 packet from the network device.
+ *
+ * Returned Value:
+ *   OK    - The packet was processed (or dropped) and can be discarded.
+ *   ERROR - Hold the packet and try again later.  There is a listening
+ *           socket but no receive in place to catch the packet yet.  The
+ *           device's d_len will be set to zero in this case as there is
+ *           no outgoing data.
+ *
+ ****************************************************************************/
+
+int ipv4_input(FAR struct net_driver_s *dev)
+{
+  int ret;
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+  ret = ipv4_in(dev);
+  NETPERF_UPDATE(NETPERF_IPv4_INPUT, start);
+
+  return ret;
+}
 #endif /* CONFIG_NET_IPv4 */
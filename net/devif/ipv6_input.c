@@ -83,6 +83,7 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <debug.h>
 #include <string.h>
 
@@ -103,6 +104,7 @@
 
 #include "netdev/netdev.h"
 #include "ipforward/ipforward.h"
+#include "ipfilter/ipfilter.h"
 #include "inet/inet.h"
 #include "devif/devif.h"
 
@@ -242,36 +244,14 @@ static bool check_destipaddr(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: ipv6_input
+ * Name: ipv6_in
  *
  * Description:
- *   Receive an IPv6 packet from the network device.  Verify and forward to
- *   L3 packet handling logic if the packet is destined for us.
- *
- * Input Parameters:
- *   dev   - The device on which the packet was received and which contains
- *           the IPv6 packet.
- * Returned Value:
- *   OK    - The packet was processed (or dropped) and can be discarded.
- *   ERROR - Hold the packet and try again later.  There is a listening
- *           socket but no receive in place to catch the packet yet.  The
- *           device's d_len will be set to zero in this case as there is
- *           no outgoing data.
- *
- *   If this function returns to the network driver with dev->d_len > 0,
- *   that is an indication to the driver that there is an outgoing response
- *   to this input.
- *
- * Assumptions:
- *   The network is locked.
+ *   Process an incoming IPv6 packet.  See ipv6_input().
  *
  ****************************************************************************/
 
-int ipv6_input(FAR struct net_driver_s *dev)
+static int ipv6_in(FAR struct net_driver_s *dev)
 {
   FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
   FAR uint8_t *payload;
@@ -289,6 +269,13 @@ int ipv6_input(FAR struct net_driver_s *dev)
   g_netstats.ipv6.recv++;
 #endif
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* There is no outgoing application data in an I/O buffer chain yet */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Start of IP input header processing code. */
   /* Check validity of the IP header. */
 
@@ -433,7 +420,16 @@ int ipv6_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_IPFORWARD
           /* Not destined for us, try to forward the packet */
 
-          ret = ipv6_forward(dev, ipv6);
+          ret = -EPERM;
+
+#ifdef CONFIG_NET_IPFILTER
+          if (ipfilter_ipv6(dev, IPFILTER_FORWARD, nxthdr, iphdrlen) ==
+              IPFILTER_ACCEPT)
+#endif
+            {
+              ret = ipv6_forward(dev, ipv6);
+            }
+
           if (ret >= 0)
             {
               /* The packet was forwarded.  Return success; d_len will
@@ -456,6 +452,18 @@ int ipv6_input(FAR struct net_driver_s *dev)
         }
     }
 
+#ifdef CONFIG_NET_IPFILTER
+  /* Apply the packet filter before any protocol processing */
+
+  if (ipfilter_ipv6(dev, IPFILTER_INPUT, nxthdr, iphdrlen) == IPFILTER_DROP)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.drop++;
+#endif
+      goto drop;
+    }
+
+#endif
   /* Now process the incoming packet according to the protocol specified in
    * the next header IPv6 field.
    */
@@ -566,4 +574,46 @@ drop:
   dev->d_len = 0;
   return OK;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv6_input
+ *
+ * Description:
+ *   Receive an IPv6 packet from the network device.  Verify and forward to
+ *   L3 packet handling logic if the packet is destined for us.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv6 packet.
+ * Returned Value:
+ *   OK    - The packet was processed (or dropped) and can be discarded.
+ *   ERROR - Hold the packet and try again later.  There is a listening
+ *           socket but no receive in place to catch the packet yet.  The
+ *           device's d_len will be set to zero in this case as there is
+ *           no outgoing data.
+ *
+ *   If this function returns to the network driver with dev->d_len > 0,
+ *   that is an indication to the driver that there is an outgoing response
+ *   to this input.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv6_input(FAR struct net_driver_s *dev)
+{
+  int ret;
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+  ret = ipv6_in(dev);
+  NETPERF_UPDATE(NETPERF_IPv6_INPUT, start);
+
+  return ret;
+}
 #endif /* CONFIG_NET_IPv6 */
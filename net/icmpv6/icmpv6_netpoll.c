@@ -44,6 +44,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include <devif/devif.h>
@@ -149,7 +150,7 @@ static uint16_t icmpv6_poll_eventhandler(FAR struct net_driver_s *dev,
       if (eventset)
         {
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -267,7 +268,7 @@ int icmpv6_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
   net_unlock();
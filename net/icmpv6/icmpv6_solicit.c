@@ -105,6 +105,15 @@ void icmpv6_solicit(FAR struct net_driver_s *dev,
   uint16_t lladdrsize;
   uint16_t l3size;
 
+#ifdef CONFIG_NETDEV_SGTX
+  /* This replaces any outgoing packet, including application data that
+   * was left in an I/O buffer chain.
+   */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
   /* Set up the IPv6 header (most is probably already in place) */
 
   ipv6          = IPv6BUF;
@@ -346,7 +346,7 @@ static uint16_t ieee802154_sendto_eventhandler(FAR struct net_driver_s *dev,
 
       /* Allocate an IOB to hold the frame data */
 
-      iob = net_ioballoc(false);
+      iob = net_ioballoc(false, IOBUSER_UNKNOWN);
       if (iob == NULL)
         {
           nwarn("WARNING: Failed to allocate IOB\n");
@@ -76,6 +76,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <queue.h>
 
 #include <nuttx/wqueue.h>
 #include <nuttx/net/ip.h>
@@ -124,6 +125,7 @@ typedef FAR struct wdog_s *WDOG_ID;
 struct igmp_group_s
 {
   struct igmp_group_s *next;    /* Implements a singly-linked list */
+  sq_entry_t           hnode;   /* Links the group in its hash bucket */
   struct work_s        work;    /* For deferred timeout operations */
   in_addr_t            grpaddr; /* Group IPv4 address */
   WDOG_ID              wdog;    /* WDOG used to detect timeouts */
@@ -53,6 +53,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
@@ -95,6 +96,30 @@
 #  endif
 #endif
 
+/* Map a group address (in network order) to its hash bucket */
+
+#define IGMP_GRPHASH(dev,a) \
+  (&(dev)->d_igmp_grphash[igmp_grphash(a) % CONFIG_NET_IGMP_HASHSIZE])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  igmp_grphash
+ *
+ * Description:
+ *   Fold a group address into a hash value.  Group addresses mostly differ
+ *   in their low-order bits, so all of the bytes are mixed.
+ *
+ ****************************************************************************/
+
+static inline uint32_t igmp_grphash(in_addr_t addr)
+{
+  uint32_t hash = addr ^ (addr >> 16);
+  return hash ^ (hash >> 8);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -144,9 +169,12 @@ FAR struct igmp_group_s *igmp_grpalloc(FAR struct net_driver_s *dev,
 
       group->ifindex = dev->d_ifindex;
 
-      /* Add the group structure to the list in the device structure */
+      /* Add the group structure to the list and to the hash table in the
+       * device structure.
+       */
 
       sq_addfirst((FAR sq_entry_t *)group, &dev->d_igmp_grplist);
+      sq_addfirst(&group->hnode, IGMP_GRPHASH(dev, *addr));
     }
 
   return group;
@@ -167,23 +195,28 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
                                       FAR const in_addr_t *addr)
 {
   FAR struct igmp_group_s *group;
+  FAR sq_entry_t *entry;
 
   grpinfo("Searching for addr %08x\n", (int)*addr);
 
-  for (group = (FAR struct igmp_group_s *)dev->d_igmp_grplist.head;
-       group;
-       group = group->next)
+  /* Only the groups in the hash bucket of the address need be examined */
+
+  for (entry = sq_peek(IGMP_GRPHASH(dev, *addr));
+       entry != NULL;
+       entry = sq_next(entry))
     {
+      group = container_of(entry, struct igmp_group_s, hnode);
+
       grpinfo("Compare: %08x vs. %08x\n", group->grpaddr, *addr);
       if (net_ipv4addr_cmp(group->grpaddr, *addr))
         {
           grpinfo("Match!\n");
           DEBUGASSERT(group->ifindex == dev->d_ifindex);
-          break;
+          return group;
         }
     }
 
-  return group;
+  return NULL;
 }
 
 /****************************************************************************
@@ -232,9 +265,12 @@ void igmp_grpfree(FAR struct net_driver_s *dev, FAR struct igmp_group_s *group)
 
   wd_cancel(group->wdog);
 
-  /* Remove the group structure from the group list in the device structure */
+  /* Remove the group structure from the group list and from the hash table
+   * in the device structure.
+   */
 
   sq_rem((FAR sq_entry_t *)group, &dev->d_igmp_grplist);
+  sq_rem(&group->hnode, IGMP_GRPHASH(dev, group->grpaddr));
 
   /* Destroy the wait semaphore */
 
@@ -93,9 +93,16 @@ void igmp_initialize(void)
 
 void igmp_devinit(struct net_driver_s *dev)
 {
+  int i;
+
   ninfo("IGMP initializing dev %p\n", dev);
   DEBUGASSERT(dev->d_igmp_grplist.head == NULL);
 
+  for (i = 0; i < CONFIG_NET_IGMP_HASHSIZE; i++)
+    {
+      sq_init(&dev->d_igmp_grphash[i]);
+    }
+
   /* Add the all systems address to the group */
 
   (void)igmp_grpalloc(dev, &g_ipv4_allsystems);
@@ -51,6 +51,7 @@
 #include <nuttx/net/igmp.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "igmp/igmp.h"
 
 #ifdef CONFIG_NET_IGMP
@@ -91,7 +92,9 @@ static void igmp_mcastmac(in_addr_t *ip, FAR uint8_t *mac)
  * Name:  igmp_addmcastmac
  *
  * Description:
- *   Add an IGMP MAC address to the device's MAC filter table.
+ *   Add an IGMP MAC address to the device's MAC filter table.  Several
+ *   groups may share one MAC address; the filter entry is reference
+ *   counted.
  *
  ****************************************************************************/
 
@@ -100,18 +103,16 @@ void igmp_addmcastmac(FAR struct net_driver_s *dev, FAR in_addr_t *ip)
   uint8_t mcastmac[6];
 
   ninfo("Adding: IP %08x\n", *ip);
-  if (dev->d_addmac)
-    {
-      igmp_mcastmac(ip, mcastmac);
-      dev->d_addmac(dev, mcastmac);
-    }
+  igmp_mcastmac(ip, mcastmac);
+  (void)netdev_addmcastmac(dev, mcastmac);
 }
 
 /****************************************************************************
  * Name:  igmp_removemcastmac
  *
  * Description:
- *   Remove an IGMP MAC address from the device's MAC filter table.
+ *   Remove an IGMP MAC address from the device's MAC filter table.  The
+ *   address remains in the filter while other groups still use it.
  *
  ****************************************************************************/
 
@@ -120,11 +121,8 @@ void igmp_removemcastmac(FAR struct net_driver_s *dev, FAR in_addr_t *ip)
   uint8_t mcastmac[6];
 
   ninfo("Removing: IP %08x\n", *ip);
-  if (dev->d_rmmac)
-    {
-      igmp_mcastmac(ip, mcastmac);
-      dev->d_rmmac(dev, mcastmac);
-    }
+  igmp_mcastmac(ip, mcastmac);
+  (void)netdev_rmmcastmac(dev, mcastmac);
 }
 
 #endif /* CONFIG_NET_IGMP */
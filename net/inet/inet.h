@@ -287,6 +287,30 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       int flags, FAR struct sockaddr *from,
                       FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: inet_recvmsg
+ *
+ * Description:
+ *   Implements the recvmsg() operation for the case of the AF_INET and
+ *   AF_INET6 address families.  Datagrams already queued in the UDP
+ *   read-ahead buffers are scattered directly into the caller's buffers;
+ *   all other receptions go through inet_recvfrom() with a bounce buffer.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On errors, a
+ *   negated errno value is returned (see recvmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t inet_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                     int flags);
+
 /****************************************************************************
  * Name: inet_close
  *
@@ -305,6 +329,29 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
 int inet_close(FAR struct socket *psock);
 
+/****************************************************************************
+ * Name: inet_zcrecv_ioctl
+ *
+ * Description:
+ *   Handle the zero-copy receive ioctl commands SIOCZCRECV and
+ *   SIOCZCRELEASE.  See include/nuttx/net/zcrecv.h.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   cmd      The ioctl command
+ *   arg      The argument of the ioctl cmd
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.  -ENOTTY is returned if 'cmd' is not a zero-copy receive
+ *   command or if 'psock' is not a TCP or UDP socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ZEROCOPY_RECV
+int inet_zcrecv_ioctl(FAR struct socket *psock, int cmd, unsigned long arg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
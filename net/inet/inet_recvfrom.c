@@ -43,8 +43,10 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
@@ -431,7 +433,7 @@ static inline void inet_udp_readahead(struct inet_recvfrom_s *pstate)
       if (pstate->ir_buflen > 0)
         {
           recvlen = iob_copyout(pstate->ir_buffer, iob, pstate->ir_buflen,
-                                src_addr_size + sizeof(uint8_t));
+                                UDP_READAHEAD_HDRLEN(src_addr_size));
 
           ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
@@ -1177,6 +1179,7 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1189,7 +1192,8 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
 
 #ifdef NET_UDP_HAVE_STACK
 static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1229,7 +1233,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Handle non-blocking UDP sockets */
 
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1305,6 +1309,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1317,7 +1322,8 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 
 #ifdef NET_TCP_HAVE_STACK
 static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   struct inet_recvfrom_s state;
   int               ret;
@@ -1391,7 +1397,7 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 
   else
 #ifdef CONFIG_NET_TCP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1557,7 +1563,7 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_STREAM:
       {
 #ifdef NET_TCP_HAVE_STACK
-        ret = inet_tcp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_tcp_recvfrom(psock, buf, len, flags, from, fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -1569,7 +1575,7 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_DGRAM:
       {
 #ifdef NET_UDP_HAVE_STACK
-        ret = inet_udp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_udp_recvfrom(psock, buf, len, flags, from, fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -1588,4 +1594,239 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_udp_timestamp
+ *
+ * Description:
+ *   Return the time of reception as an SCM_TIMESTAMP control message if
+ *   the SO_TIMESTAMP option is set on the socket.
+ *
+ * Input Parameters:
+ *   psock    The UDP socket
+ *   msg      The message header to receive the control message
+ *   ctrllen  The size of the control message buffer provided by the caller
+ *   ts       The time of reception
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_TIMESTAMP)
+static void inet_udp_timestamp(FAR struct socket *psock,
+                               FAR struct msghdr *msg, size_t ctrllen,
+                               FAR const struct timespec *ts)
+{
+  FAR struct cmsghdr *cmsg;
+  struct timeval tv;
+
+  if (!_SO_GETOPT(psock->s_options, SO_TIMESTAMP))
+    {
+      return;
+    }
+
+  if (msg->msg_control == NULL ||
+      ctrllen < CMSG_LEN(sizeof(struct timeval)))
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+      return;
+    }
+
+  tv.tv_sec        = ts->tv_sec;
+  tv.tv_usec       = ts->tv_nsec / NSEC_PER_USEC;
+
+  cmsg             = (FAR struct cmsghdr *)msg->msg_control;
+  cmsg->cmsg_len   = CMSG_LEN(sizeof(struct timeval));
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type  = SCM_TIMESTAMP;
+  memcpy(CMSG_DATA(cmsg), &tv, sizeof(struct timeval));
+
+  msg->msg_controllen = CMSG_SPACE(sizeof(struct timeval));
+  if (msg->msg_controllen > ctrllen)
+    {
+      msg->msg_controllen = cmsg->cmsg_len;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: inet_udp_recvmsg
+ *
+ * Description:
+ *   Perform the recvmsg() operation for a UDP SOCK_DGRAM socket with
+ *   read-ahead buffering.  A datagram that is already queued in the
+ *   read-ahead buffers is scattered directly from its I/O buffer chain into
+ *   the caller's buffers.  Otherwise, the next datagram is awaited through
+ *   the normal recvfrom() path.
+ *
+ * Input Parameters:
+ *   psock  Pointer to the socket structure for the SOCK_DRAM socket
+ *   msg    Describes the buffers to receive the message
+ *   flags  Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+static ssize_t inet_udp_recvmsg(FAR struct socket *psock,
+                                FAR struct msghdr *msg, int flags)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct iob_s *iob;
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  size_t ctrllen = msg->msg_controllen;
+  struct timespec ts;
+#endif
+  unsigned int offset;
+  unsigned int datalen;
+  uint8_t src_addr_size;
+  ssize_t ret;
+  int recvlen;
+  int i;
+
+  net_lock();
+  iob = iob_peek_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      net_unlock();
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      /* Nothing is buffered.  Wait for the next datagram.  It will be
+       * received into a contiguous buffer and then scattered.
+       */
+
+      ret = net_recvmsg_bounce(psock, msg, flags);
+
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+      /* The datagram was not time-stamped on reception.  Report the time
+       * at which it was delivered instead.
+       */
+
+      if (ret >= 0)
+        {
+          (void)clock_gettime(CLOCK_REALTIME, &ts);
+          inet_udp_timestamp(psock, msg, ctrllen, &ts);
+        }
+#endif
+
+      return ret;
+    }
+
+  /* Get the source address from the read-ahead header.  See
+   * udp_datahandler().
+   */
+
+  if (iob_copyout(&src_addr_size, iob, sizeof(uint8_t), 0) !=
+      sizeof(uint8_t))
+    {
+      ret = -EIO;
+      goto errout_with_iob;
+    }
+
+  if (msg->msg_name != NULL && msg->msg_namelen > 0)
+    {
+      socklen_t len = (socklen_t)msg->msg_namelen;
+
+      if ((socklen_t)src_addr_size < len)
+        {
+          len = src_addr_size;
+        }
+
+      (void)iob_copyout((FAR uint8_t *)msg->msg_name, iob, len,
+                        sizeof(uint8_t));
+      msg->msg_namelen = src_addr_size;
+    }
+
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  (void)iob_copyout((FAR uint8_t *)&ts, iob, sizeof(struct timespec),
+                    src_addr_size + sizeof(uint8_t));
+#endif
+
+  /* Scatter the payload into the caller's buffers */
+
+  offset  = UDP_READAHEAD_HDRLEN(src_addr_size);
+  datalen = iob->io_pktlen > offset ? iob->io_pktlen - offset : 0;
+  ret     = 0;
+
+  for (i = 0; i < (int)msg->msg_iovlen && (unsigned int)ret < datalen; i++)
+    {
+      recvlen = iob_copyout((FAR uint8_t *)msg->msg_iov[i].iov_base, iob,
+                            msg->msg_iov[i].iov_len, offset);
+      if (recvlen <= 0)
+        {
+          break;
+        }
+
+      offset += recvlen;
+      ret    += recvlen;
+    }
+
+  ninfo("Received %ld bytes (of %u)\n", (long)ret, datalen);
+
+  msg->msg_controllen = 0;
+  msg->msg_flags      = (unsigned int)ret < datalen ? MSG_TRUNC : 0;
+
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  inet_udp_timestamp(psock, msg, ctrllen, &ts);
+#endif
+
+  /* Leave the datagram in the read-ahead queue if we are only peeking */
+
+  if ((flags & MSG_PEEK) != 0)
+    {
+      net_unlock();
+      return ret;
+    }
+
+errout_with_iob:
+
+  /* Remove the I/O buffer chain from the head of the read-ahead queue and
+   * free it.
+   */
+
+  (void)iob_remove_queue(&conn->readahead);
+  (void)iob_free_chain(iob);
+  net_unlock();
+  return ret;
+}
+#endif /* NET_UDP_HAVE_STACK && CONFIG_NET_UDP_READAHEAD */
+
+/****************************************************************************
+ * Name: inet_recvmsg
+ *
+ * Description:
+ *   Implements the recvmsg() operation for the case of the AF_INET and
+ *   AF_INET6 address families.  Datagrams already queued in the UDP
+ *   read-ahead buffers are scattered directly into the caller's buffers;
+ *   all other receptions go through inet_recvfrom() with a bounce buffer.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On errors, a
+ *   negated errno value is returned (see recvmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t inet_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                     int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      return inet_udp_recvmsg(psock, msg, flags);
+    }
+#endif
+
+  return net_recvmsg_bounce(psock, msg, flags);
+}
+
 #endif /* CONFIG_NET */
@@ -88,6 +88,8 @@ static ssize_t    inet_send(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
                     size_t len, int flags, FAR const struct sockaddr *to,
                     socklen_t tolen);
+static ssize_t    inet_sendmsg(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
 #ifdef CONFIG_NET_SENDFILE
 static ssize_t    inet_sendfile(FAR struct socket *psock, FAR struct file *infile,
                     FAR off_t *offset, size_t count);
@@ -117,7 +119,12 @@ static const struct sock_intf_s g_inet_sockif =
   inet_sendfile,    /* si_sendfile */
 #endif
   inet_recvfrom,    /* si_recvfrom */
-  inet_close        /* si_close */
+  inet_close,       /* si_close */
+#ifdef CONFIG_NET_USRSOCK
+  NULL,             /* si_ioctl */
+#endif
+  inet_sendmsg,     /* si_sendmsg */
+  inet_recvmsg      /* si_recvmsg */
 };
 
 /****************************************************************************
@@ -425,6 +432,13 @@ static int inet_bind(FAR struct socket *psock,
 #ifdef NET_TCP_HAVE_STACK
           /* Bind a TCP/IP stream socket. */
 
+#ifdef CONFIG_NET_SOREUSEPORT
+          FAR struct tcp_conn_s *conn =
+            (FAR struct tcp_conn_s *)psock->s_conn;
+
+          conn->reuseport = _SO_GETOPT(psock->s_options, SO_REUSEPORT);
+#endif
+
           ret = tcp_bind(psock->s_conn, addr);
 
           /* Mark the socket bound */
@@ -447,6 +461,20 @@ static int inet_bind(FAR struct socket *psock,
 #ifdef NET_UDP_HAVE_STACK
           /* Bind a UDP/IP datagram socket */
 
+#ifdef CONFIG_NET_SOREUSEPORT
+          FAR struct udp_conn_s *conn =
+            (FAR struct udp_conn_s *)psock->s_conn;
+
+          if (_SO_GETOPT(psock->s_options, SO_REUSEPORT))
+            {
+              conn->flags |= _UDP_FLAG_REUSEPORT;
+            }
+          else
+            {
+              conn->flags &= ~_UDP_FLAG_REUSEPORT;
+            }
+#endif
+
           ret = udp_bind(psock->s_conn, addr);
 
           /* Mark the socket bound */
@@ -1165,35 +1193,25 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 }
 
 /****************************************************************************
- * Name: inet_sendto
+ * Name: inet_checkaddr
  *
  * Description:
- *   Implements the sendto() operation for the case of the AF_INET and
- *   AF_INET6 sockets.
+ *   Verify that a destination address is a supported INET address and
+ *   that the address structure is large enough to hold it.
  *
  * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error, a negated
- *   errno value is returned (see send_to() for the list of appropriate error
- *   values.
+ *   The size of the address for its family on success; a negated errno
+ *   value on failure.
  *
  ****************************************************************************/
 
-static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags, FAR const struct sockaddr *to,
-                           socklen_t tolen)
+static int inet_checkaddr(FAR const struct sockaddr *to, socklen_t tolen)
 {
   socklen_t minlen;
-  ssize_t nsent;
-
-  /* Verify that a valid address has been provided */
 
   switch (to->sa_family)
     {
@@ -1220,6 +1238,48 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+  return (int)minlen;
+}
+
+/****************************************************************************
+ * Name: inet_sendto
+ *
+ * Description:
+ *   Implements the sendto() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
+                           size_t len, int flags, FAR const struct sockaddr *to,
+                           socklen_t tolen)
+{
+  socklen_t minlen;
+  ssize_t nsent;
+
+  /* Verify that a valid address has been provided */
+
+  nsent = inet_checkaddr(to, tolen);
+  if (nsent < 0)
+    {
+      return nsent;
+    }
+
+  minlen = (socklen_t)nsent;
+
 #ifdef CONFIG_NET_UDP
   /* If this is a connected socket, then return EISCONN */
 
@@ -1258,6 +1318,61 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
   return nsent;
 }
 
+/****************************************************************************
+ * Name: inet_sendmsg
+ *
+ * Description:
+ *   Implements the sendmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  With UDP write buffering, the datagram is gathered
+ *   directly from the caller's buffers into a write buffer; otherwise it
+ *   is gathered into a temporary buffer and sent with inet_send() or
+ *   inet_sendto().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                            int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+   !defined(CONFIG_NET_6LOWPAN)
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+      socklen_t tolen               = (socklen_t)msg->msg_namelen;
+      int ret;
+
+      if (to != NULL && tolen > 0)
+        {
+          ret = inet_checkaddr(to, tolen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+      else
+        {
+          to    = NULL;
+          tolen = 0;
+        }
+
+      return psock_udp_sendmsg(psock, msg->msg_iov, (int)msg->msg_iovlen,
+                               flags, to, tolen);
+    }
+#endif
+
+  return net_sendmsg_bounce(psock, msg, flags);
+}
+
 /****************************************************************************
  * Name: inet_sendfile
  *
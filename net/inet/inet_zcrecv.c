@@ -0,0 +1,319 @@
+/****************************************************************************
+ * net/inet/inet_zcrecv.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/zcrecv.h>
+
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "inet/inet.h"
+
+#ifdef CONFIG_NET_ZEROCOPY_RECV
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_zcrecv_lend
+ *
+ * Description:
+ *   Describe each I/O buffer of the chain in the caller's I/O vector and
+ *   hand the chain over to the caller.
+ *
+ ****************************************************************************/
+
+static void inet_zcrecv_lend(FAR struct zcrecv_s *zc, FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  size_t len = 0;
+  int iovcnt = 0;
+
+  zc->zc_handle = iob;
+
+  for (next = iob; next != NULL; next = next->io_flink)
+    {
+      DEBUGASSERT(iovcnt < zc->zc_iovcnt);
+
+      zc->zc_iov[iovcnt].iov_base = IOB_DATA(next);
+      zc->zc_iov[iovcnt].iov_len  = next->io_len;
+      len += next->io_len;
+      iovcnt++;
+    }
+
+  zc->zc_iovcnt = iovcnt;
+  zc->zc_len    = len;
+}
+
+/****************************************************************************
+ * Name: inet_tcp_zcrecv
+ *
+ * Description:
+ *   Lend up to zc_iovcnt I/O buffers from the head of the TCP read-ahead
+ *   queue.  The lent buffers are not available to receive further data,
+ *   so the peer is throttled until they are released.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)
+static int inet_tcp_zcrecv(FAR struct socket *psock,
+                           FAR struct zcrecv_s *zc)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  FAR struct iob_s *iob;
+
+  iob = iob_split_queue(&conn->readahead, zc->zc_iovcnt);
+  if (iob == NULL)
+    {
+      /* There is no buffered data.  As with recv(), report end-of-file if
+       * the peer closed the connection gracefully.
+       */
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          if (!_SS_ISCLOSED(psock->s_flags))
+            {
+              return -ENOTCONN;
+            }
+
+          zc->zc_iovcnt = 0;
+          zc->zc_len    = 0;
+          zc->zc_handle = NULL;
+          return OK;
+        }
+
+      return -EAGAIN;
+    }
+
+  inet_zcrecv_lend(zc, iob);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: inet_udp_zcrecv
+ *
+ * Description:
+ *   Lend the I/O buffers holding the oldest datagram in the UDP read-ahead
+ *   queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+static int inet_udp_zcrecv(FAR struct socket *psock,
+                           FAR struct zcrecv_s *zc)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct iob_s *last;
+  FAR struct iob_s *iob;
+  uint8_t src_addr_size;
+  unsigned int datalen;
+  int niob;
+
+  iob = iob_remove_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  /* The datagram is preceded by the size of the source address, the
+   * source address itself, and possibly a timestamp.  See
+   * udp_datahandler().
+   */
+
+  if (iob_copyout(&src_addr_size, iob, sizeof(uint8_t), 0) !=
+      sizeof(uint8_t))
+    {
+      iob_free_chain(iob);
+      return -EIO;
+    }
+
+  if (zc->zc_from != NULL)
+    {
+      socklen_t len = zc->zc_fromlen;
+
+      if ((socklen_t)src_addr_size < len)
+        {
+          len = src_addr_size;
+        }
+
+      (void)iob_copyout((FAR uint8_t *)zc->zc_from, iob, len,
+                        sizeof(uint8_t));
+      zc->zc_fromlen = src_addr_size;
+    }
+
+  /* Remove the address header, leaving only the payload */
+
+  iob = iob_trimhead(iob, UDP_READAHEAD_HDRLEN(src_addr_size));
+
+  /* Discard the part of the datagram that cannot be described by the
+   * caller's I/O vector.
+   */
+
+  last    = iob;
+  datalen = last->io_len;
+
+  for (niob = 1; niob < zc->zc_iovcnt && last->io_flink != NULL; niob++)
+    {
+      last     = last->io_flink;
+      datalen += last->io_len;
+    }
+
+  zc->zc_flags = 0;
+  if (last->io_flink != NULL)
+    {
+      iob_free_chain(last->io_flink);
+      last->io_flink = NULL;
+      iob->io_pktlen = datalen;
+      zc->zc_flags   = MSG_TRUNC;
+    }
+
+  inet_zcrecv_lend(zc, iob);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_zcrecv_ioctl
+ *
+ * Description:
+ *   Handle the zero-copy receive ioctl commands SIOCZCRECV and
+ *   SIOCZCRELEASE.  See include/nuttx/net/zcrecv.h.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   cmd      The ioctl command
+ *   arg      The argument of the ioctl cmd
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.  -ENOTTY is returned if 'cmd' is not a zero-copy receive
+ *   command or if 'psock' is not a TCP or UDP socket.
+ *
+ ****************************************************************************/
+
+int inet_zcrecv_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
+{
+  FAR struct zcrecv_s *zc;
+  int ret;
+
+  switch (cmd)
+    {
+      case SIOCZCRECV:
+        break;
+
+      case SIOCZCRELEASE:
+        {
+          FAR struct iob_s *iob = (FAR struct iob_s *)((uintptr_t)arg);
+
+          if (iob == NULL)
+            {
+              return -EINVAL;
+            }
+
+          iob_free_chain(iob);
+          return OK;
+        }
+
+      default:
+        return -ENOTTY;
+    }
+
+  /* Only TCP and UDP sockets of the PF_INET/PF_INET6 families have
+   * read-ahead buffers to lend.
+   */
+
+  if (psock->s_sockif == NULL ||
+      psock->s_sockif->si_recvfrom != inet_recvfrom)
+    {
+      return -ENOTTY;
+    }
+
+  zc = (FAR struct zcrecv_s *)((uintptr_t)arg);
+  if (zc == NULL || zc->zc_iov == NULL || zc->zc_iovcnt <= 0)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  switch (psock->s_type)
+    {
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)
+      case SOCK_STREAM:
+        ret = inet_tcp_zcrecv(psock, zc);
+        break;
+#endif
+
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD)
+      case SOCK_DGRAM:
+        ret = inet_udp_zcrecv(psock, zc);
+        break;
+#endif
+
+      default:
+        ret = -EOPNOTSUPP;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_ZEROCOPY_RECV */
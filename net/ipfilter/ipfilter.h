@@ -0,0 +1,218 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_IPFILTER_IPFILTER_H
+#define __NET_IPFILTER_IPFILTER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/net/ipfilter.h>
+
+#ifdef CONFIG_NET_IPFILTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Address family indices of the compiled tries */
+
+#define IPFILTER_IPv4        0
+#define IPFILTER_IPv6        1
+#define IPFILTER_NFAMILIES   2
+
+/* The number of 32-bit words of a rule set */
+
+#define IPFILTER_MAXWORDS    ((CONFIG_NET_IPFILTER_MAXRULES + 31) / 32)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One node of a binary prefix trie.  The path from the root to a node
+ * spells a prefix; the node's rule set holds the rules with that prefix.
+ */
+
+struct ipfilter_node_s
+{
+  uint32_t child[2];            /* Index of the 0 and 1 child (0: none) */
+  int32_t  set;                 /* Index of the rule set (-1: none) */
+};
+
+struct ipfilter_trie_s
+{
+  FAR struct ipfilter_node_s *nodes; /* nodes[0] is the root */
+  uint32_t nnodes;                   /* Number of nodes in use */
+};
+
+/* A compiled rule table.  Rules that fully specify a TCP or UDP flow are
+ * found through a hash table.  For all other rules, the source and the
+ * destination address are looked up in a prefix trie each; the rules that
+ * may match are those in both of the unions of the rule sets on the two
+ * paths.
+ */
+
+struct ipfilter_s
+{
+  uint8_t  policy[IPFILTER_NHOOKS];  /* Action if no rule matches */
+  uint16_t nrules;                   /* Number of rules */
+  uint16_t nwords;                   /* Words per rule set */
+  FAR struct ipfilter_rule_s *rules; /* Copy of the rules */
+
+  /* Prefix tries [family][0: source, 1: destination] and rule sets */
+
+  struct ipfilter_trie_s trie[IPFILTER_NFAMILIES][2];
+  FAR uint32_t *sets;
+  uint32_t nsets;
+
+  /* Hash of the fully specified flows (rule index + 1; 0: empty) */
+
+  FAR uint16_t *exact;
+  uint32_t exactmask;                /* Size of exact minus one */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The active rule table (NULL: no filtering).  Protected by the network
+ * lock.
+ */
+
+extern FAR struct ipfilter_s *g_ipfilter;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+struct net_driver_s; /* Forward reference */
+
+/****************************************************************************
+ * Name: ipfilter_isexact
+ *
+ * Description:
+ *   Return true if a rule fully specifies a TCP or UDP flow and is so
+ *   found through the hash table of the compiled table.
+ *
+ ****************************************************************************/
+
+bool ipfilter_isexact(FAR const struct ipfilter_rule_s *rule);
+
+/****************************************************************************
+ * Name: ipfilter_hash
+ *
+ * Description:
+ *   Calculate the hash of a TCP or UDP flow.
+ *
+ ****************************************************************************/
+
+uint32_t ipfilter_hash(uint8_t family, uint8_t proto,
+                       FAR const uint8_t *src, FAR const uint8_t *dst,
+                       uint16_t sport, uint16_t dport);
+
+/****************************************************************************
+ * Name: ipfilter_ioctl
+ *
+ * Description:
+ *   Handle the SIOCSIPFILTER ioctl command:  Compile the rule table and
+ *   make it the active table.
+ *
+ * Input Parameters:
+ *   cmd - The ioctl command
+ *   arg - The argument of the ioctl command (struct ipfilter_table_s)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOTTY if
+ *   the command is not handled here.
+ *
+ ****************************************************************************/
+
+int ipfilter_ioctl(int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Name: ipfilter_ipv4
+ *
+ * Description:
+ *   Evaluate the active rule table for the IPv4 packet in d_buf.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received
+ *   hook - IPFILTER_INPUT or IPFILTER_FORWARD
+ *
+ * Returned Value:
+ *   IPFILTER_ACCEPT or IPFILTER_DROP
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipfilter_ipv4(FAR struct net_driver_s *dev, int hook);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_ipv6
+ *
+ * Description:
+ *   Evaluate the active rule table for the IPv6 packet in d_buf.
+ *
+ * Input Parameters:
+ *   dev      - The device on which the packet was received
+ *   hook     - IPFILTER_INPUT or IPFILTER_FORWARD
+ *   proto    - The upper-layer protocol after any extension headers
+ *   iphdrlen - The size of the IPv6 header and any extension headers
+ *
+ * Returned Value:
+ *   IPFILTER_ACCEPT or IPFILTER_DROP
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipfilter_ipv6(FAR struct net_driver_s *dev, int hook, uint8_t proto,
+                  uint16_t iphdrlen);
+#endif
+
+#endif /* CONFIG_NET_IPFILTER */
+#endif /* __NET_IPFILTER_IPFILTER_H */
@@ -0,0 +1,519 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_compile.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ipfilter.h>
+
+#include "ipforward/ipforward.h"
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+FAR struct ipfilter_s *g_ipfilter;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_addrbits
+ *
+ * Description:
+ *   Return the number of bits of the addresses of a family, or zero if the
+ *   family is not supported.
+ *
+ ****************************************************************************/
+
+static int ipfilter_addrbits(uint8_t family)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == AF_INET)
+    {
+      return 32;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == AF_INET6)
+    {
+      return 128;
+    }
+#endif
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipfilter_verify
+ *
+ * Description:
+ *   Verify a rule table.
+ *
+ ****************************************************************************/
+
+static int ipfilter_verify(FAR const struct ipfilter_table_s *table)
+{
+  FAR const struct ipfilter_rule_s *rule;
+  int addrbits;
+  int i;
+
+  if (table->ipt_nrules > CONFIG_NET_IPFILTER_MAXRULES ||
+      (table->ipt_nrules > 0 && table->ipt_rules == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < IPFILTER_NHOOKS; i++)
+    {
+      if (table->ipt_policy[i] > IPFILTER_DROP)
+        {
+          return -EINVAL;
+        }
+    }
+
+  for (i = 0; i < table->ipt_nrules; i++)
+    {
+      rule     = &table->ipt_rules[i];
+      addrbits = ipfilter_addrbits(rule->ipf_family);
+
+      if (addrbits == 0)
+        {
+          return -EAFNOSUPPORT;
+        }
+
+      if (rule->ipf_action > IPFILTER_DROP ||
+          rule->ipf_hooks == 0 ||
+          (rule->ipf_hooks & ~((1 << IPFILTER_NHOOKS) - 1)) != 0 ||
+          rule->ipf_srclen > addrbits || rule->ipf_dstlen > addrbits)
+        {
+          return -EINVAL;
+        }
+
+      if ((rule->ipf_sport != 0 || rule->ipf_dport != 0) &&
+          rule->ipf_proto != IP_PROTO_TCP && rule->ipf_proto != IP_PROTO_UDP)
+        {
+          return -EINVAL;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_free
+ *
+ * Description:
+ *   Free a compiled rule table.
+ *
+ ****************************************************************************/
+
+static void ipfilter_free(FAR struct ipfilter_s *filter)
+{
+  int family;
+
+  if (filter != NULL)
+    {
+      for (family = 0; family < IPFILTER_NFAMILIES; family++)
+        {
+          kmm_free(filter->trie[family][0].nodes);
+          kmm_free(filter->trie[family][1].nodes);
+        }
+
+      kmm_free(filter->exact);
+      kmm_free(filter->sets);
+      kmm_free(filter->rules);
+      kmm_free(filter);
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_insert
+ *
+ * Description:
+ *   Add a rule to the rule set of the node of a prefix, creating the path
+ *   to that node as needed.  The node array was allocated large enough by
+ *   the caller.
+ *
+ ****************************************************************************/
+
+static void ipfilter_insert(FAR struct ipfilter_s *filter,
+                            FAR struct ipfilter_trie_s *trie,
+                            FAR const uint8_t *addr, int prefixlen,
+                            int index)
+{
+  FAR struct ipfilter_node_s *node = &trie->nodes[0];
+  uint32_t child;
+  int bit;
+  int i;
+
+  for (i = 0; i < prefixlen; i++)
+    {
+      bit   = (addr[i >> 3] >> (7 - (i & 7))) & 1;
+      child = node->child[bit];
+
+      if (child == 0)
+        {
+          child = trie->nnodes++;
+          trie->nodes[child].child[0] = 0;
+          trie->nodes[child].child[1] = 0;
+          trie->nodes[child].set      = -1;
+          node->child[bit]            = child;
+        }
+
+      node = &trie->nodes[child];
+    }
+
+  if (node->set < 0)
+    {
+      node->set = filter->nsets++;
+    }
+
+  filter->sets[node->set * filter->nwords + (index >> 5)] |=
+    (uint32_t)1 << (index & 31);
+}
+
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Compile a verified rule table.
+ *
+ ****************************************************************************/
+
+static int ipfilter_compile(FAR const struct ipfilter_table_s *table,
+                            FAR struct ipfilter_s **result)
+{
+  FAR const struct ipfilter_rule_s *rule;
+  FAR struct ipfilter_s *filter;
+  FAR struct ipfilter_trie_s *trie;
+  uint32_t maxnodes[IPFILTER_NFAMILIES][2];
+  uint32_t nfamily[IPFILTER_NFAMILIES];
+  uint32_t nexact = 0;
+  uint32_t maxsets = 0;
+  uint32_t hash;
+  int family;
+  int i;
+
+  *result = NULL;
+
+  /* An empty table that accepts everything disables filtering */
+
+  if (table->ipt_nrules == 0 &&
+      table->ipt_policy[IPFILTER_INPUT] == IPFILTER_ACCEPT &&
+      table->ipt_policy[IPFILTER_FORWARD] == IPFILTER_ACCEPT)
+    {
+      return OK;
+    }
+
+  filter = (FAR struct ipfilter_s *)kmm_zalloc(sizeof(struct ipfilter_s));
+  if (filter == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(filter->policy, table->ipt_policy, sizeof(filter->policy));
+  filter->nrules = table->ipt_nrules;
+  filter->nwords = (table->ipt_nrules + 31) / 32;
+
+  if (table->ipt_nrules > 0)
+    {
+      filter->rules = (FAR struct ipfilter_rule_s *)
+        kmm_malloc(table->ipt_nrules * sizeof(struct ipfilter_rule_s));
+      if (filter->rules == NULL)
+        {
+          goto errout_nomem;
+        }
+
+      memcpy(filter->rules, table->ipt_rules,
+             table->ipt_nrules * sizeof(struct ipfilter_rule_s));
+    }
+
+  /* Size the tries:  Each prefix adds at most one node per bit */
+
+  for (family = 0; family < IPFILTER_NFAMILIES; family++)
+    {
+      maxnodes[family][0] = 1;
+      maxnodes[family][1] = 1;
+      nfamily[family]     = 0;
+    }
+
+  for (i = 0; i < filter->nrules; i++)
+    {
+      rule = &filter->rules[i];
+      if (ipfilter_isexact(rule))
+        {
+          nexact++;
+          continue;
+        }
+
+      family = rule->ipf_family == AF_INET ? IPFILTER_IPv4 : IPFILTER_IPv6;
+      maxnodes[family][0] += rule->ipf_srclen;
+      maxnodes[family][1] += rule->ipf_dstlen;
+      nfamily[family]++;
+      maxsets += 2;
+    }
+
+  if (maxsets > 0)
+    {
+      filter->sets = (FAR uint32_t *)
+        kmm_zalloc(maxsets * filter->nwords * sizeof(uint32_t));
+      if (filter->sets == NULL)
+        {
+          goto errout_nomem;
+        }
+
+      for (family = 0; family < IPFILTER_NFAMILIES; family++)
+        {
+          for (i = 0; i < 2; i++)
+            {
+              if (nfamily[family] == 0)
+                {
+                  continue;
+                }
+
+              trie        = &filter->trie[family][i];
+              trie->nodes = (FAR struct ipfilter_node_s *)
+                kmm_malloc(maxnodes[family][i] *
+                           sizeof(struct ipfilter_node_s));
+              if (trie->nodes == NULL)
+                {
+                  goto errout_nomem;
+                }
+
+              trie->nodes[0].child[0] = 0;
+              trie->nodes[0].child[1] = 0;
+              trie->nodes[0].set      = -1;
+              trie->nnodes            = 1;
+            }
+        }
+    }
+
+  /* Size the flow hash table to at most half full */
+
+  if (nexact > 0)
+    {
+      uint32_t size = 2;
+
+      while (size < 2 * nexact)
+        {
+          size <<= 1;
+        }
+
+      filter->exact = (FAR uint16_t *)kmm_zalloc(size * sizeof(uint16_t));
+      if (filter->exact == NULL)
+        {
+          goto errout_nomem;
+        }
+
+      filter->exactmask = size - 1;
+    }
+
+  /* Now enter the rules */
+
+  for (i = 0; i < filter->nrules; i++)
+    {
+      rule = &filter->rules[i];
+
+      if (ipfilter_isexact(rule))
+        {
+          hash = ipfilter_hash(rule->ipf_family, rule->ipf_proto,
+                               (FAR const uint8_t *)&rule->ipf_src,
+                               (FAR const uint8_t *)&rule->ipf_dst,
+                               rule->ipf_sport, rule->ipf_dport);
+
+          while (filter->exact[hash & filter->exactmask] != 0)
+            {
+              hash++;
+            }
+
+          filter->exact[hash & filter->exactmask] = i + 1;
+        }
+      else
+        {
+          family = rule->ipf_family == AF_INET ?
+                   IPFILTER_IPv4 : IPFILTER_IPv6;
+
+          ipfilter_insert(filter, &filter->trie[family][0],
+                          (FAR const uint8_t *)&rule->ipf_src,
+                          rule->ipf_srclen, i);
+          ipfilter_insert(filter, &filter->trie[family][1],
+                          (FAR const uint8_t *)&rule->ipf_dst,
+                          rule->ipf_dstlen, i);
+        }
+    }
+
+  *result = filter;
+  return OK;
+
+errout_nomem:
+  ipfilter_free(filter);
+  return -ENOMEM;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_isexact
+ *
+ * Description:
+ *   Return true if a rule fully specifies a TCP or UDP flow and is so
+ *   found through the hash table of the compiled table.
+ *
+ ****************************************************************************/
+
+bool ipfilter_isexact(FAR const struct ipfilter_rule_s *rule)
+{
+  int addrbits = rule->ipf_family == AF_INET ? 32 : 128;
+
+  return rule->ipf_srclen == addrbits && rule->ipf_dstlen == addrbits &&
+         rule->ipf_sport != 0 && rule->ipf_dport != 0 &&
+         (rule->ipf_proto == IP_PROTO_TCP || rule->ipf_proto == IP_PROTO_UDP);
+}
+
+/****************************************************************************
+ * Name: ipfilter_hash
+ *
+ * Description:
+ *   Calculate the hash of a TCP or UDP flow (FNV-1a).
+ *
+ ****************************************************************************/
+
+uint32_t ipfilter_hash(uint8_t family, uint8_t proto,
+                       FAR const uint8_t *src, FAR const uint8_t *dst,
+                       uint16_t sport, uint16_t dport)
+{
+  uint32_t hash = 2166136261u;
+  int addrlen = family == AF_INET ? 4 : 16;
+  int i;
+
+  for (i = 0; i < addrlen; i++)
+    {
+      hash = (hash ^ src[i]) * 16777619u;
+      hash = (hash ^ dst[i]) * 16777619u;
+    }
+
+  hash = (hash ^ proto) * 16777619u;
+  hash = (hash ^ (sport & 0xff)) * 16777619u;
+  hash = (hash ^ (sport >> 8)) * 16777619u;
+  hash = (hash ^ (dport & 0xff)) * 16777619u;
+  hash = (hash ^ (dport >> 8)) * 16777619u;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: ipfilter_ioctl
+ *
+ * Description:
+ *   Handle the SIOCSIPFILTER ioctl command:  Compile the rule table and
+ *   make it the active table.
+ *
+ * Input Parameters:
+ *   cmd - The ioctl command
+ *   arg - The argument of the ioctl command (struct ipfilter_table_s)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOTTY if
+ *   the command is not handled here.
+ *
+ ****************************************************************************/
+
+int ipfilter_ioctl(int cmd, unsigned long arg)
+{
+  FAR const struct ipfilter_table_s *table =
+    (FAR const struct ipfilter_table_s *)((uintptr_t)arg);
+  FAR struct ipfilter_s *filter;
+  FAR struct ipfilter_s *old;
+  int ret;
+
+  if (cmd != SIOCSIPFILTER)
+    {
+      return -ENOTTY;
+    }
+
+  if (table == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = ipfilter_verify(table);
+  if (ret < 0)
+    {
+      nerr("ERROR: Invalid filter table: %d\n", ret);
+      return ret;
+    }
+
+  /* Compile without holding the network lock, then swap the tables */
+
+  ret = ipfilter_compile(table, &filter);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  net_lock();
+  old        = g_ipfilter;
+  g_ipfilter = filter;
+
+  /* Cached forwarding decisions may no longer be valid */
+
+  ipv4_flowcache_flush();
+  net_unlock();
+
+  ipfilter_free(old);
+  return OK;
+}
+
+#endif /* CONFIG_NET_IPFILTER */
@@ -0,0 +1,356 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_match.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ipfilter.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The fields of a packet that rules are matched against */
+
+struct ipfilter_key_s
+{
+  uint8_t family;               /* AF_INET or AF_INET6 */
+  uint8_t proto;                /* Upper-layer protocol */
+  uint16_t sport;               /* TCP/UDP ports (network order) or zero */
+  uint16_t dport;
+  FAR const uint8_t *src;       /* Addresses (network order) */
+  FAR const uint8_t *dst;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_walk
+ *
+ * Description:
+ *   Collect the union of the rule sets on the path of an address through a
+ *   prefix trie.
+ *
+ ****************************************************************************/
+
+static void ipfilter_walk(FAR const struct ipfilter_s *filter,
+                          FAR const struct ipfilter_trie_s *trie,
+                          FAR const uint8_t *addr, int addrbits,
+                          FAR uint32_t *set)
+{
+  FAR const struct ipfilter_node_s *node = &trie->nodes[0];
+  FAR const uint32_t *nodeset;
+  int bit;
+  int i;
+  int j;
+
+  for (i = 0; ; i++)
+    {
+      if (node->set >= 0)
+        {
+          nodeset = &filter->sets[node->set * filter->nwords];
+          for (j = 0; j < filter->nwords; j++)
+            {
+              set[j] |= nodeset[j];
+            }
+        }
+
+      if (i >= addrbits)
+        {
+          break;
+        }
+
+      bit = (addr[i >> 3] >> (7 - (i & 7))) & 1;
+      if (node->child[bit] == 0)
+        {
+          break;
+        }
+
+      node = &trie->nodes[node->child[bit]];
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_rulematch
+ *
+ * Description:
+ *   Check the fields of a rule that are not covered by the address tries.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_rulematch(FAR const struct ipfilter_rule_s *rule,
+                               int hook, FAR const struct ipfilter_key_s *key)
+{
+  return (rule->ipf_hooks & IPFILTER_HOOK(hook)) != 0 &&
+         (rule->ipf_proto == 0 || rule->ipf_proto == key->proto) &&
+         (rule->ipf_sport == 0 || rule->ipf_sport == key->sport) &&
+         (rule->ipf_dport == 0 || rule->ipf_dport == key->dport);
+}
+
+/****************************************************************************
+ * Name: ipfilter_lookup
+ *
+ * Description:
+ *   Find the action of the first rule that a packet matches.
+ *
+ ****************************************************************************/
+
+static int ipfilter_lookup(FAR const struct ipfilter_s *filter, int hook,
+                           FAR const struct ipfilter_key_s *key)
+{
+  FAR const struct ipfilter_rule_s *rule;
+  FAR const struct ipfilter_trie_s *trie;
+  uint32_t srcset[IPFILTER_MAXWORDS];
+  uint32_t dstset[IPFILTER_MAXWORDS];
+  uint32_t candidates;
+  int addrbits;
+  int family;
+  int first = filter->nrules;
+  int index;
+  int i;
+
+  addrbits = key->family == AF_INET ? 32 : 128;
+  family   = key->family == AF_INET ? IPFILTER_IPv4 : IPFILTER_IPv6;
+
+  /* Look up the flow in the hash of fully specified flows */
+
+  if (filter->exact != NULL && key->sport != 0 && key->dport != 0)
+    {
+      uint32_t hash = ipfilter_hash(key->family, key->proto, key->src,
+                                    key->dst, key->sport, key->dport);
+
+      while ((index = filter->exact[hash & filter->exactmask]) != 0)
+        {
+          rule = &filter->rules[index - 1];
+          if (index - 1 < first &&
+              rule->ipf_family == key->family &&
+              ipfilter_rulematch(rule, hook, key) &&
+              memcmp(&rule->ipf_src, key->src, addrbits >> 3) == 0 &&
+              memcmp(&rule->ipf_dst, key->dst, addrbits >> 3) == 0)
+            {
+              first = index - 1;
+            }
+
+          hash++;
+        }
+    }
+
+  /* The prefix rules that may match are in both rule sets */
+
+  trie = filter->trie[family];
+  if (trie[0].nodes != NULL)
+    {
+      memset(srcset, 0, filter->nwords * sizeof(uint32_t));
+      memset(dstset, 0, filter->nwords * sizeof(uint32_t));
+
+      ipfilter_walk(filter, &trie[0], key->src, addrbits, srcset);
+      ipfilter_walk(filter, &trie[1], key->dst, addrbits, dstset);
+
+      for (i = 0; i < filter->nwords && (i << 5) < first; i++)
+        {
+          for (candidates = srcset[i] & dstset[i], index = i << 5;
+               candidates != 0 && index < first;
+               candidates >>= 1, index++)
+            {
+              if ((candidates & 1) != 0 &&
+                  ipfilter_rulematch(&filter->rules[index], hook, key))
+                {
+                  first = index;
+                  break;
+                }
+            }
+        }
+    }
+
+  if (first < filter->nrules)
+    {
+      return filter->rules[first].ipf_action;
+    }
+
+  return filter->policy[hook];
+}
+
+/****************************************************************************
+ * Name: ipfilter_ports
+ *
+ * Description:
+ *   Get the TCP or UDP ports of a packet, if it holds enough data.
+ *
+ ****************************************************************************/
+
+static void ipfilter_ports(FAR struct net_driver_s *dev,
+                           FAR struct ipfilter_key_s *key,
+                           unsigned int iphdrlen)
+{
+  /* d_len does not include the link layer header here */
+
+  key->sport = 0;
+  key->dport = 0;
+
+  if ((key->proto == IP_PROTO_TCP || key->proto == IP_PROTO_UDP) &&
+      dev->d_len >= iphdrlen + 4)
+    {
+      FAR const uint8_t *ports =
+        &dev->d_buf[NET_LL_HDRLEN(dev) + iphdrlen];
+
+      memcpy(&key->sport, &ports[0], sizeof(uint16_t));
+      memcpy(&key->dport, &ports[2], sizeof(uint16_t));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_ipv4
+ *
+ * Description:
+ *   Evaluate the active rule table for the IPv4 packet in d_buf.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received
+ *   hook - IPFILTER_INPUT or IPFILTER_FORWARD
+ *
+ * Returned Value:
+ *   IPFILTER_ACCEPT or IPFILTER_DROP
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipfilter_ipv4(FAR struct net_driver_s *dev, int hook)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  struct ipfilter_key_s key;
+  int action;
+
+  if (g_ipfilter == NULL)
+    {
+      return IPFILTER_ACCEPT;
+    }
+
+  key.family = AF_INET;
+  key.proto  = ipv4->proto;
+  key.src    = (FAR const uint8_t *)ipv4->srcipaddr;
+  key.dst    = (FAR const uint8_t *)ipv4->destipaddr;
+  ipfilter_ports(dev, &key, (ipv4->vhl & 0x0f) << 2);
+
+  action = ipfilter_lookup(g_ipfilter, hook, &key);
+  if (action == IPFILTER_DROP)
+    {
+      ninfo("Filtered IPv4 packet, proto %u\n", key.proto);
+    }
+
+  return action;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_ipv6
+ *
+ * Description:
+ *   Evaluate the active rule table for the IPv6 packet in d_buf.
+ *
+ * Input Parameters:
+ *   dev      - The device on which the packet was received
+ *   hook     - IPFILTER_INPUT or IPFILTER_FORWARD
+ *   proto    - The upper-layer protocol after any extension headers
+ *   iphdrlen - The size of the IPv6 header and any extension headers
+ *
+ * Returned Value:
+ *   IPFILTER_ACCEPT or IPFILTER_DROP
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipfilter_ipv6(FAR struct net_driver_s *dev, int hook, uint8_t proto,
+                  uint16_t iphdrlen)
+{
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  struct ipfilter_key_s key;
+  int action;
+
+  if (g_ipfilter == NULL)
+    {
+      return IPFILTER_ACCEPT;
+    }
+
+  key.family = AF_INET6;
+  key.proto  = proto;
+  key.src    = (FAR const uint8_t *)ipv6->srcipaddr;
+  key.dst    = (FAR const uint8_t *)ipv6->destipaddr;
+  ipfilter_ports(dev, &key, iphdrlen);
+
+  action = ipfilter_lookup(g_ipfilter, hook, &key);
+  if (action == IPFILTER_DROP)
+    {
+      ninfo("Filtered IPv6 packet, proto %u\n", key.proto);
+    }
+
+  return action;
+}
+#endif
+
+#endif /* CONFIG_NET_IPFILTER */
@@ -43,6 +43,11 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include <net/ethernet.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/ip.h>
 
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
@@ -81,14 +86,39 @@ struct forward_s
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   uint8_t                      f_domain;  /* Domain: PF_INET or PF_INET6 */
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  bool                         f_noarp;   /* Ethernet header from f_ethdest */
+  uint8_t                      f_ethdest[ETHER_ADDR_LEN]; /* Next hop MAC */
+#endif
 };
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+/* One entry in the IPv4 forwarding flow cache.  This holds the result of
+ * forwarding the first packet of a flow:  The device to forward on and,
+ * for Ethernet devices, the link layer address of the next hop.
+ */
+
+struct ipv4_flow_s
+{
+  FAR struct net_driver_s     *fl_dev;    /* Forwarding device (NULL=unused) */
+  in_addr_t                    fl_srcipaddr;  /* Flow source address */
+  in_addr_t                    fl_destipaddr; /* Flow destination address */
+  uint16_t                     fl_srcport;    /* Source port (network order) */
+  uint16_t                     fl_destport;   /* Dest port (network order) */
+  uint8_t                      fl_proto;  /* IP protocol */
+  bool                         fl_noarp;  /* True: fl_ethdest is valid */
+  uint8_t                      fl_ethdest[ETHER_ADDR_LEN]; /* Next hop MAC */
+  clock_t                      fl_time;   /* Time the entry was created */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 struct ipv4_hdr_s; /* Forward reference */
 struct ipv6_hdr_s; /* Forward reference */
+struct ipv4_flow_s; /* Forward reference */
 
 /****************************************************************************
  * Name: ipfwd_initialize
@@ -306,6 +336,83 @@ void ipfwd_dropstats(FAR struct forward_s *fwd);
 int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_fastforward
+ *
+ * Description:
+ *   Called by ipv4_input() as soon as the IPv4 header has been validated.
+ *   If the packet belongs to a flow in the forwarding flow cache, it is
+ *   forwarded using the cached device and next hop without any further
+ *   input processing, routing table search, or ARP look-up.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received
+ *   ipv4 - A convenience pointer to the IPv4 header in within the IPv4
+ *          packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was forwarded (dev->d_len is then
+ *   zero).  A negated errno value is returned if the packet must take the
+ *   normal input path.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_fastforward(FAR struct net_driver_s *dev,
+                     FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup
+ *
+ * Description:
+ *   Find the flow cache entry for the flow to which an IPv4 packet
+ *   belongs.  Expired entries are not returned.
+ *
+ * Input Parameters:
+ *   ipv4   - The IPv4 header of the packet
+ *   iplen  - The size of the IPv4 packet
+ *
+ * Returned Value:
+ *   The matching entry or NULL if the flow is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct ipv4_flow_s *ipv4_flowcache_lookup(FAR struct ipv4_hdr_s *ipv4,
+                                              unsigned int iplen);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flowcache_add
+ *
+ * Description:
+ *   Add the flow of a packet that has just been forwarded on 'fwddev' to
+ *   the flow cache.  Nothing is added if the next hop cannot be determined
+ *   without per-packet processing (broadcast destinations, unresolved
+ *   ARP entries).
+ *
+ * Input Parameters:
+ *   fwddev - The device on which the packet is being forwarded
+ *   ipv4   - The IPv4 header of the packet
+ *   iplen  - The size of the IPv4 packet
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipv4_flowcache_add(FAR struct net_driver_s *fwddev,
+                        FAR struct ipv4_hdr_s *ipv4, unsigned int iplen);
+#endif
+
 /****************************************************************************
  * Name: ipv6_forward
  *
@@ -376,4 +483,28 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipv4_flowcache_flush
+ *
+ * Description:
+ *   Discard all entries of the IPv4 forwarding flow cache.  This must be
+ *   called whenever a change to the network configuration (addresses,
+ *   routes, ARP entries, packet filter rules, or the registration or state
+ *   of a device) could change a forwarding decision.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipv4_flowcache_flush(void);
+#else
+#  define ipv4_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -37,6 +37,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -47,6 +48,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/ethernet.h>
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
@@ -188,6 +190,37 @@ static inline bool ipfwd_addrchk(FAR struct forward_s *fwd)
 #  define ipfwd_addrchk(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: ipfwd_ethhdr
+ *
+ * Description:
+ *   Build the Ethernet header of a forwarded IPv4 packet using the next hop
+ *   MAC address from the flow cache and mark the packet so that arp_out()
+ *   leaves it alone.
+ *
+ * Input Parameters:
+ *   fwd - The forwarding state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+static void ipfwd_ethhdr(FAR struct forward_s *fwd)
+{
+  FAR struct net_driver_s *dev = fwd->f_dev;
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+  memcpy(eth->dest, fwd->f_ethdest, ETHER_ADDR_LEN);
+  memcpy(eth->src, dev->d_mac.ether.ether_addr_octet, ETHER_ADDR_LEN);
+  eth->type   = HTONS(ETHTYPE_IP);
+
+  dev->d_len += ETH_HDRLEN;
+  IFF_SET_NOARP(dev->d_flags);
+}
+#endif
+
 /****************************************************************************
  * Name: ipfwd_eventhandler
  *
@@ -267,11 +300,24 @@ static uint16_t ipfwd_eventhandler(FAR struct net_driver_s *dev, FAR void *conn,
           devif_forward(fwd);
           flags &= ~DEVPOLL_MASK;
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+          /* If the next hop is already known from the flow cache, then
+           * build the Ethernet header now so that arp_out() can be
+           * skipped.
+           */
+
+          if (fwd->f_noarp)
+            {
+              ipfwd_ethhdr(fwd);
+            }
+
           /* Check if the destination IP address is in the ARP or Neighbor
            * table.  If not, then the send won't actually make it out... it
            * will be replaced with an ARP request or Neighbor Solicitation.
            */
 
+          else
+#endif
           if (!ipfwd_addrchk(fwd))
             {
               return flags;
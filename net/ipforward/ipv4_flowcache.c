@@ -0,0 +1,330 @@
+/****************************************************************************
+ * net/ipforward/ipv4_flowcache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <net/ethernet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+
+#include "arp/arp.h"
+#include "route/route.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE & \
+     (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)) != 0
+#  error CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE must be a power of two
+#endif
+
+#define FLOWCACHE_MASK    (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)
+#define FLOWCACHE_TIMEOUT SEC2TICK(CONFIG_NET_IPFORWARD_FLOWCACHE_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache is direct-mapped:  A new flow simply replaces any other
+ * flow with the same hash.
+ */
+
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_ports
+ *
+ * Description:
+ *   Get the source and destination ports of a TCP or UDP packet.  Zero is
+ *   used for other protocols.
+ *
+ ****************************************************************************/
+
+static void ipv4_flow_ports(FAR struct ipv4_hdr_s *ipv4, unsigned int iplen,
+                            FAR uint16_t *srcport, FAR uint16_t *destport)
+{
+  FAR uint16_t *ports = (FAR uint16_t *)((FAR uint8_t *)ipv4 + IPv4_HDRLEN);
+
+  *srcport  = 0;
+  *destport = 0;
+
+  if ((ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP) &&
+      iplen >= IPv4_HDRLEN + 4)
+    {
+      *srcport  = ports[0];
+      *destport = ports[1];
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_hash
+ *
+ * Description:
+ *   Return the index of the cache entry for a flow.
+ *
+ ****************************************************************************/
+
+static unsigned int ipv4_flow_hash(in_addr_t srcipaddr, in_addr_t destipaddr,
+                                   uint16_t srcport, uint16_t destport,
+                                   uint8_t proto)
+{
+  uint32_t hash;
+
+  hash  = srcipaddr ^ (destipaddr * 0x9e3779b1u);
+  hash ^= ((uint32_t)srcport << 16 | destport) + proto;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3bu;
+  hash ^= hash >> 16;
+
+  return hash & FLOWCACHE_MASK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup
+ *
+ * Description:
+ *   Find the flow cache entry for the flow to which an IPv4 packet
+ *   belongs.  Expired entries are not returned.
+ *
+ * Input Parameters:
+ *   ipv4   - The IPv4 header of the packet
+ *   iplen  - The size of the IPv4 packet
+ *
+ * Returned Value:
+ *   The matching entry or NULL if the flow is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_flow_s *ipv4_flowcache_lookup(FAR struct ipv4_hdr_s *ipv4,
+                                              unsigned int iplen)
+{
+  FAR struct ipv4_flow_s *flow;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t srcport;
+  uint16_t destport;
+
+  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  ipv4_flow_ports(ipv4, iplen, &srcport, &destport);
+
+  flow = &g_ipv4_flows[ipv4_flow_hash(srcipaddr, destipaddr, srcport,
+                                      destport, ipv4->proto)];
+
+  if (flow->fl_dev == NULL ||
+      !net_ipv4addr_cmp(flow->fl_srcipaddr, srcipaddr) ||
+      !net_ipv4addr_cmp(flow->fl_destipaddr, destipaddr) ||
+      flow->fl_srcport != srcport || flow->fl_destport != destport ||
+      flow->fl_proto != ipv4->proto)
+    {
+      return NULL;
+    }
+
+  /* Entries expire so that changes in the neighborhood (such as a new MAC
+   * address of the next hop) are eventually noticed.
+   */
+
+  if (clock_systimer() - flow->fl_time > FLOWCACHE_TIMEOUT)
+    {
+      flow->fl_dev = NULL;
+      return NULL;
+    }
+
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_add
+ *
+ * Description:
+ *   Add the flow of a packet that has just been forwarded on 'fwddev' to
+ *   the flow cache.  Nothing is added if the next hop cannot be determined
+ *   without per-packet processing (broadcast destinations, unresolved
+ *   ARP entries).
+ *
+ * Input Parameters:
+ *   fwddev - The device on which the packet is being forwarded
+ *   ipv4   - The IPv4 header of the packet
+ *   iplen  - The size of the IPv4 packet
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_flowcache_add(FAR struct net_driver_s *fwddev,
+                        FAR struct ipv4_hdr_s *ipv4, unsigned int iplen)
+{
+  FAR struct ipv4_flow_s *flow;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t srcport;
+  uint16_t destport;
+#ifdef CONFIG_NET_ARP
+  struct ether_addr ethaddr;
+  in_addr_t nexthop;
+#endif
+  bool noarp = false;
+
+  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+
+  /* Multicast destinations are never cached */
+
+  if ((ntohl(destipaddr) & 0xf0000000) == 0xe0000000)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_ETHERNET
+  if (fwddev->d_lltype == NET_LL_ETHERNET ||
+      fwddev->d_lltype == NET_LL_IEEE80211)
+    {
+#ifdef CONFIG_NET_ARP
+      /* Resolve the next hop the same way that arp_out() would */
+
+      if (net_ipv4addr_maskcmp(destipaddr, fwddev->d_ipaddr,
+                               fwddev->d_netmask))
+        {
+          /* Do not cache broadcasts on the local network */
+
+          if (net_ipv4addr_broadcast(destipaddr, fwddev->d_netmask))
+            {
+              return;
+            }
+
+          net_ipv4addr_copy(nexthop, destipaddr);
+        }
+      else
+        {
+#ifdef CONFIG_NET_ROUTE
+          netdev_ipv4_router(fwddev, destipaddr, &nexthop);
+#else
+          net_ipv4addr_copy(nexthop, fwddev->d_draddr);
+#endif
+        }
+
+      /* The first packets of a flow may be sent before ARP resolution
+       * completes.  The flow will be cached on a later packet.
+       */
+
+      if (arp_find(nexthop, &ethaddr) < 0)
+        {
+          return;
+        }
+
+      noarp = true;
+#else
+      return;
+#endif
+    }
+#endif
+
+  /* Replace whatever flow was in the cache entry */
+
+  ipv4_flow_ports(ipv4, iplen, &srcport, &destport);
+  flow = &g_ipv4_flows[ipv4_flow_hash(srcipaddr, destipaddr, srcport,
+                                      destport, ipv4->proto)];
+
+  flow->fl_dev        = fwddev;
+  flow->fl_srcipaddr  = srcipaddr;
+  flow->fl_destipaddr = destipaddr;
+  flow->fl_srcport    = srcport;
+  flow->fl_destport   = destport;
+  flow->fl_proto      = ipv4->proto;
+  flow->fl_noarp      = noarp;
+  flow->fl_time       = clock_systimer();
+
+#ifdef CONFIG_NET_ARP
+  if (noarp)
+    {
+      memcpy(flow->fl_ethdest, ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_flush
+ *
+ * Description:
+ *   Discard all entries of the IPv4 forwarding flow cache.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipv4_flowcache_flush(void)
+{
+  net_lock();
+  memset(g_ipv4_flows, 0, sizeof(g_ipv4_flows));
+  net_unlock();
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
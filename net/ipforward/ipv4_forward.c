@@ -146,7 +146,9 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t sum;
+  uint32_t sum;
+  uint16_t oldword;
+  uint16_t newword;
   int ttl = (int)ipv4->ttl - 1;
 
   if (ttl <= 0)
@@ -161,27 +163,24 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
       return 0;
     }
 
-  /* Save the updated TTL value */
+  /* Update the IPv4 checksum incrementally for the modified 16-bit word
+   * holding the TTL and protocol (RFC 1624):  HC' = ~(~HC + ~m + m').
+   * This avoids summing all of the 20 bytes of the IPv4 header again.
+   */
 
-  ipv4->ttl = ttl;
+  oldword   = ((uint16_t)ipv4->ttl << 8) | ipv4->proto;
+  newword   = ((uint16_t)ttl << 8) | ipv4->proto;
 
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
-   */
+  sum       = (uint16_t)~ntohs(ipv4->ipchksum);
+  sum      += (uint16_t)~oldword;
+  sum      += newword;
+  sum       = (sum & 0xffff) + (sum >> 16);
+  sum       = (sum & 0xffff) + (sum >> 16);
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, IPv4_HDRLEN);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
+  /* Save the updated TTL value and checksum */
 
-  ipv4->ipchksum = ~sum;
+  ipv4->ttl      = ttl;
+  ipv4->ipchksum = htons((uint16_t)~sum);
   return ttl;
 }
 
@@ -199,6 +198,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
  *              contains the IPv4 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *   flow     - The flow cache entry of the packet's flow (if any).  NULL
+ *              if the packet is not being forwarded on the fast path.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forward;  A negated
@@ -209,7 +210,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv4_hdr_s *ipv4)
+                            FAR struct ipv4_hdr_s *ipv4,
+                            FAR struct ipv4_flow_s *flow)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -247,6 +249,18 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
   fwd->f_domain = PF_INET; /* IPv64 address domain */
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* If the next hop of the flow is known, then the Ethernet header can be
+   * generated without an ARP look-up.
+   */
+
+  if (flow != NULL && flow->fl_noarp)
+    {
+      fwd->f_noarp = true;
+      memcpy(fwd->f_ethdest, flow->fl_ethdest, ETHER_ADDR_LEN);
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_NET_WARN
   /* Get the size of the IPv4 + L3 header. */
 
@@ -379,7 +393,7 @@ int ipv4_forward_callback(FAR struct net_driver_s *fwddev, FAR void *arg)
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, NULL);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
@@ -429,6 +443,9 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  unsigned int iplen = dev->d_len;
+#endif
   int ret;
 
   /* Search for a device that can forward this packet. */
@@ -451,12 +468,20 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, NULL);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* Remember the forwarding decision for the following packets of the
+       * same flow.
+       */
+
+      ipv4_flowcache_add(fwddev, ipv4, iplen);
+#endif
     }
   else
     {
@@ -494,6 +519,59 @@ drop:
   return ret;
 }
 
+/****************************************************************************
+ * Name: ipv4_fastforward
+ *
+ * Description:
+ *   Called by ipv4_input() as soon as the IPv4 header has been validated.
+ *   If the packet belongs to a flow in the forwarding flow cache, it is
+ *   forwarded using the cached device and next hop without any further
+ *   input processing, routing table search, or ARP look-up.
+ *
+ * Input Parameters:
+ *   dev  - The device on which the packet was received
+ *   ipv4 - A convenience pointer to the IPv4 header in within the IPv4
+ *          packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was forwarded (dev->d_len is then
+ *   zero).  A negated errno value is returned if the packet must take the
+ *   normal input path.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_fastforward(FAR struct net_driver_s *dev,
+                     FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+
+  /* Packets whose hop limit is about to expire need the full treatment */
+
+  if (ipv4->ttl <= 1)
+    {
+      return -EMULTIHOP;
+    }
+
+  flow = ipv4_flowcache_lookup(ipv4, dev->d_len);
+  if (flow == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* The forwarding device must still be usable.  Otherwise, let the normal
+   * path decide what to do with the packet.
+   */
+
+  if (flow->fl_dev == dev || !IFF_IS_UP(flow->fl_dev->d_flags))
+    {
+      return -ENETUNREACH;
+    }
+
+  return ipv4_dev_forward(dev, flow->fl_dev, ipv4, flow);
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_forward_broadcast
  *
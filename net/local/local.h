@@ -77,6 +77,18 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* Shared ring buffer transport for connected stream sockets */
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+#  if (CONFIG_NET_LOCAL_SHMRING_SIZE & \
+       (CONFIG_NET_LOCAL_SHMRING_SIZE - 1)) != 0
+#    error CONFIG_NET_LOCAL_SHMRING_SIZE must be a power of two
+#  endif
+
+#  define LOCAL_RING_MASK         (CONFIG_NET_LOCAL_SHMRING_SIZE - 1)
+#  define LOCAL_RING_NPOLLWAITERS 2
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -111,6 +123,72 @@ enum local_state_s
   LOCAL_STATE_DISCONNECTED     /* Peer disconnected */
 };
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+#ifdef CONFIG_NET_LOCAL_SCM
+/* One file or socket descriptor in flight in an SCM_RIGHTS message.  The
+ * sender's descriptor is duplicated into this detached instance when the
+ * message is sent and moved into the receiver's descriptor list when it is
+ * received.
+ */
+
+struct local_fd_s
+{
+  bool lf_socket;              /* True: lf_sock, false: lf_file */
+  union
+  {
+#if CONFIG_NFILE_DESCRIPTORS > 0
+    struct file lf_file;       /* Duplicated file */
+#endif
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+    struct socket lf_sock;     /* Cloned socket */
+#endif
+  } u;
+};
+#endif
+
+/* Ancillary data in flight on a ring.  It is attached to the first byte of
+ * the data that was sent with it and is returned by the recvmsg() call that
+ * receives that byte.
+ */
+
+struct local_ctrl_s
+{
+  sq_entry_t ctl_node;         /* Supports a singly linked list */
+  uint32_t ctl_pos;            /* Stream position of the first data byte */
+  bool ctl_hascred;            /* True: ctl_cred is valid */
+  struct ucred ctl_cred;       /* SCM_CREDENTIALS of the sender */
+#ifdef CONFIG_NET_LOCAL_SCM
+  uint8_t ctl_nfds;            /* Number of descriptors in ctl_fds[] */
+  struct local_fd_s ctl_fds[CONFIG_NET_LOCAL_SCM_MAXFD];
+#endif
+};
+
+/* One direction of a connected stream socket.  The ring is shared by the
+ * sending and the receiving peer and freed when both have closed.  The
+ * head and tail are free running byte counts; masking them with
+ * LOCAL_RING_MASK gives the position in lr_buffer[].
+ */
+
+struct local_ring_s
+{
+  sem_t lr_exclsem;            /* Mutually exclusive access to the ring */
+  sem_t lr_rdsem;              /* Used to wait for data */
+  sem_t lr_wrsem;              /* Used to wait for space */
+  uint32_t lr_head;            /* Number of bytes written */
+  uint32_t lr_tail;            /* Number of bytes read */
+  bool lr_wrclosed;            /* The sending peer has closed */
+  bool lr_rdclosed;            /* The receiving peer has closed */
+  sq_queue_t lr_ctrl;          /* Ancillary data in flight */
+#ifdef HAVE_LOCAL_POLL
+  /* Poll waiters for data (lr_rdfds) and for space (lr_wrfds) */
+
+  FAR struct pollfd *lr_rdfds[LOCAL_RING_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_RING_NPOLLWAITERS];
+#endif
+  uint8_t lr_buffer[CONFIG_NET_LOCAL_SHMRING_SIZE];
+};
+#endif /* CONFIG_NET_LOCAL_SHMRING */
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -163,6 +241,13 @@ struct local_conn_s
   struct pollfd *lc_accept_fds[LOCAL_ACCEPT_NPOLLWAITERS];
 #endif
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* The rings shared by connected peers (instead of FIFOs) */
+
+  FAR struct local_ring_s *lc_rxring; /* Incoming data */
+  FAR struct local_ring_s *lc_txring; /* Outgoing data */
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -703,6 +788,176 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
 int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Allocate the pair of rings for a connecting stream client.  The server
+ *   side of the connection takes them over when the connection is accepted.
+ *
+ * Input Parameters:
+ *   client - The connecting client
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOMEM is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+int local_ring_create(FAR struct local_conn_s *client);
+
+/****************************************************************************
+ * Name: local_ring_destroy
+ *
+ * Description:
+ *   Free the rings of a client whose connection was not accepted.
+ *
+ ****************************************************************************/
+
+void local_ring_destroy(FAR struct local_conn_s *client);
+
+/****************************************************************************
+ * Name: local_ring_close
+ *
+ * Description:
+ *   Detach a connected peer from its rings.  The other peer sees the end of
+ *   the stream after it has received any remaining data; further sends by
+ *   the other peer fail with EPIPE.  Each ring is freed when both peers
+ *   have closed it.
+ *
+ ****************************************************************************/
+
+void local_ring_close(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data from the caller's buffers into a ring.  Unless 'nonblock' is
+ *   true, this waits until all of the data has been copied.
+ *
+ * Input Parameters:
+ *   ring     The outgoing ring of the sending peer
+ *   iov      The buffers holding the data to send
+ *   iovcnt   The number of buffers
+ *   nonblock True: Do not wait for space in the ring
+ *   ctrl     Ancillary data to attach to the first byte sent (may be NULL).
+ *            On success, the ring takes ownership.
+ *
+ * Returned Value:
+ *   The number of bytes sent on success.  A negated errno value is returned
+ *   if nothing could be sent:  -EAGAIN (non-blocking and the ring is full),
+ *   -EPIPE (the receiving peer has closed), or -EINTR.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_ring_s *ring,
+                        FAR const struct iovec *iov, int iovcnt,
+                        bool nonblock, FAR struct local_ctrl_s *ctrl);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy data from a ring into the caller's buffers, waiting for data
+ *   unless 'nonblock' is true.  One call never returns data sent with
+ *   ancillary data together with data that was sent before it.
+ *
+ * Input Parameters:
+ *   ring     The incoming ring of the receiving peer
+ *   iov      The buffers to receive the data
+ *   iovcnt   The number of buffers
+ *   flags    Receive flags (MSG_PEEK is supported)
+ *   nonblock True: Do not wait for data
+ *   ctrl     Location to return ancillary data attached to the data
+ *            received (NULL: discard any ancillary data).  The caller must
+ *            release a returned instance with local_ctrl_free().
+ *
+ * Returned Value:
+ *   The number of bytes received (zero at the end of the stream) on
+ *   success.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_ring_s *ring,
+                        FAR const struct iovec *iov, int iovcnt, int flags,
+                        bool nonblock, FAR struct local_ctrl_s **ctrl);
+
+/****************************************************************************
+ * Name: local_ctrl_free
+ *
+ * Description:
+ *   Free ancillary data, closing any descriptors still held by it.
+ *
+ ****************************************************************************/
+
+void local_ctrl_free(FAR struct local_ctrl_s *ctrl);
+
+/****************************************************************************
+ * Name: local_ring_pollsetup and local_ring_pollteardown
+ *
+ * Description:
+ *   Setup or teardown the monitoring of events on the rings of a connected
+ *   stream socket.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds);
+int local_ring_pollteardown(FAR struct local_conn_s *conn,
+                            FAR struct pollfd *fds);
+#endif
+
+/****************************************************************************
+ * Name: psock_local_sendmsg
+ *
+ * Description:
+ *   Implements sendmsg() for a connected Unix domain stream socket, sending
+ *   any SCM_CREDENTIALS and SCM_RIGHTS control messages along with the
+ *   data.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      The message to send
+ *   flags    Send flags (MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_local_sendmsg(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags);
+
+/****************************************************************************
+ * Name: psock_local_recvmsg
+ *
+ * Description:
+ *   Implements recvmsg() for a connected Unix domain stream socket,
+ *   returning any SCM_CREDENTIALS and SCM_RIGHTS control messages sent
+ *   with the data.  Received descriptors are installed in the descriptor
+ *   list of the calling task.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags (MSG_DONTWAIT and MSG_PEEK are supported)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On error, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_local_recvmsg(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags);
+#endif /* CONFIG_NET_LOCAL_SHMRING */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
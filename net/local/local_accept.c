@@ -184,6 +184,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifndef CONFIG_NET_LOCAL_SHMRING
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -195,8 +196,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_SHMRING
+
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -222,7 +226,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+            }
+#endif
 
+          if (ret == OK)
+            {
               /* Return the address family */
 
               if (addr != NULL)
@@ -239,6 +247,15 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               newsock->s_type   = SOCK_STREAM;
               newsock->s_sockif = psock->s_sockif;
               newsock->s_conn   = (FAR void *)conn;
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+              /* Take over the rings allocated by the client.  What the
+               * client sends, the server receives and vice versa.
+               */
+
+              conn->lc_rxring   = client->lc_txring;
+              conn->lc_txring   = client->lc_rxring;
+#endif
             }
 
           /* Signal the client with the result of the connection */
@@ -141,9 +141,17 @@ void local_free(FAR struct local_conn_s *conn)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* Detach from the rings shared with the peer.  Stream connections do not
+   * use FIFOs.
+   */
+
+  local_ring_close(conn);
+#else
   /* Destroy all FIFOs associted with the connection */
 
   local_release_fifos(conn);
+#endif
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
@@ -156,6 +156,19 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* Allocate the rings that will be shared with the accepted peer */
+
+  ret = local_ring_create(client);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create rings for %s: %d\n",
+           client->lc_path, ret);
+
+      net_unlock();
+      return ret;
+    }
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -183,6 +196,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Add ourself to the list of waiting connections and notify the server. */
 
@@ -215,6 +229,15 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       goto errout_with_outfd;
     }
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* Yes.. the server has taken over the other end of the rings */
+
+  client->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
+
+errout_with_outfd:
+  local_ring_destroy(client);
+#else
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -235,6 +258,8 @@ errout_with_outfd:
 
 errout_with_fifos:
   (void)local_release_fifos(client);
+#endif
+
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
 }
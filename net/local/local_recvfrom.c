@@ -148,6 +148,9 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  struct iovec iov;
+#endif
   size_t readlen;
   int ret;
 
@@ -159,6 +162,26 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* Copy the data out of the ring shared with the peer.  Any ancillary data
+   * sent with it is discarded.
+   */
+
+  DEBUGASSERT(conn->lc_rxring != NULL);
+
+  iov.iov_base = buf;
+  iov.iov_len  = len;
+
+  ret = local_ring_recv(conn->lc_rxring, &iov, 1, flags,
+                        _SS_ISNONBLOCK(psock->s_flags) ||
+                        (flags & MSG_DONTWAIT) != 0, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* The incoming FIFO should be open */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -199,6 +222,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
   conn->u.peer.lc_remaining -= readlen;
+#endif
 
   /* Return the address family */
 
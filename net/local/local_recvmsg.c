@@ -0,0 +1,275 @@
+/****************************************************************************
+ * net/local/local_recvmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_install_fd
+ *
+ * Description:
+ *   Give a descriptor received in an SCM_RIGHTS message a number in the
+ *   descriptor list of the calling task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+static int local_install_fd(FAR struct local_fd_s *lfd)
+{
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (lfd->lf_socket)
+    {
+      /* The clone held by the message is closed with the message */
+
+      return psock_dupsd(&lfd->u.lf_sock, 0);
+    }
+#endif
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if (!lfd->lf_socket)
+    {
+      return file_install(&lfd->u.lf_file, 0);
+    }
+#endif
+
+  return -EBADF;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_recvmsg_ctrl
+ *
+ * Description:
+ *   Return received ancillary data as control messages in 'msg'.  Control
+ *   messages that do not fit are dropped and MSG_CTRUNC is reported;
+ *   descriptors that are not returned are closed.
+ *
+ ****************************************************************************/
+
+static void local_recvmsg_ctrl(FAR struct msghdr *msg,
+                               FAR struct local_ctrl_s *ctrl)
+{
+  FAR uint8_t *buffer = (FAR uint8_t *)msg->msg_control;
+  size_t buflen = msg->msg_controllen;
+  FAR struct cmsghdr *cmsg;
+  size_t used = 0;
+
+  if (ctrl->ctl_hascred)
+    {
+      if (buffer != NULL && used + CMSG_LEN(sizeof(struct ucred)) <= buflen)
+        {
+          cmsg             = (FAR struct cmsghdr *)&buffer[used];
+          cmsg->cmsg_len   = CMSG_LEN(sizeof(struct ucred));
+          cmsg->cmsg_level = SOL_SOCKET;
+          cmsg->cmsg_type  = SCM_CREDENTIALS;
+          memcpy(CMSG_DATA(cmsg), &ctrl->ctl_cred, sizeof(struct ucred));
+          used            += CMSG_SPACE(sizeof(struct ucred));
+        }
+      else
+        {
+          msg->msg_flags |= MSG_CTRUNC;
+        }
+    }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (ctrl->ctl_nfds > 0)
+    {
+      FAR int *fds;
+      int nfds = 0;
+      int i;
+
+      /* Return as many descriptors as there is room for */
+
+      if (buffer != NULL && used + CMSG_LEN(sizeof(int)) <= buflen)
+        {
+          nfds = (buflen - used - CMSG_LEN(0)) / sizeof(int);
+          nfds = MIN(nfds, ctrl->ctl_nfds);
+        }
+
+      if (nfds < ctrl->ctl_nfds)
+        {
+          msg->msg_flags |= MSG_CTRUNC;
+        }
+
+      if (nfds > 0)
+        {
+          cmsg             = (FAR struct cmsghdr *)&buffer[used];
+          cmsg->cmsg_level = SOL_SOCKET;
+          cmsg->cmsg_type  = SCM_RIGHTS;
+          fds              = (FAR int *)CMSG_DATA(cmsg);
+
+          for (i = 0; i < nfds; i++)
+            {
+              int fd = local_install_fd(&ctrl->ctl_fds[i]);
+              if (fd < 0)
+                {
+                  nerr("ERROR: Failed to install descriptor: %d\n", fd);
+                  msg->msg_flags |= MSG_CTRUNC;
+                  break;
+                }
+
+              fds[i] = fd;
+            }
+
+          if (i > 0)
+            {
+              cmsg->cmsg_len = CMSG_LEN(i * sizeof(int));
+              used          += CMSG_SPACE(i * sizeof(int));
+            }
+        }
+    }
+#endif
+
+  /* The space of the last control message may extend beyond the buffer */
+
+  msg->msg_controllen = MIN(used, buflen);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_local_recvmsg
+ *
+ * Description:
+ *   Implements recvmsg() for a connected Unix domain stream socket,
+ *   returning any SCM_CREDENTIALS and SCM_RIGHTS control messages sent
+ *   with the data.  Received descriptors are installed in the descriptor
+ *   list of the calling task.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags (MSG_DONTWAIT and MSG_PEEK are supported)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On error, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_local_recvmsg(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+  FAR struct local_conn_s *conn;
+  FAR struct local_ctrl_s *ctrl = NULL;
+  socklen_t namelen;
+  bool nonblock;
+  ssize_t ret;
+  int status;
+
+  DEBUGASSERT(psock && psock->s_conn && msg);
+  conn = (FAR struct local_conn_s *)psock->s_conn;
+
+  if (conn->lc_state != LOCAL_STATE_CONNECTED || conn->lc_rxring == NULL)
+    {
+      nerr("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  /* Ancillary data is not returned when peeking; it stays in the ring with
+   * the data that it was sent with.
+   */
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+  ret = local_ring_recv(conn->lc_rxring, msg->msg_iov, msg->msg_iovlen,
+                        flags, nonblock,
+                        (flags & MSG_PEEK) != 0 ? NULL : &ctrl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  msg->msg_flags = 0;
+  if ((flags & MSG_PEEK) == 0 && ctrl != NULL)
+    {
+      local_recvmsg_ctrl(msg, ctrl);
+      local_ctrl_free(ctrl);
+    }
+  else
+    {
+      msg->msg_controllen = 0;
+    }
+
+  /* Return the address family */
+
+  if (msg->msg_name != NULL)
+    {
+      namelen = msg->msg_namelen;
+      status  = local_getaddr(conn, (FAR struct sockaddr *)msg->msg_name,
+                              &namelen);
+      if (status < 0)
+        {
+          return status;
+        }
+
+      msg->msg_namelen = namelen;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_SHMRING */
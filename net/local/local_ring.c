@@ -0,0 +1,811 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <queue.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifdef HAVE_LOCAL_POLL
+#  define local_ring_pollnotify(s,e) local_ring_notify(s,e)
+#else
+#  define local_ring_pollnotify(s,e)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_semtake
+ ****************************************************************************/
+
+static void local_ring_semtake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Release the ring and wait on 'sem'.  The scheduler is locked so that
+ *   the wake-up from the peer cannot be lost between releasing the ring
+ *   and starting to wait.  The ring is held again on successful return.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR struct local_ring_s *ring, FAR sem_t *sem)
+{
+  int ret;
+
+  sched_lock();
+  nxsem_post(&ring->lr_exclsem);
+  ret = nxsem_wait(sem);
+  sched_unlock();
+
+  if (ret >= 0)
+    {
+      local_ring_semtake(&ring->lr_exclsem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_wake
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'.
+ *
+ ****************************************************************************/
+
+static void local_ring_wake(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == OK && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_notify
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static void local_ring_notify(FAR struct pollfd **slots,
+                              pollevent_t eventset)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = slots[i];
+      if (fds)
+        {
+          fds->revents |= eventset & (fds->events | POLLERR | POLLHUP);
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: local_ring_copyin and local_ring_copyout
+ *
+ * Description:
+ *   Copy data into or out of the ring at the free running stream position
+ *   'pos'.  The data wraps around the end of the buffer at most once.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyin(FAR struct local_ring_s *ring, uint32_t pos,
+                              FAR const uint8_t *src, size_t len)
+{
+  size_t offset = pos & LOCAL_RING_MASK;
+  size_t nfirst = MIN(len, CONFIG_NET_LOCAL_SHMRING_SIZE - offset);
+
+  memcpy(&ring->lr_buffer[offset], src, nfirst);
+  if (nfirst < len)
+    {
+      memcpy(ring->lr_buffer, src + nfirst, len - nfirst);
+    }
+}
+
+static void local_ring_copyout(FAR struct local_ring_s *ring, uint32_t pos,
+                               FAR uint8_t *dest, size_t len)
+{
+  size_t offset = pos & LOCAL_RING_MASK;
+  size_t nfirst = MIN(len, CONFIG_NET_LOCAL_SHMRING_SIZE - offset);
+
+  memcpy(dest, &ring->lr_buffer[offset], nfirst);
+  if (nfirst < len)
+    {
+      memcpy(dest + nfirst, ring->lr_buffer, len - nfirst);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_alloc and local_ring_free
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_alloc(void)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = (FAR struct local_ring_s *)kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring != NULL)
+    {
+      nxsem_init(&ring->lr_exclsem, 0, 1);
+      nxsem_init(&ring->lr_rdsem, 0, 0);
+      nxsem_init(&ring->lr_wrsem, 0, 0);
+
+      /* The wait semaphores are used for signaling and, hence, should not
+       * have priority inheritance enabled.
+       */
+
+      nxsem_setprotocol(&ring->lr_rdsem, SEM_PRIO_NONE);
+      nxsem_setprotocol(&ring->lr_wrsem, SEM_PRIO_NONE);
+      sq_init(&ring->lr_ctrl);
+    }
+
+  return ring;
+}
+
+static void local_ring_free(FAR struct local_ring_s *ring)
+{
+  FAR struct local_ctrl_s *ctrl;
+
+  while ((ctrl = (FAR struct local_ctrl_s *)sq_remfirst(&ring->lr_ctrl))
+         != NULL)
+    {
+      local_ctrl_free(ctrl);
+    }
+
+  nxsem_destroy(&ring->lr_exclsem);
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+  kmm_free(ring);
+}
+
+/****************************************************************************
+ * Name: local_ring_addwaiter and local_ring_rmwaiter
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static int local_ring_addwaiter(FAR struct pollfd **slots,
+                                FAR struct pollfd *fds)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (slots[i] == NULL)
+        {
+          slots[i] = fds;
+          return OK;
+        }
+    }
+
+  return -EBUSY;
+}
+
+static void local_ring_rmwaiter(FAR struct pollfd **slots,
+                                FAR struct pollfd *fds)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (slots[i] == fds)
+        {
+          slots[i] = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Allocate the pair of rings for a connecting stream client.  The server
+ *   side of the connection takes them over when the connection is accepted.
+ *
+ * Input Parameters:
+ *   client - The connecting client
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOMEM is returned on failure.
+ *
+ ****************************************************************************/
+
+int local_ring_create(FAR struct local_conn_s *client)
+{
+  DEBUGASSERT(client->lc_rxring == NULL && client->lc_txring == NULL);
+
+  client->lc_rxring = local_ring_alloc();
+  client->lc_txring = local_ring_alloc();
+
+  if (client->lc_rxring == NULL || client->lc_txring == NULL)
+    {
+      nerr("ERROR: Failed to allocate rings\n");
+      local_ring_destroy(client);
+      return -ENOMEM;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_destroy
+ *
+ * Description:
+ *   Free the rings of a client whose connection was not accepted.
+ *
+ ****************************************************************************/
+
+void local_ring_destroy(FAR struct local_conn_s *client)
+{
+  if (client->lc_rxring != NULL)
+    {
+      local_ring_free(client->lc_rxring);
+      client->lc_rxring = NULL;
+    }
+
+  if (client->lc_txring != NULL)
+    {
+      local_ring_free(client->lc_txring);
+      client->lc_txring = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_close
+ *
+ * Description:
+ *   Detach a connected peer from its rings.  The other peer sees the end of
+ *   the stream after it has received any remaining data; further sends by
+ *   the other peer fail with EPIPE.  Each ring is freed when both peers
+ *   have closed it.
+ *
+ ****************************************************************************/
+
+void local_ring_close(FAR struct local_conn_s *conn)
+{
+  FAR struct local_ring_s *ring;
+  FAR struct local_ctrl_s *ctrl;
+  sq_queue_t pending;
+  bool last;
+
+  /* Stop receiving.  Ancillary data that was never received is discarded
+   * (closing any descriptors that it holds) and the sender is told that the
+   * connection is broken.
+   */
+
+  ring = conn->lc_rxring;
+  if (ring != NULL)
+    {
+      local_ring_semtake(&ring->lr_exclsem);
+
+      ring->lr_rdclosed = true;
+      ring->lr_tail     = ring->lr_head;
+      sq_move(&ring->lr_ctrl, &pending);
+      last              = ring->lr_wrclosed;
+
+      local_ring_wake(&ring->lr_wrsem);
+      local_ring_pollnotify(ring->lr_wrfds, POLLERR | POLLHUP);
+      nxsem_post(&ring->lr_exclsem);
+
+      while ((ctrl = (FAR struct local_ctrl_s *)sq_remfirst(&pending))
+             != NULL)
+        {
+          local_ctrl_free(ctrl);
+        }
+
+      if (last)
+        {
+          local_ring_free(ring);
+        }
+
+      conn->lc_rxring = NULL;
+    }
+
+  /* Stop sending.  The receiver gets the end of the stream once it has
+   * received the data still in the ring.
+   */
+
+  ring = conn->lc_txring;
+  if (ring != NULL)
+    {
+      local_ring_semtake(&ring->lr_exclsem);
+
+      ring->lr_wrclosed = true;
+      last              = ring->lr_rdclosed;
+
+      local_ring_wake(&ring->lr_rdsem);
+      local_ring_pollnotify(ring->lr_rdfds, POLLIN | POLLHUP);
+      nxsem_post(&ring->lr_exclsem);
+
+      if (last)
+        {
+          local_ring_free(ring);
+        }
+
+      conn->lc_txring = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data from the caller's buffers into a ring.  Unless 'nonblock' is
+ *   true, this waits until all of the data has been copied.
+ *
+ * Input Parameters:
+ *   ring     The outgoing ring of the sending peer
+ *   iov      The buffers holding the data to send
+ *   iovcnt   The number of buffers
+ *   nonblock True: Do not wait for space in the ring
+ *   ctrl     Ancillary data to attach to the first byte sent (may be NULL).
+ *            On success, the ring takes ownership.
+ *
+ * Returned Value:
+ *   The number of bytes sent on success.  A negated errno value is returned
+ *   if nothing could be sent:  -EAGAIN (non-blocking and the ring is full),
+ *   -EPIPE (the receiving peer has closed), or -EINTR.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_ring_s *ring,
+                        FAR const struct iovec *iov, int iovcnt,
+                        bool nonblock, FAR struct local_ctrl_s *ctrl)
+{
+  ssize_t total = 0;
+  size_t sent = 0;
+  int ret = OK;
+  int i = 0;
+
+  local_ring_semtake(&ring->lr_exclsem);
+
+  while (i < iovcnt)
+    {
+      uint32_t space;
+      size_t nbytes;
+
+      /* Move on to the next buffer when this one has been sent */
+
+      if (sent >= iov[i].iov_len)
+        {
+          sent = 0;
+          i++;
+          continue;
+        }
+
+      if (ring->lr_rdclosed)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      /* Wait for space in the ring */
+
+      space = CONFIG_NET_LOCAL_SHMRING_SIZE -
+              (ring->lr_head - ring->lr_tail);
+      if (space == 0)
+        {
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = local_ring_wait(ring, &ring->lr_wrsem);
+          if (ret < 0)
+            {
+              return total > 0 ? total : ret;
+            }
+
+          continue;
+        }
+
+      /* Attach the ancillary data to the first byte */
+
+      if (ctrl != NULL)
+        {
+          ctrl->ctl_pos = ring->lr_head;
+          sq_addlast(&ctrl->ctl_node, &ring->lr_ctrl);
+          ctrl = NULL;
+        }
+
+      nbytes = MIN(iov[i].iov_len - sent, space);
+      local_ring_copyin(ring, ring->lr_head,
+                        (FAR const uint8_t *)iov[i].iov_base + sent, nbytes);
+
+      ring->lr_head += nbytes;
+      sent          += nbytes;
+      total         += nbytes;
+
+      /* Let the receiver have what has been sent so far */
+
+      local_ring_wake(&ring->lr_rdsem);
+      local_ring_pollnotify(ring->lr_rdfds, POLLIN);
+    }
+
+  nxsem_post(&ring->lr_exclsem);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy data from a ring into the caller's buffers, waiting for data
+ *   unless 'nonblock' is true.  One call never returns data sent with
+ *   ancillary data together with data that was sent before it.
+ *
+ * Input Parameters:
+ *   ring     The incoming ring of the receiving peer
+ *   iov      The buffers to receive the data
+ *   iovcnt   The number of buffers
+ *   flags    Receive flags (MSG_PEEK is supported)
+ *   nonblock True: Do not wait for data
+ *   ctrl     Location to return ancillary data attached to the data
+ *            received (NULL: discard any ancillary data).  The caller must
+ *            release a returned instance with local_ctrl_free().
+ *
+ * Returned Value:
+ *   The number of bytes received (zero at the end of the stream) on
+ *   success.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_ring_s *ring,
+                        FAR const struct iovec *iov, int iovcnt, int flags,
+                        bool nonblock, FAR struct local_ctrl_s **ctrl)
+{
+  FAR struct local_ctrl_s *first;
+  FAR struct local_ctrl_s *next;
+  FAR struct local_ctrl_s *taken = NULL;
+  ssize_t total = 0;
+  uint32_t avail;
+  int ret;
+  int i;
+
+  if (ctrl != NULL)
+    {
+      *ctrl = NULL;
+    }
+
+  local_ring_semtake(&ring->lr_exclsem);
+
+  /* Wait for data (or for the end of the stream) */
+
+  while (ring->lr_head == ring->lr_tail)
+    {
+      if (ring->lr_wrclosed)
+        {
+          nxsem_post(&ring->lr_exclsem);
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          nxsem_post(&ring->lr_exclsem);
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(ring, &ring->lr_rdsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Ancillary data attached to the first byte is returned with this data;
+   * ancillary data attached to a later byte ends the data that can be
+   * returned by this call.
+   */
+
+  avail = ring->lr_head - ring->lr_tail;
+  first = (FAR struct local_ctrl_s *)sq_peek(&ring->lr_ctrl);
+  if (first != NULL && first->ctl_pos == ring->lr_tail)
+    {
+      next = (FAR struct local_ctrl_s *)sq_next(&first->ctl_node);
+    }
+  else
+    {
+      next  = first;
+      first = NULL;
+    }
+
+  if (next != NULL)
+    {
+      avail = MIN(avail, next->ctl_pos - ring->lr_tail);
+    }
+
+  for (i = 0; i < iovcnt && avail > 0; i++)
+    {
+      size_t nbytes = MIN(iov[i].iov_len, avail);
+
+      local_ring_copyout(ring, ring->lr_tail + total,
+                         (FAR uint8_t *)iov[i].iov_base, nbytes);
+      total += nbytes;
+      avail -= nbytes;
+    }
+
+  if ((flags & MSG_PEEK) == 0 && total > 0)
+    {
+      ring->lr_tail += total;
+      if (first != NULL)
+        {
+          taken = (FAR struct local_ctrl_s *)sq_remfirst(&ring->lr_ctrl);
+        }
+
+      /* Let the sender have the space that was freed */
+
+      local_ring_wake(&ring->lr_wrsem);
+      local_ring_pollnotify(ring->lr_wrfds, POLLOUT);
+    }
+
+  nxsem_post(&ring->lr_exclsem);
+
+  if (taken != NULL)
+    {
+      if (ctrl != NULL)
+        {
+          *ctrl = taken;
+        }
+      else
+        {
+          local_ctrl_free(taken);
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: local_ctrl_free
+ *
+ * Description:
+ *   Free ancillary data, closing any descriptors still held by it.
+ *
+ ****************************************************************************/
+
+void local_ctrl_free(FAR struct local_ctrl_s *ctrl)
+{
+#ifdef CONFIG_NET_LOCAL_SCM
+  int i;
+
+  for (i = 0; i < ctrl->ctl_nfds; i++)
+    {
+      FAR struct local_fd_s *lfd = &ctrl->ctl_fds[i];
+
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+      if (lfd->lf_socket)
+        {
+          (void)psock_close(&lfd->u.lf_sock);
+          continue;
+        }
+#endif
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+      /* The file is reset if it was installed by the receiver */
+
+      if (!lfd->lf_socket && lfd->u.lf_file.f_inode != NULL)
+        {
+          (void)file_close_detached(&lfd->u.lf_file);
+        }
+#endif
+    }
+#endif
+
+  kmm_free(ctrl);
+}
+
+/****************************************************************************
+ * Name: local_ring_pollsetup and local_ring_pollteardown
+ *
+ * Description:
+ *   Setup or teardown the monitoring of events on the rings of a connected
+ *   stream socket.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds)
+{
+  FAR struct local_ring_s *rx = conn->lc_rxring;
+  FAR struct local_ring_s *tx = conn->lc_txring;
+  pollevent_t eventset = 0;
+  int ret = OK;
+
+  DEBUGASSERT(rx != NULL && tx != NULL);
+
+  local_ring_semtake(&rx->lr_exclsem);
+  if ((fds->events & POLLIN) != 0)
+    {
+      ret = local_ring_addwaiter(rx->lr_rdfds, fds);
+    }
+
+  if (rx->lr_head != rx->lr_tail)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (rx->lr_wrclosed)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+
+  nxsem_post(&rx->lr_exclsem);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  local_ring_semtake(&tx->lr_exclsem);
+  if ((fds->events & POLLOUT) != 0)
+    {
+      ret = local_ring_addwaiter(tx->lr_wrfds, fds);
+    }
+
+  if (tx->lr_head - tx->lr_tail < CONFIG_NET_LOCAL_SHMRING_SIZE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  if (tx->lr_rdclosed)
+    {
+      eventset |= POLLERR | POLLHUP;
+    }
+
+  nxsem_post(&tx->lr_exclsem);
+
+  if (ret < 0)
+    {
+      /* Back out the set up of the incoming ring */
+
+      local_ring_semtake(&rx->lr_exclsem);
+      local_ring_rmwaiter(rx->lr_rdfds, fds);
+      nxsem_post(&rx->lr_exclsem);
+      return ret;
+    }
+
+  fds->priv = conn;
+
+  /* Report any events that are already pending */
+
+  fds->revents |= eventset & (fds->events | POLLERR | POLLHUP);
+  if (fds->revents != 0)
+    {
+      poll_notify(fds);
+    }
+
+  return OK;
+}
+
+int local_ring_pollteardown(FAR struct local_conn_s *conn,
+                            FAR struct pollfd *fds)
+{
+  FAR struct local_ring_s *rx = conn->lc_rxring;
+  FAR struct local_ring_s *tx = conn->lc_txring;
+
+  if (fds->priv == NULL)
+    {
+      return OK;
+    }
+
+  if (rx != NULL)
+    {
+      local_ring_semtake(&rx->lr_exclsem);
+      local_ring_rmwaiter(rx->lr_rdfds, fds);
+      nxsem_post(&rx->lr_exclsem);
+    }
+
+  if (tx != NULL)
+    {
+      local_ring_semtake(&tx->lr_exclsem);
+      local_ring_rmwaiter(tx->lr_wrfds, fds);
+      nxsem_post(&tx->lr_exclsem);
+    }
+
+  fds->priv = NULL;
+  return OK;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET_LOCAL_SHMRING */
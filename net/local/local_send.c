@@ -40,12 +40,15 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
 #include <nuttx/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -77,11 +80,33 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  struct iovec iov;
+#else
   int ret;
+#endif
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  /* Verify that this is a connected peer socket that shares a ring with
+   * its peer and copy the data into the ring.
+   */
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_txring == NULL)
+    {
+      nerr("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return local_ring_send(peer->lc_txring, &iov, 1,
+                         _SS_ISNONBLOCK(psock->s_flags) ||
+                         (flags & MSG_DONTWAIT) != 0, NULL);
+#else
   /* Verify that this is a connected peer socket and that it has opened the
    * outgoing FIFO for write-only access.
    */
@@ -100,6 +125,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   /* If the send was successful, then the full packet will have been sent */
 
   return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * net/local/local_sendmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_hold_fd
+ *
+ * Description:
+ *   Duplicate one of the sender's descriptors into the message so that it
+ *   remains open until the receiver takes it over.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SCM
+static int local_hold_fd(int fd, FAR struct local_fd_s *lfd)
+{
+#if CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock == NULL || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      lfd->lf_socket = true;
+      return net_clone(psock, &lfd->u.lf_sock);
+    }
+#endif
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if (fd >= 0)
+    {
+      FAR struct file *filep;
+      int ret;
+
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      lfd->lf_socket = false;
+      return file_dup2(filep, &lfd->u.lf_file);
+    }
+#endif
+
+  return -EBADF;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_sendmsg_ctrl
+ *
+ * Description:
+ *   Convert the control messages of 'msg' to ancillary data for the ring.
+ *
+ * Returned Value:
+ *   Zero is returned on success with *pctrl set (NULL if there are no
+ *   control messages).  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int local_sendmsg_ctrl(FAR struct msghdr *msg,
+                              FAR struct local_ctrl_s **pctrl)
+{
+  FAR struct local_ctrl_s *ctrl;
+  FAR struct cmsghdr *cmsg;
+  FAR uint8_t *end;
+  int ret = OK;
+
+  *pctrl = NULL;
+  if (msg->msg_control == NULL || msg->msg_controllen == 0)
+    {
+      return OK;
+    }
+
+  ctrl = (FAR struct local_ctrl_s *)kmm_zalloc(sizeof(struct local_ctrl_s));
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  end = (FAR uint8_t *)msg->msg_control + msg->msg_controllen;
+  for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+      size_t datalen;
+
+      if (cmsg->cmsg_len < CMSG_LEN(0) ||
+          (FAR uint8_t *)cmsg + cmsg->cmsg_len > end)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      datalen = cmsg->cmsg_len - CMSG_LEN(0);
+      if (cmsg->cmsg_level != SOL_SOCKET)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      switch (cmsg->cmsg_type)
+        {
+          case SCM_CREDENTIALS:
+            {
+              FAR struct ucred *cred = (FAR struct ucred *)CMSG_DATA(cmsg);
+
+              if (datalen < sizeof(struct ucred))
+                {
+                  ret = -EINVAL;
+                  goto errout;
+                }
+
+              /* The sender can only claim to be who it is.  There are no
+               * users or groups; all tasks run as root.
+               */
+
+              if (cred->pid != getpid() || cred->uid != 0 || cred->gid != 0)
+                {
+                  ret = -EPERM;
+                  goto errout;
+                }
+
+              ctrl->ctl_cred    = *cred;
+              ctrl->ctl_hascred = true;
+            }
+            break;
+
+          case SCM_RIGHTS:
+            {
+#ifdef CONFIG_NET_LOCAL_SCM
+              FAR int *fds = (FAR int *)CMSG_DATA(cmsg);
+              int nfds = datalen / sizeof(int);
+              int i;
+
+              if (ctrl->ctl_nfds + nfds > CONFIG_NET_LOCAL_SCM_MAXFD)
+                {
+                  ret = -ETOOMANYREFS;
+                  goto errout;
+                }
+
+              for (i = 0; i < nfds; i++)
+                {
+                  ret = local_hold_fd(fds[i],
+                                      &ctrl->ctl_fds[ctrl->ctl_nfds]);
+                  if (ret < 0)
+                    {
+                      goto errout;
+                    }
+
+                  ctrl->ctl_nfds++;
+                }
+#else
+              ret = -EOPNOTSUPP;
+              goto errout;
+#endif
+            }
+            break;
+
+          default:
+            ret = -EINVAL;
+            goto errout;
+        }
+    }
+
+  *pctrl = ctrl;
+  return OK;
+
+errout:
+  local_ctrl_free(ctrl);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_local_sendmsg
+ *
+ * Description:
+ *   Implements sendmsg() for a connected Unix domain stream socket, sending
+ *   any SCM_CREDENTIALS and SCM_RIGHTS control messages along with the
+ *   data.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      The message to send
+ *   flags    Send flags (MSG_DONTWAIT is supported)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_local_sendmsg(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+  FAR struct local_conn_s *peer;
+  FAR struct local_ctrl_s *ctrl;
+  bool nonblock;
+  size_t len = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(psock && psock->s_conn && msg);
+  peer = (FAR struct local_conn_s *)psock->s_conn;
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_txring == NULL)
+    {
+      nerr("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  ret = local_sendmsg_ctrl(msg, &ctrl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Ancillary data must be attached to at least one byte of data */
+
+  if (ctrl != NULL && len == 0)
+    {
+      local_ctrl_free(ctrl);
+      return -EINVAL;
+    }
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+  ret = local_ring_send(peer->lc_txring, msg->msg_iov, msg->msg_iovlen,
+                        nonblock, ctrl);
+
+  /* The ring owns the ancillary data only if something was sent */
+
+  if (ret <= 0 && ctrl != NULL)
+    {
+      local_ctrl_free(ctrl);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_SHMRING */
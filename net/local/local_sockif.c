@@ -89,6 +89,12 @@ static ssize_t    local_sendto(FAR struct socket *psock, FAR const void *buf,
                     size_t len, int flags, FAR const struct sockaddr *to,
                     socklen_t tolen);
 static int        local_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_LOCAL_SHMRING
+static ssize_t    local_sendmsg(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
+static ssize_t    local_recvmsg(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -114,7 +120,16 @@ const struct sock_intf_s g_local_sockif =
   NULL,              /* si_sendfile */
 #endif
   local_recvfrom,    /* si_recvfrom */
+#ifdef CONFIG_NET_LOCAL_SHMRING
+  local_close,       /* si_close */
+#ifdef CONFIG_NET_USRSOCK
+  NULL,              /* si_ioctl */
+#endif
+  local_sendmsg,     /* si_sendmsg */
+  local_recvmsg      /* si_recvmsg */
+#else
   local_close        /* si_close */
+#endif
 };
 
 /****************************************************************************
@@ -834,6 +849,72 @@ static int local_close(FAR struct socket *psock)
     }
 }
 
+/****************************************************************************
+ * Name: local_sendmsg
+ *
+ * Description:
+ *   Implements the sendmsg() operation for the case of the local, Unix
+ *   socket.  Connected stream sockets send the data and any control
+ *   messages through the ring shared with the peer; datagrams are sent with
+ *   the generic implementation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see sendmsg() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_SHMRING
+static ssize_t local_sendmsg(FAR struct socket *psock,
+                             FAR struct msghdr *msg, int flags)
+{
+  if (psock->s_type == SOCK_STREAM)
+    {
+      return psock_local_sendmsg(psock, msg, flags);
+    }
+
+  return net_sendmsg_bounce(psock, msg, flags);
+}
+
+/****************************************************************************
+ * Name: local_recvmsg
+ *
+ * Description:
+ *   Implements the recvmsg() operation for the case of the local, Unix
+ *   socket.  Connected stream sockets return the data and any control
+ *   messages from the ring shared with the peer; datagrams are received
+ *   with the generic implementation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error, a
+ *   negated errno value is returned (see recvmsg() for the list of
+ *   appropriate error values.
+ *
+ ****************************************************************************/
+
+static ssize_t local_recvmsg(FAR struct socket *psock,
+                             FAR struct msghdr *msg, int flags)
+{
+  if (psock->s_type == SOCK_STREAM)
+    {
+      return psock_local_recvmsg(psock, msg, flags);
+    }
+
+  return net_recvmsg_bounce(psock, msg, flags);
+}
+#endif /* CONFIG_NET_LOCAL_SHMRING */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
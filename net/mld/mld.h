@@ -217,6 +217,7 @@ typedef FAR struct wdog_s *WDOG_ID;
 struct mld_group_s
 {
   struct mld_group_s *next;    /* Implements a singly-linked list */
+  sq_entry_t          hnode;   /* Links the group in its hash bucket */
   net_ipv6addr_t      grpaddr; /* Group IPv6 address */
   struct work_s       work;    /* For deferred timeout operations */
   WDOG_ID             polldog; /* Timer used for periodic or delayed events */
@@ -47,6 +47,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
@@ -60,10 +61,42 @@
 
 #ifdef CONFIG_NET_MLD
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a group address to its hash bucket */
+
+#define MLD_GRPHASH(dev,a) \
+  (&(dev)->d_mld.grphash[mld_grphash(a) % CONFIG_NET_MLD_HASHSIZE])
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name:  mld_grphash
+ *
+ * Description:
+ *   Fold a group address into a hash value.  Most of the bits that differ
+ *   between groups are in the low-order group ID, but the scope field in
+ *   the first half-word is also mixed in.
+ *
+ ****************************************************************************/
+
+static inline uint32_t mld_grphash(FAR const net_ipv6addr_t addr)
+{
+  uint32_t hash = addr[0];
+  int i;
+
+  for (i = 5; i < 8; i++)
+    {
+      hash = (hash << 5) ^ (hash >> 27) ^ addr[i];
+    }
+
+  return hash ^ (hash >> 16);
+}
+
 /****************************************************************************
  * Name:  mld_ngroups
  *
@@ -158,9 +191,12 @@ FAR struct mld_group_s *mld_grpalloc(FAR struct net_driver_s *dev,
         }
 #endif
 
-      /* Add the group structure to the list in the device structure */
+      /* Add the group structure to the list and to the hash table in the
+       * device structure.
+       */
 
       sq_addfirst((FAR sq_entry_t *)group, &dev->d_mld.grplist);
+      sq_addfirst(&group->hnode, MLD_GRPHASH(dev, addr));
     }
 
   return group;
@@ -186,15 +222,20 @@ FAR struct mld_group_s *mld_grpfind(FAR struct net_driver_s *dev,
                                     FAR const net_ipv6addr_t addr)
 {
   FAR struct mld_group_s *group;
+  FAR sq_entry_t *entry;
 
   mldinfo("Searching for group: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
           addr[0], addr[1], addr[2], addr[3], addr[4], addr[5], addr[6],
           addr[7]);
 
-  for (group = (FAR struct mld_group_s *)dev->d_mld.grplist.head;
-       group;
-       group = group->next)
+  /* Only the groups in the hash bucket of the address need be examined */
+
+  for (entry = sq_peek(MLD_GRPHASH(dev, addr));
+       entry != NULL;
+       entry = sq_next(entry))
     {
+      group = container_of(entry, struct mld_group_s, hnode);
+
       mldinfo("Compare: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
               group->grpaddr[0], group->grpaddr[1], group->grpaddr[2],
               group->grpaddr[3], group->grpaddr[4], group->grpaddr[5],
@@ -204,11 +245,11 @@ FAR struct mld_group_s *mld_grpfind(FAR struct net_driver_s *dev,
         {
           mldinfo("Match!\n");
           DEBUGASSERT(group->ifindex == dev->d_ifindex);
-          break;
+          return group;
         }
     }
 
-  return group;
+  return NULL;
 }
 
 /****************************************************************************
@@ -254,9 +295,12 @@ void mld_grpfree(FAR struct net_driver_s *dev, FAR struct mld_group_s *group)
 
   wd_cancel(group->polldog);
 
-  /* Remove the group structure from the group list in the device structure */
+  /* Remove the group structure from the group list and from the hash table
+   * in the device structure.
+   */
 
   sq_rem((FAR sq_entry_t *)group, &dev->d_mld.grplist);
+  sq_rem(&group->hnode, MLD_GRPHASH(dev, group->grpaddr));
 
   /* Destroy the wait semaphore */
 
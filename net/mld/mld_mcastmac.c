@@ -46,6 +46,7 @@
 #include <nuttx/net/mld.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "mld/mld.h"
 
 #ifdef CONFIG_NET_MLD
@@ -95,7 +96,9 @@ static void mld_mcastmac(FAR const net_ipv6addr_t ipaddr, FAR uint8_t *mac)
  * Name:  mld_addmcastmac
  *
  * Description:
- *   Add an MLD MAC address to the device's MAC filter table.
+ *   Add an MLD MAC address to the device's MAC filter table.  Several
+ *   groups may share one MAC address; the filter entry is reference
+ *   counted.
  *
  ****************************************************************************/
 
@@ -106,18 +109,16 @@ void mld_addmcastmac(FAR struct net_driver_s *dev,
 
   mldinfo("Adding MAC address filter\n");
 
-  if (dev->d_addmac != NULL)
-    {
-      mld_mcastmac(ipaddr, mcastmac);
-      dev->d_addmac(dev, mcastmac);
-    }
+  mld_mcastmac(ipaddr, mcastmac);
+  (void)netdev_addmcastmac(dev, mcastmac);
 }
 
 /****************************************************************************
  * Name:  mld_removemcastmac
  *
  * Description:
- *   Remove an MLD MAC address from the device's MAC filter table.
+ *   Remove an MLD MAC address from the device's MAC filter table.  The
+ *   address remains in the filter while other groups still use it.
  *
  ****************************************************************************/
 
@@ -128,11 +129,8 @@ void mld_removemcastmac(FAR struct net_driver_s *dev,
 
   mldinfo("Removing MAC address filter\n");
 
-  if (dev->d_rmmac != NULL)
-    {
-      mld_mcastmac(ipaddr, mcastmac);
-      dev->d_rmmac(dev, mcastmac);
-    }
+  mld_mcastmac(ipaddr, mcastmac);
+  (void)netdev_rmmcastmac(dev, mcastmac);
 }
 
 #endif /* CONFIG_NET_MLD */
@@ -54,6 +54,8 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
 
+#include "utils/utils.h"
+
 #ifdef CONFIG_NET_IPv6
 
 /****************************************************************************
@@ -97,6 +99,16 @@ struct neighbor_entry
   clock_t                ne_time;    /* For aging, units of tick */
 };
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* One entry in the hashed Neighbor Table */
+
+struct neighbor_node_s
+{
+  struct net_agecache_entry_s nn_age;   /* Must be first */
+  struct neighbor_entry       nn_entry;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -105,7 +117,11 @@ struct neighbor_entry
  * this table.
  */
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+extern struct net_agecache_s g_neighbors;
+#else
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -55,6 +56,7 @@
 
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
+#include "netlink/netlink.h"
 
 /****************************************************************************
  * Public Functions
@@ -80,6 +82,55 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+#ifdef CONFIG_NETLINK_ROUTE
+  bool changed;
+#endif
+
+  DEBUGASSERT(dev != NULL && addr != NULL);
+
+#ifdef CONFIG_NETLINK_ROUTE
+  /* Only new or changed mappings are reported to netlink */
+
+  node    = (FAR struct neighbor_node_s *)
+    net_agecache_find(&g_neighbors, ipaddr);
+  changed = node == NULL ||
+            node->nn_entry.ne_addr.na_lltype != dev->d_lltype ||
+            memcmp(&node->nn_entry.ne_addr.u, addr,
+                   netdev_lladdrsize(dev)) != 0;
+#endif
+
+  /* Find the entry for this IPv6 address, creating it (or replacing the
+   * oldest entry) if there is none.
+   */
+
+  node = (FAR struct neighbor_node_s *)
+    net_agecache_insert(&g_neighbors, ipaddr);
+  if (node == NULL)
+    {
+      nerr("ERROR: Failed to allocate a Neighbor Table entry\n");
+      return;
+    }
+
+  node->nn_entry.ne_time = node->nn_age.ae_time;
+  node->nn_entry.ne_addr.na_lltype = dev->d_lltype;
+  node->nn_entry.ne_addr.na_llsize = netdev_lladdrsize(dev);
+
+  memcpy(&node->nn_entry.ne_addr.u, addr, node->nn_entry.ne_addr.na_llsize);
+
+  /* Dump the contents of the new entry */
+
+  neighbor_dumpentry("Added entry", &node->nn_entry);
+
+#ifdef CONFIG_NETLINK_ROUTE
+  if (changed)
+    {
+      netlink_neigh_notify(dev, RTM_NEWNEIGH, AF_INET6, ipaddr, addr,
+                           node->nn_entry.ne_addr.na_llsize);
+    }
+#endif
+#else
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -113,6 +164,19 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
    * "oldest_ndx" variable).
    */
 
+#ifdef CONFIG_NETLINK_ROUTE
+  /* Only new or changed mappings are reported to netlink */
+
+  if (g_neighbors[oldest_ndx].ne_addr.na_lltype != lltype ||
+      !net_ipv6addr_cmp(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr) ||
+      memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
+             netdev_lladdrsize(dev)) != 0)
+    {
+      netlink_neigh_notify(dev, RTM_NEWNEIGH, AF_INET6, ipaddr, addr,
+                           netdev_lladdrsize(dev));
+    }
+#endif
+
   g_neighbors[oldest_ndx].ne_time = clock_systimer();
   net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
 
@@ -125,4 +189,5 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   /* Dump the contents of the new entry */
 
   neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+#endif
 }
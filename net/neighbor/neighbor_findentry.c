@@ -70,6 +70,17 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+
+  node = (FAR struct neighbor_node_s *)
+    net_agecache_find(&g_neighbors, ipaddr);
+  if (node != NULL)
+    {
+      neighbor_dumpentry("Entry found", &node->nn_entry);
+      return &node->nn_entry;
+    }
+#else
   int i;
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
@@ -82,6 +93,7 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
           return neighbor;
         }
     }
+#endif
 
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
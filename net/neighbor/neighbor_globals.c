@@ -54,5 +54,12 @@
  * this table.
  */
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+struct net_agecache_s g_neighbors =
+  NET_AGECACHE_INITIALIZER(struct neighbor_node_s, nn_entry.ne_ipaddr,
+                           CONFIG_NET_IPv6_NCONF_ENTRIES,
+                           SEC2TICK(10 * CONFIG_NET_IPv6_NCONF_MAXAGE));
+#else
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
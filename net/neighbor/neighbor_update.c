@@ -67,6 +67,17 @@
 
 void neighbor_update(const net_ipv6addr_t ipaddr)
 {
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+
+  node = (FAR struct neighbor_node_s *)
+    net_agecache_find(&g_neighbors, ipaddr);
+  if (node != NULL)
+    {
+      net_agecache_touch(&g_neighbors, &node->nn_age);
+      node->nn_entry.ne_time = node->nn_age.ae_time;
+    }
+#else
   struct neighbor_entry *neighbor;
 
   neighbor = neighbor_findentry(ipaddr);
@@ -74,4 +85,5 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
     {
       neighbor->ne_time = clock_systimer();
     }
+#endif
 }
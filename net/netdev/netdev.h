@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+#include <nuttx/rwlock.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NETDOWN_NOTIFIER
@@ -82,6 +83,14 @@ extern "C"
  */
 
 EXTERN struct net_driver_s *g_netdevices;
+
+/* Look-ups that only walk g_netdevices do so inside of a read-side section
+ * of g_netdev_rcu rather than locking the network.  Changes to the list
+ * are still made with the network locked, and an unregistered device is
+ * not returned to the driver until all such look-ups have completed.
+ */
+
+EXTERN struct rcu_s g_netdev_rcu;
 #endif
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -127,6 +136,27 @@ typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev, FAR void *arg);
 void netdev_ifup(FAR struct net_driver_s *dev);
 void netdev_ifdown(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_addmcastmac / netdev_rmmcastmac
+ *
+ * Description:
+ *   Take or drop a reference to a multicast MAC address in the MAC filter
+ *   of the device.  The driver's d_addmac() is called for the first
+ *   reference and d_rmmac() for the last.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MCASTGROUP
+int netdev_addmcastmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
+int netdev_rmmcastmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
+#endif
+
 /****************************************************************************
  * Name: netdev_verify
  *
@@ -572,6 +602,52 @@ int netdown_notifier_teardown(int key);
 void netdown_notifier_signal(FAR struct net_driver_s *dev);
 #endif
 
+/****************************************************************************
+ * Name: netdev_rfs_process
+ *
+ * Description:
+ *   Pass up to 'budget' frames steered to a queue to the driver's
+ *   nq_input().
+ *
+ * Input Parameters:
+ *   nq     - The queue
+ *   budget - The maximum number of frames to process
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ * Assumptions:
+ *   Called on the queue thread with the network unlocked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RFS
+struct netdev_queue_s; /* Forward reference */
+
+int netdev_rfs_process(FAR struct netdev_queue_s *nq, int budget);
+
+/****************************************************************************
+ * Name: netdev_rfs_pending
+ *
+ * Description:
+ *   Return true if frames have been steered to the queue and are not yet
+ *   processed.
+ *
+ ****************************************************************************/
+
+bool netdev_rfs_pending(FAR struct netdev_queue_s *nq);
+
+/****************************************************************************
+ * Name: netdev_rfs_discard
+ *
+ * Description:
+ *   Free all frames steered to the queue that are not yet processed.
+ *
+ ****************************************************************************/
+
+void netdev_rfs_discard(FAR struct netdev_queue_s *nq);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -53,6 +53,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "netdev/netdev.h"
+#include "netlink/netlink.h"
 
 /****************************************************************************
  * Public Functions
@@ -77,7 +78,12 @@ int netdev_carrier_on(FAR struct net_driver_s *dev)
 {
   if (dev)
     {
-      dev->d_flags |= IFF_RUNNING;
+      if ((dev->d_flags & IFF_RUNNING) == 0)
+        {
+          dev->d_flags |= IFF_RUNNING;
+          netlink_link_notify(dev, RTM_NEWLINK);
+        }
+
       return OK;
     }
 
@@ -103,7 +109,12 @@ int netdev_carrier_off(FAR struct net_driver_s *dev)
 {
   if (dev)
     {
-      dev->d_flags &= ~IFF_RUNNING;
+      if ((dev->d_flags & IFF_RUNNING) != 0)
+        {
+          dev->d_flags &= ~IFF_RUNNING;
+          netlink_link_notify(dev, RTM_NEWLINK);
+        }
+
       return OK;
     }
 
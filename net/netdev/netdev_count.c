@@ -70,10 +70,11 @@ int netdev_count(void)
 {
   struct net_driver_s *dev;
   int ndev;
+  int phase;
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
   for (dev = g_netdevices, ndev = 0; dev; dev = dev->flink, ndev++);
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return ndev;
 }
 
@@ -74,10 +74,11 @@ FAR struct net_driver_s *netdev_default(void)
 {
   FAR struct net_driver_s *ret = NULL;
   FAR struct net_driver_s *dev;
+  int phase;
 
   /* Examine each registered network device */
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -97,7 +98,7 @@ FAR struct net_driver_s *netdev_default(void)
         }
     }
 
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return ret;
 }
 
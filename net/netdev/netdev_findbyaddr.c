@@ -82,10 +82,11 @@
 FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
 {
   FAR struct net_driver_s *dev;
+  int phase;
 
   /* Examine each registered network device */
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -99,7 +100,7 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              nxrcu_read_unlock(&g_netdev_rcu, phase);
               return dev;
             }
         }
@@ -107,7 +108,7 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -133,10 +134,11 @@ FAR struct net_driver_s *netdev_findby_lipv4addr(in_addr_t lipaddr)
 FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
 {
   FAR struct net_driver_s *dev;
+  int phase;
 
   /* Examine each registered network device */
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -150,7 +152,7 @@ FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              nxrcu_read_unlock(&g_netdev_rcu, phase);
               return dev;
             }
         }
@@ -158,7 +160,7 @@ FAR struct net_driver_s *netdev_findby_lipv6addr(const net_ipv6addr_t lipaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
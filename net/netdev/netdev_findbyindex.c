@@ -73,6 +73,7 @@
 FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 {
   FAR struct net_driver_s *dev;
+  int phase;
   int i;
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -87,7 +88,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     }
 #endif
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -96,7 +97,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      net_unlock();
+      nxrcu_read_unlock(&g_netdev_rcu, phase);
       return NULL;
     }
 #endif
@@ -119,12 +120,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (i == (ifindex - 1))
 #endif
         {
-          net_unlock();
+          nxrcu_read_unlock(&g_netdev_rcu, phase);
           return dev;
         }
     }
 
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return NULL;
 }
 
@@ -70,20 +70,21 @@
 FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 {
   FAR struct net_driver_s *dev;
+  int phase;
 
   if (ifname)
     {
-      net_lock();
+      phase = nxrcu_read_lock(&g_netdev_rcu);
       for (dev = g_netdevices; dev; dev = dev->flink)
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              net_unlock();
+              nxrcu_read_unlock(&g_netdev_rcu, phase);
               return dev;
             }
         }
 
-      net_unlock();
+      nxrcu_read_unlock(&g_netdev_rcu, phase);
     }
 
   return NULL;
@@ -0,0 +1,320 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The IPv4 and TCP headers of a frame in 'buf' */
+
+#define GRO_IPv4(dev,buf) \
+  ((FAR struct ipv4_hdr_s *)&(buf)[NET_LL_HDRLEN(dev)])
+#define GRO_TCP(dev,buf) \
+  ((FAR struct tcp_hdr_s *)&(buf)[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
+
+/* The size of all headers of an aggregated frame.  Only segments without
+ * IP or TCP options are aggregated.
+ */
+
+#define GRO_HDRLEN(dev)  (NET_LL_HDRLEN(dev) + IPv4TCP_HDRLEN)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_seglen
+ *
+ * Description:
+ *   Return the amount of TCP data in the frame in d_buf if it is a valid
+ *   TCP/IPv4 data segment without options, destined for this device, and
+ *   carrying no flags other than ACK and PSH.  Otherwise return zero.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_gro_seglen(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = GRO_IPv4(dev, dev->d_buf);
+  FAR struct tcp_hdr_s *tcp = GRO_TCP(dev, dev->d_buf);
+  uint16_t iplen;
+
+  if (dev->d_len < GRO_HDRLEN(dev) || ipv4->vhl != 0x45 ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_hdrcmp(ipv4->destipaddr, &dev->d_ipaddr))
+    {
+      return 0;
+    }
+
+  iplen = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+  if (iplen <= IPv4TCP_HDRLEN || iplen + NET_LL_HDRLEN(dev) > dev->d_len)
+    {
+      return 0;
+    }
+
+  if (tcp->tcpoffset != (TCP_HDRLEN / 4) << 4 ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return 0;
+    }
+
+  /* The checksums of the aggregated frame are not calculated again, so
+   * those of each segment must be verified here.
+   */
+
+  if ((!NETDEV_RXCHKSUM(dev, NETDEV_CHKSUM_IPv4) &&
+       ipv4_chksum(dev) != 0xffff) ||
+      (!NETDEV_RXCHKSUM(dev, NETDEV_CHKSUM_TCP) &&
+       tcp_ipv4_chksum(dev) != 0xffff))
+    {
+      return 0;
+    }
+
+  return iplen - IPv4TCP_HDRLEN;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_match
+ *
+ * Description:
+ *   Return true if the segment in d_buf directly follows the held segment
+ *   of the same connection, acknowledges the same data, and advertises the
+ *   same window.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_match(FAR struct netdev_rxpoll_s *rp)
+{
+  FAR struct net_driver_s *dev = rp->rp_dev;
+  FAR struct ipv4_hdr_s *ipv4 = GRO_IPv4(dev, dev->d_buf);
+  FAR struct tcp_hdr_s *tcp = GRO_TCP(dev, dev->d_buf);
+  FAR struct ipv4_hdr_s *held4 = GRO_IPv4(dev, rp->rp_grobuf);
+  FAR struct tcp_hdr_s *heldtcp = GRO_TCP(dev, rp->rp_grobuf);
+
+  return memcmp(ipv4->srcipaddr, held4->srcipaddr, 8) == 0 &&
+         tcp->srcport == heldtcp->srcport &&
+         tcp->destport == heldtcp->destport &&
+         memcmp(tcp->ackno, heldtcp->ackno, 4) == 0 &&
+         memcmp(tcp->wnd, heldtcp->wnd, 2) == 0 &&
+         tcp_getsequence(tcp->seqno) == rp->rp_groseq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass any held aggregated segment to the network.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct netdev_rxpoll_s *rp)
+{
+  FAR struct net_driver_s *dev = rp->rp_dev;
+  FAR struct ipv4_hdr_s *held4;
+  FAR uint8_t *buf;
+  uint16_t iplen;
+  uint16_t len;
+  uint8_t rxchksum;
+
+  if (rp->rp_grolen == 0)
+    {
+      return;
+    }
+
+  DEBUGASSERT(rp->rp_reply != NULL);
+
+  /* Correct the IP length.  The checksums have already been verified. */
+
+  held4         = GRO_IPv4(dev, rp->rp_grobuf);
+  iplen         = rp->rp_grolen - NET_LL_HDRLEN(dev);
+  held4->len[0] = iplen >> 8;
+  held4->len[1] = iplen & 0xff;
+
+  /* Pass the segment to the network from the aggregation buffer */
+
+  buf             = dev->d_buf;
+  len             = dev->d_len;
+  rxchksum        = dev->d_rxchksum;
+
+  dev->d_buf      = rp->rp_grobuf;
+  dev->d_len      = rp->rp_grolen;
+  dev->d_rxchksum = rxchksum | NETDEV_CHKSUM_IPv4 | NETDEV_CHKSUM_TCP;
+  rp->rp_grolen   = 0;
+
+  ipv4_input(dev);
+
+  dev->d_rxchksum = rxchksum;
+  if (dev->d_len > 0)
+    {
+      rp->rp_reply(dev);
+    }
+
+  dev->d_buf      = buf;
+  dev->d_len      = len;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Offer a received IPv4 frame in d_buf for TCP receive aggregation.  This
+ *   is called from rp_poll() in place of ipv4_input() (after any link layer
+ *   processing such as arp_ipin()).  If the frame is an in-order data
+ *   segment that continues the held segment, its data is appended.
+ *   Otherwise the held segment is passed to the network first (see
+ *   rp_reply()).  The held segment is also passed to the network at the
+ *   end of each poll pass.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   One if the frame was absorbed (d_len is then zero); zero if the driver
+ *   must pass the frame to ipv4_input() itself.
+ *
+ * Assumptions:
+ *   Called with the network locked from rp_poll().
+ *
+ ****************************************************************************/
+
+int netdev_gro_input(FAR struct netdev_rxpoll_s *rp)
+{
+  FAR struct net_driver_s *dev = rp->rp_dev;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t seglen;
+
+  DEBUGASSERT(rp->rp_grobuf != NULL);
+
+#ifdef CONFIG_NETDEV_SGTX
+  /* The checksum calculations must not look at stale outgoing data */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+#endif
+
+  seglen = netdev_gro_seglen(dev);
+  if (seglen == 0)
+    {
+      /* Not a candidate.  Keep the order of segments of the held
+       * connection.
+       */
+
+      netdev_gro_flush(rp);
+      return 0;
+    }
+
+  tcp = GRO_TCP(dev, dev->d_buf);
+
+  if (rp->rp_grolen > 0)
+    {
+      if (netdev_gro_match(rp) &&
+          (uint32_t)rp->rp_grolen + seglen <= rp->rp_grosize)
+        {
+          /* Append the data to the held segment */
+
+          memcpy(&rp->rp_grobuf[rp->rp_grolen],
+                 &dev->d_buf[GRO_HDRLEN(dev)], seglen);
+
+          rp->rp_grolen += seglen;
+          rp->rp_groseq += seglen;
+          dev->d_len     = 0;
+
+          /* The sender wants the data delivered now */
+
+          if ((tcp->flags & TCP_PSH) != 0)
+            {
+              GRO_TCP(dev, rp->rp_grobuf)->flags |= TCP_PSH;
+              netdev_gro_flush(rp);
+            }
+
+          return 1;
+        }
+
+      netdev_gro_flush(rp);
+    }
+
+  /* There is nothing to gain by holding a segment that is pushed or that
+   * does not fit.
+   */
+
+  if ((tcp->flags & TCP_PSH) != 0 ||
+      GRO_HDRLEN(dev) + seglen > rp->rp_grosize)
+    {
+      return 0;
+    }
+
+  /* Hold this segment and wait for the next one */
+
+  memcpy(rp->rp_grobuf, dev->d_buf, GRO_HDRLEN(dev) + seglen);
+  rp->rp_grolen = GRO_HDRLEN(dev) + seglen;
+  rp->rp_groseq = tcp_getsequence(tcp->seqno) + seglen;
+  dev->d_len    = 0;
+  return 1;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
@@ -0,0 +1,263 @@
+/****************************************************************************
+ * net/netdev/netdev_gso.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_TSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest link layer, IP, and TCP headers of a large frame */
+
+#define GSO_HDRMAX 128
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gso
+ *
+ * Description:
+ *   Software segmentation for a driver that accepts large TCP frames
+ *   (d_tsomax > 0) but whose hardware cannot split them.  If
+ *   NETDEV_IS_TSO(dev) is true, the large frame is split into segments of
+ *   at most d_tsomss bytes of data.  For each segment, a complete frame
+ *   with corrected IP and TCP headers is placed in d_buf (d_len) and
+ *   passed to the driver's xmit() function.
+ *
+ * Input Parameters:
+ *   dev  - The network device with an outgoing large frame
+ *   xmit - Transmit the single frame in d_buf.  If xmit() returns a
+ *          non-zero value, the remaining segments are discarded; they will
+ *          be recovered by TCP retransmission.
+ *
+ * Returned Value:
+ *   The number of segments passed to xmit().
+ *
+ * Assumptions:
+ *   Called with the network locked, immediately after the network has
+ *   provided the frame and after the link layer header has been added.
+ *
+ ****************************************************************************/
+
+int netdev_gso(FAR struct net_driver_s *dev,
+               CODE int (*xmit)(FAR struct net_driver_s *dev))
+{
+  uint8_t hdr[GSO_HDRMAX];
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *iob;
+  unsigned int remaining;
+  unsigned int offset;
+  unsigned int hdrlen;
+  unsigned int iphdrlen;
+  unsigned int seglen;
+  uint32_t seqno;
+  uint8_t flags;
+  bool ipv4;
+  int nsegs;
+
+  if (!NETDEV_IS_TSO(dev))
+    {
+      /* An ordinary frame */
+
+      (void)xmit(dev);
+      return 1;
+    }
+
+  DEBUGASSERT(xmit != NULL && dev->d_len > dev->d_sndlen);
+
+  /* Save the headers of the large frame.  They are the template for the
+   * headers of each segment.
+   */
+
+  hdrlen = dev->d_len - dev->d_sndlen;
+  if (hdrlen > GSO_HDRMAX)
+    {
+      nerr("ERROR: Headers too large: %u\n", hdrlen);
+      dev->d_iob    = NULL;
+      dev->d_tsomss = 0;
+      dev->d_len    = 0;
+      return 0;
+    }
+
+  memcpy(hdr, dev->d_buf, hdrlen);
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  ipv4     = (dev->d_buf[NET_LL_HDRLEN(dev)] & IP_VERSION_MASK) ==
+             IPv4_VERSION;
+  iphdrlen = ipv4 ? IPv4_HDRLEN : IPv6_HDRLEN;
+#elif defined(CONFIG_NET_IPv4)
+  ipv4     = true;
+  iphdrlen = IPv4_HDRLEN;
+#else
+  ipv4     = false;
+  iphdrlen = IPv6_HDRLEN;
+#endif
+
+  tcp      = (FAR struct tcp_hdr_s *)&hdr[NET_LL_HDRLEN(dev) + iphdrlen];
+  seqno    = tcp_getsequence(tcp->seqno);
+  flags    = tcp->flags;
+
+  iob       = dev->d_iob;
+  offset    = dev->d_iobofs;
+  remaining = dev->d_sndlen;
+
+  for (nsegs = 0; remaining > 0; nsegs++)
+    {
+      seglen = remaining > dev->d_tsomss ? dev->d_tsomss : remaining;
+
+      /* Skip over the I/O buffers that have already been sent */
+
+      while (iob != NULL && offset >= iob->io_len)
+        {
+          offset -= iob->io_len;
+          iob     = iob->io_flink;
+        }
+
+      DEBUGASSERT(iob != NULL);
+
+      /* Build the frame for this segment in d_buf */
+
+      memcpy(dev->d_buf, hdr, hdrlen);
+      iob_copyout(&dev->d_buf[hdrlen], iob, seglen, offset);
+
+      dev->d_iob    = NULL;
+      dev->d_sndlen = seglen;
+      dev->d_len    = hdrlen + seglen;
+
+      offset       += seglen;
+      remaining    -= seglen;
+
+      /* Each segment has its own sequence number.  FIN and PSH belong only
+       * with the final segment.
+       */
+
+      tcp = (FAR struct tcp_hdr_s *)
+        &dev->d_buf[NET_LL_HDRLEN(dev) + iphdrlen];
+
+      tcp_setsequence(tcp->seqno, seqno);
+      seqno += seglen;
+
+      if (remaining > 0)
+        {
+          tcp->flags = flags & ~(TCP_FIN | TCP_PSH);
+        }
+
+      /* Then correct the IP length and the checksums */
+
+#ifdef CONFIG_NET_IPv4
+      if (ipv4)
+        {
+          FAR struct ipv4_hdr_s *ipv4hdr =
+            (FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)];
+          uint16_t iplen = dev->d_len - NET_LL_HDRLEN(dev);
+
+          ipv4hdr->len[0]   = iplen >> 8;
+          ipv4hdr->len[1]   = iplen & 0xff;
+
+          if (nsegs > 0)
+            {
+              ++g_ipid;
+              ipv4hdr->ipid[0] = g_ipid >> 8;
+              ipv4hdr->ipid[1] = g_ipid & 0xff;
+            }
+
+          ipv4hdr->ipchksum = 0;
+          if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_IPv4))
+            {
+              ipv4hdr->ipchksum = ~ipv4_chksum(dev);
+            }
+
+          tcp->tcpchksum    = 0;
+          if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_TCP))
+            {
+              tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (!ipv4)
+        {
+          FAR struct ipv6_hdr_s *ipv6hdr =
+            (FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)];
+          uint16_t iplen = dev->d_len - NET_LL_HDRLEN(dev) - IPv6_HDRLEN;
+
+          ipv6hdr->len[0] = iplen >> 8;
+          ipv6hdr->len[1] = iplen & 0xff;
+
+          tcp->tcpchksum  = 0;
+          if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_TCP))
+            {
+              tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+            }
+        }
+#endif
+
+      if (xmit(dev) != 0)
+        {
+          ninfo("Dropped %u bytes after %d segments\n", remaining, nsegs);
+          nsegs++;
+          break;
+        }
+    }
+
+  dev->d_tsomss = 0;
+  return nsegs;
+}
+
+#endif /* CONFIG_NETDEV_TSO */
@@ -89,6 +89,11 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "inet/inet.h"
+#include "pkt/pkt.h"
+#include "ipfilter/ipfilter.h"
+#include "ipforward/ipforward.h"
+#include "netlink/netlink.h"
 
 #if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
 
@@ -169,6 +174,7 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   in_addr_t target;
   in_addr_t netmask;
   in_addr_t router;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)rtentry->rt_target;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -188,7 +194,13 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
       router = 0;
     }
 
-  return net_addroute_ipv4(target, netmask, router);
+  ret = net_addroute_ipv4(target, netmask, router);
+  if (ret >= 0)
+    {
+      netlink_ipv4route_notify(RTM_NEWROUTE, target, netmask, router);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -209,6 +221,7 @@ static int ioctl_add_ipv6route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in6 *target;
   FAR struct sockaddr_in6 *netmask;
   net_ipv6addr_t router;
+  int ret;
 
   target    = (FAR struct sockaddr_in6 *)rtentry->rt_target;
   netmask    = (FAR struct sockaddr_in6 *)rtentry->rt_netmask;
@@ -226,7 +239,15 @@ static int ioctl_add_ipv6route(FAR struct rtentry *rtentry)
       net_ipv6addr_copy(router, in6addr_any.s6_addr16);
     }
 
-  return net_addroute_ipv6(target->sin6_addr.s6_addr16, netmask->sin6_addr.s6_addr16, router);
+  ret = net_addroute_ipv6(target->sin6_addr.s6_addr16,
+                          netmask->sin6_addr.s6_addr16, router);
+  if (ret >= 0)
+    {
+      netlink_ipv6route_notify(RTM_NEWROUTE, target->sin6_addr.s6_addr16,
+                               netmask->sin6_addr.s6_addr16, router);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv6ROUTE */
 
@@ -247,6 +268,7 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in *addr;
   in_addr_t target;
   in_addr_t netmask;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)rtentry->rt_target;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -254,7 +276,13 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)rtentry->rt_netmask;
   netmask = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_delroute_ipv4(target, netmask);
+  ret = net_delroute_ipv4(target, netmask);
+  if (ret >= 0)
+    {
+      netlink_ipv4route_notify(RTM_DELROUTE, target, netmask, 0);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -274,11 +302,21 @@ static int ioctl_del_ipv6route(FAR struct rtentry *rtentry)
 {
   FAR struct sockaddr_in6 *target;
   FAR struct sockaddr_in6 *netmask;
+  int ret;
 
   target    = (FAR struct sockaddr_in6 *)rtentry->rt_target;
   netmask    = (FAR struct sockaddr_in6 *)rtentry->rt_netmask;
 
-  return net_delroute_ipv6(target->sin6_addr.s6_addr16, netmask->sin6_addr.s6_addr16);
+  ret = net_delroute_ipv6(target->sin6_addr.s6_addr16,
+                          netmask->sin6_addr.s6_addr16);
+  if (ret >= 0)
+    {
+      netlink_ipv6route_notify(RTM_DELROUTE, target->sin6_addr.s6_addr16,
+                               netmask->sin6_addr.s6_addr16,
+                               in6addr_any.s6_addr16);
+    }
+
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv6ROUTE */
 
@@ -451,7 +489,9 @@ static int netdev_bluetooth_ioctl(FAR struct socket *psock, int cmd,
         {
           /* Perform the device IOCTL */
 
+          netdev_lock(dev);
           ret = dev->d_ioctl(dev, cmd, arg);
+          netdev_unlock(dev);
         }
     }
 
@@ -512,7 +552,9 @@ static int netdev_iee802154_ioctl(FAR struct socket *psock, int cmd,
         {
           /* Perform the device IOCTL */
 
+          netdev_lock(dev);
           ret = dev->d_ioctl(dev, cmd, arg);
+          netdev_unlock(dev);
         }
     }
 
@@ -574,7 +616,9 @@ static int netdev_pktradio_ioctl(FAR struct socket *psock, int cmd,
         {
           /* Perform the device IOCTL */
 
+          netdev_lock(dev);
           ret = dev->d_ioctl(dev, cmd, arg);
+          netdev_unlock(dev);
         }
     }
 
@@ -618,7 +662,9 @@ static int netdev_wifr_ioctl(FAR struct socket *psock, int cmd,
         {
           /* Just forward the IOCTL to the wireless driver */
 
+          netdev_lock(dev);
           ret = dev->d_ioctl(dev, cmd, ((unsigned long)(uintptr_t)req));
+          netdev_unlock(dev);
         }
     }
 
@@ -703,6 +749,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+              netlink_ipv4addr_notify(dev, RTM_NEWADDR);
               ret = OK;
             }
         }
@@ -807,6 +854,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
 
               ioctl_set_ipv6addr(dev->d_ipv6addr, &lreq->lifr_addr);
+              netlink_ipv6addr_notify(dev, RTM_NEWADDR);
               ret = OK;
             }
         }
@@ -1037,9 +1085,11 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
 #ifdef CONFIG_NET_IPv4
+              netlink_ipv4addr_notify(dev, RTM_DELADDR);
               dev->d_ipaddr = 0;
 #endif
 #ifdef CONFIG_NET_IPv6
+              netlink_ipv6addr_notify(dev, RTM_DELADDR);
               memset(&dev->d_ipv6addr, 0, sizeof(net_ipv6addr_t));
 #endif
               ret = OK;
@@ -1078,7 +1128,9 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev && dev->d_ioctl)
             {
               struct mii_iotcl_notify_s *notify = &req->ifr_ifru.ifru_mii_notify;
+              netdev_lock(dev);
               ret = dev->d_ioctl(dev, cmd, ((unsigned long)(uintptr_t)notify));
+              netdev_unlock(dev);
             }
         }
         break;
@@ -1092,7 +1144,9 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev && dev->d_ioctl)
             {
               struct mii_ioctl_data_s *mii_data = &req->ifr_ifru.ifru_mii_data;
+              netdev_lock(dev);
               ret = dev->d_ioctl(dev, cmd, ((unsigned long)(uintptr_t)mii_data));
+              netdev_unlock(dev);
             }
         }
         break;
@@ -1674,6 +1728,15 @@ int psock_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
     }
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Check for mmap() of the receive ring of a packet socket */
+
+  if (ret == -ENOTTY)
+    {
+      ret = pkt_ioctl(psock, cmd, arg);
+    }
+#endif
+
 #ifdef CONFIG_NET_IGMP
   /* Check for address filtering commands */
 
@@ -1704,6 +1767,52 @@ int psock_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
     }
 #endif
 
+#ifdef CONFIG_NET_IPFILTER
+  /* Check for packet filter IOCTL commands */
+
+  if (ret == -ENOTTY)
+    {
+      ret = ipfilter_ioctl(cmd, arg);
+    }
+#endif
+
+#ifdef CONFIG_NET_ZEROCOPY_RECV
+  /* Check for zero-copy receive IOCTL commands */
+
+  if (ret == -ENOTTY)
+    {
+      ret = inet_zcrecv_ioctl(psock, cmd, arg);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Changes to interface addresses, ARP entries, or routes may invalidate
+   * cached forwarding decisions.
+   */
+
+  if (ret >= 0)
+    {
+      switch (cmd)
+        {
+          case SIOCSIFADDR:
+          case SIOCSIFDSTADDR:
+          case SIOCSIFNETMASK:
+          case SIOCSIFHWADDR:
+          case SIOCDIFADDR:
+          case SIOCSIFFLAGS:
+          case SIOCSARP:
+          case SIOCDARP:
+          case SIOCADDRT:
+          case SIOCDELRT:
+            ipv4_flowcache_flush();
+            break;
+
+          default:
+            break;
+        }
+    }
+#endif
+
   return ret;
 }
 
@@ -1761,6 +1870,7 @@ void netdev_ifup(FAR struct net_driver_s *dev)
     {
       /* Is the interface already up? */
 
+      netdev_lock(dev);
       if ((dev->d_flags & IFF_UP) == 0)
         {
           /* No, bring the interface up now */
@@ -1770,8 +1880,11 @@ void netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              netlink_link_notify(dev, RTM_NEWLINK);
             }
         }
+
+      netdev_unlock(dev);
     }
 }
 
@@ -1783,6 +1896,7 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
     {
       /* Is the interface already down? */
 
+      netdev_lock(dev);
       if ((dev->d_flags & IFF_UP) != 0)
         {
           /* No, take the interface down now */
@@ -1792,9 +1906,12 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~IFF_UP;
+              netlink_link_notify(dev, RTM_NEWLINK);
             }
         }
 
+      netdev_unlock(dev);
+
       /* Notify clients that the network has been taken down */
 
       (void)devif_dev_event(dev, NULL, NETDEV_DOWN);
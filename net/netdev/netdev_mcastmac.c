@@ -0,0 +1,210 @@
+/****************************************************************************
+ * net/netdev/netdev_mcastmac.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NET_MCASTGROUP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One multicast MAC address in the filter of a device.  Several multicast
+ * groups may map to the same MAC address.
+ */
+
+struct netdev_mcastmac_s
+{
+  FAR struct netdev_mcastmac_s *flink;
+  uint16_t refs;                /* Number of groups using the address */
+  uint8_t mac[6];               /* The multicast MAC address */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_findmcastmac
+ *
+ * Description:
+ *   Find a multicast MAC address in the filter list of the device.
+ *
+ ****************************************************************************/
+
+static FAR struct netdev_mcastmac_s *
+  netdev_findmcastmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
+{
+  FAR struct netdev_mcastmac_s *entry;
+
+  for (entry = (FAR struct netdev_mcastmac_s *)sq_peek(&dev->d_mcastmacs);
+       entry != NULL;
+       entry = entry->flink)
+    {
+      if (memcmp(entry->mac, mac, sizeof(entry->mac)) == 0)
+        {
+          break;
+        }
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_addmcastmac
+ *
+ * Description:
+ *   Take a reference to a multicast MAC address in the MAC filter of the
+ *   device.  The driver's d_addmac() is called only for the first
+ *   reference.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   mac - The multicast MAC address
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_addmcastmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
+{
+  FAR struct netdev_mcastmac_s *entry;
+
+  entry = netdev_findmcastmac(dev, mac);
+  if (entry != NULL)
+    {
+      /* Some other group already uses this address */
+
+      entry->refs++;
+      return OK;
+    }
+
+  entry = (FAR struct netdev_mcastmac_s *)
+    kmm_malloc(sizeof(struct netdev_mcastmac_s));
+  if (entry == NULL)
+    {
+      nerr("ERROR: Failed to allocate a MAC filter entry\n");
+      return -ENOMEM;
+    }
+
+  memcpy(entry->mac, mac, sizeof(entry->mac));
+  entry->refs = 1;
+  sq_addlast((FAR sq_entry_t *)entry, &dev->d_mcastmacs);
+
+  return dev->d_addmac != NULL ? dev->d_addmac(dev, mac) : OK;
+}
+
+/****************************************************************************
+ * Name: netdev_rmmcastmac
+ *
+ * Description:
+ *   Drop a reference to a multicast MAC address in the MAC filter of the
+ *   device.  The driver's d_rmmac() is called only for the last reference.
+ *   Then all remaining addresses are added to the filter again:  Drivers
+ *   that program a hash filter cannot tell whether the hash bit of the
+ *   removed address is still needed by another address.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   mac - The multicast MAC address
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_rmmcastmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
+{
+  FAR struct netdev_mcastmac_s *entry;
+  int ret = OK;
+
+  entry = netdev_findmcastmac(dev, mac);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (--entry->refs > 0)
+    {
+      return OK;
+    }
+
+  sq_rem((FAR sq_entry_t *)entry, &dev->d_mcastmacs);
+  kmm_free(entry);
+
+  if (dev->d_rmmac != NULL)
+    {
+      ret = dev->d_rmmac(dev, mac);
+    }
+
+  if (dev->d_addmac != NULL)
+    {
+      entry = (FAR struct netdev_mcastmac_s *)sq_peek(&dev->d_mcastmacs);
+      for (; entry != NULL; entry = entry->flink)
+        {
+          (void)dev->d_addmac(dev, entry->mac);
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_MCASTGROUP */
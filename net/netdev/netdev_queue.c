@@ -0,0 +1,524 @@
+/****************************************************************************
+ * net/netdev/netdev_queue.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/sched.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHBUF ((FAR struct eth_hdr_s *)dev->d_buf)
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_mix
+ *
+ * Description:
+ *   Mix the bits of a 32-bit value (the MurmurHash3 finalizer).
+ *
+ ****************************************************************************/
+
+static uint32_t netdev_mix(uint32_t value)
+{
+  value ^= value >> 16;
+  value *= 0x85ebca6b;
+  value ^= value >> 13;
+  value *= 0xc2b2ae35;
+  value ^= value >> 16;
+  return value;
+}
+
+/****************************************************************************
+ * Name: netdev_hashaddr
+ *
+ * Description:
+ *   Hash an IP address held as an array of 16-bit values.
+ *
+ ****************************************************************************/
+
+static uint32_t netdev_hashaddr(FAR const uint16_t *addr, int nwords)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < nwords; i += 2)
+    {
+      hash = netdev_mix(hash ^ ((uint32_t)addr[i] << 16 | addr[i + 1]));
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_thread
+ *
+ * Description:
+ *   The thread of one queue.  It waits to be woken up by
+ *   netdev_queue_schedule(), then services the queue in passes of
+ *   CONFIG_NETDEV_QUEUE_BUDGET frames until a pass uses less than the
+ *   whole budget, and finally unmasks the interrupts of the queue.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments
+ *   argv - argv[1] holds the address of the queue structure in hex
+ *
+ * Returned Value:
+ *   Zero (OK) when the thread is stopped.
+ *
+ ****************************************************************************/
+
+static int netdev_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct netdev_queue_s *nq;
+  int nrecvd;
+
+  DEBUGASSERT(argc > 1 && argv[1] != NULL);
+  nq = (FAR struct netdev_queue_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+  while (!nq->nq_stop)
+    {
+      (void)nxsem_wait(&nq->nq_sem);
+
+      while (!nq->nq_stop)
+        {
+          nrecvd = 0;
+          if (nq->nq_poll != NULL)
+            {
+              nrecvd = nq->nq_poll(nq, CONFIG_NETDEV_QUEUE_BUDGET);
+            }
+
+#ifdef CONFIG_NETDEV_RFS
+          if (nrecvd < CONFIG_NETDEV_QUEUE_BUDGET)
+            {
+              nrecvd += netdev_rfs_process(nq,
+                                           CONFIG_NETDEV_QUEUE_BUDGET -
+                                           nrecvd);
+            }
+#endif
+
+          if (nrecvd < CONFIG_NETDEV_QUEUE_BUDGET)
+            {
+              break;
+            }
+
+          /* There may be more frames.  Let other threads of the same
+           * priority run before the next pass.
+           */
+
+          (void)sched_yield();
+        }
+
+      /* Clear the flag before unmasking the interrupts so that an
+       * interrupt that follows immediately will wake up the thread again.
+       */
+
+      nq->nq_scheduled = false;
+
+      if (nq->nq_enable != NULL && !nq->nq_stop)
+        {
+          nq->nq_enable(nq);
+        }
+
+#ifdef CONFIG_NETDEV_RFS
+      /* A frame may have been steered to this queue after the last pass
+       * but before the flag was cleared.
+       */
+
+      if (netdev_rfs_pending(nq))
+        {
+          netdev_queue_schedule(nq);
+        }
+#endif
+    }
+
+#ifdef CONFIG_NETDEV_RFS
+  netdev_rfs_discard(nq);
+#endif
+
+  nq->nq_pid = INVALID_PROCESS_ID;
+  (void)nxsem_post(&nq->nq_exitsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_queue_start
+ *
+ * Description:
+ *   Start one kernel thread for each queue of a multi-queue network device.
+ *   In an SMP configuration, the thread of queue n is bound to CPU
+ *   n % CONFIG_SMP_NCPUS.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   queues  - An array of nqueues queue structures
+ *   nqueues - The number of queues
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  No thread is
+ *   left running on failure.
+ *
+ ****************************************************************************/
+
+int netdev_queue_start(FAR struct net_driver_s *dev,
+                       FAR struct netdev_queue_s *queues, int nqueues)
+{
+  FAR struct netdev_queue_s *nq;
+  FAR char *argv[2];
+  char arg[2 * sizeof(uintptr_t) + 1];
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+  int ret;
+#endif
+  int i;
+
+  DEBUGASSERT(dev != NULL && queues != NULL && nqueues > 0 &&
+              nqueues <= UINT8_MAX && dev->d_queues == NULL);
+
+  dev->d_queues  = queues;
+  dev->d_nqueues = 0;
+
+  for (i = 0; i < nqueues; i++)
+    {
+      nq               = &queues[i];
+      nq->nq_dev       = dev;
+      nq->nq_index     = i;
+      nq->nq_scheduled = false;
+      nq->nq_stop      = false;
+#ifdef CONFIG_NETDEV_RFS
+      nq->nq_head      = 0;
+      nq->nq_tail      = 0;
+#endif
+
+      /* The semaphores are used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      (void)nxsem_init(&nq->nq_sem, 0, 0);
+      (void)nxsem_setprotocol(&nq->nq_sem, SEM_PRIO_NONE);
+      (void)nxsem_init(&nq->nq_exitsem, 0, 0);
+      (void)nxsem_setprotocol(&nq->nq_exitsem, SEM_PRIO_NONE);
+
+      snprintf(arg, sizeof(arg), "%lx", (unsigned long)(uintptr_t)nq);
+      argv[0] = arg;
+      argv[1] = NULL;
+
+      nq->nq_pid = kthread_create("netqueue", CONFIG_NETDEV_QUEUE_PRIORITY,
+                                  CONFIG_NETDEV_QUEUE_STACKSIZE,
+                                  (main_t)netdev_queue_thread,
+                                  (FAR char * const *)argv);
+      if (nq->nq_pid < 0)
+        {
+          int errcode = nq->nq_pid;
+
+          nerr("ERROR: Failed to start queue %d thread: %d\n", i, errcode);
+          nxsem_destroy(&nq->nq_sem);
+          nxsem_destroy(&nq->nq_exitsem);
+          netdev_queue_stop(dev);
+          return errcode;
+        }
+
+      dev->d_nqueues++;
+
+#ifdef CONFIG_SMP
+      /* Bind the thread to its CPU so that the queue state stays in the
+       * cache of that CPU.
+       */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(i % CONFIG_SMP_NCPUS, &cpuset);
+
+      ret = nxsched_setaffinity(nq->nq_pid, sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          nwarn("WARNING: Failed to bind queue %d to CPU %d: %d\n",
+                i, i % CONFIG_SMP_NCPUS, ret);
+        }
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_stop
+ *
+ * Description:
+ *   Stop the queue threads started by netdev_queue_start() and wait for
+ *   them to exit.  The network lock, if held, is released while waiting.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_queue_stop(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_queue_s *nq;
+  int i;
+
+  DEBUGASSERT(dev != NULL);
+
+  for (i = 0; i < dev->d_nqueues; i++)
+    {
+      nq = &dev->d_queues[i];
+      nq->nq_stop = true;
+      (void)nxsem_post(&nq->nq_sem);
+    }
+
+  for (i = 0; i < dev->d_nqueues; i++)
+    {
+      nq = &dev->d_queues[i];
+      while (nq->nq_pid != INVALID_PROCESS_ID)
+        {
+          (void)net_lockedwait(&nq->nq_exitsem);
+        }
+
+      nxsem_destroy(&nq->nq_sem);
+      nxsem_destroy(&nq->nq_exitsem);
+    }
+
+  dev->d_queues  = NULL;
+  dev->d_nqueues = 0;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_schedule
+ *
+ * Description:
+ *   Wake up the thread of a queue.  This is normally called from the
+ *   interrupt handler of the queue after its interrupts have been masked.
+ *
+ * Input Parameters:
+ *   nq - The queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_queue_schedule(FAR struct netdev_queue_s *nq)
+{
+  DEBUGASSERT(nq != NULL);
+
+  /* Two callers racing here at most cause one extra, empty pass */
+
+  if (!nq->nq_scheduled)
+    {
+      nq->nq_scheduled = true;
+      (void)nxsem_post(&nq->nq_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Calculate a hash over the IP addresses and, for TCP and UDP, the port
+ *   numbers of the IPv4 or IPv6 packet in d_buf.  Both directions of a
+ *   flow give the same hash.
+ *
+ * Input Parameters:
+ *   dev - The network device holding the packet in d_buf
+ *
+ * Returned Value:
+ *   The hash value.  All frames that are not IP packets give zero.
+ *
+ ****************************************************************************/
+
+uint32_t netdev_flowhash(FAR struct net_driver_s *dev)
+{
+  FAR const uint16_t *ports = NULL;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int iphdrlen;
+  uint32_t hash;
+  uint8_t version;
+  uint8_t proto;
+
+  if (dev->d_len < llhdrlen + 1)
+    {
+      return 0;
+    }
+
+  /* Determine the IP version from the Ethernet type or, for other link
+   * layers, from the IP header itself.
+   */
+
+  version = dev->d_buf[llhdrlen] >> 4;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET || dev->d_lltype == NET_LL_IEEE80211)
+    {
+      if (ETHBUF->type == HTONS(ETHTYPE_IP))
+        {
+          version = 4;
+        }
+      else if (ETHBUF->type == HTONS(ETHTYPE_IP6))
+        {
+          version = 6;
+        }
+      else
+        {
+          return 0;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (version == 4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      iphdrlen = (ipv4->vhl & 0x0f) << 2;
+      if (dev->d_len < llhdrlen + iphdrlen + 4)
+        {
+          return 0;
+        }
+
+      /* The fragments of a packet must give the same hash, but only the
+       * first fragment holds the port numbers.
+       */
+
+      proto = ipv4->proto;
+      if ((ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0)
+        {
+          ports = (FAR const uint16_t *)&dev->d_buf[llhdrlen + iphdrlen];
+        }
+
+      hash = netdev_hashaddr(ipv4->srcipaddr, 2) +
+             netdev_hashaddr(ipv4->destipaddr, 2);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (version == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      /* Extension headers are not followed:  Such packets are hashed on
+       * the addresses alone.
+       */
+
+      iphdrlen = IPv6_HDRLEN;
+      if (dev->d_len < llhdrlen + iphdrlen + 4)
+        {
+          return 0;
+        }
+
+      proto = ipv6->proto;
+      ports = (FAR const uint16_t *)&dev->d_buf[llhdrlen + iphdrlen];
+      hash  = netdev_hashaddr(ipv6->srcipaddr, 8) +
+              netdev_hashaddr(ipv6->destipaddr, 8);
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  if (ports != NULL && (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP))
+    {
+      /* The sum of the hashes does not depend on the direction */
+
+      hash += netdev_mix(ports[0]) + netdev_mix(ports[1]);
+    }
+
+  return netdev_mix(hash ^ proto);
+}
+
+/****************************************************************************
+ * Name: netdev_queue_select
+ *
+ * Description:
+ *   Select the queue for the frame in d_buf using netdev_flowhash().
+ *
+ * Input Parameters:
+ *   dev - The network device holding the packet in d_buf
+ *
+ * Returned Value:
+ *   The selected queue or NULL if the device has no queues.
+ *
+ ****************************************************************************/
+
+FAR struct netdev_queue_s *netdev_queue_select(FAR struct net_driver_s *dev)
+{
+  if (dev->d_nqueues == 0)
+    {
+      return NULL;
+    }
+
+  return &dev->d_queues[netdev_flowhash(dev) % dev->d_nqueues];
+}
+
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
@@ -50,6 +50,7 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
@@ -59,6 +60,7 @@
 #include "igmp/igmp.h"
 #include "mld/mld.h"
 #include "netdev/netdev.h"
+#include "netlink/netlink.h"
 
 #if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
 
@@ -97,6 +99,10 @@
 
 struct net_driver_s *g_netdevices = NULL;
 
+/* Protects look-ups in g_netdevices that do not lock the network */
+
+struct rcu_s g_netdev_rcu = RCU_INITIALIZER;
+
 #ifdef CONFIG_NETDEV_IFINDEX
 /* The set of network devices that have been registered.  This is used to
  * assign a unique device index to the newly registered device.
@@ -345,6 +351,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+      /* Initialize the device lock */
+
+      net_rlock_init(&dev->d_lock);
+
       /* We need exclusive access for the following operations */
 
       net_lock();
@@ -406,11 +416,22 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       snprintf(dev->d_ifname, IFNAMSIZ, devfmt, devnum);
 
-      /* Add the device to the list of known network devices */
+      /* Add the device to the list of known network devices.  The device
+       * must be completely linked before readers can see it.
+       */
 
       dev->flink  = g_netdevices;
+#ifdef CONFIG_SPINLOCK
+      SP_DMB();
+#endif
       g_netdevices = dev;
 
+#ifdef CONFIG_NET_MCASTGROUP
+      /* The multicast MAC filter is initially empty */
+
+      sq_init(&dev->d_mcastmacs);
+#endif
+
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
 
@@ -423,6 +444,7 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       mld_devinit(dev);
 #endif
 
+      netlink_link_notify(dev, RTM_NEWLINK);
       net_unlock();
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
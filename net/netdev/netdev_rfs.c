@@ -0,0 +1,252 @@
+/****************************************************************************
+ * net/netdev/netdev_rfs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_RFS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rfs_dequeue
+ *
+ * Description:
+ *   Remove the oldest frame from the backlog of a queue.
+ *
+ * Returned Value:
+ *   The I/O buffer chain holding the frame or NULL if the backlog is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *netdev_rfs_dequeue(FAR struct netdev_queue_s *nq)
+{
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (nq->nq_tail != nq->nq_head)
+    {
+      iob = nq->nq_backlog[nq->nq_tail];
+      if (++nq->nq_tail >= CONFIG_NETDEV_RFS_BACKLOG)
+        {
+          nq->nq_tail = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rfs_steer
+ *
+ * Description:
+ *   Copy the frame in d_buf into an I/O buffer chain and queue it to the
+ *   thread of the queue selected by netdev_queue_select().
+ *
+ * Input Parameters:
+ *   dev - The network device holding the received frame in d_buf
+ *
+ * Returned Value:
+ *   Zero (OK) if the frame was queued; d_len is then zero.  A negated
+ *   errno value if it could not be queued.
+ *
+ ****************************************************************************/
+
+int netdev_rfs_steer(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_queue_s *nq;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  uint16_t head;
+  int ret;
+
+  nq = netdev_queue_select(dev);
+  if (nq == NULL || nq->nq_input == NULL || dev->d_len > nq->nq_bufsize)
+    {
+      return -ENOSYS;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, dev->d_buf, dev->d_len, 0, false);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  head = nq->nq_head + 1;
+  if (head >= CONFIG_NETDEV_RFS_BACKLOG)
+    {
+      head = 0;
+    }
+
+  if (head == nq->nq_tail)
+    {
+      /* The backlog is full:  The queue thread is not keeping up */
+
+      leave_critical_section(flags);
+      iob_free_chain(iob);
+      return -ENOBUFS;
+    }
+
+  nq->nq_backlog[nq->nq_head] = iob;
+  nq->nq_head = head;
+  leave_critical_section(flags);
+
+  dev->d_len = 0;
+  netdev_queue_schedule(nq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_rfs_process
+ *
+ * Description:
+ *   Pass up to 'budget' frames steered to a queue to the driver's
+ *   nq_input().
+ *
+ * Input Parameters:
+ *   nq     - The queue
+ *   budget - The maximum number of frames to process
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ * Assumptions:
+ *   Called on the queue thread with the network unlocked.
+ *
+ ****************************************************************************/
+
+int netdev_rfs_process(FAR struct netdev_queue_s *nq, int budget)
+{
+  FAR struct net_driver_s *dev = nq->nq_dev;
+  FAR struct iob_s *iob;
+  FAR uint8_t *buf;
+  int nprocessed;
+
+  for (nprocessed = 0; nprocessed < budget; nprocessed++)
+    {
+      iob = netdev_rfs_dequeue(nq);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      /* Process the frame in the buffer of this queue.  The device's own
+       * d_buf is restored before the network is unlocked.
+       */
+
+      net_lock();
+
+      buf        = dev->d_buf;
+      dev->d_buf = nq->nq_buf;
+      dev->d_len = iob_copyout(nq->nq_buf, iob, iob->io_pktlen, 0);
+
+      nq->nq_input(nq);
+
+      dev->d_buf = buf;
+      dev->d_len = 0;
+
+      net_unlock();
+      iob_free_chain(iob);
+    }
+
+  return nprocessed;
+}
+
+/****************************************************************************
+ * Name: netdev_rfs_pending
+ *
+ * Description:
+ *   Return true if frames have been steered to the queue and are not yet
+ *   processed.
+ *
+ ****************************************************************************/
+
+bool netdev_rfs_pending(FAR struct netdev_queue_s *nq)
+{
+  return nq->nq_head != nq->nq_tail;
+}
+
+/****************************************************************************
+ * Name: netdev_rfs_discard
+ *
+ * Description:
+ *   Free all frames steered to the queue that are not yet processed.
+ *
+ ****************************************************************************/
+
+void netdev_rfs_discard(FAR struct netdev_queue_s *nq)
+{
+  FAR struct iob_s *iob;
+
+  while ((iob = netdev_rfs_dequeue(nq)) != NULL)
+    {
+      iob_free_chain(iob);
+    }
+}
+
+#endif /* CONFIG_NETDEV_RFS */
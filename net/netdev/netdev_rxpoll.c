@@ -0,0 +1,197 @@
+/****************************************************************************
+ * net/netdev/netdev_rxpoll.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_RXPOLL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_work
+ *
+ * Description:
+ *   Receive up to CONFIG_NETDEV_RXPOLL_BUDGET frames.  If the whole budget
+ *   was used, there may be more frames:  Queue the work again so that other
+ *   work on the same worker thread gets a chance to run in between.
+ *   Otherwise the ring is empty and RX interrupts are unmasked.
+ *
+ * Input Parameters:
+ *   arg - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on a worker thread.
+ *
+ ****************************************************************************/
+
+static void netdev_rxpoll_work(FAR void *arg)
+{
+  FAR struct netdev_rxpoll_s *rp = (FAR struct netdev_rxpoll_s *)arg;
+  FAR struct net_driver_s *dev = rp->rp_dev;
+  int nrecvd;
+
+  net_lock();
+  nrecvd = rp->rp_poll(dev, CONFIG_NETDEV_RXPOLL_BUDGET);
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Don't hold aggregated data across passes */
+
+  netdev_gro_flush(rp);
+#endif
+
+  net_unlock();
+
+  if (nrecvd >= CONFIG_NETDEV_RXPOLL_BUDGET)
+    {
+      (void)work_queue(rp->rp_qid, &rp->rp_work, netdev_rxpoll_work, rp, 0);
+      return;
+    }
+
+  /* Clear the flag before unmasking RX interrupts so that an interrupt
+   * that follows immediately will schedule the work again.
+   */
+
+  rp->rp_scheduled = false;
+  rp->rp_enable(dev);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_initialize
+ *
+ * Description:
+ *   Initialize the RX polling state of a network device.  rp_poll and
+ *   rp_enable (and, with CONFIG_NETDEV_GRO, rp_reply, rp_grobuf, and
+ *   rp_grosize) must be set by the driver, before or after this call.
+ *
+ * Input Parameters:
+ *   rp  - The RX polling state to initialize
+ *   dev - The network device
+ *   qid - The work queue to poll on (HPWORK or LPWORK)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rp,
+                              FAR struct net_driver_s *dev, int qid)
+{
+  DEBUGASSERT(rp != NULL && dev != NULL);
+
+  rp->rp_dev       = dev;
+  rp->rp_qid       = qid;
+  rp->rp_scheduled = false;
+
+#ifdef CONFIG_NETDEV_GRO
+  rp->rp_grolen    = 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_schedule
+ *
+ * Description:
+ *   Schedule RX polling.  This is normally called from the RX interrupt
+ *   handler after RX interrupts have been masked.  They remain masked until
+ *   rp_enable() is called.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rp)
+{
+  DEBUGASSERT(rp != NULL && rp->rp_poll != NULL && rp->rp_enable != NULL);
+
+  if (!rp->rp_scheduled)
+    {
+      rp->rp_scheduled = true;
+      (void)work_queue(rp->rp_qid, &rp->rp_work, netdev_rxpoll_work, rp, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_cancel
+ *
+ * Description:
+ *   Cancel any pending RX polling, for example when the interface is
+ *   brought down.  RX interrupts are left masked.
+ *
+ * Input Parameters:
+ *   rp - The RX polling state of the device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rp)
+{
+  DEBUGASSERT(rp != NULL);
+
+  (void)work_cancel(rp->rp_qid, &rp->rp_work);
+  rp->rp_scheduled = false;
+
+#ifdef CONFIG_NETDEV_GRO
+  rp->rp_grolen = 0;
+#endif
+}
+
+#endif /* CONFIG_NETDEV_RXPOLL */
@@ -0,0 +1,200 @@
+/****************************************************************************
+ * net/netdev/netdev_txsegs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_SGTX
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txsegs
+ *
+ * Description:
+ *   Describe the outgoing frame of length d_len as a list of memory regions
+ *   for a driver that supports scatter-gather transmit (d_sgmax > 0).  The
+ *   first region is always the start of d_buf.  If the application data of
+ *   the frame was left in an I/O buffer chain, then one further region is
+ *   returned for each I/O buffer holding part of it.  If it was left in
+ *   place by devif_ref_send(), then one further region refers to it.  The driver must not
+ *   assume that the data is in d_buf and must later release the regions
+ *   with netdev_txsegs_release(), normally when the transmission completes.
+ *
+ * Input Parameters:
+ *   dev  - The network device with an outgoing frame in d_buf (d_len > 0)
+ *   segs - An array of at least d_sgmax entries to receive the regions
+ *
+ * Returned Value:
+ *   The number of regions returned in segs[].
+ *
+ * Assumptions:
+ *   Called with the network locked, immediately after the network has
+ *   provided the frame.
+ *
+ ****************************************************************************/
+
+int netdev_txsegs(FAR struct net_driver_s *dev,
+                  FAR struct netdev_txseg_s *segs)
+{
+  FAR struct iob_s *iob;
+  unsigned int remaining;
+  unsigned int offset;
+  unsigned int seglen;
+  int nsegs;
+
+  DEBUGASSERT(dev != NULL && segs != NULL && dev->d_sgmax > 0 &&
+              dev->d_len > 0);
+
+  /* The first region holds the headers (or the whole frame) in d_buf */
+
+  segs[0].ts_data = dev->d_buf;
+  segs[0].ts_len  = dev->d_len;
+  segs[0].ts_iob  = NULL;
+  nsegs           = 1;
+
+  if (dev->d_iob != NULL && dev->d_sndlen > 0)
+    {
+      DEBUGASSERT(dev->d_len > dev->d_sndlen);
+      segs[0].ts_len = dev->d_len - dev->d_sndlen;
+
+      /* Then add one region for the part of the application data in each
+       * I/O buffer.  devif_iob_send() has already verified that there are
+       * enough regions.
+       */
+
+      remaining = dev->d_sndlen;
+      offset    = dev->d_iobofs;
+
+      for (iob = dev->d_iob;
+           iob != NULL && remaining > 0;
+           iob = iob->io_flink)
+        {
+          if (offset >= iob->io_len)
+            {
+              offset -= iob->io_len;
+              continue;
+            }
+
+          seglen = iob->io_len - offset;
+          if (seglen > remaining)
+            {
+              seglen = remaining;
+            }
+
+          DEBUGASSERT(nsegs < dev->d_sgmax);
+
+          /* The I/O buffer may be freed by its owner before the driver is
+           * finished with it.  Keep a reference until it is released.
+           */
+
+          iob_addref(iob);
+
+          segs[nsegs].ts_data = IOB_DATA(iob) + offset;
+          segs[nsegs].ts_len  = seglen;
+          segs[nsegs].ts_iob  = iob;
+          nsegs++;
+
+          remaining -= seglen;
+          offset     = 0;
+        }
+
+      DEBUGASSERT(remaining == 0);
+    }
+  else if (dev->d_sndref != NULL && dev->d_sndlen > 0)
+    {
+      /* The application data was left in place by devif_ref_send().  The
+       * owner of that memory keeps it valid until the transmission is
+       * complete, so no reference is needed.
+       */
+
+      DEBUGASSERT(dev->d_len > dev->d_sndlen && dev->d_sgmax > 1);
+      segs[0].ts_len = dev->d_len - dev->d_sndlen;
+
+      segs[1].ts_data = dev->d_sndref;
+      segs[1].ts_len  = dev->d_sndlen;
+      segs[1].ts_iob  = NULL;
+      nsegs           = 2;
+    }
+
+  /* The application data has been handed over to the driver */
+
+  dev->d_iob    = NULL;
+  dev->d_sndref = NULL;
+  return nsegs;
+}
+
+/****************************************************************************
+ * Name: netdev_txsegs_release
+ *
+ * Description:
+ *   Release the I/O buffer references held by regions returned by
+ *   netdev_txsegs().  This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   segs  - The regions returned by netdev_txsegs()
+ *   nsegs - The number of regions
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_txsegs_release(FAR struct netdev_txseg_s *segs, int nsegs)
+{
+  int i;
+
+  for (i = 0; i < nsegs; i++)
+    {
+      if (segs[i].ts_iob != NULL)
+        {
+          iob_unref(segs[i].ts_iob);
+          segs[i].ts_iob = NULL;
+        }
+    }
+}
+
+#endif /* CONFIG_NETDEV_SGTX */
@@ -54,6 +54,8 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+#include "netlink/netlink.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -159,14 +161,30 @@ int netdev_unregister(FAR struct net_driver_s *dev)
                g_netdevices = curr->flink;
             }
 
-          curr->flink = NULL;
+          /* Leave curr->flink intact for now:  A look-up may be walking
+           * through this device.
+           */
+
+          netlink_link_notify(dev, RTM_DELLINK);
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
+
+      /* The forwarding flow cache may refer to the device */
+
+      ipv4_flowcache_flush();
       net_unlock();
 
+      /* Wait until no look-up can still be referring to the device */
+
+      if (curr)
+        {
+          nxrcu_synchronize(&g_netdev_rcu);
+          curr->flink = NULL;
+        }
+
 #ifdef CONFIG_NET_ETHERNET
       ninfo("Unregistered MAC: %02x:%02x:%02x:%02x:%02x:%02x as dev: %s\n",
             dev->d_mac.ether.ether_addr_octet[0],
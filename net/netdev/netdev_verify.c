@@ -65,10 +65,11 @@ bool netdev_verify(FAR struct net_driver_s *dev)
 {
   FAR struct net_driver_s *chkdev;
   bool valid = false;
+  int phase;
 
   /* Search the list of registered devices */
 
-  net_lock();
+  phase = nxrcu_read_lock(&g_netdev_rcu);
   for (chkdev = g_netdevices; chkdev != NULL; chkdev = chkdev->flink)
     {
       /* Is the network device that we are looking for? */
@@ -82,6 +83,6 @@ bool netdev_verify(FAR struct net_driver_s *dev)
         }
     }
 
-  net_unlock();
+  nxrcu_read_unlock(&g_netdev_rcu, phase);
   return valid;
 }
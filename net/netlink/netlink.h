@@ -43,9 +43,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <semaphore.h>
 
+#include <netinet/in.h>
+#include <netpacket/netlink.h>
+
 #include "devif/devif.h"
 #include "socket/socket.h"
 
@@ -55,14 +59,41 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The message data follows the netlink_response_s header */
+
+#define NETLINK_RESP_DATA(r) ((FAR uint8_t *)((FAR char *)(r) + \
+                              sizeof(struct netlink_response_s)))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* One queued datagram.  This holds one or more netlink messages (a dump
+ * response is returned in batches).
+ */
+
+struct netlink_response_s
+{
+  sq_entry_t flink;                  /* Supports a singly linked list */
+  uint16_t   len;                    /* Number of bytes of message data */
+  bool       mcast;                  /* A multicast notification */
+                                     /* Message data follows */
+};
+
 struct netlink_conn_s
 {
   dq_entry_t node;                   /* Supports a doubly linked list */
+  uint32_t   pid;                    /* Port ID (if bound) */
+  uint32_t   groups;                 /* Multicast groups (if bound) */
   uint8_t    crefs;                  /* Reference counts on this instance */
+  uint8_t    protocol;               /* NETLINK_ROUTE, etc. */
+  uint8_t    nmcast;                 /* Number of queued notifications */
+  bool       overrun;                /* Notifications were dropped */
+  sem_t      waitsem;                /* Waits for a response */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *pollfd;         /* poll() waiter */
+#endif
+  sq_queue_t resplist;               /* Queued responses */
 
   /* Defines the list of netlink callbacks */
 
@@ -147,10 +178,148 @@ FAR struct netlink_conn_s *netlink_nextconn(FAR struct netlink_conn_s *conn);
 struct sockaddr_nl;  /* Forward reference */
 FAR struct netlink_conn_s *netlink_active(FAR struct sockaddr_nl *addr);
 
+/****************************************************************************
+ * Name: netlink_alloc_response
+ *
+ * Description:
+ *   Allocate a response container with room for 'len' bytes of message
+ *   data.  The length of the response is initially zero.
+ *
+ * Returned Value:
+ *   The new response or NULL if memory could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *netlink_alloc_response(size_t len);
+
+/****************************************************************************
+ * Name: netlink_add_response
+ *
+ * Description:
+ *   Queue a response on a netlink connection and wake up any thread that
+ *   is waiting to receive it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void netlink_add_response(FAR struct netlink_conn_s *conn,
+                          FAR struct netlink_response_s *resp);
+
+/****************************************************************************
+ * Name: netlink_add_broadcast
+ *
+ * Description:
+ *   Send a copy of a multicast notification to each netlink connection of
+ *   the given protocol that is a member of the multicast group.  Nothing
+ *   is sent when called from an interrupt handler since no memory can be
+ *   allocated.
+ *
+ * Input Parameters:
+ *   protocol - The netlink protocol (NETLINK_ROUTE, etc.)
+ *   group    - The multicast group mask (RTMGRP_LINK, etc.)
+ *   data     - The netlink message(s) to send
+ *   len      - The length of the message data
+ *
+ ****************************************************************************/
+
+void netlink_add_broadcast(int protocol, uint32_t group,
+                           FAR const void *data, size_t len);
+
+/****************************************************************************
+ * Name: netlink_get_response
+ *
+ * Description:
+ *   Remove the next response from the connection, waiting for one if the
+ *   queue is empty and 'nonblock' is false.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success with the response in *presp.  The
+ *   caller must kmm_free() it.  A negated errno value is returned on any
+ *   failure:  -EAGAIN if there is no response and 'nonblock' is true and
+ *   -ENOBUFS (once) if multicast notifications were dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netlink_get_response(FAR struct netlink_conn_s *conn, bool nonblock,
+                         FAR struct netlink_response_s **presp);
+
+/****************************************************************************
+ * Name: netlink_route_sendto
+ *
+ * Description:
+ *   Perform the NETLINK_ROUTE requests in a buffer sent to the kernel.
+ *   Responses are queued on the connection.
+ *
+ * Input Parameters:
+ *   conn - The netlink connection
+ *   buf  - The buffer holding one or more netlink request messages
+ *   len  - The length of the buffer
+ *
+ * Returned Value:
+ *   The number of bytes consumed or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_ROUTE
+ssize_t netlink_route_sendto(FAR struct netlink_conn_s *conn,
+                             FAR const void *buf, size_t len);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
 #endif
 
 #endif /* CONFIG_NET_NETLINK */
+
+/****************************************************************************
+ * Name: netlink_link_notify, netlink_ipv4addr_notify,
+ *       netlink_ipv6addr_notify, netlink_ipv4route_notify,
+ *       netlink_ipv6route_notify, and netlink_neigh_notify
+ *
+ * Description:
+ *   Tell NETLINK_ROUTE sockets that are members of the corresponding
+ *   RTMGRP_* multicast group about a change of the network state.  These
+ *   are called by the network logic that makes the change.
+ *
+ * Input Parameters:
+ *   type - The notification message type:  RTM_NEWLINK, RTM_DELLINK, etc.
+ *   dev  - The network device (may be NULL for a neighbor notification)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETLINK_ROUTE
+struct net_driver_s; /* Forward reference */
+
+void netlink_link_notify(FAR struct net_driver_s *dev, int type);
+#ifdef CONFIG_NET_IPv4
+void netlink_ipv4addr_notify(FAR struct net_driver_s *dev, int type);
+void netlink_ipv4route_notify(int type, in_addr_t target,
+                              in_addr_t netmask, in_addr_t router);
+#endif
+#ifdef CONFIG_NET_IPv6
+void netlink_ipv6addr_notify(FAR struct net_driver_s *dev, int type);
+void netlink_ipv6route_notify(int type, FAR const uint16_t *target,
+                              FAR const uint16_t *netmask,
+                              FAR const uint16_t *router);
+#endif
+void netlink_neigh_notify(FAR struct net_driver_s *dev, int type,
+                          sa_family_t family, FAR const void *ipaddr,
+                          FAR const uint8_t *lladdr, uint8_t lladdrlen);
+#else
+#  define netlink_link_notify(d,t)
+#  define netlink_ipv4addr_notify(d,t)
+#  define netlink_ipv4route_notify(t,a,m,r)
+#  define netlink_ipv6addr_notify(d,t)
+#  define netlink_ipv6route_notify(t,a,m,r)
+#  define netlink_neigh_notify(d,t,f,a,l,n)
+#endif
 #endif /* __NET_NETLINK_NETLINK_H */
@@ -41,12 +41,15 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <arch/irq.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -105,6 +108,37 @@ static void _netlink_semgive(FAR sem_t *sem)
   (void)nxsem_post(sem);
 }
 
+/****************************************************************************
+ * Name: netlink_notify_waiter
+ *
+ * Description:
+ *   Wake up a thread waiting in recvfrom() or poll() for a response.
+ *
+ ****************************************************************************/
+
+static void netlink_notify_waiter(FAR struct netlink_conn_s *conn)
+{
+  int sval;
+
+  if (nxsem_getvalue(&conn->waitsem, &sval) >= 0 && sval < 0)
+    {
+      (void)nxsem_post(&conn->waitsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  if (conn->pollfd != NULL)
+    {
+      FAR struct pollfd *fds = conn->pollfd;
+
+      fds->revents |= (fds->events & POLLIN);
+      if (fds->revents != 0)
+        {
+          (void)nxsem_post(fds->sem);
+        }
+    }
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -162,6 +196,13 @@ FAR struct netlink_conn_s *netlink_alloc(void)
 
       memset(conn, 0, sizeof(*conn));
 
+      /* This semaphore is used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      nxsem_init(&conn->waitsem, 0, 0);
+      nxsem_setprotocol(&conn->waitsem, SEM_PRIO_NONE);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->node, &g_active_netlink_connections);
@@ -182,10 +223,21 @@ FAR struct netlink_conn_s *netlink_alloc(void)
 
 void netlink_free(FAR struct netlink_conn_s *conn)
 {
+  FAR sq_entry_t *resp;
+
   /* The free list is protected by a semaphore (that behaves like a mutex). */
 
   DEBUGASSERT(conn->crefs == 0);
 
+  /* Discard any responses that were never received */
+
+  while ((resp = sq_remfirst(&conn->resplist)) != NULL)
+    {
+      kmm_free(resp);
+    }
+
+  nxsem_destroy(&conn->waitsem);
+
   _netlink_semtake(&g_free_sem);
 
   /* Remove the connection from the active list */
@@ -243,4 +295,166 @@ FAR struct netlink_conn_s *netlink_active(FAR struct sockaddr_nl *addr)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: netlink_alloc_response
+ *
+ * Description:
+ *   Allocate a response container with room for 'len' bytes of message
+ *   data.  The length of the response is initially zero.
+ *
+ * Returned Value:
+ *   The new response or NULL if memory could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct netlink_response_s *netlink_alloc_response(size_t len)
+{
+  FAR struct netlink_response_s *resp;
+
+  resp = (FAR struct netlink_response_s *)
+    kmm_malloc(sizeof(struct netlink_response_s) + len);
+  if (resp != NULL)
+    {
+      resp->len   = 0;
+      resp->mcast = false;
+    }
+
+  return resp;
+}
+
+/****************************************************************************
+ * Name: netlink_add_response
+ *
+ * Description:
+ *   Queue a response on a netlink connection and wake up any thread that
+ *   is waiting to receive it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void netlink_add_response(FAR struct netlink_conn_s *conn,
+                          FAR struct netlink_response_s *resp)
+{
+  DEBUGASSERT(conn != NULL && resp != NULL);
+
+  sq_addlast(&resp->flink, &conn->resplist);
+  netlink_notify_waiter(conn);
+}
+
+/****************************************************************************
+ * Name: netlink_add_broadcast
+ *
+ * Description:
+ *   Send a copy of a multicast notification to each netlink connection of
+ *   the given protocol that is a member of the multicast group.  Nothing
+ *   is sent when called from an interrupt handler since no memory can be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+void netlink_add_broadcast(int protocol, uint32_t group,
+                           FAR const void *data, size_t len)
+{
+  FAR struct netlink_conn_s *conn;
+  FAR struct netlink_response_s *resp;
+
+  if (up_interrupt_context())
+    {
+      return;
+    }
+
+  net_lock();
+  for (conn = netlink_nextconn(NULL); conn != NULL;
+       conn = netlink_nextconn(conn))
+    {
+      if (conn->protocol != protocol || (conn->groups & group) == 0)
+        {
+          continue;
+        }
+
+      /* Drop the notification if the application is not keeping up.  It
+       * will learn of this from the next recv().
+       */
+
+      if (conn->nmcast >= CONFIG_NET_NETLINK_QLIMIT)
+        {
+          conn->overrun = true;
+          continue;
+        }
+
+      resp = netlink_alloc_response(len);
+      if (resp == NULL)
+        {
+          conn->overrun = true;
+          continue;
+        }
+
+      memcpy(NETLINK_RESP_DATA(resp), data, len);
+      resp->len   = len;
+      resp->mcast = true;
+
+      conn->nmcast++;
+      netlink_add_response(conn, resp);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: netlink_get_response
+ *
+ * Description:
+ *   Remove the next response from the connection, waiting for one if the
+ *   queue is empty and 'nonblock' is false.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success with the response in *presp.  The
+ *   caller must kmm_free() it.  A negated errno value is returned on any
+ *   failure:  -EAGAIN if there is no response and 'nonblock' is true and
+ *   -ENOBUFS (once) if multicast notifications were dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netlink_get_response(FAR struct netlink_conn_s *conn, bool nonblock,
+                         FAR struct netlink_response_s **presp)
+{
+  FAR struct netlink_response_s *resp;
+  int ret;
+
+  if (conn->overrun)
+    {
+      conn->overrun = false;
+      return -ENOBUFS;
+    }
+
+  while ((resp = (FAR struct netlink_response_s *)
+                 sq_remfirst(&conn->resplist)) == NULL)
+    {
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = net_lockedwait(&conn->waitsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (resp->mcast)
+    {
+      DEBUGASSERT(conn->nmcast > 0);
+      conn->nmcast--;
+    }
+
+  *presp = resp;
+  return OK;
+}
+
 #endif /* CONFIG_NET_NETLINK */
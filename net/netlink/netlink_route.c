@@ -0,0 +1,811 @@
+/****************************************************************************
+ * net/netlink/netlink_route.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netpacket/netlink.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+#include "route/route.h"
+#include "utils/utils.h"
+#include "netlink/netlink.h"
+
+#ifdef CONFIG_NETLINK_ROUTE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest network address (IPv6) and link layer address (EUI-64) that
+ * may be reported.
+ */
+
+#define NLROUTE_ADDRLEN      16
+#define NLROUTE_LLADDRLEN    8
+
+/* The largest size of each kind of message */
+
+#define NLROUTE_LINK_MSGLEN \
+  (NLMSG_SPACE(sizeof(struct ifinfomsg)) + RTA_SPACE(IFNAMSIZ) + \
+   RTA_SPACE(sizeof(uint32_t)) + RTA_SPACE(NLROUTE_LLADDRLEN))
+#define NLROUTE_ADDR_MSGLEN \
+  (NLMSG_SPACE(sizeof(struct ifaddrmsg)) + 2 * RTA_SPACE(NLROUTE_ADDRLEN))
+#define NLROUTE_ROUTE_MSGLEN \
+  (NLMSG_SPACE(sizeof(struct rtmsg)) + 2 * RTA_SPACE(NLROUTE_ADDRLEN))
+#define NLROUTE_NEIGH_MSGLEN \
+  (NLMSG_SPACE(sizeof(struct ndmsg)) + RTA_SPACE(NLROUTE_ADDRLEN) + \
+   RTA_SPACE(NLROUTE_LLADDRLEN))
+#define NLROUTE_ERROR_MSGLEN NLMSG_SPACE(sizeof(struct nlmsgerr))
+#define NLROUTE_DONE_MSGLEN  NLMSG_SPACE(sizeof(int))
+
+#ifdef CONFIG_NETDEV_IFINDEX
+#  define NLROUTE_IFINDEX(d) ((d)->d_ifindex)
+#else
+#  define NLROUTE_IFINDEX(d) 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a dump in progress.  Messages are collected into responses
+ * of up to CONFIG_NETLINK_ROUTE_DUMPSIZE bytes.
+ */
+
+struct nlroute_dump_s
+{
+  FAR struct netlink_conn_s *conn;       /* The requesting connection */
+  FAR const struct nlmsghdr *req;        /* The dump request */
+  FAR struct netlink_response_s *resp;   /* The response being filled */
+  uint8_t family;                        /* Address family filter */
+  int ret;                               /* Result of the dump */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netlink_msg_init
+ *
+ * Description:
+ *   Initialize the header of a new message in 'buf' and clear its fixed
+ *   size payload.  The sequence number and port ID are copied from the
+ *   request (if any).
+ *
+ * Returned Value:
+ *   A pointer to the payload.
+ *
+ ****************************************************************************/
+
+static FAR void *netlink_msg_init(FAR void *buf, uint16_t type,
+                                  FAR const struct nlmsghdr *req,
+                                  uint16_t flags, size_t payload)
+{
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+
+  nlh->nlmsg_len   = NLMSG_LENGTH(payload);
+  nlh->nlmsg_type  = type;
+  nlh->nlmsg_flags = flags;
+  nlh->nlmsg_seq   = req != NULL ? req->nlmsg_seq : 0;
+  nlh->nlmsg_pid   = req != NULL ? req->nlmsg_pid : 0;
+
+  memset(NLMSG_DATA(nlh), 0, NLMSG_ALIGN(payload));
+  return NLMSG_DATA(nlh);
+}
+
+/****************************************************************************
+ * Name: netlink_add_attr
+ *
+ * Description:
+ *   Append a routing attribute to a message.
+ *
+ ****************************************************************************/
+
+static void netlink_add_attr(FAR struct nlmsghdr *nlh, uint16_t type,
+                             FAR const void *data, size_t len)
+{
+  FAR struct rtattr *rta;
+
+  rta = (FAR struct rtattr *)
+    ((FAR char *)nlh + NLMSG_ALIGN(nlh->nlmsg_len));
+
+  rta->rta_type = type;
+  rta->rta_len  = RTA_LENGTH(len);
+
+  memcpy(RTA_DATA(rta), data, len);
+  memset((FAR char *)RTA_DATA(rta) + len, 0,
+         RTA_ALIGN(rta->rta_len) - rta->rta_len);
+
+  nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+/****************************************************************************
+ * Name: netlink_fill_link
+ *
+ * Description:
+ *   Describe a network device in an RTM_NEWLINK or RTM_DELLINK message.
+ *
+ * Returned Value:
+ *   The size of the message.
+ *
+ ****************************************************************************/
+
+static size_t netlink_fill_link(FAR void *buf, FAR struct net_driver_s *dev,
+                                int type, FAR const struct nlmsghdr *req,
+                                uint16_t flags)
+{
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+  FAR struct ifinfomsg *ifi;
+  uint32_t mtu;
+  int lladdrlen;
+
+  ifi = (FAR struct ifinfomsg *)
+    netlink_msg_init(nlh, type, req, flags, sizeof(struct ifinfomsg));
+
+  ifi->ifi_family = AF_UNSPEC;
+  ifi->ifi_type   = dev->d_lltype;
+  ifi->ifi_index  = NLROUTE_IFINDEX(dev);
+  ifi->ifi_flags  = dev->d_flags;
+  ifi->ifi_change = 0xffffffff;
+
+  netlink_add_attr(nlh, IFLA_IFNAME, dev->d_ifname,
+                   strnlen(dev->d_ifname, IFNAMSIZ - 1) + 1);
+
+  mtu = NETDEV_PKTSIZE(dev);
+  netlink_add_attr(nlh, IFLA_MTU, &mtu, sizeof(mtu));
+
+  lladdrlen = netdev_lladdrsize(dev);
+  if (lladdrlen > 0 && lladdrlen <= NLROUTE_LLADDRLEN)
+    {
+      netlink_add_attr(nlh, IFLA_ADDRESS, &dev->d_mac, lladdrlen);
+    }
+
+  return NLMSG_ALIGN(nlh->nlmsg_len);
+}
+
+/****************************************************************************
+ * Name: netlink_fill_ipv4addr and netlink_fill_ipv6addr
+ *
+ * Description:
+ *   Describe the address of a network device in an RTM_NEWADDR or
+ *   RTM_DELADDR message.
+ *
+ * Returned Value:
+ *   The size of the message.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static uint8_t netlink_ipv4prefix(in_addr_t netmask)
+{
+  uint32_t mask = ntohl(netmask);
+  uint8_t prefixlen = 0;
+
+  while ((mask & 0x80000000) != 0)
+    {
+      prefixlen++;
+      mask <<= 1;
+    }
+
+  return prefixlen;
+}
+
+static size_t netlink_fill_ipv4addr(FAR void *buf,
+                                    FAR struct net_driver_s *dev, int type,
+                                    FAR const struct nlmsghdr *req,
+                                    uint16_t flags)
+{
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+  FAR struct ifaddrmsg *ifa;
+
+  ifa = (FAR struct ifaddrmsg *)
+    netlink_msg_init(nlh, type, req, flags, sizeof(struct ifaddrmsg));
+
+  ifa->ifa_family    = AF_INET;
+  ifa->ifa_prefixlen = netlink_ipv4prefix(dev->d_netmask);
+  ifa->ifa_flags     = IFA_F_PERMANENT;
+  ifa->ifa_scope     = RT_SCOPE_UNIVERSE;
+  ifa->ifa_index     = NLROUTE_IFINDEX(dev);
+
+  netlink_add_attr(nlh, IFA_ADDRESS, &dev->d_ipaddr, sizeof(in_addr_t));
+  netlink_add_attr(nlh, IFA_LOCAL, &dev->d_ipaddr, sizeof(in_addr_t));
+  return NLMSG_ALIGN(nlh->nlmsg_len);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static size_t netlink_fill_ipv6addr(FAR void *buf,
+                                    FAR struct net_driver_s *dev, int type,
+                                    FAR const struct nlmsghdr *req,
+                                    uint16_t flags)
+{
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+  FAR struct ifaddrmsg *ifa;
+
+  ifa = (FAR struct ifaddrmsg *)
+    netlink_msg_init(nlh, type, req, flags, sizeof(struct ifaddrmsg));
+
+  ifa->ifa_family    = AF_INET6;
+  ifa->ifa_prefixlen = net_ipv6_mask2pref(dev->d_ipv6netmask);
+  ifa->ifa_flags     = IFA_F_PERMANENT;
+  ifa->ifa_scope     = RT_SCOPE_UNIVERSE;
+  ifa->ifa_index     = NLROUTE_IFINDEX(dev);
+
+  netlink_add_attr(nlh, IFA_ADDRESS, dev->d_ipv6addr,
+                   sizeof(net_ipv6addr_t));
+  return NLMSG_ALIGN(nlh->nlmsg_len);
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_fill_route
+ *
+ * Description:
+ *   Describe a routing table entry in an RTM_NEWROUTE or RTM_DELROUTE
+ *   message.
+ *
+ * Returned Value:
+ *   The size of the message.
+ *
+ ****************************************************************************/
+
+static size_t netlink_fill_route(FAR void *buf, int type,
+                                 FAR const struct nlmsghdr *req,
+                                 uint16_t flags, sa_family_t family,
+                                 uint8_t prefixlen, FAR const void *target,
+                                 FAR const void *router, size_t addrlen)
+{
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+  FAR struct rtmsg *rtm;
+
+  rtm = (FAR struct rtmsg *)
+    netlink_msg_init(nlh, type, req, flags, sizeof(struct rtmsg));
+
+  rtm->rtm_family   = family;
+  rtm->rtm_dst_len  = prefixlen;
+  rtm->rtm_table    = RT_TABLE_MAIN;
+  rtm->rtm_protocol = RTPROT_STATIC;
+  rtm->rtm_scope    = RT_SCOPE_UNIVERSE;
+  rtm->rtm_type     = RTN_UNICAST;
+
+  netlink_add_attr(nlh, RTA_DST, target, addrlen);
+  netlink_add_attr(nlh, RTA_GATEWAY, router, addrlen);
+  return NLMSG_ALIGN(nlh->nlmsg_len);
+}
+
+/****************************************************************************
+ * Name: netlink_dump_reserve
+ *
+ * Description:
+ *   Reserve space for one more message of up to 'len' bytes in the dump
+ *   response.  The response is queued and a new one started when it is
+ *   full.
+ *
+ * Returned Value:
+ *   A pointer to the reserved space or NULL if memory could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+static FAR void *netlink_dump_reserve(FAR struct nlroute_dump_s *dump,
+                                      size_t len)
+{
+  FAR struct netlink_response_s *resp = dump->resp;
+
+  if (resp != NULL && resp->len + len > CONFIG_NETLINK_ROUTE_DUMPSIZE)
+    {
+      netlink_add_response(dump->conn, resp);
+      resp = NULL;
+    }
+
+  if (resp == NULL)
+    {
+      resp = netlink_alloc_response(CONFIG_NETLINK_ROUTE_DUMPSIZE);
+      if (resp == NULL)
+        {
+          dump->resp = NULL;
+          dump->ret  = -ENOMEM;
+          return NULL;
+        }
+    }
+
+  dump->resp = resp;
+  return NETLINK_RESP_DATA(resp) + resp->len;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_link and netlink_dump_addr
+ *
+ * Description:
+ *   netdev_foreach() callbacks that add the description of one network
+ *   device (or of its addresses) to a dump.
+ *
+ ****************************************************************************/
+
+static int netlink_dump_link(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  FAR struct nlroute_dump_s *dump = (FAR struct nlroute_dump_s *)arg;
+  FAR void *buf;
+
+  buf = netlink_dump_reserve(dump, NLROUTE_LINK_MSGLEN);
+  if (buf == NULL)
+    {
+      return 1;
+    }
+
+  dump->resp->len += netlink_fill_link(buf, dev, RTM_NEWLINK, dump->req,
+                                       NLM_F_MULTI);
+  return 0;
+}
+
+static int netlink_dump_addr(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  FAR struct nlroute_dump_s *dump = (FAR struct nlroute_dump_s *)arg;
+  FAR void *buf;
+
+#ifdef CONFIG_NET_IPv4
+  if ((dump->family == AF_UNSPEC || dump->family == AF_INET) &&
+      !net_ipv4addr_cmp(dev->d_ipaddr, INADDR_ANY))
+    {
+      buf = netlink_dump_reserve(dump, NLROUTE_ADDR_MSGLEN);
+      if (buf == NULL)
+        {
+          return 1;
+        }
+
+      dump->resp->len += netlink_fill_ipv4addr(buf, dev, RTM_NEWADDR,
+                                               dump->req, NLM_F_MULTI);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((dump->family == AF_UNSPEC || dump->family == AF_INET6) &&
+      !net_ipv6addr_cmp(dev->d_ipv6addr, g_ipv6_unspecaddr))
+    {
+      buf = netlink_dump_reserve(dump, NLROUTE_ADDR_MSGLEN);
+      if (buf == NULL)
+        {
+          return 1;
+        }
+
+      dump->resp->len += netlink_fill_ipv6addr(buf, dev, RTM_NEWADDR,
+                                               dump->req, NLM_F_MULTI);
+    }
+#endif
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_ipv4route and netlink_dump_ipv6route
+ *
+ * Description:
+ *   net_foreachroute_ipv4/6() callbacks that add one routing table entry
+ *   to a dump.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv4)
+static int netlink_dump_ipv4route(FAR struct net_route_ipv4_s *route,
+                                  FAR void *arg)
+{
+  FAR struct nlroute_dump_s *dump = (FAR struct nlroute_dump_s *)arg;
+  FAR void *buf;
+
+  buf = netlink_dump_reserve(dump, NLROUTE_ROUTE_MSGLEN);
+  if (buf == NULL)
+    {
+      return 1;
+    }
+
+  dump->resp->len +=
+    netlink_fill_route(buf, RTM_NEWROUTE, dump->req, NLM_F_MULTI, AF_INET,
+                       netlink_ipv4prefix(route->netmask), &route->target,
+                       &route->router, sizeof(in_addr_t));
+  return 0;
+}
+#endif
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv6)
+static int netlink_dump_ipv6route(FAR struct net_route_ipv6_s *route,
+                                  FAR void *arg)
+{
+  FAR struct nlroute_dump_s *dump = (FAR struct nlroute_dump_s *)arg;
+  FAR void *buf;
+
+  buf = netlink_dump_reserve(dump, NLROUTE_ROUTE_MSGLEN);
+  if (buf == NULL)
+    {
+      return 1;
+    }
+
+  dump->resp->len +=
+    netlink_fill_route(buf, RTM_NEWROUTE, dump->req, NLM_F_MULTI, AF_INET6,
+                       net_ipv6_mask2pref(route->netmask), route->target,
+                       route->router, sizeof(net_ipv6addr_t));
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_route_dump
+ *
+ * Description:
+ *   Respond to an RTM_GETLINK, RTM_GETADDR, or RTM_GETROUTE dump request.
+ *   The messages are returned in as few responses as possible.  The last
+ *   response ends with NLMSG_DONE.
+ *
+ ****************************************************************************/
+
+static int netlink_route_dump(FAR struct netlink_conn_s *conn,
+                              FAR const struct nlmsghdr *req)
+{
+  struct nlroute_dump_s dump;
+  FAR void *buf;
+
+  dump.conn   = conn;
+  dump.req    = req;
+  dump.resp   = NULL;
+  dump.family = AF_UNSPEC;
+  dump.ret    = OK;
+
+  /* The first byte of every GET request payload is the address family */
+
+  if (req->nlmsg_len > NLMSG_HDRLEN)
+    {
+      dump.family = *(FAR const uint8_t *)NLMSG_DATA(req);
+    }
+
+  switch (req->nlmsg_type)
+    {
+      case RTM_GETLINK:
+        (void)netdev_foreach(netlink_dump_link, &dump);
+        break;
+
+      case RTM_GETADDR:
+        (void)netdev_foreach(netlink_dump_addr, &dump);
+        break;
+
+      case RTM_GETROUTE:
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv4)
+        if (dump.family == AF_UNSPEC || dump.family == AF_INET)
+          {
+            (void)net_foreachroute_ipv4(netlink_dump_ipv4route, &dump);
+          }
+#endif
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_IPv6)
+        if (dump.ret == OK &&
+            (dump.family == AF_UNSPEC || dump.family == AF_INET6))
+          {
+            (void)net_foreachroute_ipv6(netlink_dump_ipv6route, &dump);
+          }
+#endif
+        break;
+
+      default:
+        return -EOPNOTSUPP;
+    }
+
+  /* Terminate the dump */
+
+  if (dump.ret == OK)
+    {
+      buf = netlink_dump_reserve(&dump, NLROUTE_DONE_MSGLEN);
+      if (buf != NULL)
+        {
+          (void)netlink_msg_init(buf, NLMSG_DONE, req, NLM_F_MULTI,
+                                 sizeof(int));
+          dump.resp->len += NLROUTE_DONE_MSGLEN;
+        }
+    }
+
+  if (dump.ret < 0)
+    {
+      if (dump.resp != NULL)
+        {
+          kmm_free(dump.resp);
+        }
+
+      return dump.ret;
+    }
+
+  netlink_add_response(conn, dump.resp);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netlink_route_error
+ *
+ * Description:
+ *   Queue an NLMSG_ERROR response to a request.  An error of zero is an
+ *   acknowledgement.
+ *
+ ****************************************************************************/
+
+static void netlink_route_error(FAR struct netlink_conn_s *conn,
+                                FAR const struct nlmsghdr *req, int error)
+{
+  FAR struct netlink_response_s *resp;
+  FAR struct nlmsgerr *err;
+
+  resp = netlink_alloc_response(NLROUTE_ERROR_MSGLEN);
+  if (resp == NULL)
+    {
+      nerr("ERROR: Failed to allocate the response\n");
+      return;
+    }
+
+  err = (FAR struct nlmsgerr *)
+    netlink_msg_init(NETLINK_RESP_DATA(resp), NLMSG_ERROR, req, 0,
+                     sizeof(struct nlmsgerr));
+
+  err->error = error;
+  memcpy(&err->msg, req, sizeof(struct nlmsghdr));
+
+  resp->len = NLROUTE_ERROR_MSGLEN;
+  netlink_add_response(conn, resp);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netlink_route_sendto
+ *
+ * Description:
+ *   Perform the NETLINK_ROUTE requests in a buffer sent to the kernel.
+ *   Responses are queued on the connection.
+ *
+ * Input Parameters:
+ *   conn - The netlink connection
+ *   buf  - The buffer holding one or more netlink request messages
+ *   len  - The length of the buffer
+ *
+ * Returned Value:
+ *   The number of bytes consumed or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t netlink_route_sendto(FAR struct netlink_conn_s *conn,
+                             FAR const void *buf, size_t len)
+{
+  FAR const struct nlmsghdr *req = (FAR const struct nlmsghdr *)buf;
+  int remaining = (int)len;
+  int ret;
+
+  if (!NLMSG_OK(req, remaining))
+    {
+      return -EINVAL;
+    }
+
+  for (; NLMSG_OK(req, remaining); req = NLMSG_NEXT(req, remaining))
+    {
+      if ((req->nlmsg_flags & NLM_F_REQUEST) == 0 ||
+          req->nlmsg_type < NLMSG_MIN_TYPE)
+        {
+          /* Not a request:  Ignore it */
+
+          continue;
+        }
+
+      switch (req->nlmsg_type)
+        {
+          case RTM_GETLINK:
+          case RTM_GETADDR:
+          case RTM_GETROUTE:
+            /* Only dumps are supported.  The state of a single object
+             * can be found with ioctl().
+             */
+
+            if ((req->nlmsg_flags & NLM_F_DUMP) != 0)
+              {
+                ret = netlink_route_dump(conn, req);
+              }
+            else
+              {
+                ret = -EOPNOTSUPP;
+              }
+            break;
+
+          default:
+            ret = -EOPNOTSUPP;
+            break;
+        }
+
+      /* Report failures and, if requested, success */
+
+      if (ret < 0 || (req->nlmsg_flags & NLM_F_ACK) != 0)
+        {
+          netlink_route_error(conn, req, ret);
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: netlink_link_notify
+ *
+ * Description:
+ *   Tell NETLINK_ROUTE sockets that are members of RTMGRP_LINK that a
+ *   device was registered, unregistered, or changed state (RTM_NEWLINK or
+ *   RTM_DELLINK).
+ *
+ ****************************************************************************/
+
+void netlink_link_notify(FAR struct net_driver_s *dev, int type)
+{
+  uint32_t buf[NLROUTE_LINK_MSGLEN / sizeof(uint32_t)];
+  size_t len;
+
+  len = netlink_fill_link(buf, dev, type, NULL, 0);
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_LINK, buf, len);
+}
+
+/****************************************************************************
+ * Name: netlink_ipv4addr_notify and netlink_ipv6addr_notify
+ *
+ * Description:
+ *   Tell NETLINK_ROUTE sockets that are members of RTMGRP_IPV4_IFADDR or
+ *   RTMGRP_IPV6_IFADDR that the address of a device was set (RTM_NEWADDR)
+ *   or is about to be removed (RTM_DELADDR).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void netlink_ipv4addr_notify(FAR struct net_driver_s *dev, int type)
+{
+  uint32_t buf[NLROUTE_ADDR_MSGLEN / sizeof(uint32_t)];
+  size_t len;
+
+  len = netlink_fill_ipv4addr(buf, dev, type, NULL, 0);
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_IPV4_IFADDR, buf, len);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void netlink_ipv6addr_notify(FAR struct net_driver_s *dev, int type)
+{
+  uint32_t buf[NLROUTE_ADDR_MSGLEN / sizeof(uint32_t)];
+  size_t len;
+
+  len = netlink_fill_ipv6addr(buf, dev, type, NULL, 0);
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_IPV6_IFADDR, buf, len);
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_ipv4route_notify and netlink_ipv6route_notify
+ *
+ * Description:
+ *   Tell NETLINK_ROUTE sockets that are members of RTMGRP_IPV4_ROUTE or
+ *   RTMGRP_IPV6_ROUTE that a route was added (RTM_NEWROUTE) or deleted
+ *   (RTM_DELROUTE).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void netlink_ipv4route_notify(int type, in_addr_t target,
+                              in_addr_t netmask, in_addr_t router)
+{
+  uint32_t buf[NLROUTE_ROUTE_MSGLEN / sizeof(uint32_t)];
+  size_t len;
+
+  len = netlink_fill_route(buf, type, NULL, 0, AF_INET,
+                           netlink_ipv4prefix(netmask), &target, &router,
+                           sizeof(in_addr_t));
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_IPV4_ROUTE, buf, len);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void netlink_ipv6route_notify(int type, FAR const uint16_t *target,
+                              FAR const uint16_t *netmask,
+                              FAR const uint16_t *router)
+{
+  uint32_t buf[NLROUTE_ROUTE_MSGLEN / sizeof(uint32_t)];
+  size_t len;
+
+  len = netlink_fill_route(buf, type, NULL, 0, AF_INET6,
+                           net_ipv6_mask2pref(netmask), target, router,
+                           sizeof(net_ipv6addr_t));
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_IPV6_ROUTE, buf, len);
+}
+#endif
+
+/****************************************************************************
+ * Name: netlink_neigh_notify
+ *
+ * Description:
+ *   Tell NETLINK_ROUTE sockets that are members of RTMGRP_NEIGH that an
+ *   address mapping was learned or changed (RTM_NEWNEIGH) or was removed
+ *   (RTM_DELNEIGH).
+ *
+ ****************************************************************************/
+
+void netlink_neigh_notify(FAR struct net_driver_s *dev, int type,
+                          sa_family_t family, FAR const void *ipaddr,
+                          FAR const uint8_t *lladdr, uint8_t lladdrlen)
+{
+  uint32_t buf[NLROUTE_NEIGH_MSGLEN / sizeof(uint32_t)];
+  FAR struct nlmsghdr *nlh = (FAR struct nlmsghdr *)buf;
+  FAR struct ndmsg *ndm;
+
+  ndm = (FAR struct ndmsg *)
+    netlink_msg_init(nlh, type, NULL, 0, sizeof(struct ndmsg));
+
+  ndm->ndm_family  = family;
+  ndm->ndm_ifindex = dev != NULL ? NLROUTE_IFINDEX(dev) : 0;
+  ndm->ndm_state   = NUD_REACHABLE;
+
+  netlink_add_attr(nlh, NDA_DST, ipaddr,
+                   family == AF_INET6 ? NLROUTE_ADDRLEN : sizeof(in_addr_t));
+
+  if (lladdr != NULL && lladdrlen > 0 && lladdrlen <= NLROUTE_LLADDRLEN)
+    {
+      netlink_add_attr(nlh, NDA_LLADDR, lladdr, lladdrlen);
+    }
+
+  netlink_add_broadcast(NETLINK_ROUTE, RTMGRP_NEIGH, buf,
+                        NLMSG_ALIGN(nlh->nlmsg_len));
+}
+
+#endif /* CONFIG_NETLINK_ROUTE */
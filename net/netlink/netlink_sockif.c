@@ -42,10 +42,16 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <netpacket/netlink.h>
+
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
 #include "netlink/netlink.h"
@@ -135,21 +141,41 @@ const struct sock_intf_s g_netlink_sockif =
 
 static int netlink_setup(FAR struct socket *psock, int protocol)
 {
+  FAR struct netlink_conn_s *conn;
   int domain = psock->s_domain;
   int type = psock->s_type;
-  int ret;
 
-  if (domain == PF_NETLINK && (type == SOCK_RAW || type == SOCK_DGRAM))
+  if (domain != PF_NETLINK || (type != SOCK_RAW && type != SOCK_DGRAM))
     {
-      ret = OK;
+      return -ENETDOWN;
     }
-  else
+
+  /* Verify that the protocol is supported */
+
+  switch (protocol)
     {
-      return -ENETDOWN;
+#ifdef CONFIG_NETLINK_ROUTE
+      case NETLINK_ROUTE:
+        break;
+#endif
+
+      default:
+        return -EPROTONOSUPPORT;
     }
 
-  psock->s_conn = NULL;
-  return ret;
+  /* Allocate the netlink connection structure */
+
+  conn = netlink_alloc();
+  if (conn == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  conn->protocol = (uint8_t)protocol;
+  conn->crefs    = 1;
+
+  psock->s_conn  = conn;
+  return OK;
 }
 
 /****************************************************************************
@@ -169,7 +195,7 @@ static int netlink_setup(FAR struct socket *psock, int protocol)
 
 static sockcaps_t netlink_sockcaps(FAR struct socket *psock)
 {
-  return 0;
+  return SOCKCAP_NONBLOCKING;
 }
 
 /****************************************************************************
@@ -231,8 +257,28 @@ static void netlink_addref(FAR struct socket *psock)
 static int netlink_bind(FAR struct socket *psock,
                         FAR const struct sockaddr *addr, socklen_t addrlen)
 {
-#warning Missing logic for NETLINK bind
-  return -EOPNOTSUPP;
+  FAR struct netlink_conn_s *conn;
+  FAR const struct sockaddr_nl *nladdr;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && addr != NULL);
+
+  if (addrlen < sizeof(struct sockaddr_nl) || addr->sa_family != AF_NETLINK)
+    {
+      return -EINVAL;
+    }
+
+  conn   = (FAR struct netlink_conn_s *)psock->s_conn;
+  nladdr = (FAR const struct sockaddr_nl *)addr;
+
+  /* A port ID of zero selects the ID of the calling task.  The multicast
+   * groups determine which notifications the socket will receive.
+   */
+
+  conn->pid     = nladdr->nl_pid != 0 ? nladdr->nl_pid : (uint32_t)getpid();
+  conn->groups  = nladdr->nl_groups;
+
+  psock->s_flags |= _SF_BOUND;
+  return OK;
 }
 
 /****************************************************************************
@@ -261,8 +307,25 @@ static int netlink_getsockname(FAR struct socket *psock,
                                FAR struct sockaddr *addr,
                                FAR socklen_t *addrlen)
 {
-#warning Missing logic for NETLINK getsockname
-  return -EOPNOTSUPP;
+  FAR struct netlink_conn_s *conn;
+  struct sockaddr_nl nladdr;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+
+  conn = (FAR struct netlink_conn_s *)psock->s_conn;
+
+  memset(&nladdr, 0, sizeof(nladdr));
+  nladdr.nl_family = AF_NETLINK;
+  nladdr.nl_pid    = conn->pid;
+  nladdr.nl_groups = conn->groups;
+
+  if (*addrlen > sizeof(nladdr))
+    {
+      *addrlen = sizeof(nladdr);
+    }
+
+  memcpy(addr, &nladdr, *addrlen);
+  return OK;
 }
 
 /****************************************************************************
@@ -431,8 +494,47 @@ static int netlink_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 static int netlink_poll(FAR struct socket *psock, FAR struct pollfd *fds,
                         bool setup)
 {
-#warning Missing logic for NETLINK poll
-  return -EOPNOTSUPP;
+  FAR struct netlink_conn_s *conn;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && fds != NULL);
+
+  conn = (FAR struct netlink_conn_s *)psock->s_conn;
+
+  net_lock();
+  if (setup)
+    {
+      /* Only one thread may poll a netlink socket at a time */
+
+      if (conn->pollfd != NULL)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          conn->pollfd = fds;
+
+          /* Requests are handled immediately so a send never waits */
+
+          fds->revents = (fds->events & POLLOUT);
+          if (!sq_empty(&conn->resplist) || conn->overrun)
+            {
+              fds->revents |= (fds->events & POLLIN);
+            }
+
+          if (fds->revents != 0)
+            {
+              (void)nxsem_post(fds->sem);
+            }
+        }
+    }
+  else if (conn->pollfd == fds)
+    {
+      conn->pollfd = NULL;
+    }
+
+  net_unlock();
+  return ret;
 }
 #endif
 
@@ -460,8 +562,9 @@ static ssize_t netlink_send(FAR struct socket *psock,
                                    FAR const void *buf,
                                    size_t len, int flags)
 {
-#warning Missing logic for NETLINK send
-  return -EOPNOTSUPP;
+  /* Messages are always sent to the kernel */
+
+  return netlink_sendto(psock, buf, len, flags, NULL, 0);
 }
 
 /****************************************************************************
@@ -492,8 +595,53 @@ static ssize_t netlink_sendto(FAR struct socket *psock, FAR const void *buf,
                              size_t len, int flags,
                              FAR const struct sockaddr *to, socklen_t tolen)
 {
-#warning Missing logic for NETLINK sendto
-  return -EOPNOTSUPP;
+  FAR struct netlink_conn_s *conn;
+  ssize_t ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && buf != NULL);
+
+  conn = (FAR struct netlink_conn_s *)psock->s_conn;
+
+  /* Only messages to the kernel (port ID zero) are supported */
+
+  if (to != NULL)
+    {
+      FAR const struct sockaddr_nl *nladdr =
+        (FAR const struct sockaddr_nl *)to;
+
+      if (tolen < sizeof(struct sockaddr_nl) ||
+          to->sa_family != AF_NETLINK)
+        {
+          return -EINVAL;
+        }
+
+      if (nladdr->nl_pid != 0)
+        {
+          return -EOPNOTSUPP;
+        }
+    }
+
+  if (len < sizeof(struct nlmsghdr))
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  switch (conn->protocol)
+    {
+#ifdef CONFIG_NETLINK_ROUTE
+      case NETLINK_ROUTE:
+        ret = netlink_route_sendto(conn, buf, len);
+        break;
+#endif
+
+      default:
+        ret = -EOPNOTSUPP;
+        break;
+    }
+
+  net_unlock();
+  return ret;
 }
 
 /****************************************************************************
@@ -523,8 +671,55 @@ static ssize_t netlink_recvfrom(FAR struct socket *psock, FAR void *buf,
                                 FAR struct sockaddr *from,
                                 FAR socklen_t *fromlen)
 {
-#warning Missing logic for NETLINK recvfrom
-  return -EOPNOTSUPP;
+  FAR struct netlink_conn_s *conn;
+  FAR struct netlink_response_s *resp;
+  bool nonblock;
+  int ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && buf != NULL);
+
+  conn     = (FAR struct netlink_conn_s *)psock->s_conn;
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+  ret = netlink_get_response(conn, nonblock, &resp);
+  net_unlock();
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Each response is one datagram.  Any part of it that does not fit in
+   * the user buffer is lost.
+   */
+
+  if (len > resp->len)
+    {
+      len = resp->len;
+    }
+
+  memcpy(buf, NETLINK_RESP_DATA(resp), len);
+  kmm_free(resp);
+
+  /* All responses come from the kernel */
+
+  if (from != NULL && fromlen != NULL)
+    {
+      struct sockaddr_nl nladdr;
+
+      memset(&nladdr, 0, sizeof(nladdr));
+      nladdr.nl_family = AF_NETLINK;
+
+      if (*fromlen > sizeof(nladdr))
+        {
+          *fromlen = sizeof(nladdr);
+        }
+
+      memcpy(from, &nladdr, *fromlen);
+    }
+
+  return len;
 }
 
 /****************************************************************************
@@ -546,31 +741,20 @@ static ssize_t netlink_recvfrom(FAR struct socket *psock, FAR void *buf,
 static int netlink_close(FAR struct socket *psock)
 {
   FAR struct netlink_conn_s *conn = psock->s_conn;
-  int ret;
-
-  /* Perform some pre-close operations for the NETLINK socket type. */
 
   /* Is this the last reference to the connection structure (there
    * could be more if the socket was dup'ed).
    */
 
+  net_lock();
   if (conn->crefs <= 1)
     {
-      /* Yes... inform user-space daemon of socket close. */
-#warning Missing logic
-
-      /* Free the connection structure */
+      /* Yes... free the connection structure and any responses that were
+       * never received.
+       */
 
       conn->crefs = 0;
       netlink_free(psock->s_conn);
-
-      if (ret < 0)
-        {
-          /* Return with error code, but free resources. */
-
-          nerr("ERROR: netlink_close failed: %d\n", ret);
-          return ret;
-        }
     }
   else
     {
@@ -579,6 +763,7 @@ static int netlink_close(FAR struct socket *psock)
       conn->crefs--;
     }
 
+  net_unlock();
   return OK;
 }
 
@@ -43,6 +43,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -65,6 +68,8 @@
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct sock_filter;      /* Forward reference */
+struct pollfd;           /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -77,6 +82,26 @@ struct pkt_conn_s
   /* Defines the list of packet callbacks */
 
   struct devif_callback_s *list;
+
+#ifdef CONFIG_NET_PKT_FILTER
+  /* The attached filter program (see pkt_setsockopt()) */
+
+  FAR struct sock_filter *filter;
+  uint16_t   nfilter;  /* Number of instructions */
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* The memory-mapped receive ring (see pkt_ring_setup()) */
+
+  FAR uint8_t *ring;   /* Start of the ring (NULL: no ring) */
+  size_t     ringsize; /* Size of the ring in bytes */
+  uint32_t   framesize; /* Size of each frame in bytes */
+  uint32_t   nframes;  /* Number of frames */
+  uint32_t   head;     /* Index of the next frame to be written */
+  uint32_t   drops;    /* Frames dropped because the ring was full */
+  bool       losing;   /* Frames dropped since the last frame was written */
+  FAR struct pollfd *fds; /* The poll() waiting on the ring (if any) */
+#endif
 };
 
 /****************************************************************************
@@ -301,6 +326,174 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the SOL_PACKET protocol socket option specified
+ *   by the 'option' argument to the value pointed to by the 'value'
+ *   argument for the packet socket 'psock'.
+ *
+ *   See <netpacket/packet.h> for a complete list of values of packet
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKTPROTO_OPTIONS
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_filter_validate
+ *
+ * Description:
+ *   Verify that a filter program is well formed:  Every instruction is
+ *   known, every jump stays inside of the program, all scratch memory
+ *   accesses are in range, and the program ends with a return instruction.
+ *
+ * Input Parameters:
+ *   filter  - The program
+ *   nfilter - The number of instructions
+ *
+ * Returned Value:
+ *   True if the program may be run by pkt_filter_run().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_FILTER
+bool pkt_filter_validate(FAR const struct sock_filter *filter,
+                         uint16_t nfilter);
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run a validated filter program on a received frame.
+ *
+ * Input Parameters:
+ *   filter  - The program
+ *   nfilter - The number of instructions
+ *   frame   - The frame
+ *   len     - The length of the frame in bytes
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to accept; zero to drop the frame.
+ *
+ ****************************************************************************/
+
+uint32_t pkt_filter_run(FAR const struct sock_filter *filter,
+                        uint16_t nfilter, FAR const uint8_t *frame,
+                        uint32_t len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up or (if tp_block_nr is zero) release the memory-mapped receive
+ *   ring of a packet socket connection.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   req  - The requested ring layout
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_MMAP
+struct tpacket_req; /* Forward reference */
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req);
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Free the receive ring of a packet socket connection, if any.
+ *
+ ****************************************************************************/
+
+void pkt_ring_release(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the received frame in d_buf into the next frame of the receive
+ *   ring.  The frame is dropped if that frame still belongs to the user.
+ *
+ * Input Parameters:
+ *   conn    - The packet socket connection
+ *   dev     - The device driver structure containing the received frame
+ *   snaplen - The maximum number of bytes to capture
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct pkt_conn_s *conn,
+                    FAR struct net_driver_s *dev, uint32_t snaplen);
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Set up or tear down a poll() on the receive ring.
+ *
+ * Input Parameters:
+ *   conn  - The packet socket connection
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_poll(FAR struct pkt_conn_s *conn, FAR struct pollfd *fds,
+                  bool setup);
+
+/****************************************************************************
+ * Name: pkt_ioctl
+ *
+ * Description:
+ *   Handle the FIOC_MMAP ioctl command (as used by mmap()) on a packet
+ *   socket:  Return the address of the receive ring.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   cmd   - The ioctl command
+ *   arg   - The argument of the ioctl command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOTTY if
+ *   the command or the socket is not handled here.
+ *
+ ****************************************************************************/
+
+int pkt_ioctl(FAR struct socket *psock, int cmd, unsigned long arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -49,6 +49,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -161,6 +162,14 @@ FAR struct pkt_conn_s *pkt_alloc(void)
       /* Make sure that the connection is marked as uninitialized */
 
       conn->ifindex = 0;
+#ifdef CONFIG_NET_PKT_FILTER
+      conn->filter  = NULL;
+      conn->nfilter = 0;
+#endif
+#ifdef CONFIG_NET_PKT_MMAP
+      conn->ring    = NULL;
+      conn->fds     = NULL;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -186,6 +195,24 @@ void pkt_free(FAR struct pkt_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_PKT_FILTER
+  /* Free any attached filter program */
+
+  if (conn->filter != NULL)
+    {
+      kmm_free(conn->filter);
+      conn->filter  = NULL;
+      conn->nfilter = 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Free any receive ring */
+
+  pkt_ring_release(conn);
+  conn->fds = NULL;
+#endif
+
   _pkt_semtake(&g_free_sem);
 
   /* Remove the connection from the active list */
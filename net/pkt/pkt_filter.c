@@ -0,0 +1,478 @@
+/****************************************************************************
+ * net/pkt/pkt_filter.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_FILTER)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <net/bpf.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_load
+ *
+ * Description:
+ *   Load a big-endian word, half word, or byte from the frame.
+ *
+ * Returned Value:
+ *   True if the value lies inside of the frame.
+ *
+ ****************************************************************************/
+
+static bool pkt_filter_load(FAR const uint8_t *frame, uint32_t len,
+                            uint32_t offset, uint16_t size,
+                            FAR uint32_t *value)
+{
+  uint32_t nbytes;
+
+  nbytes = size == BPF_W ? 4 : size == BPF_H ? 2 : 1;
+  if (offset > len || nbytes > len - offset)
+    {
+      return false;
+    }
+
+  frame += offset;
+  switch (nbytes)
+    {
+      case 4:
+        *value = (uint32_t)frame[0] << 24 | (uint32_t)frame[1] << 16 |
+                 (uint32_t)frame[2] << 8 | frame[3];
+        break;
+
+      case 2:
+        *value = (uint32_t)frame[0] << 8 | frame[1];
+        break;
+
+      default:
+        *value = frame[0];
+        break;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_validate
+ *
+ * Description:
+ *   Verify that a filter program is well formed:  Every instruction is
+ *   known, every jump stays inside of the program, all scratch memory
+ *   accesses are in range, and the program ends with a return instruction.
+ *
+ * Input Parameters:
+ *   filter  - The program
+ *   nfilter - The number of instructions
+ *
+ * Returned Value:
+ *   True if the program may be run by pkt_filter_run().
+ *
+ ****************************************************************************/
+
+bool pkt_filter_validate(FAR const struct sock_filter *filter,
+                         uint16_t nfilter)
+{
+  FAR const struct sock_filter *insn;
+  uint32_t remaining;
+  int pc;
+
+  if (nfilter == 0 || nfilter > BPF_MAXINSNS)
+    {
+      return false;
+    }
+
+  for (pc = 0; pc < nfilter; pc++)
+    {
+      insn      = &filter[pc];
+      remaining = nfilter - pc - 1;
+
+      switch (BPF_CLASS(insn->code))
+        {
+          case BPF_LD:
+          case BPF_LDX:
+            switch (BPF_MODE(insn->code))
+              {
+                case BPF_IMM:
+                case BPF_LEN:
+                  break;
+
+                case BPF_ABS:
+                case BPF_IND:
+                  if (BPF_CLASS(insn->code) == BPF_LDX ||
+                      BPF_SIZE(insn->code) == 0x18)
+                    {
+                      return false;
+                    }
+                  break;
+
+                case BPF_MSH:
+                  if (BPF_CLASS(insn->code) != BPF_LDX ||
+                      BPF_SIZE(insn->code) != BPF_B)
+                    {
+                      return false;
+                    }
+                  break;
+
+                case BPF_MEM:
+                  if (insn->k >= BPF_MEMWORDS)
+                    {
+                      return false;
+                    }
+                  break;
+
+                default:
+                  return false;
+              }
+            break;
+
+          case BPF_ST:
+          case BPF_STX:
+            if (insn->k >= BPF_MEMWORDS)
+              {
+                return false;
+              }
+            break;
+
+          case BPF_ALU:
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_DIV:
+                case BPF_MOD:
+                  if (BPF_SRC(insn->code) == BPF_K && insn->k == 0)
+                    {
+                      return false;
+                    }
+                  break;
+
+                case BPF_ADD:
+                case BPF_SUB:
+                case BPF_MUL:
+                case BPF_OR:
+                case BPF_AND:
+                case BPF_LSH:
+                case BPF_RSH:
+                case BPF_NEG:
+                case BPF_XOR:
+                  break;
+
+                default:
+                  return false;
+              }
+            break;
+
+          case BPF_JMP:
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_JA:
+                  if (insn->k > remaining)
+                    {
+                      return false;
+                    }
+                  break;
+
+                case BPF_JEQ:
+                case BPF_JGT:
+                case BPF_JGE:
+                case BPF_JSET:
+                  if (insn->jt > remaining || insn->jf > remaining)
+                    {
+                      return false;
+                    }
+                  break;
+
+                default:
+                  return false;
+              }
+
+            /* Only backward jumps could loop and there are none */
+
+            if (remaining == 0)
+              {
+                return false;
+              }
+            break;
+
+          case BPF_RET:
+            if (BPF_RVAL(insn->code) != BPF_K &&
+                BPF_RVAL(insn->code) != BPF_A)
+              {
+                return false;
+              }
+            break;
+
+          case BPF_MISC:
+            if (BPF_MISCOP(insn->code) != BPF_TAX &&
+                BPF_MISCOP(insn->code) != BPF_TXA)
+              {
+                return false;
+              }
+            break;
+        }
+    }
+
+  return BPF_CLASS(filter[nfilter - 1].code) == BPF_RET;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run a validated filter program on a received frame.  A load from
+ *   outside of the frame or a division by zero drops the frame.
+ *
+ * Input Parameters:
+ *   filter  - The program
+ *   nfilter - The number of instructions
+ *   frame   - The frame
+ *   len     - The length of the frame in bytes
+ *
+ * Returned Value:
+ *   The number of bytes of the frame to accept; zero to drop the frame.
+ *
+ ****************************************************************************/
+
+uint32_t pkt_filter_run(FAR const struct sock_filter *filter,
+                        uint16_t nfilter, FAR const uint8_t *frame,
+                        uint32_t len)
+{
+  FAR const struct sock_filter *insn;
+  uint32_t mem[BPF_MEMWORDS];
+  uint32_t a = 0;
+  uint32_t x = 0;
+  uint32_t value;
+  int pc;
+
+  memset(mem, 0, sizeof(mem));
+
+  for (pc = 0; pc < nfilter; pc++)
+    {
+      insn = &filter[pc];
+
+      switch (BPF_CLASS(insn->code))
+        {
+          case BPF_LD:
+            switch (BPF_MODE(insn->code))
+              {
+                case BPF_IMM:
+                  a = insn->k;
+                  break;
+
+                case BPF_LEN:
+                  a = len;
+                  break;
+
+                case BPF_MEM:
+                  a = mem[insn->k];
+                  break;
+
+                case BPF_ABS:
+                case BPF_IND:
+                  value = insn->k;
+                  if (BPF_MODE(insn->code) == BPF_IND)
+                    {
+                      value += x;
+                    }
+
+                  if (!pkt_filter_load(frame, len, value,
+                                       BPF_SIZE(insn->code), &a))
+                    {
+                      return 0;
+                    }
+                  break;
+              }
+            break;
+
+          case BPF_LDX:
+            switch (BPF_MODE(insn->code))
+              {
+                case BPF_IMM:
+                  x = insn->k;
+                  break;
+
+                case BPF_LEN:
+                  x = len;
+                  break;
+
+                case BPF_MEM:
+                  x = mem[insn->k];
+                  break;
+
+                case BPF_MSH:
+
+                  /* 4 * (frame[k] & 0xf):  The length of an IPv4 header */
+
+                  if (!pkt_filter_load(frame, len, insn->k, BPF_B, &value))
+                    {
+                      return 0;
+                    }
+
+                  x = (value & 0x0f) << 2;
+                  break;
+              }
+            break;
+
+          case BPF_ST:
+            mem[insn->k] = a;
+            break;
+
+          case BPF_STX:
+            mem[insn->k] = x;
+            break;
+
+          case BPF_ALU:
+            value = BPF_SRC(insn->code) == BPF_X ? x : insn->k;
+
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_ADD:
+                  a += value;
+                  break;
+
+                case BPF_SUB:
+                  a -= value;
+                  break;
+
+                case BPF_MUL:
+                  a *= value;
+                  break;
+
+                case BPF_DIV:
+                  if (value == 0)
+                    {
+                      return 0;
+                    }
+
+                  a /= value;
+                  break;
+
+                case BPF_MOD:
+                  if (value == 0)
+                    {
+                      return 0;
+                    }
+
+                  a %= value;
+                  break;
+
+                case BPF_OR:
+                  a |= value;
+                  break;
+
+                case BPF_AND:
+                  a &= value;
+                  break;
+
+                case BPF_LSH:
+                  a = value < 32 ? a << value : 0;
+                  break;
+
+                case BPF_RSH:
+                  a = value < 32 ? a >> value : 0;
+                  break;
+
+                case BPF_NEG:
+                  a = -a;
+                  break;
+
+                case BPF_XOR:
+                  a ^= value;
+                  break;
+              }
+            break;
+
+          case BPF_JMP:
+            value = BPF_SRC(insn->code) == BPF_X ? x : insn->k;
+
+            switch (BPF_OP(insn->code))
+              {
+                case BPF_JA:
+                  pc += insn->k;
+                  break;
+
+                case BPF_JEQ:
+                  pc += a == value ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JGT:
+                  pc += a > value ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JGE:
+                  pc += a >= value ? insn->jt : insn->jf;
+                  break;
+
+                case BPF_JSET:
+                  pc += (a & value) != 0 ? insn->jt : insn->jf;
+                  break;
+              }
+            break;
+
+          case BPF_RET:
+            return BPF_RVAL(insn->code) == BPF_A ? a : insn->k;
+
+          case BPF_MISC:
+            if (BPF_MISCOP(insn->code) == BPF_TAX)
+              {
+                x = a;
+              }
+            else
+              {
+                a = x;
+              }
+            break;
+        }
+    }
+
+  /* Not reached for a validated program */
+
+  return 0;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_FILTER */
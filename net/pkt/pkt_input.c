@@ -45,6 +45,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
+#include <stdint.h>
 #include <debug.h>
 
 #include <nuttx/net/netdev.h>
@@ -92,8 +93,39 @@ int pkt_input(struct net_driver_s *dev)
   conn = pkt_active(pbuf);
   if (conn)
     {
+      uint32_t snaplen = UINT32_MAX;
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_FILTER
+      /* Run any attached filter program first so that uninteresting
+       * frames are dropped before they are copied.
+       */
+
+      if (conn->filter != NULL)
+        {
+          snaplen = pkt_filter_run(conn->filter, conn->nfilter,
+                                   dev->d_buf, dev->d_len);
+          if (snaplen == 0)
+            {
+              return OK;
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+      /* With a receive ring, the frame is written into the ring instead of
+       * being passed to a pending recvfrom().
+       */
+
+      if (conn->ring != NULL)
+        {
+          pkt_ring_input(conn, dev, snaplen);
+          return OK;
+        }
+#endif
+
+      UNUSED(snaplen);
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PKT_RINGHDR(conn,n) \
+  ((FAR struct tpacket_hdr *)&(conn)->ring[(size_t)(n) * (conn)->framesize])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up or (if tp_block_nr is zero) release the memory-mapped receive
+ *   ring of a packet socket connection.  The ring is allocated from the
+ *   user heap so that the application may access it.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   req  - The requested ring layout
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req)
+{
+  uint32_t nframes;
+
+  if (req->tp_block_nr == 0)
+    {
+      pkt_ring_release(conn);
+      return OK;
+    }
+
+  if (conn->ring != NULL)
+    {
+      return -EBUSY;
+    }
+
+  /* Verify the layout */
+
+  if (req->tp_frame_size <= TPACKET_HDRLEN ||
+      (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+      req->tp_block_size < req->tp_frame_size ||
+      (req->tp_block_size % req->tp_frame_size) != 0 ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  nframes = (req->tp_block_size / req->tp_frame_size) * req->tp_block_nr;
+  if (nframes != req->tp_frame_nr)
+    {
+      return -EINVAL;
+    }
+
+  /* All frames initially belong to the kernel (TP_STATUS_KERNEL == 0) */
+
+  conn->ringsize  = (size_t)req->tp_block_size * req->tp_block_nr;
+  conn->ring      = (FAR uint8_t *)kumm_zalloc(conn->ringsize);
+  if (conn->ring == NULL)
+    {
+      conn->ringsize = 0;
+      return -ENOMEM;
+    }
+
+  conn->framesize = req->tp_frame_size;
+  conn->nframes   = nframes;
+  conn->head      = 0;
+  conn->drops     = 0;
+  conn->losing    = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Free the receive ring of a packet socket connection, if any.
+ *
+ ****************************************************************************/
+
+void pkt_ring_release(FAR struct pkt_conn_s *conn)
+{
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+      conn->ring     = NULL;
+      conn->ringsize = 0;
+      conn->nframes  = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the received frame in d_buf into the next frame of the receive
+ *   ring.  The frame is dropped if that frame still belongs to the user.
+ *
+ * Input Parameters:
+ *   conn    - The packet socket connection
+ *   dev     - The device driver structure containing the received frame
+ *   snaplen - The maximum number of bytes to capture
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct pkt_conn_s *conn,
+                    FAR struct net_driver_s *dev, uint32_t snaplen)
+{
+  FAR struct tpacket_hdr *hdr = PKT_RINGHDR(conn, conn->head);
+  struct timespec ts;
+  uint32_t status;
+  uint32_t maxlen;
+
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* The application has not yet consumed this frame */
+
+      conn->drops++;
+      conn->losing = true;
+      return;
+    }
+
+  maxlen = conn->framesize - TPACKET_HDRLEN;
+  if (snaplen > dev->d_len)
+    {
+      snaplen = dev->d_len;
+    }
+
+  if (snaplen > maxlen)
+    {
+      snaplen = maxlen;
+    }
+
+  memcpy((FAR uint8_t *)hdr + TPACKET_HDRLEN, dev->d_buf, snaplen);
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = TPACKET_HDRLEN;
+  hdr->tp_net     = TPACKET_HDRLEN + NET_LL_HDRLEN(dev);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / 1000;
+
+  /* Hand the frame to the application last */
+
+  status = TP_STATUS_USER;
+  if (conn->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      conn->losing = false;
+    }
+
+  hdr->tp_status = status;
+
+  if (++conn->head >= conn->nframes)
+    {
+      conn->head = 0;
+    }
+
+  /* Wake up any poll() on the ring */
+
+  if (conn->fds != NULL && (conn->fds->events & POLLIN) != 0)
+    {
+      conn->fds->revents |= POLLIN;
+      poll_notify(conn->fds);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Set up or tear down a poll() on the receive ring.  The ring is
+ *   readable if the most recently written frame still belongs to the user.
+ *   Only one poll() may wait on a ring at a time.
+ *
+ * Input Parameters:
+ *   conn  - The packet socket connection
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_poll(FAR struct pkt_conn_s *conn, FAR struct pollfd *fds,
+                  bool setup)
+{
+  FAR struct tpacket_hdr *hdr;
+  uint32_t prev;
+
+  if (!setup)
+    {
+      if (conn->fds == fds)
+        {
+          conn->fds = NULL;
+        }
+
+      return OK;
+    }
+
+  if (conn->ring == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (conn->fds != NULL)
+    {
+      return -EBUSY;
+    }
+
+  conn->fds = fds;
+
+  prev = conn->head == 0 ? conn->nframes - 1 : conn->head - 1;
+  hdr  = PKT_RINGHDR(conn, prev);
+
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      fds->revents |= (POLLIN & fds->events);
+    }
+
+  if (fds->revents != 0)
+    {
+      poll_notify(fds);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ioctl
+ *
+ * Description:
+ *   Handle the FIOC_MMAP ioctl command (as used by mmap()) on a packet
+ *   socket:  Return the address of the receive ring.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   cmd   - The ioctl command
+ *   arg   - The argument of the ioctl command
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOTTY if
+ *   the command or the socket is not handled here.
+ *
+ ****************************************************************************/
+
+int pkt_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+  if (psock->s_domain != PF_PACKET || cmd != FIOC_MMAP)
+    {
+      return -ENOTTY;
+    }
+
+  conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  if (conn == NULL || conn->ring == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (addr == NULL)
+    {
+      return -EINVAL;
+    }
+
+  *addr = conn->ring;
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
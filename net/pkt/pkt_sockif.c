@@ -521,7 +521,19 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Only a socket with a receive ring can be polled */
+
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  int ret;
+
+  net_lock();
+  ret = pkt_ring_poll(conn, fds, setup);
+  net_unlock();
+  return ret;
+#else
   return -ENOSYS;
+#endif
 }
 #endif /* !CONFIG_DISABLE_POLL */
 
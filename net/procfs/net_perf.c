@@ -0,0 +1,190 @@
+/****************************************************************************
+ * net/procfs/net_perf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *   Section         Count   Total us  Mean ns   Max ns
+ *   ipv4_input   xxxxxxxx   xxxxxxxx xxxxxxxx xxxxxxxx
+ *   ...
+ *
+ * Times are measured with hrtimer_now().  The tcp_input and udp_input times
+ * are included in the ipv4/6_input times and the driver_tx time is included
+ * in the devif_poll time.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/netstats.h>
+
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_PERF)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_perf_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_perf_counter(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The names of the counters, indexed by enum netperf_e */
+
+static FAR const char *g_perf_names[NETPERF_NCOUNTERS] =
+{
+  "ipv4_input",
+  "ipv6_input",
+  "tcp_input",
+  "udp_input",
+  "devif_poll",
+  "driver_tx",
+  "iob_wait",
+  "lock_wait",
+  "lock_hold"
+};
+
+/* Line generating functions.  The line number of netprocfs_perf_counter()
+ * less one is the counter to be shown.
+ */
+
+static const linegen_t g_perf_linegen[] =
+{
+  netprocfs_perf_header,
+  netprocfs_perf_counter,     /* NETPERF_IPv4_INPUT */
+  netprocfs_perf_counter,     /* NETPERF_IPv6_INPUT */
+  netprocfs_perf_counter,     /* NETPERF_TCP_INPUT */
+  netprocfs_perf_counter,     /* NETPERF_UDP_INPUT */
+  netprocfs_perf_counter,     /* NETPERF_DEVIF_POLL */
+  netprocfs_perf_counter,     /* NETPERF_DRIVER_TX */
+  netprocfs_perf_counter,     /* NETPERF_IOB_WAIT */
+  netprocfs_perf_counter,     /* NETPERF_LOCK_WAIT */
+  netprocfs_perf_counter      /* NETPERF_LOCK_HOLD */
+};
+
+#define NPERF_LINES (sizeof(g_perf_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_perf_header
+ ****************************************************************************/
+
+static int netprocfs_perf_header(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-10s %10s %10s %8s %8s\n",
+                  "Section", "Count", "Total us", "Mean ns", "Max ns");
+}
+
+/****************************************************************************
+ * Name: netprocfs_perf_counter
+ ****************************************************************************/
+
+static int netprocfs_perf_counter(FAR struct netprocfs_file_s *netfile)
+{
+  struct netperf_s perf;
+  unsigned long mean;
+  irqstate_t flags;
+  int id = netfile->lineno - 1;
+
+  DEBUGASSERT(id >= 0 && id < NETPERF_NCOUNTERS);
+
+  /* Take a consistent snapshot of the counter */
+
+  flags = enter_critical_section();
+  perf  = g_netperf[id];
+  leave_critical_section(flags);
+
+  mean = 0;
+  if (perf.np_count > 0)
+    {
+      mean = (unsigned long)(perf.np_total / perf.np_count);
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-10s %10lu %10lu %8lu %8lu\n",
+                  g_perf_names[id], (unsigned long)perf.np_count,
+                  (unsigned long)(perf.np_total / 1000), mean,
+                  (unsigned long)perf.np_max);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_perf
+ *
+ * Description:
+ *   Read and format the network performance counters.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_perf(FAR struct netprocfs_file_s *priv,
+                            FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen, g_perf_linegen,
+                                NPERF_LINES);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_PERF */
@@ -75,12 +75,19 @@
 #  define STAT_INDEX     0
 #  ifdef CONFIG_NET_MLD
 #    define MLD_INDEX    1
-#    define _ROUTE_INDEX 2
+#    define _PERF_INDEX  2
 #  else
-#    define _ROUTE_INDEX 1
+#    define _PERF_INDEX  1
 #  endif
 #else
-#  define _ROUTE_INDEX   0
+#  define _PERF_INDEX    0
+#endif
+
+#ifdef CONFIG_NET_PERF
+#  define PERF_INDEX     _PERF_INDEX
+#  define _ROUTE_INDEX   (_PERF_INDEX + 1)
+#else
+#  define _ROUTE_INDEX   _PERF_INDEX
 #endif
 
 #ifdef CONFIG_NET_ROUTE
@@ -193,6 +200,19 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 #endif
 #endif
 
+#ifdef CONFIG_NET_PERF
+  /* "net/perf" is an acceptable value for the relpath only if the network
+   * performance counters are enabled.
+   */
+
+  if (strcmp(relpath, "net/perf") == 0)
+    {
+      entry = NETPROCFS_SUBDIR_PERF;
+      dev   = NULL;
+    }
+  else
+#endif
+
 #ifdef CONFIG_NET_ROUTE
   /* "net/route" is an acceptable value for the relpath only if routing
    * table support is initialized.
@@ -320,6 +340,14 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
 #endif
 #endif
 
+#ifdef CONFIG_NET_PERF
+      case NETPROCFS_SUBDIR_PERF:
+        /* Show the network performance counters */
+
+        nreturned = netprocfs_read_perf(priv, buffer, buflen);
+        break;
+#endif
+
 #ifdef CONFIG_NET_ROUTE
       case NETPROCFS_SUBDIR_ROUTE:
         nerr("ERROR: Cannot read from directory net/route\n");
@@ -440,6 +468,9 @@ static int netprocfs_opendir(FAR const char *relpath,
       level1->base.nentries++;
 #endif
 #endif
+#ifdef CONFIG_NET_PERF
+      level1->base.nentries++;
+#endif
 #ifdef CONFIG_NET_ROUTE
       level1->base.nentries++;
 #endif
@@ -546,6 +577,16 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
       else
 #endif
 #endif
+#ifdef CONFIG_NET_PERF
+      if (index == PERF_INDEX)
+        {
+          /* Copy the performance counter directory entry */
+
+          dir->fd_dir.d_type = DTYPE_FILE;
+          strncpy(dir->fd_dir.d_name, "perf", NAME_MAX + 1);
+        }
+      else
+#endif
 #ifdef CONFIG_NET_ROUTE
       if (index == ROUTE_INDEX)
         {
@@ -677,6 +718,15 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
   else
 #endif
 #endif
+#ifdef CONFIG_NET_PERF
+  /* Check for performance counters "net/perf" */
+
+  if (strcmp(relpath, "net/perf") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
+#endif
 #ifdef CONFIG_NET_ROUTE
   /* Check for network statistics "net/stat" */
 
@@ -79,6 +79,10 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_6LOWPAN
+static int     netprocfs_sixlowpan_1(FAR struct netprocfs_file_s *netfile);
+static int     netprocfs_sixlowpan_2(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_6LOWPAN */
 
 /****************************************************************************
  * Private Data
@@ -113,6 +117,11 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_6LOWPAN
+  , netprocfs_sixlowpan_1
+  , netprocfs_sixlowpan_2
+#endif /* CONFIG_NET_6LOWPAN */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -435,6 +444,36 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_sixlowpan_1
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_6LOWPAN)
+static int netprocfs_sixlowpan_1(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  6LoWPAN   Reass: %04x  Done: %04x   Frg: %04x\n",
+                  g_netstats.sixlowpan.reassalloc,
+                  g_netstats.sixlowpan.reassdone,
+                  g_netstats.sixlowpan.fragerr);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_6LOWPAN */
+
+/****************************************************************************
+ * Name: netprocfs_sixlowpan_2
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_6LOWPAN)
+static int netprocfs_sixlowpan_2(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "            Tmo: %04x  Evct: %04x  Drop: %04x\n",
+                  g_netstats.sixlowpan.reasstimeout,
+                  g_netstats.sixlowpan.reassevict,
+                  g_netstats.sixlowpan.reassdrop);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_6LOWPAN */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
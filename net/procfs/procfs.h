@@ -75,6 +75,9 @@ enum netprocfs_entry_e
   , NETPROCFS_SUBDIR_MLD             /* /proc/net/mld */
 #endif
 #endif
+#ifdef CONFIG_NET_PERF
+  , NETPROCFS_SUBDIR_PERF            /* /proc/net/perf */
+#endif
 #ifdef CONFIG_NET_ROUTE
   , NETPROCFS_SUBDIR_ROUTE           /* /proc/net/route */
 #endif
@@ -195,6 +198,29 @@ ssize_t netprocfs_read_mldstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_perf
+ *
+ * Description:
+ *   Read and format the network performance counters.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PERF
+ssize_t netprocfs_read_perf(FAR struct netprocfs_file_s *priv,
+                            FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_routes
  *
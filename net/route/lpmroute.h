@@ -0,0 +1,144 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H 1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Look up the most specific route to the target address using the
+ *   longest-prefix-match index.  The index is (re-)built from the routing
+ *   table (RAM, ROM, or file) on the first look-up after it has been
+ *   flushed.
+ *
+ * Input Parameters:
+ *   target - The target IP address on the remote network
+ *   router - The location to return the router address
+ *
+ * Returned Value:
+ *   OK is returned if a route was found; -ENOENT is returned if there is
+ *   no route to the target.  Any other negated errno value means that the
+ *   index could not be built (for example, it ran out of memory or the
+ *   table contains a non-contiguous netmask) and the caller must fall back
+ *   to a linear search of the routing table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      FAR net_ipv6addr_t router);
+#endif
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one new route to the longest-prefix-match index.  Must be called
+ *   after the route has been added to the routing table.  If a route with
+ *   the same prefix is already present, the older route is retained
+ *   (consistent with the first-match behavior of the routing table).
+ *
+ * Input Parameters:
+ *   route - The new routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(FAR const struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(FAR const struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Discard the longest-prefix-match index.  It will be rebuilt from the
+ *   routing table on the next look-up.  Must be called whenever a route is
+ *   removed from the routing table.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void);
+#endif
+
+#else /* CONFIG_ROUTE_LPM */
+
+#  define net_addlpm_ipv4(r)
+#  define net_addlpm_ipv6(r)
+#  define net_flushlpm_ipv4()
+#  define net_flushlpm_ipv6()
+
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
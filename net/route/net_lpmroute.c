@@ -0,0 +1,651 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/lpmroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the largest address that the index must hold */
+
+#ifdef CONFIG_NET_IPv6
+#  define LPM_ADDRSIZE  sizeof(net_ipv6addr_t)
+#else
+#  define LPM_ADDRSIZE  sizeof(in_addr_t)
+#endif
+
+/* State of one index */
+
+#define LPM_STALE       0  /* Must be rebuilt from the routing table */
+#define LPM_VALID       1  /* Mirrors the routing table */
+#define LPM_FAILED      2  /* Could not be built; use a linear search */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the path-compressed binary trie.  Each node represents the
+ * prefix of length ln_plen held in ln_key.  The prefix of every node below
+ * a node begins with the prefix of that node; the child is selected by the
+ * bit following the parent's prefix.  Nodes that do not correspond to a
+ * route (ln_valid == false) only exist where two branches diverge so the
+ * depth of the trie never exceeds the length of the longest prefix.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *ln_child[2]; /* Children for next bit 0 and 1 */
+  uint8_t ln_plen;                    /* Prefix length in bits */
+  bool    ln_valid;                   /* True: node holds a route */
+  uint8_t ln_key[LPM_ADDRSIZE];       /* Prefix in network order */
+  uint8_t ln_router[LPM_ADDRSIZE];    /* Router address */
+};
+
+/* One longest-prefix-match index */
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *lt_root;     /* Root of the trie */
+  uint8_t lt_state;                   /* See LPM_* definitions */
+  uint8_t lt_addrsize;                /* Size of one address in bytes */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_trie_s g_ipv4_lpm =
+{
+  NULL, LPM_STALE, sizeof(in_addr_t)
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_trie_s g_ipv6_lpm =
+{
+  NULL, LPM_STALE, sizeof(net_ipv6addr_t)
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return the value of bit 'bit' of an address in network order (bit 0
+ *   is the most significant bit of the first byte).
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, unsigned int bit)
+{
+  return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits that two addresses have in common,
+ *   up to a maximum of 'maxbits'.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                               unsigned int maxbits)
+{
+  unsigned int nbits;
+  unsigned int i;
+  uint8_t diff;
+
+  for (i = 0; (i << 3) < maxbits; i++)
+    {
+      diff = a[i] ^ b[i];
+      if (diff != 0)
+        {
+          nbits = i << 3;
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          return nbits < maxbits ? nbits : maxbits;
+        }
+    }
+
+  return maxbits;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Convert a netmask to a prefix length.  Returns -EINVAL if the netmask
+ *   is not contiguous and so cannot be represented in the trie.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *mask, unsigned int masksize)
+{
+  unsigned int plen = 0;
+  unsigned int i;
+  uint8_t byte;
+
+  for (i = 0; i < masksize && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < masksize)
+    {
+      byte = mask[i++];
+      while ((byte & 0x80) != 0)
+        {
+          byte <<= 1;
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < masksize; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return (int)plen;
+}
+
+/****************************************************************************
+ * Name: lpm_newnode
+ *
+ * Description:
+ *   Allocate a new node for the prefix of length 'plen' of 'key'.  The
+ *   node holds a route if 'router' is non-NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *
+lpm_newnode(FAR struct lpm_trie_s *trie, FAR const uint8_t *key,
+            unsigned int plen, FAR const uint8_t *router)
+{
+  FAR struct lpm_node_s *node;
+  unsigned int nbytes;
+
+  node = (FAR struct lpm_node_s *)kmm_zalloc(sizeof(struct lpm_node_s));
+  if (node != NULL)
+    {
+      /* Copy only the bits of the prefix, leaving the remainder zero */
+
+      nbytes = plen >> 3;
+      memcpy(node->ln_key, key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->ln_key[nbytes] = key[nbytes] & (0xff << (8 - (plen & 7)));
+        }
+
+      node->ln_plen = plen;
+      if (router != NULL)
+        {
+          memcpy(node->ln_router, router, trie->lt_addrsize);
+          node->ln_valid = true;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add the route 'key/plen via router' to the trie.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_trie_s *trie, FAR const uint8_t *key,
+                      unsigned int plen, FAR const uint8_t *router)
+{
+  FAR struct lpm_node_s **pnode;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *glue;
+  unsigned int ncommon;
+
+  for (pnode = &trie->lt_root; (node = *pnode) != NULL; )
+    {
+      ncommon = lpm_common(node->ln_key, key,
+                           plen < node->ln_plen ? plen : node->ln_plen);
+
+      if (ncommon < node->ln_plen)
+        {
+          /* The new prefix diverges from this node (or is shorter than
+           * it).  It must be inserted above this node.
+           */
+
+          leaf = lpm_newnode(trie, key, plen, router);
+          if (leaf == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          if (ncommon == plen)
+            {
+              /* The new prefix is a prefix of this node */
+
+              leaf->ln_child[lpm_bit(node->ln_key, plen)] = node;
+              *pnode = leaf;
+              return OK;
+            }
+
+          /* Otherwise, a new branch point is needed where the two
+           * diverge.
+           */
+
+          glue = lpm_newnode(trie, key, ncommon, NULL);
+          if (glue == NULL)
+            {
+              kmm_free(leaf);
+              return -ENOMEM;
+            }
+
+          glue->ln_child[lpm_bit(key, ncommon)]          = leaf;
+          glue->ln_child[lpm_bit(node->ln_key, ncommon)] = node;
+          *pnode = glue;
+          return OK;
+        }
+
+      if (node->ln_plen == plen)
+        {
+          /* This node has exactly the same prefix.  Keep the older route
+           * if there is one.
+           */
+
+          if (!node->ln_valid)
+            {
+              memcpy(node->ln_router, router, trie->lt_addrsize);
+              node->ln_valid = true;
+            }
+
+          return OK;
+        }
+
+      /* This node's prefix is a prefix of the new one; descend */
+
+      pnode = &node->ln_child[lpm_bit(key, node->ln_plen)];
+    }
+
+  leaf = lpm_newnode(trie, key, plen, router);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *pnode = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Return the node with the longest prefix that matches 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_lookup(FAR struct lpm_trie_s *trie,
+                                         FAR const uint8_t *key)
+{
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *best = NULL;
+  unsigned int maxbits = (unsigned int)trie->lt_addrsize << 3;
+
+  for (node = trie->lt_root; node != NULL; )
+    {
+      if (lpm_common(node->ln_key, key, node->ln_plen) < node->ln_plen)
+        {
+          break;
+        }
+
+      if (node->ln_valid)
+        {
+          best = node;
+        }
+
+      if (node->ln_plen >= maxbits)
+        {
+          break;
+        }
+
+      node = node->ln_child[lpm_bit(key, node->ln_plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: lpm_free
+ *
+ * Description:
+ *   Free all nodes of the trie and mark it stale.  The trie is flattened
+ *   by rotation as it is freed so that no recursion is required.
+ *
+ ****************************************************************************/
+
+static void lpm_free(FAR struct lpm_trie_s *trie)
+{
+  FAR struct lpm_node_s *node = trie->lt_root;
+  FAR struct lpm_node_s *next;
+
+  while (node != NULL)
+    {
+      next = node->ln_child[0];
+      if (next != NULL)
+        {
+          node->ln_child[0] = next->ln_child[1];
+          next->ln_child[1] = node;
+        }
+      else
+        {
+          next = node->ln_child[1];
+          kmm_free(node);
+        }
+
+      node = next;
+    }
+
+  trie->lt_root  = NULL;
+  trie->lt_state = LPM_STALE;
+}
+
+/****************************************************************************
+ * Name: lpm_add
+ *
+ * Description:
+ *   Add one routing table entry to the trie
+ *
+ ****************************************************************************/
+
+static int lpm_add(FAR struct lpm_trie_s *trie, FAR const void *target,
+                   FAR const void *netmask, FAR const void *router)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)netmask, trie->lt_addrsize);
+  if (plen < 0)
+    {
+      nwarn("WARNING: Non-contiguous netmask\n");
+      return plen;
+    }
+
+  return lpm_insert(trie, (FAR const uint8_t *)target, plen,
+                    (FAR const uint8_t *)router);
+}
+
+/****************************************************************************
+ * Name: lpm_addroute_ipv4 and lpm_addroute_ipv6
+ *
+ * Description:
+ *   Routing table traversal call-outs used to build the index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_addroute_ipv4(FAR struct net_route_ipv4_s *route,
+                             FAR void *arg)
+{
+  return lpm_add(&g_ipv4_lpm, &route->target, &route->netmask,
+                 &route->router);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_addroute_ipv6(FAR struct net_route_ipv6_s *route,
+                             FAR void *arg)
+{
+  return lpm_add(&g_ipv6_lpm, route->target, route->netmask,
+                 route->router);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Look up the most specific route to the target address using the
+ *   longest-prefix-match index.  The index is (re-)built from the routing
+ *   table (RAM, ROM, or file) on the first look-up after it has been
+ *   flushed.
+ *
+ * Input Parameters:
+ *   target - The target IP address on the remote network
+ *   router - The location to return the router address
+ *
+ * Returned Value:
+ *   OK is returned if a route was found; -ENOENT is returned if there is
+ *   no route to the target.  Any other negated errno value means that the
+ *   index could not be built and the caller must fall back to a linear
+ *   search of the routing table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct lpm_node_s *node;
+  int ret;
+
+  if (g_ipv4_lpm.lt_state == LPM_STALE)
+    {
+      g_ipv4_lpm.lt_state = LPM_VALID;
+      ret = net_foreachroute_ipv4(lpm_addroute_ipv4, NULL);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to build IPv4 LPM index: %d\n", ret);
+          lpm_free(&g_ipv4_lpm);
+          g_ipv4_lpm.lt_state = LPM_FAILED;
+        }
+    }
+
+  if (g_ipv4_lpm.lt_state != LPM_VALID)
+    {
+      return -ENOSYS;
+    }
+
+  node = lpm_lookup(&g_ipv4_lpm, (FAR const uint8_t *)&target);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(router, node->ln_router, sizeof(in_addr_t));
+  return OK;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      FAR net_ipv6addr_t router)
+{
+  FAR struct lpm_node_s *node;
+  int ret;
+
+  if (g_ipv6_lpm.lt_state == LPM_STALE)
+    {
+      g_ipv6_lpm.lt_state = LPM_VALID;
+      ret = net_foreachroute_ipv6(lpm_addroute_ipv6, NULL);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to build IPv6 LPM index: %d\n", ret);
+          lpm_free(&g_ipv6_lpm);
+          g_ipv6_lpm.lt_state = LPM_FAILED;
+        }
+    }
+
+  if (g_ipv6_lpm.lt_state != LPM_VALID)
+    {
+      return -ENOSYS;
+    }
+
+  node = lpm_lookup(&g_ipv6_lpm, (FAR const uint8_t *)target);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(router, node->ln_router, sizeof(net_ipv6addr_t));
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one new route to the longest-prefix-match index.  Must be called
+ *   after the route has been added to the routing table.
+ *
+ * Input Parameters:
+ *   route - The new routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(FAR const struct net_route_ipv4_s *route)
+{
+  net_lock();
+  if (g_ipv4_lpm.lt_state != LPM_VALID ||
+      lpm_add(&g_ipv4_lpm, &route->target, &route->netmask,
+              &route->router) < 0)
+    {
+      /* Rebuild (or retry the build) on the next look-up */
+
+      lpm_free(&g_ipv4_lpm);
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(FAR const struct net_route_ipv6_s *route)
+{
+  net_lock();
+  if (g_ipv6_lpm.lt_state != LPM_VALID ||
+      lpm_add(&g_ipv6_lpm, route->target, route->netmask,
+              route->router) < 0)
+    {
+      lpm_free(&g_ipv6_lpm);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Discard the longest-prefix-match index.  It will be rebuilt from the
+ *   routing table on the next look-up.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void)
+{
+  net_lock();
+  lpm_free(&g_ipv4_lpm);
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void)
+{
+  net_lock();
+  lpm_free(&g_ipv6_lpm);
+  net_unlock();
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
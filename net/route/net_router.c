@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -57,7 +58,7 @@
  * Pre-processor defintions
  ****************************************************************************/
 
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
 #  define IPv4_ROUTER entry.router
 #else
 #  define IPv4_ROUTER router
@@ -221,6 +222,18 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the most specific route in the longest-prefix-match index.
+   * Fall back to a linear search only if the index could not be built.
+   */
+
+  ret = net_lpmroute_ipv4(target, router);
+  if (ret == OK || ret == -ENOENT)
+    {
+      return ret;
+    }
+
+#endif
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -296,6 +309,18 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the most specific route in the longest-prefix-match index.
+   * Fall back to a linear search only if the index could not be built.
+   */
+
+  ret = net_lpmroute_ipv6(target, router);
+  if (ret == OK || ret == -ENOENT)
+    {
+      return ret;
+    }
+
+#endif
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -99,6 +99,7 @@ struct sixlowpan_addrcontext_s
   uint8_t used;       /* Possibly use as prefix-length */
   uint8_t number;
   uint8_t prefix[8];
+  uint16_t match[4];  /* Prefix in the network order of net_ipv6addr_t */
 };
 
 /****************************************************************************
@@ -117,6 +118,23 @@ struct sixlowpan_addrcontext_s
 
 static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
+
+/* Look-up tables that are precomputed from the address contexts when they
+ * are initialized:  The context for each of the 16 possible context
+ * numbers, the list of used contexts, and the context that matched last.
+ */
+
+static FAR struct sixlowpan_addrcontext_s *g_hc06_ctxbynumber[16];
+static FAR struct sixlowpan_addrcontext_s *
+  g_hc06_ctxlist[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
+static FAR struct sixlowpan_addrcontext_s *g_hc06_lastctx;
+static uint8_t g_hc06_nctx;
+
+/* True if some context has a link-local prefix.  Otherwise, there is no
+ * need to search the contexts for link-local addresses.
+ */
+
+static bool g_hc06_llctx;
 #endif
 
 /* Pointer to the byte where to write next inline field. */
@@ -202,20 +220,33 @@ static FAR struct sixlowpan_addrcontext_s *
    */
 
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-  int i;
+  /* Context numbers are four-bit values */
 
-  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
-    {
-      if ((g_hc06_addrcontexts[i].used == 1) &&
-           g_hc06_addrcontexts[i].number == number)
-        {
-          return &g_hc06_addrcontexts[i];
-        }
-    }
+  return g_hc06_ctxbynumber[number & 0x0f];
+#else
+  return NULL;
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
+}
 
-  return NULL;
+/****************************************************************************
+ * Name: match_addrcontext
+ *
+ * Description:
+ *   Return true if the 64-bit prefix of ipaddr matches the address context.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+static inline bool
+  match_addrcontext(FAR const struct sixlowpan_addrcontext_s *addrcontext,
+                    FAR const net_ipv6addr_t ipaddr)
+{
+  return ipaddr[0] == addrcontext->match[0] &&
+         ipaddr[1] == addrcontext->match[1] &&
+         ipaddr[2] == addrcontext->match[2] &&
+         ipaddr[3] == addrcontext->match[3];
 }
+#endif
 
 /****************************************************************************
  * Name: find_addrcontext_byprefix
@@ -229,21 +260,40 @@ static FAR struct sixlowpan_addrcontext_s *
   find_addrcontext_byprefix(FAR const net_ipv6addr_t ipaddr)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+  FAR struct sixlowpan_addrcontext_s *addrcontext;
   int i;
 
   /* Remove code to avoid warnings and save flash if no address context is used */
 
-  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+  /* Fast path:  Link-local addresses do not use a context unless one was
+   * configured with the link-local prefix.
+   */
+
+  if (g_hc06_nctx == 0 || (net_is_addr_linklocal(ipaddr) && !g_hc06_llctx))
+    {
+      return NULL;
+    }
+
+  /* Most traffic uses the same (mesh-local) prefix as the last packet */
+
+  addrcontext = g_hc06_lastctx;
+  if (addrcontext != NULL && match_addrcontext(addrcontext, ipaddr))
+    {
+      return addrcontext;
+    }
+
+  for (i = 0; i < g_hc06_nctx; i++)
     {
-      if ((g_hc06_addrcontexts[i].used == 1) &&
-          net_ipv6addr_prefixcmp(&g_hc06_addrcontexts[i].prefix, ipaddr, 64))
+      addrcontext = g_hc06_ctxlist[i];
+      if (match_addrcontext(addrcontext, ipaddr))
         {
           ninfo("Context found for ipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x Context: %d\n",
                 ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]), ntohs(ipaddr[3]),
                 ntohs(ipaddr[4]), ntohs(ipaddr[5]), ntohs(ipaddr[6]), ntohs(ipaddr[7]),
-                g_hc06_addrcontexts[i].number);
+                addrcontext->number);
 
-          return &g_hc06_addrcontexts[i];
+          g_hc06_lastctx = addrcontext;
+          return addrcontext;
         }
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
@@ -578,9 +628,7 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
 void sixlowpan_hc06_initialize(void)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
-#endif
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -642,6 +690,31 @@ void sixlowpan_hc06_initialize(void)
 #endif /* SIXLOWPAN_CONF_ADDR_CONTEXT_1 */
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1 */
+
+  /* Precompute the tables used to find the address contexts */
+
+  memset(g_hc06_ctxbynumber, 0, sizeof(g_hc06_ctxbynumber));
+  g_hc06_lastctx = NULL;
+  g_hc06_nctx    = 0;
+  g_hc06_llctx   = false;
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+    {
+      FAR struct sixlowpan_addrcontext_s *addrcontext =
+        &g_hc06_addrcontexts[i];
+
+      if (addrcontext->used == 1)
+        {
+          memcpy(addrcontext->match, addrcontext->prefix, 8);
+          g_hc06_ctxbynumber[addrcontext->number & 0x0f] = addrcontext;
+          g_hc06_ctxlist[g_hc06_nctx++] = addrcontext;
+
+          if (net_is_addr_linklocal(addrcontext->match))
+            {
+              g_hc06_llctx = true;
+            }
+        }
+    }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 }
 
@@ -731,9 +804,16 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
    * byte with [ SCI | DCI ]
    */
 
-  /* Check if dest address context exists (for allocating third byte) */
+  /* Check if dest address context exists (for allocating third byte).
+   * Address contexts are only used with unicast destination addresses.
+   */
+
+  daddrcontext = NULL;
+  if (!net_is_addr_mcast(ipv6->destipaddr))
+    {
+      daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+    }
 
-  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
   saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
 
   if (daddrcontext != NULL || saddrcontext != NULL)
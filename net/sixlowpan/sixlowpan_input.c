@@ -60,6 +60,7 @@
 #include "nuttx/net/ip.h"
 #include "nuttx/net/icmpv6.h"
 #include "nuttx/net/sixlowpan.h"
+#include "nuttx/net/netstats.h"
 #include "nuttx/wireless/ieee802154/ieee802154_mac.h"
 
 #ifdef CONFIG_NET_PKT
@@ -401,6 +402,9 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
           {
             nerr("ERROR: Failed to find a reassembly buffer for tag=%04x\n",
                  fragtag);
+#ifdef CONFIG_NET_STATISTICS
+            g_netstats.sixlowpan.fragerr++;
+#endif
             return -ENOENT;
           }
 
@@ -574,6 +578,13 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
     {
       ninfo("IP packet ready (length %d)\n", reass->rb_pktlen);
 
+#ifdef CONFIG_NET_STATISTICS
+      if (isfrag)
+        {
+          g_netstats.sixlowpan.reassdone++;
+        }
+#endif
+
       radio->r_dev.d_buf  = reass->rb_buf;
       radio->r_dev.d_len  = reass->rb_pktlen;
       reass->rb_active    = false;
@@ -49,6 +49,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/netstats.h>
 
 #include "sixlowpan_internal.h"
 
@@ -60,6 +61,22 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Active reassembly buffers are kept in a hash table indexed by the
+ * reassembly tag and the source address.
+ */
+
+#define REASS_HASH_MASK (CONFIG_NET_6LOWPAN_REASS_NHASH - 1)
+
+#if (CONFIG_NET_6LOWPAN_REASS_NHASH & REASS_HASH_MASK) != 0
+#  error CONFIG_NET_6LOWPAN_REASS_NHASH must be a power of two
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  define REASS_STAT(f) g_netstats.sixlowpan.f++
+#else
+#  define REASS_STAT(f)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -71,9 +88,20 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* This is the hash table of active, allocated reassemby buffers */
+
+static FAR struct sixlowpan_reassbuf_s *
+  g_active_reass[CONFIG_NET_6LOWPAN_REASS_NHASH];
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+/* The number of buffers in g_active_reass[] */
+
+static uint16_t g_nactive_reass;
+
+/* The time at which the oldest active reassembly buffer expires.  There is
+ * no need to examine the active reassembly buffers before then.
+ */
+
+static clock_t g_reass_deadline;
 
 /* Pool of pre-allocated reassembly buffer stuctures */
 
@@ -115,14 +143,47 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the index of the hash table entry for the reassembly tag and
+ *   source address.
+ *
+ * Input Parameters:
+ *   reasstag - The reassembly tag.
+ *   fragsrc  - The source address of the fragment.
+ *
+ * Returned Value:
+ *   The hash table index.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+
+  /* The last byte of the source address differs the most between nodes */
+
+  if (fragsrc->nv_addrlen > 0)
+    {
+      hash ^= (unsigned int)fragsrc->nv_addr[fragsrc->nv_addrlen - 1] << 3;
+    }
+
+  return (hash ^ (hash >> 8)) & REASS_HASH_MASK;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
  * Description:
- *   Free all expired or inactive reassembly buffers.
+ *   Free all expired or inactive reassembly buffers.  Unless 'force' is
+ *   true, nothing is done before the oldest reassembly buffer expires.
  *
  * Input Parameters:
- *   None
+ *   force - Examine the reassembly buffers even if none has expired.
  *
  * Returned Value:
  *   None
@@ -132,43 +193,114 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  *
  ****************************************************************************/
 
-static void sixlowpan_reass_expire(void)
+static void sixlowpan_reass_expire(bool force)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
+  clock_t now;
   clock_t elapsed;
+  clock_t oldest;
+  int i;
+
+  if (g_nactive_reass == 0)
+    {
+      return;
+    }
+
+  now = clock_systimer();
+  if (!force && (sclock_t)(now - g_reass_deadline) < 0)
+    {
+      return;
+    }
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  oldest = now;
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_NHASH; i++)
     {
-      /* Needed if 'reass' is freed */
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
+        {
+          /* Needed if 'reass' is freed */
 
-      next = reass->rb_flink;
+          next = reass->rb_flink;
 
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not cerain.
+           */
+
+          if (!reass->rb_active)
+            {
+              sixlowpan_reass_free(reass);
+              continue;
+            }
 
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
           /* Get the elpased time of the reassembly */
 
-          elapsed = clock_systimer() - reass->rb_time;
+          elapsed = now - reass->rb_time;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* If the reassembly has expired, then free the reassembly
+           * buffer.
+           */
 
           if (elapsed > NET_6LOWPAN_TIMEOUT)
             {
               nwarn("WARNING: Reassembly timed out\n");
+              REASS_STAT(reasstimeout);
               sixlowpan_reass_free(reass);
             }
+          else if ((sclock_t)(reass->rb_time - oldest) < 0)
+            {
+              oldest = reass->rb_time;
+            }
+        }
+    }
+
+  g_reass_deadline = oldest + NET_6LOWPAN_TIMEOUT + 1;
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_evict
+ *
+ * Description:
+ *   All reassembly buffers are in use.  Cancel the oldest reassembly; it
+ *   is the one most likely to have lost a fragment.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void sixlowpan_reass_evict(void)
+{
+  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reassbuf_s *oldest = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_NHASH; i++)
+    {
+      for (reass = g_active_reass[i]; reass != NULL; reass = reass->rb_flink)
+        {
+          if (oldest == NULL ||
+              (sclock_t)(reass->rb_time - oldest->rb_time) < 0)
+            {
+              oldest = reass;
+            }
         }
     }
+
+  if (oldest != NULL)
+    {
+      nwarn("WARNING: Cancelling reassembly of tag=%04x\n",
+            oldest->rb_reasstag);
+      REASS_STAT(reassevict);
+      sixlowpan_reass_free(oldest);
+    }
 }
 
 /****************************************************************************
@@ -192,10 +324,19 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
+  unsigned int hash;
+
+  /* Reassembly buffers provided by the radio driver are never active */
+
+  if (reass->rb_pool == REASS_POOL_RADIO)
+    {
+      return;
+    }
 
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  hash = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = g_active_reass[hash];
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -209,12 +350,14 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          g_active_reass[hash] = reass->rb_flink;
         }
       else
         {
           prev->rb_flink = reass->rb_flink;
         }
+
+      g_nactive_reass--;
     }
 
   reass->rb_flink = NULL;
@@ -263,6 +406,9 @@ void sixlowpan_reass_initialize(void)
       reass->rb_flink = g_free_reass;
       g_free_reass    = reass;
     }
+
+  memset(g_active_reass, 0, sizeof(g_active_reass));
+  g_nactive_reass = 0;
 }
 
 /****************************************************************************
@@ -274,7 +420,8 @@ void sixlowpan_reass_initialize(void)
  *
  *   This function will first attempt to allocate from the g_free_reass
  *   list.  If that the list is empty, then the reassembly buffer structure
- *   will be allocated from the dynamic memory pool.
+ *   will be allocated from the dynamic memory pool.  If that also fails,
+ *   the oldest reassembly in progress is cancelled and its buffer reused.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag for subsequent lookup.
@@ -294,14 +441,25 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reassbuf_s *reass = NULL;
+  unsigned int hash;
   uint8_t pool;
 
   /* First, removed any expired or inactive reassembly buffers.  This might
    * free up a pre-allocated buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  sixlowpan_reass_expire(g_free_reass == NULL);
+
+  /* The sender is starting over with a tag that is still in use (perhaps
+   * the FRAG1 was retransmitted).  Discard the old reassembly.
+   */
+
+  reass = sixlowpan_reass_find(reasstag, fragsrc);
+  if (reass != NULL)
+    {
+      sixlowpan_reass_free(reass);
+    }
 
   /* Now, try the free list first */
 
@@ -324,6 +482,22 @@ FAR struct sixlowpan_reassbuf_s *
         kmm_malloc((sizeof (struct sixlowpan_reassbuf_s)));
       pool  = REASS_POOL_DYNAMIC;
 #endif
+
+      /* Cancel the oldest reassembly if we still have no buffer.  This will
+       * return a buffer to the free list unless all of the reassembly
+       * buffers were dynamically allocated.
+       */
+
+      if (reass == NULL)
+        {
+          sixlowpan_reass_evict();
+          if (g_free_reass != NULL)
+            {
+              reass         = g_free_reass;
+              g_free_reass  = reass->rb_flink;
+              pool          = REASS_POOL_PREALLOCATED;
+            }
+        }
     }
 
   /* We have successfully allocated memory from some source? */
@@ -339,10 +513,24 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systimer();
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* Add the reassembly buffer to the table of active reassembly
+       * buffers.
+       */
+
+      hash                 = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink      = g_active_reass[hash];
+      g_active_reass[hash] = reass;
+
+      if (g_nactive_reass++ == 0)
+        {
+          g_reass_deadline = reass->rb_time + NET_6LOWPAN_TIMEOUT + 1;
+        }
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      REASS_STAT(reassalloc);
+    }
+  else
+    {
+      REASS_STAT(reassdrop);
     }
 
   return reass;
@@ -373,24 +561,25 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* First, removed any expired reassembly buffers (we don't want to return
+   * old reassembly buffer with the same tag)
    */
 
-  sixlowpan_reass_expire();
+  sixlowpan_reass_expire(false);
 
   /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+   * reassembly buffers with the same hash.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  reass = g_active_reass[sixlowpan_reass_hash(reasstag, fragsrc)];
+  for (; reass != NULL; reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
        * reassembly tag).
        */
 
-      if (reass->rb_reasstag == reasstag &&
+      if (reass->rb_active && reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
           return reass;
@@ -152,6 +152,10 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
 #endif
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_TIMESTAMP:  /* Report the reception time of datagrams */
+#ifdef CONFIG_NET_SOREUSEPORT
+      case SO_REUSEPORT:  /* Share a local port among several sockets */
+#endif
         {
           sockopt_t optionset;
 
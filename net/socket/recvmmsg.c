@@ -0,0 +1,149 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' messages from a socket with a single call.  Each
+ *   message is received as with recvmsg() and its length is returned in
+ *   the msg_len member of its entry in 'msgvec'.
+ *
+ *   If MSG_WAITFORONE is set in 'flags', then MSG_DONTWAIT is applied to
+ *   all messages after the first so that only the messages already queued
+ *   are returned.  If 'timeout' is not NULL, no further messages are
+ *   received once that much time has elapsed.  As with Linux, the timeout
+ *   is checked only after each message is received; it does not bound the
+ *   time spent waiting for any single message.
+ *
+ * Input Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The array of messages to receive into
+ *   vlen     The number of messages in 'msgvec'
+ *   flags    Receive flags
+ *   timeout  Optional time limit
+ *
+ * Returned Value:
+ *   The number of messages received.  If no message was received, -1 is
+ *   returned and errno is set appropriately (see recvmsg()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  unsigned int nrecvd;
+  clock_t start = 0;
+  clock_t ticks = 0;
+  ssize_t ret   = OK;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  if (timeout != NULL)
+    {
+      start = clock_systimer();
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+    }
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  for (nrecvd = 0; nrecvd < vlen; nrecvd++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[nrecvd].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[nrecvd].msg_len = (unsigned int)ret;
+
+      /* Do not wait for any further messages if so requested */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          nrecvd++;
+          break;
+        }
+    }
+
+  leave_cancellation_point();
+
+  /* An error is reported only if nothing was received.  Otherwise, the
+   * error will be reported by the next call.
+   */
+
+  if (nrecvd == 0 && ret < 0)
+    {
+      set_errno((int)-ret);
+      return ERROR;
+    }
+
+  return (int)nrecvd;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,264 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_recvmsg_bounce
+ *
+ * Description:
+ *   Receive a message into a contiguous buffer with psock_recvfrom() and
+ *   then scatter it into the caller's buffers.  See net/socket/socket.h.
+ *
+ ****************************************************************************/
+
+ssize_t net_recvmsg_bounce(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags)
+{
+  FAR struct sockaddr *from = (FAR struct sockaddr *)msg->msg_name;
+  socklen_t fromlen         = (socklen_t)msg->msg_namelen;
+  FAR socklen_t *pfromlen   = NULL;
+  FAR uint8_t *buffer;
+  FAR uint8_t *ptr;
+  size_t remaining;
+  size_t len;
+  ssize_t ret;
+  int i;
+
+  if (from != NULL && msg->msg_namelen > 0)
+    {
+      pfromlen = &fromlen;
+    }
+  else
+    {
+      from = NULL;
+    }
+
+  /* There is nothing to scatter if there is only one buffer */
+
+  if (msg->msg_iovlen == 1)
+    {
+      ret = psock_recvfrom(psock, msg->msg_iov[0].iov_base,
+                           msg->msg_iov[0].iov_len, flags, from, pfromlen);
+    }
+  else
+    {
+      len = net_iovlen(msg->msg_iov, (int)msg->msg_iovlen);
+      if (len == 0)
+        {
+          /* Any non-NULL buffer pointer will do */
+
+          ret = psock_recvfrom(psock, msg, 0, flags, from, pfromlen);
+        }
+      else
+        {
+          buffer = (FAR uint8_t *)kmm_malloc(len);
+          if (buffer == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          ret = psock_recvfrom(psock, buffer, len, flags, from, pfromlen);
+
+          /* Scatter the received data into the caller's buffers */
+
+          for (i = 0, ptr = buffer, remaining = ret > 0 ? (size_t)ret : 0;
+               remaining > 0; i++)
+            {
+              len = msg->msg_iov[i].iov_len;
+              if (len > remaining)
+                {
+                  len = remaining;
+                }
+
+              memcpy(msg->msg_iov[i].iov_base, ptr, len);
+              ptr       += len;
+              remaining -= len;
+            }
+
+          kmm_free(buffer);
+        }
+    }
+
+  if (ret >= 0)
+    {
+      if (from != NULL)
+        {
+          msg->msg_namelen = (int)fromlen;
+        }
+
+      msg->msg_controllen = 0;
+      msg->msg_flags      = 0;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives one message into the msg_iov list of a struct
+ *   msghdr, returning the source address in msg_name and any control
+ *   messages (such as SCM_TIMESTAMP) in msg_control.  This is an internal
+ *   OS interface.  It is functionally equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Describes the buffers to receive the message
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On any
+ *   failure, a negated errno value is returned (see comments with
+ *   recvfrom() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  ssize_t ret;
+
+  /* Verify that the psock corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (msg == NULL || (msg->msg_iov == NULL && msg->msg_iovlen > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* Let the address family's recvmsg() method handle the operation if
+   * it has one.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_recvmsg == NULL)
+    {
+      return net_recvmsg_bounce(psock, msg, flags);
+    }
+
+  /* Set the socket state to receiving */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+
+  ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+
+  /* Set the socket state to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   The recvmsg() call is identical to recvfrom() except that the received
+ *   message is scattered into the list of buffers in msg->msg_iov, the
+ *   source address is returned in msg->msg_name, and ancillary data (for
+ *   example, SCM_TIMESTAMP if the SO_TIMESTAMP option is set) is returned
+ *   in msg->msg_control.  On return, msg->msg_flags holds MSG_TRUNC if the
+ *   datagram was larger than the buffers provided and MSG_CTRUNC if not all
+ *   of the control data could be returned.
+ *
+ * Input Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      Describes the buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On error, -1
+ *   is returned, and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Let psock_recvmsg() do all of the work */
+
+  ret = psock_recvmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   Send up to 'vlen' messages on a socket with a single call.  Each
+ *   message is sent as with sendmsg() and the number of bytes sent is
+ *   returned in the msg_len member of its entry in 'msgvec'.  Sending
+ *   stops at the first message that cannot be sent.
+ *
+ * Input Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The array of messages to send
+ *   vlen     The number of messages in 'msgvec'
+ *   flags    Send flags applied to every message
+ *
+ * Returned Value:
+ *   The number of messages sent.  If no message could be sent, -1 is
+ *   returned and errno is set appropriately (see sendmsg()).
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  unsigned int nsent;
+  ssize_t ret = OK;
+
+  /* sendmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  for (nsent = 0; nsent < vlen; nsent++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[nsent].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[nsent].msg_len = (unsigned int)ret;
+    }
+
+  leave_cancellation_point();
+
+  /* An error is reported only if nothing was sent.  Otherwise, the error
+   * will be reported by the next call.
+   */
+
+  if (nsent == 0 && ret < 0)
+    {
+      set_errno((int)-ret);
+      return ERROR;
+    }
+
+  return (int)nsent;
+}
+
+#endif /* CONFIG_NET */
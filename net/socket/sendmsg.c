@@ -0,0 +1,241 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_iovlen
+ *
+ * Description:
+ *   Return the total number of bytes described by an I/O vector.
+ *
+ ****************************************************************************/
+
+size_t net_iovlen(FAR const struct iovec *iov, int iovcnt)
+{
+  size_t len = 0;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: net_sendmsg_bounce
+ *
+ * Description:
+ *   Send a message by gathering its buffers into one contiguous buffer and
+ *   passing that to psock_sendto().  See net/socket/socket.h.
+ *
+ ****************************************************************************/
+
+ssize_t net_sendmsg_bounce(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags)
+{
+  FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+  socklen_t tolen               = (socklen_t)msg->msg_namelen;
+  FAR uint8_t *buffer;
+  FAR uint8_t *ptr;
+  size_t len;
+  ssize_t ret;
+  int i;
+
+  if (to == NULL)
+    {
+      tolen = 0;
+    }
+
+  /* There is nothing to gather if there is only one buffer */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_sendto(psock, msg->msg_iov[0].iov_base,
+                          msg->msg_iov[0].iov_len, flags, to, tolen);
+    }
+
+  len = net_iovlen(msg->msg_iov, (int)msg->msg_iovlen);
+  if (len == 0)
+    {
+      /* A zero-length message.  Any non-NULL buffer pointer will do */
+
+      return psock_sendto(psock, msg, 0, flags, to, tolen);
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(len);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0, ptr = buffer; i < (int)msg->msg_iovlen; i++)
+    {
+      memcpy(ptr, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+      ptr += msg->msg_iov[i].iov_len;
+    }
+
+  ret = psock_sendto(psock, buffer, len, flags, to, tolen);
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends a message described by a struct msghdr.  The data
+ *   is gathered from the msg_iov list and sent as a single message (or, for
+ *   stream sockets, as a single contiguous transfer).  This is an internal
+ *   OS interface.  It is functionally equivalent to sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned (See comments with sendto() for a list
+ *   of the appropriate errno value).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  /* Verify that the psock corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      nerr("ERROR: Invalid socket\n");
+      return -EBADF;
+    }
+
+  if (msg == NULL || (msg->msg_iov == NULL && msg->msg_iovlen > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* Let the address family's sendmsg() method handle the operation if
+   * it has one.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_sendmsg != NULL)
+    {
+      return psock->s_sockif->si_sendmsg(psock, msg, flags);
+    }
+
+  return net_sendmsg_bounce(psock, msg, flags);
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   The sendmsg() call is identical to sendto() except that the data to be
+ *   sent is gathered from the list of buffers in msg->msg_iov and the
+ *   address of the recipient, if any, is given by msg->msg_name.  The data
+ *   are sent as a single message.  No control messages are supported on
+ *   output; msg->msg_control is ignored.
+ *
+ * Input Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On error, -1 is
+ *   returned, and errno is set appropriately (see sendto()).
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_sendmsg do all of the work */
+
+  ret = psock_sendmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -56,6 +56,7 @@
 #include "tcp/tcp.h"
 #include "udp/udp.h"
 #include "usrsock/usrsock.h"
+#include "pkt/pkt.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -147,6 +148,10 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
 #endif
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_TIMESTAMP:  /* Report the reception time of datagrams */
+#ifdef CONFIG_NET_SOREUSEPORT
+      case SO_REUSEPORT:  /* Share a local port among several sockets */
+#endif
         {
           int setting;
 
@@ -384,6 +389,12 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKTPROTO_OPTIONS
+      case SOL_PACKET: /* Packet socket options (see include/netpacket/packet.h) */
+        ret = pkt_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       /* These levels are defined in sys/socket.h, but are not yet
        * implemented.
        */
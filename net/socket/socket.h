@@ -111,10 +111,12 @@
 #define _SO_SNDLOWAT     _SO_BIT(SO_SNDLOWAT)
 #define _SO_SNDTIMEO     _SO_BIT(SO_SNDTIMEO)
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
+#define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (15)
+#define _SO_MAXOPT       (17)
 
 /* Macros to set, test, clear options */
 
@@ -340,5 +342,42 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
 
 int net_clone(FAR struct socket *psock1, FAR struct socket *psock2);
 
+/****************************************************************************
+ * Name: net_sendmsg_bounce and net_recvmsg_bounce
+ *
+ * Description:
+ *   The generic implementations of sendmsg() and recvmsg() used when the
+ *   address family provides no si_sendmsg() or si_recvmsg() method, or when
+ *   that method cannot handle a particular message.  A message with more
+ *   than one buffer is gathered into (or scattered from) a temporary,
+ *   contiguous buffer which is then passed to si_sendto() (or returned by
+ *   si_recvfrom()).  No control messages are sent or received.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   msg   - The message to send or the buffers to receive into
+ *   flags - Send or receive flags
+ *
+ * Returned Value:
+ *   The number of bytes sent or received on success; a negated errno value
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t net_sendmsg_bounce(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags);
+ssize_t net_recvmsg_bounce(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags);
+
+/****************************************************************************
+ * Name: net_iovlen
+ *
+ * Description:
+ *   Return the total number of bytes described by an I/O vector.
+ *
+ ****************************************************************************/
+
+size_t net_iovlen(FAR const struct iovec *iov, int iovcnt);
+
 #endif /* CONFIG_NET */
 #endif /* _NET_SOCKET_SOCKET_H */
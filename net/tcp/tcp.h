@@ -87,6 +87,9 @@
 #  define TCP_WBSENT(wrb)            ((wrb)->wb_sent)
 #  define TCP_WBNRTX(wrb)            ((wrb)->wb_nrtx)
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
+#ifdef CONFIG_NET_TCP_SACK
+#  define TCP_WBSACKED(wrb)          ((wrb)->wb_sacked)
+#endif
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n) \
      (iob_copyin((wrb)->wb_iob,src,(n),0,false))
@@ -104,6 +107,28 @@
 #  endif
 #endif
 
+/* The default congestion control algorithm */
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT             (&g_tcp_cubic)
+#elif defined(CONFIG_NET_TCP_CC)
+#  define TCP_CC_DEFAULT             (&g_tcp_reno)
+#endif
+
+/* True if the connection was bound with SO_REUSEPORT */
+
+#ifdef CONFIG_NET_SOREUSEPORT
+#  define TCP_REUSEPORT(conn)        ((conn)->reuseport)
+#else
+#  define TCP_REUSEPORT(conn)        (false)
+#endif
+
+/* The number of duplicate ACKs that will trigger a fast retransmission */
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+#  define TCP_DUPACK_THRESH          3
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -118,6 +143,9 @@
  */
 
 struct net_driver_s;      /* Forward reference */
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_s;          /* Forward reference */
+#endif
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
@@ -125,6 +153,8 @@ struct tcp_hdr_s;         /* Forward reference */
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+  dq_entry_t hnode;       /* Links active connections in a hash bucket */
+  dq_entry_t lnode;       /* Links listening connections in a hash bucket */
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -146,12 +176,21 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  bool     wscale;        /* True: Window scaling is in use */
+  uint8_t  snd_scale;     /* Shift applied to the peer's window */
+  uint8_t  rcv_scale;     /* Shift applied to our advertised window */
+#endif
 
   /* If the TCP socket is bound to a local address, then this is
    * a reference to the device that routes traffic on the corresponding
@@ -187,6 +226,61 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+  /* Fast retransmit and recovery
+   *
+   *   lastackno - The last cumulative ACK number received.
+   *   recover   - The value of sndseq_max when fast recovery was entered.
+   *               Recovery ends when this sequence number is ACKed.
+   *   lastwnd   - The window advertised with the last ACK.
+   *   dupacks   - The number of consecutive duplicate ACKs.
+   *   recovery  - True: Fast recovery is in progress.
+   */
+
+  uint32_t   lastackno;   /* Last cumulative ACK number */
+  uint32_t   recover;     /* NewReno recovery point */
+  uint32_t   lastwnd;     /* Window of the last ACK */
+  uint8_t    dupacks;     /* Number of duplicate ACKs */
+  bool       recovery;    /* True: In fast recovery */
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  bool       sack;        /* True: SACK permitted by the peer */
+#endif
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+  bool       nodelay;     /* True: TCP_NODELAY option set */
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  bool       cork;        /* True: TCP_CORK option set; hold back partial
+                           * segments */
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  uint8_t    ackpending;  /* Number of received segments not yet ACKed */
+#endif
+#ifdef CONFIG_NET_SOREUSEPORT
+  bool       reuseport;   /* True: Bound with SO_REUSEPORT; the port may be
+                           * shared with other such connections */
+#endif
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cc       - The congestion control algorithm.  Selected with the
+   *              TCP_CONGESTION socket option.
+   *   cwnd     - The congestion window.  New data is sent only while the
+   *              number of un-ACKed bytes is less than this.
+   *   ssthresh - The slow start threshold.
+   *   The remaining fields are private to the CUBIC algorithm.
+   */
+
+  FAR const struct tcp_cc_s *cc; /* Congestion control algorithm */
+  uint32_t   cwnd;        /* Congestion window (bytes) */
+  uint32_t   ssthresh;    /* Slow start threshold (bytes) */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t   cubic_wmax;  /* Window before the last reduction (bytes) */
+  uint32_t   cubic_origin; /* Origin point of the cubic function (bytes) */
+  uint32_t   cubic_k;     /* Time to reach cubic_origin (msec) */
+  clock_t    cubic_epoch; /* Start of the current epoch; zero if none */
+#endif
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -275,10 +369,38 @@ struct tcp_wrbuffer_s
   uint16_t   wb_sent;      /* Number of bytes sent from the I/O buffer chain */
   uint8_t    wb_nrtx;      /* The number of retransmissions for the last
                             * segment sent */
+#ifdef CONFIG_NET_TCP_SACK
+  bool       wb_sacked;    /* True: Selectively ACKed by the peer */
+#endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
 #endif
 
+/* This structure describes one congestion control algorithm */
+
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_s
+{
+  FAR const char *name;   /* Name used with the TCP_CONGESTION option */
+
+  /* Called when the connection is established, after cwnd and ssthresh
+   * have been set to their initial values.  May be NULL.
+   */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Called when an ACK acknowledges 'nacked' bytes of new data */
+
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t nacked);
+
+  /* Called when loss is detected, either by a retransmission timeout or
+   * by duplicate ACKs.
+   */
+
+  CODE void (*loss)(FAR struct tcp_conn_s *conn, bool timeout);
+};
+#endif
+
 /* Support for listen backlog:
  *
  *   struct tcp_blcontainer_s describes one backlogged connection
@@ -322,6 +444,15 @@ extern "C"
 EXTERN struct net_driver_s *g_netdevices;
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* The congestion control algorithms */
+
+EXTERN const struct tcp_cc_s g_tcp_reno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_s g_tcp_cubic;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -494,6 +625,21 @@ int tcp_remote_ipv6_device(FAR struct tcp_conn_s *conn);
 FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
                                         FAR struct tcp_hdr_s *tcp);
 
+/****************************************************************************
+ * Name: tcp_nhalfopen
+ *
+ * Description:
+ *   Return the number of connections in the SYN_RCVD state.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+int tcp_nhalfopen(void);
+#endif
+
 /****************************************************************************
  * Name: tcp_bind
  *
@@ -811,6 +957,22 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain);
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_connlistener
+ *
+ * Description:
+ *   Return the listener responsible for a connection that is being
+ *   accepted (if any).  If several listeners share the local port with
+ *   SO_REUSEPORT, one is selected by a hash of the remote address and port
+ *   of the connection.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_connlistener(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -935,6 +1097,30 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
 void tcp_reset(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK without using a
+ *   connection structure.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   iss    - The initial sequence number to send
+ *   mss    - The MSS value to advertise
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack(FAR struct net_driver_s *dev, uint32_t iss, uint16_t mss);
+#endif
+
 /****************************************************************************
  * Name: tcp_ack
  *
@@ -957,6 +1143,59 @@ void tcp_reset(FAR struct net_driver_s *dev);
 void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK that carries a SYN
+ *   cookie.  No connection structure is allocated.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   tcp    - The TCP header of the SYN
+ *   iplen  - The size of the IP header
+ *   hdrlen - Offset to the first TCP option in d_buf
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_hdr_s *tcp, unsigned int iplen,
+                          unsigned int hdrlen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK in the device buffer returns a valid SYN cookie.  If
+ *   so, allocate a connection in the SYN_RCVD state for it, just as if the
+ *   SYN had been answered by tcp_alloc_accept().
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the ACK
+ *   tcp    - The TCP header of the ACK
+ *
+ * Returned Value:
+ *   The new connection or NULL if the cookie is not valid or no connection
+ *   structure is available.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_hdr_s *tcp);
+#endif
+
 /****************************************************************************
  * Name: tcp_appsend
  *
@@ -1370,14 +1609,97 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  *   Calculate the TCP receive window for the specified device.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that will advertise the window.
+ *
+ * Returned Value:
+ *   The value of the TCP receive window to use, scaled as required for the
+ *   window field of the TCP header.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_get_recvwscale
+ *
+ * Description:
+ *   Get the window scale shift to offer in the window scale option.  This
+ *   is the smallest shift that allows all of the read-ahead buffering that
+ *   could be available on the device to be advertised.
+ *
+ * Input Parameters:
+ *   dev - The device that will be used by the connection.
+ *
+ * Returned Value:
+ *   The window scale shift (0-14).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_recvwscale(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control when a connection is established.  The
+ *   default algorithm is used unless another was selected with the
+ *   TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that was just established.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find a congestion control algorithm by name.
+ *
+ * Input Parameters:
+ *   name - The name of the algorithm, e.g. "reno" or "cubic".
+ *   len  - The maximum length of the name.  It need not be NUL terminated.
  *
  * Returned Value:
- *   The value of the TCP receive window to use.
+ *   The algorithm or NULL if there is no algorithm with that name.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NET_TCP_CC
+FAR const struct tcp_cc_s *tcp_cc_find(FAR const char *name, size_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_reduce
+ *
+ * Description:
+ *   Calculate the slow start threshold after a loss:  A fraction of the
+ *   un-ACKed data, but no less than two segments.  Used by the congestion
+ *   control algorithms.
+ *
+ * Input Parameters:
+ *   conn     - The TCP connection.
+ *   fraction - The fraction to retain, in tenths.
+ *
+ * Returned Value:
+ *   The new slow start threshold.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+uint32_t tcp_cc_reduce(FAR struct tcp_conn_s *conn, unsigned int fraction);
+#endif
 
 /****************************************************************************
  * Name: psock_tcp_cansend
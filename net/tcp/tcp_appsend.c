@@ -156,7 +156,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else
     {
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
-      DEBUGASSERT(dev->d_sndlen <= conn->mss);
+      DEBUGASSERT(dev->d_sndlen <= conn->mss || NETDEV_IS_TSO(dev));
 #else
       /* If d_sndlen > 0, the application has data to be sent. */
 
@@ -261,6 +261,15 @@ void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp_send(dev, conn, TCP_ACK, hdrlen);
     }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Send any delayed ACK if the poll produced nothing to carry it */
+
+  else if ((result & TCP_POLL) != 0 && conn->ackpending > 0)
+    {
+      tcp_send(dev, conn, TCP_ACK, hdrlen);
+    }
+#endif
+
   /* There is nothing to do -- drop the packet */
 
   else
@@ -0,0 +1,187 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All of the available congestion control algorithms */
+
+static FAR const struct tcp_cc_s * const g_tcp_cc[] =
+{
+  &g_tcp_reno
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  , &g_tcp_cubic
+#endif
+};
+
+#define TCP_NCC (sizeof(g_tcp_cc) / sizeof(g_tcp_cc[0]))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control when a connection is established.  The
+ *   default algorithm is used unless another was selected with the
+ *   TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection that was just established.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  if (conn->cc == NULL)
+    {
+      conn->cc = TCP_CC_DEFAULT;
+    }
+
+  /* The initial window depends on the MSS (RFC 5681, section 3.1) */
+
+  if (conn->mss > 2190)
+    {
+      conn->cwnd = 2 * conn->mss;
+    }
+  else if (conn->mss > 1095)
+    {
+      conn->cwnd = 3 * conn->mss;
+    }
+  else
+    {
+      conn->cwnd = 4 * conn->mss;
+    }
+
+  /* The initial slow start threshold is arbitrarily high */
+
+  conn->ssthresh = UINT32_MAX;
+
+  if (conn->cc->init != NULL)
+    {
+      conn->cc->init(conn);
+    }
+
+  ninfo("cc=%s cwnd=%u\n", conn->cc->name, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find a congestion control algorithm by name.
+ *
+ * Input Parameters:
+ *   name - The name of the algorithm, e.g. "reno" or "cubic".
+ *   len  - The maximum length of the name.  It need not be NUL terminated.
+ *
+ * Returned Value:
+ *   The algorithm or NULL if there is no algorithm with that name.
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_s *tcp_cc_find(FAR const char *name, size_t len)
+{
+  size_t namelen;
+  int i;
+
+  namelen = strnlen(name, len);
+  for (i = 0; i < TCP_NCC; i++)
+    {
+      if (strlen(g_tcp_cc[i]->name) == namelen &&
+          strncmp(g_tcp_cc[i]->name, name, namelen) == 0)
+        {
+          return g_tcp_cc[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_reduce
+ *
+ * Description:
+ *   Calculate the slow start threshold after a loss:  A fraction of the
+ *   un-ACKed data, but no less than two segments.  Used by the congestion
+ *   control algorithms.
+ *
+ * Input Parameters:
+ *   conn     - The TCP connection.
+ *   fraction - The fraction to retain, in tenths.
+ *
+ * Returned Value:
+ *   The new slow start threshold.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_reduce(FAR struct tcp_conn_s *conn, unsigned int fraction)
+{
+  uint32_t ssthresh;
+
+  ssthresh = (conn->unacked / 10) * fraction;
+  if (ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      ssthresh = 2 * (uint32_t)conn->mss;
+    }
+
+  return ssthresh;
+}
+
+#endif /* CONFIG_NET_TCP_CC */
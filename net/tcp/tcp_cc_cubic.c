@@ -0,0 +1,294 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP_CC) && defined(CONFIG_NET_TCP_CC_CUBIC)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CUBIC congestion control requires 64-bit integer support
+#endif
+
+/* The CUBIC constants (RFC 8312):  C = 0.4 and beta = 0.7 */
+
+#define CUBIC_C_NUM       4
+#define CUBIC_C_DEN       10
+#define CUBIC_BETA_NUM    7
+#define CUBIC_BETA_DEN    10
+
+/* Limit the time from the origin point so that its cube fits in 64 bits */
+
+#define CUBIC_MAX_DELTA   2000000   /* msec */
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t nacked);
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_s g_tcp_cubic =
+{
+  "cubic",                      /* name */
+  cubic_init,                   /* init */
+  cubic_ack,                    /* ack */
+  cubic_loss                    /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ *
+ * Description:
+ *   Forget any previous congestion epoch.
+ *
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cubic_wmax   = 0;
+  conn->cubic_origin = 0;
+  conn->cubic_k      = 0;
+  conn->cubic_epoch  = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_ack
+ *
+ * Description:
+ *   Open the congestion window when new data is ACKed.  In congestion
+ *   avoidance, the window follows the cubic function
+ *
+ *     W(t) = C * (t - K)^3 + Wmax
+ *
+ *   where t is the time since the last window reduction and K is the time
+ *   at which the window will again reach Wmax.
+ *
+ ****************************************************************************/
+
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t nacked)
+{
+  uint64_t offset;
+  uint32_t target;
+  uint32_t incr;
+  clock_t now;
+  int32_t delta;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* Slow start is the same as for Reno */
+
+      incr = nacked < conn->mss ? nacked : conn->mss;
+      if (conn->cwnd < UINT32_MAX - incr)
+        {
+          conn->cwnd += incr;
+        }
+
+      return;
+    }
+
+  now = clock_systimer();
+  if (conn->cubic_epoch == 0)
+    {
+      /* Start a new congestion avoidance epoch */
+
+      conn->cubic_epoch = now != 0 ? now : 1;
+
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          /* K = cbrt((Wmax - cwnd) / C), converted from seconds to msec */
+
+          offset = (uint64_t)(conn->cubic_wmax - conn->cwnd) *
+                   CUBIC_C_DEN * 1000000 /
+                   ((uint64_t)CUBIC_C_NUM * conn->mss) * 1000;
+
+          conn->cubic_k      = cubic_root(offset);
+          conn->cubic_origin = conn->cubic_wmax;
+        }
+      else
+        {
+          conn->cubic_k      = 0;
+          conn->cubic_origin = conn->cwnd;
+        }
+    }
+
+  /* Time relative to K, in milliseconds */
+
+  delta = (int32_t)TICK2MSEC(now - conn->cubic_epoch) -
+          (int32_t)conn->cubic_k;
+
+  if (delta > CUBIC_MAX_DELTA)
+    {
+      delta = CUBIC_MAX_DELTA;
+    }
+  else if (delta < -CUBIC_MAX_DELTA)
+    {
+      delta = -CUBIC_MAX_DELTA;
+    }
+
+  /* C * MSS * (t - K)^3, with t - K in seconds */
+
+  offset  = delta < 0 ? (uint64_t)-delta : (uint64_t)delta;
+  offset  = offset * offset * offset / 1000000;
+  offset  = offset * CUBIC_C_NUM * conn->mss / (CUBIC_C_DEN * 1000);
+
+  if (delta < 0)
+    {
+      target = offset < conn->cubic_origin ?
+               conn->cubic_origin - (uint32_t)offset : conn->mss;
+    }
+  else
+    {
+      offset += conn->cubic_origin;
+      target  = offset < UINT32_MAX ? (uint32_t)offset : UINT32_MAX;
+    }
+
+  /* Never grow by more than half of the window per round trip */
+
+  if (target > conn->cwnd + conn->cwnd / 2)
+    {
+      target = conn->cwnd + conn->cwnd / 2;
+    }
+
+  if (target > conn->cwnd)
+    {
+      incr = (uint32_t)((uint64_t)(target - conn->cwnd) * nacked /
+                        conn->cwnd);
+    }
+  else
+    {
+      /* Close to the plateau:  Grow very slowly */
+
+      incr = (uint32_t)((uint64_t)conn->mss * nacked /
+                        (100 * (uint64_t)conn->cwnd));
+    }
+
+  if (conn->cwnd < UINT32_MAX - incr)
+    {
+      conn->cwnd += incr;
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_loss
+ *
+ * Description:
+ *   Reduce the window by the factor beta after a loss and remember the
+ *   window at which the loss occurred.  After a timeout, restart from slow
+ *   start with a window of one segment.
+ *
+ ****************************************************************************/
+
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  /* Fast convergence:  If the window did not reach the previous maximum,
+   * release some bandwidth for new flows.
+   */
+
+  if (conn->cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = (conn->cwnd / (2 * CUBIC_BETA_DEN)) *
+                         (CUBIC_BETA_DEN + CUBIC_BETA_NUM);
+    }
+  else
+    {
+      conn->cubic_wmax = conn->cwnd;
+    }
+
+  conn->cubic_epoch = 0;
+  conn->ssthresh    = (conn->cwnd / CUBIC_BETA_DEN) * CUBIC_BETA_NUM;
+  if (conn->ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      conn->ssthresh = 2 * (uint32_t)conn->mss;
+    }
+
+  conn->cwnd = timeout ? conn->mss : conn->ssthresh;
+}
+
+#endif /* CONFIG_NET_TCP_CC && CONFIG_NET_TCP_CC_CUBIC */
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_reno.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void reno_ack(FAR struct tcp_conn_s *conn, uint32_t nacked);
+static void reno_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_s g_tcp_reno =
+{
+  "reno",                       /* name */
+  NULL,                         /* init */
+  reno_ack,                     /* ack */
+  reno_loss                     /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: reno_ack
+ *
+ * Description:
+ *   Open the congestion window when new data is ACKed:  By up to one
+ *   segment per ACK in slow start and by about one segment per round trip
+ *   in congestion avoidance (RFC 5681, section 3.1).
+ *
+ ****************************************************************************/
+
+static void reno_ack(FAR struct tcp_conn_s *conn, uint32_t nacked)
+{
+  uint32_t incr;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* Slow start */
+
+      incr = nacked < conn->mss ? nacked : conn->mss;
+    }
+  else
+    {
+      /* Congestion avoidance */
+
+      incr = ((uint32_t)conn->mss * conn->mss) / conn->cwnd;
+      if (incr == 0)
+        {
+          incr = 1;
+        }
+    }
+
+  if (conn->cwnd < UINT32_MAX - incr)
+    {
+      conn->cwnd += incr;
+    }
+}
+
+/****************************************************************************
+ * Name: reno_loss
+ *
+ * Description:
+ *   Halve the slow start threshold after a loss.  After a timeout, restart
+ *   from slow start with a window of one segment.
+ *
+ ****************************************************************************/
+
+static void reno_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  conn->ssthresh = tcp_cc_reduce(conn, 5);
+  conn->cwnd     = timeout ? conn->mss : conn->ssthresh;
+}
+
+#endif /* CONFIG_NET_TCP_CC */
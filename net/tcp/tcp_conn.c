@@ -54,6 +54,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -88,6 +89,14 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections are also kept in a hash table, indexed by
+ * the local port, the remote port, and the remote address, so that the
+ * connection for an incoming segment can be found without traversing the
+ * whole list.
+ */
+
+static dq_queue_t g_tcp_connhash[CONFIG_NET_TCP_HASHSIZE];
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -96,6 +105,93 @@ static uint16_t g_last_tcp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashbucket
+ *
+ * Description:
+ *   Fold the connection 4-tuple (less the local address which may be
+ *   INADDR_ANY) into an index into g_tcp_connhash[].  The ports and the
+ *   partial address sum are in network byte order.
+ *
+ ****************************************************************************/
+
+static inline FAR dq_queue_t *tcp_hashbucket(uint16_t lport, uint16_t rport,
+                                             uint32_t addrsum)
+{
+  uint32_t hash = addrsum ^ ((uint32_t)lport << 16 | rport);
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_tcp_connhash[hash % CONFIG_NET_TCP_HASHSIZE];
+}
+
+/****************************************************************************
+ * Name: tcp_ipv6_addrsum
+ *
+ * Description:
+ *   Fold an IPv6 address into 32 bits for use with tcp_hashbucket().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_addrsum(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (uint32_t)(addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connbucket
+ *
+ * Description:
+ *   Return the hash bucket that holds (or will hold) an active connection.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *tcp_connbucket(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hashbucket(conn->lport, conn->rport,
+                            (uint32_t)conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hashbucket(conn->lport, conn->rport,
+                            tcp_ipv6_addrsum(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Add a connection to the list of active connections and to the active
+ *   connection hash table.  The local port, remote port and remote address
+ *   must already be set and must not change while the connection is
+ *   active.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+  dq_addlast(&conn->hnode, tcp_connbucket(conn));
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -106,11 +202,15 @@ static uint16_t g_last_tcp_port;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If reuseport is true, connections that were also bound with
+ *   SO_REUSEPORT do not conflict and are ignored.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
 static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
-                                                       uint16_t portno)
+                                                       uint16_t portno,
+                                                       bool reuseport)
 {
   FAR struct tcp_conn_s *conn;
   int i;
@@ -125,7 +225,8 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
        * matches the requested port number.
        */
 
-      if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno)
+      if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno &&
+          !(reuseport && TCP_REUSEPORT(conn)))
         {
           /* If there are multiple interface devices, then the local IP
            * address of the connection must also match.  INADDR_ANY is a
@@ -157,11 +258,15 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If reuseport is true, connections that were also bound with
+ *   SO_REUSEPORT do not conflict and are ignored.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
 static inline FAR struct tcp_conn_s *
-tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
+tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno,
+                  bool reuseport)
 {
   FAR struct tcp_conn_s *conn;
   int i;
@@ -176,7 +281,8 @@ tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
        * matches the requested port number.
        */
 
-      if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno)
+      if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno &&
+          !(reuseport && TCP_REUSEPORT(conn)))
         {
           /* If there are multiple interface devices, then the local IP
            * address of the connection must also match.  The IPv6
@@ -208,18 +314,21 @@ tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If reuseport is true, connections that were also bound with
+ *   SO_REUSEPORT do not conflict and are ignored.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, bool reuseport)
 {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (domain == PF_INET)
 #endif
     {
-      return tcp_ipv4_listener(ipaddr->ipv4, portno);
+      return tcp_ipv4_listener(ipaddr->ipv4, portno, reuseport);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -228,7 +337,7 @@ static FAR struct tcp_conn_s *
   else
 #endif
     {
-      return tcp_ipv6_listener(ipaddr->ipv6, portno);
+      return tcp_ipv6_listener(ipaddr->ipv6, portno, reuseport);
     }
 #endif /* CONFIG_NET_IPv6 */
 }
@@ -244,6 +353,8 @@ static FAR struct tcp_conn_s *
  * Input Parameters:
  *   portno -- the selected port number in host order. Zero means no port
  *     selected.
+ *   reuseport -- true if the connection was bound with SO_REUSEPORT.  The
+ *     port may then be shared with other such connections.
  *
  * Returned Value:
  *   Selected or verified port number in host order on success, a negated
@@ -260,7 +371,7 @@ static FAR struct tcp_conn_s *
  ****************************************************************************/
 
 static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-                          uint16_t portno)
+                          uint16_t portno, bool reuseport)
 {
   if (portno == 0)
     {
@@ -285,7 +396,7 @@ static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
               g_last_tcp_port = 4096;
             }
         }
-      while (tcp_listener(domain, ipaddr, htons(g_last_tcp_port)));
+      while (tcp_listener(domain, ipaddr, htons(g_last_tcp_port), false));
     }
   else
     {
@@ -293,7 +404,7 @@ static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno))
+      if (tcp_listener(domain, ipaddr, portno, reuseport))
         {
           /* It is in use... return EADDRINUSE */
 
@@ -324,15 +435,22 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *entry;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  /* Only the connections in the matching hash bucket need be examined */
+
+  entry = dq_peek(tcp_hashbucket(tcp->destport, tcp->srcport,
+                                 (uint32_t)srcipaddr));
+
+  for (; entry != NULL; entry = dq_next(entry))
     {
+      conn = container_of(entry, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -357,19 +475,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -391,15 +503,22 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *entry;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  /* Only the connections in the matching hash bucket need be examined */
+
+  entry = dq_peek(tcp_hashbucket(tcp->destport, tcp->srcport,
+                                 tcp_ipv6_addrsum(*srcipaddr)));
+
+  for (; entry != NULL; entry = dq_next(entry))
     {
+      conn = container_of(entry, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -424,19 +543,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -470,7 +583,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                        ntohs(addr->sin_port));
+                        ntohs(addr->sin_port), TCP_REUSEPORT(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -537,7 +650,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET6,
                         (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                        ntohs(addr->sin6_port));
+                        ntohs(addr->sin6_port), TCP_REUSEPORT(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -594,6 +707,11 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+  for (i = 0; i < CONFIG_NET_TCP_HASHSIZE; i++)
+    {
+      dq_init(&g_tcp_connhash[i]);
+    }
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -769,9 +887,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   if (conn->tcpstateflags != TCP_ALLOCATED)
     {
-      /* Remove the connection from the active list */
+      /* Remove the connection from the active list and hash table */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      dq_rem(&conn->hnode, tcp_connbucket(conn));
     }
 
 #ifdef CONFIG_NET_TCP_READAHEAD
@@ -1017,6 +1136,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 
       memcpy(conn->rcvseq, tcp->seqno, 4);
 
+#ifdef CONFIG_NET_SOREUSEPORT
+      /* Connections accepted on a shared port also share it so that more
+       * listeners may still bind to the port.
+       */
+
+      conn->reuseport = TCP_REUSEPORT(tcp_connlistener(conn));
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
       /* Initialize the list of TCP read-ahead buffers */
 
@@ -1034,12 +1161,43 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_addactive(conn);
     }
 
   return conn;
 }
 
+/****************************************************************************
+ * Name: tcp_nhalfopen
+ *
+ * Description:
+ *   Return the number of connections in the SYN_RCVD state.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+int tcp_nhalfopen(void)
+{
+  FAR struct tcp_conn_s *conn;
+  int nhalfopen = 0;
+
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL;
+       conn = (FAR struct tcp_conn_s *)conn->node.flink)
+    {
+      if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_SYN_RCVD)
+        {
+          nhalfopen++;
+        }
+    }
+
+  return nhalfopen;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_bind
  *
@@ -1135,7 +1293,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
       port = tcp_selectport(PF_INET,
                             (FAR const union ip_addr_u *)&conn->u.ipv4.laddr,
-                            ntohs(conn->lport));
+                            ntohs(conn->lport), false);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1150,7 +1308,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
       port = tcp_selectport(PF_INET6,
                             (FAR const union ip_addr_u *)conn->u.ipv6.laddr,
-                            ntohs(conn->lport));
+                            ntohs(conn->lport), false);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1269,7 +1427,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
@@ -41,6 +41,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -97,11 +98,6 @@
 int tcp_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
-   */
-
   FAR struct tcp_conn_s *conn;
   int ret;
 
@@ -120,10 +116,9 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
       return -ENOTCONN;
     }
 
-  /* Handle the Keep-Alive option */
-
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -153,11 +148,39 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif
+
       case TCP_NODELAY:  /* Avoid coalescing of small segments. */
-        nerr("ERROR: TCP_NODELAY not supported\n");
-        ret = -ENOSYS;
+        if (*value_len < sizeof(int))
+          {
+            ret              = -EINVAL;
+          }
+        else
+          {
+            FAR int *nodelay = (FAR int *)value;
+            *nodelay         = (int)conn->nodelay;
+            *value_len       = sizeof(int);
+            ret              = OK;
+          }
         break;
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case TCP_CORK:     /* Hold back partial segments */
+        if (*value_len < sizeof(int))
+          {
+            ret              = -EINVAL;
+          }
+        else
+          {
+            FAR int *cork    = (FAR int *)value;
+            *cork            = (int)conn->cork;
+            *value_len       = sizeof(int);
+            ret              = OK;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
         if (*value_len < sizeof(struct timeval))
           {
@@ -239,6 +262,35 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const struct tcp_cc_s *cc;
+          size_t len;
+
+          /* Report the default algorithm if the connection has not yet
+           * been established.
+           */
+
+          cc  = conn->cc != NULL ? conn->cc : TCP_CC_DEFAULT;
+          len = strlen(cc->name) + 1;
+
+          if (*value_len < len)
+            {
+              /* Truncate the name (without a NUL terminator) */
+
+              len = *value_len;
+            }
+
+          memcpy(value, cc->name, len);
+          *value_len = len;
+          ret        = OK;
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -246,9 +298,6 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
     }
 
   return ret;
-#else
-  return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
@@ -66,6 +66,119 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_synoptions
+ *
+ * Description:
+ *   Parse the TCP options of a received SYN or SYNACK segment.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received TCP packet.
+ *   conn   - The TCP connection that is being established
+ *   tcp    - The TCP header of the received segment
+ *   iplen  - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *   hdrlen - Offset to the first TCP option in d_buf
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_synoptions(FAR struct net_driver_s *dev,
+                           FAR struct tcp_conn_s *conn,
+                           FAR struct tcp_hdr_s *tcp, unsigned int iplen,
+                           unsigned int hdrlen)
+{
+  uint16_t tmp16;
+  uint8_t opt;
+  int optlen;
+  int i;
+
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      /* No options */
+
+      return;
+    }
+
+  optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  for (i = 0; i < optlen; )
+    {
+      opt = dev->d_buf[hdrlen + i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+        }
+      else if (opt == TCP_OPT_MSS &&
+               dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
+                   (uint16_t)dev->d_buf[hdrlen + 3 + i];
+          conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+
+          i += TCP_OPT_MSS_LEN;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS &&
+               dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+        {
+          /* The peer's windows will be scaled by this shift */
+
+          conn->wscale    = true;
+          conn->snd_scale = dev->d_buf[hdrlen + 2 + i];
+          if (conn->snd_scale > TCP_MAX_WSCALE)
+            {
+              conn->snd_scale = TCP_MAX_WSCALE;
+            }
+
+          i += TCP_OPT_WS_LEN;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      else if (opt == TCP_OPT_SACK_PERM &&
+               dev->d_buf[hdrlen + 1 + i] == TCP_OPT_SACK_PERM_LEN)
+        {
+          /* The peer will accept selective acknowledgments */
+
+          conn->sack = true;
+          i += TCP_OPT_SACK_PERM_LEN;
+        }
+#endif
+      else
+        {
+          /* All other options have a length field, so that we easily
+           * can skip past them.
+           */
+
+          if (dev->d_buf[hdrlen + 1 + i] == 0)
+            {
+              /* If the length field is zero, the options are malformed
+               * and we don't process them further.
+               */
+
+              break;
+            }
+
+          i += dev->d_buf[hdrlen + 1 + i];
+        }
+    }
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -95,9 +208,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -127,7 +238,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCHKSUM(dev, NETDEV_CHKSUM_TCP) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -190,7 +301,14 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
            * user application to accept it.
            */
 
-          conn = tcp_alloc_accept(dev, tcp);
+          conn = NULL;
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          if (tcp_nhalfopen() < CONFIG_NET_TCP_SYNCOOKIE_THRESH)
+#endif
+            {
+              conn = tcp_alloc_accept(dev, tcp);
+            }
+
           if (conn)
             {
               /* The connection structure was successfully allocated and has
@@ -215,6 +333,19 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
               conn->crefs = 1;
             }
 
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          if (!conn)
+            {
+              /* Too many connections are half-open or none is available.
+               * Answer with a SYN cookie; a connection structure will be
+               * allocated only if the ACK returns a valid cookie.
+               */
+
+              tcp_syncookie_synack(dev, tcp, iplen, hdrlen);
+              return;
+            }
+#endif
+
           if (!conn)
             {
               /* Either (1) all available connections are in use, or (2)
@@ -233,58 +364,11 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP MSS, window scale, and SACK permitted options,
+           * if present.
+           */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_synoptions(dev, conn, tcp, iplen, hdrlen);
 
           /* Our response will be a SYNACK. */
 
@@ -292,6 +376,27 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
           return;
         }
     }
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  else if ((tcp->flags & (TCP_SYN | TCP_RST | TCP_ACK)) == TCP_ACK)
+    {
+      /* This may be the ACK that completes a handshake that was answered
+       * with a SYN cookie.
+       */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (tcp_islistener(tcp->destport, domain))
+#else
+      if (tcp_islistener(tcp->destport))
+#endif
+        {
+          conn = tcp_syncookie_accept(dev, tcp);
+          if (conn != NULL)
+            {
+              goto found;
+            }
+        }
+    }
+#endif
 
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
 
@@ -320,6 +425,15 @@ found:
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window is never scaled in a SYN segment */
+
+  if (conn->wscale && (tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_scale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -343,11 +457,7 @@ found:
 
           /* Notify the listener for the connection of the reset event */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(conn->lport, domain);
-#else
-          listener = tcp_findlistener(conn->lport);
-#endif
+          listener = tcp_connlistener(conn);
 
           /* We must free this TCP connection structure; this connection
            * will never be established.  There should only be one reference
@@ -609,6 +719,13 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+            conn->lastackno     = conn->isn;
+            conn->lastwnd       = conn->winsize;
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
@@ -645,59 +762,11 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP MSS, window scale, and SACK permitted options,
+             * if present.
+             */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_synoptions(dev, conn, tcp, iplen, hdrlen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -708,6 +777,13 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+            conn->lastackno     = conn->isn;
+            conn->lastwnd       = conn->winsize;
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -892,6 +968,22 @@ found:
                 net_incr32(conn->rcvseq, len);
               }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+            /* If the application has nothing to send in response, then
+             * delay the ACK for the first of every two data segments.  It
+             * will go out with the next segment that we send or, at the
+             * latest, when the connection is next polled.
+             */
+
+            if (len > 0 && (result & TCP_SNDACK) != 0 &&
+                (result & (TCP_CLOSE | TCP_ABORT)) == 0 &&
+                dev->d_sndlen == 0 && conn->ackpending == 0)
+              {
+                conn->ackpending = 1;
+                result &= ~TCP_SNDACK;
+              }
+#endif
+
             /* Send the response, ACKing the data or not, as appropriate */
 
             tcp_appsend(dev, conn, result);
@@ -1031,6 +1123,10 @@ drop:
 #ifdef CONFIG_NET_IPv4
 void tcp_ipv4_input(FAR struct net_driver_s *dev)
 {
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+
   /* Configure to receive an TCP IPv4 packet */
 
   tcp_ipv4_select(dev);
@@ -1038,6 +1134,7 @@ void tcp_ipv4_input(FAR struct net_driver_s *dev)
   /* Then process in the TCP IPv4 input */
 
   tcp_input(dev, PF_INET, IPv4_HDRLEN);
+  NETPERF_UPDATE(NETPERF_TCP_INPUT, start);
 }
 #endif
 
@@ -1064,6 +1161,10 @@ void tcp_ipv4_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_IPv6
 void tcp_ipv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
 {
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+
   /* Configure to receive an TCP IPv6 packet */
 
   tcp_ipv6_select(dev);
@@ -1071,6 +1172,7 @@ void tcp_ipv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
   /* Then process in the TCP IPv6 input */
 
   tcp_input(dev, PF_INET6, iplen);
+  NETPERF_UPDATE(NETPERF_TCP_INPUT, start);
 }
 #endif
 
@@ -46,21 +46,38 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a local port number (in network order) to its listener hash bucket */
+
+#define TCP_LISTENHASH(p) \
+  (&g_tcp_listenhash[(uint16_t)((p) ^ ((p) >> 8)) % CONFIG_NET_TCP_HASHSIZE])
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* All currently listening connections, hashed by local port number.  No
+ * more than CONFIG_NET_MAX_LISTENPORTS connections may be listening at
+ * any time.
+ */
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+static dq_queue_t g_tcp_listenhash[CONFIG_NET_TCP_HASHSIZE];
+static uint16_t g_tcp_nlisteners;
 
 /****************************************************************************
  * Private Functions
@@ -83,21 +100,23 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
-  int ndx;
+  FAR dq_entry_t *entry;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each listening connection in the hash bucket for this port */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (entry = dq_peek(TCP_LISTENHASH(portno));
+       entry != NULL;
+       entry = dq_next(entry))
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
+
+      FAR struct tcp_conn_s *conn =
+        container_of(entry, struct tcp_conn_s, lnode);
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+      if (conn->lport == portno && conn->domain == domain)
 #else
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
 #endif
         {
           /* Yes.. we found a listener on this port */
@@ -111,10 +130,140 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_flowhash
+ *
+ * Description:
+ *   Hash the remote address and port of a connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOREUSEPORT
+static uint32_t tcp_flowhash(FAR struct tcp_conn_s *conn)
+{
+  FAR const uint16_t *raddr;
+  uint32_t hash;
+  int nwords;
+  int i;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      raddr  = (FAR const uint16_t *)&conn->u.ipv4.raddr;
+      nwords = 2;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      raddr  = conn->u.ipv6.raddr;
+      nwords = 8;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  hash = conn->rport;
+  for (i = 0; i < nwords; i++)
+    {
+      hash = (hash ^ raddr[i]) * 2654435761u;
+    }
+
+  return hash ^ (hash >> 16);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_samelistener
+ *
+ * Description:
+ *   Return true if other listens on the same port as listener
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOREUSEPORT
+static inline bool tcp_samelistener(FAR struct tcp_conn_s *listener,
+                                    FAR struct tcp_conn_s *other)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  return other->lport == listener->lport &&
+         other->domain == listener->domain;
+#else
+  return other->lport == listener->lport;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_connlistener
+ *
+ * Description:
+ *   Return the listener responsible for a connection that is being
+ *   accepted (if any).  If several listeners share the local port with
+ *   SO_REUSEPORT, one is selected by a hash of the remote address and port
+ *   of the connection so that the same listener is found for every packet
+ *   of the handshake.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_connlistener(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *listener;
+#ifdef CONFIG_NET_SOREUSEPORT
+  FAR struct tcp_conn_s *other;
+  FAR dq_entry_t *entry;
+  int nlisteners;
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  listener = tcp_findlistener(conn->lport, conn->domain);
+#else
+  listener = tcp_findlistener(conn->lport);
+#endif
+
+#ifdef CONFIG_NET_SOREUSEPORT
+  if (listener != NULL && listener->reuseport)
+    {
+      /* The first listener found is the earliest in the hash bucket so
+       * all listeners sharing the port follow it.  Count them, then pick
+       * one.
+       */
+
+      nlisteners = 0;
+      for (entry = &listener->lnode; entry != NULL; entry = dq_next(entry))
+        {
+          other = container_of(entry, struct tcp_conn_s, lnode);
+          if (tcp_samelistener(listener, other))
+            {
+              nlisteners++;
+            }
+        }
+
+      nlisteners = tcp_flowhash(conn) % nlisteners;
+      for (entry = &listener->lnode; entry != NULL; entry = dq_next(entry))
+        {
+          other = container_of(entry, struct tcp_conn_s, lnode);
+          if (tcp_samelistener(listener, other) && nlisteners-- == 0)
+            {
+              return other;
+            }
+        }
+    }
+#endif
+
+  return listener;
+}
+
 /****************************************************************************
  * Name: tcp_listen_initialize
  *
@@ -130,10 +279,13 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 void tcp_listen_initialize(void)
 {
   int ndx;
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE; ndx++)
     {
-      tcp_listenports[ndx] = NULL;
+      dq_init(&g_tcp_listenhash[ndx]);
     }
+
+  g_tcp_nlisteners = 0;
 }
 
 /****************************************************************************
@@ -149,15 +301,21 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR dq_queue_t *bucket;
+  FAR dq_entry_t *entry;
   int ret = -EINVAL;
 
   net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+
+  /* A listening connection can only be in the bucket of its local port */
+
+  bucket = TCP_LISTENHASH(conn->lport);
+  for (entry = dq_peek(bucket); entry != NULL; entry = dq_next(entry))
     {
-      if (tcp_listenports[ndx] == conn)
+      if (entry == &conn->lnode)
         {
-          tcp_listenports[ndx] = NULL;
+          dq_rem(entry, bucket);
+          g_tcp_nlisteners--;
           ret = OK;
           break;
         }
@@ -180,7 +338,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
-  int ndx;
+  FAR struct tcp_conn_s *listener;
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -189,41 +347,38 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * That is only allowed if both sockets were bound with SO_REUSEPORT.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(conn->lport, conn->domain))
+  listener = tcp_findlistener(conn->lport, conn->domain);
 #else
-  if (tcp_islistener(conn->lport))
+  listener = tcp_findlistener(conn->lport);
 #endif
+
+  if (listener != NULL &&
+      (!TCP_REUSEPORT(listener) || !TCP_REUSEPORT(conn)))
     {
       /* Yes, then we must refuse this request */
 
       ret = -EADDRINUSE;
     }
+  else if (g_tcp_nlisteners >= CONFIG_NET_MAX_LISTENPORTS)
+    {
+      /* All of the listener slots are in use */
+
+      ret = -ENOBUFS;
+    }
   else
     {
-      /* Otherwise, save a reference to the connection structure in the
-       * "listener" list.
+      /* Otherwise, add the connection structure to the "listener" hash
+       * table.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-        {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
-        }
+      dq_addlast(&conn->lnode, TCP_LISTENHASH(conn->lport));
+      g_tcp_nlisteners++;
+      ret = OK;
     }
 
   net_unlock();
@@ -275,11 +430,8 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    * the connection.
    */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(portno, conn->domain);
-#else
-  listener = tcp_findlistener(portno);
-#endif
+  DEBUGASSERT(conn->lport == portno);
+  listener = tcp_connlistener(conn);
   if (listener != NULL)
     {
       /* Yes, there is a listener.  Is it accepting connections now? */
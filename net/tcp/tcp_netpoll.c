@@ -46,6 +46,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 
@@ -152,7 +153,7 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           info->cb->event   = NULL;
 
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -208,7 +209,7 @@ static inline void tcp_iob_work(FAR void *arg)
            */
 
           fds->revents |= (POLLERR | POLLHUP);
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -226,7 +227,7 @@ static inline void tcp_iob_work(FAR void *arg)
           /* Yes.. then signal the poll logic */
 
           fds->revents |= POLLWRNORM;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
       else
         {
@@ -449,7 +450,7 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
@@ -53,32 +53,20 @@
 #include "tcp/tcp.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: tcp_get_recvwindow
+ * Name: tcp_recvmss
  *
  * Description:
- *   Calculate the TCP receive window for the specified device.
- *
- * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
- *
- * Returned Value:
- *   The value of the TCP receive window to use.
+ *   Calculate the MSS of packets received on the specified device.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+static uint16_t tcp_recvmss(FAR struct net_driver_s *dev)
 {
   uint16_t iplen;
-  uint16_t mss;
-  uint16_t recvwndo;
-#ifdef CONFIG_NET_TCP_READAHEAD
-  int  niob_avail;
-  int  nqentry_avail;
-#endif
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -104,7 +92,54 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
    * is the minimum size.
    */
 
-  mss = dev->d_pktsize - (NET_LL_HDRLEN(dev) + iplen + TCP_HDRLEN);
+  return dev->d_pktsize - (NET_LL_HDRLEN(dev) + iplen + TCP_HDRLEN);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_get_recvwindow
+ *
+ * Description:
+ *   Calculate the TCP receive window for the specified device.
+ *
+ * Input Parameters:
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection that will advertise the window.
+ *
+ * Returned Value:
+ *   The value of the TCP receive window to use, scaled as required for the
+ *   window field of the TCP header.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+  uint32_t maxwndo = UINT16_MAX;
+  uint32_t recvwndo;
+  uint16_t mss;
+  uint8_t shift = 0;
+#ifdef CONFIG_NET_TCP_READAHEAD
+  int  niob_avail;
+  int  nqentry_avail;
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window is scaled in all segments except for the SYN and SYNACK */
+
+  if (conn->wscale &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_SENT &&
+      (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD)
+    {
+      shift   = conn->rcv_scale;
+      maxwndo = (uint32_t)UINT16_MAX << shift;
+    }
+#endif
+
+  mss = tcp_recvmss(dev);
 
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Update the TCP received window based on read-ahead I/O buffer
@@ -158,14 +193,14 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        */
 
       rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
-      if (rwnd > UINT16_MAX)
+      if (rwnd > maxwndo)
         {
-          rwnd = UINT16_MAX;
+          rwnd = maxwndo;
         }
 
       /* Save the new receive window size */
 
-      recvwndo = (uint16_t)rwnd;
+      recvwndo = rwnd;
     }
   else /* nqentry_avail == 0 || niob_avail == 0 */
 #endif
@@ -181,5 +216,42 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
       recvwndo = mss;
     }
 
-  return recvwndo;
+  return (uint16_t)(recvwndo >> shift);
 }
+
+/****************************************************************************
+ * Name: tcp_get_recvwscale
+ *
+ * Description:
+ *   Get the window scale shift to offer in the window scale option.  This
+ *   is the smallest shift that allows all of the read-ahead buffering that
+ *   could be available on the device to be advertised.
+ *
+ * Input Parameters:
+ *   dev - The device that will be used by the connection.
+ *
+ * Returned Value:
+ *   The window scale shift (0-14).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_recvwscale(FAR struct net_driver_s *dev)
+{
+  uint32_t maxwndo;
+  uint8_t shift;
+
+  maxwndo = tcp_recvmss(dev);
+#ifdef CONFIG_NET_TCP_READAHEAD
+  maxwndo += (uint32_t)CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE;
+#endif
+
+  shift = 0;
+  while (shift < TCP_MAX_WSCALE && (maxwndo >> shift) > UINT16_MAX)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
@@ -46,6 +46,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -152,7 +153,15 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+
+  /* The checksum of each segment of a large frame is calculated when the
+   * frame is split.  The hardware may also insert the checksum itself.
+   */
+
+  if (!NETDEV_IS_TSO(dev) && !NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_TCP))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -167,7 +176,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_IPv4))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -224,7 +236,15 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+
+  /* The checksum of each segment of a large frame is calculated when the
+   * frame is split.  The hardware may also insert the checksum itself.
+   */
+
+  if (!NETDEV_IS_TSO(dev) && !NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_TCP))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -341,6 +361,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Every segment that we send acknowledges all received data */
+
+  conn->ackpending = 0;
+#endif
+
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
@@ -359,7 +385,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     {
       /* Update the TCP received window based on I/O buffer availability */
 
-      uint16_t recvwndo = tcp_get_recvwindow(dev);
+      uint16_t recvwndo = tcp_get_recvwindow(dev, conn);
 
       /* Set the TCP Window */
 
@@ -523,6 +549,94 @@ void tcp_reset(FAR struct net_driver_s *dev)
   tcp_sendcomplete(dev, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK without using a
+ *   connection structure.  Like tcp_reset(), the reply is built in place
+ *   from the received SYN.  Only the MSS option is sent.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   iss    - The initial sequence number to send
+ *   mss    - The MSS value to advertise
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_synack(FAR struct net_driver_s *dev, uint32_t iss, uint16_t mss)
+{
+  FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+  uint16_t tmp16;
+
+  /* TCP setup.  Until there is a connection, advertise a window of one
+   * segment.
+   */
+
+  tcp->flags      = TCP_SYN | TCP_ACK;
+  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  tcp->wnd[0]     = mss >> 8;
+  tcp->wnd[1]     = mss & 0xff;
+
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = mss >> 8;
+  tcp->optdata[3] = mss & 0xff;
+
+  /* Acknowledge the SYN and send our own sequence number */
+
+  tcp_setsequence(tcp->ackno, tcp_addsequence(tcp->seqno, 1));
+  tcp_setsequence(tcp->seqno, iss);
+
+  /* Swap port numbers. */
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  /* Set the packet length and swap IP addresses. */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      dev->d_len = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv6addr_hdrcopy(ipv6->destipaddr, ipv6->srcipaddr);
+      net_ipv6addr_hdrcopy(ipv6->srcipaddr, dev->d_ipv6addr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      dev->d_len = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, ipv4->srcipaddr);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &dev->d_ipaddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  /* And send out the SYNACK packet */
+
+  tcp_sendcomplete(dev, tcp);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_ack
  *
@@ -546,7 +660,37 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack)
 {
   struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
   uint16_t tcp_mss;
+  uint16_t optlen;
+#ifdef CONFIG_NET_TCP_SACK
+  bool sackperm;
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  bool wscale;
+#endif
+
+  /* We always send the TCP Maximum Segment Size option.  The SACK
+   * permitted and window scale options are offered in our SYN and, in the
+   * SYNACK, are returned only if the peer offered them in its SYN.  Each
+   * is padded with NOPs to a word boundary.
+   */
+
+  optlen = TCP_OPT_MSS_LEN;
+#ifdef CONFIG_NET_TCP_SACK
+  sackperm = (ack == TCP_SYN || conn->sack);
+  if (sackperm)
+    {
+      optlen += 2 + TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  wscale = (ack == TCP_SYN || conn->wscale);
+  if (wscale)
+    {
+      optlen += 1 + TCP_OPT_WS_LEN;
+    }
+#endif
 
   /* Get values that vary with the underlying IP domain */
 
@@ -560,9 +704,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv6BUF;
       tcp_mss = TCP_IPv6_MSS(dev);
 
-      /* Set the packet length for the TCP Maximum Segment Size */
+      /* Set the packet length for the TCP options */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN + optlen;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -576,9 +720,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv4BUF;
       tcp_mss = TCP_IPv4_MSS(dev);
 
-      /* Set the packet length for the TCP Maximum Segment Size */
+      /* Set the packet length for the TCP options */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN + optlen;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -588,11 +732,39 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   /* We send out the TCP Maximum Segment Size option with our ack. */
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optdata         = tcp->optdata;
+  *optdata++      = TCP_OPT_MSS;
+  *optdata++      = TCP_OPT_MSS_LEN;
+  *optdata++      = tcp_mss >> 8;
+  *optdata++      = tcp_mss & 0xff;
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (sackperm)
+    {
+      *optdata++  = TCP_OPT_NOOP;
+      *optdata++  = TCP_OPT_NOOP;
+      *optdata++  = TCP_OPT_SACK_PERM;
+      *optdata++  = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (wscale)
+    {
+      /* Remember the shift that we offered.  It is used only if the peer
+       * also sends the window scale option.
+       */
+
+      conn->rcv_scale = tcp_get_recvwscale(dev);
+
+      *optdata++  = TCP_OPT_NOOP;
+      *optdata++  = TCP_OPT_WS;
+      *optdata++  = TCP_OPT_WS_LEN;
+      *optdata++  = conn->rcv_scale;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
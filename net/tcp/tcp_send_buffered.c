@@ -66,6 +66,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
 
@@ -385,6 +386,403 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: psock_rewind_segment
+ *
+ * Description:
+ *   Reset the number of bytes sent from a write buffer so that all of its
+ *   data will be sent again.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   wrb      The write buffer to be resent
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+static void psock_rewind_segment(FAR struct tcp_conn_s *conn,
+                                 FAR struct tcp_wrbuffer_s *wrb)
+{
+  uint16_t sent = TCP_WBSENT(wrb);
+
+  if (conn->unacked > sent)
+    {
+      conn->unacked -= sent;
+    }
+  else
+    {
+      conn->unacked = 0;
+    }
+
+  if (conn->sent > sent)
+    {
+      conn->sent -= sent;
+    }
+  else
+    {
+      conn->sent = 0;
+    }
+
+  TCP_WBSENT(wrb) = 0;
+  TCP_WBNRTX(wrb)++;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_fast_retransmit
+ *
+ * Description:
+ *   Queue the first un-ACKed (and, with SACK, not selectively ACKed) write
+ *   buffer for immediate retransmission.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   true if a write buffer was queued for retransmission.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+static bool psock_fast_retransmit(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+
+  /* The un-ACKed segments are held in the unacked_q in sequence number
+   * order.  Look for the first one that the peer is still missing.
+   */
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+
+#ifdef CONFIG_NET_TCP_SACK
+      if (TCP_WBSACKED(wrb))
+        {
+          continue;
+        }
+#endif
+
+      ninfo("FASTREXMIT: wrb=%p seqno=%u pktlen=%u\n",
+            wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+
+      /* Move the write buffer to the write_q.  It will be sent ahead of
+       * any unsent data because the write_q is in sequence number order.
+       */
+
+      sq_rem(entry, &conn->unacked_q);
+      psock_rewind_segment(conn, wrb);
+      psock_insert_segment(wrb, &conn->write_q);
+      return true;
+    }
+
+  /* Otherwise, the missing data may be in the partially sent write buffer
+   * at the head of the write_q.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb != NULL && TCP_WBSENT(wrb) > 0)
+    {
+      ninfo("FASTREXMIT: wrb=%p seqno=%u sent=%u\n",
+            wrb, TCP_WBSEQNO(wrb), TCP_WBSENT(wrb));
+
+      psock_rewind_segment(conn, wrb);
+      return true;
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_sack_update
+ *
+ * Description:
+ *   Mark the write buffers that are covered by the SACK blocks of an
+ *   incoming ACK.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   tcp      The TCP header of the incoming ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static void psock_sack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR uint8_t *optdata;
+  uint32_t left;
+  uint32_t right;
+  int optlen;
+  int i;
+  int j;
+
+  optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optlen  = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+
+  for (i = 0; i < optlen; )
+    {
+      if (optdata[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (optdata[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || optdata[i + 1] < 2 ||
+               i + optdata[i + 1] > optlen)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      if (optdata[i] == TCP_OPT_SACK)
+        {
+          /* Each block holds the left and right edges of a contiguous
+           * range of sequence numbers that the peer has received.
+           */
+
+          for (j = i + 2; j + TCP_OPT_SACK_BLKLEN <= i + optdata[i + 1];
+               j += TCP_OPT_SACK_BLKLEN)
+            {
+              left  = tcp_getsequence(&optdata[j]);
+              right = tcp_getsequence(&optdata[j + 4]);
+
+              for (entry = sq_peek(&conn->unacked_q);
+                   entry;
+                   entry = sq_next(entry))
+                {
+                  wrb = (FAR struct tcp_wrbuffer_s *)entry;
+                  if (TCP_WBSEQNO(wrb) >= left &&
+                      TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb) <= right)
+                    {
+                      ninfo("SACK: wrb=%p seqno=%u\n",
+                            wrb, TCP_WBSEQNO(wrb));
+                      TCP_WBSACKED(wrb) = true;
+                    }
+                }
+            }
+        }
+
+      i += optdata[i + 1];
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_fast_recovery
+ *
+ * Description:
+ *   Detect duplicate ACKs and manage NewReno fast recovery (RFC 6582).
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   conn     The connection structure associated with the socket
+ *   tcp      The TCP header of the incoming ACK
+ *   ackno    The ACK number of the incoming ACK
+ *
+ * Returned Value:
+ *   true if a write buffer was queued for immediate retransmission.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+static bool psock_fast_recovery(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn,
+                                FAR struct tcp_hdr_s *tcp, uint32_t ackno)
+{
+  bool dupack;
+
+  /* A duplicate ACK carries no data, does not advance the ACK number,
+   * and does not change the advertised window.
+   */
+
+  dupack = (ackno == conn->lastackno && dev->d_len == 0 &&
+            (tcp->flags & (TCP_SYN | TCP_FIN)) == 0 &&
+            conn->winsize == conn->lastwnd);
+  conn->lastwnd = conn->winsize;
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (conn->sack)
+    {
+      psock_sack_update(conn, tcp);
+    }
+#endif
+
+  if (ackno > conn->lastackno)
+    {
+      /* New data has been ACKed */
+
+      conn->lastackno = ackno;
+      conn->dupacks   = 0;
+
+      if (conn->recovery)
+        {
+          if (ackno >= conn->recover)
+            {
+              /* A full ACK:  All data outstanding when the loss was
+               * detected has been ACKed.
+               */
+
+              ninfo("FASTREXMIT: Recovery complete ackno=%u\n", ackno);
+              conn->recovery = false;
+            }
+          else
+            {
+              /* A partial ACK:  The next missing segment was lost too */
+
+              return psock_fast_retransmit(conn);
+            }
+        }
+
+      return false;
+    }
+
+  if (!dupack || conn->dupacks >= TCP_DUPACK_THRESH)
+    {
+      return false;
+    }
+
+  if (++conn->dupacks == TCP_DUPACK_THRESH && !conn->recovery)
+    {
+      /* Three duplicate ACKs:  Assume that the first un-ACKed segment was
+       * lost and enter fast recovery.
+       */
+
+      ninfo("FASTREXMIT: ackno=%u recover=%u\n", ackno, conn->sndseq_max);
+
+      conn->recovery = true;
+      conn->recover  = conn->sndseq_max;
+#ifdef CONFIG_NET_TCP_CC
+      conn->cc->loss(conn, false);
+#endif
+      return psock_fast_retransmit(conn);
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_send_corked
+ *
+ * Description:
+ *   Return true if the write buffer at the head of the write queue should
+ *   be held back because the socket is corked:  It is the only one queued,
+ *   none of it has been sent, and it does not yet fill a segment.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *
+ * Assumptions:
+ *   The network is locked and the write queue is not empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+static inline bool psock_send_corked(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  if (!conn->cork || conn->nodelay)
+    {
+      return false;
+    }
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  return sq_next(&wrb->wb_node) == NULL && TCP_WBSENT(wrb) == 0 &&
+         TCP_WBSEQNO(wrb) == (unsigned)-1 && TCP_WBPKTLEN(wrb) < conn->mss;
+}
+#else
+#  define psock_send_corked(conn) false
+#endif
+
+/****************************************************************************
+ * Name: psock_cork_append
+ *
+ * Description:
+ *   While the socket is corked, add a small write to the last write buffer
+ *   instead of queuing a new one, so that several writes go out as one
+ *   segment.
+ *
+ * Input Parameters:
+ *   conn     The connection structure associated with the socket
+ *   buf      Data to send
+ *   len      Length of data to send
+ *
+ * Returned Value:
+ *   true if all of the data was added to the last write buffer; false if
+ *   nothing was added.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+static bool psock_cork_append(FAR struct tcp_conn_s *conn,
+                              FAR const void *buf, size_t len)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR struct iob_s *iob;
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
+  if (wrb == NULL || TCP_WBSENT(wrb) != 0 ||
+      TCP_WBSEQNO(wrb) != (unsigned)-1 ||
+      TCP_WBPKTLEN(wrb) + len > conn->mss)
+    {
+      return false;
+    }
+
+  /* Only append data that fits in the last I/O buffer of the chain.  Then
+   * the copy cannot fail part way through.
+   */
+
+  iob = TCP_WBIOB(wrb);
+  while (iob->io_flink != NULL)
+    {
+      iob = iob->io_flink;
+    }
+
+  if (IOB_BUFSIZE(iob) - iob->io_offset - iob->io_len < len)
+    {
+      return false;
+    }
+
+  return iob_trycopyin(TCP_WBIOB(wrb), (FAR const uint8_t *)buf, len,
+                       TCP_WBPKTLEN(wrb), false) == OK;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -411,6 +809,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pvconn;
   FAR struct socket *psock = (FAR struct socket *)pvpriv;
+  bool rexmit = false;
 
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the one that we are bound to.
@@ -435,6 +834,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR sq_entry_t *entry;
       FAR sq_entry_t *next;
       uint32_t ackno;
+#ifdef CONFIG_NET_TCP_CC
+      uint32_t nacked = 0;
+#endif
 
       /* Get the offset address of the TCP header */
 
@@ -497,6 +899,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_CC
+                  nacked += TCP_WBPKTLEN(wrb);
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -525,6 +931,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                   ninfo("ACK: wrb=%p trim %u bytes\n", wrb, trimlen);
 
+#ifdef CONFIG_NET_TCP_CC
+                  nacked += trimlen;
+#endif
+
                   TCP_WBTRIM(wrb, trimlen);
                   TCP_WBSEQNO(wrb) = ackno;
                   TCP_WBSENT(wrb) -= trimlen;
@@ -545,30 +955,56 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
       if (wrb && TCP_WBSENT(wrb) > 0 && ackno > TCP_WBSEQNO(wrb))
         {
-          uint32_t nacked;
+          uint32_t trimlen;
 
           /* Number of bytes that were ACKed */
 
-          nacked = ackno - TCP_WBSEQNO(wrb);
-          if (nacked > TCP_WBSENT(wrb))
+          trimlen = ackno - TCP_WBSEQNO(wrb);
+          if (trimlen > TCP_WBSENT(wrb))
             {
               /* More data has been ACKed then we have sent? ASSERT? */
 
-              nacked = TCP_WBSENT(wrb);
+              trimlen = TCP_WBSENT(wrb);
             }
 
           ninfo("ACK: wrb=%p seqno=%u nacked=%u sent=%u ackno=%u\n",
-                wrb, TCP_WBSEQNO(wrb), nacked, TCP_WBSENT(wrb), ackno);
+                wrb, TCP_WBSEQNO(wrb), trimlen, TCP_WBSENT(wrb), ackno);
 
           /* Trim the ACKed bytes from the beginning of the write buffer. */
 
-          TCP_WBTRIM(wrb, nacked);
+          TCP_WBTRIM(wrb, trimlen);
           TCP_WBSEQNO(wrb) = ackno;
-          TCP_WBSENT(wrb) -= nacked;
+          TCP_WBSENT(wrb) -= trimlen;
+#ifdef CONFIG_NET_TCP_CC
+          nacked += trimlen;
+#endif
 
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      /* Check for duplicate ACKs and partial ACKs that indicate a lost
+       * segment.
+       */
+
+      rexmit = psock_fast_recovery(dev, conn, tcp, ackno);
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Let the congestion control algorithm open the congestion window.
+       * The window is not opened while recovering from a loss.
+       */
+
+      if (nacked > 0
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+          && !conn->recovery
+#endif
+         )
+        {
+          conn->cc->ack(conn, nacked);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -604,6 +1040,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      /* A retransmission timeout ends any fast recovery */
+
+      conn->recovery = false;
+      conn->dupacks  = 0;
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      /* And restarts slow start */
+
+      conn->cc->loss(conn, true);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -707,6 +1156,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("REXMIT: wrb=%p sent=%u, conn unacked=%d sent=%d\n",
                 wrb, TCP_WBSENT(wrb), conn->unacked, conn->sent);
 
+#ifdef CONFIG_NET_TCP_SACK
+          /* The peer may discard data that it has selectively ACKed
+           * (RFC 2018), so forget the SACK information after a timeout.
+           */
+
+          TCP_WBSACKED(wrb) = false;
+#endif
+
           /* Free any write buffers that have exceed the retry count */
 
           if (++TCP_WBNRTX(wrb) >= TCP_MAXRTX)
@@ -760,12 +1217,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
    * the outgoing packet is available for our use.  In this case, we are
    * now free to send more data to receiver -- UNLESS the buffer contains
    * unprocessed incoming data.  In that event, we will have to wait for the
-   * next polling cycle.
+   * next polling cycle.  A fast retransmission is sent in response to the
+   * ACK that triggered it if that ACK carried no data.
    */
 
   if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
-      (flags & (TCP_POLL | TCP_REXMIT)) &&
-      !(sq_empty(&conn->write_q)))
+      ((flags & (TCP_POLL | TCP_REXMIT)) != 0 ||
+       (rexmit && dev->d_len == 0)) &&
+      !(sq_empty(&conn->write_q)) && !psock_send_corked(conn))
     {
       /* Check if the destination IP address is in the ARP  or Neighbor
        * table.  If not, then the send won't actually make it out... it
@@ -777,6 +1236,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
           size_t sndlen;
+          size_t maxlen;
 
           /* Peek at the head of the write queue (but don't remove anything
            * from the write queue yet).  We know from the above test that
@@ -792,10 +1252,23 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            * window size.
            */
 
+          maxlen = conn->mss;
+
+#ifdef CONFIG_NETDEV_TSO
+          /* If the device supports TCP segmentation offload, then we can
+           * send several MSS-sized segments in one large frame.
+           */
+
+          if (dev->d_tsomax > conn->mss)
+            {
+              maxlen = dev->d_tsomax;
+            }
+#endif
+
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           if (sndlen > conn->winsize)
@@ -803,6 +1276,49 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = conn->winsize;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* New data is also limited by the congestion window.
+           * Retransmissions are not.
+           */
+
+          if (TCP_WBSEQNO(wrb) == (unsigned)-1 ||
+              TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb) >= conn->sndseq_max)
+            {
+              uint32_t cwndleft = 0;
+
+              if (conn->cwnd > conn->unacked)
+                {
+                  cwndleft = conn->cwnd - conn->unacked;
+                }
+
+              if (sndlen > cwndleft)
+                {
+                  if (cwndleft < conn->mss)
+                    {
+                      /* Wait for ACKs to open the congestion window */
+
+                      ninfo("SEND: cwnd=%u unacked=%u\n",
+                            conn->cwnd, conn->unacked);
+                      return flags;
+                    }
+
+                  sndlen = cwndleft;
+                }
+            }
+#endif
+
+#ifdef CONFIG_NETDEV_TSO
+          /* Only the last segment of the write buffer may be short.
+           * Otherwise, the final segment of each large frame would be.
+           */
+
+          if (sndlen > conn->mss &&
+              sndlen < TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb))
+            {
+              sndlen -= sndlen % conn->mss;
+            }
+#endif
+
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen);
 
@@ -839,7 +1355,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            * won't actually happen until the polling cycle completes).
            */
 
-          devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
+#ifdef CONFIG_NETDEV_TSO
+          if (sndlen > conn->mss)
+            {
+              devif_tso_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb),
+                             conn->mss);
+            }
+          else
+#endif
+            {
+              devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
+            }
 
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
@@ -1086,6 +1612,19 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        */
 
       net_lock();
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+      if (conn->cork && psock_cork_append(conn, buf, len))
+        {
+          /* The last write buffer may now fill a segment */
+
+          result = len;
+          send_txnotify(psock, conn);
+          net_unlock();
+          goto done;
+        }
+#endif
+
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           wrb = tcp_wrbuffer_tryalloc();
@@ -1192,6 +1731,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       net_unlock();
     }
 
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+done:
+#endif
+
   /* Set the socket state to idle */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
@@ -58,6 +58,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -99,6 +100,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_map;     /* Mapped data at snd_foffset (or NULL) */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -418,25 +420,40 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_map != NULL)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
-            }
+              /* The file is mapped into memory.  Send the data directly
+               * from there.  If the driver supports scatter-gather
+               * transmit, it is not even copied into d_buf.
+               */
 
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+              devif_ref_send(dev, pstate->snd_map + pstate->snd_sent,
+                             sndlen);
+            }
+          else
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to lseek: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       (int)ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              dev->d_sndlen = sndlen;
             }
 
-          dev->d_sndlen = sndlen;
-
           /* Set the sequence number for this packet.  NOTE:  The network updates
            * sndseq on recept of ACK *before* this function is called.  In that
            * case sndseq will point to the next unacknowledge byte (which might
@@ -445,7 +462,8 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            */
 
           seqno = pstate->snd_sent + pstate->snd_isn;
-          ninfo("SEND: sndseq %08x->%08x len: %d\n", conn->sndseq, seqno, ret);
+          ninfo("SEND: sndseq %08x->%08x len: %d\n",
+                conn->sndseq, seqno, (int)sndlen);
 
           tcp_setsequence(conn->sndseq, seqno);
 
@@ -509,6 +527,56 @@ wait:
   return flags;
 }
 
+/****************************************************************************
+ * Name: sendfile_mmap
+ *
+ * Description:
+ *   Check if the input file can be accessed directly in memory.  This is
+ *   the case for files on an XIP ROMFS volume (where the data is in flash)
+ *   or on TMPFS.  Then the file data need not be read into the device
+ *   buffer through the file system for each packet.
+ *
+ * Input Parameters:
+ *   infile - The input file
+ *   offset - The file offset of the first byte to send
+ *   count  - The number of bytes to send.  This is reduced to the number of
+ *            bytes up to the end of the file.
+ *
+ * Returned Value:
+ *   The address of the file data at 'offset' or NULL if the file cannot be
+ *   accessed in memory.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *sendfile_mmap(FAR struct file *infile,
+                                        off_t offset, FAR size_t *count)
+{
+  FAR uint8_t *addr = NULL;
+  struct stat buf;
+  int ret;
+
+  ret = file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+  if (ret < 0 || addr == NULL)
+    {
+      return NULL;
+    }
+
+  /* Don't send beyond the end of the mapped file */
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0 || offset < 0 || offset >= buf.st_size)
+    {
+      return NULL;
+    }
+
+  if (*count > buf.st_size - offset)
+    {
+      *count = buf.st_size - offset;
+    }
+
+  return addr + offset;
+}
+
 /****************************************************************************
  * Name: sendfile_txnotify
  *
@@ -584,6 +652,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *map;
   struct sendfile_s state;
   int ret;
 
@@ -631,6 +700,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Check if the file data can be sent directly from memory */
+
+  map = sendfile_mmap(infile, offset ? *offset : 0, &count);
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -654,6 +727,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : 0; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_map     = map;                  /* Mapped file data (or NULL) */
 
   /* Allocate resources to receive a callback */
 
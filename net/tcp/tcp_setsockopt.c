@@ -51,6 +51,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
 #include "tcp/tcp.h"
@@ -88,11 +89,6 @@
 int tcp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
-   */
-
   FAR struct tcp_conn_s *conn;
   int ret;
 
@@ -110,10 +106,9 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
       return -ENOTCONN;
     }
 
-  /* Handle the Keep-Alive option */
-
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -148,11 +143,73 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif
+
+      /* Small segments are never held back to be coalesced (there is no
+       * Nagle algorithm), so TCP_NODELAY only overrides TCP_CORK.  Setting
+       * it sends any data that has been held back.
+       */
+
       case TCP_NODELAY: /* Avoid coalescing of small segments. */
-        nerr("ERROR: TCP_NODELAY not supported\n");
-        ret = -ENOSYS;
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            int nodelay = *(FAR int *)value;
+
+            if (nodelay != 0 && nodelay != 1)
+              {
+                nerr("ERROR: TCP_NODELAY value out of range: %d\n",
+                     nodelay);
+                return -EDOM;
+              }
+
+            conn->nodelay = (bool)nodelay;
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+            if (conn->nodelay && conn->cork && conn->dev != NULL)
+              {
+                netdev_txnotify_dev(conn->dev);
+              }
+#endif
+            ret = OK;
+          }
         break;
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      case TCP_CORK: /* Hold back partial segments */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            int cork = *(FAR int *)value;
+
+            if (cork != 0 && cork != 1)
+              {
+                nerr("ERROR: TCP_CORK value out of range: %d\n", cork);
+                return -EDOM;
+              }
+
+            /* Send whatever was held back when the socket is uncorked */
+
+            net_lock();
+            if (conn->cork && !cork && conn->dev != NULL)
+              {
+                netdev_txnotify_dev(conn->dev);
+              }
+
+            conn->cork = (bool)cork;
+            net_unlock();
+            ret = OK;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
         if (value_len != sizeof(struct timeval))
           {
@@ -252,6 +309,39 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
+
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const struct tcp_cc_s *cc;
+
+          cc = tcp_cc_find((FAR const char *)value, value_len);
+          if (cc == NULL)
+            {
+              nerr("ERROR: Unknown TCP congestion control\n");
+              ret = -ENOENT;
+            }
+          else
+            {
+              /* If the connection is already established, just restart
+               * the algorithm with the current window.  Otherwise, it
+               * will be initialized when the connection is established.
+               */
+
+              conn->cc = cc;
+              if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+                  cc->init != NULL)
+                {
+                  cc->init(conn);
+                }
+
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -259,9 +349,6 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
     }
 
   return ret;
-#else
-  return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
@@ -0,0 +1,401 @@
+/****************************************************************************
+ * net/tcp/tcp_syncookie.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+#  include <sys/random.h>
+#endif
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/* A SYN cookie is the initial sequence number of the SYNACK.  It holds:
+ *
+ *   Bits 27-31: A counter that advances every SYNCOOKIE_PERIOD
+ *   Bits 24-26: An index into g_syncookie_mss[]
+ *   Bits  0-23: A keyed hash of the above and of the connection
+ *
+ * A cookie is accepted in the period in which it was sent and in the
+ * following one.
+ */
+
+#define SYNCOOKIE_PERIOD      SEC2TICK(64)
+#define SYNCOOKIE_COUNTSHIFT  27
+#define SYNCOOKIE_COUNTMASK   0x1f
+#define SYNCOOKIE_MSSSHIFT    24
+#define SYNCOOKIE_MSSMASK     0x07
+#define SYNCOOKIE_HASHMASK    0x00ffffff
+
+/* The MSS assumed by TCP if the peer does not send the MSS option */
+
+#define SYNCOOKIE_DEFAULT_MSS 536
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MSS values that can be encoded in a cookie */
+
+static const uint16_t g_syncookie_mss[SYNCOOKIE_MSSMASK + 1] =
+{
+  64, 536, 1024, 1200, 1360, 1400, 1440, 1460
+};
+
+/* The secret used to key the cookie hash */
+
+static uint32_t g_syncookie_secret[2];
+static bool g_syncookie_seeded;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_seed
+ *
+ * Description:
+ *   Select the secret used to key the cookie hash.
+ *
+ ****************************************************************************/
+
+static void tcp_syncookie_seed(void)
+{
+#ifdef CONFIG_CRYPTO_RANDOM_POOL
+  getrandom(g_syncookie_secret, sizeof(g_syncookie_secret));
+#else
+  uint8_t seqno[4];
+
+  /* Without a random pool, use the only unpredictable values at hand */
+
+  tcp_initsequence(seqno);
+  g_syncookie_secret[0] = tcp_getsequence(seqno) ^ 0x5bd1e995;
+  g_syncookie_secret[1] = (uint32_t)clock_systimer() * 0x9e3779b1;
+#endif
+
+  g_syncookie_seeded = true;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_mix
+ *
+ * Description:
+ *   Mix one 32-bit value into the cookie hash.  This is a cheap mixing
+ *   function, not a cryptographic hash; it need only make the cookie
+ *   impractical to guess within its short lifetime.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_syncookie_mix(uint32_t hash, uint32_t value)
+{
+  hash ^= value;
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 16);
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_hash
+ *
+ * Description:
+ *   Compute the hash part of the cookie for the connection described by
+ *   the packet in the device buffer (a SYN or the ACK that follows it).
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure that received the packet
+ *   tcp     - The TCP header of the packet
+ *   peeriss - The initial sequence number of the peer
+ *   count   - The cookie counter
+ *   mssidx  - The index into g_syncookie_mss[]
+ *
+ * Returned Value:
+ *   The 24-bit hash.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_syncookie_hash(FAR struct net_driver_s *dev,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   uint32_t peeriss, uint32_t count,
+                                   unsigned int mssidx)
+{
+  FAR uint16_t *srcipaddr;
+  FAR uint16_t *destipaddr;
+  uint32_t hash;
+  int nwords;
+  int i;
+
+  if (!g_syncookie_seeded)
+    {
+      tcp_syncookie_seed();
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      srcipaddr  = ipv6->srcipaddr;
+      destipaddr = ipv6->destipaddr;
+      nwords     = 8;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      srcipaddr  = ipv4->srcipaddr;
+      destipaddr = ipv4->destipaddr;
+      nwords     = 2;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  hash = g_syncookie_secret[0];
+  for (i = 0; i < nwords; i++)
+    {
+      hash = tcp_syncookie_mix(hash, (uint32_t)srcipaddr[i] << 16 |
+                                     destipaddr[i]);
+    }
+
+  hash = tcp_syncookie_mix(hash, (uint32_t)tcp->srcport << 16 |
+                                 tcp->destport);
+  hash = tcp_syncookie_mix(hash, peeriss);
+  hash = tcp_syncookie_mix(hash, count << 3 | mssidx);
+  hash = tcp_syncookie_mix(hash, g_syncookie_secret[1]);
+
+  return hash & SYNCOOKIE_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_peermss
+ *
+ * Description:
+ *   Get the MSS option from the SYN in the device buffer.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_syncookie_peermss(FAR struct net_driver_s *dev,
+                                      FAR struct tcp_hdr_s *tcp,
+                                      unsigned int hdrlen)
+{
+  uint8_t opt;
+  int optlen;
+  int i;
+
+  optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  for (i = 0; i < optlen; )
+    {
+      opt = dev->d_buf[hdrlen + i];
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          ++i;
+        }
+      else if (opt == TCP_OPT_MSS &&
+               dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
+        {
+          return ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
+                  (uint16_t)dev->d_buf[hdrlen + 3 + i];
+        }
+      else if (dev->d_buf[hdrlen + 1 + i] == 0)
+        {
+          /* Malformed options */
+
+          break;
+        }
+      else
+        {
+          i += dev->d_buf[hdrlen + 1 + i];
+        }
+    }
+
+  return SYNCOOKIE_DEFAULT_MSS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK that carries a SYN
+ *   cookie.  No connection structure is allocated.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   tcp    - The TCP header of the SYN
+ *   iplen  - The size of the IP header
+ *   hdrlen - Offset to the first TCP option in d_buf
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_hdr_s *tcp, unsigned int iplen,
+                          unsigned int hdrlen)
+{
+  uint32_t cookie;
+  uint32_t count;
+  uint16_t tcp_mss;
+  uint16_t mss;
+  unsigned int mssidx;
+
+  /* Encode the largest MSS not greater than what both sides support */
+
+  tcp_mss = TCP_MSS(dev, iplen);
+  mss     = tcp_syncookie_peermss(dev, tcp, hdrlen);
+  if (mss > tcp_mss)
+    {
+      mss = tcp_mss;
+    }
+
+  mssidx = SYNCOOKIE_MSSMASK;
+  while (mssidx > 0 && g_syncookie_mss[mssidx] > mss)
+    {
+      mssidx--;
+    }
+
+  count  = (clock_systimer() / SYNCOOKIE_PERIOD) & SYNCOOKIE_COUNTMASK;
+  cookie = count << SYNCOOKIE_COUNTSHIFT |
+           (uint32_t)mssidx << SYNCOOKIE_MSSSHIFT |
+           tcp_syncookie_hash(dev, tcp, tcp_getsequence(tcp->seqno), count,
+                              mssidx);
+
+  ninfo("SYN cookie %08x mss=%u\n", cookie, g_syncookie_mss[mssidx]);
+  tcp_synack(dev, cookie, tcp_mss);
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if the ACK in the device buffer returns a valid SYN cookie.  If
+ *   so, allocate a connection in the SYN_RCVD state for it, just as if the
+ *   SYN had been answered by tcp_alloc_accept().
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the ACK
+ *   tcp    - The TCP header of the ACK
+ *
+ * Returned Value:
+ *   The new connection or NULL if the cookie is not valid or no connection
+ *   structure is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_conn_s *conn;
+  uint32_t cookie;
+  uint32_t count;
+  uint32_t now;
+  unsigned int mssidx;
+
+  /* The ACK acknowledges the cookie and carries the peer's ISS plus one */
+
+  cookie = tcp_getsequence(tcp->ackno) - 1;
+  count  = (cookie >> SYNCOOKIE_COUNTSHIFT) & SYNCOOKIE_COUNTMASK;
+  mssidx = (cookie >> SYNCOOKIE_MSSSHIFT) & SYNCOOKIE_MSSMASK;
+  now    = clock_systimer() / SYNCOOKIE_PERIOD;
+
+  if (((now - count) & SYNCOOKIE_COUNTMASK) > 1 ||
+      tcp_syncookie_hash(dev, tcp, tcp_getsequence(tcp->seqno) - 1, count,
+                         mssidx) != (cookie & SYNCOOKIE_HASHMASK))
+    {
+      return NULL;
+    }
+
+  conn = tcp_alloc_accept(dev, tcp);
+  if (conn == NULL)
+    {
+      nerr("ERROR: No free TCP connections\n");
+      return NULL;
+    }
+
+  /* The SYNACK has already been sent and, unlike after a SYN, the rcvseq
+   * copied from this packet is already correct.
+   */
+
+  conn->crefs = 1;
+  conn->mss   = g_syncookie_mss[mssidx];
+  tcp_setsequence(conn->sndseq, cookie);
+
+  ninfo("SYN cookie %08x accepted: %p\n", cookie, conn);
+  return conn;
+}
+
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
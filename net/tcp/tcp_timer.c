@@ -235,11 +235,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
                   /* Find the listener for this connection. */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-                  listener = tcp_findlistener(conn->lport, conn->domain);
-#else
-                  listener = tcp_findlistener(conn->lport);
-#endif
+                  listener = tcp_connlistener(conn);
                   if (listener != NULL)
                     {
                       /* We call tcp_callback() for the connection with
@@ -478,6 +474,17 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
         }
     }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Don't hold a delayed ACK past the timer poll */
+
+  if (conn->ackpending > 0 && dev == conn->dev &&
+      (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+    {
+      tcp_send(dev, conn, TCP_ACK, hdrlen);
+      goto done;
+    }
+#endif
+
   /* Nothing to be done */
 
   dev->d_len = 0;
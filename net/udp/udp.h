@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <nuttx/clock.h>
@@ -93,8 +94,34 @@
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
+#define _UDP_FLAG_REUSEPORT   (1 << 1) /* Bit 1:  Bound with SO_REUSEPORT */
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
+#define _UDP_ISREUSEPORT(f)   (((f) & _UDP_FLAG_REUSEPORT) != 0)
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+/* Each datagram in the read-ahead queue is preceded by a header:  One byte
+ * holding the size of the source address, the source address itself, and
+ * then (if CONFIG_NET_UDP_TIMESTAMP) the time of reception as a struct
+ * timespec.  UDP_READAHEAD_HDRLEN() gives the offset of the payload.
+ */
+
+#  ifdef CONFIG_NET_UDP_TIMESTAMP
+#    define UDP_READAHEAD_TSLEN    sizeof(struct timespec)
+#  else
+#    define UDP_READAHEAD_TSLEN    0
+#  endif
+
+#  define UDP_READAHEAD_HDRLEN(a)  (sizeof(uint8_t) + (a) + UDP_READAHEAD_TSLEN)
+
+/* A multicast or broadcast datagram received by several sockets is queued
+ * only once.  The read-ahead I/O buffer chain is shared by all of them.
+ */
+
+#  ifdef CONFIG_IOB_REFCOUNT
+#    define UDP_SHARED_READAHEAD   1
+#  endif
+#endif
 
 /****************************************************************************
  * Public Type Definitions
@@ -108,6 +135,7 @@ struct udp_hdr_s;         /* Forward reference */
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+  dq_entry_t hnode;       /* Links bound connections in a hash bucket */
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -232,6 +260,23 @@ void udp_free(FAR struct udp_conn_s *conn);
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_nextactive
+ *
+ * Description:
+ *   Find the next connection after conn that should also receive the
+ *   multicast or broadcast UDP packet in the provided UDP/IP header.  conn
+ *   was returned by udp_active() or by a previous call to this function.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct udp_conn_s *udp_nextactive(FAR struct net_driver_s *dev,
+                                      FAR struct udp_hdr_s *udp,
+                                      FAR struct udp_conn_s *conn);
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -591,6 +636,26 @@ FAR struct net_driver_s *udp_find_raddr_device(FAR struct udp_conn_s *conn);
 uint16_t udp_callback(FAR struct net_driver_s *dev,
                       FAR struct udp_conn_s *conn, uint16_t flags);
 
+/****************************************************************************
+ * Name: udp_readahead_share
+ *
+ * Description:
+ *   Begin (share == true) or end (share == false) the delivery of one
+ *   received packet to several connections.  In between, the read-ahead
+ *   I/O buffer chain built for the first connection is shared with the
+ *   others rather than copying the packet again for each of them.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef UDP_SHARED_READAHEAD
+void udp_readahead_share(bool share);
+#else
+#  define udp_readahead_share(s)
+#endif
+
 /****************************************************************************
  * Name: psock_udp_send
  *
@@ -631,6 +696,46 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmsg
+ *
+ * Description:
+ *   Send one datagram gathered from a list of buffers.  The buffers are
+ *   copied directly into the I/O buffer chain of a UDP write buffer, so no
+ *   intermediate copy is made.  The parameters are otherwise as for
+ *   psock_udp_sendto(); 'to' may be NULL for a connected socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen);
+#endif
+
+/****************************************************************************
+ * Name: udp_loopback_send
+ *
+ * Description:
+ *   Deliver a buffered datagram to a socket on the local loopback device
+ *   by moving its I/O buffer chain directly into the read-ahead queue of
+ *   the receiving connection.  On success, wrb->wb_iob is set to NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) if the datagram was delivered.  A negated errno value if it
+ *   must be sent normally.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_LOOPBACK_ZEROCOPY
+int udp_loopback_send(FAR struct udp_conn_s *conn,
+                      FAR struct udp_wrbuffer_s *wrb);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -41,7 +41,9 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <time.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -62,6 +64,31 @@
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define UDPIPv6BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef UDP_SHARED_READAHEAD
+/* While one packet is delivered to several connections, this holds the
+ * read-ahead I/O buffer chain that was queued for the first of them.
+ */
+
+struct udp_share_s
+{
+  bool              us_share;    /* A packet is being delivered */
+  uint8_t           us_addrsize; /* Size of the source address in us_iob */
+  FAR struct iob_s *us_iob;      /* The shareable I/O buffer chain */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef UDP_SHARED_READAHEAD
+static struct udp_share_s g_udp_share;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -89,17 +116,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 #endif
   FAR void  *src_addr;
   uint8_t src_addr_size;
-
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  struct timespec tstamp;
+#endif
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -164,6 +183,43 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef UDP_SHARED_READAHEAD
+  /* If this packet was already queued for another connection with the
+   * same form of source address, then just share that I/O buffer chain.
+   */
+
+  iob = g_udp_share.us_iob;
+  if (iob != NULL && g_udp_share.us_addrsize == src_addr_size &&
+      iob_share_chain(iob) == OK)
+    {
+      ret = iob_tryadd_queue(iob, &conn->readahead);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
+          (void)iob_free_chain(iob);
+          return 0;
+        }
+
+#ifdef CONFIG_UDP_READAHEAD_NOTIFIER
+      udp_notifier_signal(conn);
+#endif
+
+      ninfo("Shared %d bytes\n", buflen);
+      return buflen;
+    }
+#endif
+
+  /* Allocate on I/O buffer to start the chain (throttling as necessary).
+   * We will not wait for an I/O buffer to become available in this context.
+   */
+
+  iob = iob_tryalloc_user(true, IOBUSER_NET_UDP);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to create new I/O buffer chain\n");
+      return 0;
+    }
+
   /* Copy the src address info into the I/O buffer chain.  We will not wait
    * for an I/O buffer to become available in this context.  It there is
    * any failure to allocated, the entire I/O buffer chain will be discarded.
@@ -195,12 +251,27 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  /* Record the time of reception for SO_TIMESTAMP */
+
+  (void)clock_gettime(CLOCK_REALTIME, &tstamp);
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&tstamp, sizeof(tstamp),
+                      src_addr_size + sizeof(uint8_t), true);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      (void)iob_free_chain(iob);
+      return 0;
+    }
+#endif
+
   if (buflen > 0)
     {
       /* Copy the new appdata into the I/O buffer chain */
 
       ret = iob_trycopyin(iob, buffer, buflen,
-                          src_addr_size + sizeof(uint8_t), true);
+                          UDP_READAHEAD_HDRLEN(src_addr_size), true);
       if (ret < 0)
         {
           /* On a failure, iob_trycopyin return a negated error value but
@@ -224,6 +295,16 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef UDP_SHARED_READAHEAD
+  /* Let any further recipients of this packet share the chain */
+
+  if (g_udp_share.us_share && g_udp_share.us_iob == NULL)
+    {
+      g_udp_share.us_iob      = iob;
+      g_udp_share.us_addrsize = src_addr_size;
+    }
+#endif
+
 #ifdef CONFIG_UDP_READAHEAD_NOTIFIER
   /* Provided notification(s) that additional UDP read-ahead data is
    * available.
@@ -332,4 +413,26 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_share
+ *
+ * Description:
+ *   Begin (share == true) or end (share == false) the delivery of one
+ *   received packet to several connections.  In between, the read-ahead
+ *   I/O buffer chain built for the first connection is shared with the
+ *   others rather than copying the packet again for each of them.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef UDP_SHARED_READAHEAD
+void udp_readahead_share(bool share)
+{
+  g_udp_share.us_share = share;
+  g_udp_share.us_iob   = NULL;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -54,6 +54,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -73,6 +74,11 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Map a local port number (in network order) to its hash bucket */
+
+#define UDP_PORTHASH(p) \
+  (&g_udp_porthash[(uint16_t)((p) ^ ((p) >> 8)) % CONFIG_NET_UDP_HASHSIZE])
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,6 +96,12 @@ static sem_t g_free_sem;
 
 static dq_queue_t g_active_udp_connections;
 
+/* The allocated UDP connections that are bound to a local port are also
+ * kept in a hash table indexed by the local port number.
+ */
+
+static dq_queue_t g_udp_porthash[CONFIG_NET_UDP_HASHSIZE];
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -126,11 +138,40 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) nxsem_post(sem)
 
+/****************************************************************************
+ * Name: udp_setlport()
+ *
+ * Description:
+ *   Change the local port number of a connection, moving the connection
+ *   to the hash bucket for the new port.  A port number of zero unbinds
+ *   the connection and removes it from the hash table.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+  net_lock();
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, UDP_PORTHASH(conn->lport));
+    }
+
+  conn->lport = lport;
+  if (lport != 0)
+    {
+      dq_addlast(&conn->hnode, UDP_PORTHASH(lport));
+    }
+
+  net_unlock();
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Find the UDP connection that uses this local port number.  If
+ *   reuseport is true, connections that were also bound with SO_REUSEPORT
+ *   do not conflict and are ignored.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -139,16 +180,25 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuseport)
 {
   FAR struct udp_conn_s *conn;
-  int i;
+  FAR dq_entry_t *entry;
 
-  /* Now search each connection structure. */
+  /* Only the connections in the hash bucket for this port need be
+   * searched.
+   */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+  for (entry = dq_peek(UDP_PORTHASH(portno));
+       entry != NULL;
+       entry = dq_next(entry))
     {
-      conn = &g_udp_connections[i];
+      conn = container_of(entry, struct udp_conn_s, hnode);
+
+      if (reuseport && _UDP_ISREUSEPORT(conn->flags))
+        {
+          continue;
+        }
 
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -232,7 +282,7 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
           g_last_udp_port = 4096;
         }
     }
-  while (udp_find_conn(domain, u, htons(g_last_udp_port)) != NULL);
+  while (udp_find_conn(domain, u, htons(g_last_udp_port), false) != NULL);
 
   /* Initialize and return the connection structure, bind it to the
    * port number
@@ -249,7 +299,8 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
  *
  * Description:
  *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   used within the provided UDP header.  The search begins after prev or,
+ *   if prev is NULL, at the beginning of the hash bucket.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -258,17 +309,25 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
 
 #ifdef CONFIG_NET_IPv4
 static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp,
+                  FAR struct udp_conn_s *prev)
 {
 #ifdef CONFIG_NET_BROADCAST
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
+  FAR dq_entry_t *entry;
+
+  /* Only connections bound to the destination port need be examined */
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
+  for (entry = prev != NULL ? dq_next(&prev->hnode) :
+                              dq_peek(UDP_PORTHASH(udp->destport));
+       entry != NULL;
+       entry = dq_next(entry))
     {
+      conn = container_of(entry, struct udp_conn_s, hnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -376,13 +435,11 @@ static inline FAR struct udp_conn_s *
               break;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
     }
 
-  return conn;
+  /* If the bucket was exhausted, there is no matching connection */
+
+  return entry != NULL ? conn : NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -391,7 +448,8 @@ static inline FAR struct udp_conn_s *
  *
  * Description:
  *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   used within the provided UDP header.  The search begins after prev or,
+ *   if prev is NULL, at the beginning of the hash bucket.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -400,14 +458,22 @@ static inline FAR struct udp_conn_s *
 
 #ifdef CONFIG_NET_IPv6
 static inline FAR struct udp_conn_s *
-  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp,
+                  FAR struct udp_conn_s *prev)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
+  FAR dq_entry_t *entry;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn != NULL)
+  /* Only connections bound to the destination port need be examined */
+
+  for (entry = prev != NULL ? dq_next(&prev->hnode) :
+                              dq_peek(UDP_PORTHASH(udp->destport));
+       entry != NULL;
+       entry = dq_next(entry))
     {
+      conn = container_of(entry, struct udp_conn_s, hnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -514,16 +580,140 @@ static inline FAR struct udp_conn_s *
               break;
             }
         }
+    }
+
+  /* If the bucket was exhausted, there is no matching connection */
+
+  return entry != NULL ? conn : NULL;
+}
+#endif /* CONFIG_NET_IPv6 */
 
-      /* Look at the next active connection */
+/****************************************************************************
+ * Name: udp_reuseport_match
+ *
+ * Description:
+ *   Return true if two unconnected connections were bound with
+ *   SO_REUSEPORT to the same local address and port.
+ *
+ ****************************************************************************/
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+#ifdef CONFIG_NET_SOREUSEPORT
+static bool udp_reuseport_match(FAR struct udp_conn_s *conn,
+                                FAR struct udp_conn_s *other)
+{
+  if (!_UDP_ISREUSEPORT(other->flags) ||
+      _UDP_ISCONNECTMODE(other->flags) ||
+      other->domain != conn->domain || other->lport != conn->lport)
+    {
+      return false;
     }
 
-  return conn;
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(other->u.ipv4.laddr, conn->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(other->u.ipv6.laddr, conn->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
 }
+#endif
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   The connection conn was matched first for the received packet and it
+ *   was bound with SO_REUSEPORT.  Select one of the connections sharing
+ *   its address and port by a hash of the source address and port of the
+ *   packet so that all packets from one peer go to the same socket.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOREUSEPORT
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct net_driver_s *dev,
+                       FAR struct udp_hdr_s *udp,
+                       FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s *other;
+  FAR dq_entry_t *entry;
+  FAR uint16_t *srcipaddr;
+  uint32_t hash;
+  int nwords;
+  int nconns;
+  int i;
+
+  /* Hash the source address and port of the packet */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      srcipaddr = IPv6BUF->srcipaddr;
+      nwords    = 8;
+    }
 #endif /* CONFIG_NET_IPv6 */
 
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      srcipaddr = IPv4BUF->srcipaddr;
+      nwords    = 2;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  hash = udp->srcport;
+  for (i = 0; i < nwords; i++)
+    {
+      hash = (hash ^ srcipaddr[i]) * 2654435761u;
+    }
+
+  hash ^= hash >> 16;
+
+  /* The first match is the earliest in the hash bucket, so all of the
+   * connections sharing its port follow it.  Count them, then pick one.
+   */
+
+  nconns = 0;
+  for (entry = &conn->hnode; entry != NULL; entry = dq_next(entry))
+    {
+      other = container_of(entry, struct udp_conn_s, hnode);
+      if (udp_reuseport_match(conn, other))
+        {
+          nconns++;
+        }
+    }
+
+  nconns = hash % nconns;
+  for (entry = &conn->hnode; entry != NULL; entry = dq_next(entry))
+    {
+      other = container_of(entry, struct udp_conn_s, hnode);
+      if (udp_reuseport_match(conn, other) && nconns-- == 0)
+        {
+          return other;
+        }
+    }
+
+  return conn;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -547,6 +737,11 @@ void udp_initialize(void)
   dq_init(&g_active_udp_connections);
   nxsem_init(&g_free_sem, 0, 1);
 
+  for (i = 0; i < CONFIG_NET_UDP_HASHSIZE; i++)
+    {
+      dq_init(&g_udp_porthash[i]);
+    }
+
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       /* Mark the connection closed and move it to the free list */
@@ -622,8 +817,13 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  /* Unbind the local port, removing the connection from the hash table.
+   * This is done before taking the free list semaphore to preserve the
+   * ordering of the network lock and that semaphore.
+   */
+
+  udp_setlport(conn, 0);
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
@@ -665,12 +865,14 @@ void udp_free(FAR struct udp_conn_s *conn)
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp)
 {
+  FAR struct udp_conn_s *conn;
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return udp_ipv6_active(dev, udp);
+      conn = udp_ipv6_active(dev, udp, NULL);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -679,9 +881,62 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return udp_ipv4_active(dev, udp);
+      conn = udp_ipv4_active(dev, udp, NULL);
     }
 #endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_SOREUSEPORT
+  /* If the port is shared by several sockets, distribute the packets
+   * among them.
+   */
+
+  if (conn != NULL && _UDP_ISREUSEPORT(conn->flags) &&
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      conn = udp_reuseport_select(dev, udp, conn);
+    }
+#endif
+
+  return conn;
+}
+
+/****************************************************************************
+ * Name: udp_nextactive
+ *
+ * Description:
+ *   Find the next connection after conn that should also receive the
+ *   multicast or broadcast UDP packet in the provided UDP header.  If conn
+ *   is NULL, the first such connection is returned.  Every connection
+ *   bound with SO_REUSEPORT receives a copy of such a packet.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct udp_conn_s *udp_nextactive(FAR struct net_driver_s *dev,
+                                      FAR struct udp_hdr_s *udp,
+                                      FAR struct udp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      conn = udp_ipv6_active(dev, udp, conn);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      conn = udp_ipv4_active(dev, udp, conn);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return conn;
 }
 
 /****************************************************************************
@@ -772,8 +1027,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
-      ret         = OK;
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      ret = OK;
     }
   else
     {
@@ -783,11 +1038,12 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
       /* Is any other UDP connection already bound to this address and port? */
 
-      if (udp_find_conn(conn->domain, &conn->u, portno) == NULL)
+      if (udp_find_conn(conn->domain, &conn->u, portno,
+                        _UDP_ISREUSEPORT(conn->flags)) == NULL)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -840,7 +1096,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -45,8 +45,11 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
+#include <stdbool.h>
 #include <debug.h>
 
+#include <netinet/in.h>
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/udp.h>
@@ -56,10 +59,121 @@
 #include "utils/utils.h"
 #include "udp/udp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_ismultidest
+ *
+ * Description:
+ *   Return true if the received packet is addressed to a multicast or
+ *   broadcast address and so may be received by several sockets.
+ *
+ ****************************************************************************/
+
+static bool udp_ismultidest(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      return net_is_addr_mcast(IPv6BUF->destipaddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      in_addr_t destipaddr = net_ip4addr_conv32(IPv4BUF->destipaddr);
+
+      return IN_MULTICAST(NTOHL(destipaddr)) ||
+             net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST) ||
+             net_ipv4addr_cmp(destipaddr,
+                              (dev->d_ipaddr | ~dev->d_netmask));
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: udp_deliver
+ *
+ * Description:
+ *   Deliver the received UDP packet to one connection.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet
+ *   conn   - The receiving UDP connection
+ *   hdrlen - Length of the link layer, IP, and UDP headers
+ *
+ * Returned Value:
+ *   OK    - The packet has been processed
+ *   ERROR - The packet was not processed and should be held
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int udp_deliver(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn, unsigned int hdrlen)
+{
+  uint16_t flags;
+  int ret = OK;
+
+  /* Set-up for the application callback */
+
+  dev->d_appdata = &dev->d_buf[hdrlen];
+  dev->d_sndlen  = 0;
+
+  /* Perform the application callback */
+
+  flags = udp_callback(dev, conn, UDP_NEWDATA);
+
+  /* If the operation was successful and the UDP data was "consumed,"
+   * then the UDP_NEWDATA flag will be cleared by logic in
+   * udp_callback().  The packet memory can then be freed by the
+   * network driver.  OK will be returned to the network driver to
+   * indicate this case.
+   *
+   * "Consumed" here means that either the received data was (1)
+   * accepted by a socket waiting for data on the port or was (2)
+   * buffered in the UDP socket's read-ahead buffer.
+   */
+
+  if ((flags & UDP_NEWDATA) != 0)
+    {
+      /* No.. the packet was not processed now.  Return ERROR so
+       * that the driver may retry again later.  We still need to
+       * set d_len to zero so that the driver is aware that there
+       * is nothing to be sent.
+       */
+
+      nwarn("WARNING: Packet not processed\n");
+      dev->d_len = 0;
+      ret = ERROR;
+    }
+
+  /* If the application has data to send, setup the UDP/IP header */
+
+  if (dev->d_sndlen > 0)
+    {
+      udp_send(dev, conn);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: udp_input
  *
@@ -124,7 +238,13 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (NETDEV_RXCHKSUM(dev, NETDEV_CHKSUM_UDP))
+    {
+      /* The checksum has already been verified by the hardware */
+
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -157,72 +277,66 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   else
 #endif
     {
-      /* Demultiplex this UDP packet between the UDP "connections".
-       *
-       * REVISIT:  The logic here expects either a single receive socket or
-       * none at all.  However, multiple sockets should be capable of
-       * receiving a UDP datagram (multicast reception).  This could be
-       * handled easily by something like:
-       *
-       *   for (conn = NULL; conn = udp_active(dev, udp); )
-       *
-       * If the callback logic that receives a packet responds with an
-       * outgoing packet, then it will over-write the received buffer,
-       * however.  recvfrom() will not do that, however.  We would have to
-       * make that the rule: Recipients of a UDP packet must treat the
-       * packet as read-only.
+      /* Demultiplex this UDP packet between the UDP "connections".  A
+       * unicast packet goes to a single socket.  A multicast or broadcast
+       * packet goes to every socket that would accept it.
        */
 
-      conn = udp_active(dev, udp);
-      if (conn)
+      if (!udp_ismultidest(dev))
         {
-          uint16_t flags;
-
-          /* Set-up for the application callback */
-
-          dev->d_appdata = &dev->d_buf[hdrlen];
-          dev->d_sndlen  = 0;
-
-          /* Perform the application callback */
-
-          flags = udp_callback(dev, conn, UDP_NEWDATA);
-
-          /* If the operation was successful and the UDP data was "consumed,"
-           * then the UDP_NEWDATA flag will be cleared by logic in
-           * udp_callback().  The packet memory can then be freed by the
-           * network driver.  OK will be returned to the network driver to
-           * indicate this case.
-           *
-           * "Consumed" here means that either the received data was (1)
-           * accepted by a socket waiting for data on the port or was (2)
-           * buffered in the UDP socket's read-ahead buffer.
+          conn = udp_active(dev, udp);
+          if (conn != NULL)
+            {
+              ret = udp_deliver(dev, conn, hdrlen);
+            }
+          else
+            {
+              nwarn("WARNING: No listener on UDP port\n");
+              dev->d_len = 0;
+            }
+        }
+      else
+        {
+          FAR struct udp_conn_s *next;
+          uint16_t datalen = dev->d_len;
+
+          /* Recipients of such a packet must treat it as read-only.  Each
+           * callback consumes d_len, so restore it for every recipient.
+           * The read-ahead I/O buffer chain built for the first recipient
+           * is shared with the rest.  The packet cannot be held for a
+           * later retry once some of the sockets have received it.
            */
 
-          if ((flags & UDP_NEWDATA) != 0)
+          conn = udp_nextactive(dev, udp, NULL);
+          if (conn == NULL)
+            {
+              nwarn("WARNING: No listener on UDP port\n");
+            }
+
+          dev->d_sndlen = 0;
+          udp_readahead_share(true);
+          for (; conn != NULL; conn = next)
             {
-              /* No.. the packet was not processed now.  Return ERROR so
-               * that the driver may retry again later.  We still need to
-               * set d_len to zero so that the driver is aware that there
-               * is nothing to be sent.
-               */
+              next       = udp_nextactive(dev, udp, conn);
+              dev->d_len = datalen;
 
-              nwarn("WARNING: Packet not processed\n");
-              dev->d_len = 0;
-              ret = ERROR;
+              (void)udp_deliver(dev, conn, hdrlen);
+              if (dev->d_sndlen > 0)
+                {
+                  /* A reply has over-written the received packet */
+
+                  nwarn("WARNING: Multicast delivery truncated\n");
+                  break;
+                }
             }
 
-          /* If the application has data to send, setup the UDP/IP header */
+          udp_readahead_share(false);
 
-          if (dev->d_sndlen > 0)
+          if (dev->d_sndlen == 0)
             {
-              udp_send(dev, conn);
+              dev->d_len = 0;
             }
         }
-      else
-        {
-          nwarn("WARNING: No listener on UDP port\n");
-          dev->d_len = 0;
-        }
     }
 
   return ret;
@@ -254,13 +368,20 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 #ifdef CONFIG_NET_IPv4
 int udp_ipv4_input(FAR struct net_driver_s *dev)
 {
+  int ret;
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+
   /* Configure to receive an UDP IPv4 packet */
 
   udp_ipv4_select(dev);
 
   /* Then process in the UDP IPv4 input */
 
-  return udp_input(dev, IPv4_HDRLEN);
+  ret = udp_input(dev, IPv4_HDRLEN);
+  NETPERF_UPDATE(NETPERF_UDP_INPUT, start);
+  return ret;
 }
 #endif
 
@@ -289,13 +410,20 @@ int udp_ipv4_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_IPv6
 int udp_ipv6_input(FAR struct net_driver_s *dev, unsigned int iplen)
 {
+  int ret;
+  NETPERF_DECLARE(start);
+
+  NETPERF_START(start);
+
   /* Configure to receive an UDP IPv6 packet */
 
   udp_ipv6_select(dev);
 
   /* Then process in the UDP IPv6 input */
 
-  return udp_input(dev, iplen);
+  ret = udp_input(dev, iplen);
+  NETPERF_UPDATE(NETPERF_UDP_INPUT, start);
+  return ret;
 }
 #endif
 
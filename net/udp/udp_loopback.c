@@ -0,0 +1,337 @@
+/****************************************************************************
+ * net/udp/udp_loopback.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/loopback.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDP_LOOPBACK_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF    ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF    ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+#define UDPIPv4BUF \
+  ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
+#define UDPIPv6BUF \
+  ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_loopback_waiting
+ *
+ * Description:
+ *   Return true if some thread is waiting for new data on the connection.
+ *   Such waiters are woken by a UDP_NEWDATA event and take the data from
+ *   the device buffer; they never look at the read-ahead queue.
+ *
+ ****************************************************************************/
+
+static bool udp_loopback_waiting(FAR struct udp_conn_s *conn)
+{
+  FAR struct devif_callback_s *cb;
+
+  for (cb = conn->list; cb != NULL; cb = cb->nxtconn)
+    {
+      if ((cb->flags & UDP_NEWDATA) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_loopback_send
+ *
+ * Description:
+ *   Deliver a buffered datagram addressed to the local loopback device
+ *   by moving its I/O buffer chain directly into the read-ahead queue of
+ *   the receiving connection.
+ *
+ *   Only the IP and UDP headers are built (in the loopback device buffer)
+ *   so that the receiving connection is selected by udp_active() just as
+ *   it would be for a looped back packet.  The payload is never copied.
+ *
+ * Input Parameters:
+ *   conn - The sending UDP connection
+ *   wrb  - The write buffer holding the datagram.  On success, wb_iob is
+ *          set to NULL; the write buffer itself is still owned by the
+ *          caller.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the datagram was delivered.  A negated errno
+ *   value is returned if the datagram must take the normal path through
+ *   the loopback device instead.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+int udp_loopback_send(FAR struct udp_conn_s *conn,
+                      FAR struct udp_wrbuffer_s *wrb)
+{
+  FAR struct net_driver_s *dev;
+  FAR struct udp_conn_s *rconn;
+  FAR struct udp_hdr_s *udp;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *last;
+#ifdef CONFIG_NET_IPv6
+  struct sockaddr_in6 src_addr6;
+#endif
+#ifdef CONFIG_NET_IPv4
+  struct sockaddr_in src_addr4;
+#endif
+  FAR void *src_addr;
+  uint8_t src_addr_size;
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  struct timespec tstamp;
+#endif
+  int ret;
+
+  /* Datagrams already waiting in the write buffer queue must be sent
+   * first.  A connection with no local port yet will be bound when the
+   * datagram is sent normally.
+   */
+
+  if (!sq_empty(&conn->write_q) || conn->lport == 0)
+    {
+      return -EBUSY;
+    }
+
+  dev = netdev_findbyname("lo");
+  if (dev == NULL || !IFF_IS_UP(dev->d_flags))
+    {
+      return -ENETUNREACH;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      FAR struct sockaddr_in *dest = (FAR struct sockaddr_in *)&wrb->wb_dest;
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      in_addr_t srcipaddr;
+
+      /* Only unicast datagrams to the loopback network are handled */
+
+      if (dest->sin_family != AF_INET ||
+          !net_ipv4addr_maskcmp(dest->sin_addr.s_addr, dev->d_ipaddr,
+                                dev->d_netmask) ||
+          net_ipv4addr_cmp(dest->sin_addr.s_addr,
+                           (dev->d_ipaddr | ~dev->d_netmask)))
+        {
+          return -ENETUNREACH;
+        }
+
+      srcipaddr = conn->u.ipv4.laddr;
+      if (net_ipv4addr_cmp(srcipaddr, INADDR_ANY))
+        {
+          srcipaddr = dev->d_ipaddr;
+        }
+
+      IFF_SET_IPv4(dev->d_flags);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &srcipaddr);
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, &dest->sin_addr.s_addr);
+
+      udp                   = UDPIPv4BUF;
+      udp->destport         = dest->sin_port;
+
+      src_addr4.sin_family  = AF_INET;
+      src_addr4.sin_port    = conn->lport;
+      net_ipv4addr_copy(src_addr4.sin_addr.s_addr, srcipaddr);
+
+      src_addr_size         = sizeof(src_addr4);
+      src_addr              = &src_addr4;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      FAR struct sockaddr_in6 *dest =
+        (FAR struct sockaddr_in6 *)&wrb->wb_dest;
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      FAR const uint16_t *srcipaddr;
+
+      if (dest->sin6_family != AF_INET6 ||
+          !net_ipv6addr_cmp(dest->sin6_addr.s6_addr16, g_lo_ipv6addr))
+        {
+          return -ENETUNREACH;
+        }
+
+      srcipaddr = conn->u.ipv6.laddr;
+      if (net_ipv6addr_cmp(srcipaddr, g_ipv6_unspecaddr))
+        {
+          srcipaddr = dev->d_ipv6addr;
+        }
+
+      IFF_SET_IPv6(dev->d_flags);
+      net_ipv6addr_hdrcopy(ipv6->srcipaddr, srcipaddr);
+      net_ipv6addr_hdrcopy(ipv6->destipaddr, dest->sin6_addr.s6_addr16);
+
+      udp                   = UDPIPv6BUF;
+      udp->destport         = dest->sin6_port;
+
+      memset(&src_addr6, 0, sizeof(src_addr6));
+      src_addr6.sin6_family = AF_INET6;
+      src_addr6.sin6_port   = conn->lport;
+      net_ipv6addr_copy(src_addr6.sin6_addr.s6_addr16, srcipaddr);
+
+      src_addr_size         = sizeof(src_addr6);
+      src_addr              = &src_addr6;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  udp->srcport = conn->lport;
+
+  /* Find the receiving connection.  A thread that is already waiting in
+   * recvfrom() can only be woken through the loopback device.
+   */
+
+  rconn = udp_active(dev, udp);
+  if (rconn == NULL || rconn->domain != conn->domain ||
+      udp_loopback_waiting(rconn))
+    {
+      return -EBUSY;
+    }
+
+  /* Build the read-ahead header in its own I/O buffer chain.  This is
+   * normally a single I/O buffer.
+   */
+
+  iob = iob_tryalloc_user(true, IOBUSER_NET_UDP);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&src_addr_size,
+                      sizeof(uint8_t), 0, true);
+  if (ret >= 0)
+    {
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)src_addr,
+                          src_addr_size, sizeof(uint8_t), true);
+    }
+
+#ifdef CONFIG_NET_UDP_TIMESTAMP
+  if (ret >= 0)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &tstamp);
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)&tstamp,
+                          sizeof(tstamp), src_addr_size + sizeof(uint8_t),
+                          true);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      (void)iob_free_chain(iob);
+      return ret;
+    }
+
+  /* Then append the payload and queue the whole chain */
+
+  for (last = iob; last->io_flink != NULL; last = last->io_flink)
+    {
+    }
+
+  iob_concat(iob, wrb->wb_iob);
+
+  ret = iob_tryadd_queue(iob, &rconn->readahead);
+  if (ret < 0)
+    {
+      /* Give the payload back to the write buffer */
+
+      last->io_flink = NULL;
+      (void)iob_free_chain(iob);
+      return ret;
+    }
+
+  wrb->wb_iob = NULL;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.udp.sent++;
+  g_netstats.udp.recv++;
+#endif
+
+#ifdef CONFIG_UDP_READAHEAD_NOTIFIER
+  udp_notifier_signal(rconn);
+#endif
+
+  ninfo("Handed over %u bytes\n",
+        iob->io_pktlen - UDP_READAHEAD_HDRLEN(src_addr_size));
+  return OK;
+}
+
+#endif /* CONFIG_NET_UDP_LOOPBACK_ZEROCOPY */
@@ -46,6 +46,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 
@@ -143,7 +144,7 @@ static uint16_t udp_poll_eventhandler(FAR struct net_driver_s *dev,
       if (eventset)
         {
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -199,7 +200,7 @@ static inline void udp_iob_work(FAR void *arg)
           /* Yes.. then signal the poll logic */
 
           fds->revents |= POLLWRNORM;
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
       else
         {
@@ -391,7 +392,7 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 #if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && defined(CONFIG_IOB_NOTIFIER)
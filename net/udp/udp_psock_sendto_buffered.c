@@ -615,10 +615,49 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendmsg(psock, &iov, 1, flags, to, tolen);
+}
+
+/****************************************************************************
+ * Name: psock_udp_sendmsg
+ *
+ * Description:
+ *   Send one datagram gathered from a list of buffers.  The buffers are
+ *   copied directly into the I/O buffer chain of a UDP write buffer, so no
+ *   intermediate copy is made.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iov      The list of buffers holding the data to send
+ *   iovcnt   The number of buffers in the list
+ *   flags    Send flags
+ *   to       Address of recipient (NULL for a connected socket)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+  unsigned int offset;
+  size_t len;
   int ret = OK;
+  int i;
 
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
@@ -741,9 +780,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Dump the incoming buffers and get the total size of the datagram */
 
-  BUF_DUMP("psock_udp_send", buf, len);
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_udp_send", iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
 
   /* Set the socket state to sending */
 
@@ -813,28 +856,56 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       wrb->wb_start = clock_systimer();
 #endif
 
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
+      /* Copy the user data into the write buffer, one buffer after
+       * another.  We cannot wait for buffer space if the socket was opened
+       * non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
+      for (i = 0, offset = 0; i < iovcnt; i++)
         {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-      else
-        {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
 
-      if (ret < 0)
-        {
-          goto errout_with_wrb;
+          if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+            {
+              ret = iob_trycopyin(wrb->wb_iob,
+                                  (FAR const uint8_t *)iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+            }
+          else
+            {
+              ret = iob_copyin(wrb->wb_iob,
+                               (FAR const uint8_t *)iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_wrb;
+            }
+
+          offset += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
 
       UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
 
+#ifdef CONFIG_NET_UDP_LOOPBACK_ZEROCOPY
+      /* A datagram for a local socket may be handed over directly */
+
+      if (udp_loopback_send(conn, wrb) >= 0)
+        {
+          udp_wrbuffer_release(wrb);
+          net_unlock();
+
+          psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+          return len;
+        }
+#endif
+
       /* sendto_eventhandler() will send data in FIFO order from the
        * conn->write_q.
        *
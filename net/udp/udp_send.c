@@ -163,7 +163,10 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           /* Calculate IP checksum. */
 
           ipv4->ipchksum    = 0;
-          ipv4->ipchksum    = ~ipv4_chksum(dev);
+          if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_IPv4))
+            {
+              ipv4->ipchksum = ~ipv4_chksum(dev);
+            }
 
 #ifdef CONFIG_NET_STATISTICS
           g_netstats.ipv4.sent++;
@@ -225,31 +228,34 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       udp->udpchksum   = 0;
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum (unless the hardware will insert it) */
 
+      if (!NETDEV_TXCHKSUM(dev, NETDEV_CHKSUM_UDP))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (conn->domain == PF_INET ||
-          (conn->domain == PF_INET6 &&
-           ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
+          if (conn->domain == PF_INET ||
+              (conn->domain == PF_INET6 &&
+               ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
@@ -157,7 +157,7 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void)
 
   /* Now get the first I/O buffer for the write buffer structure */
 
-  wrb->wb_iob = net_ioballoc(false);
+  wrb->wb_iob = net_ioballoc(false, IOBUSER_NET_UDP);
   if (!wrb->wb_iob)
     {
       nerr("ERROR: Failed to allocate I/O buffer\n");
@@ -183,13 +183,17 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void)
 
 void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb)
 {
-  DEBUGASSERT(wrb && wrb->wb_iob);
+  DEBUGASSERT(wrb);
 
   /* To avoid deadlocks, we must following this ordering:  Release the I/O
-   * buffer chain first, then the write buffer structure.
+   * buffer chain first, then the write buffer structure.  There is no I/O
+   * buffer chain if it was handed over by udp_loopback_send().
    */
 
-  iob_free_chain(wrb->wb_iob);
+  if (wrb->wb_iob != NULL)
+    {
+      iob_free_chain(wrb->wb_iob);
+    }
 
   /* Then free the write buffer structure */
 
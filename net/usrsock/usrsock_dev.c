@@ -354,7 +354,7 @@ static void usrsockdev_pollnotify(FAR struct usrsockdev_s *dev, pollevent_t even
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -857,69 +857,92 @@ static ssize_t usrsockdev_write(FAR struct file *filep, FAR const char *buffer,
 
   usrsockdev_semtake(&dev->devsem);
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header. */
+  /* The daemon may write any number of messages (responses, events and
+   * the data that follows a data request response) with a single write().
+   * Handle them in order until the buffer is consumed.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
 
-      /* Handle message. */
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret <= 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
           ret = origlen - len;
         }
-    }
+      else
+        {
+          /* Data input handling. */
 
-  /* Data input handling. */
+          conn = dev->datain_conn;
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+          /* Copy data from user-space. */
 
-      /* Copy data from user-space. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer, len);
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+              ret = origlen - len;
+            }
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
-        }
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              dev->datain_conn = NULL;
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          dev->datain_conn = NULL;
+              /* Done with data response. */
 
-          /* Done with data response. */
+              (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+            }
 
-          (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+          if (ret < 0)
+            {
+              break;
+            }
         }
     }
 
-errout:
+  /* Report the messages that were handled before any bad one.  The bad
+   * message is then reported when the daemon writes it again.
+   */
+
+  if (ret < 0 && len < origlen)
+    {
+      ret = origlen - len;
+    }
+
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
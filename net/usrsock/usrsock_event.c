@@ -79,6 +79,20 @@ int usrsock_event(FAR struct usrsock_conn_s *conn, uint16_t events)
 
   net_lock();
 
+  /* The daemon typically reports 'sendto ready' and 'data available' for
+   * every packet that it handles.  If the connection already has those
+   * flags set, then nobody can be waiting for them:  Drop the repeated
+   * events instead of waking all of the callbacks again.
+   */
+
+  if ((events & ~(USRSOCK_EVENT_SENDTO_READY |
+                  USRSOCK_EVENT_RECVFROM_AVAIL)) == 0 &&
+      (conn->flags & events) == events)
+    {
+      net_unlock();
+      return OK;
+    }
+
   /* Generic state updates. */
 
   if (events & USRSOCK_EVENT_REQ_COMPLETE)
@@ -52,6 +52,7 @@
 
 #include <sys/socket.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 #include <nuttx/kmalloc.h>
@@ -144,7 +145,7 @@ static uint16_t poll_event(FAR struct net_driver_s *dev, FAR void *pvconn,
   if (eventset)
     {
       info->fds->revents |= eventset;
-      nxsem_post(info->fds->sem);
+      poll_notify(info->fds);
     }
 
   return flags;
@@ -289,7 +290,7 @@ static int usrsock_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      nxsem_post(fds->sem);
+      poll_notify(fds);
     }
 
 errout_unlock:
@@ -0,0 +1,457 @@
+/****************************************************************************
+ * net/utils/net_agecache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "utils/utils.h"
+
+#ifdef HAVE_NET_AGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initial number of hash buckets.  The number of buckets is doubled
+ * whenever there are more than two entries per bucket on average.
+ */
+
+#define AGECACHE_MINBUCKETS 8
+
+/* The key of an entry */
+
+#define AGECACHE_KEY(c,e)   ((FAR uint8_t *)(e) + (c)->ac_keyoff)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: agecache_hash
+ *
+ * Description:
+ *   FNV-1a hash of a key.
+ *
+ ****************************************************************************/
+
+static unsigned int agecache_hash(FAR struct net_agecache_s *cache,
+                                  FAR const uint8_t *key)
+{
+  uint32_t hash = 2166136261u;
+  unsigned int i;
+
+  for (i = 0; i < cache->ac_keylen; i++)
+    {
+      hash = (hash ^ key[i]) * 16777619u;
+    }
+
+  return (unsigned int)(hash ^ (hash >> 16)) & (cache->ac_nbuckets - 1);
+}
+
+/****************************************************************************
+ * Name: agecache_unlink
+ *
+ * Description:
+ *   Remove an entry from its hash chain and its timer wheel slot without
+ *   freeing it.
+ *
+ ****************************************************************************/
+
+static void agecache_unlink(FAR struct net_agecache_s *cache,
+                            FAR struct net_agecache_entry_s *entry)
+{
+  FAR struct net_agecache_entry_s **pnext;
+
+  pnext = &cache->ac_hash[agecache_hash(cache, AGECACHE_KEY(cache, entry))];
+  while (*pnext != entry)
+    {
+      DEBUGASSERT(*pnext != NULL);
+      pnext = &(*pnext)->ae_hnext;
+    }
+
+  *pnext = entry->ae_hnext;
+  dq_rem(&entry->ae_wlink, &cache->ac_wheel[entry->ae_slot]);
+  cache->ac_nentries--;
+}
+
+/****************************************************************************
+ * Name: agecache_expire
+ *
+ * Description:
+ *   Free every entry in one timer wheel slot.
+ *
+ ****************************************************************************/
+
+static void agecache_expire(FAR struct net_agecache_s *cache, int slot)
+{
+  FAR struct net_agecache_entry_s *entry;
+
+  while ((entry = (FAR struct net_agecache_entry_s *)
+                  dq_peek(&cache->ac_wheel[slot])) != NULL)
+    {
+      agecache_unlink(cache, entry);
+      kmm_free(entry);
+    }
+}
+
+/****************************************************************************
+ * Name: agecache_advance
+ *
+ * Description:
+ *   Advance the timer wheel to the current time, freeing all entries in
+ *   the slots that are passed.  Each slot covers 1/16 of the maximum age
+ *   and there is one more slot than that so that the entries in the slot
+ *   that is re-used are all older than the maximum age.
+ *
+ ****************************************************************************/
+
+static clock_t agecache_advance(FAR struct net_agecache_s *cache)
+{
+  clock_t interval;
+  clock_t now;
+  int i;
+
+  now      = clock_systimer();
+  interval = (cache->ac_maxage + NET_AGECACHE_NSLOTS - 2) /
+             (NET_AGECACHE_NSLOTS - 1);
+  if (interval == 0)
+    {
+      interval = 1;
+    }
+
+  if (now - cache->ac_base >= interval * NET_AGECACHE_NSLOTS)
+    {
+      /* The whole wheel has been passed (or this is the first access) */
+
+      for (i = 0; i < NET_AGECACHE_NSLOTS; i++)
+        {
+          agecache_expire(cache, i);
+        }
+
+      cache->ac_base = now;
+    }
+  else
+    {
+      while (now - cache->ac_base >= interval)
+        {
+          cache->ac_base += interval;
+          if (++cache->ac_cur >= NET_AGECACHE_NSLOTS)
+            {
+              cache->ac_cur = 0;
+            }
+
+          agecache_expire(cache, cache->ac_cur);
+        }
+    }
+
+  return now;
+}
+
+/****************************************************************************
+ * Name: agecache_grow
+ *
+ * Description:
+ *   Double the number of hash buckets (or allocate the initial buckets).
+ *   Failure to grow is not fatal if there are buckets already.
+ *
+ ****************************************************************************/
+
+static void agecache_grow(FAR struct net_agecache_s *cache)
+{
+  FAR struct net_agecache_entry_s **oldhash;
+  FAR struct net_agecache_entry_s *entry;
+  unsigned int oldsize;
+  unsigned int newsize;
+  unsigned int ndx;
+  unsigned int i;
+
+  oldhash = cache->ac_hash;
+  oldsize = cache->ac_nbuckets;
+  newsize = oldsize == 0 ? AGECACHE_MINBUCKETS : oldsize << 1;
+
+  cache->ac_hash = (FAR struct net_agecache_entry_s **)
+    kmm_zalloc(newsize * sizeof(FAR struct net_agecache_entry_s *));
+  if (cache->ac_hash == NULL)
+    {
+      cache->ac_hash = oldhash;
+      return;
+    }
+
+  cache->ac_nbuckets = newsize;
+
+  /* Re-hash all of the entries into the new buckets */
+
+  for (i = 0; i < oldsize; i++)
+    {
+      while ((entry = oldhash[i]) != NULL)
+        {
+          oldhash[i] = entry->ae_hnext;
+
+          ndx = agecache_hash(cache, AGECACHE_KEY(cache, entry));
+          entry->ae_hnext = cache->ac_hash[ndx];
+          cache->ac_hash[ndx] = entry;
+        }
+    }
+
+  if (oldhash != NULL)
+    {
+      kmm_free(oldhash);
+    }
+}
+
+/****************************************************************************
+ * Name: agecache_oldest
+ *
+ * Description:
+ *   Return the least recently updated entry.  This is found at the head
+ *   of the first non-empty slot following the current slot.
+ *
+ ****************************************************************************/
+
+static FAR struct net_agecache_entry_s *
+agecache_oldest(FAR struct net_agecache_s *cache)
+{
+  FAR dq_entry_t *link;
+  int slot = cache->ac_cur;
+  int i;
+
+  for (i = 0; i < NET_AGECACHE_NSLOTS; i++)
+    {
+      if (++slot >= NET_AGECACHE_NSLOTS)
+        {
+          slot = 0;
+        }
+
+      link = dq_peek(&cache->ac_wheel[slot]);
+      if (link != NULL)
+        {
+          return (FAR struct net_agecache_entry_s *)link;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_agecache_find
+ *
+ * Description:
+ *   Find the entry with the given key in an aging cache.  Expired entries
+ *   are removed from the cache and are never returned.
+ *
+ * Input Parameters:
+ *   cache - The aging cache
+ *   key   - The key to look up (ac_keylen bytes)
+ *
+ * Returned Value:
+ *   The matching entry or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_agecache_entry_s *
+net_agecache_find(FAR struct net_agecache_s *cache, FAR const void *key)
+{
+  FAR struct net_agecache_entry_s *entry;
+  clock_t now;
+
+  now = agecache_advance(cache);
+  if (cache->ac_nbuckets == 0)
+    {
+      return NULL;
+    }
+
+  for (entry = cache->ac_hash[agecache_hash(cache, key)];
+       entry != NULL;
+       entry = entry->ae_hnext)
+    {
+      if (memcmp(AGECACHE_KEY(cache, entry), key, cache->ac_keylen) == 0)
+        {
+          /* The timer wheel only has a resolution of one slot */
+
+          if (now - entry->ae_time > cache->ac_maxage)
+            {
+              net_agecache_remove(cache, entry);
+              return NULL;
+            }
+
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: net_agecache_insert
+ *
+ * Description:
+ *   Return the entry with the given key, creating it if necessary.  A new
+ *   entry is zeroed except for its key.  If the cache is full (or no
+ *   memory is available) the oldest entry is replaced.  In either case,
+ *   the entry is marked as just updated.
+ *
+ * Input Parameters:
+ *   cache - The aging cache
+ *   key   - The key of the entry (ac_keylen bytes)
+ *
+ * Returned Value:
+ *   The entry or NULL if no entry could be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_agecache_entry_s *
+net_agecache_insert(FAR struct net_agecache_s *cache, FAR const void *key)
+{
+  FAR struct net_agecache_entry_s *entry;
+  unsigned int ndx;
+
+  entry = net_agecache_find(cache, key);
+  if (entry != NULL)
+    {
+      net_agecache_touch(cache, entry);
+      return entry;
+    }
+
+  /* Keep the hash chains short */
+
+  if (cache->ac_nentries >= 2 * cache->ac_nbuckets &&
+      cache->ac_nbuckets < 0x8000)
+    {
+      agecache_grow(cache);
+    }
+
+  if (cache->ac_nbuckets == 0)
+    {
+      return NULL;
+    }
+
+  /* Allocate a new entry or replace the oldest one */
+
+  entry = NULL;
+  if (cache->ac_nentries < cache->ac_maxentries)
+    {
+      entry = (FAR struct net_agecache_entry_s *)
+        kmm_malloc(cache->ac_entsize);
+    }
+
+  if (entry == NULL)
+    {
+      entry = agecache_oldest(cache);
+      if (entry == NULL)
+        {
+          return NULL;
+        }
+
+      agecache_unlink(cache, entry);
+    }
+
+  memset(entry, 0, cache->ac_entsize);
+  memcpy(AGECACHE_KEY(cache, entry), key, cache->ac_keylen);
+
+  ndx             = agecache_hash(cache, key);
+  entry->ae_hnext = cache->ac_hash[ndx];
+  cache->ac_hash[ndx] = entry;
+
+  entry->ae_time  = clock_systimer();
+  entry->ae_slot  = cache->ac_cur;
+  dq_addlast(&entry->ae_wlink, &cache->ac_wheel[cache->ac_cur]);
+  cache->ac_nentries++;
+  return entry;
+}
+
+/****************************************************************************
+ * Name: net_agecache_touch
+ *
+ * Description:
+ *   Mark an entry of an aging cache as just updated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void net_agecache_touch(FAR struct net_agecache_s *cache,
+                        FAR struct net_agecache_entry_s *entry)
+{
+  /* Take the entry off the timer wheel so that it cannot be expired while
+   * the wheel is advanced, then add it to the end of the current slot.
+   */
+
+  dq_rem(&entry->ae_wlink, &cache->ac_wheel[entry->ae_slot]);
+  entry->ae_time = agecache_advance(cache);
+  entry->ae_slot = cache->ac_cur;
+  dq_addlast(&entry->ae_wlink, &cache->ac_wheel[cache->ac_cur]);
+}
+
+/****************************************************************************
+ * Name: net_agecache_remove
+ *
+ * Description:
+ *   Remove an entry from an aging cache and free it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void net_agecache_remove(FAR struct net_agecache_s *cache,
+                         FAR struct net_agecache_entry_s *entry)
+{
+  agecache_unlink(cache, entry);
+  kmm_free(entry);
+}
+
+#endif /* HAVE_NET_AGECACHE */
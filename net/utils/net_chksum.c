@@ -41,6 +41,7 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -79,45 +80,111 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_LIBC_ARCH_CHKSUM)
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  FAR const uint32_t *wptr;
+  uint32_t acc = 0;
+  uint32_t w;
+  bool odd;
+
+  /* The one's complement sum does not depend on byte order (RFC 1071).  So
+   * the data is summed as native 16-bit words, 32 bits at a time, and the
+   * result is converted to network order at the end.  Start on an even
+   * address; if the data begins on an odd address, all of the words are
+   * then shifted by one byte and the result must be byte swapped.
+   */
+
+  odd = ((uintptr_t)data & 1) != 0;
+  if (odd && len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = *data;
+#else
+      acc = (uint32_t)*data << 8;
+#endif
+      data++;
+      len--;
+    }
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* Each 32-bit word adds at most 0x1fffe, so the accumulator cannot
+   * overflow with a 16-bit length.
+   */
+
+  wptr = (FAR const uint32_t *)data;
+  while (len >= 16)
+    {
+      w    = wptr[0];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = wptr[1];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = wptr[2];
+      acc += (w >> 16) + (w & 0xffff);
+      w    = wptr[3];
+      acc += (w >> 16) + (w & 0xffff);
+
+      wptr += 4;
+      len  -= 16;
+    }
 
-  while (dataptr < last_byte)
+  while (len >= 4)
     {
-      /* At least two more bytes */
+      w    = *wptr++;
+      acc += (w >> 16) + (w & 0xffff);
+      len -= 4;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  data = (FAR const uint8_t *)wptr;
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
 
-      dataptr += 2;
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint32_t)*data << 8;
+#else
+      acc += *data;
+#endif
     }
 
-  if (dataptr == last_byte)
+  /* Fold the accumulator to 16 bits */
+
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  if (odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      acc = ((acc >> 8) & 0xff) | ((acc & 0xff) << 8);
     }
 
-  /* Return sum in host byte order. */
+#ifndef CONFIG_ENDIAN_BIG
+  /* Convert the sum of little-endian words to the sum of network order
+   * words.
+   */
+
+  acc = ((acc >> 8) & 0xff) | ((acc & 0xff) << 8);
+#endif
 
-  return sum;
+  /* Add the partial sum from previous calls.  Return sum in host byte
+   * order.
+   */
+
+  acc += sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_LIBC_ARCH_CHKSUM */
 
 /****************************************************************************
  * Name: net_chksum
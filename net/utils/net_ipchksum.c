@@ -41,11 +41,15 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <assert.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#ifdef CONFIG_NETDEV_SGTX
+#  include <nuttx/mm/iob.h>
+#endif
 
 #include "utils/utils.h"
 
@@ -58,6 +62,109 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_iob
+ *
+ * Description:
+ *   Continue the raw checksum calculation over 'len' bytes of an I/O
+ *   buffer chain beginning at 'offset'.  The sum is assumed to have
+ *   covered an even number of bytes so far.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NETDEV_SGTX)
+static uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob,
+                           unsigned int offset, unsigned int len)
+{
+  bool odd = false;
+  unsigned int seglen;
+  uint16_t part;
+
+  for (; iob != NULL && len > 0; iob = iob->io_flink)
+    {
+      if (offset >= iob->io_len)
+        {
+          offset -= iob->io_len;
+          continue;
+        }
+
+      seglen = iob->io_len - offset;
+      if (seglen > len)
+        {
+          seglen = len;
+        }
+
+      /* A region that starts at an odd position of the packet contributes
+       * its byte-swapped sum.
+       */
+
+      part = chksum(0, IOB_DATA(iob) + offset, seglen);
+      if (odd)
+        {
+          part = (uint16_t)((part << 8) | (part >> 8));
+        }
+
+      sum += part;
+      if (sum < part)
+        {
+          sum++; /* carry */
+        }
+
+      odd    ^= (seglen & 1) != 0;
+      len    -= seglen;
+      offset  = 0;
+    }
+
+  DEBUGASSERT(len == 0);
+  return sum;
+}
+#endif
+
+/****************************************************************************
+ * Name: upperlayer_payload_chksum
+ *
+ * Description:
+ *   Sum the protocol header and data that follow the IP header.  Normally
+ *   these are all in d_buf, but with scatter-gather transmit the
+ *   application data may have been left in an I/O buffer chain or in
+ *   place.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM)
+static uint16_t upperlayer_payload_chksum(FAR struct net_driver_s *dev,
+                                          uint16_t sum, unsigned int offset,
+                                          uint16_t upperlen)
+{
+#ifdef CONFIG_NETDEV_SGTX
+  if (dev->d_iob != NULL && dev->d_sndlen > 0)
+    {
+      uint16_t hdrlen = upperlen - dev->d_sndlen;
+
+      DEBUGASSERT(upperlen > dev->d_sndlen && (hdrlen & 1) == 0);
+
+      sum = chksum(sum, &dev->d_buf[offset], hdrlen);
+      return chksum_iob(sum, dev->d_iob, dev->d_iobofs, dev->d_sndlen);
+    }
+  else if (dev->d_sndref != NULL && dev->d_sndlen > 0)
+    {
+      uint16_t hdrlen = upperlen - dev->d_sndlen;
+
+      DEBUGASSERT(upperlen > dev->d_sndlen && (hdrlen & 1) == 0);
+
+      sum = chksum(sum, &dev->d_buf[offset], hdrlen);
+      return chksum(sum, dev->d_sndref, dev->d_sndlen);
+    }
+#endif
+
+  return chksum(sum, &dev->d_buf[offset], upperlen);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,7 +218,8 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_payload_chksum(dev, sum,
+                                  IPv4_HDRLEN + NET_LL_HDRLEN(dev), upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -177,7 +285,8 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[NET_LL_HDRLEN(dev) + iplen], upperlen);
+  sum = upperlayer_payload_chksum(dev, sum, NET_LL_HDRLEN(dev) + iplen,
+                                  upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -50,6 +50,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "utils/utils.h"
 
@@ -63,9 +64,15 @@
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+/* The global network lock */
+
+static struct net_rlock_s g_netlock;
+
+#ifdef CONFIG_NET_PERF
+/* The time that the current holder took the network lock */
+
+static uint64_t g_netlock_start;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -80,7 +87,7 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR sem_t *sem)
 {
   int ret;
 
@@ -88,7 +95,7 @@ static void _net_takesem(void)
     {
       /* Take the semaphore (perhaps waiting) */
 
-      ret = nxsem_wait(&g_netlock);
+      ret = nxsem_wait(sem);
 
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -104,33 +111,42 @@ static void _net_takesem(void)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: net_lockinitialize
+ * Name: net_rlock_init
  *
  * Description:
- *   Initialize the locking facility
+ *   Initialize a re-entrant network lock.
+ *
+ * Input Parameters:
+ *   lock - The lock to be initialized
+ *
+ * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
-void net_lockinitialize(void)
+void net_rlock_init(FAR struct net_rlock_s *lock)
 {
-  nxsem_init(&g_netlock, 0, 1);
+  nxsem_init(&lock->sem, 0, 1);
+  lock->holder = NO_HOLDER;
+  lock->count  = 0;
 }
 
 /****************************************************************************
- * Name: net_lock
+ * Name: net_rlock
  *
  * Description:
- *   Take the network lock
+ *   Take a re-entrant network lock, waiting if it is held by another
+ *   thread.
  *
  * Input Parameters:
- *   None
+ *   lock - The lock to be taken
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void net_lock(void)
+void net_rlock(FAR struct net_rlock_s *lock)
 {
 #ifdef CONFIG_SMP
   irqstate_t flags = enter_critical_section();
@@ -139,22 +155,22 @@ void net_lock(void)
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (lock->holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      lock->count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      _net_takesem(&lock->sem);
 
       /* Now this thread holds the semaphore */
 
-      g_holder = me;
-      g_count  = 1;
+      lock->holder = me;
+      lock->count  = 1;
     }
 
 #ifdef CONFIG_SMP
@@ -163,41 +179,41 @@ void net_lock(void)
 }
 
 /****************************************************************************
- * Name: net_unlock
+ * Name: net_runlock
  *
  * Description:
- *   Release the network lock.
+ *   Release a re-entrant network lock.
  *
  * Input Parameters:
- *   None
+ *   lock - The lock to be released
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void net_unlock(void)
+void net_runlock(FAR struct net_rlock_s *lock)
 {
 #ifdef CONFIG_SMP
   irqstate_t flags = enter_critical_section();
 #endif
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  DEBUGASSERT(lock->holder == getpid() && lock->count > 0);
 
   /* If the count would go to zero, then release the semaphore */
 
-  if (g_count == 1)
+  if (lock->count == 1)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      nxsem_post(&g_netlock);
+      lock->holder = NO_HOLDER;
+      lock->count  = 0;
+      nxsem_post(&lock->sem);
     }
   else
     {
       /* We still hold the semaphore. Just decrement the count */
 
-      g_count--;
+      lock->count--;
     }
 
 #ifdef CONFIG_SMP
@@ -205,6 +221,95 @@ void net_unlock(void)
 #endif
 }
 
+/****************************************************************************
+ * Name: net_rlock_held
+ *
+ * Description:
+ *   Return true if the calling thread holds the re-entrant network lock.
+ *
+ * Input Parameters:
+ *   lock - The lock to be checked
+ *
+ * Returned Value:
+ *   True if the lock is held by the calling thread.
+ *
+ ****************************************************************************/
+
+bool net_rlock_held(FAR struct net_rlock_s *lock)
+{
+  return lock->holder == getpid();
+}
+
+/****************************************************************************
+ * Name: net_lockinitialize
+ *
+ * Description:
+ *   Initialize the locking facility
+ *
+ ****************************************************************************/
+
+void net_lockinitialize(void)
+{
+  net_rlock_init(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_lock
+ *
+ * Description:
+ *   Take the network lock
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_lock(void)
+{
+#ifdef CONFIG_NET_PERF
+  if (!net_rlock_held(&g_netlock))
+    {
+      uint64_t start = netperf_gettime();
+
+      net_rlock(&g_netlock);
+      netperf_update(NETPERF_LOCK_WAIT, start);
+      g_netlock_start = netperf_gettime();
+      return;
+    }
+#endif
+
+  net_rlock(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_unlock
+ *
+ * Description:
+ *   Release the network lock.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_unlock(void)
+{
+#ifdef CONFIG_NET_PERF
+  if (g_netlock.count == 1)
+    {
+      netperf_update(NETPERF_LOCK_HOLD, g_netlock_start);
+    }
+#endif
+
+  net_runlock(&g_netlock);
+}
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -223,19 +328,22 @@ int net_breaklock(FAR unsigned int *count)
   DEBUGASSERT(count != NULL);
 
   flags = enter_critical_section(); /* No interrupts */
-  if (g_holder == me)
+  if (g_netlock.holder == me)
     {
       /* Return the lock setting */
 
-      *count   = g_count;
+      *count           = g_netlock.count;
+#ifdef CONFIG_NET_PERF
+      netperf_update(NETPERF_LOCK_HOLD, g_netlock_start);
+#endif
 
       /* Release the network lock  */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
+      g_netlock.holder = NO_HOLDER;
+      g_netlock.count  = 0;
 
-      (void)nxsem_post(&g_netlock);
-      ret      = OK;
+      (void)nxsem_post(&g_netlock.sem);
+      ret              = OK;
     }
 
   leave_critical_section(flags);
@@ -253,14 +361,21 @@ int net_breaklock(FAR unsigned int *count)
 void net_restorelock(unsigned int count)
 {
   pid_t me = getpid();
+  NETPERF_DECLARE(start);
 
-  DEBUGASSERT(g_holder != me);
+  DEBUGASSERT(g_netlock.holder != me);
 
   /* Recover the network lock at the proper count */
 
-  _net_takesem();
-  g_holder = me;
-  g_count  = count;
+  NETPERF_START(start);
+  _net_takesem(&g_netlock.sem);
+  NETPERF_UPDATE(NETPERF_LOCK_WAIT, start);
+#ifdef CONFIG_NET_PERF
+  g_netlock_start = netperf_gettime();
+#endif
+
+  g_netlock.holder = me;
+  g_netlock.count  = count;
 }
 
 /****************************************************************************
@@ -367,6 +482,7 @@ int net_lockedwait(sem_t *sem)
  *
  * Input Parameters:
  *   throttled - An indication of the IOB allocation is "throttled"
+ *   user      - The consumer that the IOB is accounted to
  *
  * Returned Value:
  *   A pointer to the newly allocated IOB is returned on success.  NULL is
@@ -375,16 +491,17 @@ int net_lockedwait(sem_t *sem)
  ****************************************************************************/
 
 #ifdef CONFIG_MM_IOB
-FAR struct iob_s *net_ioballoc(bool throttled)
+FAR struct iob_s *net_ioballoc(bool throttled, enum iob_user_e user)
 {
   FAR struct iob_s *iob;
 
-  iob = iob_tryalloc(throttled);
+  iob = iob_tryalloc_user(throttled, user);
   if (iob == NULL)
     {
       irqstate_t flags;
       unsigned int count;
       int blresult;
+      NETPERF_DECLARE(start);
 
       /* There are no buffers available now.  We will have to wait for one to
        * become available. But let's not do that with the network locked.
@@ -392,7 +509,9 @@ FAR struct iob_s *net_ioballoc(bool throttled)
 
       flags    = enter_critical_section();
       blresult = net_breaklock(&count);
-      iob      = iob_alloc(throttled);
+      NETPERF_START(start);
+      iob      = iob_alloc_user(throttled, user);
+      NETPERF_UPDATE(NETPERF_IOB_WAIT, start);
       if (blresult >= 0)
         {
           net_restorelock(count);
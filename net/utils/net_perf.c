@@ -0,0 +1,116 @@
+/****************************************************************************
+ * net/utils/net_perf.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/timers/hrtimer.h>
+#include <nuttx/net/netstats.h>
+
+#ifdef CONFIG_NET_PERF
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The network performance counters, indexed by enum netperf_e */
+
+struct netperf_s g_netperf[NETPERF_NCOUNTERS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netperf_gettime
+ *
+ * Description:
+ *   Return the start time of a timed section in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t netperf_gettime(void)
+{
+  return hrtimer_now();
+}
+
+/****************************************************************************
+ * Name: netperf_update
+ *
+ * Description:
+ *   Account the time since start to a performance counter.
+ *
+ * Input Parameters:
+ *   id    - The performance counter
+ *   start - The value returned by netperf_gettime() at the start of the
+ *           timed section
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netperf_update(enum netperf_e id, uint64_t start)
+{
+  FAR struct netperf_s *perf = &g_netperf[id];
+  irqstate_t flags;
+  uint64_t elapsed;
+
+  elapsed = hrtimer_now() - start;
+  if (elapsed > UINT32_MAX)
+    {
+      elapsed = UINT32_MAX;
+    }
+
+  /* Some sections are timed from interrupt handlers */
+
+  flags = enter_critical_section();
+  perf->np_count++;
+  perf->np_total += elapsed;
+  if ((uint32_t)elapsed > perf->np_max)
+    {
+      perf->np_max = (uint32_t)elapsed;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_NET_PERF */
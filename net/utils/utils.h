@@ -41,9 +41,44 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <queue.h>
+
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ARPTAB_HASH) || defined(CONFIG_NET_IPv6_NCONF_HASH)
+#  define HAVE_NET_AGECACHE 1
+
+/* Number of timer wheel slots in an aging cache.  Entries expire between
+ * the maximum age and (17/16) of the maximum age after their last update.
+ */
+
+#  define NET_AGECACHE_NSLOTS 17
+
+/* Static initializer for struct net_agecache_s.
+ *
+ *   type    - The type of one cache entry.  Its first member must be a
+ *             struct net_agecache_entry_s.
+ *   key     - The member of 'type' that holds the look-up key
+ *   maxents - The maximum number of entries in the cache
+ *   maxage  - The maximum age of an entry in clock ticks
+ */
+
+#  define NET_AGECACHE_INITIALIZER(type, key, maxents, maxage) \
+  { sizeof(type), offsetof(type, key), sizeof(((FAR type *)0)->key), \
+    (maxents), (maxage) }
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -57,6 +92,44 @@ enum tv2ds_remainder_e
   TV2DS_CEIL       /* Force to next larger full decisecond */
 };
 
+#ifdef HAVE_NET_AGECACHE
+/* The common header of every entry in an aging cache */
+
+struct net_agecache_entry_s
+{
+  dq_entry_t ae_wlink;                       /* Link in timer wheel slot */
+  FAR struct net_agecache_entry_s *ae_hnext; /* Next entry in hash chain */
+  clock_t ae_time;                           /* Time of last update */
+  uint8_t ae_slot;                           /* Timer wheel slot */
+};
+
+/* A dynamically allocated, hashed table of entries that expire a fixed
+ * time after they were last updated.  Expiration is handled by a timer
+ * wheel that is advanced whenever the cache is accessed, so neither
+ * look-ups nor the replacement of the oldest entry scan the table.
+ */
+
+struct net_agecache_s
+{
+  /* Configuration (see NET_AGECACHE_INITIALIZER) */
+
+  uint16_t ac_entsize;                       /* Size of one entry */
+  uint8_t  ac_keyoff;                        /* Offset to the key */
+  uint8_t  ac_keylen;                        /* Size of the key */
+  uint16_t ac_maxentries;                    /* Maximum number of entries */
+  clock_t  ac_maxage;                        /* Maximum age in ticks */
+
+  /* State */
+
+  FAR struct net_agecache_entry_s **ac_hash; /* Hash buckets */
+  uint16_t ac_nbuckets;                      /* Number of buckets (2^n) */
+  uint16_t ac_nentries;                      /* Number of entries */
+  uint8_t  ac_cur;                           /* Current timer wheel slot */
+  clock_t  ac_base;                          /* Start of current slot */
+  dq_queue_t ac_wheel[NET_AGECACHE_NSLOTS];  /* Timer wheel */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -394,6 +467,88 @@ uint16_t icmp_chksum(FAR struct net_driver_s *dev, int len);
 uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 #endif
 
+/****************************************************************************
+ * Name: net_agecache_find
+ *
+ * Description:
+ *   Find the entry with the given key in an aging cache.  Expired entries
+ *   are removed from the cache and are never returned.
+ *
+ * Input Parameters:
+ *   cache - The aging cache
+ *   key   - The key to look up (ac_keylen bytes)
+ *
+ * Returned Value:
+ *   The matching entry or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_NET_AGECACHE
+FAR struct net_agecache_entry_s *
+net_agecache_find(FAR struct net_agecache_s *cache, FAR const void *key);
+#endif
+
+/****************************************************************************
+ * Name: net_agecache_insert
+ *
+ * Description:
+ *   Return the entry with the given key, creating it if necessary.  A new
+ *   entry is zeroed except for its key.  If the cache is full (or no
+ *   memory is available) the oldest entry is replaced.  In either case,
+ *   the entry is marked as just updated.
+ *
+ * Input Parameters:
+ *   cache - The aging cache
+ *   key   - The key of the entry (ac_keylen bytes)
+ *
+ * Returned Value:
+ *   The entry or NULL if no entry could be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_NET_AGECACHE
+FAR struct net_agecache_entry_s *
+net_agecache_insert(FAR struct net_agecache_s *cache, FAR const void *key);
+#endif
+
+/****************************************************************************
+ * Name: net_agecache_touch
+ *
+ * Description:
+ *   Mark an entry of an aging cache as just updated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_NET_AGECACHE
+void net_agecache_touch(FAR struct net_agecache_s *cache,
+                        FAR struct net_agecache_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: net_agecache_remove
+ *
+ * Description:
+ *   Remove an entry from an aging cache and free it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_NET_AGECACHE
+void net_agecache_remove(FAR struct net_agecache_s *cache,
+                         FAR struct net_agecache_entry_s *entry);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,202 @@
+/****************************************************************************
+ * sched/bench/bench.h
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_BENCH_BENCH_H
+#define __SCHED_BENCH_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/bench.h>
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of batches of CONFIG_SCHED_BENCH_ITERATIONS operations used
+ * by each throughput benchmark.
+ */
+
+#define BENCH_NBATCHES 10
+
+/* The loopback network benchmarks complete each transfer in one thread so
+ * they depend on the TCP backlog and on read-ahead buffering.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_LOOPBACK)
+#  if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCPBACKLOG) && \
+      defined(CONFIG_NET_TCP_READAHEAD)
+#    define BENCH_HAVE_TCP 1
+#  endif
+#  if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_READAHEAD)
+#    define BENCH_HAVE_UDP 1
+#  endif
+#endif
+
+#if defined(BENCH_HAVE_TCP) || defined(BENCH_HAVE_UDP) || \
+    defined(CONFIG_SCHED_BENCH_NET_PEER)
+#  define BENCH_HAVE_NET 1
+#endif
+
+#if defined(CONFIG_SCHED_BENCH_FS) || defined(CONFIG_SCHED_BENCH_BLK)
+#  define BENCH_HAVE_FS 1
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_gettime
+ *
+ * Description:
+ *   Return a monotonic time in nanoseconds.  This is hrtimer_now() if
+ *   CONFIG_HRTIMER is selected; otherwise it is the system time and only
+ *   has the resolution of the system timer.
+ *
+ ****************************************************************************/
+
+uint64_t bench_gettime(void);
+
+/****************************************************************************
+ * Name: bench_init
+ *
+ * Description:
+ *   Prepare the result of a benchmark before it is run.
+ *
+ ****************************************************************************/
+
+void bench_init(FAR struct bench_result_s *result, FAR const char *name);
+
+/****************************************************************************
+ * Name: bench_report
+ *
+ * Description:
+ *   Complete the result of a benchmark after it is run and pass it to the
+ *   handler of sched_benchmark().  The handler's return value is returned.
+ *
+ ****************************************************************************/
+
+int bench_report(FAR struct bench_result_s *result);
+
+/****************************************************************************
+ * Name: bench_update
+ *
+ * Description:
+ *   Account for one measurement of elapsed nanoseconds that covered nops
+ *   operations.
+ *
+ ****************************************************************************/
+
+void bench_update(FAR struct bench_result_s *result, uint64_t elapsed,
+                  uint32_t nops);
+
+/****************************************************************************
+ * Name: bench_thread
+ *
+ * Description:
+ *   Start a helper kernel thread with the priority of the benchmark thread
+ *   and, in the SMP case, on the same CPU.
+ *
+ * Returned Value:
+ *   The ID of the new thread or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bench_thread(FAR const char *name, main_t entry);
+
+/****************************************************************************
+ * Name: bench_*
+ *
+ * Description:
+ *   The individual benchmarks.  Each fills in result; its return value is
+ *   also saved in result->br_result.
+ *
+ ****************************************************************************/
+
+int bench_yield(FAR struct bench_result_s *result);
+int bench_sem(FAR struct bench_result_s *result);
+#ifndef CONFIG_DISABLE_MQUEUE
+int bench_mqueue(FAR struct bench_result_s *result);
+#endif
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+int bench_pipe(FAR struct bench_result_s *result);
+#endif
+int bench_malloc(FAR struct bench_result_s *result);
+int bench_mallocmix(FAR struct bench_result_s *result);
+#ifdef CONFIG_SCHED_WORKQUEUE
+int bench_work(FAR struct bench_result_s *result);
+#endif
+int bench_wdog(FAR struct bench_result_s *result);
+#ifdef CONFIG_HRTIMER
+int bench_hrtimer(FAR struct bench_result_s *result);
+#endif
+#ifdef BENCH_HAVE_TCP
+int bench_tcp(FAR struct bench_result_s *result);
+#endif
+#ifdef BENCH_HAVE_UDP
+int bench_udp(FAR struct bench_result_s *result);
+#endif
+#ifdef CONFIG_SCHED_BENCH_NET_PEER
+int bench_tcppeer(FAR struct bench_result_s *result);
+#endif
+
+/****************************************************************************
+ * Name: bench_fs
+ *
+ * Description:
+ *   Run the file system and block device benchmarks and report each result
+ *   with bench_report().  These follow the fixed benchmarks of
+ *   sched_benchmark() because each covers several transfer sizes.
+ *
+ * Returned Value:
+ *   Zero (OK) or the first negated errno value returned by bench_report().
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_FS
+int bench_fs(void);
+#endif
+
+#endif /* CONFIG_SCHED_BENCH */
+#endif /* __SCHED_BENCH_BENCH_H */
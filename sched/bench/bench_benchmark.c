@@ -0,0 +1,377 @@
+/****************************************************************************
+ * sched/bench/bench_benchmark.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/bench.h>
+#include <nuttx/timers/hrtimer.h>
+
+#include "bench/bench.h"
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s
+{
+  FAR const char *name;
+  CODE int (*run)(FAR struct bench_result_s *result);
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The benchmarks in the order that they are run and reported */
+
+static const struct bench_s g_benchmarks[] =
+{
+  { "yield",     bench_yield     },
+  { "sem",       bench_sem       },
+#ifndef CONFIG_DISABLE_MQUEUE
+  { "mqueue",    bench_mqueue    },
+#endif
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+  { "pipe",      bench_pipe      },
+#endif
+  { "malloc",    bench_malloc    },
+  { "mallocmix", bench_mallocmix },
+#ifdef CONFIG_SCHED_WORKQUEUE
+  { "work",      bench_work      },
+#endif
+  { "wdog",      bench_wdog      },
+#ifdef CONFIG_HRTIMER
+  { "hrtimer",   bench_hrtimer   },
+#endif
+#ifdef BENCH_HAVE_TCP
+  { "tcp",       bench_tcp       },
+#endif
+#ifdef BENCH_HAVE_UDP
+  { "udp",       bench_udp       },
+#endif
+#ifdef CONFIG_SCHED_BENCH_NET_PEER
+  { "tcppeer",   bench_tcppeer   },
+#endif
+};
+
+#define BENCH_NBENCHMARKS \
+  (sizeof(g_benchmarks) / sizeof(struct bench_s))
+
+/* Only one set of benchmarks runs at a time */
+
+static sem_t g_benchlock = SEM_INITIALIZER(1);
+static sem_t g_benchdone;
+
+static bench_handler_t g_benchhandler;
+static FAR void *g_bencharg;
+static int g_benchret;
+
+#ifdef CONFIG_SMP
+static int g_benchcpu;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_main
+ *
+ * Description:
+ *   The benchmark kernel thread.
+ *
+ ****************************************************************************/
+
+static int bench_main(int argc, FAR char *argv[])
+{
+  struct bench_result_s result;
+  int ret = OK;
+  int i;
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  /* Keep the benchmark and its helper threads on one CPU */
+
+  g_benchcpu = up_cpu_index();
+  CPU_ZERO(&cpuset);
+  CPU_SET(g_benchcpu, &cpuset);
+  (void)nxsched_setaffinity(getpid(), sizeof(cpu_set_t), &cpuset);
+#endif
+
+  for (i = 0; i < BENCH_NBENCHMARKS; i++)
+    {
+      bench_init(&result, g_benchmarks[i].name);
+      result.br_result = g_benchmarks[i].run(&result);
+
+      ret = bench_report(&result);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#ifdef BENCH_HAVE_FS
+  if (ret >= 0)
+    {
+      ret = bench_fs();
+    }
+#endif
+
+  g_benchret = ret;
+  nxsem_post(&g_benchdone);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_gettime
+ *
+ * Description:
+ *   Return a monotonic time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t bench_gettime(void)
+{
+  struct timespec ts;
+
+#ifdef CONFIG_HRTIMER
+  uint64_t now = hrtimer_now();
+
+  if (now != 0)
+    {
+      return now;
+    }
+#endif
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_init
+ *
+ * Description:
+ *   Prepare the result of a benchmark before it is run.
+ *
+ ****************************************************************************/
+
+void bench_init(FAR struct bench_result_s *result, FAR const char *name)
+{
+  memset(result, 0, sizeof(struct bench_result_s));
+  result->br_name = name;
+  result->br_min  = UINT32_MAX;
+}
+
+/****************************************************************************
+ * Name: bench_report
+ *
+ * Description:
+ *   Complete the result of a benchmark after it is run and pass it to the
+ *   handler of sched_benchmark().
+ *
+ ****************************************************************************/
+
+int bench_report(FAR struct bench_result_s *result)
+{
+  if (result->br_count > 0)
+    {
+      result->br_mean = (uint32_t)(result->br_total / result->br_count);
+    }
+  else
+    {
+      result->br_min = 0;
+    }
+
+  return g_benchhandler(result, g_bencharg);
+}
+
+/****************************************************************************
+ * Name: bench_update
+ *
+ * Description:
+ *   Account for one measurement of elapsed nanoseconds that covered nops
+ *   operations.
+ *
+ ****************************************************************************/
+
+void bench_update(FAR struct bench_result_s *result, uint64_t elapsed,
+                  uint32_t nops)
+{
+  uint64_t perop = elapsed / nops;
+
+  if (perop > UINT32_MAX)
+    {
+      perop = UINT32_MAX;
+    }
+
+  if (perop < result->br_min)
+    {
+      result->br_min = (uint32_t)perop;
+    }
+
+  if (perop > result->br_max)
+    {
+      result->br_max = (uint32_t)perop;
+    }
+
+  result->br_total += elapsed;
+  result->br_count += nops;
+}
+
+/****************************************************************************
+ * Name: bench_thread
+ *
+ * Description:
+ *   Start a helper kernel thread with the priority of the benchmark thread
+ *   and, in the SMP case, on the same CPU.
+ *
+ ****************************************************************************/
+
+int bench_thread(FAR const char *name, main_t entry)
+{
+  int pid;
+
+  pid = kthread_create(name, CONFIG_SCHED_BENCH_PRIORITY,
+                       CONFIG_SCHED_BENCH_STACKSIZE, entry, NULL);
+  if (pid < 0)
+    {
+      serr("ERROR: Failed to start %s: %d\n", name, pid);
+      return pid;
+    }
+
+#ifdef CONFIG_SMP
+  {
+    cpu_set_t cpuset;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(g_benchcpu, &cpuset);
+    (void)nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+  }
+#endif
+
+  return pid;
+}
+
+/****************************************************************************
+ * Name: sched_benchmark
+ *
+ * Description:
+ *   Run the kernel microbenchmarks in a kernel thread and pass each result
+ *   to handler.
+ *
+ * Input Parameters:
+ *   handler - Called with the result of each benchmark.
+ *   arg     - An argument passed to handler.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if all of the benchmarks were run; a negated
+ *   errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int sched_benchmark(bench_handler_t handler, FAR void *arg)
+{
+  int ret;
+
+  DEBUGASSERT(handler != NULL);
+
+  ret = nxsem_wait(&g_benchlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_benchhandler = handler;
+  g_bencharg     = arg;
+  g_benchret     = OK;
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&g_benchdone, 0, 0);
+  nxsem_setprotocol(&g_benchdone, SEM_PRIO_NONE);
+
+  ret = kthread_create("bench", CONFIG_SCHED_BENCH_PRIORITY,
+                       CONFIG_SCHED_BENCH_STACKSIZE, bench_main, NULL);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to start the benchmark thread: %d\n", ret);
+    }
+  else
+    {
+      /* The handler may still be in use so this wait must not be
+       * interrupted.
+       */
+
+      ret = nxsem_wait_uninterruptible(&g_benchdone);
+      if (ret >= 0)
+        {
+          ret = g_benchret;
+        }
+    }
+
+  nxsem_destroy(&g_benchdone);
+  nxsem_post(&g_benchlock);
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_BENCH */
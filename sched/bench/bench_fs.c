@@ -0,0 +1,658 @@
+/****************************************************************************
+ * sched/bench/bench_fs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "bench/bench.h"
+
+#if defined(CONFIG_SCHED_BENCH) && defined(BENCH_HAVE_FS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest transfer of any benchmark */
+
+#define BENCH_FS_MAXBLOCK  4096
+
+/* The size of the file used by the small file and fsync benchmarks */
+
+#define BENCH_FS_SMALLSIZE 64
+
+#define BENCH_FS_PATHLEN   64
+#define BENCH_FS_DATAFILE  "bench.dat"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_fs_s
+{
+  FAR const char *name;
+  CODE int (*run)(FAR struct bench_result_s *result, size_t size);
+  size_t size;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BENCH_FS
+static int bench_seqwrite(FAR struct bench_result_s *result, size_t size);
+static int bench_seqread(FAR struct bench_result_s *result, size_t size);
+static int bench_rndwrite(FAR struct bench_result_s *result, size_t size);
+static int bench_rndread(FAR struct bench_result_s *result, size_t size);
+static int bench_fsync(FAR struct bench_result_s *result, size_t size);
+static int bench_create(FAR struct bench_result_s *result, size_t size);
+static int bench_readdir(FAR struct bench_result_s *result, size_t size);
+static int bench_unlink(FAR struct bench_result_s *result, size_t size);
+#endif
+#ifdef CONFIG_SCHED_BENCH_BLK
+static int bench_blkread(FAR struct bench_result_s *result, size_t size);
+#ifdef CONFIG_SCHED_BENCH_BLK_WRITE
+static int bench_blkwrite(FAR struct bench_result_s *result, size_t size);
+#endif
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The benchmarks in the order that they are run and reported.  The
+ * sequential write benchmarks leave the data file used by the read and the
+ * random access benchmarks and create leaves the files used by readdir and
+ * unlink.
+ */
+
+static const struct bench_fs_s g_fsbenchmarks[] =
+{
+#ifdef CONFIG_SCHED_BENCH_FS
+  { "seqwr-64",   bench_seqwrite, 64                },
+  { "seqwr-512",  bench_seqwrite, 512               },
+  { "seqwr-4096", bench_seqwrite, 4096              },
+  { "seqrd-64",   bench_seqread,  64                },
+  { "seqrd-512",  bench_seqread,  512               },
+  { "seqrd-4096", bench_seqread,  4096              },
+  { "rndwr-512",  bench_rndwrite, 512               },
+  { "rndwr-4096", bench_rndwrite, 4096              },
+  { "rndrd-512",  bench_rndread,  512               },
+  { "rndrd-4096", bench_rndread,  4096              },
+  { "fsync",      bench_fsync,    BENCH_FS_SMALLSIZE },
+  { "create",     bench_create,   BENCH_FS_SMALLSIZE },
+  { "readdir",    bench_readdir,  0                 },
+  { "unlink",     bench_unlink,   0                 },
+#endif
+#ifdef CONFIG_SCHED_BENCH_BLK
+  { "blkrd",      bench_blkread,  BENCH_FS_MAXBLOCK },
+#ifdef CONFIG_SCHED_BENCH_BLK_WRITE
+  { "blkwr",      bench_blkwrite, BENCH_FS_MAXBLOCK },
+#endif
+#endif
+};
+
+#define BENCH_NFSBENCHMARKS \
+  (sizeof(g_fsbenchmarks) / sizeof(struct bench_fs_s))
+
+/* The transfer buffer and the state of the random offset generator */
+
+static FAR uint8_t *g_fsbuffer;
+static uint32_t g_fsrandom;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BENCH_FS
+/****************************************************************************
+ * Name: bench_fspath
+ *
+ * Description:
+ *   Return the path of the data file (index < 0) or of a small file.
+ *
+ ****************************************************************************/
+
+static FAR const char *bench_fspath(FAR char *path, int index)
+{
+  if (index < 0)
+    {
+      snprintf(path, BENCH_FS_PATHLEN, "%s/" BENCH_FS_DATAFILE,
+               CONFIG_SCHED_BENCH_FS_PATH);
+    }
+  else
+    {
+      snprintf(path, BENCH_FS_PATHLEN, "%s/bench%03d",
+               CONFIG_SCHED_BENCH_FS_PATH, index);
+    }
+
+  return path;
+}
+
+/****************************************************************************
+ * Name: bench_fsrandom
+ *
+ * Description:
+ *   Return a pseudo-random block index in the range 0 .. nblocks-1.  The
+ *   sequence is the same on every run so that results are repeatable.
+ *
+ ****************************************************************************/
+
+static off_t bench_fsrandom(size_t nblocks)
+{
+  g_fsrandom = g_fsrandom * 1103515245 + 12345;
+  return (off_t)((g_fsrandom >> 8) % nblocks);
+}
+
+/****************************************************************************
+ * Name: bench_fsxfr
+ *
+ * Description:
+ *   Time nops reads or writes of size bytes from or to the data file.  If
+ *   random is true, each transfer is from or to a random offset.  Writes
+ *   are followed by fsync(), which is part of the time.
+ *
+ ****************************************************************************/
+
+static int bench_fsxfr(FAR struct bench_result_s *result, size_t size,
+                       bool wr, bool random)
+{
+  char path[BENCH_FS_PATHLEN];
+  struct file file;
+  uint64_t start;
+  uint64_t elapsed;
+  ssize_t nbytes;
+  size_t nops;
+  off_t pos;
+  int oflags;
+  int batch;
+  int ret;
+  int i;
+
+  nops   = CONFIG_SCHED_BENCH_FS_FILESIZE / size;
+  oflags = wr ? O_WRONLY : O_RDONLY;
+  if (wr && !random)
+    {
+      oflags |= O_CREAT | O_TRUNC;
+    }
+
+  (void)bench_fspath(path, -1);
+  g_fsrandom = 1;
+
+  for (batch = 0; batch < BENCH_NBATCHES; batch++)
+    {
+      ret = file_open(&file, path, oflags, 0666);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to open %s: %d\n", path, ret);
+          return ret;
+        }
+
+      start = bench_gettime();
+      for (i = 0; i < nops; i++)
+        {
+          if (random)
+            {
+              pos = file_seek(&file, bench_fsrandom(nops) * size, SEEK_SET);
+              if (pos < 0)
+                {
+                  ret = (int)pos;
+                  break;
+                }
+            }
+
+          if (wr)
+            {
+              nbytes = file_write(&file, g_fsbuffer, size);
+            }
+          else
+            {
+              nbytes = file_read(&file, g_fsbuffer, size);
+            }
+
+          if (nbytes != size)
+            {
+              ret = nbytes < 0 ? (int)nbytes : (wr ? -ENOSPC : -ENODATA);
+              break;
+            }
+        }
+
+      /* Not all file systems support fsync() */
+
+      if (wr && ret >= 0)
+        {
+          ret = file_fsync(&file);
+          if (ret == -EINVAL)
+            {
+              ret = OK;
+            }
+        }
+
+      elapsed = bench_gettime() - start;
+      (void)file_close(&file);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      bench_update(result, elapsed, nops);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_seqwrite, bench_seqread, bench_rndwrite and bench_rndread
+ *
+ * Description:
+ *   Measure the time per transfer of size bytes when writing or reading a
+ *   file of CONFIG_SCHED_BENCH_FS_FILESIZE bytes sequentially or at random
+ *   offsets.
+ *
+ ****************************************************************************/
+
+static int bench_seqwrite(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_fsxfr(result, size, true, false);
+}
+
+static int bench_seqread(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_fsxfr(result, size, false, false);
+}
+
+static int bench_rndwrite(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_fsxfr(result, size, true, true);
+}
+
+static int bench_rndread(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_fsxfr(result, size, false, true);
+}
+
+/****************************************************************************
+ * Name: bench_fsync
+ *
+ * Description:
+ *   Measure the latency of fsync() after each small write to the data file.
+ *   The data file is removed afterward.
+ *
+ ****************************************************************************/
+
+static int bench_fsync(FAR struct bench_result_s *result, size_t size)
+{
+  char path[BENCH_FS_PATHLEN];
+  struct file file;
+  uint64_t start;
+  ssize_t nbytes;
+  int ret;
+  int i;
+
+  (void)bench_fspath(path, -1);
+  ret = file_open(&file, path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to open %s: %d\n", path, ret);
+      return ret;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_SAMPLES; i++)
+    {
+      nbytes = file_write(&file, g_fsbuffer, size);
+      if (nbytes != size)
+        {
+          ret = nbytes < 0 ? (int)nbytes : -ENOSPC;
+          break;
+        }
+
+      start = bench_gettime();
+      ret   = file_fsync(&file);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      bench_update(result, bench_gettime() - start, 1);
+    }
+
+  (void)file_close(&file);
+  (void)unlink(path);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_create
+ *
+ * Description:
+ *   Measure the time to create, write and close each of
+ *   CONFIG_SCHED_BENCH_FS_NFILES small files.
+ *
+ ****************************************************************************/
+
+static int bench_create(FAR struct bench_result_s *result, size_t size)
+{
+  char path[BENCH_FS_PATHLEN];
+  struct file file;
+  uint64_t start;
+  ssize_t nbytes;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_FS_NFILES; i++)
+    {
+      (void)bench_fspath(path, i);
+
+      start = bench_gettime();
+      ret   = file_open(&file, path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to create %s: %d\n", path, ret);
+          return ret;
+        }
+
+      nbytes = file_write(&file, g_fsbuffer, size);
+      ret    = file_close(&file);
+      if (nbytes != size)
+        {
+          return nbytes < 0 ? (int)nbytes : -ENOSPC;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      bench_update(result, bench_gettime() - start, 1);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_readdir
+ *
+ * Description:
+ *   Measure the time per entry to list the benchmark directory.
+ *
+ ****************************************************************************/
+
+static int bench_readdir(FAR struct bench_result_s *result, size_t size)
+{
+  FAR DIR *dirp;
+  uint64_t start;
+  uint64_t elapsed;
+  uint32_t nentries;
+  int batch;
+
+  for (batch = 0; batch < BENCH_NBATCHES; batch++)
+    {
+      nentries = 0;
+      start    = bench_gettime();
+
+      dirp = opendir(CONFIG_SCHED_BENCH_FS_PATH);
+      if (dirp == NULL)
+        {
+          return -get_errno();
+        }
+
+      while (readdir(dirp) != NULL)
+        {
+          nentries++;
+        }
+
+      (void)closedir(dirp);
+      elapsed = bench_gettime() - start;
+
+      if (nentries == 0)
+        {
+          return -ENOENT;
+        }
+
+      bench_update(result, elapsed, nentries);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_unlink
+ *
+ * Description:
+ *   Measure the time to remove each of the files made by bench_create().
+ *
+ ****************************************************************************/
+
+static int bench_unlink(FAR struct bench_result_s *result, size_t size)
+{
+  char path[BENCH_FS_PATHLEN];
+  uint64_t start;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_FS_NFILES; i++)
+    {
+      (void)bench_fspath(path, i);
+
+      start = bench_gettime();
+      if (unlink(path) < 0)
+        {
+          ret = -get_errno();
+          continue;
+        }
+
+      bench_update(result, bench_gettime() - start, 1);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_SCHED_BENCH_FS */
+
+#ifdef CONFIG_SCHED_BENCH_BLK
+/****************************************************************************
+ * Name: bench_blkxfr
+ *
+ * Description:
+ *   Time sequential transfers of size bytes directly to or from the block
+ *   driver CONFIG_SCHED_BENCH_BLK_PATH, bypassing any file system.
+ *
+ ****************************************************************************/
+
+static int bench_blkxfr(FAR struct bench_result_s *result, size_t size,
+                        bool wr)
+{
+  FAR struct inode *inode;
+  struct geometry geo;
+  uint64_t start;
+  ssize_t nsectors;
+  size_t nops;
+  blkcnt_t sector;
+  int batch;
+  int ret;
+  int i;
+
+  ret = open_blockdriver(CONFIG_SCHED_BENCH_BLK_PATH, wr ? 0 : MS_RDONLY,
+                         &inode);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to open %s: %d\n",
+           CONFIG_SCHED_BENCH_BLK_PATH, ret);
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!geo.geo_available || geo.geo_sectorsize == 0 ||
+      geo.geo_sectorsize > size || (wr && !geo.geo_writeenabled) ||
+      (wr && inode->u.i_bops->write == NULL))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Each operation transfers as many whole sectors as fit in size bytes */
+
+  nsectors = size / geo.geo_sectorsize;
+  nops     = CONFIG_SCHED_BENCH_FS_FILESIZE /
+             (nsectors * geo.geo_sectorsize);
+  if (nops > geo.geo_nsectors / nsectors)
+    {
+      nops = geo.geo_nsectors / nsectors;
+    }
+
+  if (nops == 0)
+    {
+      ret = -ENOSPC;
+      goto errout;
+    }
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0, sector = 0; i < nops; i++, sector += nsectors)
+        {
+          ssize_t nxfrd;
+
+          if (wr)
+            {
+              nxfrd = inode->u.i_bops->write(inode, g_fsbuffer, sector,
+                                             nsectors);
+            }
+          else
+            {
+              nxfrd = inode->u.i_bops->read(inode, g_fsbuffer, sector,
+                                            nsectors);
+            }
+
+          if (nxfrd != nsectors)
+            {
+              ret = nxfrd < 0 ? (int)nxfrd : -EIO;
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start, nops);
+    }
+
+errout:
+  (void)close_blockdriver(inode);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_blkread and bench_blkwrite
+ ****************************************************************************/
+
+static int bench_blkread(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_blkxfr(result, size, false);
+}
+
+#ifdef CONFIG_SCHED_BENCH_BLK_WRITE
+static int bench_blkwrite(FAR struct bench_result_s *result, size_t size)
+{
+  return bench_blkxfr(result, size, true);
+}
+#endif
+#endif /* CONFIG_SCHED_BENCH_BLK */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_fs
+ *
+ * Description:
+ *   Run the file system and block device benchmarks and report each result
+ *   with bench_report().
+ *
+ ****************************************************************************/
+
+int bench_fs(void)
+{
+  struct bench_result_s result;
+  int ret = OK;
+  int i;
+
+  g_fsbuffer = (FAR uint8_t *)kmm_malloc(BENCH_FS_MAXBLOCK);
+  if (g_fsbuffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(g_fsbuffer, 0x5a, BENCH_FS_MAXBLOCK);
+
+  for (i = 0; i < BENCH_NFSBENCHMARKS; i++)
+    {
+      bench_init(&result, g_fsbenchmarks[i].name);
+      result.br_result = g_fsbenchmarks[i].run(&result,
+                                               g_fsbenchmarks[i].size);
+
+      ret = bench_report(&result);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  kmm_free(g_fsbuffer);
+  g_fsbuffer = NULL;
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_BENCH && BENCH_HAVE_FS */
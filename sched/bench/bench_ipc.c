@@ -0,0 +1,191 @@
+/****************************************************************************
+ * sched/bench/bench_ipc.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <unistd.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/drivers/drivers.h>
+
+#include "bench/bench.h"
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of each message queue message and of each pipe transfer */
+
+#define BENCH_MSGSIZE   16
+#define BENCH_PIPESIZE  64
+
+#define BENCH_MQNAME    "bench"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_mqueue
+ *
+ * Description:
+ *   Measure the time to send a message to a message queue and receive it
+ *   again in the same thread.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+int bench_mqueue(FAR struct bench_result_s *result)
+{
+  char msg[BENCH_MSGSIZE];
+  struct mq_attr attr;
+  uint64_t start;
+  mqd_t mqdes;
+  int batch;
+  int ret = OK;
+  int i;
+
+  attr.mq_maxmsg  = 4;
+  attr.mq_msgsize = BENCH_MSGSIZE;
+  attr.mq_flags   = 0;
+
+  mqdes = mq_open(BENCH_MQNAME, O_RDWR | O_CREAT, 0666, &attr);
+  if (mqdes == (mqd_t)ERROR)
+    {
+      ret = -get_errno();
+      serr("ERROR: mq_open failed: %d\n", ret);
+      return ret;
+    }
+
+  memset(msg, 0x5a, BENCH_MSGSIZE);
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          ret = nxmq_send(mqdes, msg, BENCH_MSGSIZE, 0);
+          if (ret >= 0)
+            {
+              ret = nxmq_receive(mqdes, msg, BENCH_MSGSIZE, NULL);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  (void)mq_close(mqdes);
+  (void)mq_unlink(BENCH_MQNAME);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_pipe
+ *
+ * Description:
+ *   Measure the time to write BENCH_PIPESIZE bytes to a pipe and read them
+ *   back in the same thread.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+int bench_pipe(FAR struct bench_result_s *result)
+{
+  char buffer[BENCH_PIPESIZE];
+  uint64_t start;
+  ssize_t nbytes = 0;
+  int fd[2];
+  int batch;
+  int ret;
+  int i;
+
+  ret = pipe2(fd, CONFIG_DEV_PIPE_SIZE);
+  if (ret < 0)
+    {
+      serr("ERROR: pipe2 failed: %d\n", ret);
+      return ret;
+    }
+
+  memset(buffer, 0x5a, BENCH_PIPESIZE);
+
+  for (batch = 0; batch < BENCH_NBATCHES && nbytes >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          nbytes = nx_write(fd[1], buffer, BENCH_PIPESIZE);
+          if (nbytes >= 0)
+            {
+              nbytes = nx_read(fd[0], buffer, BENCH_PIPESIZE);
+            }
+
+          if (nbytes < 0)
+            {
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  (void)close(fd[0]);
+  (void)close(fd[1]);
+  return nbytes < 0 ? (int)nbytes : OK;
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCH */
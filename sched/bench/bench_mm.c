@@ -0,0 +1,170 @@
+/****************************************************************************
+ * sched/bench/bench_mm.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "bench/bench.h"
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of the blocks of the malloc benchmark */
+
+#define BENCH_BLOCKSIZE 64
+
+/* The number of blocks that are held at once by the mallocmix benchmark
+ * and the largest block that it allocates.  BENCH_NSLOTS must be a power
+ * of two.
+ */
+
+#define BENCH_NSLOTS    16
+#define BENCH_MAXSIZE   1024
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_malloc
+ *
+ * Description:
+ *   Measure the time to allocate and free one small block.
+ *
+ ****************************************************************************/
+
+int bench_malloc(FAR struct bench_result_s *result)
+{
+  FAR void *mem;
+  uint64_t start;
+  int batch;
+  int i;
+
+  for (batch = 0; batch < BENCH_NBATCHES; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          mem = kmm_malloc(BENCH_BLOCKSIZE);
+          if (mem == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          kmm_free(mem);
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_mallocmix
+ *
+ * Description:
+ *   Measure the time to free and allocate one block while BENCH_NSLOTS
+ *   blocks of pseudo-random sizes are held.  This exercises the free list
+ *   search and coalescing more than bench_malloc().
+ *
+ ****************************************************************************/
+
+int bench_mallocmix(FAR struct bench_result_s *result)
+{
+  FAR void *slots[BENCH_NSLOTS];
+  uint32_t seed = 1;
+  uint64_t start;
+  int ret = OK;
+  int batch;
+  int slot;
+  int i;
+
+  memset(slots, 0, sizeof(slots));
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret == OK; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          /* A linear congruential generator is good enough to pick the
+           * slot and the size.
+           */
+
+          seed = seed * 1103515245 + 12345;
+          slot = (seed >> 16) & (BENCH_NSLOTS - 1);
+
+          if (slots[slot] != NULL)
+            {
+              kmm_free(slots[slot]);
+            }
+
+          slots[slot] = kmm_malloc(1 + ((seed >> 4) % BENCH_MAXSIZE));
+          if (slots[slot] == NULL)
+            {
+              ret = -ENOMEM;
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  for (slot = 0; slot < BENCH_NSLOTS; slot++)
+    {
+      if (slots[slot] != NULL)
+        {
+          kmm_free(slots[slot]);
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_BENCH */
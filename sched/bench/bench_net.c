@@ -0,0 +1,371 @@
+/****************************************************************************
+ * sched/bench/bench_net.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/net/net.h>
+
+#include "bench/bench.h"
+
+#if defined(CONFIG_SCHED_BENCH) && defined(BENCH_HAVE_NET)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of each transfer.  The times reported are per transfer, so the
+ * throughput in KiB/s is 10^9 / mean.
+ */
+
+#define BENCH_NETSIZE      1024
+#define BENCH_DGRAMSIZE    1024
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_netbuffer[BENCH_NETSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_sockaddr
+ ****************************************************************************/
+
+static void bench_sockaddr(FAR struct sockaddr_in *addr, in_addr_t ipaddr)
+{
+  memset(addr, 0, sizeof(struct sockaddr_in));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(CONFIG_SCHED_BENCH_NET_PORT);
+  addr->sin_addr.s_addr = ipaddr;
+}
+
+/****************************************************************************
+ * Name: bench_sendall and bench_recvall
+ ****************************************************************************/
+
+#if defined(BENCH_HAVE_TCP) || defined(CONFIG_SCHED_BENCH_NET_PEER)
+static int bench_sendall(FAR struct socket *psock, size_t len)
+{
+  ssize_t nsent;
+  size_t offset;
+
+  for (offset = 0; offset < len; offset += nsent)
+    {
+      nsent = psock_send(psock, &g_netbuffer[offset], len - offset, 0);
+      if (nsent <= 0)
+        {
+          return nsent < 0 ? (int)nsent : -ECONNRESET;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+#ifdef BENCH_HAVE_TCP
+static int bench_recvall(FAR struct socket *psock, size_t len)
+{
+  ssize_t nrecvd;
+  size_t offset;
+
+  for (offset = 0; offset < len; offset += nrecvd)
+    {
+      nrecvd = psock_recvfrom(psock, &g_netbuffer[offset], len - offset, 0,
+                              NULL, NULL);
+      if (nrecvd <= 0)
+        {
+          return nrecvd < 0 ? (int)nrecvd : -ECONNRESET;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_tcp
+ *
+ * Description:
+ *   Measure the time to send BENCH_NETSIZE bytes over a TCP connection on
+ *   the loopback device and receive them in the same thread.  The listening
+ *   socket's backlog completes the connection without a helper thread.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_TCP
+int bench_tcp(FAR struct bench_result_s *result)
+{
+  struct sockaddr_in addr;
+  struct socket listener;
+  struct socket client;
+  struct socket server;
+  uint64_t start;
+  int batch;
+  int ret;
+  int i;
+
+  bench_sockaddr(&addr, HTONL(INADDR_LOOPBACK));
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &listener);
+  if (ret < 0)
+    {
+      serr("ERROR: psock_socket failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = psock_bind(&listener, (FAR const struct sockaddr *)&addr,
+                   sizeof(struct sockaddr_in));
+  if (ret >= 0)
+    {
+      ret = psock_listen(&listener, 1);
+    }
+
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to listen: %d\n", ret);
+      goto errout_with_listener;
+    }
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &client);
+  if (ret < 0)
+    {
+      serr("ERROR: psock_socket failed: %d\n", ret);
+      goto errout_with_listener;
+    }
+
+  ret = psock_connect(&client, (FAR const struct sockaddr *)&addr,
+                      sizeof(struct sockaddr_in));
+  if (ret >= 0)
+    {
+      ret = psock_accept(&listener, NULL, NULL, &server);
+    }
+
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to connect: %d\n", ret);
+      goto errout_with_client;
+    }
+
+  memset(g_netbuffer, 0x5a, BENCH_NETSIZE);
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          ret = bench_sendall(&client, BENCH_NETSIZE);
+          if (ret >= 0)
+            {
+              ret = bench_recvall(&server, BENCH_NETSIZE);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  (void)psock_close(&server);
+
+errout_with_client:
+  (void)psock_close(&client);
+
+errout_with_listener:
+  (void)psock_close(&listener);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_udp
+ *
+ * Description:
+ *   Measure the time to send a BENCH_DGRAMSIZE byte datagram to a socket on
+ *   the loopback device and receive it in the same thread.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_HAVE_UDP
+int bench_udp(FAR struct bench_result_s *result)
+{
+  struct sockaddr_in addr;
+  struct socket sock;
+  uint64_t start;
+  ssize_t nbytes;
+  int batch;
+  int ret;
+  int i;
+
+  bench_sockaddr(&addr, HTONL(INADDR_LOOPBACK));
+
+  ret = psock_socket(PF_INET, SOCK_DGRAM, 0, &sock);
+  if (ret < 0)
+    {
+      serr("ERROR: psock_socket failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = psock_bind(&sock, (FAR const struct sockaddr *)&addr,
+                   sizeof(struct sockaddr_in));
+  if (ret < 0)
+    {
+      serr("ERROR: psock_bind failed: %d\n", ret);
+      goto errout;
+    }
+
+  memset(g_netbuffer, 0x5a, BENCH_DGRAMSIZE);
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          nbytes = psock_sendto(&sock, g_netbuffer, BENCH_DGRAMSIZE, 0,
+                                (FAR const struct sockaddr *)&addr,
+                                sizeof(struct sockaddr_in));
+          if (nbytes >= 0)
+            {
+              nbytes = psock_recvfrom(&sock, g_netbuffer, BENCH_DGRAMSIZE,
+                                      0, NULL, NULL);
+            }
+
+          if (nbytes < 0)
+            {
+              ret = (int)nbytes;
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+errout:
+  (void)psock_close(&sock);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_tcppeer
+ *
+ * Description:
+ *   Measure the time to stream BENCH_NETSIZE bytes to a TCP server on
+ *   another host, for example 'iperf -s' (iperf 2) on the host end of a TUN
+ *   or a simulator tap device.  The server must discard the data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BENCH_NET_PEER
+int bench_tcppeer(FAR struct bench_result_s *result)
+{
+  struct sockaddr_in addr;
+  struct socket sock;
+  uint64_t start;
+  int batch;
+  int ret;
+  int i;
+
+  bench_sockaddr(&addr, HTONL(CONFIG_SCHED_BENCH_NET_PEERADDR));
+
+  ret = psock_socket(PF_INET, SOCK_STREAM, 0, &sock);
+  if (ret < 0)
+    {
+      serr("ERROR: psock_socket failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = psock_connect(&sock, (FAR const struct sockaddr *)&addr,
+                      sizeof(struct sockaddr_in));
+  if (ret < 0)
+    {
+      serr("ERROR: psock_connect failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* A zeroed stream does not look like an iperf 2 test header, so the
+   * server simply counts the bytes received.
+   */
+
+  memset(g_netbuffer, 0, BENCH_NETSIZE);
+
+  for (batch = 0; batch < BENCH_NBATCHES && ret >= 0; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          ret = bench_sendall(&sock, BENCH_NETSIZE);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      bench_update(result, bench_gettime() - start,
+                   CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+errout:
+  (void)psock_close(&sock);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCH && BENCH_HAVE_NET */
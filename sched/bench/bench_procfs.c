@@ -0,0 +1,411 @@
+/****************************************************************************
+ * sched/bench/bench_procfs.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/version.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/bench.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_BENCH) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BENCH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BENCH_LINELEN   128
+
+/* The results buffer is grown in steps of this size */
+
+#define BENCH_BUFINCR   1024
+
+/* The board is reported with the version so that results from different
+ * releases and configurations can be told apart.
+ */
+
+#ifdef CONFIG_ARCH_BOARD_CUSTOM
+#  define BENCH_BOARD   "custom"
+#else
+#  define BENCH_BOARD   CONFIG_ARCH_BOARD
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The benchmark is run once
+ * when the file is opened; read() then returns the formatted results.
+ */
+
+struct benchprocfs_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  FAR char *results;                 /* Formatted benchmark results */
+  size_t alloc;                      /* Allocated size of results */
+  size_t len;                        /* Bytes used in results */
+  int ret;                           /* Result of the benchmark */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     benchprocfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     benchprocfs_close(FAR struct file *filep);
+static ssize_t benchprocfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     benchprocfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     benchprocfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See include/nutts/fs/procfs.h
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bench_procfsoperations =
+{
+  benchprocfs_open,    /* open */
+  benchprocfs_close,   /* close */
+  benchprocfs_read,    /* read */
+  NULL,                /* write */
+  benchprocfs_dup,     /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  benchprocfs_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: benchprocfs_append
+ *
+ * Description:
+ *   Append one line to the results buffer, growing it as needed.
+ *
+ ****************************************************************************/
+
+static int benchprocfs_append(FAR struct benchprocfs_file_s *priv,
+                              FAR const char *line, size_t linesize)
+{
+  FAR char *newbuf;
+
+  if (priv->len + linesize > priv->alloc)
+    {
+      newbuf = (FAR char *)kmm_realloc(priv->results,
+                                       priv->alloc + BENCH_BUFINCR);
+      if (newbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      priv->results = newbuf;
+      priv->alloc  += BENCH_BUFINCR;
+    }
+
+  memcpy(&priv->results[priv->len], line, linesize);
+  priv->len += linesize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchprocfs_callback
+ ****************************************************************************/
+
+static int benchprocfs_callback(FAR const struct bench_result_s *result,
+                                FAR void *arg)
+{
+  FAR struct benchprocfs_file_s *priv;
+  char line[BENCH_LINELEN];
+  size_t linesize;
+
+  DEBUGASSERT(result != NULL && arg != NULL);
+  priv = (FAR struct benchprocfs_file_s *)arg;
+
+  if (result->br_result < 0)
+    {
+      linesize = snprintf(line, BENCH_LINELEN, "%-10s error %d\n",
+                          result->br_name, result->br_result);
+    }
+  else
+    {
+      linesize = snprintf(line, BENCH_LINELEN,
+                          "%-10s %8lu %10lu %10lu %10lu\n",
+                          result->br_name,
+                          (unsigned long)result->br_count,
+                          (unsigned long)result->br_min,
+                          (unsigned long)result->br_mean,
+                          (unsigned long)result->br_max);
+    }
+
+  if (linesize >= BENCH_LINELEN)
+    {
+      linesize = BENCH_LINELEN - 1;
+    }
+
+  return benchprocfs_append(priv, line, linesize);
+}
+
+/****************************************************************************
+ * Name: benchprocfs_open
+ ****************************************************************************/
+
+static int benchprocfs_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, mode_t mode)
+{
+  FAR struct benchprocfs_file_s *priv;
+  char header[BENCH_LINELEN];
+  size_t headersize;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if (((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0))
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate the open file structure */
+
+  priv = (FAR struct benchprocfs_file_s *)
+    kmm_zalloc(sizeof(struct benchprocfs_file_s));
+  if (!priv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Run the benchmark now so that the results do not change between
+   * successive reads.
+   */
+
+  headersize = snprintf(header, BENCH_LINELEN,
+                        "# NuttX %s %s\n%-10s %8s %10s %10s %10s\n",
+                        CONFIG_VERSION_STRING, BENCH_BOARD, "BENCH",
+                        "COUNT", "MIN(ns)", "MEAN(ns)", "MAX(ns)");
+  if (headersize >= BENCH_LINELEN)
+    {
+      headersize = BENCH_LINELEN - 1;
+    }
+
+  priv->ret = benchprocfs_append(priv, header, headersize);
+  if (priv->ret >= 0)
+    {
+      priv->ret = sched_benchmark(benchprocfs_callback, priv);
+    }
+
+  if (priv->ret < 0)
+    {
+      ferr("ERROR: sched_benchmark failed: %d\n", priv->ret);
+    }
+
+  /* Save the open file structure as the open-specific state in
+   * filep->f_priv.
+   */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchprocfs_close
+ ****************************************************************************/
+
+static int benchprocfs_close(FAR struct file *filep)
+{
+  FAR struct benchprocfs_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct benchprocfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the results and the file attributes structure */
+
+  if (priv->results != NULL)
+    {
+      kmm_free(priv->results);
+    }
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchprocfs_read
+ ****************************************************************************/
+
+static ssize_t benchprocfs_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct benchprocfs_file_s *priv;
+  off_t offset;
+  size_t copysize;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct benchprocfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  if (priv->ret < 0)
+    {
+      return priv->ret;
+    }
+
+  offset   = filep->f_pos;
+  copysize = procfs_memcpy(priv->results, priv->len, buffer, buflen,
+                           &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: benchprocfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int benchprocfs_dup(FAR const struct file *oldp,
+                           FAR struct file *newp)
+{
+  FAR struct benchprocfs_file_s *oldpriv;
+  FAR struct benchprocfs_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct benchprocfs_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the results */
+
+  newpriv = (FAR struct benchprocfs_file_s *)
+    kmm_zalloc(sizeof(struct benchprocfs_file_s));
+  if (!newpriv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes and the results from the old file */
+
+  memcpy(newpriv, oldpriv, sizeof(struct benchprocfs_file_s));
+
+  if (oldpriv->results != NULL)
+    {
+      newpriv->results = (FAR char *)kmm_malloc(oldpriv->alloc);
+      if (newpriv->results == NULL)
+        {
+          kmm_free(newpriv);
+          return -ENOMEM;
+        }
+
+      memcpy(newpriv->results, oldpriv->results, oldpriv->len);
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: benchprocfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int benchprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BENCH && !CONFIG_FS_PROCFS_EXCLUDE_BENCH */
@@ -0,0 +1,239 @@
+/****************************************************************************
+ * sched/bench/bench_sched.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+
+#include "bench/bench.h"
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NOPS (BENCH_NBATCHES * CONFIG_SCHED_BENCH_ITERATIONS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static volatile bool g_yielddone;
+static sem_t g_ping;
+static sem_t g_pong;
+static sem_t g_exit;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_yielder
+ *
+ * Description:
+ *   Yield back to the benchmark thread until it is finished.
+ *
+ ****************************************************************************/
+
+static int bench_yielder(int argc, FAR char *argv[])
+{
+  while (!g_yielddone)
+    {
+      sched_yield();
+    }
+
+  nxsem_post(&g_exit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_ponger
+ *
+ * Description:
+ *   Answer each post of g_ping with a post of g_pong.
+ *
+ ****************************************************************************/
+
+static int bench_ponger(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (i = 0; i < BENCH_NOPS; i++)
+    {
+      if (nxsem_wait_uninterruptible(&g_ping) < 0)
+        {
+          break;
+        }
+
+      nxsem_post(&g_pong);
+    }
+
+  nxsem_post(&g_exit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_initsem
+ ****************************************************************************/
+
+static void bench_initsem(FAR sem_t *sem)
+{
+  /* These semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(sem, 0, 0);
+  nxsem_setprotocol(sem, SEM_PRIO_NONE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_yield
+ *
+ * Description:
+ *   Measure the context switch time.  The benchmark thread and a helper
+ *   thread of the same priority call sched_yield() in turns so that each
+ *   call switches to the other thread.
+ *
+ ****************************************************************************/
+
+int bench_yield(FAR struct bench_result_s *result)
+{
+  uint64_t start;
+  int batch;
+  int ret;
+  int i;
+
+  g_yielddone = false;
+  bench_initsem(&g_exit);
+
+  ret = bench_thread("bench_yield", bench_yielder);
+  if (ret < 0)
+    {
+      nxsem_destroy(&g_exit);
+      return ret;
+    }
+
+  /* Let the helper thread start */
+
+  sched_yield();
+
+  for (batch = 0; batch < BENCH_NBATCHES; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          sched_yield();
+        }
+
+      /* There are two context switches for each iteration */
+
+      bench_update(result, bench_gettime() - start,
+                   2 * CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  g_yielddone = true;
+  (void)nxsem_wait_uninterruptible(&g_exit);
+  nxsem_destroy(&g_exit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_sem
+ *
+ * Description:
+ *   Measure the time to wake up a thread waiting on a semaphore.  The
+ *   benchmark thread posts one semaphore and waits on a second that is
+ *   posted by the thread that was waiting on the first.
+ *
+ ****************************************************************************/
+
+int bench_sem(FAR struct bench_result_s *result)
+{
+  uint64_t start;
+  int batch;
+  int ret;
+  int i;
+
+  bench_initsem(&g_ping);
+  bench_initsem(&g_pong);
+  bench_initsem(&g_exit);
+
+  ret = bench_thread("bench_sem", bench_ponger);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  for (batch = 0; batch < BENCH_NBATCHES; batch++)
+    {
+      start = bench_gettime();
+      for (i = 0; i < CONFIG_SCHED_BENCH_ITERATIONS; i++)
+        {
+          nxsem_post(&g_ping);
+          (void)nxsem_wait_uninterruptible(&g_pong);
+        }
+
+      /* There are two hand-offs for each iteration */
+
+      bench_update(result, bench_gettime() - start,
+                   2 * CONFIG_SCHED_BENCH_ITERATIONS);
+    }
+
+  (void)nxsem_wait_uninterruptible(&g_exit);
+  ret = OK;
+
+errout:
+  nxsem_destroy(&g_exit);
+  nxsem_destroy(&g_pong);
+  nxsem_destroy(&g_ping);
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_BENCH */
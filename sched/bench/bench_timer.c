@@ -0,0 +1,302 @@
+/****************************************************************************
+ * sched/bench/bench_timer.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/timers/hrtimer.h>
+
+#include "bench/bench.h"
+
+#ifdef CONFIG_SCHED_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The work queue used by the work benchmark */
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define BENCH_WORK      HPWORK
+#else
+#  define BENCH_WORK      LPWORK
+#endif
+
+/* The period of the high resolution timer in nanoseconds */
+
+#define BENCH_HRPERIOD    100000
+
+/* How long to wait for the samples of a timer benchmark */
+
+#define BENCH_TIMEOUT     (2 * CONFIG_SCHED_BENCH_SAMPLES + SEC2TICK(1))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_timerdone;
+static volatile uint64_t g_timerstamp;
+static volatile int g_timersamples;
+static WDOG_ID g_benchwdog;
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static struct work_s g_benchwork;
+#endif
+
+#ifdef CONFIG_HRTIMER
+static struct hrtimer_s g_benchhrtimer;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_inittimer
+ ****************************************************************************/
+
+static void bench_inittimer(void)
+{
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&g_timerdone, 0, 0);
+  nxsem_setprotocol(&g_timerdone, SEM_PRIO_NONE);
+  g_timersamples = 0;
+}
+
+/****************************************************************************
+ * Name: bench_worker
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void bench_worker(FAR void *arg)
+{
+  g_timerstamp = bench_gettime();
+  nxsem_post(&g_timerdone);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdentry
+ *
+ * Description:
+ *   The watchdog timer handler.  Measures the interval since the previous
+ *   expiration and restarts the watchdog for one more tick.
+ *
+ ****************************************************************************/
+
+static void bench_wdentry(int argc, wdparm_t arg1, ...)
+{
+  FAR struct bench_result_s *result =
+    (FAR struct bench_result_s *)((uintptr_t)arg1);
+  uint64_t now = bench_gettime();
+
+  /* The first expiration only provides the start time */
+
+  if (g_timersamples > 0)
+    {
+      bench_update(result, now - g_timerstamp, 1);
+    }
+
+  g_timerstamp = now;
+
+  if (g_timersamples++ < CONFIG_SCHED_BENCH_SAMPLES)
+    {
+      (void)wd_start(g_benchwdog, 1, bench_wdentry, 1, arg1);
+    }
+  else
+    {
+      nxsem_post(&g_timerdone);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_hrentry
+ *
+ * Description:
+ *   The high resolution timer handler.  Measures the delay from the
+ *   requested expiration time until the handler runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t bench_hrentry(FAR struct hrtimer_s *timer)
+{
+  FAR struct bench_result_s *result =
+    (FAR struct bench_result_s *)timer->arg;
+
+  bench_update(result, hrtimer_now() - timer->expire, 1);
+
+  if (++g_timersamples < CONFIG_SCHED_BENCH_SAMPLES)
+    {
+      return BENCH_HRPERIOD;
+    }
+
+  nxsem_post(&g_timerdone);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_work
+ *
+ * Description:
+ *   Measure the time from queuing work with no delay until the work runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int bench_work(FAR struct bench_result_s *result)
+{
+  uint64_t start;
+  int ret = OK;
+  int i;
+
+  bench_inittimer();
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_SAMPLES; i++)
+    {
+      start = bench_gettime();
+      ret = work_queue(BENCH_WORK, &g_benchwork, bench_worker, NULL, 0);
+      if (ret >= 0)
+        {
+          ret = nxsem_tickwait(&g_timerdone, clock_systimer(),
+                               SEC2TICK(1));
+        }
+
+      if (ret < 0)
+        {
+          (void)work_cancel(BENCH_WORK, &g_benchwork);
+          break;
+        }
+
+      bench_update(result, g_timerstamp - start, 1);
+    }
+
+  nxsem_destroy(&g_timerdone);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   Measure the intervals between the expirations of a watchdog timer that
+ *   is restarted for one tick each time that it expires.  The ideal is
+ *   USEC_PER_TICK; the spread from min to max is the timer jitter.
+ *
+ ****************************************************************************/
+
+int bench_wdog(FAR struct bench_result_s *result)
+{
+  int ret;
+
+  g_benchwdog = wd_create();
+  if (g_benchwdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  bench_inittimer();
+
+  ret = wd_start(g_benchwdog, 1, bench_wdentry, 1,
+                 (wdparm_t)((uintptr_t)result));
+  if (ret >= 0)
+    {
+      ret = nxsem_tickwait(&g_timerdone, clock_systimer(), BENCH_TIMEOUT);
+    }
+
+  (void)wd_delete(g_benchwdog);
+  g_benchwdog = NULL;
+  nxsem_destroy(&g_timerdone);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: bench_hrtimer
+ *
+ * Description:
+ *   Measure the timer interrupt latency:  The delay from the expiration
+ *   time of a high resolution timer until its handler runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+int bench_hrtimer(FAR struct bench_result_s *result)
+{
+  int ret;
+
+  /* The board logic may not have provided the timer */
+
+  if (hrtimer_now() == 0)
+    {
+      return -ENODEV;
+    }
+
+  bench_inittimer();
+  hrtimer_init(&g_benchhrtimer, bench_hrentry, result);
+
+  ret = hrtimer_start(&g_benchhrtimer, BENCH_HRPERIOD, 0, HRTIMER_MODE_REL);
+  if (ret >= 0)
+    {
+      ret = nxsem_tickwait(&g_timerdone, clock_systimer(), BENCH_TIMEOUT);
+    }
+
+  (void)hrtimer_cancel(&g_benchhrtimer);
+  nxsem_destroy(&g_timerdone);
+  return ret < 0 ? ret : OK;
+}
+#endif
+
+#endif /* CONFIG_SCHED_BENCH */
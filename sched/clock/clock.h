@@ -93,6 +93,9 @@ void weak_function clock_initialize(void);
 #ifndef CONFIG_SCHED_TICKLESS
 void weak_function clock_timer(void);
 #endif
+#ifdef CONFIG_CLOCK_USERTIME
+void clock_usertime_update(void);
+#endif
 
 int  clock_abstime2ticks(clockid_t clockid,
                          FAR const struct timespec *abstime,
@@ -190,6 +190,12 @@ static void clock_inittime(void)
       g_basetime.tv_nsec += NSEC_PER_SEC;
       g_basetime.tv_sec--;
     }
+
+#ifdef CONFIG_CLOCK_USERTIME
+  /* Update the user-space copy of the clock */
+
+  clock_usertime_update();
+#endif
 #else
   clock_inittimekeeping();
 #endif
@@ -391,6 +397,10 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
 
       g_system_timer += SEC2TICK(rtc_diff->tv_sec);
       g_system_timer += NSEC2TICK(rtc_diff->tv_nsec);
+
+#ifdef CONFIG_CLOCK_USERTIME
+      clock_usertime_update();
+#endif
     }
 
 skip:
@@ -414,5 +424,11 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+#ifdef CONFIG_CLOCK_USERTIME
+  /* Update the user-space copy of the clock */
+
+  clock_usertime_update();
+#endif
 }
 #endif
@@ -122,6 +122,12 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
           up_rtc_settime(tp);
         }
 #endif
+
+#ifdef CONFIG_CLOCK_USERTIME
+      /* Update the user-space copy of the clock */
+
+      clock_usertime_update();
+#endif
       leave_critical_section(flags);
 
       sinfo("basetime=(%ld,%lu) bias=(%ld,%lu)\n",
@@ -0,0 +1,183 @@
+/****************************************************************************
+ * sched/environ/env_addvar.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifndef CONFIG_DISABLE_ENVIRON
+
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_grow
+ *
+ * Description:
+ *   Double the number of hash chains.  If memory for the larger table
+ *   cannot be allocated, then the environment keeps working with the
+ *   longer chains.
+ *
+ ****************************************************************************/
+
+static void env_grow(FAR struct env_s *env)
+{
+  FAR struct env_var_s **hash;
+  FAR dq_entry_t *node;
+  unsigned int nbuckets;
+
+  nbuckets = env->nbuckets << 1;
+  hash = (FAR struct env_var_s **)
+    kumm_zalloc(nbuckets * sizeof(FAR struct env_var_s *));
+  if (hash == NULL)
+    {
+      return;
+    }
+
+  /* Rehash all of the variables */
+
+  for (node = dq_peek(&env->vars); node != NULL; node = dq_next(node))
+    {
+      FAR struct env_var_s *var = (FAR struct env_var_s *)node;
+      unsigned int ndx = var->hash & (nbuckets - 1);
+
+      var->hnext = hash[ndx];
+      hash[ndx]  = var;
+    }
+
+  kumm_free(env->hash);
+  env->hash     = hash;
+  env->nbuckets = nbuckets;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_addvar
+ *
+ * Description:
+ *   Add a variable to the environment, replacing any variable of the same
+ *   name.
+ *
+ * Input Parameters:
+ *   group - The task group with the environment to be modified
+ *   name  - The variable name
+ *   value - The value of the variable
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if memory could not be allocated.  The
+ *   environment is unchanged on failure.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *   - The environment belongs to the group alone (see env_unshare())
+ *
+ ****************************************************************************/
+
+int env_addvar(FAR struct task_group_s *group, FAR const char *name,
+               FAR const char *value)
+{
+  FAR struct env_s *env;
+  FAR struct env_var_s *var;
+  FAR struct env_var_s *old;
+  unsigned int ndx;
+  size_t namelen;
+  size_t valuelen;
+
+  DEBUGASSERT(group != NULL && group->tg_env != NULL);
+
+  env = group->tg_env;
+  DEBUGASSERT(env->crefs == 1);
+
+  /* Allocate the new variable before touching the old one so that the
+   * environment is unchanged if this fails.
+   */
+
+  namelen  = strlen(name);
+  valuelen = strlen(value);
+
+  var = (FAR struct env_var_s *)
+    kumm_malloc(SIZEOF_ENV_VAR_S(namelen + valuelen + 2));
+  if (var == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(var->pair, name, namelen);
+  var->pair[namelen] = '=';
+  memcpy(&var->pair[namelen + 1], value, valuelen + 1);
+  var->hash = env_hash(name);
+
+  /* Replace any variable of the same name */
+
+  old = env_findvar(group, name);
+  if (old != NULL)
+    {
+      env_removevar(group, old);
+    }
+
+  /* Keep the chains short */
+
+  if (env->nvars >= env->nbuckets && env->nbuckets < ENV_NBUCKETS_MAX)
+    {
+      env_grow(env);
+    }
+
+  ndx            = var->hash & (env->nbuckets - 1);
+  var->hnext     = env->hash[ndx];
+  env->hash[ndx] = var;
+
+  dq_addlast(&var->node, &env->vars);
+  env->nvars++;
+  return OK;
+}
+
+#endif /* CONFIG_DISABLE_ENVIRON */
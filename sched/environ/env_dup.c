@@ -44,6 +44,7 @@
 #include <sys/types.h>
 #include <sched.h>
 #include <string.h>
+#include <queue.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -51,6 +52,41 @@
 #include "sched/sched.h"
 #include "environ/environ.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_alloc
+ *
+ * Description:
+ *   Allocate an empty environment with the given number of hash chains.
+ *
+ ****************************************************************************/
+
+static FAR struct env_s *env_alloc(unsigned int nbuckets)
+{
+  FAR struct env_s *env;
+
+  env = (FAR struct env_s *)kumm_zalloc(sizeof(struct env_s));
+  if (env != NULL)
+    {
+      env->hash = (FAR struct env_var_s **)
+        kumm_zalloc(nbuckets * sizeof(FAR struct env_var_s *));
+      if (env->hash == NULL)
+        {
+          kumm_free(env);
+          return NULL;
+        }
+
+      env->crefs    = 1;
+      env->nbuckets = nbuckets;
+      dq_init(&env->vars);
+    }
+
+  return env;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,13 +95,13 @@
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Give a new task group the environment of the parent task.  The
+ *   environment is shared until either group changes it (see
+ *   env_unshare()).
  *
  * Input Parameters:
- *   group - The child task group to receive the newly allocated copy of the
- *           parent task groups environment structure.
+ *   group - The child task group to receive the parent task group's
+ *           environment.
  *
  * Returned Value:
  *   zero on success
@@ -78,9 +114,6 @@
 int env_dup(FAR struct task_group_s *group)
 {
   FAR struct tcb_s *ptcb = this_task();
-  FAR char *envp = NULL;
-  size_t envlen;
-  int ret = OK;
 
   DEBUGASSERT(group != NULL && ptcb != NULL && ptcb->group != NULL);
 
@@ -92,51 +125,98 @@ int env_dup(FAR struct task_group_s *group)
 
   /* Does the parent task have an environment? */
 
-  if (ptcb->group != NULL && ptcb->group->tg_envp != NULL)
+  if (ptcb->group != NULL && ptcb->group->tg_env != NULL)
     {
-      /* Yes.. The parent task has an environment allocation. */
+      /* Yes.. Share it.  Nothing is copied unless one of the groups
+       * modifies the environment later.
+       */
+
+      group->tg_env = ptcb->group->tg_env;
+      group->tg_env->crefs++;
+    }
 
-      envlen = ptcb->group->tg_envsize;
-      envp   = NULL;
+  sched_unlock();
+  return OK;
+}
 
-      /* A special case is that the parent has an "empty" environment
-       * allocation, i.e., there is an allocation in place but it
-       * contains no variable definitions and, hence, envlen == 0.
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the task group has an environment of its own that it
+ *   may modify:  Create an empty environment if it has none and copy the
+ *   environment if it is shared with another group.
+ *
+ * Input Parameters:
+ *   group - The task group that is about to modify its environment.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if memory could not be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR struct env_s *oldenv = group->tg_env;
+  FAR struct env_s *newenv;
+  FAR dq_entry_t *node;
+
+  if (oldenv != NULL && oldenv->crefs <= 1)
+    {
+      /* The environment already belongs to this group alone */
+
+      return OK;
+    }
+
+  newenv = env_alloc(oldenv != NULL ? oldenv->nbuckets : ENV_NBUCKETS_MIN);
+  if (newenv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (oldenv != NULL)
+    {
+      /* Copy each variable, keeping the order of definition.  The hash
+       * chains have the same size so the hash values can be reused.
        */
 
-      if (envlen > 0)
+      for (node = dq_peek(&oldenv->vars); node != NULL; node = dq_next(node))
         {
-          /* There is an environment, duplicate it */
+          FAR struct env_var_s *var = (FAR struct env_var_s *)node;
+          FAR struct env_var_s *copy;
+          size_t size = SIZEOF_ENV_VAR_S(strlen(var->pair) + 1);
+          unsigned int ndx;
 
-          envp = (FAR char *)kumm_malloc(envlen);
-          if (envp == NULL)
+          copy = (FAR struct env_var_s *)kumm_malloc(size);
+          if (copy == NULL)
             {
-              /* The parent's environment can not be inherited due to a
-               * failure in the allocation of the child environment.
-               */
-
-              envlen = 0;
-              ret    = -ENOMEM;
+              group->tg_env = newenv;
+              env_release(group);
+              group->tg_env = oldenv;
+              return -ENOMEM;
             }
-          else
-            {
-             /* Duplicate the parent environment. */
 
-              memcpy(envp, ptcb->group->tg_envp, envlen);
-            }
+          memcpy(copy, var, size);
+
+          ndx               = copy->hash & (newenv->nbuckets - 1);
+          copy->hnext       = newenv->hash[ndx];
+          newenv->hash[ndx] = copy;
+
+          dq_addlast(&copy->node, &newenv->vars);
+          newenv->nvars++;
         }
 
-      /* Save the size and child environment allocation. */
+      /* Stop sharing the old environment */
 
-      group->tg_envsize = envlen;
-      group->tg_envp    = envp;
+      oldenv->crefs--;
     }
 
-  sched_unlock();
-  return ret;
+  group->tg_env = newenv;
+  return OK;
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
-
-
-
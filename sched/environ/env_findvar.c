@@ -42,6 +42,7 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <sched.h>
 
@@ -77,6 +78,27 @@ static bool env_cmpname(const char *pszname, const char *peqname)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: env_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a variable name.
+ *
+ ****************************************************************************/
+
+uint32_t env_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  for (; *name != '\0' && *name != '='; name++)
+    {
+      hash ^= (uint8_t)*name;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
 /****************************************************************************
  * Name: env_findvar
  *
@@ -89,7 +111,7 @@ static bool env_cmpname(const char *pszname, const char *peqname)
  *   pname - The variable name to find
  *
  * Returned Value:
- *   A pointer to the name=value string in the environment
+ *   The variable or NULL if there is no variable of that name.
  *
  * Assumptions:
  *   - Not called from an interrupt handler
@@ -97,25 +119,37 @@ static bool env_cmpname(const char *pszname, const char *peqname)
  *
  ****************************************************************************/
 
-FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname)
+FAR struct env_var_s *env_findvar(FAR struct task_group_s *group,
+                                  FAR const char *pname)
 {
-  FAR char *ptr;
-  FAR char *end;
+  FAR struct env_s *env;
+  FAR struct env_var_s *var;
+  uint32_t hash;
 
   /* Verify input parameters */
 
   DEBUGASSERT(group != NULL && pname != NULL);
 
-  /* Search for a name=value string with matching name */
+  env = group->tg_env;
+  if (env == NULL)
+    {
+      return NULL;
+    }
 
-  end = &group->tg_envp[group->tg_envsize];
-  for (ptr = group->tg_envp;
-       ptr < end && !env_cmpname(pname, ptr);
-       ptr += (strlen(ptr) + 1));
+  /* Search the hash chain for a name=value string with matching name */
 
-  /* Check for success */
+  hash = env_hash(pname);
+  for (var = env->hash[hash & (env->nbuckets - 1)];
+       var != NULL;
+       var = var->hnext)
+    {
+      if (var->hash == hash && env_cmpname(pname, var->pair))
+        {
+          return var;
+        }
+    }
 
-  return (ptr < end) ? ptr : NULL;
+  return NULL;
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
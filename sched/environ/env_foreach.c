@@ -44,6 +44,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <sched.h>
+#include <queue.h>
 
 #include <nuttx/environ.h>
 
@@ -77,22 +78,27 @@
 
 int env_foreach(FAR struct task_group_s *group, env_foreach_t cb, FAR void *arg)
 {
-  FAR char *ptr;
-  FAR char *end;
+  FAR dq_entry_t *node;
   int ret = OK;
 
   /* Verify input parameters */
 
   DEBUGASSERT(group != NULL && cb != NULL);
 
-  /* Search for a name=value string with matching name */
+  if (group->tg_env == NULL)
+    {
+      return OK;
+    }
+
+  /* Visit each name=value string in the order of definition */
 
-  end = &group->tg_envp[group->tg_envsize];
-  for (ptr = group->tg_envp; ptr < end; ptr += (strlen(ptr) + 1))
+  for (node = dq_peek(&group->tg_env->vars);
+       node != NULL;
+       node = dq_next(node))
     {
       /* Perform the callback */
 
-      ret = cb(arg, ptr);
+      ret = cb(arg, ((FAR struct env_var_s *)node)->pair);
 
       /* Terminate the traversal early if the callback so requests by
        * returning a non-zero value.
@@ -75,7 +75,7 @@ FAR char *getenv(FAR const char *name)
 {
   FAR struct tcb_s *rtcb;
   FAR struct task_group_s *group;
-  FAR char *pvar;
+  FAR struct env_var_s *pvar;
   FAR char *pvalue = NULL;
   int ret = OK;
 
@@ -103,7 +103,7 @@ FAR char *getenv(FAR const char *name)
 
   /* It does!  Get the value sub-string from the name=value string */
 
-  pvalue = strchr(pvar, '=');
+  pvalue = strchr(pvar->pair, '=');
   if (!pvalue)
     {
       /* The name=value string has no '='  This is a bug! */
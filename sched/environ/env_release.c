@@ -42,10 +42,12 @@
 #ifndef CONFIG_DISABLE_ENVIRON
 
 #include <sched.h>
+#include <queue.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
 
+#include "sched/sched.h"
 #include "environ/environ.h"
 
 /****************************************************************************
@@ -56,10 +58,10 @@
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of a
+ *   task group exits and from clearenv().  The task group gives up its
+ *   reference to the environment.  The name-value pairs are freed when no
+ *   other task group shares them.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
@@ -75,26 +77,33 @@
 
 void env_release(FAR struct task_group_s *group)
 {
+  FAR struct env_s *env;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+
   DEBUGASSERT(group != NULL);
 
-  /* Free any allocate environment strings */
+  /* The environment may be shared with other task groups */
+
+  sched_lock();
+  env = group->tg_env;
+  group->tg_env = NULL;
 
-  if (group->tg_envp)
+  if (env != NULL && --env->crefs == 0)
     {
-      /* Free the environment */
+      /* This was the last reference.  Free all of the variables */
 
-      sched_ufree(group->tg_envp);
-    }
+      for (node = dq_peek(&env->vars); node != NULL; node = next)
+        {
+          next = dq_next(node);
+          sched_ufree(node);
+        }
 
-  /* In any event, make sure that all environment-related varialbles in the
-   * task group structure are reset to initial values.
-   */
+      sched_ufree(env->hash);
+      sched_ufree(env);
+    }
 
-  group->tg_envsize = 0;
-  group->tg_envp = NULL;
+  sched_unlock();
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
-
-
-
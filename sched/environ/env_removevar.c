@@ -43,6 +43,9 @@
 
 #include <string.h>
 #include <sched.h>
+#include <queue.h>
+
+#include <nuttx/kmalloc.h>
 
 #include "environ/environ.h"
 
@@ -54,67 +57,52 @@
  * Name: env_removevar
  *
  * Description:
- *   Remove the referenced name=value pair from the environment
+ *   Remove the variable from the environment and free it
  *
  * Input Parameters:
- *   group - The task group with the environment containing the name=value
- *           pair
- *   pvar  - A pointer to the name=value pair in the restroom
+ *   group - The task group with the environment containing the variable
+ *   var   - The variable to be removed
  *
  * Returned Value:
- *   Zero on success
+ *   None
  *
  * Assumptions:
  *   - Not called from an interrupt handler
  *   - Caller has pre-emption disabled
- *   - Caller will reallocate the environment structure to the correct size
+ *   - The environment belongs to the group alone (see env_unshare())
  *
  ****************************************************************************/
 
-int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
+void env_removevar(FAR struct task_group_s *group,
+                   FAR struct env_var_s *var)
 {
-  FAR char *end;    /* Pointer to the end+1 of the environment */
-  int alloc;        /* Size of the allocated environment */
-  int ret = ERROR;
+  FAR struct env_s *env;
+  FAR struct env_var_s **prev;
 
-  DEBUGASSERT(group != NULL && pvar != NULL);
+  DEBUGASSERT(group != NULL && group->tg_env != NULL && var != NULL);
 
-  /* Verify that the pointer lies within the environment region */
+  env = group->tg_env;
+  DEBUGASSERT(env->crefs == 1);
 
-  alloc = group->tg_envsize;             /* Size of the allocated environment */
-  end   = &group->tg_envp[alloc];        /* Pointer to the end+1 of the environment */
+  /* Remove the variable from its hash chain */
 
-  if (pvar >= group->tg_envp && pvar < end)
+  for (prev = &env->hash[var->hash & (env->nbuckets - 1)];
+       *prev != NULL;
+       prev = &(*prev)->hnext)
     {
-      /* Set up for the removal */
-
-      int len        = strlen(pvar) + 1; /* Length of name=value string to remove */
-      FAR char *src  = &pvar[len];       /* Address of name=value string after */
-      FAR char *dest = pvar;             /* Location to move the next string */
-      int count      = end - src;        /* Number of bytes to move (might be zero) */
-
-      /* Move all of the environment strings after the removed one 'down.'
-       * this is inefficient, but robably not high duty.
-       */
-
-      while (count-- > 0)
+      if (*prev == var)
         {
-          *dest++ = *src++;
+          *prev = var->hnext;
+          break;
         }
+    }
 
-      /* Then set to the new allocation size.  The caller is expected to
-       * call realloc at some point but we don't do that here because the
-       * caller may add more stuff to the environment.
-       */
+  /* And from the list of all variables */
 
-      group->tg_envsize -= len;
-      ret = OK;
-    }
+  dq_rem(&var->node, &env->vars);
+  env->nvars--;
 
-  return ret;
+  kumm_free(var);
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
-
-
-
@@ -83,10 +83,6 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 {
   FAR struct tcb_s *rtcb;
   FAR struct task_group_s *group;
-  FAR char *pvar;
-  FAR char *newenvp;
-  int newsize;
-  int varlen;
   int ret = OK;
 
   /* Verify input parameter */
@@ -124,69 +120,36 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   group = rtcb->group;
   DEBUGASSERT(group);
 
-  /* Check if the variable already exists */
+  /* Check if the variable already exists.  If it does, do we have
+   * permission to overwrite the existing value?
+   */
 
-  if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL)
+  if (!overwrite && env_findvar(group, name) != NULL)
     {
-      /* It does! Do we have permission to overwrite the existing value? */
-
-      if (!overwrite)
-        {
-          /* No.. then just return success */
+      /* No.. then just return success */
 
-          sched_unlock();
-          return OK;
-        }
-
-      /* Yes.. just remove the name=value pair from the environment.  It will
-       * be added again below.  Note that we are responsible for reallocating
-       * the environment buffer; this will happen below.
-       */
-
-      (void)env_removevar(group, pvar);
+      sched_unlock();
+      return OK;
     }
 
-  /* Get the size of the new name=value string.  The +2 is for the '=' and for
-   * null terminator
+  /* Get an environment that may be modified.  If the environment is shared
+   * with other task groups, this is where it is copied.
    */
 
-  varlen = strlen(name) + strlen(value) + 2;
-
-  /* Then allocate or reallocate the environment buffer */
-
-  if (group->tg_envp)
+  ret = env_unshare(group);
+  if (ret >= 0)
     {
-      newsize = group->tg_envsize + varlen;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-      if (!newenvp)
-        {
-          ret = ENOMEM;
-          goto errout_with_lock;
-        }
+      /* Add the name=value string, replacing any old value */
 
-      pvar = &newenvp[group->tg_envsize];
+      ret = env_addvar(group, name, value);
     }
-  else
-    {
-      newsize = varlen;
-      newenvp = (FAR char *)kumm_malloc(varlen);
-      if (!newenvp)
-        {
-          ret = ENOMEM;
-          goto errout_with_lock;
-        }
 
-      pvar = newenvp;
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout_with_lock;
     }
 
-  /* Save the new buffer and size */
-
-  group->tg_envp    = newenvp;
-  group->tg_envsize = newsize;
-
-  /* Now, put the new name=value string into the environment buffer */
-
-  sprintf(pvar, "%s=%s", name, value);
   sched_unlock();
   return OK;
 
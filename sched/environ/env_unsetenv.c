@@ -76,9 +76,7 @@ int unsetenv(FAR const char *name)
 {
   FAR struct tcb_s *rtcb = this_task();
   FAR struct task_group_s *group = rtcb->group;
-  FAR char *pvar;
-  FAR char *newenvp;
-  int newsize;
+  FAR struct env_var_s *pvar;
   int ret = OK;
 
   DEBUGASSERT(name && group);
@@ -86,44 +84,31 @@ int unsetenv(FAR const char *name)
   /* Check if the variable exists */
 
   sched_lock();
-  if (group && (pvar = env_findvar(group, name)) != NULL)
+  if (group && env_findvar(group, name) != NULL)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+      /* It does!  Get an environment that may be modified.  If the
+       * environment is shared with other task groups, it is copied here.
+       */
 
-      (void)env_removevar(group, pvar);
-
-      /* Reallocate the new environment buffer */
-
-      newsize = group->tg_envsize;
-      if (newsize <= 0)
+      if (env_unshare(group) < 0)
         {
-          /* Free the old environment (if there was one) */
-
-          if (group->tg_envp != NULL)
-            {
-              kumm_free(group->tg_envp);
-              group->tg_envp = NULL;
-            }
-
-          group->tg_envsize = 0;
+          set_errno(ENOMEM);
+          ret = ERROR;
         }
       else
         {
-          /* Reallocate the environment to reclaim a little memory */
+          /* Remove the name=value pair from the (copied) environment */
 
-          newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-          if (newenvp == NULL)
-            {
-              set_errno(ENOMEM);
-              ret = ERROR;
-            }
-          else
-            {
-              /* Save the new environment pointer (it might have changed due
-               * to reallocation).
-               */
+          pvar = env_findvar(group, name);
+          DEBUGASSERT(pvar != NULL);
 
-              group->tg_envp = newenvp;
+          env_removevar(group, pvar);
+
+          /* Free the environment when the last variable is removed */
+
+          if (group->tg_env->nvars == 0)
+            {
+              env_release(group);
             }
         }
     }
@@ -42,6 +42,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+
 #include <nuttx/sched.h>
 
 /****************************************************************************
@@ -53,6 +57,45 @@
 #  define env_release(group) (0)
 #else
 
+/* The initial size of the hash table of an environment.  The table is
+ * doubled in size whenever there are more variables than hash chains.
+ */
+
+#define ENV_NBUCKETS_MIN     8
+#define ENV_NBUCKETS_MAX     4096
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One environment variable.  The "NAME=value" string is the one returned
+ * by getenv() so it stays in place until the variable is changed.
+ */
+
+struct env_var_s
+{
+  dq_entry_t node;                /* Link in order of definition */
+  FAR struct env_var_s *hnext;    /* Next variable in the hash chain */
+  uint32_t hash;                  /* Hash of the variable name */
+  char pair[1];                   /* "NAME=value" string (variable length) */
+};
+
+#define SIZEOF_ENV_VAR_S(n)  (sizeof(struct env_var_s) + (n) - 1)
+
+/* The environment of a task group.  A new task group shares the
+ * environment of its parent until one of them changes it.  Then that
+ * group gets a private copy (copy-on-write).
+ */
+
+struct env_s
+{
+  uint16_t crefs;                 /* Number of groups using the environment */
+  uint16_t nbuckets;              /* Number of hash chains (power of two) */
+  uint16_t nvars;                 /* Number of variables */
+  dq_queue_t vars;                /* All variables in order of definition */
+  FAR struct env_var_s **hash;    /* Hash chains */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,13 +116,13 @@ extern "C"
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Give a new task group the environment of the parent task.  The
+ *   environment is shared until either group changes it (see
+ *   env_unshare()).
  *
  * Input Parameters:
- *   group - The child task group to receive the newly allocated copy of the
- *           parent task groups environment structure.
+ *   group - The child task group to receive the parent task group's
+ *           environment.
  *
  * Returned Value:
  *   zero on success
@@ -91,14 +134,36 @@ extern "C"
 
 int env_dup(FAR struct task_group_s *group);
 
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the task group has an environment of its own that it
+ *   may modify:  Create an empty environment if it has none and copy the
+ *   environment if it is shared with another group.
+ *
+ * Input Parameters:
+ *   group - The task group that is about to modify its environment.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if memory could not be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
 /****************************************************************************
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of a
+ *   task group exits and from clearenv().  The task group gives up its
+ *   reference to the environment.  The name-value pairs are freed when no
+ *   other task group shares them.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
@@ -114,6 +179,18 @@ int env_dup(FAR struct task_group_s *group);
 
 void env_release(FAR struct task_group_s *group);
 
+/****************************************************************************
+ * Name: env_hash
+ *
+ * Description:
+ *   Return the hash of a variable name.  The name ends at the first '\0'
+ *   or '=' so that the hash of a name=value string is the hash of its
+ *   name.
+ *
+ ****************************************************************************/
+
+uint32_t env_hash(FAR const char *name);
+
 /****************************************************************************
  * Name: env_findvar
  *
@@ -126,7 +203,7 @@ void env_release(FAR struct task_group_s *group);
  *   pname - The variable name to find
  *
  * Returned Value:
- *   A pointer to the name=value string in the environment
+ *   The variable or NULL if there is no variable of that name.
  *
  * Assumptions:
  *   - Not called from an interrupt handler
@@ -134,30 +211,57 @@ void env_release(FAR struct task_group_s *group);
  *
  ****************************************************************************/
 
-FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
+FAR struct env_var_s *env_findvar(FAR struct task_group_s *group,
+                                  FAR const char *pname);
+
+/****************************************************************************
+ * Name: env_addvar
+ *
+ * Description:
+ *   Add a variable to the environment, replacing any variable of the same
+ *   name.
+ *
+ * Input Parameters:
+ *   group - The task group with the environment to be modified
+ *   name  - The variable name
+ *   value - The value of the variable
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if memory could not be allocated.  The
+ *   environment is unchanged on failure.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *   - The environment belongs to the group alone (see env_unshare())
+ *
+ ****************************************************************************/
+
+int env_addvar(FAR struct task_group_s *group, FAR const char *name,
+               FAR const char *value);
 
 /****************************************************************************
  * Name: env_removevar
  *
  * Description:
- *   Remove the referenced name=value pair from the environment
+ *   Remove the variable from the environment and free it
  *
  * Input Parameters:
- *   group - The task group with the environment containing the name=value
- *           pair
- *   pvar  - A pointer to the name=value pair in the restroom
+ *   group - The task group with the environment containing the variable
+ *   var   - The variable to be removed
  *
  * Returned Value:
- *   Zero on success
+ *   None
  *
  * Assumptions:
  *   - Not called from an interrupt handler
  *   - Caller has pre-emption disabled
- *   - Caller will reallocate the environment structure to the correct size
+ *   - The environment belongs to the group alone (see env_unshare())
  *
  ****************************************************************************/
 
-int env_removevar(FAR struct task_group_s *group, FAR char *pvar);
+void env_removevar(FAR struct task_group_s *group,
+                   FAR struct env_var_s *var);
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -50,6 +50,7 @@
 
 #include "environ/environ.h"
 #include "group/group.h"
+#include "signal/signal.h"
 
 #ifdef HAVE_TASK_GROUP
 
@@ -262,6 +263,12 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
   (void)nxsem_setprotocol(&group->tg_exitsem, SEM_PRIO_NONE);
 #endif
 
+#if !defined(CONFIG_DISABLE_SIGNALS) && CONFIG_SIG_PREALLOC_GROUP > 0
+  /* Reserve pending signal structures for the group */
+
+  nxsig_initgroup(group);
+#endif
+
   return OK;
 }
 
@@ -85,6 +85,25 @@ void os_start(void);
 int os_smp_start(void);
 #endif
 
+/****************************************************************************
+ * Name: initcall_start
+ *
+ * Description:
+ *   Start the threads that run the registered initialization calls.  Calls
+ *   registered after this will also be started as they are registered.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INITCALL
+void initcall_start(void);
+#endif
+
 /****************************************************************************
  * Name: os_idle_trampoline
  *
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * sched/init/os_boottime.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/boottime.h>
+
+#ifdef CONFIG_SCHED_BOOTTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_BOOTTIME_NMARKS
+#  define CONFIG_SCHED_BOOTTIME_NMARKS 32
+#endif
+
+#ifndef CONFIG_SCHED_BOOTTIME_NAMELEN
+#  define CONFIG_SCHED_BOOTTIME_NAMELEN 16
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+#  define boottime_now() up_critmon_gettime()
+#else
+#  define boottime_now() ((uint32_t)clock_systimer())
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One recorded mark */
+
+struct boottime_s
+{
+  uint32_t time;                              /* Raw time of the mark */
+  char name[CONFIG_SCHED_BOOTTIME_NAMELEN];   /* Name of the stage */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* These are provided by the platform for the critical section monitor */
+
+uint32_t up_critmon_gettime(void);
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The marks are held in .bss so that they may be recorded before the
+ * memory manager is initialized.
+ */
+
+static struct boottime_s g_boottime[CONFIG_SCHED_BOOTTIME_NMARKS];
+static uint8_t g_boottime_nmarks;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_mark
+ *
+ * Description:
+ *   Record the time at which a stage of the system start-up completed.
+ *
+ ****************************************************************************/
+
+void boottime_mark(FAR const char *name)
+{
+  FAR struct boottime_s *mark;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (g_boottime_nmarks < CONFIG_SCHED_BOOTTIME_NMARKS)
+    {
+      mark       = &g_boottime[g_boottime_nmarks];
+      mark->time = boottime_now();
+      strncpy(mark->name, name, CONFIG_SCHED_BOOTTIME_NAMELEN - 1);
+
+      g_boottime_nmarks++;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: boottime_get
+ *
+ * Description:
+ *   Return one of the recorded marks.
+ *
+ ****************************************************************************/
+
+int boottime_get(int index, FAR const char **name, FAR struct timespec *ts)
+{
+  uint32_t elapsed;
+
+  if (index < 0 || index >= g_boottime_nmarks)
+    {
+      return -ENOENT;
+    }
+
+  elapsed = g_boottime[index].time - g_boottime[0].time;
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  up_critmon_convert(elapsed, ts);
+#else
+  ts->tv_sec  = elapsed / CLOCKS_PER_SEC;
+  ts->tv_nsec = (elapsed % CLOCKS_PER_SEC) * NSEC_PER_TICK;
+#endif
+
+  *name = g_boottime[index].name;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_BOOTTIME */
@@ -57,6 +57,8 @@
 #include <nuttx/kthread.h>
 #include <nuttx/userspace.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/syslog/syslog.h>
+#include <nuttx/boottime.h>
 
 #ifdef CONFIG_PAGING
 # include "paging/paging.h"
@@ -251,6 +253,7 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  boottime_mark("board_initialize");
 #endif
 
   /* Start the application initialization task.  In a flat build, this is
@@ -274,6 +277,8 @@ static inline void os_do_appstart(void)
 #endif
   DEBUGASSERT(pid > 0);
   UNUSED(pid);
+
+  boottime_mark("init");
 }
 
 #elif defined(CONFIG_INIT_FILEPATH)
@@ -287,6 +292,7 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  boottime_mark("board_initialize");
 #endif
 
 #ifdef CONFIG_INIT_MOUNT
@@ -310,6 +316,8 @@ static inline void os_do_appstart(void)
              CONFIG_INIT_NEXPORTS);
   DEBUGASSERT(ret >= 0);
   UNUSED(ret);
+
+  boottime_mark("init");
 }
 
 #elif defined(CONFIG_INIT_NONE)
@@ -403,6 +411,9 @@ static inline void os_start_application(void)
  *                  perform most any kind of queued work.  Its primary
  *                  function is to serve as the "bottom half" of device
  *                  drivers.
+ *   - initcall:    The threads that run the initialization calls registered
+ *                  with initcall_register() (only if CONFIG_SCHED_INITCALL
+ *                  is defined).
  *
  *   And the main application entry point:
  *   symbols, either:
@@ -449,6 +460,21 @@ int os_bringup(void)
 
   os_workqueues();
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Start the low priority thread that formats deferred SYSLOG output */
+
+  (void)syslog_deferred_start();
+#endif
+
+#ifdef CONFIG_SCHED_INITCALL
+  /* Start running the slow initialization calls that were registered by
+   * up_initialize().  These will run in parallel with the application
+   * start-up.
+   */
+
+  initcall_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
@@ -0,0 +1,456 @@
+/****************************************************************************
+ * sched/init/os_initcall.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/boottime.h>
+#include <nuttx/initcall.h>
+
+#include "init/init.h"
+
+#ifdef CONFIG_SCHED_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_INITCALL_NTHREADS
+#  define CONFIG_SCHED_INITCALL_NTHREADS 2
+#endif
+
+#ifndef CONFIG_SCHED_INITCALL_PRIORITY
+#  define CONFIG_SCHED_INITCALL_PRIORITY 200
+#endif
+
+#ifndef CONFIG_SCHED_INITCALL_STACKSIZE
+#  define CONFIG_SCHED_INITCALL_STACKSIZE 2048
+#endif
+
+/* Values for the state field of struct initcall_s */
+
+#define INITCALL_PENDING  0  /* Waiting to run */
+#define INITCALL_RUNNING  1  /* Running now */
+#define INITCALL_DONE     2  /* Completed (successfully or not) */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_initcall_lock = SEM_INITIALIZER(1);  /* Protects the state */
+static sem_t g_initcall_done = SEM_INITIALIZER(0);  /* Signals completions */
+
+/* The list of registered calls, in order of registration */
+
+static FAR struct initcall_s *g_initcall_head;
+static FAR struct initcall_s *g_initcall_tail;
+
+static uint32_t g_initcall_ids;       /* Identifiers of registered calls */
+static uint32_t g_initcall_complete;  /* Identifiers of completed calls */
+static uint8_t  g_initcall_nwaiters;  /* Threads waiting on g_initcall_done */
+static uint8_t  g_initcall_nworkers;  /* Initialization threads running */
+static uint8_t  g_initcall_nidle;     /* Threads not running a call */
+static bool     g_initcall_started;   /* Threads may be started */
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void initcall_spawn(void);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_takelock and initcall_givelock
+ *
+ * Description:
+ *   Get and release exclusive access to the initialization call state.
+ *
+ ****************************************************************************/
+
+#define initcall_takelock() (void)nxsem_wait_uninterruptible(&g_initcall_lock)
+#define initcall_givelock() (void)nxsem_post(&g_initcall_lock)
+
+/****************************************************************************
+ * Name: initcall_find
+ *
+ * Description:
+ *   Find the registered call with this identifier.
+ *
+ ****************************************************************************/
+
+static FAR struct initcall_s *initcall_find(int id)
+{
+  FAR struct initcall_s *call;
+
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if (call->id == id)
+        {
+          return call;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: initcall_runnable
+ *
+ * Description:
+ *   Return true if the call has not yet started and all of its dependencies
+ *   have completed.
+ *
+ ****************************************************************************/
+
+static inline bool initcall_runnable(FAR struct initcall_s *call)
+{
+  return call->state == INITCALL_PENDING &&
+         (call->depends & ~g_initcall_complete) == 0;
+}
+
+/****************************************************************************
+ * Name: initcall_next
+ *
+ * Description:
+ *   Return the next call that may be run on an initialization thread.
+ *   Optionally, return the number of such calls.
+ *
+ ****************************************************************************/
+
+static FAR struct initcall_s *initcall_next(FAR int *ncalls)
+{
+  FAR struct initcall_s *next = NULL;
+  FAR struct initcall_s *call;
+  int n = 0;
+
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if ((call->flags & INITCALL_DEFERRED) == 0 && initcall_runnable(call))
+        {
+          if (next == NULL)
+            {
+              next = call;
+            }
+
+          n++;
+        }
+    }
+
+  if (ncalls != NULL)
+    {
+      *ncalls = n;
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: initcall_run
+ *
+ * Description:
+ *   Run one call on the caller's thread and wake up everyone waiting for a
+ *   call to complete.  The caller holds the lock and this function returns
+ *   with the lock held, but the lock is released while the call runs.
+ *
+ ****************************************************************************/
+
+static void initcall_run(FAR struct initcall_s *call)
+{
+  int result;
+
+  call->state = INITCALL_RUNNING;
+  initcall_givelock();
+
+  sinfo("Starting %s\n", call->name);
+  result = call->func(call->arg);
+  sinfo("%s completed: %d\n", call->name, result);
+  boottime_mark(call->name);
+
+  if (result < 0)
+    {
+      serr("ERROR: %s failed: %d\n", call->name, result);
+    }
+
+  initcall_takelock();
+
+  call->result         = result;
+  call->state          = INITCALL_DONE;
+  g_initcall_complete |= INITCALL_DEPEND(call->id);
+
+  while (g_initcall_nwaiters > 0)
+    {
+      g_initcall_nwaiters--;
+      (void)nxsem_post(&g_initcall_done);
+    }
+
+  /* Other calls may now be able to run */
+
+  initcall_spawn();
+}
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   The body of an initialization thread.  Run calls until there are no more
+ *   calls that can be run, then exit.
+ *
+ ****************************************************************************/
+
+static int initcall_worker(int argc, FAR char **argv)
+{
+  FAR struct initcall_s *call;
+
+  initcall_takelock();
+
+  while ((call = initcall_next(NULL)) != NULL)
+    {
+      g_initcall_nidle--;
+      initcall_run(call);
+      g_initcall_nidle++;
+    }
+
+  g_initcall_nidle--;
+  g_initcall_nworkers--;
+  initcall_givelock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: initcall_spawn
+ *
+ * Description:
+ *   Start more initialization threads if there are more runnable calls than
+ *   idle threads.  The caller holds the lock.
+ *
+ ****************************************************************************/
+
+static void initcall_spawn(void)
+{
+  int ncalls;
+  int pid;
+
+  if (!g_initcall_started)
+    {
+      return;
+    }
+
+  (void)initcall_next(&ncalls);
+  while (g_initcall_nidle < ncalls &&
+         g_initcall_nworkers < CONFIG_SCHED_INITCALL_NTHREADS)
+    {
+      pid = kthread_create("initcall", CONFIG_SCHED_INITCALL_PRIORITY,
+                           CONFIG_SCHED_INITCALL_STACKSIZE,
+                           (main_t)initcall_worker,
+                           (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          /* The remaining calls will be run by the threads that are already
+           * running or by initcall_wait().
+           */
+
+          serr("ERROR: Failed to start an initialization thread: %d\n", pid);
+          break;
+        }
+
+      g_initcall_nworkers++;
+      g_initcall_nidle++;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register an initialization call.  See include/nuttx/initcall.h.
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call)
+{
+  uint32_t bit;
+
+  DEBUGASSERT(call != NULL && call->func != NULL &&
+              call->id <= INITCALL_ID_MAX);
+
+  bit = INITCALL_DEPEND(call->id);
+  if ((call->depends & bit) != 0)
+    {
+      return -EINVAL;
+    }
+
+  initcall_takelock();
+
+  if ((g_initcall_ids & bit) != 0)
+    {
+      initcall_givelock();
+      return -EEXIST;
+    }
+
+  call->flink  = NULL;
+  call->state  = INITCALL_PENDING;
+  call->result = -EBUSY;
+
+  if (g_initcall_tail == NULL)
+    {
+      g_initcall_head = call;
+    }
+  else
+    {
+      g_initcall_tail->flink = call;
+    }
+
+  g_initcall_tail = call;
+  g_initcall_ids |= bit;
+
+  initcall_spawn();
+  initcall_givelock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: initcall_wait
+ *
+ * Description:
+ *   Wait for an initialization call to complete.  See
+ *   include/nuttx/initcall.h.
+ *
+ ****************************************************************************/
+
+int initcall_wait(int id)
+{
+  FAR struct initcall_s *call;
+  uint32_t pending;
+  int ret;
+  int dep;
+
+  initcall_takelock();
+
+  call = initcall_find(id);
+  if (call == NULL)
+    {
+      initcall_givelock();
+      return -ENOENT;
+    }
+
+  while (call->state != INITCALL_DONE)
+    {
+      if (initcall_runnable(call))
+        {
+          /* Nothing has started the call.  Run it now. */
+
+          initcall_run(call);
+        }
+      else if (call->state == INITCALL_PENDING)
+        {
+          /* Wait for (or run) the first dependency that has not completed */
+
+          pending = call->depends & ~g_initcall_complete;
+          dep     = 0;
+
+          while ((pending & INITCALL_DEPEND(dep)) == 0)
+            {
+              dep++;
+            }
+
+          initcall_givelock();
+          ret = initcall_wait(dep);
+          if (ret == -ENOENT)
+            {
+              serr("ERROR: %s depends on missing call %d\n",
+                   call->name, dep);
+              return ret;
+            }
+
+          initcall_takelock();
+        }
+      else
+        {
+          /* The call is running on another thread.  Wait for it. */
+
+          g_initcall_nwaiters++;
+          initcall_givelock();
+          (void)nxsem_wait_uninterruptible(&g_initcall_done);
+          initcall_takelock();
+        }
+    }
+
+  ret = call->result;
+  initcall_givelock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: initcall_start
+ *
+ * Description:
+ *   Called by os_bringup() when the OS is ready to start the initialization
+ *   threads for the calls registered so far.
+ *
+ ****************************************************************************/
+
+void initcall_start(void)
+{
+  /* g_initcall_done is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_setprotocol(&g_initcall_done, SEM_PRIO_NONE);
+
+  initcall_takelock();
+  g_initcall_started = true;
+  initcall_spawn();
+  initcall_givelock();
+}
+
+#endif /* CONFIG_SCHED_INITCALL */
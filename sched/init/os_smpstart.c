@@ -163,6 +163,14 @@ int os_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP
+      /* Take any ready-to-run task that was left waiting while this CPU
+       * could not accept it.
+       */
+
+      sched_idle_steal();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -56,6 +56,7 @@
 #include <nuttx/sched_note.h>
 #include <nuttx/syslog/syslog.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/boottime.h>
 #include <nuttx/init.h>
 
 #include "sched/sched.h"
@@ -86,6 +87,18 @@
 #  define SCHED_ALL_CPUS         ((1 << CONFIG_SMP_NCPUS) - 1)
 #endif /* CONFIG_SMP */
 
+#ifdef CONFIG_MM_SLAB
+/* The size of one object in the TCB cache */
+
+#  ifdef CONFIG_DISABLE_PTHREAD
+#    define TCBCACHE_OBJSIZE     sizeof(struct task_tcb_s)
+#  else
+#    define TCBCACHE_OBJSIZE \
+       (sizeof(struct task_tcb_s) > sizeof(struct pthread_tcb_s) ? \
+        sizeof(struct task_tcb_s) : sizeof(struct pthread_tcb_s))
+#  endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -333,6 +346,14 @@ const struct tasklist_s g_tasklisttable[NUM_TASK_STATES] =
 
 uint8_t g_os_initstate;  /* See enum os_initstate_e */
 
+#ifdef CONFIG_MM_SLAB
+/* The TCBs of tasks and threads created by task_create(), vfork(), and
+ * pthread_create() are allocated from this cache.
+ */
+
+struct slab_cache_s g_tcbcache;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -405,6 +426,7 @@ void os_start(void)
   /* Boot up is complete */
 
   g_os_initstate = OSINIT_BOOT;
+  boottime_mark("boot");
 
   /* Initialize RTOS Data ***************************************************/
   /* Initialize all task lists */
@@ -618,6 +640,14 @@ void os_start(void)
   /* The memory manager is available */
 
   g_os_initstate = OSINIT_MEMORY;
+  boottime_mark("memory");
+
+#ifdef CONFIG_MM_SLAB
+  /* Initialize the cache of TCBs */
+
+  slab_initialize(&g_tcbcache, "tcb", TCBCACHE_OBJSIZE,
+                  CONFIG_MM_SLAB_TCB_NPERSLAB);
+#endif
 
 #if defined(CONFIG_SCHED_HAVE_PARENT) && defined(CONFIG_SCHED_CHILD_STATUS)
   /* Initialize tasking data structures */
@@ -639,6 +669,8 @@ void os_start(void)
       irq_initialize();
     }
 
+  boottime_mark("irq");
+
   /* Initialize the watchdog facility (if included in the link) */
 
 #ifdef CONFIG_HAVE_WEAKFUNCTIONS
@@ -666,6 +698,8 @@ void os_start(void)
     }
 #endif
 
+  boottime_mark("clock");
+
 #ifndef CONFIG_DISABLE_SIGNALS
   /* Initialize the signal facility (if in link) */
 
@@ -703,12 +737,14 @@ void os_start(void)
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  boottime_mark("fs");
 #endif
 
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
   net_initialize();
+  boottime_mark("net");
 #endif
 
   /* The processor specific details of running the operating system
@@ -722,6 +758,7 @@ void os_start(void)
   /* Hardware resources are available */
 
   g_os_initstate = OSINIT_HARDWARE;
+  boottime_mark("up_initialize");
 
 #ifdef CONFIG_MM_SHM
   /* Initialize shared memory support */
@@ -741,6 +778,8 @@ void os_start(void)
   binfmt_initialize();
 #endif
 
+  boottime_mark("libraries");
+
   /* IDLE Group Initialization **********************************************/
   /* Announce that the CPU0 IDLE task has started */
 
@@ -795,6 +834,7 @@ void os_start(void)
    */
 
   syslog_initialize(SYSLOG_INIT_LATE);
+  boottime_mark("syslog");
 
 #ifdef CONFIG_SMP
   /* Start all CPUs *********************************************************/
@@ -863,6 +903,14 @@ void os_start(void)
         }
 #endif
 
+#ifdef CONFIG_SMP
+      /* Take any ready-to-run task that was left waiting while this CPU
+       * could not accept it.
+       */
+
+      sched_idle_steal();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -49,6 +49,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/sched.h>
 #include <nuttx/spinlock.h>
 
 /****************************************************************************
@@ -83,6 +84,9 @@ struct irq_info_s
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  uint32_t hist[SCHED_HIST_NBUCKETS]; /* Histogram of execution times */
+#endif
 #endif
 };
 
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * sched/irq/irq_attach_thread.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_IRQTHREAD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the thread attached to one IRQ */
+
+struct irq_thread_s
+{
+  int irq;                  /* The IRQ number */
+  xcpt_t isr;               /* Top half, runs in interrupt context */
+  xcpt_t isrthread;         /* Bottom half, runs on the thread */
+  FAR void *arg;            /* Argument passed to both */
+  pid_t pid;                /* The thread; INVALID_PROCESS_ID when gone */
+  volatile bool stop;       /* True: Thread should terminate */
+  sem_t sem;                /* Posted by the top half to run the thread */
+  sem_t exitsem;            /* Posted when the thread terminates */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The thread attached to each IRQ.  Modified only with the IRQ detached. */
+
+static FAR struct irq_thread_s *g_irqthread[NR_IRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The interrupt handler that is really attached to a threaded IRQ.  It
+ *   calls the top half, if any, and if the top half asks for it, masks the
+ *   IRQ and wakes up the thread.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = (FAR struct irq_thread_s *)arg;
+  int ret = IRQ_WAKE_THREAD;
+
+  if (info->isr != NULL)
+    {
+      ret = info->isr(irq, context, info->arg);
+    }
+
+  if (ret == IRQ_WAKE_THREAD)
+    {
+      /* The IRQ stays masked until the thread has serviced the device */
+
+      up_disable_irq(irq);
+      (void)nxsem_post(&info->sem);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The thread of one IRQ.  It waits to be woken up by irq_thread_isr(),
+ *   runs the bottom half, and then unmasks the IRQ again.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments
+ *   argv - argv[1] holds the address of the IRQ thread structure in hex
+ *
+ * Returned Value:
+ *   Zero (OK) when the thread is stopped.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info;
+
+  DEBUGASSERT(argc > 1 && argv[1] != NULL);
+  info = (FAR struct irq_thread_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+  for (; ; )
+    {
+      (void)nxsem_wait(&info->sem);
+      if (info->stop)
+        {
+          break;
+        }
+
+      (void)info->isrthread(info->irq, NULL, info->arg);
+      up_enable_irq(info->irq);
+    }
+
+  info->pid = INVALID_PROCESS_ID;
+  (void)nxsem_post(&info->exitsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_stop
+ *
+ * Description:
+ *   Stop the thread of an IRQ that has already been detached and release
+ *   its resources.
+ *
+ ****************************************************************************/
+
+static void irq_thread_stop(FAR struct irq_thread_s *info)
+{
+  info->stop = true;
+  (void)nxsem_post(&info->sem);
+
+  while (info->pid != INVALID_PROCESS_ID)
+    {
+      (void)nxsem_wait(&info->exitsem);
+    }
+
+  nxsem_destroy(&info->sem);
+  nxsem_destroy(&info->exitsem);
+  kmm_free(info);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  A dedicated
+ *   kernel thread with the given priority is created for the IRQ.
+ *
+ *   'isr', if not NULL, runs in interrupt context.  It should only check
+ *   the device and return IRQ_WAKE_THREAD if the thread needs to run; any
+ *   other value is just returned from the interrupt.  If 'isr' is NULL, the
+ *   thread is always woken up.  When the thread is woken up, the IRQ is
+ *   disabled with up_disable_irq() until 'isrthread' has run on the thread
+ *   (with a NULL context).
+ *
+ *   This gives each device its own priority within the thread priorities
+ *   rather than all deferred interrupt work sharing the FIFO order of the
+ *   high priority work queue.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The top half, may be NULL
+ *   isrthread  - The bottom half.  NULL detaches the IRQ and stops the
+ *                thread.
+ *   arg        - The argument passed to isr and isrthread
+ *   priority   - The priority of the thread
+ *   stack_size - The stack size of the thread.  Zero selects
+ *                CONFIG_IRQTHREAD_STACKSIZE.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  FAR char *argv[2];
+  char hexaddr[16];
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  /* Detach and stop the thread of any previous attachment */
+
+  info = g_irqthread[irq];
+  if (info != NULL)
+    {
+      up_disable_irq(irq);
+      (void)irq_detach(irq);
+
+      g_irqthread[irq] = NULL;
+      irq_thread_stop(info);
+    }
+
+  if (isrthread == NULL)
+    {
+      return OK;
+    }
+
+  if (priority < SCHED_PRIORITY_MIN || priority > SCHED_PRIORITY_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (stack_size <= 0)
+    {
+      stack_size = CONFIG_IRQTHREAD_STACKSIZE;
+    }
+
+  info = (FAR struct irq_thread_s *)kmm_zalloc(sizeof(struct irq_thread_s));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  info->irq       = irq;
+  info->isr       = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+
+  /* The semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&info->sem, 0, 0);
+  (void)nxsem_setprotocol(&info->sem, SEM_PRIO_NONE);
+  (void)nxsem_init(&info->exitsem, 0, 0);
+  (void)nxsem_setprotocol(&info->exitsem, SEM_PRIO_NONE);
+
+  snprintf(hexaddr, sizeof(hexaddr), "%lx", (unsigned long)(uintptr_t)info);
+  argv[0] = hexaddr;
+  argv[1] = NULL;
+
+  ret = kthread_create("irqthread", priority, stack_size,
+                       (main_t)irq_thread_main, (FAR char * const *)argv);
+  if (ret < 0)
+    {
+      nxsem_destroy(&info->sem);
+      nxsem_destroy(&info->exitsem);
+      kmm_free(info);
+      return ret;
+    }
+
+  info->pid = (pid_t)ret;
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  if (ret < 0)
+    {
+      irq_thread_stop(info);
+      return ret;
+    }
+
+  g_irqthread[irq] = info;
+  return OK;
+}
+
+#endif /* CONFIG_IRQTHREAD */
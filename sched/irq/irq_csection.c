@@ -189,6 +189,9 @@ irqstate_t enter_critical_section(void)
   FAR struct tcb_s *rtcb;
   irqstate_t ret;
   int cpu;
+#ifdef CONFIG_SCHED_LOCKSTAT
+  uint32_t wstart;
+#endif
 
   /* Disable interrupts.
    *
@@ -344,6 +347,13 @@ try_again:
 
               DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+              /* Note if we will have to wait for another CPU */
+
+              wstart = spin_islocked(&g_cpu_irqlock) ?
+                       sched_lockstat_gettime() : 0;
+#endif
+
               if (!irq_waitlock(cpu))
                 {
                   /* We are in a deadlock condition due to a pending pause
@@ -378,10 +388,18 @@ try_again:
               /* Note that we have entered the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM) && \
+    defined(CONFIG_HAVE_BUILTIN_RETURN_ADDRESS)
+              rtcb->crit_site = __builtin_return_address(0);
+#endif
               sched_critmon_csection(rtcb, true);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
               sched_note_csection(rtcb, true);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+              sched_lockstat_acquire(NULL, LOCKSTAT_CSECTION, wstart,
+                                     LOCKSTAT_SITE());
 #endif
             }
         }
@@ -421,10 +439,20 @@ irqstate_t enter_critical_section(void)
           /* Note that we have entered the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM) && \
+    defined(CONFIG_HAVE_BUILTIN_RETURN_ADDRESS)
+          rtcb->crit_site = __builtin_return_address(0);
+#endif
           sched_critmon_csection(rtcb, true);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           sched_note_csection(rtcb, true);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+          /* There is never a wait for the critical section on one CPU */
+
+          sched_lockstat_acquire(NULL, LOCKSTAT_CSECTION, 0,
+                                 LOCKSTAT_SITE());
 #endif
         }
     }
@@ -532,6 +560,9 @@ void leave_critical_section(irqstate_t flags)
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
               sched_note_csection(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+              sched_lockstat_release(NULL);
 #endif
               /* Decrement our count on the lock.  If all CPUs have
                * released, then unlock the spinlock.
@@ -610,6 +641,9 @@ void leave_critical_section(irqstate_t flags)
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           sched_note_csection(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+          sched_lockstat_release(NULL);
 #endif
         }
     }
@@ -39,7 +39,10 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <strings.h>
 #include <debug.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/random.h>
@@ -77,6 +80,21 @@
 #  define INCR_COUNT(ndx)
 #endif
 
+/* HIST_COUNT - Add an execution time to the histogram of this IRQ number */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define HIST_COUNT(ndx, delta) \
+     do \
+       { \
+         uint32_t nsec = (delta).tv_sec > 0 ? UINT32_MAX : \
+                         (uint32_t)(delta).tv_nsec; \
+         g_irqvector[ndx].hist[SCHED_HIST_BUCKET(nsec)]++; \
+       } \
+     while (0)
+#else
+#  define HIST_COUNT(ndx, delta)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this interrupt
  * request
  */
@@ -105,6 +123,7 @@
            { \
              g_irqvector[ndx].time = delta.tv_nsec; \
            } \
+         HIST_COUNT(ndx, delta); \
        } \
      while (0)
 #else
@@ -122,6 +141,7 @@
            { \
              g_irqvector[ndx].time = delta.tv_nsec; \
            } \
+         HIST_COUNT(ndx, delta); \
        } \
      while (0)
 #endif /* HAVE_PLATFORM_GETTIME */
@@ -134,7 +154,7 @@
  * External Function Prototypes
  ****************************************************************************/
 
-#ifdef HAVE_PLATFORM_GETTIME
+#if defined(HAVE_PLATFORM_GETTIME) || defined(CONFIG_SCHED_RUNTIME)
 /* If CONFIG_SCHED_TICKLESS is enabled, then the high resolution Tickless
  * timer will be used.  Otherwise, the platform specific logic must provide
  * the following in order to support high resolution timing:
@@ -157,7 +177,7 @@ void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
  * The second interface simple converts an elapsed time into well known
  * units.
  */
-#endif /* HAVE_PLATFORM_GETTIME */
+#endif /* HAVE_PLATFORM_GETTIME || CONFIG_SCHED_RUNTIME */
 
 /****************************************************************************
  * Public Functions
@@ -178,6 +198,9 @@ void irq_dispatch(int irq, FAR void *context)
   xcpt_t vector = irq_unexpected_isr;
   FAR void *arg = NULL;
   unsigned int ndx = irq;
+#ifdef CONFIG_SCHED_RUNTIME
+  uint32_t start;
+#endif
 
 #if NR_IRQS > 0
   if ((unsigned)irq < NR_IRQS)
@@ -214,9 +237,21 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_RUNTIME
+  start = up_critmon_gettime();
+#endif
+
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
 
+#ifdef CONFIG_SCHED_RUNTIME
+  /* Account the time spent in the handler to interrupt time.  This is
+   * subtracted from the run time of the interrupted thread.
+   */
+
+  sched_runtime_irq(up_critmon_gettime() - start);
+#endif
+
   /* Record the new "running" task.  g_running_tasks[] is only used by
    * assertion logic for reporting crashes.
    */
@@ -79,7 +79,22 @@
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+/* Histogram output format ("irqhist"):
+ *
+ *   IRQ     256     512    1024 ... 4194304     inf
+ *   DDD DDDDDDD DDDDDDD DDDDDDD ... DDDDDDD DDDDDDD
+ *
+ * Each column holds the number of handler executions that took less than
+ * the number of nanoseconds in the header and no less than the number in
+ * the column to its left.
+ */
+
+#  define HIST_COLWIDTH 8
+#  define IRQ_LINELEN   (4 + HIST_COLWIDTH * SCHED_HIST_NBUCKETS + 2)
+#else
+#  define IRQ_LINELEN   50
+#endif
 
 /****************************************************************************
  * Private Types
@@ -94,6 +109,9 @@ struct irq_file_s
   size_t remaining;           /* Number of available characters in buffer */
   size_t ncopied;             /* Number of characters in buffer */
   off_t offset;               /* Current file offset */
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  bool hist;                  /* True: "irqhist", false: "irqs" */
+#endif
   char line[IRQ_LINELEN];    /* Pre-allocated buffer for formatted lines */
 };
 
@@ -105,6 +123,14 @@ struct irq_file_s
 
 static int     irq_callback(int irq, FAR struct irq_info_s *info,
                  FAR void *arg);
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static int     irq_hist_callback(int irq, FAR struct irq_info_s *info,
+                 FAR void *arg);
+#endif
+
+/* Helpers */
+
+static bool    irq_isfile(FAR const char *relpath);
 
 /* File system methods */
 
@@ -276,6 +302,93 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
     }
 }
 
+/****************************************************************************
+ * Name: irq_hist_callback
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static int irq_hist_callback(int irq, FAR struct irq_info_s *info,
+                             FAR void *arg)
+{
+  FAR struct irq_file_s *irqfile = (FAR struct irq_file_s *)arg;
+  uint32_t hist[SCHED_HIST_NBUCKETS];
+  irqstate_t flags;
+  uint32_t total;
+  size_t linesize;
+  size_t copysize;
+  int i;
+
+  DEBUGASSERT(irqfile != NULL);
+
+  /* Take a snapshot and reset the histogram */
+
+  flags = enter_critical_section();
+  memcpy(hist, info->hist, sizeof(hist));
+  memset(info->hist, 0, sizeof(info->hist));
+  leave_critical_section(flags);
+
+  /* Don't bother if the histogram is empty.  See the REVISIT note in
+   * irq_callback().
+   */
+
+  for (i = 0, total = 0; i < SCHED_HIST_NBUCKETS; i++)
+    {
+      total += hist[i];
+    }
+
+  if (total == 0)
+    {
+      return 0;
+    }
+
+  /* Output the histogram of this interrupt */
+
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "%3u", (unsigned int)irq);
+  for (i = 0; i < SCHED_HIST_NBUCKETS; i++)
+    {
+      linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                           " %*lu", HIST_COLWIDTH - 1,
+                           (unsigned long)hist[i]);
+    }
+
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       "\n");
+
+  copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
+                            irqfile->remaining, &irqfile->offset);
+
+  irqfile->ncopied   += copysize;
+  irqfile->buffer    += copysize;
+  irqfile->remaining -= copysize;
+
+  /* Return a non-zero value to stop the traversal if the user-provided
+   * buffer is full.
+   */
+
+  return irqfile->remaining > 0 ? 0 : 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: irq_isfile
+ *
+ * Description:
+ *   Return true if relpath is one of the files provided here.
+ *
+ ****************************************************************************/
+
+static bool irq_isfile(FAR const char *relpath)
+{
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  if (strcmp(relpath, "irqhist") == 0)
+    {
+      return true;
+    }
+#endif
+
+  return strcmp(relpath, "irqs") == 0;
+}
+
 /****************************************************************************
  * Name: irq_open
  ****************************************************************************/
@@ -297,9 +410,9 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
       return -EACCES;
     }
 
-  /* "irqs" is the only acceptable value for the relpath */
+  /* "irqs" and "irqhist" are the only acceptable values for the relpath */
 
-  if (strcmp(relpath, "irqs") != 0)
+  if (!irq_isfile(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
@@ -314,6 +427,10 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  irqfile->hist = (strcmp(relpath, "irqhist") == 0);
+#endif
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)irqfile;
@@ -366,7 +483,28 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line to output is the header */
 
-  linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  if (irqfile->hist)
+    {
+      int i;
+
+      linesize = snprintf(irqfile->line, IRQ_LINELEN, "IRQ");
+      for (i = 0; i < SCHED_HIST_NBUCKETS - 1; i++)
+        {
+          linesize += snprintf(&irqfile->line[linesize],
+                               IRQ_LINELEN - linesize, " %*lu",
+                               HIST_COLWIDTH - 1,
+                               1ul << (SCHED_HIST_SHIFT + i));
+        }
+
+      linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                           " %*s\n", HIST_COLWIDTH - 1, "inf");
+    }
+  else
+#endif
+    {
+      linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
+    }
 
   copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                            irqfile->remaining, &irqfile->offset);
@@ -379,7 +517,16 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
    * each.
    */
 
-  (void)irq_foreach(irq_callback, (FAR void *)irqfile);
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  if (irqfile->hist)
+    {
+      (void)irq_foreach(irq_hist_callback, (FAR void *)irqfile);
+    }
+  else
+#endif
+    {
+      (void)irq_foreach(irq_callback, (FAR void *)irqfile);
+    }
 
   /* Update the file position */
 
@@ -435,15 +582,15 @@ static int irq_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int irq_stat(const char *relpath, struct stat *buf)
 {
-  /* "irqs" is the only acceptable value for the relpath */
+  /* "irqs" and "irqhist" are the only acceptable values for the relpath */
 
-  if (strcmp(relpath, "irqs") != 0)
+  if (!irq_isfile(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
     }
 
-  /* "irqs" is the name for a read-only file */
+  /* Both are the names of read-only files */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
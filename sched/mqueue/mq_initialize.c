@@ -81,6 +81,14 @@ sq_queue_t  g_msgfreeirq;
 
 sq_queue_t  g_desfree;
 
+#ifdef CONFIG_MM_SLAB
+/* Messages that are allocated when the free list is exhausted come from
+ * this cache.
+ */
+
+struct slab_cache_s g_msgcache;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -186,6 +194,13 @@ void nxmq_initialize(void)
     mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS,
                      MQ_ALLOC_IRQ);
 
+#ifdef CONFIG_MM_SLAB
+  /* Initialize the cache used when the free list is exhausted */
+
+  slab_initialize(&g_msgcache, "mqmsg", sizeof(struct mqueue_msg_s),
+                  CONFIG_MM_SLAB_NPERSLAB);
+#endif
+
   /* Allocate a block of message queue descriptors */
 
   nxmq_alloc_desblock();
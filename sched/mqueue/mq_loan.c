@@ -0,0 +1,261 @@
+/****************************************************************************
+ * sched/mqueue/mq_loan.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_LOAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Convert a loaned buffer back into its containing message */
+
+#define MQ_LOAN2MSG(b) \
+  ((FAR struct mqueue_msg_s *) \
+   ((FAR char *)(b) - offsetof(struct mqueue_msg_s, mail)))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_loan
+ *
+ * Description:
+ *   Obtain a message buffer that can be filled in place and then queued
+ *   with nxmq_send_loan().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor, opened for writing
+ *   buffer - The location to return the loaned buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_loan(mqd_t mqdes, FAR void **buffer)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      return -EPERM;
+    }
+
+  mqmsg = nxmq_alloc_msg(mqdes->msgq);
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *buffer = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_send_loan
+ *
+ * Description:
+ *   Queue a buffer obtained from nxmq_loan() without copying it.  On
+ *   failure, the caller still holds the loan.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The buffer returned by nxmq_loan()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see nxmq_send()).
+ *
+ ****************************************************************************/
+
+int nxmq_send_loan(mqd_t mqdes, FAR void *buffer, size_t msglen, int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_verify_send(mqdes, buffer, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for the message queue to become non-full, just as nxmq_send()
+   * does.  The message itself has already been allocated.
+   */
+
+  sched_lock();
+  msgq  = mqdes->msgq;
+  flags = enter_critical_section();
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+
+  /* Queue the message.  nxmq_do_send() sees that the data is already in
+   * place and does not copy it.
+   */
+
+  if (ret >= 0)
+    {
+      ret = nxmq_do_send(mqdes, MQ_LOAN2MSG(buffer), buffer, msglen, prio);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_loan
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages and return the
+ *   message buffer itself instead of copying the message.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor, opened for reading
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message on success.  A negated errno value is
+ *   returned on failure (see nxmq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_loan(mqd_t mqdes, FAR void **buffer, FAR int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  /* Get the next message from the message queue (see nxmq_receive()) */
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret   = nxmq_wait_receive(mqdes, &mqmsg);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      /* Hand the message buffer to the caller */
+
+      *buffer = mqmsg->mail;
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      ret = mqmsg->msglen;
+
+      /* The message is no longer counted in the queue.  Wake up any task
+       * waiting for the MQ not full event.
+       */
+
+      nxmq_notify_notfull(mqdes->msgq);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_return_loan
+ *
+ * Description:
+ *   Release a buffer obtained from nxmq_loan() or nxmq_receive_loan().
+ *
+ * Input Parameters:
+ *   mqdes  - The message queue descriptor used to obtain the buffer
+ *   buffer - The buffer to release
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_return_loan(mqd_t mqdes, FAR void *buffer)
+{
+  DEBUGASSERT(mqdes != NULL && buffer != NULL);
+  nxmq_free_msg(mqdes->msgq, MQ_LOAN2MSG(buffer));
+}
+
+#endif /* CONFIG_MQ_LOAN */
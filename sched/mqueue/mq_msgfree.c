@@ -60,6 +60,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was allocated for
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -67,10 +68,15 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
+#ifndef CONFIG_MQ_QUEUE_POOL
+  UNUSED(msgq);
+#endif
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
@@ -101,6 +107,19 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
       leave_critical_section(flags);
     }
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* If this message came from the pool of the message queue, then put it
+   * back in that pool.
+   */
+
+  else if (mqmsg->type == MQ_ALLOC_QUEUE)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+      leave_critical_section(flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate messages because they will not
    * received them.
@@ -108,7 +127,11 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 
   else if (mqmsg->type == MQ_ALLOC_DYN)
     {
+#ifdef CONFIG_MM_SLAB
+      slab_free(&g_msgcache, mqmsg);
+#else
       sched_kfree(mqmsg);
+#endif
     }
   else
     {
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * sched/mqueue/mq_msglist.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_add_msglist
+ *
+ * Description:
+ *   Add a message to the message list(s) of a message queue, after all
+ *   messages of the same or higher priority.  With CONFIG_MQ_PRIO_BUCKETS,
+ *   this is constant time; otherwise the sorted list must be searched.
+ *
+ * Input Parameters:
+ *   msgq  - The message queue
+ *   mqmsg - The message to add.  The priority must already be set.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxmq_add_msglist(FAR struct mqueue_inode_s *msgq,
+                      FAR struct mqueue_msg_s *mqmsg)
+{
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  int prio = mqmsg->priority;
+
+  DEBUGASSERT(prio < MQ_PRIO_NLISTS);
+
+  /* Append the message to the list for its priority and mark that list
+   * as non-empty.
+   */
+
+  sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msglist[prio]);
+  msgq->prioset[prio >> 5] |= (uint32_t)1 << (prio & 31);
+  msgq->prioword           |= (uint32_t)1 << (prio >> 5);
+
+#else
+  FAR struct mqueue_msg_s *next;
+  FAR struct mqueue_msg_s *prev;
+
+  /* Search the message list to find the location to insert the new
+   * message. Each is list is maintained in descending priority order.
+   */
+
+  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+       next && mqmsg->priority <= next->priority;
+       prev = next, next = next->next);
+
+  /* Add the message at the right place */
+
+  if (prev)
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                  &msgq->msglist);
+    }
+  else
+    {
+      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: nxmq_rem_msglist
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   list(s) of a message queue.
+ *
+ * Input Parameters:
+ *   msgq  - The message queue
+ *
+ * Returned Value:
+ *   The removed message or NULL if there are no messages.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_rem_msglist(FAR struct mqueue_inode_s *msgq)
+{
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  FAR struct mqueue_msg_s *mqmsg;
+  int word;
+  int prio;
+
+  if (msgq->prioword == 0)
+    {
+      return NULL;
+    }
+
+  /* The highest set bit of prioword selects the prioset[] word holding
+   * the highest priority; the highest set bit of that word selects the
+   * list.
+   */
+
+  word  = flsl((long)msgq->prioword) - 1;
+  prio  = (word << 5) + flsl((long)msgq->prioset[word]) - 1;
+
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist[prio]);
+  DEBUGASSERT(mqmsg != NULL);
+
+  if (sq_empty(&msgq->msglist[prio]))
+    {
+      msgq->prioset[word] &= ~((uint32_t)1 << (prio & 31));
+      if (msgq->prioset[word] == 0)
+        {
+          msgq->prioword &= ~((uint32_t)1 << word);
+        }
+    }
+
+  return mqmsg;
+#else
+  return (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist);
+#endif
+}
@@ -70,12 +70,22 @@
  *   The allocated and initialized message queue structure or NULL in the
  *   event of a failure.
  *
+ *   If CONFIG_MQ_QUEUE_POOL is selected, a pool of mq_maxmsg messages is
+ *   allocated in the same memory block.  If that is not possible, the
+ *   message queue is created without a pool and will use the global
+ *   message lists.
+ *
  ****************************************************************************/
 
 FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
                                            FAR struct mq_attr *attr)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_QUEUE_POOL
+  FAR struct mqueue_msg_s *pool;
+  int nmsgs;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -89,14 +99,43 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
 
   /* Allocate memory for the new message queue. */
 
-  msgq = (FAR struct mqueue_inode_s *)
-    kmm_zalloc(sizeof(struct mqueue_inode_s));
+#ifdef CONFIG_MQ_QUEUE_POOL
+  nmsgs = attr ? attr->mq_maxmsg : MQ_MAX_MSGS;
+  msgq  = NULL;
+
+  if (nmsgs > 0 && nmsgs <= INT16_MAX)
+    {
+      msgq = (FAR struct mqueue_inode_s *)
+        kmm_zalloc(sizeof(struct mqueue_inode_s) +
+                   nmsgs * sizeof(struct mqueue_msg_s));
+    }
+
+  if (msgq)
+    {
+      /* Put the messages of the pool in the free list of the new message
+       * queue.
+       */
+
+      pool = (FAR struct mqueue_msg_s *)(msgq + 1);
+      for (i = 0; i < nmsgs; i++)
+        {
+          pool[i].type = MQ_ALLOC_QUEUE;
+          sq_addlast((FAR sq_entry_t *)&pool[i], &msgq->msgfree);
+        }
+    }
+  else
+#endif
+    {
+      msgq = (FAR struct mqueue_inode_s *)
+        kmm_zalloc(sizeof(struct mqueue_inode_s));
+    }
 
   if (msgq)
     {
-      /* Initialize the new named message queue */
+      /* Initialize the new named message queue.  kmm_zalloc() leaves the
+       * message list(s) empty.
+       */
 
-      sq_init(&msgq->msglist);
       if (attr)
         {
           msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
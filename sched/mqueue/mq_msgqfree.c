@@ -68,18 +68,16 @@
 void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct mqueue_msg_s *curr;
-  FAR struct mqueue_msg_s *next;
 
-  /* Deallocate any stranded messages in the message queue. */
+  /* Deallocate any stranded messages in the message queue.  Messages from
+   * the per-queue pool are freed along with the message queue itself.
+   */
 
-  curr = (FAR struct mqueue_msg_s *)msgq->msglist.head;
-  while (curr)
+  while ((curr = nxmq_rem_msglist(msgq)) != NULL)
     {
       /* Deallocate the message structure. */
 
-      next = curr->next;
-      nxmq_free_msg(curr);
-      curr = next;
+      nxmq_free_msg(msgq, curr);
     }
 
   /* Then deallocate the message queue itself */
@@ -164,7 +164,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 
   /* Get the message from the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist)) == NULL)
+  while ((newmsg = nxmq_rem_msglist(msgq)) == NULL)
     {
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
@@ -262,9 +262,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
-  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_inode_s *msgq = mqdes->msgq;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
@@ -284,11 +282,40 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* We are done with the message.  Deallocate it now. */
 
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(msgq, mqmsg);
+
+  /* Wake up any task waiting for the MQ not full event. */
+
+  nxmq_notify_notfull(msgq);
+
+  /* Return the length of the message transferred to the user buffer */
+
+  return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: nxmq_notify_notfull
+ *
+ * Description:
+ *   Called after a message has been removed from the message queue.  This
+ *   function unblocks the highest priority task (if any) that is waiting
+ *   for the message queue to become not-full.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_notify_notfull(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
-  msgq = mqdes->msgq;
   if (msgq->nwaitnotfull > 0)
     {
       /* Find the highest priority task that is waiting for
@@ -315,8 +342,4 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
       leave_critical_section(flags);
     }
-
-  /* Return the length of the message transferred to the user buffer */
-
-  return rcvmsglen;
 }
@@ -136,7 +136,7 @@ int nxmq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
     {
       /* Now allocate the message. */
 
-      mqmsg = nxmq_alloc_msg();
+      mqmsg = nxmq_alloc_msg(msgq);
 
       /* Check if the message was successfully allocated */
 
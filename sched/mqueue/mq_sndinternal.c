@@ -115,8 +115,9 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  If CONFIG_MQ_QUEUE_POOL is selected, the message
+ *   will first be taken from the pool of the message queue.  Otherwise,
+ *   the message will be allocated from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -129,7 +130,7 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -137,11 +138,29 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* Try the pool of the message queue first.  It holds maxmsgs messages
+   * so this only fails if the queue was over-filled from interrupt level
+   * or if messages are on loan.
+   */
+
+  flags = enter_critical_section();
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msgfree);
+  leave_critical_section(flags);
+
+  if (mqmsg != NULL)
+    {
+      return mqmsg;
+    }
+#else
+  UNUSED(msgq);
+#endif
+
   /* If we were called from an interrupt handler, then try to get the message
    * from generally available list of messages. If this fails, then try the
    * list of messages reserved for interrupt handlers
@@ -178,8 +197,12 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
 
       if (mqmsg == NULL)
         {
+#ifdef CONFIG_MM_SLAB
+          mqmsg = (FAR struct mqueue_msg_s *)slab_alloc(&g_msgcache);
+#else
           mqmsg = (FAR struct mqueue_msg_s *)
             kmm_malloc((sizeof (struct mqueue_msg_s)));
+#endif
 
           /* Check if we allocated the message */
 
@@ -330,6 +353,7 @@ int nxmq_wait_send(mqd_t mqdes)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
+ *   mqmsg  - The message structure obtained by nxmq_alloc_msg()
  *   msg    - Message to send
  *   msglen - The length of the message in bytes
  *   prio   - The priority of the message
@@ -344,8 +368,6 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 {
   FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
-  FAR struct mqueue_msg_s *next;
-  FAR struct mqueue_msg_s *prev;
   irqstate_t flags;
 
   /* Get a pointer to the message queue */
@@ -358,33 +380,19 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message (unless the data was already
+   * written in place in a loaned message buffer).
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
   flags = enter_critical_section();
-
-  /* Search the message list to find the location to insert the new
-   * message. Each is list is maintained in ascending priority order.
-   */
-
-  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
-       next && prio <= next->priority;
-       prev = next, next = next->next);
-
-  /* Add the message at the right place */
-
-  if (prev)
-    {
-      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
-                  &msgq->msglist);
-    }
-  else
-    {
-      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
-    }
+  nxmq_add_msglist(msgq, mqmsg);
 
   /* Increment the count of messages in the queue */
 
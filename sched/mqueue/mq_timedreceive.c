@@ -205,7 +205,7 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
    * will not need to start timer.
    */
 
-  if (mqdes->msgq->msglist.head == NULL)
+  if (nxmq_msglist_empty(mqdes->msgq))
     {
       sclock_t ticks;
 
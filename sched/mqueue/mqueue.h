@@ -52,6 +52,7 @@
 #include <signal.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/slab.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -75,6 +76,14 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* Test if there are no messages in the message queue's message list(s) */
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+#  define nxmq_msglist_empty(q) ((q)->prioword == 0)
+#else
+#  define nxmq_msglist_empty(q) ((q)->msglist.head == NULL)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -83,7 +92,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_QUEUE       /* Preallocated in the pool of one message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -132,6 +142,14 @@ EXTERN sq_queue_t  g_msgfreeirq;
 
 EXTERN sq_queue_t  g_desfree;
 
+#ifdef CONFIG_MM_SLAB
+/* Messages that are allocated when the free list is exhausted come from
+ * this cache.
+ */
+
+EXTERN struct slab_cache_s g_msgcache;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -143,7 +161,14 @@ struct task_group_s; /* Forward reference */
 
 void weak_function nxmq_initialize(void);
 void nxmq_alloc_desblock(void);
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
+
+/* mq_msglist.c ************************************************************/
+
+void nxmq_add_msglist(FAR struct mqueue_inode_s *msgq,
+                      FAR struct mqueue_msg_s *mqmsg);
+FAR struct mqueue_msg_s *nxmq_rem_msglist(FAR struct mqueue_inode_s *msgq);
 
 /* mq_waitirq.c ************************************************************/
 
@@ -155,11 +180,12 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
 int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR int *prio);
+void nxmq_notify_notfull(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c ********************************************************/
 
 int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, int prio);
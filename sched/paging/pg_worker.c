@@ -104,6 +104,10 @@ FAR struct tcb_s *g_pftcb;
 
 static int g_fillresult;
 
+/* This is the page being filled for g_pftcb */
+
+static FAR void *g_fillpage;
+
 /* A configurable timeout period (in clock ticks) may be select to detect
  * page fill failures.
  */
@@ -113,6 +117,14 @@ static clock_t g_starttime;
 #endif
 #endif
 
+#ifdef CONFIG_PAGING_READAHEAD
+/* The virtual address of the page just after the last page filled.  A page
+ * fault at this address indicates sequential execution.
+ */
+
+static uintptr_t g_nextfill;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -320,6 +332,56 @@ static inline bool pg_dequeue(void)
   return false;
 }
 
+/****************************************************************************
+ * Name: pg_readahead
+ *
+ * Description:
+ *   If the page fault on vpage continues on from the previous fill, then
+ *   allocate the following pages that are not already in memory (up to
+ *   CONFIG_PAGING_READAHEAD of them) so that they can be filled with the
+ *   same transfer.
+ *
+ * Input Parameters:
+ *   vpage - The page allocated for the page fault
+ *
+ * Returned Value:
+ *   The number of consecutive pages to fill, starting with vpage.
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_READAHEAD
+static inline unsigned int pg_readahead(FAR void *vpage)
+{
+  uintptr_t vaddr = (uintptr_t)vpage;
+  FAR void *next;
+  unsigned int npages = 1;
+
+  if (vaddr == g_nextfill)
+    {
+      while (npages <= CONFIG_PAGING_READAHEAD)
+        {
+          vaddr += PAGESIZE;
+          if (vaddr >= PG_PAGED_VEND || up_allocvpage(vaddr, &next) < 0)
+            {
+              break;
+            }
+
+          DEBUGASSERT((uintptr_t)next == vaddr);
+          npages++;
+        }
+
+      pginfo("Read-ahead %u pages\n", npages - 1);
+    }
+
+  g_nextfill = (uintptr_t)vpage + ((uintptr_t)npages << PAGESHIFT);
+  return npages;
+}
+#endif
+
 /****************************************************************************
  * Name: pg_startfill
  *
@@ -352,6 +414,9 @@ static inline bool pg_dequeue(void)
 static inline bool pg_startfill(void)
 {
   FAR void *vpage;
+#ifdef CONFIG_PAGING_READAHEAD
+  unsigned int npages;
+#endif
   int result;
 
   /* Remove the TCB at the head of the g_waitfor fill list and check if there
@@ -385,9 +450,23 @@ static inline bool pg_startfill(void)
        * status of the fill will be provided by return value from up_fillpage().
        */
 
+#ifdef CONFIG_PAGING_READAHEAD
+      /* Sequential page faults also fill the following pages */
+
+      npages = pg_readahead(vpage);
+
+      pginfo("Call up_fillpages(%p, %u)\n", vpage, npages);
+      result = up_fillpages(vpage, npages);
+      DEBUGASSERT(result == OK);
+
+      up_fillcomplete(vpage, npages);
+#else
       pginfo("Call up_fillpage(%p)\n", g_pftcb);
       result = up_fillpage(g_pftcb, vpage);
       DEBUGASSERT(result == OK);
+
+      up_fillcomplete(vpage, 1);
+#endif
 #else
       /* If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage is non-blocking
        * call. In this case up_fillpage() will accept an additional argument: The page
@@ -399,6 +478,8 @@ static inline bool pg_startfill(void)
        */
 
       pginfo("Call up_fillpage(%p)\n", g_pftcb);
+      g_fillpage   = vpage;
+      g_fillresult = -EBUSY;
       result = up_fillpage(g_pftcb, vpage, pg_callback);
       DEBUGASSERT(result == OK);
 
@@ -580,6 +661,7 @@ int pg_worker(int argc, char *argv[])
               /* Any value other than OK, brings the system down */
 
               DEBUGASSERT(g_fillresult == OK);
+              up_fillcomplete(g_fillpage, 1);
 
               /* Handle the successful page fill complete event by restarting the
                * task that was blocked waiting for this page fill.
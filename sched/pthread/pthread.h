@@ -108,6 +108,11 @@ FAR struct join_s *pthread_findjoininfo(FAR struct task_group_s *group,
                                         pid_t pid);
 void pthread_release(FAR struct task_group_s *group);
 
+#if CONFIG_PTHREAD_STACK_CACHE > 0
+FAR void *pthread_stackcache_get(size_t stacksize, FAR size_t *allocsize);
+bool pthread_stackcache_put(FAR struct pthread_tcb_s *ptcb);
+#endif
+
 int pthread_sem_take(sem_t *sem, bool intr);
 #ifdef CONFIG_PTHREAD_MUTEX_UNSAFE
 int pthread_sem_trytake(sem_t *sem);
@@ -261,7 +261,11 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate a TCB for the new task. */
 
+#ifdef CONFIG_MM_SLAB
+  ptcb = (FAR struct pthread_tcb_s *)slab_zalloc(&g_tcbcache);
+#else
   ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#endif
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -311,10 +315,29 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
     }
   else
     {
-      /* Allocate the stack for the TCB */
+#if CONFIG_PTHREAD_STACK_CACHE > 0
+      FAR void *stack;
+      size_t allocsize;
+
+      /* Re-use the stack of an exited thread if one of this size is
+       * available.  Remember the requested size so that this stack can be
+       * cached again when this thread exits.
+       */
+
+      ptcb->stacksize = attr->stacksize;
+      stack = pthread_stackcache_get(attr->stacksize, &allocsize);
+      if (stack != NULL)
+        {
+          ret = up_use_stack((FAR struct tcb_s *)ptcb, stack, allocsize);
+        }
+      else
+#endif
+        {
+          /* Allocate the stack for the TCB */
 
-      ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
-                            TCB_FLAG_TTYPE_PTHREAD);
+          ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
+                                TCB_FLAG_TTYPE_PTHREAD);
+        }
     }
 
   if (ret != OK)
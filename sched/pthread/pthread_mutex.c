@@ -47,6 +47,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 #include "pthread/pthread.h"
@@ -55,6 +56,82 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+/****************************************************************************
+ * Name: pthread_owner_running
+ *
+ * Description:
+ *   Return true if the thread 'pid' is presently running on some other
+ *   CPU, i.e., if it is at the head of the g_assignedtasks[] list of
+ *   another CPU.
+ *
+ ****************************************************************************/
+
+static bool pthread_owner_running(pid_t pid)
+{
+  FAR struct tcb_s *tcb;
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me)
+        {
+          tcb = current_task(cpu);
+          if (tcb != NULL && tcb->pid == pid)
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_spin
+ *
+ * Description:
+ *   Spin while an adaptive mutex is held by a thread that is running on
+ *   another CPU.  This returns when the mutex becomes available, when the
+ *   holder is no longer running, or after CONFIG_PTHREAD_MUTEX_SPINCOUNT
+ *   polls.  The caller must then still take the mutex normally (and may
+ *   block if another thread takes it first).
+ *
+ *   The mutex state is only read here so that spinning CPUs do not
+ *   contend for the critical section.
+ *
+ ****************************************************************************/
+
+static void pthread_mutex_spin(FAR struct pthread_mutex_s *mutex)
+{
+  pid_t owner;
+  int spins;
+
+  for (spins = 0; spins < CONFIG_PTHREAD_MUTEX_SPINCOUNT; spins++)
+    {
+      if (mutex->sem.semcount > 0)
+        {
+          /* The mutex is available */
+
+          return;
+        }
+
+      owner = mutex->pid;
+      if (owner <= 0 || !pthread_owner_running(owner))
+        {
+          /* The holder is not running, it will not release the mutex
+           * before we would have to block anyway.
+           */
+
+          return;
+        }
+
+      SP_DSB();
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pthread_mutex_add
  *
@@ -198,6 +275,17 @@ int pthread_mutex_take(FAR struct pthread_mutex_s *mutex, bool intr)
         }
       else
         {
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+          /* If the mutex is held by a thread running on another CPU, it
+           * may be released soon.  Wait a little before blocking.
+           */
+
+          if ((mutex->flags & _PTHREAD_MFLAGS_ADAPTIVE) != 0)
+            {
+              pthread_mutex_spin(mutex);
+            }
+#endif
+
           /* Take semaphore underlying the mutex.  pthread_sem_take
            * returns zero on success and a positive errno value on failure.
            */
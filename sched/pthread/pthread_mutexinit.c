@@ -84,6 +84,9 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
 #else
   uint8_t robust = PTHREAD_MUTEX_ROBUST;
 #endif
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  uint8_t adaptive = 0;
 #endif
   int ret = OK;
   int status;
@@ -109,6 +112,9 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
 #endif
 #ifdef CONFIG_PTHREAD_MUTEX_BOTH
           robust  = attr->robust;
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+          adaptive = attr->adaptive;
 #endif
         }
 
@@ -141,6 +147,13 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
       mutex->flags  = (robust == PTHREAD_MUTEX_ROBUST ? _PTHREAD_MFLAGS_ROBUST : 0);
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+      if (adaptive)
+        {
+          mutex->flags |= _PTHREAD_MFLAGS_ADAPTIVE;
+        }
+#endif
+
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
       /* Set up attributes unique to the mutex type */
 
@@ -0,0 +1,175 @@
+/****************************************************************************
+ * sched/pthread/pthread_stackcache.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "pthread/pthread.h"
+
+#if CONFIG_PTHREAD_STACK_CACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one stack held for re-use */
+
+struct pthread_stack_s
+{
+  FAR void *stack;           /* Stack memory (NULL if the entry is free) */
+  size_t reqsize;            /* Stack size requested by pthread_create() */
+  size_t allocsize;          /* Size of the stack memory */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Stacks of exited pthreads that are waiting to be re-used */
+
+static struct pthread_stack_s g_stackcache[CONFIG_PTHREAD_STACK_CACHE];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_stackcache_get
+ *
+ * Description:
+ *   Take a cached stack that was created with the same requested size.
+ *
+ * Input Parameters:
+ *   stacksize - The stack size requested by pthread_create()
+ *   allocsize - The location to return the size of the stack memory
+ *
+ * Returned Value:
+ *   The stack memory, or NULL if no matching stack is cached.  The stack
+ *   should be given to the new thread with up_use_stack().
+ *
+ ****************************************************************************/
+
+FAR void *pthread_stackcache_get(size_t stacksize, FAR size_t *allocsize)
+{
+  FAR struct pthread_stack_s *entry;
+  FAR void *stack = NULL;
+  irqstate_t flags;
+  int i;
+
+  /* Stacks are returned with interrupts disabled in sched_releasetcb() */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_PTHREAD_STACK_CACHE; i++)
+    {
+      entry = &g_stackcache[i];
+      if (entry->stack != NULL && entry->reqsize == stacksize)
+        {
+          stack        = entry->stack;
+          *allocsize   = entry->allocsize;
+          entry->stack = NULL;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return stack;
+}
+
+/****************************************************************************
+ * Name: pthread_stackcache_put
+ *
+ * Description:
+ *   Keep the stack of an exiting pthread for re-use if it was allocated by
+ *   pthread_create() and there is room in the cache.  If the stack is
+ *   kept, the stack pointers in the TCB are cleared so that the stack
+ *   will not be freed with the TCB.
+ *
+ * Input Parameters:
+ *   ptcb - The TCB of the pthread being released
+ *
+ * Returned Value:
+ *   True if the stack was kept.
+ *
+ * Assumptions:
+ *   Called from sched_releasetcb() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+bool pthread_stackcache_put(FAR struct pthread_tcb_s *ptcb)
+{
+  FAR struct pthread_stack_s *entry;
+  irqstate_t flags;
+  bool kept = false;
+  int i;
+
+  /* Stacks provided by the caller with pthread_attr_setstack() belong to
+   * the caller and are never cached.
+   */
+
+  if (ptcb->stacksize == 0 || ptcb->cmn.stack_alloc_ptr == NULL)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_PTHREAD_STACK_CACHE; i++)
+    {
+      entry = &g_stackcache[i];
+      if (entry->stack == NULL)
+        {
+          entry->stack              = ptcb->cmn.stack_alloc_ptr;
+          entry->reqsize            = ptcb->stacksize;
+          entry->allocsize          = ptcb->cmn.adj_stack_size;
+          ptcb->cmn.stack_alloc_ptr = NULL;
+          kept                      = true;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return kept;
+}
+
+#endif /* CONFIG_PTHREAD_STACK_CACHE > 0 */
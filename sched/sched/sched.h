@@ -50,6 +50,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/mm/slab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -119,6 +120,46 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* SCHED_DEADLINE threads of equal priority are ordered by their absolute
+ * deadlines.  sched_deadline_before() is true if thread 'a' must run
+ * before thread 'b'.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define SCHED_ISDEADLINE(t) \
+  ((t)->sporadic != NULL && (t)->sporadic->deadline > 0)
+#  define sched_deadline_before(a,b) \
+  (SCHED_ISDEADLINE(a) && SCHED_ISDEADLINE(b) && \
+   (sclock_t)((a)->sporadic->abs_deadline - \
+              (b)->sporadic->abs_deadline) < 0)
+
+/* Utilization is represented as a Q16 fraction of one CPU */
+
+#  define DEADLINE_BANDWIDTH(b,p) \
+  ((uint32_t)(((uint64_t)(b) << 16) / (p)))
+#else
+#  define sched_deadline_before(a,b) (false)
+#endif
+
+/* Types of locks recorded by the lock contention profiler */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+#  define LOCKSTAT_SPINLOCK      0 /* spin_lock() */
+#  define LOCKSTAT_SEM           1 /* nxsem_wait() */
+#  define LOCKSTAT_CSECTION      2 /* enter_critical_section() */
+#  define LOCKSTAT_NTYPES        3
+
+/* The call site recorded for a lock is the return address of the function
+ * that takes it.
+ */
+
+#  ifdef CONFIG_HAVE_BUILTIN_RETURN_ADDRESS
+#    define LOCKSTAT_SITE()      __builtin_return_address(0)
+#  else
+#    define LOCKSTAT_SITE()      NULL
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -315,6 +356,15 @@ extern struct pidhash_s g_pidhash[CONFIG_MAX_TASKS];
 
 extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 
+#ifdef CONFIG_MM_SLAB
+/* The TCBs of tasks and threads created by task_create(), vfork(), and
+ * pthread_create() are allocated from this cache.  Each object can hold
+ * either a struct task_tcb_s or a struct pthread_tcb_s.
+ */
+
+extern struct slab_cache_s g_tcbcache;
+#endif
+
 #ifdef CONFIG_SCHED_CPULOAD
 /* This is the total number of clock tick counts.  Essentially the
  * 'denominator' for all CPU load calculations.
@@ -456,6 +506,9 @@ int  sched_sporadic_suspend(FAR struct tcb_s *tcb);
 uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
                                 bool noswitches);
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_admit(FAR struct tcb_s *tcb, uint32_t bandwidth);
+#endif
 #endif
 
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
@@ -470,6 +523,10 @@ FAR struct tcb_s *this_task(void);
 
 int  sched_cpu_select(cpu_set_t affinity);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
+void sched_idle_steal(void);
+#ifdef CONFIG_SMP_CALL
+void sched_smp_reschedule(int cpu);
+#endif
 
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
@@ -505,6 +562,26 @@ void sched_critmon_resume(FAR struct tcb_s *tcb);
 void sched_critmon_suspend(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_RUNTIME
+void sched_runtime_resume(FAR struct tcb_s *tcb);
+void sched_runtime_suspend(FAR struct tcb_s *tcb);
+void sched_runtime_irq(uint32_t elapsed);
+#endif
+
+#ifdef CONFIG_SCHED_PMU
+void sched_pmu_resume(FAR struct tcb_s *tcb);
+void sched_pmu_suspend(FAR struct tcb_s *tcb);
+#endif
+
+/* Lock contention profiler */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+uint32_t sched_lockstat_gettime(void);
+void sched_lockstat_acquire(FAR const void *lock, uint8_t type,
+                            uint32_t wstart, FAR void *site);
+void sched_lockstat_release(FAR const void *lock);
+#endif
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
@@ -89,10 +89,14 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
+   * SCHED_DEADLINE threads of the same priority are kept in order of
+   * their absolute deadlines.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !sched_deadline_before(tcb, next))));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
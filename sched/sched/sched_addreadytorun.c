@@ -204,7 +204,9 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
    * the new task will be running and a context switch switch will be required.
    */
 
-  if (rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->sched_priority < btcb->sched_priority ||
+      (rtcb->sched_priority == btcb->sched_priority &&
+       sched_deadline_before(btcb, rtcb)))
     {
       task_state = TSTATE_TASK_RUNNING;
     }
@@ -267,6 +269,25 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
       btcb->task_state = TSTATE_TASK_READYTORUN;
       doswitch         = false;
     }
+#ifdef CONFIG_SMP_CALL
+  else if (task_state == TSTATE_TASK_RUNNING && cpu != me &&
+           (btcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+    {
+      /* The new task should preempt the task running on some other CPU.
+       * Rather than pausing that CPU in order to modify its assigned task
+       * list, put the task in the g_readytorun list and ask that CPU to
+       * take it.  If some other CPU gets to it first, then the request is
+       * just a false alarm.
+       */
+
+      (void)sched_addprioritized(btcb, (FAR dq_queue_t *)&g_readytorun);
+
+      btcb->task_state = TSTATE_TASK_READYTORUN;
+      doswitch         = false;
+
+      sched_smp_reschedule(cpu);
+    }
+#endif
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
       /* If we are modifying some assigned task list other than our own, we
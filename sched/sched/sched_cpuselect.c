@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 
 #include "sched/sched.h"
@@ -65,6 +66,12 @@
  *   Return the index to the CPU with the lowest priority running task,
  *   possbily its IDLE task.
  *
+ *   If the CPU that is making the selection is one of the CPUs with the
+ *   lowest priority running task, then it is preferred.  Choosing this CPU
+ *   avoids pausing some other CPU in order to modify its assigned task
+ *   list.  Otherwise, ties resolve to the lowest numbered CPU which would
+ *   then bear the cost of every such pause.
+ *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
  *
@@ -78,10 +85,28 @@
 
 int sched_cpu_select(cpu_set_t affinity)
 {
+  FAR struct tcb_s *rtcb;
   uint8_t minprio;
   int cpu;
+  int me;
   int i;
 
+  /* If this CPU is permitted and is executing its IDLE task, then there is
+   * no better choice.  The IDLE task is always the last task in the
+   * assigned task list.
+   */
+
+  me = this_cpu();
+  if ((affinity & (1 << me)) != 0)
+    {
+      rtcb = (FAR struct tcb_s *)g_assignedtasks[me].head;
+      if (rtcb->flink == NULL)
+        {
+          DEBUGASSERT(rtcb->sched_priority == 0);
+          return me;
+        }
+    }
+
   /* Otherwise, find the CPU that is executing the lowest priority task
    * (possibly its IDLE task).
    */
@@ -95,7 +120,7 @@ int sched_cpu_select(cpu_set_t affinity)
 
       if ((affinity & (1 << i)) != 0)
         {
-          FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+          rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
 
           /* If this thread is executing its IDLE task, the use it.  The
            * IDLE task is always the last task in the assigned task list.
@@ -110,7 +135,8 @@ int sched_cpu_select(cpu_set_t affinity)
               DEBUGASSERT(rtcb->sched_priority == 0);
               return i;
             }
-          else if (rtcb->sched_priority < minprio)
+          else if (rtcb->sched_priority < minprio ||
+                   (rtcb->sched_priority == minprio && i == me))
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
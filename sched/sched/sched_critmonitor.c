@@ -40,7 +40,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <strings.h>
 #include <sched.h>
+#include <time.h>
 
 #include "sched/sched.h"
 
@@ -65,6 +67,14 @@
 
 uint32_t up_critmon_gettime(void);
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* The histograms are kept in well known time units so the platform time
+ * must also be converted.
+ */
+
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
+#endif
+
 /************************************************************************************
  * Private Data
  ************************************************************************************/
@@ -93,6 +103,57 @@ uint32_t g_premp_max[1];
 uint32_t g_crit_max[1];
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Histograms of the time with pre-emption disabled or within a critical
+ * section.
+ */
+
+#ifdef CONFIG_SMP_NCPUS
+struct critmon_hist_s g_premp_hist[CONFIG_SMP_NCPUS][SCHED_HIST_NBUCKETS];
+struct critmon_hist_s g_crit_hist[CONFIG_SMP_NCPUS][SCHED_HIST_NBUCKETS];
+#else
+struct critmon_hist_s g_premp_hist[1][SCHED_HIST_NBUCKETS];
+struct critmon_hist_s g_crit_hist[1][SCHED_HIST_NBUCKETS];
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_hist_add
+ *
+ * Description:
+ *   Add one duration to a histogram, remembering the call site if this is
+ *   the longest duration seen in its bucket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static void critmon_hist_add(FAR struct critmon_hist_s *hist,
+                             uint32_t elapsed, FAR void *site)
+{
+  FAR struct critmon_hist_s *bucket;
+  struct timespec ts;
+  uint32_t nsec;
+
+  up_critmon_convert(elapsed, &ts);
+  nsec = ts.tv_sec > 0 ? UINT32_MAX : (uint32_t)ts.tv_nsec;
+
+  bucket = &hist[SCHED_HIST_BUCKET(nsec)];
+  bucket->count++;
+
+  if (elapsed >= bucket->max)
+    {
+      bucket->max  = elapsed;
+      bucket->site = site;
+    }
+}
+#else
+#  define critmon_hist_add(h,e,s)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -147,6 +208,8 @@ void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
           tcb->premp_max = elapsed;
         }
 
+      critmon_hist_add(g_premp_hist[cpu], elapsed, tcb->premp_site);
+
       /* Check for the global max elapsed time */
 
       if (g_premp_start[cpu] != 0)
@@ -211,6 +274,8 @@ void sched_critmon_csection(FAR struct tcb_s *tcb, bool state)
           tcb->crit_max = elapsed;
         }
 
+      critmon_hist_add(g_crit_hist[cpu], elapsed, tcb->crit_site);
+
       /* Check for the global max elapsed time */
 
       if (g_crit_start[cpu] != 0)
@@ -333,6 +398,8 @@ void sched_critmon_suspend(FAR struct tcb_s *tcb)
         {
           tcb->premp_max = elapsed;
         }
+
+      critmon_hist_add(g_premp_hist[this_cpu()], elapsed, tcb->premp_site);
     }
 
   /* Is this task in a critical section? */
@@ -348,6 +415,8 @@ void sched_critmon_suspend(FAR struct tcb_s *tcb)
         {
           tcb->crit_max = elapsed;
         }
+
+      critmon_hist_add(g_crit_hist[this_cpu()], elapsed, tcb->crit_site);
     }
 }
 
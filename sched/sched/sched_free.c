@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/place.h>
 #include <nuttx/arch.h>
 #include <nuttx/wqueue.h>
 
@@ -82,10 +83,15 @@ void sched_ufree(FAR void *address)
 #else
   /* Check if this is an attempt to deallocate memory from an exception
    * handler.  If this function is called from the IDLE task, then we
-   * must have exclusive access to the memory manager to do this.
+   * must have exclusive access to the memory manager to do this.  Memory
+   * from the named heaps is always freed later by the worker thread.
    */
 
-  if (up_interrupt_context() || kumm_trysemaphore() != 0)
+  if (up_interrupt_context() ||
+#ifdef CONFIG_MM_PLACE
+      place_heapmember(address) ||
+#endif
+      kumm_trysemaphore() != 0)
     {
       irqstate_t flags;
 
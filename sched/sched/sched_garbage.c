@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/place.h>
 
 #include "sched/sched.h"
 
@@ -96,9 +97,20 @@ static inline void sched_kucleanup(void)
 
       if (address)
         {
-          /* Return the memory to the user heap */
+#ifdef CONFIG_MM_PLACE
+          /* Memory from a named heap is returned to that heap */
+
+          if (place_heapmember(address))
+            {
+              place_free(address);
+            }
+          else
+#endif
+            {
+              /* Return the memory to the user heap */
 
-          kumm_free(address);
+              kumm_free(address);
+            }
         }
     }
 #endif
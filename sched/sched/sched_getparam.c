@@ -138,6 +138,10 @@ int nxsched_getparam (pid_t pid, FAR struct sched_param *param)
                                &param->sched_ss_repl_period);
               clock_ticks2time((sclock_t)sporadic->budget,
                                &param->sched_ss_init_budget);
+#ifdef CONFIG_SCHED_DEADLINE
+              clock_ticks2time((sclock_t)sporadic->deadline,
+                               &param->sched_dl_deadline);
+#endif
             }
           else
             {
@@ -147,6 +151,10 @@ int nxsched_getparam (pid_t pid, FAR struct sched_param *param)
               param->sched_ss_repl_period.tv_nsec = 0;
               param->sched_ss_init_budget.tv_sec  = 0;
               param->sched_ss_init_budget.tv_nsec = 0;
+#ifdef CONFIG_SCHED_DEADLINE
+              param->sched_dl_deadline.tv_sec     = 0;
+              param->sched_dl_deadline.tv_nsec    = 0;
+#endif
             }
 #endif
         }
@@ -107,6 +107,16 @@ int nxsched_getscheduler(pid_t pid)
    */
 
   policy = (tcb->flags & TCB_FLAG_POLICY_MASK) >> TCB_FLAG_POLICY_SHIFT;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE is implemented as a variant of SCHED_SPORADIC */
+
+  if (policy + 1 == SCHED_SPORADIC && SCHED_ISDEADLINE(tcb))
+    {
+      return SCHED_DEADLINE;
+    }
+#endif
+
   return policy + 1;
 }
 
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * sched/sched/sched_idlesteal.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <queue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_idle_steal
+ *
+ * Description:
+ *   Called periodically from the IDLE loop of each CPU.  If there is a task
+ *   in the g_readytorun list that may run on this CPU, then take it and
+ *   run it.
+ *
+ *   Tasks are left in the g_readytorun list when a CPU gives up its running
+ *   task while pre-emption is disabled or while another CPU holds the IRQ
+ *   lock.  In that case, the CPU falls back to the next task in its own
+ *   assigned task list, usually its IDLE task.  Nothing else revisits the
+ *   g_readytorun list until the next scheduling event, so the task could
+ *   otherwise wait indefinitely while this CPU idles.
+ *
+ *   The task's affinity mask is honored:  Only a task whose affinity
+ *   includes this CPU is taken.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called only from the IDLE task.
+ *
+ ****************************************************************************/
+
+void sched_idle_steal(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  irqstate_t lock;
+  int me;
+
+  /* Avoid the critical section in the common case where there is nothing
+   * to take.
+   */
+
+  if (dq_peek((FAR dq_queue_t *)&g_readytorun) == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  me    = this_cpu();
+
+  /* Do nothing if pre-emption is disabled or if some other CPU holds the
+   * IRQ lock.  The task will be reconsidered when that condition clears
+   * or on the next pass through the IDLE loop.
+   */
+
+  if (!sched_islocked_global() && !irq_cpu_locked(me))
+    {
+      lock = sched_tasklist_lock();
+
+      /* Find the highest priority task that may run on this CPU */
+
+      for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+           tcb != NULL && !CPU_ISSET(me, &tcb->affinity);
+           tcb = (FAR struct tcb_s *)tcb->flink);
+
+      if (tcb != NULL)
+        {
+          /* Move it to the pending task list.  up_release_pending() will
+           * then assign it to the CPU running the lowest priority task
+           * within its affinity (this CPU, if no other is idle) and
+           * perform the context switch.
+           */
+
+          dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+          (void)sched_addprioritized(tcb, (FAR dq_queue_t *)&g_pendingtasks);
+          tcb->task_state = TSTATE_TASK_PENDING;
+        }
+
+      sched_tasklist_unlock(lock);
+
+      if (tcb != NULL)
+        {
+          up_release_pending();
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SMP */
@@ -259,6 +259,10 @@ int sched_lock(void)
           /* Note that we have pre-emption locked */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM) && \
+    defined(CONFIG_HAVE_BUILTIN_RETURN_ADDRESS)
+          rtcb->premp_site = __builtin_return_address(0);
+#endif
           sched_critmon_preemption(rtcb, true);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
@@ -314,6 +318,10 @@ int sched_lock(void)
           /* Note that we have pre-emption locked */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM) && \
+    defined(CONFIG_HAVE_BUILTIN_RETURN_ADDRESS)
+          rtcb->premp_site = __builtin_return_address(0);
+#endif
           sched_critmon_preemption(rtcb, true);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
@@ -0,0 +1,697 @@
+/****************************************************************************
+ * sched/sched/sched_lockstat.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NLOCKS           CONFIG_SCHED_LOCKSTAT_NLOCKS
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN 128
+
+/* Platform time is converted to microseconds using the time of this many
+ * platform time units.
+ */
+
+#define LOCKSTAT_SCALE   1000000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the statistics of one lock as taken from one
+ * call site.
+ */
+
+struct lockstat_s
+{
+  FAR const void *lock;        /* Address of the lock (NULL: unused) */
+  FAR void *site;              /* Address from which it was taken */
+  FAR struct tcb_s *holder;    /* Thread holding the lock (or NULL) */
+  uint8_t type;                /* See LOCKSTAT_* definitions */
+  uint32_t acquired;           /* Number of acquisitions */
+  uint32_t contended;          /* Number of acquisitions that had to wait */
+  uint32_t waitmax;            /* Longest wait */
+  uint32_t holdmax;            /* Longest hold */
+  uint32_t holdstart;          /* Time that the holder took the lock */
+  uint64_t waittotal;          /* Total time waited */
+  uint64_t holdtotal;          /* Total time held */
+};
+
+/* This structure describes one open "file".  The statistics are captured
+ * and formatted when the file is opened.
+ */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;   /* Base open file structure */
+  FAR char *text;              /* Formatted statistics */
+  size_t len;                  /* Bytes used in text */
+};
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+/* These are the same platform-specific interfaces that are used by the
+ * critical section monitor.  up_critmon_gettime() returns the current time
+ * in unknown units (usually a cycle count) and up_critmon_convert()
+ * converts an elapsed time in those units into a standard time.
+ */
+
+uint32_t up_critmon_gettime(void);
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     lockstat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     lockstat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The table of lock records.  This is an open-addressed hash table indexed
+ * by the lock address so that all records of one lock are adjacent.
+ */
+
+static struct lockstat_s g_lockstat[NLOCKS];
+
+/* The number of acquisitions that could not be recorded because the table
+ * was full.
+ */
+
+static uint32_t g_lockstat_overflow;
+
+/* The critical section is recorded under this address */
+
+static uint8_t g_lockstat_csection;
+
+#ifdef CONFIG_SMP
+/* Protects the table against other CPUs.  This must not be the critical
+ * section or an instrumented spinlock.
+ */
+
+static volatile spinlock_t g_lockstat_lock SP_SECTION = SP_UNLOCKED;
+#endif
+
+static FAR const char * const g_lockstat_typename[LOCKSTAT_NTYPES] =
+{
+  "spin",
+  "sem",
+  "csect"
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations lockstat_operations =
+{
+  lockstat_open,       /* open */
+  lockstat_close,      /* close */
+  lockstat_read,       /* read */
+  NULL,                /* write */
+  lockstat_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  lockstat_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_lock and lockstat_unlock
+ *
+ * Description:
+ *   Get exclusive access to the lock records.  This cannot use the
+ *   critical section which is itself recorded.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t lockstat_lock(void)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_lockstat_lock);
+#endif
+  return flags;
+}
+
+static inline void lockstat_unlock(irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_lockstat_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_hash
+ ****************************************************************************/
+
+static inline unsigned int lockstat_hash(FAR const void *lock)
+{
+  return (unsigned int)((((uintptr_t)lock >> 2) * 2654435761u) % NLOCKS);
+}
+
+/****************************************************************************
+ * Name: lockstat_find
+ *
+ * Description:
+ *   Find or create the record of a lock taken from a call site.  Returns
+ *   NULL if the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_s *lockstat_find(FAR const void *lock,
+                                            uint8_t type, FAR void *site)
+{
+  FAR struct lockstat_s *rec;
+  unsigned int ndx = lockstat_hash(lock);
+  int i;
+
+  for (i = 0; i < NLOCKS; i++)
+    {
+      rec = &g_lockstat[ndx];
+      if (rec->lock == NULL)
+        {
+          rec->lock = lock;
+          rec->site = site;
+          rec->type = type;
+          return rec;
+        }
+
+      if (rec->lock == lock && rec->site == site)
+        {
+          return rec;
+        }
+
+      if (++ndx >= NLOCKS)
+        {
+          ndx = 0;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lockstat_usec
+ *
+ * Description:
+ *   Convert a time in platform units to microseconds.  scale is the time
+ *   in nanoseconds of LOCKSTAT_SCALE platform units.
+ *
+ ****************************************************************************/
+
+static unsigned long lockstat_usec(uint64_t elapsed, uint64_t scale)
+{
+  return (unsigned long)
+    ((elapsed / LOCKSTAT_SCALE) * scale / 1000 +
+     (elapsed % LOCKSTAT_SCALE) * scale / (1000ull * LOCKSTAT_SCALE));
+}
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *priv;
+  FAR struct lockstat_s *snap;
+  struct timespec ts;
+  irqstate_t flags;
+  uint64_t scale;
+  uint32_t overflow;
+  size_t alloc;
+  int nrecs;
+  int i;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, "lockstat") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate the open file structure, a snapshot of the records, and
+   * enough space for the formatted output.
+   */
+
+  priv = (FAR struct lockstat_file_s *)
+    kmm_zalloc(sizeof(struct lockstat_file_s));
+  snap = (FAR struct lockstat_s *)
+    kmm_malloc(NLOCKS * sizeof(struct lockstat_s));
+  alloc = (NLOCKS + 2) * LOCKSTAT_LINELEN;
+
+  if (priv != NULL)
+    {
+      priv->text = (FAR char *)kmm_malloc(alloc);
+    }
+
+  if (priv == NULL || snap == NULL || priv->text == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+
+      if (priv != NULL && priv->text != NULL)
+        {
+          kmm_free(priv->text);
+        }
+
+      if (priv != NULL)
+        {
+          kmm_free(priv);
+        }
+
+      if (snap != NULL)
+        {
+          kmm_free(snap);
+        }
+
+      return -ENOMEM;
+    }
+
+  /* Take a consistent snapshot of the records */
+
+  flags = lockstat_lock();
+  memcpy(snap, g_lockstat, NLOCKS * sizeof(struct lockstat_s));
+  overflow = g_lockstat_overflow;
+  lockstat_unlock(flags);
+
+  up_critmon_convert(LOCKSTAT_SCALE, &ts);
+  scale = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+
+  /* Then format the snapshot */
+
+  priv->len = snprintf(priv->text, LOCKSTAT_LINELEN,
+                       "%-5s %-8s %-8s %9s %9s %10s %9s %10s %9s\n",
+                       "TYPE", "LOCK", "SITE", "ACQUIRED", "CONTENDED",
+                       "WAIT(us)", "WAITMAX", "HOLD(us)", "HOLDMAX");
+
+  for (i = 0, nrecs = 0; i < NLOCKS; i++)
+    {
+      FAR struct lockstat_s *rec = &snap[i];
+
+      if (rec->lock == NULL)
+        {
+          continue;
+        }
+
+      priv->len +=
+        snprintf(&priv->text[priv->len], LOCKSTAT_LINELEN,
+                 "%-5s %08lx %08lx %9lu %9lu %10lu %9lu %10lu %9lu\n",
+                 g_lockstat_typename[rec->type],
+                 (unsigned long)((uintptr_t)rec->lock),
+                 (unsigned long)((uintptr_t)rec->site),
+                 (unsigned long)rec->acquired,
+                 (unsigned long)rec->contended,
+                 lockstat_usec(rec->waittotal, scale),
+                 lockstat_usec(rec->waitmax, scale),
+                 lockstat_usec(rec->holdtotal, scale),
+                 lockstat_usec(rec->holdmax, scale));
+      nrecs++;
+    }
+
+  if (overflow > 0)
+    {
+      priv->len += snprintf(&priv->text[priv->len], LOCKSTAT_LINELEN,
+                            "# %lu acquisitions not recorded\n",
+                            (unsigned long)overflow);
+    }
+
+  kmm_free(snap);
+  DEBUGASSERT(priv->len < alloc);
+  finfo("%d records\n", nrecs);
+
+  /* Save the open file structure as the open-specific state in
+   * filep->f_priv.
+   */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the text and the file attributes structure */
+
+  kmm_free(priv->text);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct lockstat_file_s *priv;
+  off_t offset;
+  size_t copysize;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  offset   = filep->f_pos;
+  copysize = procfs_memcpy(priv->text, priv->len, buffer, buflen,
+                           &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldpriv;
+  FAR struct lockstat_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct lockstat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container and copy the text */
+
+  newpriv = (FAR struct lockstat_file_s *)
+    kmm_zalloc(sizeof(struct lockstat_file_s));
+  if (!newpriv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  newpriv->text = (FAR char *)kmm_malloc(oldpriv->len + 1);
+  if (newpriv->text == NULL)
+    {
+      kmm_free(newpriv);
+      return -ENOMEM;
+    }
+
+  memcpy(newpriv->text, oldpriv->text, oldpriv->len);
+  newpriv->len = oldpriv->len;
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (strcmp(relpath, "lockstat") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_lockstat_gettime
+ *
+ * Description:
+ *   Return the current time in platform units for use as the start of a
+ *   wait for a lock.
+ *
+ ****************************************************************************/
+
+uint32_t sched_lockstat_gettime(void)
+{
+  return up_critmon_gettime();
+}
+
+/****************************************************************************
+ * Name: sched_lockstat_acquire
+ *
+ * Description:
+ *   Record that the running thread acquired a lock.
+ *
+ * Input Parameters:
+ *   lock   - The address of the lock.  NULL refers to the critical section.
+ *   type   - The type of the lock (LOCKSTAT_SPINLOCK, ...)
+ *   wstart - The time from sched_lockstat_gettime() at which the thread
+ *            started to wait for the lock, or zero if the lock was
+ *            available.
+ *   site   - The address from which the lock was taken
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockstat_acquire(FAR const void *lock, uint8_t type,
+                            uint32_t wstart, FAR void *site)
+{
+  FAR struct lockstat_s *rec;
+  irqstate_t flags;
+  uint32_t now;
+
+  DEBUGASSERT(type < LOCKSTAT_NTYPES);
+
+  if (lock == NULL)
+    {
+      lock = &g_lockstat_csection;
+    }
+
+  flags = lockstat_lock();
+  now   = up_critmon_gettime();
+
+  rec = lockstat_find(lock, type, site);
+  if (rec == NULL)
+    {
+      g_lockstat_overflow++;
+    }
+  else
+    {
+      rec->acquired++;
+
+      if (wstart != 0)
+        {
+          uint32_t elapsed = now - wstart;
+
+          rec->contended++;
+          rec->waittotal += elapsed;
+          if (elapsed > rec->waitmax)
+            {
+              rec->waitmax = elapsed;
+            }
+        }
+
+      rec->holder    = current_task(this_cpu());
+      rec->holdstart = now;
+    }
+
+  lockstat_unlock(flags);
+}
+
+/****************************************************************************
+ * Name: sched_lockstat_release
+ *
+ * Description:
+ *   Record that the running thread released a lock.  Nothing is recorded
+ *   if the thread is not the one that acquired it.
+ *
+ * Input Parameters:
+ *   lock - The address of the lock.  NULL refers to the critical section.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_lockstat_release(FAR const void *lock)
+{
+  FAR struct lockstat_s *rec;
+  FAR struct tcb_s *rtcb;
+  irqstate_t flags;
+  unsigned int ndx;
+  uint32_t now;
+  int i;
+
+  if (lock == NULL)
+    {
+      lock = &g_lockstat_csection;
+    }
+
+  flags = lockstat_lock();
+  now   = up_critmon_gettime();
+  rtcb  = current_task(this_cpu());
+
+  /* All records of the lock follow its hash position up to the first
+   * unused record.
+   */
+
+  ndx = lockstat_hash(lock);
+  for (i = 0; i < NLOCKS; i++)
+    {
+      rec = &g_lockstat[ndx];
+      if (rec->lock == NULL)
+        {
+          break;
+        }
+
+      if (rec->lock == lock && rec->holder == rtcb)
+        {
+          uint32_t elapsed = now - rec->holdstart;
+
+          rec->holdtotal += elapsed;
+          if (elapsed > rec->holdmax)
+            {
+              rec->holdmax = elapsed;
+            }
+
+          rec->holder = NULL;
+          break;
+        }
+
+      if (++ndx >= NLOCKS)
+        {
+          ndx = 0;
+        }
+    }
+
+  lockstat_unlock(flags);
+}
+
+#endif /* CONFIG_SCHED_LOCKSTAT */
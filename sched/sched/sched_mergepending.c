@@ -115,7 +115,9 @@ bool sched_mergepending(void)
        */
 
       for (;
-           (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+           (rtcb && (ptcb->sched_priority < rtcb->sched_priority ||
+                     (ptcb->sched_priority == rtcb->sched_priority &&
+                      !sched_deadline_before(ptcb, rtcb))));
            rtcb = rtcb->flink);
 
       /* Add the ptcb to the spot found in the list.  Check if the
@@ -222,7 +224,7 @@ bool sched_mergepending(void)
           goto errout_with_lock;
         }
 
-      cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+      cpu  = sched_cpu_select(ptcb->affinity);
       rtcb = current_task(cpu);
 
       /* Loop while there is a higher priority task in the pending task list
@@ -278,7 +280,7 @@ bool sched_mergepending(void)
               goto errout_with_lock;
             }
 
-          cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+          cpu  = sched_cpu_select(ptcb->affinity);
           rtcb = current_task(cpu);
         }
 
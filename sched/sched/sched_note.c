@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -57,6 +59,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* In the SMP case, there is one circular buffer per CPU.  Each CPU adds
+ * notes only to its own buffer so that CPUs never contend with each other
+ * when adding notes.
+ */
+
+#ifdef CONFIG_SMP
+#  define NOTE_NBUFFERS CONFIG_SMP_NCPUS
+#else
+#  define NOTE_NBUFFERS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -92,10 +105,14 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
-static struct note_info_s g_note_info;
+static struct note_info_s g_note_info[NOTE_NBUFFERS];
 
 #ifdef CONFIG_SMP
-static volatile spinlock_t g_note_lock;
+/* Each lock is taken by the owning CPU when it adds a note and by a reader
+ * of the buffer.  It is never contended by other CPUs adding notes.
+ */
+
+static volatile spinlock_t g_note_lock[CONFIG_SMP_NCPUS];
 #endif
 
 /****************************************************************************
@@ -202,6 +219,33 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
 }
 #endif
 
+/****************************************************************************
+ * Name: note_lock and note_unlock
+ *
+ * Description:
+ *   Lock/unlock the circular buffer of one CPU.  Local interrupts are
+ *   disabled and, in the SMP case, the per-CPU spinlock is taken without
+ *   adding a note for the spinlock itself.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t note_lock(int cpu)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_note_lock[cpu]);
+#endif
+  return flags;
+}
+
+static inline void note_unlock(int cpu, irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_note_lock[cpu]);
+#endif
+  up_irq_restore(flags);
+}
+
 /****************************************************************************
  * Name: note_length
  *
@@ -209,17 +253,17 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int note_length(void)
+static unsigned int note_length(FAR struct note_info_s *ni)
 {
-  unsigned int head = g_note_info.ni_head;
-  unsigned int tail = g_note_info.ni_tail;
+  unsigned int head = ni->ni_head;
+  unsigned int tail = ni->ni_tail;
 
   if (tail > head)
     {
@@ -236,113 +280,251 @@ static unsigned int note_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The circular buffer is locked.
  *
  ****************************************************************************/
 
-static void note_remove(void)
+static void note_remove(FAR struct note_info_s *ni)
 {
-  FAR struct note_common_s *note;
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_note_info.ni_tail;
+  tail = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
-  /* Get the length of the note at the tail index */
+  /* Get the length of the note at the tail index.  The length is the first
+   * byte of the note so this is valid even if the note wraps around.
+   */
 
-  note   = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  length = note->nc_length;
-  DEBUGASSERT(length <= note_length());
+  length = ni->ni_buffer[tail];
+  DEBUGASSERT(length <= note_length(ni));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  g_note_info.ni_tail = note_next(tail, length);
+  ni->ni_tail = note_next(tail, length);
 }
 
 /****************************************************************************
- * Name: note_add
+ * Name: note_copyout
  *
  * Description:
- *   Add the variable length note to the head of the circular buffer
+ *   Copy the note at the tail of the circular buffer to the user buffer
+ *   and remove it from the circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni      - The circular buffer
+ *   buffer  - Location to return the note
+ *   notelen - The length of the note at the tail of the circular buffer
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   The circular buffer is locked and the note fits in the user buffer.
  *
  ****************************************************************************/
 
-static void note_add(FAR const uint8_t *note, uint8_t notelen)
+#ifdef CONFIG_SCHED_NOTE_GET
+static void note_copyout(FAR struct note_info_s *ni, FAR uint8_t *buffer,
+                         unsigned int notelen)
 {
-  unsigned int head;
-  unsigned int next;
+  unsigned int tail = ni->ni_tail;
+  unsigned int chunk;
 
-#ifdef CONFIG_SMP
-  /* Ignore notes that are not in the set of monitored CPUs */
+  /* Copy up to the end of the circular buffer, then any remainder from
+   * the beginning.
+   */
 
-  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << this_cpu())) == 0)
+  chunk = CONFIG_SCHED_NOTE_BUFSIZE - tail;
+  if (chunk > notelen)
     {
-      /* Not in the set of monitored CPUs.  Do not log the note. */
+      chunk = notelen;
+    }
 
-      return;
+  memcpy(buffer, &ni->ni_buffer[tail], chunk);
+  if (chunk < notelen)
+    {
+      memcpy(&buffer[chunk], ni->ni_buffer, notelen - chunk);
     }
+
+  ni->ni_tail = note_next(tail, notelen);
+}
 #endif
 
+/****************************************************************************
+ * Name: note_systime
+ *
+ * Description:
+ *   Return the time stamp of the note at the tail of the circular buffer.
+ *
+ * Input Parameters:
+ *   ni - The circular buffer
+ *
+ * Returned Value:
+ *   The LS 32-bits of the system timer when the note was buffered.
+ *
+ * Assumptions:
+ *   The circular buffer is locked and is not empty.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SMP)
+static uint32_t note_systime(FAR struct note_info_s *ni)
+{
+  unsigned int ndx;
+  uint32_t systime = 0;
+  int i;
+
+  ndx = note_next(ni->ni_tail, offsetof(struct note_common_s, nc_systime));
+  for (i = 0; i < 4; i++)
+    {
+      systime |= (uint32_t)ni->ni_buffer[ndx] << (8 * i);
+      ndx      = note_next(ndx, 1);
+    }
+
+  return systime;
+}
+#endif
+
+/****************************************************************************
+ * Name: note_select
+ *
+ * Description:
+ *   Select the circular buffer holding the oldest note.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The index of the selected circular buffer or -ENOENT if all of the
+ *   circular buffers are empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static int note_select(void)
+{
 #ifdef CONFIG_SMP
-  irqstate_t flags = up_irq_save();
-  spin_lock_wo_note(&g_note_lock);
+  irqstate_t flags;
+  uint32_t systime;
+  uint32_t oldest = 0;
+  int ret = -ENOENT;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags = note_lock(cpu);
+      if (note_length(&g_note_info[cpu]) > 0)
+        {
+          /* Compare the time stamps allowing for wraparound */
+
+          systime = note_systime(&g_note_info[cpu]);
+          if (ret < 0 || (int32_t)(systime - oldest) < 0)
+            {
+              oldest = systime;
+              ret    = cpu;
+            }
+        }
+
+      note_unlock(cpu, flags);
+    }
+
+  return ret;
+#else
+  return note_length(&g_note_info[0]) > 0 ? 0 : -ENOENT;
+#endif
+}
 #endif
 
-  /* Get the index to the head of the circular buffer */
+/****************************************************************************
+ * Name: note_add
+ *
+ * Description:
+ *   Add the variable length note to the head of the circular buffer of the
+ *   current CPU.
+ *
+ * Input Parameters:
+ *   note    - The note to add
+ *   notelen - The length of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void note_add(FAR const uint8_t *note, uint8_t notelen)
+{
+  FAR struct note_info_s *ni;
+  irqstate_t flags;
+  unsigned int head;
+  unsigned int chunk;
+  int cpu;
 
   DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
-  head = g_note_info.ni_head;
 
-  /* Loop until all bytes have been transferred to the circular buffer */
+  /* Interrupts must be disabled before sampling the CPU index so that we
+   * cannot migrate to another CPU.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
 
-  while (notelen > 0)
+#ifdef CONFIG_SMP
+  /* Ignore notes that are not in the set of monitored CPUs */
+
+  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << cpu)) == 0)
     {
-      /* Get the next head index.  Would it collide with the current tail
-       * index?
-       */
+      /* Not in the set of monitored CPUs.  Do not log the note. */
 
-      next = note_next(head, 1);
-      if (next == g_note_info.ni_tail)
-        {
-          /* Yes, then remove the note at the tail index */
+      up_irq_restore(flags);
+      return;
+    }
 
-          note_remove();
-        }
+  spin_lock_wo_note(&g_note_lock[cpu]);
+#endif
 
-      /* Save the next byte at the head index */
+  ni = &g_note_info[cpu];
 
-      g_note_info.ni_buffer[head] = *note++;
+  /* Remove notes from the tail until there is room for the new note.  One
+   * byte is always left unused so that a full buffer can be distinguished
+   * from an empty one.
+   */
 
-      head = next;
-      notelen--;
+  while (note_length(ni) + notelen >= CONFIG_SCHED_NOTE_BUFSIZE)
+    {
+      note_remove(ni);
     }
 
-  g_note_info.ni_head = head;
+  /* Copy the note into the circular buffer at the head index, wrapping
+   * around to the beginning of the buffer if necessary.
+   */
 
-#ifdef CONFIG_SMP
-  spin_unlock_wo_note(&g_note_lock);
-  up_irq_restore(flags);
-#endif
+  head  = ni->ni_head;
+  chunk = CONFIG_SCHED_NOTE_BUFSIZE - head;
+  if (chunk > notelen)
+    {
+      chunk = notelen;
+    }
+
+  memcpy(&ni->ni_buffer[head], note, chunk);
+  if (chunk < notelen)
+    {
+      memcpy(ni->ni_buffer, &note[chunk], notelen - chunk);
+    }
+
+  ni->ni_head = note_next(head, notelen);
+
+  note_unlock(cpu, flags);
 }
 
 /****************************************************************************
@@ -586,12 +768,40 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PMU
+void sched_note_pmu(FAR struct tcb_s *tcb, FAR const uint32_t *counts,
+                    int ncounters)
+{
+  struct note_pmu_s note;
+  int i;
+
+  DEBUGASSERT(ncounters == CONFIG_SCHED_PMU_NCOUNTERS);
+
+  /* Format the note */
+
+  note_common(tcb, &note.npm_cmn, sizeof(struct note_pmu_s), NOTE_PMU);
+
+  for (i = 0; i < ncounters; i++)
+    {
+      note.npm_count[i][0] = (uint8_t)(counts[i] & 0xff);
+      note.npm_count[i][1] = (uint8_t)((counts[i] >> 8) & 0xff);
+      note.npm_count[i][2] = (uint8_t)((counts[i] >> 16) & 0xff);
+      note.npm_count[i][3] = (uint8_t)((counts[i] >> 24) & 0xff);
+    }
+
+  /* Add the note to circular buffer */
+
+  note_add((FAR const uint8_t *)&note, sizeof(struct note_pmu_s));
+}
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
  * Description:
  *   Remove the next note from the tail of the circular buffer.  The note
  *   is also removed from the circular buffer to make room for futher notes.
+ *   In the SMP case, the oldest note from any CPU is returned.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -607,35 +817,36 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
+  FAR struct note_info_s *ni;
   irqstate_t flags;
-  unsigned int remaining;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
+  int cpu;
 
   DEBUGASSERT(buffer != NULL);
-  flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
+  /* Select the circular buffer with the oldest note */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  cpu = note_select();
+  if (cpu < 0)
     {
-      notelen = 0;
-      goto errout_with_csection;
+      return 0;
     }
 
-  /* Get the index to the tail of the circular buffer */
+  ni    = &g_note_info[cpu];
+  flags = note_lock(cpu);
 
-  tail    = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
+  /* Verify that the circular buffer is still not empty */
+
+  if (note_length(ni) <= 0)
+    {
+      notelen = 0;
+      goto errout_with_lock;
+    }
 
   /* Get the length of the note at the tail index */
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  notelen = ni->ni_buffer[ni->ni_tail];
+  DEBUGASSERT(notelen <= note_length(ni));
 
   /* Is the user buffer large enough to hold the note? */
 
@@ -643,33 +854,20 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Remove the large note so that we do not get constipated. */
 
-      note_remove();
+      note_remove(ni);
 
       /* and return an error */
 
       notelen = -EFBIG;
-      goto errout_with_csection;
+      goto errout_with_lock;
     }
 
-  /* Loop until the note has been transferred to the user buffer */
-
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the tail index */
-
-      *buffer++ = g_note_info.ni_buffer[tail];
-
-      /* Adjust indices and counts */
+  /* Transfer the note to the user buffer */
 
-      tail = note_next(tail, 1);
-      remaining--;
-    }
-
-  g_note_info.ni_tail = tail;
+  note_copyout(ni, buffer, (unsigned int)notelen);
 
-errout_with_csection:
-  leave_critical_section(flags);
+errout_with_lock:
+  note_unlock(cpu, flags);
   return notelen;
 }
 #endif
@@ -679,6 +877,8 @@ errout_with_csection:
  *
  * Description:
  *   Return the size of the next note at the tail of the circular buffer.
+ *   This is the note that will be returned by the next call to
+ *   sched_note_get().
  *
  * Input Parameters:
  *   None.
@@ -692,37 +892,101 @@ errout_with_csection:
 #ifdef CONFIG_SCHED_NOTE_GET
 ssize_t sched_note_size(void)
 {
-  FAR struct note_common_s *note;
+  FAR struct note_info_s *ni;
   irqstate_t flags;
-  unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
+  int cpu;
 
-  flags = enter_critical_section();
-
-  /* Verify that the circular buffer is not empty */
-
-  circlen = note_length();
-  if (circlen <= 0)
+  cpu = note_select();
+  if (cpu < 0)
     {
-      notelen = 0;
-      goto errout_with_csection;
+      return 0;
     }
 
-  /* Get the index to the tail of the circular buffer */
+  ni      = &g_note_info[cpu];
+  flags   = note_lock(cpu);
+  notelen = note_length(ni) > 0 ? ni->ni_buffer[ni->ni_tail] : 0;
+  note_unlock(cpu, flags);
 
-  tail = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
+  return notelen;
+}
+#endif
 
-  /* Get the length of the note at the tail index */
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many complete notes as will fit from the circular buffer(s)
+ *   and return them in the user buffer.  The notes are returned in the
+ *   same binary format in which they were buffered and can be streamed
+ *   directly to a host for decoding.
+ *
+ *   This is much more efficient than sched_note_get() when draining the
+ *   buffer because each circular buffer is locked only once.  In the SMP
+ *   case, the notes from each CPU are returned in order, but notes from
+ *   different CPUs are not merged; the time stamp in each note may be used
+ *   to merge them.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the total length of the returned notes is provided.  Zero
+ *   is returned only if the circular buffer(s) are empty.  A negated errno
+ *   value is returned in the event of any failure.
+ *
+ ****************************************************************************/
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+#ifdef CONFIG_SCHED_NOTE_GET
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct note_info_s *ni;
+  irqstate_t flags;
+  unsigned int notelen;
+  ssize_t retlen = 0;
+  bool toobig = false;
+  int cpu;
 
-errout_with_csection:
-  leave_critical_section(flags);
-  return notelen;
+  DEBUGASSERT(buffer != NULL);
+
+  for (cpu = 0; cpu < NOTE_NBUFFERS; cpu++)
+    {
+      ni    = &g_note_info[cpu];
+      flags = note_lock(cpu);
+
+      while (note_length(ni) > 0)
+        {
+          notelen = ni->ni_buffer[ni->ni_tail];
+          DEBUGASSERT(notelen <= note_length(ni));
+
+          if (notelen > buflen)
+            {
+              /* Remove a note that can never be returned in this user
+               * buffer so that we do not get constipated.
+               */
+
+              if (retlen == 0)
+                {
+                  note_remove(ni);
+                  toobig = true;
+                  continue;
+                }
+
+              break;
+            }
+
+          note_copyout(ni, buffer, notelen);
+
+          retlen += notelen;
+          buffer += notelen;
+          buflen -= notelen;
+        }
+
+      note_unlock(cpu, flags);
+    }
+
+  return retlen == 0 && toobig ? -EFBIG : retlen;
 }
 #endif
 
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * sched/sched/sched_pmu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched_note.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PMU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_pmu_resume
+ *
+ * Description:
+ *   Called when a thread resumes execution.  Samples the performance
+ *   counters at the start of the new time slice.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_pmu_resume(FAR struct tcb_s *tcb)
+{
+  up_pmu_read(tcb->pmu_start, CONFIG_SCHED_PMU_NCOUNTERS);
+}
+
+/****************************************************************************
+ * Name: sched_pmu_suspend
+ *
+ * Description:
+ *   Called when a thread suspends execution.  Charges the counter
+ *   increments of the time slice that just ended to the thread.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_pmu_suspend(FAR struct tcb_s *tcb)
+{
+  uint32_t now[CONFIG_SCHED_PMU_NCOUNTERS];
+  int i;
+
+  up_pmu_read(now, CONFIG_SCHED_PMU_NCOUNTERS);
+
+  for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS; i++)
+    {
+      now[i]            -= tcb->pmu_start[i];
+      tcb->pmu_count[i] += now[i];
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PMU
+  sched_note_pmu(tcb, now, CONFIG_SCHED_PMU_NCOUNTERS);
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_pmu_get
+ *
+ * Description:
+ *   Return the hardware performance counts of a thread.  If the thread is
+ *   running on this CPU now, then the current time slice is included.
+ *
+ * Input Parameters:
+ *   tcb    - The TCB of the thread
+ *   counts - The location to return CONFIG_SCHED_PMU_NCOUNTERS counts
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_pmu_get(FAR struct tcb_s *tcb, FAR uint64_t *counts)
+{
+  uint32_t now[CONFIG_SCHED_PMU_NCOUNTERS];
+  irqstate_t flags;
+  bool running;
+  int i;
+
+  flags = enter_critical_section();
+
+  /* The counters of other CPUs cannot be read from here */
+
+  running = (tcb->task_state == TSTATE_TASK_RUNNING);
+#ifdef CONFIG_SMP
+  running = running && tcb->cpu == this_cpu();
+#endif
+
+  if (running)
+    {
+      up_pmu_read(now, CONFIG_SCHED_PMU_NCOUNTERS);
+    }
+
+  for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS; i++)
+    {
+      counts[i] = tcb->pmu_count[i];
+      if (running)
+        {
+          counts[i] += (uint32_t)(now[i] - tcb->pmu_start[i]);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_PMU */
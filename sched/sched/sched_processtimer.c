@@ -117,7 +117,13 @@ static inline void sched_cpu_scheduler(int cpu)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if defined(CONFIG_SMP_PERCPU_TICK)
+  /* Each CPU performs the scheduler operations for its own task in
+   * sched_process_cputick().
+   */
+
+#  define sched_process_scheduler()
+#elif CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
 static inline void sched_process_scheduler(void)
 {
 #ifdef CONFIG_SMP
@@ -223,3 +229,36 @@ void sched_process_timer(void)
 
   wd_timer();
 }
+
+/****************************************************************************
+ * Name:  sched_process_cputick
+ *
+ * Description:
+ *   This function handles the tick of one CPU when CONFIG_SMP_PERCPU_TICK
+ *   is defined.  Only the task running on the calling CPU is examined so
+ *   that any resulting context switch also occurs on this CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_PERCPU_TICK
+void sched_process_cputick(void)
+{
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  irqstate_t flags;
+
+  /* The critical section still protects the ready-to-run list, but no
+   * other CPU needs to be paused.
+   */
+
+  flags = enter_critical_section();
+  sched_cpu_scheduler(this_cpu());
+  leave_critical_section(flags);
+#endif
+}
+#endif
@@ -49,6 +49,7 @@
 #include "sched/sched.h"
 #include "group/group.h"
 #include "timer/timer.h"
+#include "pthread/pthread.h"
 
 /****************************************************************************
  * Private Functions
@@ -146,6 +147,18 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->stack_alloc_ptr)
         {
+#if !defined(CONFIG_DISABLE_PTHREAD) && CONFIG_PTHREAD_STACK_CACHE > 0
+          /* Keep the stack of a pthread for re-use if there is room.  The
+           * stack is then detached from the TCB but up_release_stack() is
+           * still called to release any other architecture state.
+           */
+
+          if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+            {
+              (void)pthread_stackcache_put((FAR struct pthread_tcb_s *)tcb);
+            }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
           /* If the exiting thread is not a kernel thread, then it has an
            * address environment.  Don't bother to release the stack memory
@@ -198,9 +211,20 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
       group_leave(tcb);
 #endif
 
-      /* And, finally, release the TCB itself */
+      /* And, finally, release the TCB itself.  TCBs created by binfmt are
+       * allocated from the heap rather than from the TCB cache.
+       */
 
-      sched_kfree(tcb);
+#ifdef CONFIG_MM_SLAB
+      if (slab_member(&g_tcbcache, tcb))
+        {
+          slab_free(&g_tcbcache, tcb);
+        }
+      else
+#endif
+        {
+          sched_kfree(tcb);
+        }
     }
 
   return ret;
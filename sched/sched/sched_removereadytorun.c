@@ -230,20 +230,18 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 
       if (rtrtcb != NULL && rtrtcb->sched_priority >= nxttcb->sched_priority)
         {
-          FAR struct tcb_s *tmptcb;
-
-          /* The TCB at the head of the ready to run list has the higher
-           * priority.  Remove that task from the head of the g_readytorun
-           * list and add to the head of the g_assignedtasks[cpu] list.
+          /* The TCB from the ready to run list has the higher priority.
+           * Remove that task from the g_readytorun list and add to the
+           * head of the g_assignedtasks[cpu] list.  NOTE that this is not
+           * necessarily the task at the head of the g_readytorun list:
+           * Tasks ahead of it do not include this CPU in their affinity.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
-
-          dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
+          dq_rem((FAR dq_entry_t *)rtrtcb, (FAR dq_queue_t *)&g_readytorun);
+          dq_addfirst((FAR dq_entry_t *)rtrtcb, tasklist);
 
-          tmptcb->cpu = cpu;
-          nxttcb = tmptcb;
+          rtrtcb->cpu = cpu;
+          nxttcb = rtrtcb;
         }
 
       /* Will pre-emption be disabled after the switch?  If the lockcount is
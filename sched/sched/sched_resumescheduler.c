@@ -100,6 +100,12 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   sched_critmon_resume(tcb);
 #endif
+#ifdef CONFIG_SCHED_RUNTIME
+  sched_runtime_resume(tcb);
+#endif
+#ifdef CONFIG_SCHED_PMU
+  sched_pmu_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * sched/sched/sched_runtime.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <time.h>
+
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_RUNTIME
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+/* These are the same platform-specific interfaces that are used by the
+ * critical section monitor.  up_critmon_gettime() returns the current time
+ * in unknown units (usually a cycle count) and up_critmon_convert()
+ * converts an elapsed time in those units into a standard time
+ * representation.  See sched/sched/sched_critmonitor.c.
+ */
+
+uint32_t up_critmon_gettime(void);
+void up_critmon_convert(uint32_t elapsed, FAR struct timespec *ts);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Accumulated time spent in interrupt handlers on each CPU, in the units
+ * of up_critmon_gettime().  The difference between two samples is the
+ * interrupt time in that interval (modulo wrap-around).
+ */
+
+#ifdef CONFIG_SMP_NCPUS
+uint32_t g_runtime_irq[CONFIG_SMP_NCPUS];
+#else
+uint32_t g_runtime_irq[1];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: runtime_convert
+ *
+ * Description:
+ *   Convert an elapsed time in platform units into nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t runtime_convert(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  up_critmon_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_runtime_resume
+ *
+ * Description:
+ *   Called when a thread resumes execution.  Starts the run time
+ *   measurement of the new time slice.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_runtime_resume(FAR struct tcb_s *tcb)
+{
+  tcb->run_start = up_critmon_gettime();
+  tcb->irq_start = g_runtime_irq[this_cpu()];
+}
+
+/****************************************************************************
+ * Name: sched_runtime_suspend
+ *
+ * Description:
+ *   Called when a thread suspends execution.  Charges the time slice that
+ *   just ended to the thread and counts the context switch.
+ *
+ *   The thread has already been moved to its new list so a thread that is
+ *   still ready-to-run was preempted; any other thread gave up the CPU
+ *   voluntarily.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void sched_runtime_suspend(FAR struct tcb_s *tcb)
+{
+  /* Zero means that the timer was not ready when the slice started */
+
+  if (tcb->run_start != 0)
+    {
+      uint32_t elapsed = up_critmon_gettime() - tcb->run_start;
+      uint32_t irq     = g_runtime_irq[this_cpu()] - tcb->irq_start;
+
+      if (irq > elapsed)
+        {
+          irq = elapsed;
+        }
+
+      tcb->run_time += runtime_convert(elapsed - irq);
+      tcb->irq_time += runtime_convert(irq);
+      tcb->run_start = 0;
+    }
+
+  if (tcb->task_state >= FIRST_READY_TO_RUN_STATE &&
+      tcb->task_state <= LAST_READY_TO_RUN_STATE)
+    {
+      tcb->nivcsw++;
+    }
+  else
+    {
+      tcb->nvcsw++;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_runtime_irq
+ *
+ * Description:
+ *   Called on exit from each interrupt handler with the time spent in the
+ *   handler.
+ *
+ * Assumptions:
+ *   - Called from an interrupt handler with interrupts disabled
+ *
+ ****************************************************************************/
+
+void sched_runtime_irq(uint32_t elapsed)
+{
+  g_runtime_irq[this_cpu()] += elapsed;
+}
+
+/****************************************************************************
+ * Name: sched_runtime_get
+ *
+ * Description:
+ *   Return the accumulated execution time and interrupt time of a thread,
+ *   including the time slice in progress if the thread is running now.
+ *
+ * Input Parameters:
+ *   tcb     - The TCB of the thread
+ *   runtime - The location to return the execution time
+ *   irqtime - The location to return the interrupt time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_runtime_get(FAR struct tcb_s *tcb, FAR uint64_t *runtime,
+                       FAR uint64_t *irqtime)
+{
+  irqstate_t flags;
+  uint64_t run;
+  uint64_t irq;
+
+  flags = enter_critical_section();
+
+  run = tcb->run_time;
+  irq = tcb->irq_time;
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING && tcb->run_start != 0)
+    {
+      uint32_t elapsed = up_critmon_gettime() - tcb->run_start;
+#ifdef CONFIG_SMP
+      uint32_t slice   = g_runtime_irq[tcb->cpu] - tcb->irq_start;
+#else
+      uint32_t slice   = g_runtime_irq[0] - tcb->irq_start;
+#endif
+
+      if (slice > elapsed)
+        {
+          slice = elapsed;
+        }
+
+      run += runtime_convert(elapsed - slice);
+      irq += runtime_convert(slice);
+    }
+
+  leave_critical_section(flags);
+
+  *runtime = run;
+  *irqtime = irq;
+}
+
+#endif /* CONFIG_SCHED_RUNTIME */
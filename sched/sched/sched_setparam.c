@@ -131,6 +131,17 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
         }
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE parameters are subject to admission control */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC &&
+      SCHED_ISDEADLINE(tcb))
+    {
+      ret = nxsched_setscheduler(pid, SCHED_DEADLINE, param);
+      goto errout_with_lock;
+    }
+#endif
+
 #ifdef CONFIG_SCHED_SPORADIC
   /* Update parameters associated with SCHED_SPORADIC */
 
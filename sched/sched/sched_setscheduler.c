@@ -88,6 +88,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control rejected the thread.
  *
  ****************************************************************************/
 
@@ -96,6 +97,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_SPORADIC
+  uint16_t oldpolicy;
+#endif
   int ret;
 
   /* Check for supported scheduling policy */
@@ -106,6 +110,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -136,6 +143,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+#ifdef CONFIG_SCHED_SPORADIC
+  oldpolicy   = tcb->flags & TCB_FLAG_POLICY_MASK;
+#endif
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -148,7 +158,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -168,7 +178,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -231,7 +241,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 
           /* Initialize/reset current sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               ret = sched_sporadic_reset(tcb);
             }
@@ -271,6 +281,101 @@ int nxsched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          FAR struct sporadic_s *sporadic;
+          sclock_t period_ticks;
+          sclock_t runtime_ticks;
+          sclock_t deadline_ticks;
+          uint32_t bandwidth;
+
+          /* Convert timespec values to system clock ticks */
+
+          (void)clock_time2ticks(&param->sched_ss_repl_period,
+                                 &period_ticks);
+          (void)clock_time2ticks(&param->sched_ss_init_budget,
+                                 &runtime_ticks);
+          (void)clock_time2ticks(&param->sched_dl_deadline,
+                                 &deadline_ticks);
+
+          /* Avoid a zero/negative runtime.  A zero deadline means the end
+           * of the period.
+           */
+
+          if (runtime_ticks < 1)
+            {
+              runtime_ticks = 1;
+            }
+
+          if (deadline_ticks < 1)
+            {
+              deadline_ticks = period_ticks;
+            }
+
+          /* runtime <= deadline <= period */
+
+          if (runtime_ticks > deadline_ticks ||
+              deadline_ticks > period_ticks)
+            {
+              ret = -EINVAL;
+              goto errout_with_irq;
+            }
+
+          /* Admission control */
+
+          bandwidth = DEADLINE_BANDWIDTH(runtime_ticks, period_ticks);
+          ret = sched_deadline_admit(tcb, bandwidth);
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+
+          /* Initialize/reset current sporadic scheduling */
+
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
+            {
+              ret = sched_sporadic_reset(tcb);
+            }
+          else
+            {
+              ret = sched_sporadic_initialize(tcb);
+            }
+
+          /* Save the deadline scheduling parameters.  SCHED_DEADLINE is
+           * built on the sporadic server logic and uses only its main
+           * timer.
+           */
+
+          if (ret >= 0)
+            {
+              tcb->flags            |= TCB_FLAG_SCHED_SPORADIC;
+              tcb->timeslice         = runtime_ticks;
+
+              sporadic               = tcb->sporadic;
+              DEBUGASSERT(sporadic != NULL);
+
+              sporadic->hi_priority  = param->sched_priority;
+              sporadic->low_priority = param->sched_ss_low_priority;
+              sporadic->max_repl     = 1;
+              sporadic->repl_period  = period_ticks;
+              sporadic->budget       = runtime_ticks;
+              sporadic->deadline     = deadline_ticks;
+              sporadic->bandwidth    = bandwidth;
+
+              /* And start the first period */
+
+              ret = sched_sporadic_start(tcb);
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -288,6 +393,13 @@ int nxsched_setscheduler(pid_t pid, int policy,
 
 #ifdef CONFIG_SCHED_SPORADIC
 errout_with_irq:
+  /* If the parameters were rejected, then keep the previous policy */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == 0)
+    {
+      tcb->flags |= oldpolicy;
+    }
+
   leave_critical_section(flags);
   sched_unlock();
   return ret;
@@ -320,6 +432,7 @@ errout_with_irq:
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control rejected the thread.
  *
  ****************************************************************************/
 
@@ -0,0 +1,286 @@
+/****************************************************************************
+ * sched/sched/sched_smpcall.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_CALL
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The queue of pending requests for each CPU and the spinlock that
+ * protects it.  Local interrupts are disabled while the spinlock is held
+ * so that a request may also be queued from an interrupt handler.
+ */
+
+static sq_queue_t g_smp_callq[CONFIG_SMP_NCPUS];
+static volatile spinlock_t g_smp_calllock[CONFIG_SMP_NCPUS] SP_SECTION;
+
+/* The reschedule request for each CPU.  Only one may be pending at a
+ * time;  a single reschedule will consider all newly readied tasks.
+ */
+
+static struct smp_call_s g_smp_resched[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_smp_resched_handler
+ *
+ * Description:
+ *   Runs on the CPU that was asked to reschedule.  If there is a task in
+ *   the g_readytorun list that may run on this CPU and that has a higher
+ *   priority than the task running on this CPU, then move it to the
+ *   g_pendingtasks list and let up_release_pending() start it (or leave
+ *   it for sched_unlock() if pre-emption is now disabled).
+ *
+ ****************************************************************************/
+
+static void sched_smp_resched_handler(FAR void *arg)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  irqstate_t lock;
+  int me;
+
+  flags = enter_critical_section();
+  me    = this_cpu();
+  rtcb  = current_task(me);
+  lock  = sched_tasklist_lock();
+
+  /* Find the highest priority task that may run on this CPU.  The
+   * g_readytorun list is prioritized so the search may stop as soon as
+   * the priority is no longer higher than that of the running task.
+   */
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL && tcb->sched_priority > rtcb->sched_priority &&
+       !CPU_ISSET(me, &tcb->affinity);
+       tcb = (FAR struct tcb_s *)tcb->flink);
+
+  if (tcb != NULL && tcb->sched_priority <= rtcb->sched_priority)
+    {
+      /* Another CPU has already taken the task or this CPU is now running
+       * something more important.
+       */
+
+      tcb = NULL;
+    }
+
+  if (tcb != NULL)
+    {
+      dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+      (void)sched_addprioritized(tcb, (FAR dq_queue_t *)&g_pendingtasks);
+      tcb->task_state = TSTATE_TASK_PENDING;
+    }
+
+  sched_tasklist_unlock(lock);
+
+  if (tcb != NULL && !sched_islocked_global())
+    {
+      up_release_pending();
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_smp_call
+ *
+ * Description:
+ *   Queue a function to be run on another CPU and interrupt that CPU.  The
+ *   function runs in interrupt context on that CPU.  This function does
+ *   not wait for it to do so;  the caller may poll call->busy if it needs
+ *   to know when the request has been taken.  If cpu is the calling CPU,
+ *   then the function is run immediately.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU that will run the function
+ *   call - Caller-provided storage for the request
+ *   func - The function to run
+ *   arg  - The argument passed to func
+ *
+ * Returned Value:
+ *   Zero (OK) if successful.  Otherwise, a negated errno value is returned:
+ *
+ *     EBUSY  The request is still queued from a previous call.
+ *
+ ****************************************************************************/
+
+int sched_smp_call(int cpu, FAR struct smp_call_s *call,
+                   smp_callback_t func, FAR void *arg)
+{
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && call != NULL &&
+              func != NULL);
+
+  flags = up_irq_save();
+
+  if (cpu == this_cpu())
+    {
+      up_irq_restore(flags);
+      func(arg);
+      return OK;
+    }
+
+  spin_lock(&g_smp_calllock[cpu]);
+
+  if (call->busy)
+    {
+      spin_unlock(&g_smp_calllock[cpu]);
+      up_irq_restore(flags);
+      return -EBUSY;
+    }
+
+  call->func = func;
+  call->arg  = arg;
+  call->busy = true;
+  sq_addlast((FAR sq_entry_t *)call, &g_smp_callq[cpu]);
+
+  spin_unlock(&g_smp_calllock[cpu]);
+
+  /* Interrupt the other CPU.  If it is already running its queue, then it
+   * will see the new request and the interrupt will be a false alarm.
+   */
+
+  ret = up_cpu_call(cpu);
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_smp_call_handler
+ *
+ * Description:
+ *   Called by the architecture specific code from the interrupt handler of
+ *   the inter-processor interrupt generated by up_cpu_call().  It runs all
+ *   of the functions that have been queued for the calling CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_smp_call_handler(void)
+{
+  FAR struct smp_call_s *call;
+  smp_callback_t func;
+  FAR void *arg;
+  int me = this_cpu();
+
+  spin_lock(&g_smp_calllock[me]);
+
+  while ((call = (FAR struct smp_call_s *)
+                 sq_remfirst(&g_smp_callq[me])) != NULL)
+    {
+      /* Release the request before running it so that the function may
+       * re-queue it.
+       */
+
+      func       = call->func;
+      arg        = call->arg;
+      call->busy = false;
+
+      spin_unlock(&g_smp_calllock[me]);
+      func(arg);
+      spin_lock(&g_smp_calllock[me]);
+    }
+
+  spin_unlock(&g_smp_calllock[me]);
+}
+
+/****************************************************************************
+ * Name: sched_smp_reschedule
+ *
+ * Description:
+ *   Ask another CPU to reschedule itself:  A task that should preempt the
+ *   task running on that CPU has been added to the g_readytorun list.
+ *   This is used in place of up_cpu_pause() when a newly readied task is
+ *   to be started on some other CPU.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU that should reschedule
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_smp_reschedule(int cpu)
+{
+  /* -EBUSY is not an error:  The pending reschedule will also consider
+   * this task.
+   */
+
+  (void)sched_smp_call(cpu, &g_smp_resched[cpu],
+                       sched_smp_resched_handler, NULL);
+}
+
+#endif /* CONFIG_SMP_CALL */
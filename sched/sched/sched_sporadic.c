@@ -65,6 +65,17 @@
 #  define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #endif
 
+/* The admission limit for SCHED_DEADLINE threads (Q16) */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  ifdef CONFIG_SMP
+#    define DEADLINE_MAXBW \
+       (((CONFIG_SCHED_DEADLINE_MAXUTIL << 16) / 100) * CONFIG_SMP_NCPUS)
+#  else
+#    define DEADLINE_MAXBW ((CONFIG_SCHED_DEADLINE_MAXUTIL << 16) / 100)
+#  endif
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -95,6 +106,23 @@ static void sporadic_timer_cancel(FAR struct tcb_s *tcb);
 FAR struct replenishment_s *
   sporadic_alloc_repl(FAR struct sporadic_s *sporadic);
 
+/* SCHED_DEADLINE periods */
+
+#ifdef CONFIG_SCHED_DEADLINE
+static int deadline_period_start(FAR struct replenishment_s *mrepl);
+static void deadline_period_expire(int argc, wdparm_t arg1, ...);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+/* The sum of the utilization reserved by all SCHED_DEADLINE threads (Q16) */
+
+static uint32_t g_dl_bandwidth;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -150,7 +178,7 @@ static int sporadic_set_lowpriority(FAR struct tcb_s *tcb)
        * state.
        */
 
-      tcb->base_priority = tcb->low_priority;
+      tcb->base_priority = sporadic->low_priority;
     }
   else
 #endif
@@ -762,6 +790,78 @@ FAR struct replenishment_s *
   return repl;
 }
 
+/****************************************************************************
+ * Name: deadline_period_start
+ *
+ * Description:
+ *   Start the next period of a SCHED_DEADLINE thread by (1) restoring its
+ *   runtime, (2) setting the absolute deadline for the period, (3) setting
+ *   up the timer for the start of the following period, and (4) raising
+ *   the thread to the high priority.  The thread is re-positioned among
+ *   the threads of that priority according to its new deadline.
+ *
+ * Input Parameters:
+ *   mrepl - The main timer
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+static int deadline_period_start(FAR struct replenishment_s *mrepl)
+{
+  FAR struct sporadic_s *sporadic;
+  FAR struct tcb_s *tcb;
+
+  DEBUGASSERT(mrepl->tcb != NULL);
+  tcb                    = mrepl->tcb;
+  sporadic               = tcb->sporadic;
+  DEBUGASSERT(sporadic != NULL && sporadic->deadline > 0);
+
+  /* Restore the runtime and set the deadline for this period */
+
+  tcb->timeslice         = sporadic->budget;
+  sporadic->active       = mrepl;
+  mrepl->budget          = sporadic->budget;
+  sporadic->eventtime    = clock_systimer();
+  sporadic->abs_deadline = sporadic->eventtime + sporadic->deadline;
+
+  /* The period timer runs independently of the thread's execution */
+
+  DEBUGVERIFY(wd_start(&mrepl->timer, sporadic->repl_period,
+                       deadline_period_expire, 1, (wdentry_t)mrepl));
+
+  /* Then reprioritize to the higher priority */
+
+  return sporadic_set_hipriority(tcb);
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Handles the end of a SCHED_DEADLINE period by starting the next one.
+ *
+ * Input Parameters:
+ *   Standard watchdog parameters
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(int argc, wdparm_t arg1, ...)
+{
+  FAR struct replenishment_s *mrepl = (FAR struct replenishment_s *)arg1;
+
+  DEBUGASSERT(argc == 1 && mrepl != NULL &&
+              (mrepl->flags & SPORADIC_FLAG_MAIN) != 0);
+
+  DEBUGVERIFY(deadline_period_start(mrepl));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -859,6 +959,18 @@ int sched_sporadic_start(FAR struct tcb_s *tcb)
   sporadic->eventtime = clock_systimer();
   sporadic->suspended = true;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if (sporadic->deadline > 0)
+    {
+      /* Reserve the utilization admitted by sched_deadline_admit() and
+       * start the first period.
+       */
+
+      g_dl_bandwidth += sporadic->bandwidth;
+      return deadline_period_start(mrepl);
+    }
+#endif
+
   /* Then start the first interval */
 
   return sporadic_budget_start(mrepl);
@@ -954,6 +1066,16 @@ int sched_sporadic_reset(FAR struct tcb_s *tcb)
       repl->flags        = 0;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release any utilization reserved by sched_sporadic_start() */
+
+  DEBUGASSERT(g_dl_bandwidth >= sporadic->bandwidth);
+  g_dl_bandwidth        -= sporadic->bandwidth;
+  sporadic->deadline     = 0;
+  sporadic->bandwidth    = 0;
+  sporadic->abs_deadline = 0;
+#endif
+
   /* Reset sporadic scheduling parameters and state data */
 
   sporadic->suspended    = true;
@@ -1026,6 +1148,18 @@ int sched_sporadic_resume(FAR struct tcb_s *tcb)
 
   now = clock_systimer();
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The runtime of a SCHED_DEADLINE thread is consumed only while it is
+   * running.  There is nothing to replenish.
+   */
+
+  if (sporadic->deadline > 0)
+    {
+      sporadic->eventtime = now;
+      return OK;
+    }
+#endif
+
   /* Check if are in the budget portion of the replenishment interval.  We
    * know this is the case if the current timeslice is non-zero.
    */
@@ -1192,6 +1326,49 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 
   DEBUGASSERT(tcb != NULL && tcb->sporadic != NULL && ticks > 0);
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A SCHED_DEADLINE thread consumes its runtime while it runs.  When the
+   * runtime is exhausted, it drops to the low priority until the period
+   * timer starts the next period.
+   *
+   *   > 0: Runtime remaining
+   *  == 0: Throttled until the next period
+   *   < 0: Exhausted with pre-emption locked.
+   */
+
+  if (tcb->sporadic->deadline > 0)
+    {
+      if (tcb->timeslice <= 0)
+        {
+          return 0;
+        }
+
+      if (ticks < tcb->timeslice)
+        {
+          tcb->timeslice -= ticks;
+          return tcb->timeslice;
+        }
+
+      if (sched_islocked_tcb(tcb))
+        {
+          /* sched_unlock() will call sched_sporadic_lowpriority() */
+
+          tcb->timeslice = -1;
+          return 0;
+        }
+
+      if (noswitches)
+        {
+          tcb->timeslice = 1;
+          return 1;
+        }
+
+      tcb->timeslice = 0;
+      DEBUGVERIFY(sporadic_set_lowpriority(tcb));
+      return 0;
+    }
+#endif
+
   /* If we are in the low-priority phase of the replenishment interval,
    * then just return zero.
    *
@@ -1314,6 +1491,19 @@ void sched_sporadic_lowpriority(FAR struct tcb_s *tcb)
   DEBUGASSERT(tcb && tcb->sporadic);
   sporadic = tcb->sporadic;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if (sporadic->deadline > 0)
+    {
+      /* The period timer is still running.  Just throttle the thread until
+       * the next period.
+       */
+
+      tcb->timeslice = 0;
+      DEBUGVERIFY(sporadic_set_lowpriority(tcb));
+      return;
+    }
+#endif
+
   /* Enter the low-priority phase of the replenishment cycle.  (This is
    * redundant).
    */
@@ -1339,4 +1529,44 @@ void sched_sporadic_lowpriority(FAR struct tcb_s *tcb)
   DEBUGVERIFY(sporadic_interval_start(mrepl));
 }
 
+/****************************************************************************
+ * Name: sched_deadline_admit
+ *
+ * Description:
+ *   Admission control for SCHED_DEADLINE.  Check if the thread may reserve
+ *   the utilization without exceeding CONFIG_SCHED_DEADLINE_MAXUTIL.  Any
+ *   utilization that the thread already holds is assumed to be released.
+ *   Nothing is reserved here;  that is done by sched_sporadic_start().
+ *
+ * Input Parameters:
+ *   tcb       - The TCB of the thread that will use SCHED_DEADLINE
+ *   bandwidth - The requested utilization, runtime / period (Q16)
+ *
+ * Returned Value:
+ *   Zero (OK) if the thread may be admitted;  -EBUSY if not.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+int sched_deadline_admit(FAR struct tcb_s *tcb, uint32_t bandwidth)
+{
+  uint32_t total = g_dl_bandwidth;
+
+  if (tcb->sporadic != NULL)
+    {
+      total -= tcb->sporadic->bandwidth;
+    }
+
+  if (bandwidth > DEADLINE_MAXBW || total > DEADLINE_MAXBW - bandwidth)
+    {
+      return -EBUSY;
+    }
+
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_SCHED_SPORADIC */
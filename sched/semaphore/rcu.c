@@ -0,0 +1,259 @@
+/****************************************************************************
+ * sched/semaphore/rcu.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/rwlock.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrcu_wait
+ *
+ * Description:
+ *   Wait until no reader remains in a section begun in the given phase.
+ *
+ ****************************************************************************/
+
+static void nxrcu_wait(FAR struct rcu_s *rcu, int phase)
+{
+  int nreaders;
+  int cpu;
+
+  for (; ; )
+    {
+      nreaders = 0;
+      for (cpu = 0; cpu < RW_NCPUS; cpu++)
+        {
+          nreaders += rcu->readers[phase][cpu];
+        }
+
+      if (nreaders == 0)
+        {
+          break;
+        }
+
+      (void)nxsig_usleep(USEC_PER_TICK);
+    }
+
+  RW_DMB();
+}
+
+/****************************************************************************
+ * Name: nxrcu_worker
+ *
+ * Description:
+ *   Run the deferred callbacks after a grace period.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+static void nxrcu_worker(FAR void *arg)
+{
+  FAR struct rcu_s *rcu = (FAR struct rcu_s *)arg;
+  FAR struct rcu_head_s *head;
+  irqstate_t flags;
+  sq_queue_t list;
+
+  /* Callbacks deferred after this point will requeue the work */
+
+  flags = enter_critical_section();
+  list  = rcu->pending;
+  sq_init(&rcu->pending);
+  leave_critical_section(flags);
+
+  nxrcu_synchronize(rcu);
+
+  while ((head = (FAR struct rcu_head_s *)sq_remfirst(&list)) != NULL)
+    {
+      head->func(head);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrcu_init
+ *
+ * Description:
+ *   Initialize an RCU instance.
+ *
+ ****************************************************************************/
+
+void nxrcu_init(FAR struct rcu_s *rcu)
+{
+  memset(rcu, 0, sizeof(struct rcu_s));
+  (void)nxsem_init(&rcu->exclsem, 0, 1);
+}
+
+/****************************************************************************
+ * Name: nxrcu_read_lock
+ *
+ * Description:
+ *   Begin a read-side section.  This never blocks and may be nested or
+ *   called from an interrupt handler.  The returned phase must be passed
+ *   to nxrcu_read_unlock().
+ *
+ ****************************************************************************/
+
+int nxrcu_read_lock(FAR struct rcu_s *rcu)
+{
+  irqstate_t flags;
+  int phase;
+
+  flags = up_irq_save();
+  phase = rcu->phase;
+  rcu->readers[phase][this_cpu()]++;
+  up_irq_restore(flags);
+
+  RW_DMB();
+  return phase;
+}
+
+/****************************************************************************
+ * Name: nxrcu_read_unlock
+ *
+ * Description:
+ *   End a read-side section begun by nxrcu_read_lock().
+ *
+ ****************************************************************************/
+
+void nxrcu_read_unlock(FAR struct rcu_s *rcu, int phase)
+{
+  irqstate_t flags;
+
+  RW_DMB();
+
+  /* The count of this CPU may go negative if the task migrated; only the
+   * sum over all CPUs is meaningful.
+   */
+
+  flags = up_irq_save();
+  rcu->readers[phase][this_cpu()]--;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: nxrcu_synchronize
+ *
+ * Description:
+ *   Wait for a grace period:  Every read-side section that was in progress
+ *   when this function was called will have ended when it returns.  An
+ *   object unlinked before calling this function may then be freed.  This
+ *   may block and must not be called from an interrupt handler or from
+ *   within a read-side section.
+ *
+ ****************************************************************************/
+
+void nxrcu_synchronize(FAR struct rcu_s *rcu)
+{
+  int phase;
+
+  nxsem_wait_uninterruptible(&rcu->exclsem);
+
+  /* Readers that sampled the previous phase just before the last flip may
+   * still be counted there.  Let them leave before reusing that phase.
+   */
+
+  phase = rcu->phase;
+  nxrcu_wait(rcu, phase ^ 1);
+
+  /* Send new readers to the other phase and wait for the current phase to
+   * drain.
+   */
+
+  rcu->phase = phase ^ 1;
+  RW_DMB();
+  nxrcu_wait(rcu, phase);
+
+  (void)nxsem_post(&rcu->exclsem);
+}
+
+/****************************************************************************
+ * Name: nxrcu_defer
+ *
+ * Description:
+ *   Call func(head) after a grace period.  With CONFIG_SCHED_LPWORK the
+ *   callback runs on the low priority work queue and this function does
+ *   not block; callbacks deferred close together share a grace period.
+ *   Otherwise, this function waits for the grace period itself.
+ *
+ ****************************************************************************/
+
+void nxrcu_defer(FAR struct rcu_s *rcu, FAR struct rcu_head_s *head,
+                 rcu_callback_t func)
+{
+#ifdef CONFIG_SCHED_LPWORK
+  irqstate_t flags;
+#endif
+
+  head->func = func;
+
+#ifdef CONFIG_SCHED_LPWORK
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)head, &rcu->pending);
+  if (work_available(&rcu->work))
+    {
+      (void)work_queue(LPWORK, &rcu->work, nxrcu_worker, rcu, 0);
+    }
+
+  leave_critical_section(flags);
+#else
+  nxrcu_synchronize(rcu);
+  func(head);
+#endif
+}
@@ -0,0 +1,290 @@
+/****************************************************************************
+ * sched/semaphore/rwlock.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/rwlock.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwlock_nreaders
+ *
+ * Description:
+ *   Return the total number of readers holding the lock on all CPUs.
+ *
+ ****************************************************************************/
+
+static int nxrwlock_nreaders(FAR struct rwlock_s *rwl)
+{
+  int nreaders = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < RW_NCPUS; cpu++)
+    {
+      nreaders += rwl->readers[cpu];
+    }
+
+  return nreaders;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwlock_init
+ *
+ * Description:
+ *   Initialize a reader-writer lock.
+ *
+ ****************************************************************************/
+
+void nxrwlock_init(FAR struct rwlock_s *rwl)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < RW_NCPUS; cpu++)
+    {
+      rwl->readers[cpu] = 0;
+    }
+
+  rwl->nwriters = 0;
+  rwl->nrdwait  = 0;
+
+  /* rdwait and wrwait are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&rwl->wrexcl, 0, 1);
+  (void)nxsem_init(&rwl->rdwait, 0, 0);
+  (void)nxsem_init(&rwl->wrwait, 0, 0);
+  (void)nxsem_setprotocol(&rwl->rdwait, SEM_PRIO_NONE);
+  (void)nxsem_setprotocol(&rwl->wrwait, SEM_PRIO_NONE);
+}
+
+/****************************************************************************
+ * Name: nxrwlock_destroy
+ *
+ * Description:
+ *   Release the resources used by an unlocked reader-writer lock.
+ *
+ ****************************************************************************/
+
+void nxrwlock_destroy(FAR struct rwlock_s *rwl)
+{
+  DEBUGASSERT(rwl->nwriters == 0 && nxrwlock_nreaders(rwl) == 0);
+
+  (void)nxsem_destroy(&rwl->wrexcl);
+  (void)nxsem_destroy(&rwl->rdwait);
+  (void)nxsem_destroy(&rwl->wrwait);
+}
+
+/****************************************************************************
+ * Name: nxrwlock_tryrdlock
+ *
+ * Description:
+ *   Take the lock for reading if no writer holds or is waiting for it.
+ *   This never blocks so it may be called from an interrupt handler.  The
+ *   reader count of the current CPU is modified with interrupts disabled;
+ *   no shared cache line is written when there are no writers.
+ *
+ ****************************************************************************/
+
+bool nxrwlock_tryrdlock(FAR struct rwlock_s *rwl)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  rwl->readers[cpu]++;
+  RW_DMB();
+
+  if (rwl->nwriters == 0)
+    {
+      up_irq_restore(flags);
+      return true;
+    }
+
+  /* A writer got here first.  Back out and let the writer know that the
+   * reader count changed.
+   */
+
+  rwl->readers[cpu]--;
+  up_irq_restore(flags);
+
+  (void)nxsem_post(&rwl->wrwait);
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxrwlock_rdlock
+ *
+ * Description:
+ *   Take the lock for reading, waiting while any writer holds or is
+ *   waiting for the lock.  Writers are preferred so that a steady stream
+ *   of readers cannot starve them.
+ *
+ ****************************************************************************/
+
+void nxrwlock_rdlock(FAR struct rwlock_s *rwl)
+{
+  irqstate_t flags;
+
+  while (!nxrwlock_tryrdlock(rwl))
+    {
+      /* Wait for the last writer to release the lock.  nwriters and
+       * nrdwait are only modified inside of the critical section.
+       */
+
+      flags = enter_critical_section();
+      if (rwl->nwriters > 0)
+        {
+          rwl->nrdwait++;
+          nxsem_wait_uninterruptible(&rwl->rdwait);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: nxrwlock_rdunlock
+ *
+ * Description:
+ *   Release a read lock taken by nxrwlock_rdlock() or nxrwlock_tryrdlock().
+ *
+ ****************************************************************************/
+
+void nxrwlock_rdunlock(FAR struct rwlock_s *rwl)
+{
+  irqstate_t flags;
+  int16_t nwriters;
+
+  /* The task may have migrated since it took the lock so the count of this
+   * CPU may go negative.  Only the sum over all CPUs is meaningful.
+   */
+
+  flags = up_irq_save();
+  RW_DMB();
+  rwl->readers[this_cpu()]--;
+  RW_DMB();
+  nwriters = rwl->nwriters;
+  up_irq_restore(flags);
+
+  if (nwriters > 0)
+    {
+      (void)nxsem_post(&rwl->wrwait);
+    }
+}
+
+/****************************************************************************
+ * Name: nxrwlock_wrlock
+ *
+ * Description:
+ *   Take the lock for writing.  New readers are held off immediately; the
+ *   writer then waits for readers already inside to leave.
+ *
+ ****************************************************************************/
+
+void nxrwlock_wrlock(FAR struct rwlock_s *rwl)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  rwl->nwriters++;
+  leave_critical_section(flags);
+  RW_DMB();
+
+  nxsem_wait_uninterruptible(&rwl->wrexcl);
+
+  /* Each departing reader posts wrwait.  Counts left over from earlier
+   * writers only cause an extra pass through this loop.
+   */
+
+  while (nxrwlock_nreaders(rwl) > 0)
+    {
+      nxsem_wait_uninterruptible(&rwl->wrwait);
+      RW_DMB();
+    }
+}
+
+/****************************************************************************
+ * Name: nxrwlock_wrunlock
+ *
+ * Description:
+ *   Release a write lock.  If no other writer is waiting, all waiting
+ *   readers are released.
+ *
+ ****************************************************************************/
+
+void nxrwlock_wrunlock(FAR struct rwlock_s *rwl)
+{
+  irqstate_t flags;
+
+  RW_DMB();
+
+  flags = enter_critical_section();
+  DEBUGASSERT(rwl->nwriters > 0);
+
+  if (--rwl->nwriters == 0)
+    {
+      while (rwl->nrdwait > 0)
+        {
+          rwl->nrdwait--;
+          (void)nxsem_post(&rwl->rdwait);
+        }
+    }
+
+  leave_critical_section(flags);
+  (void)nxsem_post(&rwl->wrexcl);
+}
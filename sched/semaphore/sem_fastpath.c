@@ -0,0 +1,153 @@
+/****************************************************************************
+ * sched/semaphore/sem_fastpath.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <semaphore.h>
+
+#include <nuttx/arch.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_FASTPATH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Semaphores with priority inheritance must track the holder of each count
+ * and can never use the fast path.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define NXSEM_FASTPATH_OK(s) (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#else
+#  define NXSEM_FASTPATH_OK(s) (true)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_fasttake
+ *
+ * Description:
+ *   Try to take a count on the semaphore without entering a critical
+ *   section.  This succeeds only if a count is available.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor.
+ *
+ * Returned Value:
+ *   True if a count was taken.  False if the caller must fall back to the
+ *   normal, critical section logic.
+ *
+ * Assumptions:
+ *   All other modifications of semcount are performed in a critical
+ *   section on the same (single) CPU.  Any interruption between the load
+ *   and the store of up_cmpxchg16() causes the store to fail and the
+ *   compare and exchange to be retried.
+ *
+ ****************************************************************************/
+
+bool nxsem_fasttake(FAR sem_t *sem)
+{
+  int16_t count;
+
+  if (!NXSEM_FASTPATH_OK(sem))
+    {
+      return false;
+    }
+
+  do
+    {
+      count = sem->semcount;
+      if (count <= 0)
+        {
+          return false;
+        }
+    }
+  while (!up_cmpxchg16(&sem->semcount, count, count - 1));
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxsem_fastgive
+ *
+ * Description:
+ *   Try to give a count to the semaphore without entering a critical
+ *   section.  This succeeds only if no thread is waiting for the semaphore.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor.
+ *
+ * Returned Value:
+ *   True if the count was given.  False if the caller must fall back to
+ *   the normal, critical section logic.
+ *
+ ****************************************************************************/
+
+bool nxsem_fastgive(FAR sem_t *sem)
+{
+  int16_t count;
+
+  if (!NXSEM_FASTPATH_OK(sem))
+    {
+      return false;
+    }
+
+  do
+    {
+      count = sem->semcount;
+      if (count < 0 || count >= SEM_VALUE_MAX)
+        {
+          return false;
+        }
+    }
+  while (!up_cmpxchg16(&sem->semcount, count, count + 1));
+
+  return true;
+}
+
+#endif /* CONFIG_SEM_FASTPATH */
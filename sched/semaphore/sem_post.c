@@ -94,6 +94,24 @@ int nxsem_post(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+#ifdef CONFIG_SCHED_LOCKSTAT
+      /* Record the release if the posting thread is the holder */
+
+      if (NXSEM_LOCKSTAT(sem))
+        {
+          sched_lockstat_release(sem);
+        }
+#endif
+
+      /* If no thread is waiting, just give the count without entering a
+       * critical section, if possible.
+       */
+
+      if (nxsem_fastgive(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -90,6 +90,15 @@ int nxsem_trywait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+      /* Take an available count without entering a critical section, if
+       * possible.
+       */
+
+      if (nxsem_fasttake(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts disabled
        * because sem_post() may be called from an interrupt handler.
        */
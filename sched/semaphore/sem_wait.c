@@ -88,11 +88,30 @@ int nxsem_wait(FAR sem_t *sem)
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
   int ret = -EINVAL;
+#ifdef CONFIG_SCHED_LOCKSTAT
+  uint32_t wstart = 0;
+#endif
 
   /* This API should not be called from interrupt handlers */
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+  /* Take an available count without entering a critical section, if
+   * possible.
+   */
+
+  if (sem != NULL && nxsem_fasttake(sem))
+    {
+#ifdef CONFIG_SCHED_LOCKSTAT
+      if (NXSEM_LOCKSTAT(sem))
+        {
+          sched_lockstat_acquire(sem, LOCKSTAT_SEM, 0, LOCKSTAT_SITE());
+        }
+#endif
+
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -169,6 +188,9 @@ int nxsem_wait(FAR sem_t *sem)
            */
 
           DEBUGASSERT(NULL != rtcb->flink);
+#ifdef CONFIG_SCHED_LOCKSTAT
+          wstart = sched_lockstat_gettime();
+#endif
           up_block_task(rtcb, TSTATE_WAIT_SEM);
 
           /* When we resume at this point, either (1) the semaphore has been
@@ -208,6 +230,16 @@ int nxsem_wait(FAR sem_t *sem)
           sched_unlock();
 #endif
         }
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+      /* Record the acquisition.  wstart is zero if we did not wait. */
+
+      if (ret == OK && NXSEM_LOCKSTAT(sem))
+        {
+          sched_lockstat_acquire(sem, LOCKSTAT_SEM, wstart,
+                                 LOCKSTAT_SITE());
+        }
+#endif
     }
 
   leave_critical_section(flags);
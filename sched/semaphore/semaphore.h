@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+#include <nuttx/spinlock.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -109,6 +110,39 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define nxsem_canceled(stcb,sem)
 #endif
 
+/* Memory barrier used by the reader-writer, sequence, and RCU locks.  On
+ * a single CPU, disabling interrupts is sufficient.
+ */
+
+#ifdef CONFIG_SPINLOCK
+#  define RW_DMB()  SP_DMB()
+#else
+#  define RW_DMB()
+#endif
+
+/* Lock contention profiling.  Semaphores with priority inheritance
+ * disabled are used for signaling and are not recorded.
+ */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+#  ifdef CONFIG_PRIORITY_INHERITANCE
+#    define NXSEM_LOCKSTAT(sem) \
+       (((sem)->flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+#  else
+#    define NXSEM_LOCKSTAT(sem) (true)
+#  endif
+#endif
+
+/* Uncontended fast path (see sem_fastpath.c) */
+
+#ifdef CONFIG_SEM_FASTPATH
+bool nxsem_fasttake(FAR sem_t *sem);
+bool nxsem_fastgive(FAR sem_t *sem);
+#else
+#  define nxsem_fasttake(sem) (false)
+#  define nxsem_fastgive(sem) (false)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
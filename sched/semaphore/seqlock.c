@@ -0,0 +1,138 @@
+/****************************************************************************
+ * sched/semaphore/seqlock.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/rwlock.h>
+
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxseq_init
+ *
+ * Description:
+ *   Initialize a sequence lock.
+ *
+ ****************************************************************************/
+
+void nxseq_init(FAR struct seqlock_s *sl)
+{
+  sl->sequence = 0;
+}
+
+/****************************************************************************
+ * Name: nxseq_read_begin
+ *
+ * Description:
+ *   Begin a read-side section and return the sequence number to be passed
+ *   to nxseq_read_retry().  If a write is in progress on another CPU, this
+ *   spins until that write completes.  Writers hold a critical section, so
+ *   this cannot spin on a writer running on the same CPU.
+ *
+ ****************************************************************************/
+
+uint32_t nxseq_read_begin(FAR struct seqlock_s *sl)
+{
+  uint32_t seq;
+
+  while (((seq = sl->sequence) & 1) != 0)
+    {
+    }
+
+  RW_DMB();
+  return seq;
+}
+
+/****************************************************************************
+ * Name: nxseq_read_retry
+ *
+ * Description:
+ *   Return true if a write occurred since nxseq_read_begin() returned seq.
+ *   In that case, the data read may be inconsistent and must be read
+ *   again.
+ *
+ ****************************************************************************/
+
+bool nxseq_read_retry(FAR struct seqlock_s *sl, uint32_t seq)
+{
+  RW_DMB();
+  return sl->sequence != seq;
+}
+
+/****************************************************************************
+ * Name: nxseq_write_lock
+ *
+ * Description:
+ *   Begin a write-side section.  Writers are serialized by the critical
+ *   section which is held until nxseq_write_unlock().
+ *
+ ****************************************************************************/
+
+irqstate_t nxseq_write_lock(FAR struct seqlock_s *sl)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  sl->sequence++;
+  RW_DMB();
+  return flags;
+}
+
+/****************************************************************************
+ * Name: nxseq_write_unlock
+ *
+ * Description:
+ *   End a write-side section begun by nxseq_write_lock().
+ *
+ ****************************************************************************/
+
+void nxseq_write_unlock(FAR struct seqlock_s *sl, irqstate_t flags)
+{
+  RW_DMB();
+  sl->sequence++;
+  leave_critical_section(flags);
+}
@@ -120,6 +120,10 @@ void spin_initializer(FAR struct spinlock_s *lock)
 
 void spin_lock(FAR volatile spinlock_t *lock)
 {
+#ifdef CONFIG_SCHED_LOCKSTAT
+  uint32_t wstart = 0;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we are waiting for a spinlock */
 
@@ -128,6 +132,15 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
   while (up_testset(lock) == SP_LOCKED)
     {
+#ifdef CONFIG_SCHED_LOCKSTAT
+      /* Note when we started to wait for the spinlock */
+
+      if (wstart == 0)
+        {
+          wstart = sched_lockstat_gettime();
+        }
+#endif
+
       SP_DSB();
     }
 
@@ -135,6 +148,10 @@ void spin_lock(FAR volatile spinlock_t *lock)
   /* Notify that we have the spinlock */
 
   sched_note_spinlocked(this_task(), lock);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+  sched_lockstat_acquire((FAR const void *)lock, LOCKSTAT_SPINLOCK, wstart,
+                         LOCKSTAT_SITE());
 #endif
   SP_DMB();
 }
@@ -196,6 +213,9 @@ void spin_unlock(FAR volatile spinlock_t *lock)
 
   sched_note_spinunlock(this_task(), lock);
 #endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+  sched_lockstat_release((FAR const void *)lock);
+#endif
 
   SP_DMB();
   *lock = SP_UNLOCKED;
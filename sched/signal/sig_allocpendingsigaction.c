@@ -101,7 +101,11 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
 
           if (!sigq)
             {
+#ifdef CONFIG_MM_SLAB
+              sigq = (FAR sigq_t *)slab_alloc(&g_sigqcache);
+#else
               sigq = (FAR sigq_t *)kmm_malloc((sizeof (sigq_t)));
+#endif
             }
 
           /* Check if we got an allocated message */
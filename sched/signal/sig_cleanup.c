@@ -107,6 +107,18 @@ void nxsig_release(FAR struct task_group_s *group)
 
   while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingq)) != NULL)
     {
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(group, sigpend);
     }
+
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* Free the pending signal structures reserved for the group */
+
+  if (group->tg_sigpendalloc != NULL)
+    {
+      sched_kfree(group->tg_sigpendalloc);
+      group->tg_sigpendalloc = NULL;
+    }
+
+  sq_init(&group->tg_sigpendfree);
+#endif
 }
@@ -124,11 +124,14 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
  * Name: nxsig_alloc_pendingsignal
  *
  * Description:
- *   Allocate a pending signal list entry
+ *   Allocate a pending signal list entry.  Entries reserved for the group
+ *   are used first, then the shared pre-allocated entries.  If 'dynamic'
+ *   is false, then no entry will be allocated from the heap.
  *
  ****************************************************************************/
 
-static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
+static FAR sigpendq_t *
+  nxsig_alloc_pendingsignal(FAR struct task_group_s *group, bool dynamic)
 {
   FAR sigpendq_t *sigpend;
   irqstate_t      flags;
@@ -137,9 +140,17 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 
   if (up_interrupt_context())
     {
-      /* Try to get the pending signal structure from the free list */
+      /* Try to get the pending signal structure from the free lists */
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+      sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendfree);
+      if (!sigpend)
+        {
+          sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
+        }
+#else
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
+#endif
       if (!sigpend)
         {
           /* If no pending signal structure is available in the free list,
@@ -157,22 +168,31 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 
   else
     {
-      /* Try to get the pending signal structure from the free list */
+      /* Try to get the pending signal structure from the free lists */
 
       flags = enter_critical_section();
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+      sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendfree);
+      if (!sigpend)
+        {
+          sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
+        }
+#else
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
+#endif
       leave_critical_section(flags);
 
       /* Check if we got one. */
 
-      if (!sigpend)
+      if (!sigpend && dynamic)
         {
           /* No... Allocate the pending signal */
 
-          if (!sigpend)
-            {
-              sigpend = (FAR sigpendq_t *)kmm_malloc((sizeof (sigpendq_t)));
-            }
+#ifdef CONFIG_MM_SLAB
+          sigpend = (FAR sigpendq_t *)slab_alloc(&g_sigpendcache);
+#else
+          sigpend = (FAR sigpendq_t *)kmm_malloc((sizeof (sigpendq_t)));
+#endif
 
           /* Check if we got an allocated message */
 
@@ -220,10 +240,14 @@ static FAR sigpendq_t *
  * Name: nxsig_add_pendingsignal
  *
  * Description:
- *   Add the specified signal to the signal pending list. NOTE:  This
- *   function will queue only one entry for each pending signal.  This
- *   was done intentionally so that a run-away sender cannot consume
- *   all of memory.
+ *   Add the specified signal to the signal pending list.
+ *
+ *   Signals from sigqueue(), asynchronous I/O and message queues carry a
+ *   value that the receiver needs, so each one is queued in the order that
+ *   it was sent.  Other signals (and queued signals that find
+ *   no pre-allocated entry) keep only one entry for each pending signal
+ *   number.  That was done intentionally so that a run-away sender cannot
+ *   consume all of memory.
  *
  ****************************************************************************/
 
@@ -233,13 +257,32 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
   FAR struct task_group_s *group;
   FAR sigpendq_t *sigpend;
   irqstate_t flags;
+  bool queued;
 
   DEBUGASSERT(stcb != NULL && stcb->group != NULL);
   group = stcb->group;
 
   /* Check if the signal is already pending for the group */
 
+  queued  = (info->si_code == SI_QUEUE || info->si_code == SI_ASYNCIO ||
+             info->si_code == SI_MESGQ);
   sigpend = nxsig_find_pendingsignal(group, info->si_signo);
+  if (sigpend != NULL && queued)
+    {
+      /* Queue another instance if there is a pre-allocated entry */
+
+      FAR sigpendq_t *newsig = nxsig_alloc_pendingsignal(group, false);
+      if (newsig != NULL)
+        {
+          memcpy(&newsig->info, info, sizeof(siginfo_t));
+
+          flags = enter_critical_section();
+          sq_addlast((FAR sq_entry_t *)newsig, &group->tg_sigpendingq);
+          leave_critical_section(flags);
+          return;
+        }
+    }
+
   if (sigpend != NULL)
     {
       /* The signal is already pending... retain only one copy */
@@ -253,7 +296,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
     {
       /* Allocate a new pending signal entry */
 
-      sigpend = nxsig_alloc_pendingsignal();
+      sigpend = nxsig_alloc_pendingsignal(group, true);
       if (sigpend != NULL)
         {
           /* Put the signal information into the allocated structure */
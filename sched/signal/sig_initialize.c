@@ -81,6 +81,15 @@ sq_queue_t  g_sigpendingsignal;
 
 sq_queue_t  g_sigpendingirqsignal;
 
+#ifdef CONFIG_MM_SLAB
+/* Pending signal actions and pending signals that are allocated when the
+ * free lists are exhausted come from these caches.
+ */
+
+struct slab_cache_s g_sigqcache;
+struct slab_cache_s g_sigpendcache;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -180,7 +189,7 @@ static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
     (FAR sigpendq_t *)kmm_malloc((sizeof(sigpendq_t)) * nsigs);
 
   sigpend = sigpendalloc;
-  for (i = 0; i < nsigs; i++)
+  for (i = 0; sigpend != NULL && i < nsigs; i++)
     {
       sigpend->type = sigtype;
       sq_addlast((FAR sq_entry_t *)sigpend++, siglist);
@@ -234,7 +243,39 @@ void nxsig_initialize(void)
     nxsig_alloc_pendingsignalblock(&g_sigpendingirqsignal,
                                    NUM_INT_SIGNALS_PENDING,
                                    SIG_ALLOC_IRQ);
+
+#ifdef CONFIG_MM_SLAB
+  /* Initialize the caches used when the free lists are exhausted */
+
+  slab_initialize(&g_sigqcache, "sigq", sizeof(sigq_t),
+                  CONFIG_MM_SLAB_NPERSLAB);
+  slab_initialize(&g_sigpendcache, "sigpendq", sizeof(sigpendq_t),
+                  CONFIG_MM_SLAB_NPERSLAB);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsig_initgroup
+ *
+ * Description:
+ *   Allocate the block of pending signal structures reserved for a new
+ *   task group.  Signals posted to the group are taken from this pool
+ *   before the shared free lists so that one busy group cannot starve the
+ *   others.  If the block cannot be allocated, the group simply uses the
+ *   shared lists.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+void nxsig_initgroup(FAR struct task_group_s *group)
+{
+  sq_init(&group->tg_sigpendfree);
+  group->tg_sigpendalloc =
+    nxsig_alloc_pendingsignalblock(&group->tg_sigpendfree,
+                                   CONFIG_SIG_PREALLOC_GROUP,
+                                   SIG_ALLOC_GROUP);
 }
+#endif
 
 /****************************************************************************
  * Name: nxsig_alloc_actionblock
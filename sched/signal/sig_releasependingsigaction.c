@@ -96,6 +96,10 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
 
   else if (sigq->type == SIG_ALLOC_DYN)
     {
+#ifdef CONFIG_MM_SLAB
+      slab_free(&g_sigqcache, sigq);
+#else
       sched_kfree(sigq);
+#endif
     }
 }
@@ -61,11 +61,13 @@
  * Name: nxsig_release_pendingsignal
  *
  * Description:
- *   Deallocate a pending signal list entry
+ *   Deallocate a pending signal list entry.  The group is the task group
+ *   whose pending signal list held the entry.
  *
  ****************************************************************************/
 
-void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
+void nxsig_release_pendingsignal(FAR struct task_group_s *group,
+                                 FAR sigpendq_t *sigpend)
 {
   irqstate_t flags;
 
@@ -99,6 +101,19 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
       leave_critical_section(flags);
     }
 
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+  /* If this was reserved for the group, then return it to the group */
+
+  else if (sigpend->type == SIG_ALLOC_GROUP)
+    {
+      DEBUGASSERT(group != NULL);
+
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendfree);
+      leave_critical_section(flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate signals because they will not
    * receive them.
@@ -106,6 +121,10 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
 
   else if (sigpend->type == SIG_ALLOC_DYN)
     {
+#ifdef CONFIG_MM_SLAB
+      slab_free(&g_sigpendcache, sigpend);
+#else
       sched_kfree(sigpend);
+#endif
     }
 }
@@ -285,7 +285,7 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Then dispose of the pending signal structure properly */
 
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(rtcb->group, sigpend);
       leave_critical_section(flags);
     }
 
@@ -96,16 +96,16 @@ bool nxsig_unmask_pendingsignal(void)
       signo = nxsig_lowest(&unmaskedset);
       if (signo != ERROR)
         {
-          /* Remove the signal from the set of unmasked signals.  NOTE:
-           * this implicitly assumes that only one instance for a given
-           * signal number is pending.
-           */
+          /* Remove the signal from the set of unmasked signals */
 
           sigdelset(&unmaskedset, signo);
 
-          /* Remove the pending signal from the list of pending signals */
+          /* Remove each pending instance of the signal from the list of
+           * pending signals.  Queued signals may have more than one.
+           */
 
-          if ((pendingsig = nxsig_remove_pendingsignal(rtcb, signo)) != NULL)
+          while ((pendingsig = nxsig_remove_pendingsignal(rtcb, signo)) !=
+                 NULL)
             {
               /* If there is one, then process it like a normal signal.
                * Since the signal was pending, then unblocked on this
@@ -118,7 +118,7 @@ bool nxsig_unmask_pendingsignal(void)
 
               /* Then remove it from the pending signal list */
 
-              nxsig_release_pendingsignal(pendingsig);
+              nxsig_release_pendingsignal(rtcb->group, pendingsig);
             }
         }
     }
@@ -49,6 +49,7 @@
 #include <sched.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/slab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -74,7 +75,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_GROUP       /* Preallocated, reserved for one task group */
 };
 
 /* The following defines the sigaction queue entry */
@@ -153,6 +155,15 @@ extern sq_queue_t  g_sigpendingsignal;
 
 extern sq_queue_t  g_sigpendingirqsignal;
 
+#ifdef CONFIG_MM_SLAB
+/* Pending signal actions and pending signals that are allocated when the
+ * free lists are exhausted come from these caches.
+ */
+
+extern struct slab_cache_s g_sigqcache;
+extern struct slab_cache_s g_sigpendcache;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -165,6 +176,9 @@ struct task_group_s;
 /* sig_initializee.c */
 
 void weak_function nxsig_initialize(void);
+#if CONFIG_SIG_PREALLOC_GROUP > 0
+void               nxsig_initgroup(FAR struct task_group_s *group);
+#endif
 void               nxsig_alloc_actionblock(void);
 
 /* sig_action.c */
@@ -211,7 +225,8 @@ int                nxsig_lowest(FAR sigset_t *set);
 int                nxsig_evthread(pid_t pid, FAR struct sigevent *event);
 #endif
 void               nxsig_release_pendingsigaction(FAR sigq_t *sigq);
-void               nxsig_release_pendingsignal(FAR sigpendq_t *sigpend);
+void               nxsig_release_pendingsignal(FAR struct task_group_s *group,
+                                               FAR sigpendq_t *sigpend);
 FAR sigpendq_t    *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo);
 bool               nxsig_unmask_pendingsignal(void);
 
@@ -93,7 +93,11 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
+#ifdef CONFIG_MM_SLAB
+  tcb = (FAR struct task_tcb_s *)slab_zalloc(&g_tcbcache);
+#else
   tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+#endif
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
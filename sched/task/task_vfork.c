@@ -307,7 +307,11 @@ FAR struct task_tcb_s *task_vforksetup(start_t retaddr, size_t *argsize)
 
   /* Allocate a TCB for the child task. */
 
+#ifdef CONFIG_MM_SLAB
+  child = (FAR struct task_tcb_s *)slab_zalloc(&g_tcbcache);
+#else
   child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+#endif
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -48,12 +48,14 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/wdog.h>
+#include <nuttx/timers/hrtimer.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define PT_FLAGS_PREALLOCATED 0x01 /* Timer comes from a pool of preallocated timers */
+#define PT_FLAGS_HRTIMER      0x02 /* Timer uses pt_hrtimer, not pt_wdog */
 
 /****************************************************************************
  * Public Types
@@ -72,6 +74,10 @@ struct posix_timer_s
   int             pt_last;         /* Last value used to set watchdog */
   WDOG_ID         pt_wdog;         /* The watchdog that provides the timing */
   struct sigevent pt_event;        /* Notification information */
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* Provides CLOCK_MONOTONIC timing */
+  uint64_t        pt_interval;     /* Reload interval in nanoseconds */
+#endif
 };
 
 /****************************************************************************
@@ -99,4 +105,8 @@ void weak_function timer_initialize(void);
 void weak_function timer_deleteall(pid_t pid);
 int timer_release(FAR struct posix_timer_s *timer);
 
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+uint64_t timer_hrexpired(FAR struct hrtimer_s *hrtimer);
+#endif
+
 #endif /* __SCHED_TIMER_TIMER_H */
@@ -170,11 +170,18 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
                  FAR timer_t *timerid)
 {
   FAR struct posix_timer_s *ret;
-  WDOG_ID wdog;
+  WDOG_ID wdog = NULL;
 
-  /* Sanity checks.  Also, we support only CLOCK_REALTIME */
+  /* Sanity checks.  Also, we support only CLOCK_REALTIME (and, with the
+   * high resolution timers, CLOCK_MONOTONIC).
+   */
 
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  if (timerid == NULL ||
+      (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC))
+#else
   if (timerid == NULL || clockid != CLOCK_REALTIME)
+#endif
     {
       set_errno(EINVAL);
       return ERROR;
@@ -182,11 +189,14 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
 
   /* Allocate a watchdog to provide the underling CLOCK_REALTIME timer */
 
-  wdog = wd_create();
-  if (!wdog)
+  if (clockid == CLOCK_REALTIME)
     {
-      set_errno(EAGAIN);
-      return ERROR;
+      wdog = wd_create();
+      if (!wdog)
+        {
+          set_errno(EAGAIN);
+          return ERROR;
+        }
     }
 
   /* Allocate a timer instance to contain the watchdog */
@@ -194,7 +204,11 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret = timer_allocate();
   if (!ret)
     {
-      wd_delete(wdog);
+      if (wdog != NULL)
+        {
+          wd_delete(wdog);
+        }
+
       set_errno(EAGAIN);
       return ERROR;
     }
@@ -206,6 +220,15 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
 
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  if (wdog == NULL)
+    {
+      ret->pt_flags   |= PT_FLAGS_HRTIMER;
+      ret->pt_interval = 0;
+      hrtimer_init(&ret->pt_hrtimer, timer_hrexpired, ret);
+    }
+#endif
+
   /* Was a struct sigevent provided? */
 
   if (evp)
@@ -94,6 +94,19 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
       return ERROR;
     }
 
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  if ((timer->pt_flags & PT_FLAGS_HRTIMER) != 0)
+    {
+      uint64_t ns = hrtimer_remaining(&timer->pt_hrtimer);
+
+      value->it_value.tv_sec     = ns / NSEC_PER_SEC;
+      value->it_value.tv_nsec    = ns % NSEC_PER_SEC;
+      value->it_interval.tv_sec  = timer->pt_interval / NSEC_PER_SEC;
+      value->it_interval.tv_nsec = timer->pt_interval % NSEC_PER_SEC;
+      return OK;
+    }
+#endif
+
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(timer->pt_wdog);
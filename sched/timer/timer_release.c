@@ -138,7 +138,16 @@ int timer_release(FAR struct posix_timer_s *timer)
    * watchdog logic before it is actually deleted)
    */
 
-  (void)wd_delete(timer->pt_wdog);
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  if ((timer->pt_flags & PT_FLAGS_HRTIMER) != 0)
+    {
+      (void)hrtimer_cancel(&timer->pt_hrtimer);
+    }
+  else
+#endif
+    {
+      (void)wd_delete(timer->pt_wdog);
+    }
 
   /* Release the timer structure */
 
@@ -197,10 +197,112 @@ static void timer_timeout(int argc, wdparm_t itimer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_hrsettime
+ *
+ * Description:
+ *   timer_settime() for a CLOCK_MONOTONIC timer that uses the high
+ *   resolution timers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+static int timer_hrsettime(FAR struct posix_timer_s *timer, int flags,
+                           FAR const struct itimerspec *value)
+{
+  struct timespec now;
+  uint64_t delay;
+  uint64_t abstime;
+
+  /* Disarm the timer */
+
+  (void)hrtimer_cancel(&timer->pt_hrtimer);
+
+  /* If it_value is zero, the timer will not be re-armed */
+
+  if (value->it_value.tv_sec <= 0 && value->it_value.tv_nsec <= 0)
+    {
+      return OK;
+    }
+
+  timer->pt_interval = (uint64_t)value->it_interval.tv_sec * NSEC_PER_SEC +
+                       value->it_interval.tv_nsec;
+  delay = (uint64_t)value->it_value.tv_sec * NSEC_PER_SEC +
+          value->it_value.tv_nsec;
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Convert the absolute CLOCK_MONOTONIC time to a delay */
+
+      (void)clock_gettime(CLOCK_MONOTONIC, &now);
+      abstime = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+      delay   = delay > abstime ? delay - abstime : 0;
+    }
+
+  /* If the time is in the past or now, then set up the next interval
+   * instead (assuming a repetitive timer).
+   */
+
+  if (delay == 0)
+    {
+      delay = timer->pt_interval;
+    }
+
+  if (delay == 0)
+    {
+      return OK;
+    }
+
+  return hrtimer_start(&timer->pt_hrtimer, delay, 0, HRTIMER_MODE_REL);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: timer_hrexpired
+ *
+ * Description:
+ *   Called when the high resolution timer of a CLOCK_MONOTONIC timer
+ *   expires.  Returns the reload interval (zero for a one-shot timer or if
+ *   the timer was deleted).
+ *
+ * Assumptions:
+ *   This function executes in the context of the timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+uint64_t timer_hrexpired(FAR struct hrtimer_s *hrtimer)
+{
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)hrtimer->arg;
+
+  /* Send the specified signal to the specified task.   Increment the
+   * reference count on the timer first so that will not be deleted until
+   * after the signal handler returns.
+   */
+
+  timer->pt_crefs++;
+  timer_signotify(timer);
+
+  /* Release the reference.  timer_release will return nonzero if the timer
+   * was not deleted.
+   */
+
+  if (timer_release(timer))
+    {
+      return timer->pt_interval;
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: timer_settime
  *
@@ -282,6 +384,20 @@ int timer_settime(timer_t timerid, int flags,
       return ERROR;
     }
 
+#ifdef CONFIG_POSIX_TIMER_HRTIMER
+  if ((timer->pt_flags & PT_FLAGS_HRTIMER) != 0)
+    {
+      ret = timer_hrsettime(timer, flags, value);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Disarm the timer (in case the timer was already armed when timer_settime()
    * is called).
    */
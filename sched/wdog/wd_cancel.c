@@ -73,8 +73,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -90,6 +92,16 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* Remove the watchdog from its wheel slot.  If the slot is now empty,
+       * the time of the next event may have changed.
+       */
+
+      if (wd_wheel_remove(wdog))
+        {
+          sched_timer_reassess();
+        }
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -139,6 +151,7 @@ int wd_cancel(WDOG_ID wdog)
 
           sched_timer_reassess();
         }
+#endif
 
       /* Mark the watchdog inactive */
 
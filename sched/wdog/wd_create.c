@@ -120,7 +120,7 @@ WDOG_ID wd_create (void)
 
   /* We are in a normal tasking context AND there are not enough unreserved,
    * pre-allocated watchdog timers.  We need to allocate one from the kernel
-   * heap.
+   * heap (or from the watchdog cache).
    */
 
   else
@@ -128,7 +128,11 @@ WDOG_ID wd_create (void)
       /* We do not require that interrupts be disabled to do this. */
 
       leave_critical_section(flags);
+#ifdef CONFIG_MM_SLAB
+      wdog = (FAR struct wdog_s *)slab_alloc(&g_wdcache);
+#else
       wdog = (FAR struct wdog_s *)kmm_malloc(sizeof(struct wdog_s));
+#endif
 
       /* Did we get one? */
 
@@ -106,13 +106,18 @@ int wd_delete(WDOG_ID wdog)
       /* It was allocated from the heap.  Use sched_kfree() to release the
        * memory.  If the timer was released from an interrupt handler,
        * sched_kfree() will defer the actual deallocation of the memory
-       * until a more appropriate time.
+       * until a more appropriate time.  If it came from the watchdog
+       * cache, it can be returned to the cache immediately.
        *
        * We don't need interrupts disabled to do this.
        */
 
       leave_critical_section(flags);
+#ifdef CONFIG_MM_SLAB
+      slab_free(&g_wdcache, wdog);
+#else
       sched_kfree(wdog);
+#endif
     }
 
   /* Check if this is pre-allocated timer. */
@@ -74,6 +74,12 @@ int wd_gettime(WDOG_ID wdog)
   flags = enter_critical_section();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      int delay = wd_wheel_remaining(wdog) - wd_elapse();
+
+      leave_critical_section(flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -93,6 +99,7 @@ int wd_gettime(WDOG_ID wdog)
               return delay;
             }
         }
+#endif
     }
 
   leave_critical_section(flags);
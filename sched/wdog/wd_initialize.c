@@ -53,12 +53,14 @@
 
 sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -75,6 +77,14 @@ uint16_t g_wdnfree;
 clock_t g_wdtickbase;
 #endif
 
+#ifdef CONFIG_MM_SLAB
+/* Watchdog timers that are allocated when the pre-allocated timers are
+ * exhausted come from this cache.
+ */
+
+struct slab_cache_s g_wdcache;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -116,7 +126,9 @@ void wd_initialize(void)
   /* Initialize watchdog lists */
 
   sq_init(&g_wdfreelist);
+#ifndef CONFIG_WDOG_WHEEL
   sq_init(&g_wdactivelist);
+#endif
 
   /* The g_wdfreelist must be loaded at initialization time to hold the
    * configured number of watchdogs.
@@ -130,4 +142,11 @@ void wd_initialize(void)
   /* All watchdogs are free */
 
   g_wdnfree = CONFIG_PREALLOC_WDOGS;
+
+#ifdef CONFIG_MM_SLAB
+  /* Initialize the cache used when the pre-allocated timers run out */
+
+  slab_initialize(&g_wdcache, "wdog", sizeof(struct wdog_s),
+                  CONFIG_MM_SLAB_NPERSLAB);
+#endif
 }
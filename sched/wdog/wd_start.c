@@ -91,6 +91,68 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_callback
+ *
+ * Description:
+ *   Execute the function of a watchdog that has been removed from the
+ *   active watchdogs.
+ *
+ * Input Parameters:
+ *   wdog - The expired watchdog
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_callback(FAR struct wdog_s *wdog)
+{
+  /* Indicate that the watchdog is no longer active. */
+
+  WDOG_CLRACTIVE(wdog);
+
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+        DEBUGPANIC();
+        break;
+
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2], wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -98,6 +160,9 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  *   Check if the timer for the watchdog at the head of list is ready to
  *   run.  If so, remove the watchdog from the list and execute it.
  *
+ *   With CONFIG_WDOG_WHEEL, execute all watchdogs that expire at the
+ *   current time of the timer wheel.
+ *
  * Input Parameters:
  *   None
  *
@@ -106,6 +171,17 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_WHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+
+  while ((wdog = wd_wheel_expired()) != NULL)
+    {
+      wd_callback(wdog);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -134,52 +210,15 @@ static inline void wd_expiration(void)
               ((FAR struct wdog_s *)g_wdactivelist.head)->lag += wdog->lag;
             }
 
-          /* Indicate that the watchdog is no longer active. */
-
-          WDOG_CLRACTIVE(wdog);
-
-          /* Execute the watchdog function */
-
-          up_setpicbase(wdog->picbase);
-          switch (wdog->argc)
-            {
-              default:
-                DEBUGPANIC();
-                break;
-
-              case 0:
-                (*((wdentry0_t)(wdog->func)))(0);
-                break;
+          /* Indicate that the watchdog is no longer active and execute
+           * the watchdog function.
+           */
 
-#if CONFIG_MAX_WDOGPARMS > 0
-              case 1:
-                (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-              case 2:
-                (*((wdentry2_t)(wdog->func)))(2,
-                                wdog->parm[0], wdog->parm[1]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-              case 3:
-                (*((wdentry3_t)(wdog->func)))(3,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-              case 4:
-                (*((wdentry4_t)(wdog->func)))(4,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2], wdog->parm[3]);
-                break;
-#endif
-            }
+          wd_callback(wdog);
         }
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -222,10 +261,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -288,6 +329,20 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+#ifdef CONFIG_SCHED_TICKLESS
+  if (wd_wheel_empty())
+    {
+      /* Update clock tickbase */
+
+      g_wdtickbase = clock_systimer();
+    }
+#endif
+
+  /* Add the watchdog to the timer wheel */
+
+  wd_wheel_insert(wdog, delay);
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -379,9 +434,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -425,12 +484,18 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifdef CONFIG_WDOG_WHEEL
+  uint32_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
 #endif
   unsigned int ret;
+#ifndef CONFIG_WDOG_WHEEL
   int decr;
+#endif
 
 #ifdef CONFIG_SMP
   /* We are in an interrupt handler as, as a consequence, interrupts are
@@ -445,6 +510,35 @@ unsigned int wd_timer(int ticks)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Advance the timer wheel from event to event, executing the watchdogs
+   * that expire at each, until the interval is consumed.
+   */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_next();
+      if (next == 0 || next > (uint32_t)ticks)
+        {
+          break;
+        }
+
+      wd_wheel_advance(next);
+      ticks        -= next;
+      g_wdtickbase += next;
+
+      wd_expiration();
+    }
+
+  /* No event occurs in the remainder of the interval */
+
+  wd_wheel_advance(ticks);
+  g_wdtickbase += ticks;
+
+  /* Return the delay for the next event */
+
+  ret = wd_wheel_next();
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head != NULL && ticks > 0)
@@ -484,6 +578,7 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
@@ -512,6 +607,14 @@ void wd_timer(void)
   flags = enter_critical_section();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Advance the timer wheel by one tick and execute the watchdogs that
+   * expire now.
+   */
+
+  wd_wheel_advance(1);
+  wd_expiration();
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -524,6 +627,7 @@ void wd_timer(void)
 
       wd_expiration();
     }
+#endif
 
 #ifdef CONFIG_SMP
   leave_critical_section(flags);
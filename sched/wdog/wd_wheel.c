@@ -0,0 +1,364 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 32 slots so that the set of non-empty slots
+ * fits in one 32-bit word.  A slot at level n spans 32^n ticks; six levels
+ * reach 2^30 ticks.  Longer delays wait in the last level and are moved
+ * down as their time approaches.
+ */
+
+#define WHEEL_BITS       5
+#define WHEEL_SLOTS      (1 << WHEEL_BITS)
+#define WHEEL_MASK       (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS     6
+#define WHEEL_SHIFT(l)   ((l) * WHEEL_BITS)
+#define WHEEL_SPAN(l)    ((uint32_t)1 << WHEEL_SHIFT(l))
+#define WHEEL_RANGE      WHEEL_SPAN(WHEEL_LEVELS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The current time of the wheel, in ticks.  This is advanced only by
+ * wd_wheel_advance() and wraps around.
+ */
+
+static uint32_t g_wdnow;
+
+/* The head of the list of watchdogs in each slot and, for each level, the
+ * set of slots that are not empty.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS * WHEEL_SLOTS];
+static uint32_t g_wdslotset[WHEEL_LEVELS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the slot for its expiration time.  A watchdog that
+ *   expires within 32^(n+1) ticks goes into level n in the slot that will
+ *   be moved down (or expire) at the start of the span that contains the
+ *   expiration time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  uint32_t when  = wdog->expire;
+  uint32_t delta = when - g_wdnow;
+  int level;
+  int slot;
+
+  if (delta >= WHEEL_RANGE)
+    {
+      when = g_wdnow + WHEEL_RANGE - 1;
+      delta = WHEEL_RANGE - 1;
+    }
+
+  for (level = 0;
+       level < WHEEL_LEVELS - 1 && delta >= WHEEL_SPAN(level + 1);
+       level++);
+
+  slot = (when >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+  g_wdslotset[level] |= (uint32_t)1 << slot;
+
+  slot += level * WHEEL_SLOTS;
+  wdog->slot = slot;
+  wdog->prev = NULL;
+  wdog->next = g_wdwheel[slot];
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog;
+    }
+
+  g_wdwheel[slot] = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move the watchdogs in one slot of a higher level down to the levels
+ *   that now correspond to their remaining delay.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int index = (g_wdnow >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+  int slot  = level * WHEEL_SLOTS + index;
+
+  if ((g_wdslotset[level] & ((uint32_t)1 << index)) != 0)
+    {
+      wdog = g_wdwheel[slot];
+      g_wdwheel[slot] = NULL;
+      g_wdslotset[level] &= ~((uint32_t)1 << index);
+
+      for (; wdog != NULL; wdog = next)
+        {
+          next = wdog->next;
+          wd_wheel_add(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog that will expire after 'delay' ticks.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, uint32_t delay)
+{
+  wdog->expire = g_wdnow + delay;
+  wd_wheel_add(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the wheel.  Returns true if its slot became
+ *   empty so that the time of the next event may have changed.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  int slot = wdog->slot;
+
+  if (wdog->prev != NULL)
+    {
+      wdog->prev->next = wdog->next;
+    }
+  else
+    {
+      DEBUGASSERT(g_wdwheel[slot] == wdog);
+      g_wdwheel[slot] = wdog->next;
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+
+  if (g_wdwheel[slot] == NULL)
+    {
+      g_wdslotset[slot >> WHEEL_BITS] &=
+        ~((uint32_t)1 << (slot & WHEEL_MASK));
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks until the watchdog expires.
+ *
+ ****************************************************************************/
+
+int32_t wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int32_t)(wdog->expire - g_wdnow);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_empty
+ *
+ * Description:
+ *   Return true if no watchdogs are active.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_empty(void)
+{
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdslotset[level] != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next event:  Either a watchdog
+ *   expires or watchdogs must be moved down from a higher level.  Zero is
+ *   returned if the wheel is empty.  This takes constant time:  One look at
+ *   the set of non-empty slots of each level.
+ *
+ ****************************************************************************/
+
+uint32_t wd_wheel_next(void)
+{
+  uint32_t best = 0;
+  uint32_t block;
+  uint32_t delta;
+  uint32_t set;
+  int index;
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      set = g_wdslotset[level];
+      if (set == 0)
+        {
+          continue;
+        }
+
+      /* Rotate the set so that bit 0 is the slot after the current one.
+       * ffs() then gives the distance, 1..32, to the next non-empty slot.
+       */
+
+      block = g_wdnow >> WHEEL_SHIFT(level);
+      index = (block & WHEEL_MASK) + 1;
+
+      if (index < WHEEL_SLOTS)
+        {
+          set = (set >> index) | (set << (WHEEL_SLOTS - index));
+        }
+
+      block += ffs((int)set);
+      delta  = (block << WHEEL_SHIFT(level)) - g_wdnow;
+
+      if (best == 0 || delta < best)
+        {
+          best = delta;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel by 'ticks' which must not be greater than the value
+ *   last returned by wd_wheel_next() (unless the wheel is empty).  Any
+ *   watchdogs due at the new time are then returned by wd_wheel_expired().
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(uint32_t ticks)
+{
+  int level;
+
+  g_wdnow += ticks;
+
+  /* Move watchdogs down from each level whose span just started, starting
+   * with the highest level so that they can continue on down.
+   */
+
+  for (level = WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((g_wdnow & (WHEEL_SPAN(level) - 1)) == 0)
+        {
+          wd_wheel_cascade(level);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return one watchdog that expires at the current time of the
+ *   wheel or NULL if there are no more.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog = g_wdwheel[g_wdnow & WHEEL_MASK];
+
+  if (wdog != NULL)
+    {
+      DEBUGASSERT(wdog->expire == g_wdnow);
+      (void)wd_wheel_remove(wdog);
+    }
+
+  return wdog;
+}
+
+#endif /* CONFIG_WDOG_WHEEL */
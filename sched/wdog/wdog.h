@@ -48,6 +48,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/mm/slab.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -88,12 +89,14 @@ extern "C"
 
 extern sq_queue_t g_wdfreelist;
 
+#ifndef CONFIG_WDOG_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -110,6 +113,14 @@ extern uint16_t g_wdnfree;
 extern clock_t g_wdtickbase;
 #endif
 
+#ifdef CONFIG_MM_SLAB
+/* Watchdog timers that are allocated when the pre-allocated timers are
+ * exhausted come from this cache.
+ */
+
+extern struct slab_cache_s g_wdcache;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -188,6 +199,34 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_*
+ *
+ * Description:
+ *   Hierarchical timer wheel holding the active watchdogs (see
+ *   wd_wheel.c).  All must be called from within a critical section.
+ *
+ *   wd_wheel_insert    - Add a watchdog expiring after 'delay' ticks
+ *   wd_wheel_remove    - Remove a watchdog; true if the next event may
+ *                        have changed
+ *   wd_wheel_remaining - Ticks until a watchdog expires
+ *   wd_wheel_empty     - True if there are no active watchdogs
+ *   wd_wheel_next      - Ticks until the next event (zero if empty)
+ *   wd_wheel_advance   - Advance time by no more than wd_wheel_next()
+ *   wd_wheel_expired   - Remove a watchdog due now, NULL if none remain
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog, uint32_t delay);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+int32_t wd_wheel_remaining(FAR struct wdog_s *wdog);
+bool wd_wheel_empty(void);
+uint32_t wd_wheel_next(void);
+void wd_wheel_advance(uint32_t ticks);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
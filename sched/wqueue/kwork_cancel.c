@@ -90,6 +90,15 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
    */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_WQUEUE_PENDLIST
+  /* The work may still be in the pending list.  Move the pending list into
+   * the work queue so that the work can be removed from there.
+   */
+
+  (void)work_pendlist_drain(wqueue);
+#endif
+
   if (work->worker != NULL)
     {
       /* A little test of the integrity of the work queue */
@@ -156,6 +165,24 @@ int work_cancel(int qid, FAR struct work_s *work)
       return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
     }
   else
+#endif
+#ifdef CONFIG_SCHED_NAMEDWORK
+  if (qid >= NAMEDWORK)
+    {
+      FAR struct kwork_wqueue_s *wqueue;
+      int nthreads;
+
+      /* Cancel work on a named work queue */
+
+      wqueue = work_namedqueue(qid, &nthreads);
+      if (wqueue == NULL)
+        {
+          return -EINVAL;
+        }
+
+      return work_qcancel(wqueue, work);
+    }
+  else
 #endif
     {
       return -EINVAL;
@@ -0,0 +1,315 @@
+/****************************************************************************
+ * sched/wqueue/kwork_named.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/kthread.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_NAMEDWORK
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The state of the named work queues.  A queue is in use when its
+ * nthreads is non-zero.  Entries are only ever added, with pre-emption
+ * disabled.
+ */
+
+static struct named_wqueue_s g_namedwork[CONFIG_SCHED_NAMEDWORK_NQUEUES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_namedthread
+ *
+ * Description:
+ *   These are the worker threads that perform the actions placed on the
+ *   named work queues.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments
+ *   argv - argv[1] holds the index of the work queue in decimal
+ *
+ * Returned Value:
+ *   Does not return
+ *
+ ****************************************************************************/
+
+static int work_namedthread(int argc, FAR char *argv[])
+{
+  FAR struct named_wqueue_s *wqueue;
+  pid_t me = getpid();
+  int wndx;
+
+  DEBUGASSERT(argc > 1 && argv[1] != NULL);
+  wqueue = &g_namedwork[atoi(argv[1])];
+
+  /* Find our thread index by searching the workers of the queue */
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      if (wqueue->worker[wndx].pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(wndx < wqueue->nthreads);
+
+  /* Loop forever */
+
+  for (; ; )
+    {
+      work_process((FAR struct kwork_wqueue_s *)wqueue, wndx);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_namedqueue
+ *
+ * Description:
+ *   Return the named work queue with the given work queue ID.
+ *
+ * Input Parameters:
+ *   qid      - The work queue ID
+ *   nthreads - The location to return the number of worker threads
+ *
+ * Returned Value:
+ *   The work queue, or NULL if qid is not the ID of a named work queue.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_namedqueue(int qid, FAR int *nthreads)
+{
+  FAR struct named_wqueue_s *wqueue;
+
+  qid -= NAMEDWORK;
+  if (qid < 0 || qid >= CONFIG_SCHED_NAMEDWORK_NQUEUES)
+    {
+      return NULL;
+    }
+
+  wqueue = &g_namedwork[qid];
+  if (wqueue->nthreads == 0)
+    {
+      return NULL;
+    }
+
+  *nthreads = wqueue->nthreads;
+  return (FAR struct kwork_wqueue_s *)wqueue;
+}
+
+/****************************************************************************
+ * Name: work_queue_find
+ *
+ * Description:
+ *   Find a named work queue created by work_queue_create().
+ *
+ * Input Parameters:
+ *   name - The name of the work queue
+ *
+ * Returned Value:
+ *   The ID of the work queue is returned on success; -ENOENT is returned if
+ *   there is no work queue with that name.
+ *
+ ****************************************************************************/
+
+int work_queue_find(FAR const char *name)
+{
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_SCHED_NAMEDWORK_NQUEUES; ndx++)
+    {
+      if (g_namedwork[ndx].nthreads > 0 &&
+          strncmp(g_namedwork[ndx].name, name, NAMEDWORK_NAMELEN - 1) == 0)
+        {
+          return NAMEDWORK + ndx;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: work_queue_create
+ *
+ * Description:
+ *   Create a named, kernel-mode work queue served by its own worker
+ *   thread(s).
+ *
+ * Input Parameters:
+ *   name       - The name of the work queue, also used for its threads
+ *   priority   - The priority of the worker threads
+ *   stack_size - The stack size of each worker thread
+ *   nthreads   - The number of worker threads, at most
+ *                CONFIG_SCHED_NAMEDWORK_MAXTHREADS
+ *   affinity   - The CPU affinity of the worker threads as a bit set with
+ *                bit n for CPU n.  Zero means any CPU.  Ignored if
+ *                CONFIG_SMP is not selected.
+ *
+ * Returned Value:
+ *   The ID of the new work queue (NAMEDWORK or greater) is returned on
+ *   success.  A negated errno value is returned on failure:
+ *
+ *   -EEXIST - A work queue with this name already exists
+ *   -ENOSPC - All CONFIG_SCHED_NAMEDWORK_NQUEUES work queues are in use
+ *   -EINVAL - An invalid argument was provided
+ *
+ ****************************************************************************/
+
+int work_queue_create(FAR const char *name, int priority, int stack_size,
+                      int nthreads, uint32_t affinity)
+{
+  FAR struct named_wqueue_s *wqueue;
+  FAR char *argv[2];
+  char arg[8];
+  pid_t pid;
+  int ndx;
+  int ret;
+
+  if (name == NULL || nthreads < 1 ||
+      nthreads > CONFIG_SCHED_NAMEDWORK_MAXTHREADS ||
+      priority < SCHED_PRIORITY_MIN || priority > SCHED_PRIORITY_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Don't permit any of the threads to run until the work queue has been
+   * fully initialized.  This also serializes creation.
+   */
+
+  sched_lock();
+
+  if (work_queue_find(name) >= 0)
+    {
+      ret = -EEXIST;
+      goto errout;
+    }
+
+  for (ndx = 0; ndx < CONFIG_SCHED_NAMEDWORK_NQUEUES; ndx++)
+    {
+      if (g_namedwork[ndx].nthreads == 0)
+        {
+          break;
+        }
+    }
+
+  if (ndx >= CONFIG_SCHED_NAMEDWORK_NQUEUES)
+    {
+      ret = -ENOSPC;
+      goto errout;
+    }
+
+  wqueue = &g_namedwork[ndx];
+  memset(wqueue, 0, sizeof(struct named_wqueue_s));
+  strncpy(wqueue->name, name, NAMEDWORK_NAMELEN - 1);
+
+  snprintf(arg, sizeof(arg), "%d", ndx);
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  /* Start the worker thread(s) */
+
+  sinfo("Starting %d worker thread(s) for %s\n", nthreads, wqueue->name);
+
+  for (wqueue->nthreads = 0; wqueue->nthreads < nthreads; )
+    {
+      pid = kthread_create(wqueue->name, priority, stack_size,
+                           (main_t)work_namedthread,
+                           (FAR char * const *)argv);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create %d failed: %d\n",
+               wqueue->nthreads, (int)pid);
+
+          /* Keep the queue with the threads that could be started, if
+           * any.
+           */
+
+          ret = wqueue->nthreads > 0 ? NAMEDWORK + ndx : (int)pid;
+          goto errout;
+        }
+
+#ifdef CONFIG_SMP
+      if (affinity != 0)
+        {
+          cpu_set_t cpuset = (cpu_set_t)affinity;
+
+          ret = nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+          DEBUGASSERT(ret >= 0);
+          UNUSED(ret);
+        }
+#endif
+
+      wqueue->worker[wqueue->nthreads].pid  = pid;
+      wqueue->worker[wqueue->nthreads].busy = true;
+      wqueue->nthreads++;
+    }
+
+  ret = NAMEDWORK + ndx;
+
+errout:
+  sched_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_NAMEDWORK */
@@ -0,0 +1,176 @@
+/****************************************************************************
+ * sched/wqueue/kwork_pendlist.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <queue.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_WQUEUE_PENDLIST)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_pendlock and work_pendunlock
+ *
+ * Description:
+ *   Lock/unlock the pending list of a work queue.  Only local interrupts
+ *   are disabled; in the SMP case, the per-queue spinlock serializes the
+ *   other CPUs.  Unlike enter_critical_section(), this does not contend
+ *   with unrelated users of the global critical section.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t work_pendlock(FAR struct kwork_wqueue_s *wqueue)
+{
+  irqstate_t flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock(&wqueue->lock);
+#endif
+  return flags;
+}
+
+static inline void work_pendunlock(FAR struct kwork_wqueue_s *wqueue,
+                                   irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&wqueue->lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_pendlist_add
+ *
+ * Description:
+ *   Add work that is not already queued to the pending list of the work
+ *   queue.  This does not require the critical section and may be called
+ *   from interrupt handlers.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue
+ *   work   - The initialized work structure to add
+ *
+ * Returned Value:
+ *   True is returned if the pending list was empty before the work was
+ *   added.  Only in that case does the worker thread need to be signalled.
+ *
+ ****************************************************************************/
+
+bool work_pendlist_add(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+  irqstate_t flags;
+  bool empty;
+
+  /* The dq_entry_s flink field overlays the sq_entry_s flink field so the
+   * work structure may be kept in the singly-linked pending list until it
+   * is moved to the work queue.
+   */
+
+  flags = work_pendlock(wqueue);
+  empty = sq_empty(&wqueue->pend);
+  sq_addlast((FAR sq_entry_t *)work, &wqueue->pend);
+  work_pendunlock(wqueue, flags);
+
+  return empty;
+}
+
+/****************************************************************************
+ * Name: work_pendlist_drain
+ *
+ * Description:
+ *   Move all work from the pending list to the tail of the work queue,
+ *   preserving the order in which it was queued.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue
+ *
+ * Returned Value:
+ *   True is returned if any work was moved to the work queue.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+bool work_pendlist_drain(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  irqstate_t flags;
+
+  /* Detach the whole pending list at once so that the pending list lock is
+   * held only briefly.
+   */
+
+  flags = work_pendlock(wqueue);
+  entry = sq_peek(&wqueue->pend);
+  sq_init(&wqueue->pend);
+  work_pendunlock(wqueue, flags);
+
+  if (entry == NULL)
+    {
+      return false;
+    }
+
+  /* Then append each entry to the work queue */
+
+  for (; entry != NULL; entry = next)
+    {
+      next = sq_next(entry);
+      dq_addlast((FAR dq_entry_t *)entry, &wqueue->q);
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE && CONFIG_WQUEUE_PENDLIST */
@@ -122,6 +122,12 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
 
   stick = clock_systimer();
 
+#ifdef CONFIG_WQUEUE_PENDLIST
+  /* Move any newly queued work into the work queue */
+
+  (void)work_pendlist_drain(wqueue);
+#endif
+
   /* And check each entry in the work queue.  Since we have disabled
    * interrupts we know:  (1) we will not be suspended unless we do
    * so ourselves, and (2) there will be no changes to the work queue
@@ -177,6 +183,9 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
                */
 
               flags = enter_critical_section();
+#ifdef CONFIG_WQUEUE_PENDLIST
+              (void)work_pendlist_drain(wqueue);
+#endif
               work  = (FAR struct work_s *)wqueue->q.head;
             }
           else
@@ -230,6 +239,22 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
    * over the queue again.
    */
 
+#ifdef CONFIG_WQUEUE_PENDLIST
+  /* Work may have been added to the pending list while the last work was
+   * being performed.  Since the worker thread was busy, no signal was sent
+   * for that work.  Don't sleep in that case; return so that the work
+   * queue will be processed again.  Any work added after this point will
+   * find the pending list empty and this worker thread not busy and so
+   * will signal it.
+   */
+
+  wqueue->worker[wndx].busy = false;
+  if (work_pendlist_drain(wqueue))
+    {
+      wqueue->worker[wndx].busy = true;
+    }
+  else
+#endif
   if (wndx > 0 || next == WORK_DELAY_MAX)
     {
       sigset_t set;
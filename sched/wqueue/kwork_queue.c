@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -82,11 +83,11 @@
  *            is invoked. Zero means to perform the work immediately.
  *
  * Returned Value:
- *   None
+ *   True is returned if the worker thread must be signalled.
  *
  ****************************************************************************/
 
-static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+static bool work_qqueue(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work, worker_t worker,
                         FAR void *arg, clock_t delay)
 {
@@ -94,12 +95,38 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   DEBUGASSERT(work != NULL && worker != NULL);
 
+#ifdef CONFIG_WQUEUE_PENDLIST
+  /* If the work is not already queued, then it can be added to the
+   * pending list without entering the critical section.  The worker
+   * thread needs to be signalled only if the pending list was empty;
+   * otherwise, a signal is already on its way.
+   */
+
+  if (work->worker == NULL)
+    {
+      work->worker = worker;
+      work->arg    = arg;
+      work->delay  = delay;
+      work->qtime  = clock_systimer();
+
+      return work_pendlist_add(wqueue, work);
+    }
+#endif
+
   /* Interrupts are disabled so that this logic can be called from with task
    * logic or ifrom nterrupt handling logic.
    */
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_WQUEUE_PENDLIST
+  /* The work may still be in the pending list.  Move the pending list into
+   * the work queue so that the work can be found there.
+   */
+
+  (void)work_pendlist_drain(wqueue);
+#endif
+
   /* Is there already pending work? */
 
   if (work->worker != NULL)
@@ -124,6 +151,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
 
   leave_critical_section(flags);
+  return true;
 }
 
 /****************************************************************************
@@ -169,8 +197,13 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue high priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
-      return work_signal(HPWORK);
+      if (work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work,
+                      worker, arg, delay))
+        {
+          return work_signal(HPWORK);
+        }
+
+      return OK;
     }
   else
 #endif
@@ -179,8 +212,36 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue low priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
-      return work_signal(LPWORK);
+      if (work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work,
+                      worker, arg, delay))
+        {
+          return work_signal(LPWORK);
+        }
+
+      return OK;
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_NAMEDWORK
+  if (qid >= NAMEDWORK)
+    {
+      FAR struct kwork_wqueue_s *wqueue;
+      int nthreads;
+
+      /* Queue work on a named work queue */
+
+      wqueue = work_namedqueue(qid, &nthreads);
+      if (wqueue == NULL)
+        {
+          return -EINVAL;
+        }
+
+      if (work_qqueue(wqueue, work, worker, arg, delay))
+        {
+          return work_signal(qid);
+        }
+
+      return OK;
     }
   else
 #endif
@@ -92,6 +92,17 @@ int work_signal(int qid)
       threads = CONFIG_SCHED_LPNTHREADS;
     }
   else
+#endif
+#ifdef CONFIG_SCHED_NAMEDWORK
+  if (qid >= NAMEDWORK)
+    {
+      work = work_namedqueue(qid, &threads);
+      if (work == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+  else
 #endif
     {
       return -EINVAL;
@@ -47,6 +47,9 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#ifdef CONFIG_SMP
+#  include <nuttx/spinlock.h>
+#endif
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -59,6 +62,10 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Maximum length of the name of a named work queue (including the NUL) */
+
+#define NAMEDWORK_NAMELEN 16
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -76,6 +83,12 @@ struct kworker_s
 struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
+#ifdef CONFIG_WQUEUE_PENDLIST
+  struct sq_queue_s pend;      /* Newly queued work not yet in q */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;      /* Protects the pend list */
+#endif
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -87,6 +100,12 @@ struct kwork_wqueue_s
 struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
+#ifdef CONFIG_WQUEUE_PENDLIST
+  struct sq_queue_s pend;      /* Newly queued work not yet in q */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;      /* Protects the pend list */
+#endif
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -102,6 +121,12 @@ struct hp_wqueue_s
 struct lp_wqueue_s
 {
   struct dq_queue_s q;      /* The queue of pending work */
+#ifdef CONFIG_WQUEUE_PENDLIST
+  struct sq_queue_s pend;   /* Newly queued work not yet in q */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;   /* Protects the pend list */
+#endif
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -109,6 +134,30 @@ struct lp_wqueue_s
 };
 #endif
 
+/* This structure defines the state of one named work queue.  This
+ * structure must be cast compatible with kwork_wqueue_s
+ */
+
+#ifdef CONFIG_SCHED_NAMEDWORK
+struct named_wqueue_s
+{
+  struct dq_queue_s q;      /* The queue of pending work */
+#ifdef CONFIG_WQUEUE_PENDLIST
+  struct sq_queue_s pend;   /* Newly queued work not yet in q */
+#ifdef CONFIG_SMP
+  spinlock_t        lock;   /* Protects the pend list */
+#endif
+#endif
+
+  /* Describes each thread in the named queue's thread pool */
+
+  struct kworker_s  worker[CONFIG_SCHED_NAMEDWORK_MAXTHREADS];
+
+  uint8_t           nthreads;                /* Number of threads; 0=unused */
+  char              name[NAMEDWORK_NAMELEN]; /* Name of the work queue */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -167,6 +216,25 @@ int work_hpstart(void);
 int work_lpstart(void);
 #endif
 
+/****************************************************************************
+ * Name: work_namedqueue
+ *
+ * Description:
+ *   Return the named work queue with the given work queue ID.
+ *
+ * Input Parameters:
+ *   qid      - The work queue ID
+ *   nthreads - The location to return the number of worker threads
+ *
+ * Returned Value:
+ *   The work queue, or NULL if qid is not the ID of a named work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NAMEDWORK
+FAR struct kwork_wqueue_s *work_namedqueue(int qid, FAR int *nthreads);
+#endif
+
 /****************************************************************************
  * Name: work_process
  *
@@ -187,6 +255,51 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
 
+/****************************************************************************
+ * Name: work_pendlist_add
+ *
+ * Description:
+ *   Add work that is not already queued to the pending list of the work
+ *   queue.  This does not require the critical section and may be called
+ *   from interrupt handlers.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue
+ *   work   - The initialized work structure to add
+ *
+ * Returned Value:
+ *   True is returned if the pending list was empty before the work was
+ *   added.  Only in that case does the worker thread need to be signalled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_PENDLIST
+bool work_pendlist_add(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work);
+#endif
+
+/****************************************************************************
+ * Name: work_pendlist_drain
+ *
+ * Description:
+ *   Move all work from the pending list to the tail of the work queue,
+ *   preserving the order in which it was queued.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue
+ *
+ * Returned Value:
+ *   True is returned if any work was moved to the work queue.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_PENDLIST
+bool work_pendlist_drain(FAR struct kwork_wqueue_s *wqueue);
+#endif
+
 /****************************************************************************
  * Name: work_notifier_initialize
  *
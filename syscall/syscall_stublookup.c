@@ -201,6 +201,10 @@ uintptr_t STUB_pread(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4);
 uintptr_t STUB_pwrite(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_readv(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
+uintptr_t STUB_writev(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
 uintptr_t STUB_poll(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 uintptr_t STUB_select(int nbr, uintptr_t parm1, uintptr_t parm2,
@@ -264,6 +268,11 @@ uintptr_t STUB_readlink(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_pipe2(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_mkfifo2(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+            uintptr_t parm6);
+uintptr_t STUB_tee(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 
 uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
@@ -390,8 +399,16 @@ uintptr_t STUB_recv(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_recvfrom(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
             uintptr_t parm6);
+uintptr_t STUB_recvmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
+uintptr_t STUB_recvmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
 uintptr_t STUB_send(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_sendmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_sendmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
 uintptr_t STUB_sendto(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
             uintptr_t parm6);
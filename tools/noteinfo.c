@@ -1,10 +1,11 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * The following is autogenerated and comes from:
  *
- *   (gdb) p &g_note_info.ni_buffer
+ *   (gdb) p &g_note_info[0].ni_buffer
  *   $3 = (uint8_t (*)[2048]) 0x10831004
  *   (gdb) dump binary memory noteinfo.bin 0x10831004 0x10831804
  *
@@ -702,7 +703,7 @@ unsigned int noteinfo_bin_len = 8192;
 /****************************************************************************
  * This comes from:
  *
- *   (gdb) p g_note_info
+ *   (gdb) p g_note_info[0]
  *   $1 = {ni_head = 915, ni_tail = 925,
  *   ni_buffer = ...
  *
@@ -728,7 +729,7 @@ struct note_common_s
   uint8_t nc_systime[4];       /* Time when note buffered */
 };
 
-#define NTYPES 18
+#define NTYPES 19
 static char *noteid[NTYPES] =
 {
   "NOTE_START",           /* type = 0 */
@@ -752,7 +753,9 @@ static char *noteid[NTYPES] =
   "NOTE_SPINLOCK_LOCK",   /* type = 14 */
   "NOTE_SPINLOCK_LOCKED", /* type = 15 */
   "NOTE_SPINLOCK_UNLOCK", /* type = 16 */
-  "NOTE_SPINLOCK_ABORT"   /* type = 17 */
+  "NOTE_SPINLOCK_ABORT",  /* type = 17 */
+
+  "NOTE_PMU"              /* type = 18 */
 };
 
 static unsigned int next_ndx(unsigned int ndx)
@@ -765,15 +768,199 @@ static unsigned int next_ndx(unsigned int ndx)
   return ndx;
 }
 
-int main(int argc, char **argv)
+static void print_note(unsigned char *buffer, unsigned int size)
 {
   struct note_common_s *note;
-  unsigned int size;
-  unsigned int notndx;
   unsigned int bufndx;
   unsigned int remainder;
   unsigned int value;
-  char buffer[64];
+
+  note = (struct note_common_s *)buffer;
+  printf("CPU%1u PID%-3uprio=%-3u: %-20s time=%08lx",
+         note->nc_cpu,
+         (unsigned int) note->nc_pid[1] << 8 |
+         (unsigned int) note->nc_pid[0],
+         note->nc_priority,
+         note->nc_type < NTYPES ? noteid[note->nc_type] : "Unrecognized",
+         (unsigned long)note->nc_systime[3] << 24 |
+         (unsigned long)note->nc_systime[2] << 16 |
+         (unsigned long)note->nc_systime[1] << 8 |
+         (unsigned long)note->nc_systime[0]);
+
+  bufndx    = sizeof(struct note_common_s);
+  remainder = size - bufndx;
+  if (remainder > 0)
+    {
+      switch(note->nc_type)
+      {
+        /* Followed by a varible length, NULL terminated name */
+
+        case 0: /* NOTE_START */
+          buffer[size - 1] = '\0';
+          printf(" Name: %s", &buffer[bufndx]);
+          bufndx    = size;
+          remainder = 0;
+          break;
+
+        /* Followed by an 8-bit task state */
+
+        case 2: /* NOTE_SUSPEND */
+          printf(" State=%u", (unsigned int)buffer[bufndx]);
+          bufndx++;
+          remainder--;
+          break;
+
+        /* Followed by an 8-bit target CPU number */
+
+        case 4: /* NOTE_CPU_START */
+        case 6: /* NOTE_CPU_PAUSE */
+        case 8: /* NOTE_CPU_RESUME */
+          printf(" Target CPU%u", (unsigned int)buffer[bufndx]);
+          bufndx++;
+          remainder--;
+          break;
+
+        /* Followed by a 16-bit count in little endian order */
+
+        case 10: /* NOTE_PREEMPT_LOCK */
+        case 11: /* NOTE_PREEMPT_UNLOCK */
+        case 12: /* NOTE_CSECTION_ENTER */
+        case 13: /* NOTE_CSECTION_LEAVE */
+          if (remainder >= 2)
+            {
+              value = (unsigned int)buffer[bufndx + 1] << 8 |
+                      (unsigned int)buffer[bufndx];
+              printf(" Count=%u", value);
+              bufndx += 2;
+              remainder -= 2;
+            }
+          break;
+
+        /* Followed by the spinlock address and an 8-bit spinlock value.
+         * The address is target-specific so it is just dumped below.
+         */
+
+        case 14: /* NOTE_SPINLOCK_LOCK */
+        case 15: /* NOTE_SPINLOCK_LOCKED */
+        case 16: /* NOTE_SPINLOCK_UNLOCK */
+        case 17: /* NOTE_SPINLOCK_ABORT */
+          printf(" Spinlock=%u", (unsigned int)buffer[size - 1]);
+          size--;
+          break;
+
+        /* Followed by 32-bit counter increments in little endian order */
+
+        case 18: /* NOTE_PMU */
+          while (remainder >= 4)
+            {
+              value = (unsigned int)buffer[bufndx + 3] << 24 |
+                      (unsigned int)buffer[bufndx + 2] << 16 |
+                      (unsigned int)buffer[bufndx + 1] << 8 |
+                      (unsigned int)buffer[bufndx];
+              printf(" %u", value);
+              bufndx += 4;
+              remainder -= 4;
+            }
+          break;
+
+        /* Nothing addition shold follow these types */
+
+        case 1: /* NOTE_STOP */
+        case 3: /* NOTE_RESUME */
+        case 5: /* NOTE_CPU_STARTED */
+        case 7: /* NOTE_CPU_PAUSED */
+        case 9: /* NOTE_CPU_RESUMED */
+        default:
+          break;
+      }
+    }
+
+  for (; bufndx < size; bufndx++)
+    {
+      printf(" %02x", buffer[bufndx]);
+    }
+
+  printf("\n");
+}
+
+/****************************************************************************
+ * Decode a binary stream of notes as read from /dev/note (for example,
+ * captured on the host from a trace transport):
+ *
+ *   $ noteinfo notes.bin
+ *
+ * The stream is simply a sequence of complete notes.  In the SMP case,
+ * notes from each CPU are in order but notes from different CPUs are not
+ * merged; the time stamps may be used to merge them.
+ *
+ ****************************************************************************/
+
+static int decode_stream(const char *path)
+{
+  unsigned char buffer[256];
+  unsigned int offset;
+  unsigned int size;
+  FILE *stream;
+
+  stream = fopen(path, "rb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to open %s\n", path);
+      return 1;
+    }
+
+  offset = 0;
+  for (; ; )
+    {
+      /* Get the length of the next note (its first byte) */
+
+      if (fread(buffer, 1, 1, stream) != 1)
+        {
+          break;
+        }
+
+      size = buffer[0];
+      if (size < sizeof(struct note_common_s))
+        {
+          fprintf(stderr, "ERROR: Bad note size at offset %u: %u\n",
+                  offset, size);
+          fclose(stream);
+          return 1;
+        }
+
+      /* Then read the rest of the note */
+
+      if (fread(&buffer[1], 1, size - 1, stream) != size - 1)
+        {
+          fprintf(stderr, "ERROR: Incomplete record at offset %u\n", offset);
+          fclose(stream);
+          return 1;
+        }
+
+      printf("%7u: ", offset);
+      print_note(buffer, size);
+      offset += size;
+    }
+
+  fclose(stream);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int size;
+  unsigned int notndx;
+  unsigned int bufndx;
+  unsigned char buffer[256];
+
+  /* Decode a binary stream if one is provided on the command line */
+
+  if (argc > 1)
+    {
+      return decode_stream(argv[1]);
+    }
+
+  /* Otherwise, decode the circular buffer dump included above */
 
   notndx = ni_tail;
   while (notndx != ni_head)
@@ -783,9 +970,9 @@ int main(int argc, char **argv)
       /* Copy the note into the buffer */
 
       size = noteinfo_bin[notndx];
-      if (size > 64)
+      if (size < sizeof(struct note_common_s))
         {
-           printf("ERROR: size to big: %u\n", size);
+           printf("ERROR: bad size: %u\n", size);
            exit(1);
         }
 
@@ -803,94 +990,8 @@ int main(int argc, char **argv)
             }
         }
 
-      note = (struct note_common_s *)buffer;
-      printf("CPU%1u PID%-3uprio=%-3u: %-20s time=%08lx",
-             note->nc_cpu,
-             (unsigned int) note->nc_pid[1] << 8 |
-             (unsigned int) note->nc_pid[0],
-             note->nc_priority,
-             note->nc_type < NTYPES ? noteid[note->nc_type] : "Unrecognized",
-             (unsigned long)note->nc_systime[3] << 24 |
-             (unsigned long)note->nc_systime[2] << 16 |
-             (unsigned long)note->nc_systime[1] << 8 |
-             (unsigned long)note->nc_systime[0]);
-
-      bufndx    = sizeof(struct note_common_s);
-      remainder = size - bufndx;
-      if (remainder > 0)
-        {
-          switch(note->nc_type)
-          {
-            /* Followed by a varible length, NULL terminated name */
-
-            case 0: /* NOTE_START */
-              buffer[size - 1] = '\0';
-              printf(" Name: %s", &buffer[bufndx]);
-              bufndx    = size;
-              remainder = 0;
-              break;
-
-            /* Followed by an 8-bit task state */
-
-            case 2: /* NOTE_SUSPEND */
-              printf(" State=%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Followed by an 8-bit target CPU number */
-
-            case 4: /* NOTE_CPU_START */
-            case 6: /* NOTE_CPU_PAUSE */
-            case 8: /* NOTE_CPU_RESUME */
-              printf(" Target CPU%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Followed by a 16-bit count */
-
-            case 10: /* NOTE_PREEMPT_LOCK */
-            case 11: /* NOTE_PREEMPT_UNLOCK */
-            case 12: /* NOTE_CSECTION_ENTER */
-            case 13: /* NOTE_CSECTION_LEAVE */
-              if (remainder >= 2)
-                {
-                  value = (unsigned int)buffer[bufndx] << 8 |
-                          (unsigned int)buffer[bufndx+1];
-                  bufndx += 2;
-                  remainder -= 2;
-                  break;
-                }
-
-            /* Followed by an 8-bit spinlock value */
-
-            case 14: /* NOTE_SPINLOCK_LOCK */
-            case 15: /* NOTE_SPINLOCK_LOCKED */
-            case 16: /* NOTE_SPINLOCK_UNLOCK */
-            case 17: /* NOTE_SPINLOCK_ABORT */
-              printf(" Spinlock=%u", (unsigned int)buffer[bufndx]);
-              bufndx++;
-              remainder--;
-              break;
-
-            /* Nothing addition shold follow these types */
-
-            case 1: /* NOTE_STOP */
-            case 3: /* NOTE_RESUME */
-            case 5: /* NOTE_CPU_STARTED */
-            case 7: /* NOTE_CPU_PAUSED */
-            case 9: /* NOTE_CPU_RESUMED */
-            default:
-              break;
-          }
-        }
-
-      for (; bufndx < size; bufndx++)
-        {
-          printf(" %02x", buffer[bufndx]);
-        }
-
-      printf("\n");
+      print_note(buffer, size);
     }
+
+  return 0;
 }
@@ -0,0 +1,379 @@
+/****************************************************************************
+ * tools/profinfo.c
+ *
+ *   Copyright (C) 2019 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_LINE 512
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The layout of one sample as read from /dev/profile.  See struct
+ * profile_sample_s in include/nuttx/timers/profile.h.
+ */
+
+struct sample_s
+{
+  uint32_t pc;
+  uint16_t pid;
+  uint8_t  cpu;
+  uint8_t  reserved;
+};
+
+/* The number of times that one PC was sampled in one task */
+
+struct count_s
+{
+  uint32_t pc;
+  uint16_t pid;
+  unsigned long count;
+  char *func;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct count_s *g_counts;
+static size_t g_ncounts;
+static size_t g_nalloc;
+static unsigned long g_nsamples;
+static int g_swap;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(const char *progname, int exitcode)
+{
+  fprintf(stderr, "USAGE: %s [-b] [-e <elf> [-a <addr2line>]] <file>\n",
+          progname);
+  fprintf(stderr, "\nWhere:\n");
+  fprintf(stderr, "  <file> holds samples read from the target "
+                  "/dev/profile device\n");
+  fprintf(stderr, "  -b: The target is big-endian\n");
+  fprintf(stderr, "  -e <elf>: Report functions instead of addresses "
+                  "using the symbols in <elf>\n");
+  fprintf(stderr, "  -a <addr2line>: The addr2line program for the "
+                  "target (default: addr2line)\n");
+  fprintf(stderr, "\nThe output is one line per task and function, in the "
+                  "folded format used by\nflamegraph.pl:\n");
+  fprintf(stderr, "  <pid>;<function> <count>\n");
+  exit(exitcode);
+}
+
+static uint32_t swap32(uint32_t value)
+{
+  return (value >> 24) | ((value >> 8) & 0x0000ff00) |
+         ((value << 8) & 0x00ff0000) | (value << 24);
+}
+
+static uint16_t swap16(uint16_t value)
+{
+  return (uint16_t)((value >> 8) | (value << 8));
+}
+
+static int compare_pc(const void *a, const void *b)
+{
+  const struct count_s *ca = (const struct count_s *)a;
+  const struct count_s *cb = (const struct count_s *)b;
+
+  if (ca->pid != cb->pid)
+    {
+      return ca->pid < cb->pid ? -1 : 1;
+    }
+
+  if (ca->pc != cb->pc)
+    {
+      return ca->pc < cb->pc ? -1 : 1;
+    }
+
+  return 0;
+}
+
+static int compare_func(const void *a, const void *b)
+{
+  const struct count_s *ca = (const struct count_s *)a;
+  const struct count_s *cb = (const struct count_s *)b;
+
+  if (ca->pid != cb->pid)
+    {
+      return ca->pid < cb->pid ? -1 : 1;
+    }
+
+  return strcmp(ca->func, cb->func);
+}
+
+static void add_sample(uint32_t pc, uint16_t pid)
+{
+  if (g_ncounts >= g_nalloc)
+    {
+      g_nalloc  = g_nalloc ? 2 * g_nalloc : 1024;
+      g_counts  = realloc(g_counts, g_nalloc * sizeof(struct count_s));
+      if (g_counts == NULL)
+        {
+          fprintf(stderr, "ERROR: Out of memory\n");
+          exit(1);
+        }
+    }
+
+  g_counts[g_ncounts].pc    = pc;
+  g_counts[g_ncounts].pid   = pid;
+  g_counts[g_ncounts].count = 1;
+  g_counts[g_ncounts].func  = NULL;
+  g_ncounts++;
+}
+
+/* Sort the counts by key and merge the duplicates */
+
+static void merge_counts(int (*compare)(const void *, const void *))
+{
+  size_t i;
+  size_t j;
+
+  if (g_ncounts == 0)
+    {
+      return;
+    }
+
+  qsort(g_counts, g_ncounts, sizeof(struct count_s), compare);
+
+  for (i = 0, j = 1; j < g_ncounts; j++)
+    {
+      if (compare(&g_counts[i], &g_counts[j]) == 0)
+        {
+          g_counts[i].count += g_counts[j].count;
+          free(g_counts[j].func);
+        }
+      else
+        {
+          g_counts[++i] = g_counts[j];
+        }
+    }
+
+  g_ncounts = i + 1;
+}
+
+static int read_samples(const char *path)
+{
+  struct sample_s sample;
+  FILE *stream;
+
+  stream = fopen(path, "rb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to open %s\n", path);
+      return 1;
+    }
+
+  while (fread(&sample, sizeof(struct sample_s), 1, stream) == 1)
+    {
+      if (g_swap)
+        {
+          sample.pc  = swap32(sample.pc);
+          sample.pid = swap16(sample.pid);
+        }
+
+      add_sample(sample.pc, sample.pid);
+      g_nsamples++;
+    }
+
+  fclose(stream);
+  return 0;
+}
+
+/* Run addr2line once on all of the distinct addresses.  addr2line -f
+ * prints two lines for each address:  The function name and then the
+ * file and line number.
+ */
+
+static int symbolize(const char *addr2line, const char *elf)
+{
+  char tmpname[] = "/tmp/profinfoXXXXXX";
+  char command[MAX_LINE];
+  char line[MAX_LINE];
+  FILE *stream;
+  size_t i;
+  int fd;
+
+  fd = mkstemp(tmpname);
+  if (fd < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create a temporary file\n");
+      return 1;
+    }
+
+  stream = fdopen(fd, "w");
+  for (i = 0; i < g_ncounts; i++)
+    {
+      fprintf(stream, "0x%08lx\n", (unsigned long)g_counts[i].pc);
+    }
+
+  fclose(stream);
+
+  snprintf(command, MAX_LINE, "%s -f -e %s < %s", addr2line, elf, tmpname);
+  stream = popen(command, "r");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to run %s\n", addr2line);
+      unlink(tmpname);
+      return 1;
+    }
+
+  for (i = 0; i < g_ncounts; i++)
+    {
+      if (fgets(line, MAX_LINE, stream) == NULL)
+        {
+          break;
+        }
+
+      line[strcspn(line, "\r\n")] = '\0';
+      g_counts[i].func = strdup(line);
+
+      /* Skip the file name and line number */
+
+      if (fgets(line, MAX_LINE, stream) == NULL)
+        {
+          i++;
+          break;
+        }
+    }
+
+  pclose(stream);
+  unlink(tmpname);
+
+  if (i < g_ncounts)
+    {
+      fprintf(stderr, "ERROR: %s did not resolve all addresses\n",
+              addr2line);
+      return 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  const char *addr2line = "addr2line";
+  const char *elf = NULL;
+  size_t i;
+  int option;
+
+  while ((option = getopt(argc, argv, "a:be:h")) > 0)
+    {
+      switch (option)
+        {
+        case 'a':
+          addr2line = optarg;
+          break;
+
+        case 'b':
+          g_swap = 1;
+          break;
+
+        case 'e':
+          elf = optarg;
+          break;
+
+        case 'h':
+          show_usage(argv[0], 0);
+          break;
+
+        default:
+          show_usage(argv[0], 1);
+          break;
+        }
+    }
+
+  if (optind != argc - 1)
+    {
+      show_usage(argv[0], 1);
+    }
+
+  if (read_samples(argv[optind]) != 0)
+    {
+      return 1;
+    }
+
+  /* Count the distinct PCs first so that each is only looked up once */
+
+  merge_counts(compare_pc);
+
+  if (elf != NULL)
+    {
+      if (symbolize(addr2line, elf) != 0)
+        {
+          return 1;
+        }
+
+      merge_counts(compare_func);
+    }
+
+  for (i = 0; i < g_ncounts; i++)
+    {
+      if (g_counts[i].func != NULL)
+        {
+          printf("%u;%s %lu\n", g_counts[i].pid, g_counts[i].func,
+                 g_counts[i].count);
+        }
+      else
+        {
+          printf("%u;0x%08lx %lu\n", g_counts[i].pid,
+                 (unsigned long)g_counts[i].pc, g_counts[i].count);
+        }
+    }
+
+  fprintf(stderr, "%lu samples, %lu distinct locations\n",
+          g_nsamples, (unsigned long)g_ncounts);
+  return 0;
+}
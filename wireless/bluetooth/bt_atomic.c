@@ -80,6 +80,23 @@ bt_atomic_t bt_atomic_decr(FAR bt_atomic_t *ptr)
   return value;
 }
 
+bt_atomic_t bt_atomic_decrnz(FAR bt_atomic_t *ptr)
+{
+  irqstate_t flags;
+  bt_atomic_t value;
+
+  flags = spin_lock_irqsave();
+  value = *ptr;
+  if (value > 0)
+    {
+      *ptr = value - 1;
+    }
+
+  spin_unlock_irqrestore(flags);
+
+  return value;
+}
+
 bt_atomic_t bt_atomic_setbit(FAR bt_atomic_t *ptr, bt_atomic_t bitno)
 {
   irqstate_t flags;
@@ -88,6 +88,7 @@ bt_atomic_t bt_atomic_get(FAR bt_atomic_t *ptr);
 
 bt_atomic_t bt_atomic_incr(FAR bt_atomic_t *ptr);
 bt_atomic_t bt_atomic_decr(FAR bt_atomic_t *ptr);
+bt_atomic_t bt_atomic_decrnz(FAR bt_atomic_t *ptr);
 bt_atomic_t bt_atomic_setbit(FAR bt_atomic_t *ptr, bt_atomic_t bitno);
 bt_atomic_t bt_atomic_clrbit(FAR bt_atomic_t *ptr, bt_atomic_t bitno);
 
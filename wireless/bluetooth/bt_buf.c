@@ -348,7 +348,7 @@ FAR struct bt_buf_s *bt_buf_alloc(enum bt_buf_type_e type,
        * available buffers.
        */
 
-      buf->frame = iob_alloc(false);
+      buf->frame = iob_alloc_user(false, IOBUSER_WIRELESS_BLUETOOTH);
       if (!buf->frame)
         {
           wlerr("ERROR:  Failed to allocate an IOB\n");
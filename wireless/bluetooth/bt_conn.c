@@ -180,6 +180,16 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
 
       wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
       g_btdev.btdev->send(g_btdev.btdev, buf);
+
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+      /* The notification has left the queue:  Return its credit */
+
+      if (buf->u.acl.credit)
+        {
+          bt_atomic_incr(&conn->nfy_credits);
+        }
+#endif
+
       bt_buf_release(buf);
     }
 
@@ -445,7 +455,7 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
       buf = bt_l2cap_create_pdu(conn);
 
       len = remaining;
-      if (len < g_btdev.le_mtu)
+      if (len > g_btdev.le_mtu)
         {
           len = g_btdev.le_mtu;
         }
@@ -570,6 +580,11 @@ void bt_conn_set_state(FAR struct bt_conn_s *conn,
           DEBUGASSERT(ret >= 0 && g_btdev.tx_queue != 0);
           UNUSED(ret);
 
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+          bt_atomic_set(&conn->nfy_credits,
+                        CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS);
+#endif
+
           /* Get exclusive access to the handoff structure.  The count will be
            * zero when we complete this.
            */
@@ -1086,3 +1101,29 @@ int bt_conn_le_conn_update(FAR struct bt_conn_s *conn, uint16_t min,
 
   return bt_hci_cmd_send(BT_HCI_OP_LE_CONN_UPDATE, buf);
 }
+
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+int bt_conn_le_set_data_len(FAR struct bt_conn_s *conn)
+{
+  FAR struct bt_hci_cp_le_set_data_len_s *cp;
+  FAR struct bt_buf_s *buf;
+
+  if (g_btdev.le_max_tx_octets == 0)
+    {
+      return -ENOSYS;
+    }
+
+  buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DATA_LEN, sizeof(*cp));
+  if (!buf)
+    {
+      return -ENOBUFS;
+    }
+
+  cp            = bt_buf_extend(buf, sizeof(*cp));
+  cp->handle    = BT_HOST2LE16(conn->handle);
+  cp->tx_octets = BT_HOST2LE16(g_btdev.le_max_tx_octets);
+  cp->tx_time   = BT_HOST2LE16(g_btdev.le_max_tx_time);
+
+  return bt_hci_cmd_send(BT_HCI_OP_LE_SET_DATA_LEN, buf);
+}
+#endif
@@ -107,6 +107,13 @@ struct bt_conn_s
 
   uint8_t le_conn_interval;
   bt_atomic_t ref;
+
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+  /* Number of ATT notifications that may still be queued for transmission */
+
+  bt_atomic_t nfy_credits;
+#endif
+
   enum bt_conn_state_e state;
 
   /* Temporary data used by ioctl */
@@ -420,4 +427,25 @@ int bt_conn_le_conn_update(FAR struct bt_conn_s *conn, uint16_t min,
                            uint16_t max, uint16_t latency,
                            uint16_t timeout);
 
+/****************************************************************************
+ * Name: bt_conn_le_set_data_len
+ *
+ * Description:
+ *   Ask the controller to use the largest link layer PDUs that it supports
+ *   on the connection (LE Data Length Extension).  Larger PDUs avoid
+ *   splitting each L2CAP packet over several connection events.
+ *
+ * Input Parameters:
+ *   conn - The connection to send the command on.
+ *
+ * Returned Value:
+ *   Zero is returned on success; a negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+int bt_conn_le_set_data_len(FAR struct bt_conn_s *conn);
+#endif
+
 #endif /* __WIRELESS_BLUETOOTH_BT_CONN_H */
@@ -92,7 +92,8 @@ struct notify_data_s
 {
   FAR const void *data;
   size_t len;
-  uint8_t handle;
+  uint16_t handle;
+  int result;
 };
 
 /****************************************************************************
@@ -426,20 +427,48 @@ static uint8_t notify_cb(FAR const struct bt_gatt_attr_s *attr,
         }
 
       conn = bt_conn_lookup_addr_le(&ccc->cfg[i].peer);
-      if (!conn || conn->state != BT_CONN_CONNECTED)
+      if (!conn)
         {
           continue;
         }
 
+      if (conn->state != BT_CONN_CONNECTED)
+        {
+          bt_conn_release(conn);
+          continue;
+        }
+
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+      /* Don't block the caller on a full Tx queue.  Skip this peer if it
+       * already has as many notifications queued as it has credits.
+       */
+
+      if (bt_atomic_decrnz(&conn->nfy_credits) == 0)
+        {
+          wlinfo("conn %p out of notification credits\n", conn);
+          data->result = -EAGAIN;
+          bt_conn_release(conn);
+          continue;
+        }
+#endif
+
       buf = bt_att_create_pdu(conn, BT_ATT_OP_NOTIFY,
                               sizeof(*nfy) + data->len);
       if (!buf)
         {
           wlwarn("No buffer available to send notification");
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+          bt_atomic_incr(&conn->nfy_credits);
+#endif
+          data->result = -ENOBUFS;
           bt_conn_release(conn);
           return BT_GATT_ITER_STOP;
         }
 
+#if CONFIG_BLUETOOTH_GATT_NOTIFY_CREDITS > 0
+      buf->u.acl.credit = 1;
+#endif
+
       wlinfo("conn %p handle 0x%04x\n", conn, data->handle);
 
       nfy         = bt_buf_extend(buf, sizeof(*nfy));
@@ -455,15 +484,17 @@ static uint8_t notify_cb(FAR const struct bt_gatt_attr_s *attr,
   return BT_GATT_ITER_CONTINUE;
 }
 
-void bt_gatt_notify(uint16_t handle, FAR const void *data, size_t len)
+int bt_gatt_notify(uint16_t handle, FAR const void *data, size_t len)
 {
   struct notify_data_s nfy;
 
   nfy.handle = handle;
   nfy.data   = data;
   nfy.len    = len;
+  nfy.result = OK;
 
   bt_gatt_foreach_attr(handle, 0xffff, notify_cb, &nfy);
+  return nfy.result;
 }
 
 static uint8_t connected_cb(FAR const struct bt_gatt_attr_s *attr,
@@ -728,6 +728,15 @@ static void le_conn_complete(FAR struct bt_buf_s *buf)
 
   bt_l2cap_connected(conn);
 
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+  /* Use the largest link layer PDUs that the controller supports */
+
+  if (g_btdev.le_max_tx_octets > 0)
+    {
+      bt_conn_le_set_data_len(conn);
+    }
+#endif
+
   if (evt->role == BT_HCI_ROLE_SLAVE)
     {
       bt_l2cap_update_conn_param(conn);
@@ -1184,6 +1193,21 @@ static void le_read_buffer_size_complete(FAR struct bt_buf_s *buf)
   g_btdev.le_pkts = rp->le_max_num;
 }
 
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+static void le_read_max_data_len_complete(FAR struct bt_buf_s *buf)
+{
+  FAR struct bt_hci_rp_le_read_max_data_len_s *rp = (FAR void *)buf->data;
+
+  wlinfo("status %u\n", rp->status);
+
+  if (rp->status == 0)
+    {
+      g_btdev.le_max_tx_octets = BT_LE162HOST(rp->max_tx_octets);
+      g_btdev.le_max_tx_time   = BT_LE162HOST(rp->max_tx_time);
+    }
+}
+#endif
+
 static int hci_initialize(void)
 {
   FAR struct bt_hci_cp_host_buffer_size_s *hbs;
@@ -1253,6 +1277,51 @@ static int hci_initialize(void)
   read_le_features_complete(rsp);
   bt_buf_release(rsp);
 
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+  /* Read the largest link layer PDU that the controller supports */
+
+  g_btdev.le_max_tx_octets = 0;
+  g_btdev.le_max_tx_time   = 0;
+
+  if (le_datalen_capable(g_btdev))
+    {
+      ret = bt_hci_cmd_send_sync(BT_HCI_OP_LE_READ_MAX_DATA_LEN, NULL, &rsp);
+      if (ret < 0)
+        {
+          wlerr("ERROR:  bt_hci_cmd_send_sync failed: %d\n", ret);
+          return ret;
+        }
+
+      le_read_max_data_len_complete(rsp);
+      bt_buf_release(rsp);
+    }
+#endif
+
+#ifdef CONFIG_BLUETOOTH_LE_2MPHY
+  /* Prefer the 2M PHY for all connections.  The controller falls back to
+   * the 1M PHY if the peer does not support it.
+   */
+
+  if (le_2mphy_capable(g_btdev))
+    {
+      FAR struct bt_hci_cp_le_set_default_phy_s *phy;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DEFAULT_PHY, sizeof(*phy));
+      if (buf == NULL)
+        {
+          wlerr("ERROR:  Failed to create buffer\n");
+          return -ENOBUFS;
+        }
+
+      phy           = bt_buf_extend(buf, sizeof(*phy));
+      phy->all_phys = 0;
+      phy->tx_phys  = BT_HCI_LE_PHY_2M;
+      phy->rx_phys  = BT_HCI_LE_PHY_2M;
+
+      bt_hci_cmd_send_sync(BT_HCI_OP_LE_SET_DEFAULT_PHY, buf, NULL);
+    }
+#endif
+
   /* Read LE Buffer Size */
 
   ret = bt_hci_cmd_send_sync(BT_HCI_OP_LE_READ_BUFFER_SIZE, NULL, &rsp);
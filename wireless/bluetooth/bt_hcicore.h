@@ -63,6 +63,12 @@
 #define lmp_bredr_capable(btdev)  (!((btdev).features[4] & BT_LMP_NO_BREDR))
 #define lmp_le_capable(btdev)     ((btdev).features[4] & BT_LMP_LE)
 
+/* LE feature helpers */
+
+#define le_datalen_capable(btdev) \
+  ((btdev).le_features[0] & BT_HCI_LE_DATA_LEN_EXT)
+#define le_2mphy_capable(btdev)   ((btdev).le_features[1] & BT_HCI_LE_2M_PHY)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -104,6 +110,15 @@ struct bt_dev_s
   uint16_t le_mtu;
   sem_t le_pkts_sem;
 
+#ifdef CONFIG_BLUETOOTH_LE_DATALEN
+  /* Largest link layer PDU supported by the controller (LE Data Length
+   * Extension).  Zero if the extension is not supported.
+   */
+
+  uint16_t le_max_tx_octets;
+  uint16_t le_max_tx_time;
+#endif
+
   /* Number of commands controller can accept */
 
   uint8_t ncmd;
@@ -101,6 +101,10 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
 
 static void mac802154_notify_worker(FAR void *arg);
 
+static FAR struct ieee802154_txdesc_s *
+  mac802154_findindirect(FAR struct ieee802154_privmac_s *priv,
+                         FAR const struct ieee802154_addr_s *addr);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1398,6 +1402,56 @@ static void mac802154_rxdataframe(FAR struct ieee802154_privmac_s *priv,
   mac802154_unlock(priv)
 }
 
+/****************************************************************************
+ * Name: mac802154_findindirect
+ *
+ * Description:
+ *   Return the oldest indirect transaction for the device with the given
+ *   address or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called with the MAC locked
+ *
+ ****************************************************************************/
+
+static FAR struct ieee802154_txdesc_s *
+  mac802154_findindirect(FAR struct ieee802154_privmac_s *priv,
+                         FAR const struct ieee802154_addr_s *addr)
+{
+  FAR struct ieee802154_txdesc_s *txdesc;
+
+  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
+
+  while (txdesc != NULL)
+    {
+      if (txdesc->destaddr.mode == addr->mode)
+        {
+          if (addr->mode == IEEE802154_ADDRMODE_SHORT)
+            {
+              if (IEEE802154_SADDRCMP(txdesc->destaddr.saddr, addr->saddr))
+                {
+                  return txdesc;
+                }
+            }
+          else if (addr->mode == IEEE802154_ADDRMODE_EXTENDED)
+            {
+              if (IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, addr->eaddr))
+                {
+                  return txdesc;
+                }
+            }
+          else
+            {
+              DEBUGASSERT(false);
+            }
+        }
+
+      txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc);
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: mac802154_rxdatareq
  *
@@ -1428,60 +1482,39 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
    * need to check for this condition.
    */
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
-
-  while(txdesc != NULL)
+  txdesc = mac802154_findindirect(priv, &ind->src);
+  if (txdesc != NULL)
     {
-      if (txdesc->destaddr.mode == ind->src.mode)
-        {
-          if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
-            {
-              if (IEEE802154_SADDRCMP(txdesc->destaddr.saddr, ind->src.saddr))
-                {
-                  /* Remove the transaction from the queue */
-
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
-
-                  /* NOTE: We don't do anything with the purge timeout, because
-                   * we really don't need to. As of now, I see no disadvantage
-                   * to just letting the timeout expire, which won't purge the
-                   * transaction since it is no longer on the list, and then it
-                   * will reschedule the next timeout appropriately. The logic
-                   * otherwise may get complicated even though it may save a few
-                   * clock cycles.
-                   */
+      /* Remove the transaction from the queue */
 
-                  /* The addresses match, send the transaction immediately */
-
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_EXTENDED)
-            {
-              if (IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, ind->src.eaddr))
-                {
-                  /* Remove the transaction from the queue */
+      sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
 
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+      /* NOTE: We don't do anything with the purge timeout, because
+       * we really don't need to. As of now, I see no disadvantage
+       * to just letting the timeout expire, which won't purge the
+       * transaction since it is no longer on the list, and then it
+       * will reschedule the next timeout appropriately. The logic
+       * otherwise may get complicated even though it may save a few
+       * clock cycles.
+       */
 
-                  /* The addresses match, send the transaction immediately */
+      /* If the coordinator has more data for the device, it sets the Frame
+       * Pending field of the data frame so that the device requests the
+       * next transaction immediately rather than on its next poll.
+       */
 
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else
-            {
-              DEBUGASSERT(false);
-            }
+      if (mac802154_findindirect(priv, &ind->src) != NULL)
+        {
+          frame_ctrl   = (FAR uint16_t *)&txdesc->frame->io_data[0];
+          *frame_ctrl |= IEEE802154_FRAMECTRL_PEND;
         }
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc);
+      /* The addresses match, send the transaction immediately */
+
+      priv->radio->txdelayed(priv->radio, txdesc, 0);
+      priv->beaconupdate = true;
+      mac802154_unlock(priv)
+      return;
     }
 
   /* If there is no data frame pending for the requesting device, the coordinator